@@ -46,7 +46,15 @@ load('jstests/libs/analyze_plan.js');
     explained = coll.explain().aggregate([{$match: {foo: {$gt: 0}}}, {$count: "count"}]);
     assert(planHasStage(db, explained.stages[0].$cursor.queryPlanner.winningPlan, "COUNT_SCAN"));
 
-    // A $match that is not a single range cannot use the COUNT_SCAN optimization.
+    // A $match over several ranges of an index which is not multikey uses a COUNT_SCAN for each.
     explained = coll.explain().aggregate([{$match: {foo: {$in: [0, 1]}}}, {$count: "count"}]);
+    assert(planHasStage(db, explained.stages[0].$cursor.queryPlanner.winningPlan, "COUNT_SCAN"));
+    assert.eq(10, coll.aggregate([{$match: {foo: {$in: [0, 1]}}}, {$count: "count"}]).next().count);
+
+    // Once the index is multikey, a document may have keys in several of the ranges, so the
+    // COUNT_SCAN optimization cannot be used.
+    coll.insert({foo: [5, 6], bar: 0});
+    explained = coll.explain().aggregate([{$match: {foo: {$in: [5, 6]}}}, {$count: "count"}]);
     assert(!planHasStage(db, explained.stages[0].$cursor.queryPlanner.winningPlan, "COUNT_SCAN"));
+    assert.eq(1, coll.aggregate([{$match: {foo: {$in: [5, 6]}}}, {$count: "count"}]).next().count);
 }());
@@ -0,0 +1,33 @@
+/**
+ * Tests that $approxCountDistinct estimates the number of distinct values in each group, counting
+ * equal values of different numeric types once.
+ */
+(function() {
+    "use strict";
+    const coll = db.approx_count_distinct;
+
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 20000; ++i) {
+        bulk.insert({key: "large", value: i % 10000});
+    }
+    bulk.insert({key: "small", value: NumberInt(1)});
+    bulk.insert({key: "small", value: NumberLong(1)});
+    bulk.insert({key: "small", value: 1});
+    bulk.insert({key: "small", value: "1"});
+    bulk.insert({key: "small"});
+    assert.writeOK(bulk.execute());
+
+    const results =
+        coll.aggregate([
+                {$group: {_id: "$key", n: {$approxCountDistinct: "$value"}}},
+                {$sort: {_id: 1}}
+            ])
+            .toArray();
+
+    assert.eq(results.length, 2, tojson(results));
+    assert.eq(results[0]._id, "large", tojson(results));
+    assert.lte(Math.abs(results[0].n - 10000), 300, tojson(results));
+    assert.eq(results[1], {_id: "small", n: 2}, tojson(results));
+}());
@@ -0,0 +1,46 @@
+/**
+ * Tests that $topN returns the outputs of the first 'n' documents of each group in the order given
+ * by 'sortBy', matching the result of sorting all of the documents and pushing them into arrays.
+ */
+(function() {
+    "use strict";
+    const coll = db.top_n;
+
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, category: i % 7, score: (i * 37) % 101, item: "item" + i});
+    }
+    assert.writeOK(bulk.execute());
+
+    const topN =
+        coll.aggregate([
+                {
+                  $group: {
+                      _id: "$category",
+                      top: {$topN: {n: 3, sortBy: {score: -1, _id: 1}, output: "$item"}}
+                  }
+                },
+                {$sort: {_id: 1}}
+            ])
+            .toArray();
+
+    const sortThenPush = coll.aggregate([
+                                 {$sort: {score: -1, _id: 1}},
+                                 {$group: {_id: "$category", top: {$push: "$item"}}},
+                                 {$project: {top: {$slice: ["$top", 3]}}},
+                                 {$sort: {_id: 1}}
+                             ])
+                             .toArray();
+
+    assert.eq(topN, sortThenPush);
+
+    assert.commandFailedWithCode(
+        db.runCommand({
+            aggregate: coll.getName(),
+            pipeline: [{$group: {_id: null, top: {$topN: {n: -1, sortBy: {a: 1}, output: 1}}}}],
+            cursor: {}
+        }),
+        51305);
+}());
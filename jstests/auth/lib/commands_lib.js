@@ -4227,6 +4227,33 @@ var authCommandsLib = {
               {runOnDb: secondDbName, roles: {}}
           ]
         },
+        {
+          testname: "getSamplingProfile",
+          command: {getSamplingProfile: 1},
+          testcases: [
+              {
+                runOnDb: adminDbName,
+                roles: roles_monitoring,
+                privileges: [{resource: {cluster: true}, actions: ["serverStatus"]}]
+              },
+              {runOnDb: firstDbName, roles: {}},
+              {runOnDb: secondDbName, roles: {}}
+          ]
+        },
+        {
+          testname: "flushHighFrequencyDiagnosticData",
+          command: {flushHighFrequencyDiagnosticData: 1},
+          testcases: [
+              {
+                runOnDb: adminDbName,
+                roles: roles_monitoring,
+                privileges: [{resource: {cluster: true}, actions: ["serverStatus"]}],
+                expectFail: true,  // no samples are retained unless the collection is enabled
+              },
+              {runOnDb: firstDbName, roles: {}},
+              {runOnDb: secondDbName, roles: {}}
+          ]
+        },
         {
           testname: "getFreeMonitoringStatus",
           skipSharded: true,
@@ -5957,6 +5984,20 @@ var authCommandsLib = {
               },
           ]
         },
+        {
+          testname: "_readBackupFile",
+          command: {_readBackupFile: "WiredTiger", offset: 0, length: 1},
+          skipSharded: true,
+          testcases: [
+              {
+                runOnDb: adminDbName,
+                roles: {__system: 1},
+                privileges: [{resource: {cluster: true}, actions: ["internal"]}],
+                // There is no open backup cursor.
+                expectFail: true
+              },
+          ]
+        },
         {
           testname: "aggregate_$backupCursor",
           command: {aggregate: 1, cursor: {}, pipeline: [{$backupCursor: {}}]},
@@ -45,3 +45,26 @@ explain = t.find({loc: {$nearSphere: {type: "Point", coordinates: [10, 10]}}})
 inputStage = explain.executionStats.executionStages.inputStage;
 
 assert.eq(inputStage.inputStages.length, inputStage.searchIntervals.length);
+
+// With a few points far apart, the cells scanned for one interval cover the next few narrow
+// intervals, which are folded into a wider interval instead of scanning the index for nothing.
+// Every interval but the last therefore scans some index bounds.
+t.drop();
+assert.writeOK(t.insert([
+    {loc: {type: "Point", coordinates: [0, 0]}},
+    {loc: {type: "Point", coordinates: [0, 0.0001]}},
+    {loc: {type: "Point", coordinates: [30, 30]}},
+    {loc: {type: "Point", coordinates: [-120, -40]}}
+]));
+assert.commandWorked(t.ensureIndex({loc: "2dsphere"}));
+
+explain = t.find({loc: {$nearSphere: {type: "Point", coordinates: [0, 0]}}})
+              .explain("executionStats");
+inputStage = explain.executionStats.executionStages.inputStage;
+
+assert.eq(4, explain.executionStats.nReturned);
+assert.eq(inputStage.inputStages.length, inputStage.searchIntervals.length);
+for (var j = 0; j < inputStage.inputStages.length - 1; ++j) {
+    assert.neq(
+        0, inputStage.inputStages[j].inputStage.indexBounds.loc.length, tojson(inputStage));
+}
@@ -84,4 +84,42 @@
 
     // Non-simple: .returnKey() overrides other projections.
     assert.eq({_id: 1}, t.find({_id: 1}, {a: 1}).returnKey().next());
+
+    //
+    // $in over _id.
+    //
+
+    t.drop();
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(t.insert({_id: i, a: i}));
+    }
+
+    // The documents come back in _id order, without duplicates, and values which match nothing
+    // are skipped.
+    const inQuery = {_id: {$in: [7, 3, 3.0, 42, 5, NumberLong(7)]}};
+    assert.eq([{_id: 3, a: 3}, {_id: 5, a: 5}, {_id: 7, a: 7}], t.find(inQuery).toArray());
+    explain = t.find(inQuery).explain(true);
+    assert(isIdhack(db, explain.queryPlanner.winningPlan), tojson(explain));
+    assert.eq(3, explain.executionStats.nReturned);
+    assert.eq(3, explain.executionStats.totalKeysExamined);
+
+    assert.eq([{_id: 3}, {_id: 5}, {_id: 7}], t.find(inQuery).returnKey().toArray());
+    assert.eq([{a: 3}, {a: 5}, {a: 7}], t.find(inQuery, {_id: 0, a: 1}).toArray());
+    explain = t.find(inQuery).sort({_id: 1}).explain();
+    assert(isIdhack(db, explain.queryPlanner.winningPlan), tojson(explain));
+
+    // An $in on _id cannot be handled by ID hack with a limit or another sort.
+    explain = t.find(inQuery).limit(2).explain();
+    assert(!isIdhack(db, explain.queryPlanner.winningPlan), tojson(explain));
+    assert.eq([{_id: 3, a: 3}, {_id: 5, a: 5}], t.find(inQuery).limit(2).toArray());
+    explain = t.find(inQuery).sort({_id: -1}).explain();
+    assert(!isIdhack(db, explain.queryPlanner.winningPlan), tojson(explain));
+
+    // Nor with a regex among the values.
+    explain = t.find({_id: {$in: [1, /abc/]}}).explain();
+    assert(!isIdhack(db, explain.queryPlanner.winningPlan), tojson(explain));
+
+    // A multi-update over an $in on _id updates each document once.
+    assert.writeOK(t.update(inQuery, {$inc: {a: 100}}, false, true));
+    assert.eq([103, 105, 107], t.find(inQuery).toArray().map(doc => doc.a));
 })();
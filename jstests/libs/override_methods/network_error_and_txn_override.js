@@ -162,6 +162,7 @@
         "planCacheListPlans",
         "planCacheListQueryShapes",
         "planCacheSetFilter",
+        "planCacheSnapshot",
         "profile",       // Not replicated, so can't tolerate failovers.
         "setParameter",  // Not replicated, so can't tolerate failovers.
         "stageDebug",
@@ -0,0 +1,48 @@
+/**
+ * Tests that with 'internalQueryAdaptiveAndOrderInterval' enabled, a find whose $and reorders its
+ * children as it runs returns the same documents, including for positional projections, which
+ * keep the canonical order.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.adaptive_and_order;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 3000; ++i) {
+        bulk.insert({
+            _id: i,
+            a: i % 3,
+            b: i % 50,
+            msg: "message " + (i % 7),
+            arr: [{x: i % 5, y: i % 2}, {x: i % 11, y: 1}],
+            tags: [i % 4, i % 9]
+        });
+    }
+    assert.writeOK(bulk.execute());
+
+    const queries = [
+        {filter: {a: {$gte: 0}, msg: /mess.*3/, b: 7}},
+        {filter: {msg: {$exists: true}, arr: {$elemMatch: {x: 4, y: 1}}, b: {$lt: 10}}},
+        {filter: {$or: [{a: 1, b: {$gt: 5}}, {a: 2, msg: /6$/}]}},
+        {filter: {a: {$ne: 5}, $where: "this.b == 3"}},
+        {filter: {tags: 3, b: {$lt: 20}}, projection: {"tags.$": 1}},
+    ];
+
+    function runAll() {
+        return queries.map(
+            query => coll.find(query.filter, query.projection).sort({_id: 1}).toArray());
+    }
+
+    const expected = runAll();
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryAdaptiveAndOrderInterval: 16}));
+    assert.eq(expected, runAll());
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,49 @@
+/**
+ * Tests that with 'internalQueryExecYieldAdaptive' enabled, a query which runs without any lock or
+ * ticket contention yields less often than the fixed yield thresholds would have it yield.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            internalQueryExecYieldIterations: 10,
+            // Keep the time-based threshold out of the way so that yields are counted in
+            // iterations only.
+            internalQueryExecYieldPeriodMS: 1000 * 1000,
+            internalQueryExecYieldAdaptiveFactor: 2,
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.adaptive_yielding;
+    coll.drop();
+
+    const kNumDocs = 1000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < kNumDocs; ++i) {
+        bulk.insert({_id: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    function countYields() {
+        const explain = coll.find().explain("executionStats");
+        assert.eq(kNumDocs, explain.executionStats.nReturned, tojson(explain));
+        return explain.executionStats.executionStages.saveState;
+    }
+
+    const fixedYields = countYields();
+    assert.gte(fixedYields, kNumDocs / 10 - 1, "fixed yields: " + fixedYields);
+
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryExecYieldAdaptive: true}));
+    const adaptiveYields = countYields();
+
+    // Nothing is waiting on a lock or a ticket, so the plan only yields once every 'factor'
+    // squared of the shortened intervals, which is 'factor' times less often.
+    assert.lt(adaptiveYields, fixedYields, "adaptive yields: " + adaptiveYields);
+    assert.gt(adaptiveYields, 0, "adaptive yields: " + adaptiveYields);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,74 @@
+/**
+ * Tests that with 'internalQueryAggregationResultCacheMaxSizeBytes' set, repeats of an
+ * aggregation are served from the result cache until the collection is written to, or for as long
+ * after as 'internalQueryAggregationResultCacheMaxStalenessMS' allows.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: {internalQueryAggregationResultCacheMaxSizeBytes: 1024 * 1024}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.aggregation_result_cache;
+    coll.drop();
+
+    for (let i = 0; i < 20; ++i) {
+        assert.writeOK(coll.insert({_id: i, key: i % 4}));
+    }
+
+    function cacheStats() {
+        const status = assert.commandWorked(testDB.serverStatus());
+        return status.metrics.query.aggregationResultCache;
+    }
+
+    function assertCounts(pipeline, expectedCount, expectedHits, expectedMisses) {
+        const before = cacheStats();
+        const results = coll.aggregate(pipeline).toArray();
+        const after = cacheStats();
+        assert.eq(expectedCount, results[0].n, tojson(results));
+        assert.eq(expectedHits, after.hits - before.hits, tojson(after));
+        assert.eq(expectedMisses, after.misses - before.misses, tojson(after));
+    }
+
+    const pipeline = [{$match: {key: {$lt: 2}}}, {$group: {_id: null, n: {$sum: 1}}}];
+    assertCounts(pipeline, 10, 0, 1);
+    assertCounts(pipeline, 10, 1, 0);
+
+    // A write makes the next run read the collection again.
+    assert.writeOK(coll.insert({_id: 20, key: 0}));
+    assertCounts(pipeline, 11, 0, 1);
+    assertCounts(pipeline, 11, 1, 0);
+    assert.writeOK(coll.remove({_id: 20}));
+    assertCounts(pipeline, 10, 0, 1);
+
+    // Pipelines whose results may change without a write don't use the cache.
+    const nowPipeline = [
+        {$addFields: {now: "$$NOW"}},
+        {$match: {key: {$lt: 2}}},
+        {$group: {_id: null, n: {$sum: 1}}}
+    ];
+    assertCounts(nowPipeline, 10, 0, 0);
+    assertCounts(nowPipeline, 10, 0, 0);
+
+    // Results which don't fit in the first batch aren't cached.
+    const before = cacheStats();
+    assert.eq(20, coll.aggregate([{$sort: {_id: 1}}], {cursor: {batchSize: 5}}).itcount());
+    assert.eq(20, coll.aggregate([{$sort: {_id: 1}}], {cursor: {batchSize: 5}}).itcount());
+    assert.eq(2, cacheStats().misses - before.misses);
+
+    // With a staleness window, results read before a write are still served after it.
+    assert.commandWorked(testDB.adminCommand(
+        {setParameter: 1, internalQueryAggregationResultCacheMaxStalenessMS: 60 * 60 * 1000}));
+    assertCounts(pipeline, 10, 1, 0);
+    assert.writeOK(coll.insert({_id: 20, key: 0}));
+    assertCounts(pipeline, 10, 1, 0);
+
+    // Turning the window off again serves the latest data.
+    assert.commandWorked(testDB.adminCommand(
+        {setParameter: 1, internalQueryAggregationResultCacheMaxStalenessMS: 0}));
+    assertCounts(pipeline, 11, 0, 1);
+
+    MongoRunner.stopMongod(conn);
+}());
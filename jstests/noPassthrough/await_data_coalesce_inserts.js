@@ -0,0 +1,48 @@
+/**
+ * Tests that with 'internalQueryAwaitDataCoalesceMillis' an awaitData getMore woken up by an
+ * insert into a capped collection also returns the inserts that closely follow it.
+ * @tags: [requires_capped]
+ */
+(function() {
+    "use strict";
+
+    // This test runs a getMore in a parallel shell, which will not inherit the implicit session of
+    // the cursor establishing command.
+    TestData.disableImplicitSessions = true;
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: {internalQueryAwaitDataCoalesceMillis: 2 * 1000}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.await_data_coalesce_inserts;
+
+    assert.commandWorked(testDB.createCollection(coll.getName(), {capped: true, size: 4096}));
+    assert.writeOK(coll.insert({_id: 0}));
+
+    const cmdRes = assert.commandWorked(
+        testDB.runCommand({find: coll.getName(), tailable: true, awaitData: true}));
+    assert.eq(1, cmdRes.cursor.firstBatch.length);
+
+    TestData.commandResult = cmdRes;
+    const awaitShell = startParallelShell(function() {
+        const res = assert.commandWorked(db.getSiblingDB("test").runCommand({
+            getMore: TestData.commandResult.cursor.id,
+            collection: "await_data_coalesce_inserts",
+            maxTimeMS: 60 * 1000,
+        }));
+        assert.eq([{_id: 1}, {_id: 2}, {_id: 3}], res.cursor.nextBatch, tojson(res));
+    }, conn.port);
+
+    assert.soon(function() {
+        return testDB.currentOp({"command.getMore": {$exists: true}, ns: coll.getFullName()})
+                   .inprog.length === 1;
+    });
+
+    // Without coalescing, the getMore would return as soon as it found the first of these.
+    for (let i = 1; i <= 3; ++i) {
+        assert.writeOK(coll.insert({_id: i}));
+    }
+
+    awaitShell();
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,39 @@
+/**
+ * Tests that commands return the same replies when the BSON builders used to run them reuse
+ * buffers, as set by 'internalBufBuilderPoolMaxBytes'.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.buf_builder_pool;
+    coll.drop();
+
+    function runAll() {
+        coll.drop();
+        const bulk = coll.initializeOrderedBulkOp();
+        for (let i = 0; i < 1000; ++i) {
+            bulk.insert({_id: i, a: i % 10, s: "x".repeat(i % 100), arr: [i, [i + 1]]});
+        }
+        assert.writeOK(bulk.execute());
+        assert.writeOK(coll.update({a: 1}, {$set: {b: 1}}, {multi: true}));
+        return [
+            coll.find({a: {$lt: 5}}).sort({_id: 1}).batchSize(10).toArray(),
+            coll.aggregate([{$group: {_id: "$a", s: {$push: "$s"}}}, {$sort: {_id: 1}}])
+                .toArray(),
+            coll.find().sort({_id: -1}).toArray(),
+        ];
+    }
+
+    const expected = runAll();
+    for (let maxBytes of [1024, 64 * 1024 * 1024]) {
+        assert.commandWorked(
+            testDB.adminCommand({setParameter: 1, internalBufBuilderPoolMaxBytes: maxBytes}));
+        assert.eq(expected, runAll());
+    }
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,48 @@
+/**
+ * Tests that 'compact' with 'indexesOnly' runs on a replica set primary without 'force', and that
+ * the collection can be written while its indexes are compacted.
+ *
+ * @tags: [requires_persistence, requires_replication, requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    const testDB = rst.getPrimary().getDB("test");
+    const coll = testDB.compact_indexes_only;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}, {unique: true}));
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; ++i) {
+        bulk.insert({_id: i, a: i % 100, b: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(coll.remove({_id: {$mod: [3, 0]}}));
+
+    // Compacting the whole collection still requires 'force' on a primary.
+    assert.commandFailed(testDB.runCommand({compact: coll.getName()}));
+
+    const writer = startParallelShell(function() {
+        const coll = db.getSiblingDB("test").compact_indexes_only;
+        for (let i = 10000; i < 12000; ++i) {
+            assert.writeOK(coll.insert({_id: i, a: i % 100, b: i}));
+        }
+    }, rst.getPrimary().port);
+
+    for (let i = 0; i < 5; ++i) {
+        assert.commandWorked(testDB.runCommand({compact: coll.getName(), indexesOnly: true}));
+    }
+    writer();
+
+    assert.eq(coll.find().itcount(), coll.find().hint({a: 1}).itcount());
+    assert.eq(coll.find().itcount(), coll.find().hint({b: 1}).itcount());
+    const res = assert.commandWorked(coll.validate({full: true}));
+    assert(res.valid, tojson(res));
+
+    rst.stopSet();
+}());
@@ -0,0 +1,80 @@
+/**
+ * Tests that with 'internalQueryCompileMatchExpressions' enabled, collection scans and $match
+ * stages return the same documents as when their filters are matched by walking the expression
+ * tree.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.compiled_match_expressions;
+    coll.drop();
+
+    const values = [
+        1,
+        2.5,
+        NumberLong(3),
+        NumberDecimal("2.5"),
+        NaN,
+        "abc",
+        "B",
+        new Date(1000),
+        [1, 5],
+        ["abc", [3]],
+        [],
+        null,
+        {c: 1},
+        MinKey,
+        MaxKey
+    ];
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 2000; ++i) {
+        const doc = {_id: i, x: i % 17, b: values[(i * 7) % values.length]};
+        if (i % 11 != 0) {
+            doc.a = values[i % values.length];
+        }
+        bulk.insert(doc);
+    }
+    assert.writeOK(bulk.execute());
+
+    const filters = [
+        {a: 1},
+        {a: {$gt: 2}},
+        {a: {$lte: "abc"}},
+        {a: {$gte: new Date(0)}},
+        {a: null},
+        {a: NaN},
+        {a: {$in: [1, "B", null]}},
+        {a: {$exists: false}},
+        {a: {$gt: 0, $lt: 3}},
+        {a: {$gte: 1}, x: {$lt: 5}},
+        {a: {$type: "array"}, b: {$ne: 1}},
+        {x: {$gte: 3}, "a.c": 1},
+        {x: {$lt: 10}, $or: [{a: "abc"}, {b: "abc"}]},
+        {x: {$gt: 2}, $expr: {$lt: ["$x", 12]}},
+    ];
+
+    function runAll() {
+        return filters.map(filter => {
+            return {
+                find: coll.find(filter).sort({_id: 1}).toArray(),
+                agg: coll.aggregate([{$addFields: {y: 1}}, {$match: filter}, {$sort: {_id: 1}}])
+                         .toArray(),
+                aggWithCollation:
+                    coll.aggregate([{$addFields: {y: 1}}, {$match: filter}, {$sort: {_id: 1}}],
+                                   {collation: {locale: "en_US", strength: 2}})
+                        .toArray()
+            };
+        });
+    }
+
+    const expected = runAll();
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryCompileMatchExpressions: true}));
+    assert.eq(expected, runAll());
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,45 @@
+/**
+ * Tests that with 'internalQueryPlannerEnableCostEstimation' enabled, candidate plans which the
+ * sampled index statistics show to be far more expensive than the cheapest one are dropped before
+ * the trial period, and that the query results are unaffected.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: {internalQueryPlannerEnableCostEstimation: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.cost_based_plan_pruning;
+    coll.drop();
+
+    const kNumDocs = 20000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < kNumDocs; ++i) {
+        bulk.insert({a: i, b: i % 2});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    // The predicate on 'a' is far more selective than the one on 'b'.
+    const query = {a: {$gte: 100, $lt: 110}, b: 0};
+    assert.eq(5, coll.find(query).itcount());
+
+    const explain = coll.find(query).explain("allPlansExecution");
+    assert.eq(5, explain.executionStats.nReturned, tojson(explain));
+    assert.lte(explain.executionStats.allPlansExecution.length, 1, tojson(explain));
+
+    // A plan chosen by its estimate alone is not cached.
+    assert.eq(0, coll.getPlanCache().listQueryShapes().length);
+
+    // Without the knob, both plans are raced and the winner is cached.
+    assert.commandWorked(testDB.adminCommand(
+        {setParameter: 1, internalQueryPlannerEnableCostEstimation: false}));
+    assert.eq(5, coll.find(query).itcount());
+    const raced = coll.find(query).explain("allPlansExecution");
+    assert.gt(raced.executionStats.allPlansExecution.length, 1, tojson(raced));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,77 @@
+/**
+ * Tests that a count over several ranges of an index which is not multikey adds up a COUNT_SCAN of
+ * each range, and that 'approx: true' estimates a count from a random sample of the collection.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+    const coll = db.count_approx_and_count_scan_ranges;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; ++i) {
+        bulk.insert({_id: i, a: i % 10, b: i % 3, c: i % 4});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+
+    // $in predicates on the indexed fields are counted without fetching any documents.
+    const queries = [
+        {a: {$in: [1, 4, 7]}},
+        {a: {$in: [2, 9]}, b: 0},
+        {a: {$in: [0, 5]}, b: {$in: [1, 2]}},
+        {a: {$in: [3, 6]}, b: {$gte: 1}},
+    ];
+    queries.forEach(function(query) {
+        const explain = coll.explain("executionStats").count(query);
+        assert(planHasStage(db, explain.queryPlanner.winningPlan, "COUNT_SCAN"), tojson(explain));
+        assert(!planHasStage(db, explain.queryPlanner.winningPlan, "FETCH"), tojson(explain));
+        assert.eq(0, explain.executionStats.totalDocsExamined, tojson(explain));
+        assert.eq(coll.find(query).itcount(), coll.count(query), tojson(query));
+    });
+
+    // A range after a range cannot be counted by count scans.
+    let explain = coll.explain().count({a: {$gte: 3}, b: {$in: [0, 2]}});
+    assert(!planHasStage(db, explain.queryPlanner.winningPlan, "COUNT_SCAN"), tojson(explain));
+
+    assert.commandWorked(db.adminCommand({setParameter: 1, internalQueryMaxCountScans: 2}));
+    explain = coll.explain().count({a: {$in: [1, 4, 7]}});
+    assert(!planHasStage(db, explain.queryPlanner.winningPlan, "COUNT_SCAN"), tojson(explain));
+    assert.eq(3000, coll.count({a: {$in: [1, 4, 7]}}));
+    assert.commandWorked(db.adminCommand({setParameter: 1, internalQueryMaxCountScans: 200}));
+
+    // An approximate count of a predicate on an unindexed field samples the collection.
+    let res =
+        assert.commandWorked(db.runCommand({count: coll.getName(), query: {c: 1}, approx: true}));
+    assert.eq(true, res.approximate, tojson(res));
+    assert.between(1500, res.n, 3500, tojson(res));
+
+    res = assert.commandWorked(
+        db.runCommand({count: coll.getName(), query: {c: 1}, approx: true, limit: 100}));
+    assert.eq(100, res.n, tojson(res));
+
+    explain = assert.commandWorked(db.runCommand({
+        explain: {count: coll.getName(), query: {c: 1}, approx: true},
+        verbosity: "executionStats"
+    }));
+    const sampledCount = getPlanStage(explain.executionStats.executionStages, "SAMPLED_COUNT");
+    assert.neq(null, sampledCount, tojson(explain));
+    assert.eq(1000, sampledCount.docsSampled, tojson(explain));
+
+    // Without a predicate, or when the collection is no larger than the sample, the count is exact.
+    res = assert.commandWorked(db.runCommand({count: coll.getName(), approx: true}));
+    assert.eq(10000, res.n, tojson(res));
+    assert.eq(undefined, res.approximate, tojson(res));
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryApproxCountSampleSize: 20000}));
+    res = assert.commandWorked(db.runCommand({count: coll.getName(), query: {c: 1}, approx: true}));
+    assert.eq(2500, res.n, tojson(res));
+    assert.eq(undefined, res.approximate, tojson(res));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,42 @@
+/**
+ * Tests that aggregations return the same results when the cursors producing their batches reuse
+ * the buffers of freed documents, as set by 'internalDocumentBufferPoolMaxBytes'.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.document_buffer_pool;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 500; ++i) {
+        bulk.insert({_id: i, a: i % 10, arr: [i, {b: i % 3}, "s" + i], sub: {c: i, d: [1, 2, 3]}});
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipelines = [
+        [{$unwind: "$arr"}, {$project: {arr: 1, a: 1}}, {$sort: {_id: 1, arr: 1}}],
+        [{$addFields: {e: {$add: ["$a", "$sub.c"]}, "sub.f": "$arr"}}, {$match: {e: {$gt: 10}}}],
+        [{$unwind: "$sub.d"}, {$group: {_id: "$a", n: {$sum: "$sub.d"}}}, {$sort: {_id: 1}}],
+        [{$project: {_id: 0, x: {$concat: ["x", {$toString: "$_id"}]}, y: "$sub"}}],
+    ];
+
+    function runAll() {
+        return pipelines.map(pipeline => {
+            return coll.aggregate(pipeline, {cursor: {batchSize: 7}}).toArray();
+        });
+    }
+
+    const expected = runAll();
+    for (let maxBytes of [1024, 1024 * 1024]) {
+        assert.commandWorked(
+            testDB.adminCommand({setParameter: 1, internalDocumentBufferPoolMaxBytes: maxBytes}));
+        assert.eq(expected, runAll());
+    }
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,54 @@
+/**
+ * Tests that an aggregation whose documents read their fields lazily, as set by
+ * 'internalDocumentSourceCursorLazyDocuments', returns the same results as one which converts
+ * them up front.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.document_source_cursor_lazy_documents;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 500; ++i) {
+        const doc = {_id: i};
+        for (let f = 0; f < 40; ++f) {
+            doc["f" + f] = (i * f) % 17;
+        }
+        doc.sub = {x: i % 5, y: [i, {z: i % 3}]};
+        bulk.insert(doc);
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipelines = [
+        [{$group: {_id: "$f3", total: {$sum: "$f39"}, n: {$sum: 1}}}, {$sort: {_id: 1}}],
+        [
+          {$match: {f1: {$gt: 4}}},
+          {$addFields: {f2: {$add: ["$f2", 1]}, extra: "$sub.y.z"}},
+          {$project: {_id: 1, f2: 1, f20: 1, extra: 1}},
+          {$sort: {_id: 1}}
+        ],
+        [{$sort: {f7: -1, _id: 1}}, {$project: {_id: 0, f7: 1, sub: 1}}, {$limit: 20}],
+        [
+          {$project: {a: "$f0", missing: "$notThere"}},
+          {$group: {_id: "$a", n: {$sum: 1}}},
+          {$sort: {_id: 1}}
+        ],
+    ];
+
+    function runAll() {
+        return pipelines.map(
+            pipeline => coll.aggregate(pipeline, {cursor: {batchSize: 7}}).toArray());
+    }
+
+    const expected = runAll();
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalDocumentSourceCursorLazyDocuments: true}));
+    assert.eq(expected, runAll());
+
+    MongoRunner.stopMongod(conn);
+}());
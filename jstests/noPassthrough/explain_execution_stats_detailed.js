@@ -0,0 +1,66 @@
+/**
+ * Tests that explain at the "executionStatsDetailed" verbosity reports the time spent in each stage
+ * in nanoseconds, along with the hardware counters when they can be read.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.explain_execution_stats_detailed;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({a: i, b: i % 10});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    function assertDetailedStats(stage, withHardwareCounters) {
+        assert(stage.hasOwnProperty("executionTimeNanos"), tojson(stage));
+        assert.gt(stage.executionTimeNanos, 0, tojson(stage));
+        if (stage.hasOwnProperty("instructions")) {
+            assert(withHardwareCounters, tojson(stage));
+            assert.gte(stage.instructions, 0, tojson(stage));
+            assert.gte(stage.llcMisses, 0, tojson(stage));
+        }
+        if (stage.hasOwnProperty("inputStage")) {
+            // The time spent in a stage includes the time spent in its children.
+            assert.gte(
+                stage.executionTimeNanos, stage.inputStage.executionTimeNanos, tojson(stage));
+            assertDetailedStats(stage.inputStage, withHardwareCounters);
+        }
+    }
+
+    // Enough documents match that the plan ranking stops before the query has been answered, so
+    // that every stage of the winning plan is worked after the detailed stats are enabled.
+    const query = {a: {$gte: 100}, b: 5};
+    let explain = coll.find(query).explain("executionStatsDetailed");
+    assert.eq(490, explain.executionStats.nReturned, tojson(explain));
+    assertDetailedStats(explain.executionStats.executionStages, true);
+
+    // The trial period of the plan ranking does not collect the detailed stats.
+    assert(explain.executionStats.hasOwnProperty("allPlansExecution"), tojson(explain));
+    for (let plan of explain.executionStats.allPlansExecution) {
+        assert(!plan.executionStages.hasOwnProperty("executionTimeNanos"), tojson(plan));
+    }
+
+    // The lower verbosities are unchanged.
+    explain = coll.find(query).explain("allPlansExecution");
+    assert(!explain.executionStats.executionStages.hasOwnProperty("executionTimeNanos"),
+           tojson(explain));
+
+    // The hardware counters can be turned off.
+    assert.commandWorked(testDB.adminCommand(
+        {setParameter: 1, internalQueryExplainCollectHardwareCounters: false}));
+    explain = coll.find(query).explain("executionStatsDetailed");
+    assertDetailedStats(explain.executionStats.executionStages, false);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,66 @@
+/**
+ * Tests that a find with a blocking sort which exceeds the memory limit fails by default, and
+ * spills to disk instead when 'allowDiskUse' is set.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    const kSortLimitBytes = 1024 * 1024;
+    const conn = MongoRunner.runMongod(
+        {setParameter: {internalQueryExecMaxBlockingSortBytes: kSortLimitBytes}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.find_sort_allow_disk_use;
+    coll.drop();
+
+    // Insert ~3MB of data, in an order which differs from the sort order.
+    const largeStr = "x".repeat(32 * 1024);
+    const kNumDocs = 100;
+    for (let i = 0; i < kNumDocs; ++i) {
+        assert.writeOK(coll.insert({a: largeStr, b: (i * 37) % kNumDocs}));
+    }
+
+    // Without 'allowDiskUse', the unindexed sort fails once it exceeds the memory limit.
+    assert.commandFailedWithCode(testDB.runCommand({find: coll.getName(), sort: {b: 1}}),
+                                 ErrorCodes.OperationFailed);
+
+    // With 'allowDiskUse', all of the results come back in order.
+    const results = new DBCommandCursor(testDB, assert.commandWorked(testDB.runCommand({
+                        find: coll.getName(),
+                        sort: {b: 1},
+                        projection: {a: 0},
+                        allowDiskUse: true,
+                        batchSize: 10
+                    }))).toArray();
+    assert.eq(kNumDocs, results.length);
+    for (let i = 0; i < kNumDocs; ++i) {
+        assert.eq(i, results[i].b, tojson(results[i]));
+    }
+
+    // The same holds for a sort with a limit too large to be kept in memory.
+    const limited = new DBCommandCursor(testDB, assert.commandWorked(testDB.runCommand({
+                        find: coll.getName(),
+                        sort: {b: -1},
+                        projection: {a: 0},
+                        limit: 60,
+                        allowDiskUse: true
+                    }))).toArray();
+    assert.eq(60, limited.length);
+    for (let i = 0; i < limited.length; ++i) {
+        assert.eq(kNumDocs - 1 - i, limited[i].b, tojson(limited[i]));
+    }
+
+    // Explain reports the spill.
+    const explain = assert.commandWorked(testDB.runCommand({
+        explain: {find: coll.getName(), sort: {b: 1}, allowDiskUse: true},
+        verbosity: "executionStats"
+    }));
+    const sortStage = getPlanStage(explain.executionStats.executionStages, "SORT");
+    assert.neq(null, sortStage, tojson(explain));
+    assert.eq(1, sortStage.spills, tojson(sortStage));
+
+    MongoRunner.stopMongod(conn);
+}());
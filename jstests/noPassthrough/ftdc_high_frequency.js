@@ -0,0 +1,58 @@
+/**
+ * Tests that the high frequency FTDC tier retains samples in memory, and writes them to the
+ * diagnostic data directory on 'flushHighFrequencyDiagnosticData' and when a latency spike is
+ * detected.
+ */
+(function() {
+    "use strict";
+    load("jstests/libs/check_log.js");
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            diagnosticDataHighFrequencyCollectionEnabled: true,
+            diagnosticDataHighFrequencyCollectionPeriodMillis: 10,
+            diagnosticDataHighFrequencyRetainedSamples: 20,
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+    const adminDB = conn.getDB("admin");
+
+    function highFrequencyFiles() {
+        return listFiles(conn.dbpath + "/diagnostic.data")
+            .filter(file => file.baseName.endsWith("highFrequency"));
+    }
+
+    // Nothing is written until a trigger fires or the samples are flushed.
+    assert.soon(() => {
+        const res = adminDB.runCommand({flushHighFrequencyDiagnosticData: 1});
+        if (!res.ok) {
+            assert.commandFailedWithCode(res, ErrorCodes.IllegalOperation);
+            return false;
+        }
+        return true;
+    });
+    assert.eq(1, highFrequencyFiles().length);
+
+    // An operation slower than the latency trigger makes the samples around it be written.
+    assert.commandWorked(
+        adminDB.runCommand({setParameter: 1, diagnosticDataHighFrequencyLatencyTriggerMillis: 50}));
+    const coll = conn.getDB("test").ftdc_high_frequency;
+    assert.writeOK(coll.insert({_id: 0}));
+    assert.eq(1, coll.find({$where: "sleep(200); return true;"}).itcount());
+    checkLog.contains(conn, "trigger 'latencySpike' fired");
+    assert.soon(() => highFrequencyFiles().length === 2);
+
+    // Disabling the collection drops the retained samples.
+    assert.commandWorked(
+        adminDB.runCommand({setParameter: 1, diagnosticDataHighFrequencyCollectionEnabled: false}));
+    assert.soon(() => {
+        const res = adminDB.runCommand({flushHighFrequencyDiagnosticData: 1});
+        if (res.ok) {
+            return false;
+        }
+        assert.commandFailedWithCode(res, ErrorCodes.IllegalOperation);
+        return true;
+    });
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,55 @@
+/**
+ * Tests that with 'internalQueryGetMoreInitialBatchBytes' getMores without a batchSize return
+ * batches which double in size from the knob's value, while getMores with a batchSize are not
+ * affected.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: {internalQueryGetMoreInitialBatchBytes: 64 * 1024}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+    const coll = db.getmore_initial_batch_bytes;
+
+    // Each document takes a little over 1KB.
+    const str = "x".repeat(1024);
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 2000; ++i) {
+        bulk.insert({_id: i, str: str});
+    }
+    assert.writeOK(bulk.execute());
+
+    function getMoreBatchSizes(getMoreCmd) {
+        let res = assert.commandWorked(db.runCommand({find: coll.getName(), batchSize: 2}));
+        const sizes = [];
+        let total = res.cursor.firstBatch.length;
+        while (res.cursor.id != 0) {
+            res = assert.commandWorked(db.runCommand(
+                Object.merge({getMore: res.cursor.id, collection: coll.getName()}, getMoreCmd)));
+            sizes.push(res.cursor.nextBatch.length);
+            total += res.cursor.nextBatch.length;
+        }
+        assert.eq(2000, total);
+        return sizes;
+    }
+
+    const sizes = getMoreBatchSizes({});
+    assert.gt(sizes.length, 3, tojson(sizes));
+    assert.lt(sizes[0], 64, tojson(sizes));
+    for (let i = 1; i < sizes.length - 1; ++i) {
+        assert.gt(sizes[i], sizes[i - 1] * 1.5, tojson(sizes));
+    }
+
+    // A batchSize is honoured as before.
+    getMoreBatchSizes({batchSize: 100}).slice(0, -1).forEach(function(size) {
+        assert.eq(100, size);
+    });
+
+    // With the knob at zero, the rest of the results come back in a single getMore.
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryGetMoreInitialBatchBytes: 0}));
+    assert.eq([1998], getMoreBatchSizes({}));
+
+    MongoRunner.stopMongod(conn);
+}());
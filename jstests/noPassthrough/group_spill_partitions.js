@@ -0,0 +1,72 @@
+/**
+ * Tests that a $group which spills its groups partitioned by key hash, as set by
+ * 'internalDocumentSourceGroupSpillPartitions', returns the same results as one which spills sorted
+ * runs, and reports what it spilled in explain.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getAggPlanStage.
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: {internalDocumentSourceGroupMaxMemoryBytes: 64 * 1024}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.group_spill_partitions;
+    coll.drop();
+
+    const kNumKeys = 5000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 4 * kNumKeys; ++i) {
+        bulk.insert({key: i % kNumKeys, val: i, str: "x".repeat(i % 7)});
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipeline = [
+        {
+          $group: {
+              _id: "$key",
+              count: {$sum: 1},
+              total: {$sum: "$val"},
+              vals: {$push: "$val"},
+              strs: {$addToSet: "$str"}
+          }
+        },
+        {$project: {count: 1, total: 1, vals: 1, numStrs: {$size: "$strs"}}},
+        {$sort: {_id: 1}}
+    ];
+    function runGroup() {
+        return coll.aggregate(pipeline, {allowDiskUse: true}).toArray().map(doc => {
+            doc.vals.sort((a, b) => a - b);
+            return doc;
+        });
+    }
+
+    const expected = runGroup();
+    assert.eq(kNumKeys, expected.length);
+
+    // Without allowDiskUse, the partitioned $group still fails once it exceeds its memory limit.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalDocumentSourceGroupSpillPartitions: 16}));
+    assert.commandFailedWithCode(
+        testDB.runCommand({aggregate: coll.getName(), pipeline: pipeline, cursor: {}}), 16945);
+
+    assert.eq(expected, runGroup());
+
+    const explain = coll.explain("executionStats").aggregate(pipeline, {allowDiskUse: true});
+    const groupStage = getAggPlanStage(explain, "$group");
+    assert.neq(null, groupStage, tojson(explain));
+    const spillStats = groupStage.$group.$spillStats;
+    assert.gt(spillStats.spilledPartitions, 0, tojson(groupStage));
+    assert.gt(spillStats.spilledRecords, 0, tojson(groupStage));
+    assert.gt(spillStats.spilledBytes, 0, tojson(groupStage));
+
+    // With a single partition, every spill writes out all of the groups, until the partition has
+    // been partitioned as many times as allowed and is aggregated in memory regardless.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalDocumentSourceGroupSpillPartitions: 1}));
+    assert.eq(expected, runGroup());
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,48 @@
+/**
+ * Tests that an $in whose equalities are hashed, as set by 'internalQueryInHashedMinEqualities',
+ * matches the same documents as one which binary searches them.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.in_hashed_equalities;
+    coll.drop();
+
+    const oids = [];
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        const oid = ObjectId();
+        oids.push(oid);
+        const values =
+            [i, NumberLong(i), i + 0.5, NumberDecimal(i), "s" + i, "S" + i, oid, [i, -i]];
+        bulk.insert({_id: i, a: values[i % values.length]});
+    }
+    assert.writeOK(bulk.execute());
+
+    const inList = [];
+    for (let i = 0; i < 500; ++i) {
+        inList.push(i % 2 ? i : NumberLong(i), "s" + i, oids[i]);
+    }
+    inList.push(2.5, NumberDecimal("3"), null);
+
+    const collation = {locale: "en_US", strength: 2};
+    function runAll() {
+        return [
+            coll.find({a: {$in: inList}}).sort({_id: 1}).toArray(),
+            coll.find({a: {$in: inList}}).sort({_id: 1}).collation(collation).toArray(),
+            coll.aggregate([{$addFields: {b: 1}}, {$match: {a: {$in: inList}}}, {$sort: {_id: 1}}])
+                .toArray()
+        ];
+    }
+
+    const expected = runAll();
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryInHashedMinEqualities: 100}));
+    assert.eq(expected, runAll());
+
+    MongoRunner.stopMongod(conn);
+}());
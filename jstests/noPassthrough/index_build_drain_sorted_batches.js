@@ -0,0 +1,74 @@
+/**
+ * Tests that a hybrid index build which sorts its side writes by key before applying them, as set
+ * by 'indexBuildDrainSortsBatches', builds a valid index, and that the drain is reported in the
+ * serverStatus metrics.
+ *
+ * @tags: [requires_document_locking]
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/check_log.js");
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+
+    function drainMetrics() {
+        return assert.commandWorked(testDB.adminCommand({serverStatus: 1}))
+            .metrics.indexBuilds.drain;
+    }
+
+    function buildWithSideWrites(coll, sortBatches) {
+        coll.drop();
+        assert.commandWorked(testDB.adminCommand(
+            {setParameter: 1, indexBuildDrainSortsBatches: sortBatches}));
+        // Small batches make the drain apply several sorted batches.
+        assert.commandWorked(
+            testDB.adminCommand({setParameter: 1, maxIndexBuildDrainBatchSize: 10}));
+
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let i = 0; i < 100; ++i) {
+            bulk.insert({_id: i, a: i % 10});
+        }
+        assert.writeOK(bulk.execute());
+
+        assert.commandWorked(testDB.adminCommand(
+            {configureFailPoint: "hangAfterIndexBuildDumpsInsertsFromBulk", mode: "alwaysOn"}));
+        const awaitBuild = startParallelShell(
+            "assert.commandWorked(db.getSiblingDB('test')." + coll.getName() +
+                ".createIndex({a: 1}, {background: true}));",
+            conn.port);
+        checkLog.contains(conn, "Hanging after dumping inserts from bulk builder");
+
+        // Insert, update and remove documents in reverse key order, so that the side writes are
+        // recorded out of index order.
+        for (let i = 199; i >= 100; --i) {
+            assert.writeOK(coll.insert({_id: i, a: i % 17}));
+        }
+        for (let i = 0; i < 50; ++i) {
+            assert.writeOK(coll.update({_id: i}, {$set: {a: -i}}));
+        }
+        assert.writeOK(coll.remove({_id: {$gte: 150, $lt: 160}}));
+        assert.writeOK(coll.insert({_id: 155, a: 3}));
+
+        assert.commandWorked(testDB.adminCommand(
+            {configureFailPoint: "hangAfterIndexBuildDumpsInsertsFromBulk", mode: "off"}));
+        awaitBuild();
+
+        const res = assert.commandWorked(coll.validate({full: true}));
+        assert(res.valid, tojson(res));
+        return coll.find({}, {_id: 1}).hint({a: 1}).sort({a: 1, _id: 1}).toArray();
+    }
+
+    const before = drainMetrics();
+    const sorted = buildWithSideWrites(testDB.drain_sorted, true);
+    const after = drainMetrics();
+    assert.gt(after.batches, before.batches, tojson(after));
+    assert.gt(after.sideWritesApplied, before.sideWritesApplied, tojson(after));
+
+    const unsorted = buildWithSideWrites(testDB.drain_unsorted, false);
+    assert.eq(sorted, unsorted);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,58 @@
+/**
+ * Tests that builds of several indexes which extract the fields they index from each document once,
+ * as set by 'indexBuildExtractIndexedFieldsOnce', build the same indexes as ones which generate the
+ * keys of each index from the whole document.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.index_build_extract_indexed_fields;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 2000; ++i) {
+        const doc = {_id: i, a: i % 11, b: {c: [i % 3, i % 4], d: "s" + i}};
+        for (let f = 0; f < 50; ++f) {
+            doc["f" + f] = f;
+        }
+        if (i % 7 == 0) {
+            // Documents missing an indexed field, and holding a point for the geo index.
+            delete doc.a;
+            doc.loc = [i % 90, -(i % 90)];
+        }
+        bulk.insert(doc);
+    }
+    assert.writeOK(bulk.execute());
+
+    const specs = [
+        {key: {a: 1, "b.d": -1}, name: "a_bd"},
+        {key: {"b.c": 1}, name: "bc"},
+        {key: {"b.c.0": 1, f3: 1}, name: "positional"},
+        {key: {a: "hashed"}, name: "hashed"},
+        {key: {loc: "2d"}, name: "geo"},
+        {key: {f7: 1}, name: "partial", partialFilterExpression: {f10: {$gt: 5}, a: {$lt: 5}}},
+    ];
+
+    function buildAndScan() {
+        assert.commandWorked(coll.dropIndexes());
+        assert.commandWorked(coll.createIndexes(specs));
+        assert.commandWorked(coll.validate(true));
+        return specs.filter(spec => spec.name != "geo").map(spec => {
+            const filter = spec.partialFilterExpression || {};
+            return coll.find(filter, {_id: 1}).hint(spec.name).toArray();
+        });
+    }
+
+    const expected = buildAndScan();
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, indexBuildExtractIndexedFieldsOnce: true}));
+    assert.eq(expected, buildAndScan());
+    assert.eq(Math.floor(1999 / 7) + 1,
+              coll.find({loc: {$within: {$box: [[-180, -90], [180, 90]]}}}).hint("geo").itcount());
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,58 @@
+/**
+ * Tests that index builds which generate their keys on several threads, as set by
+ * 'indexBuildKeyGenerationThreads', build the same indexes as ones which generate them on the
+ * scanning thread.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.index_build_key_generation_threads;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; ++i) {
+        bulk.insert({_id: i, a: i % 97, b: "s" + (i % 13), c: [i % 5, i % 7], d: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    const specs = [
+        {key: {a: 1, b: -1, d: 1}, name: "compound"},
+        {key: {c: 1}, name: "multikey"},
+        {key: {b: "hashed"}, name: "hashed"},
+        {key: {d: 1}, name: "partial", partialFilterExpression: {a: {$lt: 10}}},
+    ];
+
+    function buildAndScan() {
+        assert.commandWorked(coll.dropIndexes());
+        assert.commandWorked(coll.createIndexes(specs));
+        assert.commandWorked(coll.validate(true));
+        return specs.map(spec => {
+            const filter = spec.partialFilterExpression || {};
+            return coll.find(filter, {_id: 1}).hint(spec.name).toArray();
+        });
+    }
+
+    const expected = buildAndScan();
+    assert.commandFailed(testDB.adminCommand({setParameter: 1, indexBuildKeyGenerationThreads: 0}));
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, indexBuildKeyGenerationThreads: 4}));
+    assert.eq(expected, buildAndScan());
+
+    // A unique index build fails on the duplicates, whichever thread generated them.
+    assert.commandFailedWithCode(coll.createIndex({a: 1}, {unique: true}),
+                                 ErrorCodes.DuplicateKey);
+    assert.commandWorked(coll.createIndex({d: 1}, {unique: true}));
+
+    // The multikey paths found by the threads are merged.
+    const explain = coll.find({c: 1}).hint("multikey").explain();
+    const ixscan = getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN");
+    assert.eq(true, ixscan.isMultiKey, tojson(ixscan));
+
+    MongoRunner.stopMongod(conn);
+}());
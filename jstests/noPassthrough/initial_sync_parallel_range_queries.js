@@ -0,0 +1,55 @@
+/**
+ * Tests that initial sync with 'collectionClonerParallelRangeQueries' clones a collection with
+ * several queries over ranges of '_id' values, and copies every document exactly once.
+ * @tags: [requires_replication]
+ */
+(function() {
+    'use strict';
+    load('jstests/libs/check_log.js');
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    const primaryDB = rst.getPrimary().getDB('test');
+    const coll = primaryDB.initial_sync_parallel_range_queries;
+    const cappedColl = primaryDB.initial_sync_parallel_range_queries_capped;
+    assert.commandWorked(
+        primaryDB.createCollection(cappedColl.getName(), {capped: true, size: 1 << 20}));
+
+    // Mix '_id' types, so that the ranges span values of more than one type.
+    const bulk = coll.initializeUnorderedBulkOp();
+    const cappedBulk = cappedColl.initializeOrderedBulkOp();
+    for (let i = 0; i < 2000; ++i) {
+        bulk.insert({_id: i % 2 === 0 ? i : "id" + i, x: "x".repeat(100)});
+        cappedBulk.insert({_id: 2000 - i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(cappedBulk.execute());
+
+    const secondary = rst.add({
+        rsConfig: {priority: 0, votes: 0},
+        setParameter: {
+            collectionClonerParallelRangeQueries: 4,
+            collectionClonerParallelRangeMinDocuments: 1000,
+            collectionClonerBatchSize: 100,
+        }
+    });
+    rst.reInitiate();
+    rst.awaitSecondaryNodes();
+    rst.awaitReplication();
+
+    checkLog.contains(secondary, "ns: '" + coll.getFullName() + "' cloning with 4 range queries");
+
+    const secondaryDB = secondary.getDB('test');
+    secondaryDB.getMongo().setSlaveOk();
+    const secondaryColl = secondaryDB.getCollection(coll.getName());
+    assert.eq(coll.find().sort({_id: 1}).toArray(), secondaryColl.find().sort({_id: 1}).toArray());
+
+    // Capped collections are cloned with one query, in their natural order.
+    const secondaryCappedColl = secondaryDB.getCollection(cappedColl.getName());
+    assert.eq(cappedColl.find().toArray(), secondaryCappedColl.find().toArray());
+
+    rst.checkReplicatedDataHashes();
+    rst.stopSet();
+})();
@@ -0,0 +1,62 @@
+/**
+ * Tests that with 'internalInsertGroupCommit', concurrent single-document inserts into the same
+ * collection all succeed or fail on their own, whether or not they were combined with others.
+ * @tags: [requires_replication]
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet({setParameter: {internalInsertGroupCommit: true}});
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+    const coll = testDB.insert_group_commit;
+    assert.commandWorked(testDB.createCollection(coll.getName()));
+
+    const kClients = 8;
+    const kDocsPerClient = 500;
+
+    // Every tenth insert of each client duplicates the '_id' of an earlier one of its inserts.
+    function insertDocuments(client, docsPerClient) {
+        const coll = db.getSiblingDB("test").insert_group_commit;
+        let nInserted = 0;
+        let nDuplicates = 0;
+        for (let i = 0; i < docsPerClient; ++i) {
+            const id = (i % 10 === 9) ? client * docsPerClient + i - 1 : client * docsPerClient + i;
+            const res = coll.insert({_id: id, client: client});
+            if (res.hasWriteError()) {
+                assert.eq(ErrorCodes.DuplicateKey, res.getWriteError().code, tojson(res));
+                ++nDuplicates;
+            } else {
+                assert.eq(1, res.nInserted, tojson(res));
+                ++nInserted;
+            }
+        }
+        db.getSiblingDB("test").results.insert(
+            {client: client, nInserted: nInserted, nDuplicates: nDuplicates});
+    }
+
+    const shells = [];
+    for (let client = 0; client < kClients; ++client) {
+        shells.push(startParallelShell(
+            "(" + insertDocuments.toString() + ")(" + client + ", " + kDocsPerClient + ");",
+            primary.port));
+    }
+    shells.forEach(awaitShell => awaitShell());
+
+    const results = testDB.results.find().toArray();
+    assert.eq(kClients, results.length, tojson(results));
+    for (let result of results) {
+        assert.eq(kDocsPerClient * 9 / 10, result.nInserted, tojson(result));
+        assert.eq(kDocsPerClient / 10, result.nDuplicates, tojson(result));
+        assert.eq(result.nInserted, coll.find({client: result.client}).itcount(), tojson(result));
+    }
+
+    // Every inserted document has its own oplog entry.
+    assert.eq(kClients * kDocsPerClient * 9 / 10,
+              primary.getDB("local").oplog.rs.find({ns: coll.getFullName(), op: "i"}).itcount());
+
+    rst.stopSet();
+}());
@@ -0,0 +1,77 @@
+/**
+ * Tests that inserting batches whose index keys are sorted across the batch, as set by
+ * 'internalInsertSortIndexKeysAcrossBatch', leaves every index consistent with the collection.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    const conn =
+        MongoRunner.runMongod({setParameter: {internalInsertSortIndexKeysAcrossBatch: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.insert_sort_index_keys;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: -1, a: 1}));
+    assert.commandWorked(coll.createIndex({u: 1}, {unique: true, sparse: true}));
+    assert.commandWorked(coll.createIndex({arr: 1}));
+    assert.commandWorked(coll.createIndex({p: 1}, {partialFilterExpression: {a: {$gt: 50}}}));
+    assert.commandWorked(coll.createIndex({"w.$**": 1}));
+
+    const kNumDocs = 500;
+    const docs = [];
+    for (let i = 0; i < kNumDocs; ++i) {
+        const doc = {_id: i, a: (i * 37) % 101, b: "s" + (i % 17), p: i, w: {x: i % 5}};
+        if (i % 10 == 0) {
+            doc.u = i;
+        }
+        if (i % 50 == 0) {
+            doc.arr = [i, i + 1, i + 2];
+            doc.w.y = [i, -i];
+        } else {
+            doc.arr = i;
+        }
+        docs.push(doc);
+    }
+    assert.commandWorked(coll.insertMany(docs));
+    assert.eq(kNumDocs, coll.find().itcount());
+
+    const validation = assert.commandWorked(coll.validate({full: true}));
+    assert(validation.valid, tojson(validation));
+
+    // Each index returns the documents the collection holds.
+    assert.eq(docs.filter(doc => doc.a == 7).length, coll.find({a: 7}).hint({a: 1}).itcount());
+    assert.eq(docs.filter(doc => doc.b == "s3").length,
+              coll.find({b: "s3"}).hint({b: -1, a: 1}).itcount());
+    assert.eq(kNumDocs / 10, coll.find({u: {$exists: true}}).hint({u: 1}).itcount());
+    assert.eq(docs.filter(doc => doc.a > 50 && doc.p < 100).length,
+              coll.find({a: {$gt: 50}, p: {$lt: 100}}).hint({p: 1}).itcount());
+    assert.eq(2, coll.find({"w.y": 100}).itcount());
+
+    // The arrays of the batch mark the index multikey.
+    const explain = coll.find({arr: 101}).hint({arr: 1}).explain();
+    const ixscan = getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN");
+    assert(ixscan.isMultiKey, tojson(ixscan));
+    assert.eq(["arr"], ixscan.multiKeyPaths.arr, tojson(ixscan));
+    assert.eq(1, coll.find({arr: 101}).hint({arr: 1}).itcount());
+
+    // A duplicate within an unordered batch fails only the document which repeats the key.
+    const res = testDB.runCommand({
+        insert: coll.getName(),
+        documents: [{_id: "d1", u: "dup"}, {_id: "d2", u: "other"}, {_id: "d3", u: "dup"}],
+        ordered: false
+    });
+    assert.commandWorked(res);
+    assert.eq(2, res.n, tojson(res));
+    assert.eq(1, res.writeErrors.length, tojson(res));
+    assert.eq(2, res.writeErrors[0].index, tojson(res));
+    assert.eq(ErrorCodes.DuplicateKey, res.writeErrors[0].code, tojson(res));
+    assert.eq(1, coll.find({u: "dup"}).itcount());
+    assert.eq(1, coll.find({u: "other"}).itcount());
+
+    MongoRunner.stopMongod(conn);
+}());
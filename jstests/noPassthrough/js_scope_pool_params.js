@@ -0,0 +1,36 @@
+/**
+ * Tests that the JavaScript scope pool parameters can be changed at runtime and that $where works
+ * whether or not scopes are kept for reuse.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {jsScopePoolSize: 20}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+    const coll = db.js_scope_pool_params;
+
+    assert.commandWorked(coll.insert([{x: 1}, {x: 2}, {x: 3}]));
+
+    function checkWhere() {
+        for (let i = 0; i < 5; ++i) {
+            assert.eq(2, coll.find({$where: "this.x > 1"}).itcount());
+        }
+    }
+
+    const res = assert.commandWorked(db.adminCommand({getParameter: 1, jsScopePoolSize: 1}));
+    assert.eq(20, res.jsScopePoolSize);
+    checkWhere();
+
+    assert.commandWorked(db.adminCommand({setParameter: 1, jsScopePoolSize: 0}));
+    checkWhere();
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, jsScopePoolSize: 5, jsScopeMaxReuseSecs: 60}));
+    checkWhere();
+
+    assert.commandFailed(db.adminCommand({setParameter: 1, jsScopePoolSize: -1}));
+    assert.commandFailed(db.adminCommand({setParameter: 1, jsScopeMaxReuseSecs: -1}));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,48 @@
+/**
+ * Tests that with 'commandLatencyPercentilesEnabled' and 'namespaceLatencyPercentilesEnabled',
+ * latency percentiles are reported per command in serverStatus and per namespace in $collStats,
+ * for no more than 'maxNamespaceLatencyPercentileHistograms' namespaces.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            commandLatencyPercentilesEnabled: true,
+            maxNamespaceLatencyPercentileHistograms: 1,
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+
+    // Enable namespace tracking only now, so that the first namespace to be tracked is ours.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, namespaceLatencyPercentilesEnabled: true}));
+
+    const tracked = testDB.latency_percentiles_tracked;
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(tracked.insert({_id: i}));
+        assert.eq(1, tracked.find({_id: i}).itcount());
+    }
+
+    const percentiles = assert.commandWorked(testDB.adminCommand({serverStatus: 1}))
+                            .opLatencies.commandPercentiles;
+    assert(percentiles.hasOwnProperty("find"), tojson(percentiles));
+    assert.gte(percentiles.find.ops, 10, tojson(percentiles));
+    assert.gte(percentiles.insert.ops, 10, tojson(percentiles));
+    for (let field of ["p50", "p99", "p999"]) {
+        assert.lte(percentiles.find[field], percentiles.find.max, tojson(percentiles));
+    }
+
+    const latencyStats = tracked.aggregate([{$collStats: {latencyStats: {}}}]).next().latencyStats;
+    assert.gte(latencyStats.percentiles.ops, 20, tojson(latencyStats));
+
+    // The limit of tracked namespaces has been reached.
+    const untracked = testDB.latency_percentiles_untracked;
+    assert.writeOK(untracked.insert({_id: 0}));
+    assert(!untracked.aggregate([{$collStats: {latencyStats: {}}}])
+                .next()
+                .latencyStats.hasOwnProperty("percentiles"));
+
+    MongoRunner.stopMongod(conn);
+}());
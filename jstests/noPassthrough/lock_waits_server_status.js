@@ -0,0 +1,59 @@
+/**
+ * Tests that the waits for a collection lock are reported per resource by the 'lockWaits' section
+ * of serverStatus, and that $currentOp reports the resource an operation is waiting for.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.lock_waits_server_status;
+    assert.writeOK(coll.insert({_id: 0}));
+
+    // The section is only reported when asked for.
+    let serverStatus = assert.commandWorked(testDB.adminCommand({serverStatus: 1}));
+    assert(!serverStatus.hasOwnProperty("lockWaits"), tojson(serverStatus));
+
+    // Hold the collection lock, so that the insert below waits for it.
+    const sleeper = startParallelShell(() => {
+        assert.commandWorked(db.adminCommand(
+            {sleep: 1, secs: 5, lock: "w", lockTarget: "test.lock_waits_server_status"}));
+    }, conn.port);
+    assert.soon(() => testDB.getSiblingDB("admin")
+                          .aggregate([{$currentOp: {}}, {$match: {"command.sleep": 1}}])
+                          .itcount() === 1);
+
+    const writer = startParallelShell(() => {
+        assert.writeOK(db.getSiblingDB("test").lock_waits_server_status.insert({_id: 1}));
+    }, conn.port);
+
+    assert.soon(() => {
+        const ops = testDB.getSiblingDB("admin")
+                        .aggregate([{$currentOp: {}}, {$match: {waitingForLock: true}}])
+                        .toArray();
+        return ops.some(
+            (op) => op.waitingForLockResource.indexOf("test.lock_waits_server_status") !== -1);
+    });
+
+    sleeper();
+    writer();
+
+    serverStatus =
+        assert.commandWorked(testDB.adminCommand({serverStatus: 1, lockWaits: {top: 1}}));
+    const lockWaits = serverStatus.lockWaits;
+    assert.eq(1, lockWaits.sampleRate, tojson(lockWaits));
+    assert.eq(1, lockWaits.resources.length, tojson(lockWaits));
+    assert.neq(-1,
+               lockWaits.resources[0].resource.indexOf("test.lock_waits_server_status"),
+               tojson(lockWaits));
+    assert.gte(lockWaits.resources[0].waits, 1, tojson(lockWaits));
+
+    // Setting the sample rate to 0 stops the sampling.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, lockWaitSampleRate: 0}));
+    serverStatus = assert.commandWorked(testDB.adminCommand({serverStatus: 1, lockWaits: 1}));
+    assert.eq(0, serverStatus.lockWaits.sampleRate, tojson(serverStatus.lockWaits));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,59 @@
+/**
+ * Tests that a $lookup which looks its input documents up in batches, as set by
+ * 'internalDocumentSourceLookupBatchSize', returns the same matches as one which runs a query for
+ * each input document.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const local = testDB.lookup_batch_size_local;
+    const foreign = testDB.lookup_batch_size_foreign;
+    local.drop();
+    foreign.drop();
+
+    const localValues = [0, 1, 2.0, NumberLong(3), [4, 5], [], null, "a", "A", {x: 1}, 99];
+    for (let i = 0; i < 200; ++i) {
+        assert.writeOK(local.insert({_id: i, key: localValues[i % localValues.length]}));
+    }
+    assert.writeOK(local.insert({_id: "missing"}));
+
+    const foreignValues = [0, 1, NumberInt(2), 3, 4, [5, 6], null, "a", "a", {x: 1}];
+    for (let i = 0; i < foreignValues.length; ++i) {
+        assert.writeOK(foreign.insert({_id: i, key: foreignValues[i]}));
+    }
+    assert.writeOK(foreign.insert({_id: "missing"}));
+    assert.commandWorked(foreign.createIndex({key: 1}));
+
+    function runLookup(collation) {
+        const pipeline = [
+            {
+              $lookup:
+                  {from: foreign.getName(), localField: "key", foreignField: "key", as: "m"}
+            },
+            {$project: {m: "$m._id"}},
+            {$sort: {_id: 1}}
+        ];
+        const options = collation ? {collation: collation} : {};
+        return local.aggregate(pipeline, options).toArray().map(doc => ({
+                                                                   _id: doc._id,
+                                                                   m: doc.m.sort()
+                                                               }));
+    }
+
+    const collation = {locale: "en_US", strength: 2};
+    const expected = runLookup();
+    const expectedWithCollation = runLookup(collation);
+
+    for (let batchSize of [2, 7, 1000]) {
+        assert.commandWorked(testDB.adminCommand(
+            {setParameter: 1, internalDocumentSourceLookupBatchSize: batchSize}));
+        assert.eq(expected, runLookup());
+        assert.eq(expectedWithCollation, runLookup(collation));
+    }
+
+    MongoRunner.stopMongod(conn);
+}());
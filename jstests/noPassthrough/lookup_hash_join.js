@@ -0,0 +1,63 @@
+/**
+ * Tests that a $lookup which reads the foreign collection into a hash table, as enabled by
+ * 'internalDocumentSourceLookupUseHashJoin', returns the same matches as one which runs a query for
+ * each input document, whether the foreign documents fit in memory, are spilled to disk, or make it
+ * fall back to a query per input document.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const local = testDB.lookup_hash_join_local;
+    const foreign = testDB.lookup_hash_join_foreign;
+    local.drop();
+    foreign.drop();
+
+    const localValues = [0, 1, 2.0, NumberLong(3), [4, 5], [], null, "a", "A", {x: 1}, 99];
+    for (let i = 0; i < 200; ++i) {
+        assert.writeOK(local.insert({_id: i, key: localValues[i % localValues.length]}));
+    }
+    assert.writeOK(local.insert({_id: "missing"}));
+
+    const foreignValues = [0, 1, NumberInt(2), 3, 4, [5, 6], null, "a", "a", {x: 1}];
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(foreign.insert({_id: i, key: foreignValues[i % foreignValues.length]}));
+    }
+    assert.writeOK(foreign.insert({_id: "missing"}));
+
+    function runLookup(allowDiskUse, collation) {
+        const pipeline = [
+            {
+              $lookup:
+                  {from: foreign.getName(), localField: "key", foreignField: "key", as: "m"}
+            },
+            {$project: {m: "$m._id"}},
+            {$sort: {_id: 1}}
+        ];
+        const options = {allowDiskUse: allowDiskUse};
+        if (collation) {
+            options.collation = collation;
+        }
+        return local.aggregate(pipeline, options).toArray();
+    }
+
+    const collation = {locale: "en_US", strength: 2};
+    const expected = runLookup(false);
+    const expectedWithCollation = runLookup(false, collation);
+
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalDocumentSourceLookupUseHashJoin: true}));
+    for (let maxMemoryBytes of[100 * 1024 * 1024, 1024, 0]) {
+        assert.commandWorked(testDB.adminCommand(
+            {setParameter: 1, internalDocumentSourceLookupHashJoinMaxMemoryBytes: maxMemoryBytes}));
+        for (let allowDiskUse of[false, true]) {
+            assert.eq(expected, runLookup(allowDiskUse));
+            assert.eq(expectedWithCollation, runLookup(allowDiskUse, collation));
+        }
+    }
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,41 @@
+/**
+ * Tests that a mapReduce which spills its emits into the temporary collection, because they exceed
+ * 'internalQueryMapReduceMaxInMemBytes', returns the same results as one that keeps them in memory.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+    const coll = db.map_reduce_max_in_mem_bytes;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({_id: i, key: i % 300, value: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    function runMapReduce() {
+        const res = assert.commandWorked(db.runCommand({
+            mapReduce: coll.getName(),
+            map: function() {
+                emit(this.key, this.value);
+            },
+            reduce: function(key, values) {
+                return Array.sum(values);
+            },
+            out: "map_reduce_max_in_mem_bytes_out"
+        }));
+        return db[res.result].find().sort({_id: 1}).toArray();
+    }
+
+    const expected = runMapReduce();
+    assert.eq(300, expected.length);
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryMapReduceMaxInMemBytes: 1024}));
+    assert.eq(expected, runMapReduce());
+
+    MongoRunner.stopMongod(conn);
+}());
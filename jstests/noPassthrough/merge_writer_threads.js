@@ -0,0 +1,58 @@
+/**
+ * Tests that $merge and $out write the same documents when 'internalDocumentSourceWriterThreads'
+ * splits their batches among several threads.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {internalDocumentSourceWriterThreads: 4}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+    const source = db.merge_writer_threads_source;
+    const target = db.merge_writer_threads_target;
+
+    // Several source documents share each key, so that some updates of a target document must be
+    // made in order.
+    const numDocs = 5000;
+    const numKeys = 1000;
+    const bulk = source.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; ++i) {
+        bulk.insert({_id: i, key: i % numKeys, value: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(target.createIndex({key: 1}, {unique: true}));
+
+    function runMerge(whenMatched) {
+        source.aggregate([
+            {$sort: {_id: 1}},
+            {$project: {_id: 0, key: 1, value: 1, ["v" + whenMatched]: "$value"}},
+            {$merge: {into: target.getName(), on: "key", whenMatched: whenMatched}}
+        ]);
+    }
+
+    // Each key is upserted once and then replaced by the source documents with that key in order.
+    runMerge("replace");
+    assert.eq(numKeys, target.find().itcount());
+    for (let key of [0, 1, numKeys - 1]) {
+        const doc = target.findOne({key: key}, {_id: 0});
+        assert.eq({key: key, value: numDocs - numKeys + key, vreplace: numDocs - numKeys + key},
+                  doc);
+    }
+
+    runMerge("merge");
+    assert.eq(numKeys, target.find({vmerge: {$exists: true}, vreplace: {$exists: true}}).itcount());
+
+    // $out inserts the documents into a new collection.
+    const out = db.merge_writer_threads_out;
+    source.aggregate([{$addFields: {copy: true}}, {$out: out.getName()}]);
+    assert.eq(numDocs, out.find({copy: true}).itcount());
+
+    // A failed write still fails the aggregation.
+    assert.commandWorked(target.insert({key: "dup", value: 1}));
+    assert.throws(() => source.aggregate([
+        {$project: {_id: 0, key: {$literal: "dup"}}},
+        {$merge: {into: target.getName(), on: "key", whenMatched: "fail"}}
+    ]));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,34 @@
+/**
+ * Tests that serverStatus reports the contention of the Client and ServiceContext mutexes, which
+ * $currentOp and killOp take for every client.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const adminDB = conn.getDB("admin");
+
+    // Scan the clients from several shells at once while they run operations.
+    const shells = [];
+    for (let i = 0; i < 4; ++i) {
+        shells.push(startParallelShell(function() {
+            for (let j = 0; j < 100; ++j) {
+                assert.commandWorked(db.adminCommand({currentOp: 1}));
+                assert.writeOK(db.getSiblingDB("test").mutex_contention.insert({}));
+            }
+        }, conn.port));
+    }
+    shells.forEach((awaitShell) => awaitShell());
+
+    const section = assert.commandWorked(adminDB.runCommand({serverStatus: 1})).mutexContention;
+    assert.neq(undefined, section);
+    for (let name of ["Client", "ServiceContext"]) {
+        for (let field of ["spinAcquisitions", "parkedAcquisitions", "parkedMicros"]) {
+            assert.gte(section[name][field], 0, tojson(section));
+        }
+    }
+
+    MongoRunner.stopMongod(conn);
+}());
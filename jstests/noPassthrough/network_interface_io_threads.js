@@ -0,0 +1,41 @@
+/**
+ * Tests that with several 'networkInterfaceIOThreads', mongos still reaches every shard, and that
+ * connPoolStats reports the connections of every thread under one pool per network interface.
+ */
+(function() {
+    "use strict";
+
+    const st = new ShardingTest({
+        shards: 3,
+        mongos: 1,
+        other: {mongosOptions: {setParameter: {networkInterfaceIOThreads: 4}}}
+    });
+
+    const dbName = "test";
+    const coll = st.s.getDB(dbName).network_interface_io_threads;
+    assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, st.shard0.shardName);
+    assert.commandWorked(
+        st.s.adminCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+    for (let [middle, shard] of [[100, st.shard1], [200, st.shard2]]) {
+        assert.commandWorked(st.s.adminCommand({split: coll.getFullName(), middle: {_id: middle}}));
+        assert.commandWorked(st.s.adminCommand(
+            {moveChunk: coll.getFullName(), find: {_id: middle}, to: shard.shardName}));
+    }
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 300; ++i) {
+        bulk.insert({_id: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.eq(300, coll.find().itcount());
+
+    const stats = assert.commandWorked(st.s.adminCommand({connPoolStats: 1}));
+    for (let shard of [st.rs0, st.rs1, st.rs2]) {
+        const host = shard.getPrimary().host;
+        assert(stats.hosts.hasOwnProperty(host), tojson(stats));
+        assert.gt(stats.hosts[host].created, 0, tojson(stats));
+    }
+
+    st.stop();
+})();
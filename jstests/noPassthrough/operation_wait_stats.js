@@ -0,0 +1,37 @@
+/**
+ * Tests that the time an operation spends waiting for write concern and for new data on an
+ * awaitData cursor is reported in the "waits" section of the profiler.
+ * @tags: [requires_replication, requires_capped]
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    const testDB = rst.getPrimary().getDB("test");
+    assert.commandWorked(testDB.createCollection("capped", {capped: true, size: 4096}));
+    assert.writeOK(testDB.capped.insert({_id: 0}));
+    assert.commandWorked(testDB.setProfilingLevel(2));
+
+    // A write concern with 'j: true' waits for the journal to be flushed.
+    assert.commandWorked(testDB.runCommand(
+        {insert: "coll", documents: [{_id: 1}], writeConcern: {w: 1, j: true}, comment: "wc"}));
+    const insertEntry = testDB.system.profile.findOne({"command.comment": "wc"});
+    assert.neq(null, insertEntry);
+    assert(insertEntry.hasOwnProperty("waits"), tojson(insertEntry));
+    assert(insertEntry.waits.hasOwnProperty("writeConcernMicros"), tojson(insertEntry));
+
+    // A getMore on an exhausted tailable awaitData cursor waits for 'maxTimeMS' for new data.
+    const res = assert.commandWorked(
+        testDB.runCommand({find: "capped", batchSize: 1, tailable: true, awaitData: true}));
+    assert.commandWorked(testDB.runCommand(
+        {getMore: res.cursor.id, collection: "capped", maxTimeMS: 500}));
+    const getMoreEntry =
+        testDB.system.profile.findOne({op: "getmore", ns: testDB.capped.getFullName()});
+    assert.neq(null, getMoreEntry);
+    assert.gte(getMoreEntry.waits.awaitDataMicros, 400 * 1000, tojson(getMoreEntry));
+
+    rst.stopSet();
+}());
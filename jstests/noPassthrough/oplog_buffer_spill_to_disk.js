@@ -0,0 +1,49 @@
+/**
+ * Tests that a secondary whose oplog buffer spills to a file, as set by 'oplogBufferSpillToDisk',
+ * replicates the writes made while its applier is paused and reports the size of the spill file
+ * in the maximum size of its buffer.
+ *
+ * @tags: [requires_replication]
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({
+        nodes: [{}, {rsConfig: {priority: 0}}],
+        nodeOptions: {setParameter: {oplogBufferSpillToDisk: true, oplogBufferMaxSpillSizeMB: 16}}
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const secondary = rst.getSecondary();
+    const testDB = primary.getDB("test");
+
+    function bufferStats() {
+        return assert.commandWorked(secondary.adminCommand({serverStatus: 1})).metrics.repl.buffer;
+    }
+
+    const buffer = bufferStats();
+    assert.eq((256 + 16) * 1024 * 1024, buffer.maxSizeBytes, tojson(buffer));
+
+    // Let the fetched operations pile up in the buffer while the applier is paused.
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: "rsSyncApplyStop", mode: "alwaysOn"}));
+    for (let i = 0; i < 20; ++i) {
+        const bulk = testDB.coll.initializeUnorderedBulkOp();
+        for (let j = 0; j < 100; ++j) {
+            bulk.insert({_id: i * 100 + j, x: "x".repeat(1000)});
+        }
+        assert.writeOK(bulk.execute());
+    }
+    assert.soon(() => bufferStats().count > 0);
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: "rsSyncApplyStop", mode: "off"}));
+
+    rst.awaitReplication();
+    secondary.setSlaveOk();
+    assert.eq(2000, secondary.getDB("test").coll.find().itcount());
+    rst.checkReplicatedDataHashes();
+
+    rst.stopSet();
+}());
@@ -0,0 +1,54 @@
+/**
+ * Tests that secondaries which add each fetched oplog batch to their buffer while the next one is
+ * fetched, as set by 'oplogFetcherEnqueueWhileFetching', end up with the same data as the primary,
+ * including through an initial sync.
+ *
+ * @tags: [requires_replication]
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({
+        nodes: [{}, {rsConfig: {priority: 0}}],
+        nodeOptions: {setParameter: {oplogFetcherEnqueueWhileFetching: true}}
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+
+    function writeBatches(start) {
+        for (let i = start; i < start + 50; ++i) {
+            const bulk = testDB.coll.initializeUnorderedBulkOp();
+            for (let j = 0; j < 100; ++j) {
+                bulk.insert({_id: i * 100 + j, x: j});
+            }
+            assert.writeOK(bulk.execute());
+            assert.writeOK(testDB.coll.update({_id: i * 100}, {$inc: {n: 1}}));
+        }
+    }
+
+    writeBatches(0);
+    rst.awaitReplication();
+
+    const secondary = rst.getSecondary();
+    const metrics =
+        assert.commandWorked(secondary.adminCommand({serverStatus: 1})).metrics.repl.network;
+    assert.gt(metrics.batchesEnqueuedWhileFetching, 0, tojson(metrics));
+
+    // Initial sync fetches the oplog with the same fetcher.
+    const newSecondary = rst.add({rsConfig: {priority: 0, votes: 0}});
+    rst.reInitiate();
+    writeBatches(50);
+    rst.awaitSecondaryNodes();
+    rst.awaitReplication();
+
+    for (let node of [secondary, newSecondary]) {
+        node.setSlaveOk();
+        assert.eq(10000, node.getDB("test").coll.find().itcount());
+    }
+    rst.checkReplicatedDataHashes();
+
+    rst.stopSet();
+}());
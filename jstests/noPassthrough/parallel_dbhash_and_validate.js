@@ -0,0 +1,48 @@
+/**
+ * Tests that dbHash and validate return the same results when 'dbHashCollectionThreads' and
+ * 'validateIndexTraversalThreads' let them hash collections and traverse indexes on several
+ * threads as they do on the command's thread.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+
+    for (let i = 0; i < 5; ++i) {
+        const coll = db["coll" + i];
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let j = 0; j < 500; ++j) {
+            bulk.insert({_id: j, a: j % 7, b: [j, j + i], c: "x".repeat(j % 20)});
+        }
+        assert.writeOK(bulk.execute());
+        assert.commandWorked(coll.createIndexes([{a: 1}, {b: 1}, {c: 1, a: -1}]));
+    }
+    assert.commandWorked(db.createCollection("capped", {capped: true, size: 4096}));
+    assert.writeOK(db.capped.insert({x: 1}));
+
+    function runChecks() {
+        const dbHash = assert.commandWorked(db.runCommand({dbHash: 1}));
+        const validates = db.getCollectionNames().map(function(collName) {
+            const res = assert.commandWorked(db.runCommand({validate: collName, full: true}));
+            assert(res.valid, tojson(res));
+            return {collName: collName, nrecords: res.nrecords, keysPerIndex: res.keysPerIndex};
+        });
+        return {md5: dbHash.md5, collections: dbHash.collections, validates: validates};
+    }
+
+    const expected = runChecks();
+
+    assert.commandWorked(db.adminCommand(
+        {setParameter: 1, dbHashCollectionThreads: 4, validateIndexTraversalThreads: 4}));
+    assert.eq(expected, runChecks());
+
+    // Hashing only some of the collections gives each of them the same hash.
+    const subset =
+        assert.commandWorked(db.runCommand({dbHash: 1, collections: ["coll0", "coll3"]}));
+    assert.eq({coll0: expected.collections.coll0, coll3: expected.collections.coll3},
+              subset.collections);
+
+    MongoRunner.stopMongod(conn);
+}());
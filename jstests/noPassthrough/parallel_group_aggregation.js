@@ -0,0 +1,79 @@
+/**
+ * Tests that an aggregation whose $group runs in parallel partial groups, as set by
+ * 'internalQueryParallelAggregationConsumers', returns the same results as one which groups on a
+ * single thread.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.parallel_group_aggregation;
+    coll.drop();
+
+    const kNumKeys = 50;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({key: i % kNumKeys, val: i, str: "s" + (i % 13), skip: i % 3 == 0});
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipelines = [
+        [
+          {$match: {skip: false}},
+          {
+            $group: {
+                _id: "$key",
+                count: {$sum: 1},
+                total: {$sum: "$val"},
+                avg: {$avg: "$val"},
+                min: {$min: "$val"},
+                max: {$max: "$val"},
+                strs: {$addToSet: "$str"}
+            }
+          },
+          {$sort: {_id: 1}}
+        ],
+        [{$group: {_id: null, count: {$sum: 1}, std: {$stdDevPop: "$val"}}}],
+        [
+          {$group: {_id: {$mod: ["$val", 7]}, n: {$sum: 1}}},
+          {$match: {n: {$gt: 0}}},
+          {$sort: {_id: 1}}
+        ],
+        [{$match: {key: -1}}, {$group: {_id: "$key", n: {$sum: 1}}}],
+    ];
+
+    function runAll() {
+        return pipelines.map(pipeline => {
+            return coll.aggregate(pipeline, {cursor: {batchSize: 2}}).toArray().map(doc => {
+                if (doc.strs) {
+                    doc.strs.sort();
+                }
+                if (doc.std) {
+                    doc.std = Math.round(doc.std * 1000);
+                }
+                return doc;
+            });
+        });
+    }
+
+    const expected = runAll();
+    for (let consumers of [2, 5]) {
+        assert.commandWorked(testDB.adminCommand(
+            {setParameter: 1, internalQueryParallelAggregationConsumers: consumers}));
+        assert.eq(expected, runAll());
+    }
+
+    // A $group which fails on one of the consumers fails the aggregation.
+    assert.commandWorked(testDB.adminCommand(
+        {setParameter: 1, internalQueryParallelAggregationConsumers: 4}));
+    assert.commandFailed(testDB.runCommand({
+        aggregate: coll.getName(),
+        pipeline: [{$group: {_id: {$divide: ["$val", "$key"]}}}],
+        cursor: {}
+    }));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,74 @@
+/**
+ * Tests that the plan cache entries saved by the planCacheSnapshot command are restored after a
+ * restart, the first time a query of their shape is planned.
+ * @tags: [requires_persistence]
+ */
+(function() {
+    "use strict";
+
+    const dbName = "test";
+    const collName = "plan_cache_snapshot";
+    const query = {a: 1, b: 1};
+
+    function getCachedPlans(coll) {
+        const cmdRes =
+            assert.commandWorked(coll.runCommand("planCacheListPlans", {query: query}));
+        return cmdRes.plans;
+    }
+
+    let conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    let coll = conn.getDB(dbName).getCollection(collName);
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; ++i) {
+        bulk.insert({a: i % 10, b: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}, {name: "a_1"}));
+    assert.commandWorked(coll.createIndex({b: 1}, {name: "b_1"}));
+
+    // Running the query twice leaves an active entry in the plan cache.
+    assert.eq(1, coll.find(query).itcount());
+    assert.eq(1, coll.find(query).itcount());
+    let plans = getCachedPlans(coll);
+    assert.eq(2, plans.length, tojson(plans));
+
+    let cmdRes = assert.commandWorked(coll.runCommand("planCacheSnapshot"));
+    assert.eq(1, cmdRes.saved, tojson(cmdRes));
+    assert.eq(1, conn.getDB("local").plan_cache_snapshot.find({ns: coll.getFullName()}).itcount());
+
+    // Taking another snapshot replaces the saved entries.
+    assert.commandWorked(coll.runCommand("planCacheSnapshot"));
+    assert.eq(1, conn.getDB("local").plan_cache_snapshot.find({ns: coll.getFullName()}).itcount());
+
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod({restart: true, dbpath: conn.dbpath, cleanData: false});
+    assert.neq(null, conn, "mongod was unable to restart");
+    coll = conn.getDB(dbName).getCollection(collName);
+
+    // The entry only comes back once a query of its shape is planned.
+    assert.eq(0, getCachedPlans(coll).length);
+    assert.eq(1, coll.find({a: 2, b: 2}).itcount());
+    // Only the winning plan is saved.
+    plans = getCachedPlans(coll);
+    assert.eq(1, plans.length, tojson(plans));
+    assert.eq("RESTORED_FROM_SNAPSHOT", plans[0].reason.stats.stage, tojson(plans));
+
+    // Without the knob, the saved entries are left alone.
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod({
+        restart: true,
+        dbpath: conn.dbpath,
+        cleanData: false,
+        setParameter: {internalQueryCacheRestoreSnapshots: false}
+    });
+    assert.neq(null, conn, "mongod was unable to restart");
+    coll = conn.getDB(dbName).getCollection(collName);
+    assert.eq(1, coll.find({a: 2, b: 2}).itcount());
+    plans = getCachedPlans(coll);
+    assert.eq(2, plans.length, tojson(plans));
+    assert.neq("RESTORED_FROM_SNAPSHOT", plans[0].reason.stats.stage, tojson(plans));
+
+    MongoRunner.stopMongod(conn);
+}());
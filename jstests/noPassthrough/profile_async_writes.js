@@ -0,0 +1,34 @@
+/**
+ * Tests that with 'profilerAsynchronousWrites', the profile entries of operations are written to
+ * system.profile in the background.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {profilerAsynchronousWrites: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("profile_async_writes");
+    const coll = testDB.coll;
+    assert.commandWorked(testDB.dropDatabase());
+    assert.writeOK(coll.insert({_id: 0}));
+    assert.commandWorked(testDB.setProfilingLevel(2));
+
+    for (let i = 0; i < 50; ++i) {
+        assert.eq(1, coll.find({_id: 0, i: {$ne: i}}).comment("async" + i).itcount());
+    }
+
+    // The entries show up once the background writer has inserted them.
+    assert.soon(() => testDB.system.profile.find({"command.comment": /^async/}).itcount() === 50);
+
+    const profileOptions = testDB.getCollectionInfos({name: "system.profile"})[0].options;
+    assert.eq(true, profileOptions.capped, tojson(profileOptions));
+
+    // Entries written by the operations themselves go to the same collection.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, profilerAsynchronousWrites: false}));
+    assert.eq(1, coll.find({_id: 0}).comment("sync").itcount());
+    assert.eq(1, testDB.system.profile.find({"command.comment": "sync"}).itcount());
+
+    MongoRunner.stopMongod(conn);
+}());
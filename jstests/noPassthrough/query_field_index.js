@@ -0,0 +1,51 @@
+/**
+ * Tests that a filter over wide documents returns the same results when the documents' fields are
+ * indexed for lookup, as set by 'internalQueryFieldIndexMinFields'.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.query_field_index;
+    coll.drop();
+
+    const kNumFields = 250;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 200; ++i) {
+        const doc = {_id: i};
+        for (let f = 0; f < kNumFields; ++f) {
+            doc["f" + f] = (i + f) % 7;
+        }
+        doc.sub = {a: i % 5, b: [i % 3, {c: i % 2}]};
+        bulk.insert(doc);
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({f0: 1}));
+
+    const queries = [
+        {f10: 3, f200: {$gt: 2}, f249: {$in: [1, 5]}},
+        {$or: [{f1: 0}, {"sub.a": 2}]},
+        {"sub.b": 1, "sub.b.c": 1},
+        {"sub.b.1.c": 0, missing: {$exists: false}},
+        {f0: {$lt: 3}, f248: {$ne: 4}},
+        {$expr: {$eq: ["$f5", "$f12"]}},
+    ];
+
+    function runAll() {
+        return queries.map(query => {
+            return coll.find(query, {_id: 1}).sort({_id: 1}).batchSize(3).toArray();
+        });
+    }
+
+    const expected = runAll();
+    for (let minFields of [1, kNumFields, kNumFields * 10]) {
+        assert.commandWorked(
+            testDB.adminCommand({setParameter: 1, internalQueryFieldIndexMinFields: minFields}));
+        assert.eq(expected, runAll());
+    }
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -15,6 +15,7 @@
         internalQueryPlanEvaluationCollFraction: 0.3,
         internalQueryPlanEvaluationMaxResults: 101,
         internalQueryCacheSize: 5000,
+        internalQueryCachePartitions: 16,
         internalQueryCacheFeedbacksStored: 20,
         internalQueryCacheEvictionRatio: 10.0,
         internalQueryCacheWorksGrowthCoefficient: 2.0,
@@ -23,25 +24,49 @@
         internalQueryPlannerMaxIndexedSolutions: 64,
         internalQueryEnumerationMaxOrSolutions: 10,
         internalQueryEnumerationMaxIntersectPerAnd: 3,
+        internalQueryEnumerationGreedyThreshold: 0,
         internalQueryForceIntersectionPlans: false,
         internalQueryPlannerEnableIndexIntersection: true,
         internalQueryPlannerEnableHashIntersection: false,
         internalQueryPlanOrChildrenIndependently: true,
         internalQueryMaxScansToExplode: 200,
+        internalQueryMaxScansToExplodeWithStatistics: 1000,
+        internalQueryMaxKeysPerScanToExplode: 10.0,
         internalQueryExecMaxBlockingSortBytes: 32 * 1024 * 1024,
         internalQueryExecYieldIterations: 128,
         internalQueryExecYieldPeriodMS: 10,
         internalQueryFacetBufferSizeBytes: 100 * 1024 * 1024,
         internalDocumentSourceCursorBatchSizeBytes: 4 * 1024 * 1024,
+        internalDocumentSourceCursorLazyDocuments: false,
+        internalDocumentBufferPoolMaxBytes: 0,
+        internalDocumentSourceSortKeyStrings: false,
+        internalBufBuilderPoolMaxBytes: 0,
         internalDocumentSourceLookupCacheSizeBytes: 100 * 1024 * 1024,
+        internalDocumentSourceLookupBatchSize: 0,
+        internalDocumentSourceLookupUseHashJoin: false,
+        internalDocumentSourceLookupHashJoinMaxMemoryBytes: 100 * 1024 * 1024,
         internalDocumentSourceSortMaxBlockingSortBytes: 100 * 1024 * 1024,
         internalLookupStageIntermediateDocumentMaxSizeBytes: 100 * 1024 * 1024,
         internalDocumentSourceGroupMaxMemoryBytes: 100 * 1024 * 1024,
+        internalDocumentSourceGroupSpillPartitions: 0,
+        internalQueryParallelAggregationConsumers: 0,
+        internalQueryAggregationResultCacheMaxSizeBytes: 0,
+        internalQueryAggregationResultCacheMaxStalenessMS: 0,
+        internalQueryCompileProjectionExpressions: false,
+        internalQueryFieldIndexMinFields: 0,
+        internalQueryCompileMatchExpressions: false,
+        internalQueryInHashedMinEqualities: 0,
+        internalQueryRegexLiteralPrefilter: false,
+        internalQueryAdaptiveAndOrderInterval: 0,
+        internalQueryReadOnceCollScanHotIndexAccessesPerMinute: 0,
         // Should be half the value of 'internalQueryExecYieldIterations' parameter.
         internalInsertMaxBatchSize: 64,
+        internalInsertSortIndexKeysAcrossBatch: false,
+        internalUpdateSkipUnaffectedIndexes: false,
         internalQueryPlannerGenerateCoveredWholeIndexScans: false,
         internalQueryIgnoreUnknownJSONSchemaKeywords: false,
         internalQueryProhibitBlockingMergeOnMongoS: false,
+        internalQueryExplainCollectHardwareCounters: true,
     };
 
     function assertDefaultParameterValues() {
@@ -89,6 +114,9 @@
     assertSetParameterSucceeds("internalQueryCacheSize", 0);
     assertSetParameterFails("internalQueryCacheSize", -1);
 
+    assertSetParameterSucceeds("internalQueryCachePartitions", 1);
+    assertSetParameterFails("internalQueryCachePartitions", 0);
+
     assertSetParameterSucceeds("internalQueryCacheFeedbacksStored", 1);
     assertSetParameterSucceeds("internalQueryCacheFeedbacksStored", 0);
     assertSetParameterFails("internalQueryCacheFeedbacksStored", -1);
@@ -113,10 +141,22 @@
     assertSetParameterSucceeds("internalQueryEnumerationMaxIntersectPerAnd", 0);
     assertSetParameterFails("internalQueryEnumerationMaxIntersectPerAnd", -1);
 
+    assertSetParameterSucceeds("internalQueryEnumerationGreedyThreshold", 100);
+    assertSetParameterSucceeds("internalQueryEnumerationGreedyThreshold", 0);
+    assertSetParameterFails("internalQueryEnumerationGreedyThreshold", -1);
+
     assertSetParameterSucceeds("internalQueryMaxScansToExplode", 11);
     assertSetParameterSucceeds("internalQueryMaxScansToExplode", 0);
     assertSetParameterFails("internalQueryMaxScansToExplode", -1);
 
+    assertSetParameterSucceeds("internalQueryMaxScansToExplodeWithStatistics", 11);
+    assertSetParameterSucceeds("internalQueryMaxScansToExplodeWithStatistics", 0);
+    assertSetParameterFails("internalQueryMaxScansToExplodeWithStatistics", -1);
+
+    assertSetParameterSucceeds("internalQueryMaxKeysPerScanToExplode", 2.5);
+    assertSetParameterSucceeds("internalQueryMaxKeysPerScanToExplode", 0.0);
+    assertSetParameterFails("internalQueryMaxKeysPerScanToExplode", -1.0);
+
     assertSetParameterSucceeds("internalQueryExecMaxBlockingSortBytes", 11);
     assertSetParameterSucceeds("internalQueryExecMaxBlockingSortBytes", 0);
     assertSetParameterFails("internalQueryExecMaxBlockingSortBytes", -1);
@@ -145,6 +185,44 @@
     assertSetParameterFails("internalDocumentSourceGroupMaxMemoryBytes", 0);
     assertSetParameterFails("internalDocumentSourceGroupMaxMemoryBytes", -1);
 
+    assertSetParameterSucceeds("internalDocumentSourceGroupSpillPartitions", 16);
+    assertSetParameterSucceeds("internalDocumentSourceGroupSpillPartitions", 0);
+    assertSetParameterFails("internalDocumentSourceGroupSpillPartitions", -1);
+    assertSetParameterFails("internalDocumentSourceGroupSpillPartitions", 1025);
+
+    assertSetParameterSucceeds("internalQueryParallelAggregationConsumers", 4);
+    assertSetParameterSucceeds("internalQueryParallelAggregationConsumers", 0);
+    assertSetParameterFails("internalQueryParallelAggregationConsumers", -1);
+    assertSetParameterFails("internalQueryParallelAggregationConsumers", 101);
+
+    assertSetParameterSucceeds("internalQueryAggregationResultCacheMaxSizeBytes", 1024 * 1024);
+    assertSetParameterSucceeds("internalQueryAggregationResultCacheMaxSizeBytes", 0);
+    assertSetParameterFails("internalQueryAggregationResultCacheMaxSizeBytes", -1);
+
+    assertSetParameterSucceeds("internalQueryAggregationResultCacheMaxStalenessMS", 1000);
+    assertSetParameterSucceeds("internalQueryAggregationResultCacheMaxStalenessMS", 0);
+    assertSetParameterFails("internalQueryAggregationResultCacheMaxStalenessMS", -1);
+
+    assertSetParameterSucceeds("internalQueryFieldIndexMinFields", 100);
+    assertSetParameterSucceeds("internalQueryFieldIndexMinFields", 0);
+    assertSetParameterFails("internalQueryFieldIndexMinFields", -1);
+
+    assertSetParameterSucceeds("internalDocumentBufferPoolMaxBytes", 1024 * 1024);
+    assertSetParameterSucceeds("internalDocumentBufferPoolMaxBytes", 0);
+    assertSetParameterFails("internalDocumentBufferPoolMaxBytes", -1);
+
+    assertSetParameterSucceeds("internalBufBuilderPoolMaxBytes", 1024 * 1024);
+    assertSetParameterSucceeds("internalBufBuilderPoolMaxBytes", 0);
+    assertSetParameterFails("internalBufBuilderPoolMaxBytes", -1);
+
+    assertSetParameterSucceeds("internalQueryInHashedMinEqualities", 1000);
+    assertSetParameterSucceeds("internalQueryInHashedMinEqualities", 0);
+    assertSetParameterFails("internalQueryInHashedMinEqualities", -1);
+
+    assertSetParameterSucceeds("internalQueryAdaptiveAndOrderInterval", 1000);
+    assertSetParameterSucceeds("internalQueryAdaptiveAndOrderInterval", 0);
+    assertSetParameterFails("internalQueryAdaptiveAndOrderInterval", -1);
+
     // Internal BSON max object size is slightly larger than the max user object size, to
     // accommodate command metadata.
     const bsonUserSizeLimit = assert.commandWorked(testDB.isMaster()).maxBsonObjectSize;
@@ -166,6 +244,18 @@
     assertSetParameterSucceeds("internalDocumentSourceLookupCacheSizeBytes", 0);
     assertSetParameterFails("internalDocumentSourceLookupCacheSizeBytes", -1);
 
+    assertSetParameterSucceeds("internalDocumentSourceLookupBatchSize", 100);
+    assertSetParameterSucceeds("internalDocumentSourceLookupBatchSize", 0);
+    assertSetParameterFails("internalDocumentSourceLookupBatchSize", -1);
+
+    assertSetParameterSucceeds("internalDocumentSourceLookupHashJoinMaxMemoryBytes", 1024);
+    assertSetParameterSucceeds("internalDocumentSourceLookupHashJoinMaxMemoryBytes", 0);
+    assertSetParameterFails("internalDocumentSourceLookupHashJoinMaxMemoryBytes", -1);
+
+    assertSetParameterSucceeds("internalQueryReadOnceCollScanHotIndexAccessesPerMinute", 100);
+    assertSetParameterSucceeds("internalQueryReadOnceCollScanHotIndexAccessesPerMinute", 0);
+    assertSetParameterFails("internalQueryReadOnceCollScanHotIndexAccessesPerMinute", -1);
+
     MongoRunner.stopMongod(conn);
 
 })();
@@ -0,0 +1,79 @@
+/**
+ * Tests that with 'internalQueryMaxTotalMemoryUsageBytes' a blocking sort or $group which pushes
+ * the memory used by all queries over the budget spills to disk when 'allowDiskUse' is set, and
+ * fails the operation using the most memory otherwise.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.query_memory_budget;
+    coll.drop();
+
+    // Insert ~4MB of data, in an order which differs from the sort order.
+    const largeStr = "x".repeat(32 * 1024);
+    const kNumDocs = 128;
+    for (let i = 0; i < kNumDocs; ++i) {
+        assert.writeOK(coll.insert({a: largeStr, b: (i * 37) % kNumDocs}));
+    }
+
+    const findCmd = {find: coll.getName(), sort: {b: 1}, projection: {a: 0}};
+    const groupCmd = {
+        aggregate: coll.getName(),
+        pipeline: [{$group: {_id: "$b", docs: {$push: "$a"}}}, {$project: {docs: 0}}],
+        cursor: {}
+    };
+
+    function setBudget(bytes) {
+        assert.commandWorked(
+            testDB.adminCommand({setParameter: 1, internalQueryMaxTotalMemoryUsageBytes: bytes}));
+    }
+
+    // Without a budget, both fit within their own limits.
+    assert.eq(kNumDocs,
+              new DBCommandCursor(testDB, assert.commandWorked(testDB.runCommand(findCmd)))
+                  .itcount());
+    assert.eq(kNumDocs,
+              new DBCommandCursor(testDB, assert.commandWorked(testDB.runCommand(groupCmd)))
+                  .itcount());
+
+    setBudget(2 * 1024 * 1024);
+
+    // An operation which cannot spill is the largest consumer, so it fails.
+    assert.commandFailedWithCode(testDB.runCommand(findCmd), ErrorCodes.ExceededMemoryLimit);
+    assert.commandFailedWithCode(testDB.runCommand(groupCmd), ErrorCodes.ExceededMemoryLimit);
+
+    // With 'allowDiskUse', the stages spill instead and return everything.
+    const sorted = new DBCommandCursor(testDB,
+                                       assert.commandWorked(testDB.runCommand(
+                                           Object.merge(findCmd, {allowDiskUse: true}))))
+                       .toArray();
+    assert.eq(kNumDocs, sorted.length);
+    for (let i = 0; i < kNumDocs; ++i) {
+        assert.eq(i, sorted[i].b, tojson(sorted[i]));
+    }
+    assert.eq(kNumDocs,
+              new DBCommandCursor(testDB,
+                                  assert.commandWorked(testDB.runCommand(
+                                      Object.merge(groupCmd, {allowDiskUse: true}))))
+                  .itcount());
+
+    const explain = assert.commandWorked(testDB.runCommand({
+        explain: Object.merge(findCmd, {allowDiskUse: true}),
+        verbosity: "executionStats"
+    }));
+    const sortStage = getPlanStage(explain.executionStats.executionStages, "SORT");
+    assert.neq(null, sortStage, tojson(explain));
+    assert.eq(1, sortStage.spills, tojson(sortStage));
+
+    // Removing the budget restores the in-memory behaviour.
+    setBudget(0);
+    assert.commandWorked(testDB.runCommand(findCmd));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,55 @@
+/**
+ * Tests that '_readBackupFile' only reads files of the dbpath while a backup cursor is open, and
+ * that it returns them in chunks which add up to the whole file.
+ *
+ * @tags: [requires_persistence, requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const adminDB = conn.getDB("admin");
+
+    assert.commandFailedWithCode(
+        adminDB.runCommand({_readBackupFile: "WiredTiger", offset: 0, length: 1024}),
+        ErrorCodes.IllegalOperation);
+
+    const isEnterprise = adminDB.runCommand({buildInfo: 1}).modules.includes("enterprise");
+    if (isEnterprise) {
+        const backupCursor = adminDB.aggregate([{$backupCursor: {}}]);
+        // The first document is the preamble.
+        backupCursor.next();
+
+        const chunkLength = 4096;
+        while (backupCursor.hasNext()) {
+            const file = backupCursor.next();
+            let offset = 0;
+            let res;
+            do {
+                res = assert.commandWorked(adminDB.runCommand(
+                    {_readBackupFile: file.filename, offset: offset, length: chunkLength}));
+                assert.eq(file.fileSize, res.fileSize, tojson(file));
+                assert.eq(32, res.md5.length, tojson(file));
+                offset += res.data.length();
+            } while (!res.eof);
+            assert.eq(file.fileSize, offset, tojson(file));
+        }
+
+        assert.commandFailedWithCode(
+            adminDB.runCommand({_readBackupFile: "WiredTiger", offset: 1 << 30, length: 1}),
+            51320);
+        assert.commandFailedWithCode(
+            adminDB.runCommand({_readBackupFile: "WiredTiger", offset: 0, length: 0}),
+            ErrorCodes.BadValue);
+        assert.commandFailedWithCode(
+            adminDB.runCommand({_readBackupFile: "journal", offset: 0, length: 1}),
+            ErrorCodes.FileNotOpen);
+        assert.commandFailedWithCode(
+            adminDB.runCommand({_readBackupFile: "/etc/hosts", offset: 0, length: 1}),
+            ErrorCodes.Unauthorized);
+        backupCursor.close();
+    }
+
+    MongoRunner.stopMongod(conn);
+}());
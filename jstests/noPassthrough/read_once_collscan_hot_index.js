@@ -0,0 +1,45 @@
+/**
+ * Tests that a find which scans a collection with a hot index, and so reads the collection with
+ * read-once cursors as set by 'internalQueryReadOnceCollScanHotIndexAccessesPerMinute', returns
+ * the same results across getMores as one which uses regular cursors.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.read_once_collscan_hot_index;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, a: i % 10, b: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    // Make the index on 'a' hot, then compare collection scans, including ones which are chosen
+    // by the multi-planner.
+    for (let i = 0; i < 20; ++i) {
+        assert.eq(100, coll.find({a: i % 10}).itcount());
+    }
+
+    function runScans() {
+        return [
+            coll.find({b: {$gte: 500}}).sort({_id: 1}).batchSize(7).toArray(),
+            coll.find({a: {$gte: 0}, b: {$lt: 20}}).sort({_id: 1}).batchSize(3).toArray(),
+            coll.find().hint({$natural: 1}).batchSize(50).toArray(),
+        ];
+    }
+
+    const expected = runScans();
+    assert.commandWorked(testDB.adminCommand(
+        {setParameter: 1, internalQueryReadOnceCollScanHotIndexAccessesPerMinute: 1}));
+    assert.eq(expected, runScans());
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,53 @@
+/**
+ * Tests that with 'internalQueryRegexLiteralPrefilter' enabled, a $regex matches the same
+ * documents as when every string is handed to the regular expression.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.regex_literal_prefilter;
+    coll.drop();
+
+    const messages = [
+        "error: connection timeout",
+        "timeout before error",
+        "ERROR: Timeout",
+        "warning: slow query",
+        "error\ntimeout",
+        "café closed",
+        "cafe closed",
+        "abe",
+        "abcde",
+    ];
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 500; ++i) {
+        bulk.insert({_id: i, msg: messages[i % messages.length] + " #" + i});
+    }
+    assert.writeOK(bulk.execute());
+
+    const regexes = [
+        /error.*timeout/,
+        /error.*timeout/s,
+        /error.*timeout/i,
+        /^error/m,
+        /caf(é|e) closed/,
+        /ab(c|d)?e/,
+        /slow|closed/,
+        /#1\d+$/,
+    ];
+
+    function runAll() {
+        return regexes.map(regex => coll.find({msg: regex}).sort({_id: 1}).toArray());
+    }
+
+    const expected = runAll();
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryRegexLiteralPrefilter: true}));
+    assert.eq(expected, runAll());
+
+    MongoRunner.stopMongod(conn);
+}());
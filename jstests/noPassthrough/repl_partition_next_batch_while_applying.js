@@ -0,0 +1,43 @@
+/**
+ * Tests that secondaries which partition the next oplog batch while they apply the current one,
+ * as set by 'replPartitionNextBatchWhileApplying', end up with the same data as the primary.
+ *
+ * @tags: [requires_replication]
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest(
+        {nodes: 2, nodeOptions: {setParameter: {replPartitionNextBatchWhileApplying: true}}});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+    assert.commandWorked(testDB.createCollection("a"));
+    assert.commandWorked(testDB.createCollection("b"));
+
+    // Interleave small unordered batches of inserts and updates, so that the secondary applies
+    // many batches of CRUD operations back to back.
+    for (let i = 0; i < 100; ++i) {
+        const bulkA = testDB.a.initializeUnorderedBulkOp();
+        const bulkB = testDB.b.initializeUnorderedBulkOp();
+        for (let j = 0; j < 100; ++j) {
+            bulkA.insert({_id: i * 100 + j, x: j});
+            bulkB.find({_id: j}).upsert().updateOne({$inc: {n: 1}});
+        }
+        assert.writeOK(bulkA.execute());
+        assert.writeOK(bulkB.execute());
+    }
+    rst.awaitReplication();
+
+    const secondaryDB = rst.getSecondary().getDB("test");
+    assert.eq(10000, secondaryDB.a.find().itcount());
+    assert.eq(100, secondaryDB.b.find({n: 100}).itcount());
+
+    const metrics =
+        assert.commandWorked(secondaryDB.adminCommand({serverStatus: 1})).metrics.repl.apply;
+    assert.gte(metrics.batchesPartitionedWhileApplying, 0, tojson(metrics));
+
+    rst.stopSet();
+}());
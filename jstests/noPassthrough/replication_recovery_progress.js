@@ -0,0 +1,42 @@
+/**
+ * Tests that the oplog replay of startup recovery logs its progress, as set by
+ * 'replicationRecoveryProgressLogIntervalSecs'.
+ * @tags: [requires_persistence, requires_replication, requires_wiredtiger,
+ * requires_majority_read_concern]
+ */
+(function() {
+    'use strict';
+    load('jstests/libs/check_log.js');
+
+    const rst = new ReplSetTest({nodes: [{}, {rsConfig: {priority: 0, votes: 0}}]});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const coll = primary.getDB('test').getCollection('t');
+    let secondary = rst.getSecondary();
+
+    // Keep the writes below out of the stable checkpoint of the secondary, so that it replays them
+    // from the oplog when it restarts.
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: 'disableSnapshotting', mode: 'alwaysOn'}));
+    for (let i = 0; i < 100; ++i) {
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let j = 0; j < 100; ++j) {
+            bulk.insert({_id: i * 100 + j});
+        }
+        assert.writeOK(bulk.execute());
+    }
+    rst.awaitReplication();
+
+    // The replay logs its progress after its first batch, and then once per interval.
+    secondary = rst.restart(1, {
+        setParameter: {replicationRecoveryProgressLogIntervalSecs: 1, replBatchLimitOperations: 10}
+    });
+    checkLog.contains(secondary, 'Replication recovery has applied');
+    rst.awaitReplication();
+    secondary.setSlaveOk();
+    assert.eq(10000, secondary.getDB('test').t.find().itcount());
+
+    rst.stopSet();
+})();
@@ -0,0 +1,68 @@
+/**
+ * Tests that a $match followed by a small $sample samples the matching documents with a random
+ * cursor, and that it scans the matching documents when too few of them match or when
+ * 'internalDocumentSourceSampleFilterPresampleSize' is zero.
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+
+    if (db.serverStatus().storageEngine.name !== "wiredTiger") {
+        jsTestLog("Skipping test since the storage engine has no random cursor");
+        MongoRunner.stopMongod(conn);
+        return;
+    }
+
+    const coll = db.sample_with_filter_random_cursor;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({_id: i, even: i % 2 === 0});
+    }
+    assert.writeOK(bulk.execute());
+
+    function usesRandomCursor(pipeline) {
+        const explain = coll.explain().aggregate(pipeline);
+        return explain.hasOwnProperty("stages") &&
+            explain.stages.some((stage) => stage.hasOwnProperty("$sampleFromRandomCursor"));
+    }
+
+    function checkSample(pipeline, size, predicate) {
+        const docs = coll.aggregate(pipeline).toArray();
+        assert.eq(size, docs.length, tojson(docs));
+        assert.eq(size, new Set(docs.map((doc) => doc._id)).size, tojson(docs));
+        docs.forEach((doc) => assert(predicate(doc), tojson(doc)));
+    }
+
+    const evenPipeline = [{$match: {even: true}}, {$sample: {size: 20}}];
+    assert(usesRandomCursor(evenPipeline));
+    checkSample(evenPipeline, 20, (doc) => doc.even);
+
+    // The explain output shows the filter applied by the random cursor.
+    const explain = coll.explain().aggregate(evenPipeline);
+    const multiIteratorStages = getAggPlanStages(explain, "MULTI_ITERATOR");
+    assert.eq(1, multiIteratorStages.length, tojson(explain));
+    assert.eq({even: {$eq: true}}, multiIteratorStages[0].filter, tojson(explain));
+
+    // None of the presampled documents match, so the random cursor might never find one.
+    const nonePipeline = [{$match: {even: "no"}}, {$sample: {size: 1}}];
+    assert(!usesRandomCursor(nonePipeline));
+    checkSample(nonePipeline, 0, (doc) => false);
+
+    // The sample is too large a part of the matching documents.
+    const largePipeline = [{$match: {even: true}}, {$sample: {size: 2000}}];
+    assert(!usesRandomCursor(largePipeline));
+    checkSample(largePipeline, 2000, (doc) => doc.even);
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalDocumentSourceSampleFilterPresampleSize: 0}));
+    assert(!usesRandomCursor(evenPipeline));
+    checkSample(evenPipeline, 20, (doc) => doc.even);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,46 @@
+/**
+ * Tests that the sampling profiler records stacks while enabled, reports its top frames to FTDC and
+ * returns folded stacks from 'getSamplingProfile'.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            samplingProfilerEnabled: true,
+            samplingProfilerFrequencyHz: 1000,
+            diagnosticDataCollectionPeriodMillis: 100,
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+    const adminDB = conn.getDB("admin");
+    const coll = conn.getDB("test").sampling_profiler;
+
+    // Keep the server busy until it has been sampled.
+    assert.soon(() => {
+        for (let i = 0; i < 100; ++i) {
+            assert.writeOK(coll.insert({x: "x".repeat(1000)}));
+            coll.find({x: {$regex: "y"}}).itcount();
+        }
+        const profile = assert.commandWorked(adminDB.runCommand({getSamplingProfile: 1}));
+        return profile.samples > 0;
+    });
+
+    const profile = assert.commandWorked(adminDB.runCommand({getSamplingProfile: 1, reset: true}));
+    assert(profile.running, tojson(profile));
+    assert.gt(profile.stacks.length, 0, tojson(profile));
+    for (let stack of profile.stacks) {
+        assert(/ \d+$/.test(stack), stack);
+    }
+
+    assert.soon(() => {
+        const data = assert.commandWorked(adminDB.runCommand({getDiagnosticData: 1})).data;
+        return data.hasOwnProperty("samplingProfiler") && data.samplingProfiler.running;
+    });
+
+    // Disabling the profiler at runtime stops it.
+    assert.commandWorked(adminDB.runCommand({setParameter: 1, samplingProfilerEnabled: false}));
+    assert.eq(false, assert.commandWorked(adminDB.runCommand({getSamplingProfile: 1})).running);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,50 @@
+/**
+ * Tests that with 'internalQueryPlannerGenerateSkipScans' enabled, a compound index can serve a
+ * predicate on its trailing field by skipping between the values of its leading field.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: {internalQueryPlannerGenerateSkipScans: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.skip_scan;
+    coll.drop();
+
+    const kNumTenants = 20;
+    const kNumTs = 100;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let tenant = 0; tenant < kNumTenants; ++tenant) {
+        for (let ts = 0; ts < kNumTs; ++ts) {
+            bulk.insert({tenant: tenant, ts: ts});
+        }
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({tenant: 1, ts: 1}));
+
+    const query = {ts: {$gte: 10, $lt: 12}};
+    const expectedCount = kNumTenants * 2;
+
+    // The planner may choose the skip scan on its own, and returns the right results either way.
+    assert.eq(expectedCount, coll.find(query).itcount());
+
+    // The skipping keeps the scan from examining the keys outside of the bounds on 'ts'.
+    const explain = coll.find(query).hint({tenant: 1, ts: 1}).explain("executionStats");
+    assert.eq(expectedCount, explain.executionStats.nReturned, tojson(explain));
+    const ixscan = getPlanStage(explain.executionStats.executionStages, "IXSCAN");
+    assert.neq(null, ixscan, tojson(explain));
+    assert.lt(ixscan.keysExamined, 4 * expectedCount, tojson(ixscan));
+    assert.gt(ixscan.seeks, kNumTenants, tojson(ixscan));
+
+    // Without the knob, the hinted index is scanned in its entirety.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryPlannerGenerateSkipScans: false}));
+    const wholeScan = coll.find(query).hint({tenant: 1, ts: 1}).explain("executionStats");
+    assert.eq(kNumTenants * kNumTs, wholeScan.executionStats.totalKeysExamined, tojson(wholeScan));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,67 @@
+/**
+ * Tests that a $sort whose keys are encoded as KeyStrings, as set by
+ * 'internalDocumentSourceSortKeyStrings', returns documents in the same order as one which compares
+ * the values of the keys, including when it spills to disk.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.sort_key_strings;
+    coll.drop();
+
+    const values = [
+        1,
+        2.5,
+        NumberLong(-3),
+        NumberDecimal("2.5"),
+        NaN,
+        "abc",
+        "ABC",
+        "b",
+        null,
+        undefined,
+        MinKey,
+        MaxKey,
+        true,
+        new Date(5),
+        {x: 1},
+        [3, 1],
+    ];
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 2000; ++i) {
+        const doc = {_id: i, b: values[(i * 7) % values.length], pad: "x".repeat(200)};
+        if (i % 13 != 0) {
+            doc.a = values[i % values.length];
+        }
+        bulk.insert(doc);
+    }
+    assert.writeOK(bulk.execute());
+
+    const collation = {locale: "en_US", strength: 2};
+    const sorts = [{a: 1, _id: 1}, {a: -1, _id: 1}, {b: -1, a: 1, _id: -1}];
+
+    function runAll(options) {
+        return sorts.map(sort => {
+            const pipeline =
+                [{$_internalInhibitOptimization: {}}, {$sort: sort}, {$project: {_id: 1}}];
+            return coll.aggregate(pipeline, options).toArray();
+        });
+    }
+
+    const optionSets = [{}, {collation: collation}];
+    const expected = optionSets.map(runAll);
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalDocumentSourceSortKeyStrings: true}));
+    assert.eq(expected, optionSets.map(runAll));
+
+    // Sorts which spill to disk give the same order.
+    assert.commandWorked(testDB.adminCommand(
+        {setParameter: 1, internalDocumentSourceSortMaxBlockingSortBytes: 64 * 1024}));
+    assert.eq(expected[0], runAll({allowDiskUse: true}));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,64 @@
+/**
+ * Tests that a $text query sorted by text score under a limit returns the same documents with
+ * 'internalQueryPlannerEnableTextScoreLimit' as without it, while reading fewer index keys.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+    const coll = db.text_score_sort_limit;
+
+    assert.commandWorked(coll.createIndex({title: "text", body: "text"}, {weights: {title: 5}}));
+
+    // Most documents match the common term with a low score, and a few match both terms or have
+    // the common term in the heavily weighted title.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 2000; ++i) {
+        const doc = {_id: i, title: "item " + i, body: "common " + "filler ".repeat(i % 50)};
+        if (i % 97 === 0) {
+            doc.title = "common item";
+        }
+        if (i % 193 === 0) {
+            doc.body += " rare";
+        }
+        bulk.insert(doc);
+    }
+    assert.writeOK(bulk.execute());
+
+    function runTextQuery(search, limit) {
+        const cursor = coll.find({$text: {$search: search}}, {score: {$meta: "textScore"}})
+                           .sort({score: {$meta: "textScore"}})
+                           .limit(limit);
+        return cursor.toArray().map((doc) => doc.score);
+    }
+
+    function totalKeysExamined(search, limit) {
+        return coll.find({$text: {$search: search}}, {score: {$meta: "textScore"}})
+            .sort({score: {$meta: "textScore"}})
+            .limit(limit)
+            .explain("executionStats")
+            .executionStats.totalKeysExamined;
+    }
+
+    const queries = [["common", 10], ["common rare", 5], ["rare", 3], ["common rare", 3000]];
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryPlannerEnableTextScoreLimit: false}));
+    const expected = queries.map(([search, limit]) => runTextQuery(search, limit));
+    const keysWithoutLimit = totalKeysExamined("common", 10);
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryPlannerEnableTextScoreLimit: true}));
+    queries.forEach(function([search, limit], i) {
+        assert.eq(expected[i], runTextQuery(search, limit), tojson([search, limit]));
+    });
+    assert.lt(totalKeysExamined("common", 10), keysWithoutLimit);
+
+    // A negated term can reject the documents with the highest scores after they are scored, so
+    // such a query reads every posting.
+    assert.eq(keysWithoutLimit, totalKeysExamined("common -rare", 10));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,76 @@
+/**
+ * Tests that a time-series collection stores its measurements in compressed buckets, that queries
+ * return the measurements unpacked, and that a time range is pushed down to the buckets.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+
+    assert.commandWorked(db.createCollection(
+        "ts", {timeseries: {timeField: "time", metaField: "tags", bucketMaxSpanSeconds: 60}}));
+    const coll = db.ts;
+    const buckets = db.system.buckets.ts;
+
+    // Measurements every second for two sensors over ten minutes, inserted in several batches.
+    const start = ISODate("2020-01-01T00:00:00Z");
+    const numMeasurements = 600;
+    let docs = [];
+    for (let i = 0; i < numMeasurements; ++i) {
+        const time = new Date(start.getTime() + i * 1000);
+        docs.push({time: time, tags: {sensor: "a"}, value: i, temp: 20.5});
+        docs.push({time: time, tags: {sensor: "b"}, value: -i, temp: 19.25});
+        if (docs.length === 100) {
+            assert.commandWorked(coll.insert(docs));
+            docs = [];
+        }
+    }
+    assert.commandWorked(coll.insert({time: start, tags: {sensor: "c"}}));
+
+    assert.eq(2 * numMeasurements + 1, coll.find().itcount());
+    assert.eq(numMeasurements, coll.find({"tags.sensor": "a"}).itcount());
+    assert.eq({time: start, tags: {sensor: "b"}, value: 0, temp: 19.25},
+              coll.findOne({"tags.sensor": "b", value: 0}));
+    assert.eq([{_id: "a", total: numMeasurements * (numMeasurements - 1) / 2}],
+              coll.aggregate([
+                      {$match: {"tags.sensor": "a"}},
+                      {$group: {_id: "$tags.sensor", total: {$sum: "$value"}}}
+                  ])
+                  .toArray());
+
+    // One bucket for each minute and sensor, and one for the third sensor.
+    assert.eq(2 * 10 + 1, buckets.find().itcount());
+    assert.eq(60, buckets.findOne({"meta.sensor": "a"}).control.count);
+
+    // A time range only reads the buckets which may hold measurements within it.
+    const lower = new Date(start.getTime() + 120 * 1000);
+    const upper = new Date(start.getTime() + 180 * 1000);
+    const rangeQuery = {time: {$gte: lower, $lt: upper}};
+    assert.eq(2 * 60, coll.find(rangeQuery).itcount());
+    const explain = coll.explain("executionStats").aggregate([{$match: rangeQuery}]);
+    assert(tojson(explain).includes("control.max.time"), tojson(explain));
+
+    // Each measurement needs a date in the time field.
+    assert.commandFailedWithCode(coll.insert({tags: {sensor: "a"}, value: 1}),
+                                 ErrorCodes.BadValue);
+    let res = coll.insert([{time: start}, {time: 1}, {time: start}], {ordered: false});
+    assert.eq(1, res.getWriteErrors().length, tojson(res));
+    assert.eq(1, res.getWriteErrors()[0].index, tojson(res));
+    assert.eq(2 * numMeasurements + 3, coll.find().itcount());
+
+    // A time-series collection cannot have a validator nor be capped.
+    assert.commandFailedWithCode(
+        db.createCollection("ts2", {timeseries: {timeField: "time"}, capped: true, size: 4096}),
+        ErrorCodes.InvalidOptions);
+    assert.commandFailedWithCode(
+        db.createCollection("ts2", {timeseries: {timeField: "time"}, validator: {a: 1}}),
+        ErrorCodes.InvalidOptions);
+
+    // Dropping the collection drops its buckets.
+    assert(coll.drop());
+    assert.eq(0, db.getCollectionNames().filter((name) => name.includes("ts")).length);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,53 @@
+// Tests that a traffic recording can be replayed against a server and that the replay reports the
+// latencies of the recorded commands.
+(function() {
+    "use strict";
+
+    const recordingDir = MongoRunner.toRealDir("$dataDir/traffic_replay/");
+    const recordingFilePath = MongoRunner.toRealDir(recordingDir + "/recording.txt");
+    mkdir(recordingDir);
+
+    const conn = MongoRunner.runMongod({setParameter: "trafficRecordingDirectory=" + recordingDir});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.traffic_replay;
+
+    assert.throws(function() {
+        replayTrafficRecording("notarealfileatall", conn.host);
+    });
+
+    assert.commandWorked(
+        testDB.adminCommand({startRecordingTraffic: 1, filename: "recording.txt"}));
+    for (let i = 0; i < 10; ++i) {
+        assert.commandWorked(coll.insert({x: i}));
+        assert.eq(i + 1, coll.find().itcount());
+    }
+    assert.commandWorked(coll.update({}, {$inc: {x: 1}}, {multi: true}));
+    assert.commandWorked(testDB.adminCommand({stopRecordingTraffic: 1}));
+
+    const recorded = convertTrafficRecordingToBSON(recordingFilePath).filter(
+        (obj) => obj.rawop.header.responseto == 0);
+
+    coll.drop();
+    const res = replayTrafficRecording(recordingFilePath, conn.host, {speed: 0, connections: 2});
+    assert.eq(recorded.length, res.numRequests, tojson(res));
+    assert.eq(10, res.commands.insert.count, tojson(res));
+    assert.eq(10, res.commands.find.count, tojson(res));
+    assert.eq(1, res.commands.update.count, tojson(res));
+    ["insert", "find", "update"].forEach(function(name) {
+        const stats = res.commands[name];
+        assert.lte(stats.p50Micros, stats.p90Micros, tojson(stats));
+        assert.lte(stats.p90Micros, stats.p99Micros, tojson(stats));
+        assert.lte(stats.p99Micros, stats.maxMicros, tojson(stats));
+    });
+
+    // The replayed requests were executed by the server.
+    assert.eq(10, coll.find().itcount());
+    assert.eq(10, coll.find({x: {$gte: 1}}).itcount());
+
+    assert.throws(function() {
+        replayTrafficRecording(recordingFilePath, conn.host, {connections: 0});
+    });
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,51 @@
+/**
+ * Tests that with 'transportLayerASIOReadAheadBytes', messages smaller and larger than the
+ * read-ahead buffer are received intact, including after the buffer size changes at runtime, and
+ * that replies are all sent with 'transportLayerASIOCoalescedReplyBytes'.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {transportLayerASIOReadAheadBytes: 1024}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const coll = conn.getDB("test").transport_layer_asio_read_ahead;
+
+    function checkRoundTrips() {
+        coll.drop();
+        for (let size of [1, 100, 1000, 1024, 5000, 1 << 20]) {
+            assert.writeOK(coll.insert({_id: size, x: "x".repeat(size)}));
+            assert.eq(size, coll.findOne({_id: size}).x.length);
+        }
+
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let i = 0; i < 1000; ++i) {
+            bulk.insert({y: i});
+        }
+        assert.writeOK(bulk.execute());
+        assert.eq(1000, coll.find({y: {$exists: true}}).batchSize(10).itcount());
+    }
+
+    checkRoundTrips();
+
+    assert.commandWorked(
+        conn.adminCommand({setParameter: 1, transportLayerASIOReadAheadBytes: 64}));
+    checkRoundTrips();
+
+    // Replies to requests read ahead may be held back and sent along with later ones.
+    assert.commandWorked(conn.adminCommand({
+        setParameter: 1,
+        transportLayerASIOReadAheadBytes: 4096,
+        transportLayerASIOCoalescedReplyBytes: 4096
+    }));
+    checkRoundTrips();
+    const exhaustCursor =
+        coll.find({y: {$exists: true}}).batchSize(10).addOption(DBQuery.Option.exhaust);
+    assert.eq(1000, exhaustCursor.itcount());
+
+    assert.commandWorked(
+        conn.adminCommand({setParameter: 1, transportLayerASIOReadAheadBytes: 0}));
+    checkRoundTrips();
+
+    MongoRunner.stopMongod(conn);
+}());
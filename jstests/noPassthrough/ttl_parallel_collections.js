@@ -0,0 +1,60 @@
+// Tests that the TTL monitor removes expired documents from several collections at a time with
+// 'ttlMonitorMaxParallelCollections', and reports the work done on each collection.
+(function() {
+    "use strict";
+
+    const runner = MongoRunner.runMongod(
+        {setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorMaxParallelCollections: 3}});
+    assert.neq(null, runner, "mongod was unable to start up");
+    const db = runner.getDB("test");
+
+    const numCollections = 5;
+    const numExpiredDocs = 100;
+    const past = new Date(Date.now() - 60 * 60 * 1000);
+    for (let i = 0; i < numCollections; ++i) {
+        const coll = db["ttl_parallel_" + i];
+        assert.commandWorked(coll.createIndex({x: 1}, {expireAfterSeconds: 0}));
+
+        const docs = [];
+        for (let j = 0; j < numExpiredDocs; ++j) {
+            docs.push({x: past});
+        }
+        docs.push({x: "not a date"});
+        assert.writeOK(coll.insert(docs));
+    }
+
+    assert.soon(function() {
+        for (let i = 0; i < numCollections; ++i) {
+            if (db["ttl_parallel_" + i].find().itcount() !== 1) {
+                return false;
+            }
+        }
+        return true;
+    }, "TTL monitor didn't remove the expired documents before timing out.");
+
+    // The pass that removed the documents may still be recording its metrics, so wait for another.
+    const ttlPass = db.serverStatus().metrics.ttl.passes;
+    assert.soon(function() {
+        return db.serverStatus().metrics.ttl.passes >= ttlPass + 2;
+    }, "TTL monitor didn't run before timing out.");
+
+    const ttlMetrics = db.serverStatus().metrics.ttl;
+    assert.gte(ttlMetrics.deletedDocuments, numCollections * numExpiredDocs, tojson(ttlMetrics));
+    for (let i = 0; i < numCollections; ++i) {
+        const stats = ttlMetrics.collections["test.ttl_parallel_" + i];
+        assert(stats, tojson(ttlMetrics));
+        assert.eq(numExpiredDocs, stats.deletedDocuments, tojson(stats));
+        assert.eq(0, stats.lastPassDeletedDocuments, tojson(stats));
+        assert.gte(stats.lastPassMillis, 0, tojson(stats));
+    }
+
+    // Dropped collections are no longer reported.
+    assert(db.ttl_parallel_0.drop());
+    const passAfterDrop = db.serverStatus().metrics.ttl.passes;
+    assert.soon(function() {
+        return db.serverStatus().metrics.ttl.passes >= passAfterDrop + 2;
+    }, "TTL monitor didn't run before timing out.");
+    assert.eq(undefined, db.serverStatus().metrics.ttl.collections["test.ttl_parallel_0"]);
+
+    MongoRunner.stopMongod(runner);
+})();
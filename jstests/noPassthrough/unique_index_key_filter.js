@@ -0,0 +1,62 @@
+/**
+ * Tests that unique indexes which keep a filter over their keys, as set by
+ * 'wiredTigerUniqueIndexKeyFilter', still reject duplicate keys inserted before and after a
+ * restart.
+ *
+ * @tags: [requires_persistence, requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    let conn = MongoRunner.runMongod({setParameter: {wiredTigerUniqueIndexKeyFilter: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    let coll = conn.getDB("test").unique_index_key_filter;
+    coll.drop();
+    assert.commandWorked(coll.createIndex({eventId: 1}, {unique: true}));
+
+    function insertEvents(start, end) {
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let i = start; i < end; ++i) {
+            bulk.insert({eventId: "event" + i});
+        }
+        assert.writeOK(bulk.execute());
+    }
+
+    function assertDuplicatesRejected(end) {
+        for (let i = 0; i < end; i += 97) {
+            assert.writeErrorWithCode(coll.insert({eventId: "event" + i}), ErrorCodes.DuplicateKey);
+        }
+    }
+
+    insertEvents(0, 1000);
+    assertDuplicatesRejected(1000);
+
+    // Keys removed from the index may be inserted again.
+    assert.writeOK(coll.remove({eventId: "event0"}));
+    assert.writeOK(coll.insert({eventId: "event0"}));
+
+    // The filter is rebuilt from the index when it is opened again.
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod({
+        dbpath: conn.dbpath,
+        noCleanData: true,
+        setParameter: {wiredTigerUniqueIndexKeyFilter: true}
+    });
+    assert.neq(null, conn, "mongod was unable to restart");
+    coll = conn.getDB("test").unique_index_key_filter;
+
+    assertDuplicatesRejected(1000);
+    insertEvents(1000, 2000);
+    assertDuplicatesRejected(2000);
+
+    // Indexes built over existing documents fill the filter from the bulk load.
+    assert.commandWorked(coll.updateMany({}, [{$set: {copy: "$eventId"}}]));
+    assert.commandWorked(coll.createIndex({copy: 1}, {unique: true}));
+    assert.writeErrorWithCode(coll.insert({copy: "event5"}), ErrorCodes.DuplicateKey);
+
+    const res = assert.commandWorked(coll.validate({full: true}));
+    assert(res.valid, tojson(res));
+
+    MongoRunner.stopMongod(conn);
+}());
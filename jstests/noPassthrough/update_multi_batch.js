@@ -0,0 +1,66 @@
+/**
+ * Tests that with 'internalUpdateMultiBatchSize', a multi-update writes several documents per
+ * WriteUnitOfWork, giving each of them its own oplog entry, and that a failure in the middle of a
+ * batch leaves the documents before it updated.
+ * @tags: [requires_replication, uses_transactions, requires_majority_read_concern]
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({nodes: 2});
+    rst.startSet({
+        setParameter:
+            {internalUpdateMultiBatchSize: 16, maxTargetSnapshotHistoryWindowInSeconds: 600}
+    });
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const coll = primary.getDB("test").update_multi_batch;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, x: 0, padding: "x".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    let res = assert.writeOK(coll.update({}, {$inc: {x: 1}}, {multi: true}));
+    assert.eq(1000, res.nMatched, tojson(res));
+    assert.eq(1000, res.nModified, tojson(res));
+    assert.eq(1000, coll.find({x: 1}).itcount());
+
+    // Every document has its own oplog entry, with its own timestamp.
+    const oplogEntries =
+        primary.getDB("local").oplog.rs.find({ns: coll.getFullName(), op: "u"}).toArray();
+    assert.eq(1000, oplogEntries.length);
+    const timestamps = new Set(oplogEntries.map(entry => tojson(entry.ts)));
+    assert.eq(1000, timestamps.size);
+
+    // Each document is timestamped like its own oplog entry, so a read at the timestamp of the
+    // entry before it still sees the document as it was.
+    rst.awaitLastOpCommitted();
+    const session = primary.startSession({causalConsistency: false});
+    const sessionColl = session.getDatabase("test").update_multi_batch;
+    function findAt(ts, id) {
+        session.startTransaction({readConcern: {level: "snapshot", atClusterTime: ts}});
+        const doc = sessionColl.findOne({_id: id});
+        assert.commandWorked(session.commitTransaction_forTesting());
+        return doc;
+    }
+    oplogEntries.sort((a, b) => timestampCmp(a.ts, b.ts));
+    for (let i = 1; i < 50; ++i) {
+        const entry = oplogEntries[i];
+        assert.eq(1, findAt(entry.ts, entry.o2._id).x, tojson(entry));
+        assert.eq(0, findAt(oplogEntries[i - 1].ts, entry.o2._id).x, tojson(entry));
+    }
+    session.endSession();
+
+    // A multi-update which fails on its second document leaves the first one updated.
+    assert.commandWorked(coll.createIndex({y: 1}, {unique: true, sparse: true}));
+    res = coll.update({}, {$set: {y: 1}}, {multi: true});
+    assert.writeErrorWithCode(res, ErrorCodes.DuplicateKey);
+    assert.eq(1, coll.find({y: 1}).itcount());
+
+    rst.awaitReplication();
+    rst.checkReplicatedDataHashes();
+    rst.stopSet();
+}());
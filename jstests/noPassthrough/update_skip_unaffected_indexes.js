@@ -0,0 +1,56 @@
+/**
+ * Tests that updates which only update the indexes whose key pattern or partial filter refers to a
+ * modified path, as set by 'internalUpdateSkipUnaffectedIndexes', leave every index consistent
+ * with the collection.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.update_skip_unaffected_indexes;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({"b.c": 1}));
+    assert.commandWorked(coll.createIndex({d: 1}, {partialFilterExpression: {e: {$gt: 5}}}));
+    assert.commandWorked(coll.createIndex({arr: 1}));
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; ++i) {
+        bulk.insert({_id: i, a: i, b: {c: i}, d: i, e: i % 10, arr: [i], pad: ""});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalUpdateSkipUnaffectedIndexes: true}));
+
+    // Resizing the padding keeps the updates from being applied in place, so that each of them
+    // goes through the index catalog.
+    const bigPad = "x".repeat(1000);
+    assert.writeOK(coll.update({}, {$set: {pad: bigPad}}, {multi: true}));
+    assert.writeOK(
+        coll.update({_id: {$lt: 20}}, {$inc: {a: 1000}, $set: {pad: ""}}, {multi: true}));
+    assert.writeOK(
+        coll.update({_id: {$lt: 50}}, {$set: {e: 7, pad: bigPad + bigPad}}, {multi: true}));
+    assert.writeOK(
+        coll.update({_id: {$gte: 90}}, {$unset: {e: 1}, $set: {pad: bigPad}}, {multi: true}));
+    assert.writeOK(coll.update({_id: 60}, {$set: {"b.c": -1, pad: ""}}));
+    assert.writeOK(coll.update({_id: 61}, {$rename: {a: "f"}, $set: {pad: bigPad}}));
+    assert.writeOK(coll.update({_id: 62}, {$push: {arr: 1000}, $set: {pad: ""}}));
+    assert.writeOK(coll.update({_id: 63}, {$set: {"arr.3.x": 1, pad: bigPad}}));
+    assert.writeOK(coll.update({_id: 64}, {$set: {b: 1, pad: ""}}));
+    assert.writeOK(coll.update({_id: 65}, {d: 5, e: 9, pad: bigPad}));
+
+    const res = assert.commandWorked(coll.validate({full: true}));
+    assert(res.valid, tojson(res));
+
+    assert.eq(20, coll.find({a: {$gte: 1000}}).hint({a: 1}).itcount());
+    assert.eq([{_id: 60}], coll.find({"b.c": -1}, {_id: 1}).hint({"b.c": 1}).toArray());
+    assert.eq(67, coll.find({e: {$gt: 5}}).hint({d: 1}).itcount());
+    assert.eq([{_id: 62}], coll.find({arr: 1000}, {_id: 1}).hint({arr: 1}).toArray());
+
+    MongoRunner.stopMongod(conn);
+}());
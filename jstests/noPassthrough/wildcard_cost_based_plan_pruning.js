@@ -0,0 +1,41 @@
+/**
+ * Tests that with 'internalQueryPlannerEnableCostEstimation' enabled, the candidate plans which
+ * scan the keys of different paths of a $** index are estimated from per-path statistics, so that
+ * the paths which are obviously less selective are not raced.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: {internalQueryPlannerEnableCostEstimation: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.wildcard_cost_based_plan_pruning;
+    coll.drop();
+
+    const kNumDocs = 20000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < kNumDocs; ++i) {
+        bulk.insert({a: i, b: i % 2, c: i % 2, d: [i % 2, 2]});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({"$**": 1}));
+
+    // The predicate on 'a' is far more selective than those on the other paths.
+    const query = {a: {$gte: 100, $lt: 110}, b: 0, c: 0, d: 0};
+    assert.eq(5, coll.find(query).itcount());
+
+    const explain = coll.find(query).explain("allPlansExecution");
+    assert.eq(5, explain.executionStats.nReturned, tojson(explain));
+    assert.lte(explain.executionStats.allPlansExecution.length, 1, tojson(explain));
+
+    // Without the knob, a candidate for each path is raced.
+    assert.commandWorked(testDB.adminCommand(
+        {setParameter: 1, internalQueryPlannerEnableCostEstimation: false}));
+    assert.eq(5, coll.find(query).itcount());
+    const raced = coll.find(query).explain("allPlansExecution");
+    assert.eq(4, raced.executionStats.allPlansExecution.length, tojson(raced));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,45 @@
+/**
+ * Tests that with 'wiredTigerAdaptiveConcurrentTransactions', the numbers of read and write
+ * tickets stay within their bounds and the adjustments are reported in serverStatus.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            wiredTigerAdaptiveConcurrentTransactions: true,
+            wiredTigerAdaptiveConcurrentTransactionsMin: 8,
+            wiredTigerAdaptiveConcurrentTransactionsMax: 16,
+            wiredTigerConcurrentReadTransactions: 8,
+            wiredTigerConcurrentWriteTransactions: 32,
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+
+    function adaptiveStats() {
+        const serverStatus = assert.commandWorked(testDB.adminCommand({serverStatus: 1}));
+        return serverStatus.wiredTiger.concurrentTransactions.adaptive;
+    }
+
+    // The adjustment thread reports its first sample within a couple of seconds, and brings the
+    // number of write tickets within the bounds.
+    assert.soon(() => {
+        const stats = adaptiveStats();
+        return stats !== undefined && stats.write.totalTickets === 16;
+    });
+
+    const stats = adaptiveStats();
+    for (let kind of ["read", "write"]) {
+        assert.gte(stats[kind].totalTickets, 8, tojson(stats));
+        assert.lte(stats[kind].totalTickets, 16, tojson(stats));
+        assert(stats[kind].hasOwnProperty("lastAdjustment"), tojson(stats));
+        assert(stats[kind].hasOwnProperty("throughput"), tojson(stats));
+    }
+    assert.eq("boolean", typeof stats.cacheUnderPressure, tojson(stats));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,36 @@
+/**
+ * Tests that with 'wiredTigerCheckpointDirtyBytesBudgetMB' set, the checkpoint thread checkpoints
+ * as soon as the cache holds more dirty data than the budget rather than waiting for 'syncdelay',
+ * and reports the checkpoints it takes in serverStatus.
+ * @tags: [requires_wiredtiger, requires_persistence]
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod(
+        {syncdelay: 3600, setParameter: {wiredTigerCheckpointDirtyBytesBudgetMB: 1}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.wt_checkpoint_dirty_budget;
+    coll.drop();
+
+    function checkpointStats() {
+        return assert.commandWorked(testDB.serverStatus()).wiredTiger.checkpoints;
+    }
+
+    // Dirty well over the budget, so that a checkpoint is due long before 'syncdelay' elapses.
+    const str = "x".repeat(1024);
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 8 * 1024; ++i) {
+        bulk.insert({i: i, str: str});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.soon(() => checkpointStats().overDirtyBudgetCount > 0, () => tojson(checkpointStats()));
+    const stats = checkpointStats();
+    assert.gte(stats.count, stats.overDirtyBudgetCount, tojson(stats));
+    assert.gte(stats.totalDurationMillis, stats.lastDurationMillis, tojson(stats));
+
+    MongoRunner.stopMongod(conn);
+}());
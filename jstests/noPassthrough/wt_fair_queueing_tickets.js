@@ -0,0 +1,57 @@
+/**
+ * Tests that with 'wiredTigerConcurrentTransactionsFairQueueing', operations still complete when
+ * they have to queue for tickets, and that serverStatus reports the ticket waits of each
+ * operation class.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            wiredTigerConcurrentTransactionsFairQueueing: true,
+            wiredTigerConcurrentReadTransactions: 5,
+            wiredTigerConcurrentWriteTransactions: 5,
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.wt_fair_queueing_tickets;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, a: i % 10});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Run more scans and point reads at once than there are tickets.
+    const shells = [];
+    for (let i = 0; i < 10; ++i) {
+        shells.push(startParallelShell(function() {
+            const coll = db.getSiblingDB("test").wt_fair_queueing_tickets;
+            for (let j = 0; j < 20; ++j) {
+                assert.eq(100, coll.find({a: j % 10}).batchSize(10).itcount());
+                assert.eq(1, coll.find({_id: j}).itcount());
+                assert.writeOK(coll.update({_id: j}, {$inc: {b: 1}}));
+            }
+        }, conn.port));
+    }
+    shells.forEach((awaitShell) => awaitShell());
+
+    const serverStatus = assert.commandWorked(testDB.adminCommand({serverStatus: 1}));
+    const tickets = serverStatus.wiredTiger.concurrentTransactions;
+    for (let kind of ["read", "write"]) {
+        assert.eq(true, tickets[kind].fairQueueing, tojson(tickets));
+        assert.eq(0, tickets[kind].queued, tojson(tickets));
+        for (let operationClass of ["short", "long", "internal", "admin"]) {
+            assert(tickets[kind].queueWaits.hasOwnProperty(operationClass), tojson(tickets));
+        }
+        assert.gt(tickets[kind].queueWaits.short.count, 0, tojson(tickets));
+    }
+    assert.eq(5, tickets.read.totalTickets, tojson(tickets));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,37 @@
+/**
+ * Tests that lowering 'wiredTigerFileHandleCloseIdleTime' lets WiredTiger close the data handles
+ * of collections which are no longer used.
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            wiredTigerFileHandleCloseIdleTime: 1,
+            wiredTigerFileHandleCloseMinimum: 0,
+            wiredTigerFileHandleCloseScanInterval: 1,
+            wiredTigerSessionCloseIdleTimeSecs: 1
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+
+    function sweepClosed() {
+        return db.serverStatus().wiredTiger["data-handle"]["connection sweep dhandles closed"];
+    }
+
+    const closedBefore = sweepClosed();
+    for (let i = 0; i < 20; ++i) {
+        assert.writeOK(db.getCollection("coll" + i).insert({_id: i}));
+    }
+
+    assert.soon(() => sweepClosed() > closedBefore, "no data handles were closed by the sweep");
+
+    // The collections are reopened on their next use.
+    for (let i = 0; i < 20; ++i) {
+        assert.eq({_id: i}, db.getCollection("coll" + i).findOne());
+    }
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,52 @@
+/**
+ * Tests that concurrent j:true writes are flushed to the journal in batches, as reported under
+ * 'wiredTiger.groupCommit' in serverStatus.
+ *
+ * @tags: [requires_journaling, requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            wiredTigerJournalGroupCommitMaxDelayMicros: 2000,
+            wiredTigerJournalGroupCommitMinWaiters: 2,
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+
+    function groupCommitStats() {
+        const serverStatus = assert.commandWorked(testDB.adminCommand({serverStatus: 1}));
+        return serverStatus.wiredTiger.groupCommit;
+    }
+
+    const before = groupCommitStats();
+
+    const shells = [];
+    for (let i = 0; i < 8; ++i) {
+        shells.push(startParallelShell(function() {
+            const coll = db.getSiblingDB("test").wt_journal_group_commit;
+            for (let j = 0; j < 100; ++j) {
+                assert.writeOK(coll.insert({x: j}, {writeConcern: {w: 1, j: true}}));
+            }
+        }, conn.port));
+    }
+    shells.forEach((awaitShell) => awaitShell());
+
+    const after = groupCommitStats();
+    const waiters = after.waiters - before.waiters;
+    const flushes = after.flushes - before.flushes;
+    assert.gte(waiters, 800, tojson(after));
+    assert.gt(flushes, 0, tojson(after));
+    assert.lte(flushes, waiters, tojson(after));
+
+    let batches = 0;
+    for (let bucket of Object.keys(after.batchSizes)) {
+        batches += after.batchSizes[bucket];
+    }
+    assert.eq(after.flushes, batches, tojson(after));
+
+    MongoRunner.stopMongod(conn);
+}());
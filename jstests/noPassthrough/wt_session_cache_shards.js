@@ -0,0 +1,42 @@
+/**
+ * Tests that a mongod whose session cache is split into shards by 'wiredTigerSessionCacheShards'
+ * serves concurrent operations and reports the shards in serverStatus.
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/parallelTester.js");  // For ScopedThread.
+
+    const conn = MongoRunner.runMongod({setParameter: {wiredTigerSessionCacheShards: 8}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.wt_session_cache_shards;
+    coll.drop();
+
+    const threads = [];
+    for (let t = 0; t < 4; ++t) {
+        const thread = new ScopedThread(function(host, t) {
+            const coll = new Mongo(host).getDB("test").wt_session_cache_shards;
+            for (let i = 0; i < 200; ++i) {
+                assert.writeOK(coll.insert({t: t, i: i}));
+                assert.eq(1, coll.find({t: t, i: i}).itcount());
+            }
+        }, conn.host, t);
+        thread.start();
+        threads.push(thread);
+    }
+    threads.forEach(thread => thread.join());
+    assert.eq(800, coll.find().itcount());
+
+    const stats = assert.commandWorked(testDB.serverStatus()).wiredTiger.sessionCache;
+    assert.eq(8, stats.shards, tojson(stats));
+    assert.gt(stats.misses, 0, tojson(stats));
+    assert.gt(stats.idleSessions, 0, tojson(stats));
+
+    // The shard count is fixed when the session cache is created.
+    assert.commandFailed(testDB.adminCommand({setParameter: 1, wiredTigerSessionCacheShards: 2}));
+
+    MongoRunner.stopMongod(conn);
+}());
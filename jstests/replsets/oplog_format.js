@@ -175,4 +175,19 @@ assert.eq(res.nModified, 1, "update failed for '" + msg + "': " + res.toString()
 assert.docEq({_id: 1, a: {b: [{c: 1}, {c: -1}]}}, coll.findOne({}), msg);
 assertLastOplog({$v: 1, $set: {"a.b": [{c: 1}, {c: -1}]}}, {_id: 1}, msg);
 
+var msg = "bad array $push $slice positive";
+coll.save({_id: 1, a: {b: [1, 2, 3]}});
+res = assert.writeOK(coll.update({_id: {$gt: 0}}, {$push: {"a.b": {$each: [4, 5], $slice: 4}}}));
+assert.eq(res.nModified, 1, "update failed for '" + msg + "': " + res.toString());
+assert.docEq({_id: 1, a: {b: [1, 2, 3, 4]}}, coll.findOne({}), msg);
+assertLastOplog({$v: 1, $set: {"a.b.2": 3, "a.b.3": 4}}, {_id: 1}, msg);
+
+var msg = "bad array filters update of several elements";
+coll.save({_id: 1, a: [0, 1, 0, 1]});
+res = assert.writeOK(
+    coll.update({_id: {$gt: 0}}, {$set: {"a.$[i]": 2}}, {arrayFilters: [{i: 0}]}));
+assert.eq(res.nModified, 1, "update failed for '" + msg + "': " + res.toString());
+assert.docEq({_id: 1, a: [2, 1, 2, 1]}, coll.findOne({}), msg);
+assertLastOplog({$v: 1, $set: {"a.0": 2, "a.2": 2}}, {_id: 1}, msg);
+
 replTest.stopSet();
@@ -0,0 +1,89 @@
+/**
+ * Tests that with 'storeFindAndModifyImagesInSideCollection' the images of retryable
+ * findAndModify operations are stored in 'config.image_collection' instead of in no-op oplog
+ * entries, that secondaries derive the same images while applying the oplog, and that a retry
+ * after failover returns the original result.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/retryable_writes_util.js");
+
+    if (!RetryableWritesUtil.storageEngineSupportsRetryableWrites(jsTest.options().storageEngine)) {
+        jsTestLog("Retryable writes are not supported, skipping test");
+        return;
+    }
+
+    const replTest = new ReplSetTest(
+        {nodes: 2, nodeOptions: {setParameter: {storeFindAndModifyImagesInSideCollection: true}}});
+    replTest.startSet();
+    replTest.initiate();
+
+    let primary = replTest.getPrimary();
+    let testDB = primary.getDB("test");
+    assert.commandWorked(testDB.foo.insert([{_id: 1, x: 1}, {_id: 2, x: 2}]));
+
+    const lsid = {id: UUID()};
+    const updateCmd = {
+        findAndModify: "foo",
+        query: {_id: 1},
+        update: {$inc: {x: 1}},
+        new: true,
+        lsid: lsid,
+        txnNumber: NumberLong(1)
+    };
+    const updateResult = assert.commandWorked(testDB.runCommand(updateCmd));
+    assert.eq({_id: 1, x: 2}, updateResult.value);
+
+    const removeLsid = {id: UUID()};
+    const removeCmd = {
+        findAndModify: "foo",
+        query: {_id: 2},
+        remove: true,
+        lsid: removeLsid,
+        txnNumber: NumberLong(1)
+    };
+    const removeResult = assert.commandWorked(testDB.runCommand(removeCmd));
+    assert.eq({_id: 2, x: 2}, removeResult.value);
+
+    replTest.awaitReplication();
+
+    const oplog = primary.getDB("local").oplog.rs;
+    assert.eq(0, oplog.find({ns: "test.foo", op: "n"}).itcount());
+    assert.eq(1, oplog.find({ns: "test.foo", op: "u", needsRetryImage: "postImage"}).itcount());
+    assert.eq(1, oplog.find({ns: "test.foo", op: "d", needsRetryImage: "preImage"}).itcount());
+
+    // Every node stores the images itself, without replicating the writes to the collection.
+    assert.eq(0, oplog.find({ns: "config.image_collection", op: {$ne: "c"}}).itcount());
+    replTest.nodes.forEach(function(node) {
+        const images = node.getDB("config").image_collection;
+        const updateImage = images.findOne({"_id.id": lsid.id});
+        assert.neq(null, updateImage, node.host);
+        assert.eq("postImage", updateImage.imageKind, tojson(updateImage));
+        assert.eq({_id: 1, x: 2}, updateImage.image, tojson(updateImage));
+
+        const removeImage = images.findOne({"_id.id": removeLsid.id});
+        assert.neq(null, removeImage, node.host);
+        assert.eq("preImage", removeImage.imageKind, tojson(removeImage));
+        assert.eq({_id: 2, x: 2}, removeImage.image, tojson(removeImage));
+    });
+
+    // Retrying on the new primary returns the original results without redoing the writes.
+    assert.commandWorked(primary.adminCommand({replSetStepDown: 10, force: true}));
+    primary = replTest.getPrimary();
+    testDB = primary.getDB("test");
+
+    const updateRetryResult = assert.commandWorked(testDB.runCommand(updateCmd));
+    assert.eq(updateResult.value, updateRetryResult.value);
+    assert.eq(updateResult.lastErrorObject, updateRetryResult.lastErrorObject);
+    assert.eq({_id: 1, x: 2}, testDB.foo.findOne({_id: 1}));
+
+    const removeRetryResult = assert.commandWorked(testDB.runCommand(removeCmd));
+    assert.eq(removeResult.value, removeRetryResult.value);
+    assert.eq(removeResult.lastErrorObject, removeRetryResult.lastErrorObject);
+
+    // A retry that asks for the other image is not compatible with the stored one.
+    assert.commandFailedWithCode(testDB.runCommand(Object.merge(updateCmd, {new: false})), 40612);
+
+    replTest.stopSet();
+})();
@@ -0,0 +1,48 @@
+/**
+ * Tests that with 'rollbackWriteDataFilesInBackground', rollback via recovery to a stable
+ * timestamp writes out every document it rolls back to the rollback data files.
+ *
+ * @tags: [requires_persistence]
+ */
+(function() {
+    "use strict";
+    load("jstests/libs/check_log.js");
+    load("jstests/replsets/libs/rollback_files.js");
+    load("jstests/replsets/libs/rollback_test.js");
+
+    const name = "rollback_write_data_files_in_background";
+    const dbName = "test";
+
+    const rollbackTest = new RollbackTest(name);
+    const rollbackNode = rollbackTest.getPrimary();
+    assert.commandWorked(
+        rollbackNode.adminCommand({setParameter: 1, rollbackWriteDataFilesInBackground: true}));
+
+    const testDB = rollbackNode.getDB(dbName);
+    assert.commandWorked(testDB.createCollection("a"));
+    assert.commandWorked(testDB.createCollection("b"));
+
+    rollbackTest.transitionToRollbackOperations();
+
+    const expectedDocs = {a: [], b: []};
+    for (let i = 0; i < 100; ++i) {
+        for (let collName of ["a", "b"]) {
+            const doc = {_id: i, coll: collName};
+            assert.commandWorked(testDB.getCollection(collName).insert(doc));
+            expectedDocs[collName].push(doc);
+        }
+    }
+
+    rollbackTest.transitionToSyncSourceOperationsBeforeRollback();
+    rollbackTest.transitionToSyncSourceOperationsDuringRollback();
+    rollbackTest.transitionToSteadyStateOperations();
+
+    checkLog.contains(rollbackNode, "Finished writing rollback files in the background");
+
+    const dbPath = rollbackTest.getTestFixture().getDbPath(rollbackNode);
+    for (let collName of ["a", "b"]) {
+        checkRollbackFiles(dbPath, dbName + "." + collName, expectedDocs[collName]);
+    }
+
+    rollbackTest.stop();
+})();
@@ -0,0 +1,49 @@
+/**
+ * Tests that with 'enableHedgedReads', reads with the 'nearest' and 'secondaryPreferred' read
+ * preferences are sent to a second member of each shard and still return every document once.
+ */
+(function() {
+    "use strict";
+    load("jstests/libs/check_log.js");
+
+    const st = new ShardingTest({
+        shards: 2,
+        mongos: 1,
+        rs: {nodes: 3},
+        other: {
+            mongosOptions: {
+                setParameter: {
+                    enableHedgedReads: true,
+                    hedgedReadsDelayMS: 0,
+                    logComponentVerbosity: tojson({query: 1}),
+                }
+            }
+        }
+    });
+
+    const dbName = "test";
+    const coll = st.s.getDB(dbName).hedged_reads;
+    assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, st.shard0.shardName);
+    assert.commandWorked(
+        st.s.adminCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+    assert.commandWorked(st.s.adminCommand({split: coll.getFullName(), middle: {_id: 50}}));
+    assert.commandWorked(st.s.adminCommand(
+        {moveChunk: coll.getFullName(), find: {_id: 50}, to: st.shard1.shardName}));
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; ++i) {
+        bulk.insert({_id: i});
+    }
+    assert.writeOK(bulk.execute({w: 3}));
+
+    for (let mode of ["nearest", "secondaryPreferred"]) {
+        const results = coll.find().sort({_id: 1}).readPref(mode).toArray();
+        assert.eq(100, results.length, mode);
+        results.forEach((doc, i) => assert.eq(i, doc._id, mode));
+    }
+
+    checkLog.contains(st.s, "Hedging request to shard");
+
+    st.stop();
+})();
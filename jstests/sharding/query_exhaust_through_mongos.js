@@ -0,0 +1,44 @@
+/**
+ * Tests that with 'internalQueryAllowExhaustOnMongoS', mongos streams every batch of an exhaust
+ * query over a sharded collection to the client.
+ */
+(function() {
+    "use strict";
+
+    const st = new ShardingTest({
+        shards: 2,
+        mongos: 1,
+        other: {mongosOptions: {setParameter: {internalQueryAllowExhaustOnMongoS: true}}}
+    });
+
+    const dbName = "test";
+    const coll = st.s.getDB(dbName).query_exhaust_through_mongos;
+    assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, st.shard0.shardName);
+    assert.commandWorked(
+        st.s.adminCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+    assert.commandWorked(st.s.adminCommand({split: coll.getFullName(), middle: {_id: 50}}));
+    assert.commandWorked(st.s.adminCommand(
+        {moveChunk: coll.getFullName(), find: {_id: 50}, to: st.shard1.shardName}));
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; ++i) {
+        bulk.insert({_id: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    const results =
+        coll.find().sort({_id: 1}).batchSize(7).addOption(DBQuery.Option.exhaust).toArray();
+    assert.eq(100, results.length);
+    results.forEach((doc, i) => assert.eq(i, doc._id, tojson(doc)));
+
+    // The connection can still be used once the exhaust stream has ended.
+    assert.eq(100, coll.find().itcount());
+
+    // Without the parameter, mongos rejects exhaust queries.
+    assert.commandWorked(
+        st.s.adminCommand({setParameter: 1, internalQueryAllowExhaustOnMongoS: false}));
+    assert.throws(() => coll.find().addOption(DBQuery.Option.exhaust).next());
+
+    st.stop();
+}());
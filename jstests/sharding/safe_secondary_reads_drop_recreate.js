@@ -62,6 +62,7 @@
         _mergeAuthzCollections: {skip: "primary only"},
         _migrateClone: {skip: "primary only"},
         _movePrimary: {skip: "primary only"},
+        _readBackupFile: {skip: "does not return user data"},
         _recvChunkAbort: {skip: "primary only"},
         _recvChunkCommit: {skip: "primary only"},
         _recvChunkStart: {skip: "primary only"},
@@ -29,9 +29,11 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 /**
@@ -65,4 +67,59 @@ public:
 private:
     AtomicWord<long long> _counter;
 };
+
+/**
+ * A 64bit counter with the interface of Counter64, for counters that every operation increments.
+ *
+ * The value is split across cache-line-aligned shards. Each thread always increments the same
+ * shard, so threads running on different cores do not contend for the counter's cache line.
+ * Reads sum the shards, so they are slower than Counter64::get() and are not a point-in-time
+ * snapshot with respect to concurrent increments.
+ */
+class ShardedCounter64 {
+public:
+    static constexpr size_t kNumShards = 16;
+
+    /** Increment this thread's shard, and return the shard's previous value. */
+    long long fetchAndAdd(long long n = 1) {
+        return _shards[_shardIndex()].fetchAndAddRelaxed(n);
+    }
+
+    void increment(uint64_t n = 1) {
+        fetchAndAdd(n);
+    }
+
+    void decrement(uint64_t n = 1) {
+        fetchAndAdd(-static_cast<long long>(n));
+    }
+
+    /** Return the sum of all shards. */
+    long long get() const {
+        long long total = 0;
+        for (auto&& shard : _shards) {
+            total += shard.loadRelaxed();
+        }
+        return total;
+    }
+
+    operator long long() const {
+        return get();
+    }
+
+    /** Reset the counter to zero. Increments that race with the reset may be lost. */
+    void reset() {
+        for (auto&& shard : _shards) {
+            shard.store(0);
+        }
+    }
+
+private:
+    static size_t _shardIndex() {
+        static AtomicWord<unsigned> nextShard{0};
+        thread_local const size_t shard = nextShard.fetchAndAddRelaxed(1) % kNumShards;
+        return shard;
+    }
+
+    std::array<CacheAligned<AtomicWord<long long>>, kNumShards> _shards{};
+};
 }  // namespace mongo
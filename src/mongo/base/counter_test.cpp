@@ -32,8 +32,10 @@
 
 #include <climits>
 #include <iostream>
+#include <vector>
 
 #include "mongo/base/counter.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -55,5 +57,37 @@ TEST(CounterTest, Test1) {
     ASSERT_EQUALS(static_cast<long long>(c), 0);
 }
 
+TEST(ShardedCounterTest, IncrementAndDecrement) {
+    ShardedCounter64 c;
+    ASSERT_EQUALS(c.get(), 0);
+    c.increment();
+    ASSERT_EQUALS(c.get(), 1);
+    ASSERT_EQUALS(c.fetchAndAdd(4), 1);
+    ASSERT_EQUALS(c.get(), 5);
+    c.decrement(7);
+    ASSERT_EQUALS(static_cast<long long>(c), -2);
+    c.reset();
+    ASSERT_EQUALS(c.get(), 0);
+}
+
+TEST(ShardedCounterTest, SumsIncrementsFromManyThreads) {
+    constexpr int kThreads = 2 * ShardedCounter64::kNumShards + 1;
+    constexpr int kIncrements = 1000;
+
+    ShardedCounter64 c;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < kIncrements; ++j) {
+                c.increment();
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQUALS(c.get(), kThreads * kIncrements);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,59 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bson_field_index.h"
+
+namespace mongo {
+
+BSONFieldIndex::BSONFieldIndex(const BSONObj& obj) : _obj(obj) {
+    for (auto&& elem : _obj) {
+        // Only the first occurrence of a repeated name is indexed, as getField() would find it.
+        _offsets.emplace(elem.fieldNameStringData(), elem.rawdata() - _obj.objdata());
+    }
+}
+
+bool BSONFieldIndex::isWorthBuilding(const BSONObj& obj, size_t minFields) {
+    // Every field takes at least two bytes, for its type and the terminator of its name, so most
+    // narrow objects can be turned away without counting their fields.
+    return static_cast<size_t>(obj.objsize()) >= BSONObj::kMinBSONLength + 2 * minFields &&
+        static_cast<size_t>(obj.nFields()) >= minFields;
+}
+
+BSONElement BSONFieldIndex::getField(StringData name) const {
+    auto it = _offsets.find(name);
+    if (it == _offsets.end()) {
+        return BSONElement();
+    }
+    return BSONElement(_obj.objdata() + it->second);
+}
+
+}  // namespace mongo
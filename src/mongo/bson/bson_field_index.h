@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * An index from the names of the top-level fields of a BSONObj to their offsets within it, so
+ * that repeated lookups in a wide object cost a hash probe rather than a linear scan each.
+ *
+ * The index holds a reference to the object it was built over, so an index over owned BSON stays
+ * valid for as long as the index itself. An index over unowned BSON must not outlive the buffer.
+ */
+class BSONFieldIndex {
+public:
+    explicit BSONFieldIndex(const BSONObj& obj);
+
+    /**
+     * Returns true if 'obj' has at least 'minFields' fields, and so is wide enough that indexing
+     * it is expected to pay off.
+     */
+    static bool isWorthBuilding(const BSONObj& obj, size_t minFields);
+
+    /**
+     * Returns the first element of the indexed object named 'name', or an EOO element if there is
+     * none. Behaves exactly like BSONObj::getField().
+     */
+    BSONElement getField(StringData name) const;
+
+    /**
+     * Returns true if this index was built over the very same buffer as 'obj'.
+     */
+    bool isIndexOf(const BSONObj& obj) const {
+        return obj.objdata() == _obj.objdata();
+    }
+
+    const BSONObj& obj() const {
+        return _obj;
+    }
+
+    /**
+     * The number of distinct field names in the indexed object.
+     */
+    size_t size() const {
+        return _offsets.size();
+    }
+
+private:
+    BSONObj _obj;
+    StringDataMap<int> _offsets;
+};
+
+}  // namespace mongo
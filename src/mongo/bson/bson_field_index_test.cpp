@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bson_field_index.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeWideObj(int nFields) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < nFields; ++i) {
+        bob.append("f" + std::to_string(i), i);
+    }
+    return bob.obj();
+}
+
+TEST(BSONFieldIndexTest, FindsEveryField) {
+    const BSONObj obj = makeWideObj(300);
+    BSONFieldIndex index(obj);
+    ASSERT_EQ(300U, index.size());
+    ASSERT_TRUE(index.isIndexOf(obj));
+    for (auto&& elem : obj) {
+        ASSERT_EQ(elem.rawdata(), index.getField(elem.fieldNameStringData()).rawdata());
+    }
+}
+
+TEST(BSONFieldIndexTest, MissingFieldIsEOO) {
+    BSONFieldIndex index(BSON("a" << 1 << "b" << 2));
+    ASSERT_TRUE(index.getField("c").eoo());
+    ASSERT_TRUE(index.getField("").eoo());
+    ASSERT_TRUE(index.getField("a.b").eoo());
+}
+
+TEST(BSONFieldIndexTest, RepeatedNameFindsFirstOccurrence) {
+    const BSONObj obj = BSON("a" << 1 << "b" << 2 << "a" << 3);
+    BSONFieldIndex index(obj);
+    ASSERT_EQ(2U, index.size());
+    ASSERT_EQ(1, index.getField("a").numberInt());
+    ASSERT_EQ(obj.getField("a").rawdata(), index.getField("a").rawdata());
+}
+
+TEST(BSONFieldIndexTest, EmptyAndDottedNames) {
+    const BSONObj obj = BSON("" << 1 << "a.b" << 2);
+    BSONFieldIndex index(obj);
+    ASSERT_EQ(1, index.getField("").numberInt());
+    ASSERT_EQ(2, index.getField("a.b").numberInt());
+}
+
+TEST(BSONFieldIndexTest, IsIndexOfComparesBuffers) {
+    const BSONObj obj = BSON("a" << 1);
+    BSONFieldIndex index(obj);
+    ASSERT_TRUE(index.isIndexOf(obj));
+    ASSERT_FALSE(index.isIndexOf(obj.copy()));
+}
+
+TEST(BSONFieldIndexTest, IsWorthBuilding) {
+    ASSERT_TRUE(BSONFieldIndex::isWorthBuilding(makeWideObj(10), 10));
+    ASSERT_FALSE(BSONFieldIndex::isWorthBuilding(makeWideObj(9), 10));
+    ASSERT_TRUE(BSONFieldIndex::isWorthBuilding(BSONObj(), 0));
+    ASSERT_FALSE(BSONFieldIndex::isWorthBuilding(BSON("" << BSONNULL), 2));
+}
+
+}  // namespace
+}  // namespace mongo
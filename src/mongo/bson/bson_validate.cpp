@@ -27,6 +27,7 @@
  *    it in the license file.
  */
 
+#include <array>
 #include <cstring>
 #include <limits>
 #include <vector>
@@ -413,6 +414,158 @@ Status validateBSONIterative(Buffer* buffer) {
     return Status::OK();
 }
 
+/**
+ * The size of the value of an element of each type, indexed by the type's byte, for the types
+ * whose values have a fixed size. The other types have -1.
+ */
+constexpr std::array<int8_t, 256> makeFixedValueSizes() {
+    std::array<int8_t, 256> sizes{};
+    for (auto&& size : sizes) {
+        size = -1;
+    }
+    sizes[static_cast<uint8_t>(MinKey)] = 0;
+    sizes[static_cast<uint8_t>(MaxKey)] = 0;
+    sizes[static_cast<uint8_t>(jstNULL)] = 0;
+    sizes[static_cast<uint8_t>(Undefined)] = 0;
+    sizes[static_cast<uint8_t>(Bool)] = 1;
+    sizes[static_cast<uint8_t>(NumberInt)] = sizeof(int32_t);
+    sizes[static_cast<uint8_t>(NumberDouble)] = sizeof(int64_t);
+    sizes[static_cast<uint8_t>(NumberLong)] = sizeof(int64_t);
+    sizes[static_cast<uint8_t>(bsonTimestamp)] = sizeof(int64_t);
+    sizes[static_cast<uint8_t>(Date)] = sizeof(int64_t);
+    sizes[static_cast<uint8_t>(jstOID)] = OID::kOIDSize;
+    sizes[static_cast<uint8_t>(NumberDecimal)] = sizeof(Decimal128::Value);
+    return sizes;
+}
+
+constexpr std::array<int8_t, 256> kFixedValueSizes = makeFixedValueSizes();
+
+int32_t readInt32(const char* p) {
+    return ConstDataView(p).read<LittleEndian<int32_t>>();
+}
+
+/**
+ * Moves 'p' past the c-string at it, which must end before 'end'.
+ */
+bool quickSkipCString(const char** p, const char* end) {
+    const void* nul = memchr(*p, 0, end - *p);
+    if (!nul)
+        return false;
+    *p = static_cast<const char*>(nul) + 1;
+    return true;
+}
+
+/**
+ * Moves 'p' past the length-prefixed string at it, which must end before 'end'.
+ */
+bool quickSkipString(const char** p, const char* end) {
+    if (end - *p < 4)
+        return false;
+    const int32_t size = readInt32(*p);
+    if (size <= 0 || size > end - *p - 4 || (*p)[4 + size - 1] != '\0')
+        return false;
+    *p += 4 + size;
+    return true;
+}
+
+/**
+ * Checks the object at 'obj', which must end before 'end', in one pass which only keeps track of
+ * where it is. 'openFrames' is the number of objects and CodeWScopes that 'obj' is nested in.
+ *
+ * Returns true only if validateBSONIterative() would accept the object. It may also return false
+ * for some objects which validateBSONIterative() accepts, so a false result means that the object
+ * must be checked again by validateBSONIterative(), which also reports what is wrong with it.
+ */
+bool quickValidateObject(const char* obj, const char* end, size_t openFrames) {
+    if (openFrames > BSONDepth::getMaxAllowableDepth() || end - obj < 5)
+        return false;
+
+    const int32_t size = readInt32(obj);
+    if (size < 5 || size > end - obj)
+        return false;
+
+    // Each element has to end before the object's EOO byte.
+    const char* const objEnd = obj + size - 1;
+    if (*objEnd != EOO)
+        return false;
+
+    const char* p = obj + sizeof(int32_t);
+    while (p < objEnd) {
+        const auto type = static_cast<uint8_t>(*p++);
+        if (type == EOO || !quickSkipCString(&p, objEnd))
+            return false;
+
+        const int8_t fixedSize = kFixedValueSizes[type];
+        if (fixedSize >= 0) {
+            if (objEnd - p < fixedSize)
+                return false;
+            if (type == Bool && static_cast<uint8_t>(*p) > 1)
+                return false;
+            p += fixedSize;
+            continue;
+        }
+
+        switch (static_cast<signed char>(type)) {
+            case String:
+            case Code:
+            case Symbol:
+                if (!quickSkipString(&p, objEnd))
+                    return false;
+                break;
+
+            case DBRef:
+                if (!quickSkipString(&p, objEnd) || objEnd - p < OID::kOIDSize)
+                    return false;
+                p += OID::kOIDSize;
+                break;
+
+            case RegEx:
+                if (!quickSkipCString(&p, objEnd) || !quickSkipCString(&p, objEnd))
+                    return false;
+                break;
+
+            case BinData: {
+                if (objEnd - p < 4)
+                    return false;
+                const int32_t binSize = readInt32(p);
+                if (binSize < 0 || binSize > objEnd - p - 5)
+                    return false;
+                p += 5 + binSize;
+                break;
+            }
+
+            case Object:
+            case Array:
+                if (!quickValidateObject(p, objEnd, openFrames + 1))
+                    return false;
+                p += readInt32(p);
+                break;
+
+            case CodeWScope: {
+                if (objEnd - p < 4)
+                    return false;
+                const int32_t codeWScopeSize = readInt32(p);
+                if (codeWScopeSize <= 0 || codeWScopeSize > objEnd - p)
+                    return false;
+                const char* const codeWScopeEnd = p + codeWScopeSize;
+                p += sizeof(int32_t);
+                if (!quickSkipString(&p, codeWScopeEnd) ||
+                    !quickValidateObject(p, codeWScopeEnd, openFrames + 2))
+                    return false;
+                p += readInt32(p);
+                if (p != codeWScopeEnd)
+                    return false;
+                break;
+            }
+
+            default:
+                return false;
+        }
+    }
+
+    return p == objEnd;
+}
+
 }  // namespace
 
 Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion version) {
@@ -420,6 +573,11 @@ Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion
         return Status(ErrorCodes::InvalidBSON, "bson data has to be at least 5 bytes");
     }
 
+    // Nearly all objects are valid, which the single pass can tell for less than the full walk.
+    if (quickValidateObject(originalBuffer, originalBuffer + maxLength, 0)) {
+        return Status::OK();
+    }
+
     Buffer buf(originalBuffer, maxLength, version);
     return validateBSONIterative(&buf);
 }
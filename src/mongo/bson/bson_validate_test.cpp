@@ -32,6 +32,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/data_view.h"
+#include "mongo/bson/bson_depth.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/random.h"
@@ -335,6 +336,64 @@ TEST(BSONValidateFast, StringHasSomething) {
     ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
 }
 
+TEST(BSONValidateFast, CodeWScope) {
+    BSONObjBuilder bob;
+    bob.appendCodeWScope("x", "function() {}", BSON("a" << 1 << "b" << BSON("c" << 2)));
+    bob.append("y", 1);
+    BSONObj obj = bob.obj();
+    ASSERT_OK(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+
+    // Growing the CodeWScope's size leaves it overlapping the next field.
+    BSONObj copy = obj.copy();
+    char* writable = const_cast<char*>(copy["x"].value());
+    DataView(writable).write<LittleEndian<int32_t>>(
+        ConstDataView(writable).read<LittleEndian<int32_t>>() + 1);
+    ASSERT_EQ(ErrorCodes::InvalidBSON,
+              validateBSON(copy.objdata(), copy.objsize(), BSONVersion::kLatest));
+}
+
+TEST(BSONValidateFast, BinDataSizes) {
+    BSONObjBuilder bob;
+    bob.appendBinData("x", 3, BinDataGeneral, "abc");
+    bob.append("y", 1);
+    BSONObj obj = bob.obj();
+    ASSERT_OK(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+
+    char* writable = const_cast<char*>(obj["x"].value());
+    for (int size : {-1, 4, 1000, std::numeric_limits<int>::max()}) {
+        DataView(writable).write<LittleEndian<int32_t>>(size);
+        ASSERT_EQ(ErrorCodes::InvalidBSON,
+                  validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+    }
+}
+
+TEST(BSONValidateFast, EarlyEndOfObject) {
+    BSONObj obj = BSON("a" << 1 << "b" << 2);
+    BSONObj copy = obj.copy();
+    // Replace the type of 'b' with EOO.
+    *const_cast<char*>(copy["b"].rawdata()) = EOO;
+    const Status status = validateBSON(copy.objdata(), copy.objsize(), BSONVersion::kLatest);
+    ASSERT_EQ(ErrorCodes::InvalidBSON, status);
+    ASSERT_STRING_CONTAINS(status.reason(), "bson length doesn't match what we found");
+}
+
+TEST(BSONValidateFast, NestingDepthLimit) {
+    auto nest = [](size_t depth) {
+        BSONObj obj = BSON("a" << 1);
+        for (size_t i = 1; i < depth; ++i) {
+            obj = BSON("a" << obj);
+        }
+        return obj;
+    };
+
+    BSONObj atLimit = nest(BSONDepth::getMaxAllowableDepth());
+    ASSERT_OK(validateBSON(atLimit.objdata(), atLimit.objsize(), BSONVersion::kLatest));
+
+    BSONObj overLimit = nest(BSONDepth::getMaxAllowableDepth() + 2);
+    ASSERT_EQ(ErrorCodes::Overflow,
+              validateBSON(overLimit.objdata(), overLimit.objsize(), BSONVersion::kLatest));
+}
+
 TEST(BSONValidateBool, BoolValuesAreValidated) {
     BSONObjBuilder bob;
     bob.append("x", false);
@@ -31,7 +31,9 @@
 
 #include "mongo/db/jsobj.h"
 
+#include <array>
 #include <boost/lexical_cast.hpp>
+#include <vector>
 
 #include "mongo/bson/timestamp.h"
 #include "mongo/util/log.h"
@@ -255,6 +257,122 @@ const string BSONObjBuilder::numStrs[] = {
 // numStrs is initialized because it is a static variable
 bool BSONObjBuilder::numStrsReady = (numStrs[0].size() > 0);
 
+namespace {
+
+/**
+ * The free buffers kept by a BufBuilderPoolScope, in one list for each power-of-two size.
+ */
+class BufBuilderPool {
+public:
+    static constexpr size_t kMinPooledBytes = 64;
+    static constexpr size_t kMaxPooledBytes = 16 * 1024 * 1024;
+
+    explicit BufBuilderPool(size_t maxBytes) : _maxBytes(maxBytes) {}
+
+    static bool isPooledSize(size_t bytes) {
+        return bytes >= kMinPooledBytes && bytes <= kMaxPooledBytes && (bytes & (bytes - 1)) == 0;
+    }
+
+    /**
+     * Returns a kept buffer of 'bytes' bytes, or a null buffer if there is none.
+     */
+    SharedBuffer take(size_t bytes) {
+        if (!isPooledSize(bytes)) {
+            return {};
+        }
+        auto& buffers = _freeBuffers[sizeClass(bytes)];
+        if (buffers.empty()) {
+            return {};
+        }
+        SharedBuffer buffer = std::move(buffers.back());
+        buffers.pop_back();
+        _pooledBytes -= bytes;
+        return buffer;
+    }
+
+    /**
+     * Keeps 'buffer' for reuse if it is unshared and there is room for it, and otherwise lets it
+     * be freed.
+     */
+    void give(SharedBuffer buffer) {
+        const size_t bytes = buffer.capacity();
+        if (!buffer || buffer.isShared() || !isPooledSize(bytes) ||
+            _pooledBytes + bytes > _maxBytes) {
+            return;
+        }
+        _freeBuffers[sizeClass(bytes)].push_back(std::move(buffer));
+        _pooledBytes += bytes;
+    }
+
+private:
+    static size_t sizeClass(size_t bytes) {
+        size_t sizeClass = 0;
+        for (size_t classBytes = kMinPooledBytes; classBytes < bytes; classBytes *= 2) {
+            ++sizeClass;
+        }
+        return sizeClass;
+    }
+
+    // One list for each power of two from kMinPooledBytes to kMaxPooledBytes.
+    std::array<std::vector<SharedBuffer>, 19> _freeBuffers;
+    const size_t _maxBytes;
+    size_t _pooledBytes = 0;
+};
+
+thread_local BufBuilderPool* threadBufBuilderPool = nullptr;
+
+}  // namespace
+
+BufBuilderPoolScope::BufBuilderPoolScope(size_t maxBytes) {
+    if (!threadBufBuilderPool && maxBytes > 0) {
+        threadBufBuilderPool = new BufBuilderPool(maxBytes);
+        _installed = true;
+    }
+}
+
+BufBuilderPoolScope::~BufBuilderPoolScope() {
+    if (_installed) {
+        delete threadBufBuilderPool;
+        threadBufBuilderPool = nullptr;
+    }
+}
+
+bool BufBuilderPoolScope::isActive() {
+    return threadBufBuilderPool;
+}
+
+void SharedBufferAllocator::malloc(size_t sz) {
+    if (threadBufBuilderPool) {
+        if (SharedBuffer pooled = threadBufBuilderPool->take(sz)) {
+            _buf = std::move(pooled);
+            return;
+        }
+    }
+    _buf = SharedBuffer::allocate(sz);
+}
+
+void SharedBufferAllocator::realloc(size_t sz) {
+    if (threadBufBuilderPool && _buf) {
+        // Move to a new buffer rather than reallocating in place, so that the old one is kept.
+        SharedBuffer grown = threadBufBuilderPool->take(sz);
+        if (!grown) {
+            grown = SharedBuffer::allocate(sz);
+        }
+        memcpy(grown.get(), _buf.get(), std::min(sz, _buf.capacity()));
+        threadBufBuilderPool->give(std::move(_buf));
+        _buf = std::move(grown);
+        return;
+    }
+    _buf.realloc(sz);
+}
+
+void SharedBufferAllocator::free() {
+    if (threadBufBuilderPool) {
+        threadBufBuilderPool->give(std::move(_buf));
+    }
+    _buf = {};
+}
+
 template <typename Alloc>
 void _BufBuilder<Alloc>::grow_reallocate(int minSize) {
     if (minSize > BufferMaxSize) {
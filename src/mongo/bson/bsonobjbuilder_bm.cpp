@@ -50,4 +50,20 @@ void BM_arrayBuilder(benchmark::State& state) {
 
 BENCHMARK(BM_arrayBuilder)->Ranges({{{1}, {100'000}}});
 
+void BM_arrayBuilderPooled(benchmark::State& state) {
+    BufBuilderPoolScope pool(64 * 1024 * 1024);
+    size_t totalBytes = 0;
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        BSONArrayBuilder array;
+        for (auto j = 0; j < state.range(0); j++)
+            array.append(j);
+        totalBytes += array.len();
+        benchmark::DoNotOptimize(array.done());
+    }
+    state.SetBytesProcessed(totalBytes);
+}
+
+BENCHMARK(BM_arrayBuilderPooled)->Ranges({{{1}, {100'000}}});
+
 }  // namespace mongo
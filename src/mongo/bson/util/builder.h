@@ -75,6 +75,33 @@ const int BufferMaxSize = 64 * 1024 * 1024;
 template <typename Allocator>
 class StringBuilderImpl;
 
+/**
+ * While an instance is alive, the buffers which the BufBuilders on this thread free or outgrow are
+ * kept, up to 'maxBytes' of them, and handed to the next BufBuilders that need a buffer of the
+ * same size rather than going back to the allocator. Only buffers whose size is a power of two
+ * from 64 bytes to 16MB, which is every size a BufBuilder grows to, are kept.
+ *
+ * A buffer released from a builder into a BSONObj or Message belongs to it and is freed the usual
+ * way. The buffers still kept are freed when the scope ends. A scope opened while another is alive
+ * on the same thread does nothing.
+ */
+class BufBuilderPoolScope {
+    BufBuilderPoolScope(const BufBuilderPoolScope&) = delete;
+    BufBuilderPoolScope& operator=(const BufBuilderPoolScope&) = delete;
+
+public:
+    explicit BufBuilderPoolScope(size_t maxBytes);
+    ~BufBuilderPoolScope();
+
+    /**
+     * Returns true if a scope is pooling buffers on this thread.
+     */
+    static bool isActive();
+
+private:
+    bool _installed = false;
+};
+
 class SharedBufferAllocator {
     SharedBufferAllocator(const SharedBufferAllocator&) = delete;
     SharedBufferAllocator& operator=(const SharedBufferAllocator&) = delete;
@@ -85,20 +112,20 @@ public:
         invariant(!_buf.isShared());
     }
 
+    ~SharedBufferAllocator() {
+        free();
+    }
+
     // Allow moving but not copying. It would be an error for two SharedBufferAllocators to use the
     // same underlying buffer.
     SharedBufferAllocator(SharedBufferAllocator&&) = default;
     SharedBufferAllocator& operator=(SharedBufferAllocator&&) = default;
 
-    void malloc(size_t sz) {
-        _buf = SharedBuffer::allocate(sz);
-    }
-    void realloc(size_t sz) {
-        _buf.realloc(sz);
-    }
-    void free() {
-        _buf = {};
-    }
+    // These draw from and give back to the BufBuilderPoolScope of this thread, if there is one.
+    void malloc(size_t sz);
+    void realloc(size_t sz);
+    void free();
+
     SharedBuffer release() {
         return std::move(_buf);
     }
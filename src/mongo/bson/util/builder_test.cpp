@@ -84,6 +84,76 @@ TEST(Builder, StackAllocatorShouldNotLeak) {
     // Let the builder go out of scope. If this leaks, it will trip the ASAN leak detector.
 }
 
+TEST(Builder, PoolReusesFreedBuffers) {
+    BufBuilderPoolScope scope(1024 * 1024);
+    ASSERT_TRUE(BufBuilderPoolScope::isActive());
+
+    const char* firstBuffer;
+    {
+        BufBuilder b;
+        b.appendStr("first");
+        firstBuffer = b.buf();
+    }
+    BufBuilder b;
+    ASSERT_EQ(firstBuffer, b.buf());
+
+    // The buffers outgrown on the way to 4096 bytes are reused by the next builder to grow.
+    for (int i = 0; i < 1024; ++i) {
+        b.appendNum(i);
+    }
+    ASSERT_EQ(4096, b.getSize());
+    BufBuilder next;
+    ASSERT_EQ(firstBuffer, next.buf());
+    next.skip(1000);
+    next.appendStr("grown");
+    ASSERT_EQ(1024, next.getSize());
+    ASSERT_EQ(std::string("grown"), next.buf() + 1000);
+    for (int i = 0; i < 1024; ++i) {
+        ASSERT_EQ(i, ConstDataView(b.buf() + i * sizeof(int)).read<LittleEndian<int>>());
+    }
+}
+
+TEST(Builder, PoolDoesNotKeepReleasedBuffers) {
+    BufBuilderPoolScope scope(1024 * 1024);
+    SharedBuffer released;
+    {
+        BufBuilder b;
+        b.appendStr("released");
+        released = b.release();
+    }
+    BufBuilder b;
+    ASSERT_NE(released.get(), b.buf());
+    ASSERT_EQ(std::string("released"), released.get());
+}
+
+TEST(Builder, PoolScopesNestAndRespectTheirLimit) {
+    {
+        BufBuilderPoolScope disabled(0);
+        ASSERT_FALSE(BufBuilderPoolScope::isActive());
+    }
+
+    BufBuilderPoolScope outer(512);
+    {
+        BufBuilderPoolScope inner(1024 * 1024);
+        ASSERT_TRUE(BufBuilderPoolScope::isActive());
+    }
+    ASSERT_TRUE(BufBuilderPoolScope::isActive());
+
+    // Only one of the two 512 byte buffers fits in the pool.
+    const char* firstBuffer;
+    const char* secondBuffer;
+    {
+        BufBuilder first;
+        BufBuilder second;
+        firstBuffer = first.buf();
+        secondBuffer = second.buf();
+    }
+    BufBuilder reused;
+    BufBuilder fresh;
+    ASSERT_TRUE(reused.buf() == firstBuffer || reused.buf() == secondBuffer);
+    ASSERT_NE(reused.buf(), fresh.buf());
+}
+
 template <typename T>
 void testStringBuilderIntegral() {
     auto check = [](T num) { ASSERT_EQ(std::string(str::stream() << num), std::to_string(num)); };
@@ -121,7 +121,7 @@ TagSet defaultTagSetForMode(ReadPreference mode) {
 const Seconds ReadPreferenceSetting::kMinimalMaxStalenessValue(90);
 
 const OperationContext::Decoration<ReadPreferenceSetting> ReadPreferenceSetting::get =
-    OperationContext::declareDecoration<ReadPreferenceSetting>();
+    OperationContext::declareHotDecoration<ReadPreferenceSetting>();
 
 const BSONObj& ReadPreferenceSetting::secondaryPreferredMetadata() {
     // This is a static method rather than a static member only because it is used by another TU
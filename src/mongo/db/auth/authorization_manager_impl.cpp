@@ -207,6 +207,7 @@ private:
 }  // namespace
 
 int authorizationManagerCacheSize;
+int authorizationManagerCacheShards;
 
 void AuthorizationManagerPinnedUsersServerParameter::append(OperationContext* opCtx,
                                                             BSONObjBuilder& out,
@@ -352,7 +353,9 @@ AuthorizationManagerImpl::AuthorizationManagerImpl(
       _privilegeDocsExist(false),
       _externalState(std::move(externalState)),
       _version(schemaVersionInvalid),
-      _userCache(authorizationManagerCacheSize, UserCacheInvalidator()),
+      _userCache(authorizationManagerCacheSize,
+                 authorizationManagerCacheShards,
+                 UserCacheInvalidator()),
       _fetchGeneration(OID::gen()) {}
 
 AuthorizationManagerImpl::~AuthorizationManagerImpl() {}
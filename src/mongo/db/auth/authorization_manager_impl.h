@@ -230,7 +230,7 @@ private:
         void operator()(User* user);
     };
 
-    InvalidatingLRUCache<UserName, User, UserCacheInvalidator> _userCache;
+    ShardedInvalidatingLRUCache<UserName, User, UserCacheInvalidator> _userCache;
 
     stdx::mutex _pinnedUsersMutex;
     stdx::condition_variable _pinnedUsersCond;
@@ -265,5 +265,6 @@ private:
 };
 
 extern int authorizationManagerCacheSize;
+extern int authorizationManagerCacheShards;
 
 }  // namespace mongo
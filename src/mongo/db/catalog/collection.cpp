@@ -35,10 +35,13 @@
 
 #include <sstream>
 
+#include "mongo/stdx/thread.h"
+
 namespace mongo {
 
 std::string CompactOptions::toString() const {
-    return str::stream() << " validateDocuments: " << validateDocuments;
+    return str::stream() << " validateDocuments: " << validateDocuments
+                         << " indexesOnly: " << indexesOnly;
 }
 
 //
@@ -51,13 +54,25 @@ void CappedInsertNotifier::notifyAll() {
     _notifier.notify_all();
 }
 
-void CappedInsertNotifier::waitUntil(uint64_t prevVersion, Date_t deadline) const {
+void CappedInsertNotifier::waitUntil(uint64_t prevVersion,
+                                     Date_t deadline,
+                                     Milliseconds coalesce) const {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
     while (!_dead && prevVersion == _version) {
         if (stdx::cv_status::timeout == _notifier.wait_until(lk, deadline.toSystemTimePoint())) {
             return;
         }
     }
+
+    if (_dead || coalesce <= Milliseconds(0)) {
+        return;
+    }
+
+    // Sleep rather than wait on '_notifier', so that the inserts made meanwhile do not wake this
+    // thread up again.
+    lk.unlock();
+    const auto wakeUp = std::min(deadline, Date_t::now() + coalesce);
+    stdx::this_thread::sleep_until(wakeUp.toSystemTimePoint());
 }
 
 void CappedInsertNotifier::kill() {
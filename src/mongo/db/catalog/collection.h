@@ -59,6 +59,7 @@ namespace mongo {
 class CappedCallback;
 class CollectionCatalogEntry;
 class ExtentManager;
+class FieldRefSetWithStorage;
 class IndexCatalog;
 class IndexCatalogEntry;
 class IndexDescriptor;
@@ -94,6 +95,14 @@ struct CollectionUpdateArgs {
     bool fromMigrate = false;
 
     StoreDocOption storeDocOption = StoreDocOption::None;
+
+    // The paths that the update may have modified, when they are known. Indexes which neither
+    // index nor filter on any of these paths are not updated.
+    const FieldRefSetWithStorage* modifiedPaths = nullptr;
+
+    // The oplog slot reserved for the update's oplog entry, if it was reserved before the write
+    // so that several updates can be timestamped within one WriteUnitOfWork.
+    OplogSlot oplogSlot;
 };
 
 /**
@@ -111,9 +120,15 @@ public:
      * Waits until 'deadline', or until notifyAll() is called to indicate that new
      * data is available in the capped collection.
      *
+     * If 'coalesce' is positive, a waiter woken by new data waits that much longer, though not
+     * past 'deadline', so that it finds the inserts which closely follow in the same scan instead
+     * of being woken up again for each of them.
+     *
      * NOTE: Waiting threads can be signaled by calling kill or notify* methods.
      */
-    void waitUntil(uint64_t prevVersion, Date_t deadline) const;
+    void waitUntil(uint64_t prevVersion,
+                   Date_t deadline,
+                   Milliseconds coalesce = Milliseconds(0)) const;
 
     /**
      * Returns the version for use as an additional wake condition when used above.
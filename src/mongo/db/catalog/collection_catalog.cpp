@@ -225,6 +225,7 @@ void CollectionCatalog::setCollectionNamespace(OperationContext* opCtx,
 
     _collections[toCollection] = _collections[fromCollection];
     _collections.erase(fromCollection);
+    _invalidateLookupSnapshot(lock);
 
     ResourceId oldRid = ResourceId(RESOURCE_COLLECTION, fromCollection.ns());
     ResourceId newRid = ResourceId(RESOURCE_COLLECTION, toCollection.ns());
@@ -239,6 +240,7 @@ void CollectionCatalog::setCollectionNamespace(OperationContext* opCtx,
 
         _collections[fromCollection] = _collections[toCollection];
         _collections.erase(toCollection);
+        _invalidateLookupSnapshot(lock);
 
         ResourceId oldRid = ResourceId(RESOURCE_COLLECTION, fromCollection.ns());
         ResourceId newRid = ResourceId(RESOURCE_COLLECTION, toCollection.ns());
@@ -270,9 +272,45 @@ void CollectionCatalog::onOpenCatalog(OperationContext* opCtx) {
     _shadowCatalog.reset();
 }
 
-Collection* CollectionCatalog::lookupCollectionByUUID(CollectionUUID uuid) const {
+std::shared_ptr<const CollectionCatalog::LookupSnapshot> CollectionCatalog::_getLookupSnapshot()
+    const {
+    if (auto snapshot = std::atomic_load(&_lookupSnapshot)) {
+        return snapshot;
+    }
+
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    return _lookupCollectionByUUID(lock, uuid);
+    // Another lookup may have rebuilt the snapshot while we waited for the lock.
+    if (auto snapshot = std::atomic_load(&_lookupSnapshot)) {
+        return snapshot;
+    }
+
+    auto snapshot = std::make_shared<LookupSnapshot>();
+    snapshot->byUUID.reserve(_catalog.size());
+    for (const auto& entry : _catalog) {
+        if (entry.second.collectionPtr) {
+            snapshot->byUUID.emplace(entry.first, entry.second.collection.get());
+        }
+    }
+    snapshot->byNamespace.reserve(_collections.size());
+    for (const auto& entry : _collections) {
+        if (entry.second->collectionPtr) {
+            snapshot->byNamespace.emplace(entry.first, entry.second->collection.get());
+        }
+    }
+
+    std::shared_ptr<const LookupSnapshot> published(std::move(snapshot));
+    std::atomic_store(&_lookupSnapshot, published);
+    return published;
+}
+
+void CollectionCatalog::_invalidateLookupSnapshot(WithLock) {
+    std::atomic_store(&_lookupSnapshot, std::shared_ptr<const LookupSnapshot>());
+}
+
+Collection* CollectionCatalog::lookupCollectionByUUID(CollectionUUID uuid) const {
+    auto snapshot = _getLookupSnapshot();
+    auto it = snapshot->byUUID.find(uuid);
+    return it == snapshot->byUUID.end() ? nullptr : it->second;
 }
 
 Collection* CollectionCatalog::_lookupCollectionByUUID(WithLock, CollectionUUID uuid) const {
@@ -283,11 +321,9 @@ Collection* CollectionCatalog::_lookupCollectionByUUID(WithLock, CollectionUUID
 }
 
 Collection* CollectionCatalog::lookupCollectionByNamespace(const NamespaceString& nss) const {
-    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    auto it = _collections.find(nss);
-    return it == _collections.end() || it->second->collectionPtr == nullptr
-        ? nullptr
-        : it->second->collection.get();
+    auto snapshot = _getLookupSnapshot();
+    auto it = snapshot->byNamespace.find(nss);
+    return it == snapshot->byNamespace.end() ? nullptr : it->second;
 }
 
 CollectionCatalogEntry* CollectionCatalog::lookupCollectionCatalogEntryByUUID(
@@ -428,6 +464,7 @@ void CollectionCatalog::registerCollection(
     _catalog[uuid] = std::move(collectionInfo);
     _collections[ns] = &_catalog[uuid];
     _orderedCollections[dbIdPair] = &_catalog[uuid];
+    _invalidateLookupSnapshot(lock);
 
     auto dbRid = ResourceId(RESOURCE_DATABASE, dbName);
     addResource(dbRid, dbName);
@@ -460,6 +497,7 @@ CollectionCatalog::deregisterCollection(CollectionUUID uuid) {
     _orderedCollections.erase(dbIdPair);
     _collections.erase(ns);
     _catalog.erase(uuid);
+    _invalidateLookupSnapshot(lock);
 
     auto collRid = ResourceId(RESOURCE_COLLECTION, ns.ns());
     removeResource(collRid, ns.ns());
@@ -497,6 +535,7 @@ void CollectionCatalog::deregisterAllCatalogEntriesAndCollectionObjects() {
     _collections.clear();
     _orderedCollections.clear();
     _catalog.clear();
+    _invalidateLookupSnapshot(lock);
 
     stdx::lock_guard<stdx::mutex> resourceLock(_resourceLock);
     _resourceInformation.clear();
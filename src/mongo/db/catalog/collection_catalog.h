@@ -31,6 +31,7 @@
 
 #include <functional>
 #include <map>
+#include <memory>
 #include <set>
 #include <unordered_map>
 
@@ -275,7 +276,34 @@ private:
 
     const std::vector<CollectionUUID>& _getOrdering_inlock(const StringData& db,
                                                            const stdx::lock_guard<stdx::mutex>&);
+
+    /**
+     * Immutable copy of the UUID and namespace to Collection mappings, which lets the
+     * lookupCollectionBy* methods run without taking '_catalogLock'.
+     */
+    struct LookupSnapshot {
+        mongo::stdx::unordered_map<CollectionUUID, Collection*, CollectionUUID::Hash> byUUID;
+        mongo::stdx::unordered_map<NamespaceString, Collection*> byNamespace;
+    };
+
+    /**
+     * Returns the current lookup snapshot, building it from the catalog first if a change to the
+     * catalog has discarded it.
+     */
+    std::shared_ptr<const LookupSnapshot> _getLookupSnapshot() const;
+
+    /**
+     * Discards the lookup snapshot after a change to the catalog. Must be called with
+     * '_catalogLock' held, after the change itself.
+     */
+    void _invalidateLookupSnapshot(WithLock);
+
     mutable mongo::stdx::mutex _catalogLock;
+
+    // Only accessed through std::atomic_load and std::atomic_store. Null when it needs to be
+    // rebuilt by the next lookup, so that a burst of changes, such as registering every collection
+    // at startup, pays for one copy of the catalog rather than one per change.
+    mutable std::shared_ptr<const LookupSnapshot> _lookupSnapshot;
     /**
      * When present, indicates that the catalog is in closed state, and contains a map from UUID
      * to pre-close NSS. See also onCloseCatalog.
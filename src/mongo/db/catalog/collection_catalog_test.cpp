@@ -529,6 +529,26 @@ TEST_F(CollectionCatalogTest, RenameCollection) {
     ASSERT_EQUALS(catalog.lookupCollectionByUUID(uuid), collection);
 }
 
+TEST_F(CollectionCatalogTest, LookupCollectionByNamespaceFollowsRenameAndDrop) {
+    auto uuid = CollectionUUID::gen();
+    NamespaceString oldNss(nss.db(), "oldcol");
+    auto collUnique = std::make_unique<CollectionMock>(oldNss);
+    auto catalogEntry = std::make_unique<CollectionCatalogEntryMock>(oldNss.ns());
+    auto collection = collUnique.get();
+    catalog.registerCollection(uuid, std::move(catalogEntry), std::move(collUnique));
+    ASSERT_EQUALS(catalog.lookupCollectionByNamespace(oldNss), collection);
+
+    NamespaceString newNss(nss.db(), "newcol");
+    catalog.setCollectionNamespace(&opCtx, collection, oldNss, newNss);
+    ASSERT(catalog.lookupCollectionByNamespace(oldNss) == nullptr);
+    ASSERT_EQUALS(catalog.lookupCollectionByNamespace(newNss), collection);
+
+    auto deregistered = catalog.deregisterCollection(uuid);
+    ASSERT(catalog.lookupCollectionByNamespace(newNss) == nullptr);
+    ASSERT(catalog.lookupCollectionByUUID(uuid) == nullptr);
+    ASSERT_EQUALS(catalog.lookupCollectionByUUID(colUUID)->ns(), nss);
+}
+
 TEST_F(CollectionCatalogTest, LookupNSSByUUIDForClosedCatalogReturnsOldNSSIfDropped) {
     catalog.onCloseCatalog(&opCtx);
     catalog.deregisterCollection(colUUID);
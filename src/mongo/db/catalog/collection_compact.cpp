@@ -45,7 +45,8 @@ namespace mongo {
 StatusWith<CompactStats> compactCollection(OperationContext* opCtx,
                                            Collection* collection,
                                            const CompactOptions* compactOptions) {
-    dassert(opCtx->lockState()->isCollectionLockedForMode(collection->ns(), MODE_X));
+    dassert(opCtx->lockState()->isCollectionLockedForMode(
+        collection->ns(), compactOptions->indexesOnly ? MODE_IX : MODE_X));
 
     DisableDocumentValidation validationDisabler(opCtx);
 
@@ -58,6 +59,23 @@ StatusWith<CompactStats> compactCollection(OperationContext* opCtx,
                                             << "cannot compact collection with record store: "
                                             << recordStore->name());
 
+    if (compactOptions->indexesOnly) {
+        // Only storage engines which compact indexes in place can do so while the collection is
+        // written, since otherwise the indexes would have to be dropped and built again.
+        if (!recordStore->compactsInPlace())
+            return StatusWith<CompactStats>(
+                ErrorCodes::CommandNotSupported,
+                str::stream() << "cannot compact only the indexes of a collection with record "
+                                 "store: "
+                              << recordStore->name());
+
+        Status status = indexCatalog->compactIndexes(opCtx);
+        if (!status.isOK())
+            return StatusWith<CompactStats>(status);
+
+        return StatusWith<CompactStats>(CompactStats());
+    }
+
     if (recordStore->compactsInPlace()) {
         CompactStats stats;
         Status status = recordStore->compact(opCtx);
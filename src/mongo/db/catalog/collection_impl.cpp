@@ -50,6 +50,8 @@
 #include "mongo/db/catalog/index_catalog_impl.h"
 #include "mongo/db/catalog/index_consistency.h"
 #include "mongo/db/catalog/index_key_validate.h"
+#include "mongo/db/catalog/validate_gen.h"
+#include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
@@ -73,6 +75,9 @@
 
 #include "mongo/db/auth/user_document_parser.h"  // XXX-ANDY
 #include "mongo/rpc/object_check.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 
@@ -369,6 +374,8 @@ Status CollectionImpl::insertDocumentsForOplog(OperationContext* opCtx,
     if (!status.isOK())
         return status;
 
+    infoCache()->notifyOfWrite(opCtx);
+
     opCtx->recoveryUnit()->onCommit(
         [this](boost::optional<Timestamp>) { notifyCappedWaitersIfNeeded(); });
 
@@ -410,6 +417,7 @@ Status CollectionImpl::insertDocuments(OperationContext* opCtx,
         return status;
     }
     invariant(sid == opCtx->recoveryUnit()->getSnapshotId());
+    infoCache()->notifyOfWrite(opCtx);
 
     getGlobalServiceContext()->getOpObserver()->onInserts(
         opCtx, ns(), uuid(), begin, end, fromMigrate);
@@ -476,6 +484,7 @@ Status CollectionImpl::insertDocumentForBulkLoader(OperationContext* opCtx,
     if (!status.isOK()) {
         return status;
     }
+    infoCache()->notifyOfWrite(opCtx);
 
     vector<InsertStatement> inserts;
     OplogSlot slot;
@@ -613,6 +622,7 @@ void CollectionImpl::deleteDocument(OperationContext* opCtx,
     int64_t keysDeleted;
     _indexCatalog->unindexRecord(opCtx, doc.value(), loc, noWarn, &keysDeleted);
     _recordStore->deleteRecord(opCtx, loc);
+    infoCache()->notifyOfWrite(opCtx);
 
     getGlobalServiceContext()->getOpObserver()->onDelete(
         opCtx, ns(), uuid(), stmtId, fromMigrate, deletedDoc);
@@ -685,12 +695,18 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
 
     uassertStatusOK(
         _recordStore->updateRecord(opCtx, oldLocation, newDoc.objdata(), newDoc.objsize()));
+    infoCache()->notifyOfWrite(opCtx);
 
     if (indexesAffected) {
         int64_t keysInserted, keysDeleted;
 
-        uassertStatusOK(_indexCatalog->updateRecord(
-            opCtx, args->preImageDoc.get(), newDoc, oldLocation, &keysInserted, &keysDeleted));
+        uassertStatusOK(_indexCatalog->updateRecord(opCtx,
+                                                    args->preImageDoc.get(),
+                                                    newDoc,
+                                                    oldLocation,
+                                                    args->modifiedPaths,
+                                                    &keysInserted,
+                                                    &keysDeleted));
 
         if (opDebug) {
             opDebug->additiveMetrics.incrementKeysInserted(keysInserted);
@@ -730,6 +746,7 @@ StatusWith<RecordData> CollectionImpl::updateDocumentWithDamages(
         _recordStore->updateWithDamages(opCtx, loc, oldRec.value(), damageSource, damages);
 
     if (newRecStatus.isOK()) {
+        infoCache()->notifyOfWrite(opCtx);
         args->updatedDoc = newRecStatus.getValue().toBson();
 
         invariant(uuid());
@@ -818,6 +835,7 @@ Status CollectionImpl::truncate(OperationContext* opCtx) {
     auto status = _recordStore->truncate(opCtx);
     if (!status.isOK())
         return status;
+    infoCache()->notifyOfWrite(opCtx);
 
     // 4) re-create indexes
     for (size_t i = 0; i < indexSpecs.size(); i++) {
@@ -835,6 +853,7 @@ void CollectionImpl::cappedTruncateAfter(OperationContext* opCtx, RecordId end,
     invariant(_indexCatalog->numIndexesInProgress(opCtx) == 0);
 
     _recordStore->cappedTruncateAfter(opCtx, end, inclusive);
+    infoCache()->notifyOfWrite(opCtx);
 }
 
 Status CollectionImpl::setValidator(OperationContext* opCtx, BSONObj validatorDoc) {
@@ -1096,6 +1115,111 @@ void _validateRecordStore(OperationContext* opCtx,
     }
 }
 
+// The outcome of traversing one index during the first phase of validation.
+struct IndexTraversal {
+    const IndexCatalogEntry* entry;
+    bool traversed = false;
+    bool checkCounts = false;
+    int64_t numTraversedKeys = 0;
+    int64_t numValidatedKeys = 0;
+};
+
+void _traverseIndex(OperationContext* opCtx,
+                    RecordStoreValidateAdaptor* indexValidator,
+                    ValidateCmdLevel level,
+                    ValidateResults* curIndexResults,
+                    IndexTraversal* traversal) {
+    const IndexDescriptor* descriptor = traversal->entry->descriptor();
+    const IndexAccessMethod* iam = traversal->entry->accessMethod();
+
+    log(LogComponent::kIndex) << "validating index " << descriptor->indexName()
+                              << " on collection " << descriptor->parentNS();
+
+    if (level == kValidateFull) {
+        iam->validate(opCtx, &traversal->numValidatedKeys, curIndexResults);
+        traversal->checkCounts = true;
+    }
+
+    if (curIndexResults->valid) {
+        indexValidator->traverseIndex(
+            iam, descriptor, curIndexResults, &traversal->numTraversedKeys);
+    }
+    traversal->traversed = true;
+}
+
+/**
+ * Traverses the indexes in 'traversals' on up to 'numThreads' threads, each with an operation
+ * context of its own. The command's collection lock keeps the indexes from changing meanwhile, and
+ * the counts kept by the index consistency are protected by its mutex. A worker never waits for
+ * the global lock, since a request which blocks it may be queued behind our own; the indexes it
+ * could not lock are left untraversed.
+ */
+void _traverseIndexesInParallel(OperationContext* opCtx,
+                                RecordStoreValidateAdaptor* indexValidator,
+                                ValidateCmdLevel level,
+                                size_t numThreads,
+                                ValidateResultsMap* indexNsResultsMap,
+                                std::vector<IndexTraversal>* traversals) {
+    ThreadPool::Options options;
+    options.poolName = "ValidateIndexes";
+    options.threadNamePrefix = "validateIndexes-";
+    options.minThreads = 0;
+    options.maxThreads = std::min(numThreads, traversals->size());
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName.c_str());
+    };
+    ThreadPool pool(options);
+    pool.startup();
+
+    stdx::mutex mutex;
+    stdx::condition_variable allDone;
+    size_t outstanding = traversals->size();
+    std::vector<Status> statuses(traversals->size(), Status::OK());
+
+    for (size_t i = 0; i < traversals->size(); ++i) {
+        IndexTraversal* traversal = &(*traversals)[i];
+        ValidateResults* curIndexResults =
+            &(*indexNsResultsMap)[traversal->entry->descriptor()->indexName()];
+
+        pool.schedule([&, i, traversal, curIndexResults](Status status) {
+            if (!status.isOK()) {
+                statuses[i] = status;
+            } else {
+                auto workerOpCtx = cc().makeOperationContext();
+                workerOpCtx->lockState()->setMaxLockTimeout(Milliseconds(0));
+                auto workerValidator = indexValidator->withOperationContext(workerOpCtx.get());
+                try {
+                    Lock::GlobalLock globalLock(workerOpCtx.get(), MODE_IS);
+                    _traverseIndex(
+                        workerOpCtx.get(), &workerValidator, level, curIndexResults, traversal);
+                } catch (const ExceptionFor<ErrorCodes::LockTimeout>&) {
+                    // Left for the command's own thread.
+                } catch (const DBException& ex) {
+                    statuses[i] = ex.toStatus();
+                }
+            }
+
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (--outstanding == 0) {
+                allDone.notify_all();
+            }
+        });
+    }
+
+    // The wait is not interruptible, since the workers refer to the collection's indexes. An index
+    // traversal does not check for interrupts on the command's thread either.
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        allDone.wait(lk, [&] { return outstanding == 0; });
+    }
+    pool.shutdown();
+    pool.join();
+
+    for (auto&& status : statuses) {
+        uassertStatusOK(status);
+    }
+}
+
 void _validateIndexes(OperationContext* opCtx,
                       IndexCatalog* indexCatalog,
                       BSONObjBuilder* keysPerIndex,
@@ -1104,43 +1228,48 @@ void _validateIndexes(OperationContext* opCtx,
                       ValidateResultsMap* indexNsResultsMap,
                       ValidateResults* results) {
 
+    std::vector<IndexTraversal> traversals;
     std::unique_ptr<IndexCatalog::IndexIterator> it = indexCatalog->getIndexIterator(opCtx, false);
+    while (it->more()) {
+        traversals.push_back({it->next()});
+
+        // Create the results of every index up front, so that the workers never modify the map.
+        (*indexNsResultsMap)[traversals.back().entry->descriptor()->indexName()];
+    }
+
+    // Traverse the indexes on other threads first if so configured, and then any which remain.
+    const size_t numThreads = static_cast<size_t>(validateIndexTraversalThreads.load());
+    if (numThreads > 1 && traversals.size() > 1) {
+        _traverseIndexesInParallel(
+            opCtx, indexValidator, level, numThreads, indexNsResultsMap, &traversals);
+    }
 
     // Validate Indexes.
-    while (it->more()) {
+    for (auto&& traversal : traversals) {
         opCtx->checkForInterrupt();
-        const IndexCatalogEntry* entry = it->next();
-        const IndexDescriptor* descriptor = entry->descriptor();
-        const IndexAccessMethod* iam = entry->accessMethod();
-
-        log(LogComponent::kIndex) << "validating index " << descriptor->indexName()
-                                  << " on collection " << descriptor->parentNS();
+        const IndexDescriptor* descriptor = traversal.entry->descriptor();
         ValidateResults& curIndexResults = (*indexNsResultsMap)[descriptor->indexName()];
-        bool checkCounts = false;
-        int64_t numTraversedKeys;
-        int64_t numValidatedKeys;
 
-        if (level == kValidateFull) {
-            iam->validate(opCtx, &numValidatedKeys, &curIndexResults);
-            checkCounts = true;
+        if (!traversal.traversed) {
+            _traverseIndex(opCtx, indexValidator, level, &curIndexResults, &traversal);
         }
 
         if (curIndexResults.valid) {
-            indexValidator->traverseIndex(iam, descriptor, &curIndexResults, &numTraversedKeys);
-
-            if (checkCounts && (numValidatedKeys != numTraversedKeys)) {
+            if (traversal.checkCounts &&
+                (traversal.numValidatedKeys != traversal.numTraversedKeys)) {
                 curIndexResults.valid = false;
-                string msg = str::stream()
-                    << "number of traversed index entries (" << numTraversedKeys
-                    << ") does not match the number of expected index entries (" << numValidatedKeys
-                    << ")";
+                string msg = str::stream() << "number of traversed index entries ("
+                                           << traversal.numTraversedKeys
+                                           << ") does not match the number of expected index "
+                                              "entries ("
+                                           << traversal.numValidatedKeys << ")";
                 results->errors.push_back(msg);
                 results->valid = false;
             }
 
             if (curIndexResults.valid) {
                 keysPerIndex->appendNumber(descriptor->indexName(),
-                                           static_cast<long long>(numTraversedKeys));
+                                           static_cast<long long>(traversal.numTraversedKeys));
             } else {
                 results->valid = false;
             }
@@ -30,7 +30,9 @@
 #pragma once
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cache_snapshot.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
 
@@ -62,6 +64,16 @@ public:
      */
     virtual QuerySettings* getQuerySettings() const = 0;
 
+    /**
+     * Get the statistics on the indexed fields of this collection.
+     */
+    virtual IndexStatisticsCache* getIndexStatistics() const = 0;
+
+    /**
+     * Get the plan cache entries saved for this collection which have yet to be restored.
+     */
+    virtual PlanCacheSnapshot* getPlanCacheSnapshot() const = 0;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -104,6 +116,19 @@ public:
     virtual void notifyOfQuery(OperationContext* const opCtx,
                                const std::set<std::string>& indexesUsed) = 0;
 
+    /**
+     * Signal to the cache that the collection is being written to. The write epoch changes once
+     * the write's unit of work commits.
+     */
+    virtual void notifyOfWrite(OperationContext* const opCtx) = 0;
+
+    /**
+     * Returns a number which changes each time a write to the collection commits, and which no
+     * other instance of any collection returns. Results read from the collection while it returns
+     * the same number are of the same data.
+     */
+    virtual unsigned long long getWriteEpoch() const = 0;
+
     virtual void setNs(NamespaceString ns) = 0;
 };
 }  // namespace mongo
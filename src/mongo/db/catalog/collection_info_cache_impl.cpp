@@ -42,6 +42,7 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index/wildcard_access_method.h"
 #include "mongo/db/index_legacy.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/planner_ixselect.h"
@@ -51,6 +52,10 @@
 #include "mongo/util/log.h"
 
 namespace mongo {
+namespace {
+// The source of every collection's write epochs, so that no two instances share one.
+AtomicWord<unsigned long long> lastWriteEpoch;
+}  // namespace
 
 CollectionInfoCacheImpl::CollectionInfoCacheImpl(Collection* collection, const NamespaceString& ns)
     : _collection(collection),
@@ -58,7 +63,10 @@ CollectionInfoCacheImpl::CollectionInfoCacheImpl(Collection* collection, const N
       _keysComputed(false),
       _planCache(std::make_unique<PlanCache>(ns.ns())),
       _querySettings(std::make_unique<QuerySettings>()),
-      _indexUsageTracker(getGlobalServiceContext()->getPreciseClockSource()) {}
+      _indexStatistics(std::make_unique<IndexStatisticsCache>()),
+      _planCacheSnapshot(std::make_unique<PlanCacheSnapshot>()),
+      _indexUsageTracker(getGlobalServiceContext()->getPreciseClockSource()),
+      _writeEpoch(lastWriteEpoch.addAndFetch(1)) {}
 
 CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
     // Necessary because the collection cache will not explicitly get updated upon database drop.
@@ -173,6 +181,14 @@ void CollectionInfoCacheImpl::notifyOfQuery(OperationContext* opCtx,
     }
 }
 
+void CollectionInfoCacheImpl::notifyOfWrite(OperationContext* opCtx) {
+    // Changing the epoch only once the write is visible means that no result read under an epoch
+    // can be missing a write which committed before that epoch was current.
+    opCtx->recoveryUnit()->onCommit([this](boost::optional<Timestamp>) {
+        _writeEpoch.store(lastWriteEpoch.addAndFetch(1));
+    });
+}
+
 void CollectionInfoCacheImpl::clearQueryCache() {
     LOG(1) << _collection->ns() << ": clearing plan cache - collection info cache reset";
     if (nullptr != _planCache.get()) {
@@ -188,6 +204,14 @@ QuerySettings* CollectionInfoCacheImpl::getQuerySettings() const {
     return _querySettings.get();
 }
 
+IndexStatisticsCache* CollectionInfoCacheImpl::getIndexStatistics() const {
+    return _indexStatistics.get();
+}
+
+PlanCacheSnapshot* CollectionInfoCacheImpl::getPlanCacheSnapshot() const {
+    return _planCacheSnapshot.get();
+}
+
 void CollectionInfoCacheImpl::updatePlanCacheIndexEntries(OperationContext* opCtx) {
     std::vector<CoreIndexInfo> indexCores;
 
@@ -239,6 +263,8 @@ void CollectionInfoCacheImpl::droppedIndex(OperationContext* opCtx, StringData i
 
 void CollectionInfoCacheImpl::rebuildIndexData(OperationContext* opCtx) {
     clearQueryCache();
+    _indexStatistics->clear();
+    _planCacheSnapshot->clear();
 
     _keysComputed = false;
     computeIndexKeys(opCtx);
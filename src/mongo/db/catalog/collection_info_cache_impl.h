@@ -35,6 +35,7 @@
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
@@ -62,6 +63,16 @@ public:
      */
     QuerySettings* getQuerySettings() const;
 
+    /**
+     * Get the statistics on the indexed fields of this collection.
+     */
+    IndexStatisticsCache* getIndexStatistics() const;
+
+    /**
+     * Get the plan cache entries saved for this collection which have yet to be restored.
+     */
+    PlanCacheSnapshot* getPlanCacheSnapshot() const;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -108,6 +119,12 @@ public:
      */
     void notifyOfQuery(OperationContext* opCtx, const std::set<std::string>& indexesUsed);
 
+    void notifyOfWrite(OperationContext* opCtx) override;
+
+    unsigned long long getWriteEpoch() const override {
+        return _writeEpoch.load();
+    }
+
     void setNs(NamespaceString ns) override;
 
 private:
@@ -135,10 +152,19 @@ private:
     // Includes index filters.
     std::unique_ptr<QuerySettings> _querySettings;
 
+    // Statistics on the indexed fields, which the planner may estimate the cost of plans with.
+    std::unique_ptr<IndexStatisticsCache> _indexStatistics;
+
+    // Plan cache entries saved by an earlier process, restored as their query shapes are planned.
+    std::unique_ptr<PlanCacheSnapshot> _planCacheSnapshot;
+
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
     bool _hasTTLIndex = false;
+
+    // Changed as writes to the collection commit, to a value drawn from a process-wide counter.
+    AtomicWord<unsigned long long> _writeEpoch;
 };
 
 }  // namespace mongo
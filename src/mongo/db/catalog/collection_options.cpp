@@ -243,6 +243,16 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
             }
 
             pipeline = e.Obj().getOwned();
+        } else if (fieldName == "timeseries") {
+            if (e.type() != mongo::Object) {
+                return Status(ErrorCodes::TypeMismatch, "'timeseries' has to be a document.");
+            }
+
+            try {
+                timeseries = TimeseriesOptions::parse(IDLParserErrorContext("timeseries"), e.Obj());
+            } catch (const DBException& ex) {
+                return ex.toStatus();
+            }
         } else if (fieldName == "idIndex" && kind == parseForCommand) {
             if (e.type() != mongo::Object) {
                 return Status(ErrorCodes::TypeMismatch, "'idIndex' has to be an object.");
@@ -266,6 +276,11 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (timeseries && (capped || !viewOn.empty())) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "'timeseries' cannot be specified with 'capped' or 'viewOn'");
+    }
+
     return Status::OK();
 }
 
@@ -334,6 +349,10 @@ void CollectionOptions::appendBSON(BSONObjBuilder* builder) const {
     if (!idIndex.isEmpty()) {
         builder->append("idIndex", idIndex);
     }
+
+    if (timeseries) {
+        builder->append("timeseries", timeseries->toBSON());
+    }
 }
 
 bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
@@ -412,6 +431,11 @@ bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
         return false;
     }
 
+    if (static_cast<bool>(timeseries) != static_cast<bool>(other.timeseries) ||
+        (timeseries && timeseries->toBSON().woCompare(other.timeseries->toBSON()) != 0)) {
+        return false;
+    }
+
     return true;
 }
 }
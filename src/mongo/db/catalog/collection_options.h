@@ -35,6 +35,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
@@ -142,5 +143,9 @@ struct CollectionOptions {
     std::string viewOn;
     // The aggregation pipeline that defines this view.
     BSONObj pipeline;
+
+    // The options of a time-series collection, given when it is created and stored with the
+    // collection which holds its buckets.
+    boost::optional<TimeseriesOptions> timeseries;
 };
 }
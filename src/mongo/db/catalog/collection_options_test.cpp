@@ -380,4 +380,27 @@ TEST(CollectionOptions, NExtentsNumberLimits) {
     ASSERT_OK(options.parse(fromjson("{$nExtents: 9999999999999999999999999999999}")));
     ASSERT_EQ(options.initialNumExtents, LLONG_MAX);
 }
+
+TEST(CollectionOptions, Timeseries) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{timeseries: {timeField: 't', metaField: 'm'}}")));
+    ASSERT(options.timeseries);
+    ASSERT_EQ("t", options.timeseries->getTimeField());
+    ASSERT_EQ("m", *options.timeseries->getMetaField());
+    ASSERT_EQ(3600, options.timeseries->getBucketMaxSpanSeconds());
+    checkRoundTrip(options);
+
+    ASSERT_OK(options.parse(fromjson("{timeseries: {timeField: 't', bucketMaxSpanSeconds: 60}}")));
+    ASSERT_FALSE(options.timeseries->getMetaField());
+    ASSERT_EQ(60, options.timeseries->getBucketMaxSpanSeconds());
+    ASSERT_OK(options.validateForStorage());
+
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: 1}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {metaField: 'm'}}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {timeField: 't', other: 1}}")));
+    ASSERT_NOT_OK(
+        options.parse(fromjson("{timeseries: {timeField: 't', bucketMaxSpanSeconds: 0}}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {timeField: 't'}, capped: true, size: 1}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {timeField: 't'}, viewOn: 'c'}")));
+}
 }  // namespace mongo
@@ -125,6 +125,33 @@ Status _createCollection(OperationContext* opCtx,
     });
 }
 
+/**
+ * Creates the time-series collection 'nss' as a view which unpacks the measurements stored in the
+ * buckets of a collection named by NamespaceString::makeTimeseriesBucketsNamespace().
+ */
+Status _createTimeseries(OperationContext* opCtx,
+                         const NamespaceString& nss,
+                         const CollectionOptions& collectionOptions) {
+    if (!collectionOptions.validator.isEmpty()) {
+        return {ErrorCodes::InvalidOptions,
+                "'validator' is not supported for time-series collections"};
+    }
+
+    const auto bucketsNs = nss.makeTimeseriesBucketsNamespace();
+
+    CollectionOptions viewOptions;
+    viewOptions.viewOn = bucketsNs.coll().toString();
+    viewOptions.collation = collectionOptions.collation;
+    viewOptions.pipeline =
+        BSON_ARRAY(BSON("$_internalUnpackBucket" << collectionOptions.timeseries->toBSON()));
+    Status status = _createView(opCtx, nss, viewOptions, BSONObj());
+    if (!status.isOK()) {
+        return status;
+    }
+
+    return _createCollection(opCtx, bucketsNs, collectionOptions, BSONObj());
+}
+
 /**
  * Shared part of the implementation of the createCollection versions for replicated and regular
  * collection creation.
@@ -171,8 +198,17 @@ Status createCollection(OperationContext* opCtx,
         }
     }
 
+    if (nss.isTimeseriesBucketsCollection() && !collectionOptions.timeseries) {
+        return {ErrorCodes::InvalidOptions,
+                str::stream() << "A collection named " << nss
+                              << " stores the buckets of a time-series collection and requires "
+                                 "'timeseries' options"};
+    }
+
     if (collectionOptions.isView()) {
         return _createView(opCtx, nss, collectionOptions, idIndex);
+    } else if (collectionOptions.timeseries && !nss.isTimeseriesBucketsCollection()) {
+        return _createTimeseries(opCtx, nss, collectionOptions);
     } else {
         return _createCollection(opCtx, nss, collectionOptions, idIndex);
     }
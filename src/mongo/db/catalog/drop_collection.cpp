@@ -168,7 +168,24 @@ Status dropCollection(OperationContext* opCtx,
 
         Collection* coll = db->getCollection(opCtx, collectionName);
         if (!coll) {
-            return _dropView(opCtx, db, collectionName, result);
+            // Dropping a time-series collection drops both its view and the collection which
+            // stores its buckets.
+            const auto bucketsNs = collectionName.makeTimeseriesBucketsNamespace();
+            auto view = ViewCatalog::get(db)->lookup(opCtx, collectionName.ns());
+            const bool isTimeseries = view && view->viewOn() == bucketsNs;
+
+            Status status = _dropView(opCtx, db, collectionName, result);
+            if (!status.isOK() || !isTimeseries || !db->getCollection(opCtx, bucketsNs)) {
+                return status;
+            }
+
+            BSONObjBuilder bucketsResult;
+            return _dropCollection(opCtx,
+                                   db,
+                                   bucketsNs,
+                                   dropOpTime,
+                                   DropCollectionSystemCollectionMode::kAllowSystemCollectionDrops,
+                                   bucketsResult);
         } else {
             return _dropCollection(
                 opCtx, db, collectionName, dropOpTime, systemCollectionMode, result);
@@ -44,6 +44,7 @@
 namespace mongo {
 class Client;
 class Collection;
+class FieldRefSetWithStorage;
 
 class IndexDescriptor;
 struct InsertDeleteOptions;
@@ -450,12 +451,16 @@ public:
      * Both 'keysInsertedOut' and 'keysDeletedOut' are required and will be set to the number of
      * index keys inserted and deleted by this operation, respectively.
      *
+     * When 'modifiedPaths' is not null, it holds every path whose value may differ between
+     * 'oldDoc' and 'newDoc'. Indexes whose keys cannot depend on any of those paths are skipped.
+     *
      * This method may throw.
      */
     virtual Status updateRecord(OperationContext* const opCtx,
                                 const BSONObj& oldDoc,
                                 const BSONObj& newDoc,
                                 const RecordId& recordId,
+                                const FieldRefSetWithStorage* modifiedPaths,
                                 int64_t* const keysInsertedOut,
                                 int64_t* const keysDeletedOut) = 0;
 
@@ -52,6 +52,7 @@ class IndexBuildInterceptor;
 class IndexDescriptor;
 class MatchExpression;
 class OperationContext;
+class UpdateIndexData;
 
 class IndexCatalogEntry {
 public:
@@ -85,6 +86,12 @@ public:
 
     virtual const MatchExpression* getFilterExpression() const = 0;
 
+    /**
+     * Returns the paths that the keys of this index, and its filter, are computed from. Returns
+     * null when the keys may depend on paths which are not known up front.
+     */
+    virtual const UpdateIndexData* getIndexedPaths() const = 0;
+
     virtual const CollatorInterface* getCollator() const = 0;
 
     /// ---------------------
@@ -43,11 +43,13 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
+#include "mongo/db/query/planner_ixselect.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/util/log.h"
@@ -108,6 +110,24 @@ IndexCatalogEntryImpl::IndexCatalogEntryImpl(OperationContext* const opCtx,
         LOG(2) << "have filter expression for " << _ns << " " << _descriptor->indexName() << " "
                << redact(filter);
     }
+
+    // The keys of these index types are generated from the values of their key pattern fields
+    // alone. Text and wildcard indexes may index fields which their key pattern does not name.
+    const IndexType type = IndexNames::nameToType(_descriptor->getAccessMethodName());
+    if (type == INDEX_BTREE || type == INDEX_HASHED || type == INDEX_2D ||
+        type == INDEX_2DSPHERE) {
+        _indexedPaths.emplace();
+        for (auto&& elem : _descriptor->keyPattern()) {
+            _indexedPaths->addPath(FieldRef(elem.fieldNameStringData()));
+        }
+        if (_filterExpression) {
+            stdx::unordered_set<std::string> paths;
+            QueryPlannerIXSelect::getFields(_filterExpression.get(), &paths);
+            for (auto&& path : paths) {
+                _indexedPaths->addPath(FieldRef(path));
+            }
+        }
+    }
 }
 
 IndexCatalogEntryImpl::~IndexCatalogEntryImpl() {
@@ -40,6 +40,7 @@
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
+#include "mongo/db/update_index_data.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 
@@ -113,6 +114,10 @@ public:
         return _filterExpression.get();
     }
 
+    const UpdateIndexData* getIndexedPaths() const final {
+        return _indexedPaths.get_ptr();
+    }
+
     const CollatorInterface* getCollator() const final {
         return _collator.get();
     }
@@ -213,6 +218,9 @@ private:
     std::unique_ptr<CollatorInterface> _collator;
     std::unique_ptr<MatchExpression> _filterExpression;
 
+    // The paths the keys of the index and its filter depend on, when they can be listed.
+    boost::optional<UpdateIndexData> _indexedPaths;
+
     // cached stuff
 
     Ordering _ordering;  // TODO: this might be b-tree specific
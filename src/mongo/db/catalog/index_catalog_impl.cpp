@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/index_catalog_impl.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -49,6 +50,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_legacy.h"
@@ -62,12 +64,14 @@
 #include "mongo/db/query/collation/collation_spec.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/kv/kv_catalog.h"
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 #include "mongo/db/storage/storage_engine_init.h"
+#include "mongo/db/update_index_data.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/represent_as.h"
@@ -1298,6 +1302,13 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
+    if (bsonRecords.size() > 1 && internalInsertSortIndexKeysAcrossBatch.load()) {
+        if (auto status =
+                _indexFilteredRecordsSorted(opCtx, index, bsonRecords, options, keysInsertedOut)) {
+            return *status;
+        }
+    }
+
     for (auto bsonRecord : bsonRecords) {
         invariant(bsonRecord.id != RecordId());
 
@@ -1331,6 +1342,98 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     return Status::OK();
 }
 
+boost::optional<Status> IndexCatalogImpl::_indexFilteredRecordsSorted(
+    OperationContext* opCtx,
+    IndexCatalogEntry* index,
+    const std::vector<BsonRecord>& bsonRecords,
+    const InsertDeleteOptions& options,
+    int64_t* keysInsertedOut) {
+    // Side writes of a hybrid build are applied in the order they were made, and records with
+    // different timestamps must each write their keys at their own timestamp.
+    if (index->isHybridBuilding()) {
+        return boost::none;
+    }
+    const Timestamp ts = bsonRecords.front().ts;
+    for (auto&& bsonRecord : bsonRecords) {
+        if (bsonRecord.ts != ts) {
+            return boost::none;
+        }
+    }
+
+    IndexAccessMethod* iam = index->accessMethod();
+    std::vector<std::pair<BSONObj, RecordId>> keyedRecords;
+    bool multikey = false;
+    MultikeyPaths multikeyPaths;
+    for (auto&& bsonRecord : bsonRecords) {
+        invariant(bsonRecord.id != RecordId());
+
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths recordMultikeyPaths;
+        iam->getKeys(*bsonRecord.docPtr,
+                     options.getKeysMode,
+                     &keys,
+                     &multikeyMetadataKeys,
+                     &recordMultikeyPaths);
+
+        // Multikey metadata keys, which only wildcard indexes generate, are left to the
+        // record-at-a-time path.
+        if (!multikeyMetadataKeys.empty()) {
+            return boost::none;
+        }
+
+        std::vector<BSONObj> keyVector(keys.begin(), keys.end());
+        if (iam->shouldMarkIndexAsMultikey(keyVector, {}, recordMultikeyPaths)) {
+            if (!multikey) {
+                multikeyPaths = recordMultikeyPaths;
+            } else {
+                invariant(multikeyPaths.size() == recordMultikeyPaths.size());
+                for (size_t i = 0; i < multikeyPaths.size(); ++i) {
+                    multikeyPaths[i].insert(recordMultikeyPaths[i].begin(),
+                                            recordMultikeyPaths[i].end());
+                }
+            }
+            multikey = true;
+        }
+
+        for (auto&& key : keyVector) {
+            keyedRecords.emplace_back(key, bsonRecord.id);
+        }
+    }
+
+    const Ordering ordering = Ordering::make(index->descriptor()->keyPattern());
+    std::sort(keyedRecords.begin(),
+              keyedRecords.end(),
+              [&ordering](const auto& lhs, const auto& rhs) {
+                  const int cmp = lhs.first.woCompare(rhs.first, ordering, false);
+                  return cmp < 0 || (cmp == 0 && lhs.second < rhs.second);
+              });
+
+    if (!ts.isNull()) {
+        Status status = opCtx->recoveryUnit()->setTimestamp(ts);
+        if (!status.isOK())
+            return status;
+    }
+
+    InsertResult result;
+    for (auto&& keyedRecord : keyedRecords) {
+        // Each key is inserted on its own, so none of them marks the index multikey; that is
+        // done once for the whole batch below.
+        Status status = iam->insertKeys(
+            opCtx, {keyedRecord.first}, {}, {}, keyedRecord.second, options, &result);
+        if (!status.isOK())
+            return status;
+    }
+    if (keysInsertedOut) {
+        *keysInsertedOut += result.numInserted;
+    }
+
+    if (multikey) {
+        index->setMultikey(opCtx, multikeyPaths);
+    }
+    return Status::OK();
+}
+
 Status IndexCatalogImpl::_indexRecords(OperationContext* opCtx,
                                        IndexCatalogEntry* index,
                                        const std::vector<BsonRecord>& bsonRecords,
@@ -1353,8 +1456,19 @@ Status IndexCatalogImpl::_updateRecord(OperationContext* const opCtx,
                                        const BSONObj& oldDoc,
                                        const BSONObj& newDoc,
                                        const RecordId& recordId,
+                                       const FieldRefSetWithStorage* modifiedPaths,
                                        int64_t* const keysInsertedOut,
                                        int64_t* const keysDeletedOut) {
+    // The keys of the index, and whether the document passes its filter, cannot change unless the
+    // update modified one of the paths the index depends on.
+    const UpdateIndexData* indexedPaths = index->getIndexedPaths();
+    if (modifiedPaths && indexedPaths &&
+        std::none_of(modifiedPaths->begin(), modifiedPaths->end(), [&](const FieldRef* path) {
+            return indexedPaths->mightBeIndexed(*path);
+        })) {
+        return Status::OK();
+    }
+
     IndexAccessMethod* iam = index->accessMethod();
 
     InsertDeleteOptions options;
@@ -1498,6 +1612,7 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
                                       const BSONObj& oldDoc,
                                       const BSONObj& newDoc,
                                       const RecordId& recordId,
+                                      const FieldRefSetWithStorage* modifiedPaths,
                                       int64_t* const keysInsertedOut,
                                       int64_t* const keysDeletedOut) {
     *keysInsertedOut = 0;
@@ -1508,8 +1623,14 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
          it != _readyIndexes.end();
          ++it) {
         IndexCatalogEntry* entry = it->get();
-        auto status =
-            _updateRecord(opCtx, entry, oldDoc, newDoc, recordId, keysInsertedOut, keysDeletedOut);
+        auto status = _updateRecord(opCtx,
+                                    entry,
+                                    oldDoc,
+                                    newDoc,
+                                    recordId,
+                                    modifiedPaths,
+                                    keysInsertedOut,
+                                    keysDeletedOut);
         if (!status.isOK())
             return status;
     }
@@ -1519,8 +1640,14 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
          it != _buildingIndexes.end();
          ++it) {
         IndexCatalogEntry* entry = it->get();
-        auto status =
-            _updateRecord(opCtx, entry, oldDoc, newDoc, recordId, keysInsertedOut, keysDeletedOut);
+        auto status = _updateRecord(opCtx,
+                                    entry,
+                                    oldDoc,
+                                    newDoc,
+                                    recordId,
+                                    modifiedPaths,
+                                    keysInsertedOut,
+                                    keysDeletedOut);
         if (!status.isOK())
             return status;
     }
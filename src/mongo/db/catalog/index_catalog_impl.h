@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <vector>
 
 #include "mongo/db/catalog/index_catalog.h"
@@ -321,6 +322,7 @@ public:
                         const BSONObj& oldDoc,
                         const BSONObj& newDoc,
                         const RecordId& recordId,
+                        const FieldRefSetWithStorage* modifiedPaths,
                         int64_t* const keysInsertedOut,
                         int64_t* const keysDeletedOut) override;
     /**
@@ -388,6 +390,17 @@ private:
                                  const std::vector<BsonRecord>& bsonRecords,
                                  int64_t* keysInsertedOut);
 
+    /**
+     * Indexes 'bsonRecords', which all share one timestamp, by generating the keys of every record
+     * first and inserting them into 'index' sorted across the whole batch. Returns boost::none
+     * without inserting anything when the batch has to be indexed one record at a time instead.
+     */
+    boost::optional<Status> _indexFilteredRecordsSorted(OperationContext* opCtx,
+                                                        IndexCatalogEntry* index,
+                                                        const std::vector<BsonRecord>& bsonRecords,
+                                                        const InsertDeleteOptions& options,
+                                                        int64_t* keysInsertedOut);
+
     Status _indexRecords(OperationContext* opCtx,
                          IndexCatalogEntry* index,
                          const std::vector<BsonRecord>& bsonRecords,
@@ -398,6 +411,7 @@ private:
                          const BSONObj& oldDoc,
                          const BSONObj& newDoc,
                          const RecordId& recordId,
+                         const FieldRefSetWithStorage* modifiedPaths,
                          int64_t* const keysInsertedOut,
                          int64_t* const keysDeletedOut);
 
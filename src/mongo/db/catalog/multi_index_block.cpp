@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/multi_index_block.h"
 
+#include <algorithm>
 #include <ostream>
 
 #include "mongo/base/error_codes.h"
@@ -43,6 +44,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/multikey_paths.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/operation_context.h"
@@ -51,7 +53,10 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/logger/redaction.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/log.h"
 #include "mongo/util/progress_meter.h"
@@ -69,6 +74,172 @@ MONGO_FAIL_POINT_DEFINE(hangAfterIndexBuildOf);
 MONGO_FAIL_POINT_DEFINE(hangAndThenFailIndexBuild);
 MONGO_FAIL_POINT_DEFINE(leaveIndexBuildUnfinishedForShutdown);
 
+namespace {
+
+/**
+ * Generates and sorts the keys of a bulk index build on a pool of threads while the collection is
+ * scanned. The scanning thread adds the documents it reads, and each full batch of them is split
+ * into one contiguous part per thread. Every thread inserts its part into per-index bulk builders
+ * of its own, so it sorts its keys into runs of its own, and the bulk builders of the indexes merge
+ * those runs when the build commits.
+ */
+class ParallelKeyGenerator {
+public:
+    struct Index {
+        const MatchExpression* filterExpression;
+        const InsertDeleteOptions* options;
+        IndexAccessMethod::BulkBuilder* bulk;
+    };
+
+    ParallelKeyGenerator(const std::vector<Index>& indexes,
+                         size_t numThreads,
+                         size_t maxMemoryUsageBytesPerIndex)
+        : _indexes(indexes), _workers(numThreads) {
+        for (auto&& worker : _workers) {
+            for (auto&& index : _indexes) {
+                worker.push_back(index.bulk->makeWorker(maxMemoryUsageBytesPerIndex / numThreads));
+            }
+        }
+
+        ThreadPool::Options options;
+        options.poolName = "IndexBuildKeyGeneration";
+        options.threadNamePrefix = "indexBuildKeyGen-";
+        options.minThreads = 0;
+        options.maxThreads = numThreads;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+        _pool = std::make_unique<ThreadPool>(options);
+        _pool->startup();
+    }
+
+    ~ParallelKeyGenerator() {
+        _pool->shutdown();
+        _pool->join();
+    }
+
+    /**
+     * Adds a copy of 'doc' to the current batch, and inserts the batch once it is full.
+     */
+    Status add(const BSONObj& doc, const RecordId& loc) {
+        _batchBytes += doc.objsize();
+        _batch.emplace_back(doc.getOwned(), loc);
+        if (_batch.size() < kMaxBatchDocumentsPerThread * _workers.size() &&
+            _batchBytes < kMaxBatchBytes) {
+            return Status::OK();
+        }
+        return flush();
+    }
+
+    /**
+     * Inserts the documents of the current batch and waits for all threads to finish inserting
+     * them. Returns the first error any thread ran into.
+     */
+    Status flush() {
+        if (_batch.empty()) {
+            return Status::OK();
+        }
+
+        const size_t docsPerThread = (_batch.size() + _workers.size() - 1) / _workers.size();
+        std::vector<Status> statuses(_workers.size(), Status::OK());
+        size_t outstanding = 0;
+        for (size_t thread = 0; thread < _workers.size(); ++thread) {
+            const size_t begin = thread * docsPerThread;
+            const size_t end = std::min(_batch.size(), begin + docsPerThread);
+            if (begin >= end) {
+                break;
+            }
+
+            ++outstanding;
+            _pool->schedule([this, thread, begin, end, &statuses, &outstanding](Status status) {
+                if (status.isOK()) {
+                    status = _insert(_workers[thread], begin, end);
+                }
+
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                statuses[thread] = status;
+                if (--outstanding == 0) {
+                    _batchDone.notify_all();
+                }
+            });
+        }
+
+        // The wait is not interruptible, since the threads refer to the batch. A batch is short.
+        {
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            _batchDone.wait(lk, [&] { return outstanding == 0; });
+        }
+
+        _batch.clear();
+        _batchBytes = 0;
+        for (auto&& status : statuses) {
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+        return Status::OK();
+    }
+
+private:
+    static constexpr size_t kMaxBatchDocumentsPerThread = 256;
+    static constexpr size_t kMaxBatchBytes = 16 * 1024 * 1024;
+
+    Status _insert(const std::vector<IndexAccessMethod::BulkBuilder*>& bulks,
+                   size_t begin,
+                   size_t end) {
+        for (size_t doc = begin; doc < end; ++doc) {
+            const BSONObj& obj = _batch[doc].first;
+            for (size_t i = 0; i < _indexes.size(); ++i) {
+                const MatchExpression* filter = _indexes[i].filterExpression;
+                if (filter && !filter->matchesBSON(obj)) {
+                    continue;
+                }
+
+                Status status =
+                    bulks[i]->insert(nullptr, obj, _batch[doc].second, *_indexes[i].options);
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+        }
+        return Status::OK();
+    }
+
+    const std::vector<Index> _indexes;
+
+    // _workers[thread][i] is the bulk builder into which 'thread' inserts the keys of index i.
+    std::vector<std::vector<IndexAccessMethod::BulkBuilder*>> _workers;
+
+    std::unique_ptr<ThreadPool> _pool;
+
+    std::vector<std::pair<BSONObj, RecordId>> _batch;
+    size_t _batchBytes = 0;
+
+    stdx::mutex _mutex;  // Guards the count of threads still inserting the current batch.
+    stdx::condition_variable _batchDone;
+};
+
+/**
+ * Returns true if the keys of 'entry' can be generated on several threads at once. Only b-tree and
+ * hashed indexes without a collation qualify, since those generate keys from the document alone.
+ */
+bool canGenerateKeysInParallel(const IndexCatalogEntry* entry) {
+    const IndexType type = IndexNames::nameToType(entry->descriptor()->getAccessMethodName());
+    return (type == INDEX_BTREE || type == INDEX_HASHED) && !entry->getCollator();
+}
+
+/**
+ * Returns true if the keys of 'entry' depend only on the fields named in its key pattern. Text and
+ * wildcard indexes are excluded, since their keys can come from any field of the document.
+ */
+bool generatesKeysFromKeyPatternFields(const IndexCatalogEntry* entry) {
+    const IndexType type = IndexNames::nameToType(entry->descriptor()->getAccessMethodName());
+    return type == INDEX_BTREE || type == INDEX_HASHED || type == INDEX_2D ||
+        type == INDEX_2DSPHERE;
+}
+
+}  // namespace
+
 MultiIndexBlock::~MultiIndexBlock() {
     invariant(_buildIsCleanedUp);
 }
@@ -331,6 +502,19 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(OperationContext* opCtx,
         _indexes.push_back(std::move(index));
     }
 
+    // Several indexes generating their keys from the same document each walk it for every field
+    // they index, so walk it just once for all of them when their keys only depend on those fields.
+    if (indexBuildExtractIndexedFieldsOnce.load() && _indexes.size() > 1 &&
+        std::all_of(_indexes.begin(), _indexes.end(), [](const IndexToBuild& index) {
+            return generatesKeysFromKeyPatternFields(index.block->getEntry());
+        })) {
+        for (auto&& index : _indexes) {
+            for (auto&& elem : index.block->getEntry()->descriptor()->keyPattern()) {
+                _indexedFieldNames.insert(str::before(elem.fieldNameStringData(), '.').toString());
+            }
+        }
+    }
+
     if (isBackgroundBuilding())
         _backgroundOperation.reset(new BackgroundOperation(ns));
 
@@ -420,6 +604,26 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
         _method != IndexBuildMethod::kBackground && useReadOnceCursorsForIndexBuilds.load();
     opCtx->recoveryUnit()->setReadOnce(readOnce);
 
+    // Until the scan is done, bulk builds only sort the keys of the documents, so the keys can be
+    // generated and sorted on other threads while this one scans.
+    std::unique_ptr<ParallelKeyGenerator> keyGenerator;
+    const int numKeyGenerationThreads = indexBuildKeyGenerationThreads.load();
+    if (numKeyGenerationThreads > 1 && !_indexes.empty() &&
+        std::all_of(_indexes.begin(), _indexes.end(), [](const IndexToBuild& index) {
+            return index.bulk && canGenerateKeysInParallel(index.block->getEntry());
+        })) {
+        std::vector<ParallelKeyGenerator::Index> indexes;
+        for (auto&& index : _indexes) {
+            indexes.push_back({index.filterExpression, &index.options, index.bulk.get()});
+        }
+        const size_t maxMemoryUsageBytesPerIndex =
+            static_cast<std::size_t>(maxIndexBuildMemoryUsageMegabytes.load()) * 1024 * 1024 /
+            _indexes.size();
+        keyGenerator = std::make_unique<ParallelKeyGenerator>(
+            indexes, numKeyGenerationThreads, maxMemoryUsageBytesPerIndex);
+        log() << "index build: generating keys on " << numKeyGenerationThreads << " threads";
+    }
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -449,20 +653,32 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
 
             failPointHangDuringBuild(&hangBeforeIndexBuildOf, "before", objToIndex.value());
 
-            WriteUnitOfWork wunit(opCtx);
-            Status ret = insert(opCtx, objToIndex.value(), loc);
-            if (_method == IndexBuildMethod::kBackground)
-                exec->saveState();
-            if (!ret.isOK()) {
-                // Fail the index build hard.
-                return ret;
-            }
-            wunit.commit();
-            if (_method == IndexBuildMethod::kBackground) {
-                try {
-                    exec->restoreState();  // Handles any WCEs internally.
-                } catch (...) {
-                    return exceptionToStatus();
+            if (keyGenerator) {
+                if (State::kAborted == _getState()) {
+                    return {ErrorCodes::IndexBuildAborted,
+                            str::stream() << "Index build aborted: " << _abortReason};
+                }
+                Status ret = keyGenerator->add(objToIndex.value(), loc);
+                if (!ret.isOK()) {
+                    // Fail the index build hard.
+                    return ret;
+                }
+            } else {
+                WriteUnitOfWork wunit(opCtx);
+                Status ret = insert(opCtx, objToIndex.value(), loc);
+                if (_method == IndexBuildMethod::kBackground)
+                    exec->saveState();
+                if (!ret.isOK()) {
+                    // Fail the index build hard.
+                    return ret;
+                }
+                wunit.commit();
+                if (_method == IndexBuildMethod::kBackground) {
+                    try {
+                        exec->restoreState();  // Handles any WCEs internally.
+                    } catch (...) {
+                        return exceptionToStatus();
+                    }
                 }
             }
 
@@ -497,6 +713,14 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
         return exec->getMemberObjectStatus(objToIndex.value());
     }
 
+    if (keyGenerator) {
+        Status ret = keyGenerator->flush();
+        if (!ret.isOK()) {
+            return ret;
+        }
+        keyGenerator.reset();
+    }
+
     if (MONGO_FAIL_POINT(leaveIndexBuildUnfinishedForShutdown)) {
         log() << "Index build interrupted due to 'leaveIndexBuildUnfinishedForShutdown' failpoint. "
                  "Mimicing shutdown error code.";
@@ -543,6 +767,8 @@ Status MultiIndexBlock::insert(OperationContext* opCtx, const BSONObj& doc, cons
                 str::stream() << "Index build aborted: " << _abortReason};
     }
 
+    // Partial filters still see the whole document, since they may refer to any of its fields.
+    const BSONObj indexedFields = _indexedFieldNames.empty() ? doc : _extractIndexedFields(doc);
     for (size_t i = 0; i < _indexes.size(); i++) {
         if (_indexes[i].filterExpression && !_indexes[i].filterExpression->matchesBSON(doc)) {
             continue;
@@ -551,9 +777,10 @@ Status MultiIndexBlock::insert(OperationContext* opCtx, const BSONObj& doc, cons
         InsertResult result;
         Status idxStatus(ErrorCodes::InternalError, "");
         if (_indexes[i].bulk) {
-            idxStatus = _indexes[i].bulk->insert(opCtx, doc, loc, _indexes[i].options);
+            idxStatus = _indexes[i].bulk->insert(opCtx, indexedFields, loc, _indexes[i].options);
         } else {
-            idxStatus = _indexes[i].real->insert(opCtx, doc, loc, _indexes[i].options, &result);
+            idxStatus =
+                _indexes[i].real->insert(opCtx, indexedFields, loc, _indexes[i].options, &result);
         }
 
         if (!idxStatus.isOK())
@@ -562,6 +789,16 @@ Status MultiIndexBlock::insert(OperationContext* opCtx, const BSONObj& doc, cons
     return Status::OK();
 }
 
+BSONObj MultiIndexBlock::_extractIndexedFields(const BSONObj& wholeDocument) const {
+    BSONObjBuilder builder;
+    for (auto&& elem : wholeDocument) {
+        if (_indexedFieldNames.find(elem.fieldNameStringData()) != _indexedFieldNames.end()) {
+            builder.append(elem);
+        }
+    }
+    return builder.obj();
+}
+
 Status MultiIndexBlock::dumpInsertsFromBulk(OperationContext* opCtx) {
     return dumpInsertsFromBulk(opCtx, nullptr);
 }
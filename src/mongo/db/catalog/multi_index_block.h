@@ -47,6 +47,7 @@
 #include "mongo/db/record_id.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/fail_point_service.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -307,6 +308,12 @@ private:
     Status _dumpInsertsFromBulk(std::set<RecordId>* dupRecords,
                                 std::vector<BSONObj>* dupKeysInserted);
 
+    /**
+     * Returns a document holding only the top-level fields of 'wholeDocument' which are named in
+     * '_indexedFieldNames', in their original order.
+     */
+    BSONObj _extractIndexedFields(const BSONObj& wholeDocument) const;
+
     /**
      * Returns the current state.
      */
@@ -327,6 +334,11 @@ private:
 
     std::vector<IndexToBuild> _indexes;
 
+    // When non-empty, the top-level fields which the keys of every index are generated from. Each
+    // document is then walked once to extract these, and the keys of all the indexes are generated
+    // from the extracted fields instead of each walking the whole document.
+    StringSet _indexedFieldNames;
+
     std::unique_ptr<BackgroundOperation> _backgroundOperation;
 
     IndexBuildMethod _method = IndexBuildMethod::kHybrid;
@@ -63,6 +63,15 @@ public:
           _indexCatalog(ic),
           _indexNsResultsMap(irm) {}
 
+    /**
+     * Returns an adaptor which keeps track of the same index consistency, but reads through
+     * 'opCtx'. This lets another thread traverse an index on behalf of the same validation.
+     */
+    RecordStoreValidateAdaptor withOperationContext(OperationContext* opCtx) const {
+        return RecordStoreValidateAdaptor(
+            opCtx, _indexConsistency, _level, _indexCatalog, _indexNsResultsMap);
+    }
+
     /**
      * Validates the BSON object and traverses through its key set to keep track of the
      * index consistency.
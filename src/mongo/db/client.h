@@ -44,7 +44,7 @@
 #include "mongo/platform/random.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/transport/session.h"
-#include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/concurrency/adaptive_mutex.h"
 #include "mongo/util/decorable.h"
 #include "mongo/util/invariant.h"
 #include "mongo/util/net/hostandport.h"
@@ -241,7 +241,7 @@ private:
     const ConnectionId _connectionId;
 
     // Protects the contents of the Client (such as changing the OperationContext, etc)
-    SpinLock _lock;
+    AdaptiveMutex _lock{"Client"};
 
     // Whether this client is running as DBDirectClient
     bool _inDirectClient = false;
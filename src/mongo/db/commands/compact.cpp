@@ -79,10 +79,13 @@ public:
         return "compact collection\n"
                "warning: this operation locks the database and is slow. you can cancel with "
                "killOp()\n"
-               "{ compact : <collection_name>, [force:<bool>], [validate:<bool>] }\n"
+               "{ compact : <collection_name>, [force:<bool>], [validate:<bool>], "
+               "[indexesOnly:<bool>] }\n"
                "  force - allows to run on a replica set primary\n"
                "  validate - check records are noncorrupt before adding to newly compacting "
-               "extents. slower but safer (defaults to true in this version)\n";
+               "extents. slower but safer (defaults to true in this version)\n"
+               "  indexesOnly - compact only the indexes, without blocking reads and writes. "
+               "allowed on a replica set primary\n";
     }
     CompactCmd() : ErrmsgCommandDeprecated("compact") {}
 
@@ -93,8 +96,17 @@ public:
                            BSONObjBuilder& result) {
         NamespaceString nss = CommandHelpers::parseNsCollectionRequired(db, cmdObj);
 
+        CompactOptions compactOptions;
+
+        if (cmdObj.hasElement("validate"))
+            compactOptions.validateDocuments = cmdObj["validate"].trueValue();
+
+        if (cmdObj.hasElement("indexesOnly"))
+            compactOptions.indexesOnly = cmdObj["indexesOnly"].trueValue();
+
         repl::ReplicationCoordinator* replCoord = repl::ReplicationCoordinator::get(opCtx);
-        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue()) {
+        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue() &&
+            !compactOptions.indexesOnly) {
             errmsg =
                 "will not run compact on an active replica set primary as this is a slow blocking "
                 "operation. use force:true to force";
@@ -112,12 +124,14 @@ public:
             return false;
         }
 
-        CompactOptions compactOptions;
-
-        if (cmdObj.hasElement("validate"))
-            compactOptions.validateDocuments = cmdObj["validate"].trueValue();
-
-        AutoGetDb autoDb(opCtx, db, MODE_X);
+        // Compacting only the indexes leaves the documents in place, so it takes intent locks and
+        // lets the collection be read and written meanwhile. The lock on the collection still
+        // keeps its indexes from being created or dropped.
+        AutoGetDb autoDb(opCtx, db, compactOptions.indexesOnly ? MODE_IX : MODE_X);
+        boost::optional<Lock::CollectionLock> collLock;
+        if (compactOptions.indexesOnly) {
+            collLock.emplace(opCtx, nss, MODE_IX);
+        }
         Database* const collDB = autoDb.getDb();
 
         Collection* collection = collDB ? collDB->getCollection(opCtx, nss) : nullptr;
@@ -254,6 +254,14 @@ public:
         }
 
         // Plan is done executing. We just need to pull the count out of the root stage.
+        if (STAGE_SAMPLED_COUNT == exec->getRootStage()->stageType()) {
+            auto* sampledCountStats =
+                static_cast<const SampledCountStats*>(exec->getRootStage()->getSpecificStats());
+            result.appendNumber("n", sampledCountStats->nCounted);
+            result.append("approximate", true);
+            return true;
+        }
+
         invariant(STAGE_COUNT == exec->getRootStage()->stageType() ||
                   STAGE_RECORD_STORE_FAST_COUNT == exec->getRootStage()->stageType());
         auto* countStats = static_cast<const CountStats*>(exec->getRootStage()->getSpecificStats());
@@ -31,17 +31,22 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog_helper.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/dbhash_gen.h"
 #include "mongo/db/commands/test_commands_enabled.h"
+#include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/logical_clock.h"
@@ -50,10 +55,13 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/transaction_participant.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -227,6 +235,13 @@ public:
         std::map<std::string, OptionalCollectionUUID> collectionToUUIDMap;
         std::set<std::string> cappedCollectionSet;
 
+        // While the database is locked in S-mode its collections cannot change, so they may be
+        // hashed by other threads once we have found them all. Otherwise each collection is only
+        // locked while we visit it, and we hash it there.
+        const size_t numThreads = static_cast<size_t>(dbHashCollectionThreads.load());
+        const bool hashInParallel = lockMode == LockMode::MODE_S && numThreads > 1;
+        std::vector<NamespaceString> collectionsToHash;
+
         bool noError = true;
         catalog::forEachCollectionFromDb(
             opCtx,
@@ -270,6 +285,11 @@ public:
                     collectionToUUIDMap[collNss.coll().toString()] = uuid;
                 }
 
+                if (hashInParallel) {
+                    collectionsToHash.push_back(collNss);
+                    return true;
+                }
+
                 // Compute the hash for this collection.
                 std::string hash = _hashCollection(opCtx, db, collNss);
 
@@ -280,6 +300,11 @@ public:
         if (!noError)
             return false;
 
+        if (hashInParallel) {
+            _hashCollectionsInParallel(
+                opCtx, db, collectionsToHash, numThreads, &collectionToHashMap);
+        }
+
         BSONObjBuilder bb(result.subobjStart("collections"));
         BSONArrayBuilder cappedCollections;
         BSONObjBuilder collectionsByUUID;
@@ -347,6 +372,127 @@ private:
             invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_S));
         }
 
+        return _computeHash(opCtx, collection, nss, nullptr);
+    }
+
+    /**
+     * Hashes the collections in 'namespaces' on up to 'numThreads' threads, each with an operation
+     * context of its own, and records their hashes in 'collectionToHashMap'. The caller must hold
+     * the database lock in S-mode throughout. A worker never waits for its locks, since a request
+     * which blocks it may be queued behind our own; the collections it could not lock are hashed
+     * on this thread afterwards.
+     */
+    void _hashCollectionsInParallel(OperationContext* opCtx,
+                                    Database* db,
+                                    const std::vector<NamespaceString>& namespaces,
+                                    size_t numThreads,
+                                    std::map<std::string, std::string>* collectionToHashMap) {
+        invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_S));
+        if (namespaces.empty()) {
+            return;
+        }
+
+        const auto prepareConflictBehavior =
+            opCtx->recoveryUnit()->getPrepareConflictBehavior();
+
+        ThreadPool::Options options;
+        options.poolName = "DBHash";
+        options.threadNamePrefix = "dbHash-";
+        options.minThreads = 0;
+        options.maxThreads = std::min(numThreads, namespaces.size());
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+        ThreadPool pool(options);
+        pool.startup();
+
+        stdx::mutex mutex;
+        stdx::condition_variable allDone;
+        size_t outstanding = namespaces.size();
+        AtomicWord<bool> cancelled{false};
+        std::vector<boost::optional<std::string>> hashes(namespaces.size());
+        std::vector<Status> statuses(namespaces.size(), Status::OK());
+
+        // The workers use the collections, which are only safe to use while we hold our lock, so
+        // they must have stopped before we return, even if we are interrupted.
+        ON_BLOCK_EXIT([&] {
+            cancelled.store(true);
+            pool.shutdown();
+            pool.join();
+        });
+
+        for (size_t i = 0; i < namespaces.size(); ++i) {
+            pool.schedule([&, i](Status status) {
+                if (!status.isOK()) {
+                    statuses[i] = status;
+                } else if (!cancelled.load()) {
+                    try {
+                        hashes[i] = _hashCollectionOnWorker(
+                            db, namespaces[i], prepareConflictBehavior, &cancelled);
+                    } catch (const DBException& ex) {
+                        statuses[i] = ex.toStatus();
+                    }
+                }
+
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                if (--outstanding == 0) {
+                    allDone.notify_all();
+                }
+            });
+        }
+
+        {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            opCtx->waitForConditionOrInterrupt(allDone, lk, [&] { return outstanding == 0; });
+        }
+
+        for (size_t i = 0; i < namespaces.size(); ++i) {
+            uassertStatusOK(statuses[i]);
+            (*collectionToHashMap)[namespaces[i].coll().toString()] =
+                hashes[i] ? *hashes[i] : _hashCollection(opCtx, db, namespaces[i]);
+        }
+    }
+
+    /**
+     * Hashes the collection 'nss' with an operation context of this worker thread's own. Returns
+     * boost::none if the collection could not be locked without waiting.
+     */
+    static boost::optional<std::string> _hashCollectionOnWorker(
+        Database* db,
+        const NamespaceString& nss,
+        PrepareConflictBehavior prepareConflictBehavior,
+        const AtomicWord<bool>* cancelled) {
+        auto opCtx = cc().makeOperationContext();
+        opCtx->lockState()->setMaxLockTimeout(Milliseconds(0));
+        opCtx->recoveryUnit()->setPrepareConflictBehavior(prepareConflictBehavior);
+
+        // The command's own lock already keeps oplog application away from this database.
+        ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(
+            opCtx->lockState());
+
+        try {
+            Lock::DBLock dbLock(opCtx.get(), db->name(), MODE_IS);
+            Lock::CollectionLock collLock(opCtx.get(), nss, MODE_IS);
+
+            Collection* collection = db->getCollection(opCtx.get(), nss);
+            invariant(collection);
+            return _computeHash(opCtx.get(), collection, nss, cancelled);
+        } catch (const ExceptionFor<ErrorCodes::LockTimeout>&) {
+            return boost::none;
+        }
+    }
+
+    /**
+     * Computes the hash of the documents of 'collection' in _id order. If 'cancelled' is given,
+     * fails with Interrupted once it has been set.
+     */
+    static std::string _computeHash(OperationContext* opCtx,
+                                    Collection* collection,
+                                    const NamespaceString& nss,
+                                    const AtomicWord<bool>* cancelled) {
+        // How many documents are hashed between checks of 'cancelled'.
+        const long long kCancelCheckInterval = 4096;
+
         auto desc = collection->getIndexCatalog()->findIdIndex(opCtx);
 
         std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
@@ -378,6 +524,9 @@ private:
         while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, nullptr))) {
             md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
             n++;
+            uassert(ErrorCodes::Interrupted,
+                    "dbHash was cancelled",
+                    !cancelled || n % kCancelCheckInterval || !cancelled->load());
         }
         if (PlanExecutor::IS_EOF != state) {
             warning() << "error while hashing, db dropped? ns=" << nss;
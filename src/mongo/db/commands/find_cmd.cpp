@@ -233,6 +233,7 @@ public:
             bool permitYield = true;
             auto exec =
                 uassertStatusOK(getExecutorFind(opCtx, collection, std::move(cq), permitYield));
+            setReadOnceIfScanningCollectionWithHotIndexes(opCtx, collection, exec.get());
 
             auto bodyBuilder = result->getBodyBuilder();
             // Got the execution tree. Explain it.
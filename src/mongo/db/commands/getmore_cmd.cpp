@@ -44,12 +44,14 @@
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/pipeline/document.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/read_concern.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/replication_coordinator.h"
@@ -275,12 +277,17 @@ public:
             // an interrupt point, we just continue as normal and return rather than reporting a
             // timeout to the user.
             BSONObj obj;
+            DocumentBufferPoolScope bufferPool(internalDocumentBufferPoolMaxBytes.load());
+            const int maxBytes = request.batchSize
+                ? FindCommon::kMaxBytesToReturnToClientAtOnce
+                : FindCommon::getMoreBatchBytesBudget(cursor->getNBatches());
             try {
                 while (!FindCommon::enoughForGetMore(request.batchSize.value_or(0), *numResults) &&
                        PlanExecutor::ADVANCED == (*state = exec->getNext(&obj, nullptr))) {
                     // If adding this object will cause us to exceed the message size limit, then we
                     // stash it for later.
-                    if (!FindCommon::haveSpaceForNext(obj, *numResults, nextBatch->bytesUsed())) {
+                    if (!FindCommon::haveSpaceForNext(
+                            obj, *numResults, nextBatch->bytesUsed(), maxBytes)) {
                         exec->enqueue(obj);
                         break;
                     }
@@ -510,6 +517,8 @@ public:
                 // execution to assume read data will not be needed again and need not be cached.
                 opCtx->recoveryUnit()->setReadOnce(true);
             }
+            setReadOnceIfScanningCollectionWithHotIndexes(
+                opCtx, readLock ? readLock->getCollection() : nullptr, exec);
             exec->reattachToOperationContext(opCtx);
             exec->restoreState();
 
@@ -56,9 +56,11 @@
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/ops/insert.h"
+#include "mongo/db/ops/write_ops.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_runtime.h"
@@ -417,7 +419,7 @@ Config::Config(const string& _dbname, const BSONObj& cmdObj) {
 
     jsMaxKeys = 500000;
     reduceTriggerRatio = 10.0;
-    maxInMemSize = 500 * 1024;
+    maxInMemSize = internalQueryMapReduceMaxInMemBytes.load();
 
     uassert(13602, "outType is no longer a valid option", cmdObj["outType"].eoo());
 
@@ -886,6 +888,40 @@ void State::_insertToInc(BSONObj& o) {
     });
 }
 
+void State::_insertBatchToInc(const std::vector<BSONObj>& docs) {
+    verify(_onDisk);
+    if (docs.empty())
+        return;
+
+    // Make sure we enforce prepare conflicts before writing.
+    EnforcePrepareConflictsBlock enforcePrepare(_opCtx);
+
+    std::vector<InsertStatement> inserts;
+    inserts.reserve(docs.size());
+    for (const auto& doc : docs) {
+        // See _insertToInc() for why the documents are not passed to fixDocumentForInsert().
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "object to insert too large for incremental collection"
+                              << ". size in bytes: "
+                              << doc.objsize()
+                              << ", max size: "
+                              << BSONObjMaxUserSize,
+                doc.objsize() <= BSONObjMaxUserSize);
+        inserts.emplace_back(doc);
+    }
+
+    writeConflictRetry(_opCtx, "M/R insertBatchToInc", _config.incLong.ns(), [&] {
+        AutoGetCollection autoColl(_opCtx, _config.incLong, MODE_IX);
+        assertCollectionNotNull(_config.incLong, autoColl);
+
+        WriteUnitOfWork wuow(_opCtx);
+        OpDebug* const nullOpDebug = nullptr;
+        uassertStatusOK(autoColl.getCollection()->insertDocuments(
+            _opCtx, inserts.begin(), inserts.end(), nullOpDebug, false));
+        wuow.commit();
+    });
+}
+
 State::State(OperationContext* opCtx, const Config& c)
     : _config(c),
       _db(opCtx),
@@ -1310,14 +1346,26 @@ void State::dumpToInc() {
     if (!_onDisk)
         return;
 
+    // Write the map in batches rather than taking the collection lock and committing a write unit
+    // of work for every document.
+    const size_t maxBatchSize = internalInsertMaxBatchSize.load();
+    const size_t maxBatchBytes = write_ops::insertVectorMaxBytes;
+    std::vector<BSONObj> batch;
+    size_t batchBytes = 0;
+
     for (InMemory::iterator i = _temp->begin(); i != _temp->end(); i++) {
         BSONList& all = i->second;
-        if (all.size() < 1)
-            continue;
-
-        for (BSONList::iterator j = all.begin(); j != all.end(); j++)
-            _insertToInc(*j);
+        for (BSONList::iterator j = all.begin(); j != all.end(); j++) {
+            batch.push_back(*j);
+            batchBytes += j->objsize();
+            if (batch.size() >= maxBatchSize || batchBytes >= maxBatchBytes) {
+                _insertBatchToInc(batch);
+                batch.clear();
+                batchBytes = 0;
+            }
+        }
     }
+    _insertBatchToInc(batch);
     _temp->clear();
     _size = 0;
 }
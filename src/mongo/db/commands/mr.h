@@ -302,6 +302,11 @@ public:
     void insertToInc(BSONObj& o);
     void _insertToInc(BSONObj& o);
 
+    /**
+     * Inserts 'docs' into the inc collection in a single write unit of work.
+     */
+    void _insertBatchToInc(const std::vector<BSONObj>& docs);
+
     // ------ reduce stage -----------
 
     void prepTempCollection();
@@ -42,11 +42,15 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands/plan_cache_commands.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/ops/write_ops.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/plan_cache_snapshot.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/util/hex.h"
 #include "mongo/util/log.h"
 
@@ -94,6 +98,7 @@ MONGO_INITIALIZER_WITH_PREREQUISITES(SetupPlanCacheCommands, MONGO_NO_PREREQUISI
     new PlanCacheListQueryShapes();
     new PlanCacheClear();
     new PlanCacheListPlans();
+    new PlanCacheTakeSnapshot();
 
     return Status::OK();
 }
@@ -453,4 +458,100 @@ Status PlanCacheListPlans::list(OperationContext* opCtx,
     return Status::OK();
 }
 
+PlanCacheTakeSnapshot::PlanCacheTakeSnapshot()
+    : PlanCacheCommand("planCacheSnapshot",
+                       "Saves the cached queries of a collection to be restored after a restart.",
+                       ActionType::planCacheWrite) {}
+
+Status PlanCacheTakeSnapshot::runPlanCacheCommand(OperationContext* opCtx,
+                                                  const std::string& ns,
+                                                  const BSONObj& cmdObj,
+                                                  BSONObjBuilder* bob) {
+    std::vector<BSONObj> docs;
+    {
+        // This is a read lock. The query cache is owned by the collection. It has to be released
+        // before writing to the snapshot collection.
+        AutoGetCollectionForReadCommand ctx(opCtx, NamespaceString(ns));
+
+        PlanCache* planCache;
+        Status status = getPlanCache(opCtx, ctx.getCollection(), ns, &planCache);
+        if (status.isOK()) {
+            docs = snapshot(opCtx, *planCache, ns);
+        }
+        // No collection - nothing to save, but the entries saved before are still replaced.
+    }
+
+    try {
+        DBDirectClient client(opCtx);
+        auto deleteResponse = client.runCommand([&] {
+            write_ops::Delete deleteOp(NamespaceString::kPlanCacheSnapshotNamespace);
+            deleteOp.setDeletes({[&] {
+                write_ops::DeleteOpEntry entry;
+                entry.setQ(BSON(PlanCacheSnapshot::kNsFieldName << ns));
+                entry.setMulti(true);
+                return entry;
+            }()});
+            return deleteOp.serialize({});
+        }());
+        uassertStatusOK(getStatusFromWriteCommandReply(deleteResponse->getCommandReply()));
+
+        // Insert in batches which stay well clear of the maximum size of a command.
+        auto it = docs.begin();
+        while (it != docs.end()) {
+            std::vector<BSONObj> batch;
+            int batchSize = 0;
+            for (; it != docs.end() && batchSize < BSONObjMaxUserSize / 2; ++it) {
+                batchSize += it->objsize();
+                batch.push_back(*it);
+            }
+            auto insertResponse = client.runCommand([&] {
+                write_ops::Insert insertOp(NamespaceString::kPlanCacheSnapshotNamespace);
+                insertOp.setDocuments(std::move(batch));
+                return insertOp.serialize({});
+            }());
+            uassertStatusOK(getStatusFromWriteCommandReply(insertResponse->getCommandReply()));
+        }
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+
+    LOG(1) << ns << ": saved " << docs.size() << " plan cache entries";
+
+    bob->append("saved", static_cast<long long>(docs.size()));
+    return Status::OK();
+}
+
+// static
+std::vector<BSONObj> PlanCacheTakeSnapshot::snapshot(OperationContext* opCtx,
+                                                     const PlanCache& planCache,
+                                                     const std::string& ns) {
+    std::vector<BSONObj> docs;
+    for (auto&& entry : planCache.getAllEntries()) {
+        // Inactive entries are not used for planning, so there is nothing to gain from them.
+        if (!entry->isActive) {
+            continue;
+        }
+
+        // The entry keeps the shape of the query which created it, from which we can recompute
+        // the key it is cached under.
+        BSONObjBuilder shapeBuilder;
+        shapeBuilder.append("query", entry->query);
+        shapeBuilder.append("sort", entry->sort);
+        shapeBuilder.append("projection", entry->projection);
+        if (!entry->collation.isEmpty()) {
+            shapeBuilder.append("collation", entry->collation);
+        }
+        auto statusWithCQ = PlanCacheCommand::canonicalize(opCtx, ns, shapeBuilder.obj());
+        if (!statusWithCQ.isOK()) {
+            LOG(1) << ns << ": not saving plan cache entry - " << redact(entry->query) << ": "
+                   << statusWithCQ.getStatus();
+            continue;
+        }
+
+        docs.push_back(PlanCacheSnapshot::serializeEntry(
+            ns, planCache.computeKey(*statusWithCQ.getValue()), *entry));
+    }
+    return docs;
+}
+
 }  // namespace mongo
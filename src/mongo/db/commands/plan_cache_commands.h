@@ -179,4 +179,27 @@ public:
                        BSONObjBuilder* bob);
 };
 
+/**
+ * planCacheSnapshot
+ *
+ * { planCacheSnapshot: <collection> }
+ *
+ */
+class PlanCacheTakeSnapshot : public PlanCacheCommand {
+public:
+    PlanCacheTakeSnapshot();
+    virtual Status runPlanCacheCommand(OperationContext* opCtx,
+                                       const std::string& ns,
+                                       const BSONObj& cmdObj,
+                                       BSONObjBuilder* bob);
+
+    /**
+     * Returns the documents saving the active entries of the collection's plan cache, as written
+     * to the snapshot collection.
+     */
+    static std::vector<BSONObj> snapshot(OperationContext* opCtx,
+                                         const PlanCache& planCache,
+                                         const std::string& ns);
+};
+
 }  // namespace mongo
@@ -0,0 +1,170 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/storage/backup_cursor_hooks.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/util/log.h"
+#include "mongo/util/md5.hpp"
+
+namespace mongo {
+namespace {
+
+// Leaves room in the reply for the fields other than the data.
+constexpr long long kMaxReadBackupFileLength = 8 * 1024 * 1024;
+
+/**
+ * Reads part of a file listed by the open backup cursor, so that the files of a consistent
+ * checkpoint can be copied from this node over the wire. The reply carries the md5 digest of the
+ * data, for the reader to check what it received.
+ *
+ * {
+ *     _readBackupFile: <file name, absolute or relative to the dbpath>,
+ *     offset: <byte offset in the file>,
+ *     length: <maximum number of bytes to return>,
+ * }
+ */
+class ReadBackupFileCommand final : public BasicCommand {
+public:
+    ReadBackupFileCommand() : BasicCommand("_readBackupFile") {}
+
+    std::string help() const override {
+        return "Internal command to read part of a file of the open backup cursor";
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::internal)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        std::string fileName;
+        uassertStatusOK(bsonExtractStringField(cmdObj, getName(), &fileName));
+        long long offset;
+        uassertStatusOK(bsonExtractIntegerField(cmdObj, "offset", &offset));
+        long long length;
+        uassertStatusOK(bsonExtractIntegerField(cmdObj, "length", &length));
+        uassert(ErrorCodes::BadValue, "'offset' must not be negative", offset >= 0);
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "'length' must be between 1 and " << kMaxReadBackupFileLength,
+                length > 0 && length <= kMaxReadBackupFileLength);
+
+        // The backup cursor keeps the files of its checkpoint from changing or being removed
+        // while they are read.
+        auto backupCursorHooks = BackupCursorHooks::get(opCtx->getServiceContext());
+        uassert(ErrorCodes::IllegalOperation,
+                "_readBackupFile requires an open backup cursor",
+                backupCursorHooks->enabled() && backupCursorHooks->isBackupCursorOpen());
+
+        const auto path = _resolvePath(fileName);
+        const long long fileSize = boost::filesystem::file_size(path);
+        uassert(51320,
+                str::stream() << "'offset' " << offset << " is past the end of '" << fileName
+                              << "', which has " << fileSize << " bytes",
+                offset <= fileSize);
+
+        std::string data(std::min(length, fileSize - offset), '\0');
+        std::ifstream file(path.string(), std::ios::in | std::ios::binary);
+        file.seekg(offset);
+        file.read(&data[0], data.size());
+        uassert(51321,
+                str::stream() << "Failed to read " << data.size() << " bytes at offset " << offset
+                              << " of '" << fileName << "'",
+                static_cast<size_t>(file.gcount()) == data.size());
+
+        result.appendBinData("data", data.size(), BinDataGeneral, data.data());
+        result.append("md5", md5simpledigest(data));
+        result.append("fileSize", fileSize);
+        result.append("eof", offset + static_cast<long long>(data.size()) == fileSize);
+        return true;
+    }
+
+private:
+    /**
+     * Returns the canonical path of 'fileName', which must name a regular file under the dbpath.
+     */
+    static boost::filesystem::path _resolvePath(const std::string& fileName) {
+        namespace fs = boost::filesystem;
+        const auto dbpath = fs::canonical(storageGlobalParams.dbpath);
+        auto path = fs::path(fileName);
+        if (path.is_relative()) {
+            path = dbpath / path;
+        }
+
+        boost::system::error_code ec;
+        path = fs::canonical(path, ec);
+        uassert(ErrorCodes::FileNotOpen,
+                str::stream() << "Cannot open '" << fileName << "': " << ec.message(),
+                !ec);
+        uassert(ErrorCodes::FileNotOpen,
+                str::stream() << "'" << fileName << "' is not a regular file",
+                fs::is_regular_file(path));
+
+        // Refuse anything outside of the dbpath, including through symbolic links.
+        auto pathIt = path.begin();
+        for (auto dbpathIt = dbpath.begin(); dbpathIt != dbpath.end(); ++dbpathIt, ++pathIt) {
+            uassert(ErrorCodes::Unauthorized,
+                    str::stream() << "'" << fileName << "' is not in the dbpath",
+                    pathIt != path.end() && *pathIt == *dbpathIt);
+        }
+        return path;
+    }
+} readBackupFileCmd;
+
+}  // namespace
+}  // namespace mongo
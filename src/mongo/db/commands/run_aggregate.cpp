@@ -46,10 +46,14 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/aggregation_result_cache.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/db/pipeline/document_source_cursor.h"
 #include "mongo/db/pipeline/document_source_geo_near.h"
+#include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_parallel_exchange.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
@@ -61,10 +65,12 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/read_concern.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/speculative_majority_read_info.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/service_context.h"
@@ -72,6 +78,7 @@
 #include "mongo/db/transaction_participant.h"
 #include "mongo/db/views/view.h"
 #include "mongo/db/views/view_catalog.h"
+#include "mongo/util/clock_source.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/string_map.h"
@@ -126,7 +133,8 @@ bool handleCursorCommand(OperationContext* opCtx,
                          const NamespaceString& nsForCursor,
                          std::vector<ClientCursor*> cursors,
                          const AggregationRequest& request,
-                         rpc::ReplyBuilderInterface* result) {
+                         rpc::ReplyBuilderInterface* result,
+                         std::vector<BSONObj>* firstBatch) {
     invariant(!cursors.empty());
     long long batchSize = request.getBatchSize();
 
@@ -174,6 +182,7 @@ bool handleCursorCommand(OperationContext* opCtx,
 
     BSONObj next;
     bool stashedResult = false;
+    DocumentBufferPoolScope bufferPool(internalDocumentBufferPoolMaxBytes.load());
     for (int objCount = 0; objCount < batchSize; objCount++) {
         // The initial getNext() on a PipelineProxyStage may be very expensive so we don't
         // do it when batchSize is 0 since that indicates a desire for a fast return.
@@ -217,6 +226,9 @@ bool handleCursorCommand(OperationContext* opCtx,
         responseBuilder.setLatestOplogTimestamp(exec->getLatestOplogTimestamp());
         responseBuilder.setPostBatchResumeToken(exec->getPostBatchResumeToken());
         responseBuilder.append(next);
+        if (firstBatch) {
+            firstBatch->push_back(next.getOwned());
+        }
     }
 
     if (cursor) {
@@ -465,9 +477,178 @@ std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> createExchangePipelinesI
     return pipelines;
 }
 
+/**
+ * If internalQueryParallelAggregationConsumers asks for more than one consumer and 'pipeline' is
+ * a $cursor followed by a $group, returns a pipeline which splits the output of the $cursor among
+ * that many threads, each of which computes a partial $group over its share, and merges their
+ * partial results with a final $group before running the rest of 'pipeline'. The $cursor still
+ * runs on one thread at a time, the one loading the Exchange. Otherwise, returns the original
+ * 'pipeline'.
+ */
+std::unique_ptr<Pipeline, PipelineDeleter> createParallelGroupPipelineIfPossible(
+    OperationContext* opCtx,
+    boost::intrusive_ptr<ExpressionContext> expCtx,
+    const AggregationRequest& request,
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline,
+    boost::optional<UUID> uuid,
+    bool hasChangeStream) {
+    const int numConsumers = internalQueryParallelAggregationConsumers.load();
+    if (numConsumers <= 1 || expCtx->explain || request.getExchangeSpec() || hasChangeStream ||
+        request.needsMerge() || request.isFromMongos() || expCtx->inMultiDocumentTransaction) {
+        return pipeline;
+    }
+
+    // The consumers read through operations of their own, which only see the latest data.
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    if (readConcernArgs.getLevel() != repl::ReadConcernLevel::kLocalReadConcern ||
+        readConcernArgs.getArgsOpTime() || readConcernArgs.getArgsAfterClusterTime() ||
+        readConcernArgs.getArgsAtClusterTime()) {
+        return pipeline;
+    }
+
+    auto& sources = pipeline->getSources();
+    if (sources.size() < 2 || !dynamic_cast<DocumentSourceCursor*>(sources.front().get())) {
+        return pipeline;
+    }
+    auto group = dynamic_cast<DocumentSourceGroup*>(std::next(sources.begin())->get());
+    if (!group || group->doingMerge()) {
+        return pipeline;
+    }
+
+    // Every stage above the Exchange needs an ExpressionContext of its own, since the contexts
+    // cannot be shared between threads. They share the runtime constants of the original.
+    auto makeConsumerExpCtx = [&] {
+        auto newExpCtx = makeExpressionContext(
+            opCtx, request, expCtx->getCollator() ? expCtx->getCollator()->clone() : nullptr, uuid);
+        newExpCtx->variables.setRuntimeConstants(expCtx->getRuntimeConstants());
+        return newExpCtx;
+    };
+
+    // The merging $group, and every stage after the partial one, run on our own thread. They are
+    // rebuilt from their serialization before the original pipeline is changed at all.
+    std::vector<Value> mergingStages;
+    group->distributedPlanLogic()->mergingStage->serializeToArray(mergingStages);
+    for (auto it = std::next(sources.begin(), 2); it != sources.end(); ++it) {
+        (*it)->serializeToArray(mergingStages);
+    }
+    std::vector<BSONObj> mergingSpec;
+    for (auto&& stage : mergingStages) {
+        mergingSpec.push_back(stage.getDocument().toBson());
+    }
+    auto mergingExpCtx = makeConsumerExpCtx();
+    auto mergingPipeline = Pipeline::parse(mergingSpec, mergingExpCtx);
+    if (!mergingPipeline.isOK()) {
+        LOG(1) << "Not running $group in parallel: " << mergingPipeline.getStatus();
+        return pipeline;
+    }
+
+    const BSONObj partialGroupSpec = group->serialize().getDocument().toBson();
+
+    // Only the $cursor remains as the input of the Exchange.
+    sources.erase(std::next(sources.begin()), sources.end());
+
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kRoundRobin);
+    spec.setConsumers(numConsumers);
+    boost::intrusive_ptr<Exchange> exchange = new Exchange(spec, std::move(pipeline));
+
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> consumers;
+    for (int idx = 0; idx < numConsumers; ++idx) {
+        auto consumerExpCtx = makeConsumerExpCtx();
+
+        // The partial $group outputs its accumulators in the form the merging $group reads.
+        consumerExpCtx->needsMerge = true;
+
+        Pipeline::SourceContainer consumerSources{
+            new DocumentSourceExchange(consumerExpCtx, exchange, idx, nullptr)};
+        consumerSources.splice(consumerSources.end(),
+                               DocumentSource::parse(consumerExpCtx, partialGroupSpec));
+        consumers.emplace_back(
+            uassertStatusOK(Pipeline::create(std::move(consumerSources), consumerExpCtx)));
+    }
+
+    auto parallelPipeline = std::move(mergingPipeline.getValue());
+    parallelPipeline->addInitialSource(
+        DocumentSourceParallelExchange::create(mergingExpCtx, std::move(consumers)));
+    return parallelPipeline;
+}
+
 /**
  * Create a PlanExecutor to execute the given 'pipeline'.
  */
+/**
+ * Returns the key to look the results of this aggregation up under in the AggregationResultCache,
+ * or boost::none if they may not be served from it. Results may be cached only when they are read
+ * from a single collection at the latest data on a node which accepts writes, since those are the
+ * reads which no committed write can be hidden from. 'pipeline' must be optimized.
+ */
+boost::optional<BSONObj> makeResultCacheKey(OperationContext* opCtx,
+                                            const NamespaceString& nss,
+                                            const AggregationRequest& request,
+                                            const LiteParsedPipeline& liteParsedPipeline,
+                                            const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                            const Pipeline* pipeline,
+                                            const boost::optional<UUID>& uuid) {
+    if (internalQueryAggregationResultCacheMaxSizeBytes.load() == 0 || !uuid) {
+        return boost::none;
+    }
+
+    if (expCtx->explain || request.getExchangeSpec() || request.isFromMongos() ||
+        request.needsMerge() || request.getBatchSize() == 0 ||
+        expCtx->tailableMode != TailableModeEnum::kNormal || liteParsedPipeline.hasChangeStream() ||
+        !liteParsedPipeline.getInvolvedNamespaces().empty() || nss.isOplog()) {
+        return boost::none;
+    }
+
+    auto txnParticipant = TransactionParticipant::get(opCtx);
+    if (txnParticipant && txnParticipant.inMultiDocumentTransaction()) {
+        return boost::none;
+    }
+
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    const auto level = readConcernArgs.getLevel();
+    if ((level != repl::ReadConcernLevel::kLocalReadConcern &&
+         level != repl::ReadConcernLevel::kAvailableReadConcern) ||
+        readConcernArgs.getArgsAfterClusterTime() || readConcernArgs.getArgsAtClusterTime()) {
+        return boost::none;
+    }
+
+    if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesForDatabase(opCtx, nss.db())) {
+        return boost::none;
+    }
+
+    return AggregationResultCache::makeKey(
+        *uuid,
+        pipeline->serialize(),
+        expCtx->getCollator() ? expCtx->getCollator()->getSpec().toBSON() : BSONObj(),
+        level == repl::ReadConcernLevel::kLocalReadConcern ? "local"_sd : "available"_sd);
+}
+
+/**
+ * Replies to the aggregation with 'results' from the AggregationResultCache, in a first batch
+ * which exhausts the cursor.
+ */
+void replyFromResultCache(OperationContext* opCtx,
+                          const NamespaceString& nsForCursor,
+                          const std::vector<BSONObj>& results,
+                          rpc::ReplyBuilderInterface* result) {
+    CursorResponseBuilder::Options options;
+    options.isInitialResponse = true;
+    CursorResponseBuilder responseBuilder(result, options);
+    for (auto&& obj : results) {
+        responseBuilder.append(obj);
+    }
+    responseBuilder.done(0LL, nsForCursor.ns());
+
+    auto curOp = CurOp::get(opCtx);
+    {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        curOp->setPlanSummary_inlock("AGGREGATION_RESULT_CACHE"_sd);
+    }
+    curOp->debug().nreturned = results.size();
+    curOp->debug().cursorExhausted = true;
+}
+
 std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> createOuterPipelineProxyExecutor(
     OperationContext* opCtx,
     const NamespaceString& nss,
@@ -513,6 +694,12 @@ Status runAggregate(OperationContext* opCtx,
     std::vector<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> execs;
     boost::intrusive_ptr<ExpressionContext> expCtx;
     auto curOp = CurOp::get(opCtx);
+
+    // When set, the results are cached under this key if they all fit in the first batch, along
+    // with the collection's write epoch and the time from before they were read.
+    boost::optional<BSONObj> resultCacheKey;
+    unsigned long long resultCacheWriteEpoch = 0;
+    Date_t resultCacheReadAt;
     {
         const LiteParsedPipeline liteParsedPipeline(request);
 
@@ -638,6 +825,24 @@ Status runAggregate(OperationContext* opCtx,
 
         pipeline->optimizePipeline();
 
+        resultCacheKey = makeResultCacheKey(
+            opCtx, nss, request, liteParsedPipeline, expCtx, pipeline.get(), uuid);
+        if (resultCacheKey) {
+            resultCacheWriteEpoch = collection->infoCache()->getWriteEpoch();
+            resultCacheReadAt = opCtx->getServiceContext()->getFastClockSource()->now();
+            auto entry = AggregationResultCache::get(opCtx->getServiceContext())
+                             .lookup(*resultCacheKey,
+                                     resultCacheWriteEpoch,
+                                     resultCacheReadAt,
+                                     Milliseconds(
+                                         internalQueryAggregationResultCacheMaxStalenessMS.load()),
+                                     request.getBatchSize());
+            if (entry) {
+                replyFromResultCache(opCtx, origNss, entry->results, result);
+                return Status::OK();
+            }
+        }
+
         // Check if the pipeline has a $geoNear stage, as it will be ripped away during the build
         // query executor phase below (to be replaced with a $geoNearCursorStage later during the
         // executor attach phase).
@@ -682,6 +887,13 @@ Status runAggregate(OperationContext* opCtx,
             // adding the initial cursor stage.
             pipeline->optimizePipeline();
 
+            pipeline = createParallelGroupPipelineIfPossible(opCtx,
+                                                             expCtx,
+                                                             request,
+                                                             std::move(pipeline),
+                                                             uuid,
+                                                             liteParsedPipeline.hasChangeStream());
+
             auto pipelines =
                 createExchangePipelinesIfNeeded(opCtx, expCtx, request, std::move(pipeline), uuid);
             for (auto&& pipelineIt : pipelines) {
@@ -772,10 +984,22 @@ Status runAggregate(OperationContext* opCtx,
         }
     } else {
         // Cursor must be specified, if explain is not.
-        const bool keepCursor =
-            handleCursorCommand(opCtx, origNss, std::move(cursors), request, result);
+        std::vector<BSONObj> firstBatch;
+        const bool keepCursor = handleCursorCommand(opCtx,
+                                                    origNss,
+                                                    std::move(cursors),
+                                                    request,
+                                                    result,
+                                                    resultCacheKey ? &firstBatch : nullptr);
         if (keepCursor) {
             cursorFreer.dismiss();
+        } else if (resultCacheKey) {
+            AggregationResultCache::get(opCtx->getServiceContext())
+                .insert(*resultCacheKey,
+                        std::move(firstBatch),
+                        resultCacheWriteEpoch,
+                        resultCacheReadAt,
+                        internalQueryAggregationResultCacheMaxSizeBytes.load());
         }
 
         PlanSummaryStats stats;
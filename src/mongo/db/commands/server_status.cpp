@@ -174,6 +174,20 @@ public:
         return true;
     }
 
+    void appendSections(OperationContext* opCtx,
+                        const std::vector<std::string>& sectionNames,
+                        BSONObjBuilder* result) {
+        _runCalled = true;
+
+        for (const auto& name : sectionNames) {
+            auto it = _sections.find(name);
+            if (it == _sections.end()) {
+                continue;
+            }
+            it->second->appendSection(opCtx, BSONElement(), result);
+        }
+    }
+
     void addSection(ServerStatusSection* section) {
         // Disallow adding a section named "timing" as it is reserved for the server status command.
         dassert(section->getSectionName() != kTimingSection);
@@ -211,6 +225,12 @@ ServerStatusSection::ServerStatusSection(const string& sectionName) : _sectionNa
     CmdServerStatusInstantiator::getInstance().addSection(this);
 }
 
+void appendServerStatusSections(OperationContext* opCtx,
+                                const std::vector<std::string>& sectionNames,
+                                BSONObjBuilder* result) {
+    CmdServerStatusInstantiator::getInstance().appendSections(opCtx, sectionNames, result);
+}
+
 OpCounterServerStatusSection::OpCounterServerStatusSection(const string& sectionName,
                                                            OpCounters* counters)
     : ServerStatusSection(sectionName), _counters(counters) {}
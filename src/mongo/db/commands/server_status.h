@@ -121,4 +121,15 @@ public:
 private:
     const OpCounters* _counters;
 };
+
+/**
+ * Appends the named sections to 'result' as the serverStatus command would for {<section>: 1},
+ * without the command's basic fields, metrics or privilege checks. Names which are not registered
+ * are skipped. This lets internal callers sample a few sections more often than the whole command
+ * can be run.
+ */
+void appendServerStatusSections(OperationContext* opCtx,
+                                const std::vector<std::string>& sectionNames,
+                                BSONObjBuilder* result);
+
 }  // namespace mongo
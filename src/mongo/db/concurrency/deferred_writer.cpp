@@ -38,6 +38,7 @@
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
 
@@ -56,7 +57,7 @@ void DeferredWriter::_logDroppedEntry() {
     _droppedEntries += 1;
     if (TimePoint::clock::now() - _lastLoggedDrop > kLogInterval) {
         log() << "Deferred write buffer for " << _nss.toString() << " is full. " << _droppedEntries
-              << " entries have been dropped.";
+              << " entries have been rejected.";
         _lastLoggedDrop = stdx::chrono::system_clock::now();
         _droppedEntries = 0;
     }
@@ -79,6 +80,11 @@ StatusWith<std::unique_ptr<AutoGetCollection>> DeferredWriter::_getCollection(
     agc = std::make_unique<AutoGetCollection>(opCtx, _nss, MODE_IX);
 
     while (!agc->getCollection()) {
+        if (!_mayCreateDatabase && !agc->getDb()) {
+            return Status(ErrorCodes::NamespaceNotFound,
+                          str::stream() << "Database " << _nss.db() << " does not exist");
+        }
+
         // Release the previous AGC's lock before trying to rebuild the collection.
         agc.reset();
         Status status = _makeCollection(opCtx);
@@ -93,45 +99,89 @@ StatusWith<std::unique_ptr<AutoGetCollection>> DeferredWriter::_getCollection(
     return std::move(agc);
 }
 
-void DeferredWriter::_worker(InsertStatement stmt) {
-    auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
-    OperationContext* opCtx = uniqueOpCtx.get();
+Status DeferredWriter::_insertBatch(OperationContext* opCtx,
+                                    const std::vector<InsertStatement>& batch) {
     auto result = _getCollection(opCtx);
-
     if (!result.isOK()) {
-        _logFailure(result.getStatus());
-        return;
+        return result.getStatus();
     }
 
     auto agc = std::move(result.getValue());
 
     Collection& collection = *agc->getCollection();
 
-    Status status = writeConflictRetry(opCtx, "deferred insert", _nss.ns(), [&] {
-        WriteUnitOfWork wuow(opCtx);
-        Status status = collection.insertDocument(opCtx, stmt, nullptr, false);
-        if (!status.isOK()) {
-            return status;
+    auto insert = [&](std::vector<InsertStatement>::const_iterator begin,
+                      std::vector<InsertStatement>::const_iterator end) {
+        return writeConflictRetry(opCtx, "deferred insert", _nss.ns(), [&] {
+            WriteUnitOfWork wuow(opCtx);
+            Status status = collection.insertDocuments(opCtx, begin, end, nullptr, false);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            wuow.commit();
+            return Status::OK();
+        });
+    };
+
+    Status status = insert(batch.begin(), batch.end());
+    if (status.isOK() || batch.size() == 1) {
+        return status;
+    }
+
+    // Keep one bad document from failing the rest of the batch.
+    status = Status::OK();
+    for (auto it = batch.begin(); it != batch.end(); ++it) {
+        Status docStatus = insert(it, it + 1);
+        if (!docStatus.isOK()) {
+            status = docStatus;
+        }
+    }
+    return status;
+}
+
+void DeferredWriter::_worker() {
+    auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
+    OperationContext* opCtx = uniqueOpCtx.get();
+
+    while (true) {
+        std::vector<InsertStatement> batch;
+        int64_t batchBytes = 0;
+        {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            if (_buffer.empty()) {
+                _workerScheduled = false;
+                return;
+            }
+
+            while (!_buffer.empty() && batch.size() < kMaxBatchSize) {
+                batchBytes += _buffer.front().objsize();
+                batch.emplace_back(std::move(_buffer.front()));
+                _buffer.pop_front();
+            }
         }
 
-        wuow.commit();
-        return Status::OK();
-    });
+        Status status = _insertBatch(opCtx, batch);
 
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
 
-    _numBytes -= stmt.doc.objsize();
+        _numBytes -= batchBytes;
 
-    // If a write to a deferred collection fails, periodically tell the log.
-    if (!status.isOK()) {
-        _logFailure(status);
+        // If a write to a deferred collection fails, periodically tell the log.
+        if (!status.isOK()) {
+            _logFailure(status);
+        }
     }
 }
 
-DeferredWriter::DeferredWriter(NamespaceString nss, CollectionOptions opts, int64_t maxSize)
+DeferredWriter::DeferredWriter(NamespaceString nss,
+                               CollectionOptions opts,
+                               int64_t maxSize,
+                               bool mayCreateDatabase)
     : _collectionOptions(opts),
       _maxNumBytes(maxSize),
       _nss(nss),
+      _mayCreateDatabase(mayCreateDatabase),
       _numBytes(0),
       _droppedEntries(0),
       _lastLogged(TimePoint::clock::now() - kLogInterval) {}
@@ -176,13 +226,17 @@ bool DeferredWriter::insertDocument(BSONObj obj) {
         return false;
     }
 
-    // Add the object to the buffer.
+    // Add the object to the buffer, and wake the worker up unless it is still draining it.
     _numBytes += obj.objsize();
-    _pool->schedule([this, obj](auto status) {
-        fassert(40588, status);
-
-        _worker(InsertStatement(obj.getOwned()));
-    });
+    _buffer.push_back(obj.getOwned());
+    if (!_workerScheduled) {
+        _workerScheduled = true;
+        _pool->schedule([this](auto status) {
+            fassert(40588, status);
+
+            _worker();
+        });
+    }
     return true;
 }
 
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
@@ -53,6 +55,9 @@ class ThreadPool;
  * caller, it cannot report most errors to the client; it instead periodically logs any errors to
  * the system log.
  *
+ * The worker thread inserts the buffered objects in batches of up to kMaxBatchSize documents, each
+ * batch in a single write unit of work.
+ *
  * Instances of this class are unconditionally thread-safe, and cannot cause deadlock barring
  * improper use of the ctor, `flush` and `shutdown` methods below.
  */
@@ -61,6 +66,11 @@ class DeferredWriter {
     DeferredWriter& operator=(const DeferredWriter&) = delete;
 
 public:
+    /**
+     * The maximum number of documents the worker thread inserts in one write unit of work.
+     */
+    static const size_t kMaxBatchSize = 100;
+
     /**
      * Create a new DeferredWriter for writing to a given collection.
      *
@@ -68,8 +78,13 @@ public:
      *
      * @param opts The options to use when creating the backing collection if it doesn't exist.
      * @param maxSize the maximum number of bytes to store in the buffer.
+     * @param mayCreateDatabase whether to create the database of the backing collection if it
+     *     doesn't exist, or to fail the writes.
      */
-    DeferredWriter(NamespaceString nss, CollectionOptions opts, int64_t maxSize);
+    DeferredWriter(NamespaceString nss,
+                   CollectionOptions opts,
+                   int64_t maxSize,
+                   bool mayCreateDatabase = true);
 
     /**
      * Start the background worker thread writing to the given collection.
@@ -134,9 +149,15 @@ private:
     StatusWith<std::unique_ptr<AutoGetCollection>> _getCollection(OperationContext* opCtx);
 
     /**
-     * The method that the worker thread will run.
+     * Insert 'batch' into the backing collection, one document at a time if the batch as a whole
+     * fails.
+     */
+    Status _insertBatch(OperationContext* opCtx, const std::vector<InsertStatement>& batch);
+
+    /**
+     * The method that the worker thread will run. Inserts batches until the buffer is empty.
      */
-    void _worker(InsertStatement stmt);
+    void _worker();
 
     /**
      * The options for the collection, in case we need to create it.
@@ -153,6 +174,8 @@ private:
      */
     const NamespaceString _nss;
 
+    const bool _mayCreateDatabase;
+
     std::unique_ptr<ThreadPool> _pool;
 
     /**
@@ -165,6 +188,16 @@ private:
      */
     int64_t _numBytes;
 
+    /**
+     * The objects which are waiting for the worker thread, oldest first.
+     */
+    std::deque<BSONObj> _buffer;
+
+    /**
+     * Whether the worker thread is scheduled to drain the buffer.
+     */
+    bool _workerScheduled = false;
+
     /**
      * The number of deffered entries that have been dropped. Resets when the
      * rate-limited system log is written out.
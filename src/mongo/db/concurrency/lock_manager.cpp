@@ -33,6 +33,10 @@
 
 #include "mongo/db/concurrency/lock_manager.h"
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/static_assert.h"
@@ -41,7 +45,9 @@
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/str.h"
 #include "mongo/util/timer.h"
@@ -49,6 +55,9 @@
 namespace mongo {
 namespace {
 
+// Grants partitioned requests as if they were made on the CPU given by the 'cpu' field of its data.
+MONGO_FAIL_POINT_DEFINE(lockManagerChoosePartitionForCPU);
+
 /**
  * Map of conflicts. 'LockConflictsTable[newMode] & existingMode != 0' means that a new request
  * with the given 'newMode' conflicts with an existing request with mode 'existingMode'.
@@ -111,6 +120,128 @@ MONGO_STATIC_ASSERT((sizeof(LockRequestStatusNames) / sizeof(LockRequestStatusNa
 
 }  // namespace
 
+/**
+ * The FastIntentLockHead optimizes intent mode requests for the global resources, which nearly
+ * every operation locks in an intent mode, and for the databases and collections used by CRUD.
+ * While no request in a non-intent mode is granted or pending on its LockHead, it grants intent
+ * requests by counting them in a single atomic word, so that they take neither a bucket nor a
+ * partition mutex.
+ *
+ * Before a request in a non-intent mode is processed on the LockHead, the fast intent lock head
+ * is closed and the requests it counted are folded into the granted counts of the LockHead, so
+ * that the new request waits for them. Each close starts a new epoch of the fast intent lock head.
+ * On unlock, a request granted in the current epoch only decrements its count, while one granted
+ * in an earlier epoch was folded and is released from the LockHead. The fast intent lock head is
+ * opened again once no request in a non-intent mode is granted or pending.
+ *
+ * The LockHead of each of the global resources always exists, so that it can be referenced without
+ * a lookup. Databases and collections which are locked get a fast intent lock head from a fixed
+ * table while their LockHead exists, and give it back when the LockHead is cleaned up. A head is
+ * only assigned to a resource while it is closed, so a grant, which must find the head open in the
+ * same epoch in which it read the resource of the head, never counts towards the wrong resource.
+ * Closing, opening and assigning happen under the bucket mutex of the LockHead.
+ */
+struct alignas(stdx::hardware_destructive_interference_size) FastIntentLockHead {
+    // The state word holds the number of granted MODE_IS and MODE_IX requests, then the closed
+    // bit, then the epoch.
+    static constexpr uint64_t kCountBits = 15;
+    static constexpr uint64_t kCountMask = (1ULL << kCountBits) - 1;
+    static constexpr uint64_t kClosedBit = 1ULL << (2 * kCountBits);
+    static constexpr uint64_t kEpochShift = 2 * kCountBits + 1;
+
+    static uint64_t countShift(LockMode mode) {
+        invariant(mode == MODE_IS || mode == MODE_IX);
+        return mode == MODE_IX ? kCountBits : 0;
+    }
+
+    static uint32_t epochOf(uint64_t state) {
+        return static_cast<uint32_t>(state >> kEpochShift);
+    }
+
+    /**
+     * Grants 'request' on 'resId' if the fast intent lock head is open for that resource and its
+     * count has room for it.
+     */
+    bool tryGrant(ResourceId resId, LockRequest* request) {
+        const uint64_t shift = countShift(request->mode);
+        uint64_t state = this->state.load();
+        while (!(state & kClosedBit) && ((state >> shift) & kCountMask) != kCountMask) {
+            // These can only change while the head is closed, which changes the epoch of the state
+            // and so makes the swap below fail.
+            if (this->resId.load() != resId) {
+                return false;
+            }
+            LockHead* const lock = this->lock.load();
+
+            if (this->state.compareAndSwap(&state, state + (1ULL << shift))) {
+                request->lock = lock;
+                request->fastIntentLock = this;
+                request->fastIntentEpoch = epochOf(state);
+                request->status = LockRequest::STATUS_GRANTED;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Releases 'request', which this fast intent lock head granted, unless its grant has since
+     * been folded into the LockHead.
+     */
+    bool tryRelease(LockRequest* request) {
+        const uint64_t shift = countShift(request->mode);
+        uint64_t state = this->state.load();
+        while (epochOf(state) == request->fastIntentEpoch) {
+            if (this->state.compareAndSwap(&state, state - (1ULL << shift))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Closes the fast intent lock head, if it is open, and returns the number of MODE_IS and
+     * MODE_IX requests it had granted in the epoch which this ends.
+     */
+    void close(uint32_t* numIS, uint32_t* numIX) {
+        *numIS = 0;
+        *numIX = 0;
+        uint64_t state = this->state.load();
+        while (!(state & kClosedBit)) {
+            const uint64_t closed =
+                (static_cast<uint64_t>(epochOf(state) + 1) << kEpochShift) | kClosedBit;
+            if (this->state.compareAndSwap(&state, closed)) {
+                *numIS = state & kCountMask;
+                *numIX = (state >> kCountBits) & kCountMask;
+                return;
+            }
+        }
+    }
+
+    void open() {
+        state.fetchAndBitAnd(~kClosedBit);
+    }
+
+    bool isClosed() const {
+        return state.load() & kClosedBit;
+    }
+
+    /**
+     * Returns the number of requests granted in the current epoch.
+     */
+    uint32_t numGranted() const {
+        const uint64_t current = state.load();
+        return (current & kCountMask) + ((current >> kCountBits) & kCountMask);
+    }
+
+    AtomicWord<uint64_t> state{0};
+
+    // The resource and its LockHead, which is not deleted while the fast intent lock head is
+    // assigned to it. An unassigned head has an invalid resource and is closed.
+    AtomicWord<uint64_t> resId{0};
+    AtomicWord<LockHead*> lock{nullptr};
+};
+
 /**
  * There is one of these objects for each resource that has a lock request. Empty objects (i.e.
  * LockHead with no requests) are allowed to exist on the lock manager's hash table.
@@ -139,6 +270,9 @@ struct LockHead {
 
         conversionsCount = 0;
         compatibleFirstCount = 0;
+
+        fastIntentLock = nullptr;
+        numFoldedFastIntentGrants = 0;
     }
 
     /**
@@ -219,6 +353,59 @@ struct LockHead {
      */
     void migratePartitionedLockHeads();
 
+    /**
+     * Closes the fast intent lock head, if this lock has one, and counts the requests it had
+     * granted as granted on this lock.
+     */
+    void foldFastIntentGrants() {
+        if (!fastIntentLock) {
+            return;
+        }
+
+        uint32_t numIS;
+        uint32_t numIX;
+        fastIntentLock->close(&numIS, &numIX);
+        for (auto mode : {MODE_IS, MODE_IX}) {
+            const uint32_t numGrants = (mode == MODE_IS ? numIS : numIX);
+            if (numGrants) {
+                if (grantedCounts[mode] == 0) {
+                    grantedModes |= modeMask(mode);
+                }
+                grantedCounts[mode] += numGrants;
+                numFoldedFastIntentGrants += numGrants;
+            }
+        }
+    }
+
+    /**
+     * Moves 'request', which the fast intent lock head granted, to the granted list, so that it
+     * can be converted or downgraded like any other granted request.
+     */
+    void makeFastIntentGrantRegular(LockRequest* request) {
+        invariant(request->fastIntentLock == fastIntentLock);
+        foldFastIntentGrants();
+
+        invariant(numFoldedFastIntentGrants > 0);
+        numFoldedFastIntentGrants--;
+        request->fastIntentLock = nullptr;
+        grantedList.push_back(request);
+    }
+
+    /**
+     * Opens the fast intent lock head, if this lock has one, when no request in a non-intent mode
+     * is granted or pending.
+     */
+    void reopenFastIntentLock() {
+        if (fastIntentLock && !(grantedModes & ~intentModes) && !conflictModes) {
+            fastIntentLock->open();
+        }
+    }
+
+    bool hasGrants() const {
+        return !grantedList.empty() || numFoldedFastIntentGrants ||
+            (fastIntentLock && fastIntentLock->numGranted());
+    }
+
     // Methods to maintain the granted queue
     void incGrantedModeCount(LockMode mode) {
         invariant(grantedCounts[mode] >= 0);
@@ -311,6 +498,17 @@ struct LockHead {
     // be switched to compatible-first. As long as this value is > 0, the policy will stay
     // compatible-first.
     uint32_t compatibleFirstCount;
+
+    //
+    // Fast intent locks
+    //
+
+    // The fast intent lock head of this resource, if it has one.
+    FastIntentLockHead* fastIntentLock;
+
+    // Counts the requests granted by the fast intent lock head which have since been folded into
+    // the granted counts. These requests are not on the granted list.
+    uint32_t numFoldedFastIntentGrants;
 };
 
 /**
@@ -393,18 +591,77 @@ void LockHead::migratePartitionedLockHeads() {
 // Have more buckets than CPUs to reduce contention on lock and caches
 const unsigned LockManager::_numLockBuckets(128);
 
+namespace {
+
 // Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+// The exact value doesn't appear very important, but should be power of two. There are at least
+// as many partitions as CPUs, so that each CPU has its own one.
+const unsigned kMinPartitions = 32;
+const unsigned kMaxPartitions = 1024;
+
+unsigned numPartitionsForCores() {
+    const unsigned numCores = stdx::thread::hardware_concurrency();
+    unsigned numPartitions = kMinPartitions;
+    while (numPartitions < numCores && numPartitions < kMaxPartitions) {
+        numPartitions *= 2;
+    }
+    return numPartitions;
+}
+
+}  // namespace
+
+// One fast intent lock head for each of RESOURCE_PBWM, RESOURCE_RSTL and RESOURCE_GLOBAL.
+const unsigned LockManager::_numFastIntentLockHeads = 3;
+
+// Enough for the databases and collections which are in use at once. Must be a power of two.
+const unsigned LockManager::_numAssignableFastIntentLockHeads = 4096;
 
-LockManager::LockManager() {
+// A resource can be assigned to any of this many consecutive heads, starting at its hash.
+const unsigned LockManager::_numFastIntentLockHeadProbes = 8;
+
+LockManager::LockManager() : _numPartitions(numPartitionsForCores()) {
     _lockBuckets = new LockBucket[_numLockBuckets];
     _partitions = new Partition[_numPartitions];
+
+    _fastIntentLockHeads = new FastIntentLockHead[_numFastIntentLockHeads];
+    for (unsigned i = 0; i < _numFastIntentLockHeads; i++) {
+        const ResourceId resId(static_cast<ResourceType>(RESOURCE_PBWM + i), 1ULL);
+        LockBucket* bucket = _getBucket(resId);
+        stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+        LockHead* lock = bucket->findOrInsert(resId);
+        lock->fastIntentLock = &_fastIntentLockHeads[i];
+        _fastIntentLockHeads[i].resId.store(resId);
+        _fastIntentLockHeads[i].lock.store(lock);
+    }
+
+    _assignableFastIntentLockHeads = new FastIntentLockHead[_numAssignableFastIntentLockHeads];
+    for (unsigned i = 0; i < _numAssignableFastIntentLockHeads; i++) {
+        uint32_t numIS;
+        uint32_t numIX;
+        _assignableFastIntentLockHeads[i].close(&numIS, &numIX);
+    }
 }
 
 LockManager::~LockManager() {
     cleanupUnusedLocks();
 
+    for (unsigned i = 0; i < _numFastIntentLockHeads; i++) {
+        LockHead* lock = _fastIntentLockHeads[i].lock.load();
+        LockBucket* bucket = _getBucket(lock->resourceId);
+        invariant(!lock->hasGrants());
+        invariant(lock->conflictModes == 0);
+
+        bucket->data.erase(lock->resourceId);
+        delete lock;
+    }
+    delete[] _fastIntentLockHeads;
+
+    for (unsigned i = 0; i < _numAssignableFastIntentLockHeads; i++) {
+        invariant(!_assignableFastIntentLockHeads[i].lock.load());
+    }
+    delete[] _assignableFastIntentLockHeads;
+
     for (unsigned i = 0; i < _numLockBuckets; i++) {
         // TODO: dump more information about the non-empty bucket to see what locks were leaked
         invariant(_lockBuckets[i].data.empty());
@@ -419,11 +676,26 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
     invariant(request->status == LockRequest::STATUS_NEW);
     invariant(request->recursiveCount == 1);
 
-    request->partitioned = (mode == MODE_IX || mode == MODE_IS);
+    const bool isIntentMode = (mode == MODE_IX || mode == MODE_IS);
+    FastIntentLockHead* globalFastIntentLock = _getFastIntentLockHead(resId);
+
+    request->partitioned = isIntentMode && !globalFastIntentLock;
     request->mode = mode;
 
+    // Fast path for intent locks on resources which have a fast intent lock head. Requests which
+    // switch the policy to compatible-first must be on the granted list, so they can't use it.
+    if (isIntentMode && !request->compatibleFirst) {
+        FastIntentLockHead* fastIntentLock =
+            globalFastIntentLock ? globalFastIntentLock : _findFastIntentLockHead(resId);
+        if (fastIntentLock && fastIntentLock->tryGrant(resId, request)) {
+            request->partitioned = false;
+            return LOCK_OK;
+        }
+    }
+
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
+        request->partitionId = _choosePartition(request);
         Partition* partition = _getPartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
 
@@ -445,6 +717,27 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     LockHead* lock = bucket->findOrInsert(resId);
 
+    if (isIntentMode) {
+        // The fast intent lock head may have been closed while there was no request in a
+        // non-intent mode left to reopen it, or the resource may not have one yet.
+        if (!request->compatibleFirst && !(lock->grantedModes & (~intentModes)) &&
+            !lock->conflictModes) {
+            if (!lock->fastIntentLock) {
+                _assignFastIntentLockHead(lock);
+            }
+            if (lock->fastIntentLock) {
+                lock->fastIntentLock->open();
+                if (lock->fastIntentLock->tryGrant(resId, request)) {
+                    request->partitioned = false;
+                    return LOCK_OK;
+                }
+            }
+        }
+    } else {
+        // Requests in non-intent modes must see the intent requests granted so far.
+        lock->foldFastIntentGrants();
+    }
+
     // Start a partitioned lock if possible
     if (request->partitioned && !(lock->grantedModes & (~intentModes)) && !lock->conflictModes) {
         Partition* partition = _getPartition(request);
@@ -500,6 +793,11 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
         lock->migratePartitionedLockHeads();
     }
 
+    lock->foldFastIntentGrants();
+    if (request->fastIntentLock) {
+        lock->makeFastIntentGrantRegular(request);
+    }
+
     // Construct granted mask without our current mode, so that it is not counted as
     // conflicting
     uint32_t grantedModesWithoutCurrentRequest = 0;
@@ -535,6 +833,7 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
         lock->decGrantedModeCount(request->mode);
         request->mode = newMode;
 
+        lock->reopenFastIntentLock();
         return LOCK_OK;
     }
 }
@@ -566,6 +865,19 @@ bool LockManager::unlock(LockRequest* request) {
 
         // not partitioned anymore, fall through to regular case
     }
+
+    if (request->fastIntentLock) {
+        invariant(request->status == LockRequest::STATUS_GRANTED);
+
+        // Fast path: the grant has not been folded into the LockHead.
+        if (request->fastIntentLock->tryRelease(request)) {
+            request->fastIntentLock = nullptr;
+            return true;
+        }
+
+        // The grant was folded, which happened under the bucket mutex, fall through to regular
+        // case
+    }
     invariant(request->lock);
 
     LockHead* lock = request->lock;
@@ -578,7 +890,13 @@ bool LockManager::unlock(LockRequest* request) {
         // already ensure request->recursiveCount == 0.
 
         // Remove from the granted list
-        lock->grantedList.remove(request);
+        if (request->fastIntentLock) {
+            invariant(lock->numFoldedFastIntentGrants > 0);
+            lock->numFoldedFastIntentGrants--;
+            request->fastIntentLock = nullptr;
+        } else {
+            lock->grantedList.remove(request);
+        }
         lock->decGrantedModeCount(request->mode);
 
         if (request->compatibleFirst) {
@@ -616,6 +934,7 @@ bool LockManager::unlock(LockRequest* request) {
         MONGO_UNREACHABLE;
     }
 
+    lock->reopenFastIntentLock();
     return (request->recursiveCount == 0);
 }
 
@@ -634,11 +953,16 @@ void LockManager::downgrade(LockRequest* request, LockMode newMode) {
     LockBucket* bucket = _getBucket(lock->resourceId);
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
 
+    if (request->fastIntentLock) {
+        lock->makeFastIntentGrantRegular(request);
+    }
+
     lock->incGrantedModeCount(newMode);
     lock->decGrantedModeCount(request->mode);
     request->mode = newMode;
 
     _onLockModeChanged(lock, true);
+    lock->reopenFastIntentLock();
 }
 
 void LockManager::cleanupUnusedLocks() {
@@ -659,7 +983,19 @@ void LockManager::_cleanupUnusedLocksInBucket(LockBucket* bucket) {
             lock->migratePartitionedLockHeads();
         }
 
-        if (lock->grantedModes == 0) {
+        // The LockHeads of the global resources live as long as the lock manager. Others give
+        // back their fast intent lock head once no request holds it.
+        const bool isGlobal = _getFastIntentLockHead(lock->resourceId) != nullptr;
+        if (lock->fastIntentLock && !isGlobal) {
+            lock->foldFastIntentGrants();
+            if (lock->grantedModes == 0) {
+                _releaseFastIntentLockHead(lock);
+            } else {
+                lock->reopenFastIntentLock();
+            }
+        }
+
+        if (lock->grantedModes == 0 && !isGlobal) {
             invariant(lock->grantedModes == 0);
             invariant(lock->grantedList._front == nullptr);
             invariant(lock->grantedList._back == nullptr);
@@ -784,7 +1120,8 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
 
     // This is a convenient place to check that the state of the two request queues is in sync
     // with the bitmask on the modes.
-    invariant((lock->grantedModes == 0) ^ (lock->grantedList._front != nullptr));
+    invariant((lock->grantedModes == 0) ^
+              (lock->grantedList._front != nullptr || lock->numFoldedFastIntentGrants > 0));
     invariant((lock->conflictModes == 0) ^ (lock->conflictList._front != nullptr));
 }
 
@@ -792,8 +1129,83 @@ LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
     return &_lockBuckets[resId % _numLockBuckets];
 }
 
+unsigned LockManager::_choosePartition(LockRequest* request) const {
+    MONGO_FAIL_POINT_BLOCK(lockManagerChoosePartitionForCPU, forcedCPU) {
+        return static_cast<unsigned>(forcedCPU.getData()["cpu"].numberInt()) % _numPartitions;
+    }
+
+#if defined(__linux__)
+    // CPUs are numbered by NUMA node, so consecutive partitions are used by the same node.
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return static_cast<unsigned>(cpu) % _numPartitions;
+    }
+#endif
+    return request->locker->getId() % _numPartitions;
+}
+
 LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
-    return &_partitions[request->locker->getId() % _numPartitions];
+    return &_partitions[request->partitionId];
+}
+
+FastIntentLockHead* LockManager::_findFastIntentLockHead(ResourceId resId) const {
+    const ResourceType type = resId.getType();
+    if (type != RESOURCE_DATABASE && type != RESOURCE_COLLECTION) {
+        return nullptr;
+    }
+
+    const uint64_t hash = static_cast<uint64_t>(resId);
+    const unsigned first = static_cast<unsigned>(hash ^ (hash >> 32));
+    for (unsigned i = 0; i < _numFastIntentLockHeadProbes; i++) {
+        FastIntentLockHead* head =
+            &_assignableFastIntentLockHeads[(first + i) & (_numAssignableFastIntentLockHeads - 1)];
+        if (head->resId.load() == resId) {
+            return head;
+        }
+    }
+    return nullptr;
+}
+
+void LockManager::_assignFastIntentLockHead(LockHead* lock) {
+    const ResourceId resId = lock->resourceId;
+    const ResourceType type = resId.getType();
+    if (type != RESOURCE_DATABASE && type != RESOURCE_COLLECTION) {
+        return;
+    }
+
+    const uint64_t hash = static_cast<uint64_t>(resId);
+    const unsigned first = static_cast<unsigned>(hash ^ (hash >> 32));
+    for (unsigned i = 0; i < _numFastIntentLockHeadProbes; i++) {
+        FastIntentLockHead* head =
+            &_assignableFastIntentLockHeads[(first + i) & (_numAssignableFastIntentLockHeads - 1)];
+
+        // Unassigned heads are closed, so nothing is granted on them while they are assigned.
+        uint64_t unassigned = 0;
+        if (head->resId.compareAndSwap(&unassigned, resId)) {
+            invariant(head->isClosed());
+            head->lock.store(lock);
+            lock->fastIntentLock = head;
+            return;
+        }
+    }
+}
+
+void LockManager::_releaseFastIntentLockHead(LockHead* lock) {
+    FastIntentLockHead* head = lock->fastIntentLock;
+    invariant(head->isClosed());
+    invariant(lock->numFoldedFastIntentGrants == 0);
+
+    lock->fastIntentLock = nullptr;
+    head->lock.store(nullptr);
+    head->resId.store(0);
+}
+
+FastIntentLockHead* LockManager::_getFastIntentLockHead(ResourceId resId) const {
+    const ResourceType type = resId.getType();
+    if (type < RESOURCE_PBWM || type > RESOURCE_GLOBAL || resId.getHashId() != 1ULL) {
+        return nullptr;
+    }
+    return &_fastIntentLockHeads[type - RESOURCE_PBWM];
 }
 
 void LockManager::dump() const {
@@ -815,12 +1227,18 @@ void LockManager::_dumpBucketToBSON(const std::map<LockerId, BSONObj>& lockToCli
     for (auto& bucketEntry : bucket->data) {
         const LockHead* lock = bucketEntry.second;
 
-        if (lock->grantedList.empty()) {
+        if (!lock->hasGrants()) {
             // If there are no granted requests, this lock is empty, so no need to print it
             continue;
         }
 
         result->append("resourceId", lock->resourceId.toString());
+        if (lock->fastIntentLock) {
+            // Requests granted by the fast intent lock head are only counted.
+            result->append("numFastIntentGrants",
+                           static_cast<int>(lock->numFoldedFastIntentGrants +
+                                            lock->fastIntentLock->numGranted()));
+        }
 
         BSONArrayBuilder grantedLocks;
         for (const LockRequest* iter = lock->grantedList._front; iter != nullptr;
@@ -878,13 +1296,17 @@ void LockManager::_dumpBucket(const LockBucket* bucket) const {
          it++) {
         const LockHead* lock = it->second;
 
-        if (lock->grantedList.empty()) {
+        if (!lock->hasGrants()) {
             // If there are no granted requests, this lock is empty, so no need to print it
             continue;
         }
 
         StringBuilder sb;
         sb << "Lock @ " << lock << ": " << lock->resourceId.toString() << '\n';
+        if (lock->fastIntentLock) {
+            sb << "FAST INTENT GRANTS: " << lock->fastIntentLock->numGranted() << " current, "
+               << lock->numFoldedFastIntentGrants << " folded\n";
+        }
 
         sb << "GRANTED:\n";
         for (const LockRequest* iter = lock->grantedList._front; iter != nullptr;
@@ -992,6 +1414,9 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
 
     lock = nullptr;
     partitionedLock = nullptr;
+    partitionId = 0;
+    fastIntentLock = nullptr;
+    fastIntentEpoch = 0;
     prev = nullptr;
     next = nullptr;
     status = STATUS_NEW;
@@ -41,8 +41,9 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/flat_hash_map.h"
 #include "mongo/stdx/mutex.h"
-#include "mongo/stdx/unordered_map.h"
+#include "mongo/stdx/new.h"
 #include "mongo/util/concurrency/mutex.h"
 
 namespace mongo {
@@ -137,22 +138,23 @@ private:
     // The lockheads need access to the partitions
     friend struct LockHead;
 
-    // These types describe the locks hash table
+    // These types describe the locks hash table. Buckets and partitions are each padded to a cache
+    // line, so that threads working on neighbouring ones don't contend on it.
 
-    struct LockBucket {
+    struct alignas(stdx::hardware_destructive_interference_size) LockBucket {
         SimpleMutex mutex;
-        typedef stdx::unordered_map<ResourceId, LockHead*> Map;
+        typedef stdx::flat_hash_map<ResourceId, LockHead*> Map;
         Map data;
         LockHead* findOrInsert(ResourceId resId);
     };
 
-    // Each locker maps to a partition that is used for resources acquired in intent modes
+    // Each CPU maps to a partition that is used for resources acquired in intent modes
     // modes and potentially other modes that don't conflict with themselves. This avoids
     // contention on the regular LockHead in the lock manager.
-    struct Partition {
+    struct alignas(stdx::hardware_destructive_interference_size) Partition {
         PartitionedLockHead* find(ResourceId resId);
         PartitionedLockHead* findOrInsert(ResourceId resId);
-        typedef stdx::unordered_map<ResourceId, PartitionedLockHead*> Map;
+        typedef stdx::flat_hash_map<ResourceId, PartitionedLockHead*> Map;
         SimpleMutex mutex;
         Map data;
     };
@@ -165,10 +167,43 @@ private:
 
 
     /**
-     * Retrieves the Partition that a particular LockRequest should use for intent locking.
+     * Chooses the partition on which a new LockRequest should be granted, which is the one of the
+     * CPU the calling thread runs on, so that threads on the same CPU, and so the same NUMA node,
+     * share partitions.
+     */
+    unsigned _choosePartition(LockRequest* request) const;
+
+    /**
+     * Retrieves the Partition that a particular LockRequest uses for intent locking.
      */
     Partition* _getPartition(LockRequest* request) const;
 
+    /**
+     * Retrieves the FastIntentLockHead which grants intent locks on the particular resource, or
+     * null if intent locks on it are granted through partitions.
+     */
+    FastIntentLockHead* _getFastIntentLockHead(ResourceId resId) const;
+
+    /**
+     * Retrieves the FastIntentLockHead which is assigned to the particular database or collection,
+     * or null if there is none. There is no need to hold a lock when calling this function, but
+     * the result is only a hint, which FastIntentLockHead::tryGrant validates.
+     */
+    FastIntentLockHead* _findFastIntentLockHead(ResourceId resId) const;
+
+    /**
+     * Assigns a free FastIntentLockHead to 'lock', if it is a database or collection lock and one
+     * of the heads it may use is free. The head is assigned closed. MUST be called under the lock
+     * bucket's mutex.
+     */
+    void _assignFastIntentLockHead(LockHead* lock);
+
+    /**
+     * Gives back the closed FastIntentLockHead of 'lock', which no request holds. MUST be called
+     * under the lock bucket's mutex.
+     */
+    void _releaseFastIntentLockHead(LockHead* lock);
+
     /**
      * Prints the contents of a bucket to the log.
      */
@@ -213,7 +248,17 @@ private:
     static const unsigned _numLockBuckets;
     LockBucket* _lockBuckets;
 
-    static const unsigned _numPartitions;
+    // Sized by the number of CPUs when the lock manager is created.
+    const unsigned _numPartitions;
     Partition* _partitions;
+
+    // One for each of the global resources which nearly every operation locks in an intent mode.
+    static const unsigned _numFastIntentLockHeads;
+    FastIntentLockHead* _fastIntentLockHeads;
+
+    // Assigned to databases and collections while their LockHeads exist.
+    static const unsigned _numAssignableFastIntentLockHeads;
+    static const unsigned _numFastIntentLockHeadProbes;
+    FastIntentLockHead* _assignableFastIntentLockHeads;
 };
 }  // namespace mongo
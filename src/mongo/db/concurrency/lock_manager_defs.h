@@ -46,6 +46,7 @@ namespace mongo {
 
 class Locker;
 
+struct FastIntentLockHead;
 struct LockHead;
 struct PartitionedLockHead;
 
@@ -426,6 +427,32 @@ struct LockRequest {
     // Protected by LockHead bucket's mutex
     PartitionedLockHead* partitionedLock;
 
+    // Index of the partition on which this request was granted, if it was partitioned. It is
+    // chosen by the CPU the request was made on, which may change before the request is unlocked.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // No synchronization
+    unsigned partitionId;
+
+    // Pointer to the fast intent lock head which granted this request, or null if it was granted
+    // or queued on 'lock' instead. Such a request is counted by the fast intent lock head, or, once
+    // a conflicting request folded its grant into 'lock', by the granted counts of 'lock', but it
+    // is never on the granted list of 'lock'.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // No synchronization
+    FastIntentLockHead* fastIntentLock;
+
+    // The epoch of 'fastIntentLock' in which this request was granted. The grant is still counted
+    // by 'fastIntentLock' as long as its epoch has not changed.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // No synchronization
+    uint32_t fastIntentEpoch;
+
     // The linked list chain on which this request hangs off the owning lock head. The reason
     // intrusive linked list is used instead of the std::list class is to allow for entries to be
     // removed from the middle of the list in O(1) time, if they are known instead of having to
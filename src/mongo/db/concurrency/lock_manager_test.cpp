@@ -30,6 +30,8 @@
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/fail_point_service.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -952,4 +954,199 @@ TEST(LockManager, Fairness) {
     ASSERT(lockMgr.unlock(&requestIX1));
 }
 
+TEST(LockManager, FastIntentLocksFairness) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, 1);
+
+    // Start with intent locks, which the fast intent lock head grants
+    LockerImpl lockerIS;
+    LockRequestCombo requestIS(&lockerIS);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+
+    LockerImpl lockerIX;
+    LockRequestCombo requestIX(&lockerIX);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX, MODE_IX));
+
+    // Now a conflicting lock comes, which must wait for the intent locks granted so far
+    LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+
+    // Now, whoever comes next should be blocked
+    LockerImpl lockerIX1;
+    LockRequestCombo requestIX1(&lockerIX1);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestIX1, MODE_IX));
+
+    // Freeing the first two locks should grant the X lock
+    ASSERT(lockMgr.unlock(&requestIS));
+    ASSERT_EQ(0, requestX.numNotifies);
+    ASSERT(lockMgr.unlock(&requestIX));
+    ASSERT_EQ(LOCK_OK, requestX.lastResult);
+    ASSERT_EQ(1, requestX.numNotifies);
+    ASSERT_EQ(LOCK_INVALID, requestIX1.lastResult);
+    ASSERT_EQ(0, requestIX1.numNotifies);
+
+    ASSERT(lockMgr.unlock(&requestX));
+    ASSERT_EQ(LOCK_OK, requestIX1.lastResult);
+    ASSERT_EQ(1, requestIX1.numNotifies);
+
+    // Once nothing conflicts, intent locks are granted immediately again
+    LockerImpl lockerIS1;
+    LockRequestCombo requestIS1(&lockerIS1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS1, MODE_IS));
+
+    // Unlock all locks so we don't assert for leaked locks
+    ASSERT(lockMgr.unlock(&requestIX1));
+    ASSERT(lockMgr.unlock(&requestIS1));
+}
+
+TEST(LockManager, FastIntentLocksConvertAndDowngrade) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, 1);
+
+    LockerImpl locker1;
+    LockRequestCombo request1(&locker1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IX));
+
+    LockerImpl locker2;
+    LockRequestCombo request2(&locker2);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IS));
+
+    // Upgrade the IX lock to X, which must wait for the IS lock
+    ASSERT(LOCK_WAITING == lockMgr.convert(resId, &request1, MODE_X));
+    ASSERT(lockMgr.unlock(&request2));
+    ASSERT_EQ(LOCK_OK, request1.lastResult);
+    ASSERT_EQ(1, request1.numNotifies);
+    ASSERT(request1.mode == MODE_X);
+
+    // Intent locks wait for the X lock until it is downgraded
+    LockerImpl locker3;
+    LockRequestCombo request3(&locker3);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request3, MODE_IS));
+    lockMgr.downgrade(&request1, MODE_IX);
+    ASSERT_EQ(LOCK_OK, request3.lastResult);
+    ASSERT_EQ(1, request3.numNotifies);
+
+    ASSERT(!lockMgr.unlock(&request1));
+    ASSERT(lockMgr.unlock(&request1));
+    ASSERT(lockMgr.unlock(&request3));
+
+    // Converting between intent modes keeps the lock available to other intent locks
+    LockerImpl locker4;
+    LockRequestCombo request4(&locker4);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request4, MODE_IS));
+    ASSERT(LOCK_OK == lockMgr.convert(resId, &request4, MODE_IX));
+
+    LockerImpl locker5;
+    LockRequestCombo request5(&locker5);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request5, MODE_IS));
+
+    ASSERT(!lockMgr.unlock(&request4));
+    ASSERT(lockMgr.unlock(&request4));
+    ASSERT(lockMgr.unlock(&request5));
+}
+
+TEST(LockManager, FastIntentLocksOnCollections) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    // The first intent lock assigns a fast intent lock head to the collection
+    LockerImpl lockerIX;
+    LockRequestCombo requestIX(&lockerIX);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX, MODE_IX));
+
+    LockerImpl lockerIS;
+    LockRequestCombo requestIS(&lockerIS);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+
+    // A DDL-style X lock waits for the intent locks granted so far, and blocks the ones after it
+    LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+
+    LockerImpl lockerIX1;
+    LockRequestCombo requestIX1(&lockerIX1);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestIX1, MODE_IX));
+
+    ASSERT(lockMgr.unlock(&requestIX));
+    ASSERT_EQ(0, requestX.numNotifies);
+    ASSERT(lockMgr.unlock(&requestIS));
+    ASSERT_EQ(LOCK_OK, requestX.lastResult);
+    ASSERT_EQ(1, requestX.numNotifies);
+    ASSERT_EQ(0, requestIX1.numNotifies);
+
+    ASSERT(lockMgr.unlock(&requestX));
+    ASSERT_EQ(LOCK_OK, requestIX1.lastResult);
+    ASSERT_EQ(1, requestIX1.numNotifies);
+
+    // Cleaning up an unused collection lock gives back its fast intent lock head, and cleaning up a
+    // used one keeps it
+    LockerImpl lockerIS1;
+    LockRequestCombo requestIS1(&lockerIS1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS1, MODE_IS));
+    lockMgr.cleanupUnusedLocks();
+
+    LockerImpl lockerS;
+    LockRequestCombo requestS(&lockerS);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestS, MODE_S));
+    ASSERT(lockMgr.unlock(&requestIX1));
+    ASSERT_EQ(LOCK_OK, requestS.lastResult);
+    ASSERT(lockMgr.unlock(&requestS));
+    ASSERT(lockMgr.unlock(&requestIS1));
+    lockMgr.cleanupUnusedLocks();
+
+    LockerImpl lockerIX2;
+    LockRequestCombo requestIX2(&lockerIX2);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX2, MODE_IX));
+    ASSERT(lockMgr.unlock(&requestIX2));
+}
+
+TEST(LockManager, PartitionedLocksUnlockedOnAnotherCPU) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_METADATA, std::string("TestDB.collection"));
+    FailPoint* forcedCPU =
+        getGlobalFailPointRegistry()->getFailPoint("lockManagerChoosePartitionForCPU");
+    ON_BLOCK_EXIT([&] { forcedCPU->setMode(FailPoint::off); });
+
+    // Intent locks are granted on the partition of the CPU they are made on, and are unlocked from
+    // that partition after the thread moved to another CPU
+    forcedCPU->setMode(FailPoint::alwaysOn, 0, BSON("cpu" << 1));
+    LockerImpl lockerIS;
+    LockRequestCombo requestIS(&lockerIS);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+    ASSERT(requestIS.partitioned);
+    ASSERT(requestIS.partitionedLock);
+    ASSERT_EQ(1U, requestIS.partitionId);
+
+    forcedCPU->setMode(FailPoint::alwaysOn, 0, BSON("cpu" << 2));
+    ASSERT(lockMgr.unlock(&requestIS));
+
+    // Nothing is left granted, so an exclusive lock is granted at once
+    LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestX, MODE_X));
+    ASSERT(lockMgr.unlock(&requestX));
+
+    // A request migrated from its partition to the lock head by a conflicting request is found
+    // there once the thread moved to another CPU
+    forcedCPU->setMode(FailPoint::alwaysOn, 0, BSON("cpu" << 1));
+    LockerImpl lockerIX;
+    LockRequestCombo requestIX(&lockerIX);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX, MODE_IX));
+    ASSERT_EQ(1U, requestIX.partitionId);
+
+    LockerImpl lockerX1;
+    LockRequestCombo requestX1(&lockerX1);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX1, MODE_X));
+    ASSERT(!requestIX.partitionedLock);
+
+    forcedCPU->setMode(FailPoint::alwaysOn, 0, BSON("cpu" << 2));
+    ASSERT(lockMgr.unlock(&requestIX));
+    ASSERT_EQ(LOCK_OK, requestX1.lastResult);
+    ASSERT_EQ(1, requestX1.numNotifies);
+    ASSERT(lockMgr.unlock(&requestX1));
+
+    lockMgr.cleanupUnusedLocks();
+}
+
 }  // namespace mongo
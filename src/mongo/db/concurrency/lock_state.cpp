@@ -35,8 +35,11 @@
 
 #include <vector>
 
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/flow_control_ticketholder.h"
+#include "mongo/db/concurrency/lock_state_gen.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_wait_stats.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/flow_control.h"
 #include "mongo/platform/compiler.h"
@@ -128,6 +131,12 @@ AtomicWord<unsigned long long> idCounter(0);
 // indexed by LockerId in order to minimize concurrent access conflicts.
 PartitionedInstanceWideLockStats globalStats;
 
+// Tracks the lock waits sampled by the Locker instances per resource.
+ResourceWaitStats resourceWaitStats;
+
+// The number of lockers which are blocked waiting for a ticket or for a lock to be granted.
+AtomicWord<long long> numWaiting(0);
+
 }  // namespace
 
 bool LockerImpl::_shouldDelayUnlock(ResourceId resId, LockMode mode) const {
@@ -251,6 +260,9 @@ void CondVarLockGrantNotification::notify(ResourceId resId, LockResult result) {
 
 namespace {
 TicketHolder* ticketHolders[LockModesCount] = {};
+
+// Lockers which acquired this many tickets wait for the next one as long operations.
+const int kLongOperationTicketsAcquired = 4;
 }  // namespace
 
 
@@ -265,6 +277,11 @@ void Locker::setGlobalThrottling(class TicketHolder* reading, class TicketHolder
     ticketHolders[MODE_IX] = writing;
 }
 
+/* static */
+long long Locker::getNumWaiting() {
+    return numWaiting.load();
+}
+
 LockerImpl::LockerImpl()
     : _id(idCounter.addAndFetch(1)), _wuowNestingLevel(0), _threadId(stdx::this_thread::get_id()) {}
 
@@ -344,18 +361,37 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
         // If the ticket wait is interrupted, restore the state of the client.
         auto restoreStateOnErrorGuard = makeGuard([&] { _clientState.store(kInactive); });
 
+        numWaiting.fetchAndAdd(1);
+        ON_BLOCK_EXIT([] { numWaiting.fetchAndSubtract(1); });
+
         OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
+        const auto operationClass = _ticketOperationClass(opCtx);
+        OperationWaitStats::ScopedWait ticketWait(opCtx, OperationWaitStats::WaitState::kTicket);
         if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+            holder->waitForTicket(interruptible, operationClass);
+        } else if (!holder->waitForTicketUntil(interruptible, deadline, operationClass)) {
             return false;
         }
         restoreStateOnErrorGuard.dismiss();
+        _numTicketsAcquired++;
     }
     _clientState.store(reader ? kActiveReader : kActiveWriter);
     return true;
 }
 
+TicketHolder::OperationClass LockerImpl::_ticketOperationClass(OperationContext* opCtx) const {
+    if (isAdminOperation()) {
+        return TicketHolder::OperationClass::kAdmin;
+    }
+    if (!opCtx || !opCtx->getClient() || !opCtx->getClient()->isFromUserConnection()) {
+        return TicketHolder::OperationClass::kInternal;
+    }
+    if (_numTicketsAcquired >= kLongOperationTicketsAcquired) {
+        return TicketHolder::OperationClass::kLong;
+    }
+    return TicketHolder::OperationClass::kShort;
+}
+
 LockResult LockerImpl::_lockGlobalBegin(OperationContext* opCtx, LockMode mode, Date_t deadline) {
     dassert(isLocked() == (_modeForTicket != MODE_NONE));
     if (_modeForTicket == MODE_NONE) {
@@ -930,6 +966,19 @@ void LockerImpl::lockComplete(OperationContext* opCtx,
     const uint64_t startOfTotalWaitTime = curTimeMicros64();
     uint64_t startOfCurrentWaitTime = startOfTotalWaitTime;
 
+    numWaiting.fetchAndAdd(1);
+    ON_BLOCK_EXIT([] { numWaiting.fetchAndSubtract(1); });
+
+    // Sample the whole wait, whether the lock is granted or not.
+    const int sampleRate = gLockWaitSampleRate.load();
+    const bool sampled = sampleRate > 0 && _numLockWaits++ % sampleRate == 0;
+    ON_BLOCK_EXIT([&] {
+        if (sampled) {
+            resourceWaitStats.recordWait(
+                resId, static_cast<int64_t>(curTimeMicros64() - startOfTotalWaitTime));
+        }
+    });
+
     while (true) {
         // It is OK if this call wakes up spuriously, because we re-evaluate the remaining
         // wait time anyways.
@@ -1073,8 +1122,14 @@ void reportGlobalLockingStats(SingleThreadedLockStats* outStats) {
     globalStats.report(outStats);
 }
 
+void reportResourceWaitStats(BSONObjBuilder* builder, size_t maxResources) {
+    builder->append("sampleRate", gLockWaitSampleRate.load());
+    resourceWaitStats.report(builder, maxResources);
+}
+
 void resetGlobalLockStats() {
     globalStats.reset();
+    resourceWaitStats.reset();
 }
 
 // Hardcoded resource IDs.
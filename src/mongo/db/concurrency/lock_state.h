@@ -36,6 +36,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/concurrency/ticketholder.h"
 
 namespace mongo {
 
@@ -321,6 +322,11 @@ private:
      */
     bool _acquireTicket(OperationContext* opCtx, LockMode mode, Date_t deadline);
 
+    /**
+     * Returns the operation class in which the Locker waits for its next ticket.
+     */
+    TicketHolder::OperationClass _ticketOperationClass(OperationContext* opCtx) const;
+
     // Used to disambiguate different lockers
     const LockerId _id;
 
@@ -350,6 +356,14 @@ private:
     // Mode for which the Locker acquired a ticket, or MODE_NONE if no ticket was acquired.
     LockMode _modeForTicket = MODE_NONE;
 
+    // Number of tickets the Locker acquired so far. Operations which have yielded their ticket
+    // several times wait for the next one as long operations.
+    int _numTicketsAcquired = 0;
+
+    // Number of lock waits of the Locker, of which every 'lockWaitSampleRate'-th is recorded per
+    // resource.
+    long long _numLockWaits = 0;
+
     // Indicates whether the client is active reader/writer or is queued.
     AtomicWord<ClientState> _clientState{kInactive};
 
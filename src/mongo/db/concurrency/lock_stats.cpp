@@ -31,6 +31,10 @@
 
 #include "mongo/db/concurrency/lock_stats.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "mongo/bson/bsonobjbuilder.h"
 
 namespace mongo {
@@ -131,6 +135,111 @@ void LockStats<CounterType>::reset() {
 }
 
 
+const int64_t ResourceWaitStats::kHistogramBucketBounds[kNumHistogramBuckets - 1] = {
+    100, 1000, 10 * 1000, 100 * 1000, 1000 * 1000};
+
+namespace {
+
+const char* const kHistogramBucketNames[ResourceWaitStats::kNumHistogramBuckets] = {
+    "lt100us", "lt1ms", "lt10ms", "lt100ms", "lt1s", "ge1s"};
+
+/**
+ * Rebuilds the ResourceId whose full hash is 'fullHash'. The top three bits of the full hash hold
+ * the resource type, and the constructor drops them from the hash id.
+ */
+ResourceId resourceIdFromFullHash(uint64_t fullHash) {
+    return ResourceId(static_cast<ResourceType>(fullHash >> 61), fullHash);
+}
+
+}  // namespace
+
+ResourceWaitStats::ResourceWaitStats() {
+    reset();
+}
+
+void ResourceWaitStats::recordWait(ResourceId resId, int64_t waitMicros) {
+    const uint64_t hash = resId;
+    const size_t first = static_cast<size_t>(hash ^ (hash >> 32));
+    for (size_t i = 0; i < kNumProbes; i++) {
+        Entry& entry = _entries[(first + i) & (kNumEntries - 1)];
+
+        unsigned long long entryResId = entry.resId.load();
+        if (entryResId == 0) {
+            // Claim the unused entry, unless another resource has just done so.
+            if (!entry.resId.compareAndSwap(&entryResId, hash) && entryResId != hash) {
+                continue;
+            }
+        } else if (entryResId != hash) {
+            continue;
+        }
+
+        int bucket = 0;
+        while (bucket < kNumHistogramBuckets - 1 && waitMicros >= kHistogramBucketBounds[bucket]) {
+            bucket++;
+        }
+
+        entry.numWaits.fetchAndAddRelaxed(1);
+        entry.combinedWaitTimeMicros.fetchAndAddRelaxed(waitMicros);
+        entry.histogram[bucket].fetchAndAddRelaxed(1);
+        return;
+    }
+
+    _numUntracked.fetchAndAddRelaxed(1);
+}
+
+void ResourceWaitStats::report(BSONObjBuilder* builder, size_t maxResources) const {
+    // Order by the wait times as they are now, since they keep changing while they are sorted.
+    std::vector<std::pair<long long, const Entry*>> used;
+    for (size_t i = 0; i < kNumEntries; i++) {
+        if (_entries[i].resId.load() != 0 && _entries[i].numWaits.load() > 0) {
+            used.emplace_back(_entries[i].combinedWaitTimeMicros.load(), &_entries[i]);
+        }
+    }
+
+    // Only the entries which are reported need to be in order.
+    const size_t numReported = std::min(maxResources, used.size());
+    std::partial_sort(used.begin(),
+                      used.begin() + numReported,
+                      used.end(),
+                      [](const std::pair<long long, const Entry*>& lhs,
+                         const std::pair<long long, const Entry*>& rhs) {
+                          return lhs.first > rhs.first;
+                      });
+
+    builder->append("numResources", static_cast<long long>(used.size()));
+    builder->append("numUntrackedWaits", _numUntracked.load());
+
+    BSONArrayBuilder resources(builder->subarrayStart("resources"));
+    for (size_t i = 0; i < numReported; i++) {
+        const Entry* entry = used[i].second;
+
+        BSONObjBuilder resource(resources.subobjStart());
+        resource.append("resource", resourceIdFromFullHash(entry->resId.load()).toString());
+        resource.append("waits", entry->numWaits.load());
+        resource.append("timeAcquiringMicros", entry->combinedWaitTimeMicros.load());
+
+        BSONObjBuilder histogram(resource.subobjStart("histogram"));
+        for (int bucket = 0; bucket < kNumHistogramBuckets; bucket++) {
+            histogram.append(kHistogramBucketNames[bucket], entry->histogram[bucket].load());
+        }
+    }
+}
+
+void ResourceWaitStats::reset() {
+    for (size_t i = 0; i < kNumEntries; i++) {
+        Entry& entry = _entries[i];
+        entry.resId.store(0);
+        entry.numWaits.store(0);
+        entry.combinedWaitTimeMicros.store(0);
+        for (int bucket = 0; bucket < kNumHistogramBuckets; bucket++) {
+            entry.histogram[bucket].store(0);
+        }
+    }
+
+    _numUntracked.store(0);
+}
+
+
 // Ensures that there are instances compiled for LockStats for AtomicWord<long long> and int64_t
 template class LockStats<int64_t>;
 template class LockStats<AtomicWord<long long>>;
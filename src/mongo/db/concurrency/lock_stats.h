@@ -216,11 +216,67 @@ typedef LockStats<int64_t> SingleThreadedLockStats;
 typedef LockStats<AtomicWord<long long>> AtomicLockStats;
 
 
+/**
+ * Tracks the waits for locks on individual resources, so that the resources whose locks are
+ * waited for the longest can be found. Each resource gets an entry in a fixed table the first
+ * time a wait for it is recorded, which it keeps until reset. Waits for resources which find no
+ * free entry are only counted.
+ *
+ * All operations are lock-free, so that the waits can be recorded from any thread.
+ */
+class ResourceWaitStats {
+    ResourceWaitStats(const ResourceWaitStats&) = delete;
+    ResourceWaitStats& operator=(const ResourceWaitStats&) = delete;
+
+public:
+    // The upper bounds, in microseconds, of the buckets of the wait time histogram. The last
+    // bucket counts the longer waits.
+    static constexpr int kNumHistogramBuckets = 6;
+    static const int64_t kHistogramBucketBounds[kNumHistogramBuckets - 1];
+
+    ResourceWaitStats();
+
+    void recordWait(ResourceId resId, int64_t waitMicros);
+
+    /**
+     * Appends the 'maxResources' resources with the largest combined wait time, from the largest
+     * down, to 'builder'.
+     */
+    void report(BSONObjBuilder* builder, size_t maxResources) const;
+
+    void reset();
+
+private:
+    // Must be a power of two.
+    static constexpr size_t kNumEntries = 1024;
+
+    // A resource can use any of this many consecutive entries, starting at its hash.
+    static constexpr size_t kNumProbes = 8;
+
+    struct Entry {
+        // The full hash of the resource, or 0 while the entry is unused.
+        AtomicWord<unsigned long long> resId;
+        AtomicWord<long long> numWaits;
+        AtomicWord<long long> combinedWaitTimeMicros;
+        AtomicWord<long long> histogram[kNumHistogramBuckets];
+    };
+
+    Entry _entries[kNumEntries];
+    AtomicWord<long long> _numUntracked;
+};
+
+
 /**
  * Reports instance-wide locking statistics, which can then be converted to BSON or logged.
  */
 void reportGlobalLockingStats(SingleThreadedLockStats* outStats);
 
+/**
+ * Reports the resources whose locks were waited for the longest, as sampled by the Locker
+ * instances according to 'lockWaitSampleRate'.
+ */
+void reportResourceWaitStats(BSONObjBuilder* builder, size_t maxResources);
+
 /**
  * Currently used for testing only.
  */
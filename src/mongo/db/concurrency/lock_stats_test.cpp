@@ -146,6 +146,71 @@ TEST_F(LockStatsTest, Subtraction) {
     ASSERT_GREATER_THAN(stats2.get(resId, MODE_S).combinedWaitTimeMicros, 0);
 }
 
+TEST_F(LockStatsTest, ResourceWaits) {
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.ResourceWaits"));
+
+    resetGlobalLockStats();
+
+    LockerForTests locker(MODE_IX);
+    locker.lock(resId, MODE_X);
+
+    for (int i = 0; i < 2; i++) {
+        LockerForTests lockerConflict(MODE_IX);
+        ASSERT_THROWS_CODE(lockerConflict.lock(resId, MODE_S, Date_t::now() + Milliseconds(5)),
+                           AssertionException,
+                           ErrorCodes::LockTimeout);
+    }
+
+    BSONObjBuilder builder;
+    reportResourceWaitStats(&builder, 10);
+    const BSONObj waits = builder.obj();
+    ASSERT_EQUALS(1, waits["numResources"].numberLong());
+
+    const BSONObj resource = waits["resources"].Array()[0].Obj();
+    ASSERT_EQUALS(resId.toString(), resource["resource"].String());
+    ASSERT_EQUALS(2, resource["waits"].numberLong());
+    ASSERT_GREATER_THAN_OR_EQUALS(resource["timeAcquiringMicros"].numberLong(), 10 * 1000);
+
+    // Both waits took at least 5 milliseconds.
+    const BSONObj histogram = resource["histogram"].Obj();
+    ASSERT_EQUALS(0, histogram["lt1ms"].numberLong());
+    ASSERT_EQUALS(2,
+                  histogram["lt10ms"].numberLong() + histogram["lt100ms"].numberLong() +
+                      histogram["lt1s"].numberLong() + histogram["ge1s"].numberLong());
+}
+
+TEST(ResourceWaitStats, ReportsLongestWaitsFirst) {
+    ResourceWaitStats stats;
+
+    const ResourceId resIdA(RESOURCE_COLLECTION, std::string("ResourceWaitStats.A"));
+    const ResourceId resIdB(RESOURCE_COLLECTION, std::string("ResourceWaitStats.B"));
+    const ResourceId resIdC(RESOURCE_DATABASE, std::string("ResourceWaitStats"));
+    stats.recordWait(resIdA, 50);
+    stats.recordWait(resIdB, 5000);
+    stats.recordWait(resIdB, 2 * 1000 * 1000);
+    stats.recordWait(resIdC, 20 * 1000);
+
+    BSONObjBuilder builder;
+    stats.report(&builder, 2);
+    const BSONObj report = builder.obj();
+    ASSERT_EQUALS(3, report["numResources"].numberLong());
+    ASSERT_EQUALS(0, report["numUntrackedWaits"].numberLong());
+
+    const std::vector<BSONElement> resources = report["resources"].Array();
+    ASSERT_EQUALS(2U, resources.size());
+    ASSERT_EQUALS(resIdB.toString(), resources[0].Obj()["resource"].String());
+    ASSERT_EQUALS(2, resources[0].Obj()["waits"].numberLong());
+    ASSERT_EQUALS(1, resources[0].Obj()["histogram"].Obj()["lt10ms"].numberLong());
+    ASSERT_EQUALS(1, resources[0].Obj()["histogram"].Obj()["ge1s"].numberLong());
+    ASSERT_EQUALS(resIdC.toString(), resources[1].Obj()["resource"].String());
+    ASSERT_EQUALS(1, resources[1].Obj()["histogram"].Obj()["lt100ms"].numberLong());
+
+    stats.reset();
+    BSONObjBuilder builderAfterReset;
+    stats.report(&builderAfterReset, 2);
+    ASSERT_EQUALS(0, builderAfterReset.obj()["numResources"].numberLong());
+}
+
 namespace {
 /**
  * Locks 'rid' and then checks the global lock stat is reported correctly. Either the global lock is
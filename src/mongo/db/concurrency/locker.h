@@ -76,6 +76,13 @@ public:
      */
     static void setGlobalThrottling(class TicketHolder* reading, class TicketHolder* writing);
 
+    /**
+     * Returns the number of lockers, across all clients, which are currently blocked either waiting
+     * for a global lock ticket or waiting for a lock to be granted. It is only maintained on the
+     * paths which block, so reading it is cheap and it can serve as a signal of contention.
+     */
+    static long long getNumWaiting();
+
     /**
      * State for reporting the number of active and queued reader and writer clients.
      */
@@ -510,6 +517,17 @@ public:
         return _shouldAcquireTicket;
     }
 
+    /**
+     * Marks this as the locker of an administrative command, which waits for tickets in its own
+     * operation class when the ticket holders queue fairly.
+     */
+    void setAdminOperation(bool newValue) {
+        _isAdminOperation = newValue;
+    }
+    bool isAdminOperation() const {
+        return _isAdminOperation;
+    }
+
     /**
      * Acquire a flow control admission ticket into the system. Flow control is used as a
      * backpressure mechanism to limit replication majority point lag.
@@ -558,6 +576,7 @@ protected:
 private:
     bool _shouldConflictWithSecondaryBatchApplication = true;
     bool _shouldAcquireTicket = true;
+    bool _isAdminOperation = false;
     std::string _debugInfo;  // Extra info about this locker for debugging purpose
 };
 
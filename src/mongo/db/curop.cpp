@@ -45,8 +45,10 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/json.h"
+#include "mongo/db/operation_wait_stats.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_memory_tracker.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/rpc/metadata/impersonated_user_metadata.h"
@@ -292,6 +294,15 @@ void CurOp::reportCurrentOpForClient(OperationContext* opCtx,
             lsid->serialize(&lsidBuilder);
         }
 
+        BSONObj waitStats = OperationWaitStats::get(clientOpCtx).toBSON();
+        if (!waitStats.isEmpty()) {
+            infoBuilder->append("waits", waitStats);
+        }
+
+        if (auto memoryTracker = QueryMemoryTracker::getIfExists_inlock(clientOpCtx)) {
+            memoryTracker->append(infoBuilder);
+        }
+
         CurOp::get(clientOpCtx)->reportState(infoBuilder, truncateOps);
     }
 }
@@ -398,6 +409,7 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
 
     // Obtain the total execution time of this operation.
     _end = curTimeMicros64();
+    _debug.waitStats = OperationWaitStats::get(opCtx).toBSON();
     _debug.executionTimeMicros = durationCount<Microseconds>(elapsedTimeExcludingPauses());
 
     const bool shouldSample =
@@ -721,6 +733,10 @@ string OpDebug::report(Client* client,
         s << " storage:" << storageStats->toBSON().toString();
     }
 
+    if (!waitStats.isEmpty()) {
+        s << " waits:" << waitStats.toString();
+    }
+
     if (iscommand) {
         s << " protocol:" << getProtoString(networkOp);
     }
@@ -810,6 +826,10 @@ void OpDebug::append(const CurOp& curop,
         b.append("storage", storageStats->toBSON());
     }
 
+    if (!waitStats.isEmpty()) {
+        b.append("waits", waitStats);
+    }
+
     if (!errInfo.isOK()) {
         b.appendNumber("ok", 0.0);
         if (!errInfo.reason().empty()) {
@@ -234,6 +234,9 @@ public:
     // Stores storage statistics.
     std::shared_ptr<StorageStats> storageStats;
 
+    // Time spent in each wait state, see OperationWaitStats.
+    BSONObj waitStats;
+
     bool waitingForFlowControl{false};
 };
 
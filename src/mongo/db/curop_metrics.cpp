@@ -36,28 +36,29 @@
 
 namespace mongo {
 namespace {
-Counter64 returnedCounter;
-Counter64 insertedCounter;
-Counter64 updatedCounter;
-Counter64 deletedCounter;
-Counter64 scannedCounter;
-Counter64 scannedObjectCounter;
+ShardedCounter64 returnedCounter;
+ShardedCounter64 insertedCounter;
+ShardedCounter64 updatedCounter;
+ShardedCounter64 deletedCounter;
+ShardedCounter64 scannedCounter;
+ShardedCounter64 scannedObjectCounter;
 
-ServerStatusMetricField<Counter64> displayReturned("document.returned", &returnedCounter);
-ServerStatusMetricField<Counter64> displayUpdated("document.updated", &updatedCounter);
-ServerStatusMetricField<Counter64> displayInserted("document.inserted", &insertedCounter);
-ServerStatusMetricField<Counter64> displayDeleted("document.deleted", &deletedCounter);
-ServerStatusMetricField<Counter64> displayScanned("queryExecutor.scanned", &scannedCounter);
-ServerStatusMetricField<Counter64> displayScannedObjects("queryExecutor.scannedObjects",
-                                                         &scannedObjectCounter);
+ServerStatusMetricField<ShardedCounter64> displayReturned("document.returned", &returnedCounter);
+ServerStatusMetricField<ShardedCounter64> displayUpdated("document.updated", &updatedCounter);
+ServerStatusMetricField<ShardedCounter64> displayInserted("document.inserted", &insertedCounter);
+ServerStatusMetricField<ShardedCounter64> displayDeleted("document.deleted", &deletedCounter);
+ServerStatusMetricField<ShardedCounter64> displayScanned("queryExecutor.scanned",
+                                                         &scannedCounter);
+ServerStatusMetricField<ShardedCounter64> displayScannedObjects("queryExecutor.scannedObjects",
+                                                                &scannedObjectCounter);
 
-Counter64 scanAndOrderCounter;
-Counter64 writeConflictsCounter;
+ShardedCounter64 scanAndOrderCounter;
+ShardedCounter64 writeConflictsCounter;
 
-ServerStatusMetricField<Counter64> displayScanAndOrder("operation.scanAndOrder",
-                                                       &scanAndOrderCounter);
-ServerStatusMetricField<Counter64> displayWriteConflicts("operation.writeConflicts",
-                                                         &writeConflictsCounter);
+ServerStatusMetricField<ShardedCounter64> displayScanAndOrder("operation.scanAndOrder",
+                                                              &scanAndOrderCounter);
+ServerStatusMetricField<ShardedCounter64> displayWriteConflicts("operation.writeConflicts",
+                                                                &writeConflictsCounter);
 
 }  // namespace
 
@@ -39,7 +39,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/session_killer.h"
-#include "mongo/stdx/unordered_map.h"
+#include "mongo/stdx/flat_hash_map.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/duration.h"
@@ -183,7 +183,7 @@ private:
 
     void deregisterCursor(ClientCursor* cursor);
     void deregisterAndDestroyCursor(
-        Partitioned<stdx::unordered_map<CursorId, ClientCursor*>, kNumPartitions>::OnePartition&&,
+        Partitioned<stdx::flat_hash_map<CursorId, ClientCursor*>, kNumPartitions>::OnePartition&&,
         OperationContext* opCtx,
         std::unique_ptr<ClientCursor, ClientCursor::Deleter> cursor);
 
@@ -209,7 +209,7 @@ private:
     // mutexes for all partitions.
     mutable SimpleMutex _registrationLock;
     std::unique_ptr<PseudoRandom> _random;
-    std::unique_ptr<Partitioned<stdx::unordered_map<CursorId, ClientCursor*>, kNumPartitions>>
+    std::unique_ptr<Partitioned<stdx::flat_hash_map<CursorId, ClientCursor*>, kNumPartitions>>
         _cursorMap;
 };
 }  // namespace mongo
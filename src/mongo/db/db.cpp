@@ -1000,6 +1000,7 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
     stopMongoDFTDC();
 
     HealthLog::get(serviceContext).shutdown();
+    shutdownAsyncProfileWriters(serviceContext);
 
     // We should always be able to acquire the global lock at shutdown.
     //
@@ -75,6 +75,15 @@ void AndHashStage::addChild(PlanStage* child) {
     _children.emplace_back(child);
 }
 
+void AndHashStage::setRecordIdsOnly() {
+    invariant(_lookAheadResults.empty());
+    _recordIdsOnly = true;
+}
+
+size_t AndHashStage::numCandidates() const {
+    return _recordIdsOnly ? _candidates.size() : _dataMap.size();
+}
+
 size_t AndHashStage::getMemUsage() const {
     return _memUsage;
 }
@@ -93,7 +102,7 @@ bool AndHashStage::isEOF() {
     // Or we're streaming in results from the last child.
 
     // If there's nothing to probe against, we're EOF.
-    if (_dataMap.empty()) {
+    if (numCandidates() == 0) {
         return true;
     }
 
@@ -173,6 +182,15 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
             return PlanStage::FAILURE;
         }
 
+        // The hash table cannot spill, so the stage fails if its operation is the one to give up
+        // memory when all queries together use more than their budget.
+        _trackedMemUsage.set(getOpCtx(), _memUsage);
+        Status budgetStatus = _trackedMemUsage.checkBudget();
+        if (!budgetStatus.isOK()) {
+            *out = WorkingSetCommon::allocateStatusMember(_ws, budgetStatus);
+            return PlanStage::FAILURE;
+        }
+
         if (0 == _currentChild) {
             return readFirstChild(out);
         } else if (_currentChild < _children.size() - 1) {
@@ -189,7 +207,7 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
     // hash map.
 
     // We should be EOF if we're not hashing results and the dataMap is empty.
-    verify(!_dataMap.empty());
+    verify(numCandidates() != 0);
 
     // We probe _dataMap with the last child.
     verify(_currentChild == _children.size() - 1);
@@ -208,6 +226,15 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
     // with no record id.
     invariant(member->hasRecordId());
 
+    if (_recordIdsOnly) {
+        // Removing the record id ensures we output it only once.
+        if (!_candidates.remove(member->recordId)) {
+            _ws->free(*out);
+            return PlanStage::NEED_TIME;
+        }
+        return PlanStage::ADVANCED;
+    }
+
     DataMap::iterator it = _dataMap.find(member->recordId);
     if (_dataMap.end() == it) {
         // Child's output wasn't in every previous child.  Throw it out.
@@ -251,6 +278,13 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
         // with no record id.
         invariant(member->hasRecordId());
 
+        if (_recordIdsOnly) {
+            _candidates.add(member->recordId);
+            _ws->free(id);
+            _memUsage = _candidates.getMemUsage();
+            return PlanStage::NEED_TIME;
+        }
+
         if (!_dataMap.insert(std::make_pair(member->recordId, id)).second) {
             // Didn't insert because we already had this RecordId inside the map. This should only
             // happen if we're seeing a newer copy of the same doc in a more recent snapshot.
@@ -271,12 +305,12 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
         _currentChild = 1;
 
         // If our first child was empty, don't scan any others, no possible results.
-        if (_dataMap.empty()) {
+        if (numCandidates() == 0) {
             _hashingChildren = false;
             return PlanStage::IS_EOF;
         }
 
-        _specificStats.mapAfterChild.push_back(_dataMap.size());
+        _specificStats.mapAfterChild.push_back(numCandidates());
 
         return PlanStage::NEED_TIME;
     } else if (PlanStage::FAILURE == childStatus) {
@@ -308,7 +342,12 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
         // WSM with no record id.
         invariant(member->hasRecordId());
 
-        if (_dataMap.end() == _dataMap.find(member->recordId)) {
+        if (_recordIdsOnly) {
+            if (_candidates.contains(member->recordId)) {
+                _seenCandidates.add(member->recordId);
+                _memUsage = _candidates.getMemUsage() + _seenCandidates.getMemUsage();
+            }
+        } else if (_dataMap.end() == _dataMap.find(member->recordId)) {
             // Ignore.  It's not in any previous child.
         } else {
             // We have a hit.  Copy data into the WSM we already have.
@@ -328,6 +367,13 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
         // Finished with a child.
         ++_currentChild;
 
+        // The candidates which this child has seen are the intersection so far.
+        if (_recordIdsOnly) {
+            std::swap(_candidates, _seenCandidates);
+            _seenCandidates.clear();
+            _memUsage = _candidates.getMemUsage();
+        }
+
         // Keep elements of _dataMap that are in _seenMap.
         DataMap::iterator it = _dataMap.begin();
         while (it != _dataMap.end()) {
@@ -346,14 +392,14 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
             }
         }
 
-        _specificStats.mapAfterChild.push_back(_dataMap.size());
+        _specificStats.mapAfterChild.push_back(numCandidates());
 
         _seenMap.clear();
 
         // _dataMap is now the intersection of the first _currentChild nodes.
 
         // If we have nothing to AND with after finishing any child, stop.
-        if (_dataMap.empty()) {
+        if (numCandidates() == 0) {
             _hashingChildren = false;
             return PlanStage::IS_EOF;
         }
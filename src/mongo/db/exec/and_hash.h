@@ -32,11 +32,13 @@
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_bitmap.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
+#include "mongo/db/query/query_memory_tracker.h"
 #include "mongo/db/record_id.h"
-#include "mongo/stdx/unordered_map.h"
-#include "mongo/stdx/unordered_set.h"
+#include "mongo/stdx/flat_hash_map.h"
+#include "mongo/stdx/flat_hash_set.h"
 
 namespace mongo {
 
@@ -44,6 +46,10 @@ namespace mongo {
  * Reads from N children, each of which must have a valid RecordId. Uses a hash table to intersect
  * the outputs of the N children based on their record ids, and outputs the intersection.
  *
+ * If setRecordIdsOnly() is called, the stage instead keeps only the set of candidate record ids, in
+ * a RecordIdBitmap, which takes a small fraction of the memory of the hash table. Each result is
+ * then the working set member produced by the last child, without the index keys of the others.
+ *
  * Preconditions: Valid RecordId. More than one child.
  */
 class AndHashStage final : public PlanStage {
@@ -57,6 +63,13 @@ public:
 
     void addChild(PlanStage* child);
 
+    /**
+     * Intersects only the record ids of the children, rather than also merging the index keys of
+     * their results. Only suitable when the results are fetched, and so their index keys are not
+     * needed. Must be called before the first call to work().
+     */
+    void setRecordIdsOnly();
+
     /**
      * Returns memory usage.
      * For testing only.
@@ -83,6 +96,11 @@ private:
     StageState hashOtherChildren(WorkingSetID* out);
     StageState workChild(size_t childNo, WorkingSetID* out);
 
+    /**
+     * Returns the number of record ids which are in the intersection of the children read so far.
+     */
+    size_t numCandidates() const;
+
     // Not owned by us.
     WorkingSet* _ws;
 
@@ -93,14 +111,19 @@ private:
 
     // _dataMap is filled out by the first child and probed by subsequent children.  This is the
     // hash table that we create by intersecting _children and probe with the last child.
-    typedef stdx::unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
+    typedef stdx::flat_hash_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
     DataMap _dataMap;
 
     // Keeps track of what elements from _dataMap subsequent children have seen.
     // Only used while _hashingChildren.
-    typedef stdx::unordered_set<RecordId, RecordId::Hasher> SeenMap;
+    typedef stdx::flat_hash_set<RecordId, RecordId::Hasher> SeenMap;
     SeenMap _seenMap;
 
+    // Used instead of _dataMap and _seenMap if _recordIdsOnly is set.
+    bool _recordIdsOnly = false;
+    RecordIdBitmap _candidates;
+    RecordIdBitmap _seenCandidates;
+
     // True if we're still intersecting _children[0..._children.size()-1].
     bool _hashingChildren;
 
@@ -111,13 +134,16 @@ private:
     AndHashStats _specificStats;
 
     // The usage in bytes of all buffered data that we're holding.
-    // Memory usage is calculated from keys held in _dataMap only.
+    // Memory usage is calculated from keys held in _dataMap, or from the bitmaps, only.
     // For simplicity, results in _lookAheadResults do not count towards the limit.
     size_t _memUsage;
 
     // Upper limit for buffered data memory usage.
     // Defaults to 32 MB (See kMaxBytes in and_hash.cpp).
     size_t _maxMemUsage;
+
+    // Reports '_memUsage' to the operation's query memory accounting.
+    QueryMemoryTracker::StageUsage _trackedMemUsage;
 };
 
 }  // namespace mongo
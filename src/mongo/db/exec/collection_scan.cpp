@@ -41,6 +41,7 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -69,6 +70,10 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     _specificStats.maxTs = params.maxTs;
     invariant(!_params.shouldTrackLatestOplogTimestamp || collection->ns().isOplog());
 
+    if (_filter && internalQueryCompileMatchExpressions.load()) {
+        _compiledFilter = CompiledMatchExpression::compile(_filter);
+    }
+
     if (params.maxTs) {
         _endConditionBSON = BSON("$gte" << *(params.maxTs));
         _endCondition = std::make_unique<GTEMatchExpression>(repl::OpTime::kTimestampFieldName,
@@ -154,6 +159,57 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    return returnRecord(&*record, out);
+}
+
+PlanStage::StageState CollectionScan::doWorkBatch(size_t maxResults,
+                                                  std::vector<WorkingSetID>* out) {
+    // Creating the cursor, re-establishing a tailable cursor and the initial seek to
+    // '_params.start' are all left to the single-result path.
+    if (_commonStats.isEOF || !_cursor || (_lastSeenId.isNull() && !_params.start.isNull())) {
+        return PlanStage::doWorkBatch(maxResults, out);
+    }
+
+    // Records rejected by the filter count towards 'maxResults' along with the ones returned, so
+    // that a selective filter cannot stretch a batch out indefinitely between yield checks.
+    WorkingSetID unownedResult = WorkingSet::INVALID_ID;
+    for (size_t examined = 0; examined < maxResults; ++examined) {
+        if (unownedResult != WorkingSet::INVALID_ID) {
+            // Advancing the cursor invalidates any unowned BSON from the previous record.
+            _workingSet->get(unownedResult)->makeObjOwnedIfNeeded();
+            unownedResult = WorkingSet::INVALID_ID;
+        }
+
+        boost::optional<Record> record;
+        try {
+            record = _cursor->next();
+        } catch (const WriteConflictException&) {
+            return deferBatchState(PlanStage::NEED_YIELD, WorkingSet::INVALID_ID, out);
+        }
+
+        if (!record) {
+            if (_params.tailable && !_lastSeenId.isNull()) {
+                _cursor.reset();
+            } else {
+                _commonStats.isEOF = true;
+            }
+            return deferBatchState(PlanStage::IS_EOF, WorkingSet::INVALID_ID, out);
+        }
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState state = returnRecord(&*record, &id);
+        if (PlanStage::ADVANCED == state) {
+            out->push_back(id);
+            unownedResult = id;
+        } else if (PlanStage::NEED_TIME != state) {
+            return deferBatchState(state, id, out);
+        }
+    }
+
+    return out->empty() ? PlanStage::NEED_TIME : PlanStage::ADVANCED;
+}
+
+PlanStage::StageState CollectionScan::returnRecord(Record* record, WorkingSetID* out) {
     _lastSeenId = record->id;
     if (_params.shouldTrackLatestOplogTimestamp) {
         auto status = setLatestOplogEntryTimestamp(*record);
@@ -190,9 +246,12 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    const bool passes = _compiledFilter ? _compiledFilter->matchesBSON(member->obj.value())
+                                        : Filter::passes(member, _filter);
+    if (passes) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
@@ -30,9 +30,11 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/record_id.h"
 
@@ -60,6 +62,7 @@ public:
                    const MatchExpression* filter);
 
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxResults, std::vector<WorkingSetID>* out) final;
     bool isEOF() final;
 
     void doDetachFromOperationContext() final;
@@ -83,6 +86,12 @@ protected:
     void doRestoreStateRequiresCollection() final;
 
 private:
+    /**
+     * Allocates a working set member for 'record', which has just been read from '_cursor', and
+     * hands it to returnIfMatches().
+     */
+    StageState returnRecord(Record* record, WorkingSetID* out);
+
     /**
      * If the member (with id memberID) passes our filter, set *out to memberID and return that
      * ADVANCED.  Otherwise, free memberID and return NEED_TIME.
@@ -102,6 +111,10 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // Compiled from '_filter' if 'internalQueryCompileMatchExpressions' is enabled and the filter
+    // can be compiled.
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
     // If a document does not pass '_filter' but passes '_endCondition', stop scanning and return
     // IS_EOF.
     BSONObj _endConditionBSON;
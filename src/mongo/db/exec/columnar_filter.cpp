@@ -0,0 +1,340 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/columnar_filter.h"
+
+#include <cmath>
+#include <functional>
+#include <string>
+
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/exec/filter.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+// Every integer of at most this magnitude has an exact double representation.
+const long long kMaxExactDoubleInteger = 1LL << 53;
+
+// Describes the value a document holds at the path of a predicate.
+enum ColumnKind : uint8_t {
+    // Missing, or of a type which can never satisfy the predicates we evaluate.
+    kOther,
+    kNumber,
+    kDate,
+    kString,
+    // Needs to be tested by the regular matcher.
+    kFallback,
+};
+
+/**
+ * The values at one path across a batch. Rows whose kind does not match a column hold a zero value
+ * in it, so that every row of every column can be compared without branching.
+ */
+struct Column {
+    explicit Column(size_t size) : kinds(size, kOther), numbers(size), dates(size), strings(size) {}
+
+    std::vector<uint8_t> kinds;
+    std::vector<double> numbers;
+    std::vector<long long> dates;
+    std::vector<StringData> strings;
+};
+
+/**
+ * Returns the column kind which 'elt' would be stored as, or kFallback if the column cannot
+ * represent it exactly.
+ */
+ColumnKind kindOf(const BSONElement& elt) {
+    switch (elt.type()) {
+        case NumberInt:
+            return kNumber;
+        case NumberLong: {
+            const long long value = elt._numberLong();
+            return value >= -kMaxExactDoubleInteger && value <= kMaxExactDoubleInteger ? kNumber
+                                                                                       : kFallback;
+        }
+        case NumberDouble:
+            // NaN compares unlike any other double, so leave it to the matcher.
+            return std::isnan(elt._numberDouble()) ? kFallback : kNumber;
+        case Date:
+            return kDate;
+        case String:
+            return kString;
+        case NumberDecimal:
+        case Symbol:
+            // These share a canonical type with one of our columns but cannot be stored in it.
+        case Array:
+            return kFallback;
+        default:
+            return kOther;
+    }
+}
+
+void storeInColumn(const BSONElement& elt, size_t row, Column* column) {
+    const ColumnKind kind = kindOf(elt);
+    column->kinds[row] = kind;
+    switch (kind) {
+        case kNumber:
+            column->numbers[row] = elt.numberDouble();
+            break;
+        case kDate:
+            column->dates[row] = elt.date().toMillisSinceEpoch();
+            break;
+        case kString:
+            column->strings[row] = elt.valueStringData();
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Returns true if 'operand' can be the right hand side of a column-wise comparison performed by a
+ * predicate with the given collator.
+ */
+bool isColumnarOperand(const BSONElement& operand, const CollatorInterface* collator) {
+    switch (kindOf(operand)) {
+        case kNumber:
+        case kDate:
+            return true;
+        case kString:
+            return !collator;
+        default:
+            return false;
+    }
+}
+
+bool isColumnarLeaf(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE: {
+            auto cmp = static_cast<const ComparisonMatchExpressionBase*>(expr);
+            return !expr->path().empty() && isColumnarOperand(cmp->getData(), cmp->getCollator());
+        }
+        case MatchExpression::MATCH_IN: {
+            auto in = static_cast<const InMatchExpression*>(expr);
+            if (expr->path().empty() || in->hasNull() || !in->getRegexes().empty() ||
+                in->getEqualities().empty()) {
+                return false;
+            }
+            for (auto&& equality : in->getEqualities()) {
+                if (!isColumnarOperand(equality, in->getCollator())) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+/**
+ * Sets each entry of 'out' for which the row is of kind 'kind' and compare(values[i], rhs) holds.
+ * Entries which are already set stay set. Kept free of branches so that it vectorizes.
+ */
+template <typename T, typename Compare>
+void orCompare(const std::vector<uint8_t>& kinds,
+               ColumnKind kind,
+               const std::vector<T>& values,
+               const T& rhs,
+               Compare compare,
+               std::vector<uint8_t>* out) {
+    const size_t size = values.size();
+    const uint8_t* kindData = kinds.data();
+    const T* valueData = values.data();
+    uint8_t* outData = out->data();
+    for (size_t i = 0; i < size; ++i) {
+        outData[i] |= static_cast<uint8_t>(kindData[i] == kind) &
+            static_cast<uint8_t>(compare(valueData[i], rhs));
+    }
+}
+
+template <typename Compare>
+void orCompareColumn(const Column& column,
+                     const BSONElement& rhs,
+                     Compare compare,
+                     std::vector<uint8_t>* out) {
+    switch (kindOf(rhs)) {
+        case kNumber:
+            orCompare(column.kinds, kNumber, column.numbers, rhs.numberDouble(), compare, out);
+            break;
+        case kDate:
+            orCompare(column.kinds,
+                      kDate,
+                      column.dates,
+                      static_cast<long long>(rhs.date().toMillisSinceEpoch()),
+                      compare,
+                      out);
+            break;
+        case kString:
+            orCompare(column.kinds, kString, column.strings, rhs.valueStringData(), compare, out);
+            break;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+/**
+ * Evaluates the leaf 'expr', for which isColumnarLeaf() holds, against every member of 'batch'.
+ */
+void evaluateLeaf(WorkingSet* ws,
+                  const MatchExpression* expr,
+                  const std::vector<WorkingSetID>& batch,
+                  std::vector<uint8_t>* out) {
+    const size_t size = batch.size();
+    Column column(size);
+
+    // The path must be null-terminated for extraction.
+    const std::string path = expr->path().toString();
+    for (size_t i = 0; i < size; ++i) {
+        WorkingSetMember* member = ws->get(batch[i]);
+        if (!member->hasObj()) {
+            column.kinds[i] = kFallback;
+            continue;
+        }
+
+        const char* remainingPath = path.c_str();
+        BSONElement elt = dotted_path_support::extractElementAtPathOrArrayAlongPath(
+            member->obj.value(), remainingPath);
+        if (*remainingPath != '\0') {
+            // We stopped at an array partway along the path.
+            column.kinds[i] = kFallback;
+        } else {
+            storeInColumn(elt, i, &column);
+        }
+    }
+
+    out->assign(size, 0);
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+            orCompareColumn(column,
+                            static_cast<const ComparisonMatchExpressionBase*>(expr)->getData(),
+                            std::equal_to<>(),
+                            out);
+            break;
+        case MatchExpression::LT:
+            orCompareColumn(column,
+                            static_cast<const ComparisonMatchExpressionBase*>(expr)->getData(),
+                            std::less<>(),
+                            out);
+            break;
+        case MatchExpression::LTE:
+            orCompareColumn(column,
+                            static_cast<const ComparisonMatchExpressionBase*>(expr)->getData(),
+                            std::less_equal<>(),
+                            out);
+            break;
+        case MatchExpression::GT:
+            orCompareColumn(column,
+                            static_cast<const ComparisonMatchExpressionBase*>(expr)->getData(),
+                            std::greater<>(),
+                            out);
+            break;
+        case MatchExpression::GTE:
+            orCompareColumn(column,
+                            static_cast<const ComparisonMatchExpressionBase*>(expr)->getData(),
+                            std::greater_equal<>(),
+                            out);
+            break;
+        case MatchExpression::MATCH_IN:
+            for (auto&& equality : static_cast<const InMatchExpression*>(expr)->getEqualities()) {
+                orCompareColumn(column, equality, std::equal_to<>(), out);
+            }
+            break;
+        default:
+            MONGO_UNREACHABLE;
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+        if (column.kinds[i] == kFallback) {
+            (*out)[i] = Filter::passes(ws->get(batch[i]), expr);
+        }
+    }
+}
+
+}  // namespace
+
+bool ColumnarFilter::canEvaluate(const MatchExpression* filter) {
+    if (filter->matchType() != MatchExpression::AND) {
+        return isColumnarLeaf(filter);
+    }
+    for (size_t i = 0; i < filter->numChildren(); ++i) {
+        if (isColumnarLeaf(filter->getChild(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ColumnarFilter::evaluate(WorkingSet* ws,
+                              const MatchExpression* filter,
+                              const std::vector<WorkingSetID>& batch,
+                              std::vector<uint8_t>* selection) {
+    selection->assign(batch.size(), 1);
+
+    std::vector<const MatchExpression*> columnar;
+    std::vector<const MatchExpression*> rowWise;
+    if (filter->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < filter->numChildren(); ++i) {
+            const MatchExpression* child = filter->getChild(i);
+            (isColumnarLeaf(child) ? columnar : rowWise).push_back(child);
+        }
+    } else {
+        (isColumnarLeaf(filter) ? columnar : rowWise).push_back(filter);
+    }
+
+    std::vector<uint8_t> leafSelection;
+    for (auto expr : columnar) {
+        evaluateLeaf(ws, expr, batch, &leafSelection);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            (*selection)[i] &= leafSelection[i];
+        }
+    }
+
+    // Only the members which are still selected need to see the remaining predicates.
+    for (size_t i = 0; i < batch.size(); ++i) {
+        for (auto expr : rowWise) {
+            if (!(*selection)[i]) {
+                break;
+            }
+            (*selection)[i] = Filter::passes(ws->get(batch[i]), expr);
+        }
+    }
+}
+
+}  // namespace mongo
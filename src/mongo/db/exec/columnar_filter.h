@@ -0,0 +1,72 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/db/exec/working_set.h"
+
+namespace mongo {
+
+class MatchExpression;
+
+/**
+ * Evaluates a filter over a batch of working set members one predicate at a time, rather than one
+ * document at a time.
+ *
+ * Simple leaf predicates -- $eq, $lt, $lte, $gt, $gte and $in against numbers, dates or strings --
+ * are evaluated by first extracting the field from every document of the batch into a contiguous
+ * typed column, and then comparing the whole column in a tight loop which the compiler can
+ * vectorize. This produces one selection byte per member. A document whose value the column cannot
+ * represent, such as an array, a NaN or a Decimal128, is tested by the regular matcher instead.
+ *
+ * For a top-level $and, the eligible children are evaluated column-wise first and the rest are
+ * then tested only against the members which are still selected.
+ */
+class ColumnarFilter {
+public:
+    /**
+     * Returns true if 'filter' is, or is an $and with a child which is, a predicate which can be
+     * evaluated column-wise.
+     */
+    static bool canEvaluate(const MatchExpression* filter);
+
+    /**
+     * Tests every member of 'batch' against 'filter'. On return, 'selection' holds one entry per
+     * member of 'batch', which is 1 if that member satisfies 'filter' and 0 otherwise.
+     */
+    static void evaluate(WorkingSet* ws,
+                         const MatchExpression* filter,
+                         const std::vector<WorkingSetID>& batch,
+                         std::vector<uint8_t>* selection);
+};
+
+}  // namespace mongo
@@ -0,0 +1,204 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for mongo/db/exec/columnar_filter.cpp
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+#include <memory>
+
+#include "mongo/db/exec/columnar_filter.h"
+
+#include "mongo/db/exec/filter.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+using namespace mongo;
+
+namespace {
+
+std::unique_ptr<MatchExpression> parseMatchExpression(
+    const BSONObj& obj, const CollatorInterface* collator = nullptr) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->setCollator(collator);
+    StatusWithMatchExpression status = MatchExpressionParser::parse(obj, std::move(expCtx));
+    ASSERT_OK(status.getStatus());
+    return std::move(status.getValue());
+}
+
+/**
+ * A batch holding a variety of values under 'a', including ones which the columns cannot
+ * represent.
+ */
+std::vector<BSONObj> makeDocs() {
+    const Date_t date = Date_t::fromMillisSinceEpoch(1000);
+    return {BSON("a" << 1),
+            BSON("a" << 2.5),
+            BSON("a" << -3),
+            BSON("a" << 3LL),
+            BSON("a" << (1LL << 60)),
+            BSON("a" << ((1LL << 60) + 1)),
+            BSON("a" << std::numeric_limits<double>::quiet_NaN()),
+            BSON("a" << std::numeric_limits<double>::infinity()),
+            BSON("a" << Decimal128("2.5")),
+            BSON("a" << Decimal128("1")),
+            BSON("a"
+                 << "abc"),
+            BSON("a"
+                 << "b"),
+            BSON("a" << BSONSymbol("abc")),
+            BSON("a" << date),
+            BSON("a" << (date + Milliseconds(1))),
+            BSON("a" << Timestamp(1, 1)),
+            BSON("a" << BSON_ARRAY(1 << 5)),
+            BSON("a" << BSON_ARRAY("abc" << 1.5)),
+            BSON("a" << BSONArray()),
+            BSON("a" << BSONNULL),
+            BSON("a" << MINKEY),
+            BSON("a" << MAXKEY),
+            BSON("a" << BSON("b" << 1)),
+            BSON("a" << BSON("b" << 2.5) << "c" << 1),
+            BSON("a" << BSON("b" << BSON_ARRAY(0 << 3))),
+            BSON("a" << BSON_ARRAY(BSON("b" << 1) << BSON("b" << 4))),
+            BSON("a" << BSON("b"
+                             << "abc")),
+            BSON("c" << 1),
+            BSONObj()};
+}
+
+/**
+ * Checks that ColumnarFilter agrees with the regular matcher for 'query' on every document of
+ * makeDocs().
+ */
+void assertAgreesWithMatcher(const BSONObj& query, const CollatorInterface* collator = nullptr) {
+    auto filter = parseMatchExpression(query, collator);
+    ASSERT_TRUE(ColumnarFilter::canEvaluate(filter.get())) << query;
+
+    WorkingSet ws;
+    std::vector<WorkingSetID> batch;
+    for (auto&& doc : makeDocs()) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* member = ws.get(id);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), doc);
+        ws.transitionToOwnedObj(id);
+        batch.push_back(id);
+    }
+
+    std::vector<uint8_t> selection;
+    ColumnarFilter::evaluate(&ws, filter.get(), batch, &selection);
+    ASSERT_EQ(batch.size(), selection.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        WorkingSetMember* member = ws.get(batch[i]);
+        ASSERT_EQ(Filter::passes(member, filter.get()), static_cast<bool>(selection[i]))
+            << query << " on " << member->obj.value();
+    }
+}
+
+TEST(ColumnarFilterTest, NumericComparisons) {
+    assertAgreesWithMatcher(fromjson("{a: 1}"));
+    assertAgreesWithMatcher(fromjson("{a: 2.5}"));
+    assertAgreesWithMatcher(fromjson("{a: {$lt: 3}}"));
+    assertAgreesWithMatcher(fromjson("{a: {$lte: 3}}"));
+    assertAgreesWithMatcher(fromjson("{a: {$gt: 2.5}}"));
+    assertAgreesWithMatcher(fromjson("{a: {$gte: 2.5}}"));
+    assertAgreesWithMatcher(
+        BSON("a" << BSON("$gt" << -std::numeric_limits<double>::infinity())));
+    assertAgreesWithMatcher(BSON("a" << BSON("$gte" << (1LL << 60))));
+    assertAgreesWithMatcher(BSON("a" << BSON("$lt" << 3LL)));
+}
+
+TEST(ColumnarFilterTest, StringComparisons) {
+    assertAgreesWithMatcher(fromjson("{a: 'abc'}"));
+    assertAgreesWithMatcher(fromjson("{a: {$lt: 'b'}}"));
+    assertAgreesWithMatcher(fromjson("{a: {$gte: 'abc'}}"));
+    assertAgreesWithMatcher(fromjson("{a: {$gt: ''}}"));
+}
+
+TEST(ColumnarFilterTest, DateComparisons) {
+    const Date_t date = Date_t::fromMillisSinceEpoch(1000);
+    assertAgreesWithMatcher(BSON("a" << date));
+    assertAgreesWithMatcher(BSON("a" << BSON("$gt" << date)));
+    assertAgreesWithMatcher(BSON("a" << BSON("$lte" << (date + Milliseconds(1)))));
+}
+
+TEST(ColumnarFilterTest, In) {
+    assertAgreesWithMatcher(fromjson("{a: {$in: [1, 5]}}"));
+    assertAgreesWithMatcher(fromjson("{a: {$in: [2.5, 'abc', 'missing']}}"));
+    assertAgreesWithMatcher(
+        BSON("a" << BSON("$in" << BSON_ARRAY(Date_t::fromMillisSinceEpoch(1000) << 3))));
+}
+
+TEST(ColumnarFilterTest, DottedPaths) {
+    assertAgreesWithMatcher(fromjson("{'a.b': 1}"));
+    assertAgreesWithMatcher(fromjson("{'a.b': {$gt: 2}}"));
+    assertAgreesWithMatcher(fromjson("{'a.b': {$in: [2.5, 'abc']}}"));
+}
+
+TEST(ColumnarFilterTest, And) {
+    assertAgreesWithMatcher(fromjson("{a: {$gt: 0, $lt: 3}}"));
+    assertAgreesWithMatcher(fromjson("{a: {$gte: 1}, c: 1}"));
+    assertAgreesWithMatcher(fromjson("{a: {$gt: 0}, c: {$exists: false}}"));
+    assertAgreesWithMatcher(fromjson("{'a.b': {$lt: 3}, a: {$type: 'object'}}"));
+    assertAgreesWithMatcher(fromjson("{$and: [{a: {$lt: 'z'}}, {a: {$regex: '^a'}}]}"));
+}
+
+TEST(ColumnarFilterTest, StringComparisonsWithCollationAreNotColumnar) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    ASSERT_FALSE(
+        ColumnarFilter::canEvaluate(parseMatchExpression(fromjson("{a: 'abc'}"), &collator).get()));
+    ASSERT_FALSE(ColumnarFilter::canEvaluate(
+        parseMatchExpression(fromjson("{a: {$in: [1, 'abc']}}"), &collator).get()));
+
+    // Numeric comparisons are unaffected by the collation.
+    assertAgreesWithMatcher(fromjson("{a: {$gt: 1}}"), &collator);
+    assertAgreesWithMatcher(fromjson("{a: {$gt: 1}, c: {$lt: 'b'}}"), &collator);
+}
+
+TEST(ColumnarFilterTest, UnsupportedPredicatesAreNotColumnar) {
+    ASSERT_FALSE(ColumnarFilter::canEvaluate(parseMatchExpression(fromjson("{a: null}")).get()));
+    ASSERT_FALSE(ColumnarFilter::canEvaluate(
+        parseMatchExpression(BSON("a" << Decimal128("1"))).get()));
+    ASSERT_FALSE(ColumnarFilter::canEvaluate(
+        parseMatchExpression(BSON("a" << std::numeric_limits<double>::quiet_NaN())).get()));
+    ASSERT_FALSE(ColumnarFilter::canEvaluate(
+        parseMatchExpression(fromjson("{a: {$in: [1, /abc/]}}")).get()));
+    ASSERT_FALSE(ColumnarFilter::canEvaluate(
+        parseMatchExpression(fromjson("{a: {$in: [1, null]}}")).get()));
+    ASSERT_FALSE(ColumnarFilter::canEvaluate(parseMatchExpression(fromjson("{a: [1]}")).get()));
+    ASSERT_FALSE(ColumnarFilter::canEvaluate(
+        parseMatchExpression(fromjson("{$or: [{a: 1}, {b: 1}]}")).get()));
+}
+
+}  // namespace
@@ -38,6 +38,8 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/str.h"
 
@@ -57,15 +59,16 @@ FetchStage::FetchStage(OperationContext* opCtx,
     : RequiresCollectionStage(kStageType, opCtx, collection),
       _ws(ws),
       _filter(filter),
-      _idRetrying(WorkingSet::INVALID_ID) {
+      _idRetrying(WorkingSet::INVALID_ID),
+      _prefetchWindow(internalQueryFetchPrefetchWindow.load()) {
     _children.emplace_back(child);
 }
 
 FetchStage::~FetchStage() {}
 
 bool FetchStage::isEOF() {
-    if (WorkingSet::INVALID_ID != _idRetrying) {
-        // We have a working set member that we need to retry.
+    if (WorkingSet::INVALID_ID != _idRetrying || !_pendingIds.empty()) {
+        // We have working set members that we need to retry or fetch.
         return false;
     }
 
@@ -80,7 +83,13 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
+    if (_idRetrying == WorkingSet::INVALID_ID && !_pendingIds.empty()) {
+        status = ADVANCED;
+        id = _pendingIds.front();
+        _pendingIds.pop_front();
+    } else if (_idRetrying == WorkingSet::INVALID_ID && _prefetchWindow > 1) {
+        status = fillPrefetchWindow(&id);
+    } else if (_idRetrying == WorkingSet::INVALID_ID) {
         status = child()->work(&id);
     } else {
         status = ADVANCED;
@@ -131,6 +140,141 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::fillPrefetchWindow(WorkingSetID* out) {
+    invariant(_pendingIds.empty());
+
+    // Bound the number of calls to our child, rather than the number of results, so that a
+    // selective child cannot hold us here past a yield check.
+    for (size_t i = 0; i < _prefetchWindow; ++i) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState status = child()->work(&id);
+
+        if (PlanStage::ADVANCED == status) {
+            // Calling work() again may invalidate unowned BSON in the member.
+            _ws->get(id)->makeObjOwnedIfNeeded();
+            _pendingIds.push_back(id);
+            continue;
+        } else if (PlanStage::NEED_TIME == status) {
+            continue;
+        }
+
+        if (_pendingIds.empty()) {
+            *out = id;
+            return status;
+        }
+
+        // We have results to fetch. If our child asked for a yield or failed, report that next;
+        // at EOF, our child keeps reporting EOF once the window has drained.
+        if (PlanStage::IS_EOF != status) {
+            deferState(status, id);
+        }
+        break;
+    }
+
+    if (_pendingIds.empty()) {
+        return PlanStage::NEED_TIME;
+    }
+
+    prefetch(_pendingIds.begin(), _pendingIds.end());
+
+    *out = _pendingIds.front();
+    _pendingIds.pop_front();
+    return PlanStage::ADVANCED;
+}
+
+template <typename Iterator>
+void FetchStage::prefetch(Iterator begin, Iterator end) {
+    std::vector<RecordId> recordIds;
+    for (auto it = begin; it != end; ++it) {
+        WorkingSetMember* member = _ws->get(*it);
+        if (!member->hasObj()) {
+            recordIds.push_back(member->recordId);
+        }
+    }
+
+    if (recordIds.size() > 1) {
+        collection()->getRecordStore()->prefetch(getOpCtx(), recordIds);
+        _specificStats.docsPrefetched += recordIds.size();
+    }
+}
+
+PlanStage::StageState FetchStage::doWorkBatch(size_t maxResults, std::vector<WorkingSetID>* out) {
+    // Members held over from an earlier write conflict go through the single-result path.
+    if (WorkingSet::INVALID_ID != _idRetrying || !_pendingIds.empty()) {
+        return PlanStage::doWorkBatch(maxResults, out);
+    }
+
+    if (isEOF()) {
+        return PlanStage::IS_EOF;
+    }
+
+    invariant(_childBatch.empty());
+    StageState status = child()->workBatch(maxResults, &_childBatch);
+    if (PlanStage::ADVANCED != status) {
+        // For FAILURE and NEED_YIELD, pass along the WorkingSetID provided by our child.
+        out->swap(_childBatch);
+        return status;
+    }
+
+    if (_prefetchWindow > 1) {
+        prefetch(_childBatch.begin(), _childBatch.end());
+    }
+
+    WorkingSetID unownedResult = WorkingSet::INVALID_ID;
+    for (size_t i = 0; i < _childBatch.size(); ++i) {
+        WorkingSetID id = _childBatch[i];
+        WorkingSetMember* member = _ws->get(id);
+
+        if (member->hasObj()) {
+            ++_specificStats.alreadyHasObj;
+            out->push_back(id);
+            continue;
+        }
+
+        verify(WorkingSetMember::RID_AND_IDX == member->getState());
+        verify(member->hasRecordId());
+
+        if (WorkingSet::INVALID_ID != unownedResult) {
+            // Seeking the cursor invalidates any unowned BSON from the previous fetch.
+            _ws->get(unownedResult)->makeObjOwnedIfNeeded();
+            unownedResult = WorkingSet::INVALID_ID;
+        }
+
+        try {
+            if (!_cursor)
+                _cursor = collection()->getCursor(getOpCtx());
+
+            if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
+                _ws->free(id);
+                continue;
+            }
+        } catch (const WriteConflictException&) {
+            // Retry this member after yielding, followed by the rest of the batch. Everything we
+            // hold on to must survive the yield.
+            member->makeObjOwnedIfNeeded();
+            _idRetrying = id;
+            for (size_t j = i + 1; j < _childBatch.size(); ++j) {
+                _ws->get(_childBatch[j])->makeObjOwnedIfNeeded();
+                _pendingIds.push_back(_childBatch[j]);
+            }
+            _childBatch.clear();
+
+            _specificStats.docsExamined += out->size();
+            Filter::filterBatch(_ws, _filter, out);
+            return deferBatchState(PlanStage::NEED_YIELD, WorkingSet::INVALID_ID, out);
+        }
+
+        out->push_back(id);
+        unownedResult = id;
+    }
+    _childBatch.clear();
+
+    // See returnIfMatches() for what counts as examining a document.
+    _specificStats.docsExamined += out->size();
+    Filter::filterBatch(_ws, _filter, out);
+    return out->empty() ? PlanStage::NEED_TIME : PlanStage::ADVANCED;
+}
+
 void FetchStage::doSaveStateRequiresCollection() {
     if (_cursor) {
         _cursor->saveUnpositioned();
@@ -29,7 +29,9 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/jsobj.h"
@@ -60,6 +62,7 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxResults, std::vector<WorkingSetID>* out) final;
 
     void doDetachFromOperationContext() final;
     void doReattachToOperationContext() final;
@@ -86,6 +89,20 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Reads up to '_prefetchWindow' results ahead from our child into '_pendingIds' and hints
+     * their records to the record store. Returns the first of them as ADVANCED, or reports the
+     * state of our child if it produced nothing.
+     */
+    StageState fillPrefetchWindow(WorkingSetID* out);
+
+    /**
+     * Hints the records of the members in the range [begin, end) which still need to be fetched
+     * to the record store.
+     */
+    template <typename Iterator>
+    void prefetch(Iterator begin, Iterator end);
+
     // Used to fetch Records from _collection.
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
@@ -98,6 +115,18 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // Members of a batch from our child which have not been fetched yet because the batch was
+    // interrupted by a write conflict. These are consumed after '_idRetrying', before asking our
+    // child for more.
+    std::deque<WorkingSetID> _pendingIds;
+
+    // Scratch space for the batches received from our child by doWorkBatch().
+    std::vector<WorkingSetID> _childBatch;
+
+    // How many results to read ahead from our child, so that their records can be prefetched.
+    // Read-ahead is disabled if this is 0 or 1.
+    const size_t _prefetchWindow;
+
     // Stats
     FetchStats _specificStats;
 };
@@ -29,9 +29,14 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/db/exec/columnar_filter.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/matchable.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace mongo {
 
@@ -55,7 +60,7 @@ public:
         // BSONElementIterator does some interesting things with arrays that I don't think
         // SimpleArrayElementIterator does.
         if (_wsm->hasObj()) {
-            return new BSONElementIterator(path, _wsm->obj.value());
+            return new BSONElementIterator(path, _wsm->obj.value(), fieldIndex());
         }
 
         // NOTE: This (kind of) duplicates code in WorkingSetMember::getFieldDotted.
@@ -94,7 +99,36 @@ public:
     }
 
 private:
+    /**
+     * Returns an index over the fields of the member's object if it is at least as wide as
+     * 'internalQueryFieldIndexMinFields', so that each leaf of the filter need not scan the object
+     * for its field. The member keeps the index of an owned object for any later lookups; the
+     * index of an unowned object lasts only as long as this document.
+     */
+    const BSONFieldIndex* fieldIndex() const {
+        if (_fieldIndexChecked) {
+            return _fieldIndex;
+        }
+        _fieldIndexChecked = true;
+
+        const int minFields = internalQueryFieldIndexMinFields.load();
+        if (minFields <= 0) {
+            return nullptr;
+        }
+        if (_wsm->obj.value().isOwned()) {
+            _fieldIndex = _wsm->getFieldIndex(minFields);
+        } else if (BSONFieldIndex::isWorthBuilding(_wsm->obj.value(), minFields)) {
+            _unownedFieldIndex.emplace(_wsm->obj.value());
+            _fieldIndex = _unownedFieldIndex.get_ptr();
+        }
+        return _fieldIndex;
+    }
+
     WorkingSetMember* _wsm;
+
+    mutable bool _fieldIndexChecked = false;
+    mutable const BSONFieldIndex* _fieldIndex = nullptr;
+    mutable boost::optional<BSONFieldIndex> _unownedFieldIndex;
 };
 
 class IndexKeyMatchableDocument : public MatchableDocument {
@@ -167,6 +201,36 @@ public:
         IndexKeyMatchableDocument doc(keyData, keyPattern);
         return filter->matches(&doc, nullptr);
     }
+
+    /**
+     * Tests every member of 'batch' against 'filter', freeing those which do not satisfy it. The
+     * remaining members are left in 'batch', in their original order. Does nothing if filter is
+     * NULL.
+     *
+     * Simple predicates are evaluated a column at a time over the whole batch; see ColumnarFilter.
+     */
+    static void filterBatch(WorkingSet* ws,
+                            const MatchExpression* filter,
+                            std::vector<WorkingSetID>* batch) {
+        if (nullptr == filter) {
+            return;
+        }
+        std::vector<uint8_t> selection;
+        if (batch->size() > 1 && ColumnarFilter::canEvaluate(filter)) {
+            ColumnarFilter::evaluate(ws, filter, *batch, &selection);
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < batch->size(); ++i) {
+            const WorkingSetID id = (*batch)[i];
+            if (selection.empty() ? passes(ws->get(id), filter) : selection[i]) {
+                (*batch)[kept++] = id;
+            } else {
+                ws->free(id);
+            }
+        }
+        batch->resize(kept);
+    }
 };
 
 }  // namespace mongo
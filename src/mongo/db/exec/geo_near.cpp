@@ -1034,15 +1034,46 @@ StatusWith<NearStage::CoveredInterval*>  //
 
     invariant(_boundsIncrement > 0.0);
 
-    R2Annulus nextBounds(_currBounds.center(),
-                         _currBounds.getOuter(),
-                         min(_currBounds.getOuter() + _boundsIncrement, _fullBounds.getOuter()));
+    const double innerBound = _currBounds.getOuter();
+    std::vector<S2CellId> cover;
+    while (true) {
+        _currBounds = R2Annulus(_currBounds.center(),
+                                innerBound,
+                                min(_currBounds.getOuter() + _boundsIncrement,
+                                    _fullBounds.getOuter()));
+
+        //
+        // Setup the covering region for this interval
+        //
+
+        std::unique_ptr<S2Region> region(buildS2Region(_currBounds));
+        std::vector<S2CellId> annulusCover = ExpressionMapping::get2dsphereCovering(*region);
+
+        // Generate a covering that does not intersect with any previous coverings
+        S2CellUnion coverUnion;
+        coverUnion.InitSwap(&annulusCover);
+        S2CellUnion diffUnion;
+        diffUnion.GetDifference(&coverUnion, &_scannedCells);
+        for (auto cellId : diffUnion.cell_ids()) {
+            if (region->MayIntersect(S2Cell(cellId))) {
+                cover.push_back(cellId);
+            }
+        }
 
+        // The cells scanned for earlier intervals often cover the whole of a narrow annulus. Such
+        // an annulus has no documents left to fetch, so rather than scan the index for nothing,
+        // fold it into a wider interval.
+        if (!cover.empty() || _currBounds.getOuter() == _fullBounds.getOuter()) {
+            break;
+        }
+        _boundsIncrement *= 2;
+    }
+
+    const R2Annulus& nextBounds = _currBounds;
     bool isLastInterval = (nextBounds.getOuter() == _fullBounds.getOuter());
-    _currBounds = nextBounds;
 
     //
-    // Setup the covering region and stages for this interval
+    // Setup the stages for this interval
     //
 
     IndexScanParams scanParams(opCtx, indexDescriptor());
@@ -1055,21 +1086,6 @@ StatusWith<NearStage::CoveredInterval*>  //
     const int s2FieldPosition = getFieldPosition(indexDescriptor(), s2Field);
     fassert(28678, s2FieldPosition >= 0);
     scanParams.bounds.fields[s2FieldPosition].intervals.clear();
-    std::unique_ptr<S2Region> region(buildS2Region(_currBounds));
-
-    std::vector<S2CellId> cover = ExpressionMapping::get2dsphereCovering(*region);
-
-    // Generate a covering that does not intersect with any previous coverings
-    S2CellUnion coverUnion;
-    coverUnion.InitSwap(&cover);
-    invariant(cover.empty());
-    S2CellUnion diffUnion;
-    diffUnion.GetDifference(&coverUnion, &_scannedCells);
-    for (auto cellId : diffUnion.cell_ids()) {
-        if (region->MayIntersect(S2Cell(cellId))) {
-            cover.push_back(cellId);
-        }
-    }
 
     // Add the cells in this covering to the _scannedCells union
     _scannedCells.Add(cover);
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/hardware_counters.h"
+
+#if defined(__linux__)
+#include <cstdint>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mongo {
+
+#if defined(__linux__)
+namespace {
+
+/**
+ * An instructions counter leading a group with a last level cache miss counter, so that both can
+ * be read with a single system call.
+ */
+class CounterGroup {
+    CounterGroup(const CounterGroup&) = delete;
+    CounterGroup& operator=(const CounterGroup&) = delete;
+
+public:
+    CounterGroup() {
+        _leader = open(PERF_COUNT_HW_INSTRUCTIONS, -1);
+        if (_leader < 0) {
+            return;
+        }
+        _llcMisses = open(PERF_COUNT_HW_CACHE_MISSES, _leader);
+        if (_llcMisses < 0) {
+            close(_leader);
+            _leader = -1;
+            return;
+        }
+        ioctl(_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    ~CounterGroup() {
+        if (_leader >= 0) {
+            close(_llcMisses);
+            close(_leader);
+        }
+    }
+
+    bool read(HardwareCounters::Sample* sample) const {
+        if (_leader < 0) {
+            return false;
+        }
+
+        // With PERF_FORMAT_GROUP, the kernel reports the number of events followed by the value
+        // of each of them in the order in which they joined the group.
+        uint64_t values[3];
+        if (::read(_leader, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) ||
+            values[0] != 2) {
+            return false;
+        }
+        sample->instructions = static_cast<long long>(values[1]);
+        sample->llcMisses = static_cast<long long>(values[2]);
+        return true;
+    }
+
+private:
+    static int open(uint64_t config, int groupFd) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.disabled = groupFd < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+    }
+
+    int _leader = -1;
+    int _llcMisses = -1;
+};
+
+}  // namespace
+
+bool HardwareCounters::read(Sample* sample) {
+    thread_local CounterGroup group;
+    return group.read(sample);
+}
+
+#else
+
+bool HardwareCounters::read(Sample* sample) {
+    return false;
+}
+
+#endif
+
+}  // namespace mongo
@@ -31,8 +31,10 @@
 
 #include "mongo/db/exec/idhack.h"
 
+#include <algorithm>
 #include <memory>
 
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/index_scan.h"
@@ -54,45 +56,90 @@ IDHackStage::IDHackStage(OperationContext* opCtx,
                          CanonicalQuery* query,
                          WorkingSet* ws,
                          const IndexDescriptor* descriptor)
-    : RequiresIndexStage(kStageType, opCtx, descriptor),
-      _workingSet(ws),
-      _key(query->getQueryObj()["_id"].wrap()) {
+    : RequiresIndexStage(kStageType, opCtx, descriptor), _workingSet(ws) {
     _specificStats.indexName = descriptor->indexName();
     if (nullptr != query->getProj()) {
         _addKeyMetadata = query->getProj()->wantIndexKey();
     }
+
+    BSONElement idElt = query->getQueryObj()["_id"];
+    std::vector<BSONObj> requestedKeys;
+    if (CanonicalQuery::isSimpleIdInQuery(query->getQueryObj())) {
+        for (auto&& elt : idElt.Obj()["$in"].Obj()) {
+            requestedKeys.push_back(elt.wrap("_id"));
+        }
+    } else {
+        requestedKeys.push_back(idElt.wrap());
+    }
+    initKeys(std::move(requestedKeys));
 }
 
 IDHackStage::IDHackStage(OperationContext* opCtx,
                          const BSONObj& key,
                          WorkingSet* ws,
                          const IndexDescriptor* descriptor)
-    : RequiresIndexStage(kStageType, opCtx, descriptor), _workingSet(ws), _key(key) {
+    : RequiresIndexStage(kStageType, opCtx, descriptor), _workingSet(ws) {
     _specificStats.indexName = descriptor->indexName();
+    initKeys({key});
 }
 
 IDHackStage::~IDHackStage() {}
 
+void IDHackStage::initKeys(std::vector<BSONObj> requestedKeys) {
+    // The _id index has the collection default collation, so its keys hold the collation keys of
+    // any strings.
+    if (collection()->getDefaultCollator()) {
+        for (auto&& requestedKey : requestedKeys) {
+            BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+            indexAccessMethod()->getKeys(requestedKey,
+                                         IndexAccessMethod::GetKeysMode::kEnforceConstraints,
+                                         &keys,
+                                         nullptr,
+                                         nullptr);
+            invariant(keys.size() == 1);
+            requestedKey = *keys.begin();
+        }
+    }
+
+    // Seeking in index order keeps successive lookups close to one another in the index.
+    auto keyLess = [](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs.woCompare(rhs, BSONObj(), false) < 0;
+    };
+    auto keyEqual = [](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs.woCompare(rhs, BSONObj(), false) == 0;
+    };
+    std::sort(requestedKeys.begin(), requestedKeys.end(), keyLess);
+    requestedKeys.erase(std::unique(requestedKeys.begin(), requestedKeys.end(), keyEqual),
+                        requestedKeys.end());
+    _keys = std::move(requestedKeys);
+}
+
 bool IDHackStage::isEOF() {
-    return _done;
+    return _nextKey >= _keys.size();
 }
 
 PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
-    if (_done) {
+    if (isEOF()) {
         return PlanStage::IS_EOF;
     }
 
     WorkingSetID id = WorkingSet::INVALID_ID;
     try {
+        if (!_indexCursor)
+            _indexCursor = indexAccessMethod()->newCursor(getOpCtx());
+
         // Look up the key by going directly to the index.
-        RecordId recordId = indexAccessMethod()->findSingle(getOpCtx(), _key);
+        auto kv = _indexCursor->seekExact(_keys[_nextKey], SortedDataInterface::Cursor::kWantLoc);
 
         // Key not found.
-        if (recordId.isNull()) {
-            _done = true;
-            return PlanStage::IS_EOF;
+        if (!kv) {
+            ++_nextKey;
+            return isEOF() ? PlanStage::IS_EOF : PlanStage::NEED_TIME;
         }
 
+        RecordId recordId = kv->loc;
+        dassert(!recordId.isNull());
+
         ++_specificStats.keysExamined;
         ++_specificStats.docsExamined;
 
@@ -109,14 +156,18 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
         if (!WorkingSetCommon::fetch(getOpCtx(), _workingSet, id, _recordCursor)) {
             // We didn't find a document with RecordId 'id'.
             _workingSet->free(id);
-            _commonStats.isEOF = true;
-            _done = true;
-            return IS_EOF;
+            ++_nextKey;
+            if (isEOF()) {
+                _commonStats.isEOF = true;
+                return IS_EOF;
+            }
+            return NEED_TIME;
         }
 
         return advance(id, member, out);
     } catch (const WriteConflictException&) {
-        // Restart at the beginning on retry.
+        // Retry the current key from scratch.
+        _indexCursor.reset();
         _recordCursor.reset();
         if (id != WorkingSet::INVALID_ID)
             _workingSet->free(id);
@@ -133,42 +184,61 @@ PlanStage::StageState IDHackStage::advance(WorkingSetID id,
 
     if (_addKeyMetadata) {
         BSONObj ownedKeyObj = member->obj.value()["_id"].wrap().getOwned();
-        member->addComputed(
-            new IndexKeyComputedData(IndexKeyComputedData::rehydrateKey(_key, ownedKeyObj)));
+        member->addComputed(new IndexKeyComputedData(
+            IndexKeyComputedData::rehydrateKey(indexDescriptor()->keyPattern(), ownedKeyObj)));
     }
 
-    _done = true;
+    ++_nextKey;
     *out = id;
     return PlanStage::ADVANCED;
 }
 
 void IDHackStage::doSaveStateRequiresIndex() {
+    // Every lookup seeks afresh, so neither cursor needs to keep its position.
+    if (_indexCursor)
+        _indexCursor->saveUnpositioned();
     if (_recordCursor)
         _recordCursor->saveUnpositioned();
 }
 
 void IDHackStage::doRestoreStateRequiresIndex() {
+    if (_indexCursor)
+        _indexCursor->restore();
     if (_recordCursor)
         _recordCursor->restore();
 }
 
 void IDHackStage::doDetachFromOperationContext() {
+    if (_indexCursor)
+        _indexCursor->detachFromOperationContext();
     if (_recordCursor)
         _recordCursor->detachFromOperationContext();
 }
 
 void IDHackStage::doReattachToOperationContext() {
+    if (_indexCursor)
+        _indexCursor->reattachToOperationContext(getOpCtx());
     if (_recordCursor)
         _recordCursor->reattachToOperationContext(getOpCtx());
 }
 
 // static
 bool IDHackStage::supportsQuery(Collection* collection, const CanonicalQuery& query) {
-    return !query.getQueryRequest().showRecordId() && query.getQueryRequest().getHint().isEmpty() &&
-        !query.getQueryRequest().getSkip() &&
-        CanonicalQuery::isSimpleIdQuery(query.getQueryRequest().getFilter()) &&
-        !query.getQueryRequest().isTailable() &&
-        CollatorInterface::collatorsMatch(query.getCollator(), collection->getDefaultCollator());
+    const QueryRequest& qr = query.getQueryRequest();
+    if (qr.showRecordId() || !qr.getHint().isEmpty() || qr.getSkip() || qr.isTailable() ||
+        !CollatorInterface::collatorsMatch(query.getCollator(), collection->getDefaultCollator())) {
+        return false;
+    }
+
+    if (CanonicalQuery::isSimpleIdQuery(qr.getFilter())) {
+        return true;
+    }
+
+    // The lookups of an $in return every matching document, in _id order.
+    return CanonicalQuery::isSimpleIdInQuery(qr.getFilter()) && !qr.getLimit() &&
+        !qr.getNToReturn() &&
+        (qr.getSort().isEmpty() ||
+         SimpleBSONObjComparator::kInstance.evaluate(qr.getSort() == BSON("_id" << 1)));
 }
 
 unique_ptr<PlanStageStats> IDHackStage::getStats() {
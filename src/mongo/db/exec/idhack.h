@@ -30,10 +30,12 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/requires_index_stage.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/sorted_data_interface.h"
 
 namespace mongo {
 
@@ -44,6 +46,10 @@ class RecordCursor;
  * A standalone stage implementing the fast path for key-value retrievals via the _id index. Since
  * the _id index always has the collection default collation, the IDHackStage can only be used when
  * the query's collation is equal to the collection default.
+ *
+ * Besides a single _id equality, the stage serves {_id: {$in: [...]}}. The values are put in index
+ * order and deduplicated up front, and then looked up one per call to work() by exact seeks on a
+ * single cursor over the _id index. The documents are returned in _id order.
  */
 class IDHackStage final : public RequiresIndexStage {
 public:
@@ -67,7 +73,8 @@ public:
     void doReattachToOperationContext() final;
 
     /**
-     * ID Hack has a very strict criteria for the queries it supports.
+     * ID Hack has a very strict criteria for the queries it supports. A query with an $in over _id
+     * is only supported if it has neither a limit nor a sort other than {_id: 1}.
      */
     static bool supportsQuery(Collection* collection, const CanonicalQuery& query);
 
@@ -94,16 +101,23 @@ private:
      */
     StageState advance(WorkingSetID id, WorkingSetMember* member, WorkingSetID* out);
 
+    /**
+     * Sets '_keys' to the index keys of the _id values in 'requestedKeys', which are of the form
+     * {_id: <value>}, in index order and without duplicates.
+     */
+    void initKeys(std::vector<BSONObj> requestedKeys);
+
+    std::unique_ptr<SortedDataInterface::Cursor> _indexCursor;
     std::unique_ptr<SeekableRecordCursor> _recordCursor;
 
     // The WorkingSet we annotate with results.  Not owned by us.
     WorkingSet* _workingSet;
 
-    // The value to match against the _id field.
-    BSONObj _key;
+    // The index keys to look up, in index order.
+    std::vector<BSONObj> _keys;
 
-    // Have we returned our one document?
-    bool _done = false;
+    // Position in '_keys' of the next key to look up.
+    size_t _nextKey = 0;
 
     // Do we need to add index key metadata for returnKey?
     bool _addKeyMetadata = false;
@@ -34,6 +34,7 @@
 #include <memory>
 
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/working_set_common.h"
 
 namespace mongo {
@@ -45,8 +46,9 @@ const char* MultiIteratorStage::kStageType = "MULTI_ITERATOR";
 
 MultiIteratorStage::MultiIteratorStage(OperationContext* opCtx,
                                        WorkingSet* ws,
-                                       Collection* collection)
-    : RequiresCollectionStage(kStageType, opCtx, collection), _ws(ws) {}
+                                       Collection* collection,
+                                       const MatchExpression* filter)
+    : RequiresCollectionStage(kStageType, opCtx, collection), _ws(ws), _filter(filter) {}
 
 void MultiIteratorStage::addIterator(unique_ptr<RecordCursor> it) {
     _iterators.push_back(std::move(it));
@@ -76,6 +78,12 @@ PlanStage::StageState MultiIteratorStage::doWork(WorkingSetID* out) {
     member->recordId = record->id;
     member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson()};
     _ws->transitionToRecordIdAndObj(*out);
+
+    if (!Filter::passes(member, _filter)) {
+        _ws->free(*out);
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_TIME;
+    }
     return PlanStage::ADVANCED;
 }
 
@@ -109,6 +117,13 @@ void MultiIteratorStage::doReattachToOperationContext() {
 }
 
 unique_ptr<PlanStageStats> MultiIteratorStage::getStats() {
+    // Add a BSON representation of the filter to the stats tree, if there is one.
+    if (nullptr != _filter) {
+        BSONObjBuilder bob;
+        _filter->serialize(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
     unique_ptr<PlanStageStats> ret =
         std::make_unique<PlanStageStats>(_commonStats, STAGE_MULTI_ITERATOR);
     ret->specific = std::make_unique<CollectionScanStats>();
@@ -35,6 +35,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 
 namespace mongo {
@@ -44,10 +45,15 @@ namespace mongo {
  *
  * This is a special stage which is not used automatically by queries. It is intended for special
  * commands that work with RecordCursors. For example, it is used by the repairCursor command.
+ *
+ * If a filter is given, the records which do not pass it are discarded.
  */
 class MultiIteratorStage final : public RequiresCollectionStage {
 public:
-    MultiIteratorStage(OperationContext* opCtx, WorkingSet* ws, Collection* collection);
+    MultiIteratorStage(OperationContext* opCtx,
+                       WorkingSet* ws,
+                       Collection* collection,
+                       const MatchExpression* filter = nullptr);
 
     void addIterator(std::unique_ptr<RecordCursor> it);
 
@@ -84,6 +90,9 @@ private:
 
     // Not owned by us.
     WorkingSet* _ws;
+
+    // The filter is not owned by us.
+    const MatchExpression* _filter;
 };
 
 }  // namespace mongo
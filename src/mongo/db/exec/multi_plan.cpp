@@ -38,15 +38,22 @@
 #include <memory>
 
 #include "mongo/base/owned_pointer_vector.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/util/log.h"
 #include "mongo/util/str.h"
 
@@ -60,6 +67,130 @@ using std::vector;
 // static
 const char* MultiPlanStage::kStageType = "MULTI_PLAN";
 
+namespace {
+
+/**
+ * Returns statistics on the indexed fields of 'collection', sampling the collection anew if the
+ * cached ones are missing or out of date. Returns nullptr if the collection cannot be sampled.
+ */
+std::shared_ptr<const CollectionIndexStatistics> getIndexStatistics(OperationContext* opCtx,
+                                                                    const Collection* collection) {
+    IndexStatisticsCache* cache = collection->infoCache()->getIndexStatistics();
+    const long long numRecords = collection->numRecords(opCtx);
+    const long long sampleSize = internalQueryPlannerCostEstimationSampleSize.load();
+
+    // Resample once the collection has grown or shrunk by a fifth, or by a sample's worth of
+    // documents for small collections.
+    auto statistics = cache->get();
+    if (statistics &&
+        std::abs(numRecords - statistics->numRecords()) <=
+            std::max(sampleSize, statistics->numRecords() / 5)) {
+        return statistics;
+    }
+
+    auto cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    if (!cursor) {
+        return nullptr;
+    }
+
+    // The histograms are built over document values, which only match the keys of regular
+    // indexes with simple collation and one key per document. The keys of $** indexes are
+    // generated from the sampled documents instead.
+    StringMap<std::vector<BSONObj>> samples;
+    std::vector<const IndexAccessMethod*> wildcardIndexes;
+    auto it = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (it->more()) {
+        const IndexCatalogEntry* entry = it->next();
+        const IndexDescriptor* desc = entry->descriptor();
+        if (desc->getIndexType() == INDEX_WILDCARD && !entry->getCollator()) {
+            wildcardIndexes.push_back(entry->accessMethod());
+            continue;
+        }
+        if (desc->getIndexType() != INDEX_BTREE || desc->isPartial() || entry->getCollator() ||
+            entry->isMultikey(opCtx)) {
+            continue;
+        }
+        for (auto&& elt : desc->keyPattern()) {
+            samples[elt.fieldNameStringData()];
+        }
+    }
+    if (samples.empty() && wildcardIndexes.empty()) {
+        return nullptr;
+    }
+
+    StringSet arrayPaths;
+    StringMap<std::vector<BSONObj>> wildcardSamples;
+    long long numSampled = 0;
+    for (; numSampled < sampleSize; ++numSampled) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        const BSONObj doc = record->data.releaseToBson();
+
+        // Several $** indexes may hold the same keys, which are counted once.
+        BSONObjSet wildcardKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        for (auto accessMethod : wildcardIndexes) {
+            accessMethod->getKeys(doc,
+                                  IndexAccessMethod::GetKeysMode::kRelaxConstraints,
+                                  &wildcardKeys,
+                                  &multikeyMetadataKeys,
+                                  nullptr);
+        }
+        for (auto&& key : wildcardKeys) {
+            // Each key is of the form {"": path, "": value}.
+            BSONObjIterator keyIt(key);
+            const BSONElement path = keyIt.next();
+            BSONObjBuilder bob;
+            bob.appendAs(keyIt.next(), "");
+            wildcardSamples[path.valueStringData()].push_back(bob.obj());
+        }
+
+        for (auto&& sample : samples) {
+            BSONElement elt = dotted_path_support::extractElementAtPath(doc, sample.first);
+            if (elt.type() == Array) {
+                arrayPaths.insert(sample.first);
+                continue;
+            }
+
+            // Documents which lack the field are indexed under null.
+            BSONObjBuilder bob;
+            if (elt.eoo()) {
+                bob.appendNull("");
+            } else {
+                bob.appendAs(elt, "");
+            }
+            sample.second.push_back(bob.obj());
+        }
+    }
+
+    StringMap<FieldHistogram> histograms;
+    for (auto&& sample : samples) {
+        if (!arrayPaths.count(sample.first)) {
+            histograms.emplace(sample.first, FieldHistogram(std::move(sample.second), numRecords));
+        }
+    }
+
+    StringMap<WildcardPathStatistics> wildcardPaths;
+    for (auto&& sample : wildcardSamples) {
+        const double numKeys =
+            static_cast<double>(sample.second.size()) * numRecords / std::max(numSampled, 1LL);
+        wildcardPaths.emplace(
+            sample.first,
+            WildcardPathStatistics{
+                numKeys,
+                FieldHistogram(std::move(sample.second), static_cast<long long>(numKeys))});
+    }
+
+    statistics = std::make_shared<CollectionIndexStatistics>(
+        numRecords, std::move(histograms), std::move(wildcardPaths));
+    cache->set(statistics);
+    return statistics;
+}
+
+}  // namespace
+
 MultiPlanStage::MultiPlanStage(OperationContext* opCtx,
                                const Collection* collection,
                                CanonicalQuery* cq,
@@ -202,9 +333,16 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), collection());
     size_t numResults = getTrialPeriodNumToReturn(*_query);
 
+    // If the estimates leave a single candidate standing, there is no need for a trial period.
+    bool chosenByEstimate = false;
+    if (internalQueryPlannerEnableCostEstimation.load() && _candidates.size() > 1) {
+        pruneCandidatesByEstimatedCost(numWorks);
+        chosenByEstimate = _candidates.size() == 1;
+    }
+
     // Work the plans, stopping when a plan hits EOF or returns some
     // fixed number of results.
-    for (size_t ix = 0; ix < numWorks; ++ix) {
+    for (size_t ix = 0; !chosenByEstimate && ix < numWorks; ++ix) {
         bool moreToDo = workAllPlans(numResults, yieldPolicy);
         if (!moreToDo) {
             break;
@@ -250,10 +388,13 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // write to the plan cache.
     //
     // TODO: We can remove this if we introduce replanning logic to the SubplanStage.
-    bool canCache = (_cachingMode == CachingMode::AlwaysCache);
+    //
+    // A plan chosen by its estimated cost has no trial statistics for the cache entry to be judged
+    // by, so it is not cached either.
+    bool canCache = (_cachingMode == CachingMode::AlwaysCache) && !chosenByEstimate;
     if (_cachingMode == CachingMode::SometimesCache) {
         // In "sometimes cache" mode, we cache unless we hit one of the special cases below.
-        canCache = true;
+        canCache = !chosenByEstimate;
 
         if (ranking->tieForBest) {
             // The winning plan tied with the runner-up and we're using "sometimes cache" mode. We
@@ -330,6 +471,45 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     return Status::OK();
 }
 
+void MultiPlanStage::pruneCandidatesByEstimatedCost(size_t numWorks) {
+    // With a sort or a limit, a plan may stop long before it has examined all that its bounds
+    // allow, which the estimates do not account for.
+    const QueryRequest& qr = _query->getQueryRequest();
+    if (!collection() || !qr.getSort().isEmpty() || qr.getLimit() || qr.getNToReturn()) {
+        return;
+    }
+
+    auto statistics = getIndexStatistics(getOpCtx(), collection());
+    if (!statistics) {
+        return;
+    }
+
+    std::vector<boost::optional<double>> costs;
+    boost::optional<double> cheapest;
+    for (auto&& candidate : _candidates) {
+        costs.push_back(statistics->estimateCost(candidate.solution->root.get()));
+        if (costs.back() && (!cheapest || *costs.back() < *cheapest)) {
+            cheapest = costs.back();
+        }
+    }
+    if (!cheapest) {
+        return;
+    }
+
+    // Candidates which could not be estimated stay in the race.
+    const double pruneRatio = internalQueryPlannerCostEstimationPruneRatio.load();
+    const double maxCost = std::max(static_cast<double>(numWorks), *cheapest * pruneRatio);
+    for (size_t ix = _candidates.size(); ix-- > 0;) {
+        if (costs[ix] && *costs[ix] > maxCost) {
+            LOG(2) << "Pruning plan with estimated cost " << *costs[ix] << ", against "
+                   << *cheapest << " for the cheapest: "
+                   << Explain::getPlanSummary(_candidates[ix].root);
+            _candidates.erase(_candidates.begin() + ix);
+            _children.erase(_children.begin() + ix);
+        }
+    }
+}
+
 bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy) {
     bool doneWorking = false;
 
@@ -180,6 +180,13 @@ private:
      */
     Status tryYield(PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Estimates the cost of each candidate from the statistics on the indexed fields of the
+     * collection, and drops the candidates which would cost more than both a trial period of
+     * 'numWorks' and 'internalQueryPlannerCostEstimationPruneRatio' times the cheapest estimate.
+     */
+    void pruneCandidatesByEstimatedCost(size_t numWorks);
+
     static const int kNoSuchPlan = -1;
 
     // Describes the cases in which we should write an entry for the winning plan to the plan cache.
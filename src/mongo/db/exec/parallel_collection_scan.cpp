@@ -0,0 +1,394 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/parallel_collection_scan.h"
+
+#include <algorithm>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/collection_scan_common.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_tree.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+
+// static
+const char* ParallelCollectionScan::kStageType = "PARALLEL_COLLSCAN";
+
+namespace {
+
+// Each worker reads at most this many records, or documents totalling this many bytes, per round.
+const size_t kMaxRecordsPerRound = 512;
+const size_t kMaxBytesPerRound = 4 * 1024 * 1024;
+
+/**
+ * Returns true if 'expr' contains an $and which reorders its children as it matches, and so may
+ * not be matched by several threads at once.
+ */
+bool hasAdaptiveAnd(const MatchExpression* expr) {
+    if (expr->matchType() == MatchExpression::AND &&
+        static_cast<const AndMatchExpression*>(expr)->getAdaptiveOrderInterval() > 0) {
+        return true;
+    }
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (hasAdaptiveAnd(expr->getChild(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+ParallelCollectionScan::ParallelCollectionScan(OperationContext* opCtx,
+                                               const Collection* collection,
+                                               size_t numPartitions,
+                                               WorkingSet* workingSet,
+                                               const MatchExpression* filter)
+    : RequiresCollectionStage(kStageType, opCtx, collection),
+      _workingSet(workingSet),
+      _filter(filter),
+      _requestedPartitions(numPartitions) {
+    invariant(_requestedPartitions > 0);
+}
+
+ParallelCollectionScan::~ParallelCollectionScan() {
+    // Rounds always finish before work() returns, so there is nothing left for the pool to run.
+    if (_pool) {
+        _pool->shutdown();
+        _pool->join();
+    }
+}
+
+// static
+bool ParallelCollectionScan::canParallelize(OperationContext* opCtx,
+                                            const Collection* collection,
+                                            const CanonicalQuery& cq,
+                                            const CollectionScanParams& params,
+                                            const MatchExpression* filter) {
+    if (internalQueryParallelCollectionScanPartitions.load() <= 1) {
+        return false;
+    }
+
+    // Only a plain forward scan over the whole of a regular collection can be split into ranges.
+    if (!collection || collection->isCapped() || collection->ns().isOplog() || params.tailable ||
+        params.direction != CollectionScanParams::FORWARD || !params.start.isNull() ||
+        params.maxTs || params.shouldTrackLatestOplogTimestamp ||
+        params.stopApplyingFilterAfterFirstMatch || params.shouldWaitForOplogVisibility) {
+        return false;
+    }
+
+    // The workers cannot take part in our write unit of work, which is also where the operations of
+    // a multi-document transaction run.
+    if (opCtx->lockState()->inAWriteUnitOfWork()) {
+        return false;
+    }
+
+    // The workers evaluate the filter concurrently. $where and $expr evaluate through state which
+    // is not safe to share between threads, and nor are collators or the statistics an adaptively
+    // ordered $and keeps.
+    if (cq.getCollator()) {
+        return false;
+    }
+    if (filter &&
+        (QueryPlannerCommon::hasNode(filter, MatchExpression::WHERE) ||
+         QueryPlannerCommon::hasNode(filter, MatchExpression::EXPRESSION) ||
+         hasAdaptiveAnd(filter))) {
+        return false;
+    }
+
+    return true;
+}
+
+void ParallelCollectionScan::initPartitions() {
+    const RecordStore* recordStore = collection()->getRecordStore();
+    auto first = recordStore->getCursor(getOpCtx(), true)->next();
+    if (!first) {
+        return;
+    }
+    auto last = recordStore->getCursor(getOpCtx(), false)->next();
+    invariant(last);
+
+    // Split [first, last] into ranges of equal width. Records inserted past 'last' are picked up
+    // by the final range, which is unbounded above.
+    const long long low = first->id.repr();
+    const unsigned long long span = static_cast<unsigned long long>(last->id.repr() - low) + 1;
+    const size_t numPartitions = static_cast<size_t>(
+        std::min(static_cast<unsigned long long>(_requestedPartitions), span));
+    const unsigned long long width = span / numPartitions;
+
+    ServiceContext* serviceContext = getOpCtx()->getServiceContext();
+    for (size_t i = 0; i < numPartitions; ++i) {
+        auto partition = std::make_unique<Partition>();
+        partition->start = RecordId(low + static_cast<long long>(width * i));
+        if (i + 1 < numPartitions) {
+            partition->end = RecordId(low + static_cast<long long>(width * (i + 1)));
+        }
+
+        partition->client =
+            serviceContext->makeClient(str::stream() << "parallelCollScan-" << i);
+        partition->opCtx = partition->client->makeOperationContext();
+
+        // A worker must never wait for a lock or a ticket, since what it would wait for may itself
+        // be queued behind our operation.
+        partition->opCtx->lockState()->setMaxLockTimeout(Milliseconds(0));
+
+        _partitions.push_back(std::move(partition));
+    }
+    _specificStats.numPartitions = _partitions.size();
+
+    ThreadPool::Options options;
+    options.poolName = "ParallelCollectionScan";
+    options.threadNamePrefix = "parallelCollScan-";
+    options.minThreads = 0;
+    options.maxThreads = _partitions.size();
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName.c_str());
+    };
+    _pool = std::make_unique<ThreadPool>(options);
+    _pool->startup();
+
+    LOG(1) << "Scanning " << collection()->ns() << " in " << _partitions.size()
+           << " parallel partitions";
+}
+
+PlanStage::StageState ParallelCollectionScan::doWork(WorkingSetID* out) {
+    if (_commonStats.isEOF) {
+        return PlanStage::IS_EOF;
+    }
+
+    if (!_pool) {
+        initPartitions();
+        if (_partitions.empty()) {
+            _commonStats.isEOF = true;
+            return PlanStage::IS_EOF;
+        }
+    }
+
+    // Hand out the buffered results, taking from each partition in turn.
+    for (size_t i = 0; i < _partitions.size(); ++i) {
+        Partition* partition = _partitions[_nextPartition].get();
+        _nextPartition = (_nextPartition + 1) % _partitions.size();
+        if (partition->results.empty()) {
+            continue;
+        }
+
+        WorkingSetID id = _workingSet->allocate();
+        WorkingSetMember* member = _workingSet->get(id);
+        member->recordId = partition->results.front().first;
+
+        // The document was read by another recovery unit, so it carries a snapshot id which
+        // never matches ours. Stages that depend on the snapshot will fetch it again.
+        member->obj = {SnapshotId(), std::move(partition->results.front().second)};
+        _workingSet->transitionToRecordIdAndObj(id);
+        partition->results.pop_front();
+
+        *out = id;
+        return PlanStage::ADVANCED;
+    }
+
+    if (std::all_of(_partitions.begin(), _partitions.end(), [](const auto& partition) {
+            return partition->eof;
+        })) {
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
+    bool madeProgress = false;
+    Status status = runRound(&madeProgress);
+    if (!status.isOK()) {
+        *out = WorkingSetCommon::allocateStatusMember(_workingSet, status);
+        return PlanStage::FAILURE;
+    }
+
+    if (!madeProgress) {
+        // Yield our own locks, so that a queued request which blocks the workers can go ahead.
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
+Status ParallelCollectionScan::runRound(bool* madeProgress) {
+    ++_specificStats.rounds;
+
+    // If we read at a point in time, so do the workers. This may open our own snapshot.
+    const boost::optional<Timestamp> readTimestamp =
+        getOpCtx()->recoveryUnit()->getPointInTimeReadTimestamp();
+
+    std::vector<Partition*> scheduled;
+    for (auto&& partition : _partitions) {
+        if (!partition->eof) {
+            partition->lockTimedOut = false;
+            scheduled.push_back(partition.get());
+        }
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _outstandingWorkers = scheduled.size();
+    }
+
+    for (Partition* partition : scheduled) {
+        _pool->schedule([this, partition, readTimestamp](Status status) {
+            if (status.isOK()) {
+                scanPartition(partition, readTimestamp);
+            } else {
+                partition->status = status;
+            }
+
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (--_outstandingWorkers == 0) {
+                _roundDone.notify_all();
+            }
+        });
+    }
+
+    // The wait is not interruptible, since the workers refer to this stage. A round is short.
+    {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _roundDone.wait(lk, [&] { return _outstandingWorkers == 0; });
+    }
+
+    *madeProgress = false;
+    Status firstError = Status::OK();
+    for (Partition* partition : scheduled) {
+        _specificStats.docsTested += partition->docsTested;
+        partition->docsTested = 0;
+        if (!partition->lockTimedOut) {
+            *madeProgress = true;
+        }
+        if (!partition->status.isOK() && firstError.isOK()) {
+            firstError = partition->status;
+        }
+    }
+    return firstError;
+}
+
+void ParallelCollectionScan::scanPartition(Partition* partition,
+                                           boost::optional<Timestamp> readTimestamp) {
+    AlternativeClientRegion acr(partition->client);
+    OperationContext* opCtx = partition->opCtx.get();
+
+    try {
+        Lock::GlobalLock globalLock(opCtx, MODE_IS);
+
+        // Between rounds the worker holds neither a lock nor a snapshot, so it chooses how to read
+        // afresh each time.
+        opCtx->recoveryUnit()->setTimestampReadSource(readTimestamp
+                                                          ? RecoveryUnit::ReadSource::kProvided
+                                                          : RecoveryUnit::ReadSource::kUnset,
+                                                      readTimestamp);
+
+        if (!partition->cursor) {
+            partition->cursor = collection()->getRecordStore()->getCursor(opCtx, true);
+        } else {
+            invariant(partition->cursor->restore());
+        }
+
+        ON_BLOCK_EXIT([&] {
+            partition->cursor->save();
+            opCtx->recoveryUnit()->abandonSnapshot();
+        });
+
+        size_t bytesBuffered = 0;
+        for (size_t i = 0; i < kMaxRecordsPerRound && bytesBuffered < kMaxBytesPerRound; ++i) {
+            boost::optional<Record> record = partition->positioned
+                ? partition->cursor->next()
+                : partition->cursor->seekAtOrAfter(partition->start);
+            partition->positioned = true;
+
+            if (!record || (!partition->end.isNull() && record->id >= partition->end)) {
+                partition->eof = true;
+                return;
+            }
+
+            ++partition->docsTested;
+            BSONObj obj = record->data.releaseToBson();
+            if (!_filter || _filter->matchesBSON(obj)) {
+                bytesBuffered += obj.objsize();
+                partition->results.emplace_back(record->id, obj.getOwned());
+            }
+        }
+    } catch (const ExceptionFor<ErrorCodes::LockTimeout>&) {
+        partition->lockTimedOut = true;
+    } catch (const WriteConflictException&) {
+        // The cursor has been saved where it was, so the next round simply carries on.
+    } catch (const DBException& ex) {
+        partition->status = ex.toStatus();
+    }
+}
+
+bool ParallelCollectionScan::isEOF() {
+    return _commonStats.isEOF;
+}
+
+void ParallelCollectionScan::doSaveStateRequiresCollection() {
+    // No worker holds a position which needs saving outside of a round.
+}
+
+void ParallelCollectionScan::doRestoreStateRequiresCollection() {}
+
+unique_ptr<PlanStageStats> ParallelCollectionScan::getStats() {
+    // Add a BSON representation of the filter to the stats tree, if there is one.
+    if (nullptr != _filter) {
+        BSONObjBuilder bob;
+        _filter->serialize(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
+    unique_ptr<PlanStageStats> ret =
+        std::make_unique<PlanStageStats>(_commonStats, STAGE_PARALLEL_COLLSCAN);
+    ret->specific = std::make_unique<ParallelCollectionScanStats>(_specificStats);
+    return ret;
+}
+
+const SpecificStats* ParallelCollectionScan::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
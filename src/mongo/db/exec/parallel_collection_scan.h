@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+class MatchExpression;
+class SeekableRecordCursor;
+class WorkingSet;
+struct CollectionScanParams;
+
+/**
+ * Scans a collection by splitting its RecordId space into contiguous ranges and reading the ranges
+ * concurrently, each on a thread of our own pool with its own Client, OperationContext and
+ * RecoveryUnit. Matching documents are returned in no particular order.
+ *
+ * Scanning proceeds in rounds. In each call to work() which finds no buffered results, every
+ * unfinished range reads up to a fixed number of records from where it left off, and applies the
+ * filter to them. The round ends before work() returns, so no worker touches the collection while
+ * this stage's own operation does not hold its locks. When our operation reads at a point in time,
+ * every worker reads at that same timestamp. Otherwise each worker, like a yielding CollectionScan,
+ * sees the latest data as of the start of its current snapshot.
+ *
+ * A worker which cannot immediately acquire its global lock, because a conflicting request is
+ * queued behind our operation's own, gives up the round. If no worker could make progress, the
+ * stage requests a yield so that the queued request can go ahead.
+ */
+class ParallelCollectionScan final : public RequiresCollectionStage {
+public:
+    static const char* kStageType;
+
+    ParallelCollectionScan(OperationContext* opCtx,
+                           const Collection* collection,
+                           size_t numPartitions,
+                           WorkingSet* workingSet,
+                           const MatchExpression* filter);
+
+    ~ParallelCollectionScan();
+
+    /**
+     * Returns true if a scan described by 'params', with the filter and collation of 'cq', may be
+     * run by this stage rather than by a CollectionScan, and the internalQueryParallelCollection-
+     * ScanPartitions knob asks for more than one partition.
+     */
+    static bool canParallelize(OperationContext* opCtx,
+                               const Collection* collection,
+                               const CanonicalQuery& cq,
+                               const CollectionScanParams& params,
+                               const MatchExpression* filter);
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+
+    StageType stageType() const final {
+        return STAGE_PARALLEL_COLLSCAN;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+protected:
+    void doSaveStateRequiresCollection() final;
+
+    void doRestoreStateRequiresCollection() final;
+
+private:
+    /**
+     * One contiguous range of the collection, scanned by a worker.
+     */
+    struct Partition {
+        // Scans [start, end). A null 'end' means the range is unbounded above.
+        RecordId start;
+        RecordId end;
+
+        ServiceContext::UniqueClient client;
+        ServiceContext::UniqueOperationContext opCtx;
+        std::unique_ptr<SeekableRecordCursor> cursor;
+
+        // Set once the first record in the range has been sought.
+        bool positioned = false;
+        bool eof = false;
+
+        // Whether a read source still needs to be chosen for the worker's next snapshot.
+        bool needsReadSource = true;
+
+        // The matching documents of the last round, not yet returned.
+        std::deque<std::pair<RecordId, BSONObj>> results;
+
+        // Filled in by the worker over the course of a round.
+        size_t docsTested = 0;
+        bool lockTimedOut = false;
+        Status status = Status::OK();
+    };
+
+    /**
+     * Computes the range boundaries from the collection's first and last RecordIds, and creates
+     * the worker pool.
+     */
+    void initPartitions();
+
+    /**
+     * Runs one round of the scan over every unfinished partition, and waits for it to end. Sets
+     * 'madeProgress' to false if no partition could run because of a lock it could not acquire.
+     * Returns the first error that a worker ran into, if any.
+     */
+    Status runRound(bool* madeProgress);
+
+    /**
+     * Reads the next records of 'partition'. Runs on a thread of '_pool'.
+     */
+    void scanPartition(Partition* partition, boost::optional<Timestamp> readTimestamp);
+
+    // WorkingSet is not owned by us.
+    WorkingSet* _workingSet;
+
+    // The filter is not owned by us.
+    const MatchExpression* _filter;
+
+    const size_t _requestedPartitions;
+
+    std::vector<std::unique_ptr<Partition>> _partitions;
+
+    // Partition we take the next buffered result from.
+    size_t _nextPartition = 0;
+
+    // Null until partitions are initialized.
+    std::unique_ptr<ThreadPool> _pool;
+
+    // Protects '_outstandingWorkers' for the duration of a round.
+    stdx::mutex _mutex;
+    stdx::condition_variable _roundDone;
+    size_t _outstandingWorkers = 0;
+
+    ParallelCollectionScanStats _specificStats;
+};
+
+}  // namespace mongo
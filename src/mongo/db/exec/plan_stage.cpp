@@ -33,6 +33,7 @@
 
 #include "mongo/db/exec/plan_stage.h"
 
+#include "mongo/db/exec/hardware_counters.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
@@ -42,8 +43,21 @@ namespace mongo {
 PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     invariant(_opCtx);
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    boost::optional<ScopedDetailedTimer> detailedTimer;
+    if (_detailedStats) {
+        detailedTimer.emplace(&_commonStats.executionTimeNanos,
+                              _hardwareCounters ? &_commonStats.instructions : nullptr,
+                              _hardwareCounters ? &_commonStats.llcMisses : nullptr);
+    }
     ++_commonStats.works;
 
+    if (_deferredBatchState) {
+        StageState deferred = _deferredBatchState->first;
+        *out = _deferredBatchState->second;
+        _deferredBatchState = boost::none;
+        return deferred;
+    }
+
     StageState workResult = doWork(out);
 
     if (StageState::ADVANCED == workResult) {
@@ -57,6 +71,79 @@ PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     return workResult;
 }
 
+PlanStage::StageState PlanStage::workBatch(size_t maxResults, std::vector<WorkingSetID>* out) {
+    invariant(_opCtx);
+    invariant(maxResults > 0);
+    invariant(out->empty());
+    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    boost::optional<ScopedDetailedTimer> detailedTimer;
+    if (_detailedStats) {
+        detailedTimer.emplace(&_commonStats.executionTimeNanos,
+                              _hardwareCounters ? &_commonStats.instructions : nullptr,
+                              _hardwareCounters ? &_commonStats.llcMisses : nullptr);
+    }
+    ++_commonStats.works;
+
+    StageState workResult;
+    if (_deferredBatchState) {
+        workResult = _deferredBatchState->first;
+        if (workResult == NEED_YIELD || workResult == FAILURE) {
+            out->push_back(_deferredBatchState->second);
+        }
+        _deferredBatchState = boost::none;
+    } else {
+        workResult = doWorkBatch(maxResults, out);
+    }
+
+    if (StageState::ADVANCED == workResult) {
+        invariant(!out->empty());
+        _commonStats.advanced += out->size();
+    } else if (StageState::NEED_TIME == workResult) {
+        ++_commonStats.needTime;
+    } else if (StageState::NEED_YIELD == workResult) {
+        ++_commonStats.needYield;
+    }
+
+    return workResult;
+}
+
+PlanStage::StageState PlanStage::doWorkBatch(size_t maxResults, std::vector<WorkingSetID>* out) {
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState state = doWork(&id);
+    if (ADVANCED == state || NEED_YIELD == state || FAILURE == state) {
+        out->push_back(id);
+    }
+    return state;
+}
+
+PlanStage::StageState PlanStage::deferBatchState(StageState state,
+                                                 WorkingSetID id,
+                                                 std::vector<WorkingSetID>* out) {
+    if (out->empty()) {
+        if (NEED_YIELD == state || FAILURE == state) {
+            out->push_back(id);
+        }
+        return state;
+    }
+
+    deferState(state, id);
+    return ADVANCED;
+}
+
+void PlanStage::enableDetailedStats(bool withHardwareCounters) {
+    for (auto&& child : _children) {
+        child->enableDetailedStats(withHardwareCounters);
+    }
+
+    HardwareCounters::Sample sample;
+    _detailedStats = true;
+    _hardwareCounters = withHardwareCounters && HardwareCounters::read(&sample);
+    if (_hardwareCounters && _commonStats.instructions < 0) {
+        _commonStats.instructions = 0;
+        _commonStats.llcMisses = 0;
+    }
+}
+
 void PlanStage::saveState() {
     ++_commonStats.yields;
     for (auto&& child : _children) {
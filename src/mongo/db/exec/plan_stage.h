@@ -29,7 +29,9 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "mongo/db/exec/plan_stats.h"
@@ -193,6 +195,25 @@ public:
      */
     StageState work(WorkingSetID* out);
 
+    /**
+     * Batched variant of work(). Asks the stage to produce up to 'maxResults' results, appending
+     * their ids to 'out', which must be empty on entry. A batch counts as a single unit of work
+     * in the stage's stats.
+     *
+     * Returns ADVANCED if at least one result was produced. Otherwise returns the state work()
+     * would have returned; for NEED_YIELD and FAILURE, 'out' then holds exactly the one
+     * WorkingSetID that work() would have placed in its out parameter. If any state other than
+     * ADVANCED or NEED_TIME is reached after some results have already been produced, the batch
+     * is returned as ADVANCED and that state is reported by the next call to work() or
+     * workBatch().
+     *
+     * Every member of the batch remains valid until the next call to work() or workBatch(), or
+     * until the next yield, exactly as the single result of work() would. Stages which reposition
+     * a storage engine cursor between results must therefore take ownership of the data of the
+     * earlier results.
+     */
+    StageState workBatch(size_t maxResults, std::vector<WorkingSetID>* out);
+
     /**
      * Returns true if no more work can be done on the query / out of results.
      */
@@ -335,12 +356,50 @@ public:
      */
     virtual const SpecificStats* getSpecificStats() const = 0;
 
+    /**
+     * Makes this stage and its children also measure the time spent in each call to work() in
+     * nanoseconds, at the cost of reading the steady clock twice per call. If
+     * 'withHardwareCounters' is true, also counts the instructions and last level cache misses of
+     * each call, which costs two more system calls per call. Used by explain at the
+     * "executionStatsDetailed" verbosity.
+     *
+     * Only affects the stages which exist at the time of the call.
+     */
+    void enableDetailedStats(bool withHardwareCounters);
+
 protected:
     /**
      * Performs one unit of work.  See comment at work() above.
      */
     virtual StageState doWork(WorkingSetID* out) = 0;
 
+    /**
+     * Produces a batch of results. See comment at workBatch() above.
+     *
+     * The default implementation performs a single call to doWork(), and so produces at most one
+     * result. It cannot do more in general, since a further call to doWork() may reposition a
+     * storage engine cursor which backs the previous result. Stages that can produce results more
+     * cheaply in bulk should override this.
+     */
+    virtual StageState doWorkBatch(size_t maxResults, std::vector<WorkingSetID>* out);
+
+    /**
+     * Helper for doWorkBatch() implementations which have reached state 'state' after appending
+     * zero or more results to 'out'. If 'out' is empty, reports 'state' immediately, along with
+     * 'id' for NEED_YIELD and FAILURE. Otherwise returns ADVANCED and holds 'state' back for the
+     * next call to work() or workBatch().
+     */
+    StageState deferBatchState(StageState state, WorkingSetID id, std::vector<WorkingSetID>* out);
+
+    /**
+     * Holds back 'state', along with the WorkingSetID that accompanies it, so that it is reported
+     * by the next call to work() or workBatch() instead of calling doWork() or doWorkBatch().
+     */
+    void deferState(StageState state, WorkingSetID id) {
+        invariant(!_deferredBatchState);
+        _deferredBatchState = std::make_pair(state, id);
+    }
+
     /**
      * Saves any stage-specific state required to resume where it was if the underlying data
      * changes.
@@ -386,6 +445,14 @@ protected:
 
 private:
     OperationContext* _opCtx;
+
+    // A state held back by deferState(), along with the WorkingSetID that accompanies it.
+    // Reported by the next call to work() or workBatch().
+    boost::optional<std::pair<StageState, WorkingSetID>> _deferredBatchState;
+
+    // Set by enableDetailedStats().
+    bool _detailedStats = false;
+    bool _hardwareCounters = false;
 };
 
 }  // namespace mongo
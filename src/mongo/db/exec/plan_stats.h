@@ -64,6 +64,9 @@ struct CommonStats {
           needTime(0),
           needYield(0),
           executionTimeMillis(0),
+          executionTimeNanos(0),
+          instructions(-1),
+          llcMisses(-1),
           isEOF(false) {}
     // String giving the type of the stage. Not owned.
     const char* stageTypeStr;
@@ -85,6 +88,13 @@ struct CommonStats {
     // Time elapsed while working inside this stage.
     long long executionTimeMillis;
 
+    // Only collected once PlanStage::enableDetailedStats() has been called. The hardware counters
+    // are -1 if they were not requested or could not be read. All three include the work done by
+    // the children of the stage.
+    long long executionTimeNanos;
+    long long instructions;
+    long long llcMisses;
+
     // TODO: have some way of tracking WSM sizes (or really any series of #s).  We can measure
     // the size of our inputs and the size of our outputs.  We can do a lot with the WS here.
 
@@ -202,6 +212,24 @@ struct CollectionScanStats : public SpecificStats {
     boost::optional<Timestamp> maxTs;
 };
 
+struct ParallelCollectionScanStats : public SpecificStats {
+    ParallelCollectionScanStats() = default;
+
+    SpecificStats* clone() const final {
+        ParallelCollectionScanStats* specific = new ParallelCollectionScanStats(*this);
+        return specific;
+    }
+
+    // How many documents did the workers check against our filter?
+    size_t docsTested = 0u;
+
+    // The number of ranges the collection was split into, each scanned by its own worker.
+    size_t numPartitions = 0u;
+
+    // The number of times the workers were set to scan their ranges.
+    size_t rounds = 0u;
+};
+
 struct CountStats : public SpecificStats {
     CountStats() : nCounted(0), nSkipped(0) {}
 
@@ -217,6 +245,22 @@ struct CountStats : public SpecificStats {
     long long nSkipped;
 };
 
+struct SampledCountStats : public SpecificStats {
+    SpecificStats* clone() const final {
+        return new SampledCountStats(*this);
+    }
+
+    // The estimated result of the count.
+    long long nCounted = 0;
+
+    // The number of results we skipped over.
+    long long nSkipped = 0;
+
+    // The number of documents read at random, and how many of them matched the query.
+    long long docsSampled = 0;
+    long long docsMatched = 0;
+};
+
 struct CountScanStats : public SpecificStats {
     CountScanStats()
         : indexVersion(0),
@@ -339,6 +383,9 @@ struct FetchStats : public SpecificStats {
 
     // The total number of full documents touched by the fetch stage.
     size_t docsExamined = 0u;
+
+    // The number of records hinted to the storage engine ahead of being fetched.
+    size_t docsPrefetched = 0u;
 };
 
 struct IDHackStats : public SpecificStats {
@@ -491,6 +538,17 @@ struct SortStats : public SpecificStats {
 
     // The pattern according to which we are sorting.
     BSONObj sortPattern;
+
+    // The number of times the sort exceeded its memory limit and handed its data to an external
+    // sorter. This is at most 1.
+    size_t spills = 0u;
+
+    // Did the external sorter write any data to disk?
+    bool usedDisk = false;
+
+    // The number of documents which the sort key generator below a limited sort discarded
+    // because they could not make the top 'limit' results.
+    size_t topKRejected = 0u;
 };
 
 struct MergeSortStats : public SpecificStats {
@@ -181,6 +181,32 @@ PlanStage::StageState ProjectionStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState ProjectionStage::doWorkBatch(size_t maxResults,
+                                                   std::vector<WorkingSetID>* out) {
+    StageState status = child()->workBatch(maxResults, out);
+    if (PlanStage::ADVANCED != status) {
+        // For FAILURE and NEED_YIELD, 'out' already holds the WorkingSetID from our child.
+        return status;
+    }
+
+    for (size_t i = 0; i < out->size(); ++i) {
+        Status projStatus = transform(_ws.get((*out)[i]));
+        if (!projStatus.isOK()) {
+            warning() << "Couldn't execute projection, status = " << redact(projStatus);
+            // Results projected before the failure are still returned.
+            for (size_t j = i; j < out->size(); ++j) {
+                _ws.free((*out)[j]);
+            }
+            out->resize(i);
+            return deferBatchState(PlanStage::FAILURE,
+                                   WorkingSetCommon::allocateStatusMember(&_ws, projStatus),
+                                   out);
+        }
+    }
+
+    return PlanStage::ADVANCED;
+}
+
 std::unique_ptr<PlanStageStats> ProjectionStage::getStats() {
     _commonStats.isEOF = isEOF();
     auto ret = std::make_unique<PlanStageStats>(_commonStats, stageType());
@@ -54,6 +54,7 @@ protected:
 public:
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxResults, std::vector<WorkingSetID>* out) final;
 
     std::unique_ptr<PlanStageStats> getStats() final;
 
@@ -0,0 +1,133 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+const size_t RecordIdBitmap::kMaxArraySize;
+
+void RecordIdBitmap::add(const RecordId& id) {
+    Chunk& chunk = _chunks[highBits(id)];
+    const uint16_t low = lowBits(id);
+
+    if (chunk.isBitmap()) {
+        uint64_t& word = chunk.bitmap[low / 64];
+        const uint64_t bit = uint64_t{1} << (low % 64);
+        if (!(word & bit)) {
+            word |= bit;
+            ++chunk.size;
+            ++_size;
+        }
+        return;
+    }
+
+    auto it = std::lower_bound(chunk.array.begin(), chunk.array.end(), low);
+    if (it != chunk.array.end() && *it == low) {
+        return;
+    }
+    chunk.array.insert(it, low);
+    ++chunk.size;
+    ++_size;
+
+    if (chunk.size > kMaxArraySize) {
+        chunk.bitmap.assign(kBitmapWords, 0);
+        for (auto value : chunk.array) {
+            chunk.bitmap[value / 64] |= uint64_t{1} << (value % 64);
+        }
+        std::vector<uint16_t>().swap(chunk.array);
+    }
+}
+
+bool RecordIdBitmap::contains(const RecordId& id) const {
+    auto chunkIt = _chunks.find(highBits(id));
+    if (chunkIt == _chunks.end()) {
+        return false;
+    }
+
+    const Chunk& chunk = chunkIt->second;
+    const uint16_t low = lowBits(id);
+    if (chunk.isBitmap()) {
+        return chunk.bitmap[low / 64] & (uint64_t{1} << (low % 64));
+    }
+    return std::binary_search(chunk.array.begin(), chunk.array.end(), low);
+}
+
+bool RecordIdBitmap::remove(const RecordId& id) {
+    auto chunkIt = _chunks.find(highBits(id));
+    if (chunkIt == _chunks.end()) {
+        return false;
+    }
+
+    Chunk& chunk = chunkIt->second;
+    const uint16_t low = lowBits(id);
+    if (chunk.isBitmap()) {
+        uint64_t& word = chunk.bitmap[low / 64];
+        const uint64_t bit = uint64_t{1} << (low % 64);
+        if (!(word & bit)) {
+            return false;
+        }
+        word &= ~bit;
+    } else {
+        auto it = std::lower_bound(chunk.array.begin(), chunk.array.end(), low);
+        if (it == chunk.array.end() || *it != low) {
+            return false;
+        }
+        chunk.array.erase(it);
+    }
+
+    --_size;
+    if (--chunk.size == 0) {
+        _chunks.erase(chunkIt);
+    }
+    return true;
+}
+
+void RecordIdBitmap::clear() {
+    _chunks.clear();
+    _size = 0;
+}
+
+size_t RecordIdBitmap::getMemUsage() const {
+    // Approximates the cost of a node of the map by the chunk it holds plus three pointers.
+    size_t memUsage = 0;
+    for (auto&& entry : _chunks) {
+        const Chunk& chunk = entry.second;
+        memUsage += sizeof(entry) + 3 * sizeof(void*) +
+            chunk.array.capacity() * sizeof(uint16_t) + chunk.bitmap.capacity() * sizeof(uint64_t);
+    }
+    return memUsage;
+}
+
+}  // namespace mongo
@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * A compressed set of RecordIds, in the style of a roaring bitmap.
+ *
+ * The 64-bit space of RecordIds is cut into chunks of 2^16 consecutive ids, keyed by the high 48
+ * bits. Each chunk which holds any ids is stored as a sorted array of the low 16 bits while it is
+ * sparse, and as a 2^16-bit bitmap once it holds more than kMaxArraySize ids, so that no chunk
+ * takes more than 8KB. Record stores hand out ids densely, so a set of millions of the ids of one
+ * collection takes between one bit and two bytes per id.
+ */
+class RecordIdBitmap {
+public:
+    // A chunk switches to a bitmap once its sorted array would be larger than the bitmap.
+    static const size_t kMaxArraySize = 4096;
+
+    /**
+     * Adds 'id' to the set. Does nothing if it is already present.
+     */
+    void add(const RecordId& id);
+
+    bool contains(const RecordId& id) const;
+
+    /**
+     * Removes 'id' from the set. Returns true if it was present.
+     */
+    bool remove(const RecordId& id);
+
+    void clear();
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Returns an estimate of the heap memory used by the set, in bytes.
+     */
+    size_t getMemUsage() const;
+
+private:
+    static const size_t kChunkBits = 16;
+    static const size_t kBitmapWords = (1 << kChunkBits) / 64;
+
+    struct Chunk {
+        bool isBitmap() const {
+            return !bitmap.empty();
+        }
+
+        // The low bits of the ids in the chunk, sorted, while the chunk is sparse.
+        std::vector<uint16_t> array;
+
+        // One bit per low value once the chunk is dense. Empty otherwise.
+        std::vector<uint64_t> bitmap;
+
+        size_t size = 0;
+    };
+
+    static uint64_t highBits(const RecordId& id) {
+        return static_cast<uint64_t>(id.repr()) >> kChunkBits;
+    }
+
+    static uint16_t lowBits(const RecordId& id) {
+        return static_cast<uint16_t>(id.repr());
+    }
+
+    std::map<uint64_t, Chunk> _chunks;
+
+    size_t _size = 0;
+};
+
+}  // namespace mongo
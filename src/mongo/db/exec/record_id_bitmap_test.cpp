@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <set>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(RecordIdBitmapTest, AddContainsRemove) {
+    RecordIdBitmap bitmap;
+    ASSERT_TRUE(bitmap.empty());
+
+    bitmap.add(RecordId(5));
+    bitmap.add(RecordId(1));
+    bitmap.add(RecordId(5));
+    bitmap.add(RecordId(1LL << 40));
+    ASSERT_EQ(bitmap.size(), 3U);
+    ASSERT_TRUE(bitmap.contains(RecordId(1)));
+    ASSERT_TRUE(bitmap.contains(RecordId(5)));
+    ASSERT_TRUE(bitmap.contains(RecordId(1LL << 40)));
+    ASSERT_FALSE(bitmap.contains(RecordId(2)));
+    ASSERT_FALSE(bitmap.contains(RecordId((1LL << 40) + 5)));
+
+    ASSERT_TRUE(bitmap.remove(RecordId(5)));
+    ASSERT_FALSE(bitmap.remove(RecordId(5)));
+    ASSERT_FALSE(bitmap.contains(RecordId(5)));
+    ASSERT_EQ(bitmap.size(), 2U);
+
+    bitmap.clear();
+    ASSERT_TRUE(bitmap.empty());
+    ASSERT_FALSE(bitmap.contains(RecordId(1)));
+}
+
+TEST(RecordIdBitmapTest, DenseChunkBecomesBitmap) {
+    RecordIdBitmap bitmap;
+    const long long kNumIds = 3 * RecordIdBitmap::kMaxArraySize;
+
+    // Add every other id, in an order which is not sorted.
+    for (long long i = kNumIds - 1; i >= 0; --i) {
+        bitmap.add(RecordId(2 * i + 1));
+    }
+    ASSERT_EQ(bitmap.size(), static_cast<size_t>(kNumIds));
+    for (long long i = 0; i < kNumIds; ++i) {
+        ASSERT_TRUE(bitmap.contains(RecordId(2 * i + 1))) << i;
+        ASSERT_FALSE(bitmap.contains(RecordId(2 * i + 2))) << i;
+    }
+
+    // All of the ids fit in one chunk, which is now an 8KB bitmap.
+    ASSERT_LT(bitmap.getMemUsage(), 2 * kNumIds * sizeof(uint16_t));
+
+    for (long long i = 0; i < kNumIds; ++i) {
+        ASSERT_TRUE(bitmap.remove(RecordId(2 * i + 1))) << i;
+    }
+    ASSERT_TRUE(bitmap.empty());
+    ASSERT_EQ(bitmap.getMemUsage(), 0U);
+}
+
+TEST(RecordIdBitmapTest, AgreesWithStdSet) {
+    RecordIdBitmap bitmap;
+    std::set<RecordId> expected;
+
+    // Ids spread over several chunks, some of them dense and some sparse.
+    for (long long i = 0; i < 50000; ++i) {
+        const RecordId id((i * 7919) % 200000);
+        bitmap.add(id);
+        expected.insert(id);
+    }
+    ASSERT_EQ(bitmap.size(), expected.size());
+    for (long long i = 0; i < 200000; ++i) {
+        ASSERT_EQ(bitmap.contains(RecordId(i)), expected.count(RecordId(i)) > 0) << i;
+    }
+}
+
+}  // namespace
+}  // namespace mongo
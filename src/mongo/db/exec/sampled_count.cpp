@@ -0,0 +1,142 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/sampled_count.h"
+
+#include <cmath>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/storage/record_store.h"
+
+namespace mongo {
+
+const char* SampledCountStage::kStageType = "SAMPLED_COUNT";
+
+SampledCountStage::SampledCountStage(OperationContext* opCtx,
+                                     Collection* collection,
+                                     std::unique_ptr<RecordCursor> randomCursor,
+                                     const MatchExpression* filter,
+                                     long long sampleSize,
+                                     long long skip,
+                                     long long limit)
+    : RequiresCollectionStage(kStageType, opCtx, collection),
+      _cursor(std::move(randomCursor)),
+      _filter(filter),
+      _sampleSize(sampleSize),
+      _skip(skip),
+      _limit(limit),
+      _numRecords(collection->numRecords(opCtx)) {
+    invariant(_cursor);
+    invariant(_sampleSize > 0);
+    invariant(_skip >= 0);
+    invariant(_limit >= 0);
+}
+
+SampledCountStage::~SampledCountStage() = default;
+
+std::unique_ptr<PlanStageStats> SampledCountStage::getStats() {
+    auto planStats = std::make_unique<PlanStageStats>(_commonStats, STAGE_SAMPLED_COUNT);
+    planStats->specific = std::make_unique<SampledCountStats>(_specificStats);
+    return planStats;
+}
+
+PlanStage::StageState SampledCountStage::doWork(WorkingSetID* out) {
+    // This stage never returns a working set member.
+    *out = WorkingSet::INVALID_ID;
+
+    if (_specificStats.docsSampled >= _sampleSize) {
+        finish();
+        return PlanStage::IS_EOF;
+    }
+
+    boost::optional<Record> record;
+    try {
+        record = _cursor->next();
+    } catch (const WriteConflictException&) {
+        return PlanStage::NEED_YIELD;
+    }
+
+    if (!record) {
+        finish();
+        return PlanStage::IS_EOF;
+    }
+
+    ++_specificStats.docsSampled;
+    if (!_filter || _filter->matchesBSON(record->data.releaseToBson())) {
+        ++_specificStats.docsMatched;
+    }
+    return PlanStage::NEED_TIME;
+}
+
+void SampledCountStage::finish() {
+    long long nCounted = 0;
+    if (_specificStats.docsSampled > 0) {
+        nCounted = std::llround(static_cast<double>(_specificStats.docsMatched) * _numRecords /
+                                _specificStats.docsSampled);
+    }
+
+    if (_skip) {
+        nCounted -= _skip;
+        if (nCounted < 0) {
+            nCounted = 0;
+        }
+    }
+
+    if (_limit < nCounted && 0 != _limit) {
+        nCounted = _limit;
+    }
+
+    _specificStats.nCounted = nCounted;
+    _specificStats.nSkipped = _skip;
+    _commonStats.isEOF = true;
+}
+
+void SampledCountStage::doSaveStateRequiresCollection() {
+    _cursor->save();
+}
+
+void SampledCountStage::doRestoreStateRequiresCollection() {
+    // A random cursor has no position to lose.
+    invariant(_cursor->restore());
+}
+
+void SampledCountStage::doDetachFromOperationContext() {
+    _cursor->detachFromOperationContext();
+}
+
+void SampledCountStage::doReattachToOperationContext() {
+    _cursor->reattachToOperationContext(getOpCtx());
+}
+
+}  // namespace mongo
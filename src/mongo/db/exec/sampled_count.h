@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/db/exec/plan_stats.h"
+#include "mongo/db/exec/requires_collection_stage.h"
+
+namespace mongo {
+
+class MatchExpression;
+class RecordCursor;
+
+/**
+ * Implements an approximate count by reading up to 'sampleSize' documents at random and scaling
+ * the fraction of them which match 'filter' by the number of records in the collection, then
+ * applying the skip and limit. 'randomCursor' must read the collection at random, and may return
+ * the same document more than once. The result is stored in '_specificStats'. Only used to answer
+ * count commands which ask for an approximate count, when the collection has more records than
+ * are sampled.
+ */
+class SampledCountStage final : public RequiresCollectionStage {
+public:
+    static const char* kStageType;
+
+    SampledCountStage(OperationContext* opCtx,
+                      Collection* collection,
+                      std::unique_ptr<RecordCursor> randomCursor,
+                      const MatchExpression* filter,
+                      long long sampleSize,
+                      long long skip,
+                      long long limit);
+
+    ~SampledCountStage();
+
+    bool isEOF() override {
+        return _commonStats.isEOF;
+    }
+
+    StageState doWork(WorkingSetID* out) override;
+
+    StageType stageType() const override {
+        return StageType::STAGE_SAMPLED_COUNT;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() override;
+
+    const SpecificStats* getSpecificStats() const override {
+        return &_specificStats;
+    }
+
+protected:
+    void doSaveStateRequiresCollection() override;
+
+    void doRestoreStateRequiresCollection() override;
+
+    void doDetachFromOperationContext() override;
+
+    void doReattachToOperationContext() override;
+
+private:
+    /**
+     * Computes the estimate from the documents sampled so far and finishes the count.
+     */
+    void finish();
+
+    std::unique_ptr<RecordCursor> _cursor;
+
+    // Not owned. May be null, in which case every document matches.
+    const MatchExpression* _filter;
+
+    long long _sampleSize = 0;
+    long long _skip = 0;
+    long long _limit = 0;
+
+    // The number of records in the collection when the count began.
+    long long _numRecords = 0;
+
+    SampledCountStats _specificStats;
+};
+
+}  // namespace mongo
@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/util/clock_source.h"
+#include "mongo/util/tsc_tick_source.h"
 
 namespace mongo {
 
@@ -42,4 +43,25 @@ ScopedTimer::~ScopedTimer() {
     *_counter += elapsed;
 }
 
+ScopedDetailedTimer::ScopedDetailedTimer(long long* nanos,
+                                         long long* instructions,
+                                         long long* llcMisses)
+    : _nanos(nanos),
+      _instructions(instructions),
+      _llcMisses(llcMisses),
+      _haveCounters(instructions && llcMisses && HardwareCounters::read(&_startCounters)),
+      _tickSource(TscTickSource::get()),
+      _start(_tickSource->getTicks()) {}
+
+ScopedDetailedTimer::~ScopedDetailedTimer() {
+    *_nanos += durationCount<Nanoseconds>(
+        _tickSource->ticksTo<Nanoseconds>(_tickSource->getTicks() - _start));
+
+    HardwareCounters::Sample end;
+    if (_haveCounters && HardwareCounters::read(&end)) {
+        *_instructions += end.instructions - _startCounters.instructions;
+        *_llcMisses += end.llcMisses - _startCounters.llcMisses;
+    }
+}
+
 }  // namespace mongo
@@ -29,7 +29,8 @@
 
 #pragma once
 
-
+#include "mongo/db/exec/hardware_counters.h"
+#include "mongo/util/tick_source.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -58,4 +59,34 @@ private:
     const Date_t _start;
 };
 
+/**
+ * Like ScopedTimer, but measures the elapsed time in nanoseconds with TscTickSource rather than
+ * in milliseconds with a ClockSource. If 'instructions' and 'llcMisses' are non-null, also
+ * adds the number of instructions retired and last level cache misses incurred by this thread
+ * while the timer was in scope, provided the hardware counters can be read.
+ */
+class ScopedDetailedTimer {
+    ScopedDetailedTimer(const ScopedDetailedTimer&) = delete;
+    ScopedDetailedTimer& operator=(const ScopedDetailedTimer&) = delete;
+
+public:
+    ScopedDetailedTimer(long long* nanos, long long* instructions, long long* llcMisses);
+
+    ~ScopedDetailedTimer();
+
+private:
+    long long* const _nanos;
+    long long* const _instructions;
+    long long* const _llcMisses;
+
+    // Declared ahead of '_haveCounters', whose initialization fills it out.
+    HardwareCounters::Sample _startCounters;
+
+    // Whether '_startCounters' could be read, in which case the counters are read again at the end.
+    const bool _haveCounters;
+
+    TickSource* const _tickSource;
+    const TickSource::Tick _start;
+};
+
 }  // namespace mongo
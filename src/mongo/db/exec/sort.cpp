@@ -43,6 +43,8 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -51,6 +53,78 @@ using std::endl;
 using std::unique_ptr;
 using std::vector;
 
+namespace {
+
+// Field names of a working set member serialized for the external sorter. The RecordId must come
+// first, since SpillComparator reads it positionally.
+const char kRecordIdField[] = "r";
+const char kSnapshotIdField[] = "s";
+const char kObjField[] = "o";
+const char kTextScoreField[] = "ts";
+const char kGeoDistanceField[] = "gd";
+const char kIndexKeyField[] = "ik";
+const char kGeoNearPointField[] = "gp";
+
+/**
+ * Generates a new file name on each call using a static, atomic and monotonically increasing
+ * number. See the comment above the version in document_source_sort.cpp.
+ */
+std::string nextFileName() {
+    static AtomicWord<unsigned> sortStageFileCounter;
+    return "extsort-sort-stage." + std::to_string(sortStageFileCounter.fetchAndAdd(1));
+}
+
+/**
+ * Members without a document, such as those of a covered plan, refer to index data which cannot
+ * be serialized.
+ */
+Status checkCanSerialize(const WorkingSetMember& member) {
+    if (!member.hasObj() || !member.keyData.empty()) {
+        return {ErrorCodes::OperationFailed,
+                "Sort exceeded its memory limit and cannot spill to disk because its input comes "
+                "from a covered plan. Add an index, or specify a smaller limit."};
+    }
+    return Status::OK();
+}
+
+/**
+ * Serializes everything in 'member' that a stage above us might look at, other than the sort
+ * key, which the external sorter keeps alongside it.
+ */
+BSONObj serializeMember(const WorkingSetMember& member) {
+    BSONObjBuilder bob;
+    bob.append(kRecordIdField,
+               static_cast<long long>(member.hasRecordId() ? member.recordId.repr() : 0));
+    bob.append(kSnapshotIdField, static_cast<long long>(member.obj.snapshotId().toNumber()));
+    bob.append(kObjField, member.obj.value());
+    if (member.hasComputed(WSM_COMPUTED_TEXT_SCORE)) {
+        bob.append(kTextScoreField,
+                   static_cast<const TextScoreComputedData*>(
+                       member.getComputed(WSM_COMPUTED_TEXT_SCORE))
+                       ->getScore());
+    }
+    if (member.hasComputed(WSM_COMPUTED_GEO_DISTANCE)) {
+        bob.append(kGeoDistanceField,
+                   static_cast<const GeoDistanceComputedData*>(
+                       member.getComputed(WSM_COMPUTED_GEO_DISTANCE))
+                       ->getDist());
+    }
+    if (member.hasComputed(WSM_INDEX_KEY)) {
+        bob.append(
+            kIndexKeyField,
+            static_cast<const IndexKeyComputedData*>(member.getComputed(WSM_INDEX_KEY))->getKey());
+    }
+    if (member.hasComputed(WSM_GEO_NEAR_POINT)) {
+        bob.append(kGeoNearPointField,
+                   static_cast<const GeoNearPointComputedData*>(
+                       member.getComputed(WSM_GEO_NEAR_POINT))
+                       ->getPoint());
+    }
+    return bob.obj();
+}
+
+}  // namespace
+
 // static
 const char* SortStage::kStageType = "SORT";
 
@@ -67,6 +141,19 @@ bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
     return lhs.recordId < rhs.recordId;
 }
 
+int SortStage::SpillComparator::operator()(const SpillSorter::Data& lhs,
+                                           const SpillSorter::Data& rhs) const {
+    // False means ignore field names.
+    int result = lhs.first.woCompare(rhs.first, pattern, false);
+    if (0 != result) {
+        return result;
+    }
+    // Break ties on RecordId, as WorkingSetComparator does.
+    const long long lhsRecordId = lhs.second.firstElement()._numberLong();
+    const long long rhsRecordId = rhs.second.firstElement()._numberLong();
+    return lhsRecordId < rhsRecordId ? -1 : (lhsRecordId > rhsRecordId ? 1 : 0);
+}
+
 SortStage::SortStage(OperationContext* opCtx,
                      const SortStageParams& params,
                      WorkingSet* ws,
@@ -77,17 +164,16 @@ SortStage::SortStage(OperationContext* opCtx,
       _limit(params.limit),
       _sorted(false),
       _resultIterator(_data.end()),
-      _memUsage(0) {
+      _memUsage(0),
+      _allowDiskUse(params.allowDiskUse) {
     _children.emplace_back(child);
 
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
     _sortKeyComparator = std::make_unique<WorkingSetComparator>(sortComparator);
 
-    // If limit > 1, we need to initialize _dataSet here to maintain ordered set of data items while
-    // fetching from the child stage.
-    if (_limit > 1) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        _dataSet.reset(new SortableDataItemSet(cmp));
+    // A limited sort can tell the stage generating its sort keys which documents to skip.
+    if (_limit > 0 && child->stageType() == STAGE_SORT_KEY_GENERATOR) {
+        _sortKeyGenChild = static_cast<SortKeyGeneratorStage*>(child);
     }
 }
 
@@ -96,18 +182,36 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
+    if (_spillIterator) {
+        return child()->isEOF() && !_spillIterator->more();
+    }
     return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
-    if (_memUsage > maxBytes) {
-        str::stream ss;
-        ss << "Sort operation used more than the maximum " << maxBytes
-           << " bytes of RAM. Add an index, or specify a smaller limit.";
-        Status status(ErrorCodes::OperationFailed, ss);
-        *out = WorkingSetCommon::allocateStatusMember(_ws, status);
-        return PlanStage::FAILURE;
+    _trackedMemUsage.set(getOpCtx(), _memUsage);
+
+    // While buffering, the sort also gives up its memory early when all queries together use
+    // more than their budget.
+    const bool overBudget = !_sorted && !_sorter && _trackedMemUsage.shouldSpill();
+    if (_memUsage > maxBytes || overBudget) {
+        Status status = Status::OK();
+        if (_allowDiskUse) {
+            status = spill();
+        } else if (_memUsage > maxBytes) {
+            str::stream ss;
+            ss << "Sort operation used more than the maximum " << maxBytes
+               << " bytes of RAM. Add an index, or specify a smaller limit.";
+            status = Status(ErrorCodes::OperationFailed, ss);
+        } else {
+            status = _trackedMemUsage.checkBudget();
+        }
+
+        if (!status.isOK()) {
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            return PlanStage::FAILURE;
+        }
     }
 
     if (isEOF()) {
@@ -136,10 +240,25 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
                 item.recordId = member->recordId;
             }
 
-            addToBuffer(item);
+            if (_sorter) {
+                Status status = addToSorter(item);
+                if (!status.isOK()) {
+                    *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+                    return PlanStage::FAILURE;
+                }
+            } else {
+                addToBuffer(item);
+            }
 
             return PlanStage::NEED_TIME;
         } else if (PlanStage::IS_EOF == code) {
+            if (_sorter) {
+                _spillIterator.reset(_sorter->done());
+                _specificStats.usedDisk = _sorter->usedDisk();
+                _sorted = true;
+                return PlanStage::NEED_TIME;
+            }
+
             // TODO: We don't need the lock for this.  We could ask for a yield and do this work
             // unlocked.  Also, this is performing a lot of work for one call to work(...)
             sortBuffer();
@@ -160,6 +279,11 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     }
 
     // Returning results.
+    if (_spillIterator) {
+        *out = nextFromSorter();
+        return PlanStage::ADVANCED;
+    }
+
     verify(_resultIterator != _data.end());
     verify(_sorted);
     *out = _resultIterator->wsid;
@@ -175,6 +299,9 @@ unique_ptr<PlanStageStats> SortStage::getStats() {
     _specificStats.memUsage = _memUsage;
     _specificStats.limit = _limit;
     _specificStats.sortPattern = _pattern.getOwned();
+    if (_sortKeyGenChild) {
+        _specificStats.topKRejected = _sortKeyGenChild->getNumRejectedByTopKBound();
+    }
 
     unique_ptr<PlanStageStats> ret = std::make_unique<PlanStageStats>(_commonStats, STAGE_SORT);
     ret->specific = std::make_unique<SortStats>(_specificStats);
@@ -201,16 +328,20 @@ const SpecificStats* SortStage::getSpecificStats() const {
  *                     Updates memory usage if item was replaced.
  *     sortBuffer() - Does nothing.
  * limit > 1:
- *     addToBuffer() - Does not update vector. Adds item to set.
- *                     If size of set exceeds limit, remove item from set
+ *     addToBuffer() - Pushes item onto the heap in vector.
+ *                     If size of heap exceeds limit, pop the item
  *                     with lowest key. Updates memory usage accordingly.
- *     sortBuffer() - Copies items from set to vectors.
+ *     sortBuffer() - Sorts the heap.
+ *
+ * With a limit, once the vector is full, addToBuffer() also keeps the
+ * sort key generator below us informed of the lowest key it holds.
  */
 void SortStage::addToBuffer(const SortableDataItem& item) {
     // Holds ID of working set member to be freed at end of this function.
     WorkingSetID wsidToFree = WorkingSet::INVALID_ID;
 
     WorkingSetMember* member = _ws->get(item.wsid);
+    const WorkingSetComparator& cmp = *_sortKeyComparator;
     if (_limit == 0) {
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         member->makeObjOwnedIfNeeded();
@@ -221,48 +352,39 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
             member->makeObjOwnedIfNeeded();
             _data.push_back(item);
             _memUsage = member->getMemUsage();
-            return;
-        }
-        wsidToFree = item.wsid;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        // Compare new item with existing item in vector.
-        if (cmp(item, _data[0])) {
-            wsidToFree = _data[0].wsid;
-            member->makeObjOwnedIfNeeded();
-            _data[0] = item;
-            _memUsage = member->getMemUsage();
+        } else {
+            wsidToFree = item.wsid;
+            // Compare new item with existing item in vector.
+            if (cmp(item, _data[0])) {
+                wsidToFree = _data[0].wsid;
+                member->makeObjOwnedIfNeeded();
+                _data[0] = item;
+                _memUsage = member->getMemUsage();
+            }
         }
+    } else if (_data.size() < _limit) {
+        // Limit not reached - push onto the heap.
+        member->makeObjOwnedIfNeeded();
+        _data.push_back(item);
+        std::push_heap(_data.begin(), _data.end(), cmp);
+        _memUsage += member->getMemUsage();
     } else {
-        // Update data item set instead of vector
-        // Limit not reached - insert and return
-        vector<SortableDataItem>::size_type limit(_limit);
-        if (_dataSet->size() < limit) {
-            member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
-            _memUsage += member->getMemUsage();
-            return;
-        }
-        // Limit will be exceeded - compare with item with lowest key
-        // If new item does not have a lower key value than last item,
-        // do nothing.
+        // Limit will be exceeded - compare with item with lowest key, at the front of the heap.
+        // If new item does not have a lower key value than that item, do nothing.
         wsidToFree = item.wsid;
-        SortableDataItemSet::const_iterator lastItemIt = --(_dataSet->end());
-        const SortableDataItem& lastItem = *lastItemIt;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        if (cmp(item, lastItem)) {
-            _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
+        if (cmp(item, _data.front())) {
+            _memUsage -= _ws->get(_data.front().wsid)->getMemUsage();
             _memUsage += member->getMemUsage();
-            wsidToFree = lastItem.wsid;
-            // According to std::set iterator validity rules,
-            // it does not matter which of erase()/insert() happens first.
-            // Here, we choose to erase first to release potential resources
-            // used by the last item and to keep the scope of the iterator to a minimum.
-            _dataSet->erase(lastItemIt);
+            wsidToFree = _data.front().wsid;
+            std::pop_heap(_data.begin(), _data.end(), cmp);
             member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
+            _data.back() = item;
+            std::push_heap(_data.begin(), _data.end(), cmp);
         }
     }
 
+    updateTopKBound();
+
     // There was a buffered result which we can throw out because we are executing a sort with a
     // limit, and the result is now known not to be in the top k set. Free the working set member
     // associated with 'wsidToFree'.
@@ -271,6 +393,94 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
     }
 }
 
+void SortStage::updateTopKBound() {
+    // For both limit == 1 and the heap, the item with the lowest key is at the front.
+    if (_sortKeyGenChild && _data.size() == _limit) {
+        _sortKeyGenChild->setTopKBound(_data.front().sortKey);
+    }
+}
+
+Status SortStage::spill() {
+    invariant(!_sorter);
+
+    // Everything which is buffered must be serializable before we give up any of it.
+    for (auto&& item : _data) {
+        Status status = checkCanSerialize(*_ws->get(item.wsid));
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    LOG(1) << "Sort stage exceeded its memory limit of "
+           << internalQueryExecMaxBlockingSortBytes.load()
+           << " bytes, or the total query memory budget, after buffering " << _memUsage
+           << " bytes; switching to an external sort";
+
+    SortOptions opts;
+    opts.Limit(_limit)
+        .MaxMemoryUsageBytes(static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load()))
+        .ExtSortAllowed()
+        .TempDir(storageGlobalParams.dbpath + "/_tmp");
+    _sorter.reset(SpillSorter::make(opts, SpillComparator(_sortKeyComparator->pattern)));
+    ++_specificStats.spills;
+
+    // The bound already given to '_sortKeyGenChild' stays valid, since the sorter keeps the same
+    // top '_limit' items that we would have.
+    for (auto&& item : _data) {
+        invariant(addToSorter(item));
+    }
+    _data.clear();
+    _resultIterator = _data.end();
+    _memUsage = 0;
+    _trackedMemUsage.set(getOpCtx(), 0);
+    return Status::OK();
+}
+
+Status SortStage::addToSorter(const SortableDataItem& item) {
+    const WorkingSetMember& member = *_ws->get(item.wsid);
+    Status status = checkCanSerialize(member);
+    if (!status.isOK()) {
+        return status;
+    }
+    _sorter->add(item.sortKey, serializeMember(member));
+    _ws->free(item.wsid);
+    return Status::OK();
+}
+
+WorkingSetID SortStage::nextFromSorter() {
+    auto next = _spillIterator->next();
+    const BSONObj& serialized = next.second;
+
+    WorkingSetID id = _ws->allocate();
+    WorkingSetMember* member = _ws->get(id);
+    const long long snapshotId = serialized[kSnapshotIdField]._numberLong();
+    member->obj = {snapshotId ? SnapshotId(snapshotId) : SnapshotId(),
+                   serialized[kObjField].Obj().getOwned()};
+
+    const long long recordId = serialized[kRecordIdField]._numberLong();
+    if (recordId) {
+        member->recordId = RecordId(recordId);
+        _ws->transitionToRecordIdAndObj(id);
+    } else {
+        _ws->transitionToOwnedObj(id);
+    }
+
+    member->addComputed(new SortKeyComputedData(next.first));
+    if (auto elt = serialized[kTextScoreField]) {
+        member->addComputed(new TextScoreComputedData(elt.Double()));
+    }
+    if (auto elt = serialized[kGeoDistanceField]) {
+        member->addComputed(new GeoDistanceComputedData(elt.Double()));
+    }
+    if (auto elt = serialized[kIndexKeyField]) {
+        member->addComputed(new IndexKeyComputedData(elt.Obj()));
+    }
+    if (auto elt = serialized[kGeoNearPointField]) {
+        member->addComputed(new GeoNearPointComputedData(elt.Obj()));
+    }
+    return id;
+}
+
 void SortStage::sortBuffer() {
     if (_limit == 0) {
         const WorkingSetComparator& cmp = *_sortKeyComparator;
@@ -279,13 +489,12 @@ void SortStage::sortBuffer() {
         // Buffer contains either 0 or 1 item so it is already in a sorted state.
         return;
     } else {
-        // Set already contains items in sorted order, so we simply copy the items
-        // from the set to the vector.
-        // Release the memory for the set after the copy.
-        vector<SortableDataItem> newData(_dataSet->begin(), _dataSet->end());
-        _data.swap(newData);
-        _dataSet.reset();
+        const WorkingSetComparator& cmp = *_sortKeyComparator;
+        std::sort_heap(_data.begin(), _data.end(), cmp);
     }
 }
 
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
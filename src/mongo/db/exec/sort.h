@@ -29,7 +29,6 @@
 
 #pragma once
 
-#include <set>
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
@@ -37,7 +36,9 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/query_memory_tracker.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
@@ -54,6 +55,9 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit = 0;
+
+    // Whether the sort may spill to disk rather than fail once it exceeds its memory limit.
+    bool allowDiskUse = false;
 };
 
 /**
@@ -132,7 +136,7 @@ private:
     };
 
     /**
-     * Inserts one item into data buffer (vector or set).
+     * Inserts one item into the data buffer.
      * If limit is exceeded, remove item with lowest key.
      */
     void addToBuffer(const SortableDataItem& item);
@@ -140,11 +144,51 @@ private:
     /**
      * Sorts data buffer.
      * Assumes no more items will be added to buffer.
-     * If data is stored in set, copy set
-     * contents to vector and clear set.
      */
     void sortBuffer();
 
+    /**
+     * Once a limited sort has buffered '_limit' items, passes the sort key of the worst of them
+     * down to '_sortKeyGenChild', so that documents which cannot displace it are dropped early.
+     */
+    void updateTopKBound();
+
+    //
+    // External sort
+    //
+    // Once the buffered data exceeds the memory limit, a sort which is allowed to use disk hands
+    // everything it has buffered, and all further input, to '_sorter' instead. Each item is keyed
+    // on its sort key, and carries its working set member in serialized form.
+    //
+
+    using SpillSorter = Sorter<BSONObj, BSONObj>;
+
+    // Orders items for '_sorter' the same way WorkingSetComparator does.
+    struct SpillComparator {
+        explicit SpillComparator(BSONObj p) : pattern(std::move(p)) {}
+        int operator()(const SpillSorter::Data& lhs, const SpillSorter::Data& rhs) const;
+        BSONObj pattern;
+    };
+
+    /**
+     * Creates '_sorter' and moves all of the buffered data into it. Fails if any of the buffered
+     * working set members cannot be serialized.
+     */
+    Status spill();
+
+    /**
+     * Serializes the member of 'item' into '_sorter' and frees it.
+     */
+    Status addToSorter(const SortableDataItem& item);
+
+    /**
+     * Allocates a working set member from the next item produced by '_spillIterator'.
+     */
+    WorkingSetID nextFromSorter();
+
+    // The child, if it generates our sort keys and we have a limit. Not owned by us.
+    SortKeyGeneratorStage* _sortKeyGenChild = nullptr;
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
@@ -153,12 +197,9 @@ private:
     // _data will contain sorted data when all data is gathered
     // and sorted.
     // When _limit is greater than 1 and not all data has been gathered from child stage,
-    // _dataSet is used instead to maintain an ordered set of the incomplete data set.
-    // When the data set is complete, we copy the items from _dataSet to _data which will
-    // be used to provide the results of this stage through _resultIterator.
+    // _data is kept as a max-heap under _sortKeyComparator, so that the item with the lowest
+    // key, which is the one a new item must beat, is always at the front.
     std::vector<SortableDataItem> _data;
-    typedef std::set<SortableDataItem, WorkingSetComparator> SortableDataItemSet;
-    std::unique_ptr<SortableDataItemSet> _dataSet;
 
     // Iterates through _data post-sort returning it.
     std::vector<SortableDataItem>::iterator _resultIterator;
@@ -167,6 +208,17 @@ private:
 
     // The usage in bytes of all buffered data that we're sorting.
     size_t _memUsage;
+
+    // Reports '_memUsage' to the operation's query memory accounting.
+    QueryMemoryTracker::StageUsage _trackedMemUsage;
+
+    const bool _allowDiskUse;
+
+    // Non-null once the sort has spilled.
+    std::unique_ptr<SpillSorter> _sorter;
+
+    // Iterates over the output of '_sorter', once all data has been added to it.
+    std::unique_ptr<SpillSorter::Iterator> _spillIterator;
 };
 
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include <vector>
 
 #include "mongo/bson/bsonobj_comparator.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
@@ -74,6 +75,12 @@ PlanStage::StageState SortKeyGeneratorStage::doWork(WorkingSetID* out) {
     if (stageState == PlanStage::ADVANCED) {
         WorkingSetMember* member = _ws->get(*out);
 
+        if (member->hasObj() && isRejectedByTopKBound(member->obj.value())) {
+            ++_numRejectedByTopKBound;
+            _ws->free(*out);
+            return PlanStage::NEED_TIME;
+        }
+
         StatusWith<BSONObj> sortKey = BSONObj();
         if (member->hasObj()) {
             SortKeyGenerator::Metadata metadata;
@@ -116,6 +123,37 @@ const SpecificStats* SortKeyGeneratorStage::getSpecificStats() const {
     return nullptr;
 }
 
+bool SortKeyGeneratorStage::isRejectedByTopKBound(const BSONObj& obj) const {
+    if (_topKBound.isEmpty()) {
+        return false;
+    }
+
+    // A $meta sort field has no value in the document to compare.
+    BSONElement specElt = _sortSpec.firstElement();
+    if (!specElt.isNumber()) {
+        return false;
+    }
+
+    const char* remainingPath = specElt.fieldName();
+    BSONElement elt =
+        dotted_path_support::extractElementAtPathOrArrayAlongPath(obj, remainingPath);
+    if (elt.eoo() || elt.type() == BSONType::Array || *remainingPath != '\0') {
+        return false;
+    }
+
+    // The bound holds collation keys, which only values containing strings can differ from.
+    if (_collator &&
+        (elt.type() == BSONType::String || elt.type() == BSONType::Object ||
+         elt.type() == BSONType::Symbol)) {
+        return false;
+    }
+
+    // False means ignore field names. Equal values may still be ordered by the remaining sort
+    // fields or by RecordId, so only a strict difference lets us reject.
+    const int cmp = elt.woCompare(_topKBound.firstElement(), false);
+    return specElt.number() < 0 ? cmp < 0 : cmp > 0;
+}
+
 StatusWith<BSONObj> SortKeyGeneratorStage::getSortKeyFromIndexKey(
     const WorkingSetMember& member) const {
     invariant(member.getState() == WorkingSetMember::RID_AND_IDX);
@@ -65,6 +65,22 @@ public:
 
     const SpecificStats* getSpecificStats() const final;
 
+    /**
+     * Called by a top-K sort above this stage with the sort key of the worst result it is
+     * currently keeping. Any document whose leading sort field already orders strictly after
+     * 'sortKey' cannot make the top K, so it is discarded without generating its sort key.
+     */
+    void setTopKBound(BSONObj sortKey) {
+        _topKBound = std::move(sortKey);
+    }
+
+    /**
+     * Returns the number of documents discarded because of the bound set by setTopKBound().
+     */
+    size_t getNumRejectedByTopKBound() const {
+        return _numRejectedByTopKBound;
+    }
+
     static const char* kStageType;
 
 protected:
@@ -73,6 +89,13 @@ protected:
 private:
     StatusWith<BSONObj> getSortKeyFromIndexKey(const WorkingSetMember& member) const;
 
+    /**
+     * Returns true if 'obj' is known to order after '_topKBound' from its leading sort field
+     * alone. Returns false whenever telling would require the full sort key, for instance when
+     * the field is missing, is reached through an array, or is subject to the collation.
+     */
+    bool isRejectedByTopKBound(const BSONObj& obj) const;
+
     WorkingSet* const _ws;
 
     // The raw sort pattern as expressed by the user.
@@ -81,6 +104,11 @@ private:
     const CollatorInterface* _collator;
 
     std::unique_ptr<SortKeyGenerator> _sortKeyGen;
+
+    // Empty until a top-K sort above this stage has filled up.
+    BSONObj _topKBound;
+
+    size_t _numRejectedByTopKBound = 0;
 };
 
 }  // namespace mongo
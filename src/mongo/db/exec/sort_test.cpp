@@ -272,6 +272,84 @@ TEST_F(SortStageTest, SortDescendingWithLimitOfOne) {
     testWork("{a: -1}", nullptr, 1, "{input: [{a: 2}, {a: 1}, {a: 3}]}", "{output: [{a: 3}]}");
 }
 
+//
+// Sorting with a limit, once the top N items are known
+// Implementation should let the sort key generator discard items
+// whose leading sort field orders after the lowest of them.
+//
+
+TEST_F(SortStageTest, SortWithLimitKeepsTiesOnLeadingField) {
+    testWork("{a: 1, b: 1}",
+             nullptr,
+             2,
+             "{input: [{a: 1, b: 3}, {a: 1, b: 2}, {a: 0, b: 9}, {a: 1, b: 1}, {a: 2, b: 0}]}",
+             "{output: [{a: 0, b: 9}, {a: 1, b: 1}]}");
+}
+
+TEST_F(SortStageTest, SortAscendingWithLimitHandlesArraysAndMissingFields) {
+    testWork("{a: 1}",
+             nullptr,
+             2,
+             "{input: [{a: 5}, {a: 3}, {a: [9, 1]}, {a: 4}, {b: 1}]}",
+             "{output: [{b: 1}, {a: [9, 1]}]}");
+}
+
+TEST_F(SortStageTest, SortDescendingWithLimitHandlesArrays) {
+    testWork("{a: -1}",
+             nullptr,
+             2,
+             "{input: [{a: 5}, {a: 3}, {a: [1, 9]}, {a: 4}]}",
+             "{output: [{a: [1, 9]}, {a: 5}]}");
+}
+
+TEST_F(SortStageTest, SortWithLimitAndCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    testWork("{a: 1}",
+             &collator,
+             2,
+             "{input: [{a: 'ba'}, {a: 'ab'}, {a: 'aa'}, {a: false}, {a: 1}]}",
+             "{output: [{a: 1}, {a: 'aa'}]}");
+}
+
+TEST_F(SortStageTest, SortWithLimitReportsDocumentsRejectedByTopKBound) {
+    WorkingSet ws;
+    auto queuedDataStage = std::make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    for (int value : {5, 4, 1, 2, 9, 8, 2}) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* wsm = ws.get(id);
+        wsm->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("a" << value));
+        wsm->transitionToOwnedObj();
+        queuedDataStage->pushBack(id);
+    }
+
+    SortStageParams params;
+    params.pattern = BSON("a" << 1);
+    params.limit = 2;
+    auto sortKeyGen = std::make_unique<SortKeyGeneratorStage>(
+        getOpCtx(), queuedDataStage.release(), &ws, params.pattern, nullptr);
+    SortStage sort(getOpCtx(), params, &ws, sortKeyGen.release());
+
+    std::vector<int> results;
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while (state != PlanStage::IS_EOF) {
+        state = sort.work(&id);
+        ASSERT_NOT_EQUALS(state, PlanStage::FAILURE);
+        if (state == PlanStage::ADVANCED) {
+            results.push_back(ws.get(id)->obj.value()["a"].numberInt());
+        }
+    }
+    ASSERT_EQUALS(2U, results.size());
+    ASSERT_EQUALS(1, results[0]);
+    ASSERT_EQUALS(2, results[1]);
+
+    // Once {a: 1} and {a: 2} are buffered, {a: 9} and {a: 8} are rejected. The second {a: 2}
+    // ties on the leading field, so it still reaches the sort stage.
+    auto stats = sort.getStats();
+    auto sortStats = static_cast<const SortStats*>(stats->specific.get());
+    ASSERT_EQUALS(2U, sortStats->topKRejected);
+}
+
 TEST_F(SortStageTest, SortAscendingWithCollation) {
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     testWork("{a: 1}",
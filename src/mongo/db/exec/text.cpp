@@ -121,8 +121,21 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
     if (wantTextScore) {
         // We use a TEXT_OR stage to get the union of the results from the index scans and then
         // compute their text scores. This is a blocking operation.
-        auto textScorer =
-            std::make_unique<TextOrStage>(opCtx, _params.spec, ws, filter, collection);
+        //
+        // When only the documents with the highest scores are needed, the TEXT_OR stage can stop
+        // reading terms early, as long as the TEXT_MATCH stage will not reject any more documents.
+        const bool textMatchMayReject = _params.query.getCaseSensitive() ||
+            _params.query.getDiacriticSensitive() || !_params.query.getNegatedTerms().empty() ||
+            !_params.query.getPositivePhr().empty() || !_params.query.getNegatedPhr().empty();
+        auto textScorer = std::make_unique<TextOrStage>(
+            opCtx,
+            _params.spec,
+            ws,
+            filter,
+            collection,
+            textMatchMayReject ? 0 : _params.limit,
+            std::vector<std::string>(_params.query.getTermsForBounds().begin(),
+                                     _params.query.getTermsForBounds().end()));
 
         textScorer->addChildren(std::move(indexScanList));
 
@@ -29,6 +29,8 @@
 
 #include "mongo/db/exec/text_or.h"
 
+#include <algorithm>
+#include <limits>
 #include <map>
 #include <memory>
 #include <vector>
@@ -57,11 +59,15 @@ TextOrStage::TextOrStage(OperationContext* opCtx,
                          const FTSSpec& ftsSpec,
                          WorkingSet* ws,
                          const MatchExpression* filter,
-                         const Collection* collection)
+                         const Collection* collection,
+                         size_t limit,
+                         std::vector<std::string> terms)
     : RequiresCollectionStage(kStageType, opCtx, collection),
       _ftsSpec(ftsSpec),
       _ws(ws),
       _scoreIterator(_scores.end()),
+      _limit(limit),
+      _terms(std::move(terms)),
       _filter(filter),
       _idRetrying(WorkingSet::INVALID_ID) {}
 
@@ -155,6 +161,10 @@ PlanStage::StageState TextOrStage::initStage(WorkingSetID* out) {
     try {
         _recordCursor = collection()->getCursor(getOpCtx());
         _internalState = State::kReadingTerms;
+        if (_limit) {
+            _maxUnreadScores.assign(_children.size(), std::numeric_limits<double>::infinity());
+            _childIsEOF.assign(_children.size(), false);
+        }
         return PlanStage::NEED_TIME;
     } catch (const WriteConflictException&) {
         invariant(_internalState == State::kInit);
@@ -183,21 +193,23 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 
     if (PlanStage::ADVANCED == childState) {
-        return addTerm(id, out);
+        const auto stageState = addTerm(id, out);
+        if (!_limit || _idRetrying != WorkingSet::INVALID_ID || !advanceToNextChild()) {
+            return stageState;
+        }
     } else if (PlanStage::IS_EOF == childState) {
         // Done with this child.
-        ++_currentChild;
-
-        if (_currentChild < _children.size()) {
+        if (_limit) {
+            _maxUnreadScores[_currentChild] = 0;
+            _childIsEOF[_currentChild] = true;
+            if (!advanceToNextChild()) {
+                return PlanStage::NEED_TIME;
+            }
+        } else if (++_currentChild < _children.size()) {
             // We have another child to read from.
             return PlanStage::NEED_TIME;
         }
 
-        // If we're here we are done reading results.  Move to the next state.
-        _scoreIterator = _scores.begin();
-        _internalState = State::kReturningResults;
-
-        return PlanStage::NEED_TIME;
     } else if (PlanStage::FAILURE == childState) {
         // If a stage fails, it may create a status WSM to indicate why it
         // failed, in which case 'id' is valid.  If ID is invalid, we
@@ -216,6 +228,62 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
         *out = id;
         return childState;
     }
+
+    // If we're here we are done reading results.  Move to the next state.
+    _scoreIterator = _scores.begin();
+    _internalState = State::kReturningResults;
+
+    return PlanStage::NEED_TIME;
+}
+
+bool TextOrStage::advanceToNextChild() {
+    double maxUnreadScore = 0;
+    for (auto score : _maxUnreadScores) {
+        maxUnreadScore += score;
+    }
+    if (_topScores.size() == _limit && maxUnreadScore <= _topScores.top().first) {
+        return true;
+    }
+
+    if (std::find(_childIsEOF.begin(), _childIsEOF.end(), false) == _childIsEOF.end()) {
+        return true;
+    }
+
+    // Read the terms in turn, so that the bounds on the scores of their unread postings all
+    // decrease together.
+    do {
+        _currentChild = (_currentChild + 1) % _children.size();
+    } while (_childIsEOF[_currentChild]);
+    return false;
+}
+
+double TextOrStage::scoreDocument(const BSONObj& obj) const {
+    fts::TermFrequencyMap termScores;
+    _ftsSpec.scoreDocument(obj, &termScores);
+
+    double score = 0;
+    for (auto&& term : _terms) {
+        auto termScore = termScores.find(term);
+        if (termScore != termScores.end()) {
+            score += termScore->second;
+        }
+    }
+    return score;
+}
+
+void TextOrStage::addToTopScores(const RecordId& recordId, double score) {
+    _topScores.emplace(score, recordId);
+    if (_topScores.size() <= _limit) {
+        return;
+    }
+
+    // The document with the lowest score can never be among the best ones again, because the
+    // lowest of the best scores only increases.
+    TextRecordData& discarded = _scores[_topScores.top().second];
+    _topScores.pop();
+    _ws->free(discarded.wsid);
+    discarded.wsid = WorkingSet::INVALID_ID;
+    discarded.score = -1;
 }
 
 PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
@@ -247,10 +315,28 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     invariant(wsm->getState() == WorkingSetMember::RID_AND_IDX);
     invariant(1 == wsm->keyData.size());
     const IndexKeyDatum newKeyData = wsm->keyData.back();  // copy to keep it around.
-    TextRecordData* textRecordData = &_scores[wsm->recordId];
+    const RecordId recordId = wsm->recordId;
+    TextRecordData* textRecordData = &_scores[recordId];
+
+    // Locate score within possibly compound key: {prefix,term,score,suffix}.
+    BSONObjIterator keyIt(newKeyData.keyData);
+    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
+        keyIt.next();
+    }
+
+    keyIt.next();  // Skip past 'term'.
+
+    BSONElement scoreElement = keyIt.next();
+    double documentTermScore = scoreElement.number();
+
+    if (_limit) {
+        // The postings of each term are read in decreasing order of score.
+        _maxUnreadScores[_currentChild] = documentTermScore;
+    }
 
     if (textRecordData->score < 0) {
-        // We have already rejected this document for not matching the filter.
+        // We have already rejected this document for not matching the filter, or discarded it for
+        // not having one of the highest scores.
         invariant(WorkingSet::INVALID_ID == textRecordData->wsid);
         _ws->free(wsid);
         return NEED_TIME;
@@ -286,6 +372,19 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
 
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         wsm->makeObjOwnedIfNeeded();
+
+        if (_limit) {
+            // Score the document for all of the terms at once, so that it is final before the
+            // postings of its other terms are read, if they ever are.
+            textRecordData->score = scoreDocument(wsm->obj.value());
+            addToTopScores(recordId, textRecordData->score);
+            return NEED_TIME;
+        }
+    } else if (_limit) {
+        // The score of this document is already final.
+        invariant(wsid != textRecordData->wsid);
+        _ws->free(wsid);
+        return NEED_TIME;
     } else {
         // We already have a working set member for this RecordId. Free the new WSM and retrieve the
         // old one. Note that since we don't keep all index keys, we could get a score that doesn't
@@ -296,17 +395,6 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         wsm = _ws->get(textRecordData->wsid);
     }
 
-    // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
-    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
-        keyIt.next();
-    }
-
-    keyIt.next();  // Skip past 'term'.
-
-    BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
-
     // Aggregate relevance score, term keys.
     textRecordData->score += documentTermScore;
     return NEED_TIME;
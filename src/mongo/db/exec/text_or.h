@@ -29,7 +29,12 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/fts/fts_spec.h"
@@ -46,6 +51,12 @@ class OperationContext;
  * A blocking stage that returns the set of WSMs with RecordIDs of all of the documents that contain
  * the positive terms in the search query, as well as their scores.
  *
+ * If it is given a limit, the stage only returns the 'limit' documents with the highest scores.
+ * Since each child reads the postings of one term in decreasing order of score, the stage reads
+ * the children in turn, scores each new document in full from its contents, and stops as soon as
+ * the sum of the scores of the last postings read from each term is no higher than the score of
+ * the 'limit'th best document found so far: no document left unread can score higher.
+ *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
  */
 class TextOrStage final : public RequiresCollectionStage {
@@ -67,11 +78,17 @@ public:
         kDone,
     };
 
+    /**
+     * 'terms' are the terms of the query which the children read the postings of. They are used
+     * to score documents in full when 'limit' is non-zero.
+     */
     TextOrStage(OperationContext* opCtx,
                 const FTSSpec& ftsSpec,
                 WorkingSet* ws,
                 const MatchExpression* filter,
-                const Collection* collection);
+                const Collection* collection,
+                size_t limit,
+                std::vector<std::string> terms);
 
     void addChild(std::unique_ptr<PlanStage> child);
 
@@ -123,6 +140,23 @@ private:
      */
     StageState returnResults(WorkingSetID* out);
 
+    /**
+     * Returns the score of the document 'obj' for the terms of the query.
+     */
+    double scoreDocument(const BSONObj& obj) const;
+
+    /**
+     * Helper for reading with a limit. Records the full score of a newly found document, and
+     * discards whichever document no longer has one of the '_limit' highest scores.
+     */
+    void addToTopScores(const RecordId& recordId, double score);
+
+    /**
+     * Helper for reading with a limit. Moves on to the next child which has postings left, and
+     * returns true if no unread document can have a higher score than those already found.
+     */
+    bool advanceToNextChild();
+
     // The index spec used to determine where to find the score.
     FTSSpec _ftsSpec;
 
@@ -150,6 +184,22 @@ private:
     ScoreMap _scores;
     ScoreMap::const_iterator _scoreIterator;
 
+    // If non-zero, only the '_limit' documents with the highest scores are returned.
+    const size_t _limit;
+    const std::vector<std::string> _terms;
+
+    // When reading with a limit, the score of the last posting read from each child, which bounds
+    // the score for that term of any document the child has not returned yet. Zero once the child
+    // is EOF.
+    std::vector<double> _maxUnreadScores;
+    std::vector<bool> _childIsEOF;
+
+    // When reading with a limit, the scores of the best documents found so far, lowest on top.
+    std::priority_queue<std::pair<double, RecordId>,
+                        std::vector<std::pair<double, RecordId>>,
+                        std::greater<std::pair<double, RecordId>>>
+        _topScores;
+
     TextOrStats _specificStats;
 
     // Members needed only for using the TextMatchableDocument.
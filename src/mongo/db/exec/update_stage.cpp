@@ -44,8 +44,10 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/write_stage_common.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/service_context.h"
@@ -152,6 +154,18 @@ CollectionUpdateArgs::StoreDocOption getStoreDocMode(const UpdateRequest& update
     invariant(!updateRequest.shouldReturnAnyDocs());
     return CollectionUpdateArgs::StoreDocOption::None;
 }
+/**
+ * Returns how many documents a multi-update should write per WriteUnitOfWork. Only multi-updates
+ * which return no documents are batched, on storage engines whose oplog is written out of
+ * timestamp order, and outside of any enclosing WriteUnitOfWork such as a transaction's.
+ */
+size_t getMultiUpdateBatchSize(OperationContext* opCtx, const UpdateRequest& request) {
+    if (!request.isMulti() || request.shouldReturnAnyDocs() || request.isExplain() ||
+        !supportsDocLocking() || opCtx->lockState()->inAWriteUnitOfWork()) {
+        return 1;
+    }
+    return static_cast<size_t>(internalUpdateMultiBatchSize.load());
+}
 }  // namespace
 
 const char* UpdateStage::kStageType = "UPDATE";
@@ -169,6 +183,7 @@ UpdateStage::UpdateStage(OperationContext* opCtx,
       _idRetrying(WorkingSet::INVALID_ID),
       _idReturning(WorkingSet::INVALID_ID),
       _updatedRecordIds(params.request->isMulti() ? new RecordIdSet() : nullptr),
+      _batchSize(getMultiUpdateBatchSize(opCtx, *params.request)),
       _doc(params.driver->getDocument()) {
     _children.emplace_back(child);
 
@@ -232,6 +247,13 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         }
         immutablePaths.keepShortest(&idFieldRef);
     }
+
+    // Track the paths modified by operator updates, so that the indexes which depend on none of
+    // them need not be updated. Replacement and pipeline updates may modify any path.
+    FieldRefSetWithStorage modifiedPaths;
+    bool trackModifiedPaths = internalUpdateSkipUnaffectedIndexes.load() &&
+        driver->type() == UpdateDriver::UpdateType::kOperator;
+
     if (!driver->needMatchDetails()) {
         // If we don't need match details, avoid doing the rematch
         status = driver->update(StringData(),
@@ -240,7 +262,8 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                                 immutablePaths,
                                 isInsert,
                                 &logObj,
-                                &docWasModified);
+                                &docWasModified,
+                                trackModifiedPaths ? &modifiedPaths : nullptr);
     } else {
         // If there was a matched field, obtain it.
         MatchDetails matchDetails;
@@ -259,7 +282,8 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                                 immutablePaths,
                                 isInsert,
                                 &logObj,
-                                &docWasModified);
+                                &docWasModified,
+                                trackModifiedPaths ? &modifiedPaths : nullptr);
     }
 
     if (!status.isOK()) {
@@ -276,6 +300,7 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         // Create ObjectId _id field if we are doing that
         if (createIdField) {
             addObjectIDIdField(&_doc);
+            trackModifiedPaths = false;
         }
     } else {
         uassertStatusOK(status);
@@ -314,8 +339,18 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
             if (args.storeDocOption == CollectionUpdateArgs::StoreDocOption::PreImage) {
                 args.preImageDoc = oldObj.value().getOwned();
             }
+            if (trackModifiedPaths) {
+                args.modifiedPaths = &modifiedPaths;
+            }
         }
 
+        // Updates batched in one WriteUnitOfWork reserve their oplog slot and timestamp the
+        // recovery unit with it before writing, so that each document is timestamped like its own
+        // oplog entry rather than like the one before it.
+        const bool reserveOplogSlot = _batchSize > 1 && !request->isExplain() &&
+            !repl::ReplicationCoordinator::get(getOpCtx())
+                 ->isOplogDisabledFor(getOpCtx(), collection()->ns());
+
         if (inPlace) {
             if (!request->isExplain()) {
                 newObj = oldObj.value();
@@ -332,6 +367,11 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                 }
 
                 WriteUnitOfWork wunit(getOpCtx());
+                if (reserveOplogSlot) {
+                    args.oplogSlot = repl::getNextOpTime(getOpCtx());
+                    uassertStatusOK(getOpCtx()->recoveryUnit()->setTimestamp(
+                        args.oplogSlot.getTimestamp()));
+                }
                 StatusWith<RecordData> newRecStatus = collection()->updateDocumentWithDamages(
                     getOpCtx(), recordId, std::move(snap), source, _damages, &args);
                 invariant(oldObj.snapshotId() == getOpCtx()->recoveryUnit()->getSnapshotId());
@@ -360,6 +400,11 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                 }
 
                 WriteUnitOfWork wunit(getOpCtx());
+                if (reserveOplogSlot) {
+                    args.oplogSlot = repl::getNextOpTime(getOpCtx());
+                    uassertStatusOK(getOpCtx()->recoveryUnit()->setTimestamp(
+                        args.oplogSlot.getTimestamp()));
+                }
                 newRecordId = collection()->updateDocument(getOpCtx(),
                                                            recordId,
                                                            oldObj,
@@ -642,6 +687,7 @@ bool UpdateStage::doneUpdating() {
     // We're done updating if either the child has no more results to give us, or we've
     // already gotten a result back and we're not a multi-update.
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
+        _batchedIds.empty() &&
         (child()->isEOF() || (_specificStats.nMatched > 0 && !_params.request->isMulti()));
 }
 
@@ -703,6 +749,12 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
         return PlanStage::ADVANCED;
     }
 
+    // Update a full batch of documents, or the last one once our child is out of results, before
+    // getting more from our child.
+    if (!_batchedIds.empty() && (_batchedIds.size() >= _batchSize || child()->isEOF())) {
+        return updateBatch(out);
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
@@ -762,6 +814,13 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
         // is allowed to free the memory.
         member->makeObjOwnedIfNeeded();
 
+        if (_batchSize > 1) {
+            // Keep this member around to update it with the rest of its batch.
+            memberFreer.dismiss();
+            _batchedIds.push_back(id);
+            return _batchedIds.size() < _batchSize ? PlanStage::NEED_TIME : updateBatch(out);
+        }
+
         // Save state before making changes
         WorkingSetCommon::prepareForSnapshotChange(_ws);
         try {
@@ -934,6 +993,90 @@ PlanStage::StageState UpdateStage::prepareToRetryWSM(WorkingSetID idToRetry, Wor
     return NEED_YIELD;
 }
 
+PlanStage::StageState UpdateStage::updateBatch(WorkingSetID* out) {
+    // Save state before making changes.
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException&) {
+        std::terminate();
+    }
+
+    // The members before 'committed' hold documents whose updates are committed, and
+    // 'committedStats' counts them.
+    auto committed = _batchedIds.begin();
+    auto committedStats = _specificStats;
+    auto discardUncommitted = [&] {
+        _specificStats = committedStats;
+        for (auto it = committed; it != _batchedIds.end(); ++it) {
+            if (_updatedRecordIds) {
+                _updatedRecordIds->erase(_ws->get(*it)->recordId);
+            }
+        }
+        for (auto it = _batchedIds.begin(); it != committed; ++it) {
+            _ws->free(*it);
+        }
+        committed = _batchedIds.erase(_batchedIds.begin(), committed);
+    };
+
+    bool oneAtATime = false;
+    while (true) {
+        try {
+            boost::optional<WriteUnitOfWork> wunit;
+            if (!oneAtATime) {
+                wunit.emplace(getOpCtx());
+            }
+            for (auto it = committed; it != _batchedIds.end(); ++it) {
+                // The document may have changed if we yielded since our child returned it, or if
+                // we are updating one document at a time.
+                if (write_stage_common::ensureStillMatches(
+                        collection(), getOpCtx(), _ws, *it, _params.canonicalQuery)) {
+                    WorkingSetMember* member = _ws->get(*it);
+                    transformAndUpdate(member->obj, member->recordId);
+                    ++_specificStats.nMatched;
+                }
+                if (!wunit) {
+                    committed = std::next(it);
+                    committedStats = _specificStats;
+                }
+            }
+            if (wunit) {
+                wunit->commit();
+            }
+            break;
+        } catch (const WriteConflictException&) {
+            // Keep the members which are not updated so we can retry updating them.
+            discardUncommitted();
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        } catch (const DBException&) {
+            discardUncommitted();
+            if (oneAtATime) {
+                throw;
+            }
+            oneAtATime = true;
+        }
+    }
+
+    for (auto id : _batchedIds) {
+        _ws->free(id);
+    }
+    _batchedIds.clear();
+
+    // As restoreState may restore (recreate) cursors, make sure to restore the state outside of
+    // the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException&) {
+        // Note we don't need to retry updating anything in this case since the updates already
+        // were committed.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return NEED_TIME;
+}
+
 bool UpdateStage::checkUpdateChangesShardKeyFields(ScopedCollectionMetadata metadata,
                                                    const Snapshotted<BSONObj>& oldObj) {
     auto newObj = _doc.getObject();
@@ -196,6 +196,14 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Updates the documents in '_batchedIds' in one WriteUnitOfWork, or one at a time if that
+     * fails with an error other than a WriteConflictException, so that the documents before the
+     * one which failed remain updated. Returns NEED_YIELD and keeps the members which are not
+     * updated to retry them on a WriteConflictException, and NEED_TIME otherwise.
+     */
+    StageState updateBatch(WorkingSetID* out);
+
     /**
      * Checks that the updated doc has all required shard key fields and throws if it does not.
      *
@@ -245,6 +253,11 @@ private:
     typedef stdx::unordered_set<RecordId, RecordId::Hasher> RecordIdSet;
     const std::unique_ptr<RecordIdSet> _updatedRecordIds;
 
+    // The number of documents a multi-update writes per WriteUnitOfWork, and the members holding
+    // the documents waiting to be updated when it is more than one.
+    const size_t _batchSize;
+    std::vector<WorkingSetID> _batchedIds;
+
     // These get reused for each update.
     mutablebson::Document& _doc;
     mutablebson::DamageVector _damages;
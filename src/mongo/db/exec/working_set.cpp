@@ -131,6 +131,7 @@ void WorkingSetMember::clear() {
 
     keyData.clear();
     obj.reset();
+    _fieldIndex.reset();
     _state = WorkingSetMember::INVALID;
 }
 
@@ -180,6 +181,20 @@ void WorkingSetMember::addComputed(WorkingSetComputedData* data) {
 bool WorkingSetMember::getFieldDotted(const string& field, BSONElement* out) const {
     // If our state is such that we have an object, use it.
     if (hasObj()) {
+        if (_fieldIndex && _fieldIndex->isIndexOf(obj.value())) {
+            // As dps::extractElementAtPath(), but with the first part found through the index.
+            StringData path(field);
+            *out = _fieldIndex->getField(path);
+            const size_t dotOffset = path.find('.');
+            if (out->eoo() && dotOffset != std::string::npos) {
+                const BSONElement sub = _fieldIndex->getField(path.substr(0, dotOffset));
+                if (sub.isABSONObj() && !sub.embeddedObject().isEmpty()) {
+                    *out = dps::extractElementAtPath(sub.embeddedObject(),
+                                                     path.substr(dotOffset + 1));
+                }
+            }
+            return true;
+        }
         *out = dps::extractElementAtPath(obj.value(), field);
         return true;
     }
@@ -193,6 +208,22 @@ bool WorkingSetMember::getFieldDotted(const string& field, BSONElement* out) con
     }
 }
 
+const BSONFieldIndex* WorkingSetMember::getFieldIndex(size_t minFields) {
+    if (!hasObj() || !obj.value().isOwned()) {
+        return nullptr;
+    }
+    if (_fieldIndex && _fieldIndex->isIndexOf(obj.value())) {
+        return _fieldIndex.get();
+    }
+    _fieldIndex.reset();
+
+    if (!BSONFieldIndex::isWorthBuilding(obj.value(), minFields)) {
+        return nullptr;
+    }
+    _fieldIndex = std::make_unique<BSONFieldIndex>(obj.value());
+    return _fieldIndex.get();
+}
+
 size_t WorkingSetMember::getMemUsage() const {
     size_t memUsage = 0;
 
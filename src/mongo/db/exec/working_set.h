@@ -32,6 +32,7 @@
 #include "boost/optional.hpp"
 #include <vector>
 
+#include "mongo/bson/bson_field_index.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/snapshot.h"
@@ -316,6 +317,16 @@ public:
      */
     bool getFieldDotted(const std::string& field, BSONElement* out) const;
 
+    /**
+     * Returns an index over the top-level fields of 'obj', so that repeated lookups of its fields
+     * by the filter, the sort key generator and so on need not each scan the object. The index is
+     * built on the first call and kept for as long as 'obj' is unchanged.
+     *
+     * Returns nullptr if this member has no object, if the object is unowned (an index over it
+     * could outlive the buffer) or if it has fewer than 'minFields' fields.
+     */
+    const BSONFieldIndex* getFieldIndex(size_t minFields);
+
     /**
      * Returns expected memory usage of working set member.
      */
@@ -327,6 +338,11 @@ private:
     MemberState _state = WorkingSetMember::INVALID;
 
     std::unique_ptr<WorkingSetComputedData> _computed[WSM_COMPUTED_NUM_TYPES];
+
+    // Built by getFieldIndex(). Since it holds a reference to the owned buffer it was built over,
+    // that buffer cannot be reused while the index is alive, and comparing the buffer against
+    // 'obj' reliably tells whether the index is stale.
+    std::unique_ptr<BSONFieldIndex> _fieldIndex;
 };
 
 }  // namespace mongo
@@ -33,6 +33,7 @@
 
 
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/json.h"
 #include "mongo/db/storage/snapshot.h"
@@ -45,6 +46,8 @@ namespace {
 
 using std::string;
 
+namespace dps = ::mongo::dotted_path_support;
+
 class WorkingSetFixture : public mongo::unittest::Test {
 protected:
     void setUp() {
@@ -156,4 +159,40 @@ TEST_F(WorkingSetFixture, getDottedFieldFromIndex) {
     ASSERT_FALSE(member->getFieldDotted("y", &elt));
 }
 
+TEST_F(WorkingSetFixture, fieldIndexOfOwnedObj) {
+    BSONObj obj = fromjson("{a: 1, b: {c: 2}, d: [{e: 3}], 'f.g': 4}");
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), obj);
+    ws->transitionToOwnedObj(id);
+
+    // Too narrow for an index.
+    ASSERT(nullptr == member->getFieldIndex(5));
+
+    const BSONFieldIndex* index = member->getFieldIndex(4);
+    ASSERT(nullptr != index);
+    ASSERT_EQUALS(index, member->getFieldIndex(4));
+    ASSERT_EQUALS(1, index->getField("a").numberInt());
+
+    // Lookups through the index agree with lookups done without one.
+    BSONElement elt;
+    for (auto&& path : {"a", "b", "b.c", "b.x", "d", "d.0.e", "f.g", "x", "x.y"}) {
+        ASSERT_TRUE(member->getFieldDotted(path, &elt));
+        ASSERT_BSONELT_EQ(dps::extractElementAtPath(obj, path), elt);
+    }
+
+    // Replacing the object makes the index stale.
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), fromjson("{a: 5, b: 6, c: 7, d: 8}"));
+    ASSERT_TRUE(member->getFieldDotted("a", &elt));
+    ASSERT_EQUALS(5, elt.numberInt());
+    index = member->getFieldIndex(4);
+    ASSERT(nullptr != index);
+    ASSERT_EQUALS(5, index->getField("a").numberInt());
+}
+
+TEST_F(WorkingSetFixture, noFieldIndexOfUnownedObj) {
+    BSONObj obj = fromjson("{a: 1, b: 2}");
+    ws->transitionToRecordIdAndObj(id);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), BSONObj(obj.objdata()));
+    ASSERT(nullptr == member->getFieldIndex(1));
+}
+
 }  // namespace
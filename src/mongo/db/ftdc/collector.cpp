@@ -31,6 +31,8 @@
 
 #include "mongo/db/ftdc/collector.h"
 
+#include <algorithm>
+
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobjbuilder.h"
@@ -45,6 +47,7 @@ namespace mongo {
 
 void FTDCCollectorCollection::add(std::unique_ptr<FTDCCollectorInterface> collector) {
     // TODO: ensure the collectors all have unique names.
+    _metricsCollectors.push_back(dynamic_cast<FTDCMetricsCollectorInterface*>(collector.get()));
     _collectors.emplace_back(std::move(collector));
 }
 
@@ -99,4 +102,69 @@ std::tuple<BSONObj, Date_t> FTDCCollectorCollection::collect(Client* client) {
     return std::tuple<BSONObj, Date_t>(builder.obj(), start);
 }
 
+bool FTDCCollectorCollection::hasMetricsCollectors() const {
+    return std::any_of(_metricsCollectors.begin(),
+                       _metricsCollectors.end(),
+                       [](FTDCMetricsCollectorInterface* collector) { return collector; });
+}
+
+boost::optional<Date_t> FTDCCollectorCollection::collectMetrics(
+    Client* client, const BSONObj& reference, std::vector<std::uint64_t>* metrics) {
+    invariant(!_collectors.empty());
+    metrics->clear();
+
+    auto clock = client->getServiceContext()->getPreciseClockSource();
+    Date_t start = clock->now();
+    Date_t end;
+    bool firstLoop = true;
+
+    metrics->push_back(start.toMillisSinceEpoch());
+
+    // See collect().
+    auto opCtx = client->makeOperationContext();
+    ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(opCtx->lockState());
+    opCtx->lockState()->setShouldAcquireTicket(false);
+    opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kNoTimestamp);
+
+    for (size_t i = 0; i < _collectors.size(); ++i) {
+        auto& collector = _collectors[i];
+
+        Date_t now = start;
+        if (!firstLoop) {
+            now = clock->now();
+        }
+        firstLoop = false;
+
+        if (_metricsCollectors[i]) {
+            metrics->push_back(now.toMillisSinceEpoch());
+            if (!_metricsCollectors[i]->collectMetrics(opCtx.get(), metrics)) {
+                return boost::none;
+            }
+            end = clock->now();
+            metrics->push_back(end.toMillisSinceEpoch());
+        } else {
+            BSONObjBuilder subObjBuilder;
+            subObjBuilder.appendDate(kFTDCCollectStartField, now);
+            collector->collect(opCtx.get(), subObjBuilder);
+            end = clock->now();
+            subObjBuilder.appendDate(kFTDCCollectEndField, end);
+
+            BSONElement referenceElement = reference[collector->name()];
+            if (referenceElement.type() != Object) {
+                return boost::none;
+            }
+
+            auto swMatches = FTDCBSONUtil::extractMetricsFromDocument(
+                referenceElement.Obj(), subObjBuilder.done(), metrics);
+            if (!swMatches.isOK() || !swMatches.getValue()) {
+                return boost::none;
+            }
+        }
+    }
+
+    metrics->push_back(end.toMillisSinceEpoch());
+
+    return start;
+}
+
 }  // namespace mongo
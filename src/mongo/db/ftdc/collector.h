@@ -29,16 +29,19 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <cstdint>
 #include <memory>
 #include <tuple>
 #include <vector>
 
+#include "mongo/util/time_support.h"
+
 
 namespace mongo {
 
 class BSONObj;
 class BSONObjBuilder;
-class Date_t;
 class Client;
 class OperationContext;
 
@@ -73,6 +76,21 @@ protected:
     FTDCCollectorInterface() = default;
 };
 
+/**
+ * A collector which can also collect a sample as a vector of metrics, without building BSON.
+ */
+class FTDCMetricsCollectorInterface : public FTDCCollectorInterface {
+public:
+    /**
+     * Append to 'metrics' the metrics FTDCBSONUtil::extractMetricsFromDocument would extract from
+     * what collect() appends, if they have the same schema as in the last call to collect().
+     *
+     * Returns false if the schema has changed or the metrics cannot be collected, in which case
+     * 'metrics' may have been partially appended to and collect() is called instead.
+     */
+    virtual bool collectMetrics(OperationContext* opCtx, std::vector<std::uint64_t>* metrics) = 0;
+};
+
 /**
  * Manages the set of BSON collectors
  *
@@ -109,9 +127,30 @@ public:
      */
     std::tuple<BSONObj, Date_t> collect(Client* client);
 
+    /**
+     * Returns true if any of the collectors is an FTDCMetricsCollectorInterface.
+     */
+    bool hasMetricsCollectors() const;
+
+    /**
+     * Collect a sample as the metrics FTDCBSONUtil::extractMetricsFromDocument would extract from
+     * the document collect() returns, when that document would have the same schema as
+     * 'reference', the last document collect() returned. FTDCMetricsCollectorInterface collectors
+     * append their metrics directly, the others are collected as BSON and their metrics extracted.
+     *
+     * Returns the time at which collecting started, or boost::none if the schema of any collector
+     * has changed, in which case the caller must collect the sample with collect() instead.
+     */
+    boost::optional<Date_t> collectMetrics(Client* client,
+                                           const BSONObj& reference,
+                                           std::vector<std::uint64_t>* metrics);
+
 private:
     // collection of collectors
     std::vector<std::unique_ptr<FTDCCollectorInterface>> _collectors;
+
+    // The collectors which can collect metrics without building BSON, nullptr for the others
+    std::vector<FTDCMetricsCollectorInterface*> _metricsCollectors;
 };
 
 }  // namespace mongo
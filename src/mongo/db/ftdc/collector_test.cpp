@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/ftdc/collector.h"
+#include "mongo/db/ftdc/ftdc_test.h"
+#include "mongo/db/ftdc/util.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class FTDCCollectorCollectionTest : public FTDCTest {};
+
+/**
+ * Collects {a: n, b: 2 * n}, and the same as metrics unless told its schema has changed.
+ */
+class MetricsCollectorMock final : public FTDCMetricsCollectorInterface {
+public:
+    explicit MetricsCollectorMock(bool* schemaChanged) : _schemaChanged(schemaChanged) {}
+
+    std::string name() const override {
+        return "metricsMock";
+    }
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override {
+        ++_counter;
+        builder.append("a", _counter);
+        builder.append("b", 2 * _counter);
+    }
+
+    bool collectMetrics(OperationContext* opCtx, std::vector<std::uint64_t>* metrics) override {
+        if (*_schemaChanged) {
+            return false;
+        }
+        ++_counter;
+        metrics->push_back(_counter);
+        metrics->push_back(2 * _counter);
+        return true;
+    }
+
+private:
+    bool* const _schemaChanged;
+    int _counter{0};
+};
+
+/**
+ * Collects {name: "joe", x: n}, or {name: "joe", y: n} once told its schema has changed.
+ */
+class BSONCollectorMock final : public FTDCCollectorInterface {
+public:
+    explicit BSONCollectorMock(bool* schemaChanged) : _schemaChanged(schemaChanged) {}
+
+    std::string name() const override {
+        return "bsonMock";
+    }
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override {
+        ++_counter;
+        builder.append("name", "joe");
+        builder.append(*_schemaChanged ? "y" : "x", _counter);
+    }
+
+private:
+    bool* const _schemaChanged;
+    int _counter{0};
+};
+
+TEST_F(FTDCCollectorCollectionTest, CollectMetrics) {
+    bool metricsSchemaChanged = false;
+    bool bsonSchemaChanged = false;
+
+    FTDCCollectorCollection collectors;
+    ASSERT_FALSE(collectors.hasMetricsCollectors());
+    collectors.add(std::make_unique<BSONCollectorMock>(&bsonSchemaChanged));
+    collectors.add(std::make_unique<MetricsCollectorMock>(&metricsSchemaChanged));
+    ASSERT_TRUE(collectors.hasMetricsCollectors());
+
+    auto client = getServiceContext()->makeClient("ftdc");
+    BSONObj reference = std::get<0>(collectors.collect(client.get()));
+
+    std::vector<std::uint64_t> metrics;
+    auto start = collectors.collectMetrics(client.get(), reference, &metrics);
+    ASSERT_TRUE(start);
+
+    // The metrics are those of the document collect() would have returned.
+    std::vector<std::uint64_t> referenceMetrics;
+    ASSERT_OK(FTDCBSONUtil::extractMetricsFromDocument(reference, reference, &referenceMetrics)
+                  .getStatus());
+    ASSERT_EQ(referenceMetrics.size(), metrics.size());
+    ASSERT_EQ(static_cast<std::uint64_t>(start->toMillisSinceEpoch()), metrics.front());
+
+    auto swDoc = FTDCBSONUtil::constructDocumentFromMetrics(reference, metrics);
+    ASSERT_OK(swDoc.getStatus());
+    ASSERT_EQ(2, swDoc.getValue()["bsonMock"]["x"].numberInt());
+    ASSERT_EQ("joe", swDoc.getValue()["bsonMock"]["name"].str());
+    ASSERT_EQ(2, swDoc.getValue()["metricsMock"]["a"].numberInt());
+    ASSERT_EQ(4, swDoc.getValue()["metricsMock"]["b"].numberInt());
+
+    // A schema change in either kind of collector requires a full sample.
+    metricsSchemaChanged = true;
+    ASSERT_FALSE(collectors.collectMetrics(client.get(), reference, &metrics));
+
+    metricsSchemaChanged = false;
+    bsonSchemaChanged = true;
+    ASSERT_FALSE(collectors.collectMetrics(client.get(), reference, &metrics));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
 
@@ -83,7 +84,26 @@ FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
             std::get<1>(swCompressedSamples.getValue()))};
     }
 
+    return _addDeltas();
+}
+
+StatusWith<boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>
+FTDCCompressor::addSample(const std::vector<std::uint64_t>& metrics, Date_t date) {
+    invariant(hasDataToFlush());
+
+    if (metrics.size() != _metricsCount) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Sample has " << metrics.size()
+                              << " metrics, but the reference document has " << _metricsCount};
+    }
 
+    _metrics.assign(metrics.begin(), metrics.end());
+
+    return _addDeltas();
+}
+
+StatusWith<boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>
+FTDCCompressor::_addDeltas() {
     // Add another sample
     for (std::size_t i = 0; i < _metrics.size(); ++i) {
         // NOTE: This touches a lot of cache lines so that compression code can be more effcient.
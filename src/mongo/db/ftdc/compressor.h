@@ -96,6 +96,17 @@ public:
     StatusWith<boost::optional<std::tuple<ConstDataRange, CompressorState, Date_t>>> addSample(
         const BSONObj& sample, Date_t date);
 
+    /**
+     * Add a sample given as the metrics FTDCBSONUtil::extractMetricsFromDocument would extract
+     * from a document with the same schema as the reference document. This lets callers which
+     * know their schema has not changed skip building the document.
+     *
+     * Requires hasDataToFlush(). Returns ErrorCodes::BadValue if the number of metrics is not the
+     * number in the reference document, otherwise the same as the other overload.
+     */
+    StatusWith<boost::optional<std::tuple<ConstDataRange, CompressorState, Date_t>>> addSample(
+        const std::vector<std::uint64_t>& metrics, Date_t date);
+
     /**
      * Returns the number of enqueued samples.
      *
@@ -150,6 +161,12 @@ private:
      */
     void _reset(const BSONObj& referenceDoc, Date_t date);
 
+    /**
+     * Add the deltas between _metrics and _prevmetrics, both matching the reference document.
+     */
+    StatusWith<boost::optional<std::tuple<ConstDataRange, CompressorState, Date_t>>>
+    _addDeltas();
+
 private:
     // Block Compressor
     BlockCompressor _compressor;
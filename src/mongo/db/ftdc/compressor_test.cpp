@@ -610,6 +610,49 @@ TEST_F(FTDCCompressorTest, TestFull) {
     }
 }
 
+// Samples added as metrics compress the same as the documents they were extracted from.
+TEST_F(FTDCCompressorTest, TestMetricsSamples) {
+    FTDCConfig config;
+    config.maxSamplesPerArchiveMetricChunk = 4;
+    FTDCCompressor c(&config);
+    FTDCDecompressor decompressor;
+
+    auto makeSample = [](int key1, int key2) {
+        return BSON("name"
+                    << "joe"
+                    << "key1"
+                    << key1
+                    << "key2"
+                    << key2);
+    };
+
+    std::vector<BSONObj> docs{makeSample(33, 42)};
+    auto st = c.addSample(docs.back(), Date_t());
+    ASSERT_HAS_SPACE(st);
+
+    for (int i = 0; i < 2; ++i) {
+        docs.push_back(makeSample(34 + i, 42 - i));
+        st = c.addSample(std::vector<std::uint64_t>{static_cast<std::uint64_t>(34 + i),
+                                                    static_cast<std::uint64_t>(42 - i)},
+                         Date_t());
+        ASSERT_HAS_SPACE(st);
+    }
+
+    ASSERT_EQUALS(ErrorCodes::BadValue,
+                  c.addSample(std::vector<std::uint64_t>{1, 2, 3}, Date_t()).getStatus());
+
+    docs.push_back(makeSample(40, 40));
+    st = c.addSample(std::vector<std::uint64_t>{40, 40}, Date_t());
+    ASSERT_FULL(st);
+
+    auto sw = decompressor.uncompress(std::get<0>(st.getValue().get()));
+    ASSERT_OK(sw.getStatus());
+    ValidateDocumentList(sw.getValue(), docs, FTDCValidationMode::kStrict);
+
+    // A full compressor needs a document to start the next chunk.
+    ASSERT_FALSE(c.hasDataToFlush());
+}
+
 template <typename T>
 BSONObj generateSample(std::random_device& rd, T generator, size_t count) {
     BSONObjBuilder builder;
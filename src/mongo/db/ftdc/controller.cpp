@@ -49,6 +49,19 @@
 
 namespace mongo {
 
+namespace {
+
+stdx::mutex registerCollectorsOnStartMutex;
+std::vector<std::function<void(FTDCController*)>> registerCollectorsOnStartFunctions;
+
+}  // namespace
+
+void FTDCController::registerCollectorsOnStart(
+    std::function<void(FTDCController*)> registerCollectors) {
+    stdx::lock_guard<stdx::mutex> lock(registerCollectorsOnStartMutex);
+    registerCollectorsOnStartFunctions.emplace_back(std::move(registerCollectors));
+}
+
 Status FTDCController::setEnabled(bool enabled) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
@@ -132,6 +145,13 @@ void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface
 BSONObj FTDCController::getMostRecentPeriodicDocument() {
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (!_mostRecentPeriodicMetrics.empty()) {
+            auto swDoc = FTDCBSONUtil::constructDocumentFromMetrics(_mostRecentPeriodicDocument,
+                                                                    _mostRecentPeriodicMetrics);
+            if (swDoc.isOK()) {
+                return swDoc.getValue();
+            }
+        }
         return _mostRecentPeriodicDocument.getOwned();
     }
 }
@@ -140,6 +160,13 @@ void FTDCController::start() {
     log() << "Initializing full-time diagnostic data capture with directory '"
           << _path.generic_string() << "'";
 
+    {
+        stdx::lock_guard<stdx::mutex> lock(registerCollectorsOnStartMutex);
+        for (const auto& registerCollectors : registerCollectorsOnStartFunctions) {
+            registerCollectors(this);
+        }
+    }
+
     // Start the thread
     _thread = stdx::thread([this] { doLoop(); });
 
@@ -196,6 +223,11 @@ void FTDCController::doLoop() {
         Client::initThread("ftdc");
         Client* client = &cc();
 
+        // The last sample collected as BSON, which has the schema of the samples collected as
+        // metrics since.
+        BSONObj lastFullSample;
+        std::vector<std::uint64_t> metrics;
+
         while (true) {
             // Compute the next interval to run regardless of how we were woken up
             // Skipping an interval due to a race condition with a config signal is harmless.
@@ -243,17 +275,37 @@ void FTDCController::doLoop() {
                     _mgr = uassertStatusOK(std::move(swMgr));
                 }
 
-                auto collectSample = _periodicCollectors.collect(client);
-
-                Status s = _mgr->writeSampleAndRotateIfNeeded(
-                    client, std::get<0>(collectSample), std::get<1>(collectSample));
+                // Collect the sample as metrics, without building the BSON document, unless the
+                // compressor needs a new reference document or the schema has changed.
+                boost::optional<Date_t> metricsStart;
+                if (!lastFullSample.isEmpty() && _periodicCollectors.hasMetricsCollectors() &&
+                    _mgr->canWriteMetricsSample()) {
+                    metricsStart =
+                        _periodicCollectors.collectMetrics(client, lastFullSample, &metrics);
+                }
 
-                uassertStatusOK(s);
+                if (metricsStart) {
+                    uassertStatusOK(
+                        _mgr->writeSampleAndRotateIfNeeded(client, metrics, *metricsStart));
 
-                // Store a reference to the most recent document from the periodic collectors
-                {
                     stdx::lock_guard<stdx::mutex> lock(_mutex);
-                    _mostRecentPeriodicDocument = std::get<0>(collectSample);
+                    _mostRecentPeriodicMetrics = metrics;
+                } else {
+                    auto collectSample = _periodicCollectors.collect(client);
+
+                    Status s = _mgr->writeSampleAndRotateIfNeeded(
+                        client, std::get<0>(collectSample), std::get<1>(collectSample));
+
+                    uassertStatusOK(s);
+
+                    lastFullSample = std::get<0>(collectSample);
+
+                    // Store a reference to the most recent document from the periodic collectors
+                    {
+                        stdx::lock_guard<stdx::mutex> lock(_mutex);
+                        _mostRecentPeriodicDocument = std::get<0>(collectSample);
+                        _mostRecentPeriodicMetrics.clear();
+                    }
                 }
             }
         }
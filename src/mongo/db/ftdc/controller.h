@@ -31,7 +31,9 @@
 
 #include <boost/filesystem/path.hpp>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
@@ -118,6 +120,13 @@ public:
      */
     void addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Register a function to add collectors to every controller when it is started, for
+     * components like storage engines which are set up before FTDC and which the FTDC libraries
+     * do not depend on.
+     */
+    static void registerCollectorsOnStart(std::function<void(FTDCController*)> registerCollectors);
+
     /**
      * Start the controller.
      *
@@ -204,6 +213,10 @@ private:
     // Owned
     BSONObj _mostRecentPeriodicDocument;
 
+    // Metrics of the last sample if it was collected as metrics, which replace those of
+    // _mostRecentPeriodicDocument. Empty otherwise.
+    std::vector<std::uint64_t> _mostRecentPeriodicMetrics;
+
     // Set of file rotation collectors
     FTDCCollectorCollection _rotateCollectors;
 
@@ -336,6 +336,22 @@ Status FTDCFileManager::writeSampleAndRotateIfNeeded(Client* client,
     return Status::OK();
 }
 
+Status FTDCFileManager::writeSampleAndRotateIfNeeded(Client* client,
+                                                     const std::vector<std::uint64_t>& metrics,
+                                                     Date_t date) {
+    Status s = _writer.writeSample(metrics, date);
+
+    if (!s.isOK()) {
+        return s;
+    }
+
+    if (_writer.getSize() > _config->maxFileSizeBytes) {
+        return rotate(client);
+    }
+
+    return Status::OK();
+}
+
 Status FTDCFileManager::close() {
     return _writer.close();
 }
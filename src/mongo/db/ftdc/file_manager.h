@@ -85,6 +85,24 @@ public:
      */
     Status writeSampleAndRotateIfNeeded(Client* client, const BSONObj& sample, Date_t date);
 
+    /**
+     * Writes a sample given as metrics matching the schema of the last sample written to disk via
+     * FTDCFileWriter. Requires canWriteMetricsSample().
+     *
+     * Rotates files as needed.
+     */
+    Status writeSampleAndRotateIfNeeded(Client* client,
+                                        const std::vector<std::uint64_t>& metrics,
+                                        Date_t date);
+
+    /**
+     * Returns true if the next sample may be written as metrics. This is not the case at the start
+     * of a file, or of a metric chunk.
+     */
+    bool canWriteMetricsSample() const {
+        return _writer.canWriteMetricsSample();
+    }
+
     /**
      * Closes the current file manager down.
      */
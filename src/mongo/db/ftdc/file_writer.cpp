@@ -153,8 +153,17 @@ Status FTDCFileWriter::writeMetadata(const BSONObj& metadata, Date_t date) {
 }
 
 Status FTDCFileWriter::writeSample(const BSONObj& sample, Date_t date) {
-    auto ret = _compressor.addSample(sample, date);
+    return processAddSampleResult(_compressor.addSample(sample, date));
+}
+
+Status FTDCFileWriter::writeSample(const std::vector<std::uint64_t>& metrics, Date_t date) {
+    return processAddSampleResult(_compressor.addSample(metrics, date));
+}
 
+Status FTDCFileWriter::processAddSampleResult(
+    const StatusWith<
+        boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>&
+        ret) {
     if (!ret.isOK()) {
         return ret.getStatus();
     }
@@ -81,6 +81,20 @@ public:
      */
     Status writeSample(const BSONObj& sample, Date_t date);
 
+    /**
+     * Write a sample given as metrics matching the schema of the last sample written. See
+     * FTDCCompressor::addSample. Requires canWriteMetricsSample().
+     */
+    Status writeSample(const std::vector<std::uint64_t>& metrics, Date_t date);
+
+    /**
+     * Returns true if the next sample may be written as metrics, which requires the compressor to
+     * have a reference document.
+     */
+    bool canWriteMetricsSample() const {
+        return _compressor.hasDataToFlush();
+    }
+
     /**
      * Close all the files and shutdown cleanly by zeroing the beginning of the interim file.
      */
@@ -102,6 +116,14 @@ public:
     void closeWithoutFlushForTest();
 
 private:
+    /**
+     * Flush the compressor's buffer or write it to the interim file after adding a sample.
+     */
+    Status processAddSampleResult(
+        const StatusWith<
+            boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>&
+            ret);
+
     /**
      * Flush all changes to disk.
      */
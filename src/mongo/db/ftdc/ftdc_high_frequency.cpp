@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/ftdc_high_frequency.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/ftdc/collector.h"
+#include "mongo/db/ftdc/ftdc_server.h"
+#include "mongo/db/ftdc/high_frequency_controller.h"
+
+namespace mongo {
+namespace {
+
+const char kServerStatusCollectorName[] = "serverStatus";
+
+/**
+ * Collects the serverStatus sections which are cheap enough to be collected many times a second.
+ * Sections which are not registered, like "wiredTigerHighFrequency" on mongos, are left out.
+ */
+class HighFrequencyServerStatusCollector final : public FTDCCollectorInterface {
+public:
+    std::string name() const override {
+        return kServerStatusCollectorName;
+    }
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override {
+        appendServerStatusSections(opCtx, _sections, &builder);
+    }
+
+private:
+    const std::vector<std::string> _sections{
+        "globalLock", "opcounters", "opLatencies", "wiredTigerHighFrequency"};
+};
+
+/**
+ * Fires when the read or write tickets run out. Only the sample in which they run out fires, so
+ * that a long period without tickets is written once.
+ */
+class TicketsExhaustedTrigger final : public FTDCHighFrequencyTrigger {
+public:
+    std::string name() const override {
+        return "ticketsExhausted";
+    }
+
+    bool shouldFlush(const BSONObj& sample) override {
+        BSONElement tickets = sample[kServerStatusCollectorName]["wiredTigerHighFrequency"]
+                                    ["concurrentTransactions"];
+        if (tickets.type() != Object) {
+            return false;
+        }
+
+        bool exhausted = false;
+        for (auto kind : {"read", "write"}) {
+            BSONElement available = tickets[kind]["available"];
+            exhausted = exhausted || (available.isNumber() && available.numberLong() <= 0);
+        }
+
+        const bool fire = exhausted && !_exhausted;
+        _exhausted = exhausted;
+        return fire;
+    }
+
+private:
+    bool _exhausted{false};
+};
+
+/**
+ * Fires when the average latency of the reads and writes which completed since the previous sample
+ * is at least 'diagnosticDataHighFrequencyLatencyTriggerMillis'. Commands are left out since some
+ * of them, like index builds, are expected to run for a long time.
+ */
+class LatencySpikeTrigger final : public FTDCHighFrequencyTrigger {
+public:
+    std::string name() const override {
+        return "latencySpike";
+    }
+
+    bool shouldFlush(const BSONObj& sample) override {
+        BSONElement opLatencies = sample[kServerStatusCollectorName]["opLatencies"];
+        if (opLatencies.type() != Object) {
+            return false;
+        }
+
+        long long latencyMicros = 0;
+        long long ops = 0;
+        for (auto kind : {"reads", "writes"}) {
+            latencyMicros += opLatencies[kind]["latency"].numberLong();
+            ops += opLatencies[kind]["ops"].numberLong();
+        }
+
+        const long long deltaLatencyMicros = latencyMicros - _latencyMicros;
+        const long long deltaOps = ops - _ops;
+        const bool first = _first;
+        _latencyMicros = latencyMicros;
+        _ops = ops;
+        _first = false;
+
+        const long long thresholdMillis =
+            ftdcStartupParams.highFrequencyLatencyTriggerMillis.load();
+        if (first || thresholdMillis <= 0 || deltaOps <= 0) {
+            return false;
+        }
+        return deltaLatencyMicros / deltaOps >= thresholdMillis * 1000;
+    }
+
+private:
+    bool _first{true};
+    long long _latencyMicros{0};
+    long long _ops{0};
+};
+
+/**
+ * Writes the samples retained by the high frequency FTDC tier to the diagnostic data directory,
+ * and returns the path of the file.
+ */
+class FlushHighFrequencyDiagnosticDataCommand final : public BasicCommand {
+public:
+    FlushHighFrequencyDiagnosticDataCommand()
+        : BasicCommand("flushHighFrequencyDiagnosticData") {}
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    std::string help() const override {
+        return "write the samples retained by the high frequency diagnostic data tier to disk";
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::serverStatus)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& db,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        auto controller = FTDCHighFrequencyController::get(opCtx->getServiceContext());
+        uassert(ErrorCodes::IllegalOperation,
+                "High frequency diagnostic data collection is not running",
+                controller);
+
+        auto path = uassertStatusOK(controller->flush("flushHighFrequencyDiagnosticData"));
+        result.append("file", path.generic_string());
+        return true;
+    }
+} flushHighFrequencyDiagnosticDataCommand;
+
+}  // namespace
+
+void installHighFrequencyCollectors(FTDCHighFrequencyController* controller) {
+    controller->addCollector(std::make_unique<HighFrequencyServerStatusCollector>());
+    controller->addTrigger(std::make_unique<TicketsExhaustedTrigger>());
+    controller->addTrigger(std::make_unique<LatencySpikeTrigger>());
+}
+
+}  // namespace mongo
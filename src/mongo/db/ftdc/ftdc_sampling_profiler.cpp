@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/ftdc_sampling_profiler.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/ftdc/collector.h"
+#include "mongo/db/ftdc/controller.h"
+#include "mongo/util/sampling_profiler.h"
+#include "mongo/util/sampling_profiler_gen.h"
+
+namespace mongo {
+namespace {
+
+class SamplingProfilerCollector final : public FTDCCollectorInterface {
+public:
+    std::string name() const override {
+        return "samplingProfiler";
+    }
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override {
+        SamplingProfiler::appendTopFrames(&builder, gSamplingProfilerTopFramesForFTDC.load());
+    }
+};
+
+/**
+ * Returns every stack the sampling profiler has recorded, in the folded format flame graph tools
+ * read. With {reset: true}, discards the samples afterwards.
+ */
+class GetSamplingProfileCommand final : public BasicCommand {
+public:
+    GetSamplingProfileCommand() : BasicCommand("getSamplingProfile") {}
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    std::string help() const override {
+        return "get the stacks recorded by the sampling profiler, in folded format";
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::serverStatus)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& db,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        SamplingProfiler::appendFoldedStacks(&result);
+        if (cmdObj["reset"].trueValue()) {
+            SamplingProfiler::reset();
+        }
+        return true;
+    }
+} getSamplingProfileCommand;
+
+}  // namespace
+
+void installSamplingProfilerCollector(FTDCController* controller) {
+    controller->addPeriodicCollector(std::make_unique<SamplingProfilerCollector>());
+}
+
+}  // namespace mongo
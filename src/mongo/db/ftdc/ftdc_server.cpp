@@ -42,10 +42,13 @@
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
+#include "mongo/db/ftdc/ftdc_high_frequency.h"
+#include "mongo/db/ftdc/ftdc_sampling_profiler.h"
 #include "mongo/db/ftdc/ftdc_server_gen.h"
 #include "mongo/db/ftdc/ftdc_system_stats.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/synchronized_value.h"
 
 namespace mongo {
@@ -62,6 +65,14 @@ FTDCController* getGlobalFTDCController() {
     return getFTDCController(getGlobalServiceContext()).get();
 }
 
+FTDCHighFrequencyController* getGlobalFTDCHighFrequencyController() {
+    if (!hasGlobalServiceContext()) {
+        return nullptr;
+    }
+
+    return FTDCHighFrequencyController::get(getGlobalServiceContext());
+}
+
 /**
  * Expose diagnosticDataCollectionDirectoryPath set parameter to specify the MongoD and MongoS FTDC
  * path.
@@ -87,6 +98,12 @@ Status DiagnosticDataCollectionDirectoryPathServerParameter::setFromString(const
                 return s;
             }
         }
+
+        auto highFrequencyController =
+            FTDCHighFrequencyController::get(getGlobalServiceContext());
+        if (highFrequencyController) {
+            highFrequencyController->setDirectory(str);
+        }
     }
 
     ftdcDirectoryPathParameter = str;
@@ -170,6 +187,33 @@ Status onUpdateFTDCPerInterimUpdate(const std::int32_t potentialNewValue) {
     return Status::OK();
 }
 
+Status onUpdateFTDCHighFrequencyEnabled(const bool value) {
+    auto controller = getGlobalFTDCHighFrequencyController();
+    if (controller) {
+        controller->setEnabled(value);
+    }
+
+    return Status::OK();
+}
+
+Status onUpdateFTDCHighFrequencyPeriod(const std::int32_t potentialNewValue) {
+    auto controller = getGlobalFTDCHighFrequencyController();
+    if (controller) {
+        controller->setPeriod(Milliseconds(potentialNewValue));
+    }
+
+    return Status::OK();
+}
+
+Status onUpdateFTDCHighFrequencyRetainedSamples(const std::int32_t potentialNewValue) {
+    auto controller = getGlobalFTDCHighFrequencyController();
+    if (controller) {
+        controller->setRetainedSamples(potentialNewValue);
+    }
+
+    return Status::OK();
+}
+
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
                                                                        StringData name,
                                                                        StringData ns,
@@ -224,19 +268,27 @@ void startFTDC(boost::filesystem::path& path,
     // hurt ftdc compression efficiency, because its output varies depending on the list of active
     // migrations.
     // "timing" is filtered out because it triggers frequent schema changes.
+    // The WiredTiger statistics are left out because the storage engine registers its own
+    // collector for them, which is cheaper than going through serverStatus.
     // TODO: do we need to enable "sharding" on MongoS?
     controller->addPeriodicCollector(std::make_unique<FTDCSimpleInternalCommandCollector>(
         "serverStatus",
         "serverStatus",
         "",
         BSON("serverStatus" << 1 << "tcMalloc" << true << "sharding" << false << "timing"
-                            << false)));
+                            << false
+                            << "wiredTiger"
+                            << BSON("statistics" << false))));
 
     registerCollectors(controller.get());
 
     // Install System Metric Collector as a periodic collector
     installSystemMetricsCollector(controller.get());
 
+    // The process has finished forking by now, so the sampling profiler's timer can be started.
+    SamplingProfiler::startup();
+    installSamplingProfilerCollector(controller.get());
+
     // Install file rotation collectors
     // These are collected on each file rotation.
 
@@ -258,9 +310,28 @@ void startFTDC(boost::filesystem::path& path,
     staticFTDC = std::move(controller);
 
     staticFTDC->start();
+
+    // The high frequency tier writes its files alongside the regular ones, but only on a trigger.
+    FTDCHighFrequencyConfig highFrequencyConfig;
+    highFrequencyConfig.enabled = ftdcStartupParams.highFrequencyEnabled.load();
+    highFrequencyConfig.period = Milliseconds(ftdcStartupParams.highFrequencyPeriodMillis.load());
+    highFrequencyConfig.retainedSamples = ftdcStartupParams.highFrequencyRetainedSamples.load();
+
+    auto highFrequencyController =
+        std::make_unique<FTDCHighFrequencyController>(path, highFrequencyConfig);
+    installHighFrequencyCollectors(highFrequencyController.get());
+    highFrequencyController->start();
+    FTDCHighFrequencyController::set(getGlobalServiceContext(),
+                                     std::move(highFrequencyController));
 }
 
 void stopFTDC() {
+    auto highFrequencyController = getGlobalFTDCHighFrequencyController();
+
+    if (highFrequencyController) {
+        highFrequencyController->stop();
+    }
+
     auto controller = getGlobalFTDCController();
 
     if (controller) {
@@ -37,6 +37,7 @@
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
+#include "mongo/db/ftdc/high_frequency_controller.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 
@@ -112,6 +113,11 @@ struct FTDCStartupParams {
     AtomicWord<int> maxSamplesPerArchiveMetricChunk;
     AtomicWord<int> maxSamplesPerInterimMetricChunk;
 
+    AtomicWord<bool> highFrequencyEnabled;
+    AtomicWord<int> highFrequencyPeriodMillis;
+    AtomicWord<int> highFrequencyRetainedSamples;
+    AtomicWord<int> highFrequencyLatencyTriggerMillis;
+
     FTDCStartupParams()
         : enabled(FTDCConfig::kEnabledDefault),
           periodMillis(FTDCConfig::kPeriodMillisDefault),
@@ -119,7 +125,11 @@ struct FTDCStartupParams {
           maxDirectorySizeMB(FTDCConfig::kMaxDirectorySizeBytesDefault / (1024 * 1024)),
           maxFileSizeMB(FTDCConfig::kMaxFileSizeBytesDefault / (1024 * 1024)),
           maxSamplesPerArchiveMetricChunk(FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(FTDCConfig::kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(FTDCConfig::kMaxSamplesPerInterimMetricChunkDefault),
+          highFrequencyEnabled(false),
+          highFrequencyPeriodMillis(FTDCHighFrequencyConfig::kPeriodMillisDefault),
+          highFrequencyRetainedSamples(FTDCHighFrequencyConfig::kRetainedSamplesDefault),
+          highFrequencyLatencyTriggerMillis(500) {}
 };
 
 extern FTDCStartupParams ftdcStartupParams;
@@ -133,6 +143,9 @@ Status onUpdateFTDCDirectorySize(const std::int32_t value);
 Status onUpdateFTDCFileSize(const std::int32_t value);
 Status onUpdateFTDCSamplesPerChunk(const std::int32_t value);
 Status onUpdateFTDCPerInterimUpdate(const std::int32_t value);
+Status onUpdateFTDCHighFrequencyEnabled(const bool value);
+Status onUpdateFTDCHighFrequencyPeriod(const std::int32_t value);
+Status onUpdateFTDCHighFrequencyRetainedSamples(const std::int32_t value);
 
 /**
  * Server Parameter accessors
@@ -0,0 +1,337 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kFTDC
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/high_frequency_controller.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "mongo/db/client.h"
+#include "mongo/db/ftdc/constants.h"
+#include "mongo/db/ftdc/util.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/log.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getHighFrequencyController =
+    ServiceContext::declareDecoration<std::unique_ptr<FTDCHighFrequencyController>>();
+
+}  // namespace
+
+FTDCHighFrequencyController::FTDCHighFrequencyController(boost::filesystem::path path,
+                                                         FTDCHighFrequencyConfig config)
+    : _configTemp(config),
+      _path(std::move(path)),
+      _retainedSamples(config.retainedSamples),
+      _compressor(&_compressorConfig) {
+    _compressorConfig.maxSamplesPerArchiveMetricChunk = FTDCHighFrequencyConfig::kSamplesPerChunk;
+}
+
+FTDCHighFrequencyController* FTDCHighFrequencyController::get(ServiceContext* serviceContext) {
+    return getHighFrequencyController(serviceContext).get();
+}
+
+void FTDCHighFrequencyController::set(ServiceContext* serviceContext,
+                                      std::unique_ptr<FTDCHighFrequencyController> controller) {
+    getHighFrequencyController(serviceContext) = std::move(controller);
+}
+
+void FTDCHighFrequencyController::setEnabled(bool enabled) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.enabled = enabled;
+    _condvar.notify_one();
+}
+
+void FTDCHighFrequencyController::setPeriod(Milliseconds millis) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.period = millis;
+    _condvar.notify_one();
+}
+
+void FTDCHighFrequencyController::setRetainedSamples(std::uint32_t samples) {
+    stdx::lock_guard<stdx::mutex> lock(_samplesMutex);
+    _retainedSamples = samples;
+    _trimChunks(lock);
+}
+
+void FTDCHighFrequencyController::setDirectory(const boost::filesystem::path& path) {
+    stdx::lock_guard<stdx::mutex> lock(_samplesMutex);
+    if (_path.empty()) {
+        _path = path;
+    }
+}
+
+void FTDCHighFrequencyController::addCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    invariant(!_started);
+    _collectors.add(std::move(collector));
+}
+
+void FTDCHighFrequencyController::addTrigger(std::unique_ptr<FTDCHighFrequencyTrigger> trigger) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    invariant(!_started);
+    _triggers.emplace_back(std::move(trigger));
+}
+
+void FTDCHighFrequencyController::start() {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    invariant(!_started);
+    _started = true;
+    _thread = stdx::thread([this] { doLoop(); });
+}
+
+void FTDCHighFrequencyController::stop() {
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (!_started || _stopRequested) {
+            return;
+        }
+        _stopRequested = true;
+        _condvar.notify_one();
+    }
+
+    _thread.join();
+}
+
+Status FTDCHighFrequencyController::addSample(const BSONObj& sample, Date_t date) {
+    stdx::lock_guard<stdx::mutex> lock(_samplesMutex);
+
+    auto swChunk = _compressor.addSample(sample, date);
+    if (!swChunk.isOK()) {
+        return swChunk.getStatus();
+    }
+
+    if (auto& chunk = swChunk.getValue()) {
+        // A full chunk includes this sample, while a schema change starts a new chunk with it.
+        const bool full =
+            std::get<1>(*chunk) == FTDCCompressor::CompressorState::kCompressorFull;
+        const std::size_t samples = _samplesInCompressor + (full ? 1 : 0);
+        _chunks.push_back(
+            {FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(*chunk), std::get<2>(*chunk)),
+             samples});
+        _samplesInChunks += samples;
+        _samplesInCompressor = full ? 0 : 1;
+    } else {
+        ++_samplesInCompressor;
+    }
+
+    _trimChunks(lock);
+
+    // Every trigger sees every sample, even while a flush is pending, so that the triggers which
+    // compare consecutive samples stay up to date.
+    for (auto& trigger : _triggers) {
+        if (trigger->shouldFlush(sample) && !_pendingFlushReason) {
+            _pendingFlushReason = trigger->name();
+            _samplesUntilFlush = _retainedSamples / 2;
+            log() << "High frequency diagnostic data trigger '" << trigger->name()
+                  << "' fired, writing the retained samples after " << _samplesUntilFlush
+                  << " more samples";
+        }
+    }
+
+    if (_pendingFlushReason) {
+        if (_samplesUntilFlush > 0) {
+            --_samplesUntilFlush;
+        } else {
+            const std::string reason = *_pendingFlushReason;
+            _pendingFlushReason = boost::none;
+            auto swPath = _flush(lock, reason);
+            if (!swPath.isOK()) {
+                return swPath.getStatus();
+            }
+        }
+    }
+
+    return Status::OK();
+}
+
+StatusWith<boost::filesystem::path> FTDCHighFrequencyController::flush(StringData reason) {
+    stdx::lock_guard<stdx::mutex> lock(_samplesMutex);
+    return _flush(lock, reason);
+}
+
+std::size_t FTDCHighFrequencyController::getRetainedSampleCount() {
+    stdx::lock_guard<stdx::mutex> lock(_samplesMutex);
+    return _samplesInChunks + _samplesInCompressor;
+}
+
+void FTDCHighFrequencyController::_trimChunks(WithLock) {
+    while (!_chunks.empty() &&
+           _samplesInChunks + _samplesInCompressor - _chunks.front().samples >= _retainedSamples) {
+        _samplesInChunks -= _chunks.front().samples;
+        _chunks.pop_front();
+    }
+}
+
+void FTDCHighFrequencyController::_resetSamples(WithLock) {
+    _compressor.reset();
+    _samplesInCompressor = 0;
+    _chunks.clear();
+    _samplesInChunks = 0;
+    _pendingFlushReason = boost::none;
+}
+
+StatusWith<boost::filesystem::path> FTDCHighFrequencyController::_flush(WithLock lock,
+                                                                        StringData reason) {
+    if (_path.empty()) {
+        return {ErrorCodes::FTDCPathNotSet,
+                "High frequency diagnostic data cannot be written without a directory"};
+    }
+
+    if (_compressor.hasDataToFlush()) {
+        auto swBuf = _compressor.getCompressedSamples();
+        if (!swBuf.isOK()) {
+            return swBuf.getStatus();
+        }
+        _chunks.push_back({FTDCBSONUtil::createBSONMetricChunkDocument(
+                               std::get<0>(swBuf.getValue()), std::get<1>(swBuf.getValue())),
+                           _samplesInCompressor});
+        _samplesInChunks += _samplesInCompressor;
+        _compressor.reset();
+        _samplesInCompressor = 0;
+    }
+
+    if (_chunks.empty()) {
+        return {ErrorCodes::IllegalOperation,
+                "There are no high frequency diagnostic data samples to write"};
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(_path, ec);
+    if (ec) {
+        return {ErrorCodes::NonExistentPath,
+                str::stream() << "Failed to create directory " << _path.generic_string() << ": "
+                              << ec.message()};
+    }
+
+    auto file = _path / (std::string(kFTDCArchiveFile) + "." + terseUTCCurrentTime() +
+                         "-highFrequency");
+    for (std::uint32_t uniquifier = 0; boost::filesystem::exists(file); ++uniquifier) {
+        if (uniquifier == FTDCConfig::kMaxFileUniqifier) {
+            return {ErrorCodes::InvalidPath,
+                    "Maximum limit reached for high frequency FTDC files in a second"};
+        }
+        file = _path / (std::string(kFTDCArchiveFile) + "." + terseUTCCurrentTime() +
+                        "-highFrequency-" + std::to_string(uniquifier));
+    }
+
+    std::ofstream stream(file.c_str(), std::ios_base::out | std::ios_base::binary);
+    if (!stream.is_open()) {
+        return {ErrorCodes::FileNotOpen, "Failed to open file " + file.generic_string()};
+    }
+
+    BSONObj metadata = FTDCBSONUtil::createBSONMetadataDocument(
+        BSON("highFrequency" << BSON("reason" << reason << "samples"
+                                              << static_cast<long long>(_samplesInChunks))),
+        Date_t::now());
+    stream.write(metadata.objdata(), metadata.objsize());
+    for (const auto& chunk : _chunks) {
+        stream.write(chunk.doc.objdata(), chunk.doc.objsize());
+    }
+    stream.close();
+
+    if (stream.fail()) {
+        return {ErrorCodes::FileStreamFailed,
+                "Failed to write high frequency diagnostic data to " + file.generic_string()};
+    }
+
+    log() << "Wrote " << _samplesInChunks << " high frequency diagnostic data samples to '"
+          << file.generic_string() << "' because of '" << reason << "'";
+
+    _resetSamples(lock);
+    return file;
+}
+
+void FTDCHighFrequencyController::doLoop() {
+    try {
+        Client::initThread("ftdcHighFrequency");
+        Client* client = &cc();
+
+        FTDCHighFrequencyConfig config;
+        bool wasEnabled = false;
+
+        while (true) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+
+                auto now = client->getServiceContext()->getPreciseClockSource()->now();
+                auto status = _condvar.wait_until(
+                    lock, FTDCUtil::roundTime(now, _configTemp.period).toSystemTimePoint());
+
+                if (_stopRequested) {
+                    break;
+                }
+
+                config = _configTemp;
+
+                // A signal is only a configuration change, re-compute when to collect.
+                if (status == stdx::cv_status::no_timeout) {
+                    continue;
+                }
+            }
+
+            if (!config.enabled) {
+                if (wasEnabled) {
+                    stdx::lock_guard<stdx::mutex> lock(_samplesMutex);
+                    _resetSamples(lock);
+                }
+                wasEnabled = false;
+                continue;
+            }
+            wasEnabled = true;
+
+            auto collectSample = _collectors.collect(client);
+            if (std::get<0>(collectSample).isEmpty()) {
+                continue;
+            }
+
+            Status s = addSample(std::get<0>(collectSample), std::get<1>(collectSample));
+            if (!s.isOK()) {
+                warning() << "Failed to add a high frequency diagnostic data sample: " << s;
+            }
+        }
+    } catch (...) {
+        warning() << "Uncaught exception in '" << exceptionToStatus()
+                  << "' in the high frequency tier of full-time diagnostic data capture. Shutting "
+                     "down the high frequency tier.";
+    }
+}
+
+}  // namespace mongo
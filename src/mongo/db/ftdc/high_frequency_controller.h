@@ -0,0 +1,267 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/db/ftdc/collector.h"
+#include "mongo/db/ftdc/compressor.h"
+#include "mongo/db/ftdc/config.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Configuration settings for the high frequency tier of FTDC.
+ */
+struct FTDCHighFrequencyConfig {
+    /**
+     * True if the high frequency tier is collecting samples.
+     */
+    bool enabled{false};
+
+    /**
+     * Period at which to collect samples.
+     */
+    Milliseconds period{kPeriodMillisDefault};
+
+    /**
+     * Minimum number of the most recent samples which are kept in memory, and written out when the
+     * retained samples are flushed.
+     */
+    std::uint32_t retainedSamples{kRetainedSamplesDefault};
+
+    static const std::int64_t kPeriodMillisDefault = 50;
+    static const std::uint32_t kRetainedSamplesDefault = 600;
+
+    /**
+     * Number of samples compressed together. Samples are dropped from the ring buffer a chunk at a
+     * time.
+     */
+    static const std::uint32_t kSamplesPerChunk = 60;
+};
+
+/**
+ * A condition on the high frequency samples which makes the samples around it worth keeping, for
+ * instance a latency spike.
+ */
+class FTDCHighFrequencyTrigger {
+    FTDCHighFrequencyTrigger(const FTDCHighFrequencyTrigger&) = delete;
+    FTDCHighFrequencyTrigger& operator=(const FTDCHighFrequencyTrigger&) = delete;
+
+public:
+    virtual ~FTDCHighFrequencyTrigger() = default;
+
+    /**
+     * Name of the trigger, recorded in the metadata of the files it causes to be written.
+     */
+    virtual std::string name() const = 0;
+
+    /**
+     * Returns true if the retained samples should be flushed because of 'sample'. Called with
+     * every sample in the order they are collected, so triggers may compare a sample to the
+     * previous one.
+     */
+    virtual bool shouldFlush(const BSONObj& sample) = 0;
+
+protected:
+    FTDCHighFrequencyTrigger() = default;
+};
+
+/**
+ * Collects a small set of cheap metrics many times a second, and keeps the most recent samples in
+ * memory, delta encoded and compressed by an FTDCCompressor. The samples are only written to the
+ * FTDC directory when a trigger fires, or when asked to with flush(), so that stalls too short to
+ * show up in the regular FTDC samples can be diagnosed without writing samples at this rate
+ * all the time.
+ *
+ * When a trigger fires, the samples are written once another half of 'retainedSamples' has been
+ * collected, so that the file covers the time both before and after the event. Triggers do not
+ * fire again until then.
+ *
+ * The files are FTDC files named like the regular archive files, "metrics.<date>-highFrequency",
+ * so that they are read by the same tools and are removed with them when the directory grows over
+ * its maximum size.
+ */
+class FTDCHighFrequencyController {
+    FTDCHighFrequencyController(const FTDCHighFrequencyController&) = delete;
+    FTDCHighFrequencyController& operator=(const FTDCHighFrequencyController&) = delete;
+
+public:
+    FTDCHighFrequencyController(boost::filesystem::path path, FTDCHighFrequencyConfig config);
+
+    ~FTDCHighFrequencyController() = default;
+
+    /**
+     * Set whether samples are collected. Disabling the collection drops the retained samples.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * Set the period for sample collection.
+     */
+    void setPeriod(Milliseconds millis);
+
+    /**
+     * Set the number of samples to retain.
+     */
+    void setRetainedSamples(std::uint32_t samples);
+
+    /**
+     * Set the directory to write files to, if it is not already set.
+     */
+    void setDirectory(const boost::filesystem::path& path);
+
+    /**
+     * Add a metric collector to collect on every period. Must be called before start().
+     */
+    void addCollector(std::unique_ptr<FTDCCollectorInterface> collector);
+
+    /**
+     * Add a trigger to check every sample against. Must be called before start().
+     */
+    void addTrigger(std::unique_ptr<FTDCHighFrequencyTrigger> trigger);
+
+    /**
+     * Start the controller. Spawns a new thread.
+     */
+    void start();
+
+    /**
+     * Stop the controller. Does not require start to be called.
+     */
+    void stop();
+
+    /**
+     * Adds a sample to the retained samples and checks it against the triggers. Exposed for
+     * testing, the samples are otherwise added by the controller's own thread.
+     */
+    Status addSample(const BSONObj& sample, Date_t date);
+
+    /**
+     * Writes the retained samples to a new file in the FTDC directory and drops them from memory.
+     * 'reason' is recorded in the metadata document at the start of the file.
+     *
+     * Returns the path of the file, ErrorCodes::FTDCPathNotSet if there is no FTDC directory, or
+     * ErrorCodes::IllegalOperation if there are no samples to write.
+     */
+    StatusWith<boost::filesystem::path> flush(StringData reason);
+
+    /**
+     * Returns the number of samples currently retained in memory.
+     */
+    std::size_t getRetainedSampleCount();
+
+    /**
+     * Get the FTDCHighFrequencyController from ServiceContext.
+     */
+    static FTDCHighFrequencyController* get(ServiceContext* serviceContext);
+
+    /**
+     * Install the FTDCHighFrequencyController on the ServiceContext.
+     */
+    static void set(ServiceContext* serviceContext,
+                    std::unique_ptr<FTDCHighFrequencyController> controller);
+
+private:
+    /**
+     * A compressed metric chunk document, and the number of samples in it.
+     */
+    struct Chunk {
+        BSONObj doc;
+        std::size_t samples;
+    };
+
+    void doLoop();
+
+    /**
+     * Drops the oldest chunks which are not needed to keep 'retainedSamples' samples.
+     */
+    void _trimChunks(WithLock);
+
+    void _resetSamples(WithLock);
+
+    StatusWith<boost::filesystem::path> _flush(WithLock, StringData reason);
+
+    // Protects the configuration, the state and the condvar.
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+
+    // Config settings manipulated by the setters, copied by the background thread.
+    FTDCHighFrequencyConfig _configTemp;
+
+    bool _started{false};
+    bool _stopRequested{false};
+
+    // Collectors and triggers, only used by the background thread once started.
+    FTDCCollectorCollection _collectors;
+    std::vector<std::unique_ptr<FTDCHighFrequencyTrigger>> _triggers;
+
+    // Protects everything below, which flush() may access from any thread.
+    stdx::mutex _samplesMutex;
+
+    // Directory to store files
+    boost::filesystem::path _path;
+
+    std::uint32_t _retainedSamples;
+
+    // Compressor for the samples not yet in a full chunk, and the number of them.
+    FTDCConfig _compressorConfig;
+    FTDCCompressor _compressor;
+    std::size_t _samplesInCompressor{0};
+
+    // Full chunks, oldest first, and the number of samples in them.
+    std::deque<Chunk> _chunks;
+    std::size_t _samplesInChunks{0};
+
+    // Set when a trigger has fired, until the samples are flushed.
+    boost::optional<std::string> _pendingFlushReason;
+    std::size_t _samplesUntilFlush{0};
+
+    // Background collection thread
+    stdx::thread _thread;
+};
+
+}  // namespace mongo
@@ -0,0 +1,202 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem.hpp>
+
+#include "mongo/db/ftdc/file_reader.h"
+#include "mongo/db/ftdc/ftdc_test.h"
+#include "mongo/db/ftdc/high_frequency_controller.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class FTDCHighFrequencyControllerTest : public FTDCTest {};
+
+BSONObj makeSample(int i) {
+    return BSON("a" << i << "b" << 2 * i);
+}
+
+/**
+ * Returns the "a" field of each metric sample in an FTDC file, and the high frequency metadata.
+ */
+std::vector<int> readSamples(const boost::filesystem::path& file, BSONObj* metadata) {
+    FTDCFileReader reader;
+    ASSERT_OK(reader.open(file));
+
+    std::vector<int> samples;
+    auto sw = reader.hasNext();
+    while (sw.isOK() && sw.getValue()) {
+        auto next = reader.next();
+        if (std::get<0>(next) == FTDCBSONUtil::FTDCType::kMetadata) {
+            *metadata = std::get<1>(next)["highFrequency"].Obj().getOwned();
+        } else {
+            samples.push_back(std::get<1>(next)["a"].numberInt());
+        }
+        sw = reader.hasNext();
+    }
+    ASSERT_OK(sw);
+
+    return samples;
+}
+
+class FireOnSampleTrigger : public FTDCHighFrequencyTrigger {
+public:
+    explicit FireOnSampleTrigger(int a) : _a(a) {}
+
+    std::string name() const override {
+        return "fireOnSample";
+    }
+
+    bool shouldFlush(const BSONObj& sample) override {
+        ++_checked;
+        return sample["a"].numberInt() == _a;
+    }
+
+    int getChecked() const {
+        return _checked;
+    }
+
+private:
+    const int _a;
+    int _checked{0};
+};
+
+FTDCHighFrequencyConfig makeConfig(std::uint32_t retainedSamples) {
+    FTDCHighFrequencyConfig config;
+    config.retainedSamples = retainedSamples;
+    return config;
+}
+
+// The controller keeps at least the most recent retainedSamples, dropping older samples a chunk at
+// a time, and writes them all out on flush.
+TEST_F(FTDCHighFrequencyControllerTest, FlushWritesMostRecentSamples) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    const std::uint32_t retainedSamples = 100;
+    FTDCHighFrequencyController controller(dir, makeConfig(retainedSamples));
+
+    const int numSamples = 1000;
+    for (int i = 0; i < numSamples; ++i) {
+        ASSERT_OK(controller.addSample(makeSample(i), Date_t::now()));
+        ASSERT_LTE(controller.getRetainedSampleCount(),
+                   retainedSamples + FTDCHighFrequencyConfig::kSamplesPerChunk);
+    }
+    const auto retained = controller.getRetainedSampleCount();
+    ASSERT_GTE(retained, retainedSamples);
+
+    auto swPath = controller.flush("test");
+    ASSERT_OK(swPath.getStatus());
+    ASSERT_EQ(0U, controller.getRetainedSampleCount());
+
+    BSONObj metadata;
+    auto samples = readSamples(swPath.getValue(), &metadata);
+    ASSERT_EQ(retained, samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        ASSERT_EQ(static_cast<int>(numSamples - retained + i), samples[i]);
+    }
+    ASSERT_EQ("test", metadata["reason"].str());
+    ASSERT_EQ(static_cast<long long>(retained), metadata["samples"].numberLong());
+
+    ASSERT_EQ(ErrorCodes::IllegalOperation, controller.flush("test").getStatus());
+}
+
+// A schema change starts a new chunk without losing any samples.
+TEST_F(FTDCHighFrequencyControllerTest, SchemaChange) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    FTDCHighFrequencyController controller(dir, makeConfig(100));
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_OK(controller.addSample(makeSample(i), Date_t::now()));
+    }
+    for (int i = 10; i < 20; ++i) {
+        ASSERT_OK(controller.addSample(BSON("a" << i), Date_t::now()));
+    }
+    ASSERT_EQ(20U, controller.getRetainedSampleCount());
+
+    auto swPath = controller.flush("test");
+    ASSERT_OK(swPath.getStatus());
+
+    BSONObj metadata;
+    auto samples = readSamples(swPath.getValue(), &metadata);
+    ASSERT_EQ(20U, samples.size());
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_EQ(i, samples[i]);
+    }
+}
+
+// The samples are written once half of retainedSamples have been collected after the trigger fired.
+TEST_F(FTDCHighFrequencyControllerTest, TriggerFlushesAfterHalfTheRetainedSamples) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    const std::uint32_t retainedSamples = 20;
+    FTDCHighFrequencyController controller(dir, makeConfig(retainedSamples));
+    auto trigger = std::make_unique<FireOnSampleTrigger>(50);
+    auto triggerPtr = trigger.get();
+    controller.addTrigger(std::move(trigger));
+
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_OK(controller.addSample(makeSample(i), Date_t::now()));
+        ASSERT_EQ(i + 1, triggerPtr->getChecked());
+
+        auto files = scanDirectory(dir);
+        if (i < 50 + static_cast<int>(retainedSamples / 2)) {
+            ASSERT_EQ(0U, files.size());
+        } else {
+            ASSERT_EQ(1U, files.size());
+        }
+    }
+
+    auto files = scanDirectory(dir);
+    ASSERT_EQ(1U, files.size());
+
+    BSONObj metadata;
+    auto samples = readSamples(files[0], &metadata);
+    ASSERT_EQ("fireOnSample", metadata["reason"].str());
+    ASSERT_GTE(samples.size(), retainedSamples);
+    ASSERT_EQ(50 + static_cast<int>(retainedSamples / 2), samples.back());
+    ASSERT_LTE(samples.front(), 50);
+}
+
+TEST_F(FTDCHighFrequencyControllerTest, FlushWithoutDirectory) {
+    FTDCHighFrequencyController controller(boost::filesystem::path(), makeConfig(100));
+    ASSERT_OK(controller.addSample(makeSample(0), Date_t::now()));
+    ASSERT_EQ(ErrorCodes::FTDCPathNotSet, controller.flush("test").getStatus());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -45,6 +45,27 @@ namespace fts {
 
 using std::string;
 
+namespace {
+
+std::array<bool, 128> makeAsciiDelimiters(unicode::DelimiterListLanguage language) {
+    std::array<bool, 128> delimiters;
+    for (char32_t codepoint = 0; codepoint < delimiters.size(); ++codepoint) {
+        delimiters[codepoint] = unicode::codepointIsDelimiter(codepoint, language);
+    }
+    return delimiters;
+}
+
+const std::array<bool, 128>& getAsciiDelimiters(unicode::DelimiterListLanguage language) {
+    static const auto englishDelimiters =
+        makeAsciiDelimiters(unicode::DelimiterListLanguage::kEnglish);
+    static const auto notEnglishDelimiters =
+        makeAsciiDelimiters(unicode::DelimiterListLanguage::kNotEnglish);
+    return language == unicode::DelimiterListLanguage::kEnglish ? englishDelimiters
+                                                                : notEnglishDelimiters;
+}
+
+}  // namespace
+
 UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
     : _language(language),
       _stemmer(language),
@@ -53,12 +74,22 @@ UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
                              ? unicode::DelimiterListLanguage::kEnglish
                              : unicode::DelimiterListLanguage::kNotEnglish),
       _caseFoldMode(_language->str() == "turkish" ? unicode::CaseFoldMode::kTurkish
-                                                  : unicode::CaseFoldMode::kNormal) {}
+                                                  : unicode::CaseFoldMode::kNormal),
+      _asciiDelimiters(getAsciiDelimiters(_delimListLanguage)) {}
 
 void UnicodeFTSTokenizer::reset(StringData document, Options options) {
     _options = options;
     _pos = 0;
-    _document.resetData(document);  // Validates that document is valid UTF8.
+
+    // Turkish case folding maps the ASCII 'I' to a non-ASCII character, so only documents in other
+    // languages can skip decoding.
+    _isAscii =
+        _caseFoldMode == unicode::CaseFoldMode::kNormal && unicode::String::isAscii(document);
+    if (_isAscii) {
+        _asciiDocument = document;
+    } else {
+        _document.resetData(document);  // Validates that document is valid UTF8.
+    }
 
     // Skip any leading delimiters (and handle the case where the document is entirely delimiters).
     _skipDelimiters();
@@ -66,15 +97,14 @@ void UnicodeFTSTokenizer::reset(StringData document, Options options) {
 
 bool UnicodeFTSTokenizer::moveNext() {
     while (true) {
-        if (_pos >= _document.size()) {
+        if (_pos >= _documentSize()) {
             _word = "";
             return false;
         }
 
         // Traverse through non-delimiters and build the next token.
         size_t start = _pos++;
-        while (_pos < _document.size() &&
-               (!unicode::codepointIsDelimiter(_document[_pos], _delimListLanguage))) {
+        while (_pos < _documentSize() && !_isDelimiterAt(_pos)) {
             ++_pos;
         }
         const size_t len = _pos - start;
@@ -84,14 +114,20 @@ bool UnicodeFTSTokenizer::moveNext() {
 
         // Stop words are case-sensitive and diacritic sensitive, so we need them to be lower cased
         // but with diacritics not removed to check against the stop word list.
-        _word = _document.toLowerToBuf(&_wordBuf, _caseFoldMode, start, len);
+        // ASCII has no characters with diacritics, so lower casing an ASCII token only needs to
+        // case fold it.
+        const StringData asciiToken = _isAscii ? _asciiDocument.substr(start, len) : StringData();
+        _word = _isAscii
+            ? unicode::String::caseFoldAndStripDiacritics(
+                  &_wordBuf, asciiToken, unicode::String::kDiacriticSensitive, _caseFoldMode)
+            : _document.toLowerToBuf(&_wordBuf, _caseFoldMode, start, len);
 
         if ((_options & kFilterStopWords) && _stopWords->isStopWord(_word)) {
             continue;
         }
 
         if (_options & kGenerateCaseSensitiveTokens) {
-            _word = _document.substrToBuf(&_wordBuf, start, len);
+            _word = _isAscii ? asciiToken : _document.substrToBuf(&_wordBuf, start, len);
         }
 
         // The stemmer is diacritic sensitive, so stem the word before removing diacritics.
@@ -112,11 +148,19 @@ StringData UnicodeFTSTokenizer::get() const {
 }
 
 void UnicodeFTSTokenizer::_skipDelimiters() {
-    while (_pos < _document.size() &&
-           unicode::codepointIsDelimiter(_document[_pos], _delimListLanguage)) {
+    while (_pos < _documentSize() && _isDelimiterAt(_pos)) {
         ++_pos;
     }
 }
 
+bool UnicodeFTSTokenizer::_isDelimiterAt(size_t pos) const {
+    return _isAscii ? _asciiDelimiters[static_cast<uint8_t>(_asciiDocument[pos])]
+                    : unicode::codepointIsDelimiter(_document[pos], _delimListLanguage);
+}
+
+size_t UnicodeFTSTokenizer::_documentSize() const {
+    return _isAscii ? _asciiDocument.size() : _document.size();
+}
+
 }  // namespace fts
 }  // namespace mongo
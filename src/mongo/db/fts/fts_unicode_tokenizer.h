@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_tokenizer.h"
 #include "mongo/db/fts/stemmer.h"
@@ -74,12 +76,29 @@ private:
      */
     void _skipDelimiters();
 
+    /**
+     * Returns whether the character at 'pos' in the current document is a delimiter.
+     */
+    bool _isDelimiterAt(size_t pos) const;
+
+    /**
+     * Returns the length of the current document in characters.
+     */
+    size_t _documentSize() const;
+
     const FTSLanguage* const _language;
     const Stemmer _stemmer;
     const StopWords* const _stopWords;
     const unicode::DelimiterListLanguage _delimListLanguage;
     const unicode::CaseFoldMode _caseFoldMode;
 
+    // Whether each ASCII character is a delimiter for this tokenizer's language.
+    const std::array<bool, 128>& _asciiDelimiters;
+
+    // A document made up entirely of ASCII characters is tokenized from its UTF-8 bytes in
+    // '_asciiDocument', without being decoded into '_document'.
+    bool _isAscii = false;
+    StringData _asciiDocument;
     unicode::String _document;
     size_t _pos;
     StringData _word;
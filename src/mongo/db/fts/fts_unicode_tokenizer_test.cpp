@@ -71,6 +71,23 @@ TEST(FtsUnicodeTokenizer, English) {
 
 // Ensure that the tokenization still works correctly when there are leading and/or trailing
 // delimiters.
+// Ensure an ASCII document, which is tokenized without being decoded, produces the same tokens as
+// a document that needs decoding.
+TEST(FtsUnicodeTokenizer, AsciiMatchesDecodedDocument) {
+    const char ascii[] = "The Quick^brown fox, JUMPS over the `lazy` dog's back";
+    const std::string decoded = std::string(ascii) + " ¿";
+
+    for (auto options : {FTSTokenizer::kNone,
+                         FTSTokenizer::kFilterStopWords,
+                         FTSTokenizer::kGenerateCaseSensitiveTokens,
+                         FTSTokenizer::kGenerateDiacriticSensitiveTokens}) {
+        for (auto language : {"english", "french"}) {
+            ASSERT(tokenizeString(ascii, language, options) ==
+                   tokenizeString(decoded.c_str(), language, options));
+        }
+    }
+}
+
 TEST(FtsUnicodeTokenizer, EnglishLeadingAndTrailingDelimiters) {
     std::vector<std::string> terms =
         tokenizeString("  , Do you see Mark's dog running?   ", "english", FTSTokenizer::kNone);
@@ -149,6 +149,18 @@ StringData String::toLowerToBuf(StackBufBuilder* buffer,
 }
 
 
+bool String::isAscii(StringData utf8) {
+    auto inputIt = utf8.begin();
+    const auto endIt = utf8.end();
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+    for (; size_t(endIt - inputIt) >= ByteVector::size; inputIt += ByteVector::size) {
+        if (ByteVector::load(&*inputIt).maskHigh())
+            return false;
+    }
+#endif
+    return std::all_of(inputIt, endIt, [](char c) { return !(uint8_t(c) & 0x80); });
+}
+
 StringData String::caseFoldAndStripDiacritics(StackBufBuilder* buffer,
                                               StringData utf8,
                                               SubstrMatchOptions options,
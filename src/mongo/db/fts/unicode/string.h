@@ -143,6 +143,12 @@ public:
                                                  SubstrMatchOptions options,
                                                  CaseFoldMode mode);
 
+    /**
+     * Returns true if every byte of the utf8 input string is ASCII. Such a string needs no
+     * decoding, and it contains no characters with diacritics.
+     */
+    static bool isAscii(StringData utf8);
+
 private:
     /**
      * Helper method for converting a UTF-8 string to a UTF-32 string.
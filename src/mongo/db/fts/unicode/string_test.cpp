@@ -199,6 +199,15 @@ TEST(UnicodeString, SubstringMatchTurkish) {
         str, UTF8("yaşindasiniz"), String::kDiacriticSensitive, CaseFoldMode::kTurkish));
 }
 
+TEST(UnicodeString, IsAscii) {
+    ASSERT(String::isAscii(""));
+    ASSERT(String::isAscii("short"));
+    ASSERT(String::isAscii("A string of ASCII text that is longer than a byte vector."));
+    ASSERT_FALSE(String::isAscii(UTF8("é")));
+    ASSERT_FALSE(String::isAscii(UTF8("A string that ends in a non-ASCII character: é")));
+    ASSERT_FALSE(String::isAscii(UTF8("A string with a non-ASCII character, é, in the middle.")));
+}
+
 TEST(UnicodeString, BadUTF8) {
     // Overlong.
     const char invalid1[] = {C(0xC0), C(0xAF), 0};
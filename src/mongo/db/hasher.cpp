@@ -33,6 +33,7 @@
 
 #include "mongo/db/hasher.h"
 
+#include <cstring>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/util/md5.hpp"
@@ -99,7 +100,159 @@ void Hasher::finish(HashDigest out) {
     md5_finish(&_md5State, out);
 }
 
-void recursiveHash(Hasher* h, const BSONElement& e, bool includeFieldName) {
+// An MD5 input block. Inputs short enough to fit in one block, after padding, are hashed with
+// md5Blocks() rather than with the md5 library.
+struct Md5Block {
+    unsigned char data[64];
+};
+
+// Collects the hash input of an element in a single Md5Block, as long as it fits. Has the same
+// interface as Hasher so that recursiveHash() produces the same input for both.
+class SingleBlockHasher {
+    SingleBlockHasher(const SingleBlockHasher&) = delete;
+    SingleBlockHasher& operator=(const SingleBlockHasher&) = delete;
+
+public:
+    explicit SingleBlockHasher(HashSeed seed) {
+        addSeed(seed);
+    }
+
+    void addData(const void* keyData, size_t numBytes) {
+        if (_overflow || _size + numBytes > kMaxInputBytes) {
+            _overflow = true;
+            return;
+        }
+        std::memcpy(_block.data + _size, keyData, numBytes);
+        _size += numBytes;
+    }
+
+    void addSeed(int32_t number) {
+        addIntegerData(number);
+    }
+
+    void addNumber(int64_t number) {
+        addIntegerData(number);
+    }
+
+    // Pads the input the way md5_finish does and copies the block to 'out'. Returns false, and
+    // leaves 'out' untouched, if the input did not fit in a single block.
+    bool finish(Md5Block* out) {
+        if (_overflow) {
+            return false;
+        }
+        std::memset(_block.data + _size, 0, sizeof(_block.data) - _size);
+        _block.data[_size] = 0x80;
+        DataView(reinterpret_cast<char*>(_block.data) + kMaxInputBytes + 1)
+            .write<LittleEndian<uint64_t>>(static_cast<uint64_t>(_size) * 8);
+        *out = _block;
+        return true;
+    }
+
+private:
+    // The padding takes a 0x80 byte and the 8 byte bit length of the input.
+    static constexpr size_t kMaxInputBytes = sizeof(Md5Block::data) - 9;
+
+    template <typename T>
+    void addIntegerData(T number) {
+        const auto data = endian::nativeToLittle(number);
+        addData(&data, sizeof(data));
+    }
+
+    Md5Block _block;
+    size_t _size = 0;
+    bool _overflow = false;
+};
+
+// The number of blocks md5Blocks() hashes together.
+constexpr size_t kMd5Lanes = 8;
+
+constexpr uint32_t kMd5Constants[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+
+constexpr int kMd5Shifts[64] = {7,  12, 17, 22, 7,  12, 17, 22, 7,  12, 17, 22, 7,  12, 17, 22,
+                                5,  9,  14, 20, 5,  9,  14, 20, 5,  9,  14, 20, 5,  9,  14, 20,
+                                4,  11, 16, 23, 4,  11, 16, 23, 4,  11, 16, 23, 4,  11, 16, 23,
+                                6,  10, 15, 21, 6,  10, 15, 21, 6,  10, 15, 21, 6,  10, 15, 21};
+
+// Applies one of the four rounds of the MD5 compression function to every lane.
+template <int Round>
+void md5Round(uint32_t (&a)[kMd5Lanes],
+              uint32_t (&b)[kMd5Lanes],
+              uint32_t (&c)[kMd5Lanes],
+              uint32_t (&d)[kMd5Lanes],
+              const uint32_t (&x)[16][kMd5Lanes]) {
+    for (int step = Round * 16; step < Round * 16 + 16; ++step) {
+        const int word = Round == 0
+            ? step
+            : Round == 1 ? (5 * step + 1) % 16 : Round == 2 ? (3 * step + 5) % 16 : (7 * step) % 16;
+        const uint32_t k = kMd5Constants[step];
+        const int shift = kMd5Shifts[step];
+        for (size_t lane = 0; lane < kMd5Lanes; ++lane) {
+            uint32_t f;
+            if (Round == 0) {
+                f = (b[lane] & c[lane]) | (~b[lane] & d[lane]);
+            } else if (Round == 1) {
+                f = (d[lane] & b[lane]) | (~d[lane] & c[lane]);
+            } else if (Round == 2) {
+                f = b[lane] ^ c[lane] ^ d[lane];
+            } else {
+                f = c[lane] ^ (b[lane] | ~d[lane]);
+            }
+            const uint32_t sum = a[lane] + f + k + x[word][lane];
+            a[lane] = d[lane];
+            d[lane] = c[lane];
+            c[lane] = b[lane];
+            b[lane] += (sum << shift) | (sum >> (32 - shift));
+        }
+    }
+}
+
+/**
+ * Computes the MD5 digest of up to kMd5Lanes single block inputs, and writes the first 8 bytes of
+ * each digest to 'out' as hash64() reads them. Every step of the algorithm is applied to all of the
+ * lanes before the next step, which lets the compiler evaluate the lanes with SIMD instructions.
+ * This costs about as much as hashing three inputs with the md5 library.
+ */
+void md5Blocks(const Md5Block* blocks, size_t count, long long int* out) {
+    invariant(count <= kMd5Lanes);
+
+    uint32_t x[16][kMd5Lanes] = {};
+    for (size_t lane = 0; lane < count; ++lane) {
+        ConstDataView blockView(reinterpret_cast<const char*>(blocks[lane].data));
+        for (size_t word = 0; word < 16; ++word) {
+            x[word][lane] = blockView.read<LittleEndian<uint32_t>>(word * sizeof(uint32_t));
+        }
+    }
+
+    uint32_t a[kMd5Lanes], b[kMd5Lanes], c[kMd5Lanes], d[kMd5Lanes];
+    for (size_t lane = 0; lane < kMd5Lanes; ++lane) {
+        a[lane] = 0x67452301;
+        b[lane] = 0xefcdab89;
+        c[lane] = 0x98badcfe;
+        d[lane] = 0x10325476;
+    }
+
+    md5Round<0>(a, b, c, d, x);
+    md5Round<1>(a, b, c, d, x);
+    md5Round<2>(a, b, c, d, x);
+    md5Round<3>(a, b, c, d, x);
+
+    for (size_t lane = 0; lane < count; ++lane) {
+        const uint32_t low = a[lane] + 0x67452301;
+        const uint32_t high = b[lane] + 0xefcdab89;
+        out[lane] = static_cast<long long int>((static_cast<uint64_t>(high) << 32) | low);
+    }
+}
+
+template <typename H>
+void recursiveHash(H* h, const BSONElement& e, bool includeFieldName) {
     int canonicalType = endian::nativeToLittle(e.canonicalType());
     h->addData(&canonicalType, sizeof(canonicalType));
 
@@ -136,9 +289,7 @@ void recursiveHash(Hasher* h, const BSONElement& e, bool includeFieldName) {
     }
 }
 
-}  // namespace
-
-long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
+long long int hashWithMd5Library(const BSONElement& e, HashSeed seed) {
     Hasher h(seed);
     recursiveHash(&h, e, false);
     HashDigest d;
@@ -148,4 +299,51 @@ long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
     return digestView.read<LittleEndian<long long int>>();
 }
 
+}  // namespace
+
+long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
+    return hashWithMd5Library(e, seed);
+}
+
+void BSONElementHasher::hash64(const BSONElement* elements,
+                               size_t count,
+                               HashSeed seed,
+                               long long int* out) {
+    // The blocks waiting to be hashed, and the positions in 'elements' they were built from.
+    Md5Block blocks[kMd5Lanes];
+    size_t positions[kMd5Lanes];
+    size_t numBlocks = 0;
+
+    auto hashBlocks = [&] {
+        long long int hashes[kMd5Lanes];
+        md5Blocks(blocks, numBlocks, hashes);
+        for (size_t i = 0; i < numBlocks; ++i) {
+            out[positions[i]] = hashes[i];
+        }
+        numBlocks = 0;
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        SingleBlockHasher h(seed);
+        recursiveHash(&h, elements[i], false);
+        if (!h.finish(&blocks[numBlocks])) {
+            out[i] = hashWithMd5Library(elements[i], seed);
+            continue;
+        }
+
+        positions[numBlocks++] = i;
+        if (numBlocks == kMd5Lanes) {
+            hashBlocks();
+        }
+    }
+
+    // Fewer than three leftover blocks are cheaper to hash one at a time.
+    if (numBlocks >= 3) {
+        hashBlocks();
+    }
+    for (size_t i = 0; i < numBlocks; ++i) {
+        out[positions[i]] = hashWithMd5Library(elements[positions[i]], seed);
+    }
+}
+
 }  // namespace mongo
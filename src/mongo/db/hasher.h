@@ -68,6 +68,15 @@ public:
      */
     static long long int hash64(const BSONElement& e, HashSeed seed);
 
+    /* Computes hash64(elements[i], seed) for each of the 'count' elements and writes
+     * it to out[i]. Elements whose hash input is short, which includes all numbers,
+     * are hashed several at a time. Prefer this to calling hash64() in a loop.
+     */
+    static void hash64(const BSONElement* elements,
+                       size_t count,
+                       HashSeed seed,
+                       long long int* out);
+
 private:
     BSONElementHasher();
 };
@@ -372,5 +372,40 @@ TEST(BSONElementHasher, HashWithNonZeroSeed) {
     ASSERT_EQUALS(hashIt(o, seed), -9222615859251096151LL);
 }
 
+TEST(BSONElementHasher, BatchHashesMatchSingleHashes) {
+    BSONArrayBuilder builder;
+    for (int i = 0; i < 10; ++i) {
+        builder << i << i * 1.5 << -1LL * i << std::string(i * 7, 'x') << BSON("a" << i)
+                << BSON_ARRAY(i << "b") << (i % 2 == 0) << MINKEY << BSONNULL;
+    }
+    // Strings of 43 characters or more do not fit in a single MD5 block with the seed and type.
+    builder << BSONCodeWScope("func f() { return 1; }", BSON("c" << true)) << OID::gen()
+            << std::string(41, 'y') << std::string(42, 'y') << std::string(43, 'y');
+    const BSONObj arr = builder.arr();
+
+    std::vector<BSONElement> elements;
+    for (auto&& elem : arr) {
+        elements.push_back(elem);
+    }
+
+    for (HashSeed seed : {0, 40513}) {
+        // Hash every prefix of up to 20 elements to cover partial batches, then all of them.
+        std::vector<size_t> counts;
+        for (size_t count = 0; count <= 20; ++count) {
+            counts.push_back(count);
+        }
+        counts.push_back(elements.size());
+
+        for (size_t count : counts) {
+            std::vector<long long> hashes(count);
+            BSONElementHasher::hash64(elements.data(), count, seed, hashes.data());
+            for (size_t i = 0; i < count; ++i) {
+                ASSERT_EQUALS(hashes[i], BSONElementHasher::hash64(elements[i], seed))
+                    << elements[i];
+            }
+        }
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -530,11 +530,23 @@ public:
 
     int64_t getKeysInserted() const final;
 
+    BulkBuilder* makeWorker(size_t maxMemoryUsageBytes) final;
+
 private:
+    /**
+     * Moves the keys sorted by the workers, and what they found out about multikeyness, into this
+     * BulkBuilder. Returns iterators over the keys of each worker.
+     */
+    std::vector<std::shared_ptr<Sorter::Iterator>> _finishWorkers();
+
+    const IndexDescriptor* _descriptor;
     std::unique_ptr<Sorter> _sorter;
     const IndexAccessMethod* _real;
     int64_t _keysInserted = 0;
 
+    // The BulkBuilders which other threads insert into, in parallel with this one.
+    std::vector<std::unique_ptr<BulkBuilderImpl>> _workers;
+
     // Set to true if any document added to the BulkBuilder causes the index to become multikey.
     bool _isMultiKey = false;
 
@@ -556,11 +568,15 @@ std::unique_ptr<IndexAccessMethod::BulkBuilder> AbstractIndexAccessMethod::initi
 AbstractIndexAccessMethod::BulkBuilderImpl::BulkBuilderImpl(const IndexAccessMethod* index,
                                                             const IndexDescriptor* descriptor,
                                                             size_t maxMemoryUsageBytes)
-    : _sorter(Sorter::make(
+    : _descriptor(descriptor),
+      _sorter(Sorter::make(
           SortOptions()
               .TempDir(storageGlobalParams.dbpath + "/_tmp")
               .ExtSortAllowed()
-              .MaxMemoryUsageBytes(maxMemoryUsageBytes),
+              .MaxMemoryUsageBytes(maxMemoryUsageBytes)
+              .SpillCompressor(indexBuildSpillZstdCompression.load()
+                                   ? SortOptions::Compressor::kZstd
+                                   : SortOptions::Compressor::kSnappy),
           BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
       _real(index) {}
 
@@ -612,17 +628,64 @@ bool AbstractIndexAccessMethod::BulkBuilderImpl::isMultikey() const {
 
 IndexAccessMethod::BulkBuilder::Sorter::Iterator*
 AbstractIndexAccessMethod::BulkBuilderImpl::done() {
+    auto workerIterators = _finishWorkers();
+
     for (const auto& key : _multikeyMetadataKeys) {
         _sorter->add(key, kMultikeyMetadataKeyId);
         ++_keysInserted;
     }
-    return _sorter->done();
+    if (workerIterators.empty()) {
+        return _sorter->done();
+    }
+
+    // Each worker sorted its own keys, so a multi-way merge of those runs with ours produces the
+    // keys of the whole build in order.
+    workerIterators.emplace_back(_sorter->done());
+    return Sorter::Iterator::merge(
+        workerIterators,
+        "",
+        SortOptions(),
+        BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version()));
+}
+
+std::vector<std::shared_ptr<IndexAccessMethod::BulkBuilder::Sorter::Iterator>>
+AbstractIndexAccessMethod::BulkBuilderImpl::_finishWorkers() {
+    std::vector<std::shared_ptr<Sorter::Iterator>> iterators;
+    for (auto&& worker : _workers) {
+        _keysInserted += worker->_keysInserted;
+        _isMultiKey = _isMultiKey || worker->_isMultiKey;
+        if (!worker->_indexMultikeyPaths.empty()) {
+            if (_indexMultikeyPaths.empty()) {
+                _indexMultikeyPaths = worker->_indexMultikeyPaths;
+            } else {
+                invariant(_indexMultikeyPaths.size() == worker->_indexMultikeyPaths.size());
+                for (size_t i = 0; i < _indexMultikeyPaths.size(); ++i) {
+                    _indexMultikeyPaths[i].insert(worker->_indexMultikeyPaths[i].begin(),
+                                                  worker->_indexMultikeyPaths[i].end());
+                }
+            }
+        }
+
+        // The metadata keys are added once, by us, since several workers may have generated the
+        // same ones.
+        _multikeyMetadataKeys.insert(worker->_multikeyMetadataKeys.begin(),
+                                     worker->_multikeyMetadataKeys.end());
+        iterators.emplace_back(worker->_sorter->done());
+    }
+    _workers.clear();
+    return iterators;
 }
 
 int64_t AbstractIndexAccessMethod::BulkBuilderImpl::getKeysInserted() const {
     return _keysInserted;
 }
 
+IndexAccessMethod::BulkBuilder* AbstractIndexAccessMethod::BulkBuilderImpl::makeWorker(
+    size_t maxMemoryUsageBytes) {
+    _workers.push_back(std::make_unique<BulkBuilderImpl>(_real, _descriptor, maxMemoryUsageBytes));
+    return _workers.back().get();
+}
+
 Status AbstractIndexAccessMethod::commitBulk(OperationContext* opCtx,
                                              BulkBuilder* bulk,
                                              bool dupsAllowed,
@@ -239,6 +239,16 @@ public:
          * Returns number of keys inserted using this BulkBuilder.
          */
         virtual int64_t getKeysInserted() const = 0;
+
+        /**
+         * Returns a BulkBuilder, owned by this one, which one other thread can insert into while
+         * this BulkBuilder and its other workers are used. Each worker sorts the keys of the
+         * documents inserted into it within 'maxMemoryUsageBytes' of its own. The worker does not
+         * need an OperationContext to insert. After all insertions are done, done() on this
+         * BulkBuilder merges the keys of all its workers with its own. A worker must not be used
+         * once done() has been called on the BulkBuilder that owns it.
+         */
+        virtual BulkBuilder* makeWorker(size_t maxMemoryUsageBytes) = 0;
     };
 
     /**
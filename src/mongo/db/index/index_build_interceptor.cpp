@@ -33,11 +33,14 @@
 
 #include "mongo/db/index/index_build_interceptor.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/catalog/index_timestamp_helper.h"
 #include "mongo/db/catalog_raii.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
@@ -55,6 +58,22 @@ namespace mongo {
 
 MONGO_FAIL_POINT_DEFINE(hangDuringIndexBuildDrainYield);
 
+namespace {
+
+// Drain progress across all index builds. The rate of side writes applied per millisecond gives an
+// estimate of how long the final drain, under a collection X lock, will take.
+Counter64 drainBatches;
+Counter64 drainSideWritesApplied;
+Counter64 drainMillis;
+ServerStatusMetricField<Counter64> displayDrainBatches("indexBuilds.drain.batches",
+                                                       &drainBatches);
+ServerStatusMetricField<Counter64> displayDrainSideWritesApplied(
+    "indexBuilds.drain.sideWritesApplied", &drainSideWritesApplied);
+ServerStatusMetricField<Counter64> displayDrainMillis("indexBuilds.drain.totalMillis",
+                                                      &drainMillis);
+
+}  // namespace
+
 IndexBuildInterceptor::IndexBuildInterceptor(OperationContext* opCtx, IndexCatalogEntry* entry)
     : _indexCatalogEntry(entry),
       _sideWritesTable(
@@ -143,6 +162,9 @@ Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
     invariant(kBatchMaxMB <= std::numeric_limits<int32_t>::max() / kMB);
     const int32_t kBatchMaxBytes = kBatchMaxMB * kMB;
 
+    const bool sortBatches = indexBuildDrainSortsBatches.load();
+    const Ordering ordering = Ordering::make(_indexCatalogEntry->descriptor()->keyPattern());
+
     // Indicates that there are no more visible records in the side table.
     bool atEof = false;
 
@@ -160,6 +182,9 @@ Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
         // table matters.
         std::vector<RecordId> recordsAddedToIndex;
 
+        // The writes read in this batch, applied once the batch is complete.
+        std::vector<SideWriteRecord> batch;
+
         while (!atEof) {
             opCtx->checkForInterrupt();
 
@@ -181,11 +206,7 @@ Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
             batchSize += 1;
             batchSizeBytes += objSize;
 
-            if (auto status =
-                    _applyWrite(opCtx, unownedDoc, options, &totalInserted, &totalDeleted);
-                !status.isOK()) {
-                return status;
-            }
+            batch.emplace_back(RecordId(unownedDoc["recordId"].Long()), unownedDoc.getOwned());
 
             // Save the record ids of the documents inserted into the index for deletion later.
             // We can't delete records while holding a positioned cursor.
@@ -197,6 +218,27 @@ Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
             }
         }
 
+        // Writes to different keys, or to the same key for different records, can be applied in
+        // any order. Applying them in index order makes the inserts into the index sequential.
+        // The sort is stable so that the writes for one key and record keep their order.
+        if (sortBatches) {
+            std::stable_sort(batch.begin(),
+                             batch.end(),
+                             [&](const SideWriteRecord& lhs, const SideWriteRecord& rhs) {
+                                 int cmp = lhs.second["key"].Obj().woCompare(
+                                     rhs.second["key"].Obj(), ordering, false);
+                                 return cmp < 0 || (cmp == 0 && lhs.first < rhs.first);
+                             });
+        }
+
+        for (const auto& write : batch) {
+            if (auto status =
+                    _applyWrite(opCtx, write.second, options, &totalInserted, &totalDeleted);
+                !status.isOK()) {
+                return status;
+            }
+        }
+
         // Delete documents from the side table as soon as they have been inserted into the index.
         // This ensures that no key is ever inserted twice and no keys are skipped.
         for (const auto& recordId : recordsAddedToIndex) {
@@ -212,6 +254,8 @@ Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
 
         progress->hit(batchSize);
         _numApplied += batchSize;
+        drainBatches.increment();
+        drainSideWritesApplied.increment(batchSize);
 
         // Lock yielding will only happen if we are holding intent locks.
         _tryYield(opCtx);
@@ -231,6 +275,7 @@ Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
     }
 
     progress->finished();
+    drainMillis.increment(timer.millis());
 
     int logLevel = (_numApplied - appliedAtStart > 0) ? 0 : 1;
     LOG(logLevel) << "index build: drain applied " << (_numApplied - appliedAtStart)
@@ -39,13 +39,17 @@
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/deferred_writer.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/introspect_gen.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -80,6 +84,67 @@ void _appendUserInfo(const CurOp& c, BSONObjBuilder& builder, AuthorizationSessi
     builder.append("user", bestUser.getUser().empty() ? "" : bestUser.getFullName());
 }
 
+/**
+ * The background writers of the profile collections, which 'profilerAsynchronousWrites' hands the
+ * profile entries to. Each database gets its writer the first time one of its operations is
+ * profiled.
+ */
+class AsyncProfileWriters {
+public:
+    // The maximum number of bytes of profile entries each writer buffers.
+    static const int64_t kMaxBufferSize = 4 * 1024 * 1024;
+
+    static AsyncProfileWriters& get(ServiceContext* serviceContext);
+
+    /**
+     * Hands 'entry' to the writer of the profile collection of 'dbName'. Returns false if the
+     * writers were shut down or the buffer of the writer is full.
+     */
+    bool insert(const std::string& dbName, const BSONObj& entry) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_shutdown) {
+            return false;
+        }
+
+        auto& writer = _writers[dbName];
+        if (!writer) {
+            // The same options as the profile collections created by createProfileCollection. The
+            // writer must not bring back a database which was dropped.
+            CollectionOptions collectionOptions;
+            collectionOptions.capped = true;
+            collectionOptions.cappedSize = 1024 * 1024;
+            writer = std::make_unique<DeferredWriter>(NamespaceString(dbName, "system.profile"),
+                                                      collectionOptions,
+                                                      kMaxBufferSize,
+                                                      false /* mayCreateDatabase */);
+            writer->startup("ProfileWriter-" + dbName);
+        }
+        return writer->insertDocument(entry);
+    }
+
+    /**
+     * Writes the buffered entries and stops the writers.
+     */
+    void shutdown() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _shutdown = true;
+        for (auto&& writer : _writers) {
+            writer.second->shutdown();
+        }
+    }
+
+private:
+    stdx::mutex _mutex;
+    bool _shutdown = false;
+    StringMap<std::unique_ptr<DeferredWriter>> _writers;
+};
+
+const auto getAsyncProfileWriters = ServiceContext::declareDecoration<AsyncProfileWriters>();
+
+AsyncProfileWriters& AsyncProfileWriters::get(ServiceContext* serviceContext) {
+    return getAsyncProfileWriters(serviceContext);
+}
+
 }  // namespace
 
 
@@ -113,10 +178,17 @@ void profile(OperationContext* opCtx, NetworkOp op) {
 
     const BSONObj p = b.done();
 
-    const bool wasLocked = opCtx->lockState()->isLocked();
-
     const string dbName(nsToDatabase(CurOp::get(opCtx)->getNS()));
 
+    // Unless the background writer's buffer is full, in which case the operation writes the entry
+    // itself, so that profiling slows operations down rather than losing entries.
+    if (gProfilerAsynchronousWrites.load() &&
+        AsyncProfileWriters::get(opCtx->getServiceContext()).insert(dbName, p)) {
+        return;
+    }
+
+    const bool wasLocked = opCtx->lockState()->isLocked();
+
     // True if we need to acquire an X lock on the database in order to create the system.profile
     // collection.
     bool acquireDbXLock = false;
@@ -200,6 +272,10 @@ void profile(OperationContext* opCtx, NetworkOp op) {
 }
 
 
+void shutdownAsyncProfileWriters(ServiceContext* serviceContext) {
+    AsyncProfileWriters::get(serviceContext).shutdown();
+}
+
 Status createProfileCollection(OperationContext* opCtx, Database* db) {
     invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_X));
 
@@ -36,12 +36,19 @@ namespace mongo {
 
 class Database;
 class OperationContext;
+class ServiceContext;
 
 /**
  * Invoked when database profile is enabled.
  */
 void profile(OperationContext* opCtx, NetworkOp op);
 
+/**
+ * Writes the profile entries buffered by 'profilerAsynchronousWrites' and stops their writers.
+ * Later entries are written by the profiled operations themselves.
+ */
+void shutdownAsyncProfileWriters(ServiceContext* serviceContext);
+
 /**
  * Pre-creates the profile collection for the specified database.
  */
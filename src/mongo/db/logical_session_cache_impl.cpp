@@ -48,6 +48,10 @@ namespace mongo {
 
 namespace {
 
+// The number of sessions a spread out refresh writes at a time, which is ten of the write batches
+// that the sessions collection sends.
+constexpr size_t kRefreshSliceSize = 10'000;
+
 void clearShardingOperationFailedStatus(OperationContext* opCtx) {
     // We do not intend to immediately act upon sharding errors if we receive them during sessions
     // collection operations. We will instead attempt the same operations during the next refresh
@@ -206,6 +210,33 @@ Status LogicalSessionCacheImpl::_reap(Client* client) {
     return Status::OK();
 }
 
+void LogicalSessionCacheImpl::_refreshSessionRecords(OperationContext* opCtx,
+                                                     const LogicalSessionRecordSet& records) {
+    const Milliseconds spread(logicalSessionRefreshSpreadMillis.load());
+    if (spread <= Milliseconds(0) || records.size() <= kRefreshSliceSize) {
+        uassertStatusOK(_sessionsColl->refreshSessions(opCtx, records));
+        return;
+    }
+
+    // Write the sessions a slice at a time so that a cache holding many sessions does not send
+    // all of their writes to the sessions collection at once. A slice still goes through
+    // refreshSessions, which groups it by the shard that owns each session.
+    const auto numSlices = (records.size() + kRefreshSliceSize - 1) / kRefreshSliceSize;
+    const auto pause = spread / static_cast<long long>(numSlices);
+
+    LogicalSessionRecordSet slice;
+    for (auto it = records.begin(); it != records.end();) {
+        slice.insert(*it);
+        if (++it == records.end() || slice.size() >= kRefreshSliceSize) {
+            uassertStatusOK(_sessionsColl->refreshSessions(opCtx, slice));
+            slice.clear();
+            if (it != records.end()) {
+                opCtx->sleepFor(pause);
+            }
+        }
+    }
+}
+
 void LogicalSessionCacheImpl::_refresh(Client* client) {
     // Stats for serverStatus:
     {
@@ -298,7 +329,7 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     }
 
     // Refresh the active sessions in the sessions collection.
-    uassertStatusOK(_sessionsColl->refreshSessions(opCtx, activeSessionRecords));
+    _refreshSessionRecords(opCtx, activeSessionRecords);
     activeSessionsBackSwapper.dismiss();
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
@@ -92,6 +92,12 @@ private:
     void _periodicRefresh(Client* client);
     void _refresh(Client* client);
 
+    /**
+     * Writes 'records' to the sessions collection, spread out over
+     * 'logicalSessionRefreshSpreadMillis' if there are enough of them. Throws on failure.
+     */
+    void _refreshSessionRecords(OperationContext* opCtx, const LogicalSessionRecordSet& records);
+
     void _periodicReap(Client* client);
     Status _reap(Client* client);
 
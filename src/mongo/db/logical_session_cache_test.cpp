@@ -50,6 +50,7 @@
 #include "mongo/stdx/future.h"
 #include "mongo/unittest/ensure_fcv.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -224,6 +225,34 @@ TEST_F(LogicalSessionCacheTest, ManySignedLsidsInCacheRefresh) {
     ASSERT(cache()->refreshNow(getClient()).isOK());
 }
 
+// Test that a spread out refresh writes every session, one slice at a time
+TEST_F(LogicalSessionCacheTest, SpreadRefreshWritesAllSessionsInSlices) {
+    const auto originalSpread = logicalSessionRefreshSpreadMillis.load();
+    logicalSessionRefreshSpreadMillis.store(30);
+    ON_BLOCK_EXIT([&] { logicalSessionRefreshSpreadMillis.store(originalSpread); });
+
+    int count = 25000;
+    for (int i = 0; i < count; i++) {
+        auto record = makeLogicalSessionRecordForTest();
+        ASSERT_OK(cache()->startSession(opCtx(), record));
+    }
+
+    int refreshes = 0;
+    size_t refreshed = 0;
+    sessions()->setRefreshHook([&](const LogicalSessionRecordSet& sessions) {
+        ASSERT_LTE(sessions.size(), 10000U);
+        ++refreshes;
+        refreshed += sessions.size();
+        return Status::OK();
+    });
+
+    clearOpCtx();
+    service()->fastForward(kForceRefresh);
+    ASSERT_OK(cache()->refreshNow(getClient()));
+    ASSERT_EQ(3, refreshes);
+    ASSERT_EQ(size_t(count), refreshed);
+}
+
 //
 TEST_F(LogicalSessionCacheTest, RefreshMatrixSessionState) {
     const std::vector<std::vector<std::string>> stateNames = {
@@ -0,0 +1,258 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_path.h"
+
+namespace mongo {
+
+namespace {
+
+// The number of documents matched between reorderings of the compiled predicates.
+const size_t kReorderInterval = 1024;
+
+template <typename T>
+int compareValues(const T& lhs, const T& rhs) {
+    return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+}
+
+bool satisfiesComparison(MatchExpression::MatchType matchType, int cmp) {
+    switch (matchType) {
+        case MatchExpression::LT:
+            return cmp < 0;
+        case MatchExpression::LTE:
+            return cmp <= 0;
+        case MatchExpression::EQ:
+            return cmp == 0;
+        case MatchExpression::GT:
+            return cmp > 0;
+        case MatchExpression::GTE:
+            return cmp >= 0;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<CompiledMatchExpression> CompiledMatchExpression::compile(
+    const MatchExpression* expr) {
+    std::unique_ptr<CompiledMatchExpression> compiled(new CompiledMatchExpression(expr));
+    if (expr->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < expr->numChildren(); ++i) {
+            const MatchExpression* child = expr->getChild(i);
+            if (!compiled->addPredicate(child)) {
+                compiled->_fallbacks.push_back(child);
+            }
+        }
+    } else {
+        compiled->addPredicate(expr);
+    }
+
+    if (compiled->_predicates.empty()) {
+        return nullptr;
+    }
+    compiled->_fieldValues.resize(compiled->_fieldNames.size());
+    return compiled;
+}
+
+bool CompiledMatchExpression::addPredicate(const MatchExpression* expr) {
+    auto pathExpr = dynamic_cast<const PathMatchExpression*>(expr);
+    if (!pathExpr || pathExpr->elementPath().fieldRef().numParts() != 1 ||
+        pathExpr->path().empty()) {
+        return false;
+    }
+
+    Predicate predicate;
+    predicate.expr = pathExpr;
+    predicate.traverseArrays =
+        pathExpr->elementPath().leafArrayBehavior() == ElementPath::LeafArrayBehavior::kTraverse;
+    predicate.matchType = expr->matchType();
+
+    auto field = std::find(_fieldNames.begin(), _fieldNames.end(), pathExpr->path());
+    predicate.field = field - _fieldNames.begin();
+    if (field == _fieldNames.end()) {
+        _fieldNames.push_back(pathExpr->path().toString());
+    }
+
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE: {
+            auto cmp = static_cast<const ComparisonMatchExpression*>(expr);
+            predicate.rhs = cmp->getData();
+            switch (predicate.rhs.type()) {
+                case NumberInt:
+                    predicate.comparison = NativeComparison::kInt;
+                    break;
+                case NumberLong:
+                    predicate.comparison = NativeComparison::kLong;
+                    break;
+                case NumberDouble:
+                    // NaN only compares equal to NaN, which the expression itself handles.
+                    if (!std::isnan(predicate.rhs._numberDouble())) {
+                        predicate.comparison = NativeComparison::kDouble;
+                    }
+                    break;
+                case Date:
+                    predicate.comparison = NativeComparison::kDate;
+                    break;
+                case String:
+                    if (!cmp->getCollator()) {
+                        predicate.comparison = NativeComparison::kString;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    _predicates.push_back(predicate);
+    return true;
+}
+
+bool CompiledMatchExpression::matchesBSON(const BSONObj& obj) const {
+    std::fill(_fieldValues.begin(), _fieldValues.end(), BSONElement());
+    if (_fieldNames.size() == 1) {
+        _fieldValues[0] = obj[_fieldNames[0]];
+    } else {
+        // Collect the first occurrence of each field, as BSONObj::getField() would.
+        size_t numRemaining = _fieldNames.size();
+        for (auto&& elt : obj) {
+            const StringData fieldName = elt.fieldNameStringData();
+            for (size_t i = 0; i < _fieldNames.size(); ++i) {
+                if (_fieldValues[i].eoo() && fieldName == _fieldNames[i]) {
+                    _fieldValues[i] = elt;
+                    --numRemaining;
+                    break;
+                }
+            }
+            if (numRemaining == 0) {
+                break;
+            }
+        }
+    }
+
+    if (++_numDocumentsSinceReorder >= kReorderInterval) {
+        reorderPredicates();
+    }
+
+    for (auto&& predicate : _predicates) {
+        ++predicate.numTried;
+        if (!matchesField(predicate, _fieldValues[predicate.field])) {
+            ++predicate.numRejected;
+            return false;
+        }
+    }
+
+    for (auto&& fallback : _fallbacks) {
+        if (!fallback->matchesBSON(obj)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompiledMatchExpression::matchesField(const Predicate& predicate,
+                                           const BSONElement& elt) const {
+    // A path expression on a single field tries each element of an array at that field, and then
+    // the array itself.
+    if (elt.type() == Array && predicate.traverseArrays) {
+        for (auto&& arrayElt : elt.Obj()) {
+            if (matchesSingleElement(predicate, arrayElt)) {
+                return true;
+            }
+        }
+    }
+    return matchesSingleElement(predicate, elt);
+}
+
+bool CompiledMatchExpression::matchesSingleElement(const Predicate& predicate,
+                                                   const BSONElement& elt) const {
+    if (predicate.comparison == NativeComparison::kNone || elt.type() != predicate.rhs.type()) {
+        return predicate.expr->matchesSingleElement(elt, nullptr);
+    }
+
+    switch (predicate.comparison) {
+        case NativeComparison::kInt:
+            return satisfiesComparison(
+                predicate.matchType,
+                compareValues(elt._numberInt(), predicate.rhs._numberInt()));
+        case NativeComparison::kLong:
+            return satisfiesComparison(
+                predicate.matchType,
+                compareValues(elt._numberLong(), predicate.rhs._numberLong()));
+        case NativeComparison::kDouble: {
+            // The operand is not NaN, so a NaN satisfies none of the comparisons.
+            const double value = elt._numberDouble();
+            return !std::isnan(value) &&
+                satisfiesComparison(predicate.matchType,
+                                    compareValues(value, predicate.rhs._numberDouble()));
+        }
+        case NativeComparison::kDate:
+            return satisfiesComparison(predicate.matchType,
+                                       compareValues(elt.date().toMillisSinceEpoch(),
+                                                     predicate.rhs.date().toMillisSinceEpoch()));
+        case NativeComparison::kString:
+            return satisfiesComparison(
+                predicate.matchType,
+                elt.valueStringData().compare(predicate.rhs.valueStringData()));
+        case NativeComparison::kNone:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void CompiledMatchExpression::reorderPredicates() const {
+    std::stable_sort(
+        _predicates.begin(), _predicates.end(), [](const Predicate& lhs, const Predicate& rhs) {
+            return lhs.numRejected * rhs.numTried > rhs.numRejected * lhs.numTried;
+        });
+    for (auto&& predicate : _predicates) {
+        predicate.numTried = 0;
+        predicate.numRejected = 0;
+    }
+    _numDocumentsSinceReorder = 0;
+}
+
+}  // namespace mongo
@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+class PathMatchExpression;
+
+/**
+ * A filter specialized for its top-level predicates, so that matching a document against it takes
+ * one pass over the fields of the document rather than a walk of the expression tree with a path
+ * lookup per predicate.
+ *
+ * The predicates which are compiled are the root of the filter, or each child of a root $and,
+ * which is a path expression on a single top-level field. The fields they name are collected in
+ * one pass over the document, and each predicate is then applied to the value of its field with
+ * the same array traversal as the tree. $eq, $lt, $lte, $gt and $gte compare an operand of the same
+ * type as their own natively when it is an int, a long, a double, a date or, when there is no
+ * collation, a string. Any other child of the $and is matched by the tree once the compiled
+ * predicates have all passed.
+ *
+ * The compiled predicates are reordered as the filter runs, so that those which reject the most
+ * documents are tried first. The filter matches the same documents as the tree it came from,
+ * although a document on which a child of the $and would fail with an error may be rejected by
+ * another predicate before that child is tried.
+ *
+ * A CompiledMatchExpression holds a pointer to the tree it came from, which must outlive it, and
+ * keeps statistics of its own, so it must not be used by more than one thread at a time.
+ */
+class CompiledMatchExpression {
+public:
+    /**
+     * Compiles 'expr', or returns nullptr if none of its top-level predicates can be compiled, in
+     * which case there is nothing to gain over matching with the tree.
+     */
+    static std::unique_ptr<CompiledMatchExpression> compile(const MatchExpression* expr);
+
+    /**
+     * Returns true if 'obj' matches the filter, as MatchExpression::matchesBSON() would.
+     */
+    bool matchesBSON(const BSONObj& obj) const;
+
+    /**
+     * Returns the number of predicates which were compiled, for testing.
+     */
+    size_t getNumCompiledPredicates() const {
+        return _predicates.size();
+    }
+
+private:
+    // How a predicate compares its operand, when it can do so natively.
+    enum class NativeComparison {
+        kNone,
+        kInt,
+        kLong,
+        kDouble,
+        kDate,
+        kString,
+    };
+
+    struct Predicate {
+        const PathMatchExpression* expr;
+
+        // The index into '_fieldNames' of the field the predicate applies to.
+        size_t field;
+
+        // True if the predicate is applied to each element of an array as well as to the array.
+        bool traverseArrays;
+
+        NativeComparison comparison = NativeComparison::kNone;
+        MatchExpression::MatchType matchType;
+        BSONElement rhs;
+
+        // Since the predicates were last reordered, the number of documents the predicate was
+        // tried on and the number of those it rejected.
+        mutable size_t numTried = 0;
+        mutable size_t numRejected = 0;
+    };
+
+    explicit CompiledMatchExpression(const MatchExpression* expr) : _expr(expr) {}
+
+    // Adds 'expr' as a compiled predicate and returns true, or returns false if it cannot be
+    // compiled.
+    bool addPredicate(const MatchExpression* expr);
+
+    // Returns true if 'predicate' matches the value 'elt' of its field, which is EOO if the field
+    // is missing.
+    bool matchesField(const Predicate& predicate, const BSONElement& elt) const;
+
+    // Returns true if 'predicate' matches 'elt' itself, without traversing it.
+    bool matchesSingleElement(const Predicate& predicate, const BSONElement& elt) const;
+
+    // Sorts the predicates so that those which rejected the largest share of the documents they
+    // were tried on come first, and resets their statistics.
+    void reorderPredicates() const;
+
+    const MatchExpression* _expr;
+
+    std::vector<std::string> _fieldNames;
+
+    // Mutable to let the filter adapt its order to the documents it sees.
+    mutable std::vector<Predicate> _predicates;
+    mutable size_t _numDocumentsSinceReorder = 0;
+
+    // The children of the root $and which are matched by the tree.
+    std::vector<const MatchExpression*> _fallbacks;
+
+    // The values of the fields in '_fieldNames' in the document being matched.
+    mutable std::vector<BSONElement> _fieldValues;
+};
+
+}  // namespace mongo
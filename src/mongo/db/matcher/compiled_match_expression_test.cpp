@@ -0,0 +1,184 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+#include <memory>
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parseMatchExpression(
+    const BSONObj& obj, const CollatorInterface* collator = nullptr) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->setCollator(collator);
+    StatusWithMatchExpression status = MatchExpressionParser::parse(obj, std::move(expCtx));
+    ASSERT_OK(status.getStatus());
+    return MatchExpression::optimize(std::move(status.getValue()));
+}
+
+/**
+ * Documents holding a variety of values under 'a' and 'b', including ones which are compared by
+ * the tree rather than natively.
+ */
+std::vector<BSONObj> makeDocs() {
+    const Date_t date = Date_t::fromMillisSinceEpoch(1000);
+    const std::vector<BSONObj> values = {
+        BSON("" << 1),
+        BSON("" << 2.5),
+        BSON("" << -3),
+        BSON("" << 3LL),
+        BSON("" << std::numeric_limits<double>::quiet_NaN()),
+        BSON("" << std::numeric_limits<double>::infinity()),
+        BSON("" << Decimal128("2.5")),
+        BSON(""
+             << "abc"),
+        BSON(""
+             << "b"),
+        BSON("" << BSONSymbol("abc")),
+        BSON("" << date),
+        BSON("" << (date + Milliseconds(1))),
+        BSON("" << Timestamp(1, 1)),
+        BSON("" << BSON_ARRAY(1 << 5)),
+        BSON("" << BSON_ARRAY("abc" << 1.5 << BSON_ARRAY(3))),
+        BSON("" << BSONArray()),
+        BSON("" << BSONNULL),
+        BSON("" << BSONUndefined),
+        BSON("" << MINKEY),
+        BSON("" << MAXKEY),
+        BSON("" << BSON("c" << 1)),
+        BSONObj()};
+
+    std::vector<BSONObj> docs;
+    for (size_t i = 0; i < values.size(); ++i) {
+        for (size_t j = 0; j < values.size(); j += 3) {
+            BSONObjBuilder bob;
+            if (!values[i].isEmpty()) {
+                bob.appendAs(values[i].firstElement(), "a");
+            }
+            bob.append("x", static_cast<int>(i));
+            if (!values[j].isEmpty()) {
+                bob.appendAs(values[j].firstElement(), "b");
+            }
+            // A repeated field is matched by its first occurrence.
+            bob.append("a", 1);
+            docs.push_back(bob.obj());
+        }
+    }
+    return docs;
+}
+
+/**
+ * Checks that the compiled form of 'query' matches the same documents of makeDocs() as the tree,
+ * over enough passes for the compiled predicates to be reordered.
+ */
+void assertAgreesWithTree(const BSONObj& query, const CollatorInterface* collator = nullptr) {
+    auto expr = parseMatchExpression(query, collator);
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT_TRUE(compiled != nullptr) << query;
+
+    const auto docs = makeDocs();
+    for (int pass = 0; pass < 10; ++pass) {
+        for (auto&& doc : docs) {
+            ASSERT_EQ(expr->matchesBSON(doc), compiled->matchesBSON(doc)) << query << " on "
+                                                                         << doc;
+        }
+    }
+}
+
+TEST(CompiledMatchExpressionTest, Comparisons) {
+    assertAgreesWithTree(fromjson("{a: 1}"));
+    assertAgreesWithTree(fromjson("{a: 2.5}"));
+    assertAgreesWithTree(fromjson("{a: {$lt: 3}}"));
+    assertAgreesWithTree(fromjson("{a: {$lte: 3}}"));
+    assertAgreesWithTree(fromjson("{a: {$gt: 2.5}}"));
+    assertAgreesWithTree(fromjson("{a: {$gte: -3}}"));
+    assertAgreesWithTree(BSON("a" << BSON("$gte" << 3LL)));
+    assertAgreesWithTree(BSON("a" << BSON("$lt" << std::numeric_limits<double>::infinity())));
+    assertAgreesWithTree(BSON("a" << std::numeric_limits<double>::quiet_NaN()));
+    assertAgreesWithTree(fromjson("{a: 'abc'}"));
+    assertAgreesWithTree(fromjson("{a: {$gt: 'abc'}}"));
+    assertAgreesWithTree(BSON("a" << BSON("$lte" << Date_t::fromMillisSinceEpoch(1000))));
+    assertAgreesWithTree(fromjson("{a: null}"));
+    assertAgreesWithTree(fromjson("{a: {$lt: {$maxKey: 1}}}"));
+    assertAgreesWithTree(fromjson("{a: [1, 5]}"));
+    assertAgreesWithTree(fromjson("{a: {c: 1}}"));
+}
+
+TEST(CompiledMatchExpressionTest, OtherPathPredicates) {
+    assertAgreesWithTree(fromjson("{a: {$in: [1, 'b', null]}}"));
+    assertAgreesWithTree(fromjson("{a: {$exists: false}}"));
+    assertAgreesWithTree(fromjson("{a: {$type: 'array'}}"));
+    assertAgreesWithTree(fromjson("{a: {$size: 0}}"));
+    assertAgreesWithTree(fromjson("{a: {$regex: '^a'}}"));
+    assertAgreesWithTree(fromjson("{a: {$elemMatch: {$gt: 1}}}"));
+}
+
+TEST(CompiledMatchExpressionTest, Conjunctions) {
+    assertAgreesWithTree(fromjson("{a: {$gt: 0, $lt: 3}}"));
+    assertAgreesWithTree(fromjson("{a: {$gte: 1}, b: 'abc'}"));
+    assertAgreesWithTree(fromjson("{a: {$exists: true}, b: {$exists: false}, x: {$lt: 10}}"));
+    assertAgreesWithTree(fromjson("{a: {$gt: 0}, 'b.c': 1}"));
+    assertAgreesWithTree(fromjson("{a: {$not: {$gt: 1}}, x: {$lt: 100}}"));
+    assertAgreesWithTree(fromjson("{a: {$lt: 'z'}, $or: [{b: 1}, {b: 'abc'}]}"));
+    assertAgreesWithTree(fromjson("{x: {$gte: 3}, $expr: {$lt: ['$x', 10]}}"));
+}
+
+TEST(CompiledMatchExpressionTest, ComparisonsWithCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    assertAgreesWithTree(fromjson("{a: 'abc'}"), &collator);
+    assertAgreesWithTree(fromjson("{a: {$gt: 'abc'}, x: {$lt: 5}}"), &collator);
+}
+
+TEST(CompiledMatchExpressionTest, OnlyTopLevelPathsAreCompiled) {
+    auto dotted = parseMatchExpression(fromjson("{'a.b': 1}"));
+    ASSERT_FALSE(CompiledMatchExpression::compile(dotted.get()));
+
+    auto disjunction = parseMatchExpression(fromjson("{$or: [{a: 1}, {b: 1}]}"));
+    ASSERT_FALSE(CompiledMatchExpression::compile(disjunction.get()));
+
+    auto conjunction = parseMatchExpression(fromjson("{a: 1, 'b.c': 1, d: {$gt: 1}}"));
+    auto compiled = CompiledMatchExpression::compile(conjunction.get());
+    ASSERT_TRUE(compiled != nullptr);
+    ASSERT_EQ(2U, compiled->getNumCompiledPredicates());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -31,6 +31,7 @@
 
 #include "mongo/db/matcher/expression_leaf.h"
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <pcrecpp.h>
@@ -44,6 +45,7 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/path.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/regex_util.h"
 #include "mongo/util/str.h"
 
@@ -228,6 +230,25 @@ void RegexMatchExpression::_init() {
     uassert(51091,
             str::stream() << "Regular expression is invalid: " << _re->error(),
             _re->error().empty());
+
+    if (internalQueryRegexLiteralPrefilter.load()) {
+        _requiredLiterals = regex_util::requiredLiterals(_regex, _flags);
+        _literalSearchers.reserve(_requiredLiterals.size());
+        for (auto&& literal : _requiredLiterals) {
+            _literalSearchers.emplace_back(literal.data(), literal.data() + literal.size());
+        }
+    }
+}
+
+bool RegexMatchExpression::containsRequiredLiterals(StringData data) const {
+    const char* begin = data.rawData();
+    const char* end = begin + data.size();
+    for (auto&& searcher : _literalSearchers) {
+        if (std::search(begin, end, searcher) == end) {
+            return false;
+        }
+    }
+    return true;
 }
 
 RegexMatchExpression::~RegexMatchExpression() {}
@@ -249,6 +270,9 @@ bool RegexMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetai
             // pcrecpp::StringPiece instance using the full length of the string to avoid truncating
             // 'data' early.
             pcrecpp::StringPiece data(e.valuestr(), e.valuestrsize() - 1);
+            if (!containsRequiredLiterals(StringData(data.data(), data.size()))) {
+                return false;
+            }
             return _re->PartialMatch(data);
         }
         case RegEx:
@@ -375,6 +399,7 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     next->_hasNull = _hasNull;
     next->_hasEmptyArray = _hasEmptyArray;
     next->_equalitySet = _equalitySet;
+    next->_hashedEqualities = _hashedEqualities;
     next->_originalEqualityVector = _originalEqualityVector;
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
@@ -385,6 +410,30 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
 }
 
 bool InMatchExpression::contains(const BSONElement& e) const {
+    if (_hashedEqualities) {
+        switch (e.type()) {
+            case NumberInt:
+            case NumberLong:
+                if (_hashedEqualities->integers.count(e.numberLong())) {
+                    return true;
+                }
+                if (!_hashedEqualities->hasUnhashedIntegers) {
+                    return false;
+                }
+                break;
+            case jstOID:
+                return _hashedEqualities->objectIds.count(e.OID());
+            case String:
+            case Symbol:
+                if (_collator) {
+                    return _hashedEqualities->strings.count(
+                        _collator->getComparisonKey(e.valueStringData()).getKeyData());
+                }
+                return _hashedEqualities->strings.count(e.valueStringData());
+            default:
+                break;
+        }
+    }
     return std::binary_search(_equalitySet.begin(), _equalitySet.end(), e, _eltCmp.makeLessThan());
 }
 
@@ -490,12 +539,7 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
     }
 
     // We need to re-compute '_equalitySet', since our set comparator has changed.
-    _equalitySet.clear();
-    _equalitySet.reserve(_originalEqualityVector.size());
-    std::unique_copy(_originalEqualityVector.begin(),
-                     _originalEqualityVector.end(),
-                     std::back_inserter(_equalitySet),
-                     _eltCmp.makeEqualTo());
+    computeEqualitySet();
 }
 
 Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
@@ -523,6 +567,12 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
             _originalEqualityVector.begin(), _originalEqualityVector.end(), _eltCmp.makeLessThan());
     }
 
+    computeEqualitySet();
+
+    return Status::OK();
+}
+
+void InMatchExpression::computeEqualitySet() {
     _equalitySet.clear();
     _equalitySet.reserve(_originalEqualityVector.size());
     std::unique_copy(_originalEqualityVector.begin(),
@@ -530,7 +580,50 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
                      std::back_inserter(_equalitySet),
                      _eltCmp.makeEqualTo());
 
-    return Status::OK();
+    _hashedEqualities.reset();
+    const int minEqualities = internalQueryInHashedMinEqualities.load();
+    if (minEqualities <= 0 || _equalitySet.size() < static_cast<size_t>(minEqualities)) {
+        return;
+    }
+
+    auto hashed = std::make_shared<HashedEqualities>();
+    for (auto&& equality : _equalitySet) {
+        switch (equality.type()) {
+            case NumberInt:
+            case NumberLong:
+                hashed->integers.insert(equality.numberLong());
+                break;
+            case NumberDouble: {
+                // Only a double with an integral value in the range of a long can equal an
+                // integer.
+                const double value = equality._numberDouble();
+                if (value == std::trunc(value) && value >= -0x1p63 && value < 0x1p63) {
+                    hashed->integers.insert(static_cast<long long>(value));
+                }
+                break;
+            }
+            case NumberDecimal:
+                hashed->hasUnhashedIntegers = true;
+                break;
+            case jstOID:
+                hashed->objectIds.insert(equality.OID());
+                break;
+            case String:
+            case Symbol:
+                if (_collator) {
+                    hashed->strings.insert(
+                        _collator->getComparisonKey(equality.valueStringData())
+                            .getKeyData()
+                            .toString());
+                } else {
+                    hashed->strings.insert(equality.valueStringData().toString());
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    _hashedEqualities = std::move(hashed);
 }
 
 Status InMatchExpression::addRegex(std::unique_ptr<RegexMatchExpression> expr) {
@@ -29,7 +29,10 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/bson/bsonmisc.h"
@@ -38,6 +41,8 @@
 #include "mongo/db/matcher/expression_path.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/stdx/unordered_set.h"
+#include "mongo/util/string_map.h"
 
 namespace pcrecpp {
 class RE;
@@ -326,6 +331,14 @@ public:
         return _flags;
     }
 
+    /**
+     * Returns the literals which a string must contain to match, and which are searched for
+     * before the regular expression is run, for testing.
+     */
+    const std::vector<std::string>& getRequiredLiterals() const {
+        return _requiredLiterals;
+    }
+
 private:
     ExpressionOptimizerFunc getOptimizer() const final {
         return [](std::unique_ptr<MatchExpression> expression) { return expression; };
@@ -333,9 +346,17 @@ private:
 
     void _init();
 
+    // Returns false if 'data' lacks one of the required literals, and so cannot match.
+    bool containsRequiredLiterals(StringData data) const;
+
     std::string _regex;
     std::string _flags;
     std::unique_ptr<pcrecpp::RE> _re;
+
+    // Extracted from the pattern if 'internalQueryRegexLiteralPrefilter' is enabled. Not modified
+    // once built, since each searcher refers to its literal.
+    std::vector<std::string> _requiredLiterals;
+    std::vector<std::boyer_moore_horspool_searcher<const char*>> _literalSearchers;
 };
 
 class ModMatchExpression : public LeafMatchExpression {
@@ -449,9 +470,36 @@ public:
         return _hasEmptyArray;
     }
 
+    /**
+     * Returns true if the equalities are also held in hash sets, for testing.
+     */
+    bool hasHashedEqualities() const {
+        return static_cast<bool>(_hashedEqualities);
+    }
+
 private:
+    /**
+     * The integer, ObjectId and string equalities, held in hash sets so that an element of one of
+     * those types is looked up in constant time rather than binary searched. Strings are stored as
+     * their comparison keys under the collator the sets were built for.
+     */
+    struct HashedEqualities {
+        stdx::unordered_set<long long> integers;
+
+        // True if there is a numeric equality, such as a Decimal128, which could equal an integer
+        // but is not in 'integers'.
+        bool hasUnhashedIntegers = false;
+
+        stdx::unordered_set<OID, OID::Hasher> objectIds;
+        StringSet strings;
+    };
+
     ExpressionOptimizerFunc getOptimizer() const final;
 
+    // Computes '_equalitySet' from '_originalEqualityVector', and '_hashedEqualities' from it if
+    // it holds at least 'internalQueryInHashedMinEqualities' elements.
+    void computeEqualitySet();
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -475,10 +523,13 @@ private:
     // support std::binary_search. Because we need to sort the elements anyway for things like index
     // bounds building, using binary search avoids the overhead of inserting into a hash table which
     // doesn't pay for itself in the common case where lookups are done a few times if ever.
-    // TODO It may be worth dynamically creating a hashset after matchesSingleElement() has been
-    // called "many" times.
+    // Large sets are hashed as well; see '_hashedEqualities'.
     std::vector<BSONElement> _equalitySet;
 
+    // The hashed form of '_equalitySet', if it is large enough to be worth building. Shared with
+    // the clones of this expression, since it is never modified once built.
+    std::shared_ptr<const HashedEqualities> _hashedEqualities;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
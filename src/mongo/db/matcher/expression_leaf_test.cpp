@@ -37,6 +37,7 @@
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/death_test.h"
 
 namespace mongo {
@@ -1014,6 +1015,50 @@ TEST(RegexMatchExpression, RegexAcceptsLFOption) {
                                      << "a\rb")));
 }
 
+TEST(RegexMatchExpression, RequiredLiteralsPrefilterMatchesTheSameStrings) {
+    const std::vector<std::pair<std::string, std::string>> patterns = {
+        {"error.*timeout", ""},
+        {"^abc$", "m"},
+        {"ab(c|d)?e", ""},
+        {"x[yz]+\\.w", "s"},
+        {"caf\xc3\xa9?s", ""},
+        {"err", "i"},
+    };
+    const std::vector<std::string> subjects = {"error: timeout",
+                                               "timeout error",
+                                               "abc",
+                                               "ab\nabc",
+                                               "abe",
+                                               "abde",
+                                               "xy.w",
+                                               "xzzy.w",
+                                               "cafs",
+                                               "caf\xc3\xa9s",
+                                               "ERROR",
+                                               std::string("error\0timeout", 13),
+                                               ""};
+
+    for (auto&& pattern : patterns) {
+        RegexMatchExpression plain("a", pattern.first, pattern.second);
+        ASSERT(plain.getRequiredLiterals().empty());
+
+        const auto oldPrefilter = internalQueryRegexLiteralPrefilter.load();
+        internalQueryRegexLiteralPrefilter.store(true);
+        RegexMatchExpression prefiltered("a", pattern.first, pattern.second);
+        internalQueryRegexLiteralPrefilter.store(oldPrefilter);
+        ASSERT_EQ(pattern.second == "i", prefiltered.getRequiredLiterals().empty());
+
+        for (auto&& subject : subjects) {
+            BSONObj doc = BSON("a" << subject << "b" << BSONSymbol(subject));
+            ASSERT_EQ(plain.matchesBSON(doc), prefiltered.matchesBSON(doc))
+                << pattern.first << " on " << doc;
+            ASSERT_EQ(plain.matchesSingleElement(doc["b"]),
+                      prefiltered.matchesSingleElement(doc["b"]))
+                << pattern.first << " on " << doc;
+        }
+    }
+}
+
 TEST(ModMatchExpression, MatchesElement) {
     BSONObj match = BSON("a" << 1);
     BSONObj largerMatch = BSON("a" << 4.0);
@@ -1370,6 +1415,74 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.contains(obj2.firstElement()));
 }
 
+TEST(InMatchExpression, HashedEqualitiesMatchTheSameElements) {
+    const OID oid = OID::gen();
+    BSONArray operand = BSON_ARRAY(1 << 3LL << 4.0 << 5.5 << (1LL << 62) << Decimal128("7")
+                                      << "abc" << BSONSymbol("def") << oid << BSON("x" << 1)
+                                      << BSON_ARRAY(2) << std::numeric_limits<double>::quiet_NaN()
+                                      << Date_t::fromMillisSinceEpoch(8));
+    BSONArray probes = BSON_ARRAY(
+        1 << 1.0 << 2 << 3 << 3.0 << 4 << 4LL << 5 << 5.5 << (1LL << 62) << ((1LL << 62) + 1) << 7
+          << 7LL << Decimal128("4") << "abc" << BSONSymbol("abc") << "def" << "ab" << oid
+          << OID::gen() << BSON("x" << 1) << BSON_ARRAY(2) << 2.0
+          << std::numeric_limits<double>::quiet_NaN() << Date_t::fromMillisSinceEpoch(8) << 8
+          << Timestamp(8, 0));
+
+    std::vector<BSONElement> equalities;
+    for (auto&& elt : operand) {
+        equalities.push_back(elt);
+    }
+
+    InMatchExpression searched("");
+    ASSERT_OK(searched.setEqualities(equalities));
+    ASSERT_FALSE(searched.hasHashedEqualities());
+
+    const auto oldMinEqualities = internalQueryInHashedMinEqualities.load();
+    internalQueryInHashedMinEqualities.store(2);
+    InMatchExpression hashed("");
+    ASSERT_OK(hashed.setEqualities(equalities));
+    internalQueryInHashedMinEqualities.store(oldMinEqualities);
+    ASSERT_TRUE(hashed.hasHashedEqualities());
+    ASSERT_TRUE(hashed.shallowClone()->equivalent(&hashed));
+
+    for (auto&& probe : probes) {
+        ASSERT_EQ(searched.matchesSingleElement(probe), hashed.matchesSingleElement(probe))
+            << probe;
+    }
+}
+
+TEST(InMatchExpression, HashedStringEqualitiesRespectCollation) {
+    BSONArray operand = BSON_ARRAY("abc"
+                                   << "def"
+                                   << 1);
+    BSONObj reversed = BSON(""
+                            << "cba");
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    CollatorInterfaceMock reverseCollator(CollatorInterfaceMock::MockType::kReverseString);
+
+    const auto oldMinEqualities = internalQueryInHashedMinEqualities.load();
+    internalQueryInHashedMinEqualities.store(1);
+    InMatchExpression in("");
+    in.setCollator(&collator);
+    ASSERT_OK(in.setEqualities({operand[0], operand[1], operand[2]}));
+    ASSERT_TRUE(in.hasHashedEqualities());
+    ASSERT(in.contains(BSON(""
+                            << "ABC")
+                           .firstElement()));
+    ASSERT(!in.contains(reversed.firstElement()));
+
+    // Changing the collation rebuilds the hashed strings under the new collation.
+    in.setCollator(&reverseCollator);
+    internalQueryInHashedMinEqualities.store(oldMinEqualities);
+    ASSERT_TRUE(in.hasHashedEqualities());
+    ASSERT(in.contains(BSON(""
+                            << "abc")
+                           .firstElement()));
+    ASSERT(!in.contains(BSON(""
+                             << "ABC")
+                            .firstElement()));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
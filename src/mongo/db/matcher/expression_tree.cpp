@@ -29,6 +29,9 @@
 
 #include "mongo/db/matcher/expression_tree.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
@@ -194,7 +197,49 @@ bool ListOfMatchExpression::equivalent(const MatchExpression* other) const {
 
 // -----
 
+namespace {
+
+/**
+ * Returns a rough estimate of the relative cost of matching a document against 'expr'.
+ */
+size_t estimateMatchCost(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::MATCH_IN:
+            return 2;
+        case MatchExpression::REGEX:
+        case MatchExpression::ELEM_MATCH_OBJECT:
+        case MatchExpression::ELEM_MATCH_VALUE:
+            return 4;
+        case MatchExpression::GEO:
+        case MatchExpression::GEO_NEAR:
+        case MatchExpression::TEXT:
+            return 8;
+        case MatchExpression::EXPRESSION:
+            return 16;
+        case MatchExpression::WHERE:
+            return 64;
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR:
+        case MatchExpression::NOT: {
+            size_t cost = 0;
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                cost += estimateMatchCost(expr->getChild(i));
+            }
+            return std::max(cost, size_t{1});
+        }
+        default:
+            return 1;
+    }
+}
+
+}  // namespace
+
 bool AndMatchExpression::matches(const MatchableDocument* doc, MatchDetails* details) const {
+    if (_adaptiveOrderInterval && !details) {
+        return matchesAdaptively(doc);
+    }
+
     for (size_t i = 0; i < numChildren(); i++) {
         if (!getChild(i)->matches(doc, details)) {
             if (details)
@@ -205,6 +250,53 @@ bool AndMatchExpression::matches(const MatchableDocument* doc, MatchDetails* det
     return true;
 }
 
+bool AndMatchExpression::matchesAdaptively(const MatchableDocument* doc) const {
+    if (_adaptiveOrder.size() != numChildren()) {
+        // The children have changed since the order was learned, so start over.
+        _adaptiveOrder.resize(numChildren());
+        std::iota(_adaptiveOrder.begin(), _adaptiveOrder.end(), 0);
+        _childStats.assign(numChildren(), ChildStats());
+        _numMatchedSinceReorder = 0;
+    }
+
+    if (++_numMatchedSinceReorder >= _adaptiveOrderInterval) {
+        reorderChildren();
+    }
+
+    for (size_t index : _adaptiveOrder) {
+        ChildStats& stats = _childStats[index];
+        ++stats.numTried;
+        if (!getChild(index)->matches(doc, nullptr)) {
+            ++stats.numRejected;
+            return false;
+        }
+    }
+    return true;
+}
+
+void AndMatchExpression::reorderChildren() const {
+    // Order by the share of the documents tried which each child rejected, divided by its cost.
+    std::vector<double> ranks(numChildren());
+    for (size_t i = 0; i < numChildren(); ++i) {
+        const ChildStats& stats = _childStats[i];
+        if (stats.numTried) {
+            ranks[i] = static_cast<double>(stats.numRejected) / stats.numTried /
+                estimateMatchCost(getChild(i));
+        }
+    }
+    std::stable_sort(_adaptiveOrder.begin(), _adaptiveOrder.end(), [&](size_t lhs, size_t rhs) {
+        return ranks[lhs] > ranks[rhs];
+    });
+
+    // Decay the statistics, so that the order follows changes in the documents being matched
+    // while a child which is now tried less often keeps what was learned about it.
+    for (auto&& stats : _childStats) {
+        stats.numTried /= 2;
+        stats.numRejected /= 2;
+    }
+    _numMatchedSinceReorder = 0;
+}
+
 bool AndMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails* details) const {
     for (size_t i = 0; i < numChildren(); i++) {
         if (!getChild(i)->matchesSingleElement(e, details)) {
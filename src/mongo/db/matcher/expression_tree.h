@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/matcher/expression.h"
 
 
@@ -122,6 +124,7 @@ public:
         if (getTag()) {
             self->setTag(getTag()->clone());
         }
+        self->_adaptiveOrderInterval = _adaptiveOrderInterval;
         return std::move(self);
     }
 
@@ -130,6 +133,48 @@ public:
     virtual void serialize(BSONObjBuilder* out) const;
 
     bool isTriviallyTrue() const final;
+
+    /**
+     * Makes matches() learn the order in which to try the children from the documents it sees.
+     * Every 'interval' documents, the children are reordered so that those which reject the most
+     * documents for their estimated cost are tried first. The order of the children in the tree is
+     * left as is, and a match which records MatchDetails tries them in that order. Clones of this
+     * expression learn their own order over the same interval.
+     *
+     * Once enabled, the expression must not be matched by more than one thread at a time.
+     */
+    void setAdaptiveOrderInterval(size_t interval) {
+        _adaptiveOrderInterval = interval;
+    }
+
+    size_t getAdaptiveOrderInterval() const {
+        return _adaptiveOrderInterval;
+    }
+
+    /**
+     * Returns the indexes of the children in the order in which matches() currently tries them,
+     * for testing. Empty until an adaptively ordered match has been performed.
+     */
+    const std::vector<size_t>& getAdaptiveOrder() const {
+        return _adaptiveOrder;
+    }
+
+private:
+    struct ChildStats {
+        size_t numTried = 0;
+        size_t numRejected = 0;
+    };
+
+    bool matchesAdaptively(const MatchableDocument* doc) const;
+
+    void reorderChildren() const;
+
+    size_t _adaptiveOrderInterval = 0;
+
+    // Mutable so that matches() can learn from the documents it tests.
+    mutable std::vector<size_t> _adaptiveOrder;
+    mutable std::vector<ChildStats> _childStats;
+    mutable size_t _numMatchedSinceReorder = 0;
 };
 
 class OrMatchExpression : public ListOfMatchExpression {
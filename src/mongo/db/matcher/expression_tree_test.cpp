@@ -179,6 +179,45 @@ TEST(AndOp, ElemMatchKey) {
     ASSERT_EQUALS("1", details.elemMatchKey());
 }
 
+TEST(AndOp, AdaptiveOrderTriesTheMostSelectiveChildFirst) {
+    BSONObj operands = BSON("a" << 1 << "b" << 2);
+    AndMatchExpression andOp;
+    andOp.add(new ExistsMatchExpression("a"));
+    andOp.add(new RegexMatchExpression("c", "^x", ""));
+    andOp.add(new EqualityMatchExpression("b", operands["b"]));
+    andOp.setAdaptiveOrderInterval(10);
+
+    // Every document has 'a' and a 'c' which matches, but only some have a matching 'b'.
+    for (int i = 0; i < 100; ++i) {
+        BSONObj doc = BSON("a" << i << "b" << i % 4 << "c"
+                               << "xyz");
+        ASSERT_EQ(i % 4 == 2, andOp.matchesBSON(doc));
+    }
+    ASSERT_EQ(3U, andOp.getAdaptiveOrder().size());
+    ASSERT_EQ(2U, andOp.getAdaptiveOrder()[0]);
+
+    // The clone learns an order of its own.
+    auto clone = andOp.shallowClone();
+    ASSERT(clone->matchesBSON(BSON("a" << 1 << "b" << 2 << "c"
+                                       << "x")));
+    ASSERT_EQ(0U, static_cast<AndMatchExpression*>(clone.get())->getAdaptiveOrder()[0]);
+}
+
+TEST(AndOp, AdaptiveOrderIsNotUsedWhenRecordingDetails) {
+    BSONObj baseOperand1 = BSON("a" << 1);
+    BSONObj baseOperand2 = BSON("b" << 2);
+    AndMatchExpression andOp;
+    andOp.add(new EqualityMatchExpression("a", baseOperand1["a"]));
+    andOp.add(new EqualityMatchExpression("b", baseOperand2["b"]));
+    andOp.setAdaptiveOrderInterval(1);
+
+    MatchDetails details;
+    details.requestElemMatchKey();
+    ASSERT(andOp.matchesBSON(BSON("a" << BSON_ARRAY(1) << "b" << BSON_ARRAY(1 << 2)), &details));
+    ASSERT(andOp.getAdaptiveOrder().empty());
+    ASSERT_EQUALS("1", details.elemMatchKey());
+}
+
 TEST(OrOp, NoClauses) {
     OrMatchExpression orOp;
     ASSERT(!orOp.matchesBSON(BSONObj(), nullptr));
@@ -506,6 +506,27 @@ TEST(Path, ArrayOffsetWithImplicitAndExplicitTraversal) {
     ASSERT(!cursor.more());
 }
 
+TEST(Path, FieldIndexFindsSameElements) {
+    BSONObj doc = BSON("x" << 4 << "a" << fromjson("{b: [{c: 1}, {c: 2}]}") << "d"
+                           << BSON_ARRAY(1 << BSON_ARRAY(2)) << ""
+                           << 3 << "a" << 7);
+    BSONFieldIndex index(doc);
+
+    for (auto&& path : {"x", "a", "a.b", "a.b.c", "a.b.1.c", "d", "d.1", "", "y", "x.y"}) {
+        ElementPath p;
+        p.init(path);
+
+        BSONElementIterator expected(&p, doc);
+        BSONElementIterator actual(&p, doc, &index);
+        while (expected.more()) {
+            ASSERT(actual.more()) << path;
+            ASSERT_EQUALS(expected.next().element().rawdata(), actual.next().element().rawdata())
+                << path;
+        }
+        ASSERT(!actual.more()) << path;
+    }
+}
+
 TEST(SimpleArrayElementIterator, SimpleNoArrayLast1) {
     BSONObj obj = BSON("a" << BSON_ARRAY(5 << BSON("x" << 6) << BSON_ARRAY(7 << 9) << 11));
     SimpleArrayElementIterator i(obj["a"], false);
@@ -61,6 +61,9 @@ public:
     // Name for the system views collection
     static constexpr StringData kSystemDotViewsCollectionName = "system.views"_sd;
 
+    // Prefix for the collections which store the buckets of time-series collections
+    static constexpr StringData kTimeseriesBucketsCollectionPrefix = "system.buckets."_sd;
+
     // Prefix for orphan collections
     static constexpr StringData kOrphanCollectionPrefix = "orphan."_sd;
     static constexpr StringData kOrphanCollectionDb = "local"_sd;
@@ -95,12 +98,19 @@ public:
     // Namespace for storing the persisted state of transaction coordinators.
     static const NamespaceString kTransactionCoordinatorsNamespace;
 
+    // Namespace for the images of retryable findAndModify operations. Each node writes its own
+    // images, so writes to it are not replicated.
+    static const NamespaceString kConfigImagesNamespace;
+
     // Namespace for replica set configuration settings.
     static const NamespaceString kSystemReplSetNamespace;
 
     // Namespace for index build entries.
     static const NamespaceString kIndexBuildEntryNamespace;
 
+    // Namespace for the plan cache entries saved by the planCacheSnapshot command. Not replicated.
+    static const NamespaceString kPlanCacheSnapshotNamespace;
+
     /**
      * Constructs an empty NamespaceString.
      */
@@ -232,6 +242,9 @@ public:
     bool isSystemDotViews() const {
         return coll() == kSystemDotViewsCollectionName;
     }
+    bool isTimeseriesBucketsCollection() const {
+        return coll().startsWith(kTimeseriesBucketsCollectionPrefix);
+    }
     bool isServerConfigurationCollection() const {
         return (db() == kAdminDb) && (coll() == "system.version");
     }
@@ -296,6 +309,21 @@ public:
      */
     bool isLegalClientSystemNS() const;
 
+    /**
+     * Returns the namespace of the collection which stores the buckets of the time-series
+     * collection with this namespace.
+     *
+     * Example:
+     *     test.foo -> test.system.buckets.foo
+     */
+    NamespaceString makeTimeseriesBucketsNamespace() const;
+
+    /**
+     * Returns the namespace of the time-series collection whose buckets this collection stores.
+     * This namespace must be a time-series buckets collection.
+     */
+    NamespaceString getTimeseriesViewNamespace() const;
+
     /**
      * Returns true if this namespace refers to a drop-pending collection.
      */
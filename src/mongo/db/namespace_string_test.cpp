@@ -199,6 +199,18 @@ TEST(NamespaceStringTest, MakeDropPendingNamespace) {
     ASSERT_EQUALS(std::size_t(NamespaceString::MaxNsCollectionLen), dropPendingNss.size());
 }
 
+TEST(NamespaceStringTest, TimeseriesBucketsNamespace) {
+    const NamespaceString bucketsNss = NamespaceString{"test.foo"}.makeTimeseriesBucketsNamespace();
+    ASSERT_EQUALS(NamespaceString{"test.system.buckets.foo"}, bucketsNss);
+    ASSERT_TRUE(bucketsNss.isTimeseriesBucketsCollection());
+    ASSERT_TRUE(bucketsNss.isLegalClientSystemNS());
+    ASSERT_EQUALS(NamespaceString{"test.foo"}, bucketsNss.getTimeseriesViewNamespace());
+
+    ASSERT_FALSE(NamespaceString{"test.foo"}.isTimeseriesBucketsCollection());
+    ASSERT_FALSE(NamespaceString{"test.system.views"}.isTimeseriesBucketsCollection());
+    ASSERT_FALSE(NamespaceString{"test.buckets.foo"}.isTimeseriesBucketsCollection());
+}
+
 TEST(NamespaceStringTest, GetDropPendingNamespaceOpTime) {
     // Null optime is acceptable.
     ASSERT_EQUALS(
@@ -50,6 +50,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_entry_gen.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/server_options.h"
@@ -195,7 +196,20 @@ OpTimeBundle replLogUpdate(OperationContext* opCtx, const OplogUpdateEntryArgs&
     OpTimeBundle opTimes;
     opTimes.wallClockTime = getWallClockTimeForOpLog(opCtx);
 
-    if (!storeObj.isEmpty() && opCtx->getTxnNumber()) {
+    boost::optional<repl::RetryImageEnum> imageKind;
+    if (args.updateArgs.storeDocOption == CollectionUpdateArgs::StoreDocOption::PreImage) {
+        imageKind = repl::RetryImageEnum::kPreImage;
+    } else if (args.updateArgs.storeDocOption == CollectionUpdateArgs::StoreDocOption::PostImage) {
+        imageKind = repl::RetryImageEnum::kPostImage;
+    }
+    // A retryable findAndModify may store its image in config.image_collection, rather than in a
+    // no-op oplog entry which doubles the oplog volume of the write.
+    const bool storeImageInSideCollection = !storeObj.isEmpty() && opCtx->getTxnNumber() &&
+        repl::storeFindAndModifyImagesInSideCollection;
+
+    if (storeImageInSideCollection) {
+        oplogLink.needsRetryImage = imageKind;
+    } else if (!storeObj.isEmpty() && opCtx->getTxnNumber()) {
         auto noteUpdateOpTime = logOperation(opCtx,
                                              "n",
                                              args.nss,
@@ -230,7 +244,16 @@ OpTimeBundle replLogUpdate(OperationContext* opCtx, const OplogUpdateEntryArgs&
                                        sessionInfo,
                                        args.updateArgs.stmtId,
                                        oplogLink,
-                                       OplogSlot());
+                                       args.updateArgs.oplogSlot);
+
+    if (storeImageInSideCollection && !opTimes.writeOpTime.isNull()) {
+        repl::writeToImageCollection(opCtx,
+                                     *opCtx->getLogicalSessionId(),
+                                     *opCtx->getTxnNumber(),
+                                     opTimes.writeOpTime.getTimestamp(),
+                                     *imageKind,
+                                     storeObj);
+    }
 
     return opTimes;
 }
@@ -257,7 +280,12 @@ OpTimeBundle replLogDelete(OperationContext* opCtx,
     OpTimeBundle opTimes;
     opTimes.wallClockTime = getWallClockTimeForOpLog(opCtx);
 
-    if (deletedDoc && opCtx->getTxnNumber()) {
+    const bool storeImageInSideCollection =
+        deletedDoc && opCtx->getTxnNumber() && repl::storeFindAndModifyImagesInSideCollection;
+
+    if (storeImageInSideCollection) {
+        oplogLink.needsRetryImage = repl::RetryImageEnum::kPreImage;
+    } else if (deletedDoc && opCtx->getTxnNumber()) {
         auto noteOplog = logOperation(opCtx,
                                       "n",
                                       nss,
@@ -287,6 +315,15 @@ OpTimeBundle replLogDelete(OperationContext* opCtx,
                                        stmtId,
                                        oplogLink,
                                        OplogSlot());
+
+    if (storeImageInSideCollection && !opTimes.writeOpTime.isNull()) {
+        repl::writeToImageCollection(opCtx,
+                                     *opCtx->getLogicalSessionId(),
+                                     *opCtx->getTxnNumber(),
+                                     opTimes.writeOpTime.getTimestamp(),
+                                     repl::RetryImageEnum::kPreImage,
+                                     *deletedDoc);
+    }
     return opTimes;
 }
 
@@ -959,6 +996,9 @@ namespace {
 // If 'limitSize' is false, then it attempts to include all given operations, regardless of whether
 // or not they fit. If the ops don't fit, TransactionTooLarge will be thrown in that case.
 //
+// The operations are serialized straight into the array, without first building each one as a
+// BSONObj of its own.
+//
 // Returns an iterator to the first statement that wasn't packed into the applyOps object.
 std::vector<repl::ReplOperation>::const_iterator packTransactionStatementsForApplyOps(
     BSONObjBuilder* applyOpsBuilder,
@@ -982,7 +1022,8 @@ std::vector<repl::ReplOperation>::const_iterator packTransactionStatementsForApp
               (opsArray.len() + OplogEntry::getDurableReplOperationSize(stmt) >
                BSONObjMaxUserSize))))
             break;
-        opsArray.append(stmt.toBSON());
+        BSONObjBuilder opBuilder(opsArray.subobjStart());
+        stmt.serialize(&opBuilder);
     }
     try {
         // BSONArrayBuilder will throw a BSONObjectTooLarge exception if we exceeded the max BSON
@@ -998,6 +1039,21 @@ std::vector<repl::ReplOperation>::const_iterator packTransactionStatementsForApp
     return stmtIter;
 }
 
+// Returns how large a buffer the applyOps object packing the statements from 'stmtBegin' to
+// 'stmtEnd' needs, from the size of each operation, so that building it does not have to grow the
+// buffer and copy what it holds so far for a large transaction. A packed applyOps object is at most
+// about BSONObjMaxUserSize, so the estimate is capped there.
+int applyOpsBufferSize(std::vector<repl::ReplOperation>::const_iterator stmtBegin,
+                       std::vector<repl::ReplOperation>::const_iterator stmtEnd) {
+    const std::size_t maxSize = BSONObjMaxUserSize;
+    // Room for the other fields of the applyOps object, such as 'partialTxn' and 'count'.
+    std::size_t size = 512;
+    for (auto stmtIter = stmtBegin; stmtIter != stmtEnd && size < maxSize; ++stmtIter) {
+        size += OplogEntry::getDurableReplOperationSize(*stmtIter);
+    }
+    return std::min(size, maxSize);
+}
+
 // Logs one applyOps entry and may update the transactions table. Assumes that the given BSON
 // builder object already has  an 'applyOps' field appended pointing to the desired array of ops
 // i.e. { "applyOps" : [op1, op2, ...] }
@@ -1095,7 +1151,7 @@ OpTimeBundle logApplyOpsForTransaction(OperationContext* opCtx,
                                        const bool updateTxnTable,
                                        boost::optional<long long> count,
                                        boost::optional<repl::OpTime> startOpTime) {
-    BSONObjBuilder applyOpsBuilder;
+    BSONObjBuilder applyOpsBuilder(applyOpsBufferSize(statements.begin(), statements.end()));
     packTransactionStatementsForApplyOps(
         &applyOpsBuilder, statements.begin(), statements.end(), false /* limitSize */);
     return logApplyOpsForTransaction(opCtx,
@@ -1158,7 +1214,7 @@ int logOplogEntriesForTransaction(OperationContext* opCtx,
             auto stmtsIter = stmts.begin();
             while (stmtsIter != stmts.end()) {
 
-                BSONObjBuilder applyOpsBuilder;
+                BSONObjBuilder applyOpsBuilder(applyOpsBufferSize(stmtsIter, stmts.end()));
                 auto nextStmt = packTransactionStatementsForApplyOps(
                     &applyOpsBuilder, stmtsIter, stmts.end(), true /* limitSize */);
 
@@ -0,0 +1,81 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+const OperationContext::Decoration<OperationArena> OperationArena::get =
+    OperationContext::declareDecoration<OperationArena>();
+
+constexpr size_t OperationArena::kInitialBlockSize;
+constexpr size_t OperationArena::kMaxBlockSize;
+
+void* OperationArena::allocate(size_t bytes, size_t alignment) {
+    invariant(alignment && (alignment & (alignment - 1)) == 0);
+    invariant(alignment <= alignof(std::max_align_t));
+
+    const auto current = reinterpret_cast<std::uintptr_t>(_current);
+    const size_t padding = (alignment - (current & (alignment - 1))) & (alignment - 1);
+    const size_t available = _end - _current;
+    if (padding > available || bytes > available - padding) {
+        // Requests which would take up most of a block get a block of their own, so that they do
+        // not waste what is left of the current one.
+        if (bytes > _nextBlockSize / 4) {
+            _bytesAllocated += bytes;
+            return _allocateBlock(bytes);
+        }
+
+        _current = _allocateBlock(_nextBlockSize);
+        _end = _current + _nextBlockSize;
+        _nextBlockSize = std::min(_nextBlockSize * 2, kMaxBlockSize);
+        return allocate(bytes, alignment);
+    }
+
+    char* const result = _current + padding;
+    _current = result + bytes;
+    _bytesAllocated += bytes;
+    return result;
+}
+
+char* OperationArena::_allocateBlock(size_t bytes) {
+    // Memory from operator new[] is suitably aligned for any fundamental type.
+    _blocks.emplace_back(new char[bytes]);
+    _bytesReserved += bytes;
+    return _blocks.back().get();
+}
+
+}  // namespace mongo
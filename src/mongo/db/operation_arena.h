@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/operation_context.h"
+
+namespace mongo {
+
+/**
+ * A monotonic arena which lives as long as an OperationContext. Memory handed out by the arena is
+ * never reused or freed individually; all of it is released in one go when the operation ends.
+ * This makes it a good fit for the many small objects that are built up while an operation runs
+ * and are dropped together when it finishes, and a poor fit for anything which grows and shrinks
+ * repeatedly or may outlive the operation, such as plan executors saved in a ClientCursor.
+ *
+ * Code opts in by allocating through OperationArenaAllocator, for instance as the allocator of a
+ * standard container. The arena is not thread safe, like the OperationContext it decorates.
+ */
+class OperationArena {
+    OperationArena(const OperationArena&) = delete;
+    OperationArena& operator=(const OperationArena&) = delete;
+
+public:
+    static const OperationContext::Decoration<OperationArena> get;
+
+    // Size of the first block the arena gets from the heap. Every following block is twice the
+    // size of the previous one, up to kMaxBlockSize.
+    static constexpr size_t kInitialBlockSize = 4 * 1024;
+    static constexpr size_t kMaxBlockSize = 1024 * 1024;
+
+    OperationArena() = default;
+
+    /**
+     * Returns 'bytes' of memory aligned to 'alignment', which must be a power of two. The memory
+     * stays valid until the arena is destroyed.
+     */
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * Returns the number of bytes handed out by allocate() so far.
+     */
+    size_t bytesAllocated() const {
+        return _bytesAllocated;
+    }
+
+    /**
+     * Returns the number of bytes the arena got from the heap so far.
+     */
+    size_t bytesReserved() const {
+        return _bytesReserved;
+    }
+
+private:
+    char* _allocateBlock(size_t bytes);
+
+    std::vector<std::unique_ptr<char[]>> _blocks;
+    char* _current = nullptr;
+    char* _end = nullptr;
+    size_t _nextBlockSize = kInitialBlockSize;
+
+    size_t _bytesAllocated = 0;
+    size_t _bytesReserved = 0;
+};
+
+/**
+ * A standard allocator which gets its memory from an OperationArena. Deallocation is a no-op, the
+ * memory is only given back when the arena is destroyed.
+ */
+template <typename T>
+class OperationArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit OperationArenaAllocator(OperationArena* arena) : _arena(arena) {}
+    explicit OperationArenaAllocator(OperationContext* opCtx)
+        : OperationArenaAllocator(&OperationArena::get(opCtx)) {}
+
+    template <typename U>
+    OperationArenaAllocator(const OperationArenaAllocator<U>& other) : _arena(other.arena()) {}
+
+    T* allocate(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {}
+
+    OperationArena* arena() const {
+        return _arena;
+    }
+
+    template <typename U>
+    bool operator==(const OperationArenaAllocator<U>& other) const {
+        return _arena == other.arena();
+    }
+
+    template <typename U>
+    bool operator!=(const OperationArenaAllocator<U>& other) const {
+        return !(*this == other);
+    }
+
+private:
+    OperationArena* _arena;
+};
+
+}  // namespace mongo
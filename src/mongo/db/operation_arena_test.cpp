@@ -0,0 +1,101 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_arena.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+bool isAligned(const void* ptr, size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST(OperationArenaTest, AllocationsAreAlignedAndDoNotOverlap) {
+    OperationArena arena;
+    char* previous = static_cast<char*>(arena.allocate(1, 1));
+    for (size_t alignment : {2, 4, 8, 16}) {
+        char* next = static_cast<char*>(arena.allocate(3, alignment));
+        ASSERT(isAligned(next, alignment));
+        ASSERT_GT(next, previous);
+        previous = next + 2;
+    }
+    ASSERT_EQ(arena.bytesAllocated(), 1U + 4 * 3);
+    ASSERT_EQ(arena.bytesReserved(), OperationArena::kInitialBlockSize);
+}
+
+TEST(OperationArenaTest, BlocksGrowWhenFull) {
+    OperationArena arena;
+    const size_t chunk = OperationArena::kInitialBlockSize / 8;
+    for (int i = 0; i < 8; ++i) {
+        arena.allocate(chunk);
+    }
+    ASSERT_EQ(arena.bytesReserved(), OperationArena::kInitialBlockSize);
+
+    arena.allocate(chunk);
+    ASSERT_EQ(arena.bytesReserved(), 3 * OperationArena::kInitialBlockSize);
+}
+
+TEST(OperationArenaTest, LargeAllocationsGetTheirOwnBlock) {
+    OperationArena arena;
+    arena.allocate(8);
+    arena.allocate(OperationArena::kInitialBlockSize);
+    ASSERT_EQ(arena.bytesReserved(), 2 * OperationArena::kInitialBlockSize);
+
+    // The first block still has room for small allocations.
+    arena.allocate(8);
+    ASSERT_EQ(arena.bytesReserved(), 2 * OperationArena::kInitialBlockSize);
+}
+
+class OperationArenaContextTest : public ServiceContextTest {};
+
+TEST_F(OperationArenaContextTest, ContainersCanAllocateFromTheOperationArena) {
+    auto opCtx = makeOperationContext();
+    OperationArenaAllocator<int> alloc(opCtx.get());
+    ASSERT(alloc.arena() == &OperationArena::get(opCtx.get()));
+
+    std::vector<int, OperationArenaAllocator<int>> values(alloc);
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(values[i], i);
+    }
+    ASSERT_GTE(OperationArena::get(opCtx.get()).bytesAllocated(), 1000 * sizeof(int));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -77,6 +77,10 @@ class OperationContext : public Interruptible, public Decorable<OperationContext
     OperationContext& operator=(const OperationContext&) = delete;
 
 public:
+    // Size of the region at the front of the decorations which holds those declared with
+    // declareHotDecoration(), such as the read concern and the sharding state of the operation.
+    static constexpr size_t kHotDecorationBytes = 6 * 64;
+
     OperationContext(Client* client, unsigned int opId);
     virtual ~OperationContext();
 
@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * The time an operation has spent blocked, broken down by what it was waiting for. Lock waits,
+ * flow control and storage engine cache stalls are already reported in the "locks", "flowControl"
+ * and "storage" sections of slow operations, so they are not repeated here.
+ *
+ * Times may be added by the operation's own thread while another thread reports them.
+ */
+class OperationWaitStats {
+public:
+    enum class WaitState {
+        kTicket,           // Queued for a read or write ticket to take the global lock.
+        kPrepareConflict,  // Blocked reading a document written by a prepared transaction.
+        kWriteConcern,     // Waiting for the write concern to be satisfied.
+        kAwaitData,        // A getMore on an awaitData cursor, waiting for new data.
+        kNumWaitStates,
+    };
+
+    /**
+     * Adds the time between its construction and destruction to a wait state. Does nothing when
+     * 'opCtx' is null.
+     */
+    class ScopedWait {
+        ScopedWait(const ScopedWait&) = delete;
+        ScopedWait& operator=(const ScopedWait&) = delete;
+
+    public:
+        ScopedWait(OperationContext* opCtx, WaitState state)
+            : _stats(opCtx ? &get(opCtx) : nullptr), _state(state) {}
+
+        ~ScopedWait() {
+            if (_stats) {
+                _stats->add(_state, _timer.elapsed());
+            }
+        }
+
+    private:
+        OperationWaitStats* const _stats;
+        const WaitState _state;
+        const Timer _timer;
+    };
+
+    static const OperationContext::Decoration<OperationWaitStats> get;
+
+    void add(WaitState state, Microseconds duration) {
+        _waitMicros[static_cast<size_t>(state)].fetchAndAddRelaxed(
+            durationCount<Microseconds>(duration));
+    }
+
+    Microseconds getWaitTime(WaitState state) const {
+        return Microseconds(_waitMicros[static_cast<size_t>(state)].loadRelaxed());
+    }
+
+    /**
+     * Appends "<waitState>Micros" for each wait state the operation has spent time in.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+    BSONObj toBSON() const;
+
+private:
+    std::array<AtomicWord<long long>, static_cast<size_t>(WaitState::kNumWaitStates)>
+        _waitMicros{};
+};
+
+}  // namespace mongo
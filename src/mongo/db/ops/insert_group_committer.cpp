@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ops/insert_group_committer.h"
+
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+const auto getInsertGroupCommitter = ServiceContext::declareDecoration<InsertGroupCommitter>();
+
+}  // namespace
+
+InsertGroupCommitter& InsertGroupCommitter::get(ServiceContext* service) {
+    return getInsertGroupCommitter(service);
+}
+
+Status InsertGroupCommitter::insert(const UUID& uuid,
+                                    const InsertStatement& insert,
+                                    size_t maxGroupSize,
+                                    const CommitFn& commit) {
+    Waiter self(insert);
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto& groupEntry = _groups[uuid];
+    if (!groupEntry) {
+        groupEntry = std::make_shared<Group>();
+    }
+    const auto group = groupEntry;
+    group->waiters.push_back(&self);
+
+    // Wait for a leader to insert our document, or to become the leader once there is none. The
+    // wait is not interruptible, since the leader may already be inserting our document.
+    group->cv.wait(lk, [&] { return self.done || !group->hasLeader; });
+    if (!self.done) {
+        group->hasLeader = true;
+        while (!self.done) {
+            std::vector<Waiter*> waiters;
+            while (!group->waiters.empty() && waiters.size() < maxGroupSize) {
+                waiters.push_back(group->waiters.front());
+                group->waiters.pop_front();
+            }
+
+            std::vector<InsertStatement> inserts;
+            inserts.reserve(waiters.size());
+            for (auto waiter : waiters) {
+                inserts.push_back(waiter->insert);
+            }
+
+            lk.unlock();
+            auto statuses = commit(inserts);
+            lk.lock();
+
+            invariant(statuses.size() == waiters.size());
+            for (size_t i = 0; i < waiters.size(); ++i) {
+                waiters[i]->status = std::move(statuses[i]);
+                waiters[i]->done = true;
+            }
+            group->cv.notify_all();
+        }
+
+        // Let one of those which arrived during our last batch take over, if any. They have been
+        // woken above while we were still the leader, so must be woken again to see that we are
+        // not anymore.
+        group->hasLeader = false;
+        if (group->waiters.empty()) {
+            _groups.erase(uuid);
+        } else {
+            group->cv.notify_all();
+        }
+    }
+
+    return self.status;
+}
+
+size_t InsertGroupCommitter::getNumWaitingForTest(const UUID& uuid) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _groups.find(uuid);
+    return it == _groups.end() ? 0 : it->second->waiters.size();
+}
+
+}  // namespace mongo
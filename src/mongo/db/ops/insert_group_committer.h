@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+struct InsertStatement;
+class ServiceContext;
+
+/**
+ * Combines the single-document inserts which clients make into the same collection at the same
+ * time. The first of them to arrive becomes the leader, and inserts its document along with those
+ * of the clients waiting behind it in one WriteUnitOfWork, saving each of them the costs of its
+ * own storage transaction, oplog slot reservation and commit.
+ */
+class InsertGroupCommitter {
+public:
+    /**
+     * Inserts the documents of 'inserts' and returns the status of inserting each of them.
+     */
+    using CommitFn =
+        std::function<std::vector<Status>(const std::vector<InsertStatement>& inserts)>;
+
+    static InsertGroupCommitter& get(ServiceContext* service);
+
+    /**
+     * Groups 'insert' with the other inserts made into the collection 'uuid' at the same time, and
+     * returns the status of inserting it. The leader of each group passes at most
+     * 'maxGroupSize' of them at a time to its 'commit' function, and keeps doing so until its own
+     * insert is done. The caller must keep the collection locked, and must not be in a
+     * WriteUnitOfWork.
+     */
+    Status insert(const UUID& uuid,
+                  const InsertStatement& insert,
+                  size_t maxGroupSize,
+                  const CommitFn& commit);
+
+    /**
+     * Returns the number of inserts into the collection 'uuid' which no leader has taken yet.
+     */
+    size_t getNumWaitingForTest(const UUID& uuid);
+
+private:
+    struct Waiter {
+        explicit Waiter(const InsertStatement& insert) : insert(insert) {}
+
+        const InsertStatement& insert;
+        bool done = false;
+        Status status = Status::OK();
+    };
+
+    struct Group {
+        stdx::condition_variable cv;
+        std::deque<Waiter*> waiters;
+        bool hasLeader = false;
+    };
+
+    stdx::mutex _mutex;
+    stdx::unordered_map<UUID, std::shared_ptr<Group>, UUID::Hash> _groups;
+};
+
+}  // namespace mongo
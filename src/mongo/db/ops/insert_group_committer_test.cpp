@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ops/insert_group_committer.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+std::vector<Status> okStatuses(const std::vector<InsertStatement>& inserts) {
+    return std::vector<Status>(inserts.size(), Status::OK());
+}
+
+TEST(InsertGroupCommitterTest, InsertsQueuedTogetherAreCommittedTogether) {
+    InsertGroupCommitter committer;
+    const auto uuid = UUID::gen();
+    const InsertStatement firstInsert(BSON("_id" << 0));
+    const std::vector<InsertStatement> queuedInserts{InsertStatement(BSON("_id" << 1)),
+                                                     InsertStatement(BSON("_id" << 2))};
+
+    std::vector<Status> queuedStatuses(queuedInserts.size(), Status::OK());
+    std::vector<stdx::thread> threads;
+    std::vector<std::vector<BSONObj>> batches;
+    InsertGroupCommitter::CommitFn commit = [&](const std::vector<InsertStatement>& inserts) {
+        if (batches.empty()) {
+            // Queue two more inserts while the first one is being committed.
+            for (size_t i = 0; i < queuedInserts.size(); ++i) {
+                threads.emplace_back([&, i] {
+                    queuedStatuses[i] = committer.insert(uuid, queuedInserts[i], 10, commit);
+                });
+            }
+            while (committer.getNumWaitingForTest(uuid) < queuedInserts.size()) {
+                sleepmillis(1);
+            }
+        }
+
+        batches.emplace_back();
+        std::vector<Status> statuses;
+        for (auto&& insert : inserts) {
+            batches.back().push_back(insert.doc);
+            statuses.push_back(insert.doc["_id"].numberInt() == 2
+                                   ? Status(ErrorCodes::DuplicateKey, "duplicate")
+                                   : Status::OK());
+        }
+        return statuses;
+    };
+
+    ASSERT_OK(committer.insert(uuid, firstInsert, 10, commit));
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(2U, batches.size());
+    ASSERT_EQ(1U, batches[0].size());
+    ASSERT_EQ(2U, batches[1].size());
+    ASSERT_OK(queuedStatuses[0]);
+    ASSERT_EQ(ErrorCodes::DuplicateKey, queuedStatuses[1]);
+    ASSERT_EQ(0U, committer.getNumWaitingForTest(uuid));
+}
+
+TEST(InsertGroupCommitterTest, FollowerQueuedDuringLastBatchTakesOver) {
+    InsertGroupCommitter committer;
+    const auto uuid = UUID::gen();
+    const InsertStatement leaderInsert(BSON("_id" << 0));
+    const InsertStatement followerInsert(BSON("_id" << 1));
+
+    AtomicWord<bool> followerDone{false};
+    Status followerStatus(ErrorCodes::InternalError, "follower insert not committed");
+    stdx::thread follower;
+    auto leaderCommit = [&](const std::vector<InsertStatement>& inserts) {
+        // Another client queues while the leader inserts its own document in its last batch.
+        follower = stdx::thread([&] {
+            followerStatus = committer.insert(uuid, followerInsert, 10, okStatuses);
+            followerDone.store(true);
+        });
+        while (committer.getNumWaitingForTest(uuid) == 0) {
+            sleepmillis(1);
+        }
+        return okStatuses(inserts);
+    };
+
+    ASSERT_OK(committer.insert(uuid, leaderInsert, 10, leaderCommit));
+
+    // No other insert follows, so the follower must become the leader on its own.
+    const auto deadline = Date_t::now() + Seconds(60);
+    while (!followerDone.load() && Date_t::now() < deadline) {
+        sleepmillis(1);
+    }
+    ASSERT_TRUE(followerDone.load());
+    follower.join();
+    ASSERT_OK(followerStatus);
+    ASSERT_EQ(0U, committer.getNumWaitingForTest(uuid));
+}
+
+}  // namespace
+}  // namespace mongo
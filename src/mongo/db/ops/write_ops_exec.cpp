@@ -31,13 +31,16 @@
 
 #include "mongo/platform/basic.h"
 
+#include <map>
 #include <memory>
+#include <vector>
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/transaction_error.h"
 #include "mongo/db/audit.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/document_validation.h"
@@ -46,6 +49,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/curop_metrics.h"
+#include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/update_stage.h"
 #include "mongo/db/introspect.h"
@@ -53,6 +57,7 @@
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/ops/delete_request.h"
 #include "mongo/db/ops/insert.h"
+#include "mongo/db/ops/insert_group_committer.h"
 #include "mongo/db/ops/parsed_delete.h"
 #include "mongo/db/ops/parsed_update.h"
 #include "mongo/db/ops/update_request.h"
@@ -61,6 +66,7 @@
 #include "mongo/db/ops/write_ops_retryability.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/retryable_writes_stats.h"
@@ -71,7 +77,10 @@
 #include "mongo/db/stats/server_write_concern_metrics.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/db/storage/duplicate_key_error_info.h"
+#include "mongo/db/timeseries/bucket_compression.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
 #include "mongo/db/transaction_participant.h"
+#include "mongo/db/views/view.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/cannot_implicitly_create_collection_info.h"
@@ -322,6 +331,39 @@ void insertDocuments(OperationContext* opCtx,
     wuow.commit();
 }
 
+/**
+ * Inserts the documents of 'inserts' into 'collection' for the InsertGroupCommitter, in one
+ * WriteUnitOfWork, or one at a time if that fails so that each of them gets the status of
+ * inserting its own document.
+ */
+std::vector<Status> commitInsertGroup(OperationContext* opCtx,
+                                      Collection* collection,
+                                      std::vector<InsertStatement> inserts) {
+    std::vector<Status> statuses(inserts.size(), Status::OK());
+    if (inserts.size() > 1) {
+        try {
+            writeConflictRetry(opCtx, "insert", collection->ns().ns(), [&] {
+                insertDocuments(opCtx, collection, inserts.begin(), inserts.end(), false);
+            });
+            return statuses;
+        } catch (const DBException&) {
+            // Insert the documents one at a time below, to find out which of them failed.
+        }
+    }
+
+    for (size_t i = 0; i < inserts.size(); ++i) {
+        try {
+            writeConflictRetry(opCtx, "insert", collection->ns().ns(), [&] {
+                auto it = inserts.begin() + i;
+                insertDocuments(opCtx, collection, it, it + 1, false);
+            });
+        } catch (const DBException& ex) {
+            statuses[i] = ex.toStatus();
+        }
+    }
+    return statuses;
+}
+
 /**
  * Returns a OperationNotSupportedInTransaction error Status if we are in a transaction and
  * operating on a capped collection.
@@ -424,6 +466,16 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
         collection.reset();
     }
 
+    // Single-document inserts outside of a transaction or retryable write may be combined with
+    // those of other clients. Capped collections are excluded for the same reason as above.
+    auto canGroupCommit = [&](Collection* coll) {
+        auto txnParticipant = TransactionParticipant::get(opCtx);
+        return internalInsertGroupCommit.load() && batch.size() == 1 && !fromMigrate &&
+            !opCtx->getTxnNumber() &&
+            !(txnParticipant && txnParticipant.inActiveOrKilledMultiDocumentTransaction()) &&
+            !opCtx->lockState()->inAWriteUnitOfWork() && supportsDocLocking() && !coll->isCapped();
+    };
+
     // Try to insert the batch one-at-a-time. This path is executed for singular batches,
     // multi-statement transactions, capped collections, and if we failed all-at-once inserting.
     for (auto it = batch.begin(); it != batch.end(); ++it) {
@@ -439,7 +491,21 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
                     uassertStatusOK(
                         checkIfTransactionOnCappedColl(opCtx, collection->getCollection()));
                     lastOpFixer->startingOp();
-                    insertDocuments(opCtx, collection->getCollection(), it, it + 1, fromMigrate);
+                    if (canGroupCommit(collection->getCollection())) {
+                        invariant(!opCtx->lockState()->inAWriteUnitOfWork());
+                        auto coll = collection->getCollection();
+                        uassertStatusOK(
+                            InsertGroupCommitter::get(opCtx->getServiceContext())
+                                .insert(*coll->uuid(),
+                                        *it,
+                                        internalInsertMaxBatchSize.load(),
+                                        [&](const std::vector<InsertStatement>& inserts) {
+                                            return commitInsertGroup(opCtx, coll, inserts);
+                                        }));
+                    } else {
+                        insertDocuments(
+                            opCtx, collection->getCollection(), it, it + 1, fromMigrate);
+                    }
                     lastOpFixer->finishedOpSuccessfully();
                     SingleWriteResult result;
                     result.setN(1);
@@ -482,6 +548,218 @@ SingleWriteResult makeWriteResultForInsertOrDeleteRetry() {
     return res;
 }
 
+/**
+ * Returns the options of the time-series collection 'ns', or none if 'ns' is not the view of a
+ * time-series collection.
+ */
+boost::optional<TimeseriesOptions> getTimeseriesOptions(OperationContext* opCtx,
+                                                        const NamespaceString& ns) {
+    if (ns.isSystem()) {
+        return boost::none;
+    }
+
+    // Almost every insert is into a regular collection, which has no buckets collection, so check
+    // the catalog before taking any locks.
+    const auto bucketsNs = ns.makeTimeseriesBucketsNamespace();
+    if (!CollectionCatalog::get(opCtx).lookupCollectionByNamespace(bucketsNs)) {
+        return boost::none;
+    }
+
+    AutoGetCollection autoView(opCtx, ns, MODE_IS, AutoGetCollection::kViewsPermitted);
+    auto view = autoView.getView();
+    if (!view || view->viewOn() != bucketsNs) {
+        return boost::none;
+    }
+
+    AutoGetCollection autoBuckets(opCtx, bucketsNs, MODE_IS);
+    auto bucketsColl = autoBuckets.getCollection();
+    if (!bucketsColl) {
+        return boost::none;
+    }
+    return bucketsColl->getCatalogEntry()->getCollectionOptions(opCtx).timeseries;
+}
+
+/**
+ * Adds 'measurements', which start the span at 'start' and have the metadata 'meta', to the
+ * buckets for that span and metadata in 'bucketsNs'. The measurements go into the first bucket
+ * which is neither full nor for other metadata with the same hash, and new buckets are created as
+ * needed. Throws if a bucket cannot be written.
+ *
+ * The compressed columns can't be appended to, so adding to a bucket unpacks and rewrites all of
+ * it. A measurement inserted on its own therefore costs time in the size of its bucket, which
+ * timeseriesBucketMaxCount bounds. Inserting measurements in batches spreads that cost over them.
+ */
+void insertIntoBuckets(OperationContext* opCtx,
+                       const NamespaceString& bucketsNs,
+                       const TimeseriesOptions& options,
+                       Date_t start,
+                       const BSONElement& meta,
+                       const std::vector<BSONObj>& measurements) {
+    const size_t maxCount = gTimeseriesBucketMaxCount.load();
+    size_t numInserted = 0;
+    int n = 0;
+    while (numInserted < measurements.size()) {
+        writeConflictRetry(opCtx, "insert into time-series buckets", bucketsNs.ns(), [&] {
+            AutoGetCollection autoColl(opCtx, bucketsNs, MODE_IX);
+            Collection* collection = autoColl.getCollection();
+            uassert(ErrorCodes::NamespaceNotFound,
+                    str::stream() << "Time-series buckets collection " << bucketsNs
+                                  << " was dropped",
+                    collection);
+            assertCanWrite_inlock(opCtx, bucketsNs);
+
+            WriteUnitOfWork wuow(opCtx);
+            const BSONObj id = timeseries::makeBucketId(start, meta, n);
+            const RecordId rid =
+                Helpers::findById(opCtx, collection, BSON(timeseries::kBucketIdFieldName << id));
+
+            Snapshotted<BSONObj> oldBucket;
+            std::vector<BSONObj> contents;
+            if (!rid.isNull()) {
+                oldBucket = collection->docFor(opCtx, rid);
+                const BSONObj& bucket = oldBucket.value();
+                const BSONElement bucketMeta = bucket[timeseries::kBucketMetaFieldName];
+                const bool sameMeta =
+                    meta.eoo() ? bucketMeta.eoo() : meta.binaryEqualValues(bucketMeta);
+                const BSONElement count = bucket[timeseries::kBucketControlFieldName]
+                                                [timeseries::kBucketControlCountFieldName];
+                if (!sameMeta || static_cast<size_t>(count.numberLong()) >= maxCount) {
+                    ++n;
+                    return;
+                }
+                timeseries::unpackBucket(options, bucket, &contents);
+            }
+
+            const size_t numExisting = contents.size();
+            size_t numAdded = std::min(maxCount - numExisting, measurements.size() - numInserted);
+            auto first = measurements.begin() + numInserted;
+            contents.insert(contents.end(), first, first + numAdded);
+            BSONObj newBucket = timeseries::makeBucket(options, id, contents);
+
+            // Add fewer measurements if they do not all fit in the bucket.
+            while (newBucket.objsize() > BSONObjMaxUserSize && numAdded > 1) {
+                numAdded /= 2;
+                contents.resize(numExisting + numAdded);
+                newBucket = timeseries::makeBucket(options, id, contents);
+            }
+            if (newBucket.objsize() > BSONObjMaxUserSize) {
+                uassert(ErrorCodes::BSONObjectTooLarge,
+                        str::stream() << "Measurement is too large to be stored in a bucket of "
+                                      << bucketsNs,
+                        numExisting > 0);
+                ++n;
+                return;
+            }
+
+            auto opDebug = &CurOp::get(opCtx)->debug();
+            if (rid.isNull()) {
+                uassertStatusOK(
+                    collection->insertDocument(opCtx, InsertStatement(newBucket), opDebug));
+            } else {
+                CollectionUpdateArgs args;
+                args.update = newBucket;
+                args.criteria = BSON(timeseries::kBucketIdFieldName << id);
+                collection->updateDocument(
+                    opCtx, rid, oldBucket, newBucket, true /* indexesAffected */, opDebug, &args);
+            }
+            wuow.commit();
+            numInserted += numAdded;
+        });
+    }
+}
+
+/**
+ * Inserts the documents of 'wholeOp' as measurements of the time-series collection with
+ * 'options'. The measurements are grouped by the span and metadata of their buckets, so that a
+ * batch updates each bucket once. A measurement without a date in the time field fails on its
+ * own, while a failure to write a bucket fails the whole command.
+ */
+WriteResult performTimeseriesInserts(OperationContext* opCtx,
+                                     const write_ops::Insert& wholeOp,
+                                     const TimeseriesOptions& options,
+                                     LastOpFixer* lastOpFixer) {
+    const auto& ns = wholeOp.getNamespace();
+    uassert(ErrorCodes::OperationNotSupportedInTransaction,
+            str::stream() << "Cannot insert into the time-series collection " << ns
+                          << " in a transaction or as a retryable write",
+            !opCtx->getTxnNumber());
+
+    struct Group {
+        BSONObj meta;
+        std::vector<BSONObj> measurements;
+    };
+    std::map<std::pair<Date_t, std::string>, Group> groups;
+    std::map<size_t, Status> errors;
+    const auto& documents = wholeOp.getDocuments();
+    const bool ordered = wholeOp.getWriteCommandBase().getOrdered();
+    for (size_t i = 0; i < documents.size(); ++i) {
+        const BSONObj& doc = documents[i];
+        auto fixedDoc = fixDocumentForInsert(opCtx->getServiceContext(), doc);
+        const BSONElement time = doc[options.getTimeField()];
+        if (!fixedDoc.isOK() || time.type() != BSONType::Date) {
+            errors.emplace(i,
+                           !fixedDoc.isOK()
+                               ? fixedDoc.getStatus()
+                               : Status(ErrorCodes::BadValue,
+                                        str::stream() << "'" << options.getTimeField()
+                                                      << "' must be present and contain a date"));
+            if (ordered) {
+                break;
+            }
+            continue;
+        }
+
+        // Measurements are stored without the '_id' which is added to other inserted documents.
+        const BSONObj meta = options.getMetaField() && doc.hasField(*options.getMetaField())
+            ? doc[*options.getMetaField()].wrap()
+            : BSONObj();
+        auto& group = groups[{timeseries::getBucketStart(options, time.date()),
+                              std::string(meta.objdata(), meta.objsize())}];
+        group.meta = meta;
+        group.measurements.push_back(doc);
+    }
+
+    const size_t numDocs =
+        ordered && !errors.empty() ? errors.begin()->first + 1 : documents.size();
+    const size_t numMeasurements = numDocs - errors.size();
+    for (size_t i = 0; i < numDocs; ++i) {
+        globalOpCounters.gotInsert();
+        ServerWriteConcernMetrics::get(opCtx)->recordWriteConcernForInsert(
+            opCtx->getWriteConcern());
+    }
+
+    lastOpFixer->startingOp();
+    const auto bucketsNs = ns.makeTimeseriesBucketsNamespace();
+    for (const auto& group : groups) {
+        insertIntoBuckets(opCtx,
+                          bucketsNs,
+                          options,
+                          group.first.first,
+                          group.second.meta.firstElement(),
+                          group.second.measurements);
+    }
+    lastOpFixer->finishedOpSuccessfully();
+    CurOp::get(opCtx)->debug().additiveMetrics.incrementNinserted(numMeasurements);
+
+    WriteResult out;
+    out.results.reserve(numDocs);
+    for (size_t i = 0; i < numDocs; ++i) {
+        auto error = errors.find(i);
+        if (error == errors.end()) {
+            SingleWriteResult result;
+            result.setN(1);
+            out.results.emplace_back(std::move(result));
+            continue;
+        }
+        try {
+            uassertStatusOK(error->second);
+        } catch (const DBException& ex) {
+            handleError(opCtx, ex, ns, wholeOp.getWriteCommandBase(), &out);
+        }
+    }
+    return out;
+}
+
 }  // namespace
 
 WriteResult performInserts(OperationContext* opCtx,
@@ -522,6 +800,10 @@ WriteResult performInserts(OperationContext* opCtx,
         opCtx, wholeOp.getWriteCommandBase().getBypassDocumentValidation());
     LastOpFixer lastOpFixer(opCtx, wholeOp.getNamespace());
 
+    if (auto timeseriesOptions = getTimeseriesOptions(opCtx, wholeOp.getNamespace())) {
+        return performTimeseriesInserts(opCtx, wholeOp, *timeseriesOptions, &lastOpFixer);
+    }
+
     WriteResult out;
     out.results.reserve(wholeOp.getDocuments().size());
 
@@ -126,9 +126,11 @@ write_ops::Insert InsertOp::parseLegacy(const Message& msgRaw) {
     uassert(ErrorCodes::InvalidLength, "Need at least one object to insert", msg.moreJSObjs());
 
     op.setDocuments([&] {
+        // The documents stay views into the message, but share ownership of its buffer so that
+        // nothing downstream needs to copy them to keep them alive, as with OP_MSG.
         std::vector<BSONObj> documents;
         while (msg.moreJSObjs()) {
-            documents.push_back(msg.nextJsObj());
+            documents.push_back(msg.nextJsObj().shareOwnershipWith(msgRaw.sharedBuffer()));
         }
 
         return documents;
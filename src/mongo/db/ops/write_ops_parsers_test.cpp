@@ -273,6 +273,27 @@ TEST(CommandWriteOpsParsers, RealMultiInsert) {
     }
 }
 
+TEST(CommandWriteOpsParsers, DocumentSequenceInsertIsNotCopied) {
+    const auto ns = NamespaceString("test", "foo");
+    const BSONObj obj0 = BSON("x" << 0);
+    const BSONObj obj1 = BSON("x" << 1);
+    auto cmd = BSON("insert" << ns.coll() << "documents" << BSON_ARRAY(obj0 << obj1));
+    const auto message = toOpMsg(ns.db(), cmd, true).serialize();
+    const auto request = OpMsgRequest::parse(message);
+    const auto op = InsertOp::parse(request);
+
+    // The parsed documents point into the message, which they keep alive.
+    const char* const begin = message.buf();
+    const char* const end = begin + message.size();
+    ASSERT_EQ(op.getDocuments().size(), 2u);
+    for (auto&& doc : op.getDocuments()) {
+        ASSERT(doc.isOwned());
+        ASSERT(doc.objdata() >= begin && doc.objdata() + doc.objsize() <= end);
+    }
+    ASSERT_BSONOBJ_EQ(op.getDocuments()[0], obj0);
+    ASSERT_BSONOBJ_EQ(op.getDocuments()[1], obj1);
+}
+
 TEST(CommandWriteOpsParsers, MultiInsertWithStmtId) {
     const auto ns = NamespaceString("test", "foo");
     const BSONObj obj0 = BSON("x" << 0);
@@ -477,6 +498,25 @@ TEST(LegacyWriteOpsParsers, RealMultiInsert) {
     }
 }
 
+TEST(LegacyWriteOpsParsers, InsertIsNotCopied) {
+    const std::string ns = "test.foo";
+    auto objs = std::vector<BSONObj>{BSON("x" << 0), BSON("x" << 1)};
+    auto message = makeInsertMessage(ns, objs.data(), objs.size(), 0);
+    const auto op = InsertOp::parseLegacy(message);
+
+    // The parsed documents point into the message, which they keep alive.
+    const char* const begin = message.buf();
+    const char* const end = begin + message.size();
+    ASSERT_EQ(op.getDocuments().size(), 2u);
+    for (auto&& doc : op.getDocuments()) {
+        ASSERT(doc.isOwned());
+        ASSERT(doc.objdata() >= begin && doc.objdata() + doc.objsize() <= end);
+    }
+    message.reset();
+    ASSERT_BSONOBJ_EQ(op.getDocuments()[0], objs[0]);
+    ASSERT_BSONOBJ_EQ(op.getDocuments()[1], objs[1]);
+}
+
 TEST(LegacyWriteOpsParsers, Update) {
     const std::string ns = "test.foo";
     const BSONObj query = BSON("x" << 1);
@@ -35,11 +35,20 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/ops/find_and_modify_result.h"
 #include "mongo/db/query/find_and_modify_request.h"
+#include "mongo/db/repl/image_collection_entry_gen.h"
 #include "mongo/logger/redaction.h"
 
 namespace mongo {
 namespace {
 
+/**
+ * Returns true if the image of the given kind for 'oplog' was stored in the image collection
+ * instead of in a separate no-op oplog entry.
+ */
+bool hasRetryImage(const repl::OplogEntry& oplog, repl::RetryImageEnum kind) {
+    return oplog.getNeedsRetryImage() && *oplog.getNeedsRetryImage() == kind;
+}
+
 /**
  * Validates that the request is retry-compatible with the operation that occurred.
  * In the case of nested oplog entry where the correct links are in the top level
@@ -65,7 +74,8 @@ void validateFindAndModifyRetryability(const FindAndModifyRequest& request,
         uassert(40607,
                 str::stream() << "No pre-image available for findAndModify retry request:"
                               << redact(request.toBSON({})),
-                oplogWithCorrectLinks.getPreImageOpTime());
+                oplogWithCorrectLinks.getPreImageOpTime() ||
+                    hasRetryImage(oplogWithCorrectLinks, repl::RetryImageEnum::kPreImage));
     } else if (opType == repl::OpTypeEnum::kInsert) {
         uassert(
             40608,
@@ -97,7 +107,8 @@ void validateFindAndModifyRetryability(const FindAndModifyRequest& request,
                                   << ts.toString()
                                   << ", oplog: "
                                   << redact(oplogEntry.toBSON()),
-                    oplogWithCorrectLinks.getPostImageOpTime());
+                    oplogWithCorrectLinks.getPostImageOpTime() ||
+                        hasRetryImage(oplogWithCorrectLinks, repl::RetryImageEnum::kPostImage));
         } else {
             uassert(40612,
                     str::stream() << "findAndModify retry request: " << redact(request.toBSON({}))
@@ -106,16 +117,49 @@ void validateFindAndModifyRetryability(const FindAndModifyRequest& request,
                                   << ts.toString()
                                   << ", oplog: "
                                   << redact(oplogEntry.toBSON()),
-                    oplogWithCorrectLinks.getPreImageOpTime());
+                    oplogWithCorrectLinks.getPreImageOpTime() ||
+                        hasRetryImage(oplogWithCorrectLinks, repl::RetryImageEnum::kPreImage));
         }
     }
 }
 
+/**
+ * Extracts the image of the findAndModify operation described by 'oplog' from the image
+ * collection, making sure that it belongs to that exact write of the session.
+ */
+BSONObj extractImageFromImageCollection(OperationContext* opCtx, const repl::OplogEntry& oplog) {
+    const auto& sessionId = *oplog.getSessionId();
+    DBDirectClient client(opCtx);
+    auto imageDoc =
+        client.findOne(NamespaceString::kConfigImagesNamespace.ns(),
+                       BSON(repl::ImageEntry::kSessionIdFieldName << sessionId.toBSON()));
+
+    boost::optional<repl::ImageEntry> image;
+    if (!imageDoc.isEmpty()) {
+        image = repl::ImageEntry::parse(IDLParserErrorContext("ImageEntry"), imageDoc);
+    }
+
+    uassert(51332,
+            str::stream() << "image collection no longer contains the complete write history of "
+                             "this transaction, image for the write with opTime "
+                          << oplog.getOpTime().toString()
+                          << " cannot be found",
+            image && image->getTxnNumber() == *oplog.getTxnNumber() &&
+                image->getTimestamp() == oplog.getTimestamp() &&
+                image->getImageKind() == *oplog.getNeedsRetryImage());
+
+    return image->getImage().getOwned();
+}
+
 /**
  * Extracts either the pre or post image (cannot be both) of the findAndModify operation from the
- * oplog.
+ * oplog, or from the image collection if that is where the image was stored.
  */
 BSONObj extractPreOrPostImage(OperationContext* opCtx, const repl::OplogEntry& oplog) {
+    if (oplog.getNeedsRetryImage()) {
+        return extractImageFromImageCollection(opCtx, oplog);
+    }
+
     invariant(oplog.getPreImageOpTime() || oplog.getPostImageOpTime());
     auto opTime = oplog.getPreImageOpTime() ? oplog.getPreImageOpTime().value()
                                             : oplog.getPostImageOpTime().value();
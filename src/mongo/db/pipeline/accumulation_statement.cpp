@@ -47,6 +47,9 @@ using std::string;
 namespace {
 // Used to keep track of which Accumulators are registered under which name.
 static StringMap<Accumulator::Factory> factoryMap;
+
+// Used to keep track of the accumulators which parse an object argument of their own.
+static StringMap<Expression::Parser> argumentParserMap;
 }  // namespace
 
 void AccumulationStatement::registerAccumulator(std::string name, Accumulator::Factory factory) {
@@ -57,6 +60,15 @@ void AccumulationStatement::registerAccumulator(std::string name, Accumulator::F
     factoryMap[name] = factory;
 }
 
+void AccumulationStatement::registerAccumulatorArgumentParser(std::string name,
+                                                              Expression::Parser parser) {
+    auto it = argumentParserMap.find(name);
+    massert(51311,
+            str::stream() << "Duplicate accumulator argument parser (" << name << ") registered.",
+            it == argumentParserMap.end());
+    argumentParserMap[name] = std::move(parser);
+}
+
 Accumulator::Factory AccumulationStatement::getFactory(StringData name) {
     auto it = factoryMap.find(name);
     uassert(
@@ -97,9 +109,13 @@ AccumulationStatement AccumulationStatement::parseAccumulationStatement(
             str::stream() << "The " << accName << " accumulator is a unary operator",
             specElem.type() != BSONType::Array);
 
-    return {fieldName.toString(),
-            Expression::parseOperand(expCtx, specElem, vps),
-            AccumulationStatement::getFactory(accName)};
+    auto factory = AccumulationStatement::getFactory(accName);
+    auto argumentParser = argumentParserMap.find(accName);
+    if (argumentParser != argumentParserMap.end() && specElem.type() == BSONType::Object) {
+        return {fieldName.toString(), argumentParser->second(expCtx, specElem, vps), factory};
+    }
+
+    return {fieldName.toString(), Expression::parseOperand(expCtx, specElem, vps), factory};
 }
 
 }  // namespace mongo
@@ -51,6 +51,21 @@ namespace mongo {
         return Status::OK();                                                   \
     }
 
+/**
+ * Registers a parser for the argument of the accumulator registered under the same 'key', for
+ * an accumulator whose argument is an object of named options rather than an expression. The
+ * parser is only used for an argument which is an object; any other argument, such as the field
+ * path from which a merging $group reads partial results, is parsed as an expression.
+ *
+ * The parser must have the signature of an Expression::Parser, and the expression it returns must
+ * serialize back to an argument which it accepts.
+ */
+#define REGISTER_ACCUMULATOR_ARGUMENT_PARSER(key, parser)                              \
+    MONGO_INITIALIZER(addToAccumulatorArgumentParserMap_##key)(InitializerContext*) { \
+        AccumulationStatement::registerAccumulatorArgumentParser("$" #key, (parser));  \
+        return Status::OK();                                                           \
+    }
+
 /**
  * A class representing a user-specified accummulation, including the field name to put the
  * accumulated result in, which accumulator to use, and the expression used to obtain the input to
@@ -86,6 +101,14 @@ public:
      */
     static void registerAccumulator(std::string name, Accumulator::Factory factory);
 
+    /**
+     * Registers a parser for the object argument of the accumulator with the given name.
+     *
+     * DO NOT call this method directly. Instead, use the REGISTER_ACCUMULATOR_ARGUMENT_PARSER
+     * macro defined in this file.
+     */
+    static void registerAccumulatorArgumentParser(std::string name, Expression::Parser parser);
+
     /**
      * Retrieves the Factory for the accumulator specified by the given name, and raises an error if
      * there is no such Accumulator registered.
@@ -146,6 +146,156 @@ private:
     ValueUnorderedSet _set;
 };
 
+/**
+ * Estimates the number of distinct values it sees with a HyperLogLog sketch, in memory and space
+ * which are bounded regardless of the number of distinct values. The standard error of the
+ * estimate is about 0.8%.
+ *
+ * Values which compare equal under the collation hash alike, and so are counted once. A sketch
+ * holds a sparse list of the registers it has set until enough of them are set that the full
+ * array of registers is smaller, so groups with few distinct values stay small. The partial
+ * results which getValue(true) returns hold the sketch in binary form, and merge into any other
+ * sketch made by the same version of the server.
+ */
+class AccumulatorApproxCountDistinct final : public Accumulator {
+public:
+    // Each sketch has 2^kPrecision registers.
+    static constexpr int kPrecision = 14;
+    static constexpr size_t kNumRegisters = size_t(1) << kPrecision;
+
+    explicit AccumulatorApproxCountDistinct(const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    static boost::intrusive_ptr<Accumulator> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    // Raises the register 'index' to at least 'rank'.
+    void updateRegister(uint32_t index, uint8_t rank);
+
+    // Replaces the sparse list of registers with the full array.
+    void convertToDense();
+
+    void updateMemUsage();
+
+    // Returns the estimate of the number of distinct values seen so far.
+    long long estimate() const;
+
+    // Until '_dense' is filled, the registers which are set, each encoded as its index shifted
+    // left by 8 bits with its rank in the low bits, ordered by index.
+    std::vector<uint32_t> _sparse;
+
+    // Either empty or holding one rank for each of the kNumRegisters registers.
+    std::vector<uint8_t> _dense;
+};
+
+
+/**
+ * Keeps the 'n' values of 'output' which sort first by 'sortBy' across the documents of a group,
+ * as in {$topN: {n: 3, sortBy: {score: -1}, output: "$item"}}, and returns them in sort order.
+ * Only the best 'n' entries are held at any time, so a group takes memory proportional to 'n'
+ * rather than to the number of documents in it.
+ *
+ * Each input is the document produced by an ExpressionInternalTopNInput, which carries 'n' and
+ * 'sortBy' along with the sort key and output of the document, so that an accumulator needs no
+ * options of its own. The partial results of getValue(true) carry them the same way. Arrays in the
+ * sort key compare as whole values, rather than by their smallest or largest element as they do
+ * in $sort. Among entries whose sort keys are equal, the first one seen is kept.
+ */
+class AccumulatorTopN final : public Accumulator {
+public:
+    explicit AccumulatorTopN(const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    static boost::intrusive_ptr<Accumulator> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    /**
+     * Parses the {n: ..., sortBy: ..., output: ...} argument of $topN.
+     */
+    static boost::intrusive_ptr<Expression> parseArgument(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        BSONElement elem,
+        const VariablesParseState& vps);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+private:
+    struct Entry {
+        std::vector<Value> sortKey;
+        Value output;
+    };
+
+    // Reads 'n' and 'sortBy' from an input, the first time there is one.
+    void configure(const Value& input);
+
+    // Returns true if 'lhs' sorts strictly before 'rhs'.
+    bool sortsBefore(const Entry& lhs, const Entry& rhs) const;
+
+    void addEntry(Entry entry);
+
+    static size_t getApproximateSize(const Entry& entry);
+
+    long long _n = 0;
+    Value _sortBy;
+
+    // The direction of each component of the sort key, 1 for ascending and -1 for descending.
+    std::vector<int> _directions;
+
+    // A heap of at most '_n' entries, with the entry which sorts last at its front.
+    std::vector<Entry> _heap;
+};
+
+/**
+ * The expression from which $topN accumulates: evaluates to a document holding 'n', the 'sortBy'
+ * specification, the values of the fields in 'sortBy' as 'sortKey', and 'output'. Serializes
+ * back to the {n: ..., sortBy: ..., output: ...} argument it was parsed from.
+ */
+class ExpressionInternalTopNInput final : public Expression {
+public:
+    ExpressionInternalTopNInput(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                long long n,
+                                BSONObj sortBy,
+                                std::vector<boost::intrusive_ptr<Expression>> sortKey,
+                                boost::intrusive_ptr<Expression> output);
+
+    boost::intrusive_ptr<Expression> optimize() final;
+    Value evaluate(const Document& root, Variables* variables) const final;
+    Value serialize(bool explain) const final;
+
+    void acceptVisitor(ExpressionVisitor* visitor) final {
+        return visitor->visit(this);
+    }
+
+protected:
+    void _doAddDependencies(DepsTracker* deps) const final;
+
+private:
+    const Value _n;
+    const Value _sortBy;
+
+    // The children are the sort key expressions, followed by the output expression.
+    const size_t _numSortKeys;
+};
+
 
 class AccumulatorFirst final : public Accumulator {
 public:
@@ -0,0 +1,275 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_ACCUMULATOR(approxCountDistinct, AccumulatorApproxCountDistinct::create);
+
+namespace {
+
+// Past this many set registers, the sparse list is replaced by the full array of registers.
+constexpr size_t kMaxSparseRegisters = AccumulatorApproxCountDistinct::kNumRegisters / 16;
+
+// The largest rank a register can hold, for a hash whose bits after the index are all zero.
+constexpr uint8_t kMaxRank = 64 - AccumulatorApproxCountDistinct::kPrecision + 1;
+
+/**
+ * Mixes the bits of a Value hash, which is not well distributed for small integers, so that each
+ * bit of the result is set with equal probability. This is the finalizer of MurmurHash3.
+ */
+uint64_t mixHash(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * The series sigma(x) = x + sum over k >= 1 of x^(2^k) * 2^(k-1) of the estimator below.
+ */
+double sigma(double x) {
+    if (x == 1) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double y = 1;
+    double z = x;
+    double previous;
+    do {
+        x *= x;
+        previous = z;
+        z += x * y;
+        y += y;
+    } while (z != previous);
+    return z;
+}
+
+/**
+ * The series tau(x) = (1 - x - sum over k >= 1 of (1 - x^(2^-k))^2 * 2^-k) / 3 of the estimator
+ * below.
+ */
+double tau(double x) {
+    if (x == 0 || x == 1) {
+        return 0;
+    }
+    double y = 1;
+    double z = 1 - x;
+    double previous;
+    do {
+        x = std::sqrt(x);
+        previous = z;
+        y *= 0.5;
+        z -= (1 - x) * (1 - x) * y;
+    } while (z != previous);
+    return z / 3;
+}
+
+uint32_t sparseIndex(uint32_t entry) {
+    return entry >> 8;
+}
+
+uint8_t sparseRank(uint32_t entry) {
+    return entry & 0xff;
+}
+
+}  // namespace
+
+const char* AccumulatorApproxCountDistinct::getOpName() const {
+    return "$approxCountDistinct";
+}
+
+void AccumulatorApproxCountDistinct::processInternal(const Value& input, bool merging) {
+    if (!merging) {
+        if (input.missing()) {
+            return;
+        }
+
+        // The top bits of the hash pick the register, and the number of leading zeros in the rest
+        // give its rank.
+        const uint64_t hash = mixHash(getExpressionContext()->getValueComparator().hash(input));
+        const uint64_t rest = hash << kPrecision;
+        const uint8_t rank = rest == 0 ? kMaxRank : countLeadingZeros64(rest) + 1;
+        updateRegister(hash >> (64 - kPrecision), rank);
+        updateMemUsage();
+        return;
+    }
+
+    // This is what getValue(true) produced below.
+    uassert(51301,
+            str::stream() << "Invalid partial result for " << getOpName() << ": "
+                          << input.toString(),
+            input.getType() == Object && input["p"].numeric() &&
+                input["p"].coerceToInt() == kPrecision);
+    const Value sparse = input["sparse"];
+    const Value registers = input["registers"];
+    if (sparse.getType() == BinData) {
+        const BSONBinData binData = sparse.getBinData();
+        uassert(51302,
+                str::stream() << "Invalid sparse registers for " << getOpName(),
+                binData.length % sizeof(uint32_t) == 0);
+        ConstDataView view(static_cast<const char*>(binData.data));
+        for (int offset = 0; offset < binData.length; offset += sizeof(uint32_t)) {
+            const uint32_t entry = view.read<LittleEndian<uint32_t>>(offset);
+            uassert(51303,
+                    str::stream() << "Invalid sparse registers for " << getOpName(),
+                    sparseIndex(entry) < kNumRegisters && sparseRank(entry) <= kMaxRank);
+            updateRegister(sparseIndex(entry), sparseRank(entry));
+        }
+    } else {
+        uassert(51304,
+                str::stream() << "Invalid registers for " << getOpName(),
+                registers.getType() == BinData &&
+                    static_cast<size_t>(registers.getBinData().length) == kNumRegisters);
+        convertToDense();
+        const uint8_t* ranks = static_cast<const uint8_t*>(registers.getBinData().data);
+        for (size_t i = 0; i < kNumRegisters; ++i) {
+            _dense[i] = std::max(_dense[i], std::min(ranks[i], kMaxRank));
+        }
+    }
+    updateMemUsage();
+}
+
+void AccumulatorApproxCountDistinct::updateRegister(uint32_t index, uint8_t rank) {
+    if (!_dense.empty()) {
+        _dense[index] = std::max(_dense[index], rank);
+        return;
+    }
+
+    const uint32_t entry = (index << 8) | rank;
+    auto it = std::lower_bound(_sparse.begin(), _sparse.end(), index << 8);
+    if (it != _sparse.end() && sparseIndex(*it) == index) {
+        *it = std::max(*it, entry);
+        return;
+    }
+    _sparse.insert(it, entry);
+    if (_sparse.size() > kMaxSparseRegisters) {
+        convertToDense();
+    }
+}
+
+void AccumulatorApproxCountDistinct::convertToDense() {
+    if (!_dense.empty()) {
+        return;
+    }
+    _dense.resize(kNumRegisters, 0);
+    for (auto&& entry : _sparse) {
+        _dense[sparseIndex(entry)] = sparseRank(entry);
+    }
+    _sparse.clear();
+    _sparse.shrink_to_fit();
+}
+
+void AccumulatorApproxCountDistinct::updateMemUsage() {
+    _memUsageBytes = sizeof(*this) + _sparse.capacity() * sizeof(uint32_t) + _dense.capacity();
+}
+
+long long AccumulatorApproxCountDistinct::estimate() const {
+    // Count the registers holding each rank.
+    std::vector<double> counts(kMaxRank + 1, 0);
+    if (_dense.empty()) {
+        counts[0] = kNumRegisters - _sparse.size();
+        for (auto&& entry : _sparse) {
+            ++counts[sparseRank(entry)];
+        }
+    } else {
+        for (auto&& rank : _dense) {
+            ++counts[rank];
+        }
+    }
+
+    // This is the improved estimator from Ertl, "New cardinality estimation algorithms for
+    // HyperLogLog sketches", which unlike the original one is unbiased for small cardinalities as
+    // well as large ones without needing empirical corrections.
+    const double m = kNumRegisters;
+    double z = m * tau(1 - counts[kMaxRank] / m);
+    for (int rank = kMaxRank - 1; rank >= 1; --rank) {
+        z = 0.5 * (z + counts[rank]);
+    }
+    z += m * sigma(counts[0] / m);
+    return std::llround(m * m / (2 * std::log(2.0)) / z);
+}
+
+Value AccumulatorApproxCountDistinct::getValue(bool toBeMerged) {
+    if (!toBeMerged) {
+        return Value(estimate());
+    }
+
+    if (_dense.empty()) {
+        std::vector<char> buffer(_sparse.size() * sizeof(uint32_t));
+        DataView view(buffer.data());
+        for (size_t i = 0; i < _sparse.size(); ++i) {
+            view.write<LittleEndian<uint32_t>>(_sparse[i], i * sizeof(uint32_t));
+        }
+        return Value(
+            DOC("p" << kPrecision << "sparse"
+                    << BSONBinData(buffer.data(), buffer.size(), BinDataGeneral)));
+    }
+    return Value(DOC("p" << kPrecision << "registers"
+                         << BSONBinData(_dense.data(), _dense.size(), BinDataGeneral)));
+}
+
+AccumulatorApproxCountDistinct::AccumulatorApproxCountDistinct(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx)
+    : Accumulator(expCtx) {
+    updateMemUsage();
+}
+
+void AccumulatorApproxCountDistinct::reset() {
+    _sparse.clear();
+    _sparse.shrink_to_fit();
+    _dense.clear();
+    _dense.shrink_to_fit();
+    updateMemUsage();
+}
+
+intrusive_ptr<Accumulator> AccumulatorApproxCountDistinct::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    return new AccumulatorApproxCountDistinct(expCtx);
+}
+
+}  // namespace mongo
@@ -31,8 +31,10 @@
 
 #include <memory>
 
+#include "mongo/db/json.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
@@ -346,6 +348,233 @@ TEST(Accumulators, AddToSetRespectsCollation) {
                             Value(std::vector<Value>{Value("a"_sd)})}});
 }
 
+TEST(Accumulators, ApproxCountDistinct) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    assertExpectedResults(
+        "$approxCountDistinct",
+        expCtx,
+        {
+            // No documents evaluated.
+            {{}, Value(0LL)},
+            // Equal numbers of different types are counted once.
+            {{Value(1), Value(1.0), Value(1LL), Value(Decimal128("1"))}, Value(1LL)},
+            // Distinct values of different types.
+            {{Value(1), Value("a"_sd), Value(BSONNULL), Value(BSON("a" << 1))}, Value(4LL)},
+            // Missing values are ignored.
+            {{Value(9), Value(), Value(9)}, Value(1LL)},
+        });
+}
+
+TEST(Accumulators, ApproxCountDistinctRespectsCollation) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    expCtx->setCollator(&collator);
+    assertExpectedResults("$approxCountDistinct",
+                          expCtx,
+                          {{{Value("a"_sd), Value("b"_sd), Value("c"_sd)}, Value(1LL)}});
+}
+
+TEST(Accumulators, ApproxCountDistinctEstimatesLargeCardinalities) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxCountDistinct");
+
+    for (long long numDistinct : {1000LL, 30000LL, 200000LL}) {
+        // Each value is seen twice, by a single accumulator and by one of four "shards" whose
+        // partial results overlap.
+        auto accum = factory(expCtx);
+        std::vector<intrusive_ptr<Accumulator>> shards;
+        for (int i = 0; i < 4; ++i) {
+            shards.push_back(factory(expCtx));
+        }
+        for (long long i = 0; i < numDistinct; ++i) {
+            accum->process(Value(i), false);
+            accum->process(Value(i), false);
+            shards[i % 4]->process(Value(i), false);
+            shards[(i * 7) % 4]->process(Value(i), false);
+        }
+
+        const long long estimate = accum->getValue(false).getLong();
+        ASSERT_LTE(std::abs(estimate - numDistinct), numDistinct * 3 / 100) << numDistinct;
+
+        // Merging the partial results gives the same sketch as seeing all the values at once.
+        auto merger = factory(expCtx);
+        for (auto&& shard : shards) {
+            merger->process(shard->getValue(true), true);
+        }
+        ASSERT_VALUE_EQ(Value(estimate), merger->getValue(false));
+
+        // The sketch stays bounded in size.
+        ASSERT_LTE(accum->memUsageForSorter(),
+                   static_cast<int>(sizeof(AccumulatorApproxCountDistinct) +
+                                    AccumulatorApproxCountDistinct::kNumRegisters));
+    }
+}
+
+TEST(Accumulators, ApproxCountDistinctRejectsInvalidPartialResults) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto accum = AccumulatorApproxCountDistinct::create(expCtx);
+    ASSERT_THROWS_CODE(accum->process(Value(1), true), AssertionException, 51301);
+    ASSERT_THROWS_CODE(
+        accum->process(Value(DOC("p" << 12 << "sparse" << BSONBinData("", 0, BinDataGeneral))),
+                       true),
+        AssertionException,
+        51301);
+    ASSERT_THROWS_CODE(
+        accum->process(Value(DOC("p" << 14 << "sparse" << BSONBinData("abc", 3, BinDataGeneral))),
+                       true),
+        AssertionException,
+        51302);
+    ASSERT_THROWS_CODE(
+        accum->process(Value(DOC("p" << 14 << "registers" << BSONBinData("a", 1, BinDataGeneral))),
+                       true),
+        AssertionException,
+        51304);
+}
+
+/**
+ * Parses 'spec' as the accumulated field of a $group, and returns the value it accumulates over
+ * 'docs' when they are all seen by one accumulator, checking that the same value results when
+ * each document is seen by an accumulator of its own whose partial results are merged.
+ */
+Value accumulateTopN(const intrusive_ptr<ExpressionContext>& expCtx,
+                     const BSONObj& spec,
+                     const std::vector<Document>& docs) {
+    auto statement = AccumulationStatement::parseAccumulationStatement(
+        expCtx, spec.firstElement(), expCtx->variablesParseState);
+    statement.expression = statement.expression->optimize();
+
+    auto accum = statement.makeAccumulator(expCtx);
+    auto merger = statement.makeAccumulator(expCtx);
+    merger->process(statement.makeAccumulator(expCtx)->getValue(true), true);
+    for (auto&& doc : docs) {
+        Value input = statement.expression->evaluate(doc, &expCtx->variables);
+        accum->process(input, false);
+
+        auto shard = statement.makeAccumulator(expCtx);
+        shard->process(input, false);
+        merger->process(shard->getValue(true), true);
+    }
+
+    Value result = accum->getValue(false);
+    ASSERT_VALUE_EQ(result, merger->getValue(false));
+    return result;
+}
+
+TEST(Accumulators, TopN) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    std::vector<Document> docs = {Document{{"item", "a"_sd}, {"score", 5}},
+                                  Document{{"item", "b"_sd}, {"score", 9}},
+                                  Document{{"item", "c"_sd}, {"score", 1}},
+                                  Document{{"item", "d"_sd}, {"score", 7.5}},
+                                  Document{{"item", "e"_sd}},
+                                  Document{{"score", 8}}};
+
+    ASSERT_VALUE_EQ(
+        Value(std::vector<Value>{Value("b"_sd), Value(BSONNULL), Value("d"_sd)}),
+        accumulateTopN(expCtx,
+                       fromjson("{top: {$topN: {n: 3, sortBy: {score: -1}, output: '$item'}}}"),
+                       docs));
+
+    // Missing sort fields sort as null, which is before any number.
+    ASSERT_VALUE_EQ(
+        Value(std::vector<Value>{Value("e"_sd), Value("c"_sd)}),
+        accumulateTopN(
+            expCtx, fromjson("{top: {$topN: {n: 2, sortBy: {score: 1}, output: '$item'}}}"), docs));
+
+    // An 'n' larger than the number of documents returns all of them.
+    ASSERT_EQ(docs.size(),
+              accumulateTopN(expCtx,
+                             fromjson("{top: {$topN: {n: 100, sortBy: {score: 1}, output: 1}}}"),
+                             docs)
+                  .getArrayLength());
+
+    ASSERT_VALUE_EQ(
+        Value(std::vector<Value>()),
+        accumulateTopN(
+            expCtx, fromjson("{top: {$topN: {n: 1, sortBy: {score: 1}, output: 1}}}"), {}));
+}
+
+TEST(Accumulators, TopNWithCompoundSortAndExpressionOutput) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    std::vector<Document> docs;
+    for (int i = 0; i < 50; ++i) {
+        docs.push_back(Document{{"a", i % 5}, {"b", i}});
+    }
+
+    // The largest 'a' is 4, held by b = 4, 9, 14, ..., of which the smallest come first.
+    ASSERT_VALUE_EQ(
+        Value(std::vector<Value>{Value(8), Value(18), Value(28)}),
+        accumulateTopN(expCtx,
+                       fromjson("{top: {$topN: {n: 3, sortBy: {a: -1, b: 1}, "
+                                "output: {$multiply: ['$b', 2]}}}}"),
+                       docs));
+}
+
+TEST(Accumulators, TopNRespectsCollation) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    expCtx->setCollator(&collator);
+    std::vector<Document> docs = {
+        Document{{"s", "ab"_sd}}, Document{{"s", "ba"_sd}}, Document{{"s", "ca"_sd}}};
+
+    // Reversed, the strings sort as "ba" < "ca" < "ab".
+    ASSERT_VALUE_EQ(
+        Value(std::vector<Value>{Value("ba"_sd), Value("ca"_sd)}),
+        accumulateTopN(
+            expCtx, fromjson("{top: {$topN: {n: 2, sortBy: {s: 1}, output: '$s'}}}"), docs));
+}
+
+TEST(Accumulators, TopNArgumentRoundTripsThroughSerialization) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    const BSONObj spec = fromjson("{top: {$topN: {n: 2, sortBy: {a: -1, b: 1}, output: '$c'}}}");
+    auto statement = AccumulationStatement::parseAccumulationStatement(
+        expCtx, spec.firstElement(), expCtx->variablesParseState);
+    Value serialized = statement.expression->serialize(false);
+    ASSERT_VALUE_EQ(Value(DOC("n" << 2LL << "sortBy" << DOC("a" << -1 << "b" << 1) << "output"
+                                  << "$c"_sd)),
+                    serialized);
+
+    auto reparsed = AccumulationStatement::parseAccumulationStatement(
+        expCtx,
+        BSON("top" << BSON("$topN" << serialized)).firstElement(),
+        expCtx->variablesParseState);
+    ASSERT_VALUE_EQ(serialized, reparsed.expression->serialize(false));
+
+    DepsTracker deps;
+    statement.expression->addDependencies(&deps);
+    ASSERT_EQ(3U, deps.fields.size());
+}
+
+TEST(Accumulators, TopNRejectsInvalidArguments) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto parse = [&](const char* json) {
+        AccumulationStatement::parseAccumulationStatement(
+            expCtx, fromjson(json).firstElement(), expCtx->variablesParseState);
+    };
+    ASSERT_THROWS_CODE(parse("{top: {$topN: {n: 0, sortBy: {a: 1}, output: 1}}}"),
+                       AssertionException,
+                       51305);
+    ASSERT_THROWS_CODE(parse("{top: {$topN: {n: 1.5, sortBy: {a: 1}, output: 1}}}"),
+                       AssertionException,
+                       51305);
+    ASSERT_THROWS_CODE(
+        parse("{top: {$topN: {n: 1, sortBy: {}, output: 1}}}"), AssertionException, 51306);
+    ASSERT_THROWS_CODE(
+        parse("{top: {$topN: {n: 1, sortBy: {a: 2}, output: 1}}}"), AssertionException, 51307);
+    ASSERT_THROWS_CODE(parse("{top: {$topN: {n: 1, sortBy: {a: 1}, output: 1, x: 1}}}"),
+                       AssertionException,
+                       51308);
+    ASSERT_THROWS_CODE(
+        parse("{top: {$topN: {sortBy: {a: 1}, output: 1}}}"), AssertionException, 51309);
+    ASSERT_THROWS_CODE(parse("{top: {$topN: {n: 1, output: 1}}}"), AssertionException, 51310);
+    ASSERT_THROWS_CODE(parse("{top: {$topN: {n: 1, sortBy: {a: 1}}}}"), AssertionException, 51312);
+
+    // An argument which is not an object is an expression, whose values must be partial results.
+    auto accum = AccumulatorTopN::create(expCtx);
+    ASSERT_THROWS_CODE(accum->process(Value(1), false), AssertionException, 51314);
+    ASSERT_THROWS_CODE(accum->process(Value(DOC("n" << 1)), false), AssertionException, 51313);
+}
+
 /* ------------------------- AccumulatorMergeObjects -------------------------- */
 
 namespace AccumulatorMergeObjects {
@@ -0,0 +1,290 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include <algorithm>
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/dependencies.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_ACCUMULATOR(topN, AccumulatorTopN::create);
+REGISTER_ACCUMULATOR_ARGUMENT_PARSER(topN, AccumulatorTopN::parseArgument);
+
+const char* AccumulatorTopN::getOpName() const {
+    return "$topN";
+}
+
+intrusive_ptr<Expression> AccumulatorTopN::parseArgument(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    BSONElement elem,
+    const VariablesParseState& vps) {
+    boost::optional<long long> n;
+    BSONObj sortBy;
+    std::vector<intrusive_ptr<Expression>> sortKey;
+    intrusive_ptr<Expression> output;
+
+    for (auto&& arg : elem.embeddedObject()) {
+        const auto argName = arg.fieldNameStringData();
+        if (argName == "n") {
+            uassert(51305,
+                    str::stream() << "$topN requires 'n' to be a positive integer, but found "
+                                  << arg,
+                    arg.isNumber() && Value(arg).integral64Bit() && arg.safeNumberLong() > 0);
+            n = arg.safeNumberLong();
+        } else if (argName == "sortBy") {
+            uassert(51306,
+                    str::stream() << "$topN requires 'sortBy' to be a non-empty object, but found "
+                                  << arg,
+                    arg.type() == BSONType::Object && !arg.embeddedObject().isEmpty());
+            sortBy = arg.embeddedObject().getOwned();
+            for (auto&& sortField : sortBy) {
+                uassert(51307,
+                        str::stream() << "$topN sort direction must be 1 or -1, but found "
+                                      << sortField,
+                        sortField.isNumber() &&
+                            (sortField.numberDouble() == 1 || sortField.numberDouble() == -1));
+                sortKey.push_back(ExpressionFieldPath::parse(
+                    expCtx, "$" + sortField.fieldNameStringData(), vps));
+            }
+        } else if (argName == "output") {
+            output = Expression::parseOperand(expCtx, arg, vps);
+        } else {
+            uasserted(51308, str::stream() << "Unrecognized argument to $topN: " << argName);
+        }
+    }
+
+    uassert(51309, "$topN requires 'n'", n);
+    uassert(51310, "$topN requires 'sortBy'", !sortBy.isEmpty());
+    uassert(51312, "$topN requires 'output'", output);
+    return new ExpressionInternalTopNInput(
+        expCtx, *n, std::move(sortBy), std::move(sortKey), std::move(output));
+}
+
+void AccumulatorTopN::configure(const Value& input) {
+    if (!_directions.empty()) {
+        return;
+    }
+
+    const Value n = input["n"];
+    const Value sortBy = input["sortBy"];
+    uassert(51313,
+            str::stream() << "Invalid input to $topN: " << input.toString(),
+            n.integral64Bit() && n.coerceToLong() > 0 && sortBy.getType() == BSONType::Object &&
+                !sortBy.getDocument().empty());
+    _n = n.coerceToLong();
+    _sortBy = sortBy;
+    auto it = sortBy.getDocument().fieldIterator();
+    while (it.more()) {
+        _directions.push_back(it.next().second.coerceToDouble() < 0 ? -1 : 1);
+    }
+}
+
+void AccumulatorTopN::processInternal(const Value& input, bool merging) {
+    uassert(51314,
+            str::stream() << "Invalid input to $topN: " << input.toString(),
+            input.getType() == BSONType::Object);
+
+    auto makeEntry = [&](const Value& sortKey, const Value& output) {
+        uassert(51315,
+                str::stream() << "Invalid sort key for $topN: " << sortKey.toString(),
+                sortKey.isArray() && sortKey.getArrayLength() == _directions.size());
+        return Entry{sortKey.getArray(), output.missing() ? Value(BSONNULL) : output};
+    };
+
+    if (!merging) {
+        configure(input);
+        addEntry(makeEntry(input["sortKey"], input["output"]));
+        return;
+    }
+
+    // This is what getValue(true) produced below. A partial result without entries need not
+    // carry 'n' and 'sortBy'.
+    const Value entries = input["entries"];
+    uassert(51316,
+            str::stream() << "Invalid partial result for $topN: " << input.toString(),
+            entries.isArray());
+    if (entries.getArrayLength() == 0) {
+        return;
+    }
+    configure(input);
+    for (auto&& entry : entries.getArray()) {
+        addEntry(makeEntry(entry["k"], entry["o"]));
+    }
+}
+
+bool AccumulatorTopN::sortsBefore(const Entry& lhs, const Entry& rhs) const {
+    const auto& comparator = getExpressionContext()->getValueComparator();
+    for (size_t i = 0; i < _directions.size(); ++i) {
+        const int cmp = comparator.compare(lhs.sortKey[i], rhs.sortKey[i]) * _directions[i];
+        if (cmp != 0) {
+            return cmp < 0;
+        }
+    }
+    return false;
+}
+
+void AccumulatorTopN::addEntry(Entry entry) {
+    auto sortsBefore = [this](const Entry& lhs, const Entry& rhs) {
+        return this->sortsBefore(lhs, rhs);
+    };
+
+    if (_heap.size() < static_cast<size_t>(_n)) {
+        _memUsageBytes += getApproximateSize(entry);
+        _heap.push_back(std::move(entry));
+        std::push_heap(_heap.begin(), _heap.end(), sortsBefore);
+        return;
+    }
+
+    // Replace the entry which sorts last, if the new one sorts before it.
+    if (!sortsBefore(entry, _heap.front())) {
+        return;
+    }
+    std::pop_heap(_heap.begin(), _heap.end(), sortsBefore);
+    _memUsageBytes -= getApproximateSize(_heap.back());
+    _memUsageBytes += getApproximateSize(entry);
+    _heap.back() = std::move(entry);
+    std::push_heap(_heap.begin(), _heap.end(), sortsBefore);
+}
+
+size_t AccumulatorTopN::getApproximateSize(const Entry& entry) {
+    size_t size = sizeof(entry) + entry.output.getApproximateSize();
+    for (auto&& value : entry.sortKey) {
+        size += value.getApproximateSize();
+    }
+    return size;
+}
+
+Value AccumulatorTopN::getValue(bool toBeMerged) {
+    if (toBeMerged) {
+        if (_directions.empty()) {
+            return Value(DOC("entries" << std::vector<Value>()));
+        }
+        std::vector<Value> entries;
+        for (auto&& entry : _heap) {
+            entries.push_back(Value(DOC("k" << entry.sortKey << "o" << entry.output)));
+        }
+        return Value(DOC("n" << _n << "sortBy" << _sortBy << "entries" << std::move(entries)));
+    }
+
+    std::vector<Entry> sorted = _heap;
+    std::sort(sorted.begin(), sorted.end(), [this](const Entry& lhs, const Entry& rhs) {
+        return sortsBefore(lhs, rhs);
+    });
+    std::vector<Value> outputs;
+    for (auto&& entry : sorted) {
+        outputs.push_back(entry.output);
+    }
+    return Value(std::move(outputs));
+}
+
+AccumulatorTopN::AccumulatorTopN(const intrusive_ptr<ExpressionContext>& expCtx)
+    : Accumulator(expCtx) {
+    _memUsageBytes = sizeof(*this);
+}
+
+void AccumulatorTopN::reset() {
+    _heap.clear();
+    _memUsageBytes = sizeof(*this);
+}
+
+intrusive_ptr<Accumulator> AccumulatorTopN::create(const intrusive_ptr<ExpressionContext>& expCtx) {
+    return new AccumulatorTopN(expCtx);
+}
+
+/* ---------------------- ExpressionInternalTopNInput ------------------------ */
+
+namespace {
+
+std::vector<intrusive_ptr<Expression>> makeTopNChildren(
+    std::vector<intrusive_ptr<Expression>> sortKey, intrusive_ptr<Expression> output) {
+    sortKey.push_back(std::move(output));
+    return sortKey;
+}
+
+}  // namespace
+
+ExpressionInternalTopNInput::ExpressionInternalTopNInput(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    long long n,
+    BSONObj sortBy,
+    std::vector<intrusive_ptr<Expression>> sortKey,
+    intrusive_ptr<Expression> output)
+    : Expression(expCtx, makeTopNChildren(sortKey, std::move(output))),
+      _n(n),
+      _sortBy(std::move(sortBy)),
+      _numSortKeys(sortKey.size()) {}
+
+intrusive_ptr<Expression> ExpressionInternalTopNInput::optimize() {
+    for (auto&& child : _children) {
+        child = child->optimize();
+    }
+    return this;
+}
+
+Value ExpressionInternalTopNInput::evaluate(const Document& root, Variables* variables) const {
+    // Missing sort fields sort as null, as in $sort.
+    std::vector<Value> sortKey;
+    sortKey.reserve(_numSortKeys);
+    for (size_t i = 0; i < _numSortKeys; ++i) {
+        Value value = _children[i]->evaluate(root, variables);
+        sortKey.push_back(value.missing() ? Value(BSONNULL) : std::move(value));
+    }
+
+    MutableDocument input(4);
+    input.addField("n", _n);
+    input.addField("sortBy", _sortBy);
+    input.addField("sortKey", Value(std::move(sortKey)));
+    input.addField("output", _children[_numSortKeys]->evaluate(root, variables));
+    return input.freezeToValue();
+}
+
+Value ExpressionInternalTopNInput::serialize(bool explain) const {
+    return Value(
+        DOC("n" << _n << "sortBy" << _sortBy << "output"
+                << _children[_numSortKeys]->serialize(explain)));
+}
+
+void ExpressionInternalTopNInput::_doAddDependencies(DepsTracker* deps) const {
+    for (auto&& child : _children) {
+        child->addDependencies(deps);
+    }
+}
+
+}  // namespace mongo
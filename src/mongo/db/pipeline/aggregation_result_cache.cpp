@@ -0,0 +1,220 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_result_cache.h"
+
+#include "mongo/base/counter.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace {
+
+const auto getAggregationResultCache =
+    ServiceContext::declareDecoration<AggregationResultCache>();
+
+Counter64 aggregationResultCacheHits;
+Counter64 aggregationResultCacheMisses;
+ServerStatusMetricField<Counter64> displayAggregationResultCacheHits(
+    "query.aggregationResultCache.hits", &aggregationResultCacheHits);
+ServerStatusMetricField<Counter64> displayAggregationResultCacheMisses(
+    "query.aggregationResultCache.misses", &aggregationResultCacheMisses);
+
+// The stages whose output depends only on their input and their specification. Stages which
+// sample, read other namespaces, write, or report on the server itself are left out.
+const StringDataSet kCacheableStages = {"$addFields",
+                                        "$bucketAuto",
+                                        "$geoNear",
+                                        "$group",
+                                        "$limit",
+                                        "$match",
+                                        "$project",
+                                        "$redact",
+                                        "$replaceRoot",
+                                        "$replaceWith",
+                                        "$set",
+                                        "$skip",
+                                        "$sort",
+                                        "$unwind"};
+
+/**
+ * Returns true if 'elem' has a string anywhere in it which reads a variable whose value differs
+ * between runs of the same pipeline.
+ */
+bool readsRuntimeConstant(const BSONElement& elem) {
+    switch (elem.type()) {
+        case String: {
+            auto str = elem.valueStringData();
+            return str.startsWith("$$NOW") || str.startsWith("$$CLUSTER_TIME");
+        }
+        case Object:
+        case Array:
+            for (auto&& child : elem.Obj()) {
+                if (readsRuntimeConstant(child)) {
+                    return true;
+                }
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+size_t approximateSize(const std::vector<BSONObj>& results) {
+    size_t size = sizeof(AggregationResultCache::Entry);
+    for (auto&& result : results) {
+        size += sizeof(BSONObj) + result.objsize();
+    }
+    return size;
+}
+
+std::string keyBytes(const BSONObj& key) {
+    return std::string(key.objdata(), key.objsize());
+}
+
+}  // namespace
+
+AggregationResultCache& AggregationResultCache::get(ServiceContext* serviceContext) {
+    return getAggregationResultCache(serviceContext);
+}
+
+boost::optional<BSONObj> AggregationResultCache::makeKey(
+    const UUID& collectionUUID,
+    const std::vector<Value>& serializedPipeline,
+    const BSONObj& collation,
+    StringData readConcernLevel) {
+    BSONObjBuilder keyBuilder;
+    collectionUUID.appendToBuilder(&keyBuilder, "uuid");
+
+    BSONArrayBuilder pipelineBuilder(keyBuilder.subarrayStart("pipeline"));
+    for (auto&& stage : serializedPipeline) {
+        stage.addToBsonArray(&pipelineBuilder);
+    }
+    pipelineBuilder.doneFast();
+
+    keyBuilder.append("collation", collation);
+    keyBuilder.append("readConcern", readConcernLevel);
+    BSONObj key = keyBuilder.obj();
+
+    for (auto&& stage : key["pipeline"].Obj()) {
+        if (stage.type() != BSONType::Object || stage.Obj().nFields() != 1 ||
+            !kCacheableStages.count(stage.Obj().firstElementFieldNameStringData())) {
+            return boost::none;
+        }
+    }
+    if (readsRuntimeConstant(key["pipeline"])) {
+        return boost::none;
+    }
+    return key;
+}
+
+std::shared_ptr<const AggregationResultCache::Entry> AggregationResultCache::lookup(
+    const BSONObj& key,
+    unsigned long long writeEpoch,
+    Date_t now,
+    Milliseconds maxStaleness,
+    long long maxResults) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _entries.find(keyBytes(key));
+    if (it == _entries.end()) {
+        aggregationResultCacheMisses.increment();
+        return nullptr;
+    }
+
+    auto entry = it->second;
+    if (entry->writeEpoch != writeEpoch && now - entry->readAt > maxStaleness) {
+        // The collection has been written to since the results were read.
+        _sizeBytes -= entry->sizeBytes;
+        _entries.erase(it);
+        aggregationResultCacheMisses.increment();
+        return nullptr;
+    }
+
+    if (static_cast<long long>(entry->results.size()) > maxResults) {
+        aggregationResultCacheMisses.increment();
+        return nullptr;
+    }
+
+    _entries.promote(it);
+    aggregationResultCacheHits.increment();
+    return entry;
+}
+
+void AggregationResultCache::insert(const BSONObj& key,
+                                    std::vector<BSONObj> results,
+                                    unsigned long long writeEpoch,
+                                    Date_t now,
+                                    size_t maxSizeBytes) {
+    const size_t sizeBytes = approximateSize(results) + key.objsize();
+    auto entry = std::make_shared<const Entry>(
+        Entry{std::move(results), writeEpoch, now, sizeBytes});
+
+    std::string bytes = keyBytes(key);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _entries.find(bytes);
+    if (it != _entries.end()) {
+        _sizeBytes -= it->second->sizeBytes;
+        _entries.erase(it);
+    }
+    _entries.add(bytes, std::move(entry));
+    _sizeBytes += sizeBytes;
+    _evict(maxSizeBytes, lk);
+}
+
+void AggregationResultCache::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _entries.clear();
+    _sizeBytes = 0;
+}
+
+size_t AggregationResultCache::numEntries() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entries.size();
+}
+
+size_t AggregationResultCache::sizeBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _sizeBytes;
+}
+
+void AggregationResultCache::_evict(size_t maxSizeBytes, WithLock) {
+    while (_sizeBytes > maxSizeBytes && _entries.size() > 0) {
+        auto lru = std::prev(_entries.end());
+        _sizeBytes -= lru->second->sizeBytes;
+        _entries.erase(lru);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/lru_cache.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * A process-wide cache of the results of aggregations which read a single collection, for
+ * aggregations which are repeated over data which changes less often than they run. Each entry is
+ * keyed on the aggregation's collection, optimized pipeline, collation and read concern level,
+ * and remembers the write epoch of the collection (see CollectionInfoCache::getWriteEpoch()) from
+ * before the results were read. An entry is served while the collection is still at that epoch,
+ * or for a bounded time after it has moved on if the caller allows stale results.
+ *
+ * Only results which fit in the first batch of the aggregation's reply are cached. This class is
+ * thread safe.
+ */
+class AggregationResultCache {
+    AggregationResultCache(const AggregationResultCache&) = delete;
+    AggregationResultCache& operator=(const AggregationResultCache&) = delete;
+
+public:
+    struct Entry {
+        std::vector<BSONObj> results;
+        unsigned long long writeEpoch;
+        Date_t readAt;
+        size_t sizeBytes;
+    };
+
+    static AggregationResultCache& get(ServiceContext* serviceContext);
+
+    AggregationResultCache() = default;
+
+    /**
+     * Returns the key to cache the results of an aggregation with the given optimized pipeline
+     * under, or boost::none if the pipeline's results may differ between runs over the same data,
+     * for instance because it samples or reads $$NOW.
+     */
+    static boost::optional<BSONObj> makeKey(const UUID& collectionUUID,
+                                            const std::vector<Value>& serializedPipeline,
+                                            const BSONObj& collation,
+                                            StringData readConcernLevel);
+
+    /**
+     * Returns the entry cached under 'key' if it was read at 'writeEpoch', or, when it was read at
+     * another epoch, if it was read no more than 'maxStaleness' before 'now'. Otherwise removes
+     * any entry under 'key' and returns nullptr. Also returns nullptr, keeping the entry, if it
+     * holds more than 'maxResults' results.
+     */
+    std::shared_ptr<const Entry> lookup(const BSONObj& key,
+                                        unsigned long long writeEpoch,
+                                        Date_t now,
+                                        Milliseconds maxStaleness,
+                                        long long maxResults);
+
+    /**
+     * Caches 'results', read at 'writeEpoch', under 'key', then evicts the least recently used
+     * entries until the cache holds no more than 'maxSizeBytes'.
+     */
+    void insert(const BSONObj& key,
+                std::vector<BSONObj> results,
+                unsigned long long writeEpoch,
+                Date_t now,
+                size_t maxSizeBytes);
+
+    void clear();
+
+    size_t numEntries() const;
+
+    size_t sizeBytes() const;
+
+private:
+    void _evict(size_t maxSizeBytes, WithLock);
+
+    mutable stdx::mutex _mutex;
+
+    // Keyed on the bytes of the BSON keys. Bounded by _sizeBytes rather than by entry count.
+    LRUCache<std::string, std::shared_ptr<const Entry>> _entries{
+        std::numeric_limits<size_t>::max()};
+
+    size_t _sizeBytes = 0;
+};
+
+}  // namespace mongo
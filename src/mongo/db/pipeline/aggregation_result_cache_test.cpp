@@ -0,0 +1,169 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_result_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<Value> makePipeline(std::initializer_list<const char*> stages) {
+    std::vector<Value> pipeline;
+    for (auto&& stage : stages) {
+        pipeline.push_back(Value(fromjson(stage)));
+    }
+    return pipeline;
+}
+
+boost::optional<BSONObj> makeKey(std::initializer_list<const char*> stages,
+                                 const BSONObj& collation = BSONObj()) {
+    static const UUID uuid = UUID::gen();
+    return AggregationResultCache::makeKey(uuid, makePipeline(stages), collation, "local"_sd);
+}
+
+BSONObj key() {
+    return *makeKey({"{$match: {a: 1}}"});
+}
+
+const Date_t kNow = Date_t::fromMillisSinceEpoch(100000);
+
+TEST(AggregationResultCacheTest, KeysDeterministicPipelines) {
+    auto first = makeKey({"{$match: {a: 1}}", "{$group: {_id: '$b', n: {$sum: 1}}}"});
+    auto second = makeKey({"{$match: {a: 1}}", "{$group: {_id: '$b', n: {$sum: 1}}}"});
+    ASSERT(first);
+    ASSERT(second);
+    ASSERT_BSONOBJ_EQ(*first, *second);
+
+    auto withCollation = makeKey({"{$match: {a: 1}}", "{$group: {_id: '$b', n: {$sum: 1}}}"},
+                                 BSON("locale"
+                                      << "fr"));
+    ASSERT(withCollation);
+    ASSERT_BSONOBJ_NE(*first, *withCollation);
+
+    ASSERT(makeKey({"{$sort: {a: 1}}", "{$limit: 3}", "{$project: {a: 1}}"}));
+    ASSERT(makeKey({}));
+}
+
+TEST(AggregationResultCacheTest, DoesNotKeyNondeterministicPipelines) {
+    ASSERT_FALSE(makeKey({"{$sample: {size: 3}}"}));
+    ASSERT_FALSE(makeKey({"{$lookup: {from: 'b', localField: 'a', foreignField: 'a', as: 'c'}}"}));
+    ASSERT_FALSE(makeKey({"{$facet: {a: [{$match: {a: 1}}]}}"}));
+    ASSERT_FALSE(makeKey({"{$match: {a: 1}}", "{$addFields: {now: '$$NOW'}}"}));
+    ASSERT_FALSE(
+        makeKey({"{$match: {$expr: {$lt: ['$a', {$add: ['$$CLUSTER_TIME', [1]]}]}}}"}));
+}
+
+TEST(AggregationResultCacheTest, ServesEntryAtSameWriteEpoch) {
+    AggregationResultCache cache;
+    ASSERT_FALSE(cache.lookup(key(), 1, kNow, Milliseconds(0), 101));
+
+    cache.insert(key(), {BSON("a" << 1), BSON("a" << 2)}, 1, kNow, 1024 * 1024);
+    ASSERT_EQ(1U, cache.numEntries());
+
+    auto entry = cache.lookup(key(), 1, kNow + Seconds(10), Milliseconds(0), 101);
+    ASSERT(entry);
+    ASSERT_EQ(2U, entry->results.size());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 2), entry->results[1]);
+}
+
+TEST(AggregationResultCacheTest, WriteRemovesEntry) {
+    AggregationResultCache cache;
+    cache.insert(key(), {BSON("a" << 1)}, 1, kNow, 1024 * 1024);
+
+    ASSERT_FALSE(cache.lookup(key(), 2, kNow, Milliseconds(0), 101));
+    ASSERT_EQ(0U, cache.numEntries());
+    ASSERT_EQ(0U, cache.sizeBytes());
+    ASSERT_FALSE(cache.lookup(key(), 1, kNow, Milliseconds(0), 101));
+}
+
+TEST(AggregationResultCacheTest, ServesStaleEntryWithinWindow) {
+    AggregationResultCache cache;
+    cache.insert(key(), {BSON("a" << 1)}, 1, kNow, 1024 * 1024);
+
+    ASSERT(cache.lookup(key(), 2, kNow + Milliseconds(500), Milliseconds(1000), 101));
+    ASSERT(cache.lookup(key(), 3, kNow + Milliseconds(1000), Milliseconds(1000), 101));
+    ASSERT_FALSE(cache.lookup(key(), 3, kNow + Milliseconds(1001), Milliseconds(1000), 101));
+    ASSERT_EQ(0U, cache.numEntries());
+}
+
+TEST(AggregationResultCacheTest, DoesNotServeMoreResultsThanAskedFor) {
+    AggregationResultCache cache;
+    cache.insert(key(), {BSON("a" << 1), BSON("a" << 2)}, 1, kNow, 1024 * 1024);
+
+    ASSERT_FALSE(cache.lookup(key(), 1, kNow, Milliseconds(0), 1));
+    ASSERT_EQ(1U, cache.numEntries());
+    ASSERT(cache.lookup(key(), 1, kNow, Milliseconds(0), 2));
+}
+
+TEST(AggregationResultCacheTest, ReplacingEntryKeepsSizeAccurate) {
+    AggregationResultCache cache;
+    cache.insert(key(), {BSON("a" << 1)}, 1, kNow, 1024 * 1024);
+    const size_t oneResultSize = cache.sizeBytes();
+
+    cache.insert(key(), {BSON("a" << 1)}, 2, kNow, 1024 * 1024);
+    ASSERT_EQ(1U, cache.numEntries());
+    ASSERT_EQ(oneResultSize, cache.sizeBytes());
+    ASSERT(cache.lookup(key(), 2, kNow, Milliseconds(0), 101));
+
+    cache.clear();
+    ASSERT_EQ(0U, cache.numEntries());
+    ASSERT_EQ(0U, cache.sizeBytes());
+}
+
+TEST(AggregationResultCacheTest, EvictsLeastRecentlyUsedEntries) {
+    AggregationResultCache cache;
+    const auto keyA = *makeKey({"{$match: {a: 1}}"});
+    const auto keyB = *makeKey({"{$match: {b: 1}}"});
+    const auto keyC = *makeKey({"{$match: {c: 1}}"});
+
+    cache.insert(keyA, {BSON("a" << 1)}, 1, kNow, 1024 * 1024);
+    const size_t entrySize = cache.sizeBytes();
+    const size_t maxSize = entrySize * 2 + entrySize / 2;
+    cache.insert(keyB, {BSON("b" << 1)}, 1, kNow, maxSize);
+
+    // Using A leaves B as the least recently used entry, which makes way for C.
+    ASSERT(cache.lookup(keyA, 1, kNow, Milliseconds(0), 101));
+    cache.insert(keyC, {BSON("c" << 1)}, 1, kNow, maxSize);
+    ASSERT_EQ(2U, cache.numEntries());
+    ASSERT(cache.lookup(keyA, 1, kNow, Milliseconds(0), 101));
+    ASSERT_FALSE(cache.lookup(keyB, 1, kNow, Milliseconds(0), 101));
+    ASSERT(cache.lookup(keyC, 1, kNow, Milliseconds(0), 101));
+
+    // An entry larger than the whole cache isn't kept.
+    cache.insert(keyB, {BSON("b" << 1)}, 1, kNow, entrySize / 2);
+    ASSERT_EQ(0U, cache.numEntries());
+}
+
+}  // namespace
+}  // namespace mongo
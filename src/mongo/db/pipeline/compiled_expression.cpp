@@ -0,0 +1,364 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/compiled_expression.h"
+
+#include "mongo/platform/overflow_arithmetic.h"
+#include "mongo/util/summation.h"
+
+namespace mongo {
+
+namespace {
+
+bool isNonDecimalNumber(const Value& value) {
+    switch (value.getType()) {
+        case NumberInt:
+        case NumberLong:
+        case NumberDouble:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(
+    boost::intrusive_ptr<Expression> expr) {
+    if (!canLower(expr.get())) {
+        return nullptr;
+    }
+
+    std::unique_ptr<CompiledExpression> compiled(new CompiledExpression(std::move(expr)));
+    compiled->compileInto(compiled->_expr.get(), compiled->allocateRegister());
+    compiled->_registers.resize(compiled->_numRegisters);
+    return compiled;
+}
+
+bool CompiledExpression::canLower(const Expression* expr) {
+    if (auto fieldPath = dynamic_cast<const ExpressionFieldPath*>(expr)) {
+        return fieldPath->isRootFieldPath() && fieldPath->getFieldPath().getPathLength() > 1;
+    }
+    return dynamic_cast<const ExpressionConstant*>(expr) ||
+        dynamic_cast<const ExpressionAdd*>(expr) || dynamic_cast<const ExpressionSubtract*>(expr) ||
+        dynamic_cast<const ExpressionMultiply*>(expr) ||
+        dynamic_cast<const ExpressionCompare*>(expr) || dynamic_cast<const ExpressionAnd*>(expr) ||
+        dynamic_cast<const ExpressionOr*>(expr) || dynamic_cast<const ExpressionNot*>(expr) ||
+        dynamic_cast<const ExpressionCoerceToBool*>(expr) ||
+        dynamic_cast<const ExpressionCond*>(expr);
+}
+
+void CompiledExpression::compileOperator(OpCode op, const Expression* expr, size_t dst) {
+    const auto& children = expr->getChildren();
+    const size_t first = _numRegisters;
+    _numRegisters += children.size();
+    for (size_t i = 0; i < children.size(); ++i) {
+        compileInto(children[i].get(), first + i);
+    }
+    addInstruction({op, dst, first, children.size(), 0, expr});
+}
+
+void CompiledExpression::compileInto(const Expression* expr, size_t dst) {
+    if (!canLower(expr)) {
+        addInstruction({OpCode::kFallback, dst, 0, 0, 0, expr});
+        return;
+    }
+
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(expr)) {
+        _constants.push_back(constant->getValue());
+        addInstruction({OpCode::kConstant, dst, _constants.size() - 1});
+    } else if (dynamic_cast<const ExpressionFieldPath*>(expr)) {
+        addInstruction({OpCode::kFieldPath, dst, 0, 0, 0, expr});
+    } else if (dynamic_cast<const ExpressionAdd*>(expr)) {
+        compileOperator(OpCode::kAdd, expr, dst);
+    } else if (dynamic_cast<const ExpressionSubtract*>(expr)) {
+        compileOperator(OpCode::kSubtract, expr, dst);
+    } else if (dynamic_cast<const ExpressionMultiply*>(expr)) {
+        compileOperator(OpCode::kMultiply, expr, dst);
+    } else if (dynamic_cast<const ExpressionCompare*>(expr)) {
+        compileOperator(OpCode::kCompare, expr, dst);
+    } else if (dynamic_cast<const ExpressionNot*>(expr)) {
+        compileInto(expr->getChildren()[0].get(), dst);
+        addInstruction({OpCode::kNot, dst});
+    } else if (dynamic_cast<const ExpressionCoerceToBool*>(expr)) {
+        compileInto(expr->getChildren()[0].get(), dst);
+        addInstruction({OpCode::kCoerceToBool, dst});
+    } else if (dynamic_cast<const ExpressionAnd*>(expr) ||
+               dynamic_cast<const ExpressionOr*>(expr)) {
+        // Each operand jumps to the end once it decides the result; if none does, the result is
+        // the one for an $and or $or whose operands are all true or all false respectively.
+        const bool isAnd = dynamic_cast<const ExpressionAnd*>(expr);
+        std::vector<size_t> jumps;
+        for (auto&& child : expr->getChildren()) {
+            compileInto(child.get(), dst);
+            jumps.push_back(
+                addInstruction({isAnd ? OpCode::kJumpIfFalse : OpCode::kJumpIfTrue, dst}));
+        }
+        addInstruction({OpCode::kSetBool, dst, isAnd ? 1u : 0u});
+        const size_t jumpToEnd = addInstruction({OpCode::kJump});
+        for (auto&& jump : jumps) {
+            _program[jump].target = _program.size();
+        }
+        addInstruction({OpCode::kSetBool, dst, isAnd ? 0u : 1u});
+        _program[jumpToEnd].target = _program.size();
+    } else {
+        invariant(dynamic_cast<const ExpressionCond*>(expr));
+        const auto& children = expr->getChildren();
+        compileInto(children[0].get(), dst);
+        const size_t jumpToElse = addInstruction({OpCode::kJumpIfFalse, dst});
+        compileInto(children[1].get(), dst);
+        const size_t jumpToEnd = addInstruction({OpCode::kJump});
+        _program[jumpToElse].target = _program.size();
+        compileInto(children[2].get(), dst);
+        _program[jumpToEnd].target = _program.size();
+    }
+}
+
+Value CompiledExpression::evaluate(const Document& root, Variables* variables) const {
+    try {
+        return runProgram(root, variables);
+    } catch (const DBException&) {
+        // The program evaluates every operand of an arithmetic or comparison instruction before
+        // any of them is checked, where the tree may stop at an earlier operand. Let the tree
+        // decide which error, if any, these inputs raise.
+        return _expr->evaluate(root, variables);
+    }
+}
+
+Value CompiledExpression::runProgram(const Document& root, Variables* variables) const {
+    size_t pc = 0;
+    while (pc < _program.size()) {
+        const Instruction& instruction = _program[pc++];
+        Value& dst = _registers[instruction.dst];
+        switch (instruction.op) {
+            case OpCode::kConstant:
+                dst = _constants[instruction.arg];
+                break;
+            case OpCode::kFieldPath:
+                dst = evaluateFieldPath(instruction, root, variables);
+                break;
+            case OpCode::kFallback:
+                dst = instruction.expr->evaluate(root, variables);
+                break;
+            case OpCode::kAdd:
+                if (!tryAdd(instruction, &dst)) {
+                    dst = instruction.expr->evaluate(root, variables);
+                }
+                break;
+            case OpCode::kSubtract:
+                if (!trySubtract(instruction, &dst)) {
+                    dst = instruction.expr->evaluate(root, variables);
+                }
+                break;
+            case OpCode::kMultiply:
+                if (!tryMultiply(instruction, &dst)) {
+                    dst = instruction.expr->evaluate(root, variables);
+                }
+                break;
+            case OpCode::kCompare:
+                dst = compare(instruction);
+                break;
+            case OpCode::kNot:
+                dst = Value(!dst.coerceToBool());
+                break;
+            case OpCode::kCoerceToBool:
+                dst = Value(dst.coerceToBool());
+                break;
+            case OpCode::kSetBool:
+                dst = Value(instruction.arg != 0);
+                break;
+            case OpCode::kJump:
+                pc = instruction.target;
+                break;
+            case OpCode::kJumpIfFalse:
+                if (!dst.coerceToBool()) {
+                    pc = instruction.target;
+                }
+                break;
+            case OpCode::kJumpIfTrue:
+                if (dst.coerceToBool()) {
+                    pc = instruction.target;
+                }
+                break;
+        }
+    }
+    return _registers[0];
+}
+
+Value CompiledExpression::evaluateFieldPath(const Instruction& instruction,
+                                            const Document& root,
+                                            Variables* variables) const {
+    const auto& fieldPath =
+        static_cast<const ExpressionFieldPath*>(instruction.expr)->getFieldPath();
+    const size_t last = fieldPath.getPathLength() - 1;
+
+    // The first component of the path names the variable, which is always $$ROOT here.
+    Document current = root;
+    for (size_t i = 1; i < last; ++i) {
+        Value val = current[fieldPath.getFieldName(i)];
+        switch (val.getType()) {
+            case Object:
+                current = val.getDocument();
+                break;
+            case Array:
+                // Leave the traversal of arrays, which collects the path from each element, to
+                // the tree.
+                return instruction.expr->evaluate(root, variables);
+            default:
+                return Value();
+        }
+    }
+    return current[fieldPath.getFieldName(last)];
+}
+
+bool CompiledExpression::tryAdd(const Instruction& instruction, Value* result) const {
+    for (size_t i = 0; i < instruction.numArgs; ++i) {
+        if (!isNonDecimalNumber(_registers[instruction.arg + i])) {
+            return false;
+        }
+    }
+
+    // As in ExpressionAdd::evaluate(), return the narrowest type which can hold the sum.
+    DoubleDoubleSummation total;
+    BSONType totalType = NumberInt;
+    for (size_t i = 0; i < instruction.numArgs; ++i) {
+        const Value& val = _registers[instruction.arg + i];
+        switch (val.getType()) {
+            case NumberDouble:
+                total.addDouble(val.getDouble());
+                totalType = NumberDouble;
+                break;
+            case NumberLong:
+                total.addLong(val.getLong());
+                if (totalType == NumberInt)
+                    totalType = NumberLong;
+                break;
+            default:
+                total.addDouble(val.getInt());
+                break;
+        }
+    }
+
+    if (totalType == NumberLong && total.fitsLong()) {
+        *result = Value(total.getLong());
+    } else if (totalType != NumberDouble && total.fitsLong()) {
+        *result = Value::createIntOrLong(total.getLong());
+    } else {
+        *result = Value(total.getDouble());
+    }
+    return true;
+}
+
+bool CompiledExpression::trySubtract(const Instruction& instruction, Value* result) const {
+    const Value& lhs = _registers[instruction.arg];
+    const Value& rhs = _registers[instruction.arg + 1];
+    if (!isNonDecimalNumber(lhs) || !isNonDecimalNumber(rhs)) {
+        return false;
+    }
+
+    // As in ExpressionSubtract::evaluate().
+    switch (Value::getWidestNumeric(rhs.getType(), lhs.getType())) {
+        case NumberDouble:
+            *result = Value(lhs.coerceToDouble() - rhs.coerceToDouble());
+            break;
+        case NumberLong:
+            *result = Value(lhs.coerceToLong() - rhs.coerceToLong());
+            break;
+        default:
+            *result = Value::createIntOrLong(lhs.coerceToLong() - rhs.coerceToLong());
+            break;
+    }
+    return true;
+}
+
+bool CompiledExpression::tryMultiply(const Instruction& instruction, Value* result) const {
+    for (size_t i = 0; i < instruction.numArgs; ++i) {
+        if (!isNonDecimalNumber(_registers[instruction.arg + i])) {
+            return false;
+        }
+    }
+
+    // As in ExpressionMultiply::evaluate(), carry the integral product alongside the double one
+    // until it overflows.
+    double doubleProduct = 1;
+    long long longProduct = 1;
+    BSONType productType = NumberInt;
+    for (size_t i = 0; i < instruction.numArgs; ++i) {
+        const Value& val = _registers[instruction.arg + i];
+        productType = Value::getWidestNumeric(productType, val.getType());
+        doubleProduct *= val.coerceToDouble();
+        if (mongoSignedMultiplyOverflow64(longProduct, val.coerceToLong(), &longProduct)) {
+            productType = NumberDouble;
+        }
+    }
+
+    if (productType == NumberDouble) {
+        *result = Value(doubleProduct);
+    } else if (productType == NumberLong) {
+        *result = Value(longProduct);
+    } else {
+        *result = Value::createIntOrLong(longProduct);
+    }
+    return true;
+}
+
+Value CompiledExpression::compare(const Instruction& instruction) const {
+    const Value& lhs = _registers[instruction.arg];
+    const Value& rhs = _registers[instruction.arg + 1];
+
+    int cmp;
+    if (lhs.getType() == NumberInt && rhs.getType() == NumberInt) {
+        cmp = lhs.getInt() < rhs.getInt() ? -1 : lhs.getInt() > rhs.getInt() ? 1 : 0;
+    } else {
+        cmp = instruction.expr->getExpressionContext()->getValueComparator().compare(lhs, rhs);
+        cmp = cmp < 0 ? -1 : cmp > 0 ? 1 : 0;
+    }
+
+    switch (static_cast<const ExpressionCompare*>(instruction.expr)->getOp()) {
+        case ExpressionCompare::EQ:
+            return Value(cmp == 0);
+        case ExpressionCompare::NE:
+            return Value(cmp != 0);
+        case ExpressionCompare::GT:
+            return Value(cmp > 0);
+        case ExpressionCompare::GTE:
+            return Value(cmp >= 0);
+        case ExpressionCompare::LT:
+            return Value(cmp < 0);
+        case ExpressionCompare::LTE:
+            return Value(cmp <= 0);
+        case ExpressionCompare::CMP:
+            return Value(cmp);
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
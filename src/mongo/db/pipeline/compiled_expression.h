@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/variables.h"
+
+namespace mongo {
+
+/**
+ * An optimized Expression tree lowered into a flat program over a file of Value registers, so
+ * that evaluating it takes a loop over an instruction vector rather than a virtual call and a
+ * temporary Value per node.
+ *
+ * Constants, field paths on $$ROOT, $add, $subtract, $multiply, the comparisons, $and, $or, $not
+ * and $cond are lowered into instructions of their own; $and, $or and $cond become jumps, so they
+ * short-circuit just as the tree does. The arithmetic instructions have a fast path for operands
+ * which are all ints, longs or doubles, and hand any other inputs to the node they came from. Any
+ * other kind of expression is evaluated by calling into the tree for its subtree.
+ *
+ * The compiled program yields the same result as the tree it came from for every input. Where
+ * evaluating it throws, it evaluates the tree instead, so that an error is reported only when the
+ * tree raises one, and it is the same error.
+ *
+ * A CompiledExpression holds a pointer to the tree it came from, which must outlive it, and
+ * evaluates into registers of its own, so it must not be used by more than one thread at a time.
+ */
+class CompiledExpression {
+public:
+    /**
+     * Compiles 'expr', or returns nullptr if the root of 'expr' is not an expression which can be
+     * lowered, in which case there is nothing to gain over evaluating the tree.
+     */
+    static std::unique_ptr<CompiledExpression> compile(boost::intrusive_ptr<Expression> expr);
+
+    /**
+     * Evaluates the program against 'root', as Expression::evaluate() would.
+     */
+    Value evaluate(const Document& root, Variables* variables) const;
+
+    /**
+     * Returns the number of instructions in the program, for testing.
+     */
+    size_t getProgramSize() const {
+        return _program.size();
+    }
+
+private:
+    enum class OpCode {
+        kConstant,      // _registers[dst] = _constants[arg].
+        kFieldPath,     // _registers[dst] = the field path 'expr' on the root document.
+        kFallback,      // _registers[dst] = expr->evaluate().
+        kAdd,           // _registers[dst] = the sum of numArgs registers from arg.
+        kSubtract,      // _registers[dst] = _registers[arg] - _registers[arg + 1].
+        kMultiply,      // _registers[dst] = the product of numArgs registers from arg.
+        kCompare,       // _registers[dst] = _registers[arg] compared to _registers[arg + 1].
+        kNot,           // _registers[dst] = !_registers[dst].
+        kCoerceToBool,  // _registers[dst] = bool(_registers[dst]).
+        kSetBool,       // _registers[dst] = bool(arg).
+        kJump,          // Continue at 'target'.
+        kJumpIfFalse,   // Continue at 'target' if bool(_registers[dst]) is false.
+        kJumpIfTrue,    // Continue at 'target' if bool(_registers[dst]) is true.
+    };
+
+    struct Instruction {
+        OpCode op;
+        size_t dst = 0;
+        size_t arg = 0;
+        size_t numArgs = 0;
+        size_t target = 0;
+
+        // The node the instruction came from, for instructions which evaluate or inspect it.
+        const Expression* expr = nullptr;
+    };
+
+    explicit CompiledExpression(boost::intrusive_ptr<Expression> expr) : _expr(std::move(expr)) {}
+
+    // Returns true if 'expr' is an expression which is lowered into instructions of its own.
+    static bool canLower(const Expression* expr);
+
+    // Appends the instructions which evaluate 'expr' into the register 'dst'.
+    void compileInto(const Expression* expr, size_t dst);
+
+    // Appends the instructions which evaluate each child of 'expr' into consecutive registers,
+    // followed by the instruction 'op' which computes 'expr' from them into the register 'dst'.
+    void compileOperator(OpCode op, const Expression* expr, size_t dst);
+
+    size_t allocateRegister() {
+        return _numRegisters++;
+    }
+
+    size_t addInstruction(Instruction instruction) {
+        _program.push_back(instruction);
+        return _program.size() - 1;
+    }
+
+    Value runProgram(const Document& root, Variables* variables) const;
+
+    // The fast path of each arithmetic instruction. Each returns false, leaving 'result' untouched,
+    // if any operand is not an int, long or double.
+    bool tryAdd(const Instruction& instruction, Value* result) const;
+    bool trySubtract(const Instruction& instruction, Value* result) const;
+    bool tryMultiply(const Instruction& instruction, Value* result) const;
+
+    Value compare(const Instruction& instruction) const;
+    Value evaluateFieldPath(const Instruction& instruction,
+                            const Document& root,
+                            Variables* variables) const;
+
+    boost::intrusive_ptr<Expression> _expr;
+
+    std::vector<Instruction> _program;
+    std::vector<Value> _constants;
+    size_t _numRegisters = 0;
+
+    // The result of the program is left in the first register.
+    mutable std::vector<Value> _registers;
+};
+
+}  // namespace mongo
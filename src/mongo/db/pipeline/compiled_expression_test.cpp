@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+
+#include "mongo/db/pipeline/compiled_expression.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Documents holding a variety of values under 'a' and 'b', including nested documents, arrays,
+ * decimals, dates and values of types which the arithmetic expressions reject.
+ */
+std::vector<Document> makeDocs() {
+    std::vector<BSONObj> objs = {
+        fromjson("{a: 1, b: 2}"),
+        fromjson("{a: 2.5, b: -1}"),
+        BSON("a" << (1LL << 62) << "b" << (1LL << 62)),
+        BSON("a" << std::numeric_limits<long long>::max() << "b" << 2),
+        BSON("a" << std::numeric_limits<int>::max() << "b" << 1),
+        BSON("a" << Decimal128("1.5") << "b" << 2),
+        BSON("a" << Date_t::fromMillisSinceEpoch(1000) << "b" << 5),
+        fromjson("{a: 'abc', b: 1}"),
+        fromjson("{a: null, b: 'abc'}"),
+        fromjson("{a: 0, b: 0}"),
+        fromjson("{a: true, b: false}"),
+        fromjson("{a: [1, 2], b: 1}"),
+        fromjson("{a: {c: 1, d: {e: 2}}, b: [{c: 3}, {c: 4}, 5]}"),
+        fromjson("{b: 3}"),
+        fromjson("{}"),
+    };
+    std::vector<Document> docs;
+    for (auto&& obj : objs) {
+        docs.push_back(Document(obj));
+    }
+    return docs;
+}
+
+/**
+ * Asserts that the compiled form of the optimized expression 'spec' yields the same value, of the
+ * same type, or the same error as the tree on every document of makeDocs().
+ */
+void assertAgreesWithTree(const BSONObj& spec) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expr =
+        Expression::parseOperand(expCtx, spec.firstElement(), expCtx->variablesParseState)
+            ->optimize();
+    auto compiled = CompiledExpression::compile(expr);
+    ASSERT(compiled) << spec;
+
+    for (auto&& doc : makeDocs()) {
+        Value expected;
+        boost::optional<ErrorCodes::Error> expectedError;
+        try {
+            expected = expr->evaluate(doc, &expCtx->variables);
+        } catch (const DBException& ex) {
+            expectedError = ex.code();
+        }
+
+        if (expectedError) {
+            ASSERT_THROWS_CODE(
+                compiled->evaluate(doc, &expCtx->variables), AssertionException, *expectedError);
+            continue;
+        }
+
+        Value actual = compiled->evaluate(doc, &expCtx->variables);
+        ASSERT_VALUE_EQ(expected, actual);
+        ASSERT_EQ(expected.getType(), actual.getType()) << spec << " on " << doc.toString();
+    }
+}
+
+TEST(CompiledExpressionTest, FieldPaths) {
+    assertAgreesWithTree(fromjson("{expr: '$a'}"));
+    assertAgreesWithTree(fromjson("{expr: '$a.c'}"));
+    assertAgreesWithTree(fromjson("{expr: '$a.d.e'}"));
+    assertAgreesWithTree(fromjson("{expr: '$b.c'}"));
+    assertAgreesWithTree(fromjson("{expr: '$$ROOT.a.c'}"));
+    assertAgreesWithTree(fromjson("{expr: '$$CURRENT.b'}"));
+    assertAgreesWithTree(fromjson("{expr: '$missing.field'}"));
+}
+
+TEST(CompiledExpressionTest, Arithmetic) {
+    assertAgreesWithTree(fromjson("{expr: {$add: ['$a', '$b']}}"));
+    assertAgreesWithTree(fromjson("{expr: {$add: ['$a', '$b', 1.5]}}"));
+    assertAgreesWithTree(fromjson("{expr: {$add: ['$a', '$b', '$a']}}"));
+    assertAgreesWithTree(BSON("expr" << BSON("$add" << BSON_ARRAY("$a" << 1LL))));
+    assertAgreesWithTree(fromjson("{expr: {$add: ['$b', '$a.c', 1]}}"));
+    assertAgreesWithTree(fromjson("{expr: {$subtract: ['$a', '$b']}}"));
+    assertAgreesWithTree(fromjson("{expr: {$subtract: ['$b', 0.5]}}"));
+    assertAgreesWithTree(fromjson("{expr: {$multiply: ['$a', '$b']}}"));
+    assertAgreesWithTree(fromjson("{expr: {$multiply: ['$a', '$b', '$a']}}"));
+    assertAgreesWithTree(fromjson("{expr: {$multiply: ['$b', 2.5]}}"));
+    assertAgreesWithTree(
+        fromjson("{expr: {$add: [{$multiply: ['$a', 2]}, {$subtract: ['$b', 1]}]}}"));
+}
+
+TEST(CompiledExpressionTest, Comparisons) {
+    for (auto&& op : {"$eq", "$ne", "$gt", "$gte", "$lt", "$lte", "$cmp"}) {
+        assertAgreesWithTree(BSON("expr" << BSON(op << BSON_ARRAY("$a"
+                                                                  << "$b"))));
+        assertAgreesWithTree(BSON("expr" << BSON(op << BSON_ARRAY("$a" << 1))));
+        assertAgreesWithTree(BSON("expr" << BSON(op << BSON_ARRAY("$a.c"
+                                                                  << "abc"))));
+    }
+}
+
+TEST(CompiledExpressionTest, LogicalExpressions) {
+    assertAgreesWithTree(fromjson("{expr: {$and: ['$a', '$b']}}"));
+    assertAgreesWithTree(fromjson("{expr: {$and: [{$gt: ['$a', 0]}, {$lt: ['$b', 2]}, '$a']}}"));
+    assertAgreesWithTree(fromjson("{expr: {$or: ['$a', '$b']}}"));
+    assertAgreesWithTree(fromjson("{expr: {$or: [{$eq: ['$a', 1]}, {$eq: ['$b', 1]}]}}"));
+    assertAgreesWithTree(fromjson("{expr: {$not: ['$a']}}"));
+    assertAgreesWithTree(fromjson("{expr: {$not: [{$and: ['$a', {$or: ['$b', '$a.c']}]}]}}"));
+    assertAgreesWithTree(fromjson("{expr: {$and: ['$a']}}"));
+    assertAgreesWithTree(fromjson("{expr: {$cond: ['$a', '$b', {$add: ['$a', 1]}]}}"));
+    assertAgreesWithTree(
+        fromjson("{expr: {$cond: {if: {$gte: ['$a', 2]}, then: 'big', else: '$a.c'}}}"));
+}
+
+TEST(CompiledExpressionTest, SubtreesWhichAreNotLoweredAreEvaluatedByTheTree) {
+    assertAgreesWithTree(fromjson("{expr: {$add: [{$abs: '$b'}, '$a']}}"));
+    assertAgreesWithTree(fromjson("{expr: {$gt: [{$size: {$ifNull: ['$b', []]}}, 1]}}"));
+    assertAgreesWithTree(fromjson("{expr: {$cond: ['$a', {$concat: ['x', 'y']}, '$$REMOVE']}}"));
+    assertAgreesWithTree(fromjson("{expr: {$and: [{$isArray: '$b'}, '$a']}}"));
+}
+
+TEST(CompiledExpressionTest, ErrorsMatchTheTree) {
+    // The tree reports the error of the first operand it rejects, or none at all if it returns
+    // null first, where the program evaluates every operand before looking at any of them.
+    assertAgreesWithTree(fromjson("{expr: {$add: ['$a', {$divide: [1, '$b']}]}}"));
+    assertAgreesWithTree(fromjson("{expr: {$multiply: ['$a', {$divide: [1, '$b']}]}}"));
+    assertAgreesWithTree(fromjson("{expr: {$add: ['$a', '$a']}}"));
+    assertAgreesWithTree(fromjson("{expr: {$subtract: ['$a', {$divide: [1, '$b']}]}}"));
+}
+
+TEST(CompiledExpressionTest, LogicalExpressionsShortCircuit) {
+    // The $divide would fail on every document where it is reached with 'b' as zero or
+    // non-numeric; the programs must not reach it where the tree does not.
+    assertAgreesWithTree(fromjson("{expr: {$and: [{$ne: ['$b', 0]}, {$divide: ['$a', '$b']}]}}"));
+    assertAgreesWithTree(fromjson("{expr: {$or: [{$eq: ['$b', 0]}, {$divide: [1, '$b']}]}}"));
+    assertAgreesWithTree(fromjson("{expr: {$cond: [{$eq: ['$b', 0]}, 0, {$divide: [1, '$b']}]}}"));
+}
+
+TEST(CompiledExpressionTest, ExpressionsWhichCannotBeLoweredAreNotCompiled) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto parse = [&](const BSONObj& spec) {
+        return Expression::parseOperand(expCtx, spec.firstElement(), expCtx->variablesParseState);
+    };
+    ASSERT_FALSE(CompiledExpression::compile(parse(fromjson("{expr: {$abs: '$a'}}"))));
+    ASSERT_FALSE(CompiledExpression::compile(parse(fromjson("{expr: '$$ROOT'}"))));
+    ASSERT_FALSE(CompiledExpression::compile(
+        parse(fromjson("{expr: {$let: {vars: {x: 1}, in: {$add: ['$$x', 1]}}}}"))));
+    ASSERT(CompiledExpression::compile(parse(fromjson("{expr: {$add: ['$a', 1]}}"))));
+}
+
+TEST(CompiledExpressionTest, ProgramIsFlat) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expr = Expression::parseOperand(expCtx,
+                                         fromjson("{expr: {$add: ['$a', {$multiply: ['$b', 2]}]}}")
+                                             .firstElement(),
+                                         expCtx->variablesParseState);
+    auto compiled = CompiledExpression::compile(expr);
+    ASSERT(compiled);
+
+    // Two field paths, a constant, a $multiply and an $add.
+    ASSERT_EQ(5U, compiled->getProgramSize());
+    ASSERT_VALUE_EQ(Value(7), compiled->evaluate(Document{{"a", 1}, {"b", 3}}, &expCtx->variables));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -31,11 +31,13 @@
 
 #include "mongo/db/pipeline/document.h"
 
+#include <array>
 #include <boost/functional/hash.hpp>
 
 #include "mongo/bson/bson_depth.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/field_path.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -45,6 +47,115 @@ using std::vector;
 
 const DocumentStorage DocumentStorage::kEmptyDoc;
 
+namespace {
+
+/**
+ * The free buffers kept by a DocumentBufferPoolScope. Only buffers whose size is a power of two
+ * between kMinPooledBytes and kMaxPooledBytes are kept, so that a buffer can always be told which
+ * list it belongs on from its size alone.
+ */
+class DocumentBufferPool {
+public:
+    static constexpr size_t kMinPooledBytes = 128;
+    static constexpr size_t kMaxPooledBytes = 64 * 1024;
+
+    explicit DocumentBufferPool(size_t maxBytes) : _maxBytes(maxBytes) {}
+
+    ~DocumentBufferPool() {
+        for (auto&& buffers : _freeBuffers) {
+            for (char* buffer : buffers) {
+                delete[] buffer;
+            }
+        }
+    }
+
+    static bool isPooledSize(size_t bytes) {
+        return bytes >= kMinPooledBytes && bytes <= kMaxPooledBytes && (bytes & (bytes - 1)) == 0;
+    }
+
+    /**
+     * Returns a kept buffer of 'bytes' bytes, or nullptr if there is none.
+     */
+    char* take(size_t bytes) {
+        if (!isPooledSize(bytes)) {
+            return nullptr;
+        }
+        auto& buffers = _freeBuffers[sizeClass(bytes)];
+        if (buffers.empty()) {
+            return nullptr;
+        }
+        char* buffer = buffers.back();
+        buffers.pop_back();
+        _pooledBytes -= bytes;
+        return buffer;
+    }
+
+    /**
+     * Keeps 'buffer', of 'bytes' bytes, for reuse if there is room for it. Returns false if the
+     * caller should free it instead.
+     */
+    bool give(char* buffer, size_t bytes) {
+        if (!isPooledSize(bytes) || _pooledBytes + bytes > _maxBytes) {
+            return false;
+        }
+        _freeBuffers[sizeClass(bytes)].push_back(buffer);
+        _pooledBytes += bytes;
+        return true;
+    }
+
+private:
+    static size_t sizeClass(size_t bytes) {
+        size_t sizeClass = 0;
+        for (size_t classBytes = kMinPooledBytes; classBytes < bytes; classBytes *= 2) {
+            ++sizeClass;
+        }
+        return sizeClass;
+    }
+
+    // One list for each power of two from kMinPooledBytes to kMaxPooledBytes.
+    std::array<std::vector<char*>, 10> _freeBuffers;
+    const size_t _maxBytes;
+    size_t _pooledBytes = 0;
+};
+
+thread_local DocumentBufferPool* threadBufferPool = nullptr;
+
+}  // namespace
+
+DocumentBufferPoolScope::DocumentBufferPoolScope(size_t maxBytes) {
+    if (!threadBufferPool && maxBytes > 0) {
+        threadBufferPool = new DocumentBufferPool(maxBytes);
+        _installed = true;
+    }
+}
+
+DocumentBufferPoolScope::~DocumentBufferPoolScope() {
+    if (_installed) {
+        delete threadBufferPool;
+        threadBufferPool = nullptr;
+    }
+}
+
+bool DocumentBufferPoolScope::isActive() {
+    return threadBufferPool;
+}
+
+char* DocumentStorage::allocateBuffer(size_t bytes) {
+    if (threadBufferPool) {
+        if (char* buffer = threadBufferPool->take(bytes)) {
+            return buffer;
+        }
+    }
+    return new char[bytes];
+}
+
+void DocumentStorage::freeBuffer(char* buffer, size_t bytes) {
+    if (!buffer || (threadBufferPool && threadBufferPool->give(buffer, bytes))) {
+        return;
+    }
+    delete[] buffer;
+}
+
 const std::vector<StringData> Document::allMetadataFieldNames = {
     Document::metaFieldGeoNearDistance,
     Document::metaFieldGeoNearPoint,
@@ -55,6 +166,14 @@ const std::vector<StringData> Document::allMetadataFieldNames = {
     Document::metaFieldTextScore};
 
 Position DocumentStorage::findField(StringData requested) const {
+    Position pos = findLoadedField(requested);
+    if (pos.found() || !hasUnloadedBson())
+        return pos;
+
+    return loadBsonFieldsUntil(requested);
+}
+
+Position DocumentStorage::findLoadedField(StringData requested) const {
     int reqSize = requested.size();  // get size calculation out of the way if needed
 
     if (_numFields >= HASH_TAB_MIN) {  // hash lookup
@@ -71,7 +190,7 @@ Position DocumentStorage::findField(StringData requested) const {
             pos = elem.nextCollision;
         }
     } else {  // linear scan
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+        for (DocumentStorageIterator it = loadedIteratorAll(); !it.atEnd(); it.advance()) {
             if (it->nameLen == reqSize && memcmp(requested.rawData(), it->_name, reqSize) == 0) {
                 return it.position();
             }
@@ -82,7 +201,44 @@ Position DocumentStorage::findField(StringData requested) const {
     return Position();
 }
 
+void DocumentStorage::setLazyBson(BSONObj bson) {
+    invariant(!_buffer && !hasUnloadedBson());
+    invariant(bson.isOwned());
+
+    _bson = std::move(bson);
+    _bsonPos = _bson.objdata() + sizeof(int32_t);
+}
+
+Position DocumentStorage::loadBsonFieldsUntil(boost::optional<StringData> requested) const {
+    // Reading the BSON doesn't change the fields the document holds, only where they are kept.
+    auto self = const_cast<DocumentStorage*>(this);
+
+    while (*_bsonPos != EOO) {
+        BSONElement bsonElement(_bsonPos);
+        self->_bsonPos += bsonElement.size();
+
+        const StringData fieldName = bsonElement.fieldNameStringData();
+        const Position pos = getNextPosition();
+        Value val(bsonElement);
+        self->appendLoadedField(fieldName) = std::move(val);
+
+        if (requested && fieldName == *requested)
+            return pos;
+    }
+
+    // The values don't refer to the BSON, so it can go once every field has been read.
+    self->_bson = BSONObj();
+    self->_bsonPos = nullptr;
+    return Position();
+}
+
 Value& DocumentStorage::appendField(StringData name) {
+    // New fields go after all of the ones in the BSON.
+    loadAllBsonFields();
+    return appendLoadedField(name);
+}
+
+Value& DocumentStorage::appendLoadedField(StringData name) {
     Position pos = getNextPosition();
     const int nameSize = name.size();
 
@@ -142,6 +298,13 @@ void DocumentStorage::alloc(unsigned newSize) {
     const bool firstAlloc = !_buffer;
     const bool doingRehash = needRehash();
     const size_t oldCapacity = _bufferEnd - _buffer;
+    const size_t oldAllocatedBytes = allocatedBytes();
+
+    // The size of the old buffer is worked out from the hash table's, so the table must keep its
+    // old size if no new buffer can be made.
+    auto restoreHashTabMask = makeGuard([this, oldHashTabMask = _hashTabMask] {
+        _hashTabMask = oldHashTabMask;
+    });
 
     // make new bucket count big enough
     while (needRehash() || hashTabBuckets() < HASH_TAB_INIT_SIZE)
@@ -154,13 +317,16 @@ void DocumentStorage::alloc(unsigned newSize) {
 
     uassert(16490, "Tried to make oversized document", capacity <= size_t(BufferMaxSize));
 
-    std::unique_ptr<char[]> oldBuf(_buffer);
-    _buffer = new char[capacity];
+    char* newBuf = allocateBuffer(capacity);
+    restoreHashTabMask.dismiss();
+
+    char* oldBuf = _buffer;
+    _buffer = newBuf;
     _bufferEnd = _buffer + capacity - hashTabBytes();
 
     if (!firstAlloc) {
         // This just copies the elements
-        memcpy(_buffer, oldBuf.get(), _usedBytes);
+        memcpy(_buffer, oldBuf, _usedBytes);
 
         if (_numFields >= HASH_TAB_MIN) {
             // if we were hashing, deal with the hash table
@@ -168,10 +334,12 @@ void DocumentStorage::alloc(unsigned newSize) {
                 rehash();
             } else {
                 // no rehash needed so just slide table down to new position
-                memcpy(_hashTab, oldBuf.get() + oldCapacity, hashTabBytes());
+                memcpy(_hashTab, oldBuf + oldCapacity, hashTabBytes());
             }
         }
     }
+
+    freeBuffer(oldBuf, oldAllocatedBytes);
 }
 
 void DocumentStorage::reserveFields(size_t expectedFields) {
@@ -187,8 +355,17 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 
     uassert(16491, "Tried to make oversized document", newSize <= size_t(BufferMaxSize));
 
-    _buffer = new char[newSize + hashTabBytes()];
-    _bufferEnd = _buffer + newSize;
+    size_t capacity = newSize + hashTabBytes();
+    if (DocumentBufferPoolScope::isActive()) {
+        // Round up to a size which the pool can take back. The extra space goes to the fields.
+        size_t pooledCapacity = 128;
+        while (pooledCapacity < capacity)
+            pooledCapacity *= 2;
+        capacity = pooledCapacity;
+    }
+
+    _buffer = allocateBuffer(capacity);
+    _bufferEnd = _buffer + capacity - hashTabBytes();
 }
 
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
@@ -198,7 +375,7 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
         // Make a copy of the buffer with the fields.
         // It is very important that the positions of each field are the same after cloning.
         const size_t bufferBytes = allocatedBytes();
-        out->_buffer = new char[bufferBytes];
+        out->_buffer = allocateBuffer(bufferBytes);
         out->_bufferEnd = out->_buffer + (_bufferEnd - _buffer);
         memcpy(out->_buffer, _buffer, bufferBytes);
 
@@ -209,7 +386,7 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
         dassert(out->allocatedBytes() == bufferBytes);
 
         // Tell values that they have been memcpyed (updates ref counts)
-        for (DocumentStorageIterator it = out->iteratorAll(); !it.atEnd(); it.advance()) {
+        for (DocumentStorageIterator it = out->loadedIteratorAll(); !it.atEnd(); it.advance()) {
             it->val.memcpyed();
         }
     } else {
@@ -219,6 +396,10 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
         dassert(out->_numFields == _numFields);
     }
 
+    // The clone reads the rest of the fields from the same BSON buffer, which it shares.
+    out->_bson = _bson;
+    out->_bsonPos = _bsonPos;
+
     // Copy metadata
     if (_metaFields.any()) {
         out->_metaFields = _metaFields;
@@ -249,11 +430,11 @@ size_t DocumentStorage::getMetadataApproximateSize() const {
 }
 
 DocumentStorage::~DocumentStorage() {
-    std::unique_ptr<char[]> deleteBufferAtScopeEnd(_buffer);
-
-    for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+    for (DocumentStorageIterator it = loadedIteratorAll(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
+
+    freeBuffer(_buffer, allocatedBytes());
 }
 
 Document::Document(const BSONObj& bson) {
@@ -268,6 +449,12 @@ Document::Document(const BSONObj& bson) {
     *this = md.freeze();
 }
 
+Document Document::fromBsonLazily(BSONObj bson) {
+    auto storage = make_intrusive<DocumentStorage>();
+    storage->setLazyBson(bson.getOwned());
+    return Document(std::move(storage));
+}
+
 Document::Document(std::initializer_list<std::pair<StringData, ImplicitValue>> initializerList) {
     MutableDocument mutableDoc(initializerList.size());
 
@@ -449,7 +636,10 @@ size_t Document::getApproximateSize() const {
     size_t size = sizeof(DocumentStorage);
     size += storage().allocatedBytes();
 
-    for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+    // Fields still to be read from the BSON are counted by the size of the BSON, without reading
+    // them.
+    size += storage().unloadedBsonBytes();
+    for (DocumentStorageIterator it = storage().loadedIterator(); !it.atEnd(); it.advance()) {
         size += it->val.getApproximateSize();
         size -= sizeof(Value);  // already accounted for above
     }
@@ -233,6 +233,14 @@ public:
      */
     static Document fromBsonWithMetaData(const BSONObj& bson);
 
+    /**
+     * Like Document(BSONObj), but reads the top-level fields of 'bson' only as they are first
+     * looked up, and keeps a copy of 'bson' (shared if it is owned) until all of them have been.
+     * A lookup reads every field in 'bson' before the one it is for, and adding a field or
+     * iterating reads them all.
+     */
+    static Document fromBsonLazily(BSONObj bson);
+
     /**
      * Given a BSON object that may have metadata fields added as part of toBsonWithMetadata(),
      * returns the same object without any of the metadata fields.
@@ -758,6 +766,34 @@ inline void swap(mongo::Document& lhs, mongo::Document& rhs) {
     lhs.swap(rhs);
 }
 
+/**
+ * While an instance is alive, the field buffers of the documents freed on this thread are kept,
+ * up to 'maxBytes' of them, and handed out again to the next documents it creates rather than
+ * going back to the allocator. A batch of getNext() calls on a pipeline creates and frees many
+ * short-lived documents of similar sizes, so wrapping the batch in a scope saves most of their
+ * allocations.
+ *
+ * Documents are not tied to the scope: one which outlives it, or is freed on another thread, just
+ * frees its buffer the usual way. The buffers still kept are freed when the scope ends. A scope
+ * opened while another is alive on the same thread does nothing.
+ */
+class DocumentBufferPoolScope {
+    DocumentBufferPoolScope(const DocumentBufferPoolScope&) = delete;
+    DocumentBufferPoolScope& operator=(const DocumentBufferPoolScope&) = delete;
+
+public:
+    explicit DocumentBufferPoolScope(size_t maxBytes);
+    ~DocumentBufferPoolScope();
+
+    /**
+     * Returns true if a scope is pooling buffers on this thread.
+     */
+    static bool isActive();
+
+private:
+    bool _installed = false;
+};
+
 /* ======================= INLINED IMPLEMENTATIONS ========================== */
 
 inline FieldIterator Document::fieldIterator() const {
@@ -33,6 +33,7 @@
 
 #include <bitset>
 #include <boost/intrusive_ptr.hpp>
+#include <boost/optional.hpp>
 
 #include "mongo/base/static_assert.h"
 #include "mongo/db/pipeline/value.h"
@@ -189,6 +190,7 @@ public:
           _usedBytes(0),
           _numFields(0),
           _hashTabMask(0),
+          _bsonPos(nullptr),
           _metaFields(),
           _textScore(0),
           _randVal(0),
@@ -230,6 +232,24 @@ public:
     /// Returns the position of the named field (may be missing) or Position()
     Position findField(StringData name) const;
 
+    /**
+     * Makes this storage, which must be empty, read its fields from 'bson' as they are looked up
+     * rather than up front. Each field is read from 'bson' once, in order, so a lookup reads every
+     * field before the one it asks for. Lookups modify the storage, so a lazily read document
+     * must only be used by one thread at a time.
+     */
+    void setLazyBson(BSONObj bson);
+
+    /// Returns true if some of the fields are still to be read from the BSON.
+    bool hasUnloadedBson() const {
+        return _bsonPos != nullptr;
+    }
+
+    /// Returns the size of the BSON the unread fields are held in, or 0 if there is none.
+    size_t unloadedBsonBytes() const {
+        return hasUnloadedBson() ? _bson.objsize() : 0;
+    }
+
     // Document uses these
     const ValueElement& getField(Position pos) const {
         verify(pos.found());
@@ -264,14 +284,21 @@ public:
 
     /// This skips missing values
     DocumentStorageIterator iterator() const {
+        loadAllBsonFields();
         return DocumentStorageIterator(_firstElement, end(), false);
     }
 
     /// This includes missing values
     DocumentStorageIterator iteratorAll() const {
+        loadAllBsonFields();
         return DocumentStorageIterator(_firstElement, end(), true);
     }
 
+    /// Like iterator(), but leaves the fields which are still in the BSON unread.
+    DocumentStorageIterator loadedIterator() const {
+        return DocumentStorageIterator(_firstElement, end(), false);
+    }
+
     /// Shallow copy of this. Caller owns memory.
     boost::intrusive_ptr<DocumentStorage> clone() const;
 
@@ -396,9 +423,36 @@ private:
         return _firstElement ? _firstElement->plusBytes(_usedBytes) : nullptr;
     }
 
+    /// This includes missing values, but not the fields which are still in the BSON.
+    DocumentStorageIterator loadedIteratorAll() const {
+        return DocumentStorageIterator(_firstElement, end(), true);
+    }
+
+    /// Like findField(), but only looks at the fields already read from the BSON.
+    Position findLoadedField(StringData name) const;
+
+    /// Like appendField(), but appends after the fields read so far without reading the others.
+    Value& appendLoadedField(StringData name);
+
+    /**
+     * Reads fields from the BSON until it reads one named 'name', and returns its position. Returns
+     * Position() after reading all of them if there is none, or if 'name' is boost::none.
+     */
+    Position loadBsonFieldsUntil(boost::optional<StringData> name) const;
+
+    void loadAllBsonFields() const {
+        if (hasUnloadedBson())
+            loadBsonFieldsUntil(boost::none);
+    }
+
     /// Allocates space in _buffer. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
+    /// Gets a buffer of 'bytes' bytes, and gives one back, through the DocumentBufferPoolScope of
+    /// this thread if there is one.
+    static char* allocateBuffer(size_t bytes);
+    static void freeBuffer(char* buffer, size_t bytes);
+
     /// Call after adding field to _buffer and increasing _numFields
     void addFieldToHashTable(Position pos);
 
@@ -434,7 +488,7 @@ private:
     /// Adds all fields to the hash table
     void rehash() {
         hashTabInit();
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance())
+        for (DocumentStorageIterator it = loadedIteratorAll(); !it.atEnd(); it.advance())
             addFieldToHashTable(it.position());
     }
 
@@ -468,6 +522,11 @@ private:
     unsigned _numFields;    // this includes removed fields
     unsigned _hashTabMask;  // equal to hashTabBuckets()-1 but used more often
 
+    // Set by setLazyBson(). _bsonPos points at the next field of _bson still to be read, and is
+    // null once all of them have been, at which point _bson is released.
+    BSONObj _bson;
+    const char* _bsonPos;
+
     std::bitset<MetaType::NUM_FIELDS> _metaFields;
     double _textScore;
     double _randVal;
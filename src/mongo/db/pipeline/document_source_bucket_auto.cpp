@@ -81,6 +81,11 @@ std::string nextFileName() {
         std::to_string(documentSourceBucketAutoFileCounter.fetchAndAdd(1));
 }
 
+// In approximate mode, the number of ranges we keep per requested bucket, and in total at least.
+// Each bucket comes out within about two ranges' worth of documents of its share.
+const size_t kApproximateRangesPerBucket = 32;
+const size_t kMinApproximateRanges = 1024;
+
 }  // namespace
 
 const char* DocumentSourceBucketAuto::getSourceName() const {
@@ -91,13 +96,17 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::getNext() {
     pExpCtx->checkForInterrupt();
 
     if (!_populated) {
-        const auto populationResult = populateSorter();
+        const auto populationResult = _approximate ? populateRanges() : populateSorter();
         if (populationResult.isPaused()) {
             return populationResult;
         }
         invariant(populationResult.isEOF());
 
-        populateBuckets();
+        if (_approximate) {
+            populateBucketsFromRanges();
+        } else {
+            populateBuckets();
+        }
 
         _populated = true;
         _bucketsIterator = _buckets.begin();
@@ -152,6 +161,20 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::populateSorter() {
     return next;
 }
 
+DocumentSource::GetNextResult DocumentSourceBucketAuto::populateRanges() {
+    auto next = pSource->getNext();
+    for (; next.isAdvanced(); next = pSource->getNext()) {
+        auto nextDoc = next.releaseDocument();
+        addDocumentToRange(extractKey(nextDoc), nextDoc);
+        _nDocuments++;
+
+        if (_ranges.size() > 2 * getMaxRanges()) {
+            compactRanges();
+        }
+    }
+    return next;
+}
+
 Value DocumentSourceBucketAuto::extractKey(const Document& doc) {
     if (!_groupByExpression) {
         return Value(BSONNULL);
@@ -195,6 +218,103 @@ void DocumentSourceBucketAuto::addDocumentToBucket(const pair<Value, Document>&
     }
 }
 
+void DocumentSourceBucketAuto::addDocumentToRange(Value key, const Document& doc) {
+    // The ranges do not overlap, so the only one which can hold 'key' is the last one to start at
+    // or before it.
+    auto it = _ranges.upper_bound(key);
+    if (it != _ranges.begin() &&
+        pExpCtx->getValueComparator().evaluate(key <= std::prev(it)->second._max)) {
+        --it;
+    } else {
+        it = _ranges.emplace_hint(it, key, Bucket(pExpCtx, key, key, _accumulatedFields));
+    }
+
+    Bucket& range = it->second;
+    range._count++;
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (size_t k = 0; k < numAccumulators; k++) {
+        range._accums[k]->process(
+            _accumulatedFields[k].expression->evaluate(doc, &pExpCtx->variables), false);
+    }
+}
+
+size_t DocumentSourceBucketAuto::getMaxRanges() const {
+    return std::max(kApproximateRangesPerBucket * _nBuckets, kMinApproximateRanges);
+}
+
+void DocumentSourceBucketAuto::compactRanges() {
+    // Merge neighbouring ranges as long as the result holds at most twice the average number of
+    // documents per range. Any two neighbours which are left then hold more than that together.
+    const long long maxRangeSize =
+        std::max(1LL, 2 * _nDocuments / static_cast<long long>(getMaxRanges()));
+
+    auto current = _ranges.begin();
+    auto next = std::next(current);
+    while (next != _ranges.end()) {
+        if (current->second._count + next->second._count <= maxRangeSize) {
+            mergeBucketInto(next->second, current->second);
+            next = _ranges.erase(next);
+        } else {
+            current = next++;
+        }
+    }
+}
+
+void DocumentSourceBucketAuto::mergeBucketInto(const Bucket& from, Bucket& into) {
+    invariant(pExpCtx->getValueComparator().evaluate(from._max >= into._max));
+    into._max = from._max;
+    into._count += from._count;
+
+    const bool toBeMerged = true;
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (size_t k = 0; k < numAccumulators; k++) {
+        into._accums[k]->process(from._accums[k]->getValue(toBeMerged), toBeMerged);
+    }
+}
+
+void DocumentSourceBucketAuto::populateBucketsFromRanges() {
+    // Every range holds documents, so a bucket which takes at least one range is never empty.
+    long long approxBucketSize = std::round(double(_nDocuments) / double(_nBuckets));
+    if (approxBucketSize < 1) {
+        approxBucketSize = 1;
+    }
+
+    auto range = _ranges.begin();
+    for (int i = 0; i < _nBuckets && range != _ranges.end(); i++) {
+        const bool isLastBucket = (i == _nBuckets - 1);
+
+        Bucket currentBucket(pExpCtx, range->second._min, range->second._min, _accumulatedFields);
+
+        // Take whole ranges until the bucket holds its share of the documents. The last bucket
+        // takes whatever is left.
+        do {
+            mergeBucketInto(range->second, currentBucket);
+            ++range;
+        } while (range != _ranges.end() &&
+                 (isLastBucket || currentBucket._count < approxBucketSize));
+
+        if (_granularityRounder && range != _ranges.end()) {
+            // Absorb any ranges which start below the rounded boundary, as populateBuckets() does
+            // with values.
+            Value boundaryValue = _granularityRounder->roundUp(currentBucket._max);
+            while (range != _ranges.end() &&
+                   pExpCtx->getValueComparator().evaluate(boundaryValue > range->second._min)) {
+                mergeBucketInto(range->second, currentBucket);
+                ++range;
+                boundaryValue = _granularityRounder->roundUp(currentBucket._max);
+            }
+            if (range != _ranges.end()) {
+                currentBucket._max = boundaryValue;
+            }
+        }
+
+        addBucket(currentBucket);
+    }
+    _ranges.clear();
+
+    roundOuterBoundaries();
+}
+
 void DocumentSourceBucketAuto::populateBuckets() {
     invariant(_sorter);
     _sortedInput.reset(_sorter->done());
@@ -294,6 +414,10 @@ void DocumentSourceBucketAuto::populateBuckets() {
         addBucket(currentBucket);
     }
 
+    roundOuterBoundaries();
+}
+
+void DocumentSourceBucketAuto::roundOuterBoundaries() {
     if (!_buckets.empty() && _granularityRounder) {
         // If we we have a granularity, we round the first bucket's minimum down and the last
         // bucket's maximum up. This way all of the bucket boundaries are rounded to numbers in the
@@ -368,6 +492,7 @@ Document DocumentSourceBucketAuto::makeDocument(const Bucket& bucket) {
 
 void DocumentSourceBucketAuto::doDispose() {
     _sortedInput.reset();
+    _ranges.clear();
     _bucketsIterator = _buckets.end();
 }
 
@@ -382,6 +507,10 @@ Value DocumentSourceBucketAuto::serialize(
         insides["granularity"] = Value(_granularityRounder->getName());
     }
 
+    if (_approximate) {
+        insides["approximate"] = Value(true);
+    }
+
     MutableDocument outputSpec(_accumulatedFields.size());
     for (auto&& accumulatedField : _accumulatedFields) {
         intrusive_ptr<Accumulator> accum = accumulatedField.makeAccumulator(pExpCtx);
@@ -400,7 +529,8 @@ intrusive_ptr<DocumentSourceBucketAuto> DocumentSourceBucketAuto::create(
     int numBuckets,
     std::vector<AccumulationStatement> accumulationStatements,
     const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-    uint64_t maxMemoryUsageBytes) {
+    uint64_t maxMemoryUsageBytes,
+    bool approximate) {
     uassert(40243,
             str::stream() << "The $bucketAuto 'buckets' field must be greater than 0, but found: "
                           << numBuckets,
@@ -416,7 +546,8 @@ intrusive_ptr<DocumentSourceBucketAuto> DocumentSourceBucketAuto::create(
                                         numBuckets,
                                         accumulationStatements,
                                         granularityRounder,
-                                        maxMemoryUsageBytes);
+                                        maxMemoryUsageBytes,
+                                        approximate);
 }
 
 DocumentSourceBucketAuto::DocumentSourceBucketAuto(
@@ -425,10 +556,13 @@ DocumentSourceBucketAuto::DocumentSourceBucketAuto(
     int numBuckets,
     std::vector<AccumulationStatement> accumulationStatements,
     const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-    uint64_t maxMemoryUsageBytes)
+    uint64_t maxMemoryUsageBytes,
+    bool approximate)
     : DocumentSource(pExpCtx),
+      _ranges(pExpCtx->getValueComparator().makeOrderedValueMap<Bucket>()),
       _nBuckets(numBuckets),
       _maxMemoryUsageBytes(maxMemoryUsageBytes),
+      _approximate(approximate),
       _groupByExpression(groupByExpression),
       _granularityRounder(granularityRounder) {
 
@@ -450,6 +584,7 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
     boost::intrusive_ptr<Expression> groupByExpression;
     boost::optional<int> numBuckets;
     boost::intrusive_ptr<GranularityRounder> granularityRounder;
+    bool approximate = false;
 
     for (auto&& argument : elem.Obj()) {
         const auto argName = argument.fieldNameStringData();
@@ -490,6 +625,13 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
                         << typeName(argument.type()),
                     argument.type() == BSONType::String);
             granularityRounder = GranularityRounder::getGranularityRounder(pExpCtx, argument.str());
+        } else if ("approximate" == argName) {
+            uassert(51300,
+                    str::stream()
+                        << "The $bucketAuto 'approximate' field must be a boolean, but found type: "
+                        << typeName(argument.type()),
+                    argument.type() == BSONType::Bool);
+            approximate = argument.boolean();
         } else {
             uasserted(40245, str::stream() << "Unrecognized option to $bucketAuto: " << argName);
         }
@@ -499,8 +641,13 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
             "$bucketAuto requires 'groupBy' and 'buckets' to be specified",
             groupByExpression && numBuckets);
 
-    return DocumentSourceBucketAuto::create(
-        pExpCtx, groupByExpression, numBuckets.get(), accumulationStatements, granularityRounder);
+    return DocumentSourceBucketAuto::create(pExpCtx,
+                                            groupByExpression,
+                                            numBuckets.get(),
+                                            accumulationStatements,
+                                            granularityRounder,
+                                            kDefaultMaxMemoryUsageBytes,
+                                            approximate);
 }
 
 }  // namespace mongo
@@ -41,6 +41,11 @@ namespace mongo {
 /**
  * The $bucketAuto stage takes a user-specified number of buckets and automatically determines
  * boundaries such that the values are approximately equally distributed between those buckets.
+ *
+ * With 'approximate' set, the stage does not sort its input. It instead accumulates each document
+ * into one of a bounded number of disjoint ranges of the 'groupBy' values, merging neighbouring
+ * ranges as they fill up, and then forms the buckets from whole ranges. The buckets are then only
+ * roughly equal in size, but memory use no longer grows with the number of input documents.
  */
 class DocumentSourceBucketAuto final : public DocumentSource {
 public:
@@ -53,7 +58,7 @@ public:
         return {StreamType::kBlocking,
                 PositionRequirement::kNone,
                 HostTypeRequirement::kNone,
-                DiskUseRequirement::kWritesTmpData,
+                _approximate ? DiskUseRequirement::kNoDiskUse : DiskUseRequirement::kWritesTmpData,
                 FacetRequirement::kAllowed,
                 TransactionRequirement::kAllowed,
                 LookupRequirement::kAllowed};
@@ -81,7 +86,8 @@ public:
         int numBuckets,
         std::vector<AccumulationStatement> accumulationStatements = {},
         const boost::intrusive_ptr<GranularityRounder>& granularityRounder = nullptr,
-        uint64_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes);
+        uint64_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes,
+        bool approximate = false);
 
     /**
      * Parses a $bucketAuto stage from the user-supplied BSON.
@@ -98,7 +104,8 @@ private:
                              int numBuckets,
                              std::vector<AccumulationStatement> accumulationStatements,
                              const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-                             uint64_t maxMemoryUsageBytes);
+                             uint64_t maxMemoryUsageBytes,
+                             bool approximate);
 
     // struct for holding information about a bucket.
     struct Bucket {
@@ -109,6 +116,7 @@ private:
         Value _min;
         Value _max;
         std::vector<boost::intrusive_ptr<Accumulator>> _accums;
+        long long _count = 0;
     };
 
     /**
@@ -119,6 +127,12 @@ private:
      */
     GetNextResult populateSorter();
 
+    /**
+     * Like populateSorter(), but accumulates each document into '_ranges' instead. Used in
+     * approximate mode.
+     */
+    GetNextResult populateRanges();
+
     /**
      * Computes the 'groupBy' expression value for 'doc'.
      */
@@ -134,6 +148,38 @@ private:
      */
     void addDocumentToBucket(const std::pair<Value, Document>& entry, Bucket& bucket);
 
+    /**
+     * Adds 'doc', whose 'groupBy' value is 'key', to the range which holds 'key', or to a new
+     * range if there is none.
+     */
+    void addDocumentToRange(Value key, const Document& doc);
+
+    /**
+     * Merges neighbouring ranges until there are at most getMaxRanges() of them.
+     */
+    void compactRanges();
+
+    /**
+     * The number of ranges to which compactRanges() reduces '_ranges'.
+     */
+    size_t getMaxRanges() const;
+
+    /**
+     * Adds the documents accumulated in 'from', which holds no values smaller than those in 'into',
+     * to 'into'.
+     */
+    void mergeBucketInto(const Bucket& from, Bucket& into);
+
+    /**
+     * Like populateBuckets(), but forms each bucket from whole ranges of '_ranges'.
+     */
+    void populateBucketsFromRanges();
+
+    /**
+     * Rounds the first bucket's minimum down and the last bucket's maximum up to the granularity.
+     */
+    void roundOuterBoundaries();
+
     /**
      * Adds 'newBucket' to _buckets and updates any boundaries if necessary.
      */
@@ -148,10 +194,15 @@ private:
     std::unique_ptr<Sorter<Value, Document>> _sorter;
     std::unique_ptr<Sorter<Value, Document>::Iterator> _sortedInput;
 
+    // Used instead of the sorter in approximate mode. Disjoint ranges of the 'groupBy' values,
+    // keyed by their minimums.
+    ValueMap<Bucket> _ranges;
+
     std::vector<AccumulationStatement> _accumulatedFields;
 
     int _nBuckets;
     uint64_t _maxMemoryUsageBytes;
+    bool _approximate;
     bool _populated = false;
     std::vector<Bucket> _buckets;
     std::vector<Bucket>::iterator _bucketsIterator;
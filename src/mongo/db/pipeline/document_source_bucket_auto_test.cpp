@@ -806,5 +806,122 @@ TEST_F(BucketAutoTests, ShouldFailOnNegativeNumbersWhenGranularitySpecified) {
         AssertionException,
         40260);
 }
+
+TEST_F(BucketAutoTests, ApproximateModeMatchesExactModeWhenFewValues) {
+    auto exactSpec = fromjson(
+        "{$bucketAuto : {groupBy : '$x', buckets : 3, output : {n : {$sum : 1}, avg : {$avg : "
+        "'$y'}}}}");
+    auto approximateSpec = fromjson(
+        "{$bucketAuto : {groupBy : '$x', buckets : 3, output : {n : {$sum : 1}, avg : {$avg : "
+        "'$y'}}, approximate : true}}");
+
+    deque<Document> inputs;
+    for (int i = 0; i < 500; i++) {
+        inputs.push_back(Document{{"x", (i * 37) % 41}, {"y", i}});
+    }
+    inputs.push_back(Document{{"x", "a"_sd}, {"y", 1}});
+    inputs.push_back(Document{{"y", 1}});
+
+    auto expected = getResults(exactSpec, inputs);
+    auto results = getResults(approximateSpec, inputs);
+    ASSERT_EQUALS(results.size(), expected.size());
+    for (size_t i = 0; i < results.size(); i++) {
+        ASSERT_DOCUMENT_EQ(results[i], expected[i]);
+    }
+}
+
+TEST_F(BucketAutoTests, ApproximateModeFormsRoughlyEqualBucketsFromManyValues) {
+    auto bucketAutoSpec = fromjson(
+        "{$bucketAuto : {groupBy : '$x', buckets : 4, output : {n : {$sum : 1}, total : {$sum : "
+        "'$x'}}, approximate : true}}");
+
+    // Many more distinct values than ranges, in no particular order.
+    const int nDocs = 20000;
+    deque<Document> inputs;
+    long long expectedTotal = 0;
+    for (int i = 0; i < nDocs; i++) {
+        const int x = static_cast<int>((i * 7919LL) % nDocs);
+        inputs.push_back(Document{{"x", x}});
+        expectedTotal += x;
+    }
+
+    auto results = getResults(bucketAutoSpec, inputs);
+    ASSERT_EQUALS(results.size(), 4UL);
+
+    long long n = 0;
+    long long total = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        const long long bucketCount = results[i]["n"].coerceToLong();
+        ASSERT_GT(bucketCount, nDocs / 4 - 100) << results[i];
+        ASSERT_LT(bucketCount, nDocs / 4 + 100) << results[i];
+        n += bucketCount;
+        total += results[i]["total"].coerceToLong();
+
+        // Each bucket starts where the previous one ends.
+        if (i > 0) {
+            ASSERT_VALUE_EQ(results[i]["_id"]["min"], results[i - 1]["_id"]["max"]);
+        }
+    }
+    ASSERT_VALUE_EQ(results.front()["_id"]["min"], Value(0));
+    ASSERT_VALUE_EQ(results.back()["_id"]["max"], Value(nDocs - 1));
+    ASSERT_EQUALS(n, nDocs);
+    ASSERT_EQUALS(total, expectedTotal);
+}
+
+TEST_F(BucketAutoTests, ApproximateModeRoundsBoundariesWithGranularitySpecified) {
+    auto bucketAutoSpec = fromjson(
+        "{$bucketAuto : {groupBy : '$x', buckets : 2, granularity : 'R5', approximate : true}}");
+
+    // Values are 0, 15, 24, 30, 50
+    auto results = getResults(bucketAutoSpec,
+                              {Document{{"x", 24}},
+                               Document{{"x", 15}},
+                               Document{{"x", 30}},
+                               Document{{"x", 50}},
+                               Document{{"x", 0}}});
+
+    ASSERT_EQUALS(results.size(), 2UL);
+    ASSERT_DOCUMENT_EQ(results[0], Document(fromjson("{_id : {min : 0, max : 25}, count : 3}")));
+    ASSERT_DOCUMENT_EQ(results[1], Document(fromjson("{_id : {min : 25, max : 63}, count : 2}")));
+}
+
+TEST_F(BucketAutoTests, ApproximateModeDoesNotBufferDocuments) {
+    auto expCtx = getExpCtx();
+    expCtx->allowDiskUse = false;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$a", vps);
+
+    const int numBuckets = 2;
+    const bool approximate = true;
+    auto bucketAutoStage = DocumentSourceBucketAuto::create(
+        expCtx, groupByExpression, numBuckets, {}, nullptr, maxMemoryUsageBytes, approximate);
+
+    string largeStr(maxMemoryUsageBytes, 'x');
+    auto mock = DocumentSourceMock::createForTest(
+        {Document{{"a", 0}, {"largeStr", largeStr}}, Document{{"a", 1}, {"largeStr", largeStr}}});
+    bucketAutoStage->setSource(mock.get());
+
+    auto next = bucketAutoStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       Document(fromjson("{_id : {min : 0, max : 1}, count : 1}")));
+}
+
+TEST_F(BucketAutoTests, SerializesApproximateFieldIfSpecified) {
+    BSONObj spec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, approximate : true}}");
+    BSONObj expected = fromjson(
+        "{groupBy : '$x', buckets : 2, approximate : true, output : {count : {$sum : {$const : "
+        "1}}}}");
+
+    testSerialize(spec, expected);
+}
+
+TEST_F(BucketAutoTests, FailsWithNonBooleanApproximate) {
+    auto spec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, approximate : 1}}");
+    ASSERT_THROWS_CODE(createBucketAuto(spec), AssertionException, 51300);
+}
+
 }  // namespace
 }  // namespace mongo
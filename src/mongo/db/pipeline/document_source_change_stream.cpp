@@ -270,8 +270,14 @@ BSONObj DocumentSourceChangeStream::buildMatchFilter(
     auto commandsOnTargetDb =
         BSON("$and" << BSON_ARRAY(cmdNsFilter << BSON("$or" << relevantCommands.arr())));
 
+    // Every change stream evaluates this filter against each entry in the oplog, so a stream on a
+    // single collection matches the namespace by equality rather than by the far costlier regex.
+    auto nsMatch = (sourceType == ChangeStreamType::kSingleCollection
+                        ? BSON("ns" << nss.ns())
+                        : BSON("ns" << BSONRegEx(getNsRegexForChangeStream(nss))));
+
     // 1.2) Supported commands that have arbitrary db namespaces in "ns" field.
-    auto renameDropTarget = BSON("o.to" << BSONRegEx(getNsRegexForChangeStream(nss)));
+    auto renameDropTarget = BSON("o.to" << nsMatch["ns"]);
 
     // 1.3) Transaction commit commands.
     auto transactionCommit = BSON("o.commitTransaction" << 1);
@@ -283,7 +289,7 @@ BSONObj DocumentSourceChangeStream::buildMatchFilter(
 
     // 2) Supported operations on the operation namespace, optionally including those from
     // migrations.
-    BSONObj opNsMatch = BSON("ns" << BSONRegEx(getNsRegexForChangeStream(nss)));
+    BSONObj opNsMatch = nsMatch;
 
     // 2.1) Normal CRUD ops.
     auto normalOpTypeMatch = BSON("op" << NE << "n");
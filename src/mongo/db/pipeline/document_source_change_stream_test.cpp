@@ -1423,6 +1423,26 @@ TEST_F(ChangeStreamStageTest, MatchFiltersCreateCollection) {
     checkTransformation(createColl, boost::none);
 }
 
+TEST_F(ChangeStreamStageTest, MatchFiltersChangesOnSimilarlyNamedCollections) {
+    std::set<NamespaceString> unmatchedNamespaces = {
+        // Namespace differs only in the character where the target namespace has a dot.
+        NamespaceString("unittests_change_stream.coll"),
+        NamespaceString("unittestsXchange_stream"),
+        // Namespace starts with the target namespace, but is longer.
+        NamespaceString("unittests.change_stream2"),
+    };
+
+    for (auto& ns : unmatchedNamespaces) {
+        auto insert = makeOplogEntry(OpTypeEnum::kInsert, ns, BSON("_id" << 1));
+        checkTransformation(insert, boost::none);
+
+        NamespaceString otherColl("test.bar");
+        OplogEntry rename = createCommand(
+            BSON("renameCollection" << otherColl.ns() << "to" << ns.ns()), testUuid());
+        checkTransformation(rename, boost::none);
+    }
+}
+
 TEST_F(ChangeStreamStageTest, MatchFiltersNoOp) {
     auto noOp = makeOplogEntry(OpTypeEnum::kNoop,  // op type
                                {},                 // namespace
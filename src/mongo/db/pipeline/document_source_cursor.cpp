@@ -75,7 +75,16 @@ DocumentSource::GetNextResult DocumentSourceCursor::getNext() {
 }
 
 Document DocumentSourceCursor::transformBSONObjToDocument(const BSONObj& obj) const {
-    return _dependencies ? _dependencies->extractFields(obj) : Document::fromBsonWithMetaData(obj);
+    if (!_dependencies) {
+        return Document::fromBsonWithMetaData(obj);
+    }
+
+    // The query has already projected 'obj' onto the dependencies, so holding on to it costs little
+    // more than extracting them would, and the pipeline may only ever look some of them up.
+    if (internalDocumentSourceCursorLazyDocuments.load()) {
+        return Document::fromBsonLazily(obj);
+    }
+    return _dependencies->extractFields(obj);
 }
 
 void DocumentSourceCursor::loadBatch() {
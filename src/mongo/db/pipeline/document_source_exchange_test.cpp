@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document_source_exchange.h"
 #include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_parallel_exchange.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/executor/network_interface_factory.h"
 #include "mongo/executor/thread_pool_task_executor.h"
@@ -105,6 +106,37 @@ protected:
         return source;
     }
 
+    /**
+     * Returns a DocumentSourceParallelExchange whose consumers each read their share of 'source'
+     * through a round robin Exchange.
+     */
+    auto makeParallelExchange(boost::intrusive_ptr<DocumentSource> source, size_t nConsumers) {
+        ExchangeSpec spec;
+        spec.setPolicy(ExchangePolicyEnum::kRoundRobin);
+        spec.setConsumers(nConsumers);
+        spec.setBufferSize(1024);
+
+        // None of the pipelines, which run on threads of their own, may share our context.
+        auto makeExpCtx = [&] {
+            boost::intrusive_ptr<ExpressionContext> expCtx =
+                new ExpressionContext(getExpCtx()->opCtx, nullptr);
+            expCtx->mongoProcessInterface = std::make_shared<StubMongoProcessOkWithOpCtxChanges>();
+            return expCtx;
+        };
+
+        boost::intrusive_ptr<Exchange> ex =
+            new Exchange(spec, unittest::assertGet(Pipeline::create({source}, makeExpCtx())));
+
+        std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> consumers;
+        for (size_t idx = 0; idx < nConsumers; ++idx) {
+            auto consumerExpCtx = makeExpCtx();
+            consumers.push_back(unittest::assertGet(Pipeline::create(
+                {new DocumentSourceExchange(consumerExpCtx, ex, idx, nullptr)}, consumerExpCtx)));
+        }
+
+        return DocumentSourceParallelExchange::create(getExpCtx(), std::move(consumers));
+    }
+
     auto parseSpec(const BSONObj& spec) {
         IDLParserErrorContext ctx("internalExchange");
         return ExchangeSpec::parse(ctx, spec);
@@ -747,6 +779,36 @@ TEST_F(DocumentSourceExchangeTest, RejectInvalidBoundariesMissingMin) {
         50958);
 }
 
+TEST_F(DocumentSourceExchangeTest, ParallelExchangeReturnsEveryDocumentOnce) {
+    const size_t nDocs = 500;
+    auto parallelExchange = makeParallelExchange(getMockSource(nDocs), 4);
+
+    std::vector<int> seen(nDocs, 0);
+    auto input = parallelExchange->getNext();
+    for (; input.isAdvanced(); input = parallelExchange->getNext()) {
+        ++seen[input.getDocument()["a"].getInt()];
+    }
+    ASSERT_TRUE(input.isEOF());
+    parallelExchange->dispose();
+
+    for (size_t i = 0; i < nDocs; ++i) {
+        ASSERT_EQ(seen[i], 1) << i;
+    }
+}
+
+TEST_F(DocumentSourceExchangeTest, ParallelExchangeStopsConsumersWhenDisposedEarly) {
+    auto parallelExchange = makeParallelExchange(getMockSource(5000), 3);
+    ASSERT_TRUE(parallelExchange->getNext().isAdvanced());
+
+    // Must not wait for the consumers to read all of their input.
+    parallelExchange->dispose();
+}
+
+TEST_F(DocumentSourceExchangeTest, ParallelExchangeDisposesConsumersWhichNeverRan) {
+    auto parallelExchange = makeParallelExchange(getMockSource(10), 2);
+    parallelExchange->dispose();
+}
+
 TEST_F(DocumentSourceExchangeTest, RejectInvalidBoundariesMissingMax) {
     BSONObj spec = BSON("policy"
                         << "keyRange"
@@ -38,8 +38,10 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -628,5 +630,59 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldNotExpandArraysWithinArraysAtEndOfCo
     ASSERT(graphLookupStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceGraphLookUpTest, ShouldFindAllResultsWhenFrontierIsQueriedInBatches) {
+    auto expCtx = getExpCtx();
+
+    const int originalBatchSize = internalDocumentSourceGraphLookupMaxFrontierBatchSize.load();
+    internalDocumentSourceGraphLookupMaxFrontierBatchSize.store(1);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxFrontierBatchSize.store(originalBatchSize); });
+
+    std::deque<DocumentSource::GetNextResult> inputs{
+        Document{{"_id", 0}, {"startVal", std::vector<Value>{Value(1), Value(2), Value(3)}}}};
+    auto inputMock = DocumentSourceMock::createForTest(std::move(inputs));
+
+    // Each value of the starting frontier and of the next one is queried for separately.
+    Document middle1{{"_id", 1}, {"to", std::vector<Value>{Value(4), Value(5)}}};
+    Document middle2{{"_id", 2}, {"to", 5}};
+    Document middle3{{"_id", 3}};
+    Document sink4{{"_id", 4}};
+    Document sink5{{"_id", 5}};
+    std::deque<DocumentSource::GetNextResult> fromContents{Document(middle1),
+                                                           Document(middle2),
+                                                           Document(middle3),
+                                                           Document(sink4),
+                                                           Document(sink5)};
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(std::move(fromContents));
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "startVal"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+
+    auto resultsValue = next.getDocument().getField("results");
+    ASSERT(resultsValue.isArray());
+    auto resultsArray = resultsValue.getArray();
+    ASSERT_EQ(5U, resultsArray.size());
+    for (auto&& doc : {middle1, middle2, middle3, sink4, sink5}) {
+        ASSERT(arrayContains(expCtx, resultsArray, Value(doc)));
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -29,6 +29,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <memory>
 
@@ -62,6 +63,9 @@ std::string nextFileName() {
     return "extsort-doc-group." + std::to_string(documentSourceGroupFileCounter.fetchAndAdd(1));
 }
 
+// The number of times the groups of a partition may be partitioned again.
+const int kMaxSpillPartitionDepth = 4;
+
 }  // namespace
 
 using boost::intrusive_ptr;
@@ -160,22 +164,10 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
         return GetNextResult::makeEOF();
 
     _currentId = _firstPartOfNextGroup.first;
-    const size_t numAccumulators = _accumulatedFields.size();
     while (pExpCtx->getValueComparator().evaluate(_currentId == _firstPartOfNextGroup.first)) {
         // Inside of this loop, _firstPartOfNextGroup is the current data being processed.
         // At loop exit, it is the first value to be processed in the next group.
-        switch (numAccumulators) {  // mirrors switch in spill()
-            case 1:                 // Single accumulators serialize as a single Value.
-                _currentAccumulators[0]->process(_firstPartOfNextGroup.second, true);
-            case 0:  // No accumulators so no Values.
-                break;
-            default: {  // Multiple accumulators serialize as an array of Values.
-                const vector<Value>& accumulatorStates = _firstPartOfNextGroup.second.getArray();
-                for (size_t i = 0; i < numAccumulators; i++) {
-                    _currentAccumulators[i]->process(accumulatorStates[i], true);
-                }
-            }
-        }
+        mergePartialResults(_firstPartOfNextGroup.second, &_currentAccumulators);
 
         if (!_sorterIterator->more()) {
             dispose();
@@ -189,13 +181,17 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
-    // Not spilled, and not streaming.
-    if (_groups->empty())
+    // Not spilled, and not streaming. Once the groups in memory have been returned, move on to
+    // those of the partitions which were written to disk, if any.
+    while (groupsIterator == _groups->end() && !_pendingPartitions.empty()) {
+        aggregateSpilledPartition();
+    }
+    if (groupsIterator == _groups->end())
         return GetNextResult::makeEOF();
 
     Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
 
-    if (++groupsIterator == _groups->end())
+    if (++groupsIterator == _groups->end() && _pendingPartitions.empty())
         dispose();
 
     return std::move(out);
@@ -203,8 +199,12 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
 
 void DocumentSourceGroup::doDispose() {
     // Free our resources.
-    _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+    _groups = pExpCtx->getValueComparator().makeFlatUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _partitions.clear();
+    _pendingPartitions.clear();
+    _memoryUsageBytes = 0;
+    _trackedMemoryUsage.set(pExpCtx->opCtx, 0);
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -256,6 +256,15 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
         insides["$doingMerge"] = Value(true);
     }
 
+    if (_numSpillPartitions > 0 && explain && *explain >= ExplainOptions::Verbosity::kExecStats) {
+        // Like $doingMerge, this cannot clash with the name of an output field.
+        insides["$spillStats"] = Value(DOC("spilledPartitions" << _spillStats.spilledPartitions
+                                                               << "spilledRecords"
+                                                               << _spillStats.spilledRecords
+                                                               << "spilledBytes"
+                                                               << _spillStats.spilledBytes));
+    }
+
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
@@ -334,9 +343,10 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _maxMemoryUsageBytes(maxMemoryUsageBytes ? *maxMemoryUsageBytes
                                                : internalDocumentSourceGroupMaxMemoryBytes.load()),
       _initialized(false),
-      _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
+      _groups(pExpCtx->getValueComparator().makeFlatUnorderedValueMap<Accumulators>()),
       _spilled(false),
-      _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
+      _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos),
+      _numSpillPartitions(internalDocumentSourceGroupSpillPartitions.load()) {
     if (!pExpCtx->inMongos && (pExpCtx->allowDiskUse || kDebugBuild)) {
         // We spill to disk in debug mode, regardless of allowDiskUse, to stress the system.
         _fileName = pExpCtx->tempDir + "/" + nextFileName();
@@ -473,13 +483,23 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
     GetNextResult input = pSource->getNext();
     for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+        // When all queries together use more than their budget, a $group which may spill does so
+        // early, and one which may not fails if its operation is the one using the most memory.
+        _trackedMemoryUsage.set(pExpCtx->opCtx, _memoryUsageBytes);
+        const bool overBudget = _allowDiskUse && _trackedMemoryUsage.shouldSpill();
+        if (_memoryUsageBytes > _maxMemoryUsageBytes || overBudget) {
             uassert(16945,
                     "Exceeded memory limit for $group, but didn't allow external sort."
                     " Pass allowDiskUse:true to opt in.",
                     _allowDiskUse);
-            _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
+            if (_numSpillPartitions > 0) {
+                spillPartitions(overBudget ? 0 : _maxMemoryUsageBytes / 2);
+            } else {
+                _sortedFiles.push_back(spill());
+                _memoryUsageBytes = 0;
+            }
+        } else {
+            uassertStatusOK(_trackedMemoryUsage.checkBudget());
         }
 
         // We release the result document here so that it does not outlive the end of this loop
@@ -548,7 +568,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                 }
 
                 // We won't be using groups again so free its memory.
-                _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+                _groups = pExpCtx->getValueComparator().makeFlatUnorderedValueMap<Accumulators>();
 
                 _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
                     _sortedFiles,
@@ -566,6 +586,10 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                 verify(_sorterIterator->more());  // we put data in, we should get something out.
                 _firstPartOfNextGroup = _sorterIterator->next();
             } else {
+                if (!_partitions.empty()) {
+                    finishSpillingPartitions();
+                }
+
                 // start the group iterator
                 groupsIterator = _groups->begin();
             }
@@ -595,36 +619,192 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
 
     SortedFileWriter<Value, Value> writer(
         SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
-    switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
-        case 0:                           // no values, essentially a distinct
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first, Value());
-            }
-            break;
+    for (size_t i = 0; i < ptrs.size(); i++) {
+        writer.addAlreadySorted(ptrs[i]->first, serializePartialResults(ptrs[i]->second));
+    }
+
+    _groups->clear();
+
+    Sorter<Value, Value>::Iterator* iteratorPtr = writer.done();
+    _nextSortedFileWriterOffset = writer.getFileEndOffset();
+    return shared_ptr<Sorter<Value, Value>::Iterator>(iteratorPtr);
+}
 
+Value DocumentSourceGroup::serializePartialResults(const Accumulators& accums) const {
+    switch (accums.size()) {
+        case 0:  // no values, essentially a distinct
+            return Value();
         case 1:  // just one value, use optimized serialization as single Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first,
-                                        ptrs[i]->second[0]->getValue(/*toBeMerged=*/true));
+            return accums[0]->getValue(/*toBeMerged=*/true);
+        default: {  // multiple values, serialize as array-typed Value
+            vector<Value> values;
+            values.reserve(accums.size());
+            for (auto&& accum : accums) {
+                values.push_back(accum->getValue(/*toBeMerged=*/true));
             }
-            break;
+            return Value(std::move(values));
+        }
+    }
+}
 
-        default:  // multiple values, serialize as array-typed Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                vector<Value> accums;
-                for (size_t j = 0; j < ptrs[i]->second.size(); j++) {
-                    accums.push_back(ptrs[i]->second[j]->getValue(/*toBeMerged=*/true));
-                }
-                writer.addAlreadySorted(ptrs[i]->first, Value(std::move(accums)));
+void DocumentSourceGroup::mergePartialResults(const Value& partialResults,
+                                              Accumulators* accums) const {
+    switch (accums->size()) {  // mirrors switch in serializePartialResults()
+        case 0:                // No accumulators so no Values.
+            break;
+        case 1:  // Single accumulators serialize as a single Value.
+            (*accums)[0]->process(partialResults, true);
+            break;
+        default: {  // Multiple accumulators serialize as an array of Values.
+            const vector<Value>& accumulatorStates = partialResults.getArray();
+            for (size_t i = 0; i < accums->size(); i++) {
+                (*accums)[i]->process(accumulatorStates[i], true);
             }
+        }
+    }
+}
+
+size_t DocumentSourceGroup::partitionOf(const Value& id) const {
+    // Mix the hash with the depth so that the groups of one partition spread over all of the
+    // partitions when they are partitioned again. This is the finalizer of MurmurHash3.
+    uint64_t hash = pExpCtx->getValueComparator().hash(id) +
+        0x9e3779b97f4a7c15ULL * static_cast<uint64_t>(_partitionDepth + 1);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash % _numSpillPartitions;
+}
+
+void DocumentSourceGroup::spillPartitions(size_t maxBytesToKeep) {
+    if (_partitions.empty()) {
+        _partitions.resize(_numSpillPartitions);
+        for (auto&& partition : _partitions) {
+            partition.depth = _partitionDepth + 1;
+        }
+    }
+
+    std::vector<std::vector<GroupsMap::iterator>> groupsByPartition(_numSpillPartitions);
+    std::vector<size_t> partitionBytes(_numSpillPartitions, 0);
+    for (auto it = _groups->begin(); it != _groups->end(); ++it) {
+        const size_t partition = partitionOf(it->first);
+        groupsByPartition[partition].push_back(it);
+        partitionBytes[partition] += it->first.getApproximateSize();
+        for (auto&& accum : it->second) {
+            partitionBytes[partition] += accum->memUsageForSorter();
+        }
+    }
+
+    auto spillWholePartition = [&](size_t partition) {
+        _memoryUsageBytes -= std::min(_memoryUsageBytes, partitionBytes[partition]);
+        partitionBytes[partition] = 0;
+        spillPartition(partition, groupsByPartition[partition]);
+    };
+    for (size_t partition = 0; partition < _numSpillPartitions; ++partition) {
+        if (!_partitions[partition].runs.empty() && !groupsByPartition[partition].empty()) {
+            spillWholePartition(partition);
+        }
+    }
+
+    // Leave room for the groups yet to come, so that we do not spill again right away.
+    while (_memoryUsageBytes > maxBytesToKeep) {
+        auto largest = std::max_element(partitionBytes.begin(), partitionBytes.end());
+        if (*largest == 0) {
             break;
+        }
+        spillWholePartition(largest - partitionBytes.begin());
     }
+}
 
-    _groups->clear();
+void DocumentSourceGroup::finishSpillingPartitions() {
+    std::vector<std::vector<GroupsMap::iterator>> groupsByPartition(_numSpillPartitions);
+    for (auto it = _groups->begin(); it != _groups->end(); ++it) {
+        const size_t partition = partitionOf(it->first);
+        if (!_partitions[partition].runs.empty()) {
+            groupsByPartition[partition].push_back(it);
+        }
+    }
 
-    Sorter<Value, Value>::Iterator* iteratorPtr = writer.done();
+    for (size_t partition = 0; partition < _numSpillPartitions; ++partition) {
+        if (!groupsByPartition[partition].empty()) {
+            spillPartition(partition, groupsByPartition[partition]);
+        }
+        if (!_partitions[partition].runs.empty()) {
+            _pendingPartitions.push_back(std::move(_partitions[partition]));
+        }
+    }
+    _partitions.clear();
+}
+
+void DocumentSourceGroup::spillPartition(size_t partition,
+                                         const std::vector<GroupsMap::iterator>& groups) {
+    _usedDisk = true;
+
+    // The groups of a partition are aggregated again in a hash table rather than merged, so the
+    // runs need not be sorted.
+    SortedFileWriter<Value, Value> writer(
+        SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
+    for (auto&& it : groups) {
+        writer.addAlreadySorted(it->first, serializePartialResults(it->second));
+        _groups->erase(it);
+    }
+
+    auto& runs = _partitions[partition].runs;
+    if (runs.empty()) {
+        ++_spillStats.spilledPartitions;
+    }
+    runs.emplace_back(writer.done());
+    _spillStats.spilledRecords += groups.size();
+    _spillStats.spilledBytes += writer.getFileEndOffset() - _nextSortedFileWriterOffset;
     _nextSortedFileWriterOffset = writer.getFileEndOffset();
-    return shared_ptr<Sorter<Value, Value>::Iterator>(iteratorPtr);
+}
+
+void DocumentSourceGroup::aggregateSpilledPartition() {
+    SpilledPartition partition = std::move(_pendingPartitions.back());
+    _pendingPartitions.pop_back();
+
+    _groups->clear();
+    _memoryUsageBytes = 0;
+    _partitionDepth = partition.depth;
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (auto&& run : partition.runs) {
+        while (run->more()) {
+            // Beyond the maximum depth, the groups are most likely few but large, so partitioning
+            // them further would not help.
+            _trackedMemoryUsage.set(pExpCtx->opCtx, _memoryUsageBytes);
+            if (_memoryUsageBytes > _maxMemoryUsageBytes &&
+                _partitionDepth < kMaxSpillPartitionDepth) {
+                spillPartitions(_maxMemoryUsageBytes / 2);
+            }
+
+            auto next = run->next();
+            const size_t oldSize = _groups->size();
+            Accumulators& group = (*_groups)[next.first];
+            if (_groups->size() != oldSize) {
+                _memoryUsageBytes += next.first.getApproximateSize();
+                group.reserve(numAccumulators);
+                for (auto&& accumulatedField : _accumulatedFields) {
+                    group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+                }
+            } else {
+                for (auto&& accum : group) {
+                    _memoryUsageBytes -= accum->memUsageForSorter();
+                }
+            }
+
+            mergePartialResults(next.second, &group);
+            for (auto&& accum : group) {
+                _memoryUsageBytes += accum->memUsageForSorter();
+            }
+        }
+        run.reset();
+    }
+
+    if (!_partitions.empty()) {
+        finishSpillingPartitions();
+    }
+    groupsIterator = _groups->begin();
 }
 
 Value DocumentSourceGroup::computeId(const Document& root) {
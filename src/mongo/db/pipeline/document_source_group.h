@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/transformer_interface.h"
+#include "mongo/db/query/query_memory_tracker.h"
 #include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
@@ -89,10 +90,22 @@ private:
 class DocumentSourceGroup final : public DocumentSource {
 public:
     using Accumulators = std::vector<boost::intrusive_ptr<Accumulator>>;
-    using GroupsMap = ValueUnorderedMap<Accumulators>;
+    using GroupsMap = ValueFlatUnorderedMap<Accumulators>;
 
     static constexpr StringData kStageName = "$group"_sd;
 
+    /**
+     * Describes what a $group partitioned by key hash wrote to disk, see
+     * internalDocumentSourceGroupSpillPartitions.
+     */
+    struct SpillStats {
+        // The number of partitions which were written to disk, counting each partition of a
+        // partition which had to be spilled again separately.
+        long long spilledPartitions = 0;
+        long long spilledRecords = 0;
+        long long spilledBytes = 0;
+    };
+
     boost::intrusive_ptr<DocumentSource> optimize() final;
     DepsTracker::State getDependencies(DepsTracker* deps) const final;
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
@@ -159,6 +172,10 @@ public:
      */
     bool usedDisk() final;
 
+    const SpillStats& getSpillStats() const {
+        return _spillStats;
+    }
+
     boost::optional<DistributedPlanLogic> distributedPlanLogic() final;
     bool canRunInParallelBeforeWriteStage(
         const std::set<std::string>& nameOfShardKeyFieldsUponEntryToStage) const final;
@@ -211,6 +228,45 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * Returns the partition of the groups with key 'id' among '_numSpillPartitions', hashing it
+     * differently at each '_partitionDepth'.
+     */
+    size_t partitionOf(const Value& id) const;
+
+    /**
+     * Writes the groups of the largest partitions to disk until the groups left in memory use at
+     * most 'maxBytesToKeep', which is half of '_maxMemoryUsageBytes' unless queries are over their
+     * total memory budget. Those of the partitions which are already on disk are always written
+     * out, since they need to be aggregated with the ones there anyway.
+     */
+    void spillPartitions(size_t maxBytesToKeep);
+
+    /**
+     * Writes the groups in memory of the partitions which are on disk to disk as well, and queues
+     * those partitions to be aggregated once the groups in memory have been returned.
+     */
+    void finishSpillingPartitions();
+
+    /**
+     * Writes 'groups', which all belong to partition 'partition', to disk and removes them from
+     * '_groups'.
+     */
+    void spillPartition(size_t partition, const std::vector<GroupsMap::iterator>& groups);
+
+    /**
+     * Replaces the contents of '_groups' with the groups of the next queued partition, merging
+     * their partial results. If they do not fit in memory, they are partitioned once more.
+     */
+    void aggregateSpilledPartition();
+
+    /**
+     * Returns the partial results of 'accums' as a single value, to be written to disk and later
+     * merged back by mergePartialResults().
+     */
+    Value serializePartialResults(const Accumulators& accums) const;
+    void mergePartialResults(const Value& partialResults, Accumulators* accums) const;
+
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
@@ -235,6 +291,7 @@ private:
     bool _doingMerge;
     size_t _memoryUsageBytes = 0;
     size_t _maxMemoryUsageBytes;
+    QueryMemoryTracker::StageUsage _trackedMemoryUsage;  // Reports '_memoryUsageBytes'.
     std::string _fileName;
     unsigned int _nextSortedFileWriterOffset = 0;
     bool _ownsFileDeletion = true;  // unless a MergeIterator is made that takes over.
@@ -263,6 +320,30 @@ private:
     const bool _allowDiskUse;
 
     std::pair<Value, Value> _firstPartOfNextGroup;
+
+    // The groups which a $group partitioned by key hash has written to disk, as unsorted runs of
+    // partial results.
+    struct SpilledPartition {
+        std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> runs;
+
+        // The '_partitionDepth' at which the groups of this partition are to be aggregated.
+        int depth = 0;
+    };
+
+    // If non-zero, a $group which exceeds its memory limit partitions its groups rather than
+    // spilling sorted runs of all of them.
+    const size_t _numSpillPartitions;
+
+    // How many times the groups in '_groups' have been partitioned already.
+    int _partitionDepth = 0;
+
+    // The partitions of the groups being aggregated. Empty until the first partition is spilled.
+    std::vector<SpilledPartition> _partitions;
+
+    // The spilled partitions which are left to aggregate once the current groups are returned.
+    std::vector<SpilledPartition> _pendingPartitions;
+
+    SpillStats _spillStats;
 };
 
 }  // namespace mongo
@@ -49,6 +49,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/unordered_set.h"
@@ -142,6 +143,105 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_EQ(idSet.count(2), 1UL);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldAggregatePartitionsSpilledByKeyHash) {
+    const auto oldSpillPartitions = internalDocumentSourceGroupSpillPartitions.load();
+    internalDocumentSourceGroupSpillPartitions.store(4);
+
+    auto expCtx = getExpCtx();
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement sumStatement{"count",
+                                       ExpressionConstant::create(expCtx, Value(1)),
+                                       AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement maxStatement{"maxSeq",
+                                       ExpressionFieldPath::parse(expCtx, "$seq", vps),
+                                       AccumulationStatement::getFactory("$max")};
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$key", vps);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {sumStatement, maxStatement}, maxMemoryUsageBytes);
+
+    // Each key comes up three times, spread over the input so that its groups are spilled before
+    // all of its documents have been seen.
+    const int numKeys = 200;
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int seq = 0; seq < 3 * numKeys; ++seq) {
+        inputs.emplace_back(Document{{"key", seq % numKeys}, {"seq", seq}});
+    }
+    auto mock = DocumentSourceMock::createForTest(inputs);
+    group->setSource(mock.get());
+
+    std::map<int, Document> results;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_TRUE(results.emplace(doc["_id"].coerceToInt(), doc).second) << doc;
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+
+    ASSERT_EQ(results.size(), static_cast<size_t>(numKeys));
+    for (auto&& result : results) {
+        ASSERT_DOCUMENT_EQ(result.second,
+                           (Document{{"_id", result.first},
+                                     {"count", 3},
+                                     {"maxSeq", result.first + 2 * numKeys}}));
+    }
+
+    ASSERT_TRUE(group->usedDisk());
+    const auto& stats = group->getSpillStats();
+    ASSERT_GT(stats.spilledPartitions, 0);
+    ASSERT_GT(stats.spilledRecords, 0);
+    ASSERT_GT(stats.spilledBytes, 0);
+
+    internalDocumentSourceGroupSpillPartitions.store(oldSpillPartitions);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldPartitionSpilledPartitionsAgainIfTheyDoNotFitInMemory) {
+    const auto oldSpillPartitions = internalDocumentSourceGroupSpillPartitions.load();
+    internalDocumentSourceGroupSpillPartitions.store(2);
+
+    auto expCtx = getExpCtx();
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement pushStatement{"spaceHog",
+                                        ExpressionFieldPath::parse(expCtx, "$largeStr", vps),
+                                        AccumulationStatement::getFactory("$push")};
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$_id", vps);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {pushStatement}, maxMemoryUsageBytes);
+
+    // Every group is larger than half of the memory limit, so half of the groups of a partition
+    // never fit in memory together.
+    const int numKeys = 20;
+    string largeStr(maxMemoryUsageBytes / 2, 'x');
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < numKeys; ++i) {
+        inputs.emplace_back(Document{{"_id", i}, {"largeStr", largeStr}});
+    }
+    auto mock = DocumentSourceMock::createForTest(inputs);
+    group->setSource(mock.get());
+
+    stdx::unordered_set<int> idSet;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_VALUE_EQ(doc["spaceHog"], Value(std::vector<Value>{Value(largeStr)}));
+        ASSERT_TRUE(idSet.insert(doc["_id"].coerceToInt()).second) << doc;
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_EQ(idSet.size(), static_cast<size_t>(numKeys));
+
+    // The two partitions of the first level were partitioned again.
+    ASSERT_GT(group->getSpillStats().spilledPartitions, 2);
+
+    internalDocumentSourceGroupSpillPartitions.store(oldSpillPartitions);
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
     const size_t maxMemoryUsageBytes = 1000;
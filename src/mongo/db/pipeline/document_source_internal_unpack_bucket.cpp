@@ -0,0 +1,176 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+
+#include <limits>
+
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/timeseries/bucket_compression.h"
+
+namespace mongo {
+
+REGISTER_DOCUMENT_SOURCE(_internalUnpackBucket,
+                         LiteParsedDocumentSourceDefault::parse,
+                         DocumentSourceInternalUnpackBucket::createFromBson);
+
+constexpr StringData DocumentSourceInternalUnpackBucket::kStageName;
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createFromBson(
+    BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    uassert(ErrorCodes::TypeMismatch,
+            str::stream() << "$_internalUnpackBucket must take a nested object but found: "
+                          << elem,
+            elem.type() == BSONType::Object);
+
+    return new DocumentSourceInternalUnpackBucket(
+        expCtx, TimeseriesOptions::parse(IDLParserErrorContext(kStageName), elem.embeddedObject()));
+}
+
+DocumentSourceInternalUnpackBucket::DocumentSourceInternalUnpackBucket(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, TimeseriesOptions options)
+    : DocumentSource(expCtx), _options(std::move(options)) {}
+
+DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    while (_nextMeasurement == _measurements.size()) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            return nextInput;
+        }
+
+        _measurements.clear();
+        _nextMeasurement = 0;
+        timeseries::unpackBucket(_options, nextInput.getDocument().toBson(), &_measurements);
+    }
+
+    return Document(_measurements[_nextMeasurement++]);
+}
+
+Value DocumentSourceInternalUnpackBucket::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    return Value(Document{{getSourceName(), Value{_options.toBSON()}}});
+}
+
+BSONObj DocumentSourceInternalUnpackBucket::makeBucketPredicate(const BSONObj& query) const {
+    const StringData timeField = _options.getTimeField();
+    const std::string minTimePath = str::stream() << timeseries::kBucketControlFieldName << "."
+                                                  << timeseries::kBucketControlMinFieldName << "."
+                                                  << timeField;
+    const std::string maxTimePath = str::stream() << timeseries::kBucketControlFieldName << "."
+                                                  << timeseries::kBucketControlMaxFieldName << "."
+                                                  << timeField;
+    const long long spanMillis = _options.getBucketMaxSpanSeconds() * 1000;
+
+    // The '_id' of a bucket begins with the start of its span, which is at most the earliest time
+    // of its measurements and more than 'spanMillis' before the latest.
+    BSONArrayBuilder predicates;
+    auto addMinBound = [&](StringData op, Date_t time) {
+        predicates.append(BSON(maxTimePath << BSON(op << time)));
+        const long long millis = time.toMillisSinceEpoch();
+        if (millis >= std::numeric_limits<long long>::min() + spanMillis) {
+            const auto start = Date_t::fromMillisSinceEpoch(millis - spanMillis);
+            predicates.append(
+                BSON(timeseries::kBucketIdFieldName
+                     << BSON("$gte" << BSON(timeseries::kBucketIdStartFieldName << start))));
+        }
+    };
+    auto addMaxBound = [&](StringData op, Date_t time) {
+        predicates.append(BSON(minTimePath << BSON(op << time)));
+        const long long millis = time.toMillisSinceEpoch();
+        if (millis < std::numeric_limits<long long>::max()) {
+            const auto end = Date_t::fromMillisSinceEpoch(millis + 1);
+            predicates.append(
+                BSON(timeseries::kBucketIdFieldName
+                     << BSON("$lt" << BSON(timeseries::kBucketIdStartFieldName << end))));
+        }
+    };
+    auto addComparison = [&](StringData op, const BSONElement& value) {
+        if (value.type() != Date) {
+            return;
+        }
+        const Date_t time = value.date();
+        if (op == "$eq") {
+            addMinBound("$gte", time);
+            addMaxBound("$lte", time);
+        } else if (op == "$gt" || op == "$gte") {
+            addMinBound(op, time);
+        } else if (op == "$lt" || op == "$lte") {
+            addMaxBound(op, time);
+        }
+    };
+
+    for (auto&& elem : query) {
+        if (elem.fieldNameStringData() != timeField) {
+            continue;
+        }
+        if (elem.type() != Object) {
+            addComparison("$eq", elem);
+            continue;
+        }
+        for (auto&& comparison : elem.Obj()) {
+            addComparison(comparison.fieldNameStringData(), comparison);
+        }
+    }
+
+    const BSONArray bucketPredicates = predicates.arr();
+    return bucketPredicates.isEmpty() ? BSONObj() : BSON("$and" << bucketPredicates);
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    if (_pushedDownBucketPredicate || std::next(itr) == container->end()) {
+        return std::next(itr);
+    }
+
+    auto nextMatch = dynamic_cast<DocumentSourceMatch*>(std::next(itr)->get());
+    if (!nextMatch) {
+        return std::next(itr);
+    }
+
+    _pushedDownBucketPredicate = true;
+    const BSONObj bucketPredicate = makeBucketPredicate(nextMatch->getQuery());
+    if (bucketPredicate.isEmpty()) {
+        return std::next(itr);
+    }
+
+    // Optimize the new $match, which may be combined with stages before it, and then this stage
+    // again.
+    container->insert(itr, DocumentSourceMatch::create(bucketPredicate, pExpCtx));
+    return std::prev(itr);
+}
+
+}  // namespace mongo
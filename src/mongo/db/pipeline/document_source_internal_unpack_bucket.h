@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
+
+namespace mongo {
+
+/**
+ * Unpacks each bucket of a time-series collection into the measurements it stores. This stage
+ * begins the pipeline of the view which presents a time-series collection, whose options it takes
+ * as its specification. See timeseries/bucket_compression.h for the format of a bucket.
+ *
+ * When this stage is followed by a $match which compares the time field with dates, a $match on
+ * the time range and on the '_id' of each bucket is added before it, so that only the buckets
+ * which may hold matching measurements are unpacked, and so that these can be found with the
+ * '_id' index of the buckets collection.
+ */
+class DocumentSourceInternalUnpackBucket final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalUnpackBucket"_sd;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    DocumentSourceInternalUnpackBucket(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                       TimeseriesOptions options);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        return {StreamType::kStreaming,
+                PositionRequirement::kNone,
+                HostTypeRequirement::kNone,
+                DiskUseRequirement::kNoDiskUse,
+                FacetRequirement::kAllowed,
+                TransactionRequirement::kAllowed,
+                LookupRequirement::kAllowed};
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    /**
+     * Unpacking a bucket needs all of its fields.
+     */
+    DepsTracker::State getDependencies(DepsTracker* deps) const final {
+        deps->needWholeDocument = true;
+        return DepsTracker::State::EXHAUSTIVE_ALL;
+    }
+
+    GetNextResult getNext() final;
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    /**
+     * Returns a $match on the fields of the buckets which selects those that may hold measurements
+     * matching the comparisons of the time field with dates at the top level of 'query', or an
+     * empty object if 'query' has none.
+     */
+    BSONObj makeBucketPredicate(const BSONObj& query) const;
+
+protected:
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
+private:
+    const TimeseriesOptions _options;
+
+    // Whether a $match on the buckets was already derived from the $match which follows.
+    bool _pushedDownBucketPredicate = false;
+
+    // The measurements of the bucket being unpacked, and the position of the next one to return.
+    std::vector<BSONObj> _measurements;
+    size_t _nextMeasurement = 0;
+};
+
+}  // namespace mongo
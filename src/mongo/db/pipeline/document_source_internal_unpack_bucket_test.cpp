@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/timeseries/bucket_compression.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using DocumentSourceInternalUnpackBucketTest = AggregationContextFixture;
+
+const BSONObj kSpec = fromjson("{timeField: 'time', metaField: 'tags', bucketMaxSpanSeconds: 60}");
+
+TimeseriesOptions makeOptions() {
+    return TimeseriesOptions::parse(IDLParserErrorContext("test"), kSpec);
+}
+
+boost::intrusive_ptr<DocumentSourceInternalUnpackBucket> makeStage(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    auto stage = DocumentSourceInternalUnpackBucket::createFromBson(
+        BSON("$_internalUnpackBucket" << kSpec).firstElement(), expCtx);
+    return static_cast<DocumentSourceInternalUnpackBucket*>(stage.get());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, UnpacksMeasurementsOfEachBucket) {
+    const auto options = makeOptions();
+    const Date_t start = Date_t::fromMillisSinceEpoch(60000);
+    auto makeMeasurement = [&](int i, StringData tag) {
+        return BSON("time" << start + Seconds(i) << "tags" << tag << "value" << i);
+    };
+    const BSONObj first = timeseries::makeBucket(
+        options,
+        timeseries::makeBucketId(start, BSON("" << "a").firstElement(), 0),
+        {makeMeasurement(0, "a"), makeMeasurement(1, "a")});
+    const BSONObj second = timeseries::makeBucket(
+        options,
+        timeseries::makeBucketId(start, BSON("" << "b").firstElement(), 0),
+        {makeMeasurement(2, "b")});
+
+    auto unpack = makeStage(getExpCtx());
+    auto source = DocumentSourceMock::createForTest({Document(first), Document(second)});
+    unpack->setSource(source.get());
+
+    for (int i = 0; i < 3; ++i) {
+        auto next = unpack->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(Document(makeMeasurement(i, i < 2 ? "a" : "b")), next.releaseDocument());
+    }
+    ASSERT_TRUE(unpack->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, SerializesOptions) {
+    auto unpack = makeStage(getExpCtx());
+    ASSERT_VALUE_EQ(Value(DOC("$_internalUnpackBucket" << Document(kSpec))), unpack->serialize());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, RejectsInvalidSpecification) {
+    ASSERT_THROWS(DocumentSourceInternalUnpackBucket::createFromBson(
+                      BSON("$_internalUnpackBucket" << 1).firstElement(), getExpCtx()),
+                  AssertionException);
+    ASSERT_THROWS(
+        DocumentSourceInternalUnpackBucket::createFromBson(
+            fromjson("{$_internalUnpackBucket: {metaField: 'tags'}}").firstElement(), getExpCtx()),
+        AssertionException);
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, MakesPredicateOnBucketsForTimeRange) {
+    auto unpack = makeStage(getExpCtx());
+    const Date_t lower = Date_t::fromMillisSinceEpoch(120000);
+    const Date_t upper = Date_t::fromMillisSinceEpoch(180000);
+
+    const BSONObj predicate =
+        unpack->makeBucketPredicate(BSON("time" << BSON("$gte" << lower << "$lt" << upper)));
+    const BSONObj expected = BSON(
+        "$and" << BSON_ARRAY(
+            BSON("control.max.time" << BSON("$gte" << lower))
+            << BSON("_id" << BSON("$gte" << BSON("t" << lower - Seconds(60))))
+            << BSON("control.min.time" << BSON("$lt" << upper))
+            << BSON("_id" << BSON("$lt" << BSON("t" << upper + Milliseconds(1))))));
+    ASSERT_BSONOBJ_EQ(expected, predicate);
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, MakesNoPredicateWithoutDateComparisons) {
+    auto unpack = makeStage(getExpCtx());
+    ASSERT_BSONOBJ_EQ(BSONObj(), unpack->makeBucketPredicate(fromjson("{value: {$gt: 5}}")));
+    ASSERT_BSONOBJ_EQ(BSONObj(), unpack->makeBucketPredicate(fromjson("{time: {$gt: 5}}")));
+    ASSERT_BSONOBJ_EQ(BSONObj(),
+                      unpack->makeBucketPredicate(fromjson("{$or: [{time: {$gt: {$date: 0}}}]}")));
+}
+
+}  // namespace
+}  // namespace mongo
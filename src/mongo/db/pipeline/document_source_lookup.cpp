@@ -31,6 +31,7 @@
 
 #include "mongo/db/pipeline/document_source_lookup.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/base/init.h"
@@ -206,6 +207,20 @@ StageConstraints DocumentSourceLookUp::constraints(Pipeline::SplitState) const {
 
 namespace {
 
+/**
+ * Generates a new file name on each call using a static, atomic and monotonically increasing
+ * number.
+ *
+ * Each user of the Sorter must implement this function to ensure that all temporary files that the
+ * Sorter instances produce are uniquely identified using a unique file name extension with separate
+ * atomic variable. This is necessary because the sorter.cpp code is separately included in multiple
+ * places, rather than compiled in one place and linked, and so cannot provide a globally unique ID.
+ */
+std::string nextFileName() {
+    static AtomicWord<unsigned> documentSourceLookupFileCounter;
+    return "extsort-doc-lookup." + std::to_string(documentSourceLookupFileCounter.fetchAndAdd(1));
+}
+
 /**
  * Constructs a query of the following shape:
  *  {$or: [
@@ -225,6 +240,85 @@ BSONObj buildEqualityOrQuery(const std::string& fieldName, const BSONArray& valu
     return orBuilder.obj();
 }
 
+/**
+ * Appends 'result' to the matches of a lookup, throwing if their total size, tracked by
+ * 'totalSize', exceeds the maximum size of the matches of a single input document.
+ */
+void appendLookupResult(Document result,
+                        const NamespaceString& fromNs,
+                        int* totalSize,
+                        std::vector<Value>* results) {
+    const auto maxBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
+    *totalSize += result.getApproximateSize();
+    uassert(4568,
+            str::stream() << "Total size of documents in " << fromNs.coll()
+                          << " matching pipeline's $lookup stage exceeds "
+                          << maxBytes
+                          << " bytes",
+
+            *totalSize <= maxBytes);
+    results->emplace_back(std::move(result));
+}
+
+/**
+ * Returns true if the foreign documents which match an equality to 'value' are exactly those
+ * holding a value equal to it on the foreign field. This excludes null, which also matches missing
+ * fields, arrays, which also match arrays as a whole, as well as regular expressions and
+ * undefined, which are not compared for equality like other values.
+ */
+bool isHashableLocalValue(const Value& value) {
+    switch (value.getType()) {
+        case jstNULL:
+        case Undefined:
+        case RegEx:
+        case Array:
+            return false;
+        default:
+            return true;
+    }
+}
+
+/**
+ * Collects the values of 'input' on 'localField' into 'values'. Returns false if the foreign
+ * documents matching 'input' cannot be found by looking up each of these values, see
+ * isHashableLocalValue(). Missing values are looked up as null, so they cannot either.
+ */
+bool getHashableLocalValues(const Document& input,
+                            const FieldPath& localField,
+                            std::vector<Value>* values) {
+    bool hashable = true;
+    document_path_support::visitAllValuesAtPath(input, localField, [&](const Value& value) {
+        hashable = hashable && isHashableLocalValue(value);
+        values->push_back(value);
+    });
+    return hashable && !values->empty();
+}
+
+/**
+ * Returns true if 'path' has a component which the matcher may treat as an array index.
+ */
+bool hasNumericComponent(const FieldPath& path) {
+    for (size_t i = 0; i < path.getPathLength(); ++i) {
+        if (str::parseUnsignedBase10Integer(path.getFieldName(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The number of partitions which the documents of a spilled hash join are split into. Each one
+// is joined on its own, so the foreign documents need to fit in memory one partition at a time.
+const size_t kNumHashJoinPartitions = 64;
+
+// The second component of the output keys [input position, foreign position] of a spilled hash
+// join which hold the input document itself rather than a foreign document it matched.
+const long long kInputDocumentKey = -1;
+const long long kLookedUpInputDocumentKey = -2;
+
+Value makeSpillKey(long long first, long long second) {
+    return Value(std::vector<Value>{Value(first), Value(second)});
+}
+
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
@@ -234,17 +328,32 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
+    // If we have not absorbed a $unwind, we cannot absorb a $match. If we have absorbed a $unwind,
+    // '_unwindSrc' would be non-null, and we would not have made it here.
+    invariant(!_matchSrc);
+
+    if ((internalDocumentSourceLookupUseHashJoin.load() && !wasConstructedWithPipelineSyntax() &&
+         !hasNumericComponent(*_foreignField)) ||
+        _hashJoinState != HashJoinState::kNotStarted) {
+        return getNextHashJoin();
+    }
+
+    const int batchSize = internalDocumentSourceLookupBatchSize.load();
+    if ((batchSize > 1 && !wasConstructedWithPipelineSyntax() &&
+         !hasNumericComponent(*_foreignField)) ||
+        !_batchedOutput.empty() || _batchEndResult) {
+        return getNextBatched(std::max(batchSize, 1));
+    }
+
     auto nextInput = pSource->getNext();
     if (!nextInput.isAdvanced()) {
         return nextInput;
     }
 
-    auto inputDoc = nextInput.releaseDocument();
-
-    // If we have not absorbed a $unwind, we cannot absorb a $match. If we have absorbed a $unwind,
-    // '_unwindSrc' would be non-null, and we would not have made it here.
-    invariant(!_matchSrc);
+    return lookUpSingle(nextInput.releaseDocument());
+}
 
+Document DocumentSourceLookUp::lookUpSingle(Document inputDoc) {
     if (!wasConstructedWithPipelineSyntax()) {
         auto matchStage =
             makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
@@ -256,17 +365,8 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
 
     std::vector<Value> results;
     int objsize = 0;
-    const auto maxBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
     while (auto result = pipeline->getNext()) {
-        objsize += result->getApproximateSize();
-        uassert(4568,
-                str::stream() << "Total size of documents in " << _fromNs.coll()
-                              << " matching pipeline's $lookup stage exceeds "
-                              << maxBytes
-                              << " bytes",
-
-                objsize <= maxBytes);
-        results.emplace_back(std::move(*result));
+        appendLookupResult(std::move(*result), _fromNs, &objsize, &results);
     }
     for (auto&& source : pipeline->getSources()) {
         if (source->usedDisk())
@@ -278,6 +378,409 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     return output.freeze();
 }
 
+DocumentSource::GetNextResult DocumentSourceLookUp::getNextBatched(size_t batchSize) {
+    if (_batchedOutput.empty() && !_batchEndResult) {
+        std::vector<Document> inputs;
+        while (inputs.size() < batchSize) {
+            auto nextInput = pSource->getNext();
+            if (!nextInput.isAdvanced()) {
+                // Report the end of the input, or the pause, once the batch has been returned.
+                _batchEndResult = std::move(nextInput);
+                break;
+            }
+            inputs.push_back(nextInput.releaseDocument());
+        }
+        lookUpBatch(std::move(inputs));
+    }
+
+    if (!_batchedOutput.empty()) {
+        Document output = std::move(_batchedOutput.front());
+        _batchedOutput.pop_front();
+        return output;
+    }
+
+    auto result = std::move(*_batchEndResult);
+    _batchEndResult = boost::none;
+    return result;
+}
+
+void DocumentSourceLookUp::lookUpBatch(std::vector<Document> inputs) {
+    // Map each local value to the inputs which hold it, in input order, using the collation of the
+    // foreign pipeline to compare them.
+    auto inputsByValue =
+        _fromExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>();
+    std::vector<bool> inBatch(inputs.size(), false);
+    BSONArrayBuilder values;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        std::vector<Value> localValues;
+        if (!getHashableLocalValues(inputs[i], *_localField, &localValues)) {
+            continue;
+        }
+
+        inBatch[i] = true;
+        for (auto&& value : localValues) {
+            auto& holders = inputsByValue[value];
+            if (holders.empty()) {
+                values << value;
+            }
+            if (holders.empty() || holders.back() != i) {
+                holders.push_back(i);
+            }
+        }
+    }
+
+    std::vector<std::vector<Value>> results(inputs.size());
+    if (!inputsByValue.empty()) {
+        // { $match: { <foreignFieldName>: { $in: <values> } } }
+        BSONObjBuilder match;
+        {
+            BSONObjBuilder query(match.subobjStart("$match"));
+            BSONObjBuilder subObj(query.subobjStart(_foreignField->fullPath()));
+            subObj << "$in" << values.arr();
+        }
+        _resolvedPipeline.back() = match.obj();
+
+        auto pipeline = buildPipeline(inputs.front());
+
+        // Each foreign document matches the inputs which hold a value equal to one of its own on
+        // the foreign field, which we collect once per input.
+        std::vector<int> sizes(inputs.size(), 0);
+        std::vector<size_t> matched;
+        std::vector<bool> isMatched(inputs.size(), false);
+        while (auto result = pipeline->getNext()) {
+            document_path_support::visitAllValuesAtPath(
+                *result, *_foreignField, [&](const Value& value) {
+                    auto it = inputsByValue.find(value);
+                    if (it == inputsByValue.end()) {
+                        return;
+                    }
+                    for (auto i : it->second) {
+                        if (!isMatched[i]) {
+                            isMatched[i] = true;
+                            matched.push_back(i);
+                        }
+                    }
+                });
+            for (auto i : matched) {
+                isMatched[i] = false;
+                appendLookupResult(*result, _fromNs, &sizes[i], &results[i]);
+            }
+            matched.clear();
+        }
+        for (auto&& source : pipeline->getSources()) {
+            if (source->usedDisk())
+                _usedDisk = true;
+        }
+    }
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!inBatch[i]) {
+            _batchedOutput.push_back(lookUpSingle(std::move(inputs[i])));
+            continue;
+        }
+        MutableDocument output(std::move(inputs[i]));
+        output.setNestedField(_as, Value(std::move(results[i])));
+        _batchedOutput.push_back(output.freeze());
+    }
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::getNextHashJoin() {
+    if (_hashJoinState == HashJoinState::kNotStarted) {
+        buildHashTable();
+    }
+
+    switch (_hashJoinState) {
+        case HashJoinState::kProbing: {
+            auto nextInput = pSource->getNext();
+            if (!nextInput.isAdvanced()) {
+                return nextInput;
+            }
+            std::vector<Value> localValues;
+            if (!getHashableLocalValues(nextInput.getDocument(), *_localField, &localValues)) {
+                return lookUpSingle(nextInput.releaseDocument());
+            }
+            return probeHashTable(nextInput.releaseDocument(), localValues);
+        }
+        case HashJoinState::kSpilled: {
+            auto inputEnd = joinSpilledPartitions();
+            if (!inputEnd.isEOF()) {
+                return inputEnd;
+            }
+            return nextSpilledHashJoinOutput();
+        }
+        case HashJoinState::kReturningSpilled:
+            return nextSpilledHashJoinOutput();
+        case HashJoinState::kAbandoned: {
+            auto nextInput = pSource->getNext();
+            if (!nextInput.isAdvanced()) {
+                return nextInput;
+            }
+            return lookUpSingle(nextInput.releaseDocument());
+        }
+        case HashJoinState::kNotStarted:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void DocumentSourceLookUp::buildHashTable() {
+    const size_t maxMemoryBytes = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    const bool canSpill = pExpCtx->allowDiskUse && !pExpCtx->inMongos;
+
+    // Read the whole foreign collection, through the view pipeline if there is one.
+    _resolvedPipeline.back() = BSON("$match" << BSONObj());
+    auto pipeline = buildPipeline(Document());
+
+    _hashTable.emplace(
+        _fromExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>());
+    _hashJoinState = HashJoinState::kProbing;
+    size_t memoryBytes = 0;
+    long long foreignSeq = 0;
+    while (auto result = pipeline->getNext()) {
+        const long long seq = foreignSeq++;
+        if (_hashJoinState == HashJoinState::kSpilled) {
+            spillForeignDocument(seq, *result);
+            continue;
+        }
+
+        bool hasValues = false;
+        document_path_support::visitAllValuesAtPath(
+            *result, *_foreignField, [&](const Value& value) {
+                auto& docs = (*_hashTable)[value];
+                if (docs.empty() || docs.back() != _hashTableDocs.size()) {
+                    docs.push_back(_hashTableDocs.size());
+                }
+                hasValues = true;
+            });
+        if (!hasValues) {
+            // No input document with hashable local values can match this one.
+            continue;
+        }
+        memoryBytes += result->getApproximateSize();
+        _hashTableDocs.push_back(std::move(*result));
+
+        if (memoryBytes <= maxMemoryBytes) {
+            continue;
+        }
+        if (!canSpill) {
+            // Look up each input document on its own instead, which needs no memory for the
+            // foreign documents.
+            _hashJoinState = HashJoinState::kAbandoned;
+            break;
+        }
+
+        // Move the foreign documents we have read so far to disk. Their positions only need to
+        // preserve the order in which the foreign pipeline returned them.
+        SortOptions opts;
+        opts.maxMemoryUsageBytes = maxMemoryBytes;
+        opts.extSortAllowed = true;
+        opts.tempDir = pExpCtx->tempDir;
+        auto comparator = [](const Sorter<Value, Document>::Data& lhs,
+                             const Sorter<Value, Document>::Data& rhs) {
+            return Value::compare(lhs.first, rhs.first, nullptr);
+        };
+        _buildSorter.reset(Sorter<Value, Document>::make(opts, comparator));
+        _probeSorter.reset(Sorter<Value, Document>::make(opts, comparator));
+        _outputSorter.reset(Sorter<Value, Document>::make(opts, comparator));
+        for (size_t i = 0; i < _hashTableDocs.size(); ++i) {
+            spillForeignDocument(i, _hashTableDocs[i]);
+        }
+        foreignSeq = _hashTableDocs.size();
+        _hashTable->clear();
+        _hashTableDocs.clear();
+        _hashJoinState = HashJoinState::kSpilled;
+    }
+
+    for (auto&& source : pipeline->getSources()) {
+        if (source->usedDisk())
+            _usedDisk = true;
+    }
+
+    if (_hashJoinState != HashJoinState::kProbing) {
+        _hashTable = boost::none;
+        _hashTableDocs.clear();
+    }
+}
+
+void DocumentSourceLookUp::spillForeignDocument(long long foreignSeq, const Document& foreignDoc) {
+    const auto& valueCmp = _fromExpCtx->getValueComparator();
+    std::vector<bool> partitions(kNumHashJoinPartitions, false);
+    document_path_support::visitAllValuesAtPath(
+        foreignDoc, *_foreignField, [&](const Value& value) {
+            partitions[valueCmp.hash(value) % kNumHashJoinPartitions] = true;
+        });
+    for (size_t p = 0; p < kNumHashJoinPartitions; ++p) {
+        if (partitions[p]) {
+            _buildSorter->add(makeSpillKey(static_cast<long long>(p), foreignSeq), foreignDoc);
+        }
+    }
+}
+
+Document DocumentSourceLookUp::probeHashTable(Document input,
+                                              const std::vector<Value>& localValues) {
+    // Return the matches in the order in which the foreign pipeline returned them, each only once
+    // however many of the local values it holds.
+    std::vector<size_t> matches;
+    for (auto&& value : localValues) {
+        auto it = _hashTable->find(value);
+        if (it != _hashTable->end()) {
+            matches.insert(matches.end(), it->second.begin(), it->second.end());
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+    matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+
+    std::vector<Value> results;
+    int objsize = 0;
+    for (auto i : matches) {
+        appendLookupResult(_hashTableDocs[i], _fromNs, &objsize, &results);
+    }
+
+    MutableDocument output(std::move(input));
+    output.setNestedField(_as, Value(std::move(results)));
+    return output.freeze();
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::joinSpilledPartitions() {
+    const auto& valueCmp = _fromExpCtx->getValueComparator();
+
+    // Spill each input document to the partitions of its local values, along with those values.
+    // The output is reassembled in input order from '_outputSorter'.
+    auto nextInput = pSource->getNext();
+    for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
+        const long long seq = _numHashJoinInputs++;
+        auto input = nextInput.releaseDocument();
+        std::vector<Value> localValues;
+        if (!getHashableLocalValues(input, *_localField, &localValues)) {
+            _outputSorter->add(makeSpillKey(seq, kLookedUpInputDocumentKey),
+                               lookUpSingle(std::move(input)));
+            continue;
+        }
+
+        std::vector<std::vector<Value>> valuesByPartition(kNumHashJoinPartitions);
+        for (auto&& value : localValues) {
+            valuesByPartition[valueCmp.hash(value) % kNumHashJoinPartitions].push_back(value);
+        }
+        for (size_t p = 0; p < kNumHashJoinPartitions; ++p) {
+            if (!valuesByPartition[p].empty()) {
+                _probeSorter->add(makeSpillKey(static_cast<long long>(p), seq),
+                                  Document{{"v", Value(std::move(valuesByPartition[p]))}});
+            }
+        }
+        _outputSorter->add(makeSpillKey(seq, kInputDocumentKey), input);
+    }
+    if (!nextInput.isEOF()) {
+        return nextInput;
+    }
+
+    // Join one partition at a time. Both sorters return their documents by partition, and within
+    // a partition by position.
+    std::unique_ptr<Sorter<Value, Document>::Iterator> buildIt(_buildSorter->done());
+    std::unique_ptr<Sorter<Value, Document>::Iterator> probeIt(_probeSorter->done());
+    _usedDisk = _usedDisk || _buildSorter->usedDisk() || _probeSorter->usedDisk();
+    boost::optional<Sorter<Value, Document>::Data> nextBuild;
+    if (buildIt->more()) {
+        nextBuild = buildIt->next();
+    }
+
+    auto partitionTable = valueCmp.makeUnorderedValueMap<std::vector<size_t>>();
+    std::vector<std::pair<long long, Document>> partitionDocs;
+    long long loadedPartition = -1;
+    while (probeIt->more()) {
+        auto probe = probeIt->next();
+        const long long partition = probe.first[0].getLong();
+        if (partition != loadedPartition) {
+            // Load the foreign documents of this partition, skipping those of the partitions
+            // without any input document.
+            partitionTable.clear();
+            partitionDocs.clear();
+            for (; nextBuild && nextBuild->first[0].getLong() <= partition;
+                 nextBuild = buildIt->more() ? buildIt->next()
+                                             : boost::optional<Sorter<Value, Document>::Data>()) {
+                if (nextBuild->first[0].getLong() < partition) {
+                    continue;
+                }
+                document_path_support::visitAllValuesAtPath(
+                    nextBuild->second, *_foreignField, [&](const Value& value) {
+                        if (static_cast<long long>(valueCmp.hash(value) %
+                                                   kNumHashJoinPartitions) != partition) {
+                            return;
+                        }
+                        auto& docs = partitionTable[value];
+                        if (docs.empty() || docs.back() != partitionDocs.size()) {
+                            docs.push_back(partitionDocs.size());
+                        }
+                    });
+                partitionDocs.emplace_back(nextBuild->first[1].getLong(), nextBuild->second);
+            }
+            loadedPartition = partition;
+        }
+
+        const long long seq = probe.first[1].getLong();
+        for (auto&& value : probe.second["v"].getArray()) {
+            auto it = partitionTable.find(value);
+            if (it == partitionTable.end()) {
+                continue;
+            }
+            for (auto i : it->second) {
+                _outputSorter->add(makeSpillKey(seq, partitionDocs[i].first),
+                                   partitionDocs[i].second);
+            }
+        }
+    }
+
+    _outputIterator.reset(_outputSorter->done());
+    _usedDisk = _usedDisk || _outputSorter->usedDisk();
+    _buildSorter.reset();
+    _probeSorter.reset();
+    _outputSorter.reset();
+    if (_outputIterator->more()) {
+        _nextOutputEntry = _outputIterator->next();
+    }
+    _hashJoinState = HashJoinState::kReturningSpilled;
+    return nextInput;
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::nextSpilledHashJoinOutput() {
+    if (!_nextOutputEntry) {
+        _outputIterator.reset();
+        return GetNextResult::makeEOF();
+    }
+
+    // Each input document comes first among the entries of its position, followed by its matches
+    // in the order of the foreign pipeline.
+    auto entry = std::move(*_nextOutputEntry);
+    _nextOutputEntry = boost::none;
+    if (_outputIterator->more()) {
+        _nextOutputEntry = _outputIterator->next();
+    }
+    const long long seq = entry.first[0].getLong();
+    if (entry.first[1].getLong() == kLookedUpInputDocumentKey) {
+        return std::move(entry.second);
+    }
+    invariant(entry.first[1].getLong() == kInputDocumentKey);
+
+    std::vector<Value> results;
+    int objsize = 0;
+    long long lastForeignSeq = kInputDocumentKey;
+    while (_nextOutputEntry && _nextOutputEntry->first[0].getLong() == seq) {
+        // A foreign document is reported once for each partition its values and ours share.
+        const long long foreignSeq = _nextOutputEntry->first[1].getLong();
+        if (foreignSeq != lastForeignSeq) {
+            appendLookupResult(std::move(_nextOutputEntry->second), _fromNs, &objsize, &results);
+            lastForeignSeq = foreignSeq;
+        }
+        _nextOutputEntry = boost::none;
+        if (_outputIterator->more()) {
+            _nextOutputEntry = _outputIterator->next();
+        }
+    }
+
+    MutableDocument output(std::move(entry.second));
+    output.setNestedField(_as, Value(std::move(results)));
+    return output.freeze();
+}
+
 std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
     const Document& inputDoc) {
     // Copy all 'let' variables into the foreign pipeline's expression context.
@@ -465,6 +968,13 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _hashTable = boost::none;
+    _hashTableDocs.clear();
+    _buildSorter.reset();
+    _probeSorter.reset();
+    _outputSorter.reset();
+    _outputIterator.reset();
+    _nextOutputEntry = boost::none;
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -879,3 +1389,6 @@ void DocumentSourceLookUp::addInvolvedCollections(
 }
 
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -39,6 +40,7 @@
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -262,6 +264,64 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Looks up the foreign documents matching 'inputDoc' with a sub-pipeline of its own, and
+     * returns 'inputDoc' with the matches added under the 'as' field.
+     */
+    Document lookUpSingle(Document inputDoc);
+
+    /**
+     * Returns the next output document, looking the input documents up in batches of up to
+     * 'batchSize'. Only used for the localField/foreignField syntax without an absorbed $unwind.
+     */
+    GetNextResult getNextBatched(size_t batchSize);
+
+    /**
+     * Looks up the foreign documents matching each of 'inputs' with a single query for all of
+     * their local values, and appends the output documents to '_batchedOutput' in input order.
+     * Inputs with a local value which the matches could not be assigned by are looked up with
+     * lookUpSingle() instead.
+     */
+    void lookUpBatch(std::vector<Document> inputs);
+
+    /**
+     * Returns the next output document of a hash join, which reads the foreign pipeline once and
+     * matches the input documents against its documents by the values of their join fields. Only
+     * used for the localField/foreignField syntax without an absorbed $unwind.
+     */
+    GetNextResult getNextHashJoin();
+
+    /**
+     * Reads the whole foreign pipeline into '_hashTable'. Once the foreign documents exceed the
+     * memory limit, they are spilled into '_buildSorter' instead, or the hash join is abandoned if
+     * we may not spill.
+     */
+    void buildHashTable();
+
+    /**
+     * Adds 'foreignDoc', the 'foreignSeq'th document returned by the foreign pipeline, to
+     * '_buildSorter' once for each partition of its values on the foreign field.
+     */
+    void spillForeignDocument(long long foreignSeq, const Document& foreignDoc);
+
+    /**
+     * Returns 'input' with the foreign documents of the in-memory '_hashTable' which hold one of
+     * 'localValues' added under the 'as' field.
+     */
+    Document probeHashTable(Document input, const std::vector<Value>& localValues);
+
+    /**
+     * Reads the rest of the input into '_probeSorter' and '_outputSorter', then joins the spilled
+     * foreign and input documents one partition at a time. Returns the result which ended the
+     * input, which is either EOF or a pause, in which case this must be called again.
+     */
+    GetNextResult joinSpilledPartitions();
+
+    /**
+     * Returns the next output document of a spilled hash join, in input order.
+     */
+    GetNextResult nextSpilledHashJoinOutput();
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -344,6 +404,41 @@ private:
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+
+    // The output documents of the last batch which have yet to be returned, followed by the
+    // result which ended that batch early, if any. Only used by getNextBatched().
+    std::deque<Document> _batchedOutput;
+    boost::optional<GetNextResult> _batchEndResult;
+
+    // The progress of a hash join, see getNextHashJoin().
+    enum class HashJoinState {
+        kNotStarted,
+        // The foreign documents fit in '_hashTable', and the input is matched against it as it
+        // streams through.
+        kProbing,
+        // The foreign documents were spilled, so the input is spilled as well.
+        kSpilled,
+        kReturningSpilled,
+        // The foreign documents did not fit in memory, and may not be spilled. The input is looked
+        // up one document at a time.
+        kAbandoned,
+    };
+    HashJoinState _hashJoinState = HashJoinState::kNotStarted;
+
+    // Maps each value of the foreign field to the positions in '_hashTableDocs' of the foreign
+    // documents which hold it, in the order in which the foreign pipeline returned them.
+    boost::optional<ValueUnorderedMap<std::vector<size_t>>> _hashTable;
+    std::vector<Document> _hashTableDocs;
+
+    // Only used once the hash join has spilled. The foreign and the input documents are sorted by
+    // the partition of their join values and their position, kept as an array [partition,
+    // position]. The output is assembled from '_outputSorter', sorted by input position.
+    std::unique_ptr<Sorter<Value, Document>> _buildSorter;
+    std::unique_ptr<Sorter<Value, Document>> _probeSorter;
+    std::unique_ptr<Sorter<Value, Document>> _outputSorter;
+    std::unique_ptr<Sorter<Value, Document>::Iterator> _outputIterator;
+    boost::optional<Sorter<Value, Document>::Data> _nextOutputEntry;
+    long long _numHashJoinInputs = 0;
 };
 
 }  // namespace mongo
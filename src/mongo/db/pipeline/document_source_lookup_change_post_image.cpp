@@ -31,7 +31,10 @@
 
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 
+#include <map>
+
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace mongo {
 
@@ -59,6 +62,12 @@ Value assertFieldHasType(const Document& fullDoc, StringData fieldName, BSONType
 DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::getNext() {
     pExpCtx->checkForInterrupt();
 
+    // Lookups from mongos each carry the read concern of their own event, so are not batched.
+    const int batchSize = internalDocumentSourceLookupChangePostImageBatchSize.load();
+    if ((batchSize > 1 && !pExpCtx->inMongos) || !_batchedOutput.empty() || _batchEndResult) {
+        return getNextBatched(std::max(batchSize, 1));
+    }
+
     auto input = pSource->getNext();
     if (!input.isAdvanced()) {
         return input;
@@ -74,6 +83,101 @@ DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::getNext() {
     return output.freeze();
 }
 
+DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::getNextBatched(
+    size_t batchSize) {
+    if (_batchedOutput.empty() && !_batchEndResult) {
+        std::vector<Document> events;
+        while (events.size() < batchSize) {
+            auto input = pSource->getNext();
+            if (!input.isAdvanced()) {
+                // Report the end of the input, or the pause, once the batch has been returned.
+                _batchEndResult = std::move(input);
+                break;
+            }
+            events.push_back(input.releaseDocument());
+
+            // The stages before this one close the cursor on the next call after an invalidate,
+            // so it ends the batch.
+            auto opTypeVal = assertFieldHasType(
+                events.back(), DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
+            if (opTypeVal.getString() == DocumentSourceChangeStream::kInvalidateOpType) {
+                break;
+            }
+        }
+        lookupPostImageBatch(std::move(events));
+    }
+
+    if (!_batchedOutput.empty()) {
+        Document output = std::move(_batchedOutput.front());
+        _batchedOutput.pop_front();
+        return output;
+    }
+
+    auto result = std::move(*_batchEndResult);
+    _batchEndResult = boost::none;
+    return result;
+}
+
+void DocumentSourceLookupChangePostImage::lookupPostImageBatch(std::vector<Document> events) {
+    struct CollectionBatch {
+        NamespaceString nss;
+        std::vector<size_t> positions;
+        std::vector<Value> ids;
+    };
+    std::map<UUID, CollectionBatch> batchesByUuid;
+    std::vector<Value> postImages(events.size());
+
+    for (size_t i = 0; i < events.size(); ++i) {
+        const Document& event = events[i];
+        auto opTypeVal = assertFieldHasType(
+            event, DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
+        if (opTypeVal.getString() != DocumentSourceChangeStream::kUpdateOpType) {
+            continue;
+        }
+
+        auto nss = assertValidNamespace(event);
+        auto documentKey =
+            assertFieldHasType(
+                event, DocumentSourceChangeStream::kDocumentKeyField, BSONType::Object)
+                .getDocument();
+        auto resumeToken =
+            ResumeToken::parse(event[DocumentSourceChangeStream::kIdField].getDocument());
+        invariant(resumeToken.getData().uuid);
+
+        // A document key with fields besides the _id needs all of them to identify the document.
+        if (documentKey.size() != 1 || documentKey["_id"].missing()) {
+            postImages[i] = lookupPostImage(event);
+            continue;
+        }
+
+        auto& batch = batchesByUuid[*resumeToken.getData().uuid];
+        batch.nss = nss;
+        batch.positions.push_back(i);
+        batch.ids.push_back(documentKey["_id"]);
+    }
+
+    for (auto&& uuidAndBatch : batchesByUuid) {
+        const CollectionBatch& batch = uuidAndBatch.second;
+        auto lookedUpDocs = pExpCtx->mongoProcessInterface->lookupDocumentsById(
+            pExpCtx, batch.nss, uuidAndBatch.first, batch.ids);
+        invariant(lookedUpDocs.size() == batch.positions.size());
+        for (size_t j = 0; j < lookedUpDocs.size(); ++j) {
+            postImages[batch.positions[j]] =
+                lookedUpDocs[j] ? Value(std::move(*lookedUpDocs[j])) : Value(BSONNULL);
+        }
+    }
+
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (postImages[i].missing()) {
+            _batchedOutput.push_back(std::move(events[i]));
+            continue;
+        }
+        MutableDocument output(std::move(events[i]));
+        output[kFullDocumentFieldName] = std::move(postImages[i]);
+        _batchedOutput.push_back(output.freeze());
+    }
+}
+
 NamespaceString DocumentSourceLookupChangePostImage::assertValidNamespace(
     const Document& inputDoc) const {
     auto namespaceObject =
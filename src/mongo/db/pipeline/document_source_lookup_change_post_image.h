@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 
@@ -119,12 +121,30 @@ private:
      */
     Value lookupPostImage(const Document& updateOp) const;
 
+    /**
+     * Returns the next change event, reading ahead up to 'batchSize' of the events which the
+     * source has available and looking up their post-images together.
+     */
+    GetNextResult getNextBatched(size_t batchSize);
+
+    /**
+     * Looks up the post-images of the update events in 'events', using a single query on _id for
+     * all those in the same collection whose document key is just an _id, and appends the events
+     * to '_batchedOutput' in order.
+     */
+    void lookupPostImageBatch(std::vector<Document> events);
+
     /**
      * Throws a AssertionException if the namespace found in 'inputDoc' doesn't match the one on the
      * ExpressionContext. If the namespace on the ExpressionContext is 'collectionless', then this
      * function verifies that the only the database names match.
      */
     NamespaceString assertValidNamespace(const Document& inputDoc) const;
+
+    // The events read ahead by getNextBatched() whose post-images have been looked up, and the
+    // result which ended that batch early, if any.
+    std::deque<Document> _batchedOutput;
+    boost::optional<GetNextResult> _batchEndResult;
 };
 
 }  // namespace mongo
@@ -45,6 +45,7 @@
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface_lookup_single_document.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace mongo {
 namespace {
@@ -324,5 +325,70 @@ TEST_F(DocumentSourceLookupChangePostImageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceLookupChangePostImageTest, BatchedLookupShouldLookUpEachPostImage) {
+    const auto oldBatchSize = internalDocumentSourceLookupChangePostImageBatchSize.load();
+    internalDocumentSourceLookupChangePostImageBatchSize.store(10);
+
+    auto expCtx = getExpCtx();
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    const Document ns{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}};
+    auto makeUpdate = [&](int id) {
+        return Document{{"_id", makeResumeToken(id)},
+                        {"documentKey", Document{{"_id", id}}},
+                        {"operationType", "update"_sd},
+                        {"ns", ns}};
+    };
+    auto withPostImage = [](Document event, Value postImage) {
+        MutableDocument output(std::move(event));
+        output["fullDocument"] = std::move(postImage);
+        return output.freeze();
+    };
+    const Document insert{{"_id", makeResumeToken(5)},
+                          {"documentKey", Document{{"_id", 5}}},
+                          {"operationType", "insert"_sd},
+                          {"ns", ns},
+                          {"fullDocument", Document{{"_id", 5}}}};
+
+    // Mock its input with updates on either side of an insert and of a pause, including two
+    // updates of the same document and an update of a document which has since been deleted.
+    auto mockLocalSource = DocumentSourceMock::createForTest(
+        deque<DocumentSource::GetNextResult>{makeUpdate(0),
+                                             Document(insert),
+                                             makeUpdate(1),
+                                             makeUpdate(2),
+                                             makeUpdate(1),
+                                             DocumentSource::GetNextResult::makePauseExecution(),
+                                             makeUpdate(0)});
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}, {"x", 0}},
+                                                             Document{{"_id", 1}, {"x", 1}}};
+    getExpCtx()->mongoProcessInterface =
+        std::make_unique<MockMongoInterface>(std::move(mockForeignContents));
+
+    const Value postImage0(Document{{"_id", 0}, {"x", 0}});
+    const Value postImage1(Document{{"_id", 1}, {"x", 1}});
+    for (auto&& expected : {withPostImage(makeUpdate(0), postImage0),
+                            insert,
+                            withPostImage(makeUpdate(1), postImage1),
+                            withPostImage(makeUpdate(2), Value(BSONNULL)),
+                            withPostImage(makeUpdate(1), postImage1)}) {
+        auto next = lookupChangeStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(), expected);
+    }
+
+    ASSERT_TRUE(lookupChangeStage->getNext().isPaused());
+
+    auto next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), withPostImage(makeUpdate(0), postImage0));
+
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+    internalDocumentSourceLookupChangePostImageBatchSize.store(oldBatchSize);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -48,6 +48,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/unittest/temp_dir.h"
 
 namespace mongo {
 namespace {
@@ -649,6 +650,227 @@ TEST_F(DocumentSourceLookUpTest, ShouldPropagatePausesWhileUnwinding) {
     lookup->dispose();
 }
 
+TEST_F(DocumentSourceLookUpTest, BatchedLookupGivesEachInputItsOwnMatches) {
+    const auto oldBatchSize = internalDocumentSourceLookupBatchSize.load();
+    internalDocumentSourceLookupBatchSize.store(10);
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "key"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    // The null and missing local values cannot be looked up with the others, since they also
+    // match the foreign documents which lack the foreign field.
+    const Document oneAndTwo{{"foreignId", vector<Value>{Value(1), Value(2)}}};
+    auto mockLocalSource = DocumentSourceMock::createForTest({Document{{"foreignId", 0}},
+                                                              Document(oneAndTwo),
+                                                              Document{{"foreignId", 1LL}},
+                                                              Document{{"foreignId", BSONNULL}},
+                                                              Document{{"other", 1}},
+                                                              Document{{"foreignId", 3}}});
+    lookup->setSource(mockLocalSource.get());
+
+    const Document keyZero{{"key", 0}};
+    const Document keyArray{{"key", vector<Value>{Value(1), Value(2)}}};
+    const Document keyOne{{"key", 1.0}};
+    const Document noKey{{"other", 0}};
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(
+        deque<DocumentSource::GetNextResult>{
+            Document(keyZero), Document(keyArray), Document(keyOne), Document(noKey)});
+
+    auto assertNextMatches = [&](const Document& input, vector<Value> matches) {
+        auto next = lookup->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        MutableDocument expected(input);
+        expected.addField("foreignDocs", Value(std::move(matches)));
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(), expected.freeze());
+    };
+    assertNextMatches(Document{{"foreignId", 0}}, {Value(keyZero)});
+    assertNextMatches(oneAndTwo, {Value(keyArray), Value(keyOne)});
+    assertNextMatches(Document{{"foreignId", 1LL}}, {Value(keyArray), Value(keyOne)});
+    assertNextMatches(Document{{"foreignId", BSONNULL}}, {Value(noKey)});
+    assertNextMatches(Document{{"other", 1}}, {Value(noKey)});
+    assertNextMatches(Document{{"foreignId", 3}}, {});
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+    internalDocumentSourceLookupBatchSize.store(oldBatchSize);
+}
+
+TEST_F(DocumentSourceLookUpTest, BatchedLookupShouldPropagatePauses) {
+    const auto oldBatchSize = internalDocumentSourceLookupBatchSize.load();
+    internalDocumentSourceLookupBatchSize.store(10);
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "_id"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    // A pause ends the batch early, and is returned once the batch has been.
+    auto mockLocalSource =
+        DocumentSourceMock::createForTest({Document{{"foreignId", 0}},
+                                           Document{{"foreignId", 1}},
+                                           DocumentSource::GetNextResult::makePauseExecution(),
+                                           Document{{"foreignId", 1}}});
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}},
+                                                             Document{{"_id", 1}}};
+    expCtx->mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 0}, {"foreignDocs", vector<Value>{Value(Document{{"_id", 0}})}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 1}, {"foreignDocs", vector<Value>{Value(Document{{"_id", 1}})}}}));
+
+    ASSERT_TRUE(lookup->getNext().isPaused());
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 1}, {"foreignDocs", vector<Value>{Value(Document{{"_id", 1}})}}}));
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+    internalDocumentSourceLookupBatchSize.store(oldBatchSize);
+}
+
+/**
+ * Runs a $lookup on "foreignId" against "key" over the given inputs, and checks that each is
+ * returned with its matches in the order in which the foreign collection holds them.
+ */
+void assertHashJoinFindsEachInputsMatches(const intrusive_ptr<ExpressionContext>& expCtx) {
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "key"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    // The null and missing local values are looked up on their own, since they also match the
+    // foreign documents which lack the foreign field.
+    const Document oneAndTwo{{"foreignId", vector<Value>{Value(1), Value(2)}}};
+    auto mockLocalSource =
+        DocumentSourceMock::createForTest({Document{{"foreignId", 0}},
+                                           Document(oneAndTwo),
+                                           DocumentSource::GetNextResult::makePauseExecution(),
+                                           Document{{"foreignId", 1LL}},
+                                           Document{{"foreignId", BSONNULL}},
+                                           Document{{"other", 1}},
+                                           Document{{"foreignId", 3}}});
+    lookup->setSource(mockLocalSource.get());
+
+    const Document keyZero{{"key", 0}};
+    const Document keyArray{{"key", vector<Value>{Value(1), Value(2)}}};
+    const Document keyOne{{"key", 1.0}};
+    const Document noKey{{"other", 0}};
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(
+        deque<DocumentSource::GetNextResult>{
+            Document(keyZero), Document(keyArray), Document(keyOne), Document(noKey)});
+
+    // Once the foreign documents are spilled, the whole input is read before any of it is
+    // returned, so the pause comes first.
+    const bool spills = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load() == 0 &&
+        expCtx->allowDiskUse;
+    auto assertNextMatches = [&](const Document& input, vector<Value> matches) {
+        auto next = lookup->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        MutableDocument expected(input);
+        expected.addField("foreignDocs", Value(std::move(matches)));
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(), expected.freeze());
+    };
+    if (spills) {
+        ASSERT_TRUE(lookup->getNext().isPaused());
+    }
+    assertNextMatches(Document{{"foreignId", 0}}, {Value(keyZero)});
+    assertNextMatches(oneAndTwo, {Value(keyArray), Value(keyOne)});
+    if (!spills) {
+        ASSERT_TRUE(lookup->getNext().isPaused());
+    }
+    assertNextMatches(Document{{"foreignId", 1LL}}, {Value(keyArray), Value(keyOne)});
+    assertNextMatches(Document{{"foreignId", BSONNULL}}, {Value(noKey)});
+    assertNextMatches(Document{{"other", 1}}, {Value(noKey)});
+    assertNextMatches(Document{{"foreignId", 3}}, {});
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    ASSERT_EQ(spills, lookup->usedDisk());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinLookupGivesEachInputItsOwnMatches) {
+    const auto oldUseHashJoin = internalDocumentSourceLookupUseHashJoin.load();
+    internalDocumentSourceLookupUseHashJoin.store(true);
+
+    assertHashJoinFindsEachInputsMatches(getExpCtx());
+
+    internalDocumentSourceLookupUseHashJoin.store(oldUseHashJoin);
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinLookupSpillsToDiskBeyondMemoryLimit) {
+    const auto oldUseHashJoin = internalDocumentSourceLookupUseHashJoin.load();
+    const auto oldMaxMemoryBytes = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    internalDocumentSourceLookupUseHashJoin.store(true);
+    internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(0);
+
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceLookUpTest");
+    expCtx->allowDiskUse = true;
+    expCtx->tempDir = tempDir.path();
+    assertHashJoinFindsEachInputsMatches(expCtx);
+
+    internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(oldMaxMemoryBytes);
+    internalDocumentSourceLookupUseHashJoin.store(oldUseHashJoin);
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinLookupFallsBackToQueriesBeyondMemoryLimitWithoutDiskUse) {
+    const auto oldUseHashJoin = internalDocumentSourceLookupUseHashJoin.load();
+    const auto oldMaxMemoryBytes = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    internalDocumentSourceLookupUseHashJoin.store(true);
+    internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(0);
+
+    auto expCtx = getExpCtx();
+    expCtx->allowDiskUse = false;
+    assertHashJoinFindsEachInputsMatches(expCtx);
+
+    internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(oldMaxMemoryBytes);
+    internalDocumentSourceLookupUseHashJoin.store(oldUseHashJoin);
+}
+
 TEST_F(DocumentSourceLookUpTest, LookupReportsAsFieldIsModified) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
@@ -43,6 +43,7 @@
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -86,6 +87,14 @@ DocumentSource::GetNextResult DocumentSourceMatch::getNext() {
     // The user facing error should have been generated earlier.
     massert(17309, "Should never call getNext on a $match stage with $text clause", !_isTextQuery);
 
+    if (!_triedToCompile) {
+        // The expression is not rewritten once the stage starts returning results.
+        _triedToCompile = true;
+        if (internalQueryCompileMatchExpressions.load()) {
+            _compiledExpression = CompiledMatchExpression::compile(_expression.get());
+        }
+    }
+
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
         // MatchExpression only takes BSON documents, so we have to make one. As an optimization,
@@ -95,7 +104,8 @@ DocumentSource::GetNextResult DocumentSourceMatch::getNext() {
             : document_path_support::documentToBsonWithPaths(nextInput.getDocument(),
                                                              _dependencies.fields);
 
-        if (_expression->matchesBSON(toMatch)) {
+        if (_compiledExpression ? _compiledExpression->matchesBSON(toMatch)
+                                : _expression->matchesBSON(toMatch)) {
             return nextInput;
         }
 
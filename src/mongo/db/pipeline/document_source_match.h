@@ -33,6 +33,7 @@
 #include <utility>
 
 #include "mongo/client/connpool.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/pipeline/document_source.h"
 
@@ -178,6 +179,11 @@ protected:
 private:
     std::unique_ptr<MatchExpression> _expression;
 
+    // Compiled from '_expression' by the first call to getNext(), if
+    // 'internalQueryCompileMatchExpressions' is enabled and the expression can be compiled.
+    std::unique_ptr<CompiledMatchExpression> _compiledExpression;
+    bool _triedToCompile = false;
+
     bool _isTextQuery;
 
     // Cache the dependencies so that we know what fields we need to serialize to BSON for matching.
@@ -33,9 +33,11 @@
 
 #include "mongo/db/pipeline/document_source_merge.h"
 
+#include <algorithm>
 #include <fmt/format.h>
 #include <map>
 
+#include "mongo/bson/bsonobj_comparator.h"
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/pipeline/document_path_support.h"
@@ -468,6 +470,14 @@ std::pair<DocumentSourceMerge::BatchObject, int> DocumentSourceMerge::makeBatchO
     return {{std::move(mergeOnFields), std::move(mod), std::move(vars)}, modSize};
 }
 
+void DocumentSourceMerge::sortBatchByMergeOnFields(BatchedObjects* batch) const {
+    const BSONObjComparator comparator(
+        BSONObj(), BSONObjComparator::FieldNamesMode::kConsider, pExpCtx->getCollator());
+    std::stable_sort(batch->begin(), batch->end(), [&](const auto& lhs, const auto& rhs) {
+        return comparator.evaluate(std::get<BSONObj>(lhs) < std::get<BSONObj>(rhs));
+    });
+}
+
 void DocumentSourceMerge::waitWhileFailPointEnabled() {
     CurOpFailpointHelpers::waitWhileFailPointEnabled(
         &hangWhileBuildingDocumentSourceMergeBatch,
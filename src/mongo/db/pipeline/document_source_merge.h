@@ -186,8 +186,15 @@ private:
         return bob.obj();
     }
 
+    /**
+     * Sorts 'batch' by the merge 'on' fields, so that successive writes find their documents
+     * near each other in the unique index. Writes with the same key keep their order.
+     */
+    void sortBatchByMergeOnFields(BatchedObjects* batch) const;
+
     void spill(BatchedObjects&& batch) override {
         DocumentSourceWriteBlock writeBlock(pExpCtx->opCtx);
+        sortBatchByMergeOnFields(&batch);
 
         try {
             auto targetEpoch = _targetCollectionVersion
@@ -0,0 +1,232 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_parallel_exchange.h"
+
+#include "mongo/db/client.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+constexpr StringData DocumentSourceParallelExchange::kStageName;
+
+namespace {
+
+// The consumers stop running ahead of getNext() once this many of their results are waiting.
+const size_t kMaxBufferedResults = 1024;
+
+}  // namespace
+
+boost::intrusive_ptr<DocumentSourceParallelExchange> DocumentSourceParallelExchange::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> pipelines) {
+    return new DocumentSourceParallelExchange(expCtx, std::move(pipelines));
+}
+
+DocumentSourceParallelExchange::DocumentSourceParallelExchange(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> pipelines)
+    : DocumentSource(expCtx) {
+    invariant(!pipelines.empty());
+    _consumerPipeline = pipelines.front()->serialize();
+    for (auto&& pipeline : pipelines) {
+        invariant(pipeline->getContext() != expCtx);
+        auto consumer = std::make_unique<Consumer>();
+        consumer->pipeline = std::move(pipeline);
+        _consumers.push_back(std::move(consumer));
+    }
+}
+
+void DocumentSourceParallelExchange::startConsumers() {
+    ServiceContext* serviceContext = pExpCtx->opCtx->getServiceContext();
+    for (size_t i = 0; i < _consumers.size(); ++i) {
+        Consumer* consumer = _consumers[i].get();
+        consumer->client =
+            serviceContext->makeClient(str::stream() << "parallelExchangeConsumer-" << i);
+        consumer->opCtx = consumer->client->makeOperationContext();
+        consumer->pipeline->detachFromOperationContext();
+    }
+
+    ThreadPool::Options options;
+    options.poolName = "ParallelExchange";
+    options.threadNamePrefix = "parallelExchange-";
+    options.minThreads = 0;
+    options.maxThreads = _consumers.size();
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName.c_str());
+    };
+    _pool = std::make_unique<ThreadPool>(options);
+    _pool->startup();
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _runningConsumers = _consumers.size();
+    }
+
+    // Every consumer needs a thread of its own: a consumer of an Exchange may wait for another
+    // consumer to make room in its buffer.
+    for (auto&& consumer : _consumers) {
+        _pool->schedule([ this, consumer = consumer.get() ](Status status) {
+            if (status.isOK()) {
+                runConsumer(consumer);
+                return;
+            }
+            consumer->pipeline->dispose(consumer->opCtx.get());
+            consumer->pipeline.get_deleter().dismissDisposal();
+
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_status.isOK()) {
+                _status = status;
+            }
+            --_runningConsumers;
+            _resultsAvailable.notify_all();
+        });
+    }
+
+    LOG(1) << "Running " << _consumers.size() << " parallel exchange consumers";
+}
+
+void DocumentSourceParallelExchange::runConsumer(Consumer* consumer) {
+    AlternativeClientRegion acr(consumer->client);
+    OperationContext* opCtx = consumer->opCtx.get();
+
+    Status status = Status::OK();
+    try {
+        consumer->pipeline->reattachToOperationContext(opCtx);
+        while (auto next = consumer->pipeline->getNext()) {
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            opCtx->waitForConditionOrInterrupt(_resultsConsumed, lk, [&] {
+                return _stopping || _results.size() < kMaxBufferedResults;
+            });
+            if (_stopping) {
+                break;
+            }
+            _results.push_back(std::move(*next));
+            _resultsAvailable.notify_all();
+        }
+    } catch (const DBException& ex) {
+        status = ex.toStatus();
+    }
+
+    const bool usedDisk = consumer->pipeline->usedDisk();
+    consumer->pipeline->dispose(opCtx);
+    consumer->pipeline.get_deleter().dismissDisposal();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _usedDisk = _usedDisk || usedDisk;
+
+    // A consumer which fails because another one did reports ExchangePassthrough, so prefer the
+    // original error.
+    if (!status.isOK() &&
+        (_status.isOK() || _status.code() == ErrorCodes::ExchangePassthrough)) {
+        _status = status;
+    }
+    --_runningConsumers;
+    _resultsAvailable.notify_all();
+}
+
+DocumentSource::GetNextResult DocumentSourceParallelExchange::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (!_pool) {
+        startConsumers();
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    pExpCtx->opCtx->waitForConditionOrInterrupt(_resultsAvailable, lk, [&] {
+        return !_results.empty() || !_status.isOK() || _runningConsumers == 0;
+    });
+    uassertStatusOK(_status);
+
+    if (_results.empty()) {
+        return GetNextResult::makeEOF();
+    }
+
+    Document next = std::move(_results.front());
+    _results.pop_front();
+    _resultsConsumed.notify_all();
+    return std::move(next);
+}
+
+void DocumentSourceParallelExchange::stopConsumers() {
+    bool anyRunning;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _stopping = true;
+        _resultsConsumed.notify_all();
+        anyRunning = _runningConsumers > 0;
+    }
+
+    // A consumer may be waiting within its pipeline rather than on us. Killing an operation takes
+    // the mutex it waits on, so we must not hold ours.
+    if (anyRunning) {
+        ServiceContext* serviceContext = pExpCtx->opCtx->getServiceContext();
+        for (auto&& consumer : _consumers) {
+            stdx::lock_guard<Client> clientLock(*consumer->client);
+            serviceContext->killOperation(
+                clientLock, consumer->opCtx.get(), ErrorCodes::Interrupted);
+        }
+    }
+
+    _pool->shutdown();
+    _pool->join();
+}
+
+void DocumentSourceParallelExchange::doDispose() {
+    if (_pool) {
+        stopConsumers();
+    } else {
+        // The consumers never ran, so their pipelines are still ours to dispose of.
+        for (auto&& consumer : _consumers) {
+            consumer->pipeline->dispose(pExpCtx->opCtx);
+            consumer->pipeline.get_deleter().dismissDisposal();
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _results.clear();
+}
+
+bool DocumentSourceParallelExchange::usedDisk() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _usedDisk;
+}
+
+Value DocumentSourceParallelExchange::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    return Value(DOC(getSourceName() << DOC("consumers" << static_cast<long long>(_consumers.size())
+                                                      << "pipeline"
+                                                      << Value(_consumerPipeline))));
+}
+
+}  // namespace mongo
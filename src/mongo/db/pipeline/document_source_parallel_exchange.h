@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+/**
+ * Runs each of a number of pipelines on its own thread, with its own Client and OperationContext,
+ * and returns the union of their results in no particular order. The pipelines are typically the
+ * consumers of a shared Exchange, each of which ends in a partial $group whose results the stages
+ * after this one merge.
+ *
+ * The threads start with the first call to getNext(), and run ahead of it until a bounded number
+ * of results is waiting to be returned. Disposing of the stage interrupts any thread which is
+ * still running, and waits for it to finish.
+ */
+class DocumentSourceParallelExchange final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalParallelExchange"_sd;
+
+    /**
+     * Creates a stage which runs each of 'pipelines'. Each pipeline must have an ExpressionContext
+     * of its own, distinct from 'expCtx'.
+     */
+    static boost::intrusive_ptr<DocumentSourceParallelExchange> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> pipelines);
+
+    GetNextResult getNext() final;
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kNone,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed,
+                                     LookupRequirement::kNotAllowed);
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    bool usedDisk() final;
+
+    size_t getNumConsumers() const {
+        return _consumers.size();
+    }
+
+protected:
+    void doDispose() final;
+
+private:
+    /**
+     * One of the pipelines, along with the Client and OperationContext of the thread running it.
+     */
+    struct Consumer {
+        std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+        ServiceContext::UniqueClient client;
+        ServiceContext::UniqueOperationContext opCtx;
+    };
+
+    DocumentSourceParallelExchange(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> pipelines);
+
+    /**
+     * Creates the worker pool and schedules every consumer on it.
+     */
+    void startConsumers();
+
+    /**
+     * Interrupts the consumers which are still running and waits for all of them to finish.
+     */
+    void stopConsumers();
+
+    /**
+     * Runs 'consumer' to completion, and then disposes of its pipeline. Runs on a thread of
+     * '_pool'.
+     */
+    void runConsumer(Consumer* consumer);
+
+    std::vector<std::unique_ptr<Consumer>> _consumers;
+
+    // The serialized stages of the first consumer, for explain and $currentOp.
+    std::vector<Value> _consumerPipeline;
+
+    // Null until the consumers have started.
+    std::unique_ptr<ThreadPool> _pool;
+
+    // Protects everything below.
+    stdx::mutex _mutex;
+    stdx::condition_variable _resultsAvailable;
+    stdx::condition_variable _resultsConsumed;
+
+    std::deque<Document> _results;
+    size_t _runningConsumers = 0;
+    bool _stopping = false;
+    bool _usedDisk = false;
+
+    // The first error which a consumer ran into.
+    Status _status = Status::OK();
+};
+
+}  // namespace mongo
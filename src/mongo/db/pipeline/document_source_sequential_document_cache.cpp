@@ -66,6 +66,7 @@ DocumentSource::GetNextResult DocumentSourceSequentialDocumentCache::getNext() {
             _cache->freeze();
         } else {
             _cache->add(nextResult.getDocument());
+            _cache->trackMemoryUsage(pExpCtx->opCtx);
         }
     }
 
@@ -40,6 +40,7 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
 
@@ -355,6 +356,14 @@ DocumentSource::GetNextResult DocumentSourceSort::populate() {
 void DocumentSourceSort::loadDocument(Document&& doc) {
     invariant(!_populated);
     if (!_sorter) {
+        // An Ordering holds the direction of at most 32 fields.
+        if (internalDocumentSourceSortKeyStrings.load() && _sortPattern.size() <= 32u) {
+            BSONObjBuilder directions;
+            for (auto&& keyPart : _sortPattern) {
+                directions.append("", keyPart.isAscending ? 1 : -1);
+            }
+            _keyStringOrdering = Ordering::make(directions.obj());
+        }
         _sorter.reset(MySorter::make(makeSortOptions(), Comparator(*this)));
     }
 
@@ -486,6 +495,10 @@ std::pair<Value, Document> DocumentSourceSort::extractSortKey(Document&& doc) co
         inMemorySortKey = deserializeSortKey(_sortPattern.size(), *serializedSortKey);
     }
 
+    if (_keyStringOrdering) {
+        inMemorySortKey = encodeSortKey(inMemorySortKey);
+    }
+
     MutableDocument toBeSorted(std::move(doc));
     if (pExpCtx->needsMerge) {
         // We need to be merged, so will have to be serialized. Save the sort key here to avoid
@@ -496,7 +509,34 @@ std::pair<Value, Document> DocumentSourceSort::extractSortKey(Document&& doc) co
     return {inMemorySortKey, toBeSorted.freeze()};
 }
 
+Value DocumentSourceSort::encodeSortKey(const Value& key) const {
+    // A missing key part compares equal to undefined, and less than every other value.
+    BSONObjBuilder keyParts;
+    auto appendKeyPart = [&](const Value& keyPart) {
+        if (keyPart.missing()) {
+            keyParts.appendUndefined("");
+        } else {
+            keyPart.addToBsonObj(&keyParts, ""_sd);
+        }
+    };
+    if (_sortPattern.size() == 1u) {
+        appendKeyPart(key);
+    } else {
+        for (auto&& keyPart : key.getArray()) {
+            appendKeyPart(keyPart);
+        }
+    }
+
+    KeyString keyString(KeyString::Version::V1, keyParts.done(), *_keyStringOrdering);
+    return Value(StringData(keyString.getBuffer(), keyString.getSize()));
+}
+
 int DocumentSourceSort::compare(const Value& lhs, const Value& rhs) const {
+    if (_keyStringOrdering) {
+        // The keys were encoded by encodeSortKey(), which took care of their directions.
+        return lhs.getStringData().compare(rhs.getStringData());
+    }
+
     // DocumentSourceSort::populate() has already guaranteed that the sort key is non-empty.
     // However, the tricky part is deciding what to do if none of the sort keys are present. In that
     // case, consider the document "less".
@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/sorter/sorter.h"
 
@@ -236,6 +237,13 @@ private:
      */
     Value getCollationComparisonKey(const Value& val) const;
 
+    /**
+     * Returns 'key', a sort key in the form returned by extractKeyFast(), encoded as a KeyString
+     * held in a string Value, such that comparing the bytes of two encoded keys orders them as
+     * compare() orders the keys themselves.
+     */
+    Value encodeSortKey(const Value& key) const;
+
     int compare(const Value& lhs, const Value& rhs) const;
 
     /**
@@ -266,6 +274,10 @@ private:
     std::unique_ptr<MySorter> _sorter;
     std::unique_ptr<MySorter::Iterator> _output;
     bool _usedDisk = false;
+
+    // Set when the sorter is created if 'internalDocumentSourceSortKeyStrings' is enabled, in which
+    // case the keys in the sorter are encoded by encodeSortKey() under this ordering.
+    boost::optional<Ordering> _keyStringOrdering;
 };
 
 }  // namespace mongo
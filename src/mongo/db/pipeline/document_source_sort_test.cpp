@@ -31,6 +31,7 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <deque>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -45,6 +46,7 @@
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 
@@ -349,6 +351,76 @@ TEST_F(DocumentSourceSortExecutionTest, ExtractArrayValues) {
                  "[{_id:1,a:[{b:1},{b:0}]},{_id:0,a:[{b:1},{b:2}]}]");
 }
 
+/**
+ * Returns the _id of each of 'docs' in the order in which a $sort by 'sortSpec' returns them.
+ */
+vector<Value> sortedIds(const intrusive_ptr<ExpressionContext>& expCtx,
+                        const vector<Document>& docs,
+                        const BSONObj& sortSpec) {
+    deque<DocumentSource::GetNextResult> inputs;
+    for (auto&& doc : docs) {
+        inputs.emplace_back(Document(doc));
+    }
+    auto sort = DocumentSourceSort::create(expCtx, sortSpec);
+    auto source = DocumentSourceMock::createForTest(inputs);
+    sort->setSource(source.get());
+
+    vector<Value> ids;
+    for (auto output = sort->getNext(); output.isAdvanced(); output = sort->getNext()) {
+        ids.push_back(output.getDocument()["_id"]);
+    }
+    return ids;
+}
+
+TEST_F(DocumentSourceSortExecutionTest, KeyStringSortKeysGiveTheSameOrder) {
+    const vector<Value> values = {Value(1),
+                                  Value(2.5),
+                                  Value(-3LL),
+                                  Value(Decimal128("2.5")),
+                                  Value(std::numeric_limits<double>::quiet_NaN()),
+                                  Value("abc"_sd),
+                                  Value("ab\0c"_sd),
+                                  Value("b"_sd),
+                                  Value(BSONNULL),
+                                  Value(BSONUndefined),
+                                  Value(),
+                                  Value(MINKEY),
+                                  Value(MAXKEY),
+                                  Value(true),
+                                  Value(Date_t::fromMillisSinceEpoch(5)),
+                                  Value(Timestamp(5, 1)),
+                                  Value(DOC("x" << 1)),
+                                  Value(DOC("x" << 1 << "y" << 2)),
+                                  Value(BSONBinData("ab", 2, BinDataGeneral))};
+    vector<Document> docs;
+    for (size_t i = 0; i < values.size(); ++i) {
+        for (size_t j = 0; j < values.size(); j += 4) {
+            const int id = docs.size();
+            docs.push_back(Document{{"_id", id}, {"a", values[i]}, {"b", values[j]}});
+        }
+    }
+
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    const vector<BSONObj> sortSpecs = {BSON("a" << 1 << "_id" << 1),
+                                       BSON("a" << -1 << "_id" << 1),
+                                       BSON("b" << -1 << "a" << 1 << "_id" << -1)};
+    for (bool withCollation : {false, true}) {
+        getExpCtx()->setCollator(withCollation ? &collator : nullptr);
+        for (auto&& sortSpec : sortSpecs) {
+            const auto expected = sortedIds(getExpCtx(), docs, sortSpec);
+            internalDocumentSourceSortKeyStrings.store(true);
+            const auto ids = sortedIds(getExpCtx(), docs, sortSpec);
+            internalDocumentSourceSortKeyStrings.store(false);
+
+            ASSERT_EQ(expected.size(), ids.size());
+            for (size_t i = 0; i < ids.size(); ++i) {
+                ASSERT_VALUE_EQ(expected[i], ids[i]);
+            }
+        }
+    }
+    getExpCtx()->setCollator(nullptr);
+}
+
 TEST_F(DocumentSourceSortExecutionTest, ShouldPauseWhenAskedTo) {
     auto sort = DocumentSourceSort::create(getExpCtx(), BSON("a" << 1));
     auto mock =
@@ -156,6 +156,150 @@ TEST(DocumentSerialization, CannotSerializeDocumentThatExceedsDepthLimit) {
     throwaway.abandon();
 }
 
+BSONObj makeLazyTestBson() {
+    return BSON("a" << 1 << "b" << BSON("c" << BSON_ARRAY(1 << 2)) << "d"
+                    << "str"
+                    << "e" << 2.5 << "a" << 3 << "f" << BSONNULL << "" << 4);
+}
+
+TEST(LazyDocument, FieldsMatchDocumentFromBson) {
+    const BSONObj bson = makeLazyTestBson();
+    Document lazy = Document::fromBsonLazily(bson);
+    Document eager = fromBson(bson);
+
+    // Look the fields up out of order, so that some are read ahead of the one asked for.
+    for (auto&& name : {"e", "a", "", "f", "b", "d", "missing"}) {
+        ASSERT_VALUE_EQ(eager[name], lazy[name]);
+    }
+    ASSERT_VALUE_EQ(Value(2), lazy.getNestedField(FieldPath("b.c.1")));
+
+    ASSERT_EQUALS(eager.size(), lazy.size());
+    ASSERT_BSONOBJ_EQ(bson, toBson(lazy));
+    ASSERT_DOCUMENT_EQ(eager, lazy);
+    ASSERT_EQUALS(DocumentComparator().hash(eager), DocumentComparator().hash(lazy));
+}
+
+TEST(LazyDocument, IteratesInBsonOrderAfterPartialRead) {
+    const BSONObj bson = makeLazyTestBson();
+    Document lazy = Document::fromBsonLazily(bson);
+    ASSERT_VALUE_EQ(Value(2.5), lazy["e"]);
+
+    size_t index = 0;
+    for (auto&& bsonElement : bson) {
+        auto field = getNthField(lazy, index++);
+        ASSERT_EQUALS(bsonElement.fieldNameStringData(), field.first);
+        ASSERT_VALUE_EQ(Value(bsonElement), field.second);
+    }
+    ASSERT_EQUALS(bson.nFields(), static_cast<int>(index));
+}
+
+TEST(LazyDocument, EmptyBson) {
+    Document lazy = Document::fromBsonLazily(BSONObj());
+    ASSERT_TRUE(lazy.empty());
+    ASSERT_EQUALS(0U, lazy.size());
+    ASSERT_VALUE_EQ(Value(), lazy["a"]);
+    ASSERT_BSONOBJ_EQ(BSONObj(), toBson(lazy));
+}
+
+TEST(LazyDocument, ModificationsKeepBsonOrder) {
+    MutableDocument md(Document::fromBsonLazily(makeLazyTestBson()));
+    md["d"] = Value("changed"_sd);
+    md.remove("b");
+    md.addField("g", Value(5));
+    md["e"] = Value(6);
+
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "d"
+                               << "changed"
+                               << "e" << 6 << "a" << 3 << "f" << BSONNULL << "" << 4 << "g" << 5),
+                      toBson(md.freeze()));
+}
+
+TEST(LazyDocument, CloneOfPartiallyReadDocument) {
+    const BSONObj bson = makeLazyTestBson();
+    Document lazy = Document::fromBsonLazily(bson);
+    ASSERT_VALUE_EQ(Value("str"_sd), lazy["d"]);
+
+    MutableDocument md(lazy);
+    md["f"] = Value(7);
+    Document modified = md.freeze();
+
+    ASSERT_VALUE_EQ(Value(7), modified["f"]);
+    ASSERT_VALUE_EQ(Value(BSONNULL), lazy["f"]);
+    ASSERT_BSONOBJ_EQ(bson, toBson(lazy));
+    ASSERT_VALUE_EQ(Value(4), modified[""]);
+    ASSERT_EQUALS(lazy.size(), modified.size());
+}
+
+TEST(LazyDocument, ApproximateSizeCountsUnreadBson) {
+    const BSONObj bson = makeLazyTestBson();
+    Document lazy = Document::fromBsonLazily(bson);
+    ASSERT_GTE(lazy.getApproximateSize(), static_cast<size_t>(bson.objsize()));
+
+    // The fields are still read as usual afterwards.
+    ASSERT_VALUE_EQ(Value(1), lazy["a"]);
+    ASSERT_BSONOBJ_EQ(bson, toBson(lazy));
+}
+
+TEST(DocumentBufferPool, ReusedBuffersHoldNewFields) {
+    DocumentBufferPoolScope scope(1024 * 1024);
+    ASSERT_TRUE(DocumentBufferPoolScope::isActive());
+
+    const BSONObj bson = makeLazyTestBson();
+    for (int i = 0; i < 10; ++i) {
+        // Documents built field by field, from BSON and by cloning all take buffers freed by the
+        // documents of the previous iteration.
+        MutableDocument md;
+        for (int field = 0; field < 20; ++field) {
+            md.addField("f" + std::to_string(field), Value(i * field));
+        }
+        Document built = md.freeze();
+        Document fromBsonDoc = fromBson(bson);
+        MutableDocument cloned(built);
+        cloned["f3"] = Value("changed"_sd);
+
+        ASSERT_VALUE_EQ(Value(i * 19), built["f19"]);
+        ASSERT_VALUE_EQ(Value(i * 3), built["f3"]);
+        ASSERT_VALUE_EQ(Value("changed"_sd), cloned.peek()["f3"]);
+        ASSERT_BSONOBJ_EQ(bson, toBson(fromBsonDoc));
+    }
+}
+
+TEST(DocumentBufferPool, DocumentsOutliveScope) {
+    Document outlives;
+    {
+        DocumentBufferPoolScope scope(1024 * 1024);
+        {
+            Document freed = fromBson(makeLazyTestBson());
+        }
+        outlives = fromBson(makeLazyTestBson());
+    }
+    ASSERT_FALSE(DocumentBufferPoolScope::isActive());
+    ASSERT_BSONOBJ_EQ(makeLazyTestBson(), toBson(outlives));
+}
+
+TEST(DocumentBufferPool, NestedAndDisabledScopes) {
+    {
+        DocumentBufferPoolScope disabled(0);
+        ASSERT_FALSE(DocumentBufferPoolScope::isActive());
+    }
+
+    DocumentBufferPoolScope outer(1024);
+    {
+        DocumentBufferPoolScope inner(1024);
+        ASSERT_TRUE(DocumentBufferPoolScope::isActive());
+    }
+    // Ending the inner scope leaves the outer one in place.
+    ASSERT_TRUE(DocumentBufferPoolScope::isActive());
+
+    // More buffers are freed than the pool has room for.
+    std::vector<Document> docs;
+    for (int i = 0; i < 50; ++i) {
+        docs.push_back(fromBson(makeLazyTestBson()));
+    }
+    docs.clear();
+    ASSERT_BSONOBJ_EQ(makeLazyTestBson(), toBson(fromBson(makeLazyTestBson())));
+}
+
 /** Add Document fields. */
 class AddField {
 public:
@@ -138,6 +138,7 @@ class ExpressionHyperbolicCosine;
 class ExpressionHyperbolicSine;
 class ExpressionDegreesToRadians;
 class ExpressionRadiansToDegrees;
+class ExpressionInternalTopNInput;
 
 class AccumulatorAvg;
 class AccumulatorMax;
@@ -272,6 +273,7 @@ public:
     virtual void visit(ExpressionFromAccumulator<AccumulatorStdDevSamp>*) = 0;
     virtual void visit(ExpressionFromAccumulator<AccumulatorSum>*) = 0;
     virtual void visit(ExpressionFromAccumulator<AccumulatorMergeObjects>*) = 0;
+    virtual void visit(ExpressionInternalTopNInput*) = 0;
     virtual void visit(ExpressionTests::Testable*) = 0;
 };
 
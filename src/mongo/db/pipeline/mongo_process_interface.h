@@ -322,6 +322,18 @@ public:
         boost::optional<BSONObj> readConcern,
         bool allowSpeculativeMajorityRead = false) = 0;
 
+    /**
+     * Looks up the documents whose _id is one of 'ids' with a single query, using the collection
+     * default collation like lookupSingleDocument(). Returns the document found for each of 'ids'
+     * in the same order, or boost::none for those with no matching document, including when the
+     * given namespace does not exist. Throws if more than one document matches any of 'ids'.
+     */
+    virtual std::vector<boost::optional<Document>> lookupDocumentsById(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID collectionUUID,
+        const std::vector<Value>& ids) = 0;
+
     /**
      * Returns a vector of all idle (non-pinned) local cursors.
      */
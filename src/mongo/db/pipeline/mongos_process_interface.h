@@ -87,6 +87,18 @@ public:
         boost::optional<BSONObj> readConcern,
         bool allowSpeculativeMajorityRead = false) final;
 
+    /**
+     * Post-images are looked up from mongos one at a time, each with the read concern of its own
+     * change event, so this is never called.
+     */
+    std::vector<boost::optional<Document>> lookupDocumentsById(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID collectionUUID,
+        const std::vector<Value>& ids) final {
+        MONGO_UNREACHABLE;
+    }
+
     std::vector<GenericCursor> getIdleCursors(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                               CurrentOpUserMode userMode) const final;
 
@@ -31,6 +31,8 @@
 
 #include "mongo/db/pipeline/parsed_aggregation_projection_node.h"
 
+#include "mongo/db/query/query_knobs_gen.h"
+
 namespace mongo {
 namespace parsed_aggregation_projection {
 
@@ -58,6 +60,7 @@ void ProjectionNode::addExpressionForPath(const FieldPath& path,
     if (path.getPathLength() == 1) {
         auto fieldName = path.fullPath();
         _expressions[fieldName] = expr;
+        _compiledExpressions.erase(fieldName);
         _orderToProcessAdditionsAndChildren.push_back(fieldName);
         return;
     }
@@ -172,10 +175,12 @@ void ProjectionNode::applyExpressions(const Document& root, MutableDocument* out
         } else {
             auto expressionIt = _expressions.find(field);
             invariant(expressionIt != _expressions.end());
-            outputDoc->setField(
-                field,
-                expressionIt->second->evaluate(
-                    root, &expressionIt->second->getExpressionContext()->variables));
+            auto* variables = &expressionIt->second->getExpressionContext()->variables;
+            auto compiledIt = _compiledExpressions.find(field);
+            outputDoc->setField(field,
+                                compiledIt != _compiledExpressions.end()
+                                    ? compiledIt->second->evaluate(root, variables)
+                                    : expressionIt->second->evaluate(root, variables));
         }
     }
 }
@@ -244,6 +249,14 @@ void ProjectionNode::optimize() {
     for (auto&& expressionIt : _expressions) {
         _expressions[expressionIt.first] = expressionIt.second->optimize();
     }
+    _compiledExpressions.clear();
+    if (internalQueryCompileProjectionExpressions.load()) {
+        for (auto&& expressionIt : _expressions) {
+            if (auto compiled = CompiledExpression::compile(expressionIt.second)) {
+                _compiledExpressions[expressionIt.first] = std::move(compiled);
+            }
+        }
+    }
     for (auto&& childPair : _children) {
         childPair.second->optimize();
     }
@@ -29,6 +29,9 @@
 
 #pragma once
 
+#include <memory>
+
+#include "mongo/db/pipeline/compiled_expression.h"
 #include "mongo/db/pipeline/parsed_aggregation_projection.h"
 
 namespace mongo {
@@ -152,6 +155,11 @@ protected:
     stdx::unordered_map<size_t, std::unique_ptr<ProjectionNode>> _arrayBranches;
 
     StringMap<boost::intrusive_ptr<Expression>> _expressions;
+
+    // Programs compiled from the optimized expressions in '_expressions', which are evaluated in
+    // their place when present. Only filled by optimize(), and only if
+    // 'internalQueryCompileProjectionExpressions' is enabled.
+    StringMap<std::unique_ptr<CompiledExpression>> _compiledExpressions;
     stdx::unordered_set<std::string> _projectedFields;
 
     ProjectionPolicies _policies;
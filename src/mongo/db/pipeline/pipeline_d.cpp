@@ -70,6 +70,7 @@
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/operation_sharding_state.h"
@@ -97,6 +98,14 @@ using std::unique_ptr;
 using write_ops::Insert;
 
 namespace {
+// The largest fraction of the documents a $sample may ask for and still be served by a random
+// cursor, which needs more attempts to find documents it has not yet returned as the fraction
+// grows.
+const double kMaxSampleRatioForRandCursor = 0.05;
+
+// The number of works() over which a sharded random cursor plan counts its orphaned documents.
+const size_t kMaxPresampleSize = 100;
+
 /**
  * Returns a PlanExecutor which uses a random cursor to sample documents if successful. Returns {}
  * if the storage engine doesn't support random cursors, or if 'sampleSize' is a large enough
@@ -108,7 +117,6 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorEx
     // function because double-locking forces any PlanExecutor we create to adopt a NO_YIELD policy.
     invariant(opCtx->lockState()->isCollectionLockedForMode(coll->ns(), MODE_IS));
 
-    static const double kMaxSampleRatioForRandCursor = 0.05;
     if (sampleSize > numRecords * kMaxSampleRatioForRandCursor || numRecords <= 100) {
         return {nullptr};
     }
@@ -142,7 +150,6 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorEx
         // be satisfied. For instance, if there are 200 documents and the sampleSize is 5, then at
         // least (5 / (200*0.05)) = (5/10) = 50% of those documents must be owned. If less than 5%
         // of the documents in the collection are owned, we default to the backup plan.
-        static const size_t kMaxPresampleSize = 100;
         const auto minWorkAdvancedRatio = std::max(
             sampleSize / (numRecords * kMaxSampleRatioForRandCursor), kMaxSampleRatioForRandCursor);
         // The trial plan is SHARDING_FILTER-MULTI_ITERATOR.
@@ -166,6 +173,92 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorEx
         opCtx, std::move(ws), std::move(root), coll, PlanExecutor::YIELD_AUTO);
 }
 
+/**
+ * Returns a PlanExecutor which uses a random cursor to sample the documents matching 'matchStage'
+ * if successful, discarding the documents which do not match. Returns {} if the storage engine
+ * doesn't support random cursors, if the operation is sharded, if the filter cannot be applied
+ * outside of the query planner, or if 'sampleSize' is a large enough percentage of the matching
+ * documents, as estimated from a presample of the collection. On success, replaces the number of
+ * records in the collection pointed to by 'numRecords' with the estimated number of matches.
+ */
+StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createFilteredRandomCursorExecutor(
+    Collection* coll,
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    const DocumentSourceMatch& matchStage,
+    long long sampleSize,
+    long long* numRecords) {
+    OperationContext* opCtx = expCtx->opCtx;
+    invariant(opCtx->lockState()->isCollectionLockedForMode(coll->ns(), MODE_IS));
+
+    const long long presampleSize = internalDocumentSourceSampleFilterPresampleSize.load();
+    if (presampleSize == 0 || *numRecords <= std::max(100LL, presampleSize) ||
+        sampleSize > *numRecords * kMaxSampleRatioForRandCursor) {
+        return {nullptr};
+    }
+
+    // Orphaned documents would have to be filtered out as well, which the estimate below does not
+    // account for.
+    if (OperationShardingState::isOperationVersioned(opCtx)) {
+        return {nullptr};
+    }
+
+    // A $text predicate can only be answered with a text index.
+    if (matchStage.isTextQuery()) {
+        return {nullptr};
+    }
+
+    const BSONObj query = matchStage.getQuery();
+    auto qr = std::make_unique<QueryRequest>(coll->ns());
+    qr->setFilter(query);
+    qr->setCollation(expCtx->getCollator() ? expCtx->getCollator()->getSpec().toBSON()
+                                           : expCtx->collation);
+    const ExtensionsCallbackReal extensionsCallback(opCtx, &coll->ns());
+    auto cq = CanonicalQuery::canonicalize(
+        opCtx, std::move(qr), expCtx, extensionsCallback, Pipeline::kAllowedMatcherFeatures);
+    if (!cq.isOK()) {
+        return {nullptr};
+    }
+
+    auto rsRandCursor = coll->getRecordStore()->getRandomCursor(opCtx);
+    if (!rsRandCursor) {
+        // The storage engine has no random cursor support.
+        return {nullptr};
+    }
+
+    // Estimate the number of matching documents from a presample. The random cursor only returns
+    // the documents which match, so it reads about 'numRecords / numMatching' documents for each
+    // one it returns, and the same ratio as for an unfiltered $sample bounds how often it finds a
+    // document which it has already returned.
+    long long numPresampledMatches = 0;
+    for (long long i = 0; i < presampleSize; ++i) {
+        auto record = rsRandCursor->next();
+        if (!record) {
+            return {nullptr};
+        }
+        if (cq.getValue()->root()->matchesBSON(record->data.toBson())) {
+            ++numPresampledMatches;
+        }
+    }
+    const double estimatedMatches =
+        static_cast<double>(*numRecords) * numPresampledMatches / presampleSize;
+    if (numPresampledMatches == 0 || sampleSize > estimatedMatches * kMaxSampleRatioForRandCursor) {
+        return {nullptr};
+    }
+    *numRecords = static_cast<long long>(estimatedMatches);
+
+    // The presample did not return any documents, so the same cursor can serve the sample.
+    auto ws = std::make_unique<WorkingSet>();
+    auto root = std::make_unique<MultiIteratorStage>(opCtx, ws.get(), coll, cq.getValue()->root());
+    root->addIterator(std::move(rsRandCursor));
+
+    return PlanExecutor::make(opCtx,
+                              std::move(ws),
+                              std::move(root),
+                              std::move(cq.getValue()),
+                              coll,
+                              PlanExecutor::YIELD_AUTO);
+}
+
 StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExecutor(
     OperationContext* opCtx,
     Collection* collection,
@@ -319,12 +412,26 @@ PipelineD::buildInnerQueryExecutor(Collection* collection,
 
     if (!sources.empty()) {
         auto sampleStage = dynamic_cast<DocumentSourceSample*>(sources.front().get());
+        // A $sample which follows an initial $match may be optimized as well, by sampling only the
+        // matching documents.
+        auto matchStage = dynamic_cast<DocumentSourceMatch*>(sources.front().get());
+        if (matchStage && sources.size() > 1) {
+            sampleStage = dynamic_cast<DocumentSourceSample*>(std::next(sources.begin())->get());
+        }
         // Optimize an initial $sample stage if possible.
         if (collection && sampleStage) {
             const long long sampleSize = sampleStage->getSampleSize();
-            const long long numRecords = collection->getRecordStore()->numRecords(expCtx->opCtx);
-            auto exec = uassertStatusOK(
-                createRandomCursorExecutor(collection, expCtx->opCtx, sampleSize, numRecords));
+            long long numRecords = collection->getRecordStore()->numRecords(expCtx->opCtx);
+            auto exec = uassertStatusOK(matchStage
+                                            ? createFilteredRandomCursorExecutor(collection,
+                                                                                 expCtx,
+                                                                                 *matchStage,
+                                                                                 sampleSize,
+                                                                                 &numRecords)
+                                            : createRandomCursorExecutor(collection,
+                                                                         expCtx->opCtx,
+                                                                         sampleSize,
+                                                                         numRecords));
             if (exec) {
                 // For sharded collections, the root of the plan tree is a TrialStage that may have
                 // chosen either a random-sampling cursor trial plan or a COLLSCAN backup plan. We
@@ -333,7 +440,11 @@ PipelineD::buildInnerQueryExecutor(Collection* collection,
                                         ? static_cast<TrialStage*>(exec->getRootStage())
                                         : nullptr);
                 if (!trialStage || !trialStage->pickedBackupPlan()) {
-                    // Replace $sample stage with $sampleFromRandomCursor stage.
+                    // Replace $sample stage with $sampleFromRandomCursor stage. The PlanExecutor
+                    // applies the filter of a preceding $match.
+                    if (matchStage) {
+                        pipeline->popFront();
+                    }
                     pipeline->popFront();
                     std::string idString = collection->ns().isOplog() ? "ts" : "_id";
                     pipeline->addInitialSource(DocumentSourceSampleFromRandomCursor::create(
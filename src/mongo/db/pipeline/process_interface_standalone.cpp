@@ -33,12 +33,18 @@
 
 #include "mongo/db/pipeline/process_interface_standalone.h"
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "mongo/bson/bsonobj_comparator.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/cursor_manager.h"
@@ -47,6 +53,8 @@
 #include "mongo/db/pipeline/document_source_cursor.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
 #include "mongo/db/pipeline/pipeline_d.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/speculative_majority_read_info.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
@@ -59,7 +67,11 @@
 #include "mongo/db/transaction_participant.h"
 #include "mongo/s/cluster_commands_helpers.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -135,6 +147,123 @@ bool supportsUniqueKey(const boost::intrusive_ptr<ExpressionContext>& expCtx,
             CollatorInterface::collatorsMatch(index->getCollator(), expCtx->getCollator()));
 }
 
+/**
+ * Sets the speculative read timestamp appropriately after we do a document lookup locally. We set
+ * the speculative read timestamp based on the timestamp used by the transaction.
+ */
+void setSpeculativeReadTimestampAfterLookup(OperationContext* opCtx) {
+    repl::SpeculativeMajorityReadInfo& speculativeMajorityReadInfo =
+        repl::SpeculativeMajorityReadInfo::get(opCtx);
+    if (speculativeMajorityReadInfo.isSpeculativeRead()) {
+        // Speculative majority reads are required to use the 'kNoOverlap' read source.
+        invariant(opCtx->recoveryUnit()->getTimestampReadSource() ==
+                  RecoveryUnit::ReadSource::kNoOverlap);
+        boost::optional<Timestamp> readTs = opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
+        invariant(readTs);
+        speculativeMajorityReadInfo.setSpeculativeReadTimestampForward(*readTs);
+    }
+}
+
+// A batch of writes is only split among threads if each of them gets at least this many writes.
+constexpr size_t kMinWritesPerWriterThread = 100;
+
+/**
+ * Returns the number of threads among which to split a batch of 'batchSize' writes made for
+ * 'opCtx'. The threads take locks of their own, so the batch is not split while 'opCtx' holds any.
+ */
+size_t getNumWriterThreads(OperationContext* opCtx, size_t batchSize) {
+    const size_t maxThreads = internalDocumentSourceWriterThreads.load();
+    if (maxThreads <= 1 || opCtx->lockState()->isLocked()) {
+        return 1;
+    }
+    return std::max<size_t>(1, std::min(maxThreads, batchSize / kMinWritesPerWriterThread));
+}
+
+/**
+ * Runs 'write' for each of the 'numParts' parts of a batch for 'opCtx', each on a thread and with
+ * an operation context of its own, and returns their results in order. If 'opCtx' is interrupted,
+ * the writes still running are killed and waited for. Afterwards the last optime of the client of
+ * 'opCtx' covers the writes, so that waiting for its write concern also waits for them.
+ */
+std::vector<WriteResult> performWritesInParallel(
+    OperationContext* opCtx,
+    size_t numParts,
+    const std::function<WriteResult(OperationContext*, size_t)>& write) {
+    ThreadPool::Options options;
+    options.poolName = "AggregationWriter";
+    options.threadNamePrefix = "aggregationWriter-";
+    options.minThreads = 0;
+    options.maxThreads = numParts;
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName.c_str());
+    };
+    ThreadPool pool(options);
+    pool.startup();
+
+    stdx::mutex mutex;
+    stdx::condition_variable allDone;
+    size_t outstanding = numParts;
+    bool cancelled = false;
+    std::vector<OperationContext*> workerOpCtxs(numParts, nullptr);
+    std::vector<WriteResult> results(numParts);
+    std::vector<Status> statuses(numParts, Status::OK());
+
+    ON_BLOCK_EXIT([&] {
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            cancelled = true;
+            for (auto workerOpCtx : workerOpCtxs) {
+                if (workerOpCtx) {
+                    stdx::lock_guard<Client> clientLock(*workerOpCtx->getClient());
+                    opCtx->getServiceContext()->killOperation(
+                        clientLock, workerOpCtx, ErrorCodes::Interrupted);
+                }
+            }
+        }
+        pool.shutdown();
+        pool.join();
+    });
+
+    for (size_t i = 0; i < numParts; ++i) {
+        pool.schedule([&, i](Status status) {
+            ServiceContext::UniqueOperationContext workerOpCtx;
+            if (status.isOK()) {
+                workerOpCtx = cc().makeOperationContext();
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                if (cancelled) {
+                    status = Status(ErrorCodes::Interrupted, "Aggregation writes were cancelled");
+                } else {
+                    workerOpCtxs[i] = workerOpCtx.get();
+                }
+            }
+            if (status.isOK()) {
+                try {
+                    results[i] = write(workerOpCtx.get(), i);
+                } catch (const DBException& ex) {
+                    status = ex.toStatus();
+                }
+            }
+
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            workerOpCtxs[i] = nullptr;
+            statuses[i] = status;
+            if (--outstanding == 0) {
+                allDone.notify_all();
+            }
+        });
+    }
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        opCtx->waitForConditionOrInterrupt(allDone, lk, [&] { return outstanding == 0; });
+    }
+    for (auto&& status : statuses) {
+        uassertStatusOK(status);
+    }
+    repl::ReplClientInfo::forClient(opCtx->getClient()).setLastOpToSystemLastOpTime(opCtx);
+    return results;
+}
+
 }  // namespace
 
 MongoInterfaceStandalone::MongoInterfaceStandalone(OperationContext* opCtx) : _client(opCtx) {}
@@ -213,13 +342,35 @@ Status MongoInterfaceStandalone::insert(const boost::intrusive_ptr<ExpressionCon
                                         std::vector<BSONObj>&& objs,
                                         const WriteConcernOptions& wc,
                                         boost::optional<OID> targetEpoch) {
-    auto writeResults = performInserts(
-        expCtx->opCtx, buildInsertOp(ns, std::move(objs), expCtx->bypassDocumentValidation));
+    std::vector<WriteResult> writeResults;
+    const size_t numThreads = getNumWriterThreads(expCtx->opCtx, objs.size());
+    if (numThreads == 1) {
+        writeResults.push_back(performInserts(
+            expCtx->opCtx, buildInsertOp(ns, std::move(objs), expCtx->bypassDocumentValidation)));
+    } else {
+        // The inserts do not depend on each other, so each thread inserts a contiguous part of the
+        // batch.
+        std::vector<std::vector<BSONObj>> parts(numThreads);
+        for (size_t i = 0; i < objs.size(); ++i) {
+            parts[i * numThreads / objs.size()].push_back(std::move(objs[i]));
+        }
+        std::vector<Insert> insertOps;
+        for (auto&& part : parts) {
+            insertOps.push_back(
+                buildInsertOp(ns, std::move(part), expCtx->bypassDocumentValidation));
+        }
+        writeResults = performWritesInParallel(
+            expCtx->opCtx, numThreads, [&](OperationContext* opCtx, size_t i) {
+                return performInserts(opCtx, insertOps[i]);
+            });
+    }
 
     // Need to check each result in the batch since the writes are unordered.
-    for (const auto& result : writeResults.results) {
-        if (result.getStatus() != Status::OK()) {
-            return result.getStatus();
+    for (const auto& writeResult : writeResults) {
+        for (const auto& result : writeResult.results) {
+            if (result.getStatus() != Status::OK()) {
+                return result.getStatus();
+            }
         }
     }
     return Status::OK();
@@ -233,18 +384,41 @@ StatusWith<MongoProcessInterface::UpdateResult> MongoInterfaceStandalone::update
     bool upsert,
     bool multi,
     boost::optional<OID> targetEpoch) {
-    auto writeResults =
-        performUpdates(expCtx->opCtx, buildUpdateOp(expCtx, ns, std::move(batch), upsert, multi));
+    std::vector<WriteResult> writeResults;
+    const size_t numThreads = multi ? 1 : getNumWriterThreads(expCtx->opCtx, batch.size());
+    if (numThreads == 1) {
+        writeResults.push_back(performUpdates(
+            expCtx->opCtx, buildUpdateOp(expCtx, ns, std::move(batch), upsert, multi)));
+    } else {
+        // Each update targets the document its query matches, so the updates are split by the hash
+        // of their queries, which keeps successive updates of a document in order on one thread.
+        const BSONObjComparator comparator(
+            BSONObj(), BSONObjComparator::FieldNamesMode::kConsider, expCtx->getCollator());
+        std::vector<BatchedObjects> parts(numThreads);
+        for (auto&& obj : batch) {
+            parts[comparator.hash(std::get<BSONObj>(obj)) % numThreads].push_back(std::move(obj));
+        }
+        std::vector<Update> updateOps;
+        for (auto&& part : parts) {
+            updateOps.push_back(buildUpdateOp(expCtx, ns, std::move(part), upsert, multi));
+        }
+        writeResults = performWritesInParallel(
+            expCtx->opCtx, numThreads, [&](OperationContext* opCtx, size_t i) {
+                return performUpdates(opCtx, updateOps[i]);
+            });
+    }
 
     // Need to check each result in the batch since the writes are unordered.
     UpdateResult updateResult;
-    for (const auto& result : writeResults.results) {
-        if (result.getStatus() != Status::OK()) {
-            return result.getStatus();
-        }
+    for (const auto& writeResult : writeResults) {
+        for (const auto& result : writeResult.results) {
+            if (result.getStatus() != Status::OK()) {
+                return result.getStatus();
+            }
 
-        updateResult.nMatched += result.getValue().getN();
-        updateResult.nModified += result.getValue().getNModified();
+            updateResult.nMatched += result.getValue().getN();
+            updateResult.nModified += result.getValue().getNModified();
+        }
     }
     return updateResult;
 }
@@ -440,21 +614,59 @@ boost::optional<Document> MongoInterfaceStandalone::lookupSingleDocument(
                                 << "]");
     }
 
-    // Set the speculative read timestamp appropriately after we do a document lookup locally. We
-    // set the speculative read timestamp based on the timestamp used by the transaction.
-    repl::SpeculativeMajorityReadInfo& speculativeMajorityReadInfo =
-        repl::SpeculativeMajorityReadInfo::get(expCtx->opCtx);
-    if (speculativeMajorityReadInfo.isSpeculativeRead()) {
-        // Speculative majority reads are required to use the 'kNoOverlap' read source.
-        invariant(expCtx->opCtx->recoveryUnit()->getTimestampReadSource() ==
-                  RecoveryUnit::ReadSource::kNoOverlap);
-        boost::optional<Timestamp> readTs =
-            expCtx->opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
-        invariant(readTs);
-        speculativeMajorityReadInfo.setSpeculativeReadTimestampForward(*readTs);
+    setSpeculativeReadTimestampAfterLookup(expCtx->opCtx);
+    return lookedUpDocument;
+}
+
+std::vector<boost::optional<Document>> MongoInterfaceStandalone::lookupDocumentsById(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Value>& ids) {
+    std::vector<boost::optional<Document>> lookedUpDocuments(ids.size());
+
+    boost::intrusive_ptr<ExpressionContext> foreignExpCtx;
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    try {
+        // Be sure to do the lookup using the collection default collation
+        foreignExpCtx = expCtx->copyWith(
+            nss,
+            collectionUUID,
+            _getCollectionDefaultCollator(expCtx->opCtx, nss.db(), collectionUUID));
+        pipeline = makePipeline({BSON("$match" << BSON("_id" << BSON("$in" << Value(ids))))},
+                                foreignExpCtx);
+    } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return lookedUpDocuments;
     }
 
-    return lookedUpDocument;
+    // The same _id may be looked up more than once, so map each _id to all of its positions.
+    auto positionsById =
+        foreignExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>();
+    for (size_t i = 0; i < ids.size(); ++i) {
+        positionsById[ids[i]].push_back(i);
+    }
+
+    while (auto next = pipeline->getNext()) {
+        auto it = positionsById.find((*next)["_id"]);
+        if (it == positionsById.end()) {
+            continue;
+        }
+        for (auto i : it->second) {
+            uassert(ErrorCodes::TooManyMatchingDocuments,
+                    str::stream() << "found more than one document with _id "
+                                  << ids[i].toString()
+                                  << " ["
+                                  << lookedUpDocuments[i]->toString()
+                                  << ", "
+                                  << next->toString()
+                                  << "]",
+                    !lookedUpDocuments[i]);
+            lookedUpDocuments[i] = *next;
+        }
+    }
+
+    setSpeculativeReadTimestampAfterLookup(expCtx->opCtx);
+    return lookedUpDocuments;
 }
 
 BackupCursorState MongoInterfaceStandalone::openBackupCursor(OperationContext* opCtx) {
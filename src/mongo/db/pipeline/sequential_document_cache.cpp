@@ -59,10 +59,22 @@ void SequentialDocumentCache::abandon() {
 
     _cache.clear();
     _cache.shrink_to_fit();
+    _memoryUsage.set(nullptr, 0);
 
     _cacheIter = _cache.begin();
 }
 
+void SequentialDocumentCache::trackMemoryUsage(OperationContext* opCtx) {
+    if (!isBuilding()) {
+        return;
+    }
+
+    _memoryUsage.set(opCtx, _sizeBytes);
+    if (_memoryUsage.shouldSpill()) {
+        abandon();
+    }
+}
+
 boost::optional<Document> SequentialDocumentCache::getNext() {
     invariant(_status == CacheStatus::kServing);
 
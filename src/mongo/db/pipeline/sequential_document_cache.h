@@ -34,6 +34,7 @@
 #include <vector>
 
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/query/query_memory_tracker.h"
 
 #include "mongo/base/status.h"
 
@@ -54,6 +55,7 @@ public:
         : _status(moveFrom._status),
           _maxSizeBytes(moveFrom._maxSizeBytes),
           _sizeBytes(moveFrom._sizeBytes),
+          _memoryUsage(std::move(moveFrom._memoryUsage)),
           _cacheIter(std::move(moveFrom._cacheIter)),
           _cache(std::move(moveFrom._cache)) {}
 
@@ -62,6 +64,7 @@ public:
         _maxSizeBytes = moveFrom._maxSizeBytes;
         _cache = std::move(moveFrom._cache);
         _sizeBytes = moveFrom._sizeBytes;
+        _memoryUsage = std::move(moveFrom._memoryUsage);
         _status = moveFrom._status;
 
         return *this;
@@ -102,6 +105,13 @@ public:
      */
     void abandon();
 
+    /**
+     * Reports the size of the cache to the query memory accounting of 'opCtx'. A cache which is
+     * still being built is abandoned when all queries together use more than their memory budget,
+     * since $lookup can run its pipeline for each document instead.
+     */
+    void trackMemoryUsage(OperationContext* opCtx);
+
     /**
      * Returns the next Document in sequence from the cache, or boost::none if the end of the cache
      * has been reached. May only be called while in 'kServing' mode.
@@ -148,6 +158,7 @@ private:
     CacheStatus _status = CacheStatus::kBuilding;
     size_t _maxSizeBytes = 0;
     size_t _sizeBytes = 0;
+    QueryMemoryTracker::StageUsage _memoryUsage;
 
     std::vector<Document>::iterator _cacheIter;
     std::vector<Document> _cache;
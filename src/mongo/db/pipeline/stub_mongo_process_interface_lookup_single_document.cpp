@@ -103,4 +103,34 @@ boost::optional<Document> StubMongoProcessInterfaceLookupSingleDocument::lookupS
     return lookedUpDocument;
 }
 
+std::vector<boost::optional<Document>>
+StubMongoProcessInterfaceLookupSingleDocument::lookupDocumentsById(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Value>& ids) {
+    std::vector<boost::optional<Document>> lookedUpDocuments(ids.size());
+    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID, boost::none);
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    try {
+        pipeline = makePipeline({BSON("$match" << BSON("_id" << BSON("$in" << Value(ids))))},
+                                foreignExpCtx);
+    } catch (ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return lookedUpDocuments;
+    }
+
+    while (auto next = pipeline->getNext()) {
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (foreignExpCtx->getValueComparator().evaluate(ids[i] == (*next)["_id"])) {
+                uassert(ErrorCodes::TooManyMatchingDocuments,
+                        str::stream() << "found more than one document with _id "
+                                      << ids[i].toString(),
+                        !lookedUpDocuments[i]);
+                lookedUpDocuments[i] = *next;
+            }
+        }
+    }
+    return lookedUpDocuments;
+}
+
 }  // namespace mongo
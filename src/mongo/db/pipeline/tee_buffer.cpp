@@ -50,12 +50,7 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferS
 }
 
 DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
-    size_t nConsumersStillProcessingThisBatch =
-        std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
-            return info.nLeftToReturn > 0;
-        });
-
-    if (_buffer.empty() || nConsumersStillProcessingThisBatch == 0) {
+    if (_buffer.empty() || _nConsumersStillProcessingThisBatch == 0) {
         loadNextBatch();
     }
 
@@ -71,21 +66,27 @@ DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
     }
 
     const size_t bufferIndex = _buffer.size() - _consumers[consumerId].nLeftToReturn;
-    --_consumers[consumerId].nLeftToReturn;
+    if (--_consumers[consumerId].nLeftToReturn == 0) {
+        --_nConsumersStillProcessingThisBatch;
+    }
 
     return _buffer[bufferIndex];
 }
 
 void TeeBuffer::loadNextBatch() {
+    OperationContext* opCtx = _source->getContext()->opCtx;
     _buffer.clear();
     size_t bytesInBuffer = 0;
+    _memoryUsage.set(opCtx, bytesInBuffer);
 
     auto input = _source->getNext();
     for (; input.isAdvanced(); input = _source->getNext()) {
         bytesInBuffer += input.getDocument().getApproximateSize();
         _buffer.push_back(std::move(input));
+        _memoryUsage.set(opCtx, bytesInBuffer);
 
-        if (bytesInBuffer >= _bufferSizeBytes) {
+        // The batches also get smaller when all queries together use more than their budget.
+        if (bytesInBuffer >= _bufferSizeBytes || _memoryUsage.shouldSpill()) {
             break;  // Need to break here so we don't get the next input and accidentally ignore it.
         }
     }
@@ -97,9 +98,13 @@ void TeeBuffer::loadNextBatch() {
     invariant(!input.isPaused());
 
     // Populate the pending returns.
+    _nConsumersStillProcessingThisBatch = 0;
     for (size_t consumerId = 0; consumerId < _consumers.size(); ++consumerId) {
         if (_consumers[consumerId].stillInUse) {
             _consumers[consumerId].nLeftToReturn = _buffer.size();
+            if (!_buffer.empty()) {
+                ++_nConsumersStillProcessingThisBatch;
+            }
         }
     }
 }
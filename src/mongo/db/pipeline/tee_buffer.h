@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_memory_tracker.h"
 #include "mongo/util/intrusive_counter.h"
 
 namespace mongo {
@@ -65,11 +66,15 @@ public:
      */
     void dispose(size_t consumerId) {
         _consumers[consumerId].stillInUse = false;
+        if (_consumers[consumerId].nLeftToReturn > 0) {
+            --_nConsumersStillProcessingThisBatch;
+        }
         _consumers[consumerId].nLeftToReturn = 0;
         if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
                 return info.stillInUse;
             })) {
             _buffer.clear();
+            _memoryUsage.set(nullptr, 0);
             if (_source) {
                 _source->dispose();
             }
@@ -97,11 +102,16 @@ private:
 
     const size_t _bufferSizeBytes;
     std::vector<DocumentSource::GetNextResult> _buffer;
+    QueryMemoryTracker::StageUsage _memoryUsage;  // Reports the size of '_buffer'.
 
     struct ConsumerInfo {
         bool stillInUse = true;
         int nLeftToReturn = 0;
     };
     std::vector<ConsumerInfo> _consumers;
+
+    // The number of consumers with documents of the current batch left to return, so that
+    // getNext() does not need to scan all the consumers for every document it returns.
+    size_t _nConsumersStillProcessingThisBatch = 0;
 };
 }  // namespace mongo
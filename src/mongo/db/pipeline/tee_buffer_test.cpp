@@ -167,5 +167,42 @@ TEST(TeeBufferTest, ShouldAllowOtherConsumersToAdvanceOnceTrailingConsumerIsDisp
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
 }
+
+TEST(TeeBufferTest, ShouldLoadNextBatchOnlyOnceEveryRemainingConsumerFinishedTheCurrentOne) {
+    std::deque<DocumentSource::GetNextResult> inputs{
+        Document{{"a", 1}}, Document{{"a", 2}}, Document{{"a", 3}}};
+    auto mock = DocumentSourceMock::createForTest(inputs);
+
+    const size_t nConsumers = 3;
+    const size_t bufferBytes = 1;  // Each document is a batch of its own.
+    auto teeBuffer = TeeBuffer::create(nConsumers, bufferBytes);
+    teeBuffer->setSource(mock.get());
+
+    bool disposed = false;
+    for (auto&& input : inputs) {
+        for (size_t consumerId = 0; consumerId < nConsumers - 1; ++consumerId) {
+            auto next = teeBuffer->getNext(consumerId);
+            ASSERT_TRUE(next.isAdvanced());
+            ASSERT_DOCUMENT_EQ(next.getDocument(), input.getDocument());
+        }
+        if (disposed) {
+            continue;
+        }
+
+        // Consumer #0 has to wait for consumer #2 until it is done with the batch or disposed of.
+        ASSERT_TRUE(teeBuffer->getNext(0).isPaused());
+        if (input.getDocument()["a"].getInt() == 1) {
+            auto next = teeBuffer->getNext(2);
+            ASSERT_TRUE(next.isAdvanced());
+            ASSERT_DOCUMENT_EQ(next.getDocument(), input.getDocument());
+        } else {
+            teeBuffer->dispose(2);
+            disposed = true;
+        }
+    }
+
+    ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
+    ASSERT_TRUE(teeBuffer->getNext(1).isEOF());
+}
 }  // namespace
 }  // namespace mongo
@@ -35,11 +35,13 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_array.h"
+#include "mongo/db/matcher/expression_tree.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/canonical_query_encoder.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/indexability.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/util/log.h"
 
@@ -232,6 +234,10 @@ Status CanonicalQuery::init(OperationContext* opCtx,
     // Normalize, sort and validate tree.
     _root = MatchExpression::optimize(std::move(root));
     sortTree(_root.get());
+    const int adaptiveOrderInterval = internalQueryAdaptiveAndOrderInterval.load();
+    if (adaptiveOrderInterval > 0) {
+        enableAdaptiveAndOrdering(_root.get(), adaptiveOrderInterval);
+    }
     Status validStatus = isValid(_root.get(), *_qr);
     if (!validStatus.isOK()) {
         return validStatus;
@@ -261,6 +267,9 @@ void CanonicalQuery::setCollator(std::unique_ptr<CollatorInterface> collator) {
     // the object owned by '_collator'. We must associate the match expression tree with the new
     // value of '_collator'.
     _root->setCollator(_collator.get());
+
+    // The collation is part of the shape.
+    _encodedKey = boost::none;
 }
 
 // static
@@ -293,6 +302,40 @@ bool CanonicalQuery::isSimpleIdQuery(const BSONObj& query) {
     return hasID;
 }
 
+// static
+bool CanonicalQuery::isSimpleIdInQuery(const BSONObj& query) {
+    if (query.nFields() != 1) {
+        return false;
+    }
+
+    BSONElement idElt = query.firstElement();
+    if (idElt.fieldNameStringData() != "_id" || idElt.type() != Object) {
+        return false;
+    }
+
+    BSONObj inObj = idElt.Obj();
+    if (inObj.nFields() != 1) {
+        return false;
+    }
+
+    BSONElement inElt = inObj.firstElement();
+    if (inElt.fieldNameStringData() != "$in" || inElt.type() != Array) {
+        return false;
+    }
+
+    for (auto&& elt : inElt.Obj()) {
+        if (elt.type() == Object) {
+            if (elt.Obj().firstElementFieldName()[0] == '$') {
+                return false;
+            }
+        } else if (!Indexability::isExactBoundsGenerating(elt)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 // static
 void CanonicalQuery::sortTree(MatchExpression* tree) {
     for (size_t i = 0; i < tree->numChildren(); ++i) {
@@ -304,6 +347,16 @@ void CanonicalQuery::sortTree(MatchExpression* tree) {
     }
 }
 
+// static
+void CanonicalQuery::enableAdaptiveAndOrdering(MatchExpression* tree, size_t interval) {
+    for (size_t i = 0; i < tree->numChildren(); ++i) {
+        enableAdaptiveAndOrdering(tree->getChild(i), interval);
+    }
+    if (tree->matchType() == MatchExpression::AND) {
+        static_cast<AndMatchExpression*>(tree)->setAdaptiveOrderInterval(interval);
+    }
+}
+
 // static
 size_t CanonicalQuery::countNodes(const MatchExpression* root, MatchExpression::MatchType type) {
     size_t sum = 0;
@@ -483,8 +536,11 @@ std::string CanonicalQuery::toStringShort() const {
     return ss;
 }
 
-CanonicalQuery::QueryShapeString CanonicalQuery::encodeKey() const {
-    return canonical_query_encoder::encode(*this);
+const CanonicalQuery::QueryShapeString& CanonicalQuery::encodeKey() const {
+    if (!_encodedKey) {
+        _encodedKey = canonical_query_encoder::encode(*this);
+    }
+    return *_encodedKey;
 }
 
 }  // namespace mongo
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 
 #include "mongo/base/status.h"
 #include "mongo/db/dbmessage.h"
@@ -101,6 +102,12 @@ public:
      */
     static bool isSimpleIdQuery(const BSONObj& query);
 
+    /**
+     * Returns true if "query" is of the form {_id: {$in: [...]}}, where each of the values could
+     * be the operand of a query accepted by isSimpleIdQuery().
+     */
+    static bool isSimpleIdInQuery(const BSONObj& query);
+
     const NamespaceString& nss() const {
         return _qr->nss();
     }
@@ -130,8 +137,11 @@ public:
     /**
      * Compute the "shape" of this query by encoding the match, projection and sort, and stripping
      * out the appropriate values.
+     *
+     * The encoding is computed by the first call and returned by later ones, until setCollator()
+     * changes the shape.
      */
-    QueryShapeString encodeKey() const;
+    const QueryShapeString& encodeKey() const;
 
     /**
      * Sets this CanonicalQuery's collator, and sets the collator on this CanonicalQuery's match
@@ -163,6 +173,12 @@ public:
      */
     static void sortTree(MatchExpression* tree);
 
+    /**
+     * Makes every $and in the expression tree learn the order in which to try its children every
+     * 'interval' documents it matches. See AndMatchExpression::setAdaptiveOrderInterval().
+     */
+    static void enableAdaptiveAndOrdering(MatchExpression* tree, size_t interval);
+
     /**
      * Returns a count of 'type' nodes in expression tree.
      */
@@ -204,6 +220,9 @@ private:
     std::unique_ptr<CollatorInterface> _collator;
 
     bool _canHaveNoopMatchNodes = false;
+
+    // Cache of encodeKey(). A query is looked up by its shape several times while it is planned.
+    mutable boost::optional<QueryShapeString> _encodedKey;
 };
 
 }  // namespace mongo
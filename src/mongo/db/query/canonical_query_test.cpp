@@ -31,6 +31,7 @@
 
 #include "mongo/db/json.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/canonical_query_encoder.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/query/query_test_service_context.h"
@@ -368,6 +369,28 @@ TEST(CanonicalQueryTest, SettingCollatorUpdatesCollatorAndMatchExpression) {
     ASSERT_EQUALS(inExpr->getCollator(), cq->getCollator());
 }
 
+TEST(CanonicalQueryTest, SettingCollatorChangesEncodedKey) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    auto qr = std::make_unique<QueryRequest>(nss);
+    qr->setFilter(fromjson("{a: 'foo'}"));
+    auto cq = assertGet(CanonicalQuery::canonicalize(opCtx.get(), std::move(qr)));
+
+    const auto keyWithoutCollation = cq->encodeKey();
+    ASSERT_EQUALS(keyWithoutCollation, canonical_query_encoder::encode(*cq));
+    ASSERT_EQUALS(&cq->encodeKey(), &cq->encodeKey());
+
+    unique_ptr<CollatorInterface> collator =
+        assertGet(CollatorFactoryInterface::get(opCtx->getServiceContext())
+                      ->makeFromBSON(BSON("locale"
+                                          << "reverse")));
+    cq->setCollator(std::move(collator));
+
+    ASSERT_NOT_EQUALS(keyWithoutCollation, cq->encodeKey());
+    ASSERT_EQUALS(cq->encodeKey(), canonical_query_encoder::encode(*cq));
+}
+
 TEST(CanonicalQueryTest, NorWithOneChildNormalizedToNot) {
     unique_ptr<CanonicalQuery> cq(canonicalize("{$nor: [{a: 1}]}"));
     auto root = cq->root();
@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/query/cursor_response.h"
+#include "mongo/db/query/find_common.h"
 
 #include "mongo/rpc/op_msg_rpc_impls.h"
 
@@ -389,6 +390,18 @@ TEST(CursorResponseTest, cursorReturnDocumentSequences) {
     ASSERT_BSONOBJ_EQ(opMsg.body, expectedBody);
 }
 
+TEST(CursorResponseTest, replyBytesForBatchFitsTheSerializedResponse) {
+    std::vector<BSONObj> batch;
+    for (int i = 0; i < 20000; ++i) {
+        batch.push_back(BSON("_id" << i));
+    }
+    const auto replyBytes = FindCommon::replyBytesForBatch(batch);
+
+    CursorResponse response(NamespaceString("db.coll"), CursorId(123), std::move(batch));
+    ASSERT_LTE(size_t(response.toBSON(CursorResponse::ResponseType::InitialResponse).objsize()),
+               replyBytes);
+}
+
 }  // namespace
 
 }  // namespace mongo
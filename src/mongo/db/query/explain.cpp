@@ -48,6 +48,7 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/query/stage_builder.h"
@@ -175,12 +176,19 @@ size_t getDocsExamined(StageType type, const SpecificStats* specific) {
     if (STAGE_COLLSCAN == type) {
         const CollectionScanStats* spec = static_cast<const CollectionScanStats*>(specific);
         return spec->docsTested;
+    } else if (STAGE_PARALLEL_COLLSCAN == type) {
+        const ParallelCollectionScanStats* spec =
+            static_cast<const ParallelCollectionScanStats*>(specific);
+        return spec->docsTested;
     } else if (STAGE_FETCH == type) {
         const FetchStats* spec = static_cast<const FetchStats*>(specific);
         return spec->docsExamined;
     } else if (STAGE_IDHACK == type) {
         const IDHackStats* spec = static_cast<const IDHackStats*>(specific);
         return spec->docsExamined;
+    } else if (STAGE_SAMPLED_COUNT == type) {
+        const SampledCountStats* spec = static_cast<const SampledCountStats*>(specific);
+        return spec->docsSampled;
     } else if (STAGE_TEXT_OR == type) {
         const TextOrStats* spec = static_cast<const TextOrStats*>(specific);
         return spec->fetches;
@@ -325,6 +333,13 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
         bob->appendNumber("nReturned", stats.common.advanced);
         bob->appendNumber("executionTimeMillisEstimate", stats.common.executionTimeMillis);
+        if (verbosity >= ExplainOptions::Verbosity::kExecStatsDetailed) {
+            bob->appendNumber("executionTimeNanos", stats.common.executionTimeNanos);
+            if (stats.common.instructions >= 0) {
+                bob->appendNumber("instructions", stats.common.instructions);
+                bob->appendNumber("llcMisses", stats.common.llcMisses);
+            }
+        }
         bob->appendNumber("works", stats.common.works);
         bob->appendNumber("advanced", stats.common.advanced);
         bob->appendNumber("needTime", stats.common.needTime);
@@ -364,6 +379,14 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsTested);
         }
+    } else if (STAGE_PARALLEL_COLLSCAN == stats.stageType) {
+        ParallelCollectionScanStats* spec =
+            static_cast<ParallelCollectionScanStats*>(stats.specific.get());
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("docsExamined", spec->docsTested);
+            bob->appendNumber("numPartitions", spec->numPartitions);
+            bob->appendNumber("rounds", spec->rounds);
+        }
     } else if (STAGE_COUNT == stats.stageType) {
         CountStats* spec = static_cast<CountStats*>(stats.specific.get());
 
@@ -442,6 +465,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsExamined);
             bob->appendNumber("alreadyHasObj", spec->alreadyHasObj);
+            if (spec->docsPrefetched) {
+                bob->appendNumber("docsPrefetched", spec->docsPrefetched);
+            }
         }
     } else if (STAGE_GEO_NEAR_2D == stats.stageType || STAGE_GEO_NEAR_2DSPHERE == stats.stageType) {
         NearStats* spec = static_cast<NearStats*>(stats.specific.get());
@@ -522,6 +548,15 @@ void Explain::statsToBSON(const PlanStageStats& stats,
             bob->appendNumber("nCounted", spec->nCounted);
             bob->appendNumber("nSkipped", spec->nSkipped);
         }
+    } else if (STAGE_SAMPLED_COUNT == stats.stageType) {
+        SampledCountStats* spec = static_cast<SampledCountStats*>(stats.specific.get());
+
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("nCounted", spec->nCounted);
+            bob->appendNumber("nSkipped", spec->nSkipped);
+            bob->appendNumber("docsSampled", spec->docsSampled);
+            bob->appendNumber("docsMatched", spec->docsMatched);
+        }
     } else if (STAGE_SHARDING_FILTER == stats.stageType) {
         ShardingFilterStats* spec = static_cast<ShardingFilterStats*>(stats.specific.get());
 
@@ -538,6 +573,13 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            if (spec->spills) {
+                bob->appendNumber("spills", spec->spills);
+                bob->appendBool("usedDisk", spec->usedDisk);
+            }
+            if (spec->topKRejected) {
+                bob->appendNumber("topKRejected", spec->topKRejected);
+            }
         }
 
         if (spec->limit > 0) {
@@ -808,10 +850,13 @@ void Explain::generateExecutionInfo(PlanExecutor* exec,
 
         BSONArrayBuilder allPlansBob(execBob.subarrayStart("allPlansExecution"));
 
+        // The detailed stats are only collected once the trial period is over.
+        const auto trialVerbosity = std::min(verbosity, ExplainOptions::Verbosity::kExecAllPlans);
+
         if (winningPlanTrialStats) {
             BSONObjBuilder planBob(allPlansBob.subobjStart());
             generateSinglePlanExecutionInfo(
-                winningPlanTrialStats, verbosity, boost::none, &planBob);
+                winningPlanTrialStats, trialVerbosity, boost::none, &planBob);
             planBob.doneFast();
         }
 
@@ -819,7 +864,7 @@ void Explain::generateExecutionInfo(PlanExecutor* exec,
         for (size_t i = 0; i < rejectedStats.size(); ++i) {
             BSONObjBuilder planBob(allPlansBob.subobjStart());
             generateSinglePlanExecutionInfo(
-                rejectedStats[i].get(), verbosity, boost::none, &planBob);
+                rejectedStats[i].get(), trialVerbosity, boost::none, &planBob);
             planBob.doneFast();
         }
 
@@ -880,6 +925,10 @@ void Explain::explainStages(PlanExecutor* exec,
 
     // If we need execution stats, then run the plan in order to gather the stats.
     if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+        if (verbosity >= ExplainOptions::Verbosity::kExecStatsDetailed) {
+            exec->getRootStage()->enableDetailedStats(
+                internalQueryExplainCollectHardwareCounters.load());
+        }
         executePlanStatus = exec->executePlan();
 
         // If executing the query failed because it was killed, then the collection may no longer be
@@ -40,6 +40,7 @@ constexpr StringData ExplainOptions::kVerbosityName;
 constexpr StringData ExplainOptions::kQueryPlannerVerbosityStr;
 constexpr StringData ExplainOptions::kExecStatsVerbosityStr;
 constexpr StringData ExplainOptions::kAllPlansExecutionVerbosityStr;
+constexpr StringData ExplainOptions::kExecStatsDetailedVerbosityStr;
 
 StringData ExplainOptions::verbosityString(ExplainOptions::Verbosity verbosity) {
     switch (verbosity) {
@@ -49,6 +50,8 @@ StringData ExplainOptions::verbosityString(ExplainOptions::Verbosity verbosity)
             return kExecStatsVerbosityStr;
         case Verbosity::kExecAllPlans:
             return kAllPlansExecutionVerbosityStr;
+        case Verbosity::kExecStatsDetailed:
+            return kExecStatsDetailedVerbosityStr;
         default:
             MONGO_UNREACHABLE;
     }
@@ -70,6 +73,8 @@ StatusWith<ExplainOptions::Verbosity> ExplainOptions::parseCmdBSON(const BSONObj
             verbosity = Verbosity::kQueryPlanner;
         } else if (verbStr == kExecStatsVerbosityStr) {
             verbosity = Verbosity::kExecStats;
+        } else if (verbStr == kExecStatsDetailedVerbosityStr) {
+            verbosity = Verbosity::kExecStatsDetailed;
         } else if (verbStr != kAllPlansExecutionVerbosityStr) {
             return Status(ErrorCodes::FailedToParse,
                           str::stream() << "verbosity string must be one of {'"
@@ -78,6 +83,8 @@ StatusWith<ExplainOptions::Verbosity> ExplainOptions::parseCmdBSON(const BSONObj
                                         << kExecStatsVerbosityStr
                                         << "', '"
                                         << kAllPlansExecutionVerbosityStr
+                                        << "', '"
+                                        << kExecStatsDetailedVerbosityStr
                                         << "'}");
         }
     }
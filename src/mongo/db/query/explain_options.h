@@ -58,6 +58,12 @@ public:
         // At this verbosity level, we generate the execution stats for each rejected plan as well
         // as the winning plan. String alias is "allPlansExecution".
         kExecAllPlans = 2,
+
+        // In addition to everything reported by kExecAllPlans, the stats for each stage of the
+        // winning plan include the time spent executing it in nanoseconds, and, where the
+        // platform allows, the instructions retired and last level cache misses incurred while
+        // doing so. String alias is "executionStatsDetailed".
+        kExecStatsDetailed = 3,
     };
 
     static constexpr StringData kVerbosityName = "verbosity"_sd;
@@ -66,6 +72,7 @@ public:
     static constexpr StringData kQueryPlannerVerbosityStr = "queryPlanner"_sd;
     static constexpr StringData kExecStatsVerbosityStr = "executionStats"_sd;
     static constexpr StringData kAllPlansExecutionVerbosityStr = "allPlansExecution"_sd;
+    static constexpr StringData kExecStatsDetailedVerbosityStr = "executionStatsDetailed"_sd;
 
     /**
      * Converts an explain verbosity to its string representation.
@@ -46,6 +46,8 @@ TEST(ExplainOptionsTest, VerbosityEnumToStringReturnsCorrectValues) {
               "executionStats"_sd);
     ASSERT_EQ(ExplainOptions::verbosityString(ExplainOptions::Verbosity::kExecAllPlans),
               "allPlansExecution"_sd);
+    ASSERT_EQ(ExplainOptions::verbosityString(ExplainOptions::Verbosity::kExecStatsDetailed),
+              "executionStatsDetailed"_sd);
 }
 
 TEST(ExplainOptionsTest, ExplainOptionsSerializeToBSONCorrectly) {
@@ -58,6 +60,9 @@ TEST(ExplainOptionsTest, ExplainOptionsSerializeToBSONCorrectly) {
     ASSERT_BSONOBJ_EQ(BSON("verbosity"
                            << "allPlansExecution"),
                       ExplainOptions::toBSON(ExplainOptions::Verbosity::kExecAllPlans));
+    ASSERT_BSONOBJ_EQ(BSON("verbosity"
+                           << "executionStatsDetailed"),
+                      ExplainOptions::toBSON(ExplainOptions::Verbosity::kExecStatsDetailed));
 }
 
 TEST(ExplainOptionsTest, CanParseExplainVerbosity) {
@@ -70,6 +75,9 @@ TEST(ExplainOptionsTest, CanParseExplainVerbosity) {
     verbosity = unittest::assertGet(
         ExplainOptions::parseCmdBSON(fromjson("{explain: {}, verbosity: 'allPlansExecution'}")));
     ASSERT(verbosity == ExplainOptions::Verbosity::kExecAllPlans);
+    verbosity = unittest::assertGet(ExplainOptions::parseCmdBSON(
+        fromjson("{explain: {}, verbosity: 'executionStatsDetailed'}")));
+    ASSERT(verbosity == ExplainOptions::Verbosity::kExecStatsDetailed);
 }
 
 TEST(ExplainOptionsTest, ParsingFailsIfVerbosityIsNotAString) {
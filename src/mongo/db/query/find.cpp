@@ -54,6 +54,7 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -132,6 +133,66 @@ void beginQueryOp(OperationContext* opCtx,
     curOp->setNS_inlock(nss.ns());
 }
 
+namespace {
+
+/**
+ * Returns true if the plan rooted at 'root' scans a collection, and was chosen without running any
+ * of its stages, so that none of its stages has opened a cursor yet.
+ */
+bool isUntriedCollectionScanPlan(const PlanStage* root) {
+    bool scansCollection = false;
+    std::vector<const PlanStage*> stages{root};
+    while (!stages.empty()) {
+        const PlanStage* stage = stages.back();
+        stages.pop_back();
+        switch (stage->stageType()) {
+            case STAGE_CACHED_PLAN:
+            case STAGE_MULTI_PLAN:
+            case STAGE_SUBPLAN:
+                return false;
+            case STAGE_COLLSCAN:
+                scansCollection = true;
+                break;
+            default:
+                break;
+        }
+        for (auto&& child : stage->getChildren()) {
+            stages.push_back(child.get());
+        }
+    }
+    return scansCollection;
+}
+
+bool hasHotIndex(const Collection* collection, long long minAccessesPerMinute, Date_t now) {
+    for (auto&& entry : collection->infoCache()->getIndexUsageStats()) {
+        const auto& stats = entry.second;
+        const long long minutes =
+            std::max(durationCount<Minutes>(now - stats.trackerStartTime), 1LL);
+        if (stats.accesses.load() / minutes >= minAccessesPerMinute) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+void setReadOnceIfScanningCollectionWithHotIndexes(OperationContext* opCtx,
+                                                   const Collection* collection,
+                                                   PlanExecutor* exec) {
+    const long long minAccessesPerMinute =
+        internalQueryReadOnceCollScanHotIndexAccessesPerMinute.load();
+    if (minAccessesPerMinute <= 0 || !collection ||
+        !isUntriedCollectionScanPlan(exec->getRootStage())) {
+        return;
+    }
+
+    const Date_t now = opCtx->getServiceContext()->getFastClockSource()->now();
+    if (hasHotIndex(collection, minAccessesPerMinute, now)) {
+        opCtx->recoveryUnit()->setReadOnce(true);
+    }
+}
+
 void endQueryOp(OperationContext* opCtx,
                 Collection* collection,
                 const PlanExecutor& exec,
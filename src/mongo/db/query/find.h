@@ -86,6 +86,20 @@ void endQueryOp(OperationContext* opCtx,
                 long long numResults,
                 CursorId cursorId);
 
+/**
+ * Makes the storage engine cursors of 'exec' read-once when its plan scans 'collection' and one of
+ * the collection's indexes is used at least
+ * 'internalQueryReadOnceCollScanHotIndexAccessesPerMinute' times a minute. The pages that the scan
+ * reads are then the first to be evicted from the storage engine cache, rather than the pages of
+ * the hot indexes.
+ *
+ * Must be called before 'exec' opens any cursors, or after it has been detached from its previous
+ * operation.
+ */
+void setReadOnceIfScanningCollectionWithHotIndexes(OperationContext* opCtx,
+                                                   const Collection* collection,
+                                                   PlanExecutor* exec);
+
 /**
  * Called from the getMore entry point in ops/query.cpp.
  * Returned buffer is the message to return to the client.
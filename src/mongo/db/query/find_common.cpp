@@ -33,6 +33,7 @@
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_request.h"
 #include "mongo/util/assert_util.h"
 
@@ -71,6 +72,45 @@ bool FindCommon::haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int
     return (bytesBuffered + nextDoc.objsize()) <= kMaxBytesToReturnToClientAtOnce;
 }
 
+bool FindCommon::haveSpaceForNext(const BSONObj& nextDoc,
+                                  long long numDocs,
+                                  int bytesBuffered,
+                                  int maxBytes) {
+    invariant(maxBytes <= kMaxBytesToReturnToClientAtOnce);
+    if (!numDocs) {
+        return true;
+    }
+
+    return (bytesBuffered + nextDoc.objsize()) <= maxBytes;
+}
+
+int FindCommon::getMoreBatchBytesBudget(std::uint64_t nBatchesReturned) {
+    const long long initialBytes = internalQueryGetMoreInitialBatchBytes.load();
+    if (!initialBytes || initialBytes >= kMaxBytesToReturnToClientAtOnce) {
+        return kMaxBytesToReturnToClientAtOnce;
+    }
+
+    // The first batch came from the cursor-generating command, so the first getMore gets the
+    // initial budget.
+    long long budget = initialBytes;
+    for (std::uint64_t i = 1; i < nBatchesReturned && budget < kMaxBytesToReturnToClientAtOnce;
+         ++i) {
+        budget *= 2;
+    }
+    return std::min(budget, static_cast<long long>(kMaxBytesToReturnToClientAtOnce));
+}
+
+std::size_t FindCommon::replyBytesForBatch(const std::vector<BSONObj>& batch) {
+    // Each document of a batch array also takes a type byte and its index as a field name, which
+    // has at most 7 digits in a batch of at most 16MB, and the envelope holds the cursor id, the
+    // namespace and the command's status.
+    std::size_t bytes = 1024;
+    for (const auto& obj : batch) {
+        bytes += obj.objsize() + 9;
+    }
+    return bytes;
+}
+
 BSONObj FindCommon::transformSortSpec(const BSONObj& sortSpec) {
     BSONObjBuilder comparatorBob;
 
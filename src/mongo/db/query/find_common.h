@@ -27,6 +27,8 @@
  *    it in the license file.
  */
 
+#include <vector>
+
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/util/fail_point_service.h"
@@ -115,6 +117,31 @@ public:
      */
     static bool haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int bytesBuffered);
 
+    /**
+     * Like the above, but against a budget of 'maxBytes', which must not exceed
+     * kMaxBytesToReturnToClientAtOnce, rather than the whole reply size limit.
+     */
+    static bool haveSpaceForNext(const BSONObj& nextDoc,
+                                 long long numDocs,
+                                 int bytesBuffered,
+                                 int maxBytes);
+
+    /**
+     * Returns how many bytes of documents a getMore without a batchSize may return from a cursor
+     * which has returned 'nBatchesReturned' batches so far. The budget starts at
+     * 'internalQueryGetMoreInitialBatchBytes' and doubles with each batch, so that a client
+     * which reads only a few batches gets them quickly while one that reads the whole result set
+     * soon gets batches of the full kMaxBytesToReturnToClientAtOnce.
+     */
+    static int getMoreBatchBytesBudget(std::uint64_t nBatchesReturned);
+
+    /**
+     * Returns how many bytes a reply needs to hold 'batch' along with its cursor response envelope,
+     * so that its buffer can be allocated once instead of growing, and so copying, while the batch
+     * is appended.
+     */
+    static std::size_t replyBytesForBatch(const std::vector<BSONObj>& batch);
+
     /**
      * Transforms the raw sort spec into one suitable for use as the ordering specification in
      * BSONObj::woCompare().
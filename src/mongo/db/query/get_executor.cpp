@@ -40,6 +40,7 @@
 #include "mongo/base/error_codes.h"
 #include "mongo/base/parse_number.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/dbdirectclient.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/count.h"
@@ -49,6 +50,7 @@
 #include "mongo/db/exec/multi_plan.h"
 #include "mongo/db/exec/projection.h"
 #include "mongo/db/exec/record_store_fast_count.h"
+#include "mongo/db/exec/sampled_count.h"
 #include "mongo/db/exec/shard_filter.h"
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/subplan.h"
@@ -65,6 +67,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cache_snapshot.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
@@ -76,6 +79,7 @@
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/query/stage_builder.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/operation_sharding_state.h"
@@ -234,7 +238,7 @@ void applyIndexFilters(Collection* collection,
                        QueryPlannerParams* plannerParams) {
     if (!IDHackStage::supportsQuery(collection, canonicalQuery)) {
         QuerySettings* querySettings = collection->infoCache()->getQuerySettings();
-        const auto key = canonicalQuery.encodeKey();
+        const auto& key = canonicalQuery.encodeKey();
 
         // Filter index catalog if index filters are specified for query.
         // Also, signal to planner that application hint should be ignored.
@@ -298,6 +302,13 @@ void fillOutPlannerParams(OperationContext* opCtx,
         plannerParams->options |= QueryPlannerParams::GENERATE_COVERED_IXSCANS;
     }
 
+    if (internalQueryPlannerGenerateSkipScans.load()) {
+        plannerParams->options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    }
+
+    // Only statistics which have already been sampled are used, so this never samples.
+    plannerParams->indexStatistics = collection->infoCache()->getIndexStatistics()->get();
+
     plannerParams->options |= QueryPlannerParams::SPLIT_LIMITED_SORT;
 
     if (shouldWaitForOplogVisibility(
@@ -336,6 +347,52 @@ bool shouldWaitForOplogVisibility(OperationContext* opCtx,
 
 namespace {
 
+/**
+ * Restores the plan cache entry which was saved for the shape of 'canonicalQuery', if there is
+ * one. The first query on the collection reads all of the entries saved for it.
+ */
+void restoreFromPlanCacheSnapshot(OperationContext* opCtx,
+                                  Collection* collection,
+                                  const CanonicalQuery& canonicalQuery,
+                                  const PlanCacheKey& planCacheKey,
+                                  const QueryPlannerParams& plannerParams) {
+    PlanCacheSnapshot* snapshot = collection->infoCache()->getPlanCacheSnapshot();
+    if (snapshot->needsLoad()) {
+        // The local database cannot be read inside of a transaction, which runs in a single
+        // write unit of work, nor at the point in time of a stronger read concern. Leave the
+        // loading to a later query.
+        const auto readConcernLevel = repl::ReadConcernArgs::get(opCtx).getLevel();
+        if (opCtx->lockState()->inAWriteUnitOfWork() ||
+            (readConcernLevel != repl::ReadConcernLevel::kLocalReadConcern &&
+             readConcernLevel != repl::ReadConcernLevel::kAvailableReadConcern)) {
+            return;
+        }
+
+        std::vector<BSONObj> docs;
+        try {
+            DBDirectClient client(opCtx);
+            auto cursor =
+                client.query(NamespaceString::kPlanCacheSnapshotNamespace,
+                             QUERY(PlanCacheSnapshot::kNsFieldName << collection->ns().ns()));
+            while (cursor->more()) {
+                docs.push_back(cursor->nextSafe().getOwned());
+            }
+        } catch (const DBException& ex) {
+            // Give up on the saved entries rather than retrying on every query.
+            LOG(1) << "Failed to read the saved plan cache entries for " << collection->ns()
+                   << ": " << redact(ex);
+            docs.clear();
+        }
+        snapshot->load(docs);
+    }
+
+    snapshot->restore(canonicalQuery,
+                      planCacheKey,
+                      plannerParams.indices,
+                      collection->infoCache()->getPlanCache(),
+                      opCtx->getServiceContext()->getPreciseClockSource()->now());
+}
+
 struct PrepareExecutionResult {
     PrepareExecutionResult(unique_ptr<CanonicalQuery> canonicalQuery,
                            unique_ptr<QuerySolution> querySolution,
@@ -462,6 +519,11 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         CurOp::get(opCtx)->debug().planCacheKey =
             canonical_query_encoder::computeHash(planCacheKey.toString());
 
+        if (internalQueryCacheRestoreSnapshots.load()) {
+            restoreFromPlanCacheSnapshot(
+                opCtx, collection, *canonicalQuery, planCacheKey, plannerParams);
+        }
+
         // Try to look up a cached solution for the query.
         if (auto cs =
                 collection->infoCache()->getPlanCache()->getCacheEntryIfActive(planCacheKey)) {
@@ -1117,6 +1179,40 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorUpdate(
 
 namespace {
 
+/**
+ * Returns 'true' if the bounds of 'isn', the index scan of the provided solution 'soln', can be
+ * split into several ranges of keys which a count scan each counts. Replaces 'soln->root' with an
+ * OR of those count scans which does not dedup.
+ *
+ * Each document has at most one key in an index which is neither multikey nor $**, and the ranges
+ * are disjoint, so the count is the sum of the keys in every range.
+ */
+bool turnIxscanIntoCountOfRanges(QuerySolution* soln, const IndexScanNode* isn) {
+    if (isn->index.multikey || isn->index.type == INDEX_WILDCARD) {
+        return false;
+    }
+
+    std::vector<IndexBoundsBuilder::KeyRange> ranges;
+    if (!IndexBoundsBuilder::isUnionOfSingleIntervals(
+            isn->bounds, static_cast<size_t>(internalQueryMaxCountScans.load()), &ranges)) {
+        return false;
+    }
+
+    auto orn = std::make_unique<OrNode>();
+    orn->dedup = false;
+    for (auto&& range : ranges) {
+        auto csn = std::make_unique<CountScanNode>(isn->index);
+        csn->startKey = std::move(range.startKey);
+        csn->startKeyInclusive = range.startKeyInclusive;
+        csn->endKey = std::move(range.endKey);
+        csn->endKeyInclusive = range.endKeyInclusive;
+        orn->children.push_back(csn.release());
+    }
+    // Takes ownership of 'orn' and deletes the old root.
+    soln->root = std::move(orn);
+    return true;
+}
+
 /**
  * Returns 'true' if the provided solution 'soln' can be rewritten to use
  * a fast counting stage.  Mutates the tree in 'soln->root'.
@@ -1160,7 +1256,7 @@ bool turnIxscanIntoCount(QuerySolution* soln) {
 
     if (!IndexBoundsBuilder::isSingleInterval(
             isn->bounds, &startKey, &startKeyInclusive, &endKey, &endKeyInclusive)) {
-        return false;
+        return turnIxscanIntoCountOfRanges(soln, isn);
     }
 
     // Make the count node that we replace the fetch + ixscan with.
@@ -1287,6 +1383,21 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorCount(
         return PlanExecutor::make(opCtx, std::move(ws), std::move(root), nss, yieldPolicy);
     }
 
+    // An approximate count is estimated from a random sample of the collection rather than by
+    // planning the query, unless the collection is small enough to count in full or the sample
+    // would need filtering by shard.
+    const long long sampleSize = internalQueryApproxCountSampleSize.load();
+    if (request.getApprox() && !OperationShardingState::isOperationVersioned(opCtx) &&
+        collection->numRecords(opCtx) > sampleSize) {
+        if (auto randomCursor = collection->getRecordStore()->getRandomCursor(opCtx)) {
+            const MatchExpression* filter = cq->root();
+            unique_ptr<PlanStage> root = std::make_unique<SampledCountStage>(
+                opCtx, collection, std::move(randomCursor), filter, sampleSize, skip, limit);
+            return PlanExecutor::make(
+                opCtx, std::move(ws), std::move(root), std::move(cq), collection, yieldPolicy);
+        }
+    }
+
     size_t plannerOptions = QueryPlannerParams::IS_COUNT;
     if (OperationShardingState::isOperationVersioned(opCtx)) {
         plannerOptions |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
@@ -1168,4 +1168,48 @@ bool IndexBoundsBuilder::isSingleInterval(const IndexBounds& bounds,
     }
 }
 
+// static
+bool IndexBoundsBuilder::isUnionOfSingleIntervals(const IndexBounds& bounds,
+                                                  size_t maxRanges,
+                                                  std::vector<KeyRange>* rangesOut) {
+    size_t numRanges = 1;
+    for (auto&& oil : bounds.fields) {
+        if (oil.intervals.empty()) {
+            return false;
+        }
+        numRanges *= oil.intervals.size();
+        if (numRanges > maxRanges) {
+            return false;
+        }
+    }
+
+    // 'positions' holds the interval of each field which the current combination uses. The last
+    // field advances fastest, so that the ranges come out in index order.
+    std::vector<size_t> positions(bounds.fields.size(), 0);
+    IndexBounds combination = bounds;
+    for (size_t n = 0; n < numRanges; ++n) {
+        for (size_t i = 0; i < positions.size(); ++i) {
+            combination.fields[i].intervals.assign(1, bounds.fields[i].intervals[positions[i]]);
+        }
+
+        KeyRange range;
+        if (!isSingleInterval(combination,
+                              &range.startKey,
+                              &range.startKeyInclusive,
+                              &range.endKey,
+                              &range.endKeyInclusive)) {
+            return false;
+        }
+        rangesOut->push_back(std::move(range));
+
+        for (size_t i = positions.size(); i-- > 0;) {
+            if (++positions[i] < bounds.fields[i].intervals.size()) {
+                break;
+            }
+            positions[i] = 0;
+        }
+    }
+    return true;
+}
+
 }  // namespace mongo
@@ -203,6 +203,26 @@ public:
                                  BSONObj* endKey,
                                  bool* endKeyInclusive);
 
+    /**
+     * One interval between 'startKey' and 'endKey', as isSingleInterval() produces them.
+     */
+    struct KeyRange {
+        BSONObj startKey;
+        bool startKeyInclusive;
+        BSONObj endKey;
+        bool endKeyInclusive;
+    };
+
+    /**
+     * Returns 'true' if the bounds 'bounds' can be represented as at most 'maxRanges' intervals,
+     * one for each combination of an interval from every field, and appends them to 'rangesOut'
+     * in index order. As the intervals of each field are disjoint, so are the ranges. Returns
+     * 'false' if otherwise, or if the bounds contain no keys.
+     */
+    static bool isUnionOfSingleIntervals(const IndexBounds& bounds,
+                                         size_t maxRanges,
+                                         std::vector<KeyRange>* rangesOut);
+
 private:
     /**
      * Performs the heavy lifting for IndexBoundsBuilder::translate().
@@ -1826,6 +1826,80 @@ TEST(IndexBoundsBuilderTest, EqualitySingleMissingSingleInterval) {
     ASSERT(!testSingleInterval(bounds));
 }
 
+//
+// isUnionOfSingleIntervals
+//
+
+TEST(IndexBoundsBuilderTest, InIntervalsOnSingleFieldAreUnionOfSingleIntervals) {
+    OrderedIntervalList oil("a");
+    IndexBounds bounds;
+    oil.intervals.push_back(Interval(BSON("" << 3 << "" << 3), true, true));
+    oil.intervals.push_back(Interval(fromjson("{ '':5, '':7 }"), false, true));
+    bounds.fields.push_back(oil);
+
+    std::vector<IndexBoundsBuilder::KeyRange> ranges;
+    ASSERT(IndexBoundsBuilder::isUnionOfSingleIntervals(bounds, 10, &ranges));
+    ASSERT_EQ(ranges.size(), 2U);
+    ASSERT_BSONOBJ_EQ(ranges[0].startKey, BSON("" << 3));
+    ASSERT_BSONOBJ_EQ(ranges[0].endKey, BSON("" << 3));
+    ASSERT(ranges[0].startKeyInclusive);
+    ASSERT(ranges[0].endKeyInclusive);
+    ASSERT_BSONOBJ_EQ(ranges[1].startKey, BSON("" << 5));
+    ASSERT_BSONOBJ_EQ(ranges[1].endKey, BSON("" << 7));
+    ASSERT(!ranges[1].startKeyInclusive);
+    ASSERT(ranges[1].endKeyInclusive);
+}
+
+TEST(IndexBoundsBuilderTest, PointCombinationsOnTwoFieldsAreUnionOfSingleIntervalsInIndexOrder) {
+    OrderedIntervalList oil_a("a");
+    OrderedIntervalList oil_b("b");
+    IndexBounds bounds;
+    oil_a.intervals.push_back(Interval(BSON("" << 1 << "" << 1), true, true));
+    oil_a.intervals.push_back(Interval(BSON("" << 2 << "" << 2), true, true));
+    oil_b.intervals.push_back(Interval(BSON("" << 8 << "" << 8), true, true));
+    oil_b.intervals.push_back(Interval(fromjson("{ '':9, '':Infinity }"), true, true));
+    bounds.fields.push_back(oil_a);
+    bounds.fields.push_back(oil_b);
+
+    std::vector<IndexBoundsBuilder::KeyRange> ranges;
+    ASSERT(IndexBoundsBuilder::isUnionOfSingleIntervals(bounds, 4, &ranges));
+    ASSERT_EQ(ranges.size(), 4U);
+    ASSERT_BSONOBJ_EQ(ranges[0].startKey, BSON("" << 1 << "" << 8));
+    ASSERT_BSONOBJ_EQ(ranges[1].startKey, BSON("" << 1 << "" << 9));
+    ASSERT_BSONOBJ_EQ(ranges[1].endKey, fromjson("{ '':1, '':Infinity }"));
+    ASSERT_BSONOBJ_EQ(ranges[2].startKey, BSON("" << 2 << "" << 8));
+    ASSERT_BSONOBJ_EQ(ranges[3].startKey, BSON("" << 2 << "" << 9));
+
+    // There are more combinations than allowed.
+    ranges.clear();
+    ASSERT(!IndexBoundsBuilder::isUnionOfSingleIntervals(bounds, 3, &ranges));
+}
+
+TEST(IndexBoundsBuilderTest, RangeFollowedByIntervalsIsNotUnionOfSingleIntervals) {
+    // Once the first field is a range, a combination can only be a single interval if every
+    // later field takes all values.
+    OrderedIntervalList oil_a("a");
+    OrderedIntervalList oil_b("b");
+    IndexBounds bounds;
+    oil_a.intervals.push_back(Interval(fromjson("{ '':1, '':5 }"), true, true));
+    oil_b.intervals.push_back(Interval(BSON("" << 8 << "" << 8), true, true));
+    oil_b.intervals.push_back(Interval(BSON("" << 9 << "" << 9), true, true));
+    bounds.fields.push_back(oil_a);
+    bounds.fields.push_back(oil_b);
+
+    std::vector<IndexBoundsBuilder::KeyRange> ranges;
+    ASSERT(!IndexBoundsBuilder::isUnionOfSingleIntervals(bounds, 10, &ranges));
+}
+
+TEST(IndexBoundsBuilderTest, EmptyBoundsAreNotUnionOfSingleIntervals) {
+    OrderedIntervalList oil("a");
+    IndexBounds bounds;
+    bounds.fields.push_back(oil);
+
+    std::vector<IndexBoundsBuilder::KeyRange> ranges;
+    ASSERT(!IndexBoundsBuilder::isUnionOfSingleIntervals(bounds, 10, &ranges));
+}
+
 //
 // Complementing bounds for negations
 //
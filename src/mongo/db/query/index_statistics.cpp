@@ -0,0 +1,284 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+
+namespace {
+
+bool isUnionOfPoints(const OrderedIntervalList& oil) {
+    if (oil.intervals.empty()) {
+        return false;
+    }
+    for (auto&& interval : oil.intervals) {
+        if (!interval.isPoint()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+FieldHistogram::FieldHistogram(std::vector<BSONObj> sample, long long numRecords)
+    : _sample(std::move(sample)) {
+    std::sort(_sample.begin(), _sample.end(), [](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs.firstElement().woCompare(rhs.firstElement(), false) < 0;
+    });
+
+    // Count the distinct values of the sample, and how many of them it holds only once.
+    size_t numDistinct = 0;
+    size_t numSingletons = 0;
+    for (size_t i = 0; i < _sample.size();) {
+        size_t end = i + 1;
+        while (end < _sample.size() &&
+               _sample[end].firstElement().woCompare(_sample[i].firstElement(), false) == 0) {
+            ++end;
+        }
+        ++numDistinct;
+        numSingletons += (end - i == 1);
+        i = end;
+    }
+
+    const double sampleSize = _sample.size();
+    if (numRecords <= static_cast<long long>(_sample.size())) {
+        _numDistinct = numDistinct;
+        return;
+    }
+
+    // The values seen more than once are likely to be all there is of the frequent values, while
+    // each value seen once stands for a number of values which the sample missed. This is the
+    // "guaranteed-error estimator" of Charikar et al.
+    _numDistinct =
+        std::sqrt(numRecords / sampleSize) * numSingletons + (numDistinct - numSingletons);
+}
+
+size_t FieldHistogram::_countInInterval(const Interval& interval) const {
+    BSONElement start = interval.start;
+    BSONElement end = interval.end;
+    bool startInclusive = interval.startInclusive;
+    bool endInclusive = interval.endInclusive;
+    if (start.woCompare(end, false) > 0) {
+        // The interval was reversed for a descending scan.
+        std::swap(start, end);
+        std::swap(startInclusive, endInclusive);
+    }
+
+    auto lowerBound = [this](const BSONElement& elt) {
+        return std::lower_bound(
+            _sample.begin(), _sample.end(), elt, [](const BSONObj& obj, const BSONElement& elt) {
+                return obj.firstElement().woCompare(elt, false) < 0;
+            });
+    };
+    auto upperBound = [this](const BSONElement& elt) {
+        return std::upper_bound(
+            _sample.begin(), _sample.end(), elt, [](const BSONElement& elt, const BSONObj& obj) {
+                return elt.woCompare(obj.firstElement(), false) < 0;
+            });
+    };
+
+    auto first = startInclusive ? lowerBound(start) : upperBound(start);
+    auto last = endInclusive ? upperBound(end) : lowerBound(end);
+    return last > first ? last - first : 0;
+}
+
+double FieldHistogram::estimateFraction(const OrderedIntervalList& oil) const {
+    if (_sample.empty()) {
+        return 0;
+    }
+
+    const double sampleSize = _sample.size();
+    double fraction = 0;
+    for (auto&& interval : oil.intervals) {
+        const double count = _countInInterval(interval);
+        if (interval.isPoint()) {
+            // A value the sample missed is assumed to be as frequent as an average value.
+            fraction += std::max(count / sampleSize, 1 / _numDistinct);
+        } else {
+            fraction += count / sampleSize;
+        }
+    }
+    return std::min(1.0, fraction);
+}
+
+const FieldHistogram* CollectionIndexStatistics::getHistogram(StringData path) const {
+    auto it = _histograms.find(path);
+    return it == _histograms.end() ? nullptr : &it->second;
+}
+
+const WildcardPathStatistics* CollectionIndexStatistics::getWildcardPathStatistics(
+    StringData path) const {
+    auto it = _wildcardPaths.find(path);
+    return it == _wildcardPaths.end() ? nullptr : &it->second;
+}
+
+boost::optional<double> CollectionIndexStatistics::estimateCost(
+    const QuerySolutionNode* root) const {
+    if (auto estimate = _estimate(root)) {
+        return estimate->cost;
+    }
+    return boost::none;
+}
+
+boost::optional<double> CollectionIndexStatistics::estimateNumKeys(
+    const IndexScanNode* node) const {
+    // The histograms describe the values of the documents, which are only the keys of a regular
+    // index with one key per document.
+    const IndexEntry& index = node->index;
+    if (index.type == INDEX_WILDCARD) {
+        return _estimateWildcardNumKeys(node);
+    }
+    if (index.type != INDEX_BTREE || index.multikey || index.filterExpr || index.collator ||
+        node->bounds.isSimpleRange) {
+        return boost::none;
+    }
+
+    // Assuming that the fields are independent, every field bound to points narrows the scan
+    // down, and so does the first field which is bound to a range. Past that one, the scan
+    // examines every key within the bounds of the preceding fields.
+    double fraction = 1;
+    for (size_t i = 0; i < node->bounds.fields.size(); ++i) {
+        const OrderedIntervalList& oil = node->bounds.fields[i];
+        const FieldHistogram* histogram = getHistogram(oil.name);
+        if (!histogram) {
+            if (i == 0) {
+                return boost::none;
+            }
+            break;
+        }
+        fraction *= histogram->estimateFraction(oil);
+        if (!isUnionOfPoints(oil)) {
+            break;
+        }
+    }
+    return fraction * _numRecords;
+}
+
+boost::optional<double> CollectionIndexStatistics::_estimateWildcardNumKeys(
+    const IndexScanNode* node) const {
+    // Only a scan of the keys of a single path, whose values are compared without a collation,
+    // matches the statistics. Scans which also visit the subpaths or the array index permutations
+    // of a path have more than one interval on "$_path".
+    const IndexEntry& index = node->index;
+    if (_wildcardPaths.empty() || index.collator || node->bounds.isSimpleRange ||
+        node->bounds.fields.size() != 2 || node->bounds.fields[0].intervals.size() != 1 ||
+        !node->bounds.fields[0].intervals[0].isPoint()) {
+        return boost::none;
+    }
+
+    // Paths which none of the sampled documents has are assumed to be rare.
+    const WildcardPathStatistics* pathStatistics =
+        getWildcardPathStatistics(node->bounds.fields[1].name);
+    if (!pathStatistics) {
+        return 0.0;
+    }
+    return pathStatistics->numKeys *
+        pathStatistics->histogram.estimateFraction(node->bounds.fields[1]);
+}
+
+boost::optional<CollectionIndexStatistics::Estimate> CollectionIndexStatistics::_estimate(
+    const QuerySolutionNode* node) const {
+    std::vector<Estimate> children;
+    for (auto child : node->children) {
+        auto estimate = _estimate(child);
+        if (!estimate) {
+            return boost::none;
+        }
+        children.push_back(*estimate);
+    }
+
+    switch (node->getType()) {
+        case STAGE_COLLSCAN:
+            return Estimate{static_cast<double>(_numRecords), static_cast<double>(_numRecords)};
+        case STAGE_IXSCAN: {
+            auto numKeys = estimateNumKeys(static_cast<const IndexScanNode*>(node));
+            if (!numKeys) {
+                return boost::none;
+            }
+            // Count the initial seek, so that no scan is free.
+            return Estimate{*numKeys, *numKeys + 1};
+        }
+        case STAGE_FETCH:
+            // Filters are not accounted for, so every fetched document is returned.
+            return Estimate{children[0].numResults, children[0].cost + children[0].numResults};
+        case STAGE_OR:
+        case STAGE_SORT_MERGE: {
+            Estimate estimate{0, 0};
+            for (auto&& child : children) {
+                estimate.numResults += child.numResults;
+                estimate.cost += child.cost;
+            }
+            return estimate;
+        }
+        case STAGE_AND_HASH:
+        case STAGE_AND_SORTED: {
+            Estimate estimate{children[0].numResults, 0};
+            for (auto&& child : children) {
+                estimate.numResults = std::min(estimate.numResults, child.numResults);
+                estimate.cost += child.cost;
+            }
+            return estimate;
+        }
+        case STAGE_PROJECTION_COVERED:
+        case STAGE_PROJECTION_DEFAULT:
+        case STAGE_PROJECTION_SIMPLE:
+        case STAGE_SHARDING_FILTER:
+        case STAGE_SORT:
+        case STAGE_SORT_KEY_GENERATOR:
+            return children[0];
+        default:
+            return boost::none;
+    }
+}
+
+std::shared_ptr<const CollectionIndexStatistics> IndexStatisticsCache::get() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _statistics;
+}
+
+void IndexStatisticsCache::set(std::shared_ptr<const CollectionIndexStatistics> statistics) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _statistics = std::move(statistics);
+}
+
+void IndexStatisticsCache::clear() {
+    set(nullptr);
+}
+
+}  // namespace mongo
@@ -0,0 +1,175 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+struct IndexScanNode;
+struct QuerySolutionNode;
+
+/**
+ * An equi-depth histogram of the values which one field takes across a collection, built from a
+ * uniform random sample of its documents. Each sampled value bounds a bucket holding an equal
+ * share of the collection, so the fraction of the documents whose value falls in a range is
+ * estimated from the number of sampled values in it. The number of distinct values in the whole
+ * collection is extrapolated from the frequencies in the sample.
+ */
+class FieldHistogram {
+public:
+    /**
+     * 'sample' holds one single-element object per sampled document, in any order, out of a
+     * collection of 'numRecords' documents.
+     */
+    FieldHistogram(std::vector<BSONObj> sample, long long numRecords);
+
+    /**
+     * Returns the estimated fraction of the documents whose value for the field lies within
+     * 'oil', between 0 and 1.
+     */
+    double estimateFraction(const OrderedIntervalList& oil) const;
+
+    /**
+     * Returns the estimated number of distinct values of the field in the collection.
+     */
+    double estimateNumDistinct() const {
+        return _numDistinct;
+    }
+
+private:
+    /**
+     * Returns the number of sampled values which lie within 'interval'.
+     */
+    size_t _countInInterval(const Interval& interval) const;
+
+    // Sorted by value.
+    std::vector<BSONObj> _sample;
+
+    double _numDistinct = 0;
+};
+
+/**
+ * The keys which the $** indexes of a collection hold for one path: their estimated number, and a
+ * histogram of their values built from the keys of the sampled documents. Unlike the histograms of
+ * regular indexes, these count one entry per key rather than per document, so that the elements
+ * of an array each count once.
+ */
+struct WildcardPathStatistics {
+    double numKeys;
+    FieldHistogram histogram;
+};
+
+/**
+ * Statistics on the fields of the indexes of a collection, used to estimate the cost of candidate
+ * plans before, or instead of, racing them against each other.
+ */
+class CollectionIndexStatistics {
+public:
+    CollectionIndexStatistics(long long numRecords,
+                              StringMap<FieldHistogram> histograms,
+                              StringMap<WildcardPathStatistics> wildcardPaths = {})
+        : _numRecords(numRecords),
+          _histograms(std::move(histograms)),
+          _wildcardPaths(std::move(wildcardPaths)) {}
+
+    /**
+     * The number of documents in the collection at the time the sample was taken.
+     */
+    long long numRecords() const {
+        return _numRecords;
+    }
+
+    /**
+     * Returns the histogram for the field 'path', or nullptr if there is none.
+     */
+    const FieldHistogram* getHistogram(StringData path) const;
+
+    /**
+     * Returns the statistics on the $** index keys for 'path', or nullptr if none of the sampled
+     * documents has such keys.
+     */
+    const WildcardPathStatistics* getWildcardPathStatistics(StringData path) const;
+
+    /**
+     * Returns the estimated number of keys and documents which the solution rooted at 'root'
+     * examines, or boost::none if the solution cannot be estimated.
+     */
+    boost::optional<double> estimateCost(const QuerySolutionNode* root) const;
+
+    /**
+     * Returns the estimated number of keys which the index scan 'node' examines, or boost::none if
+     * it cannot be estimated.
+     */
+    boost::optional<double> estimateNumKeys(const IndexScanNode* node) const;
+
+private:
+    struct Estimate {
+        double numResults;
+        double cost;
+    };
+
+    boost::optional<Estimate> _estimate(const QuerySolutionNode* node) const;
+
+    boost::optional<double> _estimateWildcardNumKeys(const IndexScanNode* node) const;
+
+    long long _numRecords;
+    StringMap<FieldHistogram> _histograms;
+
+    // Empty unless the collection has a $** index.
+    StringMap<WildcardPathStatistics> _wildcardPaths;
+};
+
+/**
+ * Holds the most recent CollectionIndexStatistics built for a collection. The statistics are
+ * immutable once built, so readers share them and a refresh replaces them as a whole.
+ */
+class IndexStatisticsCache {
+public:
+    std::shared_ptr<const CollectionIndexStatistics> get() const;
+
+    void set(std::shared_ptr<const CollectionIndexStatistics> statistics);
+
+    void clear();
+
+private:
+    mutable stdx::mutex _mutex;
+    std::shared_ptr<const CollectionIndexStatistics> _statistics;
+};
+
+}  // namespace mongo
@@ -0,0 +1,268 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_statistics.h"
+
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<BSONObj> makeSample(const std::vector<int>& values) {
+    std::vector<BSONObj> sample;
+    for (auto value : values) {
+        sample.push_back(BSON("" << value));
+    }
+    return sample;
+}
+
+/**
+ * Returns the values 0 to 'n' - 1, each repeated 'repeats' times.
+ */
+std::vector<int> makeValues(int n, int repeats = 1) {
+    std::vector<int> values;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < repeats; ++j) {
+            values.push_back(i);
+        }
+    }
+    return values;
+}
+
+OrderedIntervalList makeOil(const std::string& name, std::vector<Interval> intervals) {
+    OrderedIntervalList oil(name);
+    oil.intervals = std::move(intervals);
+    return oil;
+}
+
+IndexEntry buildSimpleIndexEntry(const BSONObj& kp) {
+    return {kp,
+            IndexNames::nameToType(IndexNames::findPluginName(kp)),
+            false,
+            {},
+            {},
+            false,
+            false,
+            CoreIndexInfo::Identifier("test_foo"),
+            nullptr,
+            {},
+            nullptr,
+            nullptr};
+}
+
+TEST(FieldHistogramTest, EstimatesFractionOfRanges) {
+    FieldHistogram histogram(makeSample(makeValues(100)), 100);
+
+    const auto range = makeOil("a", {Interval(BSON("" << 10 << "" << 20), true, false)});
+    ASSERT_APPROX_EQUAL(0.1, histogram.estimateFraction(range), 1e-9);
+
+    // Intervals reversed for a descending scan are counted the same way.
+    const auto reversed = makeOil("a", {Interval(BSON("" << 20 << "" << 10), false, true)});
+    ASSERT_APPROX_EQUAL(0.1, histogram.estimateFraction(reversed), 1e-9);
+
+    const auto disjoint = makeOil("a",
+                                {Interval(BSON("" << -5 << "" << 4), true, true),
+                                 Interval(BSON("" << 90 << "" << 1000), false, true)});
+    ASSERT_APPROX_EQUAL(0.14, histogram.estimateFraction(disjoint), 1e-9);
+
+    const auto strings = makeOil("a", {Interval(BSON("" << "a" << "" << "z"), true, true)});
+    ASSERT_EQUALS(0.0, histogram.estimateFraction(strings));
+
+    OrderedIntervalList all("a");
+    IndexBoundsBuilder::allValuesForField(BSON("a" << 1).firstElement(), &all);
+    ASSERT_APPROX_EQUAL(1.0, histogram.estimateFraction(all), 1e-9);
+}
+
+TEST(FieldHistogramTest, EstimatesFractionOfPoints) {
+    std::vector<int> values(50, 1000);
+    for (auto value : makeValues(50)) {
+        values.push_back(value);
+    }
+    FieldHistogram histogram(makeSample(values), 100);
+    ASSERT_EQUALS(51.0, histogram.estimateNumDistinct());
+
+    // A frequent value is estimated from its frequency in the sample.
+    const auto frequent = makeOil("a", {IndexBoundsBuilder::makePointInterval(BSON("" << 1000))});
+    ASSERT_APPROX_EQUAL(0.5, histogram.estimateFraction(frequent), 1e-9);
+
+    // Other values are assumed to be as frequent as the average value.
+    const auto missing = makeOil("a", {IndexBoundsBuilder::makePointInterval(BSON("" << -1))});
+    ASSERT_APPROX_EQUAL(1 / 51.0, histogram.estimateFraction(missing), 1e-9);
+}
+
+TEST(FieldHistogramTest, ExtrapolatesNumDistinct) {
+    // Every value seen once in a sample of 1% of the collection.
+    ASSERT_APPROX_EQUAL(
+        1000.0, FieldHistogram(makeSample(makeValues(100)), 10000).estimateNumDistinct(), 1e-9);
+
+    // Values which are all seen twice are likely to be all the values there are.
+    ASSERT_APPROX_EQUAL(
+        50.0, FieldHistogram(makeSample(makeValues(50, 2)), 10000).estimateNumDistinct(), 1e-9);
+
+    // A sample of the whole collection holds every value.
+    ASSERT_APPROX_EQUAL(
+        100.0, FieldHistogram(makeSample(makeValues(100)), 100).estimateNumDistinct(), 1e-9);
+
+    ASSERT_EQUALS(0.0, FieldHistogram({}, 0).estimateNumDistinct());
+}
+
+class CollectionIndexStatisticsTest : public unittest::Test {
+protected:
+    CollectionIndexStatisticsTest() : statistics(1000, makeHistograms()) {}
+
+    static StringMap<FieldHistogram> makeHistograms() {
+        StringMap<FieldHistogram> histograms;
+        histograms.emplace("a", FieldHistogram(makeSample(makeValues(100)), 1000));
+        histograms.emplace("b", FieldHistogram(makeSample(makeValues(10, 10)), 1000));
+        return histograms;
+    }
+
+    static std::unique_ptr<IndexScanNode> makeIndexScan(
+        const BSONObj& keyPattern, std::vector<OrderedIntervalList> fields) {
+        auto ixscan = std::make_unique<IndexScanNode>(buildSimpleIndexEntry(keyPattern));
+        ixscan->bounds.fields = std::move(fields);
+        return ixscan;
+    }
+
+    static std::unique_ptr<FetchNode> makeFetch(std::unique_ptr<QuerySolutionNode> child) {
+        auto fetch = std::make_unique<FetchNode>();
+        fetch->children.push_back(child.release());
+        return fetch;
+    }
+
+    CollectionIndexStatistics statistics;
+};
+
+TEST_F(CollectionIndexStatisticsTest, EstimatesCollectionScan) {
+    CollectionScanNode collscan;
+    ASSERT_APPROX_EQUAL(1000.0, *statistics.estimateCost(&collscan), 1e-9);
+}
+
+TEST_F(CollectionIndexStatisticsTest, EstimatesFetchedIndexScan) {
+    auto fetch = makeFetch(makeIndexScan(
+        BSON("a" << 1), {makeOil("a", {Interval(BSON("" << 10 << "" << 20), true, false)})}));
+
+    // One hundred keys and documents, and the seek.
+    ASSERT_APPROX_EQUAL(201.0, *statistics.estimateCost(fetch.get()), 1e-9);
+}
+
+TEST_F(CollectionIndexStatisticsTest, EstimatesCompoundIndexScan) {
+    OrderedIntervalList all("c");
+    IndexBoundsBuilder::allValuesForField(BSON("c" << 1).firstElement(), &all);
+    auto ixscan = makeIndexScan(
+        BSON("b" << 1 << "a" << 1 << "c" << 1),
+        {makeOil("b", {IndexBoundsBuilder::makePointInterval(BSON("" << 3))}),
+         makeOil("a", {Interval(BSON("" << 10 << "" << 20), true, false)}),
+         all});
+
+    // The point on 'b' and the range on 'a' each keep a tenth of the keys.
+    ASSERT_APPROX_EQUAL(11.0, *statistics.estimateCost(ixscan.get()), 1e-9);
+}
+
+TEST_F(CollectionIndexStatisticsTest, EstimatesOr) {
+    OrNode orNode;
+    orNode.children.push_back(
+        makeIndexScan(BSON("a" << 1),
+                      {makeOil("a", {Interval(BSON("" << 10 << "" << 20), true, false)})})
+            .release());
+    orNode.children.push_back(
+        makeIndexScan(BSON("b" << 1),
+                      {makeOil("b", {IndexBoundsBuilder::makePointInterval(BSON("" << 3))})})
+            .release());
+    ASSERT_APPROX_EQUAL(202.0, *statistics.estimateCost(&orNode), 1e-9);
+}
+
+TEST_F(CollectionIndexStatisticsTest, CannotEstimateUnknownFieldsOrIndexes) {
+    auto noHistogram = makeIndexScan(
+        BSON("c" << 1), {makeOil("c", {IndexBoundsBuilder::makePointInterval(BSON("" << 3))})});
+    ASSERT_FALSE(statistics.estimateCost(noHistogram.get()));
+
+    auto multikey = makeIndexScan(
+        BSON("a" << 1), {makeOil("a", {IndexBoundsBuilder::makePointInterval(BSON("" << 3))})});
+    multikey->index.multikey = true;
+    ASSERT_FALSE(statistics.estimateCost(multikey.get()));
+
+    // A fetch over a scan which cannot be estimated cannot be estimated either.
+    ASSERT_FALSE(statistics.estimateCost(makeFetch(std::move(noHistogram)).get()));
+}
+
+TEST(CollectionIndexStatisticsWildcardTest, EstimatesWildcardIndexScansFromPathStatistics) {
+    // Every document has two elements in an array under 'x', and a tenth of them has a 'y'.
+    StringMap<WildcardPathStatistics> wildcardPaths;
+    wildcardPaths.emplace(
+        "x", WildcardPathStatistics{2000, FieldHistogram(makeSample(makeValues(100)), 2000)});
+    wildcardPaths.emplace(
+        "y", WildcardPathStatistics{100, FieldHistogram(makeSample(makeValues(10, 10)), 100)});
+    CollectionIndexStatistics statistics(1000, {}, std::move(wildcardPaths));
+
+    auto makeWildcardScan = [](const std::string& path,
+                               std::vector<Interval> pathIntervals,
+                               std::vector<Interval> valueIntervals) {
+        auto ixscan = std::make_unique<IndexScanNode>(buildSimpleIndexEntry(BSON("$**" << 1)));
+        ixscan->index.keyPattern = BSON("$_path" << 1 << path << 1);
+        ixscan->bounds.fields = {makeOil("$_path", std::move(pathIntervals)),
+                                 makeOil(path, std::move(valueIntervals))};
+        return ixscan;
+    };
+
+    auto x = makeWildcardScan("x",
+                              {IndexBoundsBuilder::makePointInterval("x")},
+                              {Interval(BSON("" << 10 << "" << 20), true, false)});
+    ASSERT_APPROX_EQUAL(200.0, *statistics.estimateNumKeys(x.get()), 1e-9);
+
+    auto y = makeWildcardScan("y",
+                              {IndexBoundsBuilder::makePointInterval("y")},
+                              {IndexBoundsBuilder::makePointInterval(BSON("" << 3))});
+    ASSERT_APPROX_EQUAL(10.0, *statistics.estimateNumKeys(y.get()), 1e-9);
+
+    // No sampled document has a 'z'.
+    auto z = makeWildcardScan("z",
+                              {IndexBoundsBuilder::makePointInterval("z")},
+                              {IndexBoundsBuilder::makePointInterval(BSON("" << 3))});
+    ASSERT_EQUALS(0.0, *statistics.estimateNumKeys(z.get()));
+
+    // The keys of the subpaths of 'x' are not accounted for.
+    OrderedIntervalList all("x");
+    IndexBoundsBuilder::allValuesForField(BSON("x" << 1).firstElement(), &all);
+    auto subpaths = makeWildcardScan(
+        "x",
+        {IndexBoundsBuilder::makePointInterval("x"),
+         IndexBoundsBuilder::makeRangeInterval("x.", "x/", BoundInclusion::kIncludeStartKeyOnly)},
+        all.intervals);
+    ASSERT_FALSE(statistics.estimateNumKeys(subpaths.get()));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,337 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/parameterized_solution.h"
+
+#include <algorithm>
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns the predicates of the conjunction 'root'.
+ */
+std::vector<const MatchExpression*> getPredicates(const MatchExpression* root) {
+    if (root->matchType() != MatchExpression::AND) {
+        return {root};
+    }
+    std::vector<const MatchExpression*> predicates;
+    for (size_t i = 0; i < root->numChildren(); ++i) {
+        predicates.push_back(root->getChild(i));
+    }
+    return predicates;
+}
+
+bool isBindablePredicate(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            break;
+        default:
+            return false;
+    }
+
+    // Null, MinKey and MaxKey bounds lead the planner to special cases, and regexes are
+    // not comparisons at all.
+    switch (static_cast<const ComparisonMatchExpressionBase*>(expr)->getData().type()) {
+        case jstNULL:
+        case Undefined:
+        case MinKey:
+        case MaxKey:
+        case RegEx:
+            return false;
+        default:
+            return !expr->path().empty();
+    }
+}
+
+bool isQueryParameterizable(const CanonicalQuery& query) {
+    const QueryRequest& qr = query.getQueryRequest();
+    return !qr.getSkip() && !qr.getLimit() && !qr.getNToReturn() && !qr.isTailable();
+}
+
+bool isPointField(const OrderedIntervalList& oil) {
+    return oil.intervals.size() == 1 && oil.intervals[0].isPoint();
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<ParameterizedSolution> ParameterizedSolution::make(
+    const CanonicalQuery& query, const QueryPlannerParams& params, const QuerySolution& soln) {
+    if (!internalQueryCacheParameterizeSolutions.load() || !isQueryParameterizable(query) ||
+        !soln.root) {
+        return nullptr;
+    }
+
+    const auto predicates = getPredicates(query.root());
+    if (predicates.empty()) {
+        return nullptr;
+    }
+    for (auto predicate : predicates) {
+        if (!isBindablePredicate(predicate)) {
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<ParameterizedSolution> parameterized(new ParameterizedSolution());
+
+    // The projection, if any, is at the root.
+    const QuerySolutionNode* node = soln.root.get();
+    switch (node->getType()) {
+        case STAGE_PROJECTION_DEFAULT:
+            parameterized->_projectionType = ProjectionType::kDefault;
+            break;
+        case STAGE_PROJECTION_SIMPLE:
+            parameterized->_projectionType = ProjectionType::kSimple;
+            break;
+        case STAGE_PROJECTION_COVERED:
+            parameterized->_projectionType = ProjectionType::kCovered;
+            parameterized->_coveredKeyObj =
+                static_cast<const ProjectionNodeCovered*>(node)->coveredKeyObj.getOwned();
+            break;
+        default:
+            break;
+    }
+    if (parameterized->_projectionType != ProjectionType::kNone) {
+        node = node->children[0];
+    }
+    const QuerySolutionNode* subtreeRoot = node;
+
+    // The rest of the solution must be a chain leading to a single index scan, none of which
+    // depends on the constants of the query.
+    const IndexScanNode* ixscan = nullptr;
+    while (!ixscan) {
+        if (node->filter) {
+            return nullptr;
+        }
+        switch (node->getType()) {
+            case STAGE_IXSCAN:
+                ixscan = static_cast<const IndexScanNode*>(node);
+                continue;
+            case STAGE_SORT:
+                if (static_cast<const SortNode*>(node)->limit) {
+                    return nullptr;
+                }
+                break;
+            case STAGE_FETCH:
+            case STAGE_SHARDING_FILTER:
+            case STAGE_SORT_KEY_GENERATOR:
+                break;
+            default:
+                return nullptr;
+        }
+        if (node->children.size() != 1) {
+            return nullptr;
+        }
+        node = node->children[0];
+    }
+
+    // Predicates on other index types, and the partial filter expression of an index, might no
+    // longer be answered by the index for different constants.
+    const IndexEntry& index = ixscan->index;
+    if (index.type != INDEX_BTREE || index.multikey || index.filterExpr ||
+        !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+        return nullptr;
+    }
+
+    std::vector<std::string> fields;
+    for (auto&& elt : index.keyPattern) {
+        fields.push_back(elt.fieldName());
+    }
+    parameterized->_boundsSources.resize(fields.size());
+    for (size_t i = 0; i < predicates.size(); ++i) {
+        auto field = std::find(fields.begin(), fields.end(), predicates[i]->path());
+        if (field == fields.end()) {
+            return nullptr;
+        }
+        parameterized->_boundsSources[field - fields.begin()].push_back(i);
+        parameterized->_predicates.push_back(
+            {predicates[i]->matchType(), predicates[i]->path().toString()});
+    }
+    for (auto&& oil : ixscan->bounds.fields) {
+        parameterized->_pointFields.push_back(isPointField(oil));
+    }
+
+    parameterized->_root.reset(subtreeRoot->clone());
+    for (QuerySolutionNode* copy = parameterized->_root.get(); !copy->children.empty();
+         copy = copy->children[0]) {
+        // The template outlives the query, so it must own the sort patterns it holds.
+        if (copy->getType() == STAGE_SORT) {
+            auto sortNode = static_cast<SortNode*>(copy);
+            sortNode->pattern = sortNode->pattern.getOwned();
+        } else if (copy->getType() == STAGE_SORT_KEY_GENERATOR) {
+            auto keyGenNode = static_cast<SortKeyGeneratorNode*>(copy);
+            keyGenNode->sortSpec = keyGenNode->sortSpec.getOwned();
+        }
+    }
+
+    // Binding the constants of 'query' itself must reproduce what the planner built.
+    IndexBounds bounds;
+    if (ixscan->bounds.fields.size() != fields.size() ||
+        !parameterized->_bindBounds(query.root(), &bounds) || !(bounds == ixscan->bounds)) {
+        return nullptr;
+    }
+
+    parameterized->_plannerOptions = params.options;
+    parameterized->_indexFiltersApplied = params.indexFiltersApplied;
+    parameterized->_indexFilterApplied = soln.indexFilterApplied;
+    parameterized->_hasBlockingStage = soln.hasBlockingStage;
+    return parameterized;
+}
+
+bool ParameterizedSolution::_matchesPredicates(const CanonicalQuery& query) const {
+    const auto predicates = getPredicates(query.root());
+    if (predicates.size() != _predicates.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < predicates.size(); ++i) {
+        if (predicates[i]->matchType() != _predicates[i].matchType ||
+            predicates[i]->path() != _predicates[i].path || !isBindablePredicate(predicates[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ParameterizedSolution::_bindBounds(const MatchExpression* root, IndexBounds* bounds) const {
+    const auto predicates = getPredicates(root);
+
+    const IndexScanNode* ixscan = nullptr;
+    for (const QuerySolutionNode* node = _root.get(); !ixscan; node = node->children[0]) {
+        if (node->getType() == STAGE_IXSCAN) {
+            ixscan = static_cast<const IndexScanNode*>(node);
+        }
+    }
+    const IndexEntry& index = ixscan->index;
+
+    bounds->fields.resize(_boundsSources.size());
+    BSONObjIterator kpIt(index.keyPattern);
+    for (size_t field = 0; field < _boundsSources.size(); ++field) {
+        const BSONElement elt = kpIt.next();
+        OrderedIntervalList* oil = &bounds->fields[field];
+        oil->name = elt.fieldName();
+
+        if (_boundsSources[field].empty()) {
+            IndexBoundsBuilder::allValuesForField(elt, oil);
+            continue;
+        }
+
+        bool first = true;
+        for (auto i : _boundsSources[field]) {
+            IndexBoundsBuilder::BoundsTightness tightness;
+            if (first) {
+                IndexBoundsBuilder::translate(predicates[i], elt, index, oil, &tightness);
+                first = false;
+            } else {
+                IndexBoundsBuilder::translateAndIntersect(
+                    predicates[i], elt, index, oil, &tightness);
+            }
+            if (tightness != IndexBoundsBuilder::EXACT) {
+                return false;
+            }
+        }
+    }
+
+    IndexBoundsBuilder::alignBounds(bounds, index.keyPattern, ixscan->direction);
+
+    // A field which turns from a point into a range, or the other way around, changes which
+    // sorts the scan provides.
+    for (size_t field = 0; field < _pointFields.size(); ++field) {
+        if (isPointField(bounds->fields[field]) != _pointFields[field]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<QuerySolution> ParameterizedSolution::bind(
+    const CanonicalQuery& query, const QueryPlannerParams& params) const {
+    if (!internalQueryCacheParameterizeSolutions.load() || params.options != _plannerOptions ||
+        params.indexFiltersApplied != _indexFiltersApplied || !isQueryParameterizable(query) ||
+        !_matchesPredicates(query)) {
+        return nullptr;
+    }
+
+    IndexBounds bounds;
+    if (!_bindBounds(query.root(), &bounds)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<QuerySolutionNode> root(_root->clone());
+    QuerySolutionNode* node = root.get();
+    while (node->getType() != STAGE_IXSCAN) {
+        node = node->children[0];
+    }
+    auto ixscan = static_cast<IndexScanNode*>(node);
+    ixscan->bounds = std::move(bounds);
+    ixscan->queryCollator = query.getCollator();
+
+    const QueryRequest& qr = query.getQueryRequest();
+    switch (_projectionType) {
+        case ProjectionType::kNone:
+            break;
+        case ProjectionType::kDefault:
+            root = std::make_unique<ProjectionNodeDefault>(
+                std::move(root), *query.root(), qr.getProj(), *query.getProj());
+            break;
+        case ProjectionType::kSimple:
+            root = std::make_unique<ProjectionNodeSimple>(
+                std::move(root), *query.root(), qr.getProj(), *query.getProj());
+            break;
+        case ProjectionType::kCovered:
+            root = std::make_unique<ProjectionNodeCovered>(
+                std::move(root), *query.root(), qr.getProj(), *query.getProj(), _coveredKeyObj);
+            break;
+    }
+    root->computeProperties();
+
+    auto soln = std::make_unique<QuerySolution>();
+    soln->root = std::move(root);
+    soln->hasBlockingStage = _hasBlockingStage;
+    soln->indexFilterApplied = _indexFilterApplied;
+    return soln;
+}
+
+}  // namespace mongo
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/query/index_bounds.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+struct QueryPlannerParams;
+struct QuerySolution;
+struct QuerySolutionNode;
+
+/**
+ * A query solution kept by the plan cache as a template for every query of its shape. Rather than
+ * tagging a copy of the query with the cached index assignments and running access planning and
+ * analysis again, a cache hit clones the template and re-binds the constants of the new query into
+ * the bounds of its index scan.
+ *
+ * Only the simplest shapes are parameterized: a conjunction of $eq, $lt, $lte, $gt and $gte
+ * predicates answered exactly by the bounds of a single scan over a regular, non-multikey,
+ * non-partial index, with no residual filter, skip or limit. A query whose constants would lead
+ * the planner to build a structurally different solution, for instance because a bound is no
+ * longer exact or a point interval becomes a range, is not bound and takes the regular path.
+ */
+class ParameterizedSolution {
+public:
+    /**
+     * Returns a template for the queries of the same shape as 'query', built from 'soln', the
+     * solution which the planner produced for 'query' with 'params'. Returns nullptr if the shape
+     * or the solution cannot be parameterized.
+     */
+    static std::unique_ptr<ParameterizedSolution> make(const CanonicalQuery& query,
+                                                       const QueryPlannerParams& params,
+                                                       const QuerySolution& soln);
+
+    /**
+     * Returns the solution for 'query', which must have the shape this template was made for,
+     * with its own constants bound into the index bounds. Returns nullptr if the constants of
+     * 'query' or 'params' do not allow for the template to be used.
+     */
+    std::unique_ptr<QuerySolution> bind(const CanonicalQuery& query,
+                                        const QueryPlannerParams& params) const;
+
+private:
+    enum class ProjectionType { kNone, kDefault, kSimple, kCovered };
+
+    struct Predicate {
+        MatchExpression::MatchType matchType;
+        std::string path;
+    };
+
+    ParameterizedSolution() = default;
+
+    /**
+     * Builds the bounds of the index scan from the constants of the predicates of 'root'. Returns
+     * false if the bounds of any field are not exact or are shaped differently from the ones of
+     * the template.
+     */
+    bool _bindBounds(const MatchExpression* root, IndexBounds* bounds) const;
+
+    /**
+     * Returns true if the predicates of 'query' line up with '_predicates' and have constants
+     * which can be bound.
+     */
+    bool _matchesPredicates(const CanonicalQuery& query) const;
+
+    // The solution without its projection, which refers to the query it was built for and so is
+    // rebuilt on every bind. It is a chain of single child nodes ending in an index scan.
+    std::unique_ptr<QuerySolutionNode> _root;
+
+    ProjectionType _projectionType = ProjectionType::kNone;
+    BSONObj _coveredKeyObj;
+
+    // The predicates of the query, in canonical order.
+    std::vector<Predicate> _predicates;
+
+    // For each field of the index, the positions in '_predicates' of the predicates which bound
+    // it. Fields with no predicates are scanned in their entirety.
+    std::vector<std::vector<size_t>> _boundsSources;
+
+    // For each field of the index, whether the template's bounds were a single point. The
+    // analysis of which sorts the scan provides depends on it.
+    std::vector<bool> _pointFields;
+
+    // The planner parameters the template was built with, which must be the same when binding.
+    size_t _plannerOptions = 0;
+    bool _indexFiltersApplied = false;
+
+    // Carried over from the template's QuerySolution.
+    bool _indexFilterApplied = false;
+    bool _hasBlockingStage = false;
+};
+
+}  // namespace mongo
@@ -30,7 +30,9 @@
 #pragma once
 
 #include <boost/optional/optional.hpp>
+#include <memory>
 #include <set>
+#include <vector>
 
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/query/canonical_query.h"
@@ -107,6 +109,7 @@ public:
 };
 
 
+class ParameterizedSolution;
 struct PlanRankingDecision;
 struct QuerySolution;
 struct QuerySolutionNode;
@@ -220,6 +223,10 @@ struct SolutionCacheData {
         // The cached plan is a collection scan.
         COLLSCAN_SOLN,
 
+        // The plan should scan the index in 'tree' skipping
+        // over the values of its leading field.
+        SKIP_SCAN_SOLN,
+
         // Build the solution by using 'tree'
         // to tag the match expression.
         USE_INDEX_TAGS_SOLN
@@ -232,6 +239,10 @@ struct SolutionCacheData {
 
     // True if index filter was applied.
     bool indexFilterApplied;
+
+    // If set, a USE_INDEX_TAGS_SOLN can be recreated by binding the constants of a query into this
+    // template instead of tagging the query with 'tree'. Immutable, and so shared between copies.
+    std::shared_ptr<const ParameterizedSolution> parameterizedSoln;
 };
 
 class PlanCacheEntry;
@@ -353,6 +364,10 @@ public:
  * Caches the best solution to a query.  Aside from the (CanonicalQuery -> QuerySolution)
  * mapping, the cache contains information on why that mapping was made and statistics on the
  * cache entry's actual performance on subsequent runs.
+ *
+ * The entries are split by the hash of their key between a number of partitions, each of which has
+ * its own LRU list and mutex. Lookups of different shapes therefore rarely contend, at the price of
+ * evicting the least recently used entry of a partition rather than of the whole cache.
  */
 class PlanCache {
 private:
@@ -399,7 +414,7 @@ public:
      */
     PlanCache();
 
-    PlanCache(size_t size);
+    PlanCache(size_t size, size_t numPartitions = 1);
 
     PlanCache(const std::string& ns);
 
@@ -425,6 +440,20 @@ public:
                Date_t now,
                boost::optional<double> worksGrowthCoefficient = boost::none);
 
+    /**
+     * Adds an active entry for 'query' whose single plan is 'solution', as saved by a
+     * PlanCacheSnapshot along with the 'works' and 'score' of the plan. Does nothing if the cache
+     * already has an entry for the shape of 'query', since that entry reflects the current data.
+     *
+     * The CachedPlanStage still runs a trial period against 'works', so an entry which no longer
+     * suits the data is replanned as usual.
+     */
+    Status restore(const CanonicalQuery& query,
+                   std::unique_ptr<SolutionCacheData> solution,
+                   size_t works,
+                   double score,
+                   Date_t now);
+
     /**
      * Set a cache entry back to the 'inactive' state. Rather than completely evicting an entry
      * when the associated plan starts to perform poorly, we deactivate it, so that plans which
@@ -546,10 +575,22 @@ private:
                                    size_t newWorks,
                                    double growthCoefficient);
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> _cache;
+    struct Partition {
+        explicit Partition(size_t size) : cache(size) {}
+
+        LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> cache;
+
+        // Protects 'cache'.
+        mutable stdx::mutex mutex;
+    };
+
+    /**
+     * Returns the partition which holds the entry for 'key', if there is one.
+     */
+    Partition& partitionFor(const PlanCacheKey& key) const;
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    // Never empty. Held by pointer since a Partition, owning a mutex, cannot be moved.
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
     // Full namespace of collection.
     std::string _ns;
@@ -0,0 +1,449 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cache_snapshot.h"
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/plan_ranker.h"
+#include "mongo/util/log.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+constexpr StringData PlanCacheSnapshot::kNsFieldName;
+
+namespace {
+
+// Fields of the documents written by serializeEntry(), besides kNsFieldName.
+const char kKeyField[] = "key";
+const char kQueryField[] = "query";
+const char kSortField[] = "sort";
+const char kProjectionField[] = "projection";
+const char kCollationField[] = "collation";
+const char kWorksField[] = "works";
+const char kScoreField[] = "score";
+const char kPlanField[] = "plan";
+
+// Fields of the plans written by serializeSolution().
+const char kTypeField[] = "type";
+const char kDirectionField[] = "direction";
+const char kIndexFilterAppliedField[] = "indexFilterApplied";
+const char kTreeField[] = "tree";
+
+// Fields of the trees of index assignments within a plan.
+const char kIndexField[] = "index";
+const char kKeyPatternField[] = "keyPattern";
+const char kPositionField[] = "position";
+const char kCanCombineBoundsField[] = "canCombineBounds";
+const char kOrPushdownsField[] = "orPushdowns";
+const char kRouteField[] = "route";
+const char kChildrenField[] = "children";
+const char kNameField[] = "name";
+const char kDisambiguatorField[] = "disambiguator";
+
+StringData solutionTypeToString(SolutionCacheData::SolutionType type) {
+    switch (type) {
+        case SolutionCacheData::WHOLE_IXSCAN_SOLN:
+            return "wholeIndexScan"_sd;
+        case SolutionCacheData::COLLSCAN_SOLN:
+            return "collectionScan"_sd;
+        case SolutionCacheData::SKIP_SCAN_SOLN:
+            return "skipScan"_sd;
+        case SolutionCacheData::USE_INDEX_TAGS_SOLN:
+            return "indexTags"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+StatusWith<SolutionCacheData::SolutionType> solutionTypeFromString(StringData str) {
+    for (auto type : {SolutionCacheData::WHOLE_IXSCAN_SOLN,
+                      SolutionCacheData::COLLSCAN_SOLN,
+                      SolutionCacheData::SKIP_SCAN_SOLN,
+                      SolutionCacheData::USE_INDEX_TAGS_SOLN}) {
+        if (str == solutionTypeToString(type)) {
+            return type;
+        }
+    }
+    return Status(ErrorCodes::FailedToParse, str::stream() << "unknown plan type: " << str);
+}
+
+BSONObj serializeIdentifier(const IndexEntry::Identifier& identifier) {
+    BSONObjBuilder bob;
+    bob.append(kNameField, identifier.catalogName);
+    if (!identifier.disambiguator.empty()) {
+        bob.append(kDisambiguatorField, identifier.disambiguator);
+    }
+    return bob.obj();
+}
+
+/**
+ * Parses the identifier in the field 'fieldName' of 'obj' and returns the entry for it among
+ * 'indexes'.
+ */
+StatusWith<const IndexEntry*> parseIndex(const BSONObj& obj,
+                                         StringData fieldName,
+                                         const std::vector<IndexEntry>& indexes) {
+    BSONElement elt;
+    auto status = bsonExtractTypedField(obj, fieldName, Object, &elt);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    std::string name;
+    std::string disambiguator;
+    status = bsonExtractStringField(elt.Obj(), kNameField, &name);
+    if (!status.isOK()) {
+        return status;
+    }
+    status = bsonExtractStringFieldWithDefault(elt.Obj(), kDisambiguatorField, "", &disambiguator);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    const IndexEntry::Identifier identifier(std::move(name), std::move(disambiguator));
+    for (auto&& index : indexes) {
+        if (index.identifier == identifier) {
+            return &index;
+        }
+    }
+    return Status(ErrorCodes::IndexNotFound,
+                  str::stream() << "index " << identifier << " is not available");
+}
+
+BSONObj serializeTree(const PlanCacheIndexTree& tree) {
+    BSONObjBuilder bob;
+    if (tree.entry) {
+        bob.append(kIndexField, serializeIdentifier(tree.entry->identifier));
+        bob.append(kKeyPatternField, tree.entry->keyPattern);
+        bob.append(kPositionField, static_cast<long long>(tree.index_pos));
+        bob.append(kCanCombineBoundsField, tree.canCombineBounds);
+    }
+
+    if (!tree.orPushdowns.empty()) {
+        BSONArrayBuilder orPushdownsBuilder(bob.subarrayStart(kOrPushdownsField));
+        for (auto&& orPushdown : tree.orPushdowns) {
+            BSONObjBuilder orPushdownBuilder(orPushdownsBuilder.subobjStart());
+            orPushdownBuilder.append(kIndexField, serializeIdentifier(orPushdown.indexEntryId));
+            orPushdownBuilder.append(kPositionField, static_cast<long long>(orPushdown.position));
+            orPushdownBuilder.append(kCanCombineBoundsField, orPushdown.canCombineBounds);
+            BSONArrayBuilder routeBuilder(orPushdownBuilder.subarrayStart(kRouteField));
+            for (auto position : orPushdown.route) {
+                routeBuilder.append(static_cast<long long>(position));
+            }
+        }
+    }
+
+    if (!tree.children.empty()) {
+        BSONArrayBuilder childrenBuilder(bob.subarrayStart(kChildrenField));
+        for (auto child : tree.children) {
+            childrenBuilder.append(serializeTree(*child));
+        }
+    }
+    return bob.obj();
+}
+
+Status parsePosition(const BSONObj& obj, StringData fieldName, size_t* out) {
+    long long position;
+    auto status = bsonExtractIntegerField(obj, fieldName, &position);
+    if (!status.isOK()) {
+        return status;
+    }
+    if (position < 0) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << "'" << fieldName << "' cannot be negative");
+    }
+    *out = position;
+    return Status::OK();
+}
+
+StatusWith<std::unique_ptr<PlanCacheIndexTree>> parseTree(const BSONObj& obj,
+                                                          const std::vector<IndexEntry>& indexes) {
+    auto tree = std::make_unique<PlanCacheIndexTree>();
+    if (obj.hasField(kIndexField)) {
+        auto index = parseIndex(obj, kIndexField, indexes);
+        if (!index.isOK()) {
+            return index.getStatus();
+        }
+        BSONElement keyPattern;
+        auto status = bsonExtractTypedField(obj, kKeyPatternField, Object, &keyPattern);
+        if (!status.isOK()) {
+            return status;
+        }
+        if (index.getValue()->keyPattern.woCompare(keyPattern.Obj()) != 0) {
+            return Status(ErrorCodes::IndexNotFound,
+                          str::stream() << "index " << index.getValue()->identifier
+                                        << " no longer has the key pattern "
+                                        << keyPattern.Obj());
+        }
+        tree->setIndexEntry(*index.getValue());
+
+        status = parsePosition(obj, kPositionField, &tree->index_pos);
+        if (!status.isOK()) {
+            return status;
+        }
+        status = bsonExtractBooleanField(obj, kCanCombineBoundsField, &tree->canCombineBounds);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    if (auto orPushdowns = obj[kOrPushdownsField]) {
+        if (orPushdowns.type() != Array) {
+            return Status(ErrorCodes::FailedToParse, "'orPushdowns' must be an array");
+        }
+        for (auto&& elt : orPushdowns.Obj()) {
+            if (elt.type() != Object) {
+                return Status(ErrorCodes::FailedToParse, "an OR pushdown must be an object");
+            }
+            const BSONObj orPushdownObj = elt.Obj();
+            auto index = parseIndex(orPushdownObj, kIndexField, indexes);
+            if (!index.isOK()) {
+                return index.getStatus();
+            }
+
+            PlanCacheIndexTree::OrPushdown orPushdown{index.getValue()->identifier, 0, true, {}};
+            auto status = parsePosition(orPushdownObj, kPositionField, &orPushdown.position);
+            if (!status.isOK()) {
+                return status;
+            }
+            status = bsonExtractBooleanField(
+                orPushdownObj, kCanCombineBoundsField, &orPushdown.canCombineBounds);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            BSONElement route;
+            status = bsonExtractTypedField(orPushdownObj, kRouteField, Array, &route);
+            if (!status.isOK()) {
+                return status;
+            }
+            for (auto&& position : route.Obj()) {
+                if (!position.isNumber() || position.safeNumberLong() < 0) {
+                    return Status(ErrorCodes::FailedToParse,
+                                  "an OR pushdown route must hold non-negative numbers");
+                }
+                orPushdown.route.push_back(position.safeNumberLong());
+            }
+            tree->orPushdowns.push_back(std::move(orPushdown));
+        }
+    }
+
+    if (auto children = obj[kChildrenField]) {
+        if (children.type() != Array) {
+            return Status(ErrorCodes::FailedToParse, "'children' must be an array");
+        }
+        for (auto&& elt : children.Obj()) {
+            if (elt.type() != Object) {
+                return Status(ErrorCodes::FailedToParse, "a child must be an object");
+            }
+            auto child = parseTree(elt.Obj(), indexes);
+            if (!child.isOK()) {
+                return child.getStatus();
+            }
+            tree->children.push_back(child.getValue().release());
+        }
+    }
+    return std::move(tree);
+}
+
+}  // namespace
+
+// static
+BSONObj PlanCacheSnapshot::serializeEntry(StringData ns,
+                                          const PlanCacheKey& key,
+                                          const PlanCacheEntry& entry) {
+    invariant(!entry.plannerData.empty());
+
+    BSONObjBuilder bob;
+    bob.append(kNsFieldName, ns);
+    bob.appendBinData(kKeyField, key.toString().size(), BinDataGeneral, key.toString().data());
+    bob.append(kQueryField, entry.query);
+    bob.append(kSortField, entry.sort);
+    bob.append(kProjectionField, entry.projection);
+    if (!entry.collation.isEmpty()) {
+        bob.append(kCollationField, entry.collation);
+    }
+    bob.append(kWorksField, static_cast<long long>(entry.works));
+    bob.append(kScoreField, entry.decision->scores[0]);
+
+    // Only the winning plan is kept, since it is the only one the cache uses for planning.
+    bob.append(kPlanField, serializeSolution(*entry.plannerData[0]));
+    return bob.obj();
+}
+
+// static
+BSONObj PlanCacheSnapshot::serializeSolution(const SolutionCacheData& data) {
+    BSONObjBuilder bob;
+    bob.append(kTypeField, solutionTypeToString(data.solnType));
+    bob.append(kDirectionField, data.wholeIXSolnDir);
+    bob.append(kIndexFilterAppliedField, data.indexFilterApplied);
+    if (data.tree) {
+        bob.append(kTreeField, serializeTree(*data.tree));
+    }
+    return bob.obj();
+}
+
+// static
+StatusWith<std::unique_ptr<SolutionCacheData>> PlanCacheSnapshot::parseSolution(
+    const BSONObj& obj, const std::vector<IndexEntry>& indexes) {
+    auto data = std::make_unique<SolutionCacheData>();
+
+    std::string typeStr;
+    auto status = bsonExtractStringField(obj, kTypeField, &typeStr);
+    if (!status.isOK()) {
+        return status;
+    }
+    auto type = solutionTypeFromString(typeStr);
+    if (!type.isOK()) {
+        return type.getStatus();
+    }
+    data->solnType = type.getValue();
+
+    long long direction;
+    status = bsonExtractIntegerField(obj, kDirectionField, &direction);
+    if (!status.isOK()) {
+        return status;
+    }
+    if (direction != 1 && direction != -1) {
+        return Status(ErrorCodes::FailedToParse, "'direction' must be 1 or -1");
+    }
+    data->wholeIXSolnDir = direction;
+
+    status = bsonExtractBooleanField(obj, kIndexFilterAppliedField, &data->indexFilterApplied);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    if (data->solnType == SolutionCacheData::COLLSCAN_SOLN) {
+        return std::move(data);
+    }
+
+    BSONElement treeElt;
+    status = bsonExtractTypedField(obj, kTreeField, Object, &treeElt);
+    if (!status.isOK()) {
+        return status;
+    }
+    auto tree = parseTree(treeElt.Obj(), indexes);
+    if (!tree.isOK()) {
+        return tree.getStatus();
+    }
+    data->tree = std::move(tree.getValue());
+
+    // These plans are built from the index of the root rather than by tagging the query.
+    if ((data->solnType == SolutionCacheData::WHOLE_IXSCAN_SOLN ||
+         data->solnType == SolutionCacheData::SKIP_SCAN_SOLN) &&
+        !data->tree->entry) {
+        return Status(ErrorCodes::FailedToParse, "plan is missing its index");
+    }
+    return std::move(data);
+}
+
+bool PlanCacheSnapshot::needsLoad() const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    return !_loaded;
+}
+
+void PlanCacheSnapshot::load(const std::vector<BSONObj>& docs) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _loaded = true;
+    _entries.clear();
+    for (auto&& doc : docs) {
+        BSONElement key = doc[kKeyField];
+        if (key.type() != BinData) {
+            continue;
+        }
+        int length;
+        const char* data = key.binData(length);
+        _entries[std::string(data, length)] = doc.getOwned();
+    }
+}
+
+void PlanCacheSnapshot::restore(const CanonicalQuery& query,
+                                const PlanCacheKey& key,
+                                const std::vector<IndexEntry>& indexes,
+                                PlanCache* planCache,
+                                Date_t now) {
+    BSONObj doc;
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        auto it = _entries.find(key.toString());
+        if (it == _entries.end()) {
+            return;
+        }
+        doc = std::move(it->second);
+        _entries.erase(it);
+    }
+
+    auto status = [&]() -> Status {
+        long long works;
+        auto status = bsonExtractIntegerField(doc, kWorksField, &works);
+        if (!status.isOK()) {
+            return status;
+        }
+        if (works < 0) {
+            return Status(ErrorCodes::FailedToParse, "'works' cannot be negative");
+        }
+        double score;
+        status = bsonExtractDoubleField(doc, kScoreField, &score);
+        if (!status.isOK()) {
+            return status;
+        }
+        BSONElement plan;
+        status = bsonExtractTypedField(doc, kPlanField, Object, &plan);
+        if (!status.isOK()) {
+            return status;
+        }
+        auto solution = parseSolution(plan.Obj(), indexes);
+        if (!solution.isOK()) {
+            return solution.getStatus();
+        }
+        return planCache->restore(query, std::move(solution.getValue()), works, score, now);
+    }();
+
+    if (!status.isOK()) {
+        LOG(1) << "Not restoring the saved plan cache entry for "
+               << redact(query.toStringShort()) << ": " << status;
+        return;
+    }
+    LOG(2) << "Restored the saved plan cache entry for " << redact(query.toStringShort());
+}
+
+void PlanCacheSnapshot::clear() {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _entries.clear();
+}
+
+}  // namespace mongo
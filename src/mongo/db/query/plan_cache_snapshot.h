@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/index_entry.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+
+/**
+ * The plan cache entries of a collection which the planCacheSnapshot command saved to the local
+ * database, so that a restarted node does not have to multi-plan every query shape at once.
+ *
+ * A saved entry holds the winning plan of a cache entry along with its works and score, keyed by
+ * the full PlanCacheKey. The plan names its indexes rather than describing them. The entries are
+ * read from disk the first time the collection is queried, and each one goes back into the plan
+ * cache the first time a query of its shape is planned, with its index names resolved against the
+ * indexes the planner sees for that query. An entry whose key the current indexes no longer
+ * produce is never looked up, and one whose indexes are gone fails to resolve and is dropped.
+ */
+class PlanCacheSnapshot {
+public:
+    // The field of a saved entry which holds the namespace of its collection.
+    static constexpr StringData kNsFieldName = "ns"_sd;
+
+    /**
+     * Returns the document saving 'entry', cached under 'key' for the collection 'ns'.
+     */
+    static BSONObj serializeEntry(StringData ns,
+                                  const PlanCacheKey& key,
+                                  const PlanCacheEntry& entry);
+
+    static BSONObj serializeSolution(const SolutionCacheData& data);
+
+    /**
+     * Parses a plan saved by serializeSolution(), looking up the indexes it names in 'indexes'.
+     * Fails if one of them is missing or has a different key pattern than when it was saved.
+     */
+    static StatusWith<std::unique_ptr<SolutionCacheData>> parseSolution(
+        const BSONObj& obj, const std::vector<IndexEntry>& indexes);
+
+    /**
+     * Returns true if the saved entries have not been read for this collection yet.
+     */
+    bool needsLoad() const;
+
+    /**
+     * Keeps the documents written by serializeEntry() until their query shapes are planned.
+     */
+    void load(const std::vector<BSONObj>& docs);
+
+    /**
+     * If an entry saved under 'key' remains, removes it and restores it into 'planCache' as the
+     * entry for 'query'. 'indexes' are the indexes available to the planner for 'query'.
+     */
+    void restore(const CanonicalQuery& query,
+                 const PlanCacheKey& key,
+                 const std::vector<IndexEntry>& indexes,
+                 PlanCache* planCache,
+                 Date_t now);
+
+    /**
+     * Drops the saved entries which have not been restored yet. They are not read again.
+     */
+    void clear();
+
+private:
+    mutable stdx::mutex _mutex;
+
+    bool _loaded = false;
+
+    // Documents written by serializeEntry(), keyed by the string of their PlanCacheKey.
+    StringMap<BSONObj> _entries;
+};
+
+}  // namespace mongo
@@ -0,0 +1,254 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+/**
+ * This file contains tests for mongo/db/query/plan_cache_snapshot.h
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cache_snapshot.h"
+
+#include "mongo/db/index_names.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using unittest::assertGet;
+
+const NamespaceString nss("test.collection");
+
+std::unique_ptr<CanonicalQuery> canonicalize(const char* queryStr) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    auto qr = std::make_unique<QueryRequest>(nss);
+    qr->setFilter(fromjson(queryStr));
+    const boost::intrusive_ptr<ExpressionContext> expCtx;
+    auto statusWithCQ =
+        CanonicalQuery::canonicalize(opCtx.get(),
+                                     std::move(qr),
+                                     expCtx,
+                                     ExtensionsCallbackNoop(),
+                                     MatchExpressionParser::kAllowAllSpecialFeatures);
+    ASSERT_OK(statusWithCQ.getStatus());
+    return std::move(statusWithCQ.getValue());
+}
+
+IndexEntry makeIndexEntry(const BSONObj& kp, const std::string& name) {
+    return {kp,
+            IndexNames::nameToType(IndexNames::findPluginName(kp)),
+            false,
+            {},
+            {},
+            false,
+            false,
+            CoreIndexInfo::Identifier(name),
+            nullptr,
+            {},
+            nullptr,
+            nullptr};
+}
+
+std::vector<IndexEntry> makeIndexes() {
+    return {makeIndexEntry(BSON("a" << 1), "a_1"),
+            makeIndexEntry(BSON("b" << 1 << "c" << 1), "bc")};
+}
+
+/**
+ * Returns the cache data of a plan which intersects an index on 'a' with an index on 'b', and
+ * pushes a predicate down into an $or.
+ */
+std::unique_ptr<SolutionCacheData> makeTaggedSolution(const std::vector<IndexEntry>& indexes) {
+    auto data = std::make_unique<SolutionCacheData>();
+    data->solnType = SolutionCacheData::USE_INDEX_TAGS_SOLN;
+    data->tree = std::make_unique<PlanCacheIndexTree>();
+
+    auto first = std::make_unique<PlanCacheIndexTree>();
+    first->setIndexEntry(indexes[0]);
+    first->orPushdowns.push_back({indexes[1].identifier, 1, false, {1, 0}});
+    data->tree->children.push_back(first.release());
+
+    auto second = std::make_unique<PlanCacheIndexTree>();
+    second->setIndexEntry(indexes[1]);
+    second->index_pos = 1;
+    data->tree->children.push_back(second.release());
+    return data;
+}
+
+TEST(PlanCacheSnapshotTest, RoundTripsIndexTaggedSolution) {
+    const auto indexes = makeIndexes();
+    auto data = makeTaggedSolution(indexes);
+    data->indexFilterApplied = true;
+
+    auto parsed = PlanCacheSnapshot::parseSolution(PlanCacheSnapshot::serializeSolution(*data),
+                                                   indexes);
+    ASSERT_OK(parsed.getStatus());
+    ASSERT_EQ(data->toString(), parsed.getValue()->toString());
+    ASSERT_TRUE(parsed.getValue()->indexFilterApplied);
+    ASSERT_BSONOBJ_EQ(BSON("b" << 1 << "c" << 1),
+                      parsed.getValue()->tree->children[1]->entry->keyPattern);
+}
+
+TEST(PlanCacheSnapshotTest, RoundTripsWholeIndexScanAndCollectionScan) {
+    const auto indexes = makeIndexes();
+
+    SolutionCacheData wholeScan;
+    wholeScan.solnType = SolutionCacheData::WHOLE_IXSCAN_SOLN;
+    wholeScan.wholeIXSolnDir = -1;
+    wholeScan.tree = std::make_unique<PlanCacheIndexTree>();
+    wholeScan.tree->setIndexEntry(indexes[1]);
+    auto parsed = PlanCacheSnapshot::parseSolution(
+        PlanCacheSnapshot::serializeSolution(wholeScan), indexes);
+    ASSERT_OK(parsed.getStatus());
+    ASSERT_EQ(wholeScan.toString(), parsed.getValue()->toString());
+
+    SolutionCacheData collScan;
+    collScan.solnType = SolutionCacheData::COLLSCAN_SOLN;
+    parsed =
+        PlanCacheSnapshot::parseSolution(PlanCacheSnapshot::serializeSolution(collScan), indexes);
+    ASSERT_OK(parsed.getStatus());
+    ASSERT_EQ(SolutionCacheData::COLLSCAN_SOLN, parsed.getValue()->solnType);
+    ASSERT_FALSE(parsed.getValue()->tree);
+}
+
+TEST(PlanCacheSnapshotTest, FailsToParseSolutionWhoseIndexesChanged) {
+    const auto indexes = makeIndexes();
+    const BSONObj serialized = PlanCacheSnapshot::serializeSolution(*makeTaggedSolution(indexes));
+
+    // The index has been dropped.
+    ASSERT_EQ(ErrorCodes::IndexNotFound,
+              PlanCacheSnapshot::parseSolution(serialized, {indexes[0]}).getStatus());
+
+    // The index has been recreated under the same name with a different key pattern.
+    ASSERT_EQ(ErrorCodes::IndexNotFound,
+              PlanCacheSnapshot::parseSolution(
+                  serialized, {indexes[0], makeIndexEntry(BSON("b" << 1), "bc")})
+                  .getStatus());
+
+    // The index only appears in an OR pushdown.
+    auto data = makeTaggedSolution(indexes);
+    data->tree->children.pop_back();
+    ASSERT_EQ(ErrorCodes::IndexNotFound,
+              PlanCacheSnapshot::parseSolution(PlanCacheSnapshot::serializeSolution(*data),
+                                               {indexes[0]})
+                  .getStatus());
+}
+
+TEST(PlanCacheSnapshotTest, FailsToParseMalformedSolution) {
+    const auto indexes = makeIndexes();
+    ASSERT_NOT_OK(PlanCacheSnapshot::parseSolution(BSONObj(), indexes).getStatus());
+    ASSERT_NOT_OK(PlanCacheSnapshot::parseSolution(
+                      fromjson("{type: 'unknown', direction: 1, indexFilterApplied: false}"),
+                      indexes)
+                      .getStatus());
+    ASSERT_NOT_OK(PlanCacheSnapshot::parseSolution(
+                      fromjson("{type: 'indexTags', direction: 1, indexFilterApplied: false}"),
+                      indexes)
+                      .getStatus());
+    ASSERT_NOT_OK(PlanCacheSnapshot::parseSolution(
+                      fromjson("{type: 'wholeIndexScan', direction: 1, indexFilterApplied: false, "
+                               "tree: {}}"),
+                      indexes)
+                      .getStatus());
+}
+
+TEST(PlanCacheSnapshotTest, RestoresSavedEntryWhenItsShapeIsPlanned) {
+    const auto indexes = makeIndexes();
+    const auto cq = canonicalize("{a: 1, b: 2}");
+
+    // Save an entry from one cache.
+    PlanCache savedCache;
+    ASSERT_OK(savedCache.restore(*cq, makeTaggedSolution(indexes), 123, 1.5, Date_t()));
+    auto entry = assertGet(savedCache.getEntry(*cq));
+    const auto key = savedCache.computeKey(*cq);
+    const BSONObj doc = PlanCacheSnapshot::serializeEntry(nss.ns(), key, *entry);
+    ASSERT_EQ(nss.ns(), doc[PlanCacheSnapshot::kNsFieldName].str());
+
+    // Another shape does not restore it.
+    PlanCacheSnapshot snapshot;
+    ASSERT_TRUE(snapshot.needsLoad());
+    snapshot.load({doc});
+    ASSERT_FALSE(snapshot.needsLoad());
+
+    PlanCache planCache;
+    const auto otherCq = canonicalize("{a: 1}");
+    snapshot.restore(*otherCq, planCache.computeKey(*otherCq), indexes, &planCache, Date_t());
+    ASSERT_EQ(0U, planCache.size());
+
+    // Its own shape restores it as an active entry.
+    snapshot.restore(*cq, planCache.computeKey(*cq), indexes, &planCache, Date_t());
+    ASSERT_EQ(1U, planCache.size());
+    auto result = planCache.get(*canonicalize("{a: 3, b: 4}"));
+    ASSERT_EQ(PlanCache::CacheEntryState::kPresentActive, result.state);
+    ASSERT_EQ(123U, result.cachedSolution->decisionWorks);
+    ASSERT_EQ(entry->plannerData[0]->toString(),
+              result.cachedSolution->plannerData[0]->toString());
+
+    // It is only restored once.
+    planCache.clear();
+    snapshot.restore(*cq, planCache.computeKey(*cq), indexes, &planCache, Date_t());
+    ASSERT_EQ(0U, planCache.size());
+}
+
+TEST(PlanCacheSnapshotTest, DoesNotRestoreOverExistingEntry) {
+    const auto indexes = makeIndexes();
+    const auto cq = canonicalize("{a: 1, b: 2}");
+
+    PlanCache planCache;
+    ASSERT_OK(planCache.restore(*cq, makeTaggedSolution(indexes), 10, 1.5, Date_t()));
+    ASSERT_OK(planCache.restore(*cq, makeTaggedSolution(indexes), 1000, 1.5, Date_t()));
+    ASSERT_EQ(10U, assertGet(planCache.getEntry(*cq))->works);
+}
+
+TEST(PlanCacheSnapshotTest, DoesNotRestoreEntryWhoseIndexesAreGone) {
+    const auto indexes = makeIndexes();
+    const auto cq = canonicalize("{a: 1, b: 2}");
+
+    PlanCache savedCache;
+    ASSERT_OK(savedCache.restore(*cq, makeTaggedSolution(indexes), 123, 1.5, Date_t()));
+    auto entry = assertGet(savedCache.getEntry(*cq));
+    PlanCacheSnapshot snapshot;
+    snapshot.load(
+        {PlanCacheSnapshot::serializeEntry(nss.ns(), savedCache.computeKey(*cq), *entry)});
+
+    PlanCache planCache;
+    snapshot.restore(*cq, planCache.computeKey(*cq), {indexes[0]}, &planCache, Date_t());
+    ASSERT_EQ(0U, planCache.size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/canonical_query_encoder.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/parameterized_solution.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
@@ -567,6 +568,44 @@ TEST(PlanCacheTest, PlanCacheLRUPolicyRemovesInactiveEntries) {
     ASSERT_EQ(planCache.get(*cqC).state, PlanCache::CacheEntryState::kPresentInactive);
 }
 
+TEST(PlanCacheTest, PartitionedCacheFindsEntriesOfEveryPartition) {
+    PlanCache planCache(100, 4);
+    QueryTestServiceContext serviceContext;
+
+    const size_t kNumShapes = 20;
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (size_t i = 0; i < kNumShapes; ++i) {
+        queries.push_back(canonicalize(BSON("a" + std::to_string(i) << 1)));
+        addCacheEntryForShape(*queries.back(), &planCache);
+    }
+
+    ASSERT_EQ(planCache.size(), kNumShapes);
+    ASSERT_EQ(planCache.getAllEntries().size(), kNumShapes);
+    for (auto&& cq : queries) {
+        ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    }
+
+    ASSERT_OK(planCache.remove(*queries[0]));
+    ASSERT_EQ(planCache.get(*queries[0]).state, PlanCache::CacheEntryState::kNotPresent);
+    ASSERT_EQ(planCache.size(), kNumShapes - 1);
+
+    planCache.clear();
+    ASSERT_EQ(planCache.size(), 0U);
+}
+
+TEST(PlanCacheTest, PartitionedCacheRespectsTotalSize) {
+    // More partitions than entries are requested, so each partition holds a single entry.
+    const size_t kCacheSize = 3;
+    PlanCache planCache(kCacheSize, 8);
+    QueryTestServiceContext serviceContext;
+
+    for (size_t i = 0; i < 20; ++i) {
+        unique_ptr<CanonicalQuery> cq(canonicalize(BSON("a" + std::to_string(i) << 1)));
+        addCacheEntryForShape(*cq, &planCache);
+        ASSERT_LTE(planCache.size(), kCacheSize);
+    }
+}
+
 TEST(PlanCacheTest, PlanCacheRemoveDeletesInactiveEntries) {
     PlanCache planCache;
     unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
@@ -1797,6 +1836,95 @@ TEST_F(CachePlanSelectionTest, ContainedOrAndIntersection) {
         "]}}}}");
 }
 
+//
+// Parameterized solutions.
+//
+
+TEST_F(CachePlanSelectionTest, ParameterizedSolutionRebindsConstants) {
+    addIndex(BSON("a" << 1 << "b" << 1), "a_1_b_1");
+    runQuery(fromjson("{a: 1, b: {$gt: 5}}"));
+
+    auto soln =
+        firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}}}}}");
+    ASSERT(soln->cacheData->parameterizedSoln);
+
+    auto planSoln = planQueryFromCache(
+        fromjson("{a: 7, b: {$gt: 10}}"), BSONObj(), BSONObj(), BSONObj(), *soln);
+    assertSolutionMatches(planSoln.get(),
+                          "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, bounds: "
+                          "{a: [[7, 7, true, true]], b: [[10, Infinity, false, true]]}}}}}");
+}
+
+TEST_F(CachePlanSelectionTest, ParameterizedSolutionRebindsIntoReverseCoveredScan) {
+    addIndex(BSON("a" << 1 << "b" << -1), "a_1_b_-1");
+    runQuerySortProj(
+        fromjson("{a: 3, b: {$lt: 5}}"), fromjson("{b: 1}"), fromjson("{_id: 0, b: 1}"));
+
+    const std::string solnJson =
+        "{proj: {spec: {_id: 0, b: 1}, node: {ixscan: {pattern: {a: 1, b: -1}, dir: -1}}}}";
+    auto soln = firstMatchingSolution(solnJson);
+    ASSERT(soln->cacheData->parameterizedSoln);
+
+    auto planSoln = planQueryFromCache(fromjson("{a: 4, b: {$lt: 2}}"),
+                                       fromjson("{b: 1}"),
+                                       fromjson("{_id: 0, b: 1}"),
+                                       BSONObj(),
+                                       *soln);
+    assertSolutionMatches(planSoln.get(),
+                          "{proj: {spec: {_id: 0, b: 1}, node: {ixscan: {pattern: {a: 1, b: -1}, "
+                          "dir: -1, bounds: {a: [[4, 4, true, true]], "
+                          "b: [[-Infinity, 2, true, false]]}}}}}");
+}
+
+TEST_F(CachePlanSelectionTest, ParameterizedSolutionFallsBackWhenBoundsAreInexact) {
+    addIndex(BSON("a" << 1), "a_1");
+    runQuery(fromjson("{a: 5}"));
+
+    auto soln = firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {a: 1}}}}}");
+    ASSERT(soln->cacheData->parameterizedSoln);
+
+    // Arrays and nulls need a filter, which the template does not have.
+    unique_ptr<CanonicalQuery> cqArray(canonicalize("{a: [1, 2]}"));
+    ASSERT_FALSE(soln->cacheData->parameterizedSoln->bind(*cqArray, params));
+    unique_ptr<CanonicalQuery> cqNull(canonicalize("{a: null}"));
+    ASSERT_FALSE(soln->cacheData->parameterizedSoln->bind(*cqNull, params));
+
+    auto planSoln =
+        planQueryFromCache(fromjson("{a: null}"), BSONObj(), BSONObj(), BSONObj(), *soln);
+    assertSolutionMatches(planSoln.get(),
+                          "{fetch: {filter: {a: null}, node: {ixscan: {pattern: {a: 1}}}}}");
+}
+
+TEST_F(CachePlanSelectionTest, ParameterizedSolutionRequiresSamePlannerOptions) {
+    addIndex(BSON("a" << 1), "a_1");
+    runQuery(fromjson("{a: 5}"));
+
+    auto soln = firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {a: 1}}}}}");
+    ASSERT(soln->cacheData->parameterizedSoln);
+
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 6}"));
+    ASSERT(soln->cacheData->parameterizedSoln->bind(*cq, params));
+    params.options |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
+    ASSERT_FALSE(soln->cacheData->parameterizedSoln->bind(*cq, params));
+}
+
+TEST_F(CachePlanSelectionTest, SolutionsWithFiltersOrLimitsAreNotParameterized) {
+    addIndex(BSON("a" << 1), "a_1", true);
+    addIndex(BSON("b" << 1), "b_1");
+    runQuery(fromjson("{a: 5, b: 6}"));
+    ASSERT_FALSE(
+        firstMatchingSolution("{fetch: {filter: {b: 6}, node: {ixscan: {pattern: {a: 1}}}}}")
+            ->cacheData->parameterizedSoln);
+    ASSERT_FALSE(
+        firstMatchingSolution("{fetch: {filter: {a: 5}, node: {ixscan: {pattern: {b: 1}}}}}")
+            ->cacheData->parameterizedSoln);
+
+    runQuerySkipLimit(fromjson("{b: 6}"), 0, 3);
+    ASSERT_FALSE(firstMatchingSolution("{limit: {n: 3, node: {fetch: {filter: null, node: "
+                                       "{ixscan: {pattern: {b: 1}}}}}}}")
+                     ->cacheData->parameterizedSoln);
+}
+
 // When a sparse index is present, computeKey() should generate different keys depending on
 // whether or not the predicates in the given query can use the index.
 TEST(PlanCacheTest, ComputeKeySparseIndex) {
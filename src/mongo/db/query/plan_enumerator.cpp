@@ -31,6 +31,7 @@
 
 #include "mongo/db/query/plan_enumerator.h"
 
+#include <algorithm>
 #include <set>
 
 #include "mongo/db/query/index_tag.h"
@@ -87,6 +88,29 @@ bool isPathOutsideElemMatch(const RelevantTag* rt, size_t component) {
 
 using PossibleFirstAssignment = std::vector<MatchExpression*>;
 
+// How much a predicate on one field of an index narrows its scan, for greedy enumeration. Only the
+// fields constrained by an equality or an $in let the bounds on the next field narrow it further.
+const double kEqualityScore = 2.0;
+const double kInScore = 1.5;
+const double kRangeScore = 1.0;
+const double kOtherScore = 0.5;
+
+double scorePredicate(const MatchExpression* pred) {
+    switch (pred->matchType()) {
+        case MatchExpression::EQ:
+            return kEqualityScore;
+        case MatchExpression::MATCH_IN:
+            return kInScore;
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            return kRangeScore;
+        default:
+            return kOtherScore;
+    }
+}
+
 void getPossibleFirstAssignments(const IndexEntry& thisIndex,
                                  const vector<MatchExpression*>& predsOverLeadingField,
                                  std::vector<PossibleFirstAssignment>* possibleFirstAssignments) {
@@ -260,7 +284,8 @@ PlanEnumerator::PlanEnumerator(const PlanEnumeratorParams& params)
       _indices(params.indices),
       _ixisect(params.intersect),
       _orLimit(params.maxSolutionsPerOr),
-      _intersectLimit(params.maxIntersectPerAnd) {}
+      _intersectLimit(params.maxIntersectPerAnd),
+      _greedyThreshold(params.greedyThreshold) {}
 
 PlanEnumerator::~PlanEnumerator() {
     typedef stdx::unordered_map<MemoID, NodeAssignment*> MemoMap;
@@ -273,6 +298,21 @@ Status PlanEnumerator::init() {
     // Fill out our memo structure from the tagged _root.
     _done = !prepMemo(_root, PrepMemoContext());
 
+    if (!_done && _greedyThreshold > 0) {
+        size_t numChoices = 0;
+        for (auto&& entry : _memo) {
+            if (entry.second->andAssignment) {
+                numChoices += entry.second->andAssignment->choices.size();
+            }
+        }
+        if (numChoices > _greedyThreshold) {
+            LOG(5) << "Enumerator: memo has " << numChoices
+                   << " index assignment choices, outputting only the greedy plan";
+            _greedy = true;
+            rankChoicesGreedily();
+        }
+    }
+
     // Dump the tags.  We replace them with IndexTag instances.
     _root->resetTag();
 
@@ -360,10 +400,61 @@ unique_ptr<MatchExpression> PlanEnumerator::getNext() {
 
     _root->resetTag();
     LOG(5) << "Enumerator: memo just before moving:" << endl << dumpMemo();
-    _done = nextMemo(memoIDForNode(_root));
+    _done = _greedy || nextMemo(memoIDForNode(_root));
     return tree;
 }
 
+void PlanEnumerator::rankChoicesGreedily() {
+    for (auto&& entry : _memo) {
+        AndAssignment* andAssignment = entry.second->andAssignment.get();
+        if (!andAssignment) {
+            continue;
+        }
+
+        // An intersection scores as its best scan, so that the stable sort keeps the single index
+        // choice, which is enumerated first, ahead of it. A choice which only indexes subnodes
+        // gets no credit over one which indexes a predicate itself.
+        std::vector<std::pair<double, AndEnumerableState>> ranked;
+        for (auto&& choice : andAssignment->choices) {
+            double score = 0;
+            for (auto&& assignment : choice.assignments) {
+                score = std::max(score, scoreAssignment(assignment));
+            }
+            ranked.emplace_back(score, std::move(choice));
+        }
+        std::stable_sort(ranked.begin(), ranked.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first > rhs.first;
+        });
+
+        for (size_t i = 0; i < ranked.size(); ++i) {
+            andAssignment->choices[i] = std::move(ranked[i].second);
+        }
+    }
+}
+
+double PlanEnumerator::scoreAssignment(const OneIndexAssignment& assignment) const {
+    const size_t nFields = (*_indices)[assignment.index].keyPattern.nFields();
+
+    // The best score of the predicates assigned to each field of the index.
+    std::vector<double> fieldScores(nFields, 0);
+    for (size_t i = 0; i < assignment.preds.size(); ++i) {
+        const IndexPosition position = assignment.positions[i];
+        if (position < nFields) {
+            fieldScores[position] =
+                std::max(fieldScores[position], scorePredicate(assignment.preds[i]));
+        }
+    }
+
+    double score = 0;
+    for (auto fieldScore : fieldScores) {
+        score += fieldScore;
+        if (fieldScore < kInScore || !assignment.canCombineBounds) {
+            break;
+        }
+    }
+    return score;
+}
+
 //
 // Structure creation
 //
@@ -44,7 +44,8 @@ struct PlanEnumeratorParams {
     PlanEnumeratorParams()
         : intersect(false),
           maxSolutionsPerOr(internalQueryEnumerationMaxOrSolutions.load()),
-          maxIntersectPerAnd(internalQueryEnumerationMaxIntersectPerAnd.load()) {}
+          maxIntersectPerAnd(internalQueryEnumerationMaxIntersectPerAnd.load()),
+          greedyThreshold(internalQueryEnumerationGreedyThreshold.load()) {}
 
     // Do we provide solutions that use more indices than the minimum required to provide
     // an indexed solution?
@@ -65,6 +66,11 @@ struct PlanEnumeratorParams {
     // all-pairs approach, we could wind up creating a lot of enumeration possibilities for
     // certain inputs.
     size_t maxIntersectPerAnd;
+
+    // If the memo holds more than this many index assignment choices in total, the number of
+    // combinations is likely too large to step through. Instead we rank the choices at each AND by
+    // a selectivity heuristic and output only the plan made of the best ones. Zero disables this.
+    size_t greedyThreshold;
 };
 
 /**
@@ -522,6 +528,19 @@ private:
 
     std::string dumpMemo();
 
+    /**
+     * Sorts the choices of every AND in the memo so that the one with the highest
+     * scoreAssignment() comes first.
+     */
+    void rankChoicesGreedily();
+
+    /**
+     * Returns a heuristic estimate of how narrow the scan for 'assignment' is. Each leading field
+     * of the index constrained to points narrows the scan further, and the first field which is
+     * not ends the prefix of fields that contribute.
+     */
+    double scoreAssignment(const OneIndexAssignment& assignment) const;
+
     // Map from expression to its MemoID.
     stdx::unordered_map<MatchExpression*, MemoID> _nodeToId;
 
@@ -550,6 +569,13 @@ private:
 
     // How many things do we want from each AND?
     size_t _intersectLimit;
+
+    // How many index assignment choices can the memo hold before we switch to greedy mode?
+    size_t _greedyThreshold;
+
+    // If true, we output only the first enumeration state, for which every AND has been ranked by
+    // rankChoicesGreedily().
+    bool _greedy = false;
 };
 
 }  // namespace mongo
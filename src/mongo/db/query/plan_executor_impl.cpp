@@ -51,9 +51,11 @@
 #include "mongo/db/exec/trial_stage.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/operation_wait_stats.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/mock_yield_policies.h"
 #include "mongo/db/query/plan_yield_policy.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/util/fail_point_service.h"
@@ -450,11 +452,14 @@ PlanExecutor::ExecState PlanExecutorImpl::_waitForInserts(CappedInsertNotifierDa
     auto curOp = CurOp::get(_opCtx);
     curOp->pauseTimer();
     ON_BLOCK_EXIT([curOp] { curOp->resumeTimer(); });
+    OperationWaitStats::ScopedWait awaitDataWait(_opCtx,
+                                                 OperationWaitStats::WaitState::kAwaitData);
     auto opCtx = _opCtx;
     uint64_t currentNotifierVersion = notifierData->notifier->getVersion();
-    auto yieldResult = _yieldPolicy->yieldOrInterrupt([opCtx, notifierData] {
+    const Milliseconds coalesce(internalQueryAwaitDataCoalesceMillis.load());
+    auto yieldResult = _yieldPolicy->yieldOrInterrupt([opCtx, notifierData, coalesce] {
         const auto deadline = awaitDataState(opCtx).waitForInsertsDeadline;
-        notifierData->notifier->waitUntil(notifierData->lastEOFVersion, deadline);
+        notifierData->notifier->waitUntil(notifierData->lastEOFVersion, deadline, coalesce);
     });
     notifierData->lastEOFVersion = currentNotifierVersion;
 
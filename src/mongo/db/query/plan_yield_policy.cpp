@@ -31,6 +31,9 @@
 
 #include "mongo/db/query/plan_yield_policy.h"
 
+#include <algorithm>
+
+#include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/curop_failpoint_helpers.h"
@@ -50,21 +53,44 @@ MONGO_FAIL_POINT_DEFINE(setInterruptOnlyPlansCheckForInterruptHang);
 PlanYieldPolicy::PlanYieldPolicy(PlanExecutor* exec, PlanExecutor::YieldPolicy policy)
     : _policy(exec->getOpCtx()->lockState()->isGlobalLockedRecursively() ? PlanExecutor::NO_YIELD
                                                                          : policy),
+      _adaptiveFactor(_getAdaptiveFactor(_policy)),
       _forceYield(false),
       _elapsedTracker(exec->getOpCtx()->getServiceContext()->getFastClockSource(),
-                      internalQueryExecYieldIterations.load(),
-                      Milliseconds(internalQueryExecYieldPeriodMS.load())),
+                      std::max(1, internalQueryExecYieldIterations.load() / _adaptiveFactor),
+                      Milliseconds(internalQueryExecYieldPeriodMS.load() / _adaptiveFactor)),
       _planYielding(exec) {}
 
 
 PlanYieldPolicy::PlanYieldPolicy(PlanExecutor::YieldPolicy policy, ClockSource* cs)
     : _policy(policy),
+      _adaptiveFactor(_getAdaptiveFactor(_policy)),
       _forceYield(false),
       _elapsedTracker(cs,
-                      internalQueryExecYieldIterations.load(),
-                      Milliseconds(internalQueryExecYieldPeriodMS.load())),
+                      std::max(1, internalQueryExecYieldIterations.load() / _adaptiveFactor),
+                      Milliseconds(internalQueryExecYieldPeriodMS.load() / _adaptiveFactor)),
       _planYielding(nullptr) {}
 
+int PlanYieldPolicy::_getAdaptiveFactor(PlanExecutor::YieldPolicy policy) {
+    // Only the plans which release locks or storage engine resources benefit from yielding more
+    // often. INTERRUPT_ONLY plans keep the fixed interval so that they notice a kill promptly.
+    switch (policy) {
+        case PlanExecutor::YIELD_AUTO:
+        case PlanExecutor::WRITE_CONFLICT_RETRY_ONLY:
+            return internalQueryExecYieldAdaptive.load()
+                ? std::max(1, internalQueryExecYieldAdaptiveFactor.load())
+                : 1;
+        default:
+            return 1;
+    }
+}
+
+bool PlanYieldPolicy::_shouldYieldAdaptively() {
+    if (Locker::getNumWaiting() > 0) {
+        return true;
+    }
+    return ++_uncontendedIntervals >= _adaptiveFactor * _adaptiveFactor;
+}
+
 bool PlanYieldPolicy::shouldYieldOrInterrupt() {
     if (_policy == PlanExecutor::INTERRUPT_ONLY) {
         return _elapsedTracker.intervalHasElapsed();
@@ -74,10 +100,13 @@ bool PlanYieldPolicy::shouldYieldOrInterrupt() {
     invariant(!_planYielding->getOpCtx()->lockState()->inAWriteUnitOfWork());
     if (_forceYield)
         return true;
-    return _elapsedTracker.intervalHasElapsed();
+    if (!_elapsedTracker.intervalHasElapsed())
+        return false;
+    return _adaptiveFactor == 1 || _shouldYieldAdaptively();
 }
 
 void PlanYieldPolicy::resetTimer() {
+    _uncontendedIntervals = 0;
     _elapsedTracker.resetLastTime();
 }
 
@@ -136,8 +136,28 @@ public:
     }
 
 private:
+    /**
+     * Computes '_adaptiveFactor' for a yield policy constructed with 'policy'.
+     */
+    static int _getAdaptiveFactor(PlanExecutor::YieldPolicy policy);
+
+    /**
+     * Called each time '_elapsedTracker' fires for an adaptively yielding plan. Returns true if
+     * other clients are waiting for locks or tickets, or if the plan has already let
+     * '_adaptiveFactor' squared intervals go by without yielding.
+     */
+    bool _shouldYieldAdaptively();
+
     const PlanExecutor::YieldPolicy _policy;
 
+    // When adaptive yielding is enabled for an auto-yielding plan, the yield intervals are
+    // divided by this factor and each interval is the occasion to check for contention
+    // instead of an unconditional yield. Otherwise, it is 1 and we yield at every interval.
+    const int _adaptiveFactor;
+
+    // The number of intervals which went by with no contention since we last yielded.
+    int _uncontendedIntervals = 0;
+
     bool _forceYield;
     ElapsedTracker _elapsedTracker;
 
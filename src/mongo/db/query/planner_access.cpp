@@ -536,11 +536,25 @@ bool QueryPlannerAccess::orNeedsFetch(const ScanBuildingState* scanState) {
         return true;
     } else {
         invariant(scanState->loosestBounds == IndexBoundsBuilder::INEXACT_COVERED);
-        const IndexEntry& index = scanState->indices[scanState->currentIndexNumber];
-        return index.multikey;
+        return !scanState->curOrFilterableOnIndexKeys;
     }
 }
 
+bool QueryPlannerAccess::canFilterOnIndexKeys(const IndexEntry& index, size_t pos) {
+    if (!index.multikey) {
+        return true;
+    }
+
+    // Stay conservative for $** indexes, whose key pattern gains the virtual '$_path' field once
+    // the scan is finished.
+    if (index.multikeyPaths.empty() || INDEX_WILDCARD == index.type) {
+        return false;
+    }
+
+    invariant(pos < index.multikeyPaths.size());
+    return index.multikeyPaths[pos].empty();
+}
+
 void QueryPlannerAccess::finishAndOutputLeaf(ScanBuildingState* scanState,
                                              vector<std::unique_ptr<QuerySolutionNode>>* out) {
     finishLeafNode(scanState->currentScan.get(), scanState->indices[scanState->currentIndexNumber]);
@@ -1215,7 +1229,7 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::_buildIndexedDataAccess(
             if (tightness == IndexBoundsBuilder::EXACT) {
                 return soln;
             } else if (tightness == IndexBoundsBuilder::INEXACT_COVERED &&
-                       !indices[tag->index].multikey) {
+                       canFilterOnIndexKeys(indices[tag->index], tag->pos)) {
                 verify(nullptr == soln->filter.get());
                 soln->filter = std::move(ownedRoot);
                 return soln;
@@ -1290,6 +1304,100 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::scanWholeIndex(
     return solnRoot;
 }
 
+namespace {
+
+/**
+ * Returns true if 'expr' is a predicate from which skipScanIndex() may build the bounds on its
+ * field.
+ */
+bool isSkipScanPredicate(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::MATCH_IN:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::skipScanIndex(
+    const IndexEntry& index, const CanonicalQuery& query, const QueryPlannerParams& params) {
+    // Multikey indexes are excluded because bounds on a multikey field cannot always be
+    // intersected, and sparse or partial indexes because they may not hold every document.
+    if (index.type != INDEX_BTREE || index.multikey || index.sparse || index.filterExpr ||
+        index.keyPattern.nFields() < 2 ||
+        !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+        return nullptr;
+    }
+
+    MatchExpression* root = query.root();
+    std::vector<const MatchExpression*> predicates;
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            predicates.push_back(root->getChild(i));
+        }
+    } else {
+        predicates.push_back(root);
+    }
+
+    auto isn = std::make_unique<IndexScanNode>(index);
+    isn->addKeyMetadata = query.getQueryRequest().returnKey();
+    isn->queryCollator = query.getCollator();
+    isn->bounds.fields.resize(index.keyPattern.nFields());
+
+    bool hasTrailingBounds = false;
+    size_t pos = 0;
+    for (auto&& keyElt : index.keyPattern) {
+        OrderedIntervalList* oil = &isn->bounds.fields[pos];
+        bool hasBounds = false;
+        for (auto predicate : predicates) {
+            if (!isSkipScanPredicate(predicate) ||
+                predicate->path() != keyElt.fieldNameStringData()) {
+                continue;
+            }
+
+            // The regular planner already makes use of predicates on the leading field.
+            if (0 == pos) {
+                return nullptr;
+            }
+
+            IndexBoundsBuilder::BoundsTightness tightness;
+            if (hasBounds) {
+                IndexBoundsBuilder::translateAndIntersect(
+                    predicate, keyElt, index, oil, &tightness);
+            } else {
+                IndexBoundsBuilder::translate(predicate, keyElt, index, oil, &tightness);
+                hasBounds = true;
+            }
+        }
+
+        if (!hasBounds) {
+            IndexBoundsBuilder::allValuesForField(keyElt, oil);
+        }
+        hasTrailingBounds = hasTrailingBounds || hasBounds;
+        ++pos;
+    }
+
+    if (!hasTrailingBounds) {
+        return nullptr;
+    }
+
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    // The bounds only narrow down the keys examined, so the whole query is applied to the fetched
+    // documents.
+    auto fetch = std::make_unique<FetchNode>();
+    fetch->filter = root->shallowClone();
+    fetch->children.push_back(isn.release());
+    return std::move(fetch);
+}
+
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
                                                  MatchExpression::MatchType type) {
@@ -1343,6 +1451,13 @@ void QueryPlannerAccess::handleFilterOr(ScanBuildingState* scanState) {
             scanState->loosestBounds = scanState->tightness;
         }
 
+        // The whole $or may become the filter of the scan, so even predicates with exact bounds
+        // must see the same values in every key of a document.
+        const IndexEntry& index = scanState->indices[scanState->currentIndexNumber];
+        if (!canFilterOnIndexKeys(index, scanState->ixtag->pos)) {
+            scanState->curOrFilterableOnIndexKeys = false;
+        }
+
         // Detach 'child' and add it to 'curOr'.
         root->getChildVector()->erase(root->getChildVector()->begin() + scanState->curChild);
         scanState->curOr->getChildVector()->push_back(child);
@@ -1363,18 +1478,20 @@ void QueryPlannerAccess::handleFilterAnd(ScanBuildingState* scanState) {
         root->getChildVector()->erase(root->getChildVector()->begin() + scanState->curChild);
         delete child;
     } else if (scanState->tightness == IndexBoundsBuilder::INEXACT_COVERED &&
-               (INDEX_TEXT == index.type || !index.multikey)) {
+               (INDEX_TEXT == index.type ||
+                canFilterOnIndexKeys(index, scanState->ixtag->pos))) {
         // The bounds are not exact, but the information needed to
         // evaluate the predicate is in the index key. Remove the
         // MatchExpression from its parent and attach it to the filter
         // of the index scan we're building.
         //
-        // We can only use this optimization if the index is NOT multikey.
-        // Suppose that we had the multikey index {x: 1} and a document
-        // {x: ["a", "b"]}. Now if we query for {x: /b/} the filter might
-        // ever only be applied to the index key "a". We'd incorrectly
-        // conclude that the document does not match the query :( so we
-        // gotta stick to non-multikey indices.
+        // We can only use this optimization if the predicate's field is
+        // not multikey. Suppose that we had the multikey index {x: 1} and
+        // a document {x: ["a", "b"]}. Now if we query for {x: /b/} the
+        // filter might ever only be applied to the index key "a". We'd
+        // incorrectly conclude that the document does not match the query
+        // :( so we gotta stick to fields which the index's path-level
+        // multikey metadata shows never hold arrays.
         root->getChildVector()->erase(root->getChildVector()->begin() + scanState->curChild);
 
         addFilterToSolutionNode(scanState->currentScan.get(), child, root->matchType());
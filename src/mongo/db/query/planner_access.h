@@ -110,6 +110,18 @@ public:
                                                              const QueryPlannerParams& params,
                                                              int direction = 1);
 
+    /**
+     * Return a plan that scans the provided compound index with bounds built from the predicates
+     * of 'query' on the index's non-leading fields, leaving the leading field unbounded. The index
+     * scan's bounds checker then skips from one distinct leading value to the next, seeking
+     * directly to the start of the trailing bounds under each. Returns nullptr if the query
+     * constrains the leading field, or none of the others, or if the index cannot be scanned this
+     * way.
+     */
+    static std::unique_ptr<QuerySolutionNode> skipScanIndex(const IndexEntry& index,
+                                                            const CanonicalQuery& query,
+                                                            const QueryPlannerParams& params);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
@@ -149,7 +161,8 @@ private:
               ixtag(nullptr),
               tightness(IndexBoundsBuilder::INEXACT_FETCH),
               curOr(nullptr),
-              loosestBounds(IndexBoundsBuilder::EXACT) {}
+              loosestBounds(IndexBoundsBuilder::EXACT),
+              curOrFilterableOnIndexKeys(true) {}
 
         /**
          * Reset the scan building state in preparation for building a new scan.
@@ -161,6 +174,7 @@ private:
             currentIndexNumber = newTag->index;
             tightness = IndexBoundsBuilder::INEXACT_FETCH;
             loosestBounds = IndexBoundsBuilder::EXACT;
+            curOrFilterableOnIndexKeys = true;
 
             if (MatchExpression::OR == root->matchType()) {
                 curOr = std::make_unique<OrMatchExpression>();
@@ -214,6 +228,10 @@ private:
         // INEXACT_FETCH, then 'loosestBounds' is INEXACT_COVERED.
         IndexBoundsBuilder::BoundsTightness loosestBounds;
 
+        // Whether every predicate in 'curOr' is over a field for which canFilterOnIndexKeys()
+        // holds, so that 'curOr' as a whole may be applied to the index keys.
+        bool curOrFilterableOnIndexKeys;
+
     private:
         // Default constructor is not allowed.
         ScanBuildingState();
@@ -387,6 +405,15 @@ private:
      */
     static bool orNeedsFetch(const ScanBuildingState* scanState);
 
+    /**
+     * Returns true if a predicate over the field at position 'pos' of the key pattern of 'index'
+     * gives the same answer for every index key of a document. This holds unless the index is
+     * multikey, and its path-level multikey metadata does not show that field's path to be free of
+     * arrays. Only then can the predicate be applied as a filter on the index scan, since the scan
+     * deduplicates the keys of each document before filtering them.
+     */
+    static bool canFilterOnIndexKeys(const IndexEntry& index, size_t pos);
+
     static void finishTextNode(QuerySolutionNode* node, const IndexEntry& index);
 
     /**
@@ -40,6 +40,8 @@
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/query/index_statistics.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/util/log.h"
@@ -59,6 +61,18 @@ namespace dps = ::mongo::dotted_path_support;
 
 namespace {
 
+/**
+ * If 'node' is a TEXT node whose results are sorted by nothing but their text score, and only the
+ * first 'limit' of them are needed, passes the limit down to the TEXT node.
+ */
+void pushLimitIntoTextNode(const BSONObj& sortObj, QuerySolutionNode* node, size_t limit) {
+    if (!internalQueryPlannerEnableTextScoreLimit.load() || STAGE_TEXT != node->getType() ||
+        sortObj.nFields() != 1 || !QueryRequest::isTextScoreMeta(sortObj.firstElement())) {
+        return;
+    }
+    static_cast<TextNode*>(node)->limit = limit;
+}
+
 /**
  * Walk the tree 'root' and output all leaf nodes into 'leafNodes'.
  */
@@ -396,6 +410,36 @@ std::unique_ptr<ProjectionNode> analyzeProjection(const CanonicalQuery& query,
         std::move(solnRoot), *query.root(), qr.getProj(), *query.getProj());
 }
 
+/**
+ * Returns true if the index statistics in 'params' estimate that exploding 'leafNodes' into
+ * 'totalNumScans' point scans leaves few enough keys to each of them to be worth the extra scans,
+ * as long as there are not too many of those either. A merge sort of the scans then costs little
+ * more than the scans themselves, where a blocking sort would have to buffer every result.
+ */
+bool fewKeysPerExplodedScan(const QueryPlannerParams& params,
+                            const vector<QuerySolutionNode*>& leafNodes,
+                            size_t totalNumScans) {
+    if (!params.indexStatistics ||
+        totalNumScans > (size_t)internalQueryMaxScansToExplodeWithStatistics.load()) {
+        return false;
+    }
+
+    double totalNumKeys = 0;
+    for (auto leaf : leafNodes) {
+        auto numKeys =
+            params.indexStatistics->estimateNumKeys(static_cast<const IndexScanNode*>(leaf));
+        if (!numKeys) {
+            return false;
+        }
+        totalNumKeys += *numKeys;
+    }
+
+    const double keysPerScan = totalNumKeys / totalNumScans;
+    LOG(5) << "Estimated " << keysPerScan << " keys for each of " << totalNumScans
+           << " exploded ixscans";
+    return keysPerScan <= internalQueryMaxKeysPerScanToExplode.load();
+}
+
 }  // namespace
 
 // static
@@ -550,7 +594,8 @@ bool QueryPlannerAnalysis::explodeForSort(const CanonicalQuery& query,
     }
 
     // Too many ixscans spoil the performance.
-    if (totalNumScans > (size_t)internalQueryMaxScansToExplode.load()) {
+    if (totalNumScans > (size_t)internalQueryMaxScansToExplode.load() &&
+        !fewKeysPerExplodedScan(params, leafNodes, totalNumScans)) {
         LOG(5) << "Could expand ixscans to pull out sort order but resulting scan count"
                << "(" << totalNumScans << ") is too high.";
         return false;
@@ -650,6 +695,7 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
 
     // And build the full sort stage. The sort stage has to have a sort key generating stage
     // as its child, supplying it with the appropriate sort keys.
+    QuerySolutionNode* const sortedNode = solnRoot;
     SortKeyGeneratorNode* keyGenNode = new SortKeyGeneratorNode();
     keyGenNode->sortSpec = sortObj;
     keyGenNode->children.push_back(solnRoot);
@@ -666,6 +712,7 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         // We have a true limit. The limit can be combined with the SORT stage.
         sort->limit =
             static_cast<size_t>(*qr.getLimit()) + static_cast<size_t>(qr.getSkip().value_or(0));
+        pushLimitIntoTextNode(sortObj, sortedNode, sort->limit);
     } else if (qr.getNToReturn()) {
         // We have an ntoreturn specified by an OP_QUERY style find. This is used
         // by clients to mean both batchSize and limit.
@@ -0,0 +1,338 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/client/dbclient_cursor.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+
+#ifdef MONGO_QUERY_BM_COUNT_ALLOCATIONS
+#include <gperftools/malloc_hook.h>
+#endif
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("query_bm.coll");
+
+// The storage engines on which each workload runs, selected by the "engine" argument.
+const std::vector<std::string> kEngines = {
+    "biggie",
+#ifdef MONGO_QUERY_BM_HAVE_WIREDTIGER
+    "wiredTiger",
+#endif
+};
+
+#ifdef MONGO_QUERY_BM_COUNT_ALLOCATIONS
+AtomicWord<long long> allocationCount{0};
+
+void countAllocation(const void* ptr, size_t size) {
+    allocationCount.fetchAndAddRelaxed(1);
+}
+#endif
+
+/**
+ * Counts the memory allocations made by every thread while this object is in scope, when the
+ * allocator is tcmalloc. Otherwise nothing is counted.
+ */
+class AllocationCounter {
+public:
+    AllocationCounter() {
+#ifdef MONGO_QUERY_BM_COUNT_ALLOCATIONS
+        invariant(MallocHook::AddNewHook(&countAllocation));
+        _start = allocationCount.load();
+#endif
+    }
+
+    ~AllocationCounter() {
+#ifdef MONGO_QUERY_BM_COUNT_ALLOCATIONS
+        invariant(MallocHook::RemoveNewHook(&countAllocation));
+#endif
+    }
+
+    /**
+     * Reports the number of operations per second and, if allocations are counted, the number of
+     * allocations per operation.
+     */
+    void report(benchmark::State& state) const {
+        state.SetItemsProcessed(state.iterations());
+#ifdef MONGO_QUERY_BM_COUNT_ALLOCATIONS
+        if (state.iterations() > 0) {
+            state.counters["allocsPerOp"] =
+                static_cast<double>(allocationCount.load() - _start) / state.iterations();
+        }
+#endif
+    }
+
+private:
+    long long _start = 0;
+};
+
+/**
+ * A mongod ServiceContext with a storage engine of its own, on which a workload runs commands
+ * through DBDirectClient, as a client connected to a standalone server would.
+ */
+class QueryBenchmarkFixture : public ServiceContextMongoDTest {
+public:
+    explicit QueryBenchmarkFixture(benchmark::State& state)
+        : ServiceContextMongoDTest(kEngines[state.range(0)]) {
+        state.SetLabel(kEngines[state.range(0)]);
+
+        auto service = getServiceContext();
+        auto replCoord = std::make_unique<repl::ReplicationCoordinatorMock>(service);
+        invariant(replCoord->setFollowerMode(repl::MemberState::RS_PRIMARY));
+        repl::ReplicationCoordinator::set(service, std::move(replCoord));
+
+        _opCtx = makeOperationContext();
+        _client = std::make_unique<DBDirectClient>(_opCtx.get());
+    }
+
+    ~QueryBenchmarkFixture() {
+        _client.reset();
+        _opCtx.reset();
+    }
+
+    DBDirectClient& client() {
+        return *_client;
+    }
+
+    /**
+     * Inserts the documents {_id: i, a: i, b: i % 100, g: i % 10, s: <string>} for each i in
+     * [0, numDocs), and creates an index on each of the key patterns in 'indexes'.
+     */
+    void load(int numDocs, const std::vector<BSONObj>& indexes = {}) {
+        std::vector<BSONObj> batch;
+        for (int i = 0; i < numDocs; ++i) {
+            batch.push_back(BSON("_id" << i << "a" << i << "b" << i % 100 << "g" << i % 10 << "s"
+                                       << ("value" + std::to_string(i % 1000))));
+            if (batch.size() == 1000 || i == numDocs - 1) {
+                _client->insert(kNss.ns(), batch);
+                batch.clear();
+            }
+        }
+        for (auto&& keys : indexes) {
+            _client->createIndex(kNss.ns(), keys);
+        }
+    }
+
+    /**
+     * Runs 'cmd' on the database of the collection, and throws if it fails.
+     */
+    BSONObj runCommand(const BSONObj& cmd) {
+        BSONObj result;
+        _client->runCommand(kNss.db().toString(), cmd, result);
+        uassertStatusOK(getStatusFromCommandResult(result));
+        return result;
+    }
+
+    /**
+     * Runs an aggregation of the collection with 'pipeline', whose results must fit in one batch.
+     */
+    BSONObj aggregate(const BSONArray& pipeline) {
+        const auto cursor = BSON("batchSize" << std::numeric_limits<int>::max());
+        return runCommand(
+            BSON("aggregate" << kNss.coll() << "pipeline" << pipeline << "cursor" << cursor));
+    }
+
+private:
+    // The fixture is not run as a unit test.
+    void _doTest() final {
+        MONGO_UNREACHABLE;
+    }
+
+    ServiceContext::UniqueOperationContext _opCtx;
+    std::unique_ptr<DBDirectClient> _client;
+};
+
+void BM_FindById(benchmark::State& state) {
+    QueryBenchmarkFixture fixture(state);
+    const int numDocs = state.range(1);
+    fixture.load(numDocs);
+
+    int i = 0;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            fixture.client().findOne(kNss.ns(), QUERY("_id" << i++ % numDocs)));
+    }
+    allocations.report(state);
+}
+
+void BM_FindIndexedRange(benchmark::State& state) {
+    QueryBenchmarkFixture fixture(state);
+    const int numDocs = state.range(1);
+    fixture.load(numDocs, {BSON("a" << 1)});
+
+    // Each query returns 100 documents.
+    int i = 0;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        const int start = (i++ * 100) % numDocs;
+        auto cursor = fixture.client().query(
+            kNss, QUERY("a" << BSON("$gte" << start << "$lt" << start + 100)));
+        benchmark::DoNotOptimize(cursor->itcount());
+    }
+    allocations.report(state);
+}
+
+void BM_FindCollectionScan(benchmark::State& state) {
+    QueryBenchmarkFixture fixture(state);
+    fixture.load(state.range(1));
+
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        auto cursor = fixture.client().query(kNss, QUERY("b" << 7 << "s" << BSON("$ne" << "")));
+        benchmark::DoNotOptimize(cursor->itcount());
+    }
+    allocations.report(state);
+}
+
+void BM_FindSortLimit(benchmark::State& state) {
+    QueryBenchmarkFixture fixture(state);
+    fixture.load(state.range(1));
+
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        auto cursor = fixture.client().query(kNss, Query().sort(BSON("s" << -1 << "a" << 1)), 10);
+        benchmark::DoNotOptimize(cursor->itcount());
+    }
+    allocations.report(state);
+}
+
+void BM_AggregateGroup(benchmark::State& state) {
+    QueryBenchmarkFixture fixture(state);
+    fixture.load(state.range(1));
+
+    const auto pipeline = BSON_ARRAY(BSON(
+        "$group" << BSON("_id"
+                         << "$g"
+                         << "total" << BSON("$sum" << "$a") << "avg" << BSON("$avg" << "$b"))));
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fixture.aggregate(pipeline));
+    }
+    allocations.report(state);
+}
+
+void BM_AggregateMatchProject(benchmark::State& state) {
+    QueryBenchmarkFixture fixture(state);
+    fixture.load(state.range(1), {BSON("b" << 1)});
+
+    const auto pipeline = BSON_ARRAY(
+        BSON("$match" << BSON("b" << BSON("$lt" << 5)))
+        << BSON("$project" << BSON("_id" << 0 << "a" << 1 << "sum"
+                                         << BSON("$add" << BSON_ARRAY("$a"
+                                                                      << "$b")))));
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fixture.aggregate(pipeline));
+    }
+    allocations.report(state);
+}
+
+void BM_UpdateById(benchmark::State& state) {
+    QueryBenchmarkFixture fixture(state);
+    const int numDocs = state.range(1);
+    fixture.load(numDocs, {BSON("b" << 1)});
+
+    int i = 0;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        fixture.client().update(
+            kNss.ns(), QUERY("_id" << i++ % numDocs), BSON("$inc" << BSON("b" << 1)));
+    }
+    allocations.report(state);
+}
+
+void BM_InsertOne(benchmark::State& state) {
+    QueryBenchmarkFixture fixture(state);
+    fixture.load(state.range(1), {BSON("a" << 1), BSON("b" << 1)});
+
+    int i = state.range(1);
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        fixture.client().insert(kNss.ns(),
+                                BSON("_id" << i << "a" << i << "b" << i % 100 << "g" << i % 10));
+        ++i;
+    }
+    allocations.report(state);
+}
+
+void BM_IndexBuild(benchmark::State& state) {
+    QueryBenchmarkFixture fixture(state);
+    fixture.load(state.range(1));
+
+    const BSONObj keys = BSON("s" << 1 << "a" << 1);
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        fixture.client().createIndex(kNss.ns(), keys);
+
+        state.PauseTiming();
+        fixture.client().dropIndex(kNss.ns(), keys);
+        state.ResumeTiming();
+    }
+    allocations.report(state);
+}
+
+/**
+ * Runs a workload on each storage engine over collections of 1,000 and 10,000 documents.
+ */
+void withEnginesAndSizes(benchmark::internal::Benchmark* bm) {
+    bm->ArgNames({"engine", "docs"});
+    for (size_t engine = 0; engine < kEngines.size(); ++engine) {
+        for (int numDocs : {1000, 10000}) {
+            bm->Args({static_cast<int>(engine), numDocs});
+        }
+    }
+}
+
+BENCHMARK(BM_FindById)->Apply(withEnginesAndSizes);
+BENCHMARK(BM_FindIndexedRange)->Apply(withEnginesAndSizes);
+BENCHMARK(BM_FindCollectionScan)->Apply(withEnginesAndSizes);
+BENCHMARK(BM_FindSortLimit)->Apply(withEnginesAndSizes);
+BENCHMARK(BM_AggregateGroup)->Apply(withEnginesAndSizes);
+BENCHMARK(BM_AggregateMatchProject)->Apply(withEnginesAndSizes);
+BENCHMARK(BM_UpdateById)->Apply(withEnginesAndSizes);
+BENCHMARK(BM_InsertOne)->Apply(withEnginesAndSizes);
+BENCHMARK(BM_IndexBuild)->Apply(withEnginesAndSizes)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,184 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_memory_tracker.h"
+
+#include <set>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+const auto getTracker =
+    OperationContext::declareDecoration<std::shared_ptr<QueryMemoryTracker>>();
+
+AtomicWord<long long> totalBytes{0};
+
+// Every live tracker, to find the operation using the most memory once the budget is exceeded.
+stdx::mutex trackersMutex;
+std::set<const QueryMemoryTracker*> trackers;
+
+const std::shared_ptr<QueryMemoryTracker>& getOrCreateTracker(OperationContext* opCtx) {
+    auto& tracker = getTracker(opCtx);
+    if (!tracker) {
+        auto newTracker = std::make_shared<QueryMemoryTracker>();
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        tracker = std::move(newTracker);
+    }
+    return tracker;
+}
+
+}  // namespace
+
+QueryMemoryTracker::StageUsage::StageUsage(StageUsage&& other)
+    : _tracker(std::move(other._tracker)), _bytes(other._bytes) {
+    other._bytes = 0;
+}
+
+QueryMemoryTracker::StageUsage& QueryMemoryTracker::StageUsage::operator=(StageUsage&& other) {
+    if (this != &other) {
+        _release();
+        _tracker = std::move(other._tracker);
+        _bytes = other._bytes;
+        other._bytes = 0;
+    }
+    return *this;
+}
+
+QueryMemoryTracker::StageUsage::~StageUsage() {
+    _release();
+}
+
+void QueryMemoryTracker::StageUsage::set(OperationContext* opCtx, size_t bytes) {
+    if (opCtx) {
+        const auto& tracker = getOrCreateTracker(opCtx);
+        if (tracker != _tracker) {
+            _release();
+            _tracker = tracker;
+        }
+    }
+
+    const long long delta = static_cast<long long>(bytes) - static_cast<long long>(_bytes);
+    if (delta != 0) {
+        if (_tracker) {
+            _tracker->_add(delta);
+        }
+        totalBytes.fetchAndAdd(delta);
+        _bytes = bytes;
+    }
+}
+
+bool QueryMemoryTracker::StageUsage::shouldSpill() const {
+    return _bytes >= kMinBytesToSpill && isOverBudget();
+}
+
+Status QueryMemoryTracker::StageUsage::checkBudget() const {
+    if (!_tracker || _tracker->getCurrentBytes() < static_cast<long long>(kMinBytesToSpill) ||
+        !isOverBudget() || !_tracker->_isLargestConsumer()) {
+        return Status::OK();
+    }
+
+    return {ErrorCodes::ExceededMemoryLimit,
+            str::stream() << "Operation used " << _tracker->getCurrentBytes()
+                          << " bytes, the most memory of all queries, while queries in total used "
+                          << getTotalBytes()
+                          << " bytes, more than internalQueryMaxTotalMemoryUsageBytes of "
+                          << internalQueryMaxTotalMemoryUsageBytes.load() << " bytes"};
+}
+
+void QueryMemoryTracker::StageUsage::_release() {
+    if (_bytes > 0) {
+        if (_tracker) {
+            _tracker->_add(-static_cast<long long>(_bytes));
+        }
+        totalBytes.fetchAndSubtract(_bytes);
+        _bytes = 0;
+    }
+}
+
+QueryMemoryTracker::QueryMemoryTracker() {
+    stdx::lock_guard<stdx::mutex> lk(trackersMutex);
+    trackers.insert(this);
+}
+
+QueryMemoryTracker::~QueryMemoryTracker() {
+    stdx::lock_guard<stdx::mutex> lk(trackersMutex);
+    trackers.erase(this);
+}
+
+std::shared_ptr<QueryMemoryTracker> QueryMemoryTracker::get(OperationContext* opCtx) {
+    return getOrCreateTracker(opCtx);
+}
+
+const QueryMemoryTracker* QueryMemoryTracker::getIfExists_inlock(OperationContext* opCtx) {
+    return getTracker(opCtx).get();
+}
+
+long long QueryMemoryTracker::getTotalBytes() {
+    return totalBytes.load();
+}
+
+bool QueryMemoryTracker::isOverBudget() {
+    const long long budget = internalQueryMaxTotalMemoryUsageBytes.load();
+    return budget > 0 && totalBytes.load() > budget;
+}
+
+void QueryMemoryTracker::append(BSONObjBuilder* builder) const {
+    if (auto peak = getPeakBytes(); peak > 0) {
+        builder->append("queryMemoryUsageBytes", getCurrentBytes());
+        builder->append("peakQueryMemoryUsageBytes", peak);
+    }
+}
+
+void QueryMemoryTracker::_add(long long bytes) {
+    const long long current = _currentBytes.addAndFetch(bytes);
+    if (current > _peakBytes.load()) {
+        _peakBytes.store(current);
+    }
+}
+
+bool QueryMemoryTracker::_isLargestConsumer() const {
+    const long long bytes = getCurrentBytes();
+    stdx::lock_guard<stdx::mutex> lk(trackersMutex);
+    for (auto&& tracker : trackers) {
+        if (tracker->getCurrentBytes() > bytes) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace mongo
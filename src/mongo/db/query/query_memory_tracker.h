@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "mongo/base/status.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * The memory buffered by the query stages of one operation, such as blocking sorts, $group,
+ * hashed AND and the $lookup and $facet caches. Each of these stages owns a StageUsage and
+ * reports its usage there, which also adds it to the total over all operations.
+ *
+ * When 'internalQueryMaxTotalMemoryUsageBytes' is set and the total exceeds it, stages which can
+ * spill to disk or drop a cache do so early, and those which cannot fail the operation if it is
+ * the one using the most memory.
+ *
+ * A tracker is shared by its operation and the stages which reported to it, so that the usage of
+ * a cursor stays accounted for between its getMores.
+ */
+class QueryMemoryTracker {
+    QueryMemoryTracker(const QueryMemoryTracker&) = delete;
+    QueryMemoryTracker& operator=(const QueryMemoryTracker&) = delete;
+
+public:
+    /**
+     * Stages which buffer less than this do not spill in favour of the budget, so that a stage
+     * which holds little does not write a file for every document it reads.
+     */
+    static constexpr size_t kMinBytesToSpill = 1024 * 1024;
+
+    /**
+     * The memory buffered by one stage. The usage is released when the StageUsage is destroyed.
+     */
+    class StageUsage {
+        StageUsage(const StageUsage&) = delete;
+        StageUsage& operator=(const StageUsage&) = delete;
+
+    public:
+        StageUsage() = default;
+        StageUsage(StageUsage&& other);
+        StageUsage& operator=(StageUsage&& other);
+        ~StageUsage();
+
+        /**
+         * Sets the bytes buffered by the stage, which is running as part of 'opCtx'. The usage
+         * moves to the tracker of 'opCtx' if it was last reported under another operation.
+         */
+        void set(OperationContext* opCtx, size_t bytes);
+
+        size_t get() const {
+            return _bytes;
+        }
+
+        /**
+         * Returns true if the stage is asked to spill or drop what it buffers because the total
+         * usage of all operations exceeds the budget.
+         */
+        bool shouldSpill() const;
+
+        /**
+         * Returns ExceededMemoryLimit if the total usage exceeds the budget and the operation of
+         * this stage uses the most memory of all operations. Stages which cannot spill call this
+         * while they buffer.
+         */
+        Status checkBudget() const;
+
+    private:
+        void _release();
+
+        std::shared_ptr<QueryMemoryTracker> _tracker;
+        size_t _bytes = 0;
+    };
+
+    QueryMemoryTracker();
+    ~QueryMemoryTracker();
+
+    /**
+     * Returns the tracker of 'opCtx', creating it on first use. Must be called by the thread which
+     * runs the operation.
+     */
+    static std::shared_ptr<QueryMemoryTracker> get(OperationContext* opCtx);
+
+    /**
+     * Returns the tracker of 'opCtx', or null if no stage has reported to it yet. The caller must
+     * hold the lock of the Client of 'opCtx'.
+     */
+    static const QueryMemoryTracker* getIfExists_inlock(OperationContext* opCtx);
+
+    /**
+     * Returns the bytes buffered by all stages of all operations.
+     */
+    static long long getTotalBytes();
+
+    /**
+     * Returns true if 'internalQueryMaxTotalMemoryUsageBytes' is set and exceeded.
+     */
+    static bool isOverBudget();
+
+    long long getCurrentBytes() const {
+        return _currentBytes.load();
+    }
+
+    long long getPeakBytes() const {
+        return _peakBytes.load();
+    }
+
+    /**
+     * Appends the "queryMemoryUsageBytes" and "peakQueryMemoryUsageBytes" of the operation if it
+     * has buffered any memory.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+private:
+    void _add(long long bytes);
+
+    bool _isLargestConsumer() const;
+
+    AtomicWord<long long> _currentBytes{0};
+    AtomicWord<long long> _peakBytes{0};
+};
+
+}  // namespace mongo
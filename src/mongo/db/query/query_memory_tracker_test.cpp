@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_memory_tracker.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const size_t kMB = QueryMemoryTracker::kMinBytesToSpill;
+
+class QueryMemoryTrackerTest : public ServiceContextTest {
+public:
+    ~QueryMemoryTrackerTest() {
+        internalQueryMaxTotalMemoryUsageBytes.store(0);
+    }
+};
+
+TEST_F(QueryMemoryTrackerTest, StageUsageIsAddedToOperationAndTotal) {
+    auto opCtx = makeOperationContext();
+    const auto totalBefore = QueryMemoryTracker::getTotalBytes();
+    {
+        QueryMemoryTracker::StageUsage first;
+        QueryMemoryTracker::StageUsage second;
+        first.set(opCtx.get(), 100);
+        second.set(opCtx.get(), 50);
+        first.set(opCtx.get(), 30);
+
+        auto tracker = QueryMemoryTracker::get(opCtx.get());
+        ASSERT_EQ(80, tracker->getCurrentBytes());
+        ASSERT_EQ(150, tracker->getPeakBytes());
+        ASSERT_EQ(totalBefore + 80, QueryMemoryTracker::getTotalBytes());
+    }
+
+    auto tracker = QueryMemoryTracker::get(opCtx.get());
+    ASSERT_EQ(0, tracker->getCurrentBytes());
+    ASSERT_EQ(150, tracker->getPeakBytes());
+    ASSERT_EQ(totalBefore, QueryMemoryTracker::getTotalBytes());
+
+    BSONObjBuilder builder;
+    tracker->append(&builder);
+    ASSERT_BSONOBJ_EQ(BSON("queryMemoryUsageBytes" << 0LL << "peakQueryMemoryUsageBytes" << 150LL),
+                      builder.obj());
+}
+
+TEST_F(QueryMemoryTrackerTest, UnusedTrackerAppendsNothing) {
+    auto opCtx = makeOperationContext();
+    ASSERT(!QueryMemoryTracker::getIfExists_inlock(opCtx.get()));
+
+    BSONObjBuilder builder;
+    QueryMemoryTracker::get(opCtx.get())->append(&builder);
+    ASSERT_BSONOBJ_EQ(BSONObj(), builder.obj());
+}
+
+TEST_F(QueryMemoryTrackerTest, StageUsageOutlivesItsOperationAndMovesToTheNext) {
+    QueryMemoryTracker::StageUsage usage;
+    std::shared_ptr<QueryMemoryTracker> firstTracker;
+    {
+        auto opCtx = makeOperationContext();
+        usage.set(opCtx.get(), 100);
+        firstTracker = QueryMemoryTracker::get(opCtx.get());
+    }
+
+    // A null OperationContext keeps reporting to the last tracker, like a detached cursor.
+    usage.set(nullptr, 120);
+    ASSERT_EQ(120, firstTracker->getCurrentBytes());
+
+    auto opCtx = makeOperationContext();
+    usage.set(opCtx.get(), 70);
+    ASSERT_EQ(0, firstTracker->getCurrentBytes());
+    ASSERT_EQ(70, QueryMemoryTracker::get(opCtx.get())->getCurrentBytes());
+}
+
+TEST_F(QueryMemoryTrackerTest, MovedStageUsageKeepsItsBytes) {
+    auto opCtx = makeOperationContext();
+    auto tracker = QueryMemoryTracker::get(opCtx.get());
+
+    QueryMemoryTracker::StageUsage usage;
+    usage.set(opCtx.get(), 100);
+    QueryMemoryTracker::StageUsage moved(std::move(usage));
+    ASSERT_EQ(100u, moved.get());
+    ASSERT_EQ(100, tracker->getCurrentBytes());
+
+    QueryMemoryTracker::StageUsage assigned;
+    assigned.set(opCtx.get(), 10);
+    assigned = std::move(moved);
+    ASSERT_EQ(100, tracker->getCurrentBytes());
+}
+
+TEST_F(QueryMemoryTrackerTest, BudgetSpillsLargeStagesAndFailsTheLargestConsumer) {
+    auto opCtx = makeOperationContext();
+    auto otherClient = getServiceContext()->makeClient("other");
+    auto otherOpCtx = otherClient->makeOperationContext();
+
+    QueryMemoryTracker::StageUsage large;
+    QueryMemoryTracker::StageUsage small;
+    QueryMemoryTracker::StageUsage other;
+    large.set(opCtx.get(), 3 * kMB);
+    small.set(opCtx.get(), kMB / 2);
+    other.set(otherOpCtx.get(), 2 * kMB);
+
+    // Without a budget, nothing spills or fails.
+    ASSERT_FALSE(QueryMemoryTracker::isOverBudget());
+    ASSERT_FALSE(large.shouldSpill());
+    ASSERT_OK(large.checkBudget());
+
+    internalQueryMaxTotalMemoryUsageBytes.store(QueryMemoryTracker::getTotalBytes() - 1);
+    ASSERT(QueryMemoryTracker::isOverBudget());
+    ASSERT(large.shouldSpill());
+    ASSERT(other.shouldSpill());
+    ASSERT_FALSE(small.shouldSpill());
+
+    // Only the operation using the most memory fails, from any of its stages.
+    ASSERT_EQ(ErrorCodes::ExceededMemoryLimit, large.checkBudget());
+    ASSERT_EQ(ErrorCodes::ExceededMemoryLimit, small.checkBudget());
+    ASSERT_OK(other.checkBudget());
+
+    large.set(opCtx.get(), 0);
+    ASSERT_FALSE(QueryMemoryTracker::isOverBudget());
+    ASSERT_OK(other.checkBudget());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "mongo/db/jsobj.h"
@@ -37,6 +38,8 @@
 
 namespace mongo {
 
+class CollectionIndexStatistics;
+
 struct QueryPlannerParams {
     QueryPlannerParams()
         : options(DEFAULT),
@@ -98,6 +101,10 @@ struct QueryPlannerParams {
         // return exactly one document per value of the distinct field. See the comments above the
         // declaration of getExecutorDistinct() for more detail.
         STRICT_DISTINCT_ONLY = 1 << 11,
+
+        // Set this to generate skip scans over compound indexes whose leading field the query
+        // does not constrain but some later field it does.
+        GENERATE_SKIP_SCANS = 1 << 12,
     };
 
     // See Options enum above.
@@ -118,6 +125,10 @@ struct QueryPlannerParams {
     // plans via the MultiPlanStage, and the set of possible plans is very large for certain
     // index+query combinations.
     size_t maxIndexedSolutions;
+
+    // The statistics most recently sampled for the collection's indexes, if any. Used to estimate
+    // the size of index scans while their shape is decided.
+    std::shared_ptr<const CollectionIndexStatistics> indexStatistics;
 };
 
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_always_boolean.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_test_fixture.h"
 
@@ -2090,6 +2091,57 @@ TEST_F(QueryPlannerTest, ExplodeMustReverseScans2) {
         "{ixscan: {pattern: {a:1, b:1, c:-1}}}]}}}}");
 }
 
+/**
+ * Returns index statistics for a collection of 'numRecords' documents, sampled as holding each of
+ * the values 0 to 'numDistinct' - 1 for 'a' equally often.
+ */
+std::shared_ptr<const CollectionIndexStatistics> makeStatisticsForA(int numDistinct,
+                                                                    long long numRecords) {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < 100; ++i) {
+        sample.push_back(BSON("" << i % numDistinct));
+    }
+    StringMap<FieldHistogram> histograms;
+    histograms.emplace("a", FieldHistogram(std::move(sample), numRecords));
+    return std::make_shared<CollectionIndexStatistics>(numRecords, std::move(histograms));
+}
+
+TEST_F(QueryPlannerTest, ExplodeBeyondScanLimitWhenStatisticsEstimateFewKeysPerScan) {
+    int oldMaxScansToExplode = internalQueryMaxScansToExplode.load();
+    internalQueryMaxScansToExplode.store(2);
+
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    const BSONObj query = fromjson("{a: {$in: [1, 2, 3]}}");
+
+    // Without statistics, three scans are too many.
+    runQuerySortProj(query, BSON("b" << 1), BSONObj());
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{sort: {pattern: {b: 1}, limit: 0, node: {sortKeyGen: {node: "
+        "{fetch: {node: {ixscan: {pattern: {a: 1, b: 1}}}}}}}}}");
+
+    // Each value of 'a' is estimated to match 100 documents.
+    params.indexStatistics = makeStatisticsForA(10, 1000);
+    runQuerySortProj(query, BSON("b" << 1), BSONObj());
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{sort: {pattern: {b: 1}, limit: 0, node: {sortKeyGen: {node: "
+        "{fetch: {node: {ixscan: {pattern: {a: 1, b: 1}}}}}}}}}");
+
+    // Each value of 'a' is estimated to match 2 documents.
+    params.indexStatistics = makeStatisticsForA(100, 200);
+    runQuerySortProj(query, BSON("b" << 1), BSONObj());
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {node: {mergeSort: {nodes: "
+        "[{ixscan: {pattern: {a: 1, b: 1}}},"
+        "{ixscan: {pattern: {a: 1, b: 1}}},"
+        "{ixscan: {pattern: {a: 1, b: 1}}}]}}}}");
+
+    internalQueryMaxScansToExplode.store(oldMaxScansToExplode);
+}
+
 // SERVER-13752: don't try to explode if the ordered interval list for
 // the leading field of the compound index is empty.
 TEST_F(QueryPlannerTest, CantExplodeWithEmptyBounds) {
@@ -4048,6 +4100,50 @@ TEST_F(QueryPlannerTest, OrEnumerationLimit2) {
     assertNumSolutions(internalQueryEnumerationMaxOrSolutions.load());
 }
 
+TEST_F(QueryPlannerTest, OrEnumerationGreedyPicksEqualityIndexPerClause) {
+    int oldGreedyThreshold = internalQueryEnumerationGreedyThreshold.load();
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+
+    // Each clause can use either index, for four choices in total.
+    const BSONObj query = fromjson("{$or: [{a: 1, b: {$gt: 1}}, {a: {$gt: 1}, b: 1}]}");
+    internalQueryEnumerationGreedyThreshold.store(4);
+    runQuery(query);
+    assertNumSolutions(4U);
+
+    // Past the threshold, only the plan which scans the index with the equality in each clause is
+    // output.
+    internalQueryEnumerationGreedyThreshold.store(3);
+    runQuery(query);
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{or: {nodes: ["
+        "{fetch: {filter: {b: {$gt: 1}}, node: {ixscan: {pattern: {a: 1}}}}},"
+        "{fetch: {filter: {a: {$gt: 1}}, node: {ixscan: {pattern: {b: 1}}}}}]}}");
+
+    internalQueryEnumerationGreedyThreshold.store(oldGreedyThreshold);
+}
+
+TEST_F(QueryPlannerTest, OrEnumerationGreedyPrefersLongerEqualityPrefix) {
+    int oldGreedyThreshold = internalQueryEnumerationGreedyThreshold.load();
+    internalQueryEnumerationGreedyThreshold.store(1);
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1 << "a" << 1));
+
+    runQuery(fromjson("{$or: [{a: 1, b: 1}, {a: 2, b: 2}]}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {or: {nodes: ["
+        "{ixscan: {pattern: {b: 1, a: 1}, bounds: {b: [[1,1,true,true]], a: [[1,1,true,true]]}}},"
+        "{ixscan: {pattern: {b: 1, a: 1}, bounds: {b: [[2,2,true,true]], a: [[2,2,true,true]]}}}"
+        "]}}}}");
+
+    internalQueryEnumerationGreedyThreshold.store(oldGreedyThreshold);
+}
+
 // SERVER-13104: test that we properly enumerate all solutions for nested $or.
 TEST_F(QueryPlannerTest, EnumerateNestedOr) {
     params.options = QueryPlannerParams::NO_TABLE_SCAN;
@@ -5882,6 +5978,73 @@ TEST_F(QueryPlannerTest, EmptyQueryWithProjectionUsesCollscanIfIndexCollationDif
         "{cscan: {dir: 1}}}}");
 }
 
+TEST_F(QueryPlannerTest, PredicateOnTrailingFieldUsesSkipScanIfEnabled) {
+    params.options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("tenant" << 1 << "ts" << 1));
+    runQuery(fromjson("{ts: {$gte: 5, $lt: 10}}"));
+    assertNumSolutions(2);
+    assertSolutionExists("{cscan: {dir: 1, filter: {ts: {$gte: 5, $lt: 10}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {ts: {$gte: 5, $lt: 10}}, node: "
+        "{ixscan: {filter: null, pattern: {tenant: 1, ts: 1}, bounds: "
+        "{tenant: [['MinKey', 'MaxKey', true, true]], ts: [[5, 10, true, false]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, PredicateOnTrailingFieldDoesNotUseSkipScanIfDisabled) {
+    params.options &= ~QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("tenant" << 1 << "ts" << 1));
+    runQuery(fromjson("{ts: {$gte: 5, $lt: 10}}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1, filter: {ts: {$gte: 5, $lt: 10}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanBoundsOnlyFieldsWithPredicates) {
+    params.options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << -1 << "c" << 1));
+    runQuery(fromjson("{c: {$in: [1, 3]}, d: 4}"));
+    assertNumSolutions(2);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: {c: {$in: [1, 3]}, d: 4}, node: "
+        "{ixscan: {filter: null, pattern: {a: 1, b: -1, c: 1}, bounds: "
+        "{a: [['MinKey', 'MaxKey', true, true]], b: [['MaxKey', 'MinKey', true, true]], "
+        "c: [[1, 1, true, true], [3, 3, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanWhenLeadingFieldIsConstrained) {
+    params.options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("tenant" << 1 << "ts" << 1));
+    runQuery(fromjson("{tenant: {$gt: 'a'}, ts: 5}"));
+    assertNumSolutions(2);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {tenant: 1, ts: 1}, bounds: "
+        "{tenant: [['a', {}, false, false]], ts: [[5, 5, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanOverMultikeySparseOrPartialIndexes) {
+    params.options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    constexpr bool isMultikey = true;
+    addIndex(BSON("a" << 1 << "b" << 1), isMultikey);
+    addIndex(BSON("c" << 1 << "b" << 1), false, true /* sparse */);
+    auto filterObj = fromjson("{c: 1}");
+    auto filterExpr = QueryPlannerTest::parseMatchExpression(filterObj);
+    addIndex(BSON("d" << 1 << "b" << 1), filterExpr.get());
+    runQuery(fromjson("{b: 2}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 2}}}");
+}
+
+TEST_F(QueryPlannerTest, HintedIndexWithPredicateOnTrailingFieldUsesSkipScanIfEnabled) {
+    params.options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("tenant" << 1 << "ts" << 1));
+    runQueryHint(fromjson("{ts: 5}"), BSON("tenant" << 1 << "ts" << 1));
+    assertNumSolutions(1);
+    assertSolutionExists(
+        "{fetch: {filter: {ts: 5}, node: {ixscan: {pattern: {tenant: 1, ts: 1}, bounds: "
+        "{tenant: [['MinKey', 'MaxKey', true, true]], ts: [[5, 5, true, true]]}}}}}");
+}
+
 TEST_F(QueryPlannerTest, NoFetchStageWhenSingleFieldSortIsCoveredByIndex) {
     params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
     addIndex(fromjson("{a: 1, b: 1}"));
@@ -473,6 +473,40 @@ TEST_F(QueryPlannerTest, SortKeyMetaProjectionWithTextScoreMetaSort) {
         "{sortKeyGen: {node: {text: {search: 'foo'}}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, LimitOfTextScoreSortIsPushedIntoTextNode) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQueryAsCommand(
+        fromjson("{find: 'testns', filter: {$text: {$search: 'foo'}}, sort: {score: {$meta: "
+                 "'textScore'}}, projection: {score: {$meta: 'textScore'}}, limit: 20}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {score: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 20, pattern: {score: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', limit: 20}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, LimitOfSortOnTextScoreAndAnotherFieldIsNotPushedIntoTextNode) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQueryAsCommand(
+        fromjson("{find: 'testns', filter: {$text: {$search: 'foo'}}, sort: {score: {$meta: "
+                 "'textScore'}, a: 1}, projection: {score: {$meta: 'textScore'}}, limit: 20}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {score: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 20, pattern: {score: {$meta: 'textScore'}, a: 1}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', limit: 0}}}}}}}}");
+}
+
 TEST_F(QueryPlannerTest, PredicatesOverLeadingFieldsWithSharedPathPrefixHandledCorrectly) {
     const bool multikey = true;
     addIndex(BSON("a.x" << 1 << "a.y" << 1 << "b.x" << 1 << "b.y" << 1 << "_fts"
@@ -394,6 +394,14 @@ public:
         _readOnce = readOnce;
     }
 
+    bool allowDiskUse() const {
+        return _allowDiskUse;
+    }
+
+    void setAllowDiskUse(bool allowDiskUse) {
+        _allowDiskUse = allowDiskUse;
+    }
+
     void setAllowSpeculativeMajorityRead(bool allowSpeculativeMajorityRead) {
         _allowSpeculativeMajorityRead = allowSpeculativeMajorityRead;
     }
@@ -534,6 +542,8 @@ private:
     bool _exhaust = false;
     bool _allowPartialResults = false;
     bool _readOnce = false;
+    // Allows a blocking sort to spill to disk rather than fail once it exceeds its memory limit.
+    bool _allowDiskUse = false;
     bool _allowSpeculativeMajorityRead = false;
 
     boost::optional<long long> _replicationTerm;
@@ -287,6 +287,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If non-zero, the results are sorted by text score and only the 'limit' documents with the
+    // highest scores are needed, so the text stage may stop scoring documents early.
+    size_t limit = 0;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
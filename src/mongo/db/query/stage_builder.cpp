@@ -51,6 +51,7 @@
 #include "mongo/db/exec/limit.h"
 #include "mongo/db/exec/merge_sort.h"
 #include "mongo/db/exec/or.h"
+#include "mongo/db/exec/parallel_collection_scan.h"
 #include "mongo/db/exec/projection.h"
 #include "mongo/db/exec/shard_filter.h"
 #include "mongo/db/exec/skip.h"
@@ -59,6 +60,7 @@
 #include "mongo/db/exec/text.h"
 #include "mongo/db/index/fts_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/util/log.h"
 
@@ -81,6 +83,15 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.direction = (csn->direction == 1) ? CollectionScanParams::FORWARD
                                                      : CollectionScanParams::BACKWARD;
             params.shouldWaitForOplogVisibility = csn->shouldWaitForOplogVisibility;
+            if (ParallelCollectionScan::canParallelize(
+                    opCtx, collection, cq, params, csn->filter.get())) {
+                return new ParallelCollectionScan(
+                    opCtx,
+                    collection,
+                    static_cast<size_t>(internalQueryParallelCollectionScanPartitions.load()),
+                    ws,
+                    csn->filter.get());
+            }
             return new CollectionScan(opCtx, collection, params, ws, csn->filter.get());
         }
         case STAGE_IXSCAN: {
@@ -118,6 +129,10 @@ PlanStage* buildStages(OperationContext* opCtx,
             if (nullptr == childStage) {
                 return nullptr;
             }
+            if (STAGE_AND_HASH == childStage->stageType()) {
+                // The fetch discards the index keys, so the AND need not merge them.
+                static_cast<AndHashStage*>(childStage)->setRecordIdsOnly();
+            }
             return new FetchStage(opCtx, ws, childStage, fn->filter.get(), collection);
         }
         case STAGE_SORT: {
@@ -129,6 +144,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             SortStageParams params;
             params.pattern = sn->pattern;
             params.limit = sn->limit;
+            params.allowDiskUse = cq.getQueryRequest().allowDiskUse();
             return new SortStage(opCtx, params, ws, childStage);
         }
         case STAGE_SORT_KEY_GENERATOR: {
@@ -299,6 +315,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             // fail in this case (this improvement is being tracked by SERVER-21510).
             params.query = static_cast<FTSQueryImpl&>(*node->ftsQuery);
             params.wantTextScore = (cq.getProj() && cq.getProj()->wantTextScore());
+            params.limit = node->limit;
             return new TextStage(opCtx, params, ws, node->filter.get());
         }
         case STAGE_SHARDING_FILTER: {
@@ -380,9 +397,11 @@ PlanStage* buildStages(OperationContext* opCtx,
         case STAGE_IDHACK:
         case STAGE_MULTI_ITERATOR:
         case STAGE_MULTI_PLAN:
+        case STAGE_PARALLEL_COLLSCAN:
         case STAGE_PIPELINE_PROXY:
         case STAGE_QUEUED_DATA:
         case STAGE_RECORD_STORE_FAST_COUNT:
+        case STAGE_SAMPLED_COUNT:
         case STAGE_SUBPLAN:
         case STAGE_TEXT_MATCH:
         case STAGE_TEXT_OR:
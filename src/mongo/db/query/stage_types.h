@@ -76,6 +76,9 @@ enum StageType {
     STAGE_MULTI_PLAN,
     STAGE_OR,
 
+    // Scans a collection in several ranges at once.
+    STAGE_PARALLEL_COLLSCAN,
+
     // Projection has three alternate implementations.
     STAGE_PROJECTION_DEFAULT,
     STAGE_PROJECTION_COVERED,
@@ -87,6 +90,7 @@ enum StageType {
 
     STAGE_QUEUED_DATA,
     STAGE_RECORD_STORE_FAST_COUNT,
+    STAGE_SAMPLED_COUNT,
     STAGE_SHARDING_FILTER,
     STAGE_SKIP,
     STAGE_SORT,
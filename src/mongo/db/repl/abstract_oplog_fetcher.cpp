@@ -179,6 +179,10 @@ NamespaceString AbstractOplogFetcher::_getNamespace() const {
     return _nss;
 }
 
+Status AbstractOplogFetcher::_waitForPendingBatchWork() {
+    return Status::OK();
+}
+
 void AbstractOplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
                                      BSONObjBuilder* getMoreBob) {
     Status responseStatus =
@@ -293,6 +297,11 @@ void AbstractOplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
 void AbstractOplogFetcher::_finishCallback(Status status) {
     invariant(isActive());
 
+    auto pendingBatchWorkStatus = _waitForPendingBatchWork();
+    if (status.isOK()) {
+        status = pendingBatchWorkStatus;
+    }
+
     _onShutdownCallbackFn(status);
 
     decltype(_onShutdownCallbackFn) onShutdownCallbackFn;
@@ -135,6 +135,12 @@ protected:
      */
     OpTime _getLastOpTimeFetched() const;
 
+    /**
+     * Waits for the work that the subclass left running on the batches it has processed, and
+     * returns the first error of that work. Called before the oplog fetcher completes.
+     */
+    virtual Status _waitForPendingBatchWork();
+
     // =============== AbstractAsyncComponent overrides ================
 
     /**
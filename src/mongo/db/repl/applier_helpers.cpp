@@ -36,8 +36,11 @@
 #include <algorithm>
 #include <iterator>
 
+#include "mongo/bson/bsonelement_comparator_interface.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/db/ops/write_ops.h"
+#include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/sync_tail.h"
 #include "mongo/util/assert_util.h"
@@ -67,6 +70,69 @@ void ApplierHelpers::stableSortByNamespace(MultiApplier::OperationPtrs* oplogEnt
     std::stable_sort(oplogEntryPointers->begin(), oplogEntryPointers->end(), nssComparator);
 }
 
+namespace {
+
+/**
+ * Returns whether the operation may be moved ahead of the updates and deletes which precede it.
+ */
+bool isGroupableInsert(const OplogEntry& entry) {
+    return entry.getOpType() == OpTypeEnum::kInsert && !entry.isForCappedCollection;
+}
+
+}  // namespace
+
+// static
+void ApplierHelpers::stableGroupInserts(OperationPtrs* oplogEntryPointers) {
+    OperationPtrs grouped;
+    grouped.reserve(oplogEntryPointers->size());
+
+    // The inserts of the group being built, and the updates and deletes they were moved ahead of.
+    OperationPtrs inserts;
+    OperationPtrs others;
+    auto othersIds = SimpleBSONElementComparator::kInstance.makeBSONEltSet();
+    bool othersHaveCollatableIds = false;
+
+    auto flush = [&] {
+        grouped.insert(grouped.end(), inserts.begin(), inserts.end());
+        grouped.insert(grouped.end(), others.begin(), others.end());
+        inserts.clear();
+        others.clear();
+        othersIds.clear();
+        othersHaveCollatableIds = false;
+    };
+
+    for (auto entry : *oplogEntryPointers) {
+        if (!inserts.empty() && entry->getNss() != inserts.front()->getNss()) {
+            flush();
+        }
+
+        if (isGroupableInsert(*entry)) {
+            // The collation of the collection is not known here, so an _id which collation may
+            // make equal to the _id of an operation the insert would skip keeps it in its place.
+            auto id = entry->getIdElement();
+            const bool conflicts = othersIds.count(id) ||
+                (othersHaveCollatableIds && CollationIndexKey::isCollatableType(id.type()));
+            if (conflicts) {
+                flush();
+            }
+            inserts.push_back(entry);
+        } else if (!inserts.empty() && (entry->getOpType() == OpTypeEnum::kUpdate ||
+                                        entry->getOpType() == OpTypeEnum::kDelete)) {
+            auto id = entry->getIdElement();
+            othersIds.insert(id);
+            othersHaveCollatableIds =
+                othersHaveCollatableIds || CollationIndexKey::isCollatableType(id.type());
+            others.push_back(entry);
+        } else {
+            flush();
+            grouped.push_back(entry);
+        }
+    }
+    flush();
+
+    oplogEntryPointers->swap(grouped);
+}
+
 using InsertGroup = ApplierHelpers::InsertGroup;
 
 InsertGroup::InsertGroup(ApplierHelpers::OperationPtrs* ops,
@@ -50,6 +50,14 @@ public:
      */
     static void stableSortByNamespace(OperationPtrs* oplogEntryPointers);
 
+    /**
+     * Moves each insert ahead of the updates and deletes which separate it from the previous
+     * insert into the same namespace, unless one of them is on the same document, so that the
+     * inserts can be grouped. The order of the inserts, and of the other operations, does not
+     * change. Expects the entries to be sorted by namespace.
+     */
+    static void stableGroupInserts(OperationPtrs* oplogEntryPointers);
+
     class InsertGroup;
 };
 
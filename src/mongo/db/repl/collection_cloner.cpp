@@ -66,6 +66,8 @@ constexpr auto kCountResponseDocumentCountFieldName = "n"_sd;
 const int kProgressMeterSecondsBetween = 60;
 const int kProgressMeterCheckInterval = 128;
 
+const BSONObj kIdIndexKeyPattern = BSON("_id" << 1);
+
 }  // namespace
 
 // Failpoint which causes initial sync to hang before establishing its cursor to clone the
@@ -258,6 +260,9 @@ void CollectionCloner::_cancelRemainingWork_inlock() {
     if (_queryState == QueryState::kRunning) {
         _queryState = QueryState::kCanceling;
         _clientConnection->shutdownAndDisallowReconnect();
+        for (auto&& rangeClientConnection : _rangeClientConnections) {
+            rangeClientConnection->shutdownAndDisallowReconnect();
+        }
     } else {
         _queryState = QueryState::kFinished;
     }
@@ -486,6 +491,7 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
                     stdx::lock_guard<stdx::mutex> lock(_mutex);
                     _queryState = QueryState::kFinished;
                     _clientConnection.reset();
+                    _rangeClientConnections.clear();
                 }
                 _condition.notify_all();
                 _finishCallback(status);
@@ -547,54 +553,203 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
         return;
     }
 
+    auto splitPoints = _getRangeSplitPoints();
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _activeRangeQueries = splitPoints.size() + 1;
+        if (!splitPoints.empty()) {
+            _stats.rangeQueries = _activeRangeQueries;
+            log() << "CollectionCloner ns: '" << _sourceNss.ns() << "' cloning with "
+                  << _activeRangeQueries << " range queries";
+        }
+    }
+
+    // The first range is queried on this thread, and each of the others on an executor thread of
+    // its own.
+    for (size_t i = 0; i < splitPoints.size(); ++i) {
+        BSONObj min = splitPoints[i];
+        BSONObj max = i + 1 < splitPoints.size() ? splitPoints[i + 1] : BSONObj();
+        auto scheduleResult = _executor->scheduleWork(
+            [this, min, max, onCompletionGuard](
+                const executor::TaskExecutor::CallbackArgs& callbackData) {
+                _runAdditionalRangeQuery(callbackData, min, max, onCompletionGuard);
+            });
+        if (!scheduleResult.isOK()) {
+            _finishRangeQuery(scheduleResult.getStatus(), onCompletionGuard);
+        }
+    }
+
+    auto queryStatus = _queryRange(_clientConnection.get(),
+                                   BSONObj(),
+                                   splitPoints.empty() ? BSONObj() : splitPoints.front(),
+                                   onCompletionGuard);
+    _finishRangeQuery(queryStatus, onCompletionGuard);
+}
+
+std::vector<BSONObj> CollectionCloner::_getRangeSplitPoints() {
+    const int numRanges = collectionClonerParallelRangeQueries.load();
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        // Capped collections must be inserted in their natural order, and the keys of an '_id'
+        // index with a collation are not '_id' values which a query can use as bounds.
+        if (numRanges <= 1 ||
+            _stats.documentToCopy <
+                static_cast<size_t>(collectionClonerParallelRangeMinDocuments.load()) ||
+            _idIndexSpec.isEmpty() || _options.capped || !_options.collation.isEmpty()) {
+            return {};
+        }
+    }
+
+    // Any '_id' values split the collection into ranges that together cover it, so split points
+    // which are out of date by the time the ranges are queried are only a matter of balance.
+    const auto dbName = _sourceNss.db().toString();
+    BSONObj collStatsResult;
+    if (!_clientConnection->runCommand(
+            dbName, BSON("collStats" << _sourceNss.coll()), collStatsResult)) {
+        log() << "CollectionCloner ns: '" << _sourceNss.ns()
+              << "' cloning with a single query, unable to get collection size: "
+              << redact(getStatusFromCommandResult(collStatsResult));
+        return {};
+    }
+
+    // splitVector picks a split point every 'maxChunkSizeBytes / (2 * averageDocumentSize)'
+    // documents.
+    const long long dataSize = collStatsResult["size"].safeNumberLong();
+    BSONObj splitVectorResult;
+    if (!_clientConnection->runCommand(
+            dbName,
+            BSON("splitVector" << _sourceNss.ns() << "keyPattern" << kIdIndexKeyPattern
+                               << "maxChunkSizeBytes"
+                               << std::max(1LL, 2 * dataSize / numRanges)
+                               << "maxSplitPoints"
+                               << numRanges - 1),
+            splitVectorResult)) {
+        log() << "CollectionCloner ns: '" << _sourceNss.ns()
+              << "' cloning with a single query, unable to split collection: "
+              << redact(getStatusFromCommandResult(splitVectorResult));
+        return {};
+    }
+
+    std::vector<BSONObj> splitPoints;
+    for (auto&& splitKey : splitVectorResult.getObjectField("splitKeys")) {
+        splitPoints.push_back(splitKey.Obj().getOwned());
+    }
+    return splitPoints;
+}
+
+void CollectionCloner::_runAdditionalRangeQuery(
+    const executor::TaskExecutor::CallbackArgs& callbackData,
+    const BSONObj& min,
+    const BSONObj& max,
+    std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    if (!callbackData.status.isOK()) {
+        _finishRangeQuery(callbackData.status, onCompletionGuard);
+        return;
+    }
+    DBClientConnection* conn = nullptr;
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (_queryState == QueryState::kRunning) {
+            _rangeClientConnections.push_back(_createClientFn());
+            conn = _rangeClientConnections.back().get();
+        }
+    }
+    if (!conn) {
+        _finishRangeQuery({ErrorCodes::CallbackCanceled, "Collection cloning cancelled."},
+                          onCompletionGuard);
+        return;
+    }
+
+    Status connectStatus = conn->connect(_source, StringData());
+    if (connectStatus.isOK() && !replAuthenticate(conn)) {
+        connectStatus = {ErrorCodes::AuthenticationFailed,
+                         str::stream() << "Failed to authenticate to " << _source};
+    }
+    if (!connectStatus.isOK()) {
+        _finishRangeQuery(connectStatus, onCompletionGuard);
+        return;
+    }
+    _finishRangeQuery(_queryRange(conn, min, max, onCompletionGuard), onCompletionGuard);
+}
+
+Status CollectionCloner::_queryRange(DBClientConnection* conn,
+                                     const BSONObj& min,
+                                     const BSONObj& max,
+                                     std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
     // readOnce is available on 4.2 sync sources only.  Initially we don't know FCV, so
     // we won't use the readOnce feature, but once the admin database is cloned we will use it.
     // The admin database is always cloned first, so all user data should use readOnce.
     const bool readOnceAvailable = serverGlobalParams.featureCompatibility.getVersionUnsafe() ==
         ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo42;
+    Query query = readOnceAvailable ? QUERY("query" << BSONObj() << "$readOnce" << true) : Query();
+    if (!min.isEmpty() || !max.isEmpty()) {
+        query.hint(kIdIndexKeyPattern);
+        if (!min.isEmpty()) {
+            query.minKey(min);
+        }
+        if (!max.isEmpty()) {
+            query.maxKey(max);
+        }
+    }
     try {
-        _clientConnection->query(
+        conn->query(
             [this, onCompletionGuard](DBClientCursorBatchIterator& iter) {
                 _handleNextBatch(onCompletionGuard, iter);
             },
             NamespaceStringOrUUID(_sourceNss.db().toString(), *_options.uuid),
-            readOnceAvailable ? QUERY("query" << BSONObj() << "$readOnce" << true) : Query(),
+            query,
             nullptr /* fieldsToReturn */,
             QueryOption_NoCursorTimeout | QueryOption_SlaveOk |
                 (collectionClonerUsesExhaust ? QueryOption_Exhaust : 0),
             _collectionClonerBatchSize);
     } catch (const DBException& e) {
-        auto queryStatus = e.toStatus().withContext(str::stream() << "Error querying collection '"
-                                                                  << _sourceNss.ns());
-        stdx::unique_lock<stdx::mutex> lock(_mutex);
-        if (queryStatus.code() == ErrorCodes::OperationFailed ||
-            queryStatus.code() == ErrorCodes::CursorNotFound ||
-            queryStatus.code() == ErrorCodes::QueryPlanKilled) {
-            // With these errors, it's possible the collection was dropped while we were
-            // cloning.  If so, we'll execute the drop during oplog application, so it's OK to
-            // just stop cloning.
-            //
-            // A 4.2 node should only ever raise QueryPlanKilled, but an older node could raise
-            // OperationFailed or CursorNotFound.
-            _verifyCollectionWasDropped(lock, queryStatus, onCompletionGuard);
-            return;
-        } else if (queryStatus.code() != ErrorCodes::NamespaceNotFound) {
-            // NamespaceNotFound means the collection was dropped before we started cloning, so
-            // we're OK to ignore the error.  Any other error we must report.
-            onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, queryStatus);
-            return;
-        }
+        return e.toStatus().withContext(str::stream() << "Error querying collection '"
+                                                      << _sourceNss.ns());
     }
+    return Status::OK();
+}
+
+void CollectionCloner::_finishRangeQuery(const Status& queryStatus,
+                                         std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    stdx::unique_lock<stdx::mutex> lock(_mutex);
+    invariant(_activeRangeQueries > 0);
+    --_activeRangeQueries;
+    if (queryStatus.code() == ErrorCodes::OperationFailed ||
+        queryStatus.code() == ErrorCodes::CursorNotFound ||
+        queryStatus.code() == ErrorCodes::QueryPlanKilled) {
+        // With these errors, it's possible the collection was dropped while we were
+        // cloning.  If so, we'll execute the drop during oplog application, so it's OK to
+        // just stop cloning.
+        //
+        // A 4.2 node should only ever raise QueryPlanKilled, but an older node could raise
+        // OperationFailed or CursorNotFound.
+        _rangeQueryFailed = true;
+        _verifyCollectionWasDropped(lock, queryStatus, onCompletionGuard);
+        return;
+    } else if (!queryStatus.isOK() && queryStatus.code() != ErrorCodes::NamespaceNotFound) {
+        // NamespaceNotFound means the collection was dropped before we started cloning, so
+        // we're OK to ignore the error.  Any other error we must report.
+        _rangeQueryFailed = true;
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, queryStatus);
+        return;
+    }
+
+    // Success is only reported by the last range query to return, and only if none of the others
+    // failed, since a failed query has already reported its result or is verifying a drop.
+    if (_activeRangeQueries > 0 || _rangeQueryFailed) {
+        return;
+    }
+    lock.unlock();
     waitForDbWorker();
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    lock.lock();
     onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, Status::OK());
 }
 
 void CollectionCloner::_handleNextBatch(std::shared_ptr<OnCompletionGuard> onCompletionGuard,
                                         DBClientCursorBatchIterator& iter) {
-    _stats.receivedBatches++;
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _stats.receivedBatches++;
         uassert(ErrorCodes::CallbackCanceled,
                 "Collection cloning cancelled.",
                 _queryState != QueryState::kCanceling);
@@ -808,6 +963,9 @@ void CollectionCloner::Stats::append(BSONObjBuilder* builder) const {
         }
     }
     builder->appendNumber("receivedBatches", receivedBatches);
+    if (rangeQueries > 0) {
+        builder->appendNumber("rangeQueries", rangeQueries);
+    }
 }
 }  // namespace repl
 }  // namespace mongo
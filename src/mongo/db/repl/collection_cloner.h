@@ -82,6 +82,7 @@ public:
         size_t indexes{0};
         size_t fetchedBatches{0};  // This is actually inserted batches.
         size_t receivedBatches{0};
+        size_t rangeQueries{0};  // Number of '_id' range queries, if more than one.
 
         std::string toString() const;
         BSONObj toBSON() const;
@@ -214,11 +215,46 @@ private:
     /**
      * Using a DBClientConnection, executes a query to retrieve all documents in the collection.
      * For each batch returned by the upstream node, _handleNextBatch will be called with the data.
-     * This method will return when the entire query is finished or failed.
+     * Large collections are split into ranges of '_id' values which are queried in parallel,
+     * each over its own connection. This method will return when the query of the first range
+     * is finished or failed.
      */
     void _runQuery(const executor::TaskExecutor::CallbackArgs& callbackData,
                    std::shared_ptr<OnCompletionGuard> onCompletionGuard);
 
+    /**
+     * Asks the sync source for '_id' values which split the collection into about
+     * 'collectionClonerParallelRangeQueries' ranges of the same size, using the 'splitVector'
+     * command over '_clientConnection'. Returns no split points when the collection is to be
+     * cloned with a single query, including when the sync source cannot provide them.
+     */
+    std::vector<BSONObj> _getRangeSplitPoints();
+
+    /**
+     * Runs the query for one of the '_id' ranges after the first, on a connection of its own.
+     */
+    void _runAdditionalRangeQuery(const executor::TaskExecutor::CallbackArgs& callbackData,
+                                  const BSONObj& min,
+                                  const BSONObj& max,
+                                  std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
+    /**
+     * Queries the documents whose '_id' lies in ['min', 'max') over 'conn', passing each batch
+     * to _handleNextBatch. An empty 'min' or 'max' leaves that end of the range open, so that
+     * the ranges of all of the queries together cover every document in the collection.
+     */
+    Status _queryRange(DBClientConnection* conn,
+                       const BSONObj& min,
+                       const BSONObj& max,
+                       std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
+    /**
+     * Called when one of the range queries has returned. Reports the first error, and reports
+     * success once the last of the queries has returned and its documents are inserted.
+     */
+    void _finishRangeQuery(const Status& queryStatus,
+                           std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
     /**
      * Put all results from a query batch into a buffer to be inserted, and schedule
      * it to be inserted.
@@ -302,6 +338,15 @@ private:
     // allow cancellation, and those other threads may access it only when holding '_mutex'.
     std::unique_ptr<DBClientConnection> _clientConnection;
 
+    // (M) Client connections used by the range queries after the first, which runs over
+    // '_clientConnection'. Each is set and used under the same rules as '_clientConnection', by
+    // the thread of its own range query.
+    std::vector<std::unique_ptr<DBClientConnection>> _rangeClientConnections;
+
+    // (M) Number of range queries which have not returned yet, and whether any of them failed.
+    size_t _activeRangeQueries = 0;
+    bool _rangeQueryFailed = false;
+
     // State transitions:
     // PreStart --> Running --> ShuttingDown --> Complete
     // It is possible to skip intermediate states. For example,
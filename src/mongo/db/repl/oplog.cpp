@@ -366,6 +366,11 @@ void appendSessionInfo(OperationContext* opCtx,
         oplogLink.postImageOpTime.append(builder,
                                          OplogEntryBase::kPostImageOpTimeFieldName.toString());
     }
+
+    if (oplogLink.needsRetryImage) {
+        builder->append(OplogEntryBase::kNeedsRetryImageFieldName,
+                        RetryImage_serializer(*oplogLink.needsRetryImage));
+    }
 }
 
 OplogDocWriter _logOpWriter(OperationContext* opCtx,
@@ -1287,6 +1292,46 @@ StatusWith<OplogApplication::Mode> OplogApplication::parseMode(const std::string
     MONGO_UNREACHABLE;
 }
 
+namespace {
+
+/**
+ * Returns which image of its document applying 'op' stores in config.image_collection, if any.
+ * Images are only stored when the oplog is applied in order from a consistent state, which initial
+ * sync does not do.
+ */
+boost::optional<RetryImageEnum> getRetryImageToStore(const BSONObj& op,
+                                                     OplogApplication::Mode mode) {
+    auto needsRetryImage = op[OplogEntryBase::kNeedsRetryImageFieldName];
+    if (!needsRetryImage ||
+        (mode != OplogApplication::Mode::kSecondary &&
+         mode != OplogApplication::Mode::kRecovering)) {
+        return boost::none;
+    }
+    return RetryImage_parse(IDLParserErrorContext("needsRetryImage"),
+                            needsRetryImage.valueStringData());
+}
+
+void storeRetryImage(OperationContext* opCtx,
+                     const BSONObj& op,
+                     RetryImageEnum imageKind,
+                     const BSONObj& image) {
+    // The document is missing if this is a replay of an operation that was already applied.
+    if (image.isEmpty()) {
+        return;
+    }
+    auto sessionId = LogicalSessionId::parse(
+        IDLParserErrorContext("storeRetryImage"),
+        op[OperationSessionInfo::kSessionIdFieldName].embeddedObjectUserCheck());
+    writeToImageCollection(opCtx,
+                           sessionId,
+                           op[OperationSessionInfo::kTxnNumberFieldName].numberLong(),
+                           op[OplogEntryBase::kTimestampFieldName].timestamp(),
+                           imageKind,
+                           image);
+}
+
+}  // namespace
+
 // @return failure status if an update should have happened and the document DNE.
 // See replset initial sync code.
 Status applyOperation_inlock(OperationContext* opCtx,
@@ -1661,6 +1706,8 @@ Status applyOperation_inlock(OperationContext* opCtx,
             timestamp = fieldTs.timestamp();
         }
 
+        const auto retryImage = getRetryImageToStore(op, mode);
+
         const StringData ns = fieldNs.valueStringDataSafe();
         auto status = writeConflictRetry(opCtx, "applyOps_update", ns, [&] {
             WriteUnitOfWork wuow(opCtx);
@@ -1668,6 +1715,11 @@ Status applyOperation_inlock(OperationContext* opCtx,
                 uassertStatusOK(opCtx->recoveryUnit()->setTimestamp(timestamp));
             }
 
+            BSONObj preImage;
+            if (retryImage == RetryImageEnum::kPreImage) {
+                Helpers::findById(opCtx, db, requestNss.ns(), updateCriteria, preImage);
+            }
+
             UpdateResult ur = update(opCtx, db, request);
             if (ur.numMatched == 0 && ur.upserted.isEmpty()) {
                 if (ur.modifiers) {
@@ -1708,6 +1760,14 @@ Status applyOperation_inlock(OperationContext* opCtx,
                 }
             }
 
+            if (retryImage == RetryImageEnum::kPreImage) {
+                storeRetryImage(opCtx, op, *retryImage, preImage);
+            } else if (retryImage == RetryImageEnum::kPostImage) {
+                BSONObj postImage;
+                Helpers::findById(opCtx, db, requestNss.ns(), updateCriteria, postImage);
+                storeRetryImage(opCtx, op, *retryImage, postImage);
+            }
+
             wuow.commit();
             return Status::OK();
         });
@@ -1740,6 +1800,8 @@ Status applyOperation_inlock(OperationContext* opCtx,
             timestamp = fieldTs.timestamp();
         }
 
+        const auto retryImage = getRetryImageToStore(op, mode);
+
         const StringData ns = fieldNs.valueStringDataSafe();
         writeConflictRetry(opCtx, "applyOps_delete", ns, [&] {
             WriteUnitOfWork wuow(opCtx);
@@ -1748,6 +1810,11 @@ Status applyOperation_inlock(OperationContext* opCtx,
             }
 
             if (opType[1] == 0) {
+                if (retryImage) {
+                    BSONObj preImage;
+                    Helpers::findById(opCtx, db, requestNss.ns(), deleteCriteria, preImage);
+                    storeRetryImage(opCtx, op, *retryImage, preImage);
+                }
                 const auto justOne = true;
                 deleteObjects(opCtx, collection, requestNss, deleteCriteria, justOne);
             } else
@@ -2008,6 +2075,46 @@ void establishOplogCollectionForLogging(OperationContext* opCtx, Collection* opl
     LocalOplogInfo::get(opCtx)->setCollection(oplog);
 }
 
+void writeToImageCollection(OperationContext* opCtx,
+                            const LogicalSessionId& sessionId,
+                            TxnNumber txnNumber,
+                            Timestamp timestamp,
+                            RetryImageEnum imageKind,
+                            const BSONObj& image) {
+    ImageEntry imageEntry;
+    imageEntry.setSessionId(sessionId);
+    imageEntry.setTxnNumber(txnNumber);
+    imageEntry.setTimestamp(timestamp);
+    imageEntry.setImageKind(imageKind);
+    imageEntry.setImage(image);
+
+    // Every node derives the images from the oplog entries it writes or applies.
+    UnreplicatedWritesBlock uwb(opCtx);
+    AutoGetCollection autoColl(opCtx, NamespaceString::kConfigImagesNamespace, MODE_IX);
+    uassert(51331,
+            str::stream() << "Unable to store the image of a retryable findAndModify because the "
+                          << NamespaceString::kConfigImagesNamespace.ns()
+                          << " collection is missing",
+            autoColl.getCollection());
+
+    const auto idQuery = BSON(ImageEntry::kSessionIdFieldName << sessionId.toBSON());
+    BSONObj existing;
+    if (Helpers::findById(opCtx,
+                          autoColl.getDb(),
+                          NamespaceString::kConfigImagesNamespace.ns(),
+                          idQuery,
+                          existing) &&
+        existing[ImageEntry::kTxnNumberFieldName].numberLong() > txnNumber) {
+        return;
+    }
+
+    UpdateRequest request(NamespaceString::kConfigImagesNamespace);
+    request.setQuery(idQuery);
+    request.setUpdateModification(imageEntry.toBSON());
+    request.setUpsert();
+    update(opCtx, autoColl.getDb(), request);
+}
+
 void signalOplogWaiters() {
     auto oplog = LocalOplogInfo::get(getGlobalServiceContext())->getCollection();
     if (oplog) {
@@ -77,6 +77,9 @@ struct OplogLink {
     OpTime prevOpTime;
     OpTime preImageOpTime;
     OpTime postImageOpTime;
+
+    // Set instead of a pre or post image optime when the image is in config.image_collection.
+    boost::optional<RetryImageEnum> needsRetryImage;
 };
 
 /**
@@ -160,6 +163,19 @@ void acquireOplogCollectionForLogging(OperationContext* opCtx);
  */
 void establishOplogCollectionForLogging(OperationContext* opCtx, Collection* oplog);
 
+/**
+ * Stores 'image' as the image of the retryable findAndModify with 'txnNumber' on 'sessionId', whose
+ * write has the oplog timestamp 'timestamp'. Keeps the stored image if it belongs to a later
+ * txnNumber, since oplog application may apply the writes of a session out of order. The write is
+ * not replicated.
+ */
+void writeToImageCollection(OperationContext* opCtx,
+                            const LogicalSessionId& sessionId,
+                            TxnNumber txnNumber,
+                            Timestamp timestamp,
+                            RetryImageEnum imageKind,
+                            const BSONObj& image);
+
 using IncrementOpsAppliedStatsFn = std::function<void()>;
 
 /**
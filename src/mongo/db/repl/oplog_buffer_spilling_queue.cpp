@@ -0,0 +1,280 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_buffer_spilling_queue.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <cstring>
+
+#include "mongo/base/data_view.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+// Limit on the operations read back from the spill file at once, which the pusher waits on.
+const std::size_t kMaxRefillSize = 16 * 1024 * 1024;
+
+std::size_t getDocumentSize(const BSONObj& o) {
+    return static_cast<std::size_t>(o.objsize());
+}
+
+}  // namespace
+
+OplogBufferSpillingQueue::OplogBufferSpillingQueue(Counters* counters,
+                                                   std::size_t maxMemorySize,
+                                                   std::size_t maxSpillSize,
+                                                   std::string spillFilePath)
+    : _counters(counters),
+      _maxMemorySize(maxMemorySize),
+      _maxSpillSize(maxSpillSize),
+      _spillFilePath(std::move(spillFilePath)) {}
+
+void OplogBufferSpillingQueue::startup(OperationContext*) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    boost::filesystem::create_directories(boost::filesystem::path(_spillFilePath).parent_path());
+    _spillFile.open(_spillFilePath,
+                    std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    uassert(51322,
+            str::stream() << "error opening oplog buffer spill file \"" << _spillFilePath
+                          << "\": "
+                          << errnoWithDescription(),
+            _spillFile.is_open());
+
+    // Update server status metric to reflect the current oplog buffer's max size.
+    if (_counters) {
+        _counters->setMaxSize(getMaxSize());
+    }
+}
+
+void OplogBufferSpillingQueue::shutdown(OperationContext* opCtx) {
+    clear(opCtx);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_spillFile.is_open()) {
+        _spillFile.close();
+        boost::system::error_code ec;
+        boost::filesystem::remove(_spillFilePath, ec);
+    }
+}
+
+void OplogBufferSpillingQueue::pushEvenIfFull(OperationContext*, const Value& value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _push_inlock(value);
+}
+
+void OplogBufferSpillingQueue::push(OperationContext*, const Value& value) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _notFullCondition.wait(lk, [&] { return _hasSpace_inlock(getDocumentSize(value)); });
+    _push_inlock(value);
+}
+
+void OplogBufferSpillingQueue::pushAllNonBlocking(OperationContext*,
+                                                  Batch::const_iterator begin,
+                                                  Batch::const_iterator end) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto i = begin; i != end; ++i) {
+        _push_inlock(*i);
+    }
+}
+
+void OplogBufferSpillingQueue::waitForSpace(OperationContext*, std::size_t size) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _notFullCondition.wait(lk, [&] { return _hasSpace_inlock(size); });
+}
+
+bool OplogBufferSpillingQueue::isEmpty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _memoryQueue.empty() && _spilledCount == 0;
+}
+
+std::size_t OplogBufferSpillingQueue::getMaxSize() const {
+    return _maxMemorySize + _maxSpillSize;
+}
+
+std::size_t OplogBufferSpillingQueue::getSize() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _memorySize + static_cast<std::size_t>(_spillWriteOffset - _spillReadOffset);
+}
+
+std::size_t OplogBufferSpillingQueue::getCount() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _memoryQueue.size() + _spilledCount;
+}
+
+void OplogBufferSpillingQueue::clear(OperationContext*) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _memoryQueue.clear();
+    _memorySize = 0;
+    if (_spillFile.is_open()) {
+        _resetSpillFile_inlock();
+    }
+    _lastPushed = boost::none;
+    if (_counters) {
+        _counters->clear();
+    }
+    _notFullCondition.notify_all();
+}
+
+bool OplogBufferSpillingQueue::tryPop(OperationContext*, Value* value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _refill_inlock();
+    if (_memoryQueue.empty()) {
+        return false;
+    }
+    *value = std::move(_memoryQueue.front());
+    _memoryQueue.pop_front();
+    _memorySize -= getDocumentSize(*value);
+    if (_memoryQueue.empty() && _spilledCount == 0) {
+        _lastPushed = boost::none;
+    }
+    if (_counters) {
+        _counters->decrement(*value);
+    }
+    _notFullCondition.notify_all();
+    return true;
+}
+
+bool OplogBufferSpillingQueue::waitForData(Seconds waitDuration) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    return _notEmptyCondition.wait_for(lk, waitDuration.toSystemDuration(), [&] {
+        return !_memoryQueue.empty() || _spilledCount > 0;
+    });
+}
+
+bool OplogBufferSpillingQueue::peek(OperationContext*, Value* value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _refill_inlock();
+    if (_memoryQueue.empty()) {
+        return false;
+    }
+    *value = _memoryQueue.front();
+    return true;
+}
+
+boost::optional<OplogBuffer::Value> OplogBufferSpillingQueue::lastObjectPushed(
+    OperationContext*) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _lastPushed;
+}
+
+std::size_t OplogBufferSpillingQueue::getSpilledSize_forTest() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return static_cast<std::size_t>(_spillWriteOffset - _spillReadOffset);
+}
+
+void OplogBufferSpillingQueue::_push_inlock(const Value& value) {
+    const auto size = getDocumentSize(value);
+    if (_spilledCount == 0 && _memorySize + size <= _maxMemorySize) {
+        _memoryQueue.push_back(value.getOwned());
+        _memorySize += size;
+    } else {
+        // BSON objects carry their own size, so the file needs no framing of its own.
+        _spillFile.seekp(_spillWriteOffset);
+        _spillFile.write(value.objdata(), size);
+        uassert(51323,
+                str::stream() << "error writing to oplog buffer spill file \"" << _spillFilePath
+                              << "\": "
+                              << errnoWithDescription(),
+                _spillFile.good());
+        _spillWriteOffset += size;
+        ++_spilledCount;
+    }
+    _lastPushed = value.getOwned();
+    if (_counters) {
+        _counters->increment(value);
+    }
+    _notEmptyCondition.notify_all();
+}
+
+void OplogBufferSpillingQueue::_refill_inlock() {
+    if (!_memoryQueue.empty() || _spilledCount == 0) {
+        return;
+    }
+
+    // Flush what was written, before reading it back through the same stream.
+    _spillFile.flush();
+    _spillFile.seekg(_spillReadOffset);
+    const auto refillSize = std::min(_maxMemorySize, kMaxRefillSize);
+    while (_spilledCount > 0 && (_memoryQueue.empty() || _memorySize < refillSize)) {
+        char sizeBytes[sizeof(int32_t)];
+        _spillFile.read(sizeBytes, sizeof(sizeBytes));
+        const auto size = ConstDataView(sizeBytes).read<LittleEndian<int32_t>>();
+        uassert(51324,
+                str::stream() << "error reading oplog buffer spill file \"" << _spillFilePath
+                              << "\": "
+                              << errnoWithDescription(),
+                _spillFile.good() && size >= BSONObj::kMinBSONLength);
+        auto buffer = SharedBuffer::allocate(size);
+        std::memcpy(buffer.get(), sizeBytes, sizeof(sizeBytes));
+        _spillFile.read(buffer.get() + sizeof(sizeBytes), size - sizeof(sizeBytes));
+        uassert(51326,
+                str::stream() << "error reading oplog buffer spill file \"" << _spillFilePath
+                              << "\": "
+                              << errnoWithDescription(),
+                _spillFile.good());
+
+        _memoryQueue.emplace_back(std::move(buffer));
+        _memorySize += size;
+        _spillReadOffset += size;
+        --_spilledCount;
+    }
+
+    if (_spilledCount == 0) {
+        _resetSpillFile_inlock();
+    }
+}
+
+void OplogBufferSpillingQueue::_resetSpillFile_inlock() {
+    _spillFile.close();
+    _spillFile.open(_spillFilePath,
+                    std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    uassert(51325,
+            str::stream() << "error reopening oplog buffer spill file \"" << _spillFilePath
+                          << "\": "
+                          << errnoWithDescription(),
+            _spillFile.is_open());
+    _spillReadOffset = 0;
+    _spillWriteOffset = 0;
+    _spilledCount = 0;
+}
+
+bool OplogBufferSpillingQueue::_hasSpace_inlock(std::size_t size) const {
+    const auto totalSize =
+        _memorySize + static_cast<std::size_t>(_spillWriteOffset - _spillReadOffset);
+    return totalSize == 0 || totalSize + size <= getMaxSize();
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <fstream>
+#include <string>
+
+#include "mongo/db/repl/oplog_buffer.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Oplog buffer which holds operations in memory up to a limit, and beyond it appends them to a
+ * file, so that the oplog fetcher can run far ahead of the applier without holding all of the
+ * fetched operations in memory.
+ *
+ * Operations are kept in the order that they were pushed: once an operation has been written to
+ * the file, all of the operations pushed after it are written to the file too, until the file has
+ * been read back. Operations are read back from the file in chunks, when the memory queue runs
+ * out, and the file is emptied to be written from its start again once all of it has been read.
+ */
+class OplogBufferSpillingQueue final : public OplogBuffer {
+public:
+    /**
+     * Holds up to 'maxMemorySize' bytes of operations in memory, and up to 'maxSpillSize' bytes
+     * more in the file at 'spillFilePath', which the oplog buffer creates on startup and removes on
+     * shutdown.
+     */
+    OplogBufferSpillingQueue(Counters* counters,
+                             std::size_t maxMemorySize,
+                             std::size_t maxSpillSize,
+                             std::string spillFilePath);
+
+    void startup(OperationContext* opCtx) override;
+    void shutdown(OperationContext* opCtx) override;
+    void pushEvenIfFull(OperationContext* opCtx, const Value& value) override;
+    void push(OperationContext* opCtx, const Value& value) override;
+    void pushAllNonBlocking(OperationContext* opCtx,
+                            Batch::const_iterator begin,
+                            Batch::const_iterator end) override;
+    void waitForSpace(OperationContext* opCtx, std::size_t size) override;
+    bool isEmpty() const override;
+    std::size_t getMaxSize() const override;
+    std::size_t getSize() const override;
+    std::size_t getCount() const override;
+    void clear(OperationContext* opCtx) override;
+    bool tryPop(OperationContext* opCtx, Value* value) override;
+    bool waitForData(Seconds waitDuration) override;
+    bool peek(OperationContext* opCtx, Value* value) override;
+    boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
+
+    /**
+     * Returns the number of bytes of operations in the spill file.
+     */
+    std::size_t getSpilledSize_forTest() const;
+
+private:
+    /**
+     * Adds 'value' to the memory queue, or to the spill file once the memory queue is full.
+     */
+    void _push_inlock(const Value& value);
+
+    /**
+     * Moves operations from the spill file to the empty memory queue, if there are any. Empties the
+     * spill file once all of it has been read.
+     */
+    void _refill_inlock();
+
+    /**
+     * Truncates the spill file and starts writing it from its start again.
+     */
+    void _resetSpillFile_inlock();
+
+    bool _hasSpace_inlock(std::size_t size) const;
+
+    Counters* const _counters;
+    const std::size_t _maxMemorySize;
+    const std::size_t _maxSpillSize;
+    const std::string _spillFilePath;
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _notEmptyCondition;
+    stdx::condition_variable _notFullCondition;
+
+    // Operations to be popped before any of the spilled operations.
+    std::deque<Value> _memoryQueue;
+    std::size_t _memorySize = 0;
+
+    // Operations written to the spill file, between '_spillReadOffset' and '_spillWriteOffset'.
+    std::fstream _spillFile;
+    std::streamoff _spillReadOffset = 0;
+    std::streamoff _spillWriteOffset = 0;
+    std::size_t _spilledCount = 0;
+
+    boost::optional<Value> _lastPushed;
+};
+
+}  // namespace repl
+}  // namespace mongo
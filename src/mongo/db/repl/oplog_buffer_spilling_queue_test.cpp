@@ -0,0 +1,159 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer_spilling_queue.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+BSONObj makeOplogEntry(int t) {
+    return BSON("ts" << Timestamp(t, t) << "h" << t << "op"
+                     << "i"
+                     << "ns"
+                     << "test.t"
+                     << "o"
+                     << BSON("_id" << t));
+}
+
+class OplogBufferSpillingQueueTest : public unittest::Test {
+protected:
+    /**
+     * Makes an oplog buffer which holds 'memoryEntries' of the entries of makeOplogEntry() in
+     * memory and 'spillEntries' more in its spill file.
+     */
+    std::unique_ptr<OplogBufferSpillingQueue> makeBuffer(std::size_t memoryEntries,
+                                                         std::size_t spillEntries) {
+        const std::size_t entrySize = makeOplogEntry(0).objsize();
+        auto buffer = std::make_unique<OplogBufferSpillingQueue>(&_counters,
+                                                                 memoryEntries * entrySize,
+                                                                 spillEntries * entrySize,
+                                                                 _tempDir.path() + "/spill");
+        buffer->startup(nullptr);
+        return buffer;
+    }
+
+    OplogBuffer::Counters _counters;
+
+private:
+    unittest::TempDir _tempDir{"oplog_buffer_spilling_queue_test"};
+};
+
+TEST_F(OplogBufferSpillingQueueTest, PopsOperationsInPushOrderThroughSpillFile) {
+    auto buffer = makeBuffer(3, 100);
+    for (int i = 0; i < 10; ++i) {
+        buffer->push(nullptr, makeOplogEntry(i));
+    }
+    ASSERT_EQUALS(10U, buffer->getCount());
+    ASSERT_EQUALS(10U, _counters.count.get());
+    ASSERT_EQUALS(7U * makeOplogEntry(0).objsize(), buffer->getSpilledSize_forTest());
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(9), *buffer->lastObjectPushed(nullptr));
+
+    // Operations pushed while some are spilled go to the spill file, after them.
+    BSONObj value;
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(buffer->tryPop(nullptr, &value));
+        ASSERT_BSONOBJ_EQ(makeOplogEntry(i), value);
+    }
+    buffer->push(nullptr, makeOplogEntry(10));
+
+    for (int i = 5; i <= 10; ++i) {
+        ASSERT_TRUE(buffer->peek(nullptr, &value));
+        ASSERT_BSONOBJ_EQ(makeOplogEntry(i), value);
+        ASSERT_TRUE(buffer->tryPop(nullptr, &value));
+        ASSERT_BSONOBJ_EQ(makeOplogEntry(i), value);
+    }
+    ASSERT_TRUE(buffer->isEmpty());
+    ASSERT_FALSE(buffer->tryPop(nullptr, &value));
+    ASSERT_FALSE(buffer->lastObjectPushed(nullptr));
+    ASSERT_EQUALS(0U, buffer->getSize());
+    ASSERT_EQUALS(0U, _counters.size.get());
+
+    buffer->shutdown(nullptr);
+}
+
+TEST_F(OplogBufferSpillingQueueTest, ReusesSpillFileOnceItHasBeenRead) {
+    auto buffer = makeBuffer(2, 100);
+    BSONObj value;
+    int next = 0;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 5; ++i) {
+            buffer->pushEvenIfFull(nullptr, makeOplogEntry(round * 5 + i));
+        }
+        ASSERT_GREATER_THAN(buffer->getSpilledSize_forTest(), 0U);
+        while (buffer->tryPop(nullptr, &value)) {
+            ASSERT_BSONOBJ_EQ(makeOplogEntry(next++), value);
+        }
+        ASSERT_EQUALS(0U, buffer->getSpilledSize_forTest());
+    }
+    ASSERT_EQUALS(15, next);
+
+    buffer->shutdown(nullptr);
+}
+
+TEST_F(OplogBufferSpillingQueueTest, MaxSizeCoversMemoryAndSpillFile) {
+    auto buffer = makeBuffer(2, 3);
+    const std::size_t entrySize = makeOplogEntry(0).objsize();
+    ASSERT_EQUALS(5U * entrySize, buffer->getMaxSize());
+    ASSERT_EQUALS(5U * entrySize, _counters.maxSize.get());
+
+    OplogBuffer::Batch batch;
+    for (int i = 0; i < 5; ++i) {
+        batch.push_back(makeOplogEntry(i));
+    }
+    buffer->pushAllNonBlocking(nullptr, batch.cbegin(), batch.cend());
+    ASSERT_EQUALS(5U * entrySize, buffer->getSize());
+    ASSERT_EQUALS(3U * entrySize, buffer->getSpilledSize_forTest());
+
+    // There is room again once an operation has been popped.
+    BSONObj value;
+    ASSERT_TRUE(buffer->tryPop(nullptr, &value));
+    buffer->waitForSpace(nullptr, entrySize);
+
+    buffer->clear(nullptr);
+    ASSERT_TRUE(buffer->isEmpty());
+    ASSERT_EQUALS(0U, buffer->getSpilledSize_forTest());
+    ASSERT_EQUALS(0U, _counters.count.get());
+    ASSERT_FALSE(buffer->waitForData(Seconds(0)));
+
+    buffer->push(nullptr, makeOplogEntry(5));
+    ASSERT_TRUE(buffer->waitForData(Seconds(0)));
+    ASSERT_TRUE(buffer->tryPop(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(5), value);
+
+    buffer->shutdown(nullptr);
+}
+
+}  // namespace
@@ -117,6 +117,7 @@ public:
     using OplogEntryBase::getPrevWriteOpTimeInTransaction;
     using OplogEntryBase::getPreImageOpTime;
     using OplogEntryBase::getPostImageOpTime;
+    using OplogEntryBase::getNeedsRetryImage;
 
     enum class CommandType {
         kNotCommand,
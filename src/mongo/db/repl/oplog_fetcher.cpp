@@ -37,6 +37,7 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/matcher.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/rpc/metadata/oplog_query_metadata.h"
@@ -65,6 +66,10 @@ ServerStatusMetricField<Counter64> displayOpsRead("repl.network.ops", &opsReadSt
 // The bytes read via the oplog reader
 Counter64 networkByteStats;
 ServerStatusMetricField<Counter64> displayBytesRead("repl.network.bytes", &networkByteStats);
+// The batches added to the oplog buffer while the next batch was fetched
+Counter64 enqueuedWhileFetchingStats;
+ServerStatusMetricField<Counter64> displayEnqueuedWhileFetching(
+    "repl.network.batchesEnqueuedWhileFetching", &enqueuedWhileFetchingStats);
 
 const Milliseconds maximumAwaitDataTimeoutMS(30 * 1000);
 
@@ -521,8 +526,18 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
     // Record time for each batch.
     getmoreReplStats.recordMillis(durationCount<Milliseconds>(queryResponse.elapsedMillis));
 
+    // The documents of the previous batch must be enqueued before these ones.
+    auto status = _waitForPendingBatchWork();
+    if (!status.isOK()) {
+        return status;
+    }
+
     // TODO: back pressure handling will be added in SERVER-23499.
-    auto status = _enqueueDocumentsFn(firstDocToApply, documents.cend(), info);
+    if (oplogFetcherEnqueueWhileFetching.load()) {
+        status = _scheduleEnqueue(Fetcher::Documents(firstDocToApply, documents.cend()), info);
+    } else {
+        status = _enqueueDocumentsFn(firstDocToApply, documents.cend(), info);
+    }
     if (!status.isOK()) {
         return status;
     }
@@ -559,5 +574,40 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
                                     _getGetMoreMaxTime(),
                                     _batchSize);
 }
+
+Status OplogFetcher::_waitForPendingBatchWork() {
+    stdx::unique_lock<stdx::mutex> lk(_enqueueMutex);
+    _enqueueCondition.wait(lk, [this] { return !_enqueueInProgress; });
+    return _enqueueStatus;
+}
+
+Status OplogFetcher::_scheduleEnqueue(Fetcher::Documents documents, const DocumentsInfo& info) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_enqueueMutex);
+        invariant(!_enqueueInProgress);
+        _enqueueInProgress = true;
+    }
+
+    // The enqueue may block until the buffer has room, which holds back the next batch once it
+    // has been fetched.
+    auto scheduleResult = _getExecutor()->scheduleWork(
+        [ this, documents = std::move(documents), info ](
+            const executor::TaskExecutor::CallbackArgs& args) {
+            auto status = args.status.isOK()
+                ? _enqueueDocumentsFn(documents.cbegin(), documents.cend(), info)
+                : args.status;
+            stdx::lock_guard<stdx::mutex> lk(_enqueueMutex);
+            _enqueueInProgress = false;
+            _enqueueStatus = status;
+            _enqueueCondition.notify_all();
+        });
+    if (!scheduleResult.isOK()) {
+        stdx::lock_guard<stdx::mutex> lk(_enqueueMutex);
+        _enqueueInProgress = false;
+        return scheduleResult.getStatus();
+    }
+    enqueuedWhileFetchingStats.increment();
+    return Status::OK();
+}
 }  // namespace repl
 }  // namespace mongo
@@ -39,6 +39,8 @@
 #include "mongo/db/repl/abstract_oplog_fetcher.h"
 #include "mongo/db/repl/data_replicator_external_state.h"
 #include "mongo/db/repl/repl_set_config.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/fail_point_service.h"
 
 namespace mongo {
@@ -170,6 +172,17 @@ private:
      */
     StatusWith<BSONObj> _onSuccessfulBatch(const Fetcher::QueryResponse& queryResponse) override;
 
+    /**
+     * Waits for the enqueue of the previous batch, if it is still running, and returns its status.
+     */
+    Status _waitForPendingBatchWork() override;
+
+    /**
+     * Schedules the enqueue of 'documents' on the executor, so that the next batch is requested
+     * from the sync source while the documents are added to the buffer.
+     */
+    Status _scheduleEnqueue(Fetcher::Documents documents, const DocumentsInfo& info);
+
     // The metadata object sent with the Fetcher queries.
     const BSONObj _metadataObject;
 
@@ -189,6 +202,13 @@ private:
 
     // Indicates if we want to skip the first document during oplog fetching or not.
     StartingPoint _startingPoint;
+
+    // Guards the state of the enqueue of the previous batch, which runs on the executor when
+    // 'oplogFetcherEnqueueWhileFetching' is set.
+    stdx::mutex _enqueueMutex;
+    stdx::condition_variable _enqueueCondition;
+    bool _enqueueInProgress = false;
+    Status _enqueueStatus = Status::OK();
 };
 
 }  // namespace repl
@@ -63,7 +63,7 @@ const string ReadConcernArgs::kAtClusterTimeFieldName("atClusterTime");
 const string ReadConcernArgs::kLevelFieldName("level");
 
 const OperationContext::Decoration<ReadConcernArgs> handle =
-    OperationContext::declareDecoration<ReadConcernArgs>();
+    OperationContext::declareHotDecoration<ReadConcernArgs>();
 
 ReadConcernArgs& ReadConcernArgs::get(OperationContext* opCtx) {
     return handle(opCtx);
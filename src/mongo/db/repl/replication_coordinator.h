@@ -41,6 +41,7 @@
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/split_horizon.h"
 #include "mongo/db/repl/sync_source_selector.h"
+#include "mongo/util/future.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/time_support.h"
 
@@ -209,6 +210,18 @@ public:
                                                const OpTime& opTime,
                                                const WriteConcernOptions& writeConcern) = 0;
 
+    /**
+     * Returns a future which is ready once "opTime" has been replicated to a set of nodes that
+     * satisfies the writeConcern, without blocking the calling thread. The writeConcern's
+     * wTimeout is ignored; the future is set with an error only if waiting can't succeed:
+     * ErrorCodes::PrimarySteppedDown if this node steps down before the writeConcern is satisfied
+     * ErrorCodes::UnknownReplWriteConcern if the writeConcern.wMode contains a write concern
+     *     mode that is not known
+     * ErrorCodes::ShutdownInProgress if we are mid-shutdown
+     */
+    virtual SemiFuture<void> awaitReplicationAsyncNoWTimeout(
+        const OpTime& opTime, const WriteConcernOptions& writeConcern) = 0;
+
     /**
      * Causes this node to relinquish being primary for at least 'stepdownTime'.  If 'force' is
      * false, before doing so it will wait for 'waitTime' for one other electable node to be caught
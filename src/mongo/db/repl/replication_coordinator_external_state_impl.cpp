@@ -68,6 +68,7 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_applier_impl.h"
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
+#include "mongo/db/repl/oplog_buffer_spilling_queue.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator.h"
@@ -84,6 +85,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/session_catalog_mongod.h"
 #include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/db/system_index.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface.h"
@@ -135,6 +137,10 @@ ServerStatusMetricField<Counter64> displayBufferSize("repl.buffer.sizeBytes", &b
 ServerStatusMetricField<Counter64> displayBufferMaxSize("repl.buffer.maxSizeBytes",
                                                         &bufferGauge.maxSize);
 
+// Operations the spilling oplog buffer holds in memory before it writes to its spill file, the
+// same as the limit of the blocking queue.
+const std::size_t kOplogBufferSpillingQueueMemorySize = 256 * 1024 * 1024;
+
 class NoopOplogApplierObserver : public repl::OplogApplier::Observer {
 public:
     void onBatchBegin(const repl::OplogApplier::Operations&) final {}
@@ -214,10 +220,18 @@ void ReplicationCoordinatorExternalStateImpl::startSteadyStateReplication(
         return;
 
     invariant(replCoord);
-    _oplogBuffer = std::make_unique<OplogBufferBlockingQueue>(&bufferGauge);
+    if (oplogBufferSpillToDisk) {
+        _oplogBuffer = std::make_unique<OplogBufferSpillingQueue>(
+            &bufferGauge,
+            kOplogBufferSpillingQueueMemorySize,
+            static_cast<std::size_t>(oplogBufferMaxSpillSizeMB) * 1024 * 1024,
+            storageGlobalParams.dbpath + "/_tmp/oplogBuffer.spill");
+    } else {
+        _oplogBuffer = std::make_unique<OplogBufferBlockingQueue>(&bufferGauge);
+    }
 
-    // No need to log OplogBuffer::startup because the blocking queue implementation
-    // does not start any threads or access the storage layer.
+    // No need to log OplogBuffer::startup because neither the blocking queue nor the spilling
+    // queue implementation starts any threads or accesses the storage layer.
     _oplogBuffer->startup(opCtx);
 
     invariant(!_oplogApplier);
@@ -214,6 +214,44 @@ void ReplicationCoordinatorImpl::CallbackWaiter::notify_inlock() {
     finishCallback();
 }
 
+ReplicationCoordinatorImpl::PromiseWaiter::PromiseWaiter(ReplicationCoordinatorImpl* _replCoord,
+                                                         OpTime _opTime,
+                                                         WriteConcernOptions _writeConcern,
+                                                         Promise<void> _promise)
+    : Waiter(_opTime, &ownedWriteConcern),
+      replCoord(_replCoord),
+      ownedWriteConcern(std::move(_writeConcern)),
+      promise(std::move(_promise)) {}
+
+void ReplicationCoordinatorImpl::PromiseWaiter::notify_inlock() {
+    // The WaiterList has already removed this waiter, so nothing refers to it any more.
+    std::unique_ptr<PromiseWaiter> self(this);
+
+    auto status = [&]() -> Status {
+        if (replCoord->_doneWaitingForReplication_inlock(opTime, ownedWriteConcern)) {
+            return replCoord->_checkIfWriteConcernCanBeSatisfied_inlock(ownedWriteConcern);
+        }
+        if (replCoord->_inShutdown) {
+            return {ErrorCodes::ShutdownInProgress, "Replication is being shut down"};
+        }
+        auto stepdownStatus =
+            replCoord->_checkForStepDownWhileAwaitingReplication_inlock(opTime);
+        if (!stepdownStatus.isOK()) {
+            return stepdownStatus;
+        }
+        // All waiters are signaled when the node leaves the primary state, before the new member
+        // state is recorded.
+        return {ErrorCodes::PrimarySteppedDown,
+                "Primary stepped down while waiting for replication"};
+    }();
+
+    if (status.isOK()) {
+        promise.emplaceValue();
+    } else {
+        promise.setError(std::move(status));
+    }
+}
+
 
 class ReplicationCoordinatorImpl::WaiterGuard {
 public:
@@ -1669,6 +1707,38 @@ ReplicationCoordinator::StatusAndDuration ReplicationCoordinatorImpl::awaitRepli
     return {std::move(status), duration_cast<Milliseconds>(timer.elapsed())};
 }
 
+SemiFuture<void> ReplicationCoordinatorImpl::awaitReplicationAsyncNoWTimeout(
+    const OpTime& opTime, const WriteConcernOptions& writeConcern) {
+    WriteConcernOptions fixedWriteConcern = populateUnsetWriteConcernOptionsSyncMode(writeConcern);
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    if (getReplicationMode() == modeNone || opTime.isNull()) {
+        return SemiFuture<void>::makeReady();
+    }
+
+    if (_inShutdown) {
+        return SemiFuture<void>::makeReady(
+            Status(ErrorCodes::ShutdownInProgress, "Replication is being shut down"));
+    }
+
+    auto stepdownStatus = _checkForStepDownWhileAwaitingReplication_inlock(opTime);
+    if (!stepdownStatus.isOK()) {
+        return SemiFuture<void>::makeReady(std::move(stepdownStatus));
+    }
+
+    if (_doneWaitingForReplication_inlock(opTime, fixedWriteConcern)) {
+        return SemiFuture<void>::makeReady(
+            _checkIfWriteConcernCanBeSatisfied_inlock(fixedWriteConcern));
+    }
+
+    // The waiter owns itself until it is notified, which happens at the latest when replication
+    // shuts down.
+    auto pf = makePromiseFuture<void>();
+    _replicationWaiterList.add_inlock(
+        new PromiseWaiter(this, opTime, std::move(fixedWriteConcern), std::move(pf.promise)));
+    return std::move(pf.future).semi();
+}
+
 BSONObj ReplicationCoordinatorImpl::_getReplicationProgress(WithLock wl) const {
     BSONObjBuilder progress;
 
@@ -1686,6 +1756,30 @@ BSONObj ReplicationCoordinatorImpl::_getReplicationProgress(WithLock wl) const {
     _topCoord->fillMemberData(&progress);
     return progress.obj();
 }
+
+Status ReplicationCoordinatorImpl::_checkForStepDownWhileAwaitingReplication_inlock(
+    const OpTime& opTime) const {
+    if (getReplicationMode() == modeReplSet && !_memberState.primary()) {
+        return {ErrorCodes::PrimarySteppedDown,
+                "Primary stepped down while waiting for replication"};
+    }
+
+    if (opTime.getTerm() != _topCoord->getTerm()) {
+        return {
+            ErrorCodes::PrimarySteppedDown,
+            str::stream() << "Term changed from " << opTime.getTerm() << " to "
+                          << _topCoord->getTerm()
+                          << " while waiting for replication, indicating that this node must "
+                             "have stepped down."};
+    }
+
+    if (_topCoord->isSteppingDown()) {
+        return {ErrorCodes::PrimarySteppedDown,
+                "Received stepdown request while waiting for replication"};
+    }
+    return Status::OK();
+}
+
 Status ReplicationCoordinatorImpl::_awaitReplication_inlock(
     stdx::unique_lock<stdx::mutex>* lock,
     OperationContext* opCtx,
@@ -1715,29 +1809,7 @@ Status ReplicationCoordinatorImpl::_awaitReplication_inlock(
         return interruptStatus;
     }
 
-    auto checkForStepDown = [&]() -> Status {
-        if (replMode == modeReplSet && !_memberState.primary()) {
-            return {ErrorCodes::PrimarySteppedDown,
-                    "Primary stepped down while waiting for replication"};
-        }
-
-        if (opTime.getTerm() != _topCoord->getTerm()) {
-            return {
-                ErrorCodes::PrimarySteppedDown,
-                str::stream() << "Term changed from " << opTime.getTerm() << " to "
-                              << _topCoord->getTerm()
-                              << " while waiting for replication, indicating that this node must "
-                                 "have stepped down."};
-        }
-
-        if (_topCoord->isSteppingDown()) {
-            return {ErrorCodes::PrimarySteppedDown,
-                    "Received stepdown request while waiting for replication"};
-        }
-        return Status::OK();
-    };
-
-    Status stepdownStatus = checkForStepDown();
+    Status stepdownStatus = _checkForStepDownWhileAwaitingReplication_inlock(opTime);
     if (!stepdownStatus.isOK()) {
         return stepdownStatus;
     }
@@ -1790,7 +1862,7 @@ Status ReplicationCoordinatorImpl::_awaitReplication_inlock(
             return {ErrorCodes::WriteConcernFailed, "waiting for replication timed out"};
         }
 
-        stepdownStatus = checkForStepDown();
+        stepdownStatus = _checkForStepDownWhileAwaitingReplication_inlock(opTime);
         if (!stepdownStatus.isOK()) {
             return stepdownStatus;
         }
@@ -129,6 +129,9 @@ public:
     virtual ReplicationCoordinator::StatusAndDuration awaitReplication(
         OperationContext* opCtx, const OpTime& opTime, const WriteConcernOptions& writeConcern);
 
+    SemiFuture<void> awaitReplicationAsyncNoWTimeout(
+        const OpTime& opTime, const WriteConcernOptions& writeConcern) override;
+
     void stepDown(OperationContext* opCtx,
                   bool force,
                   const Milliseconds& waitTime,
@@ -623,6 +626,26 @@ private:
         FinishFunc finishCallback = nullptr;
     };
 
+    // When the waiter is notified, it completes the promise with the outcome of waiting for
+    // 'writeConcern', and deletes itself.
+    //
+    // This is used when a caller wants a future which is ready when the opTime is reached with
+    // the given writeConcern, instead of blocking a thread.
+    struct PromiseWaiter : public Waiter {
+        PromiseWaiter(ReplicationCoordinatorImpl* _replCoord,
+                      OpTime _opTime,
+                      WriteConcernOptions _writeConcern,
+                      Promise<void> _promise);
+        void notify_inlock() override;
+        bool runs_once() const override {
+            return true;
+        }
+
+        ReplicationCoordinatorImpl* const replCoord;
+        const WriteConcernOptions ownedWriteConcern;
+        Promise<void> promise;
+    };
+
     class WaiterGuard;
 
     class WaiterList {
@@ -785,6 +808,12 @@ private:
      * Helper method for _awaitReplication that takes an already locked unique_lock, but leaves
      * operation timing to the caller.
      */
+    /**
+     * Returns PrimarySteppedDown if this node has stepped down, or is stepping down, since it wrote
+     * 'opTime'.
+     */
+    Status _checkForStepDownWhileAwaitingReplication_inlock(const OpTime& opTime) const;
+
     Status _awaitReplication_inlock(stdx::unique_lock<stdx::mutex>* lock,
                                     OperationContext* opCtx,
                                     const OpTime& opTime,
@@ -141,6 +141,15 @@ ReplicationCoordinator::StatusAndDuration ReplicationCoordinatorMock::awaitRepli
     return _awaitReplicationReturnValueFunction(opTime);
 }
 
+SemiFuture<void> ReplicationCoordinatorMock::awaitReplicationAsyncNoWTimeout(
+    const OpTime& opTime, const WriteConcernOptions& writeConcern) {
+    auto status = _awaitReplicationReturnValueFunction(opTime).status;
+    if (!status.isOK()) {
+        return SemiFuture<void>::makeReady(std::move(status));
+    }
+    return SemiFuture<void>::makeReady();
+}
+
 void ReplicationCoordinatorMock::setAwaitReplicationReturnValueFunction(
     AwaitReplicationReturnValueFunction returnValueFunction) {
     _awaitReplicationReturnValueFunction = std::move(returnValueFunction);
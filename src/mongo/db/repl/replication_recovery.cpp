@@ -42,6 +42,7 @@
 #include "mongo/db/repl/apply_ops.h"
 #include "mongo/db/repl/oplog_applier_impl.h"
 #include "mongo/db/repl/oplog_buffer.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/replication_consistency_markers_impl.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/transaction_oplog_application.h"
@@ -65,6 +66,9 @@ const auto kRecoveryOperationLogLevel = logger::LogSeverity::Debug(3);
  */
 class RecoveryOplogApplierStats : public OplogApplier::Observer {
 public:
+    RecoveryOplogApplierStats(Timestamp oplogApplicationStartPoint, Timestamp topOfOplog)
+        : _oplogApplicationStartPoint(oplogApplicationStartPoint), _topOfOplog(topOfOplog) {}
+
     void onBatchBegin(const OplogApplier::Operations& batch) final {
         _numBatches++;
         LOG_FOR_RECOVERY(kRecoveryBatchLogLevel)
@@ -86,7 +90,27 @@ public:
         }
     }
 
-    void onBatchEnd(const StatusWith<OpTime>&, const OplogApplier::Operations&) final {}
+    void onBatchEnd(const StatusWith<OpTime>& lastOpTimeApplied,
+                    const OplogApplier::Operations&) final {
+        const auto intervalSecs = replicationRecoveryProgressLogIntervalSecs.load();
+        // Log after the first batch, so that a long replay shows how far it has to go early on.
+        if (!lastOpTimeApplied.isOK() || intervalSecs == 0 ||
+            (_progressLogged && _sinceProgressLogged.seconds() < intervalSecs)) {
+            return;
+        }
+        _progressLogged = true;
+        _sinceProgressLogged.reset();
+
+        // Estimate the progress from the seconds of the timestamps, as the number of operations
+        // left is not known without scanning the oplog.
+        const auto appliedThrough = lastOpTimeApplied.getValue().getTimestamp();
+        const auto totalSecs = _topOfOplog.getSecs() - _oplogApplicationStartPoint.getSecs();
+        const auto appliedSecs = appliedThrough.getSecs() - _oplogApplicationStartPoint.getSecs();
+        log() << "Replication recovery has applied " << _numOpsApplied << " operations in "
+              << _numBatches << " batches, through " << appliedThrough.toBSON() << " of "
+              << _topOfOplog.toBSON() << " ("
+              << (totalSecs == 0 ? 100 : 100ULL * appliedSecs / totalSecs) << "%)";
+    }
     void onMissingDocumentsFetchedAndInserted(const std::vector<FetchInfo>&) final {}
 
     void complete(const OpTime& applyThroughOpTime) const {
@@ -96,8 +120,12 @@ public:
     }
 
 private:
+    const Timestamp _oplogApplicationStartPoint;
+    const Timestamp _topOfOplog;
     std::size_t _numBatches = 0;
     std::size_t _numOpsApplied = 0;
+    bool _progressLogged = false;
+    Timer _sinceProgressLogged;
 };
 
 /**
@@ -370,7 +398,7 @@ void ReplicationRecoveryImpl::_applyToEndOfOplog(OperationContext* opCtx,
     OplogBufferLocalOplog oplogBuffer(oplogApplicationStartPoint);
     oplogBuffer.startup(opCtx);
 
-    RecoveryOplogApplierStats stats;
+    RecoveryOplogApplierStats stats(oplogApplicationStartPoint, topOfOplog);
 
     auto writerPool = OplogApplier::makeWriterPool();
     OplogApplier::Options options;
@@ -64,6 +64,7 @@
 #include "mongo/db/storage/remove_saver.h"
 #include "mongo/db/transaction_history_iterator.h"
 #include "mongo/s/catalog/type_config_version.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 
@@ -170,6 +171,11 @@ RollbackImpl::RollbackImpl(OplogInterface* localOplog,
 
 RollbackImpl::~RollbackImpl() {
     shutdown();
+    // The critical section waits for the rollback file writer, so this only matters if rollback
+    // never reached it.
+    if (_rollbackFileWriter.joinable()) {
+        _rollbackFileWriter.join();
+    }
 }
 
 Status RollbackImpl::runRollback(OperationContext* opCtx) {
@@ -480,6 +486,7 @@ Status RollbackImpl::_runRollbackCriticalSection(
         if (!status.isOK()) {
             return status.withContext("Error while writing out rollback files");
         }
+        _startRollbackFileWriter();
     } else {
         log() << "Not writing rollback files. 'createRollbackDataFiles' set to false.";
     }
@@ -541,6 +548,9 @@ Status RollbackImpl::_runRollbackCriticalSection(
     // rollback.
     _correctRecordStoreCounts(opCtx);
 
+    // Rollback is not complete until the documents it deleted are in the rollback files.
+    _waitForRollbackFileWriter();
+
     // Reconstruct prepared transactions after counts have been adjusted. Since prepared
     // transactions were aborted (i.e. the in-memory counts were rolled-back) before computing
     // collection counts, reconstruct the prepared transactions now, adding on any additional counts
@@ -1101,9 +1111,10 @@ void RollbackImpl::_writeRollbackFileForNamespace(OperationContext* opCtx,
                                                   UUID uuid,
                                                   NamespaceString nss,
                                                   const SimpleBSONObjUnorderedSet& idSet) {
-    RemoveSaver removeSaver(kRollbackRemoveSaverType, nss.ns(), kRollbackRemoveSaverWhy);
+    auto removeSaver =
+        std::make_unique<RemoveSaver>(kRollbackRemoveSaverType, nss.ns(), kRollbackRemoveSaverWhy);
     log() << "Preparing to write deleted documents to a rollback file for collection " << nss.ns()
-          << " with uuid " << uuid.toString() << " to " << removeSaver.file().generic_string();
+          << " with uuid " << uuid.toString() << " to " << removeSaver->file().generic_string();
 
     // The RemoveSaver will save the data files in a directory structure similar to the following:
     //
@@ -1116,7 +1127,7 @@ void RollbackImpl::_writeRollbackFileForNamespace(OperationContext* opCtx,
     //
     // If this is the first data directory created, we save the full directory path in
     // _rollbackStats. Otherwise, we store the longest common prefix of the two directories.
-    const auto& newDirectoryPath = removeSaver.root().generic_string();
+    const auto& newDirectoryPath = removeSaver->root().generic_string();
     if (!_rollbackStats.rollbackDataFileDirectory) {
         _rollbackStats.rollbackDataFileDirectory = newDirectoryPath;
     } else {
@@ -1129,18 +1140,68 @@ void RollbackImpl::_writeRollbackFileForNamespace(OperationContext* opCtx,
         _rollbackStats.rollbackDataFileDirectory = std::string(newDirectoryPath.begin(), prefixEnd);
     }
 
+    // In the background, only the reads must happen before recovering to the stable timestamp.
+    // The documents are held in memory until the rollback file writer writes them out.
+    const bool writeInBackground = gRollbackWriteDataFilesInBackground.load();
+    std::vector<BSONObj> documents;
+
     for (auto&& id : idSet) {
         // StorageInterface::findById() does not respect the collation, but because we are using
         // exact _id fields recorded in the oplog, we can get away with binary string
         // comparisons.
         auto document = _findDocumentById(opCtx, uuid, nss, id.firstElement());
         if (document) {
-            fassert(50750, removeSaver.goingToDelete(*document));
+            if (writeInBackground) {
+                documents.push_back(document->getOwned());
+            } else {
+                fassert(50750, removeSaver->goingToDelete(*document));
+            }
         }
     }
+
+    if (writeInBackground) {
+        _pendingRollbackFiles.push_back(
+            {std::move(uuid),
+             std::move(nss),
+             std::move(removeSaver),
+             std::move(documents)});
+        return;
+    }
     _listener->onRollbackFileWrittenForNamespace(std::move(uuid), std::move(nss));
 }
 
+void RollbackImpl::_startRollbackFileWriter() {
+    if (_pendingRollbackFiles.empty()) {
+        return;
+    }
+    log() << "Writing " << _pendingRollbackFiles.size()
+          << " rollback files in the background during recovery";
+    _rollbackFileWriter = stdx::thread([this] {
+        setThreadName("rollbackFileWriter");
+        for (auto&& pending : _pendingRollbackFiles) {
+            for (auto&& document : pending.documents) {
+                fassert(51327, pending.removeSaver->goingToDelete(document));
+            }
+            // Destroying the RemoveSaver flushes and closes its file.
+            pending.removeSaver.reset();
+            pending.documents.clear();
+        }
+    });
+}
+
+void RollbackImpl::_waitForRollbackFileWriter() {
+    if (!_rollbackFileWriter.joinable()) {
+        return;
+    }
+    _rollbackFileWriter.join();
+    for (auto&& pending : _pendingRollbackFiles) {
+        _listener->onRollbackFileWrittenForNamespace(std::move(pending.uuid),
+                                                     std::move(pending.nss));
+    }
+    _pendingRollbackFiles.clear();
+    log() << "Finished writing rollback files in the background";
+}
+
 StatusWith<Timestamp> RollbackImpl::_recoverToStableTimestamp(OperationContext* opCtx) {
     // Recover to the stable timestamp while holding the global exclusive lock. This may throw,
     // which the caller must handle.
@@ -37,10 +37,12 @@
 #include "mongo/db/repl/roll_back_local_operations.h"
 #include "mongo/db/repl/rollback.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/stdx/thread.h"
 
 namespace mongo {
 
 class OperationContext;
+class RemoveSaver;
 
 namespace repl {
 
@@ -438,6 +440,19 @@ private:
      */
     Status _writeRollbackFiles(OperationContext* opCtx);
 
+    /**
+     * Writes the documents of '_pendingRollbackFiles' to their rollback files on a separate
+     * thread, so that the recovery to the stable timestamp and the oplog replay do not wait on
+     * them. Does nothing if there are no pending rollback files.
+     */
+    void _startRollbackFileWriter();
+
+    /**
+     * Waits for the thread started by _startRollbackFileWriter() to write all of the pending
+     * rollback files, and notifies the listener of each namespace written.
+     */
+    void _waitForRollbackFileWriter();
+
     /**
      * Logs a summary of what has occurred so far during rollback to the server log.
      */
@@ -495,6 +510,19 @@ private:
     // Maintains the count of the record store pointed to by the UUID after we recover from the
     // oplog.
     stdx::unordered_map<UUID, long long, UUID::Hash> _newCounts;  // (N)
+
+    // The documents read for a rollback file, which the rollback file writer thread writes out
+    // when 'rollbackWriteDataFilesInBackground' is set.
+    struct PendingRollbackFile {
+        UUID uuid;
+        NamespaceString nss;
+        std::unique_ptr<RemoveSaver> removeSaver;
+        std::vector<BSONObj> documents;
+    };
+    std::vector<PendingRollbackFile> _pendingRollbackFiles;  // (N)
+
+    // Writes out '_pendingRollbackFiles' while the critical section of rollback continues.
+    stdx::thread _rollbackFileWriter;  // (N)
 };
 
 }  // namespace repl
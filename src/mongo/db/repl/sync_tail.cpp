@@ -35,7 +35,10 @@
 
 #include "third_party/murmurhash3/MurmurHash3.h"
 #include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
 #include <memory>
+#include <numeric>
+#include <queue>
 
 #include "mongo/base/counter.h"
 #include "mongo/bson/bsonelement_comparator.h"
@@ -67,6 +70,7 @@
 #include "mongo/db/repl/multiapplier.h"
 #include "mongo/db/repl/oplogreader.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/transaction_oplog_application.h"
@@ -108,6 +112,11 @@ ServerStatusMetricField<Counter64> displayAttemptsToBecomeSecondary(
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
 
+// Number of batches partitioned over the writer threads while the previous batch was applied.
+Counter64 batchesPartitionedWhileApplying;
+ServerStatusMetricField<Counter64> displayBatchesPartitionedWhileApplying(
+    "repl.apply.batchesPartitionedWhileApplying", &batchesPartitionedWhileApplying);
+
 class ApplyBatchFinalizer {
 public:
     ApplyBatchFinalizer(ReplicationCoordinator* replCoord) : _replCoord(replCoord) {}
@@ -608,6 +617,23 @@ public:
         return ops;
     }
 
+    /**
+     * Returns the next batch if it is ready, or an empty batch otherwise. Unlike getNextBatch(),
+     * never returns the shutdown signal, which the next call to getNextBatch() returns instead.
+     */
+    OpQueue tryGetNextBatch() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_ops.empty()) {
+            return OpQueue(0);
+        }
+
+        OpQueue ops = std::move(_ops);
+        _ops = OpQueue(0);
+        _cv.notify_all();
+
+        return ops;
+    }
+
 private:
     /**
      * If slaveDelay is enabled, this function calculates the most recent timestamp of any oplog
@@ -653,8 +679,8 @@ private:
 
                 auto oplogEntries =
                     fassertNoTrace(31004, _getNextApplierBatchFn(opCtx.get(), batchLimits));
-                for (const auto& oplogEntry : oplogEntries) {
-                    ops.emplace_back(oplogEntry.getRaw());
+                for (auto& oplogEntry : oplogEntries) {
+                    ops.emplace_back(std::move(oplogEntry));
                 }
 
                 // If we don't have anything in the queue, wait a bit for something to appear.
@@ -713,6 +739,22 @@ void SyncTail::oplogApplication(OplogBuffer* oplogBuffer,
     _oplogApplication(replCoord, &batcher);
 }
 
+namespace {
+
+/**
+ * Returns whether a batch may be partitioned over the writer threads while the batch before it is
+ * applied, or be applied while the batch after it is partitioned. Commands may change the
+ * collection properties the partitioning depends on, and the operations of transactions are read
+ * from the oplog, in which the previous batch is not visible yet.
+ */
+bool canPartitionBatchEarly(const MultiApplier::Operations& ops) {
+    return std::all_of(ops.begin(), ops.end(), [](const OplogEntry& op) {
+        return op.isCrudOpType() || op.getOpType() == OpTypeEnum::kNoop;
+    });
+}
+
+}  // namespace
+
 void SyncTail::_oplogApplication(ReplicationCoordinator* replCoord,
                                  OpQueueBatcher* batcher) noexcept {
     std::unique_ptr<ApplyBatchFinalizer> finalizer{
@@ -723,6 +765,9 @@ void SyncTail::_oplogApplication(ReplicationCoordinator* replCoord,
     // Get replication consistency markers.
     OpTime minValid;
 
+    // The next batch, taken from the batcher and partitioned while the previous batch was applied.
+    boost::optional<PartitionedBatch> nextBatch;
+
     while (true) {  // Exits on message from OpQueueBatcher.
         // Use a new operation context each iteration, as otherwise we may appear to use a single
         // collection name to refer to collections with different UUIDs.
@@ -755,26 +800,33 @@ void SyncTail::_oplogApplication(ReplicationCoordinator* replCoord,
         // Transition to SECONDARY state, if possible.
         tryToGoLiveAsASecondary(&opCtx, replCoord, minValid);
 
-        long long termWhenBufferIsEmpty = replCoord->getTerm();
-        // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't become
-        // ready in time, we'll loop again so we can do the above checks periodically.
-        OpQueue ops = batcher->getNextBatch(Seconds(1));
-        if (ops.empty()) {
-            if (ops.mustShutdown()) {
-                // Shut down and exit oplog application loop.
-                return;
-            }
-            if (MONGO_FAIL_POINT(rsSyncApplyStop)) {
-                continue;
+        PartitionedBatch batch;
+        if (nextBatch) {
+            batch = std::move(*nextBatch);
+            nextBatch = boost::none;
+        } else {
+            long long termWhenBufferIsEmpty = replCoord->getTerm();
+            // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't become
+            // ready in time, we'll loop again so we can do the above checks periodically.
+            OpQueue ops = batcher->getNextBatch(Seconds(1));
+            if (ops.empty()) {
+                if (ops.mustShutdown()) {
+                    // Shut down and exit oplog application loop.
+                    return;
+                }
+                if (MONGO_FAIL_POINT(rsSyncApplyStop)) {
+                    continue;
+                }
+                // Signal drain complete if we're in Draining state and the buffer is empty.
+                replCoord->signalDrainComplete(&opCtx, termWhenBufferIsEmpty);
+                continue;  // Try again.
             }
-            // Signal drain complete if we're in Draining state and the buffer is empty.
-            replCoord->signalDrainComplete(&opCtx, termWhenBufferIsEmpty);
-            continue;  // Try again.
+            batch.ops = ops.releaseBatch();
         }
 
         // Extract some info from ops that we'll need after releasing the batch below.
-        const auto firstOpTimeInBatch = ops.front().getOpTime();
-        const auto lastOpInBatch = ops.back();
+        const auto firstOpTimeInBatch = batch.ops.front().getOpTime();
+        const auto lastOpInBatch = batch.ops.back();
         const auto lastOpTimeInBatch = lastOpInBatch.getOpTime();
         const auto lastWallTimeInBatch = lastOpInBatch.getWallClockTime();
         const auto lastAppliedOpTimeAtStartOfBatch = replCoord->getMyLastAppliedOpTime();
@@ -793,10 +845,35 @@ void SyncTail::_oplogApplication(ReplicationCoordinator* replCoord,
         // Don't allow the fsync+lock thread to see intermediate states of batch application.
         stdx::lock_guard<SimpleMutex> fsynclk(filesLockedFsync);
 
+        // While the writer threads apply this batch, partition the next one if it is ready, so
+        // that they do not wait for it once they are done with this one.
+        const bool partitionNextBatch =
+            replPartitionNextBatchWhileApplying.load() && canPartitionBatchEarly(batch.ops);
+        auto partitionNextBatchFn = [&] {
+            if (!partitionNextBatch) {
+                return;
+            }
+
+            OpQueue ops = batcher->tryGetNextBatch();
+            if (ops.empty()) {
+                return;
+            }
+
+            nextBatch.emplace();
+            nextBatch->ops = ops.releaseBatch();
+            if (canPartitionBatchEarly(nextBatch->ops)) {
+                nextBatch->writerVectors.resize(_writerPool->getStats().numThreads);
+                fillWriterVectors(
+                    &opCtx, &nextBatch->ops, &nextBatch->writerVectors, &nextBatch->derivedOps);
+                nextBatch->isPartitioned = true;
+                batchesPartitionedWhileApplying.increment();
+            }
+        };
+
         // Apply the operations in this batch. 'multiApply' returns the optime of the last op that
         // was applied, which should be the last optime in the batch.
         auto lastOpTimeAppliedInBatch =
-            fassertNoTrace(34437, multiApply(&opCtx, ops.releaseBatch()));
+            fassertNoTrace(34437, _multiApply(&opCtx, std::move(batch), partitionNextBatchFn));
         invariant(lastOpTimeAppliedInBatch == lastOpTimeInBatch);
 
         // In order to provide resilience in the event of a crash in the middle of batch
@@ -1023,6 +1100,9 @@ Status multiSyncApply(OperationContext* opCtx,
     opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kNoTimestamp);
 
     ApplierHelpers::stableSortByNamespace(ops);
+    if (replGroupInsertsAcrossOtherDocuments.load()) {
+        ApplierHelpers::stableGroupInserts(ops);
+    }
 
     // Assume we are recovering if oplog writes are disabled in the options.
     // Assume we are in initial sync if we have a host for fetching missing documents.
@@ -1099,7 +1179,8 @@ Status multiSyncApply(OperationContext* opCtx,
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
- * writerVectors - Set of operations for each worker thread to apply.
+ * writerVectors - Set of operations for each worker thread to apply, or for each bucket of
+ *      operations which must be applied in order.
  * derivedOps - If provided, this function inserts a decomposition of applyOps operations
  *      and instructions for updating the transactions table.  Required if processing oplogs
  *      with transactions.
@@ -1233,18 +1314,64 @@ void SyncTail::_fillWriterVectors(OperationContext* opCtx,
     }
 }
 
+namespace {
+
+/**
+ * Appends each bucket of operations to a writer, the largest buckets first and each to the writer
+ * with the fewest operations so far. Only the operations of a bucket must be applied in order, so
+ * a bucket with a hot document gets a writer of its own rather than serializing the application
+ * of all the buckets which would have hashed to the same writer.
+ */
+void assignBucketsToWriters(std::vector<MultiApplier::OperationPtrs>* buckets,
+                            std::vector<MultiApplier::OperationPtrs>* writerVectors) {
+    std::vector<size_t> bucketOrder(buckets->size());
+    std::iota(bucketOrder.begin(), bucketOrder.end(), 0);
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&](size_t lhs, size_t rhs) {
+        return (*buckets)[lhs].size() > (*buckets)[rhs].size();
+    });
+
+    // Pairs of the number of operations of a writer and its index, the least loaded on top.
+    using WriterLoad = std::pair<size_t, size_t>;
+    std::priority_queue<WriterLoad, std::vector<WriterLoad>, std::greater<WriterLoad>> writers;
+    for (size_t i = 0; i < writerVectors->size(); ++i) {
+        writers.emplace((*writerVectors)[i].size(), i);
+    }
+
+    for (auto bucketIndex : bucketOrder) {
+        auto& bucket = (*buckets)[bucketIndex];
+        if (bucket.empty()) {
+            break;
+        }
+
+        auto writerLoad = writers.top();
+        writers.pop();
+        auto& writer = (*writerVectors)[writerLoad.second];
+        writer.insert(writer.end(), bucket.begin(), bucket.end());
+        writers.emplace(writerLoad.first + bucket.size(), writerLoad.second);
+    }
+}
+
+}  // namespace
+
 void SyncTail::fillWriterVectors(OperationContext* opCtx,
                                  MultiApplier::Operations* ops,
                                  std::vector<MultiApplier::OperationPtrs>* writerVectors,
                                  std::vector<MultiApplier::Operations>* derivedOps) {
+    // Hash the operations into more buckets than there are writers, so that the buckets can be
+    // balanced over the writers.
+    std::vector<MultiApplier::OperationPtrs> buckets(writerVectors->size() *
+                                                     replWriterBucketsPerThread.load());
+
     SessionUpdateTracker sessionUpdateTracker;
-    _fillWriterVectors(opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker);
+    _fillWriterVectors(opCtx, ops, &buckets, derivedOps, &sessionUpdateTracker);
 
     auto newOplogWrites = sessionUpdateTracker.flushAll();
     if (!newOplogWrites.empty()) {
         derivedOps->emplace_back(std::move(newOplogWrites));
-        _fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+        _fillWriterVectors(opCtx, &derivedOps->back(), &buckets, derivedOps, nullptr);
     }
+
+    assignBucketsToWriters(&buckets, writerVectors);
 }
 
 void SyncTail::_applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors,
@@ -1276,6 +1403,15 @@ void SyncTail::_applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors
 }
 
 StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::Operations ops) {
+    PartitionedBatch batch;
+    batch.ops = std::move(ops);
+    return _multiApply(opCtx, std::move(batch), [] {});
+}
+
+StatusWith<OpTime> SyncTail::_multiApply(OperationContext* opCtx,
+                                         PartitionedBatch batch,
+                                         const std::function<void()>& whileApplying) {
+    auto& ops = batch.ops;
     invariant(!ops.empty());
 
     LOG(2) << "replication batch size is " << ops.size();
@@ -1315,10 +1451,13 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
         // - ops to update config.transactions. Normal writes to config.transactions in the
         //   primary don't create an oplog entry, so extract info from writes with transactions
         //   and create a pseudo oplog.
-        std::vector<MultiApplier::Operations> derivedOps;
+        auto& derivedOps = batch.derivedOps;
 
-        std::vector<MultiApplier::OperationPtrs> writerVectors(_writerPool->getStats().numThreads);
-        fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
+        auto& writerVectors = batch.writerVectors;
+        if (!batch.isPartitioned) {
+            writerVectors.resize(_writerPool->getStats().numThreads);
+            fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
+        }
 
         // Wait for writes to finish before applying ops.
         _writerPool->waitForIdle();
@@ -1341,6 +1480,7 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
         {
             std::vector<Status> statusVector(_writerPool->getStats().numThreads, Status::OK());
             _applyOps(writerVectors, &statusVector, &multikeyVector);
+            whileApplying();
             _writerPool->waitForIdle();
 
             // If any of the statuses is not ok, return error.
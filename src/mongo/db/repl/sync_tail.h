@@ -156,10 +156,14 @@ public:
             return _batch;
         }
 
-        void emplace_back(BSONObj obj) {
+        /**
+         * Takes the entry as parsed when the batch was read from the oplog buffer, so that it is
+         * not parsed again. It keeps referencing the buffer of the fetched batch.
+         */
+        void emplace_back(OplogEntry entry) {
             invariant(!_mustShutdown);
-            _bytes += obj.objsize();
-            _batch.emplace_back(std::move(obj));
+            _bytes += entry.getRawObjSizeBytes();
+            _batch.emplace_back(std::move(entry));
         }
         void pop_back() {
             _bytes -= back().getRawObjSizeBytes();
@@ -238,8 +242,27 @@ public:
 private:
     class OpQueueBatcher;
 
+    /**
+     * A batch of operations, and the operations of the batch and of 'derivedOps' partitioned over
+     * the writer threads once 'isPartitioned' is set.
+     */
+    struct PartitionedBatch {
+        MultiApplier::Operations ops;
+        std::vector<MultiApplier::Operations> derivedOps;
+        std::vector<MultiApplier::OperationPtrs> writerVectors;
+        bool isPartitioned = false;
+    };
+
     void _oplogApplication(ReplicationCoordinator* replCoord, OpQueueBatcher* batcher) noexcept;
 
+    /**
+     * Applies a batch like multiApply(), but only partitions it if it is not partitioned yet.
+     * Calls 'whileApplying' on this thread while the writer threads apply the batch.
+     */
+    StatusWith<OpTime> _multiApply(OperationContext* opCtx,
+                                   PartitionedBatch batch,
+                                   const std::function<void()>& whileApplying);
+
     void _fillWriterVectors(OperationContext* opCtx,
                             MultiApplier::Operations* ops,
                             std::vector<MultiApplier::OperationPtrs>* writerVectors,
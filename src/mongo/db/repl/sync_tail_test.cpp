@@ -52,6 +52,7 @@
 #include "mongo/db/logical_session_id_helpers.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/repl/applier_helpers.h"
 #include "mongo/db/repl/bgsync.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
 #include "mongo/db/repl/idempotency_test_fixture.h"
@@ -474,6 +475,57 @@ TEST_F(SyncTailTest, MultiSyncApplyUsesSyncApplyToApplyOperation) {
     ASSERT_TRUE(AutoGetCollectionForReadCommand(_opCtx.get(), nss).getCollection());
 }
 
+TEST_F(SyncTailTest, FillWriterVectorsGivesHotDocumentItsOwnWriter) {
+    NamespaceString hotNss("test.hot");
+    const Seconds s(1);
+    unsigned int i = 1;
+
+    // One document is updated 100 times, and 30 others are inserted into their own collections.
+    MultiApplier::Operations ops;
+    for (int j = 0; j < 100; ++j) {
+        ops.push_back(makeUpdateDocumentOplogEntry(
+            {Timestamp(s, i++), 1LL}, hotNss, BSON("_id" << 0), BSON("$set" << BSON("x" << j))));
+    }
+    const int numOtherOps = 30;
+    for (int j = 0; j < numOtherOps; ++j) {
+        NamespaceString nss("test.t" + std::to_string(j));
+        ops.push_back(
+            makeInsertDocumentOplogEntry({Timestamp(s, i++), 1LL}, nss, BSON("_id" << j)));
+    }
+
+    const size_t numWriters = 4;
+    std::vector<MultiApplier::OperationPtrs> writerVectors(numWriters);
+    std::vector<MultiApplier::Operations> derivedOps;
+    SyncTail syncTail(nullptr, nullptr, nullptr, {}, nullptr);
+    syncTail.fillWriterVectors(_opCtx.get(), &ops, &writerVectors, &derivedOps);
+
+    size_t numOps = 0;
+    for (auto&& writer : writerVectors) {
+        numOps += writer.size();
+    }
+    ASSERT_EQ(ops.size(), numOps);
+
+    // The updates of the hot document are applied in order by one writer, which gets fewer of the
+    // other operations than the other writers.
+    auto hotWriter = std::find_if(writerVectors.begin(), writerVectors.end(), [&](auto& writer) {
+        return std::any_of(writer.begin(), writer.end(), [&](const OplogEntry* op) {
+            return op->getNss() == hotNss;
+        });
+    });
+    ASSERT(hotWriter != writerVectors.end());
+
+    std::vector<const OplogEntry*> hotOps;
+    std::copy_if(hotWriter->begin(),
+                 hotWriter->end(),
+                 std::back_inserter(hotOps),
+                 [&](const OplogEntry* op) { return op->getNss() == hotNss; });
+    ASSERT_EQ(100U, hotOps.size());
+    for (size_t j = 0; j < hotOps.size(); ++j) {
+        ASSERT_EQ(&ops[j], hotOps[j]);
+    }
+    ASSERT_LTE(hotWriter->size() - hotOps.size(), numOtherOps / numWriters);
+}
+
 class MultiOplogEntrySyncTailTest : public SyncTailTest {
 public:
     MultiOplogEntrySyncTailTest() : _nss1("test.preptxn1"), _nss2("test.preptxn2"), _txnNum(1) {}
@@ -842,14 +894,14 @@ TEST_F(MultiOplogEntrySyncTailTest, MultiApplyTwoTransactionsOneBatch) {
     // Note the insert counter so we can check it later.  It is necessary to use opCounters as
     // inserts are idempotent so we will not detect duplicate inserts just by checking inserts in
     // the opObserver.
-    int insertsBefore = replOpCounters.getInsert()->load();
+    int insertsBefore = replOpCounters.getInsert()->get();
     // Insert all the oplog entries in one batch.  All inserts should be executed, in order, exactly
     // once.
     ASSERT_OK(syncTail.multiApply(
         _opCtx.get(),
         {insertOps1[0], insertOps1[1], commitOp1, insertOps2[0], insertOps2[1], commitOp2}));
     ASSERT_EQ(6U, oplogDocs().size());
-    ASSERT_EQ(4, replOpCounters.getInsert()->load() - insertsBefore);
+    ASSERT_EQ(4, replOpCounters.getInsert()->get() - insertsBefore);
     ASSERT_EQ(4U, _insertedDocs[_nss1].size());
     checkTxnTable(_lsid,
                   txnNum2,
@@ -1536,6 +1588,48 @@ TEST_F(SyncTailTest, MultiSyncApplySortsOperationsStablyByNamespaceBeforeApplyin
     ASSERT(onInsertsCalled);
 }
 
+TEST_F(SyncTailTest, StableGroupInsertsMovesInsertsAheadOfOtherDocuments) {
+    NamespaceString nss1("test.t1");
+    NamespaceString nss2("test.t2");
+
+    const Seconds s(1);
+    unsigned int i = 1;
+    auto insert1 = makeInsertDocumentOplogEntry({Timestamp(s, i++), 1LL}, nss1, BSON("_id" << 1));
+    auto updateA = makeUpdateDocumentOplogEntry(
+        {Timestamp(s, i++), 1LL}, nss1, BSON("_id" << 10), BSON("$set" << BSON("x" << 1)));
+    auto insert2 = makeInsertDocumentOplogEntry({Timestamp(s, i++), 1LL}, nss1, BSON("_id" << 2));
+    auto deleteB = makeDeleteDocumentOplogEntry({Timestamp(s, i++), 1LL}, nss1, BSON("_id" << 11));
+    auto insert3 = makeInsertDocumentOplogEntry({Timestamp(s, i++), 1LL}, nss1, BSON("_id" << 3));
+    auto update4 = makeUpdateDocumentOplogEntry(
+        {Timestamp(s, i++), 1LL}, nss1, BSON("_id" << 4), BSON("$set" << BSON("x" << 1)));
+    auto insert4 = makeInsertDocumentOplogEntry({Timestamp(s, i++), 1LL}, nss1, BSON("_id" << 4));
+    auto insert5 = makeInsertDocumentOplogEntry({Timestamp(s, i++), 1LL}, nss1, BSON("_id" << 5));
+    auto updateStr = makeUpdateDocumentOplogEntry(
+        {Timestamp(s, i++), 1LL}, nss1, BSON("_id" << "a"), BSON("$set" << BSON("x" << 1)));
+    auto insertStr =
+        makeInsertDocumentOplogEntry({Timestamp(s, i++), 1LL}, nss1, BSON("_id" << "A"));
+    auto other = makeInsertDocumentOplogEntry({Timestamp(s, i++), 1LL}, nss2, BSON("_id" << 6));
+
+    MultiApplier::OperationPtrs ops = {
+        &insert1, &updateA, &insert2, &deleteB, &insert3, &update4, &insert4, &insert5};
+    ops.push_back(&updateStr);
+    ops.push_back(&insertStr);
+    ops.push_back(&other);
+    ApplierHelpers::stableGroupInserts(&ops);
+
+    // The inserts stay behind the operations on the same document, and on _ids which the
+    // collation may make equal to theirs.
+    MultiApplier::OperationPtrs expected = {
+        &insert1, &insert2, &insert3, &updateA, &deleteB, &update4, &insert4, &insert5};
+    expected.push_back(&updateStr);
+    expected.push_back(&insertStr);
+    expected.push_back(&other);
+    ASSERT_EQ(expected.size(), ops.size());
+    for (size_t j = 0; j < expected.size(); ++j) {
+        ASSERT_EQ(expected[j], ops[j]) << "Entry " << j << ": " << ops[j]->toString();
+    }
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyGroupsInsertOperationByNamespaceBeforeApplying) {
     int seconds = 1;
     auto makeOp = [&seconds](const NamespaceString& nss) {
@@ -243,6 +243,7 @@ ShardId BalancerPolicy::_getLeastLoadedReceiverShard(const ShardStatisticsVector
                                                      const set<ShardId>& excludedShards) {
     ShardId best;
     unsigned minChunks = numeric_limits<unsigned>::max();
+    double minOpsPerSec = numeric_limits<double>::max();
 
     for (const auto& stat : shardStats) {
         if (excludedShards.count(stat.shardId))
@@ -253,13 +254,15 @@ ShardId BalancerPolicy::_getLeastLoadedReceiverShard(const ShardStatisticsVector
             continue;
         }
 
+        // Among the shards with the fewest chunks, prefer the one serving the fewest operations
         unsigned myChunks = distribution.numberOfChunksInShard(stat.shardId);
-        if (myChunks >= minChunks) {
+        if (myChunks > minChunks || (myChunks == minChunks && stat.opsPerSec >= minOpsPerSec)) {
             continue;
         }
 
         best = stat.shardId;
         minChunks = myChunks;
+        minOpsPerSec = stat.opsPerSec;
     }
 
     return best;
@@ -271,18 +274,24 @@ ShardId BalancerPolicy::_getMostOverloadedShard(const ShardStatisticsVector& sha
                                                 const set<ShardId>& excludedShards) {
     ShardId worst;
     unsigned maxChunks = 0;
+    double maxOpsPerSec = 0;
 
     for (const auto& stat : shardStats) {
         if (excludedShards.count(stat.shardId))
             continue;
 
+        // Among the shards with the most chunks, prefer the one serving the most operations
         const unsigned shardChunkCount =
             distribution.numberOfChunksInShardWithTag(stat.shardId, chunkTag);
-        if (shardChunkCount <= maxChunks)
+        if (shardChunkCount == 0 || shardChunkCount < maxChunks)
+            continue;
+
+        if (shardChunkCount == maxChunks && stat.opsPerSec <= maxOpsPerSec)
             continue;
 
         worst = stat.shardId;
         maxChunks = shardChunkCount;
+        maxOpsPerSec = stat.opsPerSec;
     }
 
     return worst;
@@ -73,6 +73,7 @@ BSONObj ClusterStatistics::ShardStatistics::toBSON() const {
     }
 
     builder.append("version", mongoVersion);
+    builder.append("opsPerSec", opsPerSec);
     return builder.obj();
 }
 
@@ -93,6 +93,10 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // The rate of operations (inserts, queries, updates, deletes and getMores) served by this
+        // shard's primary since the previous statistics were collected. Zero if it is not known.
+        double opsPerSec{0};
     };
 
     virtual ~ClusterStatistics();
@@ -49,16 +49,19 @@ namespace mongo {
 namespace {
 
 const char kVersionField[] = "version";
+const char kOpCountersField[] = "opcounters";
+
+// The operation counters which are added up to measure the load of a shard. Commands are left out,
+// because the monitoring and balancing of the cluster issue them regardless of the load.
+const char* const kOpCounterFields[] = {"insert", "query", "update", "delete", "getmore"};
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Returns the serverStatus response or an error. Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -79,15 +82,25 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
 
-    std::string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
+/**
+ * Returns the total number of operations the shard's primary reports in the 'opcounters' section
+ * of 'serverStatus', or NoSuchKey if there is no such section.
+ */
+StatusWith<long long> extractNumOps(const BSONObj& serverStatus) {
+    BSONElement opCounters;
+    Status status = bsonExtractTypedField(serverStatus, kOpCountersField, Object, &opCounters);
     if (!status.isOK()) {
         return status;
     }
 
-    return version;
+    long long numOps = 0;
+    for (const auto field : kOpCounterFields) {
+        numOps += opCounters.Obj()[field].safeNumberLong();
+    }
+    return numOps;
 }
 
 }  // namespace
@@ -134,15 +147,27 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
         }
 
         std::string mongoDVersion;
+        double opsPerSec = 0;
+
+        // Since the mongod version and the rate of operations are only used for reporting and to
+        // choose between otherwise equivalent shards, there is no need to fail the entire round if
+        // they cannot be retrieved, so just leave them empty
+        auto serverStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        if (serverStatus.isOK()) {
+            auto mongoDVersionStatus =
+                bsonExtractStringField(serverStatus.getValue(), kVersionField, &mongoDVersion);
+            if (!mongoDVersionStatus.isOK()) {
+                log() << "Unable to obtain shard version for " << shard.getName()
+                      << causedBy(mongoDVersionStatus);
+            }
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
-        if (mongoDVersionStatus.isOK()) {
-            mongoDVersion = std::move(mongoDVersionStatus.getValue());
+            auto numOps = extractNumOps(serverStatus.getValue());
+            if (numOps.isOK()) {
+                opsPerSec = _updateOpsPerSec(shard.getName(), numOps.getValue(), Date_t::now());
+            }
         } else {
-            // Since the mongod version is only used for reporting, there is no need to fail the
-            // entire round if it cannot be retrieved, so just leave it empty
             log() << "Unable to obtain shard version for " << shard.getName()
-                  << causedBy(mongoDVersionStatus.getStatus());
+                  << causedBy(serverStatus.getStatus());
         }
 
         std::set<std::string> shardTags;
@@ -157,9 +182,33 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+        stats.back().opsPerSec = opsPerSec;
     }
 
     return stats;
 }
 
+double ClusterStatisticsImpl::_updateOpsPerSec(const ShardId& shardId,
+                                               long long numOps,
+                                               Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _opCountersSamples.find(shardId);
+    if (it == _opCountersSamples.end()) {
+        _opCountersSamples.emplace(shardId, OpCountersSample{numOps, now});
+        return 0;
+    }
+
+    const auto previous = it->second;
+    it->second = {numOps, now};
+
+    // The counters start over when another node becomes the primary of the shard.
+    const auto elapsed = now - previous.time;
+    if (numOps < previous.numOps || elapsed <= Milliseconds(0)) {
+        return 0;
+    }
+
+    return (numOps - previous.numOps) * 1000.0 / durationCount<Milliseconds>(elapsed);
+}
+
 }  // namespace mongo
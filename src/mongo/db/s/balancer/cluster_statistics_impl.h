@@ -31,13 +31,17 @@
 
 #include "mongo/db/s/balancer/balancer_random.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
 /**
  * Default implementation for the cluster statistics gathering utility. Uses a blocking method to
- * fetch the statistics and does not perform any caching. If any of the shards fails to report
- * statistics fails the entire refresh.
+ * fetch the statistics and does not perform any caching, other than of the operation counters of
+ * the shards, from which it derives their rates of operations. If any of the shards fails to
+ * report statistics fails the entire refresh.
  */
 class ClusterStatisticsImpl final : public ClusterStatistics {
 public:
@@ -47,8 +51,30 @@ public:
     StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* opCtx) override;
 
 private:
+    /**
+     * The total number of operations a shard's primary reported having served, and when.
+     */
+    struct OpCountersSample {
+        long long numOps;
+        Date_t time;
+    };
+
+    /**
+     * Records 'numOps' as the current number of operations served by the given shard's primary,
+     * and returns the rate of operations since the previous sample of that shard, or zero if there
+     * is no usable previous sample.
+     */
+    double _updateOpsPerSec(const ShardId& shardId, long long numOps, Date_t now);
+
     // Source of randomness when metadata needs to be randomized.
     BalancerRandomSource& _random;
+
+    // Protects '_opCountersSamples', since the statistics may be fetched concurrently by the
+    // balancer and by the commands which move single chunks.
+    stdx::mutex _mutex;
+
+    // The last operation counters sample of each shard, from which the next rate is computed.
+    stdx::unordered_map<ShardId, OpCountersSample, ShardId::Hasher> _opCountersSamples;
 };
 
 }  // namespace mongo
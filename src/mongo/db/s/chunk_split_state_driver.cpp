@@ -86,4 +86,9 @@ void ChunkSplitStateDriver::commitSplit() {
     _splitState = SplitState::kSplitCommitted;
 }
 
+std::vector<BSONObj> ChunkSplitStateDriver::getSampledKeys() const {
+    auto wt = _writesTracker.lock();
+    return wt ? wt->getSampledKeys() : std::vector<BSONObj>();
+}
+
 }  // namespace mongo
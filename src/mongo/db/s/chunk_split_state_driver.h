@@ -96,6 +96,12 @@ public:
      */
     void commitSplit();
 
+    /**
+     * Returns the sample of the shard keys written to the chunk being split, or an empty sample
+     * if the chunk's metadata has changed since the split was initiated.
+     */
+    std::vector<BSONObj> getSampledKeys() const;
+
 private:
     /**
      * Should only be used by tryInitiateSplit
@@ -33,6 +33,8 @@
 
 #include "mongo/db/s/chunk_splitter.h"
 
+#include <algorithm>
+
 #include "mongo/client/dbclient_cursor.h"
 #include "mongo/client/query.h"
 #include "mongo/db/client.h"
@@ -40,6 +42,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/s/chunk_split_state_driver.h"
 #include "mongo/db/s/shard_filtering_metadata_refresh.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/split_chunk.h"
 #include "mongo/db/s/split_vector.h"
@@ -51,6 +54,7 @@
 #include "mongo/s/config_server_client.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/shard_key_pattern.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 
@@ -104,6 +108,33 @@ Status splitChunkAtMultiplePoints(OperationContext* opCtx,
     return status.getStatus().withContext("split failed");
 }
 
+/**
+ * Returns the median of the sampled shard keys which fall strictly inside the chunk [min, max), or
+ * boost::none if too few of them do for the median to be meaningful. Splitting at the median
+ * divides the writes to the chunk evenly between the two resulting chunks.
+ */
+boost::optional<BSONObj> findMedianSampledKey(std::vector<BSONObj> sampledKeys,
+                                              const BSONObj& min,
+                                              const BSONObj& max) {
+    const size_t kMinSampledKeys = 10;
+
+    const auto& comparator = SimpleBSONObjComparator::kInstance;
+    sampledKeys.erase(std::remove_if(sampledKeys.begin(),
+                                     sampledKeys.end(),
+                                     [&](const BSONObj& key) {
+                                         return comparator.evaluate(key <= min) ||
+                                             comparator.evaluate(key >= max);
+                                     }),
+                      sampledKeys.end());
+    if (sampledKeys.size() < kMinSampledKeys) {
+        return boost::none;
+    }
+
+    auto median = sampledKeys.begin() + sampledKeys.size() / 2;
+    std::nth_element(sampledKeys.begin(), median, sampledKeys.end(), comparator.makeLessThan());
+    return *median;
+}
+
 /**
  * Attempts to move the chunk specified by minKey away from its current shard.
  */
@@ -317,19 +348,39 @@ void ChunkSplitter::_runAutosplit(std::shared_ptr<ChunkSplitStateDriver> chunkSp
                << " dataWritten since last check: " << dataWritten
                << " maxChunkSizeBytes: " << maxChunkSizeBytes;
 
+        const auto skpGlobalMin = shardKeyPattern.getKeyPattern().globalMin();
+        const auto skpGlobalMax = shardKeyPattern.getKeyPattern().globalMax();
+
+        // The first and last chunks of the collection are left to the top chunk optimization
+        // below, since the writes to them are likely to go to their extreme keys.
+        boost::optional<BSONObj> sampledSplitPoint;
+        if (autoSplitFromSampledWriteKeys.load() && skpGlobalMin.woCompare(min) != 0 &&
+            skpGlobalMax.woCompare(max) != 0) {
+            sampledSplitPoint = findMedianSampledKey(
+                chunkSplitStateDriver->getSampledKeys(), chunk.getMin(), chunk.getMax());
+        }
+
         chunkSplitStateDriver->prepareSplit();
-        auto splitPoints = uassertStatusOK(splitVector(opCtx.get(),
-                                                       nss,
-                                                       shardKeyPattern.toBSON(),
-                                                       chunk.getMin(),
-                                                       chunk.getMax(),
-                                                       false,
-                                                       boost::none,
-                                                       boost::none,
-                                                       boost::none,
-                                                       maxChunkSizeBytes));
-
-        if (splitPoints.size() <= 1) {
+        std::vector<BSONObj> splitPoints;
+        if (sampledSplitPoint) {
+            LOG(1) << "splitting " << redact(chunk.toString())
+                   << " at the median of the sampled written keys "
+                   << redact(sampledSplitPoint->toString());
+            splitPoints.push_back(*sampledSplitPoint);
+        } else {
+            splitPoints = uassertStatusOK(splitVector(opCtx.get(),
+                                                      nss,
+                                                      shardKeyPattern.toBSON(),
+                                                      chunk.getMin(),
+                                                      chunk.getMax(),
+                                                      false,
+                                                      boost::none,
+                                                      boost::none,
+                                                      boost::none,
+                                                      maxChunkSizeBytes));
+        }
+
+        if (!sampledSplitPoint && splitPoints.size() <= 1) {
             LOG(1)
                 << "ChunkSplitter attempted split but not enough split points were found for chunk "
                 << redact(chunk.toString());
@@ -350,8 +401,6 @@ void ChunkSplitter::_runAutosplit(std::shared_ptr<ChunkSplitStateDriver> chunkSp
 
         // Keeps track of the minKey of the top chunk after the split so we can migrate the chunk.
         BSONObj topChunkMinKey;
-        const auto skpGlobalMin = shardKeyPattern.getKeyPattern().globalMin();
-        const auto skpGlobalMax = shardKeyPattern.getKeyPattern().globalMax();
         if (KeyPattern::isOrderedKeyPattern(shardKeyPattern.toBSON())) {
             if (skpGlobalMin.woCompare(min) == 0) {
                 // MinKey is infinity (This is the first chunk on the collection)
@@ -51,6 +51,7 @@
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_runtime.h"
 #include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_state.h"
@@ -74,6 +75,35 @@ const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 WriteConcernOptions::kWriteConcernTimeoutSharding);
 
+// How long to defer the next batch of deletions while the majority commit point lags too far
+// behind.
+const Milliseconds kMajorityLagBackoff{1000};
+
+/**
+ * Returns when the next batch of deletions from the range being cleaned in 'nss' should start.
+ * This is 'rangeDeleterBatchDelayMS' after now, unless 'rangeDeleterMaxMajorityLagSecs' is set and
+ * the majority commit point lags further behind this node's last applied optime, in which case the
+ * next batch is deferred so that the secondaries can catch up.
+ */
+Date_t whenToDeleteNextBatch(OperationContext* opCtx, const NamespaceString& nss) {
+    auto delay = Milliseconds(rangeDeleterBatchDelayMS.load());
+
+    const auto maxLagSecs = rangeDeleterMaxMajorityLagSecs.load();
+    auto* const replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (maxLagSecs > 0 && replCoord->isReplEnabled()) {
+        const auto lastApplied = replCoord->getMyLastAppliedOpTime().getTimestamp();
+        const auto lastCommitted = replCoord->getLastCommittedOpTime().getTimestamp();
+        if (lastApplied.getSecs() > lastCommitted.getSecs() + maxLagSecs) {
+            LOG(1) << "Deferring the next batch of deletions in " << nss.ns()
+                   << " because the majority commit point is "
+                   << lastApplied.getSecs() - lastCommitted.getSecs() << " seconds behind";
+            delay = std::max(delay, kMajorityLagBackoff);
+        }
+    }
+
+    return Date_t::now() + delay;
+}
+
 MONGO_FAIL_POINT_DEFINE(hangBeforeDoingDeletion);
 
 boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& deletions,
@@ -294,7 +324,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     invariant(continueDeleting);
 
     notification.abandon();
-    return Date_t::now() + Milliseconds(rangeDeleterBatchDelayMS.load());
+    return whenToDeleteNextBatch(opCtx, nss);
 }
 
 bool CollectionRangeDeleter::_checkCollectionMetadataStillValid(
@@ -40,12 +40,14 @@
 #include "mongo/db/keypattern.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/s/collection_sharding_runtime.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -232,6 +234,33 @@ TEST_F(CollectionRangeDeleterTest, MultipleCleanupNextRangeCalls) {
     ASSERT_EQUALS(0ULL, dbclient.count(kAdminSysVer.ns(), BSON(kShardKey << "startRangeDeletion")));
 }
 
+// Tests that the next batch of deletions is deferred while the majority commit point lags behind
+// by more than 'rangeDeleterMaxMajorityLagSecs'.
+TEST_F(CollectionRangeDeleterTest, NextBatchIsDeferredWhileMajorityLags) {
+    rangeDeleterMaxMajorityLagSecs.store(10);
+    ON_BLOCK_EXIT([] { rangeDeleterMaxMajorityLagSecs.store(0); });
+
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    dbclient.insert(kNss.toString(), BSON(kShardKey << 1));
+    dbclient.insert(kNss.toString(), BSON(kShardKey << 2));
+
+    std::list<Deletion> ranges;
+    ranges.emplace_back(
+        Deletion{ChunkRange(BSON(kShardKey << 0), BSON(kShardKey << 10)), Date_t{}});
+    rangeDeleter.add(std::move(ranges));
+
+    // The mock never advances the majority commit point past the null optime.
+    replicationCoordinator()->setMyLastAppliedOpTimeAndWallTime(
+        {repl::OpTime(Timestamp(100, 1), 1), Date_t()});
+
+    const auto before = Date_t::now();
+    auto when = next(rangeDeleter, 1);
+    ASSERT(when);
+    ASSERT_GTE(*when, before + Seconds(1));
+    ASSERT_EQUALS(1ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 5)));
+}
+
 // Tests the case that there are two ranges to clean, each containing multiple documents.
 TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInMultipleRangesToClean) {
     CollectionRangeDeleter rangeDeleter;
@@ -379,51 +379,65 @@ Status MigrationDestinationManager::start(OperationContext* opCtx,
 void MigrationDestinationManager::cloneDocumentsFromDonor(
     OperationContext* opCtx,
     std::function<void(OperationContext*, BSONObj)> insertBatchFn,
-    std::function<BSONObj(OperationContext*)> fetchBatchFn) {
+    std::function<BSONObj(OperationContext*)> fetchBatchFn,
+    int numInserterThreads) {
+    invariant(numInserterThreads > 0);
 
-    SingleProducerSingleConsumerQueue<BSONObj>::Options options;
-    options.maxQueueDepth = 1;
+    // Each inserter thread may have one fetched batch waiting for it, so that the fetching of the
+    // next batches from the donor overlaps with the insertion of the previous ones.
+    MultiProducerMultiConsumerQueue<BSONObj>::Options options;
+    options.maxQueueDepth = numInserterThreads;
 
-    SingleProducerSingleConsumerQueue<BSONObj> batches(options);
+    MultiProducerMultiConsumerQueue<BSONObj> batches(options);
 
-    stdx::thread inserterThread{[&] {
-        ThreadClient tc("chunkInserter", opCtx->getServiceContext());
-        auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
-        auto consumerGuard = makeGuard([&] { batches.closeConsumerEnd(); });
-        try {
-            while (true) {
-                auto nextBatch = batches.pop(inserterOpCtx.get());
-                auto arr = nextBatch["objects"].Obj();
-                if (arr.isEmpty()) {
-                    return;
-                }
-                insertBatchFn(inserterOpCtx.get(), arr);
-            }
-        } catch (...) {
-            stdx::lock_guard<Client> lk(*opCtx->getClient());
-            opCtx->getServiceContext()->killOperation(lk, opCtx, ErrorCodes::Error(51008));
-            log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
-        }
-    }};
-    auto inserterThreadJoinGuard = makeGuard([&] {
+    std::vector<stdx::thread> inserterThreads;
+    auto inserterThreadsJoinGuard = makeGuard([&] {
         batches.closeProducerEnd();
-        inserterThread.join();
+        for (auto& inserterThread : inserterThreads) {
+            inserterThread.join();
+        }
     });
 
+    for (int i = 0; i < numInserterThreads; ++i) {
+        inserterThreads.emplace_back([&] {
+            ThreadClient tc("chunkInserter", opCtx->getServiceContext());
+            auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
+            auto consumerGuard = makeGuard([&] { batches.closeConsumerEnd(); });
+            try {
+                while (true) {
+                    auto nextBatch = batches.pop(inserterOpCtx.get());
+                    insertBatchFn(inserterOpCtx.get(), nextBatch["objects"].Obj());
+                }
+            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueConsumed>&) {
+                // All of the batches have been fetched and inserted.
+                consumerGuard.dismiss();
+            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+                // Another inserter thread failed, and has already interrupted the migration.
+            } catch (...) {
+                stdx::lock_guard<Client> lk(*opCtx->getClient());
+                opCtx->getServiceContext()->killOperation(lk, opCtx, ErrorCodes::Error(51008));
+                log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
+            }
+        });
+    }
+
     while (true) {
         opCtx->checkForInterrupt();
 
         auto res = fetchBatchFn(opCtx);
 
         opCtx->checkForInterrupt();
-        batches.push(res.getOwned(), opCtx);
         auto arr = res["objects"].Obj();
         if (arr.isEmpty()) {
-            inserterThreadJoinGuard.dismiss();
-            inserterThread.join();
+            inserterThreadsJoinGuard.dismiss();
+            batches.closeProducerEnd();
+            for (auto& inserterThread : inserterThreads) {
+                inserterThread.join();
+            }
             opCtx->checkForInterrupt();
             break;
         }
+        batches.push(res.getOwned(), opCtx);
     }
 }
 
@@ -861,7 +875,8 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx) {
             return res.response;
         };
 
-        cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn);
+        cloneDocumentsFromDonor(
+            opCtx, insertBatchFn, fetchBatchFn, migrateCloneInsertionThreads.load());
 
         timing.done(3);
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
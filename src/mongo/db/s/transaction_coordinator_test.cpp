@@ -38,10 +38,12 @@
 #include "mongo/db/s/server_transaction_coordinators_metrics.h"
 #include "mongo/db/s/transaction_coordinator_document_gen.h"
 #include "mongo/db/s/transaction_coordinator_metrics_observer.h"
+#include "mongo/db/s/transaction_coordinator_params_gen.h"
 #include "mongo/db/s/transaction_coordinator_test_fixture.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/tick_source_mock.h"
 
 namespace mongo {
@@ -646,6 +648,39 @@ TEST_F(TransactionCoordinatorDriverPersistenceTest,
     assertDocumentMatches(allCoordinatorDocs[0], _lsid, txnNumber2, _participants);
 }
 
+TEST_F(TransactionCoordinatorDriverPersistenceTest,
+       GroupedStateWritesPersistEveryCoordinatorState) {
+    coordinatorGroupStateWrites.store(true);
+    ON_BLOCK_EXIT([] { coordinatorGroupStateWrites.store(false); });
+
+    persistParticipantListExpectSuccess(operationContext(), _lsid, _txnNumber, _participants);
+    persistDecisionExpectSuccess(
+        operationContext(), _lsid, _txnNumber, _participants, _commitTimestamp /* commit */);
+
+    // Coordinators which write at the same time each find their own document persisted.
+    std::vector<LogicalSessionId> lsids;
+    std::vector<Future<void>> futures;
+    for (int i = 0; i < 5; i++) {
+        lsids.push_back(makeLogicalSessionIdForTest());
+        futures.push_back(
+            txn::persistParticipantsList(*_aws, lsids.back(), _txnNumber, _participants));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+
+    auto allCoordinatorDocs = txn::readAllCoordinatorDocs(operationContext());
+    ASSERT_EQUALS(allCoordinatorDocs.size(), size_t(6));
+    for (const auto& lsid : lsids) {
+        ASSERT_EQUALS(1,
+                      std::count_if(allCoordinatorDocs.begin(),
+                                    allCoordinatorDocs.end(),
+                                    [&](const TransactionCoordinatorDocument& doc) {
+                                        return doc.getId().getSessionId() == lsid;
+                                    }));
+    }
+}
+
 
 using TransactionCoordinatorTest = TransactionCoordinatorTestBase;
 
@@ -33,12 +33,16 @@
 
 #include "mongo/db/s/transaction_coordinator_util.h"
 
+#include <algorithm>
+
 #include "mongo/client/remote_command_retry_scheduler.h"
 #include "mongo/db/commands/txn_cmds_gen.h"
 #include "mongo/db/commands/txn_two_phase_commit_cmds_gen.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/s/transaction_coordinator_params_gen.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/util/fail_point_service.h"
@@ -97,6 +101,154 @@ bool shouldRetryPersistingCoordinatorState(const Status& responseStatus) {
         responseStatus != ErrorCodes::TransactionCoordinatorSteppingDown;
 }
 
+/**
+ * Groups the writes of coordinators which persist their state at the same time into one update
+ * command against config.transaction_coordinators, followed by one wait for majority write concern
+ * on behalf of all of them. The first waiting writer runs a batch with its own operation context,
+ * while the others wait for its outcome; writes which arrive while a batch runs make up the next.
+ */
+class CoordinatorStateWriteGroup {
+public:
+    static CoordinatorStateWriteGroup& get(ServiceContext* service);
+
+    /**
+     * Returns true once 'entry' has matched or upserted its document and the write is majority
+     * committed. Returns false if the grouped write could not confirm that, in which case the
+     * caller should run the write on its own to find out why.
+     */
+    bool write(OperationContext* opCtx, write_ops::UpdateOpEntry entry);
+
+private:
+    struct PendingWrite {
+        write_ops::UpdateOpEntry entry;
+        bool done{false};
+        bool applied{false};
+    };
+
+    using Batch = std::vector<std::shared_ptr<PendingWrite>>;
+
+    /**
+     * Runs the updates of 'batch' as one unordered update command and waits for majority write
+     * concern. Returns whether every update matched or upserted its document.
+     */
+    static bool _runBatch(OperationContext* opCtx, const Batch& batch);
+
+    stdx::mutex _mutex;
+
+    // Notified every time a batch completes
+    stdx::condition_variable _batchDoneCV;
+
+    // Writes which have not been taken by a batch yet, in arrival order
+    Batch _pending;
+
+    // Whether some writer is running a batch
+    bool _batchInProgress{false};
+};
+
+const auto getCoordinatorStateWriteGroup =
+    ServiceContext::declareDecoration<CoordinatorStateWriteGroup>();
+
+CoordinatorStateWriteGroup& CoordinatorStateWriteGroup::get(ServiceContext* service) {
+    return getCoordinatorStateWriteGroup(service);
+}
+
+bool CoordinatorStateWriteGroup::write(OperationContext* opCtx, write_ops::UpdateOpEntry entry) {
+    auto pendingWrite = std::make_shared<PendingWrite>();
+    pendingWrite->entry = std::move(entry);
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _pending.push_back(pendingWrite);
+
+    while (true) {
+        auto waitStatus = opCtx->waitForConditionOrInterruptNoAssert(
+            _batchDoneCV, lk, [&] { return pendingWrite->done || !_batchInProgress; });
+        if (!waitStatus.isOK()) {
+            // Withdraw the write if no batch has taken it yet. A batch which already runs it is
+            // harmless, because the caller's retry will match the same document.
+            auto it = std::find(_pending.begin(), _pending.end(), pendingWrite);
+            if (it != _pending.end()) {
+                _pending.erase(it);
+            }
+            uassertStatusOK(waitStatus);
+        }
+
+        if (pendingWrite->done) {
+            return pendingWrite->applied;
+        }
+
+        // No batch is running and this write has not been taken by one, so run the next batch on
+        // behalf of every pending writer.
+        const auto maxBatchSize = size_t(coordinatorGroupStateWritesMaxBatchSize.load());
+        Batch batch;
+        if (_pending.size() <= maxBatchSize) {
+            batch.swap(_pending);
+        } else {
+            batch.assign(_pending.begin(), _pending.begin() + maxBatchSize);
+            _pending.erase(_pending.begin(), _pending.begin() + maxBatchSize);
+        }
+        _batchInProgress = true;
+        lk.unlock();
+
+        bool applied;
+        try {
+            applied = _runBatch(opCtx, batch);
+        } catch (const DBException& ex) {
+            // The writers whose updates were in the batch retry them on their own, so that an
+            // interruption of this operation does not fail theirs.
+            LOG(3) << "Failed to write a group of " << batch.size()
+                   << " coordinator state updates: " << redact(ex.toStatus());
+            applied = false;
+        }
+
+        lk.lock();
+        for (auto& write : batch) {
+            write->done = true;
+            write->applied = applied;
+        }
+        _batchInProgress = false;
+        _batchDoneCV.notify_all();
+    }
+}
+
+bool CoordinatorStateWriteGroup::_runBatch(OperationContext* opCtx, const Batch& batch) {
+    DBDirectClient client(opCtx);
+
+    // Throws if serializing the request or deserializing the response fails.
+    const auto commandResponse = client.runCommand([&] {
+        write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
+        updateOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase wcb;
+            wcb.setOrdered(false);
+            return wcb;
+        }());
+        std::vector<write_ops::UpdateOpEntry> updates;
+        updates.reserve(batch.size());
+        for (const auto& write : batch) {
+            updates.push_back(write->entry);
+        }
+        updateOp.setUpdates(std::move(updates));
+        return updateOp.serialize({});
+    }());
+
+    // Every update queries a single document by _id, so the updates all succeeded exactly when
+    // as many documents were matched or upserted as there were updates.
+    const auto commandReply = commandResponse->getCommandReply();
+    if (!getStatusFromWriteCommandReply(commandReply).isOK() ||
+        commandReply.getIntField("n") != int(batch.size())) {
+        return false;
+    }
+
+    LOG(3) << "Wrote a group of " << batch.size() << " coordinator state updates";
+
+    WriteConcernResult unusedWCResult;
+    uassertStatusOK(
+        waitForWriteConcern(opCtx,
+                            repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp(),
+                            kMajorityWriteConcern,
+                            &unusedWCResult));
+    return true;
+}
+
 }  // namespace
 
 namespace {
@@ -115,35 +267,44 @@ void persistParticipantListBlocking(OperationContext* opCtx,
     sessionInfo.setSessionId(lsid);
     sessionInfo.setTxnNumber(txnNumber);
 
+    const auto updateEntry = [&] {
+        write_ops::UpdateOpEntry entry;
+
+        // Ensure that the document for the (lsid, txnNumber) either has no participant list or
+        // has the same participant list. The document may have the same participant list if an
+        // earlier attempt to write the participant list failed waiting for writeConcern.
+        BSONObj noParticipantList = BSON(TransactionCoordinatorDocument::kParticipantsFieldName
+                                         << BSON("$exists" << false));
+        BSONObj sameParticipantList =
+            BSON("$and" << buildParticipantListMatchesConditions(participantList));
+        entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
+                        << sessionInfo.toBSON()
+                        << "$or"
+                        << BSON_ARRAY(noParticipantList << sameParticipantList)));
+
+        // Update with participant list.
+        TransactionCoordinatorDocument doc;
+        doc.setId(std::move(sessionInfo));
+        doc.setParticipants(std::move(participantList));
+        entry.setU(doc.toBSON());
+
+        entry.setUpsert(true);
+        return entry;
+    }();
+
+    if (coordinatorGroupStateWrites.load() &&
+        CoordinatorStateWriteGroup::get(opCtx->getServiceContext()).write(opCtx, updateEntry)) {
+        LOG(3) << "Wrote participant list for " << lsid.getId() << ':' << txnNumber
+               << " as part of a group";
+        return;
+    }
+
     DBDirectClient client(opCtx);
 
     // Throws if serializing the request or deserializing the response fails.
     const auto commandResponse = client.runCommand([&] {
         write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
-        updateOp.setUpdates({[&] {
-            write_ops::UpdateOpEntry entry;
-
-            // Ensure that the document for the (lsid, txnNumber) either has no participant list or
-            // has the same participant list. The document may have the same participant list if an
-            // earlier attempt to write the participant list failed waiting for writeConcern.
-            BSONObj noParticipantList = BSON(TransactionCoordinatorDocument::kParticipantsFieldName
-                                             << BSON("$exists" << false));
-            BSONObj sameParticipantList =
-                BSON("$and" << buildParticipantListMatchesConditions(participantList));
-            entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
-                            << sessionInfo.toBSON()
-                            << "$or"
-                            << BSON_ARRAY(noParticipantList << sameParticipantList)));
-
-            // Update with participant list.
-            TransactionCoordinatorDocument doc;
-            doc.setId(std::move(sessionInfo));
-            doc.setParticipants(std::move(participantList));
-            entry.setU(doc.toBSON());
-
-            entry.setUpsert(true);
-            return entry;
-        }()});
+        updateOp.setUpdates({updateEntry});
         return updateOp.serialize({});
     }());
 
@@ -300,54 +461,63 @@ void persistDecisionBlocking(OperationContext* opCtx,
     sessionInfo.setSessionId(lsid);
     sessionInfo.setTxnNumber(txnNumber);
 
+    const auto updateEntry = [&] {
+        write_ops::UpdateOpEntry entry;
+
+        // Ensure that the document for the (lsid, txnNumber) has the same participant list and
+        // either has no decision or the same decision. The document may have the same decision
+        // if an earlier attempt to write the decision failed waiting for writeConcern.
+        BSONObj noDecision = BSON(TransactionCoordinatorDocument::kDecisionFieldName
+                                  << BSON("$exists" << false));
+        BSONObj sameDecision;
+        if (commitTimestamp) {
+            sameDecision = BSON(TransactionCoordinatorDocument::kDecisionFieldName
+                                << BSON(TransactionCoordinatorDocument::kDecisionFieldName
+                                        << "commit"
+                                        << "commitTimestamp"
+                                        << *commitTimestamp));
+        } else {
+            sameDecision =
+                BSON(TransactionCoordinatorDocument::kDecisionFieldName
+                     << BSON(TransactionCoordinatorDocument::kDecisionFieldName << "abort"));
+        }
+        entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
+                        << sessionInfo.toBSON()
+                        << "$and"
+                        << buildParticipantListMatchesConditions(participantList)
+                        << "$or"
+                        << BSON_ARRAY(noDecision << sameDecision)));
+
+        // Update with decision.
+        TransactionCoordinatorDocument doc;
+        doc.setId(sessionInfo);
+        doc.setParticipants(std::move(participantList));
+        txn::CoordinatorCommitDecision decision;
+        if (commitTimestamp) {
+            decision.setDecision(CommitDecision::kCommit);
+            decision.setCommitTimestamp(commitTimestamp);
+        } else {
+            decision.setDecision(CommitDecision::kAbort);
+        }
+        doc.setDecision(decision);
+        entry.setU(doc.toBSON());
+
+        return entry;
+    }();
+
+    if (coordinatorGroupStateWrites.load() &&
+        CoordinatorStateWriteGroup::get(opCtx->getServiceContext()).write(opCtx, updateEntry)) {
+        LOG(3) << "Wrote decision " << (commitTimestamp ? "commit" : "abort") << " for "
+               << lsid.getId() << ':' << txnNumber << " as part of a group";
+        return;
+    }
+
     DBDirectClient client(opCtx);
 
     // Throws if serializing the request or deserializing the response fails.
     const auto commandResponse = client.runCommand([&] {
         write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
-        updateOp.setUpdates({[&] {
-            write_ops::UpdateOpEntry entry;
-
-            // Ensure that the document for the (lsid, txnNumber) has the same participant list and
-            // either has no decision or the same decision. The document may have the same decision
-            // if an earlier attempt to write the decision failed waiting for writeConcern.
-            BSONObj noDecision = BSON(TransactionCoordinatorDocument::kDecisionFieldName
-                                      << BSON("$exists" << false));
-            BSONObj sameDecision;
-            if (commitTimestamp) {
-                sameDecision = BSON(TransactionCoordinatorDocument::kDecisionFieldName
-                                    << BSON(TransactionCoordinatorDocument::kDecisionFieldName
-                                            << "commit"
-                                            << "commitTimestamp"
-                                            << *commitTimestamp));
-            } else {
-                sameDecision =
-                    BSON(TransactionCoordinatorDocument::kDecisionFieldName
-                         << BSON(TransactionCoordinatorDocument::kDecisionFieldName << "abort"));
-            }
-            entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
-                            << sessionInfo.toBSON()
-                            << "$and"
-                            << buildParticipantListMatchesConditions(participantList)
-                            << "$or"
-                            << BSON_ARRAY(noDecision << sameDecision)));
-
-            // Update with decision.
-            TransactionCoordinatorDocument doc;
-            doc.setId(sessionInfo);
-            doc.setParticipants(std::move(participantList));
-            txn::CoordinatorCommitDecision decision;
-            if (commitTimestamp) {
-                decision.setDecision(CommitDecision::kCommit);
-                decision.setCommitTimestamp(commitTimestamp);
-            } else {
-                decision.setDecision(CommitDecision::kAbort);
-            }
-            doc.setDecision(decision);
-            entry.setU(doc.toBSON());
-
-            return entry;
-        }()});
+        updateOp.setUpdates({updateEntry});
         return updateOp.serialize({});
     }());
 
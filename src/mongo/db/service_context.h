@@ -45,6 +45,7 @@
 #include "mongo/transport/service_executor.h"
 #include "mongo/transport/session.h"
 #include "mongo/util/clock_source.h"
+#include "mongo/util/concurrency/adaptive_mutex.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/decorable.h"
 #include "mongo/util/periodic_runner.h"
@@ -163,7 +164,7 @@ public:
         Client* next();
 
     private:
-        stdx::unique_lock<stdx::mutex> _lock;
+        stdx::unique_lock<AdaptiveMutex> _lock;
         ClientSet::const_iterator _curr;
         ClientSet::const_iterator _end;
     };
@@ -530,7 +531,7 @@ private:
         std::unique_ptr<ClientObserver> _observer;
     };
 
-    stdx::mutex _mutex;
+    AdaptiveMutex _mutex{"ServiceContext"};
 
     /**
      * The storage engine, if any.
@@ -591,7 +592,7 @@ private:
     AtomicWord<unsigned> _nextOpId{1};
 
     bool _startupComplete = false;
-    stdx::condition_variable _startupCompleteCondVar;
+    stdx::condition_variable_any _startupCompleteCondVar;
 };
 
 /**
@@ -61,6 +61,7 @@
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/ops/write_ops_exec.h"
 #include "mongo/db/query/find.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/read_concern.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/read_concern_args.h"
@@ -730,6 +731,7 @@ void execCommandDatabase(OperationContext* opCtx,
 
         if (command->adminOnly()) {
             LOG(2) << "command: " << request.getCommandName();
+            opCtx->lockState()->setAdminOperation(true);
         }
 
         if (command->maintenanceMode()) {
@@ -921,6 +923,7 @@ void curOpCommandSetup(OperationContext* opCtx, const OpMsgRequest& request) {
 DbResponse receivedCommands(OperationContext* opCtx,
                             const Message& message,
                             const ServiceEntryPointCommon::Hooks& behaviors) {
+    BufBuilderPoolScope bufBuilderPool(internalBufBuilderPoolMaxBytes.load());
     auto replyBuilder = rpc::makeReplyBuilder(rpc::protocolForMessage(message));
     OpMsgRequest request;
     [&] {
@@ -1335,11 +1338,12 @@ DbResponse ServiceEntryPointCommon::handleRequest(OperationContext* opCtx,
     const bool shouldSample = currentOp.completeAndLogOperation(
         opCtx, MONGO_LOG_DEFAULT_COMPONENT, dbresponse.response.size(), slowMsOverride, forceLog);
 
-    Top::get(opCtx->getServiceContext())
-        .incrementGlobalLatencyStats(
-            opCtx,
-            durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses()),
-            currentOp.getReadWriteType());
+    const auto latencyMicros = durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses());
+    auto& top = Top::get(opCtx->getServiceContext());
+    top.incrementGlobalLatencyStats(opCtx, latencyMicros, currentOp.getReadWriteType());
+    if (auto command = currentOp.getCommand()) {
+        top.incrementCommandLatencyStats(opCtx, command->getName(), latencyMicros);
+    }
 
     if (currentOp.shouldDBProfile(shouldSample)) {
         // Performance profiling is on
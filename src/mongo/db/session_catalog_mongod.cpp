@@ -41,6 +41,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/ops/write_ops.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/session_txn_record_gen.h"
 #include "mongo/db/sessions_collection.h"
@@ -174,7 +175,7 @@ int removeSessionsTransactionRecords(OperationContext* opCtx,
     return response.getN();
 }
 
-void createTransactionTable(OperationContext* opCtx) {
+void createRetryableWritesCollection(OperationContext* opCtx, const NamespaceString& nss) {
     const size_t initialExtentSize = 0;
     const bool capped = false;
     const bool maxSize = 0;
@@ -182,11 +183,7 @@ void createTransactionTable(OperationContext* opCtx) {
 
     DBDirectClient client(opCtx);
 
-    if (client.createCollection(NamespaceString::kSessionTransactionsTableNamespace.ns(),
-                                initialExtentSize,
-                                capped,
-                                maxSize,
-                                &result)) {
+    if (client.createCollection(nss.ns(), initialExtentSize, capped, maxSize, &result)) {
         return;
     }
 
@@ -196,11 +193,8 @@ void createTransactionTable(OperationContext* opCtx) {
         return;
     }
 
-    uassertStatusOKWithContext(status,
-                               str::stream()
-                                   << "Failed to create the "
-                                   << NamespaceString::kSessionTransactionsTableNamespace.ns()
-                                   << " collection");
+    uassertStatusOKWithContext(
+        status, str::stream() << "Failed to create the " << nss.ns() << " collection");
 }
 
 void abortInProgressTransactions(OperationContext* opCtx) {
@@ -269,7 +263,10 @@ void MongoDSessionCatalog::onStepUp(OperationContext* opCtx) {
 
     abortInProgressTransactions(opCtx);
 
-    createTransactionTable(opCtx);
+    createRetryableWritesCollection(opCtx, NamespaceString::kSessionTransactionsTableNamespace);
+    if (repl::storeFindAndModifyImagesInSideCollection) {
+        createRetryableWritesCollection(opCtx, NamespaceString::kConfigImagesNamespace);
+    }
 }
 
 boost::optional<UUID> MongoDSessionCatalog::getTransactionTableUUID(OperationContext* opCtx) {
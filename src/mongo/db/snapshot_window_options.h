@@ -99,6 +99,13 @@ struct SnapshotWindowParams {
         decreaseHistoryIfNotNeededPeriodSeconds)::WordType>
         observeDecreaseHistoryIfNotNeededPeriodSeconds;
 
+    // snapshotWindowMaxCacheDirtyRatio (startup & runtime server parameter, range [0, 1]).
+    //
+    // When positive, the task that checks for cache pressure also treats a cache holding more than
+    // this fraction of dirty data as under pressure, so that the window shrinks before the cache
+    // overflows to disk.
+    AtomicDouble snapshotWindowMaxCacheDirtyRatio{0};
+
     AtomicWord<long long> snapshotTooOldErrorCount{0};
 };
 
@@ -126,10 +126,15 @@ void decreaseTargetSnapshotWindowSize(OperationContext* opCtx) {
         auto currentInsertsCount = engine->getCacheOverflowTableInsertCount(opCtx);
         auto currentSnapshotErrorCount = snapshotWindowParams.snapshotTooOldErrorCount.load();
 
-        // Only decrease the snapshot window size if there were writes to the cache overflow table
-        // and there has been no new SnapshotTooOld errors in the same time period.
-        if (currentInsertsCount > lastInsertsCount &&
-            currentSnapshotErrorCount == lastSnapshotErrorCount) {
+        // Writes to the cache overflow table, or, when a limit is set, a cache holding too much
+        // dirty data, mean that the history we keep is putting the cache under pressure.
+        const auto maxDirtyRatio = snapshotWindowParams.snapshotWindowMaxCacheDirtyRatio.load();
+        const bool cacheUnderPressure = currentInsertsCount > lastInsertsCount ||
+            (maxDirtyRatio > 0 && engine->getCacheDirtyRatio(opCtx) > maxDirtyRatio);
+
+        // Only decrease the snapshot window size if the cache is under pressure and there has been
+        // no new SnapshotTooOld errors in the same time period.
+        if (cacheUnderPressure && currentSnapshotErrorCount == lastSnapshotErrorCount) {
             _decreaseTargetSnapshotWindowSize(lock, opCtx);
         }
 
@@ -37,6 +37,7 @@
 #include "mongo/db/snapshot_window_options.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -197,5 +198,40 @@ TEST_F(SnapshotWindowTest, DecreaseAndIncreaseSnapshotWindow) {
     ASSERT_EQ(snapshotWindowSecondsEight, maxTargetSnapshotWindowSeconds);
 }
 
+TEST_F(SnapshotWindowTest, DecreaseSnapshotWindowWhenCacheIsDirty) {
+    auto engine = getServiceContext()->getStorageEngine();
+    invariant(engine);
+
+    snapshotWindowParams.maxTargetSnapshotHistoryWindowInSeconds.store(100);
+    snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.store(100);
+    snapshotWindowParams.snapshotWindowMultiplicativeDecrease.store(0.5);
+    snapshotWindowParams.snapshotWindowMaxCacheDirtyRatio.store(0.2);
+    ON_BLOCK_EXIT([] { snapshotWindowParams.snapshotWindowMaxCacheDirtyRatio.store(0); });
+
+    // Start from no new cache overflow writes or SnapshotTooOld errors.
+    engine->setCacheOverflowTableInsertCountForTest(0);
+    decreaseTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(100, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+
+    // A cache with less dirty data than the limit is not under pressure.
+    engine->setCacheDirtyRatioForTest(0.1);
+    decreaseTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(100, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+
+    engine->setCacheDirtyRatioForTest(0.5);
+    decreaseTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(50, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+
+    // SnapshotTooOld errors still keep the window from shrinking.
+    incrementSnapshotTooOldErrorCount();
+    decreaseTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(50, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+
+    // Without a limit, only writes to the cache overflow table count as pressure.
+    snapshotWindowParams.snapshotWindowMaxCacheDirtyRatio.store(0);
+    decreaseTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(50, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+}
+
 }  // namespace
 }  // namespace mongo
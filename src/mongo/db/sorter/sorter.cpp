@@ -51,6 +51,7 @@
 #include <boost/filesystem/operations.hpp>
 #include <snappy.h>
 #include <vector>
+#include <zstd.h>
 
 #include "mongo/base/string_data.h"
 #include "mongo/config.h"
@@ -158,8 +159,10 @@ public:
     FileIterator(const std::string& fileName,
                  std::streampos fileStartOffset,
                  std::streampos fileEndOffset,
-                 const Settings& settings)
+                 const Settings& settings,
+                 SortOptions::Compressor compressor)
         : _settings(settings),
+          _compressor(compressor),
           _done(false),
           _fileName(fileName),
           _fileStartOffset(fileStartOffset),
@@ -263,6 +266,11 @@ private:
             return;
         }
 
+        if (_compressor == SortOptions::Compressor::kZstd) {
+            fillBufferFromZstdBlock(blockSize);
+            return;
+        }
+
         dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
 
         size_t uncompressedSize;
@@ -280,6 +288,30 @@ private:
         _bufferReader.reset(new BufReader(_buffer.get(), uncompressedSize));
     }
 
+    /**
+     * Decompresses the zstd compressed block of 'blockSize' bytes in _buffer and places the result
+     * in _bufferReader.
+     */
+    void fillBufferFromZstdBlock(int32_t blockSize) {
+        const unsigned long long uncompressedSize =
+            ZSTD_getFrameContentSize(_buffer.get(), blockSize);
+        uassert(51317,
+                "couldn't get uncompressed length",
+                uncompressedSize != ZSTD_CONTENTSIZE_UNKNOWN &&
+                    uncompressedSize != ZSTD_CONTENTSIZE_ERROR);
+
+        std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
+        const size_t result = ZSTD_decompress(
+            decompressionBuffer.get(), uncompressedSize, _buffer.get(), blockSize);
+        uassert(51318,
+                str::stream() << "decompression failed: " << ZSTD_getErrorName(result),
+                !ZSTD_isError(result) && result == uncompressedSize);
+
+        // hold on to decompressed data and throw out compressed data at block exit
+        _buffer.swap(decompressionBuffer);
+        _bufferReader.reset(new BufReader(_buffer.get(), uncompressedSize));
+    }
+
     /**
      * Attempts to read data from disk. Sets _done to true when file offset reaches _fileEndOffset.
      *
@@ -309,6 +341,7 @@ private:
     }
 
     const Settings _settings;
+    const SortOptions::Compressor _compressor;
     bool _done;
     std::unique_ptr<char[]> _buffer;
     std::unique_ptr<BufReader> _bufferReader;
@@ -902,7 +935,7 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts,
                                                const std::string& fileName,
                                                const std::streampos fileStartOffset,
                                                const Settings& settings)
-    : _settings(settings) {
+    : _settings(settings), _compressor(opts.spillCompressor) {
 
     // This should be checked by consumers, but if we get here don't allow writes.
     uassert(
@@ -951,7 +984,17 @@ void SortedFileWriter<Key, Value>::spill() {
         return;
 
     std::string compressed;
-    snappy::Compress(outBuffer, size, &compressed);
+    if (_compressor == SortOptions::Compressor::kZstd) {
+        compressed.resize(ZSTD_compressBound(size));
+        const size_t result = ZSTD_compress(
+            &compressed[0], compressed.size(), outBuffer, size, ZSTD_CLEVEL_DEFAULT);
+        uassert(51319,
+                str::stream() << "Failed to compress data: " << ZSTD_getErrorName(result),
+                !ZSTD_isError(result));
+        compressed.resize(result);
+    } else {
+        snappy::Compress(outBuffer, size, &compressed);
+    }
     verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
 
     const bool shouldCompress = compressed.size() < size_t(_buffer.len() / 10 * 9);
@@ -1008,7 +1051,7 @@ SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     _file.close();
 
     return new sorter::FileIterator<Key, Value>(
-        _fileName, _fileStartOffset, _fileEndOffset, _settings);
+        _fileName, _fileStartOffset, _fileEndOffset, _settings, _compressor);
 }
 
 //
@@ -89,6 +89,9 @@ namespace mongo {
  * Runtime options that control the Sorter's behavior
  */
 struct SortOptions {
+    // The block compressors which may be used for the data spilled to disk.
+    enum class Compressor { kSnappy, kZstd };
+
     // The number of KV pairs to be returned. 0 indicates no limit.
     unsigned long long limit;
 
@@ -103,7 +106,15 @@ struct SortOptions {
     // extSortAllowed is true.
     std::string tempDir;
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    // Compressor for the blocks of spilled data. A block is written uncompressed if compressing it
+    // does not save at least 10% of its size.
+    Compressor spillCompressor;
+
+    SortOptions()
+        : limit(0),
+          maxMemoryUsageBytes(64 * 1024 * 1024),
+          extSortAllowed(false),
+          spillCompressor(Compressor::kSnappy) {}
 
     // Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -126,6 +137,11 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& SpillCompressor(Compressor newSpillCompressor) {
+        spillCompressor = newSpillCompressor;
+        return *this;
+    }
 };
 
 /**
@@ -256,6 +272,7 @@ private:
     void spill();
 
     const Settings _settings;
+    const SortOptions::Compressor _compressor;
     std::string _fileName;
     std::ofstream _file;
     BufBuilder _buffer;
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/base/counter.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/basic.h"
@@ -42,6 +43,9 @@ namespace mongo {
 /**
  * for storing operation counters
  * note: not thread safe.  ok with that for speed
+ *
+ * Every operation bumps these, so each counter is sharded across cache lines; see
+ * ShardedCounter64.
  */
 class OpCounters {
 public:
@@ -74,35 +78,35 @@ public:
     BSONObj getObj() const;
 
     // thse are used by snmp, and other things, do not remove
-    const AtomicWord<long long>* getInsert() const {
+    const ShardedCounter64* getInsert() const {
         return &_insert;
     }
-    const AtomicWord<long long>* getQuery() const {
+    const ShardedCounter64* getQuery() const {
         return &_query;
     }
-    const AtomicWord<long long>* getUpdate() const {
+    const ShardedCounter64* getUpdate() const {
         return &_update;
     }
-    const AtomicWord<long long>* getDelete() const {
+    const ShardedCounter64* getDelete() const {
         return &_delete;
     }
-    const AtomicWord<long long>* getGetMore() const {
+    const ShardedCounter64* getGetMore() const {
         return &_getmore;
     }
-    const AtomicWord<long long>* getCommand() const {
+    const ShardedCounter64* getCommand() const {
         return &_command;
     }
 
 private:
     // Increment member `counter` by `n`, resetting all counters if it was > 2^60.
-    void _checkWrap(CacheAligned<AtomicWord<long long>> OpCounters::*counter, int n);
-
-    CacheAligned<AtomicWord<long long>> _insert;
-    CacheAligned<AtomicWord<long long>> _query;
-    CacheAligned<AtomicWord<long long>> _update;
-    CacheAligned<AtomicWord<long long>> _delete;
-    CacheAligned<AtomicWord<long long>> _getmore;
-    CacheAligned<AtomicWord<long long>> _command;
+    void _checkWrap(ShardedCounter64 OpCounters::*counter, int n);
+
+    ShardedCounter64 _insert;
+    ShardedCounter64 _query;
+    ShardedCounter64 _update;
+    ShardedCounter64 _delete;
+    ShardedCounter64 _getmore;
+    ShardedCounter64 _command;
 };
 
 extern OpCounters globalOpCounters;
@@ -122,20 +126,11 @@ public:
     void append(BSONObjBuilder& b);
 
 private:
-    CacheAligned<AtomicWord<long long>> _physicalBytesIn{0};
-    CacheAligned<AtomicWord<long long>> _physicalBytesOut{0};
-
-    // These two counters are always incremented at the same time, so
-    // we place them on the same cache line.
-    struct Together {
-        AtomicWord<long long> logicalBytesIn{0};
-        AtomicWord<long long> requests{0};
-    };
-    CacheAligned<Together> _together{};
-    static_assert(sizeof(decltype(_together)) <= stdx::hardware_constructive_interference_size,
-                  "cache line spill");
-
-    CacheAligned<AtomicWord<long long>> _logicalBytesOut{0};
+    ShardedCounter64 _physicalBytesIn;
+    ShardedCounter64 _physicalBytesOut;
+    ShardedCounter64 _logicalBytesIn;
+    ShardedCounter64 _requests;
+    ShardedCounter64 _logicalBytesOut;
 };
 
 extern NetworkCounter networkCounter;
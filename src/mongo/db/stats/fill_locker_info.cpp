@@ -68,6 +68,9 @@ void fillLockerInfo(const Locker::LockerInfo& lockerInfo, BSONObjBuilder& infoBu
 
     // "waitingForLock" section
     infoBuilder.append("waitingForLock", lockerInfo.waitingResource.isValid());
+    if (lockerInfo.waitingResource.isValid()) {
+        infoBuilder.append("waitingForLockResource", lockerInfo.waitingResource.toString());
+    }
 
     // "lockStats" section
     {
@@ -52,6 +52,7 @@ TEST(FillLockerInfo, DoesReportWaitingForLockIfWaiting) {
 
     ASSERT(infoObj["waitingForLock"].type() == BSONType::Bool);
     ASSERT_TRUE(infoObj["waitingForLock"].Bool());
+    ASSERT_EQ(resourceIdGlobal.toString(), infoObj["waitingForLockResource"].String());
 }
 
 TEST(FillLockerInfo, DoesNotReportWaitingForLockIfNotWaiting) {
@@ -65,6 +66,7 @@ TEST(FillLockerInfo, DoesNotReportWaitingForLockIfNotWaiting) {
 
     ASSERT(infoObj["waitingForLock"].type() == BSONType::Bool);
     ASSERT_FALSE(infoObj["waitingForLock"].Bool());
+    ASSERT_FALSE(infoObj.hasField("waitingForLockResource"));
 }
 
 TEST(FillLockerInfo, DoesReportLockStats) {
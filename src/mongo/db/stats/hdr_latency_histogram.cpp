@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/hdr_latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+size_t HdrLatencyHistogram::_getBucket(uint64_t latencyMicros) {
+    if (latencyMicros < kSubBuckets) {
+        return latencyMicros;
+    }
+
+    // Latencies in [2^log2, 2^(log2 + 1)) are split into kSubBuckets buckets, each
+    // 2^(log2 - kSubBucketBits) wide.
+    const int log2 = 63 - countLeadingZeros64(latencyMicros);
+    const int shift = log2 - kSubBucketBits;
+    const uint64_t subBucket = (latencyMicros >> shift) - kSubBuckets;
+    return kSubBuckets + shift * kSubBuckets + subBucket;
+}
+
+uint64_t HdrLatencyHistogram::_getBucketUpperBound(size_t bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+
+    const int shift = (bucket - kSubBuckets) / kSubBuckets;
+    const uint64_t subBucket = (bucket - kSubBuckets) % kSubBuckets;
+    return ((kSubBuckets + subBucket + 1) << shift) - 1;
+}
+
+void HdrLatencyHistogram::increment(uint64_t latencyMicros) {
+    latencyMicros = std::min(latencyMicros, kMaxLatencyMicros);
+
+    const auto bucket = _getBucket(latencyMicros);
+    if (bucket >= _buckets.size()) {
+        _buckets.resize(bucket + 1);
+    }
+    ++_buckets[bucket];
+    ++_count;
+    _max = std::max(_max, latencyMicros);
+}
+
+uint64_t HdrLatencyHistogram::percentile(double fraction) const {
+    if (_count == 0) {
+        return 0;
+    }
+
+    const auto rank = std::max<uint64_t>(1, std::ceil(fraction * _count));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < _buckets.size(); ++bucket) {
+        seen += _buckets[bucket];
+        if (seen >= rank) {
+            // The bucket's upper bound can overshoot the largest latency in it.
+            return std::min(_getBucketUpperBound(bucket), _max);
+        }
+    }
+    return _max;
+}
+
+void HdrLatencyHistogram::append(BSONObjBuilder* builder) const {
+    builder->append("ops", static_cast<long long>(_count));
+    builder->append("p50", static_cast<long long>(percentile(0.5)));
+    builder->append("p99", static_cast<long long>(percentile(0.99)));
+    builder->append("p999", static_cast<long long>(percentile(0.999)));
+    builder->append("max", static_cast<long long>(_max));
+}
+
+}  // namespace mongo
@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Latency histogram with log-linear buckets, in the style of HdrHistogram, precise enough to
+ * report tail percentiles.
+ *
+ * Each power of two range of latencies is split into kSubBuckets equal-width buckets, so a
+ * recorded latency is known to within 1/kSubBuckets (about 3%) of its value. Latencies below
+ * kSubBuckets micros are recorded exactly. Buckets are allocated up to the largest latency seen,
+ * so a histogram of sub-second latencies takes a few kilobytes.
+ *
+ * Note: This class is not thread-safe.
+ */
+class HdrLatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr uint64_t kSubBuckets = 1ULL << kSubBucketBits;
+
+    // Larger latencies, about 12 days, are recorded as this.
+    static constexpr uint64_t kMaxLatencyMicros = (1ULL << 40) - 1;
+
+    void increment(uint64_t latencyMicros);
+
+    uint64_t count() const {
+        return _count;
+    }
+
+    /**
+     * Returns the highest latency, to within the bucket width, at or below which fall 'fraction'
+     * of the recorded latencies. Returns 0 if nothing was recorded.
+     */
+    uint64_t percentile(double fraction) const;
+
+    /**
+     * Appends {ops, p50, p99, p999, max}, with latencies in micros.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+private:
+    static size_t _getBucket(uint64_t latencyMicros);
+
+    // The highest latency that falls in 'bucket'.
+    static uint64_t _getBucketUpperBound(size_t bucket);
+
+    std::vector<uint64_t> _buckets;
+    uint64_t _count = 0;
+    uint64_t _max = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,109 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/hdr_latency_histogram.h"
+
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(HdrLatencyHistogram, EmptyHistogramReportsZero) {
+    HdrLatencyHistogram hist;
+    ASSERT_EQ(hist.count(), 0U);
+    ASSERT_EQ(hist.percentile(0.5), 0U);
+    ASSERT_EQ(hist.percentile(0.99), 0U);
+}
+
+TEST(HdrLatencyHistogram, SmallLatenciesAreExact) {
+    HdrLatencyHistogram hist;
+    for (uint64_t i = 1; i <= HdrLatencyHistogram::kSubBuckets; ++i) {
+        hist.increment(i - 1);
+    }
+    ASSERT_EQ(hist.count(), HdrLatencyHistogram::kSubBuckets);
+    ASSERT_EQ(hist.percentile(0.5), HdrLatencyHistogram::kSubBuckets / 2 - 1);
+    ASSERT_EQ(hist.percentile(1), HdrLatencyHistogram::kSubBuckets - 1);
+}
+
+TEST(HdrLatencyHistogram, PercentilesAreWithinTheRelativeError) {
+    HdrLatencyHistogram hist;
+    for (uint64_t i = 1; i <= 100 * 1000; ++i) {
+        hist.increment(i);
+    }
+
+    for (double fraction : {0.5, 0.9, 0.99, 0.999}) {
+        const double expected = fraction * 100 * 1000;
+        const double actual = hist.percentile(fraction);
+        ASSERT_GTE(actual, expected) << fraction;
+        ASSERT_LTE(actual, expected * (1 + 1.0 / HdrLatencyHistogram::kSubBuckets)) << fraction;
+    }
+    ASSERT_EQ(hist.percentile(1), 100U * 1000);
+}
+
+TEST(HdrLatencyHistogram, TailLatenciesShowInHighPercentiles) {
+    HdrLatencyHistogram hist;
+    for (int i = 0; i < 990; ++i) {
+        hist.increment(100);
+    }
+    for (int i = 0; i < 10; ++i) {
+        hist.increment(50 * 1000);
+    }
+
+    ASSERT_LTE(hist.percentile(0.5), 103U);
+    ASSERT_LTE(hist.percentile(0.99), 103U);
+    ASSERT_GTE(hist.percentile(0.999), 50U * 1000);
+    ASSERT_LTE(hist.percentile(0.999), 50U * 1000);
+}
+
+TEST(HdrLatencyHistogram, HugeLatenciesAreClamped) {
+    HdrLatencyHistogram hist;
+    hist.increment(std::numeric_limits<uint64_t>::max());
+    ASSERT_EQ(hist.percentile(1), HdrLatencyHistogram::kMaxLatencyMicros);
+}
+
+TEST(HdrLatencyHistogram, AppendsPercentiles) {
+    HdrLatencyHistogram hist;
+    hist.increment(10);
+    hist.increment(20);
+
+    BSONObjBuilder builder;
+    hist.append(&builder);
+    ASSERT_BSONOBJ_EQ(builder.obj(),
+                      BSON("ops" << 2 << "p50" << 10 << "p99" << 20 << "p999" << 20 << "max"
+                                 << 20));
+}
+
+}  // namespace
+}  // namespace mongo
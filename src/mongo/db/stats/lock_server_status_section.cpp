@@ -29,6 +29,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <valarray>
 
 #include "mongo/db/client.h"
@@ -36,6 +37,7 @@
 #include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/util/concurrency/adaptive_mutex.h"
 
 namespace mongo {
 namespace {
@@ -127,5 +129,57 @@ public:
 
 } lockStatsServerStatusSection;
 
+
+/**
+ * Reports the resources whose locks were waited for the longest. Not included by default, since
+ * its list of resources changes from one call to the next.
+ */
+class LockWaitsServerStatusSection : public ServerStatusSection {
+public:
+    LockWaitsServerStatusSection() : ServerStatusSection("lockWaits") {}
+
+    bool includeByDefault() const override {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        // The number of resources to report can be given as {lockWaits: {top: <n>}}.
+        long long maxResources = kDefaultMaxResources;
+        if (configElement.type() == Object && configElement.Obj()["top"].isNumber()) {
+            maxResources = std::max(0LL, configElement.Obj()["top"].safeNumberLong());
+        }
+
+        BSONObjBuilder ret;
+        reportResourceWaitStats(&ret, static_cast<size_t>(maxResources));
+        return ret.obj();
+    }
+
+private:
+    static constexpr long long kDefaultMaxResources = 10;
+
+} lockWaitsServerStatusSection;
+
+
+/**
+ * Reports how often the adaptive mutexes, such as those of the Clients, were found held.
+ */
+class MutexContentionServerStatusSection : public ServerStatusSection {
+public:
+    MutexContentionServerStatusSection() : ServerStatusSection("mutexContention") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder ret;
+        MutexContentionStats::reportAll(&ret);
+        return ret.obj();
+    }
+
+} mutexContentionServerStatusSection;
+
 }  // namespace
 }  // namespace mongo
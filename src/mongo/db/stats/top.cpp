@@ -35,6 +35,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/top_gen.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -48,6 +49,11 @@ namespace {
 
 const auto getTop = ServiceContext::declareDecoration<Top>();
 
+bool isFromUser(OperationContext* opCtx) {
+    Client* client = opCtx->getClient();
+    return client->isFromUserConnection() && !client->isInDirectClient();
+}
+
 }  // namespace
 
 Top::UsageData::UsageData(const UsageData& older, const UsageData& newer) {
@@ -103,6 +109,7 @@ void Top::_record(OperationContext* opCtx,
                   Command::ReadWriteType readWriteType) {
 
     _incrementHistogram(opCtx, micros, &c.opLatencyHistogram, readWriteType);
+    _incrementLatencyPercentiles(opCtx, micros, &c);
 
     c.total.inc(micros);
 
@@ -142,7 +149,13 @@ void Top::_record(OperationContext* opCtx,
 
 void Top::collectionDropped(const NamespaceString& nss, bool databaseDropped) {
     stdx::lock_guard<SimpleMutex> lk(_lock);
-    _usage.erase(nss.ns());
+    auto it = _usage.find(nss.ns());
+    if (it != _usage.end()) {
+        if (it->second.latencyPercentiles) {
+            --_numLatencyPercentiles;
+        }
+        _usage.erase(it);
+    }
 
     if (!databaseDropped) {
         // If a collection drop occurred, there will be a subsequent call to record for this
@@ -205,7 +218,12 @@ void Top::appendLatencyStats(const NamespaceString& nss,
     auto hashedNs = UsageMap::hasher().hashed_key(nss.ns());
     stdx::lock_guard<SimpleMutex> lk(_lock);
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    auto& coll = _usage[hashedNs];
+    coll.opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    if (coll.latencyPercentiles) {
+        BSONObjBuilder percentilesBuilder(latencyStatsBuilder.subobjStart("percentiles"));
+        coll.latencyPercentiles->append(&percentilesBuilder);
+    }
     builder->append("ns", nss.ns());
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -217,9 +235,37 @@ void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
     _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
 }
 
+void Top::incrementCommandLatencyStats(OperationContext* opCtx,
+                                       StringData commandName,
+                                       uint64_t latency) {
+    if (!gCommandLatencyPercentilesEnabled.load() || !isFromUser(opCtx)) {
+        return;
+    }
+
+    stdx::lock_guard<SimpleMutex> guard(_lock);
+    _commandLatencyPercentiles[commandName].increment(latency);
+}
+
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
     stdx::lock_guard<SimpleMutex> guard(_lock);
     _globalHistogramStats.append(includeHistograms, builder);
+
+    if (_commandLatencyPercentiles.empty()) {
+        return;
+    }
+
+    // Sort the commands so that FTDC sees a stable schema.
+    std::vector<StringData> commandNames;
+    for (auto&& entry : _commandLatencyPercentiles) {
+        commandNames.push_back(entry.first);
+    }
+    std::sort(commandNames.begin(), commandNames.end());
+
+    BSONObjBuilder commandsBuilder(builder->subobjStart("commandPercentiles"));
+    for (auto&& commandName : commandNames) {
+        BSONObjBuilder commandBuilder(commandsBuilder.subobjStart(commandName));
+        _commandLatencyPercentiles.find(commandName)->second.append(&commandBuilder);
+    }
 }
 
 void Top::incrementGlobalTransactionLatencyStats(uint64_t latency) {
@@ -232,9 +278,26 @@ void Top::_incrementHistogram(OperationContext* opCtx,
                               OperationLatencyHistogram* histogram,
                               Command::ReadWriteType readWriteType) {
     // Only update histogram if operation came from a user.
-    Client* client = opCtx->getClient();
-    if (client->isFromUserConnection() && !client->isInDirectClient()) {
+    if (isFromUser(opCtx)) {
         histogram->increment(latency, readWriteType);
     }
 }
+
+void Top::_incrementLatencyPercentiles(OperationContext* opCtx,
+                                       long long latency,
+                                       CollectionData* c) {
+    if (!gNamespaceLatencyPercentilesEnabled.load() || !isFromUser(opCtx)) {
+        return;
+    }
+
+    if (!c->latencyPercentiles) {
+        const auto maxLatencyPercentiles = gMaxNamespaceLatencyPercentileHistograms.load();
+        if (_numLatencyPercentiles >= static_cast<size_t>(maxLatencyPercentiles)) {
+            return;
+        }
+        c->latencyPercentiles.emplace();
+        ++_numLatencyPercentiles;
+    }
+    c->latencyPercentiles->increment(latency);
+}
 }  // namespace mongo
@@ -34,9 +34,11 @@
  */
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/optional.hpp>
 
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/stats/hdr_latency_histogram.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
@@ -85,6 +87,10 @@ public:
         UsageData remove;
         UsageData commands;
         OperationLatencyHistogram opLatencyHistogram;
+
+        // Only tracked with 'namespaceLatencyPercentilesEnabled', for a bounded number of
+        // namespaces.
+        boost::optional<HdrLatencyHistogram> latencyPercentiles;
     };
 
     enum class LockType {
@@ -124,13 +130,21 @@ public:
                                      uint64_t latency,
                                      Command::ReadWriteType readWriteType);
 
+    /**
+     * Increments the latency percentiles of 'commandName', if 'commandLatencyPercentilesEnabled'
+     * is set and the operation came from a user.
+     */
+    void incrementCommandLatencyStats(OperationContext* opCtx,
+                                      StringData commandName,
+                                      uint64_t latency);
+
     /**
      * Increments the global transactions histogram.
      */
     void incrementGlobalTransactionLatencyStats(uint64_t latency);
 
     /**
-     * Appends the global latency statistics.
+     * Appends the global latency statistics, and the latency percentiles of each command.
      */
     void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
 
@@ -151,9 +165,15 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
+    void _incrementLatencyPercentiles(OperationContext* opCtx,
+                                      long long latency,
+                                      CollectionData* c);
+
     mutable SimpleMutex _lock;
     OperationLatencyHistogram _globalHistogramStats;
+    StringMap<HdrLatencyHistogram> _commandLatencyPercentiles;
     UsageMap _usage;
+    size_t _numLatencyPercentiles = 0;
     std::set<std::string> _collDropNs;
 };
 
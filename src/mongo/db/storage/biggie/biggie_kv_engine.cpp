@@ -94,12 +94,15 @@ std::unique_ptr<mongo::RecordStore> KVEngine::getRecordStore(OperationContext* o
 }
 
 bool KVEngine::trySwapMaster(StringStore& newMaster, uint64_t version) {
+    invariant(!newMaster.hasBranch());
+    // Copy the new master before taking the lock, since the commit succeeds if no other commit has
+    // swapped in a master since 'version'.
+    auto snapshot = std::make_shared<const MasterSnapshot>(version + 1, newMaster);
+
     stdx::lock_guard<stdx::mutex> lock(_masterLock);
-    invariant(!newMaster.hasBranch() && !_master.hasBranch());
-    if (_masterVersion != version)
+    if (_master->version != version)
         return false;
-    _master = newMaster;
-    _masterVersion++;
+    std::atomic_store(&_master, std::shared_ptr<const MasterSnapshot>(std::move(snapshot)));
     return true;
 }
 
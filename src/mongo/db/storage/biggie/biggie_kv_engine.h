@@ -150,11 +150,13 @@ public:
     // Biggie Specific
 
     /**
-     * Returns a pair of the current version and copy of tree of the master.
+     * Returns a pair of the current version and copy of tree of the master. Readers load the
+     * current snapshot of the master atomically and never take _masterLock, so they neither wait
+     * for nor delay a commit swapping in a new master.
      */
     std::pair<uint64_t, StringStore> getMasterInfo() {
-        stdx::lock_guard<stdx::mutex> lock(_masterLock);
-        return std::make_pair(_masterVersion, _master);
+        std::shared_ptr<const MasterSnapshot> master = std::atomic_load(&_master);
+        return std::make_pair(master->version, master->store);
     }
 
     /**
@@ -169,9 +171,23 @@ private:
     std::map<std::string, bool> _idents;  // TODO : replace with a query to _master.
     std::unique_ptr<VisibilityManager> _visibilityManager;
 
+    /**
+     * An immutable version of the master. Copies of the store share its nodes, so a commit only
+     * ever copies the paths it changed.
+     */
+    struct MasterSnapshot {
+        MasterSnapshot(uint64_t version, const StringStore& store)
+            : version(version), store(store) {}
+
+        const uint64_t version;
+        const StringStore store;
+    };
+
+    // Serializes commits swapping in a new master. _master is only replaced while holding it, with
+    // std::atomic_store, so that readers can load it with std::atomic_load instead.
     mutable stdx::mutex _masterLock;
-    StringStore _master;
-    uint64_t _masterVersion = 0;
+    std::shared_ptr<const MasterSnapshot> _master =
+        std::make_shared<const MasterSnapshot>(0, StringStore());
 };
 }  // namespace biggie
 }  // namespace mongo
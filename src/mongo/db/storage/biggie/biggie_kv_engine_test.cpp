@@ -34,9 +34,12 @@
 #include <memory>
 
 #include "mongo/base/init.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/db/storage/biggie/biggie_kv_engine.h"
+#include "mongo/db/storage/biggie/biggie_recovery_unit.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -70,5 +73,45 @@ MONGO_INITIALIZER(RegisterKVHarnessFactory)(InitializerContext*) {
     return Status::OK();
 }
 
+TEST(BiggieKVEngineTest, ConcurrentCommitsAreAllMerged) {
+    KVEngine engine;
+    const int kNumThreads = 4;
+    const int kNumCommits = 100;
+
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&engine, t] {
+            RecoveryUnit ru(&engine);
+            for (int i = 0; i < kNumCommits; ++i) {
+                const std::string key = str::stream() << "key" << i << "." << t;
+                while (true) {
+                    ru.beginUnitOfWork(nullptr);
+                    ru.getHead()->insert(StringStore::value_type(key, "value"));
+                    ru.makeDirty();
+                    try {
+                        ru.commitUnitOfWork();
+                        break;
+                    } catch (const WriteConflictException&) {
+                        ru.abortUnitOfWork();
+                    }
+                }
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    auto master = engine.getMasterInfo();
+    ASSERT_EQ(static_cast<uint64_t>(kNumThreads * kNumCommits), master.first);
+    ASSERT_EQ(static_cast<size_t>(kNumThreads * kNumCommits), master.second.size());
+    for (int t = 0; t < kNumThreads; ++t) {
+        for (int i = 0; i < kNumCommits; ++i) {
+            const std::string key = str::stream() << "key" << i << "." << t;
+            ASSERT(master.second.find(key) != master.second.end()) << key;
+        }
+    }
+}
+
 }  // namespace biggie
 }  // namespace mongo
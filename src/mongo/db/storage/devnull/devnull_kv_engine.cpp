@@ -270,6 +270,15 @@ void DevNullKVEngine::setCacheOverflowTableInsertCountForTest(int insertsCount)
     _overflowTableInsertCountForTest = insertsCount;
 }
 
+double DevNullKVEngine::getCacheDirtyRatio(OperationContext* opCtx) const {
+    return _cacheDirtyRatioForTest;
+}
+
+void DevNullKVEngine::setCacheDirtyRatioForTest(double dirtyRatio) {
+    invariant(dirtyRatio >= 0 && dirtyRatio <= 1);
+    _cacheDirtyRatioForTest = dirtyRatio;
+}
+
 StatusWith<std::vector<std::string>> DevNullKVEngine::beginNonBlockingBackup(
     OperationContext* opCtx) {
     std::vector<std::string> filesToCopy = {"filename.wt"};
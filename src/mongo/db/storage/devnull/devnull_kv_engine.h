@@ -100,6 +100,10 @@ public:
 
     virtual void setCacheOverflowTableInsertCountForTest(int insertCount) override;
 
+    virtual double getCacheDirtyRatio(OperationContext* opCtx) const override;
+
+    virtual void setCacheDirtyRatioForTest(double dirtyRatio) override;
+
     virtual int64_t getIdentSize(OperationContext* opCtx, StringData ident) {
         return 1;
     }
@@ -154,5 +158,7 @@ private:
     std::shared_ptr<void> _catalogInfo;
 
     int _overflowTableInsertCountForTest;
+
+    double _cacheDirtyRatioForTest = 0;
 };
 }
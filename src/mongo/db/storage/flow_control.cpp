@@ -119,6 +119,9 @@ bool sustainerAdvanced(const std::vector<repl::MemberData>& prevMemberData,
 
     return true;
 }
+
+// The PI controller never accumulates more than this many threshold lags of lag.
+const double kMaxControllerIntegral = 10.0;
 }  // namespace
 
 FlowControl::FlowControl(repl::ReplicationCoordinator* replCoord)
@@ -202,6 +205,25 @@ BSONObj FlowControl::generateSection(OperationContext* opCtx,
     bob.append("isLaggedCount", _isLaggedCount.load());
     bob.append("isLaggedTimeMicros", _isLaggedTimeMicros.load());
 
+    if (gFlowControlUsePIController.load()) {
+        stdx::lock_guard<stdx::mutex> lk(_controllerMutex);
+        BSONObjBuilder controller(bob.subobjStart("controller"));
+        controller.append("sustainableRate", _getSustainableApplyRate());
+        controller.append("targetRate", _lastControllerRate);
+        controller.append("integral", _controllerIntegral);
+        controller.append("lagMillis", _lastLagMillis);
+        controller.append("predictedLagMillis", _predictedLagMillis);
+        controller.append("nextPredictedLagMillis", _nextPredictedLagMillis);
+
+        BSONArrayBuilder members(controller.subarrayStart("members"));
+        for (auto&& member : _memberApplyRates) {
+            BSONObjBuilder memberBob(members.subobjStart());
+            memberBob.append("memberId", member.first);
+            memberBob.append("host", member.second.host.toString());
+            memberBob.append("applyRate", member.second.opsPerPeriod);
+        }
+    }
+
     return bob.obj();
 }
 
@@ -289,6 +311,107 @@ int FlowControl::_calculateNewTicketsForLag(const std::vector<repl::MemberData>&
     return multiplyWithOverflowCheck(locksPerOp, sustainerAppliedPenalty, _kMaxTickets);
 }
 
+void FlowControl::_updateMemberApplyRates(const std::vector<repl::MemberData>& prevMemberData,
+                                          const std::vector<repl::MemberData>& currMemberData) {
+    std::map<int, double> applied;
+    for (auto&& curr : currMemberData) {
+        auto prev = std::find_if(
+            prevMemberData.begin(), prevMemberData.end(), [&](const repl::MemberData& member) {
+                return member.getMemberId() == curr.getMemberId();
+            });
+        if (prev == prevMemberData.end()) {
+            continue;
+        }
+
+        // Timestamps within one sample apart are only a few operations apart.
+        const std::int64_t ops =
+            _approximateOpsBetween(prev->getLastAppliedOpTime().getTimestamp(),
+                                   curr.getLastAppliedOpTime().getTimestamp());
+        applied[curr.getMemberId()] = std::max(ops, std::int64_t(0));
+    }
+
+    const double damping = gFlowControlDamping.load();
+    stdx::lock_guard<stdx::mutex> lk(_controllerMutex);
+    std::map<int, MemberApplyRate> rates;
+    for (auto&& curr : currMemberData) {
+        auto ops = applied.find(curr.getMemberId());
+        if (ops == applied.end()) {
+            continue;
+        }
+
+        auto rate = _memberApplyRates.find(curr.getMemberId());
+        rates[curr.getMemberId()] = {curr.getHostAndPort(),
+                                     rate == _memberApplyRates.end()
+                                         ? ops->second
+                                         : damping * rate->second.opsPerPeriod +
+                                             (1.0 - damping) * ops->second};
+    }
+
+    // Members which left the replica set are forgotten.
+    _memberApplyRates = std::move(rates);
+}
+
+double FlowControl::_getSustainableApplyRate() const {
+    if (_memberApplyRates.empty()) {
+        return -1.0;
+    }
+
+    std::vector<double> rates;
+    for (auto&& member : _memberApplyRates) {
+        rates.push_back(member.second.opsPerPeriod);
+    }
+    std::sort(rates.begin(), rates.end());
+
+    // The majority point advances at the rate of the slowest member of the fastest majority.
+    return rates[(rates.size() - 1) / 2];
+}
+
+int FlowControl::_calculateNewTicketsWithController(double locksPerOp,
+                                                    std::uint64_t lagMillis,
+                                                    std::uint64_t thresholdLagMillis) {
+    stdx::lock_guard<stdx::mutex> lk(_controllerMutex);
+    const double sustainableRate = _getSustainableApplyRate();
+    if (sustainableRate < 0.0) {
+        return -1;
+    }
+
+    // The lag above the threshold, in threshold lags. The integral only accumulates lag above the
+    // threshold, so that it does not let writes through faster once the commit point catches up.
+    const double threshold = static_cast<double>(thresholdLagMillis);
+    const double error = (static_cast<double>(lagMillis) - threshold) / threshold;
+    _controllerIntegral =
+        std::min(std::max(_controllerIntegral + error, 0.0), kMaxControllerIntegral);
+
+    const double fraction = std::max(1.0 - gFlowControlProportionalGain.load() * error -
+                                         gFlowControlIntegralGain.load() * _controllerIntegral,
+                                     0.0);
+    double rate = sustainableRate * fraction;
+
+    // Damp the change from the last target rate, so that bursts do not make the rate swing.
+    const double damping = gFlowControlDamping.load();
+    if (_lastControllerRate >= 0.0) {
+        rate = damping * _lastControllerRate + (1.0 - damping) * rate;
+    }
+    _lastControllerRate = rate;
+
+    // Each period, the lag grows by the time the majority needs to apply what is written beyond
+    // the rate at which it applies, and shrinks by the time it catches up on otherwise.
+    _predictedLagMillis = _nextPredictedLagMillis;
+    _nextPredictedLagMillis = static_cast<std::int64_t>(lagMillis);
+    if (sustainableRate > 0.0) {
+        const double lagChangeMillis = 1000.0 * (rate - sustainableRate) / sustainableRate;
+        _nextPredictedLagMillis =
+            std::max(static_cast<std::int64_t>(lagMillis + lagChangeMillis), std::int64_t(0));
+    }
+
+    LOG(DEBUG_LOG_LEVEL) << "Controller sustainable rate: " << sustainableRate
+                         << " LagMillis: " << lagMillis << " Error: " << error
+                         << " Integral: " << _controllerIntegral << " Target rate: " << rate
+                         << " Predicted lag millis: " << _nextPredictedLagMillis;
+
+    return multiplyWithOverflowCheck(locksPerOp, rate, _kMaxTickets);
+}
+
 int FlowControl::getNumTickets() {
     // Flow Control is only enabled on nodes that can accept writes.
     const bool canAcceptWrites = _replCoord->canAcceptNonLocalWrites();
@@ -308,8 +431,17 @@ int FlowControl::getNumTickets() {
 
     // It's important to update the topology on each iteration.
     _updateTopologyData();
+    const bool usePIController = gFlowControlUsePIController.load();
+    if (usePIController) {
+        _updateMemberApplyRates(_prevMemberData, _currMemberData);
+    }
     const repl::OpTimeAndWallTime myLastApplied = _replCoord->getMyLastAppliedOpTimeAndWallTime();
     const repl::OpTimeAndWallTime lastCommitted = _replCoord->getLastCommittedOpTimeAndWallTime();
+    const std::uint64_t lagMillis = getLagMillis(myLastApplied.wallTime, lastCommitted.wallTime);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_controllerMutex);
+        _lastLagMillis = static_cast<std::int64_t>(lagMillis);
+    }
     const double locksPerOp = _getLocksPerOp();
     const std::int64_t locksUsedLastPeriod = _getLocksUsedLastPeriod();
 
@@ -323,8 +455,7 @@ int FlowControl::getNumTickets() {
 
     int ret = 0;
     const auto thresholdLagMillis = getThresholdLagMillis();
-    const bool isHealthy =
-        getLagMillis(myLastApplied.wallTime, lastCommitted.wallTime) < thresholdLagMillis ||
+    const bool isHealthy = lagMillis < thresholdLagMillis ||
         // _approximateOpsBetween will return -1 if the input timestamps are in the same "bucket".
         // This is an indication that there are very few ops between the two timestamps.
         //
@@ -346,16 +477,28 @@ int FlowControl::getNumTickets() {
             auto waitTime = curTimeMicros64() - _startWaitTime;
             _isLaggedTimeMicros.fetchAndAddRelaxed(waitTime);
         }
+
+        // The next lagged period starts the controller over from the sustainable rate, and with
+        // what is left of the accumulated lag.
+        stdx::lock_guard<stdx::mutex> lk(_controllerMutex);
+        _controllerIntegral *= gFlowControlDamping.load();
+        _lastControllerRate = -1.0;
+        _predictedLagMillis = -1;
+        _nextPredictedLagMillis = -1;
     } else if (sustainerAdvanced(_prevMemberData, _currMemberData)) {
         // Expected case where flow control has meaningful data from the last period to make a new
         // calculation.
-        ret =
-            _calculateNewTicketsForLag(_prevMemberData,
-                                       _currMemberData,
-                                       locksUsedLastPeriod,
-                                       locksPerOp,
-                                       getLagMillis(myLastApplied.wallTime, lastCommitted.wallTime),
-                                       thresholdLagMillis);
+        ret = usePIController
+            ? _calculateNewTicketsWithController(locksPerOp, lagMillis, thresholdLagMillis)
+            : -1;
+        if (ret < 0) {
+            ret = _calculateNewTicketsForLag(_prevMemberData,
+                                             _currMemberData,
+                                             locksUsedLastPeriod,
+                                             locksPerOp,
+                                             lagMillis,
+                                             thresholdLagMillis);
+        }
         if (!_isLagged.load()) {
             _isLagged.store(true);
             _isLaggedCount.fetchAndAddRelaxed(1);
@@ -374,9 +517,7 @@ int FlowControl::getNumTickets() {
     ret = std::max(ret, gFlowControlMinTicketsPerSecond.load());
 
     LOG(DEBUG_LOG_LEVEL) << "Are lagged? " << (_isLagged.load() ? "true" : "false")
-                         << " Curr lag millis: "
-                         << getLagMillis(myLastApplied.wallTime, lastCommitted.wallTime)
-                         << " OpsLagged: "
+                         << " Curr lag millis: " << lagMillis << " OpsLagged: "
                          << _approximateOpsBetween(lastCommitted.opTime.getTimestamp(),
                                                    myLastApplied.opTime.getTimestamp())
                          << " Granting: " << ret
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <deque>
+#include <map>
 
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/operation_context.h"
@@ -102,6 +103,30 @@ public:
                                    double locksPerOp,
                                    std::uint64_t lagMillis,
                                    std::uint64_t thresholdLagMillis);
+
+    /**
+     * Updates the moving averages of the number of operations each member applied per period
+     * from two successive observations of the members.
+     */
+    void _updateMemberApplyRates(const std::vector<repl::MemberData>& prevMemberData,
+                                 const std::vector<repl::MemberData>& currMemberData);
+
+    /**
+     * Returns the number of operations per period at which the majority can apply, that is the
+     * apply rate of the slowest member of the fastest majority, or -1.0 if the apply rates are not
+     * known yet. The caller must hold '_controllerMutex'.
+     */
+    double _getSustainableApplyRate() const;
+
+    /**
+     * Computes the tickets for a lagged commit point with the PI controller. The target rate is
+     * the sustainable apply rate, cut in proportion to how far 'lagMillis' is above
+     * 'thresholdLagMillis' and to the lag accumulated over the previous lagged periods.
+     */
+    int _calculateNewTicketsWithController(double locksPerOp,
+                                           std::uint64_t lagMillis,
+                                           std::uint64_t thresholdLagMillis);
+
     void _trimSamples(const Timestamp trimSamplesTo);
 
     // Sample of (timestamp, ops, lock acquisitions) where ops and lock acquisitions are
@@ -141,6 +166,22 @@ private:
 
     // This value is used for calculating server status metrics.
     std::uint64_t _startWaitTime = 0;
+
+    // State of the PI controller. Only the periodic job changes it, and 'generateSection' reads it,
+    // both under the mutex.
+    struct MemberApplyRate {
+        HostAndPort host;
+        double opsPerPeriod;
+    };
+    mutable stdx::mutex _controllerMutex;
+    std::map<int, MemberApplyRate> _memberApplyRates;
+    double _controllerIntegral = 0.0;
+    double _lastControllerRate = -1.0;
+    std::int64_t _lastLagMillis = 0;
+    // The lag the controller predicted for the current period and for the next one, or -1 if it
+    // did not run in the period before.
+    std::int64_t _predictedLagMillis = -1;
+    std::int64_t _nextPredictedLagMillis = -1;
 };
 
 }  // namespace mongo
@@ -245,4 +245,70 @@ TEST_F(FlowControlTest, CalculatingTickets) {
                                                       currLag,
                                                       thresholdLag));
 }
+
+TEST_F(FlowControlTest, CalculatingTicketsWithController) {
+    gFlowControlProportionalGain.store(0.5);
+    gFlowControlIntegralGain.store(0.1);
+    gFlowControlDamping.store(0.5);
+
+    auto constructMemberData = [](int memberId, Timestamp ts) -> repl::MemberData {
+        repl::MemberData ret;
+        ret.setMemberId(memberId);
+        ret.setHostAndPort(HostAndPort("node", memberId));
+        ret.setLastAppliedOpTimeAndWallTime({{ts, 1}, Date_t()}, Date_t());
+        return ret;
+    };
+
+    // Construct samples where Timestamp X maps to operation number X.
+    for (int ts = 1; ts <= 4000; ++ts) {
+        flowControl->sample(Timestamp(ts), 1);
+    }
+
+    // The controller falls back to the heuristic until it knows the apply rates of the members.
+    const double locksPerOp = 2.0;
+    const std::uint64_t thresholdLag = 1000;
+    ASSERT_EQ(-1.0, flowControl->_getSustainableApplyRate());
+    ASSERT_EQ(-1,
+              flowControl->_calculateNewTicketsWithController(
+                  locksPerOp, thresholdLag, thresholdLag));
+
+    // From 1000, the secondaries apply 500 and 1000 operations while the primary writes 2000.
+    std::vector<repl::MemberData> prevMemberData = {constructMemberData(0, Timestamp(1000)),
+                                                    constructMemberData(1, Timestamp(1000)),
+                                                    constructMemberData(2, Timestamp(1000))};
+    std::vector<repl::MemberData> currMemberData = {constructMemberData(0, Timestamp(3000)),
+                                                    constructMemberData(1, Timestamp(1500)),
+                                                    constructMemberData(2, Timestamp(2000))};
+    flowControl->_updateMemberApplyRates(prevMemberData, currMemberData);
+    ASSERT_EQ(1000.0, flowControl->_getSustainableApplyRate());
+
+    // At the threshold lag, the controller targets the sustainable rate.
+    ASSERT_EQ(2000,
+              flowControl->_calculateNewTicketsWithController(
+                  locksPerOp, thresholdLag, thresholdLag));
+
+    // Twice the threshold lag cuts the target rate to 1 - 0.5 * 1 (proportional) - 0.1 * 1
+    // (integral) = 0.4 of the sustainable rate, which the damping brings to
+    // 0.5 * 1000 + 0.5 * 400 = 700 operations per period.
+    ASSERT_EQ(1400,
+              flowControl->_calculateNewTicketsWithController(
+                  locksPerOp, 2 * thresholdLag, thresholdLag));
+
+    // The members' apply rates are averaged with the damping factor. The member which is not
+    // observed anymore is forgotten.
+    prevMemberData = std::move(currMemberData);
+    currMemberData = {constructMemberData(0, Timestamp(4000)),
+                      constructMemberData(1, Timestamp(2500))};
+    flowControl->_updateMemberApplyRates(prevMemberData, currMemberData);
+    ASSERT_EQ(750.0, flowControl->_getSustainableApplyRate());
+
+    BSONElement noopVar;
+    gFlowControlUsePIController.store(true);
+    auto serverStatusSection = flowControl->generateSection(opCtx.get(), noopVar);
+    gFlowControlUsePIController.store(false);
+    auto controller = serverStatusSection["controller"].Obj();
+    ASSERT_EQ(750.0, controller["sustainableRate"].Double());
+    ASSERT_APPROX_EQUAL(700.0, controller["targetRate"].Double(), 0.001);
+    ASSERT_EQ(2u, controller["members"].Array().size());
+}
 }  // namespace mongo
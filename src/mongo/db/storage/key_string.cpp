@@ -229,11 +229,20 @@ const uint8_t kGreater = 254;
 
 // some utility functions
 namespace {
+// Flips the bits a word at a time, which the compiler can vectorize, and the last few bytes one by
+// one. 'dst' may be 'src' itself.
 void memcpy_flipBits(void* dst, const void* src, size_t bytes) {
     const char* input = static_cast<const char*>(src);
     char* output = static_cast<char*>(dst);
-    const char* const end = input + bytes;
-    while (input != end) {
+    for (; bytes >= sizeof(uint64_t); bytes -= sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, input, sizeof(word));
+        word = ~word;
+        memcpy(output, &word, sizeof(word));
+        input += sizeof(word);
+        output += sizeof(word);
+    }
+    while (bytes--) {
         *output++ = ~(*input++);
     }
 }
@@ -284,10 +293,8 @@ string readInvertedCString(BufReader* reader) {
     const char* end = static_cast<const char*>(memchr(start, 0xFF, reader->remaining()));
     uassert(50817, "Failed to find '0xFF' in inverted string.", end);
     size_t actualBytes = end - start;
-    string s(start, actualBytes);
-    for (size_t i = 0; i < s.size(); i++) {
-        s[i] = ~s[i];
-    }
+    string s(actualBytes, '\0');
+    memcpy_flipBits(&s[0], start, actualBytes);
     reader->skip(1 + actualBytes);
     return s;
 }
@@ -314,9 +321,7 @@ string readInvertedCStringWithNuls(BufReader* reader) {
         reader->skip(1 + actualBytes);
     } while (reader->peek<unsigned char>() == 0x00);
 
-    for (size_t i = 0; i < out.size(); i++) {
-        out[i] = ~out[i];
-    }
+    memcpy_flipBits(&out[0], out.data(), out.size());
 
     return out;
 }
@@ -857,19 +862,22 @@ void KeyString::_appendBsonValue(const BSONElement& elem, bool invert, const Str
 /// -- lowest level
 
 void KeyString::_appendStringLike(StringData str, bool invert) {
-    while (true) {
-        size_t firstNul = strnlen(str.rawData(), str.size());
-        // No NULs in string.
-        _appendBytes(str.rawData(), firstNul, invert);
-        if (firstNul == str.size() || firstNul == std::string::npos) {
-            _append(int8_t(0), invert);
+    const char* pos = str.rawData();
+    const char* const end = pos + str.size();
+    while (pos != end) {
+        const char* nul = static_cast<const char*>(memchr(pos, 0, end - pos));
+        if (!nul) {
+            // No more NULs in string.
+            _appendBytes(pos, end - pos, invert);
             break;
         }
 
         // replace "\x00" with "\x00\xFF"
+        _appendBytes(pos, nul - pos, invert);
         _appendBytes("\x00\xFF", 2, invert);
-        str = str.substr(firstNul + 1);  // skip over the NUL byte
+        pos = nul + 1;  // skip over the NUL byte
     }
+    _append(int8_t(0), invert);
 }
 
 void KeyString::_appendBson(const BSONObj& obj, bool invert) {
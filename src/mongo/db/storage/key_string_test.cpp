@@ -1351,6 +1351,74 @@ TEST_F(KeyStringTest, VeryLargeString) {
     ROUNDTRIP(version, obj);
 }
 
+namespace {
+// Returns the bytes which encode 'str' within a key, as the byte-at-a-time encoder wrote them:
+// each NUL escaped as "\x00\xFF", then a terminating NUL, all inverted for a descending key.
+std::string byteAtATimeStringEncoding(StringData str, bool invert) {
+    std::string out;
+    for (char c : str) {
+        out += c;
+        if (c == '\0') {
+            out += '\xFF';
+        }
+    }
+    out += '\0';
+    if (invert) {
+        for (auto& c : out) {
+            c = ~c;
+        }
+    }
+    return out;
+}
+}  // namespace
+
+TEST_F(KeyStringTest, StringsMatchByteAtATimeEncodingAndRoundTripUnaligned) {
+    std::vector<std::string> strings;
+    for (size_t len = 0; len <= 41; ++len) {
+        std::string plain;
+        for (size_t i = 0; i < len; ++i) {
+            plain += static_cast<char>(i % 3 == 0 ? 0xFF - i : 'a' + i % 26);
+        }
+        strings.push_back(plain);
+        if (len == 0) {
+            continue;
+        }
+
+        for (size_t pos : {size_t(0), len / 2, len - 1}) {
+            std::string withNul = plain;
+            withNul[pos] = '\0';
+            strings.push_back(withNul);
+        }
+        strings.push_back(std::string(len, '\0'));
+    }
+
+    for (auto ord : {ALL_ASCENDING, ONE_DESCENDING}) {
+        const bool invert = ord.get(0) == -1;
+        const KeyString emptyKs(version, BSON("" << ""), ord);
+        const std::string emptyKey(emptyKs.getBuffer(), emptyKs.getSize());
+
+        for (auto&& str : strings) {
+            // The string begins at a different alignment within each source object.
+            for (size_t offset = 0; offset < 8; ++offset) {
+                const BSONObj orig = BSON("" << str);
+                const KeyString ks(version, BSON(std::string(offset, 'f') << str), ord);
+                const std::string expected =
+                    emptyKey.substr(0, 1) + byteAtATimeStringEncoding(str, invert) +
+                    emptyKey.substr(2);
+                const std::string key(ks.getBuffer(), ks.getSize());
+                ASSERT_EQ(toHex(expected.data(), expected.size()), toHex(key.data(), key.size()));
+
+                // Decode the key from an unaligned copy too.
+                std::vector<char> buffer(offset + key.size());
+                memcpy(buffer.data() + offset, key.data(), key.size());
+                const BSONObj converted = KeyString::toBson(
+                    buffer.data() + offset, key.size(), ord, ks.getTypeBits());
+                ASSERT(converted.binaryEqual(orig));
+            }
+        }
+    }
+}
+
 TEST_F(KeyStringTest, ToBsonSafeShouldNotTerminate) {
     KeyString::TypeBits typeBits(KeyString::Version::V1);
 
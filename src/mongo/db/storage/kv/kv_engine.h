@@ -340,6 +340,18 @@ public:
      */
     virtual void setCacheOverflowTableInsertCountForTest(int insertCount) {}
 
+    /**
+     * See 'StorageEngine::getCacheDirtyRatio'
+     */
+    virtual double getCacheDirtyRatio(OperationContext* opCtx) const {
+        return 0;
+    }
+
+    /**
+     * See 'StorageEngine::setCacheDirtyRatioForTest()'
+     */
+    virtual void setCacheDirtyRatioForTest(double dirtyRatio) {}
+
     /**
      * See `StorageEngine::supportsRecoverToStableTimestamp`
      */
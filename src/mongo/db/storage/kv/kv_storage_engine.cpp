@@ -50,8 +50,10 @@
 #include "mongo/db/unclean_shutdown.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/progress_meter.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -61,6 +63,9 @@ using std::vector;
 namespace {
 const std::string catalogInfo = "_mdb_catalog";
 const auto kCatalogLogLevel = logger::LogSeverity::Debug(2);
+
+// Loading a catalog of at least this many collections logs how long it took.
+const size_t kCatalogLoadLogThreshold = 1000;
 }
 
 KVStorageEngine::KVStorageEngine(KVEngine* engine, KVStorageEngineOptions options)
@@ -183,8 +188,18 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
         }
     }
 
+    // Opening the record store of every collection can take a long time when there are many of
+    // them, so report how far along we are every few seconds.
+    Timer loadTimer;
+    ProgressMeter progress(collectionsKnownToCatalog.size(),
+                           /*secondsBetween=*/10,
+                           /*checkInterval=*/1,
+                           "collections",
+                           "Loading the storage engine catalog");
+
     KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
     for (const auto& nss : collectionsKnownToCatalog) {
+        progress.hit();
         std::string dbName = nss.db().toString();
 
         if (loadingFromUncleanShutdownOrRepair) {
@@ -230,6 +245,11 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
     KVPrefix::setLargestPrefix(maxSeenPrefix);
     opCtx->recoveryUnit()->abandonSnapshot();
 
+    if (collectionsKnownToCatalog.size() >= kCatalogLoadLogThreshold) {
+        log() << "Loaded the storage engine catalog entries of " << collectionsKnownToCatalog.size()
+              << " collections in " << loadTimer.millis() << "ms";
+    }
+
     // Unset the unclean shutdown flag to avoid executing special behavior if this method is called
     // after startup.
     startingAfterUncleanShutdown(getGlobalServiceContext()) = false;
@@ -723,6 +743,14 @@ void KVStorageEngine::setCacheOverflowTableInsertCountForTest(int insertCount) {
     return _engine->setCacheOverflowTableInsertCountForTest(insertCount);
 }
 
+double KVStorageEngine::getCacheDirtyRatio(OperationContext* opCtx) const {
+    return _engine->getCacheDirtyRatio(opCtx);
+}
+
+void KVStorageEngine::setCacheDirtyRatioForTest(double dirtyRatio) {
+    return _engine->setCacheDirtyRatioForTest(dirtyRatio);
+}
+
 bool KVStorageEngine::supportsRecoverToStableTimestamp() const {
     return _engine->supportsRecoverToStableTimestamp();
 }
@@ -129,6 +129,10 @@ public:
 
     virtual void setCacheOverflowTableInsertCountForTest(int insertCount) override;
 
+    virtual double getCacheDirtyRatio(OperationContext* opCtx) const override;
+
+    virtual void setCacheDirtyRatioForTest(double dirtyRatio) override;
+
     virtual bool supportsRecoverToStableTimestamp() const override;
 
     virtual bool supportsRecoveryTimestamp() const override;
@@ -36,8 +36,39 @@
 
 namespace mongo {
 
-MobileSession::MobileSession(sqlite3* session, MobileSessionPool* sessionPool)
-    : _session(session), _sessionPool(sessionPool) {}
+MobileStatementCache::~MobileStatementCache() {
+    for (auto&& entry : _statements) {
+        sqlite3_finalize(entry.second);
+    }
+}
+
+sqlite3_stmt* MobileStatementCache::checkOut(StringData sql) {
+    auto it = _statements.find(sql.toString());
+    if (it == _statements.end()) {
+        return nullptr;
+    }
+
+    sqlite3_stmt* stmt = it->second;
+    _statements.erase(it);
+    return stmt;
+}
+
+void MobileStatementCache::checkIn(StringData sql, sqlite3_stmt* stmt) {
+    if (_statements.size() >= kMaxCachedStatements) {
+        sqlite3_finalize(stmt);
+        return;
+    }
+
+    bool inserted = _statements.emplace(sql.toString(), stmt).second;
+    if (!inserted) {
+        sqlite3_finalize(stmt);
+    }
+}
+
+MobileSession::MobileSession(sqlite3* session,
+                             MobileSessionPool* sessionPool,
+                             MobileStatementCache* statementCache)
+    : _session(session), _sessionPool(sessionPool), _statementCache(statementCache) {}
 
 MobileSession::~MobileSession() {
     // Releases this session back to the session pool.
@@ -47,4 +78,8 @@ MobileSession::~MobileSession() {
 sqlite3* MobileSession::getSession() const {
     return _session;
 }
+
+MobileStatementCache* MobileSession::getStatementCache() const {
+    return _statementCache;
+}
 }  // namespace mongo
@@ -32,11 +32,46 @@
 #include <sqlite3.h>
 #include <string>
 
+#include "mongo/base/string_data.h"
 #include "mongo/db/storage/mobile/mobile_session_pool.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 class MobileSessionPool;
 
+/**
+ * Keeps prepared statements of a SQLite connection for reuse, keyed by their SQL text. It is only
+ * used by the operation holding the connection, so it needs no synchronization.
+ */
+class MobileStatementCache final {
+    MobileStatementCache(const MobileStatementCache&) = delete;
+    MobileStatementCache& operator=(const MobileStatementCache&) = delete;
+
+public:
+    static constexpr std::size_t kMaxCachedStatements = 64;
+
+    MobileStatementCache() = default;
+
+    /**
+     * Finalizes all cached statements. Must be called before the connection is closed.
+     */
+    ~MobileStatementCache();
+
+    /**
+     * Removes and returns a cached statement for 'sql', or returns nullptr if there is none.
+     */
+    sqlite3_stmt* checkOut(StringData sql);
+
+    /**
+     * Caches 'stmt', which must be reset, for reuse by a later statement with the same SQL text.
+     * Finalizes it instead if the cache is full or already holds a statement for 'sql'.
+     */
+    void checkIn(StringData sql, sqlite3_stmt* stmt);
+
+private:
+    stdx::unordered_map<std::string, sqlite3_stmt*> _statements;
+};
+
 /**
  * This class manages a SQLite database connection object.
  */
@@ -45,7 +80,9 @@ class MobileSession final {
     MobileSession& operator=(const MobileSession&) = delete;
 
 public:
-    MobileSession(sqlite3* session, MobileSessionPool* sessionPool);
+    MobileSession(sqlite3* session,
+                  MobileSessionPool* sessionPool,
+                  MobileStatementCache* statementCache = nullptr);
 
     ~MobileSession();
 
@@ -54,8 +91,14 @@ public:
      */
     sqlite3* getSession() const;
 
+    /**
+     * Returns the prepared statement cache of the connection, or nullptr if it has none.
+     */
+    MobileStatementCache* getStatementCache() const;
+
 private:
     sqlite3* _session;
     MobileSessionPool* _sessionPool;
+    MobileStatementCache* _statementCache;
 };
 }  // namespace mongo
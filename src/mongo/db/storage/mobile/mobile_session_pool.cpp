@@ -114,7 +114,7 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
     // Checks if there is an open session available.
     if (!_sessions.empty()) {
         sqlite3* session = _popSession_inlock();
-        return std::make_unique<MobileSession>(session, this);
+        return std::make_unique<MobileSession>(session, this, _statementCaches[session].get());
     }
 
     // Checks if a new session can be opened.
@@ -124,7 +124,9 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
         embedded::checkStatus(status, SQLITE_OK, "sqlite3_open");
         embedded::configureSession(session, _options);
         _curPoolSize++;
-        return std::make_unique<MobileSession>(session, this);
+        auto& statementCache = _statementCaches[session];
+        statementCache = std::make_unique<MobileStatementCache>();
+        return std::make_unique<MobileSession>(session, this, statementCache.get());
     }
 
     // There are no open sessions available and the maxPoolSize has been reached.
@@ -133,7 +135,7 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
         _releasedSessionNotifier, lk, [&] { return !_sessions.empty(); });
 
     sqlite3* session = _popSession_inlock();
-    return std::make_unique<MobileSession>(session, this);
+    return std::make_unique<MobileSession>(session, this, _statementCaches[session].get());
 }
 
 void MobileSessionPool::releaseSession(MobileSession* session) {
@@ -176,6 +178,8 @@ void MobileSessionPool::shutDown() {
         sqlite3_close(session);
     }
 
+    // Cached statements must be finalized before their connection can be closed.
+    _statementCaches.clear();
     for (auto&& session : _sessions) {
         sqlite3_close(session);
     }
@@ -38,9 +38,11 @@
 #include "mongo/db/storage/mobile/mobile_options.h"
 #include "mongo/db/storage/mobile/mobile_session.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 class MobileSession;
+class MobileStatementCache;
 
 /**
  * This class manages a queue of operations delayed for some reason
@@ -122,5 +124,8 @@ private:
 
     using SessionPool = std::vector<sqlite3*>;
     SessionPool _sessions;
+
+    // The prepared statement cache of every open session.
+    stdx::unordered_map<sqlite3*, std::unique_ptr<MobileStatementCache>> _statementCaches;
 };
 }  // namespace mongo
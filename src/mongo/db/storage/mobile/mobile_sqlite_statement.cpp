@@ -55,6 +55,17 @@ void SqliteStatement::finalize() {
     if (!_stmt) {
         return;
     }
+
+    // sqlite3_reset() reports the error of the last step just like sqlite3_finalize(), so a
+    // statement which failed is finalized below and checked against _exceptionStatus.
+    if (_statementCache && _exceptionStatus == SQLITE_OK && sqlite3_reset(_stmt) == SQLITE_OK) {
+        SQLITE_STMT_TRACE() << "Caching: " << _sqlQuery.data();
+        sqlite3_clear_bindings(_stmt);
+        _statementCache->checkIn(StringData(_sqlQuery.data(), _sqlQuery.size() - 1), _stmt);
+        _stmt = nullptr;
+        return;
+    }
+
     SQLITE_STMT_TRACE() << "Finalize: " << _sqlQuery.data();
 
     int status = sqlite3_finalize(_stmt);
@@ -63,6 +74,15 @@ void SqliteStatement::finalize() {
 }
 
 void SqliteStatement::prepare(const MobileSession& session) {
+    _statementCache = session.getStatementCache();
+    if (_statementCache) {
+        _stmt = _statementCache->checkOut(StringData(_sqlQuery.data(), _sqlQuery.size() - 1));
+        if (_stmt) {
+            SQLITE_STMT_TRACE() << "Reusing: " << _sqlQuery.data();
+            return;
+        }
+    }
+
     SQLITE_STMT_TRACE() << "Preparing: " << _sqlQuery.data();
 
     int status = sqlite3_prepare_v2(
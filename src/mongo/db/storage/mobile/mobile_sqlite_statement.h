@@ -143,12 +143,14 @@ public:
     }
 
     /**
-     * Finalizes a prepared statement.
+     * Finalizes a prepared statement. A statement whose last step succeeded is reset and returned
+     * to the statement cache of its session instead.
      */
     void finalize();
 
     /**
-     * Prepare a statement with the given mobile session.
+     * Prepare a statement with the given mobile session, reusing a statement with the same SQL
+     * text from the session's statement cache if there is one.
      */
     void prepare(const MobileSession& session);
 
@@ -162,6 +164,9 @@ private:
     static AtomicWord<long long> _nextID;
     sqlite3_stmt* _stmt;
 
+    // The cache of the session that prepared _stmt, to which _stmt is returned when finalized.
+    MobileStatementCache* _statementCache = nullptr;
+
     // If the most recent call to sqlite3_step on this statement returned an error, the error is
     // returned again when the statement is finalized. This is used to verify that the last error
     // code returned matches the finalize error code, if there is any.
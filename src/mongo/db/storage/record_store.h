@@ -56,6 +56,10 @@ struct CompactOptions {
     // other
     bool validateDocuments = true;
 
+    // Compacts only the indexes of the collection, which storage engines that compact in place can
+    // do while the collection is read and written.
+    bool indexesOnly = false;
+
     std::string toString() const;
 };
 
@@ -205,6 +209,23 @@ public:
      */
     virtual boost::optional<Record> seekExact(const RecordId& id) = 0;
 
+    /**
+     * Seeks to the first Record whose id is at or after 'id', and returns it, or boost::none if
+     * there is no such Record. Only supported on forward cursors.
+     *
+     * The default implementation must be called before the cursor has returned any Record, and
+     * simply iterates until it passes 'id'. Storage engines which can position a cursor on an
+     * inexact key should override it.
+     */
+    virtual boost::optional<Record> seekAtOrAfter(const RecordId& id) {
+        while (auto record = next()) {
+            if (record->id >= id) {
+                return record;
+            }
+        }
+        return boost::none;
+    }
+
     /**
      * Prepares for state changes in underlying data without necessarily saving the current
      * state.
@@ -540,6 +561,14 @@ public:
                       "this storage engine does not support touch");
     }
 
+    /**
+     * Hints that the records with the given ids are about to be read, in no particular order, so
+     * that the storage engine can bring them into its cache ahead of time with fewer, better
+     * ordered reads than fetching them one at a time would issue. This is purely advisory: ids
+     * which do not exist are ignored, and the default implementation does nothing.
+     */
+    virtual void prefetch(OperationContext* opCtx, const std::vector<RecordId>& ids) const {}
+
     /**
      * Return the RecordId of an oplog entry as close to startingPosition as possible without
      * being higher. If there are no entries <= startingPosition, return RecordId().
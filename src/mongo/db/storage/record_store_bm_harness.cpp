@@ -0,0 +1,261 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/record_store_bm_harness.h"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxThreads = 16;
+const int kNumRecords = 10000;
+const int kScanLength = 100;
+
+/**
+ * The state of one benchmark run, shared by all of its threads. Thread 0 creates it before the
+ * timed loop and destroys it afterwards, and the barriers at the start and the end of the loop
+ * order this against the other threads, which only use it inside the loop.
+ */
+class RecordStoreBenchmark {
+public:
+    struct ThreadState {
+        ThreadState(ServiceContext::UniqueClient client,
+                    ServiceContext::UniqueOperationContext opCtx,
+                    int32_t seed)
+            : client(std::move(client)), opCtx(std::move(opCtx)), random(seed) {}
+
+        ServiceContext::UniqueClient client;
+        ServiceContext::UniqueOperationContext opCtx;
+        std::unique_ptr<SeekableRecordCursor> cursor;
+        PseudoRandom random;
+    };
+
+    /**
+     * Creates a record store holding 'numRecords' records of 'state.range(0)' bytes, and an
+     * OperationContext for each thread, positioned on the first record if 'withCursors' is true.
+     */
+    void setUp(const benchmark::State& state, int numRecords, bool withCursors) {
+        _harness = newRecordStoreHarnessHelper();
+        _rs = _harness->newNonCappedRecordStore();
+        _supportsDocLocking = _harness->supportsDocLocking();
+        _value = std::string(state.range(0), 'x');
+
+        if (numRecords > 0) {
+            auto opCtx = _harness->newOperationContext();
+            WriteUnitOfWork wuow(opCtx.get());
+            for (int i = 0; i < numRecords; ++i) {
+                _recordIds.push_back(uassertStatusOK(
+                    _rs->insertRecord(opCtx.get(), _value.data(), _value.size(), Timestamp())));
+            }
+            wuow.commit();
+        }
+
+        _threads.reserve(state.threads);
+        for (int i = 0; i < state.threads; ++i) {
+            auto client = _harness->serviceContext()->makeClient(
+                str::stream() << "RecordStoreBenchmark thread " << i);
+            auto opCtx = _harness->newOperationContext(client.get());
+            _threads.emplace_back(std::move(client), std::move(opCtx), i);
+            if (withCursors) {
+                auto& thread = _threads.back();
+                thread.cursor = _rs->getCursor(thread.opCtx.get());
+                invariant(thread.cursor->seekExact(_recordIds.front()));
+            }
+        }
+    }
+
+    void tearDown() {
+        _threads.clear();
+        _recordIds.clear();
+        _rs.reset();
+        _harness.reset();
+    }
+
+    ThreadState& thread(const benchmark::State& state) {
+        return _threads[state.thread_index];
+    }
+
+    /**
+     * Returns a random record followed by at least 'trailing' - 1 other records.
+     */
+    const RecordId& randomRecordId(ThreadState& thread, int trailing = 1) const {
+        return _recordIds[thread.random.nextInt32(_recordIds.size() - trailing + 1)];
+    }
+
+    const RecordId& firstRecordId() const {
+        return _recordIds.front();
+    }
+
+    /**
+     * Inserts a record in its own WriteUnitOfWork, retrying on write conflicts. Writers are
+     * serialized when the record store does not support document-level locking, as the
+     * collection lock would do.
+     */
+    void insert(OperationContext* opCtx) {
+        stdx::unique_lock<stdx::mutex> lk(_writeMutex, stdx::defer_lock);
+        if (!_supportsDocLocking) {
+            lk.lock();
+        }
+
+        while (true) {
+            try {
+                WriteUnitOfWork wuow(opCtx);
+                uassertStatusOK(
+                    _rs->insertRecord(opCtx, _value.data(), _value.size(), Timestamp()));
+                wuow.commit();
+                return;
+            } catch (const WriteConflictException&) {
+                opCtx->recoveryUnit()->abandonSnapshot();
+            }
+        }
+    }
+
+private:
+    std::unique_ptr<RecordStoreHarnessHelper> _harness;
+    std::unique_ptr<RecordStore> _rs;
+    bool _supportsDocLocking = false;
+    std::string _value;
+    std::vector<RecordId> _recordIds;
+    std::vector<ThreadState> _threads;
+    stdx::mutex _writeMutex;
+};
+
+void BM_Insert(benchmark::State& state) {
+    static RecordStoreBenchmark bm;
+    if (state.thread_index == 0) {
+        bm.setUp(state, 0, false);
+    }
+
+    for (auto keepRunning : state) {
+        bm.insert(bm.thread(state).opCtx.get());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    if (state.thread_index == 0) {
+        bm.tearDown();
+    }
+}
+
+void BM_SeekExact(benchmark::State& state) {
+    static RecordStoreBenchmark bm;
+    if (state.thread_index == 0) {
+        bm.setUp(state, kNumRecords, true);
+    }
+
+    for (auto keepRunning : state) {
+        auto& thread = bm.thread(state);
+        benchmark::DoNotOptimize(thread.cursor->seekExact(bm.randomRecordId(thread)));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index == 0) {
+        bm.tearDown();
+    }
+}
+
+void BM_RangeScan(benchmark::State& state) {
+    static RecordStoreBenchmark bm;
+    if (state.thread_index == 0) {
+        bm.setUp(state, kNumRecords, true);
+    }
+
+    for (auto keepRunning : state) {
+        auto& thread = bm.thread(state);
+        auto record = thread.cursor->seekExact(bm.randomRecordId(thread, kScanLength));
+        for (int i = 1; record && i < kScanLength; ++i) {
+            record = thread.cursor->next();
+        }
+        benchmark::DoNotOptimize(record);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kScanLength);
+    state.SetBytesProcessed(state.iterations() * kScanLength * state.range(0));
+    if (state.thread_index == 0) {
+        bm.tearDown();
+    }
+}
+
+void BM_SaveRestore(benchmark::State& state) {
+    static RecordStoreBenchmark bm;
+    if (state.thread_index == 0) {
+        bm.setUp(state, kNumRecords, true);
+    }
+
+    for (auto keepRunning : state) {
+        auto& thread = bm.thread(state);
+        thread.cursor->save();
+        invariant(thread.cursor->restore());
+        if (!thread.cursor->next()) {
+            thread.cursor->seekExact(bm.firstRecordId());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index == 0) {
+        bm.tearDown();
+    }
+}
+
+}  // namespace
+
+void registerRecordStoreHarnessBenchmarks(StringData engineName) {
+    auto registerBenchmark = [engineName](StringData name, void (*fn)(benchmark::State&)) {
+        const std::string fullName = str::stream() << "BM_RecordStore" << name << "/"
+                                                   << engineName;
+        return benchmark::RegisterBenchmark(fullName.c_str(), fn)
+            ->ArgName("valueSize")
+            ->Arg(16)
+            ->Arg(256)
+            ->Arg(4096)
+            ->ThreadRange(1, kMaxThreads)
+            ->UseRealTime();
+    };
+
+    // Every insert is kept until the end of the run, so bound the number of them.
+    registerBenchmark("Insert", BM_Insert)->Iterations(kNumRecords);
+    registerBenchmark("SeekExact", BM_SeekExact);
+    registerBenchmark("RangeScan", BM_RangeScan);
+    registerBenchmark("SaveRestore", BM_SaveRestore);
+}
+
+}  // namespace mongo
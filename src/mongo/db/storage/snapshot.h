@@ -56,6 +56,10 @@ public:
         return _id != other._id;
     }
 
+    uint64_t toNumber() const {
+        return _id;
+    }
+
     std::string toString() const {
         return std::to_string(_id);
     }
@@ -0,0 +1,290 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/sorted_data_interface_bm_harness.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/db/storage/sorted_data_interface_test_harness.h"
+#include "mongo/platform/random.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxThreads = 16;
+const int kNumKeys = 10000;
+const int kScanLength = 100;
+const size_t kKeyDigits = 10;
+
+/**
+ * Returns the 'i'th key of an index, as a string of 'keySize' bytes which starts with 'i' padded
+ * with zeros so that the keys sort in the order of 'i'.
+ */
+BSONObj makeKey(int i, int64_t keySize) {
+    const std::string digits = std::to_string(i);
+    std::string value = std::string(kKeyDigits - digits.size(), '0') + digits;
+    value.resize(std::max(static_cast<size_t>(keySize), kKeyDigits), 'x');
+    return BSON("" << value);
+}
+
+std::vector<BSONObj> makeKeys(int numKeys, int64_t keySize) {
+    std::vector<BSONObj> keys;
+    keys.reserve(numKeys);
+    for (int i = 0; i < numKeys; ++i) {
+        keys.push_back(makeKey(i, keySize));
+    }
+    return keys;
+}
+
+/**
+ * The state of one benchmark run, shared by all of its threads. Thread 0 creates it before the
+ * timed loop and destroys it afterwards, and the barriers at the start and the end of the loop
+ * order this against the other threads, which only use it inside the loop.
+ */
+class SortedDataInterfaceBenchmark {
+public:
+    struct ThreadState {
+        ThreadState(ServiceContext::UniqueClient client,
+                    ServiceContext::UniqueOperationContext opCtx,
+                    int32_t seed)
+            : client(std::move(client)), opCtx(std::move(opCtx)), random(seed) {}
+
+        ServiceContext::UniqueClient client;
+        ServiceContext::UniqueOperationContext opCtx;
+        std::unique_ptr<SortedDataInterface::Cursor> cursor;
+        PseudoRandom random;
+    };
+
+    /**
+     * Creates an index holding 'numKeys' keys of 'state.range(0)' bytes, and an
+     * OperationContext for each thread, with a cursor positioned on the first key if 'withCursors'
+     * is true. The keys of an index which starts empty are generated for the run to insert.
+     */
+    void setUp(const benchmark::State& state, int numKeys, bool withCursors) {
+        _harness = newSortedDataInterfaceHarnessHelper();
+        _sorted = _harness->newSortedDataInterface(/*unique=*/false, /*partial=*/false);
+        _keys = makeKeys(numKeys > 0 ? numKeys : kNumKeys, state.range(0));
+
+        if (numKeys > 0) {
+            auto opCtx = _harness->newOperationContext();
+            WriteUnitOfWork wuow(opCtx.get());
+            for (int i = 0; i < numKeys; ++i) {
+                uassertStatusOK(_sorted->insert(opCtx.get(), _keys[i], RecordId(i + 1), true));
+            }
+            wuow.commit();
+        }
+
+        _threads.reserve(state.threads);
+        for (int i = 0; i < state.threads; ++i) {
+            auto client = _harness->serviceContext()->makeClient(
+                str::stream() << "SortedDataInterfaceBenchmark thread " << i);
+            auto opCtx = _harness->newOperationContext(client.get());
+            _threads.emplace_back(std::move(client), std::move(opCtx), i);
+            if (withCursors) {
+                auto& thread = _threads.back();
+                thread.cursor = _sorted->newCursor(thread.opCtx.get());
+                invariant(thread.cursor->seek(_keys.front(), true));
+            }
+        }
+    }
+
+    void tearDown() {
+        _threads.clear();
+        _keys.clear();
+        _sorted.reset();
+        _harness.reset();
+    }
+
+    ThreadState& thread(const benchmark::State& state) {
+        return _threads[state.thread_index];
+    }
+
+    SortedDataInterface* sorted() const {
+        return _sorted.get();
+    }
+
+    const std::vector<BSONObj>& keys() const {
+        return _keys;
+    }
+
+    /**
+     * Returns a random key followed by at least 'trailing' - 1 other keys.
+     */
+    const BSONObj& randomKey(ThreadState& thread, int trailing = 1) const {
+        return _keys[thread.random.nextInt32(_keys.size() - trailing + 1)];
+    }
+
+private:
+    std::unique_ptr<SortedDataInterfaceHarnessHelper> _harness;
+    std::unique_ptr<SortedDataInterface> _sorted;
+    std::vector<BSONObj> _keys;
+    std::vector<ThreadState> _threads;
+};
+
+void BM_Insert(benchmark::State& state) {
+    static SortedDataInterfaceBenchmark bm;
+    bm.setUp(state, 0, false);
+
+    auto opCtx = bm.thread(state).opCtx.get();
+    size_t i = 0;
+    for (auto keepRunning : state) {
+        WriteUnitOfWork wuow(opCtx);
+        uassertStatusOK(bm.sorted()->insert(opCtx, bm.keys()[i], RecordId(i + 1), true));
+        wuow.commit();
+        ++i;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    bm.tearDown();
+}
+
+void BM_SeekExact(benchmark::State& state) {
+    static SortedDataInterfaceBenchmark bm;
+    if (state.thread_index == 0) {
+        bm.setUp(state, kNumKeys, true);
+    }
+
+    for (auto keepRunning : state) {
+        auto& thread = bm.thread(state);
+        benchmark::DoNotOptimize(thread.cursor->seekExact(bm.randomKey(thread)));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index == 0) {
+        bm.tearDown();
+    }
+}
+
+void BM_RangeScan(benchmark::State& state) {
+    static SortedDataInterfaceBenchmark bm;
+    if (state.thread_index == 0) {
+        bm.setUp(state, kNumKeys, true);
+    }
+
+    for (auto keepRunning : state) {
+        auto& thread = bm.thread(state);
+        auto entry = thread.cursor->seek(bm.randomKey(thread, kScanLength), true);
+        for (int i = 1; entry && i < kScanLength; ++i) {
+            entry = thread.cursor->next();
+        }
+        benchmark::DoNotOptimize(entry);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kScanLength);
+    if (state.thread_index == 0) {
+        bm.tearDown();
+    }
+}
+
+void BM_SaveRestore(benchmark::State& state) {
+    static SortedDataInterfaceBenchmark bm;
+    if (state.thread_index == 0) {
+        bm.setUp(state, kNumKeys, true);
+    }
+
+    for (auto keepRunning : state) {
+        auto& thread = bm.thread(state);
+        thread.cursor->save();
+        thread.cursor->restore();
+        if (!thread.cursor->next()) {
+            thread.cursor->seek(bm.keys().front(), true);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index == 0) {
+        bm.tearDown();
+    }
+}
+
+void BM_BulkBuild(benchmark::State& state) {
+    const std::vector<BSONObj> keys = makeKeys(kNumKeys, state.range(0));
+
+    for (auto keepRunning : state) {
+        // Each build gets a harness of its own, since some engines keep the keys of an index
+        // after it is destroyed.
+        state.PauseTiming();
+        auto harness = newSortedDataInterfaceHarnessHelper();
+        auto sorted = harness->newSortedDataInterface(/*unique=*/false, /*partial=*/false);
+        auto opCtx = harness->newOperationContext();
+        state.ResumeTiming();
+
+        std::unique_ptr<SortedDataBuilderInterface> builder(
+            sorted->getBulkBuilder(opCtx.get(), true));
+        for (size_t i = 0; i < keys.size(); ++i) {
+            uassertStatusOK(builder->addKey(keys[i], RecordId(i + 1)));
+        }
+        builder->commit(false);
+
+        state.PauseTiming();
+        builder.reset();
+        opCtx.reset();
+        sorted.reset();
+        harness.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * kNumKeys);
+    state.SetBytesProcessed(state.iterations() * kNumKeys * state.range(0));
+}
+
+}  // namespace
+
+void registerSortedDataInterfaceHarnessBenchmarks(StringData engineName) {
+    auto registerBenchmark = [engineName](StringData name, void (*fn)(benchmark::State&)) {
+        const std::string fullName = str::stream() << "BM_SortedDataInterface" << name << "/"
+                                                   << engineName;
+        return benchmark::RegisterBenchmark(fullName.c_str(), fn)
+            ->ArgName("keySize")
+            ->Arg(16)
+            ->Arg(256)
+            ->Arg(1024)
+            ->UseRealTime();
+    };
+
+    // The harness does not say whether an index supports concurrent writers, so the writes are
+    // only measured from a single thread.
+    registerBenchmark("Insert", BM_Insert)->Iterations(kNumKeys);
+    registerBenchmark("BulkBuild", BM_BulkBuild);
+
+    registerBenchmark("SeekExact", BM_SeekExact)->ThreadRange(1, kMaxThreads);
+    registerBenchmark("RangeScan", BM_RangeScan)->ThreadRange(1, kMaxThreads);
+    registerBenchmark("SaveRestore", BM_SaveRestore)->ThreadRange(1, kMaxThreads);
+}
+
+}  // namespace mongo
@@ -464,6 +464,20 @@ public:
      */
     virtual void setCacheOverflowTableInsertCountForTest(int insertCount) {}
 
+    /**
+     * Returns the fraction, between 0 and 1, of the storage engine's cache that holds dirty data.
+     * A cache filling up with dirty data also indicates cache pressure, before the cache overflow
+     * table is written to.
+     */
+    virtual double getCacheDirtyRatio(OperationContext* opCtx) const {
+        return 0;
+    }
+
+    /**
+     * For unit tests only. Sets the ratio that the getCacheDirtyRatio() function above returns.
+     */
+    virtual void setCacheDirtyRatioForTest(double dirtyRatio) {}
+
     /**
      *  Notifies the storage engine that a replication batch has completed.
      *  This means that all the writes associated with the oplog entries in the batch are
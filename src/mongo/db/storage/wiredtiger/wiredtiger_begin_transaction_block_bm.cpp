@@ -39,6 +39,7 @@
 #include "mongo/db/storage/recovery_unit_test_harness.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_begin_transaction_block.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
@@ -46,6 +47,7 @@
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/processinfo.h"
 
 namespace mongo {
 namespace {
@@ -141,6 +143,31 @@ void BM_setTimestamp(benchmark::State& state) {
     }
 }
 
+/**
+ * Benchmark getting a session from the session cache and releasing it straight back, as every
+ * operation does. All threads share one session cache, whose idle sessions are spread across the
+ * number of shards given as the argument.
+ */
+void BM_WiredTigerSessionChurn(benchmark::State& state) {
+    static std::unique_ptr<WiredTigerTestHelper> helper;
+    if (state.thread_index == 0) {
+        gWiredTigerSessionCacheShards.store(state.range(0));
+        helper = std::make_unique<WiredTigerTestHelper>();
+    }
+
+    for (auto _ : state) {
+        auto session = helper->getSessionCache()->getSession();
+        benchmark::DoNotOptimize(session.get());
+    }
+
+    if (state.thread_index == 0) {
+        state.counters["steals"] = helper->getSessionCache()->getSessionSteals();
+        state.counters["misses"] = helper->getSessionCache()->getSessionMisses();
+        helper.reset();
+        gWiredTigerSessionCacheShards.store(1);
+    }
+}
+
 BENCHMARK(BM_WiredTigerBeginTxnBlock);
 BENCHMARK_TEMPLATE(BM_WiredTigerBeginTxnBlockWithArgs,
                    PrepareConflictBehavior::kEnforce,
@@ -163,5 +190,11 @@ BENCHMARK_TEMPLATE(BM_WiredTigerBeginTxnBlockWithArgs,
 
 BENCHMARK(BM_setTimestamp);
 
+BENCHMARK(BM_WiredTigerSessionChurn)
+    ->ThreadRange(1, ProcessInfo::getNumAvailableCores())
+    ->ArgName("shards")
+    ->Arg(1)
+    ->Arg(16);
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ftdc_collector.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/ftdc/collector.h"
+#include "mongo/db/ftdc/controller.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+const char kStatisticsURI[] = "statistics:";
+const char kStatisticsConfig[] = "statistics=(fast)";
+
+class WiredTigerStatisticsFTDCCollector final : public FTDCMetricsCollectorInterface {
+public:
+    std::string name() const override {
+        return "wiredTigerStatistics";
+    }
+
+    /**
+     * Appends the statistics as WiredTigerUtil::exportTableToBSON does for serverStatus, and
+     * records where each one is among the metrics FTDC extracts from them.
+     */
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override {
+        _keys.clear();
+        _slots.clear();
+        _numSlots = 0;
+
+        Lock::GlobalLock lk(opCtx, LockMode::MODE_IS);
+        WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn()->getSession();
+
+        WT_CURSOR* cursor = nullptr;
+        int ret =
+            session->open_cursor(session, kStatisticsURI, nullptr, kStatisticsConfig, &cursor);
+        if (ret != 0) {
+            builder.append("error", "unable to retrieve statistics");
+            builder.append("reason", wiredtiger_strerror(ret));
+            return;
+        }
+        ON_BLOCK_EXIT([&] { cursor->close(cursor); });
+
+        struct Statistic {
+            std::string name;
+            long long value;
+        };
+
+        // Statistics without a category go first, then each category in order of their names.
+        std::vector<Statistic> uncategorized;
+        std::vector<size_t> uncategorizedPositions;
+        std::map<std::string, std::vector<std::pair<Statistic, size_t>>> categories;
+
+        int key;
+        const char* desc;
+        uint64_t value;
+        while (cursor->next(cursor) == 0 && cursor->get_key(cursor, &key) == 0 &&
+               cursor->get_value(cursor, &desc, nullptr, &value) == 0) {
+            const size_t position = _keys.size();
+            _keys.push_back(key);
+            _slots.push_back(-1);
+
+            StringData description(desc);
+            StringData prefix;
+            StringData suffix;
+            size_t idx = description.find(':');
+            if (idx == std::string::npos) {
+                idx = description.find(' ');
+            }
+            if (idx != std::string::npos) {
+                prefix = description.substr(0, idx);
+                suffix = description.substr(idx + 1);
+            } else {
+                prefix = description;
+                suffix = "num";
+            }
+
+            Statistic statistic{str::ltrim(suffix).toString(),
+                                WiredTigerUtil::castStatisticsValue<long long>(value)};
+            if (prefix.empty()) {
+                uncategorized.push_back({description.toString(), statistic.value});
+                uncategorizedPositions.push_back(position);
+            } else if (prefix != "LSM") {
+                categories[prefix.toString()].emplace_back(std::move(statistic), position);
+            }
+        }
+
+        builder.append("uri", kStatisticsURI);
+        for (size_t i = 0; i < uncategorized.size(); ++i) {
+            builder.appendNumber(uncategorized[i].name, uncategorized[i].value);
+            _slots[uncategorizedPositions[i]] = _numSlots++;
+        }
+        for (const auto& category : categories) {
+            BSONObjBuilder sub(builder.subobjStart(category.first));
+            for (const auto& statistic : category.second) {
+                sub.appendNumber(statistic.first.name, statistic.first.value);
+                _slots[statistic.second] = _numSlots++;
+            }
+        }
+    }
+
+    bool collectMetrics(OperationContext* opCtx, std::vector<std::uint64_t>* metrics) override {
+        if (_keys.empty()) {
+            return false;
+        }
+
+        Lock::GlobalLock lk(opCtx, LockMode::MODE_IS);
+        WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn()->getSession();
+
+        WT_CURSOR* cursor = nullptr;
+        if (session->open_cursor(session, kStatisticsURI, nullptr, kStatisticsConfig, &cursor)) {
+            return false;
+        }
+        ON_BLOCK_EXIT([&] { cursor->close(cursor); });
+
+        const size_t base = metrics->size();
+        metrics->resize(base + _numSlots);
+
+        size_t position = 0;
+        int key;
+        const char* desc;
+        uint64_t value;
+        while (cursor->next(cursor) == 0) {
+            if (cursor->get_key(cursor, &key) != 0 || position == _keys.size() ||
+                key != _keys[position] ||
+                cursor->get_value(cursor, &desc, nullptr, &value) != 0) {
+                return false;
+            }
+
+            if (_slots[position] >= 0) {
+                (*metrics)[base + _slots[position]] =
+                    WiredTigerUtil::castStatisticsValue<long long>(value);
+            }
+            ++position;
+        }
+
+        return position == _keys.size();
+    }
+
+private:
+    // The statistics keys in the order the cursor returned them in the last call to collect(),
+    // and the position of each one's value among the metrics, or -1 for those left out.
+    std::vector<int> _keys;
+    std::vector<int> _slots;
+    int _numSlots{0};
+};
+
+}  // namespace
+
+void registerWiredTigerStatisticsFTDCCollector() {
+    FTDCController::registerCollectorsOnStart([](FTDCController* controller) {
+        controller->addPeriodicCollector(std::make_unique<WiredTigerStatisticsFTDCCollector>());
+    });
+}
+
+}  // namespace mongo
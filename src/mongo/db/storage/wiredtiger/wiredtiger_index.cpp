@@ -48,6 +48,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -649,7 +650,7 @@ private:
  */
 class WiredTigerIndex::UniqueBulkBuilder : public BulkBuilder {
 public:
-    UniqueBulkBuilder(WiredTigerIndex* idx,
+    UniqueBulkBuilder(WiredTigerIndexUnique* idx,
                       OperationContext* opCtx,
                       bool dupsAllowed,
                       KVPrefix prefix)
@@ -696,6 +697,12 @@ private:
 
         _keyString.resetToKey(newKey, _idx->ordering(), id);
 
+        if (auto keyFilter = _idx->keyFilter()) {
+            keyFilter->add(_keyString.getBuffer(),
+                           KeyString::sizeWithoutRecordIdAtEnd(_keyString.getBuffer(),
+                                                               _keyString.getSize()));
+        }
+
         // Can't use WiredTigerCursor since we aren't using the cache.
         WiredTigerItem keyItem(_keyString.getBuffer(), _keyString.getSize());
         setKey(_cursor, keyItem.Get());
@@ -780,7 +787,7 @@ private:
         return SpecialFormatInserted::NoSpecialFormatInserted;
     }
 
-    WiredTigerIndex* _idx;
+    WiredTigerIndexUnique* _idx;
     const bool _dupsAllowed;
     KeyString _keyString;
     std::vector<std::pair<RecordId, KeyString::TypeBits>> _records;
@@ -1245,7 +1252,34 @@ WiredTigerIndexUnique::WiredTigerIndexUnique(OperationContext* ctx,
                                              const IndexDescriptor* desc,
                                              KVPrefix prefix,
                                              bool isReadOnly)
-    : WiredTigerIndex(ctx, uri, desc, prefix, isReadOnly), _partial(desc->isPartial()) {}
+    : WiredTigerIndex(ctx, uri, desc, prefix, isReadOnly), _partial(desc->isPartial()) {
+    // The filter must hold every key in the index before any insert relies on it, so it is only
+    // built while the index is being opened. This happens at startup, when the index is created,
+    // or with the collection locked exclusively, so no other operation can insert keys meanwhile.
+    if (gWiredTigerUniqueIndexKeyFilter && !isReadOnly && isTimestampSafeUniqueIdx() &&
+        prefix == KVPrefix::kNotPrefixed) {
+        _buildKeyFilter(ctx);
+    }
+}
+
+void WiredTigerIndexUnique::_buildKeyFilter(OperationContext* opCtx) {
+    // Most unique indexes are small. The filter adds larger layers as the index grows.
+    const size_t kInitialKeyFilterCapacity = 64 * 1024;
+    _keyFilter = std::make_unique<WiredTigerIndexKeyFilter>(kInitialKeyFilterCapacity);
+
+    // The cursor returns the keys of entries in either unique index format.
+    auto cursor = newCursor(opCtx, true);
+    long long numKeys = 0;
+    for (auto kv = cursor->seek(BSONObj(), true, SortedDataInterface::Cursor::kWantKey); kv;
+         kv = cursor->next(SortedDataInterface::Cursor::kWantKey)) {
+        const KeyString prefixKey(keyStringVersion(), kv->key, _ordering);
+        _keyFilter->add(prefixKey.getBuffer(), prefixKey.getSize());
+        ++numKeys;
+    }
+
+    LOG(1) << "Built a filter over " << numKeys << " keys of unique index " << _indexName
+           << " (" << _uri << ") in " << _keyFilter->numLayers() << " layers";
+}
 
 std::unique_ptr<SortedDataInterface::Cursor> WiredTigerIndexUnique::newCursor(
     OperationContext* opCtx, bool forward) const {
@@ -1475,13 +1509,28 @@ StatusWith<SpecialFormatInserted> WiredTigerIndexUnique::_insertTimestampSafe(
         ret = WT_OP_CHECK(c->remove(c));
         invariantWTOK(ret);
 
+        // Every transaction which inserted this key and committed before our snapshot began added
+        // it to the filter first, and the first phase conflicts with those which did not commit
+        // before it. So if the filter has never seen the key, neither has our snapshot.
+        const bool mightExist =
+            !_keyFilter || _keyFilter->mightContain(prefixKey.getBuffer(), prefixKey.getSize());
+        if (_keyFilter) {
+            _keyFilter->add(prefixKey.getBuffer(), prefixKey.getSize());
+        }
+
         // Second phase looks up for existence of key to avoid insertion of duplicate key
-        if (_keyExists(opCtx, c, prefixKey))
+        if (mightExist && _keyExists(opCtx, c, prefixKey))
             return buildDupKeyErrorStatus(key, _collectionNamespace, _indexName, _keyPattern);
     }
 
     // Now create the table key/value, the actual data record.
     KeyString tableKey(keyStringVersion(), key, _ordering, id);
+
+    if (_keyFilter && dupsAllowed) {
+        _keyFilter->add(tableKey.getBuffer(),
+                        KeyString::sizeWithoutRecordIdAtEnd(tableKey.getBuffer(),
+                                                            tableKey.getSize()));
+    }
     WiredTigerItem keyItem(tableKey.getBuffer(), tableKey.getSize());
 
     WiredTigerItem valueItem = tableKey.getTypeBits().isAllZeros()
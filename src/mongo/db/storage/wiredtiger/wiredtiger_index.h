@@ -36,6 +36,7 @@
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_index_key_filter.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 
@@ -210,6 +211,14 @@ public:
 
     bool isTimestampSafeUniqueIdx() const override;
 
+    /**
+     * Returns the filter over the keys inserted into this index, or null if this index does not
+     * keep one.
+     */
+    WiredTigerIndexKeyFilter* keyFilter() const {
+        return _keyFilter.get();
+    }
+
     bool isDup(OperationContext* opCtx, WT_CURSOR* c, const BSONObj& key) override;
 
     StatusWith<SpecialFormatInserted> _insert(OperationContext* opCtx,
@@ -254,7 +263,17 @@ private:
      */
     bool _keyExists(OperationContext* opCtx, WT_CURSOR* c, const KeyString& key);
 
+    /**
+     * Fills '_keyFilter' with the keys of every entry in the index.
+     */
+    void _buildKeyFilter(OperationContext* opCtx);
+
     bool _partial;
+
+    // When 'wiredTigerUniqueIndexKeyFilter' is set, holds every key inserted into this timestamp
+    // safe unique index, so that inserts of keys which the index has never held need not search
+    // it for duplicates.
+    std::unique_ptr<WiredTigerIndexKeyFilter> _keyFilter;
 };
 
 class WiredTigerIndexStandard : public WiredTigerIndex {
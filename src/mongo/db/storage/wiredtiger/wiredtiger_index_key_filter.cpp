@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_index_key_filter.h"
+
+#include <third_party/murmurhash3/MurmurHash3.h>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+// Ten bits and seven probes per key give a false positive rate of about one percent per layer.
+constexpr size_t kBitsPerKey = 10;
+constexpr size_t kNumProbes = 7;
+
+struct KeyHash {
+    uint64_t h1;
+    uint64_t h2;
+};
+
+KeyHash hashKey(const void* key, size_t size) {
+    uint64_t out[2];
+    MurmurHash3_x64_128(key, static_cast<int>(size), 0, out);
+    // An odd step visits kNumProbes distinct bits whatever the size of the layer.
+    return {out[0], out[1] | 1};
+}
+
+}  // namespace
+
+class WiredTigerIndexKeyFilter::Layer {
+public:
+    explicit Layer(size_t capacity)
+        : _capacity(capacity),
+          _numBits(capacity * kBitsPerKey),
+          _words(new AtomicWord<unsigned long long>[(_numBits + 63) / 64]) {}
+
+    /**
+     * Sets the bits of 'hash'. Returns true if the layer now holds at least as many keys as it has
+     * room for.
+     */
+    bool add(const KeyHash& hash) {
+        uint64_t bit = hash.h1;
+        for (size_t i = 0; i < kNumProbes; ++i, bit += hash.h2) {
+            const uint64_t index = bit % _numBits;
+            _words[index / 64].fetchAndBitOr(1ULL << (index % 64));
+        }
+        return _numKeys.fetchAndAdd(1) + 1 >= _capacity;
+    }
+
+    bool mightContain(const KeyHash& hash) const {
+        uint64_t bit = hash.h1;
+        for (size_t i = 0; i < kNumProbes; ++i, bit += hash.h2) {
+            const uint64_t index = bit % _numBits;
+            if (!(_words[index / 64].loadRelaxed() & (1ULL << (index % 64)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t capacity() const {
+        return _capacity;
+    }
+
+private:
+    const size_t _capacity;
+    const uint64_t _numBits;
+    std::unique_ptr<AtomicWord<unsigned long long>[]> _words;
+    AtomicWord<unsigned long long> _numKeys{0};
+};
+
+WiredTigerIndexKeyFilter::WiredTigerIndexKeyFilter(size_t initialCapacity) {
+    invariant(initialCapacity > 0);
+    _layers[0] = std::make_unique<Layer>(initialCapacity);
+    _numLayers.store(1);
+}
+
+WiredTigerIndexKeyFilter::~WiredTigerIndexKeyFilter() = default;
+
+void WiredTigerIndexKeyFilter::add(const void* key, size_t size) {
+    const auto hash = hashKey(key, size);
+    const unsigned numLayers = _numLayers.load();
+    if (!_layers[numLayers - 1]->add(hash) || numLayers == kMaxLayers) {
+        return;
+    }
+
+    // The newest layer is full. Whichever thread gets here first adds the next one; the others,
+    // and any thread which added a key to the full layer in the meantime, have nothing to do.
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_numLayers.load() != numLayers) {
+        return;
+    }
+    _layers[numLayers] = std::make_unique<Layer>(_layers[numLayers - 1]->capacity() * 2);
+    _numLayers.store(numLayers + 1);
+}
+
+bool WiredTigerIndexKeyFilter::mightContain(const void* key, size_t size) const {
+    const auto hash = hashKey(key, size);
+    const unsigned numLayers = _numLayers.load();
+    for (unsigned i = numLayers; i > 0; --i) {
+        if (_layers[i - 1]->mightContain(hash)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace mongo
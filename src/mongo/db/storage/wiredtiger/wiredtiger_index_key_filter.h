@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * A Bloom filter over the keys inserted into a unique index, which lets an insert skip the search
+ * for a duplicate of a key which the index has certainly never held. Keys are only ever added, so
+ * a key which was removed from the index may still test positive, but a key which was inserted
+ * never tests negative.
+ *
+ * The filter is made of layers, each of which has room for twice as many keys as the one before
+ * it. Keys are added to the newest layer, and a key might be present if any layer may contain it,
+ * so that the false positive rate stays low however many keys the index grows to.
+ *
+ * All methods may be called concurrently.
+ */
+class WiredTigerIndexKeyFilter {
+    WiredTigerIndexKeyFilter(const WiredTigerIndexKeyFilter&) = delete;
+    WiredTigerIndexKeyFilter& operator=(const WiredTigerIndexKeyFilter&) = delete;
+
+public:
+    /**
+     * Once this many layers exist, the newest one keeps taking keys past its capacity.
+     */
+    static constexpr size_t kMaxLayers = 24;
+
+    /**
+     * Creates an empty filter whose first layer has room for 'initialCapacity' keys.
+     */
+    explicit WiredTigerIndexKeyFilter(size_t initialCapacity);
+
+    ~WiredTigerIndexKeyFilter();
+
+    /**
+     * Adds the 'size' bytes at 'key' to the filter.
+     */
+    void add(const void* key, size_t size);
+
+    /**
+     * Returns false if the 'size' bytes at 'key' were certainly never added to the filter.
+     */
+    bool mightContain(const void* key, size_t size) const;
+
+    size_t numLayers() const {
+        return _numLayers.load();
+    }
+
+private:
+    class Layer;
+
+    std::array<std::unique_ptr<Layer>, kMaxLayers> _layers;
+
+    // Layers [0, _numLayers) are immutable once published, other than their bits.
+    AtomicWord<unsigned> _numLayers{0};
+
+    // Serializes the creation of new layers.
+    stdx::mutex _mutex;
+};
+
+}  // namespace mongo
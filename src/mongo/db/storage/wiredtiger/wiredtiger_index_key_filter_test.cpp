@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_index_key_filter.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::string makeKey(int i) {
+    return "key" + std::to_string(i);
+}
+
+TEST(WiredTigerIndexKeyFilterTest, EmptyFilterContainsNothing) {
+    WiredTigerIndexKeyFilter filter(16);
+    for (int i = 0; i < 100; ++i) {
+        const auto key = makeKey(i);
+        ASSERT_FALSE(filter.mightContain(key.data(), key.size()));
+    }
+}
+
+TEST(WiredTigerIndexKeyFilterTest, AddedKeysAreAlwaysContained) {
+    WiredTigerIndexKeyFilter filter(16);
+    for (int i = 0; i < 10000; ++i) {
+        const auto key = makeKey(i);
+        filter.add(key.data(), key.size());
+    }
+    // The filter grew past its first layer, and still holds every key.
+    ASSERT_GT(filter.numLayers(), 1U);
+    for (int i = 0; i < 10000; ++i) {
+        const auto key = makeKey(i);
+        ASSERT_TRUE(filter.mightContain(key.data(), key.size())) << key;
+    }
+}
+
+TEST(WiredTigerIndexKeyFilterTest, FewKeysWhichWereNotAddedAreContained) {
+    WiredTigerIndexKeyFilter filter(1024);
+    for (int i = 0; i < 10000; ++i) {
+        const auto key = makeKey(i);
+        filter.add(key.data(), key.size());
+    }
+    int falsePositives = 0;
+    for (int i = 10000; i < 20000; ++i) {
+        const auto key = makeKey(i);
+        falsePositives += filter.mightContain(key.data(), key.size());
+    }
+    // Each layer has a false positive rate of about one percent.
+    ASSERT_LT(falsePositives, 500);
+}
+
+TEST(WiredTigerIndexKeyFilterTest, ConcurrentAddsAreAllContained) {
+    WiredTigerIndexKeyFilter filter(16);
+    const int kNumThreads = 4;
+    const int kKeysPerThread = 5000;
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&filter, t] {
+            for (int i = t * kKeysPerThread; i < (t + 1) * kKeysPerThread; ++i) {
+                const auto key = makeKey(i);
+                filter.add(key.data(), key.size());
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    for (int i = 0; i < kNumThreads * kKeysPerThread; ++i) {
+        const auto key = makeKey(i);
+        ASSERT_TRUE(filter.mightContain(key.data(), key.size())) << key;
+    }
+}
+
+}  // namespace
+}  // namespace mongo
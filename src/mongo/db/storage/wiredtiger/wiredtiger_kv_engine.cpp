@@ -80,6 +80,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_adjuster.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
@@ -289,20 +290,20 @@ public:
         LOG(1) << "starting " << name() << " thread";
 
         while (!_shuttingDown.load()) {
-            {
-                stdx::unique_lock<stdx::mutex> lock(_mutex);
-                MONGO_IDLE_THREAD_BLOCK;
-                _condvar.wait_for(lock,
-                                  stdx::chrono::seconds(static_cast<std::int64_t>(
-                                      wiredTigerGlobalOptions.checkpointDelaySecs)));
-            }
+            const bool overDirtyBudget = _waitForNextCheckpoint();
 
             // Might have been awakened by another thread shutting us down.
             if (_shuttingDown.load()) {
                 break;
             }
 
+            // Flushing the size storer before the checkpoint puts the sizes in it as well.
+            _wiredTigerKVEngine->_flushSizeInfoInBatches();
+
             const Date_t startTime = Date_t::now();
+            const std::int64_t bytesWrittenBefore =
+                _getConnectionStat(WT_STAT_CONN_CACHE_BYTES_WRITE);
+            bool tookCheckpoint = true;
 
             const Timestamp stableTimestamp = _wiredTigerKVEngine->getStableTimestamp();
             const Timestamp initialDataTimestamp = _wiredTigerKVEngine->getInitialDataTimestamp();
@@ -347,6 +348,7 @@ public:
                            "a checkpoint. StableTimestamp: "
                         << stableTimestamp.toString()
                         << " InitialDataTimestamp: " << initialDataTimestamp.toString();
+                    tookCheckpoint = false;
                 } else {
                     auto oplogNeededForRollback = _wiredTigerKVEngine->getOplogNeededForRollback();
 
@@ -367,7 +369,15 @@ public:
                     }
                 }
 
-                const auto secondsElapsed = durationCount<Seconds>(Date_t::now() - startTime);
+                const auto elapsed = Date_t::now() - startTime;
+                if (tookCheckpoint) {
+                    _recordCheckpoint(
+                        elapsed,
+                        _getConnectionStat(WT_STAT_CONN_CACHE_BYTES_WRITE) - bytesWrittenBefore,
+                        overDirtyBudget);
+                }
+
+                const auto secondsElapsed = durationCount<Seconds>(elapsed);
                 if (secondsElapsed >= 30) {
                     LOG(1) << "Checkpoint took " << secondsElapsed << " seconds to complete.";
                 }
@@ -407,10 +417,25 @@ public:
             log() << "Triggering the first stable checkpoint. Initial Data: " << initialData
                   << " PrevStable: " << prevStable << " CurrStable: " << currStable;
             stdx::unique_lock<stdx::mutex> lock(_mutex);
+            _triggered = true;
             _condvar.notify_one();
         }
     }
 
+    /**
+     * Appends the number of checkpoints taken, how many of them were taken early because the
+     * cache held more dirty data than 'wiredTigerCheckpointDirtyBytesBudgetMB', and the duration
+     * and bytes written of the most recent one.
+     */
+    void appendStats(BSONObjBuilder* builder) const {
+        BSONObjBuilder bob(builder->subobjStart("checkpoints"));
+        bob.append("count", _numCheckpoints.load());
+        bob.append("overDirtyBudgetCount", _numOverDirtyBudgetCheckpoints.load());
+        bob.append("totalDurationMillis", _totalDurationMillis.load());
+        bob.append("lastDurationMillis", _lastDurationMillis.load());
+        bob.append("lastBytesWritten", _lastBytesWritten.load());
+    }
+
     std::uint64_t getOplogNeededForCrashRecovery() const {
         return _oplogNeededForCrashRecovery.load();
     }
@@ -430,19 +455,87 @@ public:
             stdx::unique_lock<stdx::mutex> lock(_mutex);
             // Wake up the checkpoint thread early, to take a final checkpoint before shutting
             // down, if one has not coincidentally just been taken.
+            _triggered = true;
             _condvar.notify_one();
         }
         wait();
     }
 
 private:
+    /**
+     * Waits until the next checkpoint is due: after 'checkpointDelaySecs' seconds, when woken up
+     * early, or, when 'wiredTigerCheckpointDirtyBytesBudgetMB' is positive, as soon as the cache
+     * holds more dirty data than the budget. Checking the budget once a second keeps each
+     * checkpoint from having to write out much more than it, instead of letting dirty data build up
+     * for the whole delay. Returns true if the checkpoint is due because of the budget.
+     */
+    bool _waitForNextCheckpoint() {
+        const Date_t deadline = Date_t::now() +
+            Seconds(static_cast<std::int64_t>(wiredTigerGlobalOptions.checkpointDelaySecs));
+
+        while (true) {
+            const std::int64_t dirtyBudgetBytes =
+                static_cast<std::int64_t>(gWiredTigerCheckpointDirtyBytesBudgetMB.load()) * 1024 *
+                1024;
+            auto wait = deadline - Date_t::now();
+            if (dirtyBudgetBytes > 0) {
+                wait = std::min(wait, Milliseconds(Seconds(1)));
+            }
+
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                if (wait > Milliseconds(0) &&
+                    _condvar.wait_for(lock, wait.toSystemDuration(), [&] { return _triggered; })) {
+                    _triggered = false;
+                    return false;
+                }
+                _triggered = false;
+            }
+
+            if (Date_t::now() >= deadline) {
+                return false;
+            }
+            if (dirtyBudgetBytes > 0 &&
+                _getConnectionStat(WT_STAT_CONN_CACHE_BYTES_DIRTY) > dirtyBudgetBytes) {
+                return true;
+            }
+        }
+    }
+
+    // Returns the value of the connection statistic 'statisticsKey', or 0 if it is unavailable.
+    std::int64_t _getConnectionStat(int statisticsKey) {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        auto result = WiredTigerUtil::getStatisticsValue(
+            session->getSession(), "statistics:", "statistics=(fast)", statisticsKey);
+        return result.isOK() ? result.getValue() : 0;
+    }
+
+    void _recordCheckpoint(Milliseconds duration, std::int64_t bytesWritten, bool overDirtyBudget) {
+        _numCheckpoints.fetchAndAdd(1);
+        if (overDirtyBudget) {
+            _numOverDirtyBudgetCheckpoints.fetchAndAdd(1);
+        }
+        _totalDurationMillis.fetchAndAdd(durationCount<Milliseconds>(duration));
+        _lastDurationMillis.store(durationCount<Milliseconds>(duration));
+        _lastBytesWritten.store(bytesWritten);
+    }
+
     WiredTigerKVEngine* _wiredTigerKVEngine;
     WiredTigerSessionCache* _sessionCache;
 
-    stdx::mutex _mutex;  // protects _condvar
+    stdx::mutex _mutex;  // protects _condvar and _triggered
     // The checkpoint thread idles on this condition variable for a particular time duration between
     // taking checkpoints. It can be triggered early to expediate immediate checkpointing.
     stdx::condition_variable _condvar;
+    bool _triggered = false;
+
+    // Use int64_t as these are serialized to bson which does not support unsigned 64-bit numbers.
+    AtomicWord<std::int64_t> _numCheckpoints{0};
+    AtomicWord<std::int64_t> _numOverDirtyBudgetCheckpoints{0};
+    AtomicWord<std::int64_t> _totalDurationMillis{0};
+    AtomicWord<std::int64_t> _lastDurationMillis{0};
+    AtomicWord<std::int64_t> _lastBytesWritten{0};
 
     AtomicWord<bool> _shuttingDown{false};
 
@@ -455,8 +548,120 @@ private:
 namespace {
 TicketHolder openWriteTransaction(128);
 TicketHolder openReadTransaction(128);
+
+// The latest statistics of the ticket adjustment thread, for serverStatus.
+stdx::mutex ticketAdjustmentStatsMutex;
+BSONObj ticketAdjustmentStats;
 }  // namespace
 
+class WiredTigerKVEngine::WiredTigerTicketAdjustmentThread : public BackgroundJob {
+public:
+    WiredTigerTicketAdjustmentThread(WiredTigerSessionCache* sessionCache,
+                                     int minTickets,
+                                     int maxTickets)
+        : BackgroundJob(false /* deleteSelf */),
+          _sessionCache(sessionCache),
+          _readAdjuster(minTickets, maxTickets),
+          _writeAdjuster(minTickets, maxTickets) {}
+
+    virtual string name() const {
+        return "WTTicketAdjuster";
+    }
+
+    virtual void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+        LOG(1) << "starting " << name() << " thread";
+
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(lock, stdx::chrono::seconds(1));
+            }
+            if (_shuttingDown.load()) {
+                break;
+            }
+
+            // The adjustments are reported through serverStatus, so that FTDC records each one.
+            const bool cacheUnderPressure = _cacheUnderPressure();
+            BSONObjBuilder stats;
+            stats.append("cacheUnderPressure", cacheUnderPressure);
+            _adjust("read", &openReadTransaction, &_readAdjuster, cacheUnderPressure, &stats);
+            _adjust("write", &openWriteTransaction, &_writeAdjuster, cacheUnderPressure, &stats);
+
+            stdx::lock_guard<stdx::mutex> lk(ticketAdjustmentStatsMutex);
+            ticketAdjustmentStats = stats.obj();
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            _condvar.notify_one();
+        }
+        wait();
+    }
+
+private:
+    void _adjust(StringData kind,
+                 TicketHolder* holder,
+                 WiredTigerTicketAdjuster* adjuster,
+                 bool cacheUnderPressure,
+                 BSONObjBuilder* stats) {
+        WiredTigerTicketAdjuster::Sample sample;
+        sample.numAcquired = holder->numAcquired();
+        sample.numDelayed = holder->numDelayed();
+        sample.cacheUnderPressure = cacheUnderPressure;
+
+        const int currentTickets = holder->outof();
+        const int tickets = adjuster->adjust(sample, currentTickets);
+        if (tickets != currentTickets) {
+            LOG(1) << "Adjusting " << kind << " tickets from " << currentTickets << " to "
+                   << tickets << " ("
+                   << WiredTigerTicketAdjuster::adjustmentName(adjuster->lastAdjustment()) << ")";
+            Status status = holder->resize(tickets);
+            if (!status.isOK()) {
+                warning() << "Failed to adjust " << kind << " tickets: " << status;
+            }
+        }
+
+        BSONObjBuilder kindStats(stats->subobjStart(kind));
+        kindStats.append("totalTickets", holder->outof());
+        adjuster->appendStats(&kindStats);
+    }
+
+    // Returns whether the cache is past the points at which WiredTiger makes application threads
+    // help with eviction by default.
+    bool _cacheUnderPressure() {
+        const double kEvictionTrigger = 0.95;
+        const double kEvictionDirtyTrigger = 0.20;
+
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        auto getStat = [&](int statisticsKey) -> int64_t {
+            auto result = WiredTigerUtil::getStatisticsValue(
+                session->getSession(), "statistics:", "statistics=(fast)", statisticsKey);
+            return result.isOK() ? result.getValue() : 0;
+        };
+
+        const int64_t maxBytes = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+        if (maxBytes <= 0) {
+            return false;
+        }
+        return getStat(WT_STAT_CONN_CACHE_BYTES_INUSE) >= maxBytes * kEvictionTrigger ||
+            getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY) >= maxBytes * kEvictionDirtyTrigger;
+    }
+
+    WiredTigerSessionCache* _sessionCache;
+    WiredTigerTicketAdjuster _readAdjuster;
+    WiredTigerTicketAdjuster _writeAdjuster;
+    AtomicWord<bool> _shuttingDown{false};
+
+    stdx::mutex _mutex;  // protects _condvar
+    stdx::condition_variable _condvar;
+};
+
 OpenWriteTransactionParam::OpenWriteTransactionParam(StringData name, ServerParameterType spt)
     : ServerParameter(name, spt), _data(&openWriteTransaction) {}
 
@@ -592,7 +797,9 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
         // If we're readOnly skip all WAL-related settings.
         ss << "log=(enabled=true,archive=true,path=journal,compressor=";
         ss << wiredTigerGlobalOptions.journalCompressor << "),";
-        ss << "file_manager=(close_idle_time=100000),";  //~28 hours, will put better fix in 3.1.x
+        ss << "file_manager=(close_idle_time=" << gWiredTigerFileHandleCloseIdleTime
+           << ",close_handle_minimum=" << gWiredTigerFileHandleCloseMinimum
+           << ",close_scan_interval=" << gWiredTigerFileHandleCloseScanInterval << "),";
         ss << "statistics_log=(wait=" << wiredTigerGlobalOptions.statisticsLogDelaySecs << "),";
         ss << "verbose=(recovery_progress),";
         ss << "verbose=(checkpoint_progress),";
@@ -697,7 +904,23 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
 
+    if (gWiredTigerConcurrentTransactionsFairQueueing) {
+        const TicketHolder::OperationClassWeights weights{gWiredTigerFairQueueingShortWeight,
+                                                          gWiredTigerFairQueueingLongWeight,
+                                                          gWiredTigerFairQueueingInternalWeight,
+                                                          gWiredTigerFairQueueingAdminWeight};
+        openReadTransaction.setFairQueueing(weights);
+        openWriteTransaction.setFairQueueing(weights);
+    }
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+
+    if (gWiredTigerAdaptiveConcurrentTransactions) {
+        const int minTickets = gWiredTigerAdaptiveConcurrentTransactionsMin;
+        const int maxTickets = std::max(minTickets, gWiredTigerAdaptiveConcurrentTransactionsMax);
+        _ticketAdjustmentThread = std::make_unique<WiredTigerTicketAdjustmentThread>(
+            _sessionCache.get(), minTickets, maxTickets);
+        _ticketAdjustmentThread->go();
+    }
 }
 
 
@@ -709,6 +932,12 @@ WiredTigerKVEngine::~WiredTigerKVEngine() {
     _sessionCache.reset(nullptr);
 }
 
+void WiredTigerKVEngine::appendCheckpointStats(BSONObjBuilder* builder) const {
+    if (_checkpointThread) {
+        _checkpointThread->appendStats(builder);
+    }
+}
+
 void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
     BSONObjBuilder bb(b.subobjStart("concurrentTransactions"));
     {
@@ -716,6 +945,7 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        openWriteTransaction.appendQueueStats(&bbb);
         bbb.done();
     }
     {
@@ -723,8 +953,15 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        openReadTransaction.appendQueueStats(&bbb);
         bbb.done();
     }
+    {
+        stdx::lock_guard<stdx::mutex> lk(ticketAdjustmentStatsMutex);
+        if (!ticketAdjustmentStats.isEmpty()) {
+            bb.append("adaptive", ticketAdjustmentStats);
+        }
+    }
     bb.done();
 }
 
@@ -799,6 +1036,11 @@ void WiredTigerKVEngine::cleanShutdown() {
     }
 
     // these must be the last things we do before _conn->close();
+    if (_ticketAdjustmentThread) {
+        log() << "Shutting down ticket adjustment thread";
+        _ticketAdjustmentThread->shutdown();
+        log() << "Finished shutting down ticket adjustment thread";
+    }
     if (_sessionSweeper) {
         log() << "Shutting down session sweeper thread";
         _sessionSweeper->shutdown();
@@ -1088,6 +1330,28 @@ void WiredTigerKVEngine::syncSizeInfo(bool sync) const {
     }
 }
 
+bool WiredTigerKVEngine::_isSizeInfoFlushedInBackground() const {
+    // Only durable engines have a checkpoint thread.
+    return !_ephemeral && gWiredTigerSizeStorerBackgroundFlushBatchSize.load() > 0;
+}
+
+void WiredTigerKVEngine::_flushSizeInfoInBatches() const {
+    const auto batchSize = gWiredTigerSizeStorerBackgroundFlushBatchSize.load();
+    if (batchSize <= 0 || !_sizeStorer)
+        return;
+
+    try {
+        // Write no more batches than were pending at the start, so that collections dirtied while
+        // flushing wait for the next cycle rather than keeping this one going.
+        size_t pending = _sizeStorer->flushBatch(batchSize);
+        for (size_t batches = pending / batchSize + 1; pending > 0 && batches > 0; --batches) {
+            pending = _sizeStorer->flushBatch(batchSize);
+        }
+    } catch (const WriteConflictException&) {
+        // ignore, we'll try again later.
+    }
+}
+
 void WiredTigerKVEngine::setOldestActiveTransactionTimestampCallback(
     StorageEngine::OldestActiveTransactionTimestampCallback callback) {
     stdx::lock_guard<stdx::mutex> lk(_oldestActiveTransactionTimestampCallbackMutex);
@@ -1407,7 +1671,8 @@ bool WiredTigerKVEngine::haveDropsQueued() const {
     Date_t now = _clockSource->now();
     Milliseconds delta = now - _previousCheckedDropsQueued;
 
-    if (!_readOnly && _sizeStorerSyncTracker.intervalHasElapsed()) {
+    if (!_readOnly && !_isSizeInfoFlushedInBackground() &&
+        _sizeStorerSyncTracker.intervalHasElapsed()) {
         _sizeStorerSyncTracker.resetLastTime();
         syncSizeInfo(false);
     }
@@ -1944,6 +2209,18 @@ int64_t WiredTigerKVEngine::getCacheOverflowTableInsertCount(OperationContext* o
     return insertCount;
 }
 
+double WiredTigerKVEngine::getCacheDirtyRatio(OperationContext* opCtx) const {
+    WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn();
+    invariant(session);
+
+    auto dirtyBytes = uassertStatusOK(WiredTigerUtil::getStatisticsValue(
+        session->getSession(), "statistics:", "", WT_STAT_CONN_CACHE_BYTES_DIRTY));
+    auto maxBytes = uassertStatusOK(WiredTigerUtil::getStatisticsValue(
+        session->getSession(), "statistics:", "", WT_STAT_CONN_CACHE_BYTES_MAX));
+
+    return maxBytes > 0 ? static_cast<double>(dirtyBytes) / maxBytes : 0;
+}
+
 Timestamp WiredTigerKVEngine::getStableTimestamp() const {
     return Timestamp(_stableTimestamp.load());
 }
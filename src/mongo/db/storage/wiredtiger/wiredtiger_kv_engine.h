@@ -245,6 +245,8 @@ public:
 
     int64_t getCacheOverflowTableInsertCount(OperationContext* opCtx) const override;
 
+    double getCacheDirtyRatio(OperationContext* opCtx) const override;
+
     bool supportsReadConcernMajority() const final;
 
     // wiredtiger specific
@@ -307,6 +309,11 @@ public:
 
     static void appendGlobalStats(BSONObjBuilder& b);
 
+    /**
+     * Appends statistics about the checkpoints taken by the checkpoint thread, if it is running.
+     */
+    void appendCheckpointStats(BSONObjBuilder* builder) const;
+
     Timestamp getStableTimestamp() const override;
     Timestamp getOldestTimestamp() const override;
     Timestamp getCheckpointTimestamp() const override;
@@ -356,6 +363,7 @@ private:
     class WiredTigerSessionSweeper;
     class WiredTigerJournalFlusher;
     class WiredTigerCheckpointThread;
+    class WiredTigerTicketAdjustmentThread;
 
     /**
      * Opens a connection on the WiredTiger database 'path' with the configuration 'wtOpenConfig'.
@@ -382,6 +390,17 @@ private:
 
     std::string _uri(StringData ident) const;
 
+    /**
+     * Returns true if the checkpoint thread flushes the size storer, as set by
+     * 'wiredTigerSizeStorerBackgroundFlushBatchSize', so that operations need not.
+     */
+    bool _isSizeInfoFlushedInBackground() const;
+
+    /**
+     * Called by the checkpoint thread to flush the size storer one bounded transaction at a time.
+     */
+    void _flushSizeInfoInBatches() const;
+
     /**
      * Uses the 'stableTimestamp', the 'targetSnapshotHistoryWindowInSeconds' setting and the
      * current _oldestTimestamp to calculate what the new oldest_timestamp should be, in order to
@@ -445,6 +464,7 @@ private:
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerTicketAdjustmentThread> _ticketAdjustmentThread;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/curop.h"
+#include "mongo/db/operation_wait_stats.h"
 #include "mongo/db/prepare_conflict_tracker.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -78,6 +79,8 @@ int wiredTigerPrepareConflictRetry(OperationContext* opCtx, F&& f) {
         return ret;
 
     PrepareConflictTracker::get(opCtx).beginPrepareConflict();
+    OperationWaitStats::ScopedWait prepareConflictWait(
+        opCtx, OperationWaitStats::WaitState::kPrepareConflict);
 
     // It is contradictory to be running into a prepare conflict when we are ignoring interruptions,
     // particularly when running code inside an
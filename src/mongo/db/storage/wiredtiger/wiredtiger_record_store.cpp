@@ -37,6 +37,7 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/base/checked_cast.h"
@@ -55,6 +56,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -157,6 +159,23 @@ private:
     OplogStones* _oplogStones;
 };
 
+namespace {
+
+/**
+ * Returns how many stones an oplog of 'maxSize' bytes is divided into: one for each maximum-sized
+ * document, but at least 10 and at most 'wiredTigerOplogMaxStones'.
+ */
+size_t computeNumStonesToKeep(unsigned long long maxSize) {
+    const unsigned long long kMinStonesToKeep = 10ULL;
+    const unsigned long long kMaxStonesToKeep = std::max(
+        kMinStonesToKeep, static_cast<unsigned long long>(gWiredTigerOplogMaxStones.load()));
+
+    unsigned long long numStones = maxSize / BSONObjMaxInternalSize;
+    return std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
+}
+
+}  // namespace
+
 WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTigerRecordStore* rs)
     : _rs(rs) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
@@ -165,11 +184,7 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTi
     invariant(rs->cappedMaxSize() > 0);
     unsigned long long maxSize = rs->cappedMaxSize();
 
-    const unsigned long long kMinStonesToKeep = 10ULL;
-    const unsigned long long kMaxStonesToKeep = 100ULL;
-
-    unsigned long long numStones = maxSize / BSONObjMaxInternalSize;
-    size_t numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
+    size_t numStonesToKeep = computeNumStonesToKeep(maxSize);
     _minBytesPerStone = maxSize / numStonesToKeep;
     invariant(_minBytesPerStone > 0);
 
@@ -458,16 +473,29 @@ void WiredTigerRecordStore::OplogStones::_pokeReclaimThreadIfNeeded() {
 
 void WiredTigerRecordStore::OplogStones::adjust(int64_t maxSize) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    const unsigned long long kMinStonesToKeep = 10ULL;
-    const unsigned long long kMaxStonesToKeep = 100ULL;
-
-    unsigned long long numStones = maxSize / BSONObjMaxInternalSize;
-    size_t numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
-    _minBytesPerStone = maxSize / numStonesToKeep;
+    _minBytesPerStone = maxSize / computeNumStonesToKeep(maxSize);
     invariant(_minBytesPerStone > 0);
     _pokeReclaimThreadIfNeeded();
 }
 
+void WiredTigerRecordStore::OplogStones::recordTruncation(int64_t bytes, int64_t micros) {
+    _truncateCount.fetchAndAddRelaxed(1);
+    _totalTimeTruncatingMicros.fetchAndAddRelaxed(micros);
+    _bytesReclaimed.fetchAndAddRelaxed(bytes);
+}
+
+void WiredTigerRecordStore::OplogStones::appendTruncationStats(BSONObjBuilder* builder) const {
+    const long long micros = _totalTimeTruncatingMicros.loadRelaxed();
+    const long long bytes = _bytesReclaimed.loadRelaxed();
+    BSONObjBuilder bob(builder->subobjStart("oplogTruncation"));
+    bob.appendNumber("truncateCount", _truncateCount.loadRelaxed());
+    bob.appendNumber("totalTimeTruncatingMicros", micros);
+    bob.appendNumber("bytesReclaimed", bytes);
+    // The rate at which the truncations themselves reclaim space, excluding the time between them.
+    bob.appendNumber("bytesReclaimedPerSecond",
+                     micros > 0 ? static_cast<long long>(bytes * 1000000.0 / micros) : 0LL);
+}
+
 StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj options) {
     StringBuilder ss;
     BSONForEach(elem, options) {
@@ -1172,18 +1200,19 @@ bool WiredTigerRecordStore::yieldAndAwaitOplogDeletionRequest(OperationContext*
     return !oplogStones->isDead();
 }
 
-void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
-    reclaimOplog(opCtx, _kvEngine->getPinnedOplog());
+Milliseconds WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
+    return reclaimOplog(opCtx, _kvEngine->getPinnedOplog());
 }
 
-void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayTruncateUpTo) {
+Milliseconds WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx,
+                                                 Timestamp mayTruncateUpTo) {
     Timer timer;
     while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
         invariant(stone->lastRecord.isValid());
 
         if (static_cast<std::uint64_t>(stone->lastRecord.repr()) >= mayTruncateUpTo.asULL()) {
             // Do not truncate oplogs needed for replication recovery.
-            return;
+            return Milliseconds(0);
         }
 
         LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
@@ -1194,6 +1223,7 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
         WT_SESSION* session = ru->getSession()->getSession();
 
         try {
+            Timer truncateTimer;
             WriteUnitOfWork wuow(opCtx);
 
             WiredTigerCursor cwrap(_uri, _tableId, true, opCtx);
@@ -1220,6 +1250,19 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
             _oplogStones->firstRecord = stone->lastRecord;
+
+            const auto truncateMicros = truncateTimer.micros();
+            _oplogStones->recordTruncation(stone->bytes, truncateMicros);
+
+            // Spread the truncations out so that they reclaim no more than the rate limit on
+            // average, pausing after each one for as long as the limit allows for its bytes.
+            const long long maxBytesPerSecond = gWiredTigerOplogTruncateMaxBytesPerSecond.load();
+            if (maxBytesPerSecond > 0) {
+                const long long pauseMicros =
+                    static_cast<long long>(stone->bytes * 1000000.0 / maxBytesPerSecond) -
+                    truncateMicros;
+                return duration_cast<Milliseconds>(Microseconds(std::max(0LL, pauseMicros)));
+            }
         } catch (const WriteConflictException&) {
             LOG(1) << "Caught WriteConflictException while truncating oplog entries, retrying";
         }
@@ -1229,6 +1272,7 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
            << _sizeInfo->numRecords.load() << " records totaling to " << _sizeInfo->dataSize.load()
            << " bytes";
     log() << "WiredTiger record store oplog truncation finished in: " << timer.millis() << "ms";
+    return Milliseconds(0);
 }
 
 Status WiredTigerRecordStore::insertRecords(OperationContext* opCtx,
@@ -1406,19 +1450,30 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
     WiredTigerItem value(data, len);
 
     // Check if we should modify rather than doing a full update.  Look for deltas for documents
-    // larger than 1KB, up to 16 changes representing up to 10% of the data.
+    // larger than 1KB, up to 16 changes representing up to 10% of the data. A byte by byte diff
+    // finds the changes of a typical update, which grow or shrink a few fields and rewrite the
+    // length headers enclosing them; WiredTiger's own diff is tried when it doesn't.
     const int kMinLengthForDiff = 1024;
     const int kMaxEntries = 16;
     const int kMaxDiffBytes = len / 10;
 
     bool skip_update = false;
     if (len > kMinLengthForDiff && len <= old_length + kMaxDiffBytes) {
-        int nentries = kMaxEntries;
-        std::vector<WT_MODIFY> entries(nentries);
+        int nentries;
+        std::vector<WT_MODIFY> entries;
 
-        if ((ret = wiredtiger_calc_modify(
-                 c->session, &old_value, value.Get(), kMaxDiffBytes, entries.data(), &nentries)) ==
-            0) {
+        if (WiredTigerUtil::calcModifyFromDiff(
+                old_value, value, kMaxDiffBytes, kMaxEntries, &entries)) {
+            nentries = entries.size();
+            ret = 0;
+        } else {
+            nentries = kMaxEntries;
+            entries.resize(nentries);
+            ret = wiredtiger_calc_modify(
+                c->session, &old_value, value.Get(), kMaxDiffBytes, entries.data(), &nentries);
+        }
+
+        if (ret == 0) {
             invariantWTOK(WT_OP_CHECK(nentries == 0 ? c->reserve(c)
                                                     : c->modify(c, entries.data(), nentries)));
             WT_ITEM new_value;
@@ -1571,6 +1626,9 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* opCtx,
         result->appendIntOrLL("sleepCount", _cappedSleep.load());
         result->appendIntOrLL("sleepMS", _cappedSleepMS.load());
     }
+    if (_oplogStones) {
+        _oplogStones->appendTruncationStats(result);
+    }
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn();
     WT_SESSION* s = session->getSession();
     BSONObjBuilder bob(result->subobjStart(_engineName));
@@ -1616,6 +1674,33 @@ Status WiredTigerRecordStore::touch(OperationContext* opCtx, BSONObjBuilder* out
     return Status(ErrorCodes::CommandNotSupported, "this storage engine does not support touch");
 }
 
+void WiredTigerRecordStore::prefetch(OperationContext* opCtx,
+                                     const std::vector<RecordId>& ids) const {
+    if (_isEphemeral || ids.size() < 2) {
+        // Either everything is already in memory, or there is nothing to gain over simply
+        // fetching the one record.
+        return;
+    }
+
+    // Visiting the records in key order reads each leaf page at most once for the whole set, and
+    // lets successive searches descend through internal pages which are already in cache.
+    std::vector<RecordId> sorted(ids);
+    std::sort(sorted.begin(), sorted.end());
+
+    WiredTigerCursor curwrap(_uri, _tableId, true, opCtx);
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+    for (auto&& id : sorted) {
+        setKey(c, id);
+        int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+        if (ret != 0 && ret != WT_NOTFOUND) {
+            // This is only a hint. Leave any error, such as a write conflict, for the real read to
+            // surface.
+            return;
+        }
+    }
+}
+
 void WiredTigerRecordStore::waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const {
     // Make sure that callers do not hold an active snapshot so it will be able to see the oplog
     // entries it waited for afterwards.
@@ -1933,6 +2018,46 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+boost::optional<Record> WiredTigerRecordStoreCursorBase::seekAtOrAfter(const RecordId& id) {
+    invariant(_forward);
+
+    _skipNextAdvance = false;
+    WT_CURSOR* c = _cursor->get();
+    setKey(c, id);
+
+    // Nothing after the next line can throw WCEs.
+    int cmp;
+    int ret = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search_near(c, &cmp); });
+    if (ret == 0 && cmp < 0) {
+        // We landed before 'id'; the record we want, if any, is the next one.
+        ret = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->next(c); });
+    }
+    RecordId foundId;
+    if (ret == WT_NOTFOUND) {
+        _eof = true;
+        return {};
+    }
+    invariantWTOK(ret);
+    if (hasWrongPrefix(c, &foundId)) {
+        _eof = true;
+        return {};
+    }
+    if (!foundId.isValid()) {
+        foundId = getKey(c);
+    }
+
+    if (_oplogVisibleTs && foundId.repr() > *_oplogVisibleTs) {
+        _eof = true;
+        return {};
+    }
+
+    WT_ITEM value;
+    invariantWTOK(c->get_value(c, &value));
+
+    _lastReturnedId = foundId;
+    _eof = false;
+    return {{foundId, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
+}
 
 void WiredTigerRecordStoreCursorBase::save() {
     try {
@@ -198,6 +198,8 @@ public:
 
     virtual Status touch(OperationContext* opCtx, BSONObjBuilder* output) const;
 
+    void prefetch(OperationContext* opCtx, const std::vector<RecordId>& ids) const override;
+
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive);
 
     virtual boost::optional<RecordId> oplogStartHack(OperationContext* opCtx,
@@ -244,14 +246,18 @@ public:
 
     bool inShutdown() const;
 
-    void reclaimOplog(OperationContext* opCtx);
+    Milliseconds reclaimOplog(OperationContext* opCtx);
 
     /**
      * The `recoveryTimestamp` is when replication recovery would need to replay from for
      * recoverable rollback, or restart for durable engines. `reclaimOplog` will not
      * truncate oplog entries in front of this time.
+     *
+     * When 'wiredTigerOplogTruncateMaxBytesPerSecond' limits the rate of truncation, truncates at
+     * most one stone and returns how long the caller should wait before calling again. Otherwise
+     * truncates every excess stone and returns zero.
      */
-    void reclaimOplog(OperationContext* opCtx, Timestamp recoveryTimestamp);
+    Milliseconds reclaimOplog(OperationContext* opCtx, Timestamp recoveryTimestamp);
 
     // Returns false if the oplog was dropped while waiting for a deletion request.
     bool yieldAndAwaitOplogDeletionRequest(OperationContext* opCtx);
@@ -420,6 +426,8 @@ public:
 
     boost::optional<Record> seekExact(const RecordId& id);
 
+    boost::optional<Record> seekAtOrAfter(const RecordId& id) final;
+
     void save();
 
     void saveUnpositioned();
@@ -80,6 +80,7 @@ public:
 
         const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
 
+        Milliseconds pause(0);
         try {
             // A Global IX lock should be good enough to protect the oplog truncation from
             // interruptions such as restartCatalog. PBWM, database lock or collection lock is not
@@ -115,7 +116,7 @@ public:
             if (!rs->yieldAndAwaitOplogDeletionRequest(opCtx.get())) {
                 return false;  // Oplog went away.
             }
-            rs->reclaimOplog(opCtx.get());
+            pause = rs->reclaimOplog(opCtx.get());
         } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
             return false;
         } catch (const std::exception& e) {
@@ -124,6 +125,11 @@ public:
         } catch (...) {
             fassertFailedNoTrace(!"unknown error in OplogTruncaterThread");
         }
+
+        // Pace rate-limited truncation only after the locks above have been released.
+        if (pause > Milliseconds(0)) {
+            sleepFor(pause);
+        }
         return true;
     }
 
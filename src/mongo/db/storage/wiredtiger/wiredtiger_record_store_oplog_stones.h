@@ -113,6 +113,12 @@ public:
 
     void setMinBytesPerStone(int64_t size);
 
+    // Records a truncation of 'bytes' bytes of the oplog which took 'micros' microseconds.
+    void recordTruncation(int64_t bytes, int64_t micros);
+
+    // Appends the number of truncations, the time spent in them, and the bytes they reclaimed.
+    void appendTruncationStats(BSONObjBuilder* builder) const;
+
 private:
     class InsertChange;
     class TruncateChange;
@@ -143,6 +149,10 @@ private:
     AtomicWord<long long> _currentRecords;  // Number of records in the stone being filled.
     AtomicWord<long long> _currentBytes;    // Number of bytes in the stone being filled.
 
+    AtomicWord<long long> _truncateCount{0};
+    AtomicWord<long long> _totalTimeTruncatingMicros{0};
+    AtomicWord<long long> _bytesReclaimed{0};
+
     mutable stdx::mutex _mutex;  // Protects against concurrent access to the deque of oplog stones.
     std::deque<OplogStones::Stone> _stones;  // front = oldest, back = newest.
 };
@@ -43,6 +43,7 @@
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -819,6 +820,76 @@ TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStones) {
     }
 }
 
+// Verify that rate-limited reclaiming truncates one stone at a time and asks to be paused.
+TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStonesAtLimitedRate) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_OK(wtrs->updateCappedSize(opCtx.get(), 120U));
+    }
+
+    oplogStones->setMinBytesPerStone(100);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 110), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 120), RecordId(1, 3));
+        ASSERT_EQ(3U, oplogStones->numStones());
+    }
+
+    // 1000 bytes per second allows a 100 byte stone to be truncated every 100 milliseconds.
+    const auto originalMaxBytesPerSecond = gWiredTigerOplogTruncateMaxBytesPerSecond.load();
+    gWiredTigerOplogTruncateMaxBytesPerSecond.store(1000);
+    ON_BLOCK_EXIT(
+        [&] { gWiredTigerOplogTruncateMaxBytesPerSecond.store(originalMaxBytesPerSecond); });
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        auto pause = wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 3));
+        ASSERT_LTE(pause, Milliseconds(100));
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(230, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        auto pause = wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 3));
+        ASSERT_LTE(pause, Milliseconds(110));
+
+        ASSERT_EQ(1, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(120, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(1U, oplogStones->numStones());
+    }
+
+    // Nothing is left to truncate, so there is nothing to wait for.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(Milliseconds(0), wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 3)));
+        ASSERT_EQ(1, rs->numRecords(opCtx.get()));
+    }
+
+    BSONObjBuilder builder;
+    oplogStones->appendTruncationStats(&builder);
+    BSONObj stats = builder.obj()["oplogTruncation"].Obj();
+    ASSERT_EQ(2, stats["truncateCount"].numberLong());
+    ASSERT_EQ(210, stats["bytesReclaimed"].numberLong());
+}
+
 // Verify that an oplog stone isn't created if it would cause the logical representation of the
 // records to not be in increasing order.
 TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
@@ -70,19 +70,63 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
     std::vector<std::string> fieldsToIgnore = {"LSM"};
 
     BSONObjBuilder bob;
-    Status status =
-        WiredTigerUtil::exportTableToBSON(s, uri, "statistics=(fast)", &bob, fieldsToIgnore);
-    if (!status.isOK()) {
-        bob.append("error", "unable to retrieve statistics");
-        bob.append("code", static_cast<int>(status.code()));
-        bob.append("reason", status.reason());
+
+    // FTDC collects the statistics separately, with {wiredTiger: {statistics: false}}.
+    const bool includeStatistics = configElement.type() != Object ||
+        configElement.Obj()["statistics"].eoo() || configElement.Obj()["statistics"].trueValue();
+    if (includeStatistics) {
+        Status status =
+            WiredTigerUtil::exportTableToBSON(s, uri, "statistics=(fast)", &bob, fieldsToIgnore);
+        if (!status.isOK()) {
+            bob.append("error", "unable to retrieve statistics");
+            bob.append("code", static_cast<int>(status.code()));
+            bob.append("reason", status.reason());
+        }
     }
 
     WiredTigerKVEngine::appendGlobalStats(bob);
 
+    _engine->appendCheckpointStats(&bob);
+
+    WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->appendStats(&bob);
+
     WiredTigerUtil::appendSnapshotWindowSettings(_engine, session, &bob);
 
     return bob.obj();
 }
 
+WiredTigerHighFrequencyServerStatusSection::WiredTigerHighFrequencyServerStatusSection()
+    : ServerStatusSection("wiredTigerHighFrequency") {}
+
+bool WiredTigerHighFrequencyServerStatusSection::includeByDefault() const {
+    return false;
+}
+
+BSONObj WiredTigerHighFrequencyServerStatusSection::generateSection(
+    OperationContext* opCtx, const BSONElement& configElement) const {
+    Lock::GlobalLock lk(opCtx, LockMode::MODE_IS);
+
+    WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn();
+    invariant(session);
+
+    BSONObjBuilder bob;
+    WiredTigerKVEngine::appendGlobalStats(bob);
+
+    {
+        BSONObjBuilder cacheBuilder(bob.subobjStart("cache"));
+        auto appendStat = [&](StringData name, int statisticsKey) {
+            auto result = WiredTigerUtil::getStatisticsValue(
+                session->getSession(), "statistics:", "statistics=(fast)", statisticsKey);
+            if (result.isOK()) {
+                cacheBuilder.appendNumber(name, static_cast<long long>(result.getValue()));
+            }
+        };
+        appendStat("maximum bytes configured", WT_STAT_CONN_CACHE_BYTES_MAX);
+        appendStat("bytes currently in the cache", WT_STAT_CONN_CACHE_BYTES_INUSE);
+        appendStat("tracked dirty bytes in the cache", WT_STAT_CONN_CACHE_BYTES_DIRTY);
+    }
+
+    return bob.obj();
+}
+
 }  // namespace mongo
@@ -49,4 +49,17 @@ private:
     WiredTigerKVEngine* _engine;
 };
 
+/**
+ * Adds "wiredTigerHighFrequency" to the results of db.serverStatus({wiredTigerHighFrequency: 1}):
+ * the tickets and the cache fill levels, without the rest of the WiredTiger statistics. It is
+ * cheap enough to be sampled many times a second by the high frequency FTDC tier.
+ */
+class WiredTigerHighFrequencyServerStatusSection : public ServerStatusSection {
+public:
+    WiredTigerHighFrequencyServerStatusSection();
+    bool includeByDefault() const override;
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override;
+};
+
 }  // namespace mongo
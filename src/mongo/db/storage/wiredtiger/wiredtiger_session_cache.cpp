@@ -33,9 +33,12 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
@@ -107,13 +110,19 @@ void _openCursor(WT_SESSION* session,
 
 WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, bool allowOverwrite) {
     // Find the most recently used cursor
-    for (CursorCache::iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        if (i->_id == id) {
-            WT_CURSOR* c = i->_cursor;
-            _cursors.erase(i);
-            _cursorsOut++;
-            return c;
+    auto cached = _cursorsById.find(id);
+    if (cached != _cursorsById.end()) {
+        auto& positions = cached->second;
+        invariant(!positions.empty());
+        CursorCache::iterator i = positions.back();
+        positions.pop_back();
+        if (positions.empty()) {
+            _cursorsById.erase(cached);
         }
+        WT_CURSOR* c = i->_cursor;
+        _cursors.erase(i);
+        _cursorsOut++;
+        return c;
     }
 
     WT_CURSOR* cursor = nullptr;
@@ -140,11 +149,23 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
 
     // Cursors are pushed to the front of the list and removed from the back
     _cursors.push_front(WiredTigerCachedCursor(id, _cursorGen++, cursor));
+    _cursorsById[id].push_back(_cursors.begin());
 
     // A negative value for wiredTigercursorCacheSize means to use hybrid caching.
     std::uint32_t cacheSize = abs(gWiredTigerCursorCacheSize.load());
 
     while (!_cursors.empty() && _cursorGen - _cursors.back()._gen > cacheSize) {
+        // The least recently released cursor of all is also the least recently released of its
+        // table.
+        auto indexed = _cursorsById.find(_cursors.back()._id);
+        invariant(indexed != _cursorsById.end());
+        auto& positions = indexed->second;
+        invariant(positions.front() == std::prev(_cursors.end()));
+        positions.erase(positions.begin());
+        if (positions.empty()) {
+            _cursorsById.erase(indexed);
+        }
+
         cursor = _cursors.back()._cursor;
         _cursors.pop_back();
         invariantWTOK(cursor->close(cursor));
@@ -171,6 +192,7 @@ void WiredTigerSession::closeAllCursors(const std::string& uri) {
         } else
             ++i;
     }
+    _rebuildCursorIndex();
 }
 
 void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
@@ -178,6 +200,9 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
 
     _cursorEpoch = _cache->getCursorEpoch();
     auto toDrop = engine->filterCursorsWithQueuedDrops(&_cursors);
+    if (!toDrop.empty()) {
+        _rebuildCursorIndex();
+    }
 
     for (auto i = toDrop.begin(); i != toDrop.end(); i++) {
         WT_CURSOR* cursor = i->_cursor;
@@ -187,6 +212,15 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
     }
 }
 
+void WiredTigerSession::_rebuildCursorIndex() {
+    _cursorsById.clear();
+    // The cursors are kept from the most to the least recently released.
+    for (auto i = _cursors.end(); i != _cursors.begin();) {
+        --i;
+        _cursorsById[i->_id].push_back(i);
+    }
+}
+
 namespace {
 AtomicWord<unsigned long long> nextTableId(1);
 }
@@ -197,11 +231,18 @@ uint64_t WiredTigerSession::genTableId() {
 
 // -----------------------
 
+namespace {
+// The upper bounds of the batch sizes counted in each bucket but the last, and the bucket names.
+const long long kGroupCommitBatchSizeBounds[] = {1, 4, 16, 64};
+const char* const kGroupCommitBatchSizeNames[] = {"1", "2-4", "5-16", "17-64", "65+"};
+}  // namespace
+
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
     : _engine(engine),
       _conn(engine->getConnection()),
       _clockSource(_engine->getClockSource()),
       _shuttingDown(0),
+      _shards(gWiredTigerSessionCacheShards.load()),
       _prepareCommitOrAbortCounter(0) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource* cs)
@@ -209,6 +250,7 @@ WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource*
       _conn(conn),
       _clockSource(cs),
       _shuttingDown(0),
+      _shards(gWiredTigerSessionCacheShards.load()),
       _prepareCommitOrAbortCounter(0) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
@@ -267,6 +309,10 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
+    _numDurableWaiters.fetchAndAdd(1);
+    ON_BLOCK_EXIT([this] { _numDurableWaiters.fetchAndSubtract(1); });
+    _numGroupCommitWaiters.fetchAndAddRelaxed(1);
+
     uint32_t start = _lastSyncTime.load();
     // Do the remainder in a critical section that ensures only a single thread at a time
     // will attempt to synchronize.
@@ -276,9 +322,34 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         // Someone else synced already since we read lastSyncTime, so we're done!
         return;
     }
+
+    // When other threads are waiting as well, more are likely to come. Delay the flush by part of
+    // the time a flush takes, so that those which come meanwhile share it rather than wait for the
+    // next one: they read lastSyncTime before it is bumped below.
+    const long long maxDelayMicros = gWiredTigerJournalGroupCommitMaxDelayMicros.load();
+    if (maxDelayMicros > 0 &&
+        _numDurableWaiters.load() >= gWiredTigerJournalGroupCommitMinWaiters.load()) {
+        const long long delayMicros =
+            std::min(maxDelayMicros, _averageGroupCommitFlushMicros.load() / 2);
+        if (delayMicros > 0) {
+            sleepmicros(delayMicros);
+            _numGroupCommitDelays.fetchAndAddRelaxed(1);
+            _totalGroupCommitDelayMicros.fetchAndAddRelaxed(delayMicros);
+        }
+    }
     _lastSyncTime.store(current + 1);
 
-    // Nobody has synched yet, so we have to sync ourselves.
+    // Nobody has synched yet, so we have to sync ourselves. This flush covers the threads which are
+    // waiting now.
+    const long long batchSize = _numDurableWaiters.load();
+    int bucket = 0;
+    while (bucket < kNumGroupCommitBatchSizeBuckets - 1 &&
+           batchSize > kGroupCommitBatchSizeBounds[bucket]) {
+        bucket++;
+    }
+    _groupCommitBatchSizes[bucket].fetchAndAddRelaxed(1);
+    _numGroupCommitFlushes.fetchAndAddRelaxed(1);
+    const uint64_t startOfFlush = curTimeMicros64();
 
     // This gets the token (OpTime) from the last write, before flushing (either the journal, or a
     // checkpoint), and then reports that token (OpTime) as a durable write.
@@ -300,6 +371,11 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         LOG(4) << "created checkpoint";
     }
     _journalListener->onDurable(token);
+
+    // Only the thread which flushes updates the average, while it holds _lastSyncMutex.
+    const long long flushMicros = static_cast<long long>(curTimeMicros64() - startOfFlush);
+    const long long average = _averageGroupCommitFlushMicros.loadRelaxed();
+    _averageGroupCommitFlushMicros.store(average ? (average * 7 + flushMicros) / 8 : flushMicros);
 }
 
 void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx,
@@ -321,9 +397,11 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        for (SessionCache::iterator i = shard.sessions.begin(); i != shard.sessions.end(); i++) {
+            (*i)->closeAllCursors(uri);
+        }
     }
 }
 
@@ -331,15 +409,50 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        for (SessionCache::iterator i = shard.sessions.begin(); i != shard.sessions.end(); i++) {
+            (*i)->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 size_t WiredTigerSessionCache::getIdleSessionsCount() {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    return _sessions.size();
+    size_t count = 0;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        count += shard.sessions.size();
+    }
+    return count;
+}
+
+void WiredTigerSessionCache::appendStats(BSONObjBuilder* builder) {
+    BSONObjBuilder bob(builder->subobjStart("sessionCache"));
+    bob.appendNumber("shards", static_cast<long long>(getNumShards()));
+    bob.appendNumber("idleSessions", static_cast<long long>(getIdleSessionsCount()));
+    bob.appendNumber("steals", getSessionSteals());
+    bob.appendNumber("misses", getSessionMisses());
+    bob.done();
+
+    BSONObjBuilder groupCommit(builder->subobjStart("groupCommit"));
+    groupCommit.append("waiters", _numGroupCommitWaiters.load());
+    groupCommit.append("flushes", _numGroupCommitFlushes.load());
+    groupCommit.append("delays", _numGroupCommitDelays.load());
+    groupCommit.append("totalDelayMicros", _totalGroupCommitDelayMicros.load());
+    groupCommit.append("averageFlushMicros", _averageGroupCommitFlushMicros.load());
+
+    BSONObjBuilder batchSizes(groupCommit.subobjStart("batchSizes"));
+    for (int bucket = 0; bucket < kNumGroupCommitBatchSizeBuckets; bucket++) {
+        batchSizes.append(kGroupCommitBatchSizeNames[bucket],
+                          _groupCommitBatchSizes[bucket].load());
+    }
+}
+
+size_t WiredTigerSessionCache::_shardIndexForThisThread() const {
+    if (_shards.size() == 1) {
+        return 0;
+    }
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) % _shards.size();
 }
 
 void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
@@ -349,14 +462,15 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
     }
 
     auto cutoffTime = _clockSource->now() - Milliseconds(idleTimeMillis);
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+    for (auto&& shard : _shards) {
+        // Each shard is swept under its own lock, so the threads using the others carry on.
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
         // Discard all sessions that became idle before the cutoff time
-        for (auto it = _sessions.begin(); it != _sessions.end();) {
+        for (auto it = shard.sessions.begin(); it != shard.sessions.end();) {
             auto session = *it;
             invariant(session->getIdleExpireTime() != Date_t::min());
             if (session->getIdleExpireTime() < cutoffTime) {
-                it = _sessions.erase(it);
+                it = shard.sessions.erase(it);
                 delete (session);
             } else {
                 ++it;
@@ -367,12 +481,15 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
 
 void WiredTigerSessionCache::closeAll() {
     // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // The epoch is bumped before any shard is emptied: releaseSession rechecks it under the shard
+    // lock, so a session released after its shard has been emptied is deleted rather than cached.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+    SessionCache swap;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        swap.insert(swap.end(), shard.sessions.begin(), shard.sessions.end());
+        shard.sessions.clear();
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -389,18 +506,25 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
+    // Look in this thread's own shard first, then steal from the others in turn.
+    const size_t ownIndex = _shardIndexForThisThread();
+    for (size_t i = 0; i < _shards.size(); ++i) {
+        auto& shard = _shards[(ownIndex + i) % _shards.size()];
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        if (!shard.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = shard.sessions.back();
+            shard.sessions.pop_back();
             // Reset the idle time
             cachedSession->setIdleExpireTime(Date_t::min());
+            if (i > 0) {
+                _sessionSteals.fetchAndAddRelaxed(1);
+            }
             return UniqueWiredTigerSession(cachedSession);
         }
     }
+    _sessionMisses.fetchAndAddRelaxed(1);
 
     // Outside of the cache partition lock, but on release will be put back on the cache
     return UniqueWiredTigerSession(
@@ -457,10 +581,11 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->setIdleExpireTime(_clockSource->now());
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        auto& shard = _shards[_shardIndexForThisThread()];
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            shard.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -31,17 +31,22 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
+#include <boost/align/aligned_allocator.hpp>
 #include <wiredtiger.h>
 
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -167,6 +172,9 @@ private:
     // The cursor cache is a list of pairs that contain an ID and cursor
     typedef std::list<WiredTigerCachedCursor> CursorCache;
 
+    // Refills _cursorsById from _cursors, after cursors have been removed from the latter directly.
+    void _rebuildCursorIndex();
+
     // Used internally by WiredTigerSessionCache
     uint64_t _getEpoch() const {
         return _epoch;
@@ -182,6 +190,10 @@ private:
     WiredTigerSessionCache* _cache;  // not owned
     WT_SESSION* _session;            // owned
     CursorCache _cursors;            // owned
+    // Indexes _cursors by table id, so that getCursor need not walk the cursors of every other
+    // table the session has used. Each id maps to the positions of its cached cursors, from the
+    // least to the most recently released.
+    stdx::unordered_map<uint64_t, std::vector<CursorCache::iterator>> _cursorsById;
     uint64_t _cursorGen;
     int _cursorsOut;
     bool _dropQueuedIdentsAtSessionEnd = true;
@@ -223,6 +235,34 @@ public:
      */
     size_t getIdleSessionsCount();
 
+    /**
+     * Returns the number of shards the idle sessions are spread across, as set by
+     * 'wiredTigerSessionCacheShards' when the cache was constructed.
+     */
+    size_t getNumShards() const {
+        return _shards.size();
+    }
+
+    /**
+     * Returns how many times getSession took an idle session from a shard other than the calling
+     * thread's own.
+     */
+    long long getSessionSteals() const {
+        return _sessionSteals.loadRelaxed();
+    }
+
+    /**
+     * Returns how many times getSession found no idle session in any shard and opened a new one.
+     */
+    long long getSessionMisses() const {
+        return _sessionMisses.loadRelaxed();
+    }
+
+    /**
+     * Appends the shard count, the number of idle sessions, and the steal and miss counters.
+     */
+    void appendStats(BSONObjBuilder* builder);
+
     /**
      * Closes all cached sessions whose idle expiration time has been reached.
      */
@@ -317,9 +357,20 @@ private:
     AtomicWord<unsigned> _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+
+    // The idle sessions, split into shards so that threads releasing and reusing sessions
+    // concurrently rarely contend on the same mutex. Each thread prefers the shard its id hashes to
+    // and only steals from the others when its own is empty.
+    struct Shard {
+        stdx::mutex lock;
+        SessionCache sessions;
+    };
+    std::vector<CacheAligned<Shard>, boost::alignment::aligned_allocator<CacheAligned<Shard>>>
+        _shards;
+
+    AtomicWord<long long> _sessionSteals{0};
+    AtomicWord<long long> _sessionMisses{0};
 
     // Bumped when all open sessions need to be closed
     AtomicWord<unsigned long long> _epoch;  // atomic so we can check it outside of the lock
@@ -331,6 +382,21 @@ private:
     AtomicWord<unsigned> _lastSyncTime;
     stdx::mutex _lastSyncMutex;
 
+    // Number of threads waiting in waitUntilDurable for a journal flush, or for a checkpoint
+    // without the journal. One of them flushes for all of them.
+    AtomicWord<long long> _numDurableWaiters{0};
+
+    // Statistics of the flushes of waitUntilDurable, with a histogram of the number of waiters
+    // each flush covers.
+    static constexpr int kNumGroupCommitBatchSizeBuckets = 5;
+    AtomicWord<long long> _numGroupCommitWaiters{0};
+    AtomicWord<long long> _numGroupCommitFlushes{0};
+    AtomicWord<long long> _groupCommitBatchSizes[kNumGroupCommitBatchSizeBuckets];
+    AtomicWord<long long> _numGroupCommitDelays{0};
+    AtomicWord<long long> _totalGroupCommitDelayMicros{0};
+    // Moving average of the time a flush takes, which bounds the delay before the next one.
+    AtomicWord<long long> _averageGroupCommitFlushMicros{0};
+
     // Mutex and cond var for waiting on prepare commit or abort.
     stdx::mutex _prepareCommittedOrAbortedMutex;
     stdx::condition_variable _prepareCommittedOrAbortedCond;
@@ -349,6 +415,12 @@ private:
      * session and releasing it, the session is directly released. This method is thread safe.
      */
     void releaseSession(WiredTigerSession* session);
+
+    /**
+     * Returns the index of the shard that the calling thread releases its sessions to and looks in
+     * first.
+     */
+    size_t _shardIndexForThisThread() const;
 };
 
 /**
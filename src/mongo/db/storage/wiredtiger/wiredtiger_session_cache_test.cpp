@@ -31,12 +31,17 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/unittest/temp_dir.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/system_clock_source.h"
 
 namespace mongo {
@@ -113,4 +118,113 @@ TEST(WiredTigerSessionCacheTest, CheckSessionCacheCleanup) {
     ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
 }
 
+TEST(WiredTigerSessionCacheTest, CachedCursorsAreFoundByTableAndEvictedLeastRecentlyReleased) {
+    const auto originalCacheSize = gWiredTigerCursorCacheSize.load();
+    gWiredTigerCursorCacheSize.store(3);
+    ON_BLOCK_EXIT([&] { gWiredTigerCursorCacheSize.store(originalCacheSize); });
+
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    UniqueWiredTigerSession session = harnessHelper.getSessionCache()->getSession();
+    WT_SESSION* wtSession = session->getSession();
+    const std::vector<std::string> uris = {"table:a", "table:b"};
+    for (auto&& uri : uris) {
+        ASSERT_OK(wtRCToStatus(wtSession->create(wtSession, uri.c_str(), nullptr)));
+    }
+
+    // Two cursors on table 'a', released one after the other, and one on table 'b'.
+    WT_CURSOR* a1 = session->getCursor(uris[0], 1, true);
+    WT_CURSOR* a2 = session->getCursor(uris[0], 1, true);
+    WT_CURSOR* b = session->getCursor(uris[1], 2, true);
+    session->releaseCursor(1, a1);
+    session->releaseCursor(1, a2);
+    session->releaseCursor(2, b);
+    ASSERT_EQ(session->cachedCursors(), 3);
+
+    // Each table gets back its own most recently released cursor.
+    ASSERT_EQ(session->getCursor(uris[1], 2, true), b);
+    ASSERT_EQ(session->getCursor(uris[0], 1, true), a2);
+    ASSERT_EQ(session->cachedCursors(), 1);
+
+    // Once more than the cache size of cursors have been released since 'a1' was, it is closed.
+    session->releaseCursor(2, b);
+    session->releaseCursor(1, a2);
+    ASSERT_EQ(session->cachedCursors(), 2);
+    ASSERT_EQ(session->getCursor(uris[0], 1, true), a2);
+    ASSERT_EQ(session->cachedCursors(), 1);
+    session->releaseCursor(1, a2);
+
+    // Closing the cursors of one table leaves the other's to be found.
+    session->closeAllCursors(uris[0]);
+    ASSERT_EQ(session->cachedCursors(), 1);
+    ASSERT_EQ(session->getCursor(uris[1], 2, true), b);
+    session->releaseCursor(2, b);
+    session->closeAllCursors("");
+    ASSERT_EQ(session->cachedCursors(), 0);
+}
+
+TEST(WiredTigerSessionCacheTest, ShardedSessionsAreReusedAcrossThreads) {
+    const auto originalShards = gWiredTigerSessionCacheShards.load();
+    gWiredTigerSessionCacheShards.store(4);
+    ON_BLOCK_EXIT([&] { gWiredTigerSessionCacheShards.store(originalShards); });
+
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+    ASSERT_EQUALS(sessionCache->getNumShards(), 4U);
+
+    // The first session of all is a miss, and is cached when it is released.
+    sessionCache->getSession();
+    ASSERT_EQUALS(sessionCache->getSessionMisses(), 1);
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+
+    // Every other thread reuses the one idle session, stealing it whenever it was released to a
+    // shard other than the thread's own. Some of the threads are all but certain to differ.
+    for (int i = 0; i < 20 && sessionCache->getSessionSteals() == 0; ++i) {
+        stdx::thread([&] { sessionCache->getSession(); }).join();
+    }
+    ASSERT_GT(sessionCache->getSessionSteals(), 0);
+    ASSERT_EQUALS(sessionCache->getSessionMisses(), 1);
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+
+    // Idle sessions expire whichever shard holds them.
+    sleepmillis(10);
+    sessionCache->closeExpiredIdleSessions(2);
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+}
+
+TEST(WiredTigerSessionCacheTest, ConcurrentDurabilityWaitersShareFlushes) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    // Without a journal, each flush is a checkpoint.
+    const int kNumThreads = 8;
+    const int kNumWaitsPerThread = 10;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < kNumWaitsPerThread; ++j) {
+                sessionCache->waitUntilDurable(false, false);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    BSONObjBuilder builder;
+    sessionCache->appendStats(&builder);
+    const BSONObj groupCommit = builder.obj()["groupCommit"].Obj();
+    ASSERT_EQUALS(kNumThreads * kNumWaitsPerThread, groupCommit["waiters"].numberLong());
+
+    // Every flush falls into one batch size bucket.
+    const long long flushes = groupCommit["flushes"].numberLong();
+    ASSERT_GT(flushes, 0);
+    ASSERT_LTE(flushes, kNumThreads * kNumWaitsPerThread);
+    long long batches = 0;
+    for (auto&& bucket : groupCommit["batchSizes"].Obj()) {
+        batches += bucket.numberLong();
+    }
+    ASSERT_EQUALS(flushes, batches);
+    ASSERT_GT(groupCommit["averageFlushMicros"].numberLong(), 0);
+}
+
 }  // namespace mongo
@@ -31,6 +31,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <tuple>
+#include <vector>
 #include <wiredtiger.h>
 
 #include "mongo/bson/bsonobj.h"
@@ -119,6 +121,9 @@ std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(Strin
     auto result = std::make_shared<SizeInfo>();
     result->numRecords.store(data["numRecords"].safeNumberLong());
     result->dataSize.store(data["dataSize"].safeNumberLong());
+    result->_persisted = true;
+    result->_persistedNumRecords = result->numRecords.load();
+    result->_persistedDataSize = result->dataSize.load();
     return result;
 }
 
@@ -132,15 +137,42 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
     if (buffer.empty())
         return;  // Nothing to do.
 
+    _writeEntries(&buffer, syncToDisk);
+}
+
+size_t WiredTigerSizeStorer::flushBatch(size_t maxEntries) {
+    invariant(maxEntries > 0);
+
+    Buffer buffer;
+    size_t remaining;
+    {
+        stdx::lock_guard<stdx::mutex> bufferLock(_bufferMutex);
+        if (_buffer.size() <= maxEntries) {
+            _buffer.swap(buffer);
+        } else {
+            for (auto it = _buffer.begin(); buffer.size() < maxEntries;) {
+                buffer.try_emplace(it->first, std::move(it->second));
+                _buffer.erase(it++);
+            }
+        }
+        remaining = _buffer.size();
+    }
+
+    if (!buffer.empty())
+        _writeEntries(&buffer, false);
+    return remaining;
+}
+
+void WiredTigerSizeStorer::_writeEntries(Buffer* buffer, bool syncToDisk) {
     Timer t;
     stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
     {
         // On failure, place entries back into the map, unless a newer value already exists.
-        ON_BLOCK_EXIT([this, &buffer]() {
+        ON_BLOCK_EXIT([this, buffer]() {
             this->_cursor->reset(this->_cursor);
-            if (!buffer.empty()) {
+            if (!buffer->empty()) {
                 stdx::lock_guard<stdx::mutex> bufferLock(this->_bufferMutex);
-                for (auto& it : buffer)
+                for (auto& it : *buffer)
                     this->_buffer.try_emplace(it.first, it.second);
             }
         });
@@ -148,15 +180,25 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
         WT_SESSION* session = _session.getSession();
         WiredTigerBeginTxnBlock txnOpen(session, syncToDisk ? "sync=true" : nullptr);
 
-        for (auto it = buffer.begin(); it != buffer.end(); ++it) {
+        // The values written, which become the persisted values of their SizeInfo on commit.
+        std::vector<std::tuple<SizeInfo*, long long, long long>> written;
+        for (auto it = buffer->begin(); it != buffer->end(); ++it) {
 
             // Ordering is important here: when the store method checks if the SizeInfo
             // is dirty and it returns true, the current values of numRecords and dataSize must
             // still be written back. So, the required order is to clear the dirty flag first.
             SizeInfo& sizeInfo = *it->second;
             sizeInfo._dirty.store(false);
-            BSONObj data = BSON("numRecords" << sizeInfo.numRecords.load() << "dataSize"
-                                             << sizeInfo.dataSize.load());
+            const long long numRecords = sizeInfo.numRecords.load();
+            const long long dataSize = sizeInfo.dataSize.load();
+
+            // Only the collections whose sizes changed since they were last written are written.
+            if (sizeInfo._persisted && sizeInfo._persistedNumRecords == numRecords &&
+                sizeInfo._persistedDataSize == dataSize) {
+                continue;
+            }
+
+            BSONObj data = BSON("numRecords" << numRecords << "dataSize" << dataSize);
 
             auto& uri = it->first;
             LOG(2) << "WiredTigerSizeStorer::flush " << uri << " -> " << redact(data);
@@ -165,10 +207,20 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
             _cursor->set_key(_cursor, key.Get());
             _cursor->set_value(_cursor, value.Get());
             invariantWTOK(_cursor->insert(_cursor));
+            written.emplace_back(&sizeInfo, numRecords, dataSize);
         }
         txnOpen.done();
         invariantWTOK(session->commit_transaction(session, nullptr));
-        buffer.clear();
+
+        for (auto&& entry : written) {
+            SizeInfo* sizeInfo = std::get<0>(entry);
+            sizeInfo->_persisted = true;
+            sizeInfo->_persistedNumRecords = std::get<1>(entry);
+            sizeInfo->_persistedDataSize = std::get<2>(entry);
+        }
+        LOG(2) << "WiredTigerSizeStorer wrote " << written.size() << " of " << buffer->size()
+               << " entries";
+        buffer->clear();
     }
 
     auto micros = t.micros();
@@ -71,6 +71,13 @@ public:
     private:
         friend WiredTigerSizeStorer;
         AtomicWord<bool> _dirty;
+
+        // The values last written to or read from the table, so that a flush can skip a SizeInfo
+        // which was marked dirty but has since returned to them. Guarded by the size storer's
+        // _cursorMutex.
+        bool _persisted = false;
+        long long _persistedNumRecords = 0;
+        long long _persistedDataSize = 0;
     };
 
     WiredTigerSizeStorer(WT_CONNECTION* conn,
@@ -91,15 +98,28 @@ public:
      */
     void flush(bool syncToDisk);
 
+    /**
+     * Writes at most 'maxEntries' of the pending changes to the underlying table in a single
+     * transaction, leaving the others for later calls so that no one call holds the table for
+     * long. Returns the number of changes still pending.
+     */
+    size_t flushBatch(size_t maxEntries);
+
 private:
+    using Buffer = StringMap<std::shared_ptr<SizeInfo>>;
+
+    /**
+     * Writes the entries taken out of _buffer into 'buffer' to the table. On failure, puts them
+     * back into _buffer unless newer values are there already.
+     */
+    void _writeEntries(Buffer* buffer, bool syncToDisk);
+
     const WiredTigerSession _session;
     const bool _readOnly;
     // Guards _cursor. Acquire *before* _bufferMutex.
     mutable stdx::mutex _cursorMutex;
     WT_CURSOR* _cursor;  // pointer is const after constructor
 
-    using Buffer = StringMap<std::shared_ptr<SizeInfo>>;
-
     mutable stdx::mutex _bufferMutex;  // Guards _buffer
     Buffer _buffer;
 };
@@ -297,6 +297,43 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(nullptr);  // this has to be deleted before ss
 }
 
+TEST(WiredTigerRecordStoreTest, SizeStorerFlushesInBoundedBatches) {
+    WiredTigerHarnessHelper harnessHelper;
+    const std::string storageUri = WiredTigerKVEngine::kTableUriPrefix + "sizeStorer";
+    WiredTigerSizeStorer ss(harnessHelper.conn(), storageUri);
+
+    std::vector<std::shared_ptr<WiredTigerSizeStorer::SizeInfo>> sizeInfos;
+    for (int i = 0; i < 5; i++) {
+        auto sizeInfo = std::make_shared<WiredTigerSizeStorer::SizeInfo>();
+        sizeInfo->numRecords.store(i);
+        sizeInfo->dataSize.store(10 * i);
+        ss.store("table:coll" + std::to_string(i), sizeInfo);
+        sizeInfos.push_back(sizeInfo);
+    }
+
+    // Each batch writes at most two of the five collections.
+    ASSERT_EQUALS(3U, ss.flushBatch(2));
+    ASSERT_EQUALS(1U, ss.flushBatch(2));
+    ASSERT_EQUALS(0U, ss.flushBatch(2));
+    ASSERT_EQUALS(0U, ss.flushBatch(2));
+
+    // A collection whose size changes and changes back is still stored correctly.
+    sizeInfos[3]->numRecords.store(100);
+    ss.store("table:coll3", sizeInfos[3]);
+    sizeInfos[3]->numRecords.store(3);
+    ASSERT_EQUALS(0U, ss.flushBatch(10));
+    sizeInfos[4]->dataSize.store(41);
+    ss.store("table:coll4", sizeInfos[4]);
+    ss.flush(false);
+
+    WiredTigerSizeStorer ss2(harnessHelper.conn(), storageUri);
+    for (int i = 0; i < 5; i++) {
+        auto info = ss2.load("table:coll" + std::to_string(i));
+        ASSERT_EQUALS(i, info->numRecords.load());
+        ASSERT_EQUALS(i == 4 ? 41 : 10 * i, info->dataSize.load());
+    }
+}
+
 class SizeStorerUpdateTest : public mongo::unittest::Test {
 private:
     virtual void setUp() {
@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_adjuster.h"
+
+#include <algorithm>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+// An increase is kept as long as the throughput does not fall by more than this fraction.
+const double kThroughputTolerance = 0.05;
+
+// After an increase is undone, the number of tickets is not increased for this many intervals.
+const int kIntervalsWithoutIncreaseAfterRevert = 10;
+
+int step(int tickets) {
+    return std::max(1, tickets / 10);
+}
+
+}  // namespace
+
+WiredTigerTicketAdjuster::WiredTigerTicketAdjuster(int minTickets, int maxTickets)
+    : _minTickets(minTickets), _maxTickets(maxTickets) {
+    invariant(0 < minTickets && minTickets <= maxTickets);
+}
+
+int WiredTigerTicketAdjuster::adjust(const Sample& sample, int currentTickets) {
+    if (!_hasSample) {
+        _hasSample = true;
+        _lastSample = sample;
+        _lastAdjustment = Adjustment::kNone;
+        return std::min(std::max(currentTickets, _minTickets), _maxTickets);
+    }
+
+    const long long throughput = sample.numAcquired - _lastSample.numAcquired;
+    const bool delayed = sample.numDelayed > _lastSample.numDelayed;
+    _lastSample = sample;
+    _lastThroughput = throughput;
+    if (_intervalsWithoutIncrease > 0) {
+        _intervalsWithoutIncrease--;
+    }
+
+    const bool increaseLoweredThroughput = _lastAdjustment == Adjustment::kIncrease &&
+        throughput < _throughputBeforeIncrease * (1 - kThroughputTolerance);
+
+    int tickets = currentTickets;
+    if (sample.cacheUnderPressure) {
+        tickets = std::max(_minTickets, currentTickets - step(currentTickets));
+        _lastAdjustment = Adjustment::kDecrease;
+    } else if (increaseLoweredThroughput) {
+        tickets = std::max(_minTickets, currentTickets - _lastIncrease);
+        _lastAdjustment = Adjustment::kRevert;
+        _intervalsWithoutIncrease = kIntervalsWithoutIncreaseAfterRevert;
+    } else if (delayed && currentTickets < _maxTickets && _intervalsWithoutIncrease == 0) {
+        _lastIncrease = std::min(step(currentTickets), _maxTickets - currentTickets);
+        _throughputBeforeIncrease = throughput;
+        tickets = currentTickets + _lastIncrease;
+        _lastAdjustment = Adjustment::kIncrease;
+    } else {
+        _lastAdjustment = Adjustment::kNone;
+    }
+
+    tickets = std::min(std::max(tickets, _minTickets), _maxTickets);
+    if (tickets == currentTickets) {
+        _lastAdjustment = Adjustment::kNone;
+    }
+
+    switch (_lastAdjustment) {
+        case Adjustment::kNone:
+            break;
+        case Adjustment::kIncrease:
+            _numIncreases++;
+            break;
+        case Adjustment::kDecrease:
+            _numDecreases++;
+            break;
+        case Adjustment::kRevert:
+            _numReverts++;
+            break;
+    }
+    return tickets;
+}
+
+void WiredTigerTicketAdjuster::appendStats(BSONObjBuilder* builder) const {
+    builder->append("throughput", _lastThroughput);
+    builder->append("lastAdjustment", adjustmentName(_lastAdjustment));
+    builder->append("increases", _numIncreases);
+    builder->append("decreases", _numDecreases);
+    builder->append("reverts", _numReverts);
+}
+
+StringData WiredTigerTicketAdjuster::adjustmentName(Adjustment adjustment) {
+    switch (adjustment) {
+        case Adjustment::kNone:
+            return "none";
+        case Adjustment::kIncrease:
+            return "increase";
+        case Adjustment::kDecrease:
+            return "decrease";
+        case Adjustment::kRevert:
+            return "revert";
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo {
+
+/**
+ * Decides, once per interval, how many tickets a TicketHolder should have, from the throughput
+ * and delays of its ticket acquisitions and from the pressure on the WiredTiger cache.
+ *
+ * While the cache is under pressure, the number of tickets shrinks by a tenth every interval, as
+ * more concurrent transactions would only make it harder for eviction to keep up. Otherwise, while
+ * operations are delayed waiting for tickets, the number grows by a tenth, as long as that does not
+ * lower the throughput. An increase which lowered the throughput is undone, and the number is then
+ * held for a while.
+ *
+ * Not thread safe; the adjustment thread owns each adjuster.
+ */
+class WiredTigerTicketAdjuster {
+    WiredTigerTicketAdjuster(const WiredTigerTicketAdjuster&) = delete;
+    WiredTigerTicketAdjuster& operator=(const WiredTigerTicketAdjuster&) = delete;
+
+public:
+    /**
+     * What was observed in one interval.
+     */
+    struct Sample {
+        // The numbers of tickets acquired, and of those which waited for a ticket, since startup.
+        long long numAcquired = 0;
+        long long numDelayed = 0;
+
+        // Whether the cache is so full or dirty that application threads are pulled into eviction.
+        bool cacheUnderPressure = false;
+    };
+
+    enum class Adjustment { kNone, kIncrease, kDecrease, kRevert };
+
+    WiredTigerTicketAdjuster(int minTickets, int maxTickets);
+
+    /**
+     * Returns how many tickets the holder, which has 'currentTickets' now, should have for the next
+     * interval.
+     */
+    int adjust(const Sample& sample, int currentTickets);
+
+    Adjustment lastAdjustment() const {
+        return _lastAdjustment;
+    }
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+    static StringData adjustmentName(Adjustment adjustment);
+
+private:
+    const int _minTickets;
+    const int _maxTickets;
+
+    bool _hasSample = false;
+    Sample _lastSample;
+    long long _lastThroughput = 0;
+
+    // The throughput of the interval before the last increase, and the size of that increase.
+    long long _throughputBeforeIncrease = 0;
+    int _lastIncrease = 0;
+    int _intervalsWithoutIncrease = 0;
+
+    Adjustment _lastAdjustment = Adjustment::kNone;
+    long long _numIncreases = 0;
+    long long _numDecreases = 0;
+    long long _numReverts = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_adjuster.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Adjustment = WiredTigerTicketAdjuster::Adjustment;
+
+WiredTigerTicketAdjuster::Sample makeSample(long long numAcquired,
+                                            long long numDelayed,
+                                            bool cacheUnderPressure = false) {
+    WiredTigerTicketAdjuster::Sample sample;
+    sample.numAcquired = numAcquired;
+    sample.numDelayed = numDelayed;
+    sample.cacheUnderPressure = cacheUnderPressure;
+    return sample;
+}
+
+TEST(WiredTigerTicketAdjusterTest, FirstSampleOnlyClampsTickets) {
+    WiredTigerTicketAdjuster adjuster(16, 256);
+    ASSERT_EQ(256, adjuster.adjust(makeSample(0, 0), 1000));
+    ASSERT(Adjustment::kNone == adjuster.lastAdjustment());
+}
+
+TEST(WiredTigerTicketAdjusterTest, GrowsWhileDelayedUpToMax) {
+    WiredTigerTicketAdjuster adjuster(16, 115);
+    ASSERT_EQ(100, adjuster.adjust(makeSample(0, 0), 100));
+
+    ASSERT_EQ(110, adjuster.adjust(makeSample(1000, 1), 100));
+    ASSERT(Adjustment::kIncrease == adjuster.lastAdjustment());
+
+    ASSERT_EQ(115, adjuster.adjust(makeSample(2000, 2), 110));
+    ASSERT(Adjustment::kIncrease == adjuster.lastAdjustment());
+
+    ASSERT_EQ(115, adjuster.adjust(makeSample(3000, 3), 115));
+    ASSERT(Adjustment::kNone == adjuster.lastAdjustment());
+
+    // Without delays the number of tickets is kept.
+    ASSERT_EQ(115, adjuster.adjust(makeSample(4000, 3), 115));
+    ASSERT(Adjustment::kNone == adjuster.lastAdjustment());
+}
+
+TEST(WiredTigerTicketAdjusterTest, RevertsIncreaseWhichLowersThroughput) {
+    WiredTigerTicketAdjuster adjuster(16, 256);
+    ASSERT_EQ(100, adjuster.adjust(makeSample(0, 0), 100));
+    ASSERT_EQ(110, adjuster.adjust(makeSample(1000, 1), 100));
+
+    // The throughput fell from 1000 to 800 per interval after the increase.
+    ASSERT_EQ(100, adjuster.adjust(makeSample(1800, 2), 110));
+    ASSERT(Adjustment::kRevert == adjuster.lastAdjustment());
+
+    // The number of tickets is then held for a while, even though operations are delayed.
+    long long numAcquired = 1800;
+    for (int i = 0; i < 9; i++) {
+        numAcquired += 1000;
+        ASSERT_EQ(100, adjuster.adjust(makeSample(numAcquired, 3 + i), 100));
+    }
+    ASSERT_EQ(110, adjuster.adjust(makeSample(numAcquired + 1000, 100), 100));
+}
+
+TEST(WiredTigerTicketAdjusterTest, ShrinksUnderCachePressureDownToMin) {
+    WiredTigerTicketAdjuster adjuster(90, 256);
+    ASSERT_EQ(100, adjuster.adjust(makeSample(0, 0), 100));
+
+    // Cache pressure wins over delayed operations.
+    ASSERT_EQ(90, adjuster.adjust(makeSample(1000, 1, true), 100));
+    ASSERT(Adjustment::kDecrease == adjuster.lastAdjustment());
+    ASSERT_EQ(90, adjuster.adjust(makeSample(2000, 2, true), 90));
+    ASSERT(Adjustment::kNone == adjuster.lastAdjustment());
+
+    BSONObjBuilder builder;
+    adjuster.appendStats(&builder);
+    const BSONObj stats = builder.obj();
+    ASSERT_EQ(1000, stats["throughput"].numberLong());
+    ASSERT_EQ(1, stats["decreases"].numberLong());
+    ASSERT_EQ(0, stats["increases"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -33,6 +33,7 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "mongo/base/simple_string_data_comparator.h"
@@ -383,6 +384,86 @@ size_t WiredTigerUtil::getCacheSizeMB(double requestedCacheSizeGB) {
     return static_cast<size_t>(cacheSizeMB);
 }
 
+bool WiredTigerUtil::calcModifyFromDiff(const WT_ITEM& oldValue,
+                                        const WT_ITEM& newValue,
+                                        size_t maxDiffBytes,
+                                        size_t maxEntries,
+                                        std::vector<WT_MODIFY>* entries) {
+    // Runs of differing bytes separated by fewer equal bytes than this are merged, since each
+    // modification costs more than a few bytes to describe and to apply.
+    const size_t kMergeGap = 8;
+
+    const char* oldData = static_cast<const char*>(oldValue.data);
+    const char* newData = static_cast<const char*>(newValue.data);
+    const size_t oldSize = oldValue.size;
+    const size_t newSize = newValue.size;
+
+    const size_t commonSize = std::min(oldSize, newSize);
+    size_t suffix = 0;
+    while (suffix < commonSize &&
+           oldData[oldSize - 1 - suffix] == newData[newSize - 1 - suffix]) {
+        ++suffix;
+    }
+
+    entries->clear();
+    size_t diffBytes = 0;
+    auto addEntry = [&](size_t offset, size_t size, size_t dataSize) {
+        diffBytes += dataSize;
+        if (entries->size() == maxEntries || diffBytes > maxDiffBytes) {
+            return false;
+        }
+        WT_MODIFY entry;
+        entry.data.data = newData + offset;
+        entry.data.size = dataSize;
+        entry.offset = offset;
+        entry.size = size;
+        entries->push_back(entry);
+        return true;
+    };
+
+    // Before the common suffix, both values are compared at the same offsets. Every modification
+    // but the last keeps its size, so the offsets of the later ones are unaffected.
+    const size_t alignedEnd = commonSize - suffix;
+    size_t pos = 0;
+    while (pos < alignedEnd) {
+        if (oldData[pos] == newData[pos]) {
+            ++pos;
+            continue;
+        }
+        const size_t start = pos;
+        size_t end = ++pos;
+        while (pos < alignedEnd && pos - end < kMergeGap) {
+            if (oldData[pos] != newData[pos]) {
+                end = pos + 1;
+            }
+            ++pos;
+        }
+        if (!addEntry(start, end - start, end - start)) {
+            return false;
+        }
+    }
+
+    // Whichever value is longer has bytes left between the aligned part and the common suffix.
+    if (oldSize != newSize) {
+        const size_t oldEnd = oldSize - suffix;
+        const size_t newEnd = newSize - suffix;
+        if (!entries->empty() && alignedEnd - (entries->back().offset + entries->back().size) <
+                kMergeGap) {
+            WT_MODIFY& last = entries->back();
+            diffBytes += newEnd - last.offset - last.data.size;
+            if (diffBytes > maxDiffBytes) {
+                return false;
+            }
+            last.data.size = newEnd - last.offset;
+            last.size = oldEnd - last.offset;
+        } else if (!addEntry(alignedEnd, oldEnd - alignedEnd, newEnd - alignedEnd)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 namespace {
 int mdb_handle_error_with_startup_suppression(WT_EVENT_HANDLER* handler,
                                               WT_SESSION* session,
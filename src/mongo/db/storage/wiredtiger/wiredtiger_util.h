@@ -30,6 +30,7 @@
 #pragma once
 
 #include <limits>
+#include <vector>
 #include <wiredtiger.h>
 
 #include "mongo/base/status.h"
@@ -223,6 +224,21 @@ public:
      */
     static size_t getCacheSizeMB(double requestedCacheSizeGB);
 
+    /**
+     * Computes the modifications that turn 'oldValue' into 'newValue' by comparing them byte by
+     * byte up to their common suffix. Changes which keep their size, such as the length headers
+     * of a BSON document and of its enclosing subdocuments, become modifications of the same
+     * size, and the last change absorbs any difference in size.
+     *
+     * Returns false if more than 'maxEntries' modifications or more than 'maxDiffBytes' bytes of
+     * new data are needed. The modifications point into the data of 'newValue'.
+     */
+    static bool calcModifyFromDiff(const WT_ITEM& oldValue,
+                                   const WT_ITEM& newValue,
+                                   size_t maxDiffBytes,
+                                   size_t maxEntries,
+                                   std::vector<WT_MODIFY>* entries);
+
     class ErrorAccumulator : public WT_EVENT_HANDLER {
     public:
         ErrorAccumulator(std::vector<std::string>* errors);
@@ -33,6 +33,7 @@
 #include <string>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
@@ -324,4 +325,100 @@ TEST(WiredTigerUtilTest, GetStatisticsValueValidKey) {
     ASSERT_EQUALS(0U, result.getValue());
 }
 
+namespace {
+
+/**
+ * Applies 'entries' to 'oldValue' in order, the way WT_CURSOR::modify() does.
+ */
+std::string applyModifications(const BSONObj& oldValue, const std::vector<WT_MODIFY>& entries) {
+    std::string value(oldValue.objdata(), oldValue.objsize());
+    for (const auto& entry : entries) {
+        ASSERT_LTE(entry.offset + entry.size, value.size());
+        value.replace(entry.offset,
+                      entry.size,
+                      static_cast<const char*>(entry.data.data),
+                      entry.data.size);
+    }
+    return value;
+}
+
+BSONObj makeDocument(long long counter, StringData name) {
+    const std::string padding(50 * 1024, 'x');
+    return BSON("_id" << 1 << "padding" << padding << "nested"
+                      << BSON("counter" << counter << "name" << name)
+                      << "tail"
+                      << padding);
+}
+
+bool diff(const BSONObj& oldObj, const BSONObj& newObj, std::vector<WT_MODIFY>* entries) {
+    WiredTigerItem oldValue(oldObj.objdata(), oldObj.objsize());
+    WiredTigerItem newValue(newObj.objdata(), newObj.objsize());
+    return WiredTigerUtil::calcModifyFromDiff(
+        oldValue, newValue, newObj.objsize() / 10, 16, entries);
+}
+
+std::string toString(const BSONObj& obj) {
+    return std::string(obj.objdata(), obj.objsize());
+}
+
+}  // namespace
+
+TEST(WiredTigerUtilTest, CalcModifyFromDiffSameSize) {
+    const BSONObj oldObj = makeDocument(1, "joe");
+    const BSONObj newObj = makeDocument(2, "joe");
+    std::vector<WT_MODIFY> entries;
+    ASSERT_TRUE(diff(oldObj, newObj, &entries));
+    ASSERT_EQ(1U, entries.size());
+    ASSERT_EQ(entries[0].size, entries[0].data.size);
+    ASSERT_EQ(toString(newObj), applyModifications(oldObj, entries));
+}
+
+TEST(WiredTigerUtilTest, CalcModifyFromDiffGrowingAndShrinkingField) {
+    const BSONObj oldObj = makeDocument(1, "joe");
+    const BSONObj newObj = makeDocument(1, "joe and some more characters");
+    std::vector<WT_MODIFY> entries;
+
+    // The document and 'nested' length headers, and the grown string.
+    ASSERT_TRUE(diff(oldObj, newObj, &entries));
+    ASSERT_EQ(3U, entries.size());
+    ASSERT_EQ(toString(newObj), applyModifications(oldObj, entries));
+    size_t diffBytes = 0;
+    for (const auto& entry : entries) {
+        diffBytes += entry.data.size;
+    }
+    ASSERT_LT(diffBytes, 64U);
+
+    ASSERT_TRUE(diff(newObj, oldObj, &entries));
+    ASSERT_EQ(toString(oldObj), applyModifications(newObj, entries));
+}
+
+TEST(WiredTigerUtilTest, CalcModifyFromDiffIdenticalValues) {
+    const BSONObj obj = makeDocument(1, "joe");
+    std::vector<WT_MODIFY> entries;
+    ASSERT_TRUE(diff(obj, obj, &entries));
+    ASSERT_TRUE(entries.empty());
+}
+
+TEST(WiredTigerUtilTest, CalcModifyFromDiffTooManyChanges) {
+    const BSONObj oldObj = makeDocument(1, "joe");
+    BSONObjBuilder builder;
+    builder.append("_id", 1);
+    builder.append("padding", std::string(50 * 1024, 'y'));
+    const BSONObj newObj = builder.obj();
+    std::vector<WT_MODIFY> entries;
+    ASSERT_FALSE(diff(oldObj, newObj, &entries));
+
+    std::string spread(oldObj.objdata(), oldObj.objsize());
+    for (size_t i = 100; i < 20 * 100; i += 100) {
+        spread[i] = 'z';
+    }
+    WiredTigerItem oldValue(oldObj.objdata(), oldObj.objsize());
+    WiredTigerItem newValue(spread);
+    ASSERT_FALSE(
+        WiredTigerUtil::calcModifyFromDiff(oldValue, newValue, spread.size(), 16, &entries));
+    ASSERT_TRUE(
+        WiredTigerUtil::calcModifyFromDiff(oldValue, newValue, spread.size(), 32, &entries));
+    ASSERT_EQ(19U, entries.size());
+}
+
 }  // namespace mongo
@@ -0,0 +1,541 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_compression.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/hasher.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace timeseries {
+namespace {
+
+const int kBucketVersion = 1;
+
+uint64_t zigZagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigZagDecode(uint64_t value) {
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+void appendVarUInt(BufBuilder* buf, uint64_t value) {
+    while (value >= 0x80) {
+        buf->appendChar(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    buf->appendChar(static_cast<char>(value));
+}
+
+/**
+ * Appends bits to a buffer, starting with the most significant bit of each byte.
+ */
+class BitWriter {
+public:
+    explicit BitWriter(BufBuilder* buf) : _buf(buf) {}
+
+    /**
+     * Appends the 'count' least significant bits of 'bits', starting with the most significant of
+     * them.
+     */
+    void write(uint64_t bits, int count) {
+        for (int i = count - 1; i >= 0; --i) {
+            _current = (_current << 1) | ((bits >> i) & 1);
+            if (++_numBits == 8) {
+                _buf->appendChar(static_cast<char>(_current));
+                _current = 0;
+                _numBits = 0;
+            }
+        }
+    }
+
+    /**
+     * Appends the bits of an incomplete last byte, padded with zeros.
+     */
+    void flush() {
+        if (_numBits > 0) {
+            write(0, 8 - _numBits);
+        }
+    }
+
+private:
+    BufBuilder* const _buf;
+    uint8_t _current = 0;
+    int _numBits = 0;
+};
+
+/**
+ * Reads the values and bits written to a column by 'appendVarUInt()' and 'BitWriter'. Throws if it
+ * reaches the end of the column.
+ */
+class ColumnReader {
+public:
+    ColumnReader(const char* data, int length) : _pos(data), _end(data + length) {}
+
+    uint64_t readVarUInt() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = readByte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        uasserted(51334, "Invalid varint in time-series bucket column");
+    }
+
+    uint64_t readBits(int count) {
+        uint64_t bits = 0;
+        for (int i = 0; i < count; ++i) {
+            if (_numBits == 0) {
+                _current = readByte();
+                _numBits = 8;
+            }
+            bits = (bits << 1) | ((_current >> --_numBits) & 1);
+        }
+        return bits;
+    }
+
+    uint8_t readByte() {
+        uassert(51335, "Truncated time-series bucket column", _pos < _end);
+        return static_cast<uint8_t>(*_pos++);
+    }
+
+private:
+    const char* _pos;
+    const char* const _end;
+    uint8_t _current = 0;
+    int _numBits = 0;
+};
+
+uint64_t doubleToBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsToDouble(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool canCompressColumnOf(BSONType type) {
+    return type == Date || type == NumberLong || type == NumberInt || type == NumberDouble;
+}
+
+int64_t toInt64(const BSONElement& elem) {
+    switch (elem.type()) {
+        case Date:
+            return elem.date().toMillisSinceEpoch();
+        case NumberLong:
+            return elem._numberLong();
+        case NumberInt:
+            return elem._numberInt();
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+/**
+ * Appends a column holding dates or integers of type 'type' as the zigzag encoded first value, the
+ * difference between the first two values, and then the differences between successive
+ * differences.
+ */
+void appendDeltaOfDeltaColumn(BSONObjBuilder* data,
+                              StringData fieldName,
+                              BSONType type,
+                              const std::vector<int64_t>& values) {
+    BufBuilder buf;
+    buf.appendChar(static_cast<char>(type));
+    uint64_t prev = 0;
+    uint64_t prevDelta = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        // Unsigned arithmetic wraps around for the differences of distant values, and the decoder
+        // wraps them back.
+        const uint64_t value = static_cast<uint64_t>(values[i]);
+        if (i == 0) {
+            appendVarUInt(&buf, zigZagEncode(values[i]));
+        } else {
+            const uint64_t delta = value - prev;
+            appendVarUInt(&buf, zigZagEncode(static_cast<int64_t>(delta - prevDelta)));
+            prevDelta = delta;
+        }
+        prev = value;
+    }
+    data->appendBinData(fieldName, buf.len(), BinDataGeneral, buf.buf());
+}
+
+/**
+ * Appends a column holding doubles as the first value, followed by the XOR of each value with the
+ * previous one. A zero XOR takes one bit. Otherwise the bits between the leading and trailing zeros
+ * of the XOR are stored, within the window of the previous XOR if they fit in it, and else with the
+ * number of leading zeros and of significant bits of the new window.
+ */
+void appendXorColumn(BSONObjBuilder* data,
+                     StringData fieldName,
+                     const std::vector<double>& values) {
+    BufBuilder buf;
+    buf.appendChar(static_cast<char>(NumberDouble));
+    BitWriter writer(&buf);
+    uint64_t prev = 0;
+    int prevLeading = -1;
+    int prevTrailing = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        const uint64_t bits = doubleToBits(values[i]);
+        if (i == 0) {
+            writer.write(bits, 64);
+            prev = bits;
+            continue;
+        }
+
+        const uint64_t xorBits = bits ^ prev;
+        prev = bits;
+        if (xorBits == 0) {
+            writer.write(0, 1);
+            continue;
+        }
+
+        writer.write(1, 1);
+        const int leading = std::min(countLeadingZeros64(xorBits), 31);
+        const int trailing = countTrailingZeros64(xorBits);
+        if (prevLeading >= 0 && leading >= prevLeading && trailing >= prevTrailing) {
+            writer.write(0, 1);
+            writer.write(xorBits >> prevTrailing, 64 - prevLeading - prevTrailing);
+        } else {
+            const int significant = 64 - leading - trailing;
+            writer.write(1, 1);
+            writer.write(leading, 5);
+            // 64 significant bits are stored as 0, which is never needed otherwise.
+            writer.write(significant == 64 ? 0 : significant, 6);
+            writer.write(xorBits >> trailing, significant);
+            prevLeading = leading;
+            prevTrailing = trailing;
+        }
+    }
+    writer.flush();
+    data->appendBinData(fieldName, buf.len(), BinDataGeneral, buf.buf());
+}
+
+/**
+ * Returns the 'count' values of a compressed column as an array.
+ */
+BSONObj decompressColumn(const BSONElement& column, int count) {
+    int length;
+    const char* data = column.binData(length);
+    ColumnReader reader(data, length);
+    const auto type = static_cast<BSONType>(reader.readByte());
+
+    BSONArrayBuilder values;
+    if (type == NumberDouble) {
+        uint64_t prev = 0;
+        int leading = 0;
+        int trailing = 0;
+        for (int i = 0; i < count; ++i) {
+            if (i == 0) {
+                prev = reader.readBits(64);
+            } else if (reader.readBits(1)) {
+                if (reader.readBits(1)) {
+                    leading = static_cast<int>(reader.readBits(5));
+                    int significant = static_cast<int>(reader.readBits(6));
+                    if (significant == 0) {
+                        significant = 64;
+                    }
+                    uassert(51336,
+                            "Invalid XOR window in time-series bucket column",
+                            leading + significant <= 64);
+                    trailing = 64 - leading - significant;
+                }
+                prev ^= reader.readBits(64 - leading - trailing) << trailing;
+            }
+            values.append(bitsToDouble(prev));
+        }
+        return values.arr();
+    }
+
+    uassert(51337,
+            str::stream() << "Invalid type " << typeName(type) << " of time-series bucket column",
+            type == Date || type == NumberLong || type == NumberInt);
+    uint64_t value = 0;
+    uint64_t delta = 0;
+    for (int i = 0; i < count; ++i) {
+        const uint64_t encoded = static_cast<uint64_t>(zigZagDecode(reader.readVarUInt()));
+        if (i == 0) {
+            value = encoded;
+        } else {
+            delta += encoded;
+            value += delta;
+        }
+
+        const auto signedValue = static_cast<int64_t>(value);
+        if (type == Date) {
+            values.append(Date_t::fromMillisSinceEpoch(signedValue));
+        } else if (type == NumberLong) {
+            values.append(static_cast<long long>(signedValue));
+        } else {
+            values.append(static_cast<int>(signedValue));
+        }
+    }
+    return values.arr();
+}
+
+/**
+ * Iterates over the values of a column, which either maps the position of each measurement that
+ * has the field to its value, or holds the values of all of them.
+ */
+class ColumnIterator {
+public:
+    ColumnIterator(StringData fieldName, BSONObj values)
+        : _fieldName(fieldName), _values(std::move(values)), _it(_values) {
+        _advance();
+    }
+
+    /**
+     * Appends the value of the measurement at position 'pos' to 'builder', if it has one. The
+     * positions must increase with each call.
+     */
+    void appendValue(int pos, BSONObjBuilder* builder) {
+        if (_next.eoo() || _nextPos != pos) {
+            return;
+        }
+        builder->appendAs(_next, _fieldName);
+        _advance();
+    }
+
+private:
+    void _advance() {
+        _next = _it.next();
+        if (_next.eoo()) {
+            return;
+        }
+        uassert(51338,
+                str::stream() << "Invalid position '" << _next.fieldNameStringData()
+                              << "' in time-series bucket column '"
+                              << _fieldName
+                              << "'",
+                parseNumberFromStringWithBase(_next.fieldNameStringData(), 10, &_nextPos).isOK());
+    }
+
+    StringData _fieldName;
+    BSONObj _values;
+    BSONObjIterator _it;
+    BSONElement _next;
+    int _nextPos = 0;
+};
+
+}  // namespace
+
+Date_t getBucketStart(const TimeseriesOptions& options, Date_t time) {
+    const long long spanMillis = options.getBucketMaxSpanSeconds() * 1000;
+    const long long millis = time.toMillisSinceEpoch();
+    // Round down, including for the dates before the epoch.
+    long long start = millis - millis % spanMillis;
+    if (millis % spanMillis < 0) {
+        start -= spanMillis;
+    }
+    return Date_t::fromMillisSinceEpoch(start);
+}
+
+BSONObj makeBucketId(Date_t start, const BSONElement& meta, int n) {
+    const long long metaHash =
+        meta.eoo() ? 0 : BSONElementHasher::hash64(meta, BSONElementHasher::DEFAULT_HASH_SEED);
+    return BSON(kBucketIdStartFieldName << start << kBucketIdMetaHashFieldName << metaHash
+                                        << kBucketIdSequenceFieldName
+                                        << n);
+}
+
+BSONObj makeBucket(const TimeseriesOptions& options,
+                   const BSONObj& id,
+                   const std::vector<BSONObj>& measurements) {
+    invariant(!measurements.empty());
+    const StringData timeField = options.getTimeField();
+    const auto metaField = options.getMetaField();
+
+    struct Column {
+        StringData fieldName;
+        std::vector<std::pair<int, BSONElement>> values;
+    };
+    std::vector<Column> columns;
+    StringMap<size_t> columnPositions;
+
+    std::vector<int64_t> times;
+    times.reserve(measurements.size());
+    BSONElement meta;
+    for (size_t pos = 0; pos < measurements.size(); ++pos) {
+        BSONElement time;
+        for (auto&& elem : measurements[pos]) {
+            const StringData fieldName = elem.fieldNameStringData();
+            if (fieldName == timeField) {
+                if (time.eoo()) {
+                    time = elem;
+                }
+                continue;
+            }
+            if (metaField && fieldName == *metaField) {
+                if (pos == 0 && meta.eoo()) {
+                    meta = elem;
+                }
+                continue;
+            }
+
+            auto it = columnPositions.find(fieldName);
+            if (it == columnPositions.end()) {
+                it = columnPositions.emplace(fieldName, columns.size()).first;
+                columns.push_back({fieldName, {}});
+            }
+            auto& values = columns[it->second].values;
+            // Only the first of several fields with the same name is stored.
+            if (values.empty() || values.back().first != static_cast<int>(pos)) {
+                values.emplace_back(pos, elem);
+            }
+        }
+
+        uassert(51333,
+                str::stream() << "'" << timeField << "' must be present and contain a valid date",
+                time.type() == Date);
+        times.push_back(time.date().toMillisSinceEpoch());
+    }
+
+    BSONObjBuilder bucket;
+    bucket.append(kBucketIdFieldName, id);
+    {
+        BSONObjBuilder control(bucket.subobjStart(kBucketControlFieldName));
+        control.append(kBucketControlVersionFieldName, kBucketVersion);
+        const auto minMax = std::minmax_element(times.begin(), times.end());
+        control.append(kBucketControlMinFieldName,
+                       BSON(timeField << Date_t::fromMillisSinceEpoch(*minMax.first)));
+        control.append(kBucketControlMaxFieldName,
+                       BSON(timeField << Date_t::fromMillisSinceEpoch(*minMax.second)));
+        control.append(kBucketControlCountFieldName, static_cast<int>(measurements.size()));
+    }
+    if (!meta.eoo()) {
+        bucket.appendAs(meta, kBucketMetaFieldName);
+    }
+
+    BSONObjBuilder data(bucket.subobjStart(kBucketDataFieldName));
+    appendDeltaOfDeltaColumn(&data, timeField, Date, times);
+    for (auto&& column : columns) {
+        const BSONType type = column.values.front().second.type();
+        const bool compressible = column.values.size() == measurements.size() &&
+            canCompressColumnOf(type) &&
+            std::all_of(column.values.begin(), column.values.end(), [type](const auto& value) {
+                return value.second.type() == type;
+            });
+
+        if (compressible && type == NumberDouble) {
+            std::vector<double> values;
+            values.reserve(column.values.size());
+            for (auto&& value : column.values) {
+                values.push_back(value.second._numberDouble());
+            }
+            appendXorColumn(&data, column.fieldName, values);
+        } else if (compressible) {
+            std::vector<int64_t> values;
+            values.reserve(column.values.size());
+            for (auto&& value : column.values) {
+                values.push_back(toInt64(value.second));
+            }
+            appendDeltaOfDeltaColumn(&data, column.fieldName, type, values);
+        } else {
+            BSONObjBuilder values(data.subobjStart(column.fieldName));
+            for (auto&& value : column.values) {
+                values.appendAs(value.second, std::to_string(value.first));
+            }
+        }
+    }
+    data.doneFast();
+    return bucket.obj();
+}
+
+void unpackBucket(const TimeseriesOptions& options,
+                  const BSONObj& bucket,
+                  std::vector<BSONObj>* measurements) {
+    const BSONElement control = bucket[kBucketControlFieldName];
+    const BSONElement data = bucket[kBucketDataFieldName];
+    uassert(51339,
+            "Time-series bucket must have 'control' and 'data' objects",
+            control.type() == Object && data.type() == Object);
+    const BSONElement countElem = control.Obj()[kBucketControlCountFieldName];
+    uassert(51340,
+            "Time-series bucket must have a positive 'control.count'",
+            countElem.isNumber() && countElem.numberInt() > 0);
+    const int count = countElem.numberInt();
+
+    const StringData timeField = options.getTimeField();
+    const auto metaField = options.getMetaField();
+    const BSONElement meta = bucket[kBucketMetaFieldName];
+
+    boost::optional<ColumnIterator> timeColumn;
+    std::vector<ColumnIterator> columns;
+    for (auto&& column : data.Obj()) {
+        const StringData fieldName = column.fieldNameStringData();
+        uassert(51341,
+                str::stream() << "Invalid type " << typeName(column.type())
+                              << " of time-series bucket column '"
+                              << fieldName
+                              << "'",
+                column.type() == BinData || column.type() == Object);
+        BSONObj values =
+            column.type() == BinData ? decompressColumn(column, count) : column.Obj();
+        if (fieldName == timeField) {
+            timeColumn.emplace(fieldName, std::move(values));
+        } else {
+            columns.emplace_back(fieldName, std::move(values));
+        }
+    }
+    uassert(51342,
+            str::stream() << "Time-series bucket has no '" << timeField << "' column",
+            timeColumn);
+
+    measurements->reserve(measurements->size() + count);
+    for (int pos = 0; pos < count; ++pos) {
+        BSONObjBuilder measurement;
+        timeColumn->appendValue(pos, &measurement);
+        if (metaField && !meta.eoo()) {
+            measurement.appendAs(meta, *metaField);
+        }
+        for (auto&& column : columns) {
+            column.appendValue(pos, &measurement);
+        }
+        measurements->push_back(measurement.obj());
+    }
+}
+
+}  // namespace timeseries
+}  // namespace mongo
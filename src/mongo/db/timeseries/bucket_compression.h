@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace timeseries {
+
+/**
+ * A time-series collection stores its measurements in the documents of a buckets collection. Each
+ * bucket holds the measurements with the same metadata over a span of time, as one column for each
+ * top-level field of the measurements:
+ *
+ * {
+ *     _id: {t: <start of the span>, m: <hash of the metadata>, n: <sequence number>},
+ *     control: {version: 1, min: {<time field>: <date>}, max: {<time field>: <date>}, count: <n>},
+ *     meta: <metadata, absent if the measurements have none>,
+ *     data: {<time field>: <column>, <field>: <column>, ...}
+ * }
+ *
+ * A column is BinData if every measurement has the field with the same date, integer or double
+ * type. Dates and integers are then compressed as the differences between successive differences
+ * of their values, which are small when the measurements are taken at regular intervals, and
+ * doubles as the XOR of each value with the previous one. Any other column is an object which maps
+ * the position of each measurement which has the field to its value.
+ */
+constexpr StringData kBucketIdFieldName = "_id"_sd;
+constexpr StringData kBucketIdStartFieldName = "t"_sd;
+constexpr StringData kBucketIdMetaHashFieldName = "m"_sd;
+constexpr StringData kBucketIdSequenceFieldName = "n"_sd;
+constexpr StringData kBucketControlFieldName = "control"_sd;
+constexpr StringData kBucketControlVersionFieldName = "version"_sd;
+constexpr StringData kBucketControlMinFieldName = "min"_sd;
+constexpr StringData kBucketControlMaxFieldName = "max"_sd;
+constexpr StringData kBucketControlCountFieldName = "count"_sd;
+constexpr StringData kBucketMetaFieldName = "meta"_sd;
+constexpr StringData kBucketDataFieldName = "data"_sd;
+
+/**
+ * Returns the start of the span of the bucket which holds the measurements taken at 'time'.
+ */
+Date_t getBucketStart(const TimeseriesOptions& options, Date_t time);
+
+/**
+ * Returns the '_id' of the bucket with sequence number 'n' among those which start at 'start' and
+ * hold measurements with a metadata hashing like 'meta', which is EOO for measurements without
+ * metadata. Measurements with the same metadata are added to the bucket with the next sequence
+ * number once a bucket is full, or if its metadata only has the same hash.
+ */
+BSONObj makeBucketId(Date_t start, const BSONElement& meta, int n);
+
+/**
+ * Returns the bucket with the '_id' 'id' which stores 'measurements', in order. The measurements
+ * must have the same metadata, and throws if one of them has no date in the time field.
+ */
+BSONObj makeBucket(const TimeseriesOptions& options,
+                   const BSONObj& id,
+                   const std::vector<BSONObj>& measurements);
+
+/**
+ * Appends the measurements stored in 'bucket' to 'measurements', in the order in which they were
+ * added to it. Each measurement has the time field first, followed by the meta field and then by
+ * its other fields in the order in which they first appear in the bucket.
+ */
+void unpackBucket(const TimeseriesOptions& options,
+                  const BSONObj& bucket,
+                  std::vector<BSONObj>* measurements);
+
+}  // namespace timeseries
+}  // namespace mongo
@@ -0,0 +1,229 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_compression.h"
+
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace timeseries {
+namespace {
+
+TimeseriesOptions makeOptions(bool withMeta) {
+    TimeseriesOptions options;
+    options.setTimeField("time"_sd);
+    if (withMeta) {
+        options.setMetaField("tags"_sd);
+    }
+    options.setBucketMaxSpanSeconds(60);
+    return options;
+}
+
+Date_t makeTime(long long millis) {
+    return Date_t::fromMillisSinceEpoch(millis);
+}
+
+std::vector<BSONObj> roundTrip(const TimeseriesOptions& options,
+                               const std::vector<BSONObj>& measurements) {
+    const BSONObj bucket = makeBucket(options, BSON("x" << 1), measurements);
+    std::vector<BSONObj> unpacked;
+    unpackBucket(options, bucket, &unpacked);
+    return unpacked;
+}
+
+TEST(BucketCompression, RoundTripsDenseColumns) {
+    const auto options = makeOptions(true);
+    std::vector<BSONObj> measurements;
+    for (int i = 0; i < 100; ++i) {
+        measurements.push_back(BSON("time" << makeTime(1000000 + i * 1000) << "tags"
+                                           << BSON("sensor" << 7)
+                                           << "temp"
+                                           << 20.5 + (i % 7) * 0.25
+                                           << "count"
+                                           << i * i
+                                           << "total"
+                                           << static_cast<long long>(i) * -123456789LL));
+    }
+
+    const auto unpacked = roundTrip(options, measurements);
+    ASSERT_EQ(measurements.size(), unpacked.size());
+    for (size_t i = 0; i < measurements.size(); ++i) {
+        ASSERT_BSONOBJ_EQ(measurements[i], unpacked[i]);
+    }
+}
+
+TEST(BucketCompression, CompressesRegularTimesAndRepeatedDoubles) {
+    const auto options = makeOptions(false);
+    std::vector<BSONObj> measurements;
+    for (int i = 0; i < 1000; ++i) {
+        measurements.push_back(BSON("time" << makeTime(i * 1000) << "value" << 1.5));
+    }
+
+    const BSONObj bucket = makeBucket(options, BSON("x" << 1), measurements);
+    const BSONObj data = bucket[kBucketDataFieldName].Obj();
+    ASSERT_EQ(BinData, data["time"].type());
+    ASSERT_EQ(BinData, data["value"].type());
+    // A type byte, the first two values and one byte for each difference of the differences.
+    int length;
+    data["time"].binData(length);
+    ASSERT_LTE(length, 1 + 10 + 1000);
+    // A type byte, the first value and one bit for each repeated value.
+    data["value"].binData(length);
+    ASSERT_LTE(length, 1 + 8 + 1000 / 8 + 1);
+
+    ASSERT_BSONOBJ_EQ(
+        BSON("version" << 1 << "min" << BSON("time" << makeTime(0)) << "max"
+                       << BSON("time" << makeTime(999000))
+                       << "count"
+                       << 1000),
+        bucket[kBucketControlFieldName].Obj());
+}
+
+TEST(BucketCompression, RoundTripsSpecialDoublesAndExtremeIntegers) {
+    const auto options = makeOptions(false);
+    const std::vector<double> doubles = {0.0,
+                                         -0.0,
+                                         std::numeric_limits<double>::infinity(),
+                                         std::numeric_limits<double>::max(),
+                                         std::numeric_limits<double>::denorm_min(),
+                                         -1e300,
+                                         3.14159,
+                                         3.14159,
+                                         2.71828};
+    const std::vector<long long> longs = {std::numeric_limits<long long>::max(),
+                                          std::numeric_limits<long long>::min(),
+                                          0,
+                                          -1,
+                                          std::numeric_limits<long long>::max(),
+                                          1,
+                                          std::numeric_limits<long long>::min(),
+                                          42,
+                                          42};
+    std::vector<BSONObj> measurements;
+    for (size_t i = 0; i < doubles.size(); ++i) {
+        measurements.push_back(
+            BSON("time" << makeTime(-5000 + static_cast<long long>(i) * 7919) << "d" << doubles[i]
+                        << "l"
+                        << longs[i]));
+    }
+
+    const auto unpacked = roundTrip(options, measurements);
+    ASSERT_EQ(measurements.size(), unpacked.size());
+    for (size_t i = 0; i < measurements.size(); ++i) {
+        // Compare the bytes, which distinguishes -0.0 from 0.0.
+        ASSERT(measurements[i].binaryEqual(unpacked[i]))
+            << measurements[i] << " != " << unpacked[i];
+    }
+}
+
+TEST(BucketCompression, StoresSparseAndMixedColumnsByPosition) {
+    const auto options = makeOptions(true);
+    const std::vector<BSONObj> measurements = {
+        BSON("time" << makeTime(1) << "a" << 1 << "b"
+                    << "x"),
+        BSON("time" << makeTime(2) << "a" << 2.5),
+        BSON("time" << makeTime(3) << "c" << BSON("nested" << true) << "b"
+                    << "y"),
+    };
+
+    const BSONObj bucket = makeBucket(options, BSON("x" << 1), measurements);
+    ASSERT_FALSE(bucket.hasField(kBucketMetaFieldName));
+    const BSONObj data = bucket[kBucketDataFieldName].Obj();
+    ASSERT_BSONOBJ_EQ(BSON("0" << 1 << "1" << 2.5), data["a"].Obj());
+    ASSERT_BSONOBJ_EQ(BSON("0"
+                           << "x"
+                           << "2"
+                           << "y"),
+                      data["b"].Obj());
+
+    const auto unpacked = roundTrip(options, measurements);
+    ASSERT_EQ(measurements.size(), unpacked.size());
+    ASSERT_BSONOBJ_EQ(measurements[0], unpacked[0]);
+    ASSERT_BSONOBJ_EQ(measurements[1], unpacked[1]);
+    // The fields follow the order in which they first appear in the bucket.
+    ASSERT_BSONOBJ_EQ(BSON("time" << makeTime(3) << "b"
+                                  << "y"
+                                  << "c"
+                                  << BSON("nested" << true)),
+                      unpacked[2]);
+}
+
+TEST(BucketCompression, RequiresDateInTimeField) {
+    const auto options = makeOptions(false);
+    ASSERT_THROWS_CODE(makeBucket(options, BSON("x" << 1), {BSON("time" << 1)}),
+                       AssertionException,
+                       51333);
+    ASSERT_THROWS_CODE(
+        makeBucket(options, BSON("x" << 1), {BSON("time" << makeTime(1)), BSON("other" << 1)}),
+        AssertionException,
+        51333);
+}
+
+TEST(BucketCompression, RejectsTruncatedColumn) {
+    const auto options = makeOptions(false);
+    BSONObj bucket = makeBucket(options, BSON("x" << 1), {BSON("time" << makeTime(1))});
+    BSONObjBuilder truncated;
+    truncated.append(bucket[kBucketControlFieldName]);
+    truncated.append(kBucketDataFieldName,
+                     BSON("time" << BSONBinData("\x09", 1, BinDataGeneral)));
+    std::vector<BSONObj> unpacked;
+    ASSERT_THROWS_CODE(
+        unpackBucket(options, truncated.obj(), &unpacked), AssertionException, 51335);
+}
+
+TEST(BucketCompression, BucketStartRoundsDown) {
+    const auto options = makeOptions(false);
+    ASSERT_EQ(makeTime(60000), getBucketStart(options, makeTime(60000)));
+    ASSERT_EQ(makeTime(60000), getBucketStart(options, makeTime(119999)));
+    ASSERT_EQ(makeTime(-60000), getBucketStart(options, makeTime(-1)));
+    ASSERT_EQ(makeTime(0), getBucketStart(options, makeTime(0)));
+}
+
+TEST(BucketCompression, BucketIdDependsOnMetadataHash) {
+    const BSONObj withMeta = BSON("tags" << BSON("sensor" << 1));
+    const BSONObj sameMeta = BSON("other" << BSON("sensor" << 1));
+    const BSONObj otherMeta = BSON("tags" << BSON("sensor" << 2));
+    ASSERT_BSONOBJ_EQ(makeBucketId(makeTime(0), withMeta.firstElement(), 0),
+                      makeBucketId(makeTime(0), sameMeta.firstElement(), 0));
+    ASSERT_BSONOBJ_NE(makeBucketId(makeTime(0), withMeta.firstElement(), 0),
+                      makeBucketId(makeTime(0), otherMeta.firstElement(), 0));
+    ASSERT_BSONOBJ_EQ(BSON("t" << makeTime(0) << "m" << 0LL << "n" << 3),
+                      makeBucketId(makeTime(0), BSONElement(), 3));
+}
+
+}  // namespace
+}  // namespace timeseries
+}  // namespace mongo
@@ -71,16 +71,6 @@ namespace mongo {
 
 namespace {
 
-// Packet struct
-struct TrafficReaderPacket {
-    uint64_t id;
-    StringData local;
-    StringData remote;
-    Date_t date;
-    uint64_t order;
-    MsgData::ConstView message;
-};
-
 bool readBytes(size_t toRead, char* buf, int fd) {
     while (toRead) {
 #ifdef _WIN32
@@ -109,6 +99,8 @@ bool readBytes(size_t toRead, char* buf, int fd) {
     return true;
 }
 
+}  // namespace
+
 boost::optional<TrafficReaderPacket> readPacket(char* buf, int fd) {
     if (!readBytes(4, buf, fd)) {
         return boost::none;
@@ -134,6 +126,8 @@ boost::optional<TrafficReaderPacket> readPacket(char* buf, int fd) {
         id, local, remote, Date_t::fromMillisSinceEpoch(date), order, message};
 }
 
+namespace {
+
 void getBSONObjFromPacket(TrafficReaderPacket& packet, BSONObjBuilder* builder) {
     {
         // RawOp Field
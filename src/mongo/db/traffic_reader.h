@@ -27,12 +27,30 @@
  *    it in the license file.
  */
 
+#include <boost/optional.hpp>
+
+#include "mongo/base/string_data.h"
 #include "mongo/rpc/op_msg.h"
+#include "mongo/util/time_support.h"
 
 #pragma once
 
 namespace mongo {
 
+// A packet of a traffic recording, which points into the buffer it was read into.
+struct TrafficReaderPacket {
+    uint64_t id;
+    StringData local;
+    StringData remote;
+    Date_t date;
+    uint64_t order;
+    MsgData::ConstView message;
+};
+
+// Reads the next packet of the traffic recording 'fd' into 'buf', which must hold at least
+// MaxMessageSizeBytes. Returns boost::none at the end of the recording.
+boost::optional<TrafficReaderPacket> readPacket(char* buf, int fd);
+
 // Method for testing, takes the recorded traffic and returns a BSONArray
 BSONArray trafficRecordingFileToBSONArr(const std::string& inputFile);
 
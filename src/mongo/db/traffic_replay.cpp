@@ -0,0 +1,253 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/traffic_replay.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <map>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/client/dbclient_connection.h"
+#include "mongo/db/traffic_reader.h"
+#include "mongo/rpc/factory.h"
+#include "mongo/rpc/message.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+namespace {
+
+struct ReplayRequest {
+    // The time since the first request of the recording at which this request was recorded.
+    Milliseconds offset;
+    std::string name;
+    bool expectsResponse;
+    Message message;
+};
+
+/**
+ * Returns the name under which the latencies of 'message' are reported.
+ */
+std::string requestName(const Message& message) {
+    if (message.operation() == dbMsg) {
+        return rpc::opMsgRequestFromAnyProtocol(message).getCommandName().toString();
+    }
+    return networkOpToString(message.operation());
+}
+
+bool requestExpectsResponse(const Message& message) {
+    switch (message.operation()) {
+        case dbMsg:
+            return !OpMsg::isFlagSet(message, OpMsg::kMoreToCome);
+        case dbQuery:
+        case dbGetMore:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Reads the requests of a recording, leaving out the responses, and assigns them to one of
+ * 'numConnections' lists by the session they were recorded on.
+ */
+std::vector<std::vector<ReplayRequest>> readRequests(const std::string& inputFile,
+                                                     int numConnections) {
+#ifdef _WIN32
+    auto inputFd = ::open(inputFile.c_str(), O_RDONLY | O_BINARY);
+#else
+    auto inputFd = ::open(inputFile.c_str(), O_RDONLY);
+#endif
+
+    uassert(ErrorCodes::FileNotOpen,
+            str::stream() << "Specified file does not exist (" << inputFile << ")",
+            inputFd > 0);
+
+    const auto guard = makeGuard([&] { ::close(inputFd); });
+
+    std::vector<std::vector<ReplayRequest>> requests(numConnections);
+    boost::optional<Date_t> firstDate;
+    auto buf = SharedBuffer::allocate(MaxMessageSizeBytes);
+    while (auto packet = readPacket(buf.get(), inputFd)) {
+        if (packet->message.getResponseToMsgId()) {
+            continue;
+        }
+
+        if (!firstDate) {
+            firstDate = packet->date;
+        }
+
+        Message message;
+        message.setData(
+            packet->message.getNetworkOp(), packet->message.data(), packet->message.dataLen());
+        if (message.operation() == dbMsg) {
+            // The checksum won't be valid once the network layer assigns a new requestId.
+            OpMsg::removeChecksum(&message);
+        }
+
+        auto name = requestName(message);
+        bool expectsResponse = requestExpectsResponse(message);
+        requests[packet->id % numConnections].push_back(
+            {packet->date - *firstDate, std::move(name), expectsResponse, std::move(message)});
+    }
+
+    return requests;
+}
+
+class LatencyStats {
+public:
+    void add(const std::string& name, Microseconds latency) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _latencies[name].push_back(latency);
+    }
+
+    void append(BSONObjBuilder* builder) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (auto&& entry : _latencies) {
+            auto& latencies = entry.second;
+            std::sort(latencies.begin(), latencies.end());
+
+            // Uses the nearest-rank definition of a percentile.
+            auto percentile = [&](int p) {
+                size_t rank = (latencies.size() * p + 99) / 100;
+                return durationCount<Microseconds>(latencies[std::max<size_t>(rank, 1) - 1]);
+            };
+
+            BSONObjBuilder commandBuilder(builder->subobjStart(entry.first));
+            commandBuilder.append("count", static_cast<long long>(latencies.size()));
+            commandBuilder.append("p50Micros", percentile(50));
+            commandBuilder.append("p90Micros", percentile(90));
+            commandBuilder.append("p99Micros", percentile(99));
+            commandBuilder.append("maxMicros", durationCount<Microseconds>(latencies.back()));
+        }
+    }
+
+private:
+    stdx::mutex _mutex;
+    std::map<std::string, std::vector<Microseconds>> _latencies;
+};
+
+void replayRequests(const TrafficReplayOptions& options,
+                    Date_t start,
+                    std::vector<ReplayRequest>& requests,
+                    LatencyStats* stats) {
+    DBClientConnection conn;
+    uassertStatusOK(conn.connect(options.target, "mongotrafficreplay"));
+
+    for (auto&& request : requests) {
+        if (options.speed > 0) {
+            auto offset = Milliseconds(static_cast<long long>(
+                static_cast<double>(durationCount<Milliseconds>(request.offset)) / options.speed));
+            auto delay = start + offset - Date_t::now();
+            if (delay > Milliseconds(0)) {
+                sleepFor(delay);
+            }
+        }
+
+        Timer timer;
+        if (request.expectsResponse) {
+            Message response;
+            uassert(ErrorCodes::HostUnreachable,
+                    str::stream() << "Lost the connection to " << options.target.toString(),
+                    conn.call(request.message, response, false, nullptr));
+        } else {
+            conn.say(request.message);
+        }
+        stats->add(request.name, Microseconds(timer.micros()));
+    }
+}
+
+}  // namespace
+
+BSONObj replayTrafficRecording(const std::string& inputFile, const TrafficReplayOptions& options) {
+    uassert(ErrorCodes::BadValue,
+            "The number of connections to replay over must be positive",
+            options.numConnections > 0);
+    uassert(ErrorCodes::BadValue, "The replay speed must not be negative", options.speed >= 0);
+
+    auto requests = readRequests(inputFile, options.numConnections);
+
+    LatencyStats stats;
+    stdx::mutex statusMutex;
+    Status status = Status::OK();
+    std::vector<stdx::thread> threads;
+    long long numRequests = 0;
+
+    Timer timer;
+    const auto start = Date_t::now();
+    for (auto&& connectionRequests : requests) {
+        if (connectionRequests.empty()) {
+            continue;
+        }
+
+        numRequests += connectionRequests.size();
+        threads.emplace_back([&, connectionRequests = &connectionRequests] {
+            try {
+                replayRequests(options, start, *connectionRequests, &stats);
+            } catch (const DBException& ex) {
+                stdx::lock_guard<stdx::mutex> lk(statusMutex);
+                if (status.isOK()) {
+                    status = ex.toStatus();
+                }
+            }
+        });
+    }
+
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    uassertStatusOK(status);
+
+    BSONObjBuilder builder;
+    builder.append("numRequests", numRequests);
+    builder.append("durationMillis", timer.millis());
+    {
+        BSONObjBuilder commandsBuilder(builder.subobjStart("commands"));
+        stats.append(&commandsBuilder);
+    }
+    return builder.obj();
+}
+
+}  // namespace mongo
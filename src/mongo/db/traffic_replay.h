@@ -0,0 +1,70 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <string>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/net/hostandport.h"
+
+namespace mongo {
+
+struct TrafficReplayOptions {
+    // The server to replay the recorded requests against.
+    HostAndPort target;
+
+    // How many times faster than recorded the requests are sent. 0 sends them as fast as possible.
+    double speed = 1.0;
+
+    // The number of connections over which the recorded sessions are spread. The requests of a
+    // recorded session are always sent in order over the same connection.
+    int numConnections = 4;
+};
+
+/**
+ * Replays the requests of the traffic recording 'inputFile' against 'options.target' at their
+ * recorded timing, and returns a summary of the replay of the form
+ *
+ * {
+ *     numRequests: <num>,
+ *     durationMillis: <num>,
+ *     commands: {
+ *         <command name>: {count: <num>, p50Micros: <num>, p90Micros: <num>, p99Micros: <num>,
+ *                          maxMicros: <num>},
+ *         ...
+ *     }
+ * }
+ *
+ * Responses are only waited for, not compared with the recorded ones.
+ */
+BSONObj replayTrafficRecording(const std::string& inputFile, const TrafficReplayOptions& options);
+
+}  // namespace mongo
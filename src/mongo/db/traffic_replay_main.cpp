@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <iostream>
+#include <string>
+
+#include "mongo/base/initializer.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/traffic_replay.h"
+#include "mongo/transport/transport_layer_manager.h"
+#include "mongo/util/exit_code.h"
+#include "mongo/util/quick_exit.h"
+#include "mongo/util/signal_handlers.h"
+#include "mongo/util/text.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+namespace mongo {
+namespace {
+
+int trafficReplayMain(int argc, char** argv, char** envp) {
+    setupSignalHandlers();
+
+    Status status = mongo::runGlobalInitializers(argc, argv, envp);
+    if (!status.isOK()) {
+        std::cerr << "Failed global initialization: " << status << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    startSignalProcessingThread();
+
+    boost::program_options::variables_map vm;
+    std::string inputFile;
+    TrafficReplayOptions options;
+
+    try {
+        // Define the program options
+        boost::program_options::options_description desc{"Options"};
+        desc.add_options()("help,h", "help")(
+            "input,i",
+            boost::program_options::value<std::string>(),
+            "Path to the traffic recording to replay")(
+            "host",
+            boost::program_options::value<std::string>()->default_value("localhost:27017"),
+            "The server to replay the traffic against")(
+            "speed",
+            boost::program_options::value<double>()->default_value(1.0),
+            "How many times faster than recorded to replay the traffic, 0 replays it as fast as "
+            "possible")("connections",
+                        boost::program_options::value<int>()->default_value(4),
+                        "The number of connections to spread the recorded sessions over");
+
+        // Parse the program options
+        store(parse_command_line(argc, argv, desc), vm);
+        notify(vm);
+
+        // Handle the help option
+        if (vm.count("help")) {
+            std::cout << "Mongo Traffic Replay Help: \n\n\t./mongotrafficreplay "
+                         "-i trafficinput.txt --host localhost:27017 --speed 2 \n\n"
+                      << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        // User must specify a --input param and it must point to a valid file
+        if (!vm.count("input")) {
+            std::cerr << "Error: An input file must be specified" << std::endl;
+            return EXIT_FAILURE;
+        }
+        inputFile = vm["input"].as<std::string>();
+        if (!boost::filesystem::exists(inputFile.c_str())) {
+            std::cerr << "Error: Specified file does not exist (" << inputFile << ")" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        auto swTarget = HostAndPort::parse(vm["host"].as<std::string>());
+        if (!swTarget.isOK()) {
+            std::cerr << "Error: " << swTarget.getStatus() << std::endl;
+            return EXIT_FAILURE;
+        }
+        options.target = swTarget.getValue();
+        options.speed = vm["speed"].as<double>();
+        options.numConnections = vm["connections"].as<int>();
+    } catch (const boost::program_options::error& ex) {
+        std::cerr << ex.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    setGlobalServiceContext(ServiceContext::make());
+    getGlobalServiceContext()->setTransportLayer(
+        transport::TransportLayerManager::makeAndStartDefaultEgressTransportLayer());
+
+    try {
+        auto summary = replayTrafficRecording(inputFile, options);
+        std::cout << tojson(summary, JsonStringFormat::Strict, true) << std::endl;
+    } catch (const DBException& ex) {
+        std::cerr << "Error replaying the traffic recording: " << ex.toStatus() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+}  // namespace
+}  // namespace mongo
+
+#if defined(_WIN32)
+// In Windows, wmain() is an alternate entry point for main(), and receives the same parameters
+// as main() but encoded in Windows Unicode (UTF-16); "wide" 16-bit wchar_t characters.  The
+// WindowsCommandLine object converts these wide character strings to a UTF-8 coded equivalent
+// and makes them available through the argv() and envp() members.  This enables
+// trafficReplayMain() to process UTF-8 encoded arguments and environment variables without
+// regard to platform.
+int wmain(int argc, wchar_t* argvW[], wchar_t* envpW[]) {
+    mongo::WindowsCommandLine wcl(argc, argvW, envpW);
+    int exitCode = mongo::trafficReplayMain(argc, wcl.argv(), wcl.envp());
+    mongo::quickExit(exitCode);
+}
+#else
+int main(int argc, char* argv[], char** envp) {
+    int exitCode = mongo::trafficReplayMain(argc, argv, envp);
+    mongo::quickExit(exitCode);
+}
+#endif
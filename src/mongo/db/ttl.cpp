@@ -33,6 +33,9 @@
 
 #include "mongo/db/ttl.h"
 
+#include <algorithm>
+#include <map>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -54,10 +57,13 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/ttl_collection_cache.h"
 #include "mongo/db/ttl_gen.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -70,6 +76,39 @@ ServerStatusMetricField<Counter64> ttlPassesDisplay("ttl.passes", &ttlPasses);
 ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocuments",
                                                               &ttlDeletedDocuments);
 
+namespace {
+
+/**
+ * The work done by TTL passes on one collection. The documents deleted by the last pass are those
+ * that expired since the pass before, so they show how fast the collection builds up a backlog.
+ */
+struct TTLCollectionStats {
+    long long deletedDocuments = 0;
+    long long lastPassDeletedDocuments = 0;
+    long long lastPassMillis = 0;
+};
+
+stdx::mutex ttlCollectionStatsMutex;
+std::map<std::string, TTLCollectionStats> ttlCollectionStats;
+
+class TTLCollectionStatsSSM : public ServerStatusMetric {
+public:
+    TTLCollectionStatsSSM() : ServerStatusMetric("ttl.collections") {}
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        BSONObjBuilder collectionsBob(b.subobjStart(_leafName));
+        stdx::lock_guard<stdx::mutex> lk(ttlCollectionStatsMutex);
+        for (const auto& entry : ttlCollectionStats) {
+            BSONObjBuilder collectionBob(collectionsBob.subobjStart(entry.first));
+            collectionBob.appendNumber("deletedDocuments", entry.second.deletedDocuments);
+            collectionBob.appendNumber("lastPassDeletedDocuments",
+                                       entry.second.lastPassDeletedDocuments);
+            collectionBob.appendNumber("lastPassMillis", entry.second.lastPassMillis);
+        }
+    }
+} ttlCollectionStatsSSM;
+
+}  // namespace
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor(ServiceContext* serviceContext) : _serviceContext(serviceContext) {}
@@ -133,10 +172,23 @@ private:
 
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
         std::vector<std::string> ttlCollections = ttlCollectionCache.getCollections();
-        std::vector<BSONObj> ttlIndexes;
+        std::vector<std::vector<BSONObj>> ttlIndexesByCollection;
 
         ttlPasses.increment();
 
+        {
+            // Forget about the collections which no longer have TTL indexes.
+            stdx::lock_guard<stdx::mutex> lk(ttlCollectionStatsMutex);
+            for (auto it = ttlCollectionStats.begin(); it != ttlCollectionStats.end();) {
+                if (std::find(ttlCollections.begin(), ttlCollections.end(), it->first) ==
+                    ttlCollections.end()) {
+                    it = ttlCollectionStats.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
         // Get all TTL indexes from every collection.
         for (const std::string& collectionNS : ttlCollections) {
             NamespaceString collectionNSS(collectionNS);
@@ -150,49 +202,111 @@ private:
             CollectionCatalogEntry* collEntry = coll->getCatalogEntry();
             std::vector<std::string> indexNames;
             collEntry->getAllIndexes(&opCtx, &indexNames);
+            std::vector<BSONObj> ttlIndexes;
             for (const std::string& name : indexNames) {
                 BSONObj spec = collEntry->getIndexSpec(&opCtx, name);
                 if (spec.hasField(secondsExpireField)) {
                     ttlIndexes.push_back(spec.getOwned());
                 }
             }
+            if (!ttlIndexes.empty()) {
+                ttlIndexesByCollection.push_back(std::move(ttlIndexes));
+            }
         }
 
+        const size_t maxParallelCollections = ttlMonitorMaxParallelCollections.load();
+        if (maxParallelCollections == 1 || ttlIndexesByCollection.size() <= 1) {
+            for (const auto& ttlIndexes : ttlIndexesByCollection) {
+                if (!doTTLForCollection(&opCtx, ttlIndexes)) {
+                    return;
+                }
+            }
+            return;
+        }
+
+        // Collections are independent of each other, so a collection with a large backlog need not
+        // hold up the other collections. Each collection's indexes are still processed in turn.
+        ThreadPool::Options options;
+        options.poolName = "TTLMonitor";
+        options.threadNamePrefix = "TTLMonitor-";
+        options.minThreads = 0;
+        options.maxThreads = std::min(maxParallelCollections, ttlIndexesByCollection.size());
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+            AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+
+            stdx::lock_guard<Client> lk(cc());
+            cc().setSystemOperationKillable(lk);
+        };
+        ThreadPool pool(options);
+        pool.startup();
+        for (const auto& ttlIndexes : ttlIndexesByCollection) {
+            pool.schedule([this, &ttlIndexes](Status status) {
+                if (!status.isOK()) {
+                    return;
+                }
+                const ServiceContext::UniqueOperationContext workerOpCtx =
+                    cc().makeOperationContext();
+                doTTLForCollection(workerOpCtx.get(), ttlIndexes);
+            });
+        }
+        pool.shutdown();
+        pool.join();
+    }
+
+    /**
+     * Removes the expired documents of one collection using each of its TTL indexes in turn, and
+     * records the work done in the collection's TTL metrics. Returns false if the pass was
+     * interrupted.
+     */
+    bool doTTLForCollection(OperationContext* opCtx, const std::vector<BSONObj>& ttlIndexes) {
+        Timer timer;
+        long long numDeleted = 0;
+        bool interrupted = false;
         for (const BSONObj& idx : ttlIndexes) {
             try {
-                doTTLForIndex(&opCtx, idx);
+                numDeleted += doTTLForIndex(opCtx, idx);
             } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
                 warning() << "TTLMonitor was interrupted, waiting " << ttlMonitorSleepSecs.load()
                           << " seconds before doing another pass";
-                return;
+                interrupted = true;
+                break;
             } catch (const DBException& dbex) {
                 error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
                 // Continue on to the next index.
                 continue;
             }
         }
+
+        stdx::lock_guard<stdx::mutex> lk(ttlCollectionStatsMutex);
+        TTLCollectionStats& stats = ttlCollectionStats[ttlIndexes.front()["ns"].String()];
+        stats.deletedDocuments += numDeleted;
+        stats.lastPassDeletedDocuments = numDeleted;
+        stats.lastPassMillis = timer.millis();
+        return !interrupted;
     }
 
     /**
      * Remove documents from the collection using the specified TTL index after a sufficient amount
-     * of time has passed according to its expiry specification.
+     * of time has passed according to its expiry specification. Returns the number of documents
+     * deleted.
      */
-    void doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
+    long long doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
         const NamespaceString collectionNSS(idx["ns"].String());
         if (collectionNSS.isDropPendingNamespace()) {
-            return;
+            return 0;
         }
         if (!userAllowedWriteNS(collectionNSS).isOK()) {
             error() << "namespace '" << collectionNSS
                     << "' doesn't allow deletes, skipping ttl job for: " << idx;
-            return;
+            return 0;
         }
 
         const BSONObj key = idx["key"].Obj();
         const StringData name = idx["name"].valueStringData();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
-            return;
+            return 0;
         }
 
         LOG(1) << "ns: " << collectionNSS << " key: " << key << " name: " << name;
@@ -207,18 +321,18 @@ private:
         Collection* collection = autoGetCollection.getCollection();
         if (!collection) {
             // Collection was dropped.
-            return;
+            return 0;
         }
 
         if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, collectionNSS)) {
-            return;
+            return 0;
         }
 
         const IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
         if (!desc) {
             LOG(1) << "index not found (index build in progress? index dropped?), skipping "
                    << "ttl job for: " << idx;
-            return;
+            return 0;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition changed
@@ -227,7 +341,7 @@ private:
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
-            return;
+            return 0;
         }
 
         BSONElement secondsExpireElt = idx[secondsExpireField];
@@ -235,7 +349,7 @@ private:
             error() << "ttl indexes require the " << secondsExpireField << " field to be "
                     << "numeric but received a type of " << typeName(secondsExpireElt.type())
                     << ", skipping ttl job for: " << idx;
-            return;
+            return 0;
         }
 
         const Date_t kDawnOfTime =
@@ -279,12 +393,13 @@ private:
         if (!result.isOK()) {
             error() << "ttl query execution for index " << idx
                     << " failed with status: " << redact(result);
-            return;
+            return 0;
         }
 
         const long long numDeleted = DeleteStage::getNumDeleted(*exec);
         ttlDeletedDocuments.increment(numDeleted);
         LOG(1) << "deleted: " << numDeleted;
+        return numDeleted;
     }
 
     ServiceContext* _serviceContext;
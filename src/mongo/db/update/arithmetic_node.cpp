@@ -64,6 +64,19 @@ Status ArithmeticNode::init(BSONElement modExpr,
     return Status::OK();
 }
 
+SafeNum ArithmeticNode::computeValue(SafeNum originalValue) const {
+    SafeNum valueToSet = _val;
+    switch (_op) {
+        case ArithmeticOp::kAdd:
+            valueToSet += originalValue;
+            break;
+        case ArithmeticOp::kMultiply:
+            valueToSet *= originalValue;
+            break;
+    }
+    return valueToSet;
+}
+
 ModifierNode::ModifyResult ArithmeticNode::updateExistingElement(
     mutablebson::Element* element, std::shared_ptr<FieldRef> elementPath) const {
     if (!element->isNumeric()) {
@@ -79,15 +92,7 @@ ModifierNode::ModifyResult ArithmeticNode::updateExistingElement(
     }
 
     SafeNum originalValue = element->getValueSafeNum();
-    SafeNum valueToSet = _val;
-    switch (_op) {
-        case ArithmeticOp::kAdd:
-            valueToSet += originalValue;
-            break;
-        case ArithmeticOp::kMultiply:
-            valueToSet *= originalValue;
-            break;
-    }
+    SafeNum valueToSet = computeValue(originalValue);
 
     // If the updated value is identical to the original value, treat this as a no-op. Caveat:
     // if the found element is in a deserialized state, we can't do that.
@@ -33,6 +33,7 @@
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/update/modifier_node.h"
+#include "mongo/util/safe_num.h"
 
 namespace mongo {
 
@@ -57,6 +58,12 @@ public:
         visitor->visit(this);
     }
 
+    /**
+     * Returns the result of applying this operation to the numeric value 'originalValue'. The
+     * result is not valid if the operation overflows.
+     */
+    SafeNum computeValue(SafeNum originalValue) const;
+
 protected:
     ModifyResult updateExistingElement(mutablebson::Element* element,
                                        std::shared_ptr<FieldRef> elementPath) const final;
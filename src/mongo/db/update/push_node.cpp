@@ -298,6 +298,7 @@ ModifierNode::ModifyResult PushNode::performPush(mutablebson::Element* element,
                                 << "}");
     }
 
+    const auto originalSize = static_cast<long long>(countChildren(*element));
     auto result = insertElementsWithPosition(element, _position, _valuesToPush);
 
     if (_sort) {
@@ -309,10 +310,15 @@ ModifierNode::ModifyResult PushNode::performPush(mutablebson::Element* element,
         const auto sliceAbs = safeApproximateAbs(_slice.get());
 
         while (static_cast<long long>(countChildren(*element)) > sliceAbs) {
-            result = ModifyResult::kNormalUpdate;
             if (_slice.get() >= 0) {
+                // Trimming the back of an array which fit within the slice before the push only
+                // removes appended values, so the update is still an append of the others.
+                if (originalSize > sliceAbs) {
+                    result = ModifyResult::kNormalUpdate;
+                }
                 invariant(element->popBack());
             } else {
+                result = ModifyResult::kNormalUpdate;
                 // A negative value in '_slice' trims the array down to abs(_slice) but removes
                 // entries from the front of the array instead of the back.
                 invariant(element->popFront());
@@ -340,13 +346,13 @@ void PushNode::logUpdate(LogBuilder* logBuilder,
     } else if (modifyResult == ModifyResult::kArrayAppendUpdate) {
         // This update only modified the array by appending entries to the end. Rather than writing
         // out the entire contents of the array, we create oplog entries for the newly appended
-        // elements.
-        auto numAppended = _valuesToPush.size();
+        // elements. A positive $slice may have trimmed some of them, in which case we log the
+        // elements in the positions they could occupy, which may include some that were already
+        // in the array.
         auto arraySize = countChildren(element);
-
-        invariant(arraySize > numAppended);
-        auto position = arraySize - numAppended;
-        for (const auto& valueToLog : _valuesToPush) {
+        auto position = arraySize - std::min(_valuesToPush.size(), arraySize);
+        for (auto valueToLog = getNthChild(element, position); valueToLog.ok();
+             valueToLog = valueToLog.rightSibling()) {
             std::string pathToArrayElement(str::stream() << pathTaken << "." << position);
             uassertStatusOK(logBuilder->addToSetsWithNewFieldName(pathToArrayElement, valueToLog));
 
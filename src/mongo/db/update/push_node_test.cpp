@@ -515,7 +515,37 @@ TEST_F(PushNodeTest, ApplyToArrayWithSlice) {
     ASSERT_TRUE(result.indexesAffected);
     ASSERT_EQUALS(fromjson("{a: [3]}"), doc);
     ASSERT_FALSE(doc.isInPlaceModeEnabled());
-    ASSERT_EQUALS(fromjson("{$set: {a: [3]}}"), getLogDoc());
+    ASSERT_EQUALS(fromjson("{$set: {'a.0': 3}}"), getLogDoc());
+    ASSERT_EQUALS("{a}", getModifiedPaths());
+}
+
+TEST_F(PushNodeTest, ApplyToArrayWithPositiveSliceLogsAppendedElements) {
+    auto update = fromjson("{$push: {a: {$each: [4, 5], $slice: 4}}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    PushNode node;
+    ASSERT_OK(node.init(update["$push"]["a"], expCtx));
+
+    mutablebson::Document doc(fromjson("{a: [1, 2, 3]}"));
+    setPathTaken("a");
+    auto result = node.apply(getApplyParams(doc.root()["a"]), getUpdateNodeApplyParams());
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [1, 2, 3, 4]}"), doc);
+    ASSERT_EQUALS(fromjson("{$set: {'a.2': 3, 'a.3': 4}}"), getLogDoc());
+    ASSERT_EQUALS("{a}", getModifiedPaths());
+}
+
+TEST_F(PushNodeTest, ApplyToArrayLargerThanPositiveSliceLogsWholeArray) {
+    auto update = fromjson("{$push: {a: {$each: [4], $slice: 2}}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    PushNode node;
+    ASSERT_OK(node.init(update["$push"]["a"], expCtx));
+
+    mutablebson::Document doc(fromjson("{a: [1, 2, 3]}"));
+    setPathTaken("a");
+    auto result = node.apply(getApplyParams(doc.root()["a"]), getUpdateNodeApplyParams());
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [1, 2]}"), doc);
+    ASSERT_EQUALS(fromjson("{$set: {a: [1, 2]}}"), getLogDoc());
     ASSERT_EQUALS("{a}", getModifiedPaths());
 }
 
@@ -31,6 +31,8 @@
 
 #include "mongo/db/update/update_array_node.h"
 
+#include "mongo/db/update/arithmetic_node.h"
+
 namespace mongo {
 
 // static
@@ -64,6 +66,10 @@ UpdateExecutor::ApplyResult UpdateArrayNode::apply(
                           << applyParams.element.toString(),
             applyParams.element.getType() == BSONType::Array);
 
+    if (auto fastPathResult = _applyArithmeticToNumericArray(applyParams, updateNodeApplyParams)) {
+        return *fastPathResult;
+    }
+
     // Construct a map from the array index to the set of updates that should be applied to the
     // array element at that index. We do not apply the updates yet because we need to know how many
     // array elements will be updated in order to know whether to pass 'logBuilder' on to the
@@ -102,10 +108,9 @@ UpdateExecutor::ApplyResult UpdateArrayNode::apply(
     const bool childrenShouldLogThemselves = matchingElements.size() <= 1;
 
     // Keep track of which array elements were actually modified (non-noop updates) for logging
-    // purposes. We only need to keep track of one element, since if more than one element is
-    // modified, we log the whole array.
-    boost::optional<mutablebson::Element> modifiedElement;
-    size_t nModified = 0;
+    // purposes.
+    std::vector<mutablebson::Element> modifiedElements;
+    size_t nElements = 0;
 
     // Update array elements.
     auto applyResult = ApplyResult::noopResult();
@@ -151,12 +156,12 @@ UpdateExecutor::ApplyResult UpdateArrayNode::apply(
                 applyResult.indexesAffected || childApplyResult.indexesAffected;
             applyResult.noop = applyResult.noop && childApplyResult.noop;
             if (!childApplyResult.noop) {
-                modifiedElement = childElement;
-                ++nModified;
+                modifiedElements.push_back(childElement);
             }
         }
 
         ++i;
+        ++nElements;
     }
 
     // If no elements match the array filter, report the path to the array itself as modified.
@@ -166,23 +171,139 @@ UpdateExecutor::ApplyResult UpdateArrayNode::apply(
 
     // If the child updates have not been logged, log the updated array elements.
     if (!childrenShouldLogThemselves && applyParams.logBuilder) {
-        if (nModified > 1) {
+        if (modifiedElements.size() > 1 && modifiedElements.size() == nElements) {
 
-            // Log the entire array.
+            // Log the entire array, since every one of its elements was modified.
             auto logElement = applyParams.logBuilder->getDocument().makeElementWithNewFieldName(
                 updateNodeApplyParams.pathTaken->dottedField(), applyParams.element);
             invariant(logElement.ok());
             uassertStatusOK(applyParams.logBuilder->addToSets(logElement));
-        } else if (nModified == 1) {
+        } else {
+
+            // Log each modified array element by its position, so that updating a few elements
+            // of a large array doesn't log the whole array.
+            for (auto&& modifiedElement : modifiedElements) {
+                FieldRef::FieldRefTempAppend tempAppend(*(updateNodeApplyParams.pathTaken),
+                                                        modifiedElement.getFieldName());
+                auto logElement =
+                    applyParams.logBuilder->getDocument().makeElementWithNewFieldName(
+                        updateNodeApplyParams.pathTaken->dottedField(), modifiedElement);
+                invariant(logElement.ok());
+                uassertStatusOK(applyParams.logBuilder->addToSets(logElement));
+            }
+        }
+    }
+
+    return applyResult;
+}
+
+boost::optional<UpdateExecutor::ApplyResult> UpdateArrayNode::_applyArithmeticToNumericArray(
+    ApplyParams applyParams, UpdateNodeApplyParams updateNodeApplyParams) const {
+    if (_children.size() != 1 || !applyParams.element.hasValue()) {
+        return boost::none;
+    }
+    const auto& identifier = _children.begin()->first;
+    auto arithmeticNode = dynamic_cast<const ArithmeticNode*>(_children.begin()->second.get());
+    if (!arithmeticNode) {
+        return boost::none;
+    }
+
+    // Leave any update to or below an immutable path to the element by element checks.
+    const auto& pathTaken = *updateNodeApplyParams.pathTaken;
+    for (auto&& immutablePath : applyParams.immutablePaths) {
+        if (pathTaken.commonPrefixSize(*immutablePath) ==
+            std::min(pathTaken.numParts(), immutablePath->numParts())) {
+            return boost::none;
+        }
+    }
+
+    const ExpressionWithPlaceholder* filter = nullptr;
+    if (!identifier.empty()) {
+        auto filterIt = _arrayFilters.find(identifier);
+        invariant(filterIt != _arrayFilters.end());
+        filter = filterIt->second.get();
+    }
+
+    const BSONObj array = applyParams.element.getValue().embeddedObject();
+    BSONObjBuilder newArrayBuilder(array.objsize());
+    std::vector<size_t> matchedPositions;
+    std::vector<size_t> modifiedPositions;
+    size_t nElements = 0;
+    for (auto&& arrayElement : array) {
+        if (filter && !filter->matchesBSONElement(arrayElement)) {
+            newArrayBuilder.append(arrayElement);
+        } else {
+            if (!arrayElement.isNumber()) {
+                return boost::none;
+            }
+            const SafeNum originalValue(arrayElement);
+            const SafeNum newValue = arithmeticNode->computeValue(originalValue);
+            if (!newValue.isValid()) {
+                return boost::none;
+            }
+            matchedPositions.push_back(nElements);
+            if (newValue.isIdentical(originalValue)) {
+                newArrayBuilder.append(arrayElement);
+            } else {
+                newValue.toBSON(arrayElement.fieldNameStringData(), &newArrayBuilder);
+                modifiedPositions.push_back(nElements);
+            }
+        }
+        ++nElements;
+    }
 
-            // Log the modified array element.
-            invariant(modifiedElement);
+    if (applyParams.modifiedPaths) {
+        if (matchedPositions.empty()) {
+            applyParams.modifiedPaths->keepShortest(pathTaken);
+        }
+        for (auto position : matchedPositions) {
             FieldRef::FieldRefTempAppend tempAppend(*(updateNodeApplyParams.pathTaken),
-                                                    modifiedElement->getFieldName());
+                                                    std::to_string(position));
+            applyParams.modifiedPaths->keepShortest(*updateNodeApplyParams.pathTaken);
+        }
+    }
+
+    if (modifiedPositions.empty()) {
+        return ApplyResult::noopResult();
+    }
+
+    const BSONObj newArray = newArrayBuilder.obj();
+    invariant(applyParams.element.setValueArray(newArray));
+
+    // The canonical index path of an array element does not depend on its position, so checking
+    // the first modified element covers all of them.
+    ApplyResult applyResult;
+    {
+        FieldRef::FieldRefTempAppend tempAppend(*(updateNodeApplyParams.pathTaken),
+                                                std::to_string(modifiedPositions.front()));
+        if (!applyParams.indexData ||
+            !applyParams.indexData->mightBeIndexed(*updateNodeApplyParams.pathTaken)) {
+            applyResult.indexesAffected = false;
+        }
+    }
+
+    if (applyParams.logBuilder) {
+        if (modifiedPositions.size() > 1 && modifiedPositions.size() == nElements) {
             auto logElement = applyParams.logBuilder->getDocument().makeElementWithNewFieldName(
-                updateNodeApplyParams.pathTaken->dottedField(), *modifiedElement);
+                pathTaken.dottedField(), applyParams.element);
             invariant(logElement.ok());
             uassertStatusOK(applyParams.logBuilder->addToSets(logElement));
+        } else {
+            auto modifiedPosition = modifiedPositions.begin();
+            size_t position = 0;
+            for (auto&& newElement : newArray) {
+                if (modifiedPosition == modifiedPositions.end()) {
+                    break;
+                }
+                if (position++ != *modifiedPosition) {
+                    continue;
+                }
+                ++modifiedPosition;
+                FieldRef::FieldRefTempAppend tempAppend(*(updateNodeApplyParams.pathTaken),
+                                                        newElement.fieldNameStringData());
+                uassertStatusOK(applyParams.logBuilder->addToSetsWithNewFieldName(
+                    updateNodeApplyParams.pathTaken->dottedField(), newElement));
+            }
         }
     }
 
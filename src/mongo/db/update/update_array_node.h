@@ -98,6 +98,19 @@ public:
     }
 
 private:
+    /**
+     * Applies an update whose only child is an $inc or $mul to the array elements it selects by
+     * computing the whole array in one pass over its serialized value, without expanding the
+     * array in the mutable document. Replacing the array value with one of the same size leaves
+     * the document eligible for an in-place update with a single damage event.
+     *
+     * Returns boost::none without modifying the document if the fast path does not apply, for
+     * example because a selected element is not numeric or because the result overflows, in which
+     * case the caller must apply the update element by element.
+     */
+    boost::optional<ApplyResult> _applyArithmeticToNumericArray(
+        ApplyParams applyParams, UpdateNodeApplyParams updateNodeApplyParams) const;
+
     const std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>>& _arrayFilters;
     std::map<std::string, clonable_ptr<UpdateNode>> _children;
 
@@ -32,6 +32,7 @@
 #include "mongo/db/update/update_array_node.h"
 
 #include "mongo/bson/mutable/algorithm.h"
+#include "mongo/bson/mutable/damage_vector.h"
 #include "mongo/bson/mutable/mutable_bson_test_utils.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
@@ -120,7 +121,7 @@ TEST_F(UpdateArrayNodeTest, UpdateIsAppliedToAllMatchingElements) {
     ASSERT_FALSE(result.noop);
     ASSERT_EQUALS(fromjson("{a: [2, 1, 2]}"), doc);
     ASSERT_TRUE(doc.isInPlaceModeEnabled());
-    ASSERT_EQUALS(fromjson("{$set: {a: [2, 1, 2]}}"), getLogDoc());
+    ASSERT_EQUALS(fromjson("{$set: {'a.0': 2, 'a.2': 2}}"), getLogDoc());
     ASSERT_EQUALS("{a.0, a.2}", getModifiedPaths());
 }
 
@@ -763,4 +764,100 @@ TEST_F(UpdateArrayNodeTest, ApplyArrayUpdateWithoutLogBuilderOrIndexData) {
 }
 
 }  // namespace
+TEST_F(UpdateArrayNodeTest, IncrementOfAllElementsOfNumericArrayIsASingleDamageEvent) {
+    auto update = fromjson("{$inc: {'a.$[]': 1}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    std::set<std::string> foundIdentifiers;
+    UpdateObjectNode root;
+    ASSERT_OK(UpdateObjectNode::parseAndMerge(&root,
+                                              modifiertable::ModifierType::MOD_INC,
+                                              update["$inc"]["a.$[]"],
+                                              expCtx,
+                                              arrayFilters,
+                                              foundIdentifiers));
+
+    mutablebson::Document doc(fromjson("{a: [0, 1, 2.5]}"));
+    addIndexedPath("a");
+    auto result = root.apply(getApplyParams(doc.root()), getUpdateNodeApplyParams());
+    ASSERT_TRUE(result.indexesAffected);
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [1, 2, 3.5]}"), doc);
+    ASSERT_TRUE(doc.isInPlaceModeEnabled());
+    ASSERT_EQUALS(fromjson("{$set: {a: [1, 2, 3.5]}}"), getLogDoc());
+    ASSERT_EQUALS("{a.0, a.1, a.2}", getModifiedPaths());
+
+    mutablebson::DamageVector damages;
+    const char* source = nullptr;
+    size_t size = 0;
+    ASSERT_TRUE(doc.getInPlaceUpdates(&damages, &source, &size));
+    ASSERT_EQUALS(1U, damages.size());
+}
+
+TEST_F(UpdateArrayNodeTest, MultiplyOfFilteredElementsOfNumericArrayLogsModifiedElements) {
+    auto update = fromjson("{$mul: {'a.$[i]': 2}}");
+    auto arrayFilter = fromjson("{i: {$gte: 1}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    auto parsedFilter = assertGet(MatchExpressionParser::parse(arrayFilter, expCtx));
+    arrayFilters["i"] = assertGet(ExpressionWithPlaceholder::make(std::move(parsedFilter)));
+    std::set<std::string> foundIdentifiers;
+    UpdateObjectNode root;
+    ASSERT_OK(UpdateObjectNode::parseAndMerge(&root,
+                                              modifiertable::ModifierType::MOD_MUL,
+                                              update["$mul"]["a.$[i]"],
+                                              expCtx,
+                                              arrayFilters,
+                                              foundIdentifiers));
+
+    mutablebson::Document doc(fromjson("{a: [0, 2, 0, 3]}"));
+    addIndexedPath("b");
+    auto result = root.apply(getApplyParams(doc.root()), getUpdateNodeApplyParams());
+    ASSERT_FALSE(result.indexesAffected);
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [0, 4, 0, 6]}"), doc);
+    ASSERT_TRUE(doc.isInPlaceModeEnabled());
+    ASSERT_EQUALS(fromjson("{$set: {'a.1': 4, 'a.3': 6}}"), getLogDoc());
+    ASSERT_EQUALS("{a.1, a.3}", getModifiedPaths());
+}
+
+TEST_F(UpdateArrayNodeTest, IncrementOfNumericArrayThatChangesTypeIsNotInPlace) {
+    auto update = fromjson("{$inc: {'a.$[]': 1}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    std::set<std::string> foundIdentifiers;
+    UpdateObjectNode root;
+    ASSERT_OK(UpdateObjectNode::parseAndMerge(&root,
+                                              modifiertable::ModifierType::MOD_INC,
+                                              update["$inc"]["a.$[]"],
+                                              expCtx,
+                                              arrayFilters,
+                                              foundIdentifiers));
+
+    mutablebson::Document doc(BSON("a" << BSON_ARRAY(std::numeric_limits<int>::max() << 1)));
+    auto result = root.apply(getApplyParams(doc.root()), getUpdateNodeApplyParams());
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(BSON("a" << BSON_ARRAY(std::numeric_limits<int>::max() + 1LL << 2)), doc);
+    ASSERT_FALSE(doc.isInPlaceModeEnabled());
+}
+
+TEST_F(UpdateArrayNodeTest, IncrementOfArrayWithNonNumericElementFails) {
+    auto update = fromjson("{$inc: {'a.$[]': 1}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    std::set<std::string> foundIdentifiers;
+    UpdateObjectNode root;
+    ASSERT_OK(UpdateObjectNode::parseAndMerge(&root,
+                                              modifiertable::ModifierType::MOD_INC,
+                                              update["$inc"]["a.$[]"],
+                                              expCtx,
+                                              arrayFilters,
+                                              foundIdentifiers));
+
+    mutablebson::Document doc(fromjson("{a: [0, 'foo', 2]}"));
+    ASSERT_THROWS_CODE(root.apply(getApplyParams(doc.root()), getUpdateNodeApplyParams()),
+                       AssertionException,
+                       ErrorCodes::TypeMismatch);
+}
+
 }  // namespace mongo
@@ -38,12 +38,14 @@
 #include "mongo/db/field_ref.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/update/log_builder.h"
 #include "mongo/db/update/modifier_table.h"
 #include "mongo/db/update/object_replace_executor.h"
 #include "mongo/db/update/path_support.h"
 #include "mongo/db/update/storage_validation.h"
+#include "mongo/db/update/update_shape_cache.h"
 #include "mongo/util/embedded_builder.h"
 #include "mongo/util/str.h"
 
@@ -195,8 +197,29 @@ void UpdateDriver::parse(
         uassertStatusOK(updateSemanticsFromElement(updateSemanticsElement));
     }
 
-    auto root = std::make_unique<UpdateObjectNode>();
-    _positional = parseUpdateExpression(updateExpr, root.get(), _expCtx, arrayFilters);
+    boost::optional<std::string> shapeKey;
+    if (internalUpdateShapeCacheMaxEntries.load() > 0 && arrayFilters.empty()) {
+        shapeKey = UpdateShapeCache::computeShapeKey(updateExpr);
+    }
+
+    std::unique_ptr<UpdateObjectNode> root;
+    if (shapeKey) {
+        root = UpdateShapeCache::get().lookup(*shapeKey, updateExpr, _expCtx, &_positional);
+    }
+
+    if (!root) {
+        root = std::make_unique<UpdateObjectNode>();
+        _positional = parseUpdateExpression(updateExpr, root.get(), _expCtx, arrayFilters);
+
+        if (shapeKey) {
+            // The cached tree is parsed from an owned copy of the update, so that its leaves don't
+            // refer to the memory of this request.
+            auto ownedExpr = updateExpr.getOwned();
+            auto cachedRoot = std::make_unique<UpdateObjectNode>();
+            parseUpdateExpression(ownedExpr, cachedRoot.get(), _expCtx, arrayFilters);
+            UpdateShapeCache::get().add(*shapeKey, ownedExpr, std::move(cachedRoot), _positional);
+        }
+    }
     _updateExecutor = std::make_unique<UpdateTreeExecutor>(std::move(root));
 }
 
@@ -384,6 +384,17 @@ void UpdateObjectNode::setChild(std::string field, std::unique_ptr<UpdateNode> c
     }
 }
 
+void UpdateObjectNode::replaceChild(const std::string& field, std::unique_ptr<UpdateNode> child) {
+    if (fieldchecker::isPositionalElement(field)) {
+        invariant(_positionalChild);
+        _positionalChild = std::move(child);
+    } else {
+        auto it = _children.find(field);
+        invariant(it != _children.end());
+        it->second = std::move(child);
+    }
+}
+
 BSONObj UpdateObjectNode::serialize() const {
     std::map<std::string, std::vector<std::pair<std::string, BSONObj>>> operatorOrientedUpdates;
 
@@ -101,6 +101,11 @@ public:
 
     void setChild(std::string field, std::unique_ptr<UpdateNode> child) final;
 
+    /**
+     * Replaces the existing child named 'field' with 'child'.
+     */
+    void replaceChild(const std::string& field, std::unique_ptr<UpdateNode> child);
+
     /**
      * Gather all update operators in the subtree rooted from this into a BSONObj in the format of
      * the update command's update parameter.
@@ -0,0 +1,187 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/update/update_shape_cache.h"
+
+#include "mongo/db/field_ref.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/update/field_checker.h"
+#include "mongo/db/update/log_builder.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+void appendKeyPart(StringData part, std::string* key) {
+    key->append(part.rawData(), part.size());
+    key->push_back('\0');
+}
+
+// Returns the path of the leaf node that the update operator 'type' builds for 'field'.
+StringData leafPath(modifiertable::ModifierType type, const BSONElement& field) {
+    return type == modifiertable::ModifierType::MOD_RENAME ? field.valueStringData()
+                                                            : field.fieldNameStringData();
+}
+
+}  // namespace
+
+// static
+UpdateShapeCache& UpdateShapeCache::get() {
+    static UpdateShapeCache cache(internalUpdateShapeCacheMaxEntries.load());
+    return cache;
+}
+
+// static
+boost::optional<std::string> UpdateShapeCache::computeShapeKey(const BSONObj& updateExpr) {
+    std::string key;
+    for (auto&& mod : updateExpr) {
+        appendKeyPart(mod.fieldNameStringData(), &key);
+        if (mod.fieldNameStringData() == LogBuilder::kUpdateSemanticsFieldName) {
+            continue;
+        }
+
+        // Malformed updates are left to the parser to report.
+        auto type = modifiertable::getType(mod.fieldName());
+        if (type == modifiertable::MOD_UNKNOWN || mod.type() != BSONType::Object ||
+            mod.embeddedObject().isEmpty()) {
+            return boost::none;
+        }
+
+        for (auto&& field : mod.Obj()) {
+            if (type == modifiertable::ModifierType::MOD_RENAME) {
+                if (field.type() != BSONType::String) {
+                    return boost::none;
+                }
+                // The destination of a $rename determines where its node goes in the tree.
+                appendKeyPart(field.fieldNameStringData(), &key);
+            }
+
+            auto path = leafPath(type, field);
+            if (fieldchecker::hasArrayFilter(FieldRef(path))) {
+                return boost::none;
+            }
+            appendKeyPart(path, &key);
+        }
+        key.push_back('\0');
+    }
+    return key;
+}
+
+UpdateShapeCache::UpdateShapeCache(size_t maxEntries) : _entries(maxEntries) {}
+
+std::unique_ptr<UpdateObjectNode> UpdateShapeCache::lookup(
+    const std::string& shapeKey,
+    const BSONObj& updateExpr,
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    bool* positional) const {
+    EntryHandle entry;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        EntryHandle* found;
+        if (!_entries.get(shapeKey, &found).isOK()) {
+            return nullptr;
+        }
+        entry = *found;
+    }
+
+    std::unique_ptr<UpdateObjectNode> root(
+        static_cast<UpdateObjectNode*>(entry->root->clone().release()));
+
+    // The shapes are equal, so the fields of 'updateExpr' map in order onto the cached leaves.
+    // Replace each leaf with one initialized from the new value. The ConflictPlaceholderNodes of
+    // $rename hold no value, so the cloned ones are kept.
+    auto leaf = entry->leaves.begin();
+    for (auto&& mod : updateExpr) {
+        if (mod.fieldNameStringData() == LogBuilder::kUpdateSemanticsFieldName) {
+            continue;
+        }
+        for (auto&& field : mod.Obj()) {
+            invariant(leaf != entry->leaves.end());
+            auto node = modifiertable::makeUpdateLeafNode(leaf->type);
+            invariant(node);
+            uassertStatusOK(node->init(field, expCtx));
+
+            auto parent = root.get();
+            for (size_t i = 0; i + 1 < leaf->path.size(); ++i) {
+                auto child = parent->getChild(leaf->path[i]);
+                invariant(child && child->type == UpdateNode::Type::Object);
+                parent = static_cast<UpdateObjectNode*>(child);
+            }
+            parent->replaceChild(leaf->path.back(), std::move(node));
+            ++leaf;
+        }
+    }
+    invariant(leaf == entry->leaves.end());
+
+    *positional = entry->positional;
+    return root;
+}
+
+void UpdateShapeCache::add(const std::string& shapeKey,
+                           const BSONObj& updateExpr,
+                           std::unique_ptr<UpdateObjectNode> root,
+                           bool positional) {
+    auto entry = std::make_shared<Entry>();
+    entry->updateExpr = updateExpr.getOwned();
+    entry->root = std::move(root);
+    entry->positional = positional;
+    for (auto&& mod : entry->updateExpr) {
+        if (mod.fieldNameStringData() == LogBuilder::kUpdateSemanticsFieldName) {
+            continue;
+        }
+        auto type = modifiertable::getType(mod.fieldName());
+        for (auto&& field : mod.Obj()) {
+            FieldRef path(leafPath(type, field));
+            Leaf leaf{type, {}};
+            for (size_t i = 0; i < path.numParts(); ++i) {
+                leaf.path.push_back(path.getPart(i).toString());
+            }
+            entry->leaves.push_back(std::move(leaf));
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _entries.add(shapeKey, new EntryHandle(std::move(entry)));
+}
+
+size_t UpdateShapeCache::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entries.size();
+}
+
+void UpdateShapeCache::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _entries.clear();
+}
+
+}  // namespace mongo
@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/db/update/modifier_table.h"
+#include "mongo/db/update/update_object_node.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class ExpressionContext;
+
+/**
+ * A process-wide cache of parsed operator-style update expressions, keyed by their shape: the
+ * update operators and the field paths they modify, in order, but not the values they apply. An
+ * update whose shape is cached clones the cached UpdateObjectNode tree and only re-initializes
+ * its leaves with the new values, instead of parsing every path and building the tree again.
+ *
+ * The cache holds at most 'internalUpdateShapeCacheMaxEntries' shapes, evicting the least recently
+ * used. This class is thread-safe.
+ */
+class UpdateShapeCache {
+    UpdateShapeCache(const UpdateShapeCache&) = delete;
+    UpdateShapeCache& operator=(const UpdateShapeCache&) = delete;
+
+public:
+    /**
+     * Returns the cache shared by every UpdateDriver of this process.
+     */
+    static UpdateShapeCache& get();
+
+    /**
+     * Returns the shape of 'updateExpr', or boost::none if it can't be cached. Updates that are
+     * malformed, or whose paths have array filter identifiers, are never cached.
+     */
+    static boost::optional<std::string> computeShapeKey(const BSONObj& updateExpr);
+
+    explicit UpdateShapeCache(size_t maxEntries);
+
+    /**
+     * Returns a tree for 'updateExpr', whose shape is 'shapeKey', or nullptr if the shape isn't
+     * cached. Sets '*positional' to whether the update is positional. Throws if a value of
+     * 'updateExpr' is not valid for its update operator.
+     */
+    std::unique_ptr<UpdateObjectNode> lookup(const std::string& shapeKey,
+                                             const BSONObj& updateExpr,
+                                             const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                             bool* positional) const;
+
+    /**
+     * Caches 'root', the tree parsed from 'updateExpr', under 'shapeKey'.
+     */
+    void add(const std::string& shapeKey,
+             const BSONObj& updateExpr,
+             std::unique_ptr<UpdateObjectNode> root,
+             bool positional);
+
+    size_t size() const;
+
+    void clear();
+
+private:
+    // The leaf of the tree that is built from one field of the update expression.
+    struct Leaf {
+        modifiertable::ModifierType type;
+
+        // The path of the leaf in the tree. For $rename, this is the path of the RenameNode.
+        std::vector<std::string> path;
+    };
+
+    struct Entry {
+        // The update expression which the leaves of 'root' were initialized with.
+        BSONObj updateExpr;
+        std::unique_ptr<const UpdateObjectNode> root;
+        bool positional;
+
+        // One for each field of each update operator, in the order of 'updateExpr'.
+        std::vector<Leaf> leaves;
+    };
+
+    using EntryHandle = std::shared_ptr<const Entry>;
+
+    mutable stdx::mutex _mutex;
+    LRUKeyValue<std::string, EntryHandle> _entries;
+};
+
+}  // namespace mongo
@@ -0,0 +1,168 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/update/update_shape_cache.h"
+
+#include "mongo/bson/mutable/mutable_bson_test_utils.h"
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/update/update_driver.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+using ArrayFilters = std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>>;
+
+/**
+ * Parses 'updateSpec' with a new UpdateDriver and applies it to 'doc'.
+ */
+void applyUpdate(BSONObj updateSpec, mutablebson::Document* doc, StringData matchedField = "") {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver driver(expCtx);
+    ArrayFilters arrayFilters;
+    driver.parse(updateSpec, arrayFilters);
+
+    const bool validateForStorage = true;
+    const FieldRefSet emptyImmutablePaths;
+    const bool isInsert = false;
+    ASSERT_OK(driver.update(matchedField, doc, validateForStorage, emptyImmutablePaths, isInsert));
+}
+
+TEST(UpdateShapeCacheTest, ShapeIgnoresValues) {
+    ASSERT_EQ(*UpdateShapeCache::computeShapeKey(fromjson("{$set: {a: 1, 'b.c': 'x'}}")),
+              *UpdateShapeCache::computeShapeKey(fromjson("{$set: {a: [2], 'b.c': {d: 1}}}")));
+}
+
+TEST(UpdateShapeCacheTest, ShapeDependsOnOperatorsAndPaths) {
+    auto key = *UpdateShapeCache::computeShapeKey(fromjson("{$set: {a: 1}, $inc: {b: 1}}"));
+    ASSERT_NE(key, *UpdateShapeCache::computeShapeKey(fromjson("{$set: {a: 1}, $inc: {c: 1}}")));
+    ASSERT_NE(key, *UpdateShapeCache::computeShapeKey(fromjson("{$set: {a: 1}, $mul: {b: 1}}")));
+    ASSERT_NE(key, *UpdateShapeCache::computeShapeKey(fromjson("{$inc: {b: 1}, $set: {a: 1}}")));
+    ASSERT_NE(key, *UpdateShapeCache::computeShapeKey(fromjson("{$set: {a: 1, b: 1}}")));
+}
+
+TEST(UpdateShapeCacheTest, ShapeOfRenameDependsOnDestination) {
+    ASSERT_NE(*UpdateShapeCache::computeShapeKey(fromjson("{$rename: {a: 'b'}}")),
+              *UpdateShapeCache::computeShapeKey(fromjson("{$rename: {a: 'c'}}")));
+}
+
+TEST(UpdateShapeCacheTest, UncacheableUpdatesHaveNoShape) {
+    ASSERT_FALSE(UpdateShapeCache::computeShapeKey(fromjson("{$set: {'a.$[i]': 1}}")));
+    ASSERT_FALSE(UpdateShapeCache::computeShapeKey(fromjson("{$rename: {a: 'b.$[]'}}")));
+    ASSERT_FALSE(UpdateShapeCache::computeShapeKey(fromjson("{$rename: {a: 1}}")));
+    ASSERT_FALSE(UpdateShapeCache::computeShapeKey(fromjson("{$set: 1}")));
+    ASSERT_FALSE(UpdateShapeCache::computeShapeKey(fromjson("{$set: {}}")));
+    ASSERT_FALSE(UpdateShapeCache::computeShapeKey(fromjson("{$foo: {a: 1}}")));
+}
+
+TEST(UpdateShapeCacheTest, EvictsLeastRecentlyUsedShape) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateShapeCache cache(1);
+    ArrayFilters arrayFilters;
+    for (auto&& spec : {fromjson("{$set: {a: 1}}"), fromjson("{$set: {b: 1}}")}) {
+        auto root = std::make_unique<UpdateObjectNode>();
+        for (auto&& field : spec["$set"].Obj()) {
+            std::set<std::string> foundIdentifiers;
+            ASSERT_OK(UpdateObjectNode::parseAndMerge(root.get(),
+                                                      modifiertable::ModifierType::MOD_SET,
+                                                      field,
+                                                      expCtx,
+                                                      arrayFilters,
+                                                      foundIdentifiers));
+        }
+        cache.add(*UpdateShapeCache::computeShapeKey(spec), spec, std::move(root), false);
+    }
+    ASSERT_EQ(1U, cache.size());
+
+    bool positional = true;
+    auto spec = fromjson("{$set: {a: 2}}");
+    ASSERT_FALSE(cache.lookup(*UpdateShapeCache::computeShapeKey(spec), spec, expCtx, &positional));
+    spec = fromjson("{$set: {b: 2}}");
+    ASSERT(cache.lookup(*UpdateShapeCache::computeShapeKey(spec), spec, expCtx, &positional));
+    ASSERT_FALSE(positional);
+}
+
+class UpdateShapeCacheDriverTest : public unittest::Test {
+protected:
+    void setUp() final {
+        _oldMaxEntries = internalUpdateShapeCacheMaxEntries.load();
+        internalUpdateShapeCacheMaxEntries.store(10);
+        UpdateShapeCache::get().clear();
+    }
+
+    void tearDown() final {
+        UpdateShapeCache::get().clear();
+        internalUpdateShapeCacheMaxEntries.store(_oldMaxEntries);
+    }
+
+private:
+    int _oldMaxEntries;
+};
+
+TEST_F(UpdateShapeCacheDriverTest, CachedShapeAppliesNewValues) {
+    mutablebson::Document doc(fromjson("{n: 1, r: 'x'}"));
+    applyUpdate(fromjson("{$set: {a: 1, 'b.c': 'x'}, $inc: {n: 1}, $rename: {r: 's'}}"), &doc);
+    ASSERT_EQ(1U, UpdateShapeCache::get().size());
+    ASSERT_EQUALS(fromjson("{n: 2, a: 1, b: {c: 'x'}, s: 'x'}"), doc);
+
+    doc.reset(fromjson("{n: 1, r: 'y'}"));
+    applyUpdate(fromjson("{$set: {a: [2], 'b.c': {d: 1}}, $inc: {n: 5}, $rename: {r: 's'}}"),
+                &doc);
+    ASSERT_EQ(1U, UpdateShapeCache::get().size());
+    ASSERT_EQUALS(fromjson("{n: 6, a: [2], b: {c: {d: 1}}, s: 'y'}"), doc);
+}
+
+TEST_F(UpdateShapeCacheDriverTest, CachedPositionalShapeAppliesNewValues) {
+    mutablebson::Document doc(fromjson("{a: [0, 0]}"));
+    applyUpdate(fromjson("{$set: {'a.$': 1}}"), &doc, "0");
+    ASSERT_EQUALS(fromjson("{a: [1, 0]}"), doc);
+
+    applyUpdate(fromjson("{$set: {'a.$': 2}}"), &doc, "1");
+    ASSERT_EQ(1U, UpdateShapeCache::get().size());
+    ASSERT_EQUALS(fromjson("{a: [1, 2]}"), doc);
+}
+
+TEST_F(UpdateShapeCacheDriverTest, CachedShapeValidatesNewValues) {
+    mutablebson::Document doc(fromjson("{n: 1}"));
+    applyUpdate(fromjson("{$inc: {n: 1}}"), &doc);
+    ASSERT_EQ(1U, UpdateShapeCache::get().size());
+
+    ASSERT_THROWS_CODE(applyUpdate(fromjson("{$inc: {n: 'a'}}"), &doc),
+                       AssertionException,
+                       ErrorCodes::TypeMismatch);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -371,6 +371,31 @@ private:
     static const int kDocsPerWorker = 100;
 };
 
+/**
+ * Test that a writer which may not create the database of its collection does not bring back a
+ * database which doesn't exist, while another one does.
+ */
+class DeferredWriterTestNoDatabase : public DeferredWriterTestBase {
+public:
+    void run(void) {
+        const NamespaceString nss("deferred_writer_no_db", "coll");
+        _client.dropDatabase(nss.db().toString());
+        {
+            RaiiWrapper gw(std::make_unique<DeferredWriter>(
+                nss, CollectionOptions(), 200'000, false /* mayCreateDatabase */));
+            ASSERT(gw.get()->insertDocument(getObj()));
+        }
+        ASSERT_FALSE(AutoGetDb(_opCtx.get(), nss.db(), MODE_IS).getDb());
+
+        {
+            RaiiWrapper gw(std::make_unique<DeferredWriter>(nss, CollectionOptions(), 200'000));
+            ASSERT(gw.get()->insertDocument(getObj()));
+        }
+        ASSERT_EQ(1U, _client.count(nss.ns()));
+        _client.dropDatabase(nss.db().toString());
+    }
+};
+
 class DeferredWriterTests : public Suite {
 public:
     DeferredWriterTests() : Suite("deferred_writer_tests") {}
@@ -382,6 +407,7 @@ public:
         add<DeferredWriterTestNoDeadlock>();
         add<DeferredWriterTestCap>();
         add<DeferredWriterTestAsync>();
+        add<DeferredWriterTestNoDatabase>();
     }
 } deferredWriterTests;
 }
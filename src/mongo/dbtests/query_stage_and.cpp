@@ -434,6 +434,63 @@ public:
     }
 };
 
+// The same AND as above, intersecting only record ids. It does not buffer the large keys of the
+// first child, and so stays under the limit.
+class QueryStageAndHashRecordIdsOnlyFirstChildLargeKeys : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, nss());
+            wuow.commit();
+        }
+
+        std::string big(512, 'a');
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << i << "big" << big));
+        }
+
+        addIndex(BSON("foo" << 1 << "big" << 1));
+        addIndex(BSON("bar" << 1));
+
+        WorkingSet ws;
+        auto ah = std::make_unique<AndHashStage>(&_opCtx, &ws, 20 * big.size());
+        ah->setRecordIdsOnly();
+
+        // Foo <= 20
+        auto params = makeIndexScanParams(&_opCtx, getIndex(BSON("foo" << 1 << "big" << 1), coll));
+        params.bounds.startKey = BSON("" << 20 << "" << big);
+        params.direction = -1;
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, nullptr));
+
+        // Bar >= 10
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("bar" << 1), coll));
+        params.bounds.startKey = BSON("" << 10);
+        params.direction = -1;
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, nullptr));
+
+        // Each result holds only the key of the last child.
+        int count = 0;
+        while (!ah->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState status = ah->work(&id);
+            ASSERT_NOT_EQUALS(PlanStage::FAILURE, status);
+            if (PlanStage::ADVANCED != status) {
+                continue;
+            }
+            WorkingSetMember* member = ws.get(id);
+            ASSERT_EQUALS(1U, member->keyData.size());
+            ASSERT_BSONOBJ_EQ(BSON("bar" << 1), member->keyData[0].indexKeyPattern);
+            ++count;
+        }
+        ASSERT_EQUALS(11, count);
+        ASSERT_LT(ah->getMemUsage(), 20 * big.size());
+    }
+};
+
 // An AND with three children.
 // Add large keys (512 bytes) to index of last child to verify that
 // keys in last child are not buffered
@@ -1343,6 +1400,7 @@ public:
         add<QueryStageAndHashDeleteDuringYield>();
         add<QueryStageAndHashTwoLeaf>();
         add<QueryStageAndHashTwoLeafFirstChildLargeKeys>();
+        add<QueryStageAndHashRecordIdsOnlyFirstChildLargeKeys>();
         add<QueryStageAndHashTwoLeafLastChildLargeKeys>();
         add<QueryStageAndHashThreeLeaf>();
         add<QueryStageAndHashThreeLeafMiddleChildLargeKeys>();
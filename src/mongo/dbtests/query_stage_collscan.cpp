@@ -34,6 +34,7 @@
 #include "mongo/platform/basic.h"
 
 #include <memory>
+#include <set>
 
 #include "mongo/client/dbclient_cursor.h"
 #include "mongo/db/catalog/collection.h"
@@ -42,14 +43,18 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/parallel_collection_scan.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/util/fail_point_service.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageCollectionScan {
 
@@ -391,6 +396,136 @@ public:
     }
 };
 
+//
+// Get every matching object, in order, when the scan is driven in batches.
+//
+
+class QueryStageCollscanWorkBatchWithMatch : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        auto collection = ctx.getCollection();
+
+        CollectionScanParams params;
+        params.direction = CollectionScanParams::FORWARD;
+        params.tailable = false;
+
+        const CollatorInterface* collator = nullptr;
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, collator));
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(BSON("foo" << BSON("$gte" << 25)), expCtx);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        CollectionScan scan(&_opCtx, collection, params, &ws, filterExpr.get());
+
+        int count = 0;
+        vector<WorkingSetID> batch;
+        while (!scan.isEOF()) {
+            batch.clear();
+            PlanStage::StageState state = scan.workBatch(7, &batch);
+            ASSERT_NOT_EQUALS(PlanStage::FAILURE, state);
+            if (PlanStage::ADVANCED != state) {
+                ASSERT(batch.empty());
+                continue;
+            }
+
+            ASSERT_LTE(batch.size(), 7U);
+            for (auto id : batch) {
+                WorkingSetMember* member = ws.get(id);
+                ASSERT(member->hasObj());
+                ASSERT_EQUALS(25 + count, member->obj.value()["foo"].numberInt());
+                ws.free(id);
+                ++count;
+            }
+        }
+
+        ASSERT_EQUALS(numObj() - 25, count);
+    }
+};
+
+class QueryStageParallelCollscanWithMatch : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        auto collection = ctx.getCollection();
+
+        const CollatorInterface* collator = nullptr;
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, collator));
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(BSON("foo" << BSON("$gte" << 25)), expCtx);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        ParallelCollectionScan scan(&_opCtx, collection, 4, &ws, filterExpr.get());
+
+        // Results come back in no particular order, but each exactly once, including across
+        // yields.
+        std::set<int> seen;
+        while (!scan.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = scan.work(&id);
+            ASSERT_NOT_EQUALS(PlanStage::FAILURE, state);
+            ASSERT_NOT_EQUALS(PlanStage::NEED_YIELD, state);
+            if (PlanStage::ADVANCED == state) {
+                WorkingSetMember* member = ws.get(id);
+                ASSERT(member->hasRecordId());
+                ASSERT(member->hasObj());
+                ASSERT(seen.insert(member->obj.value()["foo"].numberInt()).second);
+                ws.free(id);
+            }
+            scan.saveState();
+            scan.restoreState();
+        }
+
+        ASSERT_EQUALS(static_cast<size_t>(numObj() - 25), seen.size());
+        ASSERT_EQUALS(25, *seen.begin());
+        ASSERT_EQUALS(numObj() - 1, *seen.rbegin());
+
+        auto stats = static_cast<const ParallelCollectionScanStats*>(scan.getSpecificStats());
+        ASSERT_EQUALS(4U, stats->numPartitions);
+        ASSERT_EQUALS(static_cast<size_t>(numObj()), stats->docsTested);
+    }
+};
+
+class QueryStageParallelCollscanRejectsAdaptiveAnd : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        const int oldPartitions = internalQueryParallelCollectionScanPartitions.load();
+        const int oldInterval = internalQueryAdaptiveAndOrderInterval.load();
+        ON_BLOCK_EXIT([&] {
+            internalQueryParallelCollectionScanPartitions.store(oldPartitions);
+            internalQueryAdaptiveAndOrderInterval.store(oldInterval);
+        });
+        internalQueryParallelCollectionScanPartitions.store(4);
+
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        auto collection = ctx.getCollection();
+
+        auto canParallelize = [&] {
+            auto qr = std::make_unique<QueryRequest>(nss);
+            qr->setFilter(BSON("foo" << BSON("$gte" << 25) << "bar" << BSON("$exists" << false)));
+            auto cq = uassertStatusOK(CanonicalQuery::canonicalize(&_opCtx, std::move(qr)));
+
+            // The scan gets its own copy of the filter, which keeps the adaptive ordering.
+            auto filter = cq->root()->shallowClone();
+            return ParallelCollectionScan::canParallelize(
+                &_opCtx, collection, *cq, CollectionScanParams(), filter.get());
+        };
+
+        internalQueryAdaptiveAndOrderInterval.store(0);
+        ASSERT_TRUE(canParallelize());
+
+        // The workers would share the statistics which the $and reorders its children by.
+        internalQueryAdaptiveAndOrderInterval.store(16);
+        ASSERT_FALSE(canParallelize());
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("QueryStageCollectionScan") {}
@@ -405,6 +540,9 @@ public:
         add<QueryStageCollscanObjectsInOrderBackward>();
         add<QueryStageCollscanDeleteUpcomingObject>();
         add<QueryStageCollscanDeleteUpcomingObjectBackward>();
+        add<QueryStageCollscanWorkBatchWithMatch>();
+        add<QueryStageParallelCollscanWithMatch>();
+        add<QueryStageParallelCollscanRejectsAdaptiveAnd>();
     }
 };
 
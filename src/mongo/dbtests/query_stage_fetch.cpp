@@ -46,7 +46,9 @@
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageFetch {
 
@@ -223,6 +225,66 @@ public:
     }
 };
 
+//
+// Test that reading ahead to prefetch records preserves the order of our child's results.
+//
+class FetchStagePrefetchWindow : public QueryStageFetchBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, nss());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, nss());
+            wuow.commit();
+        }
+
+        const int numDocs = 10;
+        for (int i = 0; i < numDocs; ++i) {
+            insert(BSON("foo" << i));
+        }
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(size_t(numDocs), recordIds.size());
+
+        internalQueryFetchPrefetchWindow.store(4);
+        ON_BLOCK_EXIT([] { internalQueryFetchPrefetchWindow.store(0); });
+
+        WorkingSet ws;
+        auto mockStage = std::make_unique<QueuedDataStage>(&_opCtx, &ws);
+
+        // Hand out the RecordIds in descending order, as a backwards index scan might.
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* mockMember = ws.get(id);
+            mockMember->recordId = *it;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+        }
+
+        unique_ptr<FetchStage> fetchStage(
+            new FetchStage(&_opCtx, &ws, mockStage.release(), nullptr, coll));
+
+        int expected = numDocs - 1;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while (PlanStage::IS_EOF != (state = fetchStage->work(&id))) {
+            if (PlanStage::ADVANCED != state) {
+                continue;
+            }
+            WorkingSetMember* member = ws.get(id);
+            ASSERT_TRUE(member->hasObj());
+            ASSERT_EQUALS(expected--, member->obj.value()["foo"].numberInt());
+            ws.free(id);
+        }
+        ASSERT_EQUALS(-1, expected);
+
+        auto stats = static_cast<const FetchStats*>(fetchStage->getSpecificStats());
+        ASSERT_EQUALS(size_t(numDocs), stats->docsPrefetched);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_fetch") {}
@@ -230,6 +292,7 @@ public:
     void setupTests() {
         add<FetchStageAlreadyFetched>();
         add<FetchStageFilter>();
+        add<FetchStagePrefetchWindow>();
     }
 };
 
@@ -105,6 +105,9 @@ public:
     repl::ReplicationCoordinator::StatusAndDuration awaitReplication(
         OperationContext*, const repl::OpTime&, const WriteConcernOptions&) override;
 
+    SemiFuture<void> awaitReplicationAsyncNoWTimeout(const repl::OpTime&,
+                                                     const WriteConcernOptions&) override;
+
     void stepDown(OperationContext*, bool, const Milliseconds&, const Milliseconds&) override;
 
     Status checkIfWriteConcernCanBeSatisfied(const WriteConcernOptions&) const override;
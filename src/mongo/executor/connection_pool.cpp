@@ -274,6 +274,13 @@ public:
      */
     size_t requestsPending() const;
 
+    /**
+     * Returns how many requests for a connection were fulfilled after each range of wait times.
+     */
+    const ConnectionStatsPer::AcquisitionWaitTimes& acquisitionWaitTimes() const {
+        return _acquisitionWaitTimes;
+    }
+
     /**
      * Returns the HostAndPort for this pool.
      */
@@ -386,6 +393,8 @@ private:
 
     size_t _created = 0;
 
+    ConnectionStatsPer::AcquisitionWaitTimes _acquisitionWaitTimes{};
+
     transport::Session::TagMask _tags = transport::Session::kPending;
 
     HostHealth _health;
@@ -536,6 +545,7 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
                                      pool->availableConnections(),
                                      pool->createdConnections(),
                                      pool->refreshingConnections()};
+        hostStats.acquisitionWaitTimes = pool->acquisitionWaitTimes();
         stats->updateStatsForHost(_name, host, hostStats);
     }
 }
@@ -606,6 +616,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
         if (conn) {
             LOG(kDiagnosticLogLevel) << "Requesting new connection to " << _hostAndPort
                                      << "--using existing idle connection";
+            ++_acquisitionWaitTimes[ConnectionStatsPer::acquisitionWaitBucket(Milliseconds(0))];
             return Future<ConnectionPool::ConnectionHandle>::makeReady(std::move(conn));
         }
     }
@@ -623,7 +634,11 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
     _requests.push_back(make_pair(expiration, std::move(pf.promise)));
     std::push_heap(begin(_requests), end(_requests), RequestComparator{});
 
-    return std::move(pf.future);
+    // Requests are fulfilled by this pool while it holds the lock, which is when this runs.
+    return std::move(pf.future).tap([this, now](const ConnectionHandle&) {
+        const auto wait = _parent->_factory->now() - now;
+        ++_acquisitionWaitTimes[ConnectionStatsPer::acquisitionWaitBucket(wait)];
+    });
 }
 
 auto ConnectionPool::SpecificPool::makeHandle(ConnectionInterface* connection) -> ConnectionHandle {
@@ -31,11 +31,37 @@
 
 #include "mongo/executor/connection_pool_stats.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/util/map_util.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
 namespace executor {
+namespace {
+
+void appendAcquisitionWaitTimes(BSONObjBuilder* result,
+                                const ConnectionStatsPer::AcquisitionWaitTimes& waitTimes) {
+    const auto& bounds = ConnectionStatsPer::kAcquisitionWaitBucketBoundsMillis;
+    BSONObjBuilder waitTimesBuilder(result->subobjStart("acquisitionWaitTimes"));
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        const std::string bucketName = str::stream() << "lt" << bounds[i] << "ms";
+        waitTimesBuilder.appendNumber(bucketName, waitTimes[i]);
+    }
+    const std::string lastBucketName = str::stream() << "gte" << bounds.back() << "ms";
+    waitTimesBuilder.appendNumber(lastBucketName, waitTimes.back());
+}
+
+}  // namespace
+
+constexpr std::array<int, 7> ConnectionStatsPer::kAcquisitionWaitBucketBoundsMillis;
+
+size_t ConnectionStatsPer::acquisitionWaitBucket(Milliseconds wait) {
+    const auto& bounds = kAcquisitionWaitBucketBoundsMillis;
+    return std::upper_bound(bounds.begin(), bounds.end(), durationCount<Milliseconds>(wait)) -
+        bounds.begin();
+}
 
 ConnectionStatsPer::ConnectionStatsPer(size_t nInUse,
                                        size_t nAvailable,
@@ -50,6 +76,9 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    for (size_t i = 0; i < acquisitionWaitTimes.size(); ++i) {
+        acquisitionWaitTimes[i] += other.acquisitionWaitTimes[i];
+    }
 
     return *this;
 }
@@ -99,6 +128,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result, bool forFT
             poolInfo.appendNumber("poolAvailable", poolStats.available);
             poolInfo.appendNumber("poolCreated", poolStats.created);
             poolInfo.appendNumber("poolRefreshing", poolStats.refreshing);
+            appendAcquisitionWaitTimes(&poolInfo, poolStats.acquisitionWaitTimes);
             for (const auto& host : statsByPoolHost[pool.first]) {
                 BSONObjBuilder hostInfo(poolInfo.subobjStart(host.first.toString()));
                 auto& hostStats = host.second;
@@ -106,6 +136,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result, bool forFT
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                appendAcquisitionWaitTimes(&hostInfo, hostStats.acquisitionWaitTimes);
             }
         }
     }
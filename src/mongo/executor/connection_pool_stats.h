@@ -29,7 +29,10 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
@@ -40,6 +43,19 @@ namespace executor {
  * a parent ConnectionPoolStats object and should not need to be created directly.
  */
 struct ConnectionStatsPer {
+    /**
+     * The number of requests for a connection which waited less than each of
+     * kAcquisitionWaitBucketBoundsMillis for one, followed by the number which waited longer.
+     */
+    static constexpr std::array<int, 7> kAcquisitionWaitBucketBoundsMillis{
+        1, 5, 10, 50, 100, 500, 1000};
+    using AcquisitionWaitTimes = std::array<size_t, kAcquisitionWaitBucketBoundsMillis.size() + 1>;
+
+    /**
+     * Returns the index of the bucket of AcquisitionWaitTimes which counts a wait of 'wait'.
+     */
+    static size_t acquisitionWaitBucket(Milliseconds wait);
+
     ConnectionStatsPer(size_t nInUse, size_t nAvailable, size_t nCreated, size_t nRefreshing);
 
     ConnectionStatsPer();
@@ -50,6 +66,7 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+    AcquisitionWaitTimes acquisitionWaitTimes{};
 };
 
 /**
@@ -33,6 +33,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <numeric>
 #include <random>
 #include <stack>
 #include <tuple>
@@ -41,6 +42,7 @@
 #include <fmt/ostream.h>
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
@@ -420,6 +422,49 @@ TEST_F(ConnectionPoolTest, TimeoutOnSetup) {
                            fmt::format("{}", ConnectionPool::kHostRetryTimeout));
 }
 
+/**
+ * Verify that the time requests wait for a connection is counted in the matching bucket.
+ */
+TEST_F(ConnectionPoolTest, AcquisitionWaitTimesAreCounted) {
+    auto pool = makePool();
+
+    auto now = Date_t::now();
+
+    PoolImpl::setNow(now);
+
+    // The first request waits for its connection to be set up
+    bool reachedA = false;
+    pool->get_forTest(HostAndPort(),
+                      Milliseconds(5000),
+                      [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                          ASSERT(swConn.isOK());
+                          reachedA = true;
+                          doneWith(swConn.getValue());
+                      });
+
+    PoolImpl::setNow(now + Milliseconds(20));
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(reachedA);
+
+    // The second request gets the idle connection right away
+    bool reachedB = false;
+    pool->get_forTest(HostAndPort(),
+                      Milliseconds(5000),
+                      [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                          ASSERT(swConn.isOK());
+                          reachedB = true;
+                          doneWith(swConn.getValue());
+                      });
+    ASSERT(reachedB);
+
+    ConnectionPoolStats stats;
+    pool->appendConnectionStats(&stats);
+    const auto& waitTimes = stats.statsByHost[HostAndPort()].acquisitionWaitTimes;
+    ASSERT_EQ(waitTimes[ConnectionStatsPer::acquisitionWaitBucket(Milliseconds(0))], 1u);
+    ASSERT_EQ(waitTimes[ConnectionStatsPer::acquisitionWaitBucket(Milliseconds(20))], 1u);
+    ASSERT_EQ(std::accumulate(waitTimes.begin(), waitTimes.end(), size_t(0)), 2u);
+}
+
 /**
  * Verify that refresh callbacks happen at the appropriate moments.
  */
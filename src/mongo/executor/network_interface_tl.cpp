@@ -33,9 +33,13 @@
 
 #include "mongo/executor/network_interface_tl.h"
 
+#include <algorithm>
+
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/server_options.h"
 #include "mongo/executor/connection_pool_tl.h"
+#include "mongo/executor/network_interface_tl_gen.h"
+#include "mongo/stdx/trusted_hasher.h"
 #include "mongo/transport/transport_layer_manager.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
@@ -44,6 +48,40 @@
 
 namespace mongo {
 namespace executor {
+namespace {
+
+/**
+ * Forwards to a hook shared by the connection pools of every IOThread.
+ */
+class SharedNetworkConnectionHook final : public NetworkConnectionHook {
+public:
+    explicit SharedNetworkConnectionHook(std::shared_ptr<NetworkConnectionHook> hook)
+        : _hook(std::move(hook)) {}
+
+    BSONObj augmentIsMasterRequest(BSONObj cmdObj) override {
+        return _hook->augmentIsMasterRequest(std::move(cmdObj));
+    }
+
+    Status validateHost(const HostAndPort& remoteHost,
+                        const BSONObj& isMasterRequest,
+                        const RemoteCommandResponse& isMasterReply) override {
+        return _hook->validateHost(remoteHost, isMasterRequest, isMasterReply);
+    }
+
+    StatusWith<boost::optional<RemoteCommandRequest>> makeRequest(
+        const HostAndPort& remoteHost) override {
+        return _hook->makeRequest(remoteHost);
+    }
+
+    Status handleReply(const HostAndPort& remoteHost, RemoteCommandResponse&& response) override {
+        return _hook->handleReply(remoteHost, std::move(response));
+    }
+
+private:
+    const std::shared_ptr<NetworkConnectionHook> _hook;
+};
+
+}  // namespace
 
 NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
                                        ConnectionPool::Options connPoolOpts,
@@ -65,11 +103,15 @@ std::string NetworkInterfaceTL::getDiagnosticString() {
 }
 
 void NetworkInterfaceTL::appendConnectionStats(ConnectionPoolStats* stats) const {
-    auto pool = [&] {
+    auto pools = [&] {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
-        return _pool.get();
+        std::vector<ConnectionPool*> pools;
+        for (const auto& ioThread : _ioThreads) {
+            pools.push_back(ioThread.pool.get());
+        }
+        return pools;
     }();
-    if (pool)
+    for (auto pool : pools)
         pool->appendConnectionStats(stats);
 }
 
@@ -96,32 +138,51 @@ void NetworkInterfaceTL::startup() {
         _tl = _ownedTransportLayer.get();
     }
 
-    _reactor = _tl->getReactor(transport::TransportLayer::kNewReactor);
-    auto typeFactory = std::make_unique<connection_pool_tl::TLTypeFactory>(
-        _reactor, _tl, std::move(_onConnectHook), _connPoolOpts);
-    _pool = std::make_shared<ConnectionPool>(
-        std::move(typeFactory), std::string("NetworkInterfaceTL-") + _instanceName, _connPoolOpts);
-    _ioThread = stdx::thread([this] {
-        setThreadName(_instanceName);
-        _run();
-    });
+    // All the pools share the name of the interface, so that their stats add up under it
+    const size_t numIOThreads = networkInterfaceIOThreads;
+    std::shared_ptr<NetworkConnectionHook> onConnectHook = std::move(_onConnectHook);
+    _ioThreads.resize(numIOThreads);
+    for (auto& ioThread : _ioThreads) {
+        ioThread.reactor = _tl->getReactor(transport::TransportLayer::kNewReactor);
+        auto typeFactory = std::make_unique<connection_pool_tl::TLTypeFactory>(
+            ioThread.reactor,
+            _tl,
+            onConnectHook ? std::make_unique<SharedNetworkConnectionHook>(onConnectHook) : nullptr,
+            _connPoolOpts);
+        ioThread.pool = std::make_shared<ConnectionPool>(std::move(typeFactory),
+                                                         std::string("NetworkInterfaceTL-") +
+                                                             _instanceName,
+                                                         _connPoolOpts);
+    }
+    _reactor = _ioThreads.front().reactor;
+
+    for (size_t i = 0; i < numIOThreads; ++i) {
+        std::string threadName = _instanceName;
+        if (i > 0) {
+            threadName += str::stream() << "-" << i;
+        }
+        _ioThreads[i].thread = stdx::thread([this, i, threadName] {
+            setThreadName(threadName);
+            _run(&_ioThreads[i]);
+        });
+    }
 
     invariant(_state.swap(kStarted) == kDefault);
 }
 
-void NetworkInterfaceTL::_run() {
+void NetworkInterfaceTL::_run(IOThread* ioThread) {
     LOG(2) << "The NetworkInterfaceTL reactor thread is spinning up";
 
     // This returns when the reactor is stopped in shutdown()
-    _reactor->run();
+    ioThread->reactor->run();
 
     // Note that the pool will shutdown again when the ConnectionPool dtor runs
     // This prevents new timers from being set, calls all cancels via the factory registry, and
     // destructs all connections for all existing pools.
-    _pool->shutdown();
+    ioThread->pool->shutdown();
 
     // Close out all remaining tasks in the reactor now that they've all been canceled.
-    _reactor->drain();
+    ioThread->reactor->drain();
 
     LOG(2) << "NetworkInterfaceTL shutdown successfully";
 }
@@ -132,12 +193,16 @@ void NetworkInterfaceTL::shutdown() {
 
     LOG(2) << "Shutting down network interface.";
 
-    // Stop the reactor/thread first so that nothing runs on a partially dtor'd pool.
-    _reactor->stop();
+    // Stop the reactors/threads first so that nothing runs on a partially dtor'd pool.
+    for (auto& ioThread : _ioThreads) {
+        ioThread.reactor->stop();
+    }
 
     _cancelAllAlarms();
 
-    _ioThread.join();
+    for (auto& ioThread : _ioThreads) {
+        ioThread.thread.join();
+    }
 }
 
 bool NetworkInterfaceTL::inShutdown() const {
@@ -236,7 +301,10 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         cmdState->deadline = cmdState->start + cmdState->requestOnAny.timeout;
     }
 
-    auto executor = baton ? ExecutorPtr(baton) : ExecutorPtr(_reactor);
+    // Without a baton, the command completes on the reactor holding the connections to its first
+    // target
+    auto executor =
+        baton ? ExecutorPtr(baton) : ExecutorPtr(_ioThreadFor(request.target.front()).reactor);
     std::move(cmdPF.future)
         .thenRunOn(executor)
         .onError([requestId = cmdState->requestOnAny.id](auto error)
@@ -322,7 +390,8 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
             }
         };
 
-        if (auto semi = _pool->get(request.target[idx], request.sslMode, request.timeout);
+        auto& ioThread = _ioThreadFor(request.target[idx]);
+        if (auto semi = ioThread.pool->get(request.target[idx], request.sslMode, request.timeout);
             semi.isReady()) {
             // If we have a connection in hand, stay on thread and immediately handle it
             getConnectionCallback(std::move(semi).getNoThrow());
@@ -330,7 +399,7 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
             // Otherwise route all connection management over the networking reactor, to ensure we
             // promptly return connections to the pool that may not be needed
             std::move(semi)
-                .thenRunOn(ExecutorPtr(_reactor))
+                .thenRunOn(ExecutorPtr(ioThread.reactor))
                 .getAsync(std::move(getConnectionCallback));
         }
     }
@@ -365,7 +434,7 @@ void NetworkInterfaceTL::_onAcquireConn(std::shared_ptr<CommandState> state,
                                     << state->requestOnAny.timeout);
         }
 
-        state->timer = _reactor->makeTimer();
+        state->timer = _ioThreadFor(state->conn->getHostAndPort()).reactor->makeTimer();
         state->timer->waitUntil(state->deadline, baton)
             .getAsync([this, client, state, baton](Status status) {
                 if (status == ErrorCodes::CallbackCanceled) {
@@ -604,11 +673,20 @@ void NetworkInterfaceTL::_answerAlarm(Status status, std::shared_ptr<AlarmState>
 }
 
 bool NetworkInterfaceTL::onNetworkThread() {
-    return _reactor->onReactorThread();
+    return std::any_of(_ioThreads.begin(), _ioThreads.end(), [](const IOThread& ioThread) {
+        return ioThread.reactor->onReactorThread();
+    });
 }
 
 void NetworkInterfaceTL::dropConnections(const HostAndPort& hostAndPort) {
-    _pool->dropConnections(hostAndPort);
+    _ioThreadFor(hostAndPort).pool->dropConnections(hostAndPort);
+}
+
+auto NetworkInterfaceTL::_ioThreadFor(const HostAndPort& hostAndPort) -> IOThread& {
+    if (_ioThreads.size() == 1) {
+        return _ioThreads.front();
+    }
+    return _ioThreads[DefaultHasher<HostAndPort>{}(hostAndPort) % _ioThreads.size()];
 }
 
 }  // namespace executor
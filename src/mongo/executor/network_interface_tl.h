@@ -30,6 +30,7 @@
 #pragma once
 
 #include <deque>
+#include <vector>
 
 #include "mongo/client/async_client.h"
 #include "mongo/db/service_context.h"
@@ -133,7 +134,22 @@ private:
     void _cancelAllAlarms();
     void _answerAlarm(Status status, std::shared_ptr<AlarmState> state);
 
-    void _run();
+    /**
+     * An egress networking thread, which runs a reactor and owns the connections to the hosts
+     * assigned to it.
+     */
+    struct IOThread {
+        transport::ReactorHandle reactor;
+        std::shared_ptr<ConnectionPool> pool;
+        stdx::thread thread;
+    };
+
+    /**
+     * Returns the IOThread whose pool holds the connections to 'hostAndPort'.
+     */
+    IOThread& _ioThreadFor(const HostAndPort& hostAndPort);
+
+    void _run(IOThread* ioThread);
     void _onAcquireConn(std::shared_ptr<CommandState> state,
                         ConnectionPool::ConnectionHandle conn,
                         const BatonHandle& baton);
@@ -143,12 +159,12 @@ private:
     transport::TransportLayer* _tl;
     // Will be created if ServiceContext is null, or if no TransportLayer was configured at startup
     std::unique_ptr<transport::TransportLayer> _ownedTransportLayer;
+    // The reactor of the first IOThread, which also runs alarms and scheduled work
     transport::ReactorHandle _reactor;
 
     mutable stdx::mutex _mutex;
     ConnectionPool::Options _connPoolOpts;
     std::unique_ptr<NetworkConnectionHook> _onConnectHook;
-    std::shared_ptr<ConnectionPool> _pool;
     Counters _counters;
 
     std::unique_ptr<rpc::EgressMetadataHook> _metadataHook;
@@ -161,7 +177,10 @@ private:
         kStopped,
     };
     AtomicWord<State> _state;
-    stdx::thread _ioThread;
+
+    // Hosts are assigned to these by the hash of their HostAndPort. This is filled in by startup()
+    // and does not change afterwards.
+    std::vector<IOThread> _ioThreads;
 
     stdx::mutex _inProgressMutex;
     stdx::unordered_map<TaskExecutor::CallbackHandle, std::weak_ptr<CommandState>> _inProgress;
@@ -39,6 +39,7 @@
 #include "mongo/client/remote_command_targeter.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/s/async_requests_sender_gen.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/transport/baton.h"
@@ -56,6 +57,16 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+/**
+ * Returns whether requests sent with 'readPref' may be sent to a second host while the first is
+ * slow to respond. Only idempotent requests are, since both hosts may end up running them.
+ */
+bool shouldHedge(const ReadPreferenceSetting& readPref, Shard::RetryPolicy retryPolicy) {
+    return gEnableHedgedReads.load() && retryPolicy == Shard::RetryPolicy::kIdempotent &&
+        (readPref.pref == ReadPreference::Nearest ||
+         readPref.pref == ReadPreference::SecondaryPreferred);
+}
+
 }  // namespace
 
 AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
@@ -181,6 +192,10 @@ SemiFuture<std::vector<HostAndPort>> AsyncRequestsSender::RemoteData::resolveSha
 
 auto AsyncRequestsSender::RemoteData::scheduleRemoteCommand(std::vector<HostAndPort>&& hostAndPorts)
     -> SemiFuture<RemoteCommandOnAnyCallbackArgs> {
+    if (hostAndPorts.size() > 1 && shouldHedge(_ars->_readPreference, _ars->_retryPolicy)) {
+        return scheduleHedgedRemoteCommand(std::move(hostAndPorts));
+    }
+
     executor::RemoteCommandRequestOnAny request(
         std::move(hostAndPorts), _ars->_db, _cmdObj, _ars->_metadataObj, _ars->_opCtx);
 
@@ -200,6 +215,104 @@ auto AsyncRequestsSender::RemoteData::scheduleRemoteCommand(std::vector<HostAndP
     return std::move(f).semi();
 }
 
+auto AsyncRequestsSender::RemoteData::scheduleHedgedRemoteCommand(
+    std::vector<HostAndPort>&& hostAndPorts) -> SemiFuture<RemoteCommandOnAnyCallbackArgs> {
+    using CallbackHandle = executor::TaskExecutor::CallbackHandle;
+
+    struct HedgeState {
+        explicit HedgeState(Promise<RemoteCommandOnAnyCallbackArgs> p) : promise(std::move(p)) {}
+
+        stdx::mutex mutex;
+        bool done = false;
+
+        // The requests and the timer which have not been canceled yet
+        std::vector<CallbackHandle> handles;
+
+        Promise<RemoteCommandOnAnyCallbackArgs> promise;
+    };
+
+    auto makeRequest = [this](const HostAndPort& host) {
+        return executor::RemoteCommandRequestOnAny(std::vector<HostAndPort>{host},
+                                                   _ars->_db,
+                                                   _cmdObj,
+                                                   _ars->_metadataObj,
+                                                   _ars->_opCtx);
+    };
+
+    const auto& executor = *_ars->_subExecutor;
+    const auto& baton = *_ars->_subBaton;
+
+    auto[p, f] = makePromiseFuture<RemoteCommandOnAnyCallbackArgs>();
+    auto state = std::make_shared<HedgeState>(std::move(p));
+
+    // Keeps the handle to cancel once a response arrives, or cancels it if one already has. The
+    // cancellation happens outside of the mutex, since it may run the canceled callback.
+    auto keepHandle = [state, executor](const CallbackHandle& handle) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(state->mutex);
+            if (!state->done) {
+                state->handles.push_back(handle);
+                return;
+            }
+        }
+        executor->cancel(handle);
+    };
+
+    auto onResponse = [state, executor](const RemoteCommandOnAnyCallbackArgs& cbData) {
+        std::vector<CallbackHandle> handles;
+        {
+            stdx::lock_guard<stdx::mutex> lk(state->mutex);
+            if (std::exchange(state->done, true)) {
+                return;
+            }
+            handles = std::move(state->handles);
+        }
+
+        for (const auto& handle : handles) {
+            executor->cancel(handle);
+        }
+        state->promise.emplaceValue(cbData);
+    };
+
+    // Failures to schedule skip the retry loop
+    keepHandle(uassertStatusOK(executor->scheduleRemoteCommandOnAny(
+        makeRequest(hostAndPorts[0]), onResponse, baton)));
+
+    auto hedge = [
+        state,
+        executor,
+        baton,
+        onResponse,
+        keepHandle,
+        shardId = _shardId,
+        request = makeRequest(hostAndPorts[1])
+    ](const executor::TaskExecutor::CallbackArgs& args) {
+        if (!args.status.isOK()) {
+            return;
+        }
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(state->mutex);
+            if (state->done) {
+                return;
+            }
+        }
+
+        LOG(1) << "Hedging request to shard " << shardId << " with host " << request.target[0];
+
+        // The first request is still outstanding if the hedged one can't be scheduled
+        auto swHandle = executor->scheduleRemoteCommandOnAny(request, onResponse, baton);
+        if (swHandle.isOK()) {
+            keepHandle(swHandle.getValue());
+        }
+    };
+
+    keepHandle(uassertStatusOK(executor->scheduleWorkAt(
+        executor->now() + Milliseconds(gHedgedReadsDelayMS.load()), std::move(hedge))));
+
+    return std::move(f).semi();
+}
+
 
 auto AsyncRequestsSender::RemoteData::handleResponse(RemoteCommandOnAnyCallbackArgs&& rcr)
     -> SemiFuture<RemoteCommandOnAnyCallbackArgs> {
@@ -227,6 +227,14 @@ private:
         SemiFuture<RemoteCommandOnAnyCallbackArgs> scheduleRemoteCommand(
             std::vector<HostAndPort>&& hostAndPort);
 
+        /**
+         * Schedules the remote command on the first of the given hosts, and again on the second if
+         * the first has not responded within hedgedReadsDelayMS. Whichever response arrives first
+         * is returned, and the other request is canceled.
+         */
+        SemiFuture<RemoteCommandOnAnyCallbackArgs> scheduleHedgedRemoteCommand(
+            std::vector<HostAndPort>&& hostAndPorts);
+
         /**
          * Handles the remote response
          */
@@ -33,6 +33,8 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <numeric>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
@@ -58,6 +60,22 @@ void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
     }
 }
 
+void checkContinuity(const ChunkInfo& chunk, const ChunkInfo& nextChunk) {
+    if (SimpleBSONObjComparator::kInstance.evaluate(chunk.getMax() == nextChunk.getMin())) {
+        return;
+    }
+
+    uasserted(ErrorCodes::ConflictingOperationInProgress,
+              str::stream() << (SimpleBSONObjComparator::kInstance.evaluate(chunk.getMax() <
+                                                                            nextChunk.getMin())
+                                    ? "Gap"
+                                    : "Overlap")
+                            << " exists in the routing table between chunks "
+                            << chunk.getRange().toString()
+                            << " and "
+                            << nextChunk.getRange().toString());
+}
+
 std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering ordering) {
     BSONObjBuilder strippedKeyValue;
     for (const auto& elem : shardKeyValue) {
@@ -68,8 +86,253 @@ std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering orde
     return {ks.getBuffer(), ks.getSize()};
 }
 
+/**
+ * Returns the first 8 bytes of 'keyString', padded with zeros, as a big-endian integer. These
+ * compare in the same order as the KeyStrings, except that different KeyStrings may be equal.
+ */
+std::uint64_t keyStringPrefix(const std::string& keyString) {
+    std::uint64_t prefix = 0;
+    for (std::size_t i = 0; i < sizeof(prefix); ++i) {
+        prefix <<= 8;
+        if (i < keyString.size()) {
+            prefix |= static_cast<unsigned char>(keyString[i]);
+        }
+    }
+    return prefix;
+}
+
+/**
+ * Returns the index of the first prefix which is not less than 'prefix', or with 'orEqual', which
+ * is greater than 'prefix'. The loop has no branches on the data other than its fixed number of
+ * halvings, so a search over a large routing table does not stall on mispredictions.
+ */
+std::size_t searchPrefixes(const std::vector<std::uint64_t>& prefixes,
+                           std::uint64_t prefix,
+                           bool orEqual) {
+    if (prefixes.empty()) {
+        return 0;
+    }
+
+    const std::uint64_t* base = prefixes.data();
+    std::size_t n = prefixes.size();
+    while (n > 1) {
+        const std::size_t half = n / 2;
+        base = (orEqual ? base[half] <= prefix : base[half] < prefix) ? base + half : base;
+        n -= half;
+    }
+    return (base - prefixes.data()) + (orEqual ? *base <= prefix : *base < prefix);
+}
+
+/**
+ * Returns the index of the first of 'prefixes' and 'keyAt(i)' which is greater than 'keyString',
+ * with 'orEqual', or not less than it otherwise. Only the keys whose prefix equals that of
+ * 'keyString' are compared as strings.
+ */
+template <typename KeyAt>
+std::size_t searchKeys(const std::vector<std::uint64_t>& prefixes,
+                       KeyAt keyAt,
+                       const std::string& keyString,
+                       bool orEqual) {
+    const auto prefix = keyStringPrefix(keyString);
+    std::size_t low = searchPrefixes(prefixes, prefix, false);
+    std::size_t high = searchPrefixes(prefixes, prefix, true);
+    while (low < high) {
+        const std::size_t mid = low + (high - low) / 2;
+        const int cmp = keyAt(mid).compare(keyString);
+        if (orEqual ? cmp <= 0 : cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
 }  // namespace
 
+constexpr std::size_t ChunkInfoMap::kMaxPageSize;
+constexpr std::size_t RoutingTableHistory::kMaxQueryTargetingCacheBytes;
+
+ChunkInfoMap::const_iterator ChunkInfoMap::upper_bound(const std::string& keyString) const {
+    const auto pageIndex = searchKeys(
+        _pageMaxPrefixes,
+        [this](std::size_t i) -> const std::string& { return _pages[i]->entries.back().first; },
+        keyString,
+        true);
+    if (pageIndex == _pages.size()) {
+        return end();
+    }
+
+    const auto& page = *_pages[pageIndex];
+    return {this,
+            pageIndex,
+            searchKeys(page.prefixes,
+                       [&page](std::size_t i) -> const std::string& {
+                           return page.entries[i].first;
+                       },
+                       keyString,
+                       true)};
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::lower_bound(const std::string& keyString) const {
+    const auto pageIndex = searchKeys(
+        _pageMaxPrefixes,
+        [this](std::size_t i) -> const std::string& { return _pages[i]->entries.back().first; },
+        keyString,
+        false);
+    if (pageIndex == _pages.size()) {
+        return end();
+    }
+
+    const auto& page = *_pages[pageIndex];
+    return {this,
+            pageIndex,
+            searchKeys(page.prefixes,
+                       [&page](std::size_t i) -> const std::string& {
+                           return page.entries[i].first;
+                       },
+                       keyString,
+                       false)};
+}
+
+void ChunkInfoMap::insert(value_type entry) {
+    if (_pages.empty()) {
+        auto page = std::make_shared<Page>();
+        page->prefixes.push_back(keyStringPrefix(entry.first));
+        page->entries.push_back(std::move(entry));
+        _pageMaxPrefixes.push_back(page->prefixes.back());
+        _pages.push_back(std::move(page));
+        _size = 1;
+        return;
+    }
+
+    // The entry goes in the first page with a greater max, or at the end of the last page.
+    const auto pageIndex = std::min(
+        searchKeys(_pageMaxPrefixes,
+                   [this](std::size_t i) -> const std::string& {
+                       return _pages[i]->entries.back().first;
+                   },
+                   entry.first,
+                   true),
+        _pages.size() - 1);
+    auto& page = _mutablePage(pageIndex);
+    const auto offset = searchKeys(
+        page.prefixes,
+        [&page](std::size_t i) -> const std::string& { return page.entries[i].first; },
+        entry.first,
+        true);
+    page.prefixes.insert(page.prefixes.begin() + offset, keyStringPrefix(entry.first));
+    page.entries.insert(page.entries.begin() + offset, std::move(entry));
+    ++_size;
+
+    if (page.entries.size() > kMaxPageSize) {
+        const auto half = page.entries.size() / 2;
+        auto upperHalf = std::make_shared<Page>();
+        upperHalf->prefixes.assign(page.prefixes.begin() + half, page.prefixes.end());
+        upperHalf->entries.assign(std::make_move_iterator(page.entries.begin() + half),
+                                  std::make_move_iterator(page.entries.end()));
+        page.prefixes.erase(page.prefixes.begin() + half, page.prefixes.end());
+        page.entries.erase(page.entries.begin() + half, page.entries.end());
+
+        _pages.insert(_pages.begin() + pageIndex + 1, std::move(upperHalf));
+        _pageMaxPrefixes.insert(_pageMaxPrefixes.begin() + pageIndex + 1, 0);
+        _pageChanged(pageIndex + 1);
+    }
+    _pageChanged(pageIndex);
+}
+
+void ChunkInfoMap::erase(const_iterator first, const_iterator last) {
+    // Go through the pages backwards, so that the removal of an emptied page does not move the
+    // pages which are left to trim.
+    auto pageIndex = last._offset == 0 ? last._page : last._page + 1;
+    while (pageIndex-- > first._page) {
+        const std::size_t begin = pageIndex == first._page ? first._offset : 0;
+        const std::size_t end =
+            pageIndex == last._page ? last._offset : _pages[pageIndex]->entries.size();
+        _size -= end - begin;
+
+        // Pages which are removed whole are not copied.
+        if (begin == 0 && end == _pages[pageIndex]->entries.size()) {
+            _pages.erase(_pages.begin() + pageIndex);
+            _pageMaxPrefixes.erase(_pageMaxPrefixes.begin() + pageIndex);
+            continue;
+        }
+
+        auto& page = _mutablePage(pageIndex);
+        page.prefixes.erase(page.prefixes.begin() + begin, page.prefixes.begin() + end);
+        page.entries.erase(page.entries.begin() + begin, page.entries.begin() + end);
+        _pageChanged(pageIndex);
+    }
+}
+
+ShardVersionMap ChunkInfoMap::constructShardVersionMap(const OID& epoch) const {
+    ShardVersionMap shardVersions;
+    const ChunkInfo* lastChunk = nullptr;
+
+    for (const auto& page : _pages) {
+        if (!page->shardVersions) {
+            ShardVersionMap pageShardVersions;
+            for (std::size_t i = 0; i < page->entries.size(); ++i) {
+                const auto& chunk = *page->entries[i].second;
+                if (i > 0) {
+                    checkContinuity(*page->entries[i - 1].second, chunk);
+                }
+
+                auto& maxShardVersion =
+                    pageShardVersions
+                        .emplace(chunk.getShardIdAt(boost::none), ChunkVersion(0, 0, epoch))
+                        .first->second;
+                if (chunk.getLastmod() > maxShardVersion)
+                    maxShardVersion = chunk.getLastmod();
+            }
+            page->shardVersions = std::move(pageShardVersions);
+        }
+
+        if (lastChunk) {
+            checkContinuity(*lastChunk, *page->entries.front().second);
+        }
+        lastChunk = page->entries.back().second.get();
+
+        for (const auto& pageShardVersion : *page->shardVersions) {
+            auto& maxShardVersion =
+                shardVersions.emplace(pageShardVersion.first, ChunkVersion(0, 0, epoch))
+                    .first->second;
+            if (pageShardVersion.second > maxShardVersion)
+                maxShardVersion = pageShardVersion.second;
+
+            // If a shard has chunks it must have a shard version, otherwise we have an invalid
+            // chunk somewhere, which should have been caught at chunk load time
+            invariant(maxShardVersion.isSet());
+        }
+    }
+
+    if (lastChunk) {
+        invariant(!shardVersions.empty());
+        checkAllElementsAreOfType(MinKey, _pages.front()->entries.front().second->getMin());
+        checkAllElementsAreOfType(MaxKey, lastChunk->getMax());
+    }
+
+    return shardVersions;
+}
+
+ChunkInfoMap::Page& ChunkInfoMap::_mutablePage(std::size_t pageIndex) {
+    auto& page = _pages[pageIndex];
+    if (page.use_count() > 1) {
+        page = std::make_shared<Page>(*page);
+    }
+    page->shardVersions = boost::none;
+    return *page;
+}
+
+void ChunkInfoMap::_pageChanged(std::size_t pageIndex) {
+    if (_pages[pageIndex]->entries.empty()) {
+        _pages.erase(_pages.begin() + pageIndex);
+        _pageMaxPrefixes.erase(_pageMaxPrefixes.begin() + pageIndex);
+        return;
+    }
+    _pageMaxPrefixes[pageIndex] = _pages[pageIndex]->prefixes.back();
+}
+
 RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
                                          boost::optional<UUID> uuid,
                                          KeyPattern shardKeyPattern,
@@ -108,6 +371,42 @@ Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj
     return Chunk(*(it->second), _clusterTime);
 }
 
+std::vector<Chunk> ChunkManager::findIntersectingChunksWithSimpleCollation(
+    const std::vector<BSONObj>& shardKeys) const {
+    std::vector<std::string> keyStrings;
+    keyStrings.reserve(shardKeys.size());
+    for (const auto& shardKey : shardKeys) {
+        keyStrings.push_back(_rt->_extractKeyString(shardKey));
+    }
+
+    std::vector<std::size_t> order(shardKeys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&keyStrings](std::size_t lhs, std::size_t rhs) {
+        return keyStrings[lhs] < keyStrings[rhs];
+    });
+
+    const auto& chunkMap = _rt->getChunkMap();
+    std::vector<ChunkInfo*> chunkInfos(shardKeys.size());
+    auto it = chunkMap.end();
+    for (const auto i : order) {
+        // The chunk of the previous key also holds this key while the key is below its max.
+        if (it == chunkMap.end() || !(keyStrings[i] < it->first)) {
+            it = chunkMap.upper_bound(keyStrings[i]);
+        }
+        uassert(ErrorCodes::ShardKeyNotFound,
+                str::stream() << "Cannot target single shard using key " << shardKeys[i],
+                it != chunkMap.end() && it->second->containsKey(shardKeys[i]));
+        chunkInfos[i] = it->second.get();
+    }
+
+    std::vector<Chunk> chunks;
+    chunks.reserve(shardKeys.size());
+    for (const auto chunkInfo : chunkInfos) {
+        chunks.emplace_back(*chunkInfo, _clusterTime);
+    }
+    return chunks;
+}
+
 bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& shardId) const {
     if (shardKey.isEmpty())
         return false;
@@ -125,6 +424,32 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
                                        const BSONObj& query,
                                        const BSONObj& collation,
                                        std::set<ShardId>* shardIds) const {
+    // The routing table at a past cluster time may place chunks on other shards, so only the
+    // targeting of the latest routing table is cached.
+    if (_clusterTime) {
+        _getShardIdsForQuery(opCtx, query, collation, shardIds);
+        return;
+    }
+
+    // Both objects are prefixed with their size, so their concatenation identifies the pair.
+    std::string cacheKey;
+    cacheKey.reserve(query.objsize() + collation.objsize());
+    cacheKey.append(query.objdata(), query.objsize());
+    cacheKey.append(collation.objdata(), collation.objsize());
+    if (_rt->_findCachedShardIdsForQuery(cacheKey, shardIds)) {
+        return;
+    }
+
+    std::set<ShardId> targetedShardIds;
+    _getShardIdsForQuery(opCtx, query, collation, &targetedShardIds);
+    shardIds->insert(targetedShardIds.begin(), targetedShardIds.end());
+    _rt->_cacheShardIdsForQuery(std::move(cacheKey), targetedShardIds);
+}
+
+void ChunkManager::_getShardIdsForQuery(OperationContext* opCtx,
+                                        const BSONObj& query,
+                                        const BSONObj& collation,
+                                        std::set<ShardId>* shardIds) const {
     auto qr = std::make_unique<QueryRequest>(_rt->getns());
     qr->setFilter(query);
 
@@ -169,7 +494,15 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
     //   => Ranges { a : 1, b : 3 } => { a : 2, b : 4 }
     BoundList ranges = _rt->getShardKeyPattern().flattenBounds(bounds);
 
+    // The point ranges, such as those of an $in on the shard key, are looked up together in the
+    // order of their keys, so that consecutive keys in the same chunk share a single lookup
+    std::vector<BSONObj> pointKeys;
     for (BoundList::const_iterator it = ranges.begin(); it != ranges.end(); ++it) {
+        if (SimpleBSONObjComparator::kInstance.evaluate(it->first == it->second)) {
+            pointKeys.push_back(it->first);
+            continue;
+        }
+
         getShardIdsForRange(it->first /*min*/, it->second /*max*/, shardIds);
 
         // once we know we need to visit all shards no need to keep looping
@@ -178,6 +511,18 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
         }
     }
 
+    if (!pointKeys.empty() && shardIds->size() < _rt->_shardVersions.size()) {
+        try {
+            for (const auto& chunk : findIntersectingChunksWithSimpleCollation(pointKeys)) {
+                shardIds->insert(chunk.getShardId());
+            }
+        } catch (const DBException&) {
+            for (const auto& pointKey : pointKeys) {
+                getShardIdsForRange(pointKey, pointKey, shardIds);
+            }
+        }
+    }
+
     // SERVER-4914 Some clients of getShardIdsForQuery() assume at least one shard will be returned.
     // For now, we satisfy that assumption by adding a shard with no matches rather than returning
     // an empty set of shards.
@@ -226,6 +571,37 @@ ChunkManager::ConstRangeOfChunks ChunkManager::getNextChunkOnShard(const BSONObj
     return {ConstChunkIterator(), ConstChunkIterator()};
 }
 
+bool RoutingTableHistory::_findCachedShardIdsForQuery(const std::string& cacheKey,
+                                                      std::set<ShardId>* shardIds) const {
+    stdx::lock_guard<stdx::mutex> lk(_queryTargetingCacheMutex);
+    auto it = _queryTargetingCache.find(cacheKey);
+    if (it == _queryTargetingCache.end()) {
+        return false;
+    }
+
+    shardIds->insert(it->second.begin(), it->second.end());
+    return true;
+}
+
+void RoutingTableHistory::_cacheShardIdsForQuery(std::string cacheKey,
+                                                 const std::set<ShardId>& shardIds) const {
+    // Queries too large to share the cache with others are not worth keeping
+    if (cacheKey.size() > kMaxQueryTargetingCacheBytes / 16) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_queryTargetingCacheMutex);
+    if (_queryTargetingCacheBytes + cacheKey.size() > kMaxQueryTargetingCacheBytes) {
+        _queryTargetingCache.clear();
+        _queryTargetingCacheBytes = 0;
+    }
+
+    const auto keySize = cacheKey.size();
+    if (_queryTargetingCache.emplace(std::move(cacheKey), shardIds).second) {
+        _queryTargetingCacheBytes += keySize;
+    }
+}
+
 void RoutingTableHistory::getAllShardIds(std::set<ShardId>* all) const {
     std::transform(_shardVersions.begin(),
                    _shardVersions.end(),
@@ -405,86 +781,7 @@ std::string RoutingTableHistory::toString() const {
 }
 
 ShardVersionMap RoutingTableHistory::_constructShardVersionMap() const {
-    const OID& epoch = _collectionVersion.epoch();
-
-    ShardVersionMap shardVersions;
-    ChunkInfoMap::const_iterator current = _chunkMap.cbegin();
-
-    boost::optional<BSONObj> firstMin = boost::none;
-    boost::optional<BSONObj> lastMax = boost::none;
-
-    while (current != _chunkMap.cend()) {
-        const auto& firstChunkInRange = current->second;
-        const auto& currentRangeShardId = firstChunkInRange->getShardIdAt(boost::none);
-
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(currentRangeShardId);
-        if (shardVersionIt == shardVersions.end()) {
-            shardVersionIt =
-                shardVersions.emplace(currentRangeShardId, ChunkVersion(0, 0, epoch)).first;
-        }
-
-        auto& maxShardVersion = shardVersionIt->second;
-
-        current =
-            std::find_if(current,
-                         _chunkMap.cend(),
-                         [&currentRangeShardId,
-                          &maxShardVersion](const ChunkInfoMap::value_type& chunkMapEntry) {
-                             const auto& currentChunk = chunkMapEntry.second;
-
-                             if (currentChunk->getShardIdAt(boost::none) != currentRangeShardId)
-                                 return true;
-
-                             if (currentChunk->getLastmod() > maxShardVersion)
-                                 maxShardVersion = currentChunk->getLastmod();
-
-                             return false;
-                         });
-
-        const auto rangeLast = std::prev(current);
-
-        const auto& rangeMin = firstChunkInRange->getMin();
-        const auto& rangeMax = rangeLast->second->getMax();
-
-        // Check the continuity of the chunks map
-        if (lastMax && !SimpleBSONObjComparator::kInstance.evaluate(*lastMax == rangeMin)) {
-            if (SimpleBSONObjComparator::kInstance.evaluate(*lastMax < rangeMin))
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream()
-                              << "Gap exists in the routing table between chunks "
-                              << _chunkMap.at(_extractKeyString(*lastMax))->getRange().toString()
-                              << " and "
-                              << rangeLast->second->getRange().toString());
-            else
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream()
-                              << "Overlap exists in the routing table between chunks "
-                              << _chunkMap.at(_extractKeyString(*lastMax))->getRange().toString()
-                              << " and "
-                              << rangeLast->second->getRange().toString());
-        }
-
-        if (!firstMin)
-            firstMin = rangeMin;
-
-        lastMax = rangeMax;
-
-        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
-        // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
-    }
-
-    if (!_chunkMap.empty()) {
-        invariant(!shardVersions.empty());
-        invariant(firstMin.is_initialized());
-        invariant(lastMax.is_initialized());
-
-        checkAllElementsAreOfType(MinKey, firstMin.get());
-        checkAllElementsAreOfType(MaxKey, lastMax.get());
-    }
-
-    return shardVersions;
+    return _chunkMap.constructShardVersionMap(_collectionVersion.epoch());
 }
 
 std::string RoutingTableHistory::_extractKeyString(const BSONObj& shardKeyValue) const {
@@ -29,6 +29,9 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <iterator>
 #include <map>
 #include <set>
 #include <string>
@@ -40,6 +43,8 @@
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/shard_key_pattern.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/ticketholder.h"
 
 namespace mongo {
@@ -49,12 +54,165 @@ struct QuerySolutionNode;
 class OperationContext;
 class ChunkManager;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
-
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
 
+/**
+ * Ordered map from the max KeyString for each chunk to an entry describing the chunk.
+ *
+ * The entries are kept sorted in pages of up to kMaxPageSize entries, which copies of the map
+ * share. Copying the map copies only the pointers to its pages, and changing a copy copies only the
+ * pages it changes, so that the routing table of a refresh with a few changed chunks does not have
+ * to copy every chunk of the collection.
+ *
+ * Each page also keeps the first 8 bytes of each of its keys as an integer, so that lookups do a
+ * branchless binary search on integers and compare whole KeyStrings only among equal prefixes.
+ */
+class ChunkInfoMap {
+public:
+    using value_type = std::pair<std::string, std::shared_ptr<ChunkInfo>>;
+
+    // A page which grows past this size is split in two.
+    static constexpr std::size_t kMaxPageSize = 1024;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ChunkInfoMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return _map->_pages[_page]->entries[_offset];
+        }
+        pointer operator->() const {
+            return &**this;
+        }
+
+        const_iterator& operator++() {
+            if (++_offset == _map->_pages[_page]->entries.size()) {
+                ++_page;
+                _offset = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+        const_iterator& operator--() {
+            if (_offset == 0) {
+                --_page;
+                _offset = _map->_pages[_page]->entries.size();
+            }
+            --_offset;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            auto it = *this;
+            --*this;
+            return it;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _page == other._page && _offset == other._offset;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class ChunkInfoMap;
+
+        const_iterator(const ChunkInfoMap* map, std::size_t page, std::size_t offset)
+            : _map(map), _page(page), _offset(offset) {}
+
+        const ChunkInfoMap* _map = nullptr;
+        std::size_t _page = 0;
+        std::size_t _offset = 0;
+    };
+    using iterator = const_iterator;
+
+    const_iterator begin() const {
+        return {this, 0, 0};
+    }
+    const_iterator end() const {
+        return {this, _pages.size(), 0};
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+    std::size_t size() const {
+        return _size;
+    }
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Return the first chunk whose key is greater than 'keyString', or not less than it.
+     */
+    const_iterator upper_bound(const std::string& keyString) const;
+    const_iterator lower_bound(const std::string& keyString) const;
+
+    /**
+     * Inserts 'entry', whose key must not be in the map yet.
+     */
+    void insert(value_type entry);
+
+    /**
+     * Removes the chunks in [first, last), which are iterators of this map.
+     */
+    void erase(const_iterator first, const_iterator last);
+
+    /**
+     * Returns the maximum chunk version on each shard which owns chunks in the map, and checks
+     * that the chunks cover the key space from MinKey to MaxKey without gaps or overlaps. Throws
+     * ConflictingOperationInProgress if they do not.
+     *
+     * The result for each page is kept in the page, so that for a map changed from another only
+     * the changed pages are examined one chunk at a time. This must be called before the map is
+     * shared with other threads.
+     */
+    ShardVersionMap constructShardVersionMap(const OID& epoch) const;
+
+private:
+    struct Page {
+        std::vector<std::uint64_t> prefixes;
+        std::vector<value_type> entries;
+
+        // The maximum chunk version of each shard with chunks in the page, once computed by
+        // constructShardVersionMap().
+        mutable boost::optional<ShardVersionMap> shardVersions;
+    };
+
+    /**
+     * Returns the page at 'pageIndex', after copying it if other maps share it.
+     */
+    Page& _mutablePage(std::size_t pageIndex);
+
+    /**
+     * Refreshes the prefix of the max of the page at 'pageIndex', or removes the page if it has
+     * become empty.
+     */
+    void _pageChanged(std::size_t pageIndex);
+
+    std::vector<std::shared_ptr<Page>> _pages;
+
+    // The prefix of the max key of each page, to search for a page in the same way as in a page.
+    std::vector<std::uint64_t> _pageMaxPrefixes;
+
+    std::size_t _size = 0;
+};
+
 /**
  * In-memory representation of the routing table for a single sharded collection at various points
  * in time.
@@ -160,12 +318,28 @@ private:
                         ChunkVersion collectionVersion);
 
     /**
-     * Does a single pass over the chunkMap and constructs the ShardVersionMap object.
+     * Constructs the ShardVersionMap object from the chunkMap, which also checks its continuity.
      */
     ShardVersionMap _constructShardVersionMap() const;
 
     std::string _extractKeyString(const BSONObj& shardKeyValue) const;
 
+    /**
+     * Looks up the shards targeted by the query whose cache key is 'cacheKey', and if the result
+     * is cached, adds them to 'shardIds' and returns true.
+     */
+    bool _findCachedShardIdsForQuery(const std::string& cacheKey,
+                                     std::set<ShardId>* shardIds) const;
+
+    /**
+     * Caches 'shardIds' as the shards targeted by the query whose cache key is 'cacheKey'. The
+     * cache is emptied when it would grow beyond kMaxQueryTargetingCacheBytes.
+     */
+    void _cacheShardIdsForQuery(std::string cacheKey, const std::set<ShardId>& shardIds) const;
+
+    // The maximum total size of the keys of the query targeting cache.
+    static constexpr std::size_t kMaxQueryTargetingCacheBytes = 4 * 1024 * 1024;
+
     // The shard versioning mechanism hinges on keeping track of the number of times we reload
     // ChunkManagers.
     const unsigned long long _sequenceNumber;
@@ -198,6 +372,12 @@ private:
     // chunks, it won't be present in this map.
     const ShardVersionMap _shardVersions;
 
+    // Cache of the shards targeted by queries, keyed by the bytes of the query and collation. Since
+    // a routing table never changes, the cached results stay valid for as long as it is in use.
+    mutable stdx::mutex _queryTargetingCacheMutex;
+    mutable stdx::unordered_map<std::string, std::set<ShardId>> _queryTargetingCache;
+    mutable std::size_t _queryTargetingCacheBytes{0};
+
     friend class ChunkManager;
 };
 
@@ -337,6 +517,14 @@ public:
         return findIntersectingChunk(shardKey, CollationSpec::kSimpleSpec);
     }
 
+    /**
+     * Same as findIntersectingChunkWithSimpleCollation for each of "shardKeys", and returns the
+     * chunks in the same order. The keys are looked up in sorted order, so that a key which falls
+     * in the same chunk as the key before it does not search the routing table again.
+     */
+    std::vector<Chunk> findIntersectingChunksWithSimpleCollation(
+        const std::vector<BSONObj>& shardKeys) const;
+
     /**
      * Finds the shard IDs for a given filter and collation. If collation is empty, we use the
      * collection default collation for targeting.
@@ -404,6 +592,15 @@ public:
     }
 
 private:
+    /**
+     * Computes the shard IDs for a given filter and collation, without consulting the query
+     * targeting cache of the routing table.
+     */
+    void _getShardIdsForQuery(OperationContext* opCtx,
+                              const BSONObj& query,
+                              const BSONObj& collation,
+                              std::set<ShardId>* shardIds) const;
+
     std::shared_ptr<RoutingTableHistory> _rt;
     boost::optional<Timestamp> _clusterTime;
 };
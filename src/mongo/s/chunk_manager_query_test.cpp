@@ -385,6 +385,40 @@ TEST_F(ChunkManagerQueryTest, InMultiShard) {
                  {ShardId("0"), ShardId("1"), ShardId("2")});
 }
 
+TEST_F(ChunkManagerQueryTest, InWithPointsAndRangesMultiShard) {
+    runQueryTest(BSON("a" << 1),
+                 nullptr,
+                 false,
+                 {BSON("a" << -100), BSON("a" << 0), BSON("a" << 100)},
+                 BSON("$or" << BSON_ARRAY(BSON("a" << BSON("$in" << BSON_ARRAY(-150 << -120)))
+                                          << BSON("a" << BSON("$gte" << 10 << "$lt" << 20)))),
+                 BSONObj(),
+                 {ShardId("0"), ShardId("2")});
+}
+
+TEST_F(ChunkManagerQueryTest, RepeatedQueryIsTargetedTheSameWay) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(kNss,
+                                         shardKeyPattern,
+                                         nullptr,
+                                         false,
+                                         {BSON("a" << -100), BSON("a" << 0), BSON("a" << 100)});
+
+    BSONArrayBuilder inBuilder;
+    for (int i = -50; i < 50; ++i) {
+        inBuilder.append(i);
+    }
+    const auto query = BSON("a" << BSON("$in" << inBuilder.arr()));
+
+    for (int i = 0; i < 2; ++i) {
+        std::set<ShardId> shardIds;
+        chunkManager->getShardIdsForQuery(operationContext(), query, BSONObj(), &shardIds);
+        ASSERT_EQ(2U, shardIds.size());
+        ASSERT_EQ(1U, shardIds.count(ShardId("1")));
+        ASSERT_EQ(1U, shardIds.count(ShardId("2")));
+    }
+}
+
 TEST_F(ChunkManagerQueryTest, CollationStringsMultiShard) {
     runQueryTest(BSON("a" << 1),
                  nullptr,
@@ -488,5 +522,83 @@ TEST_F(ChunkManagerQueryTest, SimpleCollationNumbersMultiShard) {
         {ShardId("0")});
 }
 
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunkForBoundsWithTheSamePrefix) {
+    // The split points share more than their first 8 KeyString bytes, so that targeting has to
+    // compare whole bounds to tell the chunks apart.
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(kNss,
+                                         shardKeyPattern,
+                                         nullptr,
+                                         false,
+                                         {BSON("a"
+                                               << "user000000000001"),
+                                          BSON("a"
+                                               << "user000000000002"),
+                                          BSON("a"
+                                               << "user000000000003")});
+
+    const auto shardIdForKey = [&](const BSONObj& shardKey) {
+        return chunkManager->findIntersectingChunkWithSimpleCollation(shardKey).getShardId();
+    };
+    ASSERT_EQ(ShardId("0"), shardIdForKey(BSON("a" << 5)));
+    ASSERT_EQ(ShardId("0"),
+              shardIdForKey(BSON("a"
+                                 << "user000000000000")));
+    ASSERT_EQ(ShardId("1"),
+              shardIdForKey(BSON("a"
+                                 << "user000000000001")));
+    ASSERT_EQ(ShardId("1"),
+              shardIdForKey(BSON("a"
+                                 << "user0000000000015")));
+    ASSERT_EQ(ShardId("2"),
+              shardIdForKey(BSON("a"
+                                 << "user000000000002")));
+    ASSERT_EQ(ShardId("3"),
+              shardIdForKey(BSON("a"
+                                 << "user000000000003")));
+    ASSERT_EQ(ShardId("3"), shardIdForKey(BSON("a" << BSON("b" << 1))));
+
+    runGetShardIdsForRangeTest(BSON("a" << 1),
+                               false,
+                               {BSON("a"
+                                     << "user000000000001"),
+                                BSON("a"
+                                     << "user000000000002"),
+                                BSON("a"
+                                     << "user000000000003")},
+                               BSON("a"
+                                    << "user0000000000015"),
+                               BSON("a"
+                                    << "user000000000002"),
+                               {ShardId("1"), ShardId("2")});
+}
+
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunksReturnsChunksInTheOrderOfTheKeys) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(kNss,
+                                         shardKeyPattern,
+                                         nullptr,
+                                         false,
+                                         {BSON("a" << -100), BSON("a" << 0), BSON("a" << 100)});
+
+    const std::vector<BSONObj> shardKeys{BSON("a" << 150),
+                                         BSON("a" << -150),
+                                         BSON("a" << 0),
+                                         BSON("a" << -1),
+                                         BSON("a" << 150),
+                                         BSON("a" << 100),
+                                         BSON("a" << -100)};
+    const auto chunks = chunkManager->findIntersectingChunksWithSimpleCollation(shardKeys);
+    ASSERT_EQ(shardKeys.size(), chunks.size());
+    for (size_t i = 0; i < shardKeys.size(); ++i) {
+        ASSERT_EQ(chunkManager->findIntersectingChunkWithSimpleCollation(shardKeys[i]).getShardId(),
+                  chunks[i].getShardId());
+    }
+    ASSERT_EQ(ShardId("3"), chunks[0].getShardId());
+    ASSERT_EQ(ShardId("0"), chunks[1].getShardId());
+    ASSERT_EQ(ShardId("2"), chunks[2].getShardId());
+    ASSERT_EQ(ShardId("1"), chunks[3].getShardId());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -51,6 +51,28 @@ bool ChunkWritesTracker::shouldSplit(uint64_t maxChunkSize) {
     return getBytesWritten() > maxChunkSize / ChunkWritesTracker::kSplitTestFactor;
 }
 
+void ChunkWritesTracker::sampleKey(const BSONObj& shardKey) {
+    stdx::lock_guard<stdx::mutex> lk(_sampleMutex);
+
+    // Reservoir sampling: the n-th key written replaces a random sampled key with probability
+    // kMaxSampledKeys / n, so that every key written so far is equally likely to be in the sample.
+    const auto n = ++_numKeysSeen;
+    if (_sampledKeys.size() < kMaxSampledKeys) {
+        _sampledKeys.push_back(shardKey.getOwned());
+        return;
+    }
+
+    const auto slot = static_cast<uint64_t>(_random.nextInt64(n));
+    if (slot < kMaxSampledKeys) {
+        _sampledKeys[slot] = shardKey.getOwned();
+    }
+}
+
+std::vector<BSONObj> ChunkWritesTracker::getSampledKeys() const {
+    stdx::lock_guard<stdx::mutex> lk(_sampleMutex);
+    return _sampledKeys;
+}
+
 bool ChunkWritesTracker::acquireSplitLock() {
     stdx::lock_guard<stdx::mutex> lk(_mtx);
 
@@ -29,7 +29,11 @@
 
 #pragma once
 
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/random.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
@@ -42,6 +46,11 @@ public:
      */
     static constexpr uint64_t kSplitTestFactor = 5;
 
+    /**
+     * The maximum number of shard keys of written documents kept as a sample for the chunk.
+     */
+    static constexpr size_t kMaxSampledKeys = 100;
+
     /**
      * Add more bytes written to the chunk.
      */
@@ -68,6 +77,17 @@ public:
      */
     bool shouldSplit(uint64_t maxChunkSize);
 
+    /**
+     * Adds the shard key of a written document to the uniform sample of the shard keys written to
+     * the chunk, which holds at most kMaxSampledKeys keys.
+     */
+    void sampleKey(const BSONObj& shardKey);
+
+    /**
+     * Returns the current sample of the shard keys written to the chunk, in no particular order.
+     */
+    std::vector<BSONObj> getSampledKeys() const;
+
     /**
      * Locks the chunk for splitting, returning false if it is already locked.
      * While it is locked, shouldSplit will always return false.
@@ -91,6 +111,23 @@ private:
      */
     stdx::mutex _mtx;
 
+    /**
+     * Protects the sample of written shard keys and the state used to draw it.
+     */
+    mutable stdx::mutex _sampleMutex;
+
+    /**
+     * A reservoir sample of the shard keys written to the chunk, and the number of keys which have
+     * been offered to it.
+     */
+    std::vector<BSONObj> _sampledKeys;
+    uint64_t _numKeysSeen{0};
+
+    /**
+     * Chooses which sampled key a newly written key replaces.
+     */
+    PseudoRandom _random{int64_t{0}};
+
     /**
      * Whether or not a current split is in progress for this chunk.
      */
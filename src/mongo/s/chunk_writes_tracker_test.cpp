@@ -31,6 +31,8 @@
 
 #include "mongo/s/chunk_writes_tracker.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
+
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 
@@ -64,6 +66,23 @@ TEST(ChunkWritesTrackerTest, ClearBytesWrittenReturnsBytesWrittenBeforeClearing)
     ASSERT_EQ(previousBytesWritten, bytesToAdd);
 }
 
+TEST(ChunkWritesTrackerTest, SampledKeysAreBoundedAndComeFromTheWrittenKeys) {
+    ChunkWritesTracker wt;
+    ASSERT(wt.getSampledKeys().empty());
+
+    const int numKeys = 10 * ChunkWritesTracker::kMaxSampledKeys;
+    for (int i = 0; i < numKeys; ++i) {
+        wt.sampleKey(BSON("x" << i));
+    }
+
+    const auto sampledKeys = wt.getSampledKeys();
+    ASSERT_EQ(sampledKeys.size(), ChunkWritesTracker::kMaxSampledKeys);
+    for (const auto& key : sampledKeys) {
+        ASSERT_GTE(key["x"].numberInt(), 0);
+        ASSERT_LT(key["x"].numberInt(), numKeys);
+    }
+}
+
 TEST(ChunkWritesTrackerTest, ShouldSplitReturnsTrueWithBytesWrittenAndMaxChunkSizeZero) {
     ChunkWritesTracker wt;
     wt.addBytesWritten(4ull);
@@ -36,6 +36,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/query/cursor_response.h"
+#include "mongo/db/query/find_common.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/views/resolved_view.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -217,6 +218,7 @@ public:
                     ClusterFind::runQuery(opCtx, *cq, ReadPreferenceSetting::get(opCtx), &batch);
 
                 // Build the response document.
+                result->reserveBytes(FindCommon::replyBytesForBatch(batch));
                 CursorResponseBuilder::Options options;
                 options.isInitialResponse = true;
                 CursorResponseBuilder firstBatch(result, options);
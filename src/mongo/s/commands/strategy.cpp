@@ -76,9 +76,11 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
 #include "mongo/s/query/cluster_find.h"
+#include "mongo/s/query/cluster_query_knobs_gen.h"
 #include "mongo/s/session_catalog_router.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/s/transaction_router.h"
+#include "mongo/stdx/unordered_set.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -90,6 +92,9 @@ namespace {
 
 const auto kOperationTime = "operationTime"_sd;
 
+// The ids of the cursors which stream their batches to this client with the exhaust option
+const auto getExhaustCursorIds = Client::declareDecoration<stdx::unordered_set<CursorId>>();
+
 /**
  * Extract and process metadata from the command request body.
  */
@@ -599,6 +604,22 @@ void runCommand(OperationContext* opCtx,
     }
 }
 
+/**
+ * Appends the documents of 'batch' to the results of 'reply', whose buffer is grown to fit all of
+ * them up front, and returns how many there are.
+ */
+int appendBatchToReply(const std::vector<BSONObj>& batch, OpQueryReplyBuilder* reply) {
+    auto& buffer = reply->bufBuilderForResults();
+    const int bytes = FindCommon::replyBytesForBatch(batch);
+    buffer.reserveBytes(bytes);
+    buffer.claimReservedBytes(bytes);
+
+    for (const auto& obj : batch) {
+        buffer.appendBuf(obj.objdata(), obj.objsize());
+    }
+    return batch.size();
+}
+
 }  // namespace
 
 DbResponse Strategy::queryOp(OperationContext* opCtx, const NamespaceString& nss, DbMessage* dbm) {
@@ -622,7 +643,8 @@ DbResponse Strategy::queryOp(OperationContext* opCtx, const NamespaceString& nss
     LOG(3) << "query: " << q.ns << " " << redact(q.query) << " ntoreturn: " << q.ntoreturn
            << " options: " << q.queryOptions;
 
-    if (q.queryOptions & QueryOption_Exhaust) {
+    const bool exhaust = q.queryOptions & QueryOption_Exhaust;
+    if (exhaust && !internalQueryAllowExhaustOnMongoS.load()) {
         uasserted(18526,
                   str::stream() << "The 'exhaust' query option is invalid for mongos queries: "
                                 << nss.ns()
@@ -691,17 +713,20 @@ DbResponse Strategy::queryOp(OperationContext* opCtx, const NamespaceString& nss
     }
 
     // Fill out the response buffer.
-    int numResults = 0;
     OpQueryReplyBuilder reply;
-    for (auto&& obj : batch) {
-        obj.appendSelfToBufBuilder(reply.bufBuilderForResults());
-        numResults++;
-    }
+    const int numResults = appendBatchToReply(batch, &reply);
 
-    return DbResponse{reply.toQueryReply(0,  // query result flags
-                                         numResults,
-                                         0,  // startingFrom
-                                         cursorId)};
+    DbResponse dbResponse{reply.toQueryReply(0,  // query result flags
+                                             numResults,
+                                             0,  // startingFrom
+                                             cursorId)};
+
+    // Have the service state machine run the getMores of an exhaust cursor on the client's behalf.
+    if (exhaust && cursorId != 0) {
+        getExhaustCursorIds(client).insert(cursorId);
+        dbResponse.exhaustNS = nss.ns();
+    }
+    return dbResponse;
 }
 
 DbResponse Strategy::clientCommand(OperationContext* opCtx, const Message& m) {
@@ -794,6 +819,9 @@ DbResponse Strategy::getMore(OperationContext* opCtx, const NamespaceString& nss
 
     globalOpCounters.gotGetMore();
 
+    auto& exhaustCursorIds = getExhaustCursorIds(opCtx->getClient());
+    const bool exhaust = exhaustCursorIds.erase(cursorId);
+
     // TODO: Handle stale config exceptions here from coll being dropped or sharded during op for
     // now has same semantics as legacy request.
 
@@ -821,20 +849,20 @@ DbResponse Strategy::getMore(OperationContext* opCtx, const NamespaceString& nss
     uassertStatusOK(cursorResponse.getStatus());
 
     // Build the response document.
-    BufBuilder buffer(FindCommon::kInitReplyBufferSize);
+    OpQueryReplyBuilder reply;
+    const int numResults = appendBatchToReply(cursorResponse.getValue().getBatch(), &reply);
 
-    int numResults = 0;
-    for (const auto& obj : cursorResponse.getValue().getBatch()) {
-        buffer.appendBuf((void*)obj.objdata(), obj.objsize());
-        ++numResults;
-    }
+    DbResponse dbResponse{
+        reply.toQueryReply(0,  // query result flags
+                           numResults,
+                           cursorResponse.getValue().getNumReturnedSoFar().value_or(0),
+                           cursorResponse.getValue().getCursorId())};
 
-    return replyToQuery(0,
-                        buffer.buf(),
-                        buffer.len(),
-                        numResults,
-                        cursorResponse.getValue().getNumReturnedSoFar().value_or(0),
-                        cursorResponse.getValue().getCursorId());
+    if (exhaust && cursorResponse.getValue().getCursorId() != 0) {
+        exhaustCursorIds.insert(cursorId);
+        dbResponse.exhaustNS = nss.ns();
+    }
+    return dbResponse;
 }
 
 void Strategy::killCursors(OperationContext* opCtx, DbMessage* dbm) {
@@ -39,6 +39,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/util/assert_util.h"
@@ -79,6 +80,26 @@ int compareSortKeys(BSONObj leftSortKey, BSONObj rightSortKey, BSONObj sortKeyPa
     return leftSortKey.woCompare(rightSortKey, sortKeyPattern, considerFieldName);
 }
 
+/**
+ * Returns the Ordering used to encode sort keys as KeyStrings for the sort pattern 'sort', or
+ * boost::none if there is no sort or if the pattern has more fields than an Ordering can describe.
+ */
+boost::optional<Ordering> makeSortKeyOrdering(const boost::optional<BSONObj>& sort) {
+    if (!sort || static_cast<size_t>(sort->nFields()) > Ordering::kMaxCompoundIndexKeys) {
+        return boost::none;
+    }
+    return Ordering::make(*sort);
+}
+
+/**
+ * Returns the KeyString encoding of 'sortKey' under 'ordering'. Two encoded sort keys compare
+ * bytewise in the same order as compareSortKeys() compares the sort keys themselves.
+ */
+std::string encodeSortKey(const BSONObj& sortKey, Ordering ordering) {
+    KeyString ks(KeyString::Version::V1, sortKey, ordering);
+    return std::string(ks.getBuffer(), ks.getSize());
+}
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
@@ -93,6 +114,7 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       _params(std::move(params)),
       _mergeQueue(MergingComparator(
           _remotes, _params.getSort().value_or(BSONObj()), _params.getCompareWholeSortKey())),
+      _sortKeyOrdering(makeSortKeyOrdering(_params.getSort())),
       _promisedMinSortKeys(PromisedMinSortKeyComparator(_params.getSort().value_or(BSONObj()))) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
@@ -290,7 +312,7 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
@@ -306,12 +328,16 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
 
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
+    if (_sortKeyOrdering) {
+        _remotes[smallestRemote].sortKeyBuffer.pop();
+    }
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
     if (!_remotes[smallestRemote].docBuffer.empty()) {
         _mergeQueue.push(smallestRemote);
     }
+    _prefetchNextBatchIfNeeded(lk, smallestRemote);
 
     // For sorted tailable awaitData cursors, update the high water mark to the document's sort key.
     if (_tailableMode == TailableModeEnum::kTailableAndAwaitData) {
@@ -322,7 +348,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
@@ -339,6 +365,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
                 // the batch.
                 _eofNext = true;
             }
+            _prefetchNextBatchIfNeeded(lk, _gettingFromRemote);
 
             return front;
         }
@@ -589,9 +616,8 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
     if (_params.getAllowPartialResults() || remote.status == ErrorCodes::ExchangePassthrough) {
         remote.status = Status::OK();
 
-        // Clear the results buffer and cursor id.
-        std::queue<ClusterQueryResult> emptyBuffer;
-        std::swap(remote.docBuffer, emptyBuffer);
+        // Clear the cursor id. Results which were buffered ahead of the failed request remain valid
+        // and are still returned.
         remote.cursorId = 0;
     }
 }
@@ -645,7 +671,9 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            size_t remoteIndex,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
+    const bool wasBuffering = remote.hasNext();
     _updateRemoteMetadata(lk, remoteIndex, response);
+    remote.lastBatchSize = response.getBatch().size();
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
         if (_params.getSort()) {
@@ -665,6 +693,10 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                          << obj);
                 return false;
             }
+            if (_sortKeyOrdering) {
+                remote.sortKeyBuffer.push(encodeSortKey(
+                    extractSortKey(obj, _params.getCompareWholeSortKey()), *_sortKeyOrdering));
+            }
         }
 
         ClusterQueryResult result(obj);
@@ -673,13 +705,29 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
     }
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
-    // queue.
-    if (_params.getSort() && !response.getBatch().empty()) {
+    // queue, unless it is already there because results prefetched earlier are still buffered.
+    if (_params.getSort() && !response.getBatch().empty() && !wasBuffering) {
         _mergeQueue.push(remoteIndex);
     }
     return true;
 }
 
+void AsyncResultsMerger::_prefetchNextBatchIfNeeded(WithLock lk, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    if (!internalQueryPrefetchMergedBatches.load() ||
+        _tailableMode != TailableModeEnum::kNormal || _lifecycleState != kAlive || !_opCtx) {
+        return;
+    }
+    if (!remote.status.isOK() || remote.exhausted() || remote.cbHandle.isValid() ||
+        remote.docBuffer.size() * 2 > remote.lastBatchSize) {
+        return;
+    }
+
+    // Be careful only to do this when '_opCtx' is non-null, since it is illegal to schedule a
+    // remote command on a user's behalf without a non-null OperationContext.
+    remote.status = _askForNextBatch(lk, remoteIndex);
+}
+
 void AsyncResultsMerger::_signalCurrentEventIfReady(WithLock lk) {
     if (_ready(lk) && _currentEvent.isValid()) {
         // To prevent ourselves from signalling the event twice, we set '_currentEvent' as
@@ -787,6 +835,12 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 //
 
 bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+    const auto& leftSortKeys = _remotes[lhs].sortKeyBuffer;
+    const auto& rightSortKeys = _remotes[rhs].sortKeyBuffer;
+    if (!leftSortKeys.empty() && !rightSortKeys.empty()) {
+        return leftSortKeys.front() > rightSortKeys.front();
+    }
+
     const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
     const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
 
@@ -31,10 +31,12 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
@@ -292,6 +294,16 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // Used only if there is a sort that can be described by an Ordering. Holds the KeyString
+        // encoding of the sort key of each result in 'docBuffer', in the same order, so that the
+        // merge compares results with a byte comparison rather than by walking their $sortKey
+        // objects.
+        std::queue<std::string> sortKeyBuffer;
+
+        // The number of results in the last batch received from this remote. Used to decide when
+        // to prefetch the next batch.
+        size_t lastBatchSize = 0;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -445,6 +457,13 @@ private:
      */
     void _updateRemoteMetadata(WithLock, size_t remoteIndex, const CursorResponse& response);
 
+    /**
+     * If prefetching is enabled, schedules a getMore for the given remote once a result has been
+     * returned from it and fewer than half of the results of its last batch remain buffered, so
+     * that the next batch arrives before the buffer runs out.
+     */
+    void _prefetchNextBatchIfNeeded(WithLock, size_t remoteIndex);
+
     OperationContext* _opCtx;
     executor::TaskExecutor* _executor;
     TailableModeEnum _tailableMode;
@@ -460,6 +479,11 @@ private:
     // next document to return, according to the sort order. Used only if there is a sort.
     std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
 
+    // The ordering of the sort key pattern, used to encode the sort keys of buffered results as
+    // KeyStrings. Unset if there is no sort, or if the sort pattern has more fields than an
+    // Ordering can describe, in which case results are merged by comparing their $sortKey objects.
+    const boost::optional<Ordering> _sortKeyOrdering;
+
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
     size_t _gettingFromRemote = 0;
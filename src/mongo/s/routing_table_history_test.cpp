@@ -318,5 +318,42 @@ TEST_F(RoutingTableHistoryTestThreeInitialChunks,
                               expectedBytesInChunksNotSplit);
 }
 
+TEST_F(RoutingTableHistoryTest, UpdatingLargeRoutingTableLeavesPreviousRoutingTableUnchanged) {
+    // Enough chunks for the chunk map to keep them in several pages.
+    std::vector<BSONObj> boundaryPoints{getShardKeyPattern().globalMin()};
+    for (int i = 0; i < 3000; ++i) {
+        boundaryPoints.push_back(BSON("a" << i));
+    }
+    boundaryPoints.push_back(getShardKeyPattern().globalMax());
+    auto rt = splitChunk(getInitialRoutingTable(), boundaryPoints);
+    ASSERT_EQ(rt->getChunkMap().size(), 3001ull);
+
+    auto splitRt = splitChunk(rt, {BSON("a" << 1500), BSON("a" << 1500.5), BSON("a" << 1501)});
+    ASSERT_EQ(splitRt->getChunkMap().size(), 3002ull);
+
+    // Merge chunks from several pages into one.
+    auto mergedVersion = splitRt->getVersion();
+    mergedVersion.incMajor();
+    auto mergedRt = splitRt->makeUpdated({ChunkType{
+        kNss, ChunkRange{BSON("a" << 100), BSON("a" << 2900)}, mergedVersion, kThisShard}});
+    ASSERT_EQ(mergedRt->getChunkMap().size(), 202ull);
+
+    for (const auto& table : {rt, splitRt, mergedRt}) {
+        boost::optional<BSONObj> lastMax;
+        for (const auto& entry : table->getChunkMap()) {
+            if (lastMax) {
+                ASSERT_BSONOBJ_EQ(*lastMax, entry.second->getMin());
+            }
+            lastMax = entry.second->getMax();
+        }
+        ASSERT_BSONOBJ_EQ(getShardKeyPattern().globalMax(), *lastMax);
+    }
+
+    const auto merged = mergedRt->overlappingRanges(BSON("a" << 99), BSON("a" << 2900), false);
+    ASSERT_EQ(std::distance(merged.first, merged.second), 2);
+    ASSERT_BSONOBJ_EQ(BSON("a" << 100), std::next(merged.first)->second->getMin());
+    ASSERT_EQ(mergedVersion, mergedRt->getVersion(kThisShard));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -31,6 +31,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cmath>
+
 #include "mongo/client/replica_set_monitor.h"
 #include "mongo/s/sharding_task_executor_pool_controller.h"
 #include "mongo/util/log.h"
@@ -153,7 +155,21 @@ auto ShardingTaskExecutorPoolController::updateHost(const SpecificPool* pool,
     const size_t maxConns = gParameters.maxConnections.load();
 
     // Update the target for just the pool first
-    data.target = stats.requests + stats.active;
+    const auto demand = stats.requests + stats.active;
+    data.target = demand;
+
+    // Keep connections for the recent peak of demand, which decays by half every half-life
+    const auto halfLifeMS = gParameters.recentDemandHalfLifeMS.load();
+    if (halfLifeMS > 0) {
+        const auto now = Date_t::now();
+        if (data.recentDemandUpdated != Date_t()) {
+            const auto elapsedMS = durationCount<Milliseconds>(now - data.recentDemandUpdated);
+            data.recentDemand *= std::exp2(-double(elapsedMS) / halfLifeMS);
+        }
+        data.recentDemandUpdated = now;
+        data.recentDemand = std::max(data.recentDemand, double(demand));
+        data.target = std::max(data.target, size_t(std::lround(data.recentDemand)));
+    }
 
     if (data.target < minConns) {
         data.target = minConns;
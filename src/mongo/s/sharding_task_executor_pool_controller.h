@@ -85,6 +85,8 @@ public:
         AtomicWord<int> pendingTimeoutMS;
         AtomicWord<int> toRefreshTimeoutMS;
 
+        AtomicWord<int> recentDemandHalfLifeMS;
+
         synchronized_value<std::string> matchingStrategyString;
         AtomicWord<MatchingStrategy> matchingStrategy;
     };
@@ -171,6 +173,10 @@ private:
         // The number of connections the host should maintain
         size_t target = 0;
 
+        // The peak of requests plus active connections, decayed to the time it was last updated
+        double recentDemand = 0;
+        Date_t recentDemandUpdated;
+
         // This host is able to shutdown
         bool isAbleToShutdown = false;
     };
@@ -301,6 +301,27 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
+    // The inserts of an unordered batch are targeted all at once, which lets the targeter walk the
+    // routing table once for the whole batch. Ordered batches usually stop at the first insert for
+    // another shard, so they keep targeting one insert at a time.
+    std::vector<boost::optional<StatusWith<ShardEndpoint>>> insertEndpoints;
+    if (!ordered && _clientRequest.getBatchType() == BatchedCommandRequest::BatchType_Insert) {
+        std::vector<BSONObj> docs;
+        std::vector<size_t> docWriteOpIndexes;
+        for (size_t i = 0; i < numWriteOps; ++i) {
+            if (_writeOps[i].getWriteState() == WriteOpState_Ready) {
+                docs.push_back(_writeOps[i].getWriteItem().getDocument());
+                docWriteOpIndexes.push_back(i);
+            }
+        }
+
+        auto swEndpoints = targeter.targetInserts(_opCtx, docs);
+        insertEndpoints.resize(numWriteOps);
+        for (size_t i = 0; i < docWriteOpIndexes.size(); ++i) {
+            insertEndpoints[docWriteOpIndexes[i]] = std::move(swEndpoints[i]);
+        }
+    }
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -316,7 +337,9 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        Status targetStatus = !insertEndpoints.empty()
+            ? writeOp.targetWrites(_opCtx, targeter, std::move(*insertEndpoints[i]), &writes)
+            : writeOp.targetWrites(_opCtx, targeter, &writes);
 
         if (!targetStatus.isOK()) {
             WriteErrorDetail targetError;
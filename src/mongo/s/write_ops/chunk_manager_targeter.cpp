@@ -410,6 +410,49 @@ StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* o
     return Status::OK();
 }
 
+std::vector<StatusWith<ShardEndpoint>> ChunkManagerTargeter::targetInserts(
+    OperationContext* opCtx, const std::vector<BSONObj>& docs) const {
+    if (!_routingInfo->cm()) {
+        return NSTargeter::targetInserts(opCtx, docs);
+    }
+
+    const auto& cm = _routingInfo->cm();
+
+    // The documents without a valid shard key are left to targetInsert(), which reports why.
+    std::vector<BSONObj> shardKeys;
+    std::vector<std::size_t> shardKeyDocIndexes;
+    shardKeys.reserve(docs.size());
+    shardKeyDocIndexes.reserve(docs.size());
+    for (std::size_t i = 0; i < docs.size(); ++i) {
+        auto shardKey = cm->getShardKeyPattern().extractShardKeyFromDoc(docs[i]);
+        if (!shardKey.isEmpty() && ShardKeyPattern::checkShardKeySize(shardKey).isOK()) {
+            shardKeys.push_back(std::move(shardKey));
+            shardKeyDocIndexes.push_back(i);
+        }
+    }
+
+    boost::optional<std::vector<Chunk>> chunks;
+    try {
+        chunks = cm->findIntersectingChunksWithSimpleCollation(shardKeys);
+    } catch (const DBException&) {
+        // Target each document on its own, so that only the ones which fail get an error.
+        shardKeyDocIndexes.clear();
+    }
+
+    std::vector<StatusWith<ShardEndpoint>> endpoints;
+    endpoints.reserve(docs.size());
+    std::size_t nextShardKey = 0;
+    for (std::size_t i = 0; i < docs.size(); ++i) {
+        if (nextShardKey < shardKeyDocIndexes.size() && shardKeyDocIndexes[nextShardKey] == i) {
+            const auto& shardId = (*chunks)[nextShardKey++].getShardId();
+            endpoints.push_back(ShardEndpoint(shardId, cm->getVersion(shardId)));
+        } else {
+            endpoints.push_back(targetInsert(opCtx, docs[i]));
+        }
+    }
+    return endpoints;
+}
+
 StatusWith<std::vector<ShardEndpoint>> ChunkManagerTargeter::targetUpdate(
     OperationContext* opCtx, const write_ops::UpdateOpEntry& updateDoc) const {
     //
@@ -71,6 +71,28 @@ Status WriteOp::targetWrites(OperationContext* opCtx,
         }
     }();
 
+    return _addTargetedWrites(opCtx, targeter, std::move(swEndpoints), targetedWrites);
+}
+
+Status WriteOp::targetWrites(OperationContext* opCtx,
+                             const NSTargeter& targeter,
+                             StatusWith<ShardEndpoint> swInsertEndpoint,
+                             std::vector<TargetedWrite*>* targetedWrites) {
+    invariant(_itemRef.getOpType() == BatchedCommandRequest::BatchType_Insert);
+    if (!swInsertEndpoint.isOK()) {
+        return swInsertEndpoint.getStatus();
+    }
+
+    return _addTargetedWrites(opCtx,
+                              targeter,
+                              std::vector<ShardEndpoint>{std::move(swInsertEndpoint.getValue())},
+                              targetedWrites);
+}
+
+Status WriteOp::_addTargetedWrites(OperationContext* opCtx,
+                                   const NSTargeter& targeter,
+                                   StatusWith<std::vector<ShardEndpoint>> swEndpoints,
+                                   std::vector<TargetedWrite*>* targetedWrites) {
     // Unless executing as part of a transaction, if we're targeting more than one endpoint with an
     // update/delete, we have to target everywhere since we cannot currently retry partial results.
     //
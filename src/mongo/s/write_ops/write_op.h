@@ -122,6 +122,15 @@ public:
                         const NSTargeter& targeter,
                         std::vector<TargetedWrite*>* targetedWrites);
 
+    /**
+     * Same as above for an insert which the caller has already targeted, as one of a batch
+     * targeted with NSTargeter::targetInserts().
+     */
+    Status targetWrites(OperationContext* opCtx,
+                        const NSTargeter& targeter,
+                        StatusWith<ShardEndpoint> swInsertEndpoint,
+                        std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Returns the number of child writes that were last targeted.
      */
@@ -160,6 +169,14 @@ public:
     void setOpError(const WriteErrorDetail& error);
 
 private:
+    /**
+     * Creates the TargetedWrite operations for the endpoints returned by the targeter.
+     */
+    Status _addTargetedWrites(OperationContext* opCtx,
+                              const NSTargeter& targeter,
+                              StatusWith<std::vector<ShardEndpoint>> swEndpoints,
+                              std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Updates the op state after new information is received.
      */
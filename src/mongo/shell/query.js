@@ -37,7 +37,7 @@ DBQuery.prototype.help = function() {
         "\t.count(<applySkipLimit>) - total # of objects matching query. by default ignores skip,limit");
     print("\t.size() - total # of objects cursor would return, honors skip,limit");
     print(
-        "\t.explain(<verbosity>) - accepted verbosities are {'queryPlanner', 'executionStats', 'allPlansExecution'}");
+        "\t.explain(<verbosity>) - accepted verbosities are {'queryPlanner', 'executionStats', 'allPlansExecution', 'executionStatsDetailed'}");
     print("\t.min({...})");
     print("\t.max({...})");
     print("\t.maxTimeMS(<n>)");
@@ -63,6 +63,7 @@
 #include "mongo/base/environment_buffer.h"
 #include "mongo/client/dbclient_connection.h"
 #include "mongo/db/traffic_reader.h"
+#include "mongo/db/traffic_replay.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/shell/shell_options.h"
 #include "mongo/shell/shell_utils.h"
@@ -1067,6 +1068,28 @@ BSONObj ConvertTrafficRecordingToBSON(const BSONObj& a, void* data) {
     return BSON("" << arr);
 }
 
+BSONObj ReplayTrafficRecording(const BSONObj& a, void* data) {
+    int nFields = a.nFields();
+    uassert(ErrorCodes::FailedToParse, "wrong number of arguments", nFields == 2 || nFields == 3);
+
+    BSONObjIterator it(a);
+    auto inputFile = it.next().String();
+
+    TrafficReplayOptions options;
+    options.target = uassertStatusOK(HostAndPort::parse(it.next().String()));
+    if (it.more()) {
+        auto optionsObj = it.next().Obj();
+        if (auto speed = optionsObj["speed"]) {
+            options.speed = speed.numberDouble();
+        }
+        if (auto connections = optionsObj["connections"]) {
+            options.numConnections = connections.numberInt();
+        }
+    }
+
+    return BSON("" << replayTrafficRecording(inputFile, options));
+}
+
 int KillMongoProgramInstances() {
     vector<ProcessId> pids;
     registry.getRegisteredPids(pids);
@@ -1119,6 +1142,7 @@ void installShellUtilsLauncher(Scope& scope) {
     scope.injectNative("pathExists", PathExists);
     scope.injectNative("copyDbpath", CopyDbpath);
     scope.injectNative("convertTrafficRecordingToBSON", ConvertTrafficRecordingToBSON);
+    scope.injectNative("replayTrafficRecording", ReplayTrafficRecording);
 }
 }  // namespace shell_utils
 }  // namespace mongo
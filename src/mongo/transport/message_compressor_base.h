@@ -42,6 +42,7 @@ enum class MessageCompressor : uint8_t {
     kSnappy = 1,
     kZlib = 2,
     kZstd = 3,
+    kZstdDict = 4,
     kExtended = 255,
 };
 
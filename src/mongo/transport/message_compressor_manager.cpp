@@ -33,11 +33,14 @@
 
 #include "mongo/transport/message_compressor_manager.h"
 
+#include <vector>
+
 #include "mongo/base/data_range_cursor.h"
 #include "mongo/base/data_type_endian.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/rpc/message.h"
+#include "mongo/transport/message_compressor_manager_gen.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/session.h"
 #include "mongo/util/log.h"
@@ -72,6 +75,15 @@ struct CompressionHeader {
     }
 };
 
+/**
+ * Returns whether 'compressor' shrinks 'sample' by at least an eighth.
+ */
+bool isCompressible(MessageCompressorBase* compressor, ConstDataRange sample) {
+    std::vector<char> scratch(compressor->getMaxCompressedSize(sample.length()));
+    auto sws = compressor->compressData(sample, DataRange(scratch.data(), scratch.size()));
+    return sws.isOK() && sws.getValue() <= sample.length() - sample.length() / 8;
+}
+
 const transport::Session::Decoration<MessageCompressorManager> getForSession =
     transport::Session::declareDecoration<MessageCompressorManager>();
 }  // namespace
@@ -95,9 +107,28 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
         return {msg};
     }
 
+    auto inputHeader = msg.header();
+
+    const auto minBytes = gNetworkMessageCompressionMinBytes.load();
+    if (inputHeader.dataLen() < minBytes) {
+        LOG(3) << "Message is smaller than " << minBytes
+               << " bytes, returning original uncompressed message";
+        return {msg};
+    }
+
+    // The end of a message holds its payload rather than the names of its command's fields.
+    const auto sampleBytes = gNetworkMessageCompressionSampleBytes.load();
+    if (sampleBytes > 0 && inputHeader.dataLen() / 2 > sampleBytes &&
+        !isCompressible(compressor,
+                        ConstDataRange(inputHeader.data() + inputHeader.dataLen() - sampleBytes,
+                                       sampleBytes))) {
+        LOG(3) << "Message does not compress with " << compressor->getName()
+               << ", returning original uncompressed message";
+        return {msg};
+    }
+
     LOG(3) << "Compressing message with " << compressor->getName();
 
-    auto inputHeader = msg.header();
     size_t bufferSize = compressor->getMaxCompressedSize(msg.dataSize()) +
         CompressionHeader::size() + MsgData::MsgDataHeaderSize;
 
@@ -97,7 +97,9 @@ public:
      * parameter value for compressorId from a call to decompressMessage.
      *
      * If _negotiated is empty (meaning compression was not negotiated or is not supported), then
-     * it will return a ref-count bumped copy of the input message.
+     * it will return a ref-count bumped copy of the input message. It also does so for messages
+     * smaller than networkMessageCompressionMinBytes, and for those whose sample of
+     * networkMessageCompressionSampleBytes hardly compresses.
      *
      * If an error occurs in the compressor, it will return a Status error.
      */
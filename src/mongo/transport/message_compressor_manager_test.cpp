@@ -37,14 +37,18 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/rpc/message.h"
+#include "mongo/platform/random.h"
 #include "mongo/transport/message_compressor_manager.h"
+#include "mongo/transport/message_compressor_manager_gen.h"
 #include "mongo/transport/message_compressor_noop.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_snappy.h"
 #include "mongo/transport/message_compressor_zlib.h"
 #include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/transport/message_compressor_zstd_gen.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -168,8 +172,7 @@ void checkOverflow(std::unique_ptr<MessageCompressorBase> compressor) {
         compressor->decompressData(tooSmallRange, DataRange(scratch.data(), scratch.size())));
 }
 
-Message buildMessage() {
-    const auto data = std::string{"Hello, world!"};
+Message buildMessage(const std::string& data = "Hello, world!") {
     const auto bufferSize = MsgData::MsgDataHeaderSize + data.size();
     auto buf = SharedBuffer::allocate(bufferSize);
     MsgData::View testView(buf.get());
@@ -240,6 +243,58 @@ TEST(ZstdMessageCompressor, Fidelity) {
     checkFidelity(testMessage, std::make_unique<ZstdMessageCompressor>());
 }
 
+TEST(ZstdMessageCompressor, FidelityAtFastLevel) {
+    gZstdCompressionFastLevelMinBytes.store(1);
+    ON_BLOCK_EXIT([] { gZstdCompressionFastLevelMinBytes.store(0); });
+
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, std::make_unique<ZstdMessageCompressor>());
+}
+
+TEST(ZstdDictMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, std::make_unique<ZstdDictMessageCompressor>("Hello, world!"));
+}
+
+TEST(ZstdDictMessageCompressor, CompressesWithDictionary) {
+    const std::string data = "{insert: 'coll', documents: [{_id: 1, name: 'value'}]}";
+    ZstdMessageCompressor plain;
+    ZstdDictMessageCompressor withDictionary(data);
+    ConstDataRange input(data.data(), data.size());
+
+    std::vector<char> plainBuffer(plain.getMaxCompressedSize(data.size()));
+    auto plainSize =
+        assertOk(plain.compressData(input, DataRange(plainBuffer.data(), plainBuffer.size())));
+    std::vector<char> buffer(withDictionary.getMaxCompressedSize(data.size()));
+    auto size =
+        assertOk(withDictionary.compressData(input, DataRange(buffer.data(), buffer.size())));
+    ASSERT_LT(size, plainSize);
+
+    std::string scratch(data.size(), '\0');
+    ASSERT_EQ(data.size(),
+              assertOk(withDictionary.decompressData(ConstDataRange(buffer.data(), size),
+                                                     DataRange(&scratch[0], scratch.size()))));
+    ASSERT_EQ(data, scratch);
+}
+
+TEST(ZstdDictMessageCompressor, FailsWithAnotherDictionary) {
+    const std::string data = "{insert: 'coll', documents: [{_id: 1, name: 'value'}]}";
+    ZstdDictMessageCompressor compressor(data);
+    ZstdDictMessageCompressor other("{update: 'coll', updates: [{q: {_id: 1}, u: {x: 1}}]}");
+    ConstDataRange input(data.data(), data.size());
+
+    std::vector<char> buffer(compressor.getMaxCompressedSize(data.size()));
+    auto size = assertOk(compressor.compressData(input, DataRange(buffer.data(), buffer.size())));
+
+    std::string scratch(data.size(), '\0');
+    ASSERT_NOT_OK(other.decompressData(ConstDataRange(buffer.data(), size),
+                                       DataRange(&scratch[0], scratch.size())));
+}
+
+TEST(ZstdDictMessageCompressor, EmptyDictionaryThrows) {
+    ASSERT_THROWS_CODE(ZstdDictMessageCompressor(""), DBException, ErrorCodes::BadValue);
+}
+
 TEST(SnappyMessageCompressor, Overflow) {
     checkOverflow(std::make_unique<SnappyMessageCompressor>());
 }
@@ -252,6 +307,63 @@ TEST(ZstdMessageCompressor, Overflow) {
     checkOverflow(std::make_unique<ZstdMessageCompressor>());
 }
 
+TEST(ZstdDictMessageCompressor, Overflow) {
+    checkOverflow(std::make_unique<ZstdDictMessageCompressor>("We embrace reality."));
+}
+
+/**
+ * Returns the network op of 'msg' after the first negotiated compressor of 'mgr' is applied.
+ */
+NetworkOp compressedOp(MessageCompressorManager& mgr, const Message& msg) {
+    auto swm = mgr.compressMessage(msg);
+    ASSERT_OK(swm.getStatus());
+    return swm.getValue().operation();
+}
+
+TEST(MessageCompressorManager, SmallMessagesAreNotCompressed) {
+    MessageCompressorRegistry registry;
+    registry.setSupportedCompressors({"snappy"});
+    registry.registerImplementation(std::make_unique<SnappyMessageCompressor>());
+    ASSERT_OK(registry.finalizeSupportedCompressors());
+
+    MessageCompressorManager mgr(&registry);
+    BSONObjBuilder negotiatorOut;
+    mgr.serverNegotiate(BSON("isMaster" << 1 << "compression" << BSON_ARRAY("snappy")),
+                        &negotiatorOut);
+
+    gNetworkMessageCompressionMinBytes.store(64);
+    ON_BLOCK_EXIT([] { gNetworkMessageCompressionMinBytes.store(0); });
+
+    ASSERT_EQ(compressedOp(mgr, buildMessage()), dbQuery);
+    ASSERT_EQ(compressedOp(mgr, buildMessage(std::string(64, 'x'))), dbCompressed);
+}
+
+TEST(MessageCompressorManager, IncompressibleMessagesAreNotCompressed) {
+    MessageCompressorRegistry registry;
+    registry.setSupportedCompressors({"snappy"});
+    registry.registerImplementation(std::make_unique<SnappyMessageCompressor>());
+    ASSERT_OK(registry.finalizeSupportedCompressors());
+
+    MessageCompressorManager mgr(&registry);
+    BSONObjBuilder negotiatorOut;
+    mgr.serverNegotiate(BSON("isMaster" << 1 << "compression" << BSON_ARRAY("snappy")),
+                        &negotiatorOut);
+
+    gNetworkMessageCompressionSampleBytes.store(1024);
+    ON_BLOCK_EXIT([] { gNetworkMessageCompressionSampleBytes.store(0); });
+
+    PseudoRandom random(1);
+    std::string incompressible(8192, '\0');
+    for (auto& c : incompressible) {
+        c = static_cast<char>(random.nextInt32());
+    }
+    ASSERT_EQ(compressedOp(mgr, buildMessage(incompressible)), dbQuery);
+    ASSERT_EQ(compressedOp(mgr, buildMessage(std::string(8192, 'x'))), dbCompressed);
+
+    // Messages too small to sample are compressed regardless.
+    ASSERT_EQ(compressedOp(mgr, buildMessage(incompressible.substr(0, 2048))), dbCompressed);
+}
+
 TEST(MessageCompressorManager, SERVER_28008) {
 
     // Create a client and server that will negotiate the same compressors,
@@ -31,13 +31,19 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <fstream>
+#include <iterator>
 #include <memory>
 
+#define ZSTD_STATIC_LINKING_ONLY
 #include <zstd.h>
 
 #include "mongo/base/init.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/transport/message_compressor_zstd_gen.h"
+#include "mongo/util/log.h"
 
 namespace mongo {
 
@@ -49,11 +55,12 @@ std::size_t ZstdMessageCompressor::getMaxCompressedSize(size_t inputSize) {
 
 StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input,
                                                             DataRange output) {
-    size_t ret = ZSTD_compress(const_cast<char*>(output.data()),
-                               output.length(),
-                               input.data(),
-                               input.length(),
-                               ZSTD_CLEVEL_DEFAULT);
+    const auto fastLevelMinBytes = gZstdCompressionFastLevelMinBytes.load();
+    const int level = fastLevelMinBytes > 0 && input.length() >= size_t(fastLevelMinBytes)
+        ? 1
+        : ZSTD_CLEVEL_DEFAULT;
+    size_t ret = ZSTD_compress(
+        const_cast<char*>(output.data()), output.length(), input.data(), input.length(), level);
 
     if (ZSTD_isError(ret)) {
         return Status{ErrorCodes::BadValue,
@@ -77,6 +84,72 @@ StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange inp
     return {ret};
 }
 
+ZstdDictMessageCompressor::ZstdDictMessageCompressor(std::string dictionary)
+    : MessageCompressorBase(MessageCompressor::kZstdDict),
+      _dictionary(std::move(dictionary)),
+      _cdict(nullptr, &ZSTD_freeCDict),
+      _ddict(nullptr, &ZSTD_freeDDict) {
+    uassert(ErrorCodes::BadValue, "A zstd dictionary can't be empty", !_dictionary.empty());
+
+    _cdict.reset(ZSTD_createCDict(_dictionary.data(), _dictionary.size(), ZSTD_CLEVEL_DEFAULT));
+    _ddict.reset(ZSTD_createDDict(_dictionary.data(), _dictionary.size()));
+    uassert(ErrorCodes::BadValue, "Could not load the zstd dictionary", _cdict && _ddict);
+}
+
+std::size_t ZstdDictMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize);
+}
+
+StatusWith<std::size_t> ZstdDictMessageCompressor::compressData(ConstDataRange input,
+                                                                DataRange output) {
+    std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> cctx(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+    if (!cctx) {
+        return Status{ErrorCodes::ExceededMemoryLimit, "Could not allocate a zstd context"};
+    }
+
+    ZSTD_frameParameters frameParams;
+    frameParams.contentSizeFlag = 1;
+    frameParams.checksumFlag = 1;
+    frameParams.noDictIDFlag = 0;
+    size_t ret = ZSTD_compress_usingCDict_advanced(cctx.get(),
+                                                   const_cast<char*>(output.data()),
+                                                   output.length(),
+                                                   input.data(),
+                                                   input.length(),
+                                                   _cdict.get(),
+                                                   frameParams);
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    }
+    counterHitCompress(input.length(), ret);
+    return {ret};
+}
+
+StatusWith<std::size_t> ZstdDictMessageCompressor::decompressData(ConstDataRange input,
+                                                                  DataRange output) {
+    std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> dctx(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+    if (!dctx) {
+        return Status{ErrorCodes::ExceededMemoryLimit, "Could not allocate a zstd context"};
+    }
+
+    size_t ret = ZSTD_decompress_usingDDict(dctx.get(),
+                                            const_cast<char*>(output.data()),
+                                            output.length(),
+                                            input.data(),
+                                            input.length(),
+                                            _ddict.get());
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not decompress message: " << ZSTD_getErrorName(ret)};
+    }
+
+    counterHitDecompress(input.length(), ret);
+    return {ret};
+}
+
 
 MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
                           ("EndStartupOptionHandling"),
@@ -86,4 +159,44 @@ MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
     compressorRegistry.registerImplementation(std::make_unique<ZstdMessageCompressor>());
     return Status::OK();
 }
+
+// The dictionary is loaded after option handling, once the server parameter naming it is set.
+MONGO_INITIALIZER_GENERAL(ZstdDictMessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    auto& compressorRegistry = MessageCompressorRegistry::get();
+    const auto name = getMessageCompressorName(MessageCompressor::kZstdDict).toString();
+    const auto& names = compressorRegistry.getCompressorNames();
+    if (std::find(names.begin(), names.end(), name) == names.end()) {
+        return Status::OK();
+    }
+
+    if (gZstdCompressionDictionaryFile.empty()) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "The '" << name << "' network message compressor needs "
+                                    << "zstdCompressionDictionaryFile to be set"};
+    }
+
+    std::ifstream dictionaryFile(gZstdCompressionDictionaryFile, std::ios::binary);
+    if (!dictionaryFile.is_open()) {
+        return Status{ErrorCodes::FileNotOpen,
+                      str::stream() << "Failed opening zstd dictionary file '"
+                                    << gZstdCompressionDictionaryFile
+                                    << "'"};
+    }
+    std::string dictionary((std::istreambuf_iterator<char>(dictionaryFile)),
+                           std::istreambuf_iterator<char>());
+
+    try {
+        const auto dictionaryId = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+        compressorRegistry.registerImplementation(
+            std::make_unique<ZstdDictMessageCompressor>(std::move(dictionary)));
+        log() << "Loaded zstd dictionary " << dictionaryId << " from '"
+              << gZstdCompressionDictionaryFile << "' for network message compression";
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+    return Status::OK();
+}
 }  // namespace mongo
@@ -27,8 +27,14 @@
  *    it in the license file.
  */
 
+#include <memory>
+#include <string>
+
 #include "mongo/transport/message_compressor_base.h"
 
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
 namespace mongo {
 class ZstdMessageCompressor final : public MessageCompressorBase {
 public:
@@ -41,5 +47,31 @@ public:
     StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
 };
 
+/**
+ * Compresses each message with zstd and a dictionary shared by both ends of the connection, so
+ * that small messages, which have too little content of their own to compress, can refer to the
+ * dictionary instead. Frames carry a checksum of their content, so that a peer using another
+ * dictionary fails to decompress them rather than producing different content.
+ */
+class ZstdDictMessageCompressor final : public MessageCompressorBase {
+public:
+    /**
+     * Throws if 'dictionary' is empty or zstd cannot load it.
+     */
+    explicit ZstdDictMessageCompressor(std::string dictionary);
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override;
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+private:
+    const std::string _dictionary;
+
+    std::unique_ptr<ZSTD_CDict_s, size_t (*)(ZSTD_CDict_s*)> _cdict;
+    std::unique_ptr<ZSTD_DDict_s, size_t (*)(ZSTD_DDict_s*)> _ddict;
+};
+
 
 }  // namespace mongo
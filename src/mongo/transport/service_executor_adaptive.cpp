@@ -60,6 +60,7 @@ constexpr auto kTotalTimeQueuedUs = "totalTimeQueuedMicros"_sd;
 constexpr auto kThreadsInUse = "threadsInUse"_sd;
 constexpr auto kThreadsRunning = "threadsRunning"_sd;
 constexpr auto kThreadsPending = "threadsPending"_sd;
+constexpr auto kTotalKeptOnThread = "totalKeptOnThread"_sd;
 constexpr auto kExecutorLabel = "executor"_sd;
 constexpr auto kExecutorName = "adaptive"_sd;
 constexpr auto kStuckDetection = "stuckThreadsDetected"_sd;
@@ -117,6 +118,10 @@ struct ServerParameterOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return adaptiveServiceExecutorRecursionLimit.load();
     }
+
+    bool threadAffinity() const final {
+        return adaptiveServiceExecutorThreadAffinity.load();
+    }
 };
 
 }  // namespace
@@ -217,11 +222,18 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
     //
     // Posting a task on the io_context will run the task without recursion.
     //
+    // Deferring a task on the io_context will run the task without recursion, on the current
+    // thread once its current task returns, unless another thread picks it up first.
+    //
     // If the task is allowed to recurse and we are not over the depth limit, dispatch it so it
-    // can be called immediately and recursively.
+    // can be called immediately and recursively. Otherwise a worker thread keeps the task for
+    // itself when thread affinity is enabled.
     if ((flags & kMayRecurse) &&
         (_localThreadState->recursionDepth + 1 < _config->recursionLimit())) {
         _reactorHandle->dispatch(std::move(wrappedTask));
+    } else if (_localThreadState && _config->threadAffinity()) {
+        _reactorHandle->defer(std::move(wrappedTask));
+        _totalKeptOnThread.addAndFetch(1);
     } else {
         _reactorHandle->schedule(std::move(wrappedTask));
     }
@@ -641,7 +653,8 @@ void ServiceExecutorAdaptive::appendStats(BSONObjBuilder* bob) const {
          << ticksToMicros(_getThreadTimerTotal(ThreadTimer::kExecuting, lk), _tickSource)  //
          << kTotalTimeQueuedUs << ticksToMicros(_totalSpentQueued.load(), _tickSource)     //
          << kThreadsRunning << _threadsRunning.load()                                      //
-         << kThreadsPending << _threadsPending.load();
+         << kThreadsPending << _threadsPending.load()                                      //
+         << kTotalKeptOnThread << _totalKeptOnThread.load();
 
     BSONObjBuilder threadStartReasons(bob->subobjStart(kThreadReasons));
     for (size_t i = 0; i < _threadStartCounters.size(); i++) {
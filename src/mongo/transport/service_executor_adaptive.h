@@ -80,6 +80,10 @@ public:
         // The maximum allowable depth of recursion for tasks scheduled with the MayRecurse flag
         // before stack unwinding is forced.
         virtual int recursionLimit() const = 0;
+
+        // Whether tasks scheduled by a worker thread, which are not run recursively, are kept on
+        // that thread rather than handed to any thread running the reactor.
+        virtual bool threadAffinity() const = 0;
     };
 
     explicit ServiceExecutorAdaptive(ServiceContext* ctx, ReactorHandle reactor);
@@ -234,6 +238,7 @@ private:
     AtomicWord<int64_t> _totalQueued{0};
     AtomicWord<int64_t> _totalExecuted{0};
     AtomicWord<TickSource::Tick> _totalSpentQueued{0};
+    AtomicWord<int64_t> _totalKeptOnThread{0};
 
     // Threads signal this condition variable when they exit so we can gracefully shutdown
     // the executor.
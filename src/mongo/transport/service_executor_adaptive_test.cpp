@@ -73,6 +73,10 @@ struct TestOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return 0;
     }
+
+    bool threadAffinity() const final {
+        return false;
+    }
 };
 
 struct RecursionOptions : public ServiceExecutorAdaptive::Options {
@@ -103,6 +107,10 @@ struct RecursionOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return 10;
     }
+
+    bool threadAffinity() const final {
+        return false;
+    }
 };
 
 class ServiceExecutorAdaptiveFixture : public unittest::Test {
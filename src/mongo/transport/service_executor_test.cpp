@@ -55,7 +55,7 @@ const Milliseconds kShutdownTime = kWorkerThreadRunTime + Milliseconds{50};
 
 struct TestOptions : public ServiceExecutorAdaptive::Options {
     int reservedThreads() const final {
-        return 1;
+        return numReservedThreads;
     }
 
     Milliseconds workerThreadRunTime() const final {
@@ -81,6 +81,13 @@ struct TestOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return 0;
     }
+
+    bool threadAffinity() const final {
+        return withThreadAffinity;
+    }
+
+    int numReservedThreads = 1;
+    bool withThreadAffinity = false;
 };
 
 /* This implements the portions of the transport::Reactor based on ASIO, but leaves out
@@ -135,6 +142,10 @@ public:
         asio::dispatch(_ioContext, [task = std::move(task)] { task(Status::OK()); });
     }
 
+    void defer(Task task) final {
+        asio::defer(_ioContext, [task = std::move(task)] { task(Status::OK()); });
+    }
+
     bool onReactorThread() const final {
         return false;
     }
@@ -159,7 +170,7 @@ protected:
             getGlobalServiceContext(), std::make_shared<ASIOReactor>(), std::move(configOwned));
     }
 
-    ServiceExecutorAdaptive::Options* executorConfig;
+    TestOptions* executorConfig;
     std::unique_ptr<ServiceExecutorAdaptive> executor;
     std::shared_ptr<asio::io_context> asioIOCtx;
 };
@@ -206,6 +217,41 @@ TEST_F(ServiceExecutorAdaptiveFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorAdaptiveFixture, TasksScheduledByWorkerStayOnItsThreadWithAffinity) {
+    executorConfig->numReservedThreads = 4;
+    executorConfig->withThreadAffinity = true;
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    const size_t kNumTasks = 20;
+    stdx::condition_variable cond;
+    stdx::mutex mutex;
+    std::vector<stdx::thread::id> threadIds;
+    std::function<void()> task = [&] {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        threadIds.push_back(stdx::this_thread::get_id());
+        if (threadIds.size() == kNumTasks) {
+            cond.notify_all();
+            return;
+        }
+        ASSERT_OK(executor->schedule(
+            task, ServiceExecutor::kMayRecurse, ServiceExecutorTaskName::kSSMProcessMessage));
+    };
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    ASSERT_OK(executor->schedule(
+        task, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMStartSession));
+    cond.wait(lk, [&] { return threadIds.size() == kNumTasks; });
+
+    for (const auto& threadId : threadIds) {
+        ASSERT(threadId == threadIds.front());
+    }
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    ASSERT_EQ(bob.obj()["totalKeptOnThread"].numberLong(), int64_t(kNumTasks - 1));
+}
+
 TEST_F(ServiceExecutorSynchronousFixture, BasicTaskRuns) {
     ASSERT_OK(executor->start());
     auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
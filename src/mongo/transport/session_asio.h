@@ -37,6 +37,7 @@
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/transport_layer_asio.h"
+#include "mongo/transport/transport_layer_asio_gen.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/net/socket_utils.h"
 #ifdef MONGO_CONFIG_SSL
@@ -150,24 +151,12 @@ public:
 
     Status sinkMessage(Message message) override {
         ensureSync();
-
-        return write(asio::buffer(message.buf(), message.size()))
-            .then([this, &message] {
-                if (_isIngressSession) {
-                    networkCounter.hitPhysicalOut(message.size());
-                }
-            })
-            .getNoThrow();
+        return sinkMessageImpl(std::move(message)).getNoThrow();
     }
 
     Future<void> asyncSinkMessage(Message message, const BatonHandle& baton = nullptr) override {
         ensureAsync();
-        return write(asio::buffer(message.buf(), message.size()), baton)
-            .then([this, message /*keep the buffer alive*/]() {
-                if (_isIngressSession) {
-                    networkCounter.hitPhysicalOut(message.size());
-                }
-            });
+        return sinkMessageImpl(std::move(message), baton);
     }
 
     void cancelAsyncOperations(const BatonHandle& baton = nullptr) override {
@@ -354,7 +343,7 @@ private:
 
         auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
         auto ptr = headerBuffer.get();
-        return read(asio::buffer(ptr, kHeaderSize), baton)
+        return readBuffered(asio::buffer(ptr, kHeaderSize), baton)
             .then([ headerBuffer = std::move(headerBuffer), this, baton ]() mutable {
                 if (checkForHTTPRequest(asio::buffer(headerBuffer.get(), kHeaderSize))) {
                     return sendHTTPResponse(baton);
@@ -383,7 +372,7 @@ private:
                 memcpy(buffer.get(), headerBuffer.get(), kHeaderSize);
 
                 MsgData::View msgView(buffer.get());
-                return read(asio::buffer(msgView.data(), msgView.dataLen()), baton)
+                return readBuffered(asio::buffer(msgView.data(), msgView.dataLen()), baton)
                     .then([ this, buffer = std::move(buffer), msgLen ]() mutable {
                         if (_isIngressSession) {
                             networkCounter.hitPhysicalIn(msgLen);
@@ -393,6 +382,140 @@ private:
             });
     }
 
+    /**
+     * Fills 'buffer' from the bytes this session read ahead of the messages it received so far,
+     * and when those do not suffice, reads as many more bytes as the socket has ready, up to
+     * transportLayerASIOReadAheadBytes, keeping any beyond the end of 'buffer' for the next read.
+     * Reads into 'buffer' directly when it is too large to read ahead for, or the session may use
+     * TLS.
+     */
+    Future<void> readBuffered(asio::mutable_buffer buffer, const BatonHandle& baton = nullptr) {
+        auto copyReadAhead = [&] {
+            const auto size = std::min(buffer.size(), _readAheadEnd - _readAheadBegin);
+            if (size > 0) {
+                memcpy(buffer.data(), _readAheadBuffer.get() + _readAheadBegin, size);
+                _readAheadBegin += size;
+                buffer += size;
+            }
+        };
+
+        copyReadAhead();
+        if (buffer.size() == 0) {
+            return Future<void>::makeReady();
+        }
+
+        // The client may be waiting for the held replies before it sends anything more.
+        if (!_heldReplies.empty()) {
+            return sinkHeldReplies(baton).then(
+                [buffer, baton, this] { return readBuffered(buffer, baton); });
+        }
+
+        const auto readAheadBytes = size_t(transportLayerASIOReadAheadBytes.load());
+        if (buffer.size() >= readAheadBytes || !canReadAhead()) {
+            return read(buffer, baton);
+        }
+
+        // The bytes read ahead have all been consumed, so the buffer may be reused or resized.
+        if (_readAheadBuffer.capacity() != readAheadBytes) {
+            _readAheadBuffer = SharedBuffer::allocate(readAheadBytes);
+        }
+        _readAheadBegin = 0;
+        _readAheadEnd = 0;
+
+        std::error_code ec;
+        while (_readAheadEnd < buffer.size() && !ec) {
+            auto readAheadSpace = asio::buffer(_readAheadBuffer.get() + _readAheadEnd,
+                                               readAheadBytes - _readAheadEnd);
+            _readAheadEnd += _socket.read_some(readAheadSpace, ec);
+        }
+        copyReadAhead();
+
+        if (!ec || buffer.size() == 0) {
+            return Future<void>::makeReady();
+        }
+        if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+            (_blockingMode == Async)) {
+            // Wait for the socket to have bytes ready, then read ahead again for the rest.
+            if (baton && baton->networking()) {
+                return baton->networking()
+                    ->addSession(*this, NetworkingBaton::Type::In)
+                    .then([buffer, baton, this] { return readBuffered(buffer, baton); });
+            }
+
+            return _socket.async_wait(GenericSocket::wait_read, UseFuture{})
+                .then([buffer, baton, this] { return readBuffered(buffer, baton); });
+        }
+        return futurize(ec);
+    }
+
+    bool canReadAhead() const {
+#ifdef MONGO_CONFIG_SSL
+        return !_sslSocket && _ranHandshake;
+#else
+        return true;
+#endif
+    }
+
+    Future<void> sinkMessageImpl(Message message, const BatonHandle& baton = nullptr) {
+        // When the client has already sent its next request, hold this reply back so that it is
+        // sent along with the reply to that request.
+        const auto maxHeldBytes = size_t(transportLayerASIOCoalescedReplyBytes.load());
+        if (_isIngressSession && _heldRepliesBytes + message.size() <= maxHeldBytes &&
+            hasReadAheadMessage()) {
+            _heldRepliesBytes += message.size();
+            _heldReplies.push_back(std::move(message));
+            return Future<void>::makeReady();
+        }
+
+        if (!_heldReplies.empty()) {
+            _heldRepliesBytes += message.size();
+            _heldReplies.push_back(std::move(message));
+            return sinkHeldReplies(baton);
+        }
+
+        return write(asio::buffer(message.buf(), message.size()), baton)
+            .then([this, message /*keep the buffer alive*/]() {
+                if (_isIngressSession) {
+                    networkCounter.hitPhysicalOut(message.size());
+                }
+            });
+    }
+
+    /**
+     * Sends the replies held back by sinkMessageImpl() with one write, in the order they were
+     * sunk.
+     */
+    Future<void> sinkHeldReplies(const BatonHandle& baton = nullptr) {
+        auto buffer = SharedBuffer::allocate(_heldRepliesBytes);
+        size_t size = 0;
+        for (const auto& reply : _heldReplies) {
+            memcpy(buffer.get() + size, reply.buf(), reply.size());
+            size += reply.size();
+        }
+        _heldReplies.clear();
+        _heldRepliesBytes = 0;
+
+        return write(asio::buffer(buffer.get(), size), baton)
+            .then([this, buffer /*keep the buffer alive*/, size]() {
+                if (_isIngressSession) {
+                    networkCounter.hitPhysicalOut(size);
+                }
+            });
+    }
+
+    /**
+     * Returns whether the bytes read ahead hold the whole of the next message, so that receiving
+     * it needs no read from the socket.
+     */
+    bool hasReadAheadMessage() const {
+        const auto size = _readAheadEnd - _readAheadBegin;
+        if (size < sizeof(MSGHEADER::Value)) {
+            return false;
+        }
+        MSGHEADER::ConstView header(_readAheadBuffer.get() + _readAheadBegin);
+        return size_t(header.getMessageLength()) <= size;
+    }
+
     template <typename MutableBufferSequence>
     Future<void> read(const MutableBufferSequence& buffers, const BatonHandle& baton = nullptr) {
 #ifdef MONGO_CONFIG_SSL
@@ -707,6 +830,16 @@ private:
     bool _ranHandshake = false;
 #endif
 
+    // Bytes read from the socket beyond the end of the last message received; those which have
+    // not been received yet are in [_readAheadBegin, _readAheadEnd).
+    SharedBuffer _readAheadBuffer;
+    size_t _readAheadBegin = 0;
+    size_t _readAheadEnd = 0;
+
+    // Replies which wait to be sent along with the reply to a request that was read ahead
+    std::vector<Message> _heldReplies;
+    size_t _heldRepliesBytes = 0;
+
     TransportLayerASIO* const _tl;
     bool _isIngressSession;
 };
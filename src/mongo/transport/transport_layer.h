@@ -172,6 +172,12 @@ public:
     virtual void schedule(Task task) = 0;
     virtual void dispatch(Task task) = 0;
 
+    /*
+     * Schedules a task to run once the current task on this thread returns, preferably on this
+     * same thread. Behaves like schedule() when called from a thread not running the reactor.
+     */
+    virtual void defer(Task task) = 0;
+
     virtual bool onReactorThread() const = 0;
 
     /*
@@ -190,6 +190,10 @@ public:
         asio::dispatch(_ioContext, [task = std::move(task)] { task(Status::OK()); });
     }
 
+    void defer(Task task) override {
+        asio::defer(_ioContext, [task = std::move(task)] { task(Status::OK()); });
+    }
+
     bool onReactorThread() const override {
         return this == _reactorForThread;
     }
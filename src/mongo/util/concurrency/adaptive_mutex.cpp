@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/adaptive_mutex.h"
+
+#include <map>
+#include <memory>
+
+#include "mongo/platform/pause.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+struct StatsRegistry {
+    stdx::mutex mutex;
+    std::map<std::string, std::unique_ptr<MutexContentionStats>> stats;
+};
+
+// Never destroyed, since mutexes may still be locked while static objects are destroyed at exit.
+StatsRegistry& statsRegistry() {
+    static StatsRegistry* registry = new StatsRegistry();
+    return *registry;
+}
+
+}  // namespace
+
+MutexContentionStats* MutexContentionStats::get(StringData name) {
+    auto& registry = statsRegistry();
+    stdx::lock_guard<stdx::mutex> lk(registry.mutex);
+    auto& stats = registry.stats[name.toString()];
+    if (!stats) {
+        stats = std::make_unique<MutexContentionStats>();
+    }
+    return stats.get();
+}
+
+void MutexContentionStats::reportAll(BSONObjBuilder* builder) {
+    auto& registry = statsRegistry();
+    stdx::lock_guard<stdx::mutex> lk(registry.mutex);
+    for (auto&& entry : registry.stats) {
+        BSONObjBuilder statsBuilder(builder->subobjStart(entry.first));
+        entry.second->report(&statsBuilder);
+    }
+}
+
+void MutexContentionStats::report(BSONObjBuilder* builder) const {
+    builder->append("spinAcquisitions", spinAcquisitions.loadRelaxed());
+    builder->append("parkedAcquisitions", parkedAcquisitions.loadRelaxed());
+    builder->append("parkedMicros", parkedMicros.loadRelaxed());
+}
+
+void AdaptiveMutex::_lockSlowPath() {
+    for (int i = 0; i < kSpinTries; ++i) {
+        MONGO_YIELD_CORE_FOR_SMT();
+        if (_mutex.try_lock()) {
+            _stats->spinAcquisitions.fetchAndAddRelaxed(1);
+            return;
+        }
+    }
+
+    const auto start = curTimeMicros64();
+    _mutex.lock();
+    _stats->parkedAcquisitions.fetchAndAddRelaxed(1);
+    _stats->parkedMicros.fetchAndAddRelaxed(curTimeMicros64() - start);
+}
+
+}  // namespace mongo
@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * Counts the contended acquisitions of the AdaptiveMutexes sharing a name. Uncontended
+ * acquisitions are not counted, so that they do not all write the same cache line.
+ */
+class MutexContentionStats {
+    MutexContentionStats(const MutexContentionStats&) = delete;
+    MutexContentionStats& operator=(const MutexContentionStats&) = delete;
+
+public:
+    MutexContentionStats() = default;
+
+    /**
+     * Returns the statistics of the mutexes named 'name', which live as long as the process.
+     */
+    static MutexContentionStats* get(StringData name);
+
+    /**
+     * Appends one subobject per name to 'builder'.
+     */
+    static void reportAll(BSONObjBuilder* builder);
+
+    void report(BSONObjBuilder* builder) const;
+
+    // Acquisitions which found the mutex held and got it while spinning.
+    AtomicWord<long long> spinAcquisitions{0};
+
+    // Acquisitions which found the mutex held past the spinning, and parked until it was released.
+    AtomicWord<long long> parkedAcquisitions{0};
+    AtomicWord<long long> parkedMicros{0};
+};
+
+/**
+ * A mutex for short critical sections which spins for a little while when it finds the mutex held
+ * and then parks the thread in the kernel. Unlike SpinLock, it does not burn CPU when the holder
+ * is descheduled, which happens on oversubscribed hosts.
+ *
+ * The contention of all the mutexes with the same name is reported together, in the
+ * 'mutexContention' serverStatus section.
+ */
+class AdaptiveMutex {
+    AdaptiveMutex(const AdaptiveMutex&) = delete;
+    AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+
+public:
+    // The number of times lock() tries to acquire a held mutex before it parks.
+    static constexpr int kSpinTries = 100;
+
+    explicit AdaptiveMutex(StringData name) : _stats(MutexContentionStats::get(name)) {}
+
+    void lock() {
+        if (MONGO_likely(_mutex.try_lock()))
+            return;
+        _lockSlowPath();
+    }
+
+    bool try_lock() {
+        return _mutex.try_lock();
+    }
+
+    void unlock() {
+        _mutex.unlock();
+    }
+
+private:
+    void _lockSlowPath();
+
+    stdx::mutex _mutex;
+    MutexContentionStats* const _stats;
+};
+
+}  // namespace mongo
@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/adaptive_mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+TEST(AdaptiveMutexTest, ConcurrentIncs) {
+    AdaptiveMutex mutex("AdaptiveMutexTest.ConcurrentIncs");
+    int counter = 0;
+
+    const int threads = 16;
+    const int incs = 50000;
+    std::vector<stdx::thread> testers;
+    for (int i = 0; i < threads; ++i) {
+        testers.emplace_back([&] {
+            for (int j = 0; j < incs; ++j) {
+                stdx::lock_guard<AdaptiveMutex> lk(mutex);
+                ++counter;
+            }
+        });
+    }
+    for (auto&& tester : testers) {
+        tester.join();
+    }
+
+    ASSERT_EQ(threads * incs, counter);
+}
+
+TEST(AdaptiveMutexTest, TryLock) {
+    AdaptiveMutex mutex("AdaptiveMutexTest.TryLock");
+    ASSERT(mutex.try_lock());
+    ASSERT_FALSE(mutex.try_lock());
+    mutex.unlock();
+    ASSERT(mutex.try_lock());
+    mutex.unlock();
+}
+
+// Holds 'mutex' long past the spinning of another thread which waits for it.
+void lockWhileHeld(AdaptiveMutex& mutex) {
+    AtomicWord<bool> waiting{false};
+    mutex.lock();
+    stdx::thread waiter([&] {
+        waiting.store(true);
+        stdx::lock_guard<AdaptiveMutex> lk(mutex);
+    });
+    while (!waiting.load()) {
+        sleepmillis(1);
+    }
+    sleepmillis(100);
+    mutex.unlock();
+    waiter.join();
+}
+
+TEST(AdaptiveMutexTest, ReportsParkedAcquisitionsByName) {
+    const auto name = "AdaptiveMutexTest.ReportsParkedAcquisitionsByName"_sd;
+    AdaptiveMutex first(name);
+    AdaptiveMutex second(name);
+    auto stats = MutexContentionStats::get(name);
+    ASSERT_EQ(stats, MutexContentionStats::get(name));
+
+    // Uncontended acquisitions are not counted.
+    first.lock();
+    first.unlock();
+    ASSERT_EQ(0, stats->spinAcquisitions.load());
+    ASSERT_EQ(0, stats->parkedAcquisitions.load());
+
+    lockWhileHeld(first);
+    ASSERT_EQ(1, stats->parkedAcquisitions.load());
+    ASSERT_GT(stats->parkedMicros.load(), 0);
+
+    // The mutexes with the same name count into the same statistics.
+    lockWhileHeld(second);
+    ASSERT_EQ(2, stats->parkedAcquisitions.load());
+
+    BSONObjBuilder builder;
+    MutexContentionStats::reportAll(&builder);
+    auto report = builder.obj()[name].Obj();
+    ASSERT_EQ(0, report["spinAcquisitions"].numberLong());
+    ASSERT_EQ(2, report["parkedAcquisitions"].numberLong());
+    ASSERT_EQ(stats->parkedMicros.load(), report["parkedMicros"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
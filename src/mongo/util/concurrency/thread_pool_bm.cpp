@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace mongo {
+namespace {
+
+constexpr size_t kNumThreads = 8;
+
+std::unique_ptr<ThreadPoolInterface> makePool(ThreadPool*) {
+    ThreadPool::Options options;
+    options.minThreads = kNumThreads;
+    options.maxThreads = kNumThreads;
+    return std::make_unique<ThreadPool>(options);
+}
+
+std::unique_ptr<ThreadPoolInterface> makePool(WorkStealingThreadPool*) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = kNumThreads;
+    return std::make_unique<WorkStealingThreadPool>(options);
+}
+
+/**
+ * Runs state.range(0) empty tasks per iteration. With "fromTasks", they are scheduled by tasks
+ * running in the pool, each of which schedules ten of them, as continuations do.
+ */
+template <typename Pool, bool fromTasks>
+void BM_scheduleShortTasks(benchmark::State& state) {
+    auto pool = makePool(static_cast<Pool*>(nullptr));
+    pool->startup();
+
+    const size_t numTasks = state.range(0);
+    stdx::mutex mutex;
+    stdx::condition_variable allDone;
+    size_t numDone = 0;
+    auto task = [&](Status) {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (++numDone == numTasks) {
+            allDone.notify_one();
+        }
+    };
+
+    for (auto _ : state) {
+        numDone = 0;
+        if (fromTasks) {
+            for (size_t i = 0; i < numTasks / 10; ++i) {
+                pool->schedule([&](Status) {
+                    for (size_t j = 0; j < 10; ++j) {
+                        pool->schedule(task);
+                    }
+                });
+            }
+        } else {
+            for (size_t i = 0; i < numTasks; ++i) {
+                pool->schedule(task);
+            }
+        }
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        allDone.wait(lk, [&] { return numDone == numTasks; });
+    }
+
+    pool->shutdown();
+    pool->join();
+}
+
+BENCHMARK_TEMPLATE(BM_scheduleShortTasks, ThreadPool, false)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_scheduleShortTasks, WorkStealingThreadPool, false)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_scheduleShortTasks, ThreadPool, true)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_scheduleShortTasks, WorkStealingThreadPool, true)->Arg(10000);
+
+}  // namespace
+}  // namespace mongo
@@ -36,9 +36,197 @@
 #include <iostream>
 
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
+namespace {
+
+// Strides are this divided by the weight of the queue.
+const uint64_t kStrideScale = 1ULL << 20;
+
+const char* const kWaitBucketNames[] = {
+    "lessThan1ms", "lessThan10ms", "lessThan100ms", "lessThan1s", "atLeast1s"};
+
+}  // namespace
+
+StringData TicketHolder::operationClassName(OperationClass operationClass) {
+    switch (operationClass) {
+        case OperationClass::kShort:
+            return "short";
+        case OperationClass::kLong:
+            return "long";
+        case OperationClass::kInternal:
+            return "internal";
+        case OperationClass::kAdmin:
+            return "admin";
+    }
+    MONGO_UNREACHABLE;
+}
+
+void TicketHolder::setFairQueueing(const OperationClassWeights& weights) {
+    stdx::lock_guard<stdx::mutex> lk(_queueMutex);
+    for (size_t i = 0; i < kNumOperationClasses; i++) {
+        invariant(weights[i] > 0);
+        _queues[i].stride = kStrideScale / weights[i];
+    }
+    _fairQueueing = true;
+}
+
+void TicketHolder::waitForTicket(OperationContext* opCtx, OperationClass operationClass) {
+    invariant(waitForTicketUntil(opCtx, Date_t::max(), operationClass));
+}
+
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx,
+                                      Date_t until,
+                                      OperationClass operationClass) {
+    Timer timer;
+    const bool acquired = _fairQueueing ? _waitInQueueUntil(opCtx, until, operationClass)
+                                        : _waitForTicketUntil(opCtx, until);
+    if (acquired) {
+        _recordWait(operationClass, Microseconds(timer.micros()));
+    }
+    return acquired;
+}
+
+void TicketHolder::release() {
+    _release();
+
+    // A waiter increments the number of queued operations before it tries to take a ticket, so
+    // either it sees the ticket released above, or this sees it queued.
+    if (_fairQueueing && _numQueued.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_queueMutex);
+        _grantQueuedTickets(lk);
+    }
+}
+
+bool TicketHolder::_waitInQueueUntil(OperationContext* opCtx,
+                                     Date_t until,
+                                     OperationClass operationClass) {
+    // Only take a ticket directly while nobody is queued, so as not to overtake the queues.
+    if (_numQueued.load() == 0 && tryAcquire()) {
+        return true;
+    }
+
+    Queue& queue = _queues[static_cast<size_t>(operationClass)];
+    Waiter waiter;
+
+    stdx::unique_lock<stdx::mutex> lk(_queueMutex);
+    if (queue.waiters.empty()) {
+        // A queue doesn't accumulate credit while it has no waiters.
+        queue.pass = std::max(queue.pass, _pass);
+    }
+    auto it = queue.waiters.insert(queue.waiters.end(), &waiter);
+    _numQueued.fetchAndAdd(1);
+    _grantQueuedTickets(lk);
+
+    auto dequeueGuard = makeGuard([&] {
+        if (!waiter.granted) {
+            queue.waiters.erase(it);
+            _numQueued.fetchAndSubtract(1);
+        } else {
+            // The wait was interrupted after a ticket was handed to this waiter.
+            _release();
+            _grantQueuedTickets(lk);
+        }
+    });
+
+    const auto isGranted = [&] { return waiter.granted; };
+    bool granted;
+    if (opCtx) {
+        granted = opCtx->waitForConditionOrInterruptUntil(waiter.cv, lk, until, isGranted);
+    } else if (until == Date_t::max()) {
+        waiter.cv.wait(lk, isGranted);
+        granted = true;
+    } else {
+        granted = waiter.cv.wait_until(lk, until.toSystemTimePoint(), isGranted);
+    }
+
+    if (granted) {
+        dequeueGuard.dismiss();
+    }
+    return granted;
+}
+
+void TicketHolder::_grantQueuedTickets(WithLock) {
+    while (_numQueued.load() > 0) {
+        Queue* next = nullptr;
+        for (auto& queue : _queues) {
+            if (!queue.waiters.empty() && (!next || queue.pass < next->pass)) {
+                next = &queue;
+            }
+        }
+        invariant(next);
+
+        if (!tryAcquire()) {
+            return;
+        }
+
+        Waiter* waiter = next->waiters.front();
+        next->waiters.pop_front();
+        _numQueued.fetchAndSubtract(1);
+
+        _pass = next->pass;
+        next->pass += next->stride;
+
+        waiter->granted = true;
+        waiter->cv.notify_one();
+    }
+}
+
+void TicketHolder::_recordWait(OperationClass operationClass, Microseconds wait) {
+    const long long micros = durationCount<Microseconds>(wait);
+    size_t bucket = 0;
+    for (long long bound = 1000; bucket < kNumWaitBuckets - 1 && micros >= bound; bound *= 10) {
+        bucket++;
+    }
+
+    WaitStats& stats = _waitStats[static_cast<size_t>(operationClass)];
+    stats.buckets[bucket].fetchAndAddRelaxed(1);
+    stats.totalMicros.fetchAndAddRelaxed(micros);
+}
+
+long long TicketHolder::numAcquired() const {
+    long long count = 0;
+    for (const WaitStats& stats : _waitStats) {
+        for (const auto& bucketCount : stats.buckets) {
+            count += bucketCount.loadRelaxed();
+        }
+    }
+    return count;
+}
+
+long long TicketHolder::numDelayed() const {
+    long long count = 0;
+    for (const WaitStats& stats : _waitStats) {
+        for (size_t bucket = 1; bucket < kNumWaitBuckets; bucket++) {
+            count += stats.buckets[bucket].loadRelaxed();
+        }
+    }
+    return count;
+}
+
+void TicketHolder::appendQueueStats(BSONObjBuilder* builder) const {
+    builder->append("fairQueueing", _fairQueueing);
+    builder->append("queued", queued());
+
+    BSONObjBuilder waitsBuilder(builder->subobjStart("queueWaits"));
+    for (size_t i = 0; i < kNumOperationClasses; i++) {
+        const WaitStats& stats = _waitStats[i];
+        BSONObjBuilder classBuilder(
+            waitsBuilder.subobjStart(operationClassName(static_cast<OperationClass>(i))));
+
+        long long count = 0;
+        for (size_t bucket = 0; bucket < kNumWaitBuckets; bucket++) {
+            const long long bucketCount = stats.buckets[bucket].loadRelaxed();
+            classBuilder.append(kWaitBucketNames[bucket], bucketCount);
+            count += bucketCount;
+        }
+        classBuilder.append("count", count);
+        classBuilder.append("totalWaitMicros", stats.totalMicros.loadRelaxed());
+    }
+}
 
 #if defined(__linux__)
 namespace {
@@ -88,11 +276,7 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
-}
-
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+bool TicketHolder::_waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     const Milliseconds intervalMs(500);
     struct timespec ts;
 
@@ -123,7 +307,7 @@ bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     return true;
 }
 
-void TicketHolder::release() {
+void TicketHolder::_release() {
     check(sem_post(&_sem));
 }
 
@@ -179,18 +363,17 @@ bool TicketHolder::tryAcquire() {
     return _tryAcquire();
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
+bool TicketHolder::_waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
 
-    if (opCtx) {
-        opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
-    } else {
-        _newTicket.wait(lk, [this] { return _tryAcquire(); });
+    if (until == Date_t::max()) {
+        if (opCtx) {
+            opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
+        } else {
+            _newTicket.wait(lk, [this] { return _tryAcquire(); });
+        }
+        return true;
     }
-}
-
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     if (opCtx) {
         return opCtx->waitForConditionOrInterruptUntil(
@@ -201,7 +384,7 @@ bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     }
 }
 
-void TicketHolder::release() {
+void TicketHolder::_release() {
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
         _num++;
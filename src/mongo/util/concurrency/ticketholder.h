@@ -32,10 +32,15 @@
 #include <semaphore.h>
 #endif
 
+#include <array>
+#include <list>
+
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -45,9 +50,26 @@ class TicketHolder {
     TicketHolder& operator=(const TicketHolder&) = delete;
 
 public:
+    /**
+     * The classes of operations which wait for tickets. When the holder queues fairly, each class
+     * waits in its own queue, and the queues are admitted in proportion to their weights.
+     */
+    enum class OperationClass { kShort, kLong, kInternal, kAdmin };
+    static constexpr size_t kNumOperationClasses = 4;
+    using OperationClassWeights = std::array<int, kNumOperationClasses>;
+
+    static StringData operationClassName(OperationClass operationClass);
+
     explicit TicketHolder(int num);
     ~TicketHolder();
 
+    /**
+     * Makes operations which can't get a ticket right away wait in the queue of their operation
+     * class, and hands released tickets to the queues by weighted fair queueing. Each weight must
+     * be positive. Must be called before any ticket is acquired.
+     */
+    void setFairQueueing(const OperationClassWeights& weights);
+
     bool tryAcquire();
 
     /**
@@ -55,7 +77,10 @@ public:
      * 'opCtx' is killed, throwing an AssertionException.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    void waitForTicket(OperationContext* opCtx);
+    void waitForTicket(OperationContext* opCtx, OperationClass operationClass);
+    void waitForTicket(OperationContext* opCtx) {
+        waitForTicket(opCtx, OperationClass::kShort);
+    }
     void waitForTicket() {
         waitForTicket(nullptr);
     }
@@ -67,7 +92,10 @@ public:
      * proceed.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    bool waitForTicketUntil(OperationContext* opCtx, Date_t until);
+    bool waitForTicketUntil(OperationContext* opCtx, Date_t until, OperationClass operationClass);
+    bool waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+        return waitForTicketUntil(opCtx, until, OperationClass::kShort);
+    }
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
@@ -81,7 +109,72 @@ public:
 
     int outof() const;
 
+    /**
+     * Returns the number of operations waiting in the fair queues.
+     */
+    int queued() const {
+        return _numQueued.load();
+    }
+
+    /**
+     * Returns the number of tickets acquired by waiting for them, and the number of those whose
+     * wait took at least a millisecond.
+     */
+    long long numAcquired() const;
+    long long numDelayed() const;
+
+    /**
+     * Appends, for each operation class, a histogram of the time its operations waited for
+     * tickets.
+     */
+    void appendQueueStats(BSONObjBuilder* builder) const;
+
 private:
+    // A waiting operation, to which a released ticket is handed by setting 'granted'.
+    struct Waiter {
+        stdx::condition_variable cv;
+        bool granted = false;
+    };
+
+    // The waiters of one operation class. The queue with the least 'pass' is served next, after
+    // which its 'pass' advances by 'stride', which is inversely proportional to its weight.
+    struct Queue {
+        std::list<Waiter*> waiters;
+        uint64_t pass = 0;
+        uint64_t stride = 0;
+    };
+
+    // Waits are counted in buckets of less than 1ms, 10ms, 100ms and 1s, and of at least 1s.
+    static constexpr size_t kNumWaitBuckets = 5;
+    struct WaitStats {
+        std::array<AtomicWord<long long>, kNumWaitBuckets> buckets;
+        AtomicWord<long long> totalMicros;
+    };
+
+    bool _waitForTicketUntil(OperationContext* opCtx, Date_t until);
+    void _release();
+
+    bool _waitInQueueUntil(OperationContext* opCtx, Date_t until, OperationClass operationClass);
+
+    /**
+     * Hands tickets to queued waiters as long as there are both.
+     */
+    void _grantQueuedTickets(WithLock);
+
+    void _recordWait(OperationClass operationClass, Microseconds wait);
+
+    bool _fairQueueing = false;
+
+    // Protects the queues and the pass of the last served queue.
+    stdx::mutex _queueMutex;
+    std::array<Queue, kNumOperationClasses> _queues;
+    uint64_t _pass = 0;
+
+    // Read without the mutex by releasers, to skip it when nobody is queued.
+    AtomicWord<int> _numQueued{0};
+
+    std::array<WaitStats, kNumOperationClasses> _waitStats;
+
 #if defined(__linux__)
     mutable sem_t _sem;
 
@@ -32,6 +32,10 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
 
@@ -72,4 +76,62 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, FairQueueingTimeout) {
+    TicketHolder holder(1);
+    holder.setFairQueueing({1, 1, 1, 1});
+
+    ASSERT(holder.waitForTicketUntil(nullptr, Date_t::now(), TicketHolder::OperationClass::kLong));
+    ASSERT_FALSE(holder.waitForTicketUntil(
+        nullptr, Date_t::now() + Milliseconds(2), TicketHolder::OperationClass::kShort));
+    ASSERT_EQ(holder.queued(), 0);
+
+    holder.release();
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT(holder.tryAcquire());
+    holder.release();
+}
+
+TEST(TicketholderTest, FairQueueingAdmitsByWeight) {
+    using OperationClass = TicketHolder::OperationClass;
+    TicketHolder holder(1);
+    holder.setFairQueueing({3, 1, 1, 1});
+    holder.waitForTicket();
+
+    stdx::mutex mutex;
+    std::vector<OperationClass> admitted;
+    std::vector<stdx::thread> threads;
+    for (auto operationClass : {OperationClass::kShort, OperationClass::kLong}) {
+        for (int i = 0; i < 4; i++) {
+            threads.emplace_back([&, operationClass] {
+                holder.waitForTicket(nullptr, operationClass);
+                {
+                    stdx::lock_guard<stdx::mutex> lk(mutex);
+                    admitted.push_back(operationClass);
+                }
+                holder.release();
+            });
+        }
+    }
+    while (holder.queued() < 8) {
+        sleepmillis(1);
+    }
+
+    holder.release();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // The short operations have three times the weight of the long ones, so they take four of
+    // the first five tickets.
+    ASSERT_EQ(admitted.size(), 8U);
+    ASSERT_EQ(std::count(admitted.begin(), admitted.begin() + 5, OperationClass::kShort), 4);
+    ASSERT_EQ(holder.used(), 0);
+
+    BSONObjBuilder builder;
+    holder.appendQueueStats(&builder);
+    const BSONObj stats = builder.obj();
+    ASSERT_EQ(stats["queueWaits"]["short"]["count"].numberLong(), 5);
+    ASSERT_EQ(stats["queueWaits"]["long"]["count"].numberLong(), 4);
+}
 }  // namespace
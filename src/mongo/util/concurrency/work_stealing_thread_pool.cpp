@@ -0,0 +1,322 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include "mongo/base/status.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+namespace {
+
+// Counter used to assign unique names to otherwise-unnamed thread pools.
+AtomicWord<int> nextUnnamedThreadPoolId{1};
+
+// The pool and the index of the worker which this thread runs, if any.
+thread_local const WorkStealingThreadPool* currentPool = nullptr;
+thread_local size_t currentWorkerIndex = 0;
+
+WorkStealingThreadPool::Options cleanUpOptions(WorkStealingThreadPool::Options&& options) {
+    if (options.poolName.empty()) {
+        options.poolName = str::stream() << "WorkStealingThreadPool"
+                                         << nextUnnamedThreadPoolId.fetchAndAdd(1);
+    }
+    if (options.threadNamePrefix.empty()) {
+        options.threadNamePrefix = str::stream() << options.poolName << '-';
+    }
+    if (options.numThreads < 1) {
+        severe() << "Tried to create pool " << options.poolName << " with "
+                 << options.numThreads << " threads but it needs at least 1";
+        fassertFailed(51328);
+    }
+    return {std::move(options)};
+}
+
+void runTask(OutOfLineExecutor::Task task) noexcept {
+    task(Status::OK());
+}
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(Options options)
+    : _options(cleanUpOptions(std::move(options))) {
+    for (size_t i = 0; i < _options.numThreads; ++i) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    shutdown();
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_state == shutdownComplete) {
+            return;
+        }
+    }
+    join();
+}
+
+void WorkStealingThreadPool::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state != preStart) {
+        severe() << "Attempting to start pool " << _options.poolName
+                 << ", but it has already started";
+        fassertFailed(51329);
+    }
+    _setState_inlock(running);
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        const std::string threadName = str::stream() << _options.threadNamePrefix << i;
+        _threads.emplace_back([this, i, threadName] {
+            setThreadName(threadName);
+            _options.onCreateThread(threadName);
+            LOG(1) << "starting thread in pool " << _options.poolName;
+            currentPool = this;
+            currentWorkerIndex = i;
+            _consumeTasks(i);
+            currentPool = nullptr;
+            LOG(1) << "shutting down thread in pool " << _options.poolName;
+        });
+    }
+}
+
+void WorkStealingThreadPool::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    switch (_state) {
+        case preStart:
+        case running:
+            _setState_inlock(joinRequired);
+            _inShutdown.store(true);
+            _workAvailable.notify_all();
+            return;
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void WorkStealingThreadPool::join() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _stateChange.wait(lk, [this] {
+        switch (_state) {
+            case preStart:
+            case running:
+                return false;
+            case joinRequired:
+                return true;
+            case joining:
+            case shutdownComplete:
+                severe() << "Attempted to join pool " << _options.poolName << " more than once";
+                fassertFailed(51330);
+        }
+        MONGO_UNREACHABLE;
+    });
+    _setState_inlock(joining);
+    std::vector<stdx::thread> threadsToJoin;
+    swap(threadsToJoin, _threads);
+    lk.unlock();
+
+    // The workers drain all the queues before they exit.
+    for (auto& t : threadsToJoin) {
+        t.join();
+    }
+    if (_numPendingTasks.load()) {
+        _drainPendingTasks();
+    }
+
+    lk.lock();
+    invariant(_state == joining);
+    _setState_inlock(shutdownComplete);
+}
+
+void WorkStealingThreadPool::schedule(Task task) {
+    if (currentPool == this && !_inShutdown.load()) {
+        // Tasks running in the pool only take the mutex of their own worker to schedule more work.
+        // The worker drains its own queue before it exits, so a task which gets in here
+        // concurrently with shutdown() still runs.
+        Worker& worker = *_workers[currentWorkerIndex];
+        {
+            stdx::lock_guard<stdx::mutex> workerLk(worker.mutex);
+            worker.tasks.push_back(std::move(task));
+        }
+        _numPendingTasks.fetchAndAdd(1);
+        _notifyWorkAvailable();
+        return;
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    switch (_state) {
+        case joinRequired:
+        case joining:
+        case shutdownComplete: {
+            auto status = Status(ErrorCodes::ShutdownInProgress,
+                                 str::stream() << "Shutdown of thread pool " << _options.poolName
+                                               << " in progress");
+
+            lk.unlock();
+            task(status);
+            return;
+        }
+        case preStart:
+        case running:
+            break;
+    }
+    _injectedTasks.push_back(std::move(task));
+    _numPendingTasks.fetchAndAdd(1);
+    if (_state == running) {
+        _workAvailable.notify_one();
+    }
+}
+
+WorkStealingThreadPool::Stats WorkStealingThreadPool::getStats() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Stats result;
+    result.numThreads = _threads.size();
+    result.numIdleThreads = _numIdleThreads.load();
+    result.numPendingTasks = _numPendingTasks.load();
+    result.numStolenTasks = _numStolenTasks.load();
+    return result;
+}
+
+void WorkStealingThreadPool::_consumeTasks(size_t workerIndex) {
+    Task task;
+    while (true) {
+        if (_takeTask(workerIndex, &task)) {
+            runTask(std::move(task));
+            continue;
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (_state != running) {
+            // No new task can get into the injection queue, and only this worker adds tasks to its
+            // own queue, so the queues this worker is responsible for are drained.
+            return;
+        }
+
+        _numIdleThreads.fetchAndAdd(1);
+        {
+            MONGO_IDLE_THREAD_BLOCK;
+            _workAvailable.wait(lk, [&] { return _numPendingTasks.load() || _state != running; });
+        }
+        _numIdleThreads.fetchAndSubtract(1);
+    }
+}
+
+bool WorkStealingThreadPool::_takeTask(size_t workerIndex, Task* task) {
+    auto takeFrom = [&](std::deque<Task>* tasks, bool fromFront) {
+        if (tasks->empty()) {
+            return false;
+        }
+        if (fromFront) {
+            *task = std::move(tasks->front());
+            tasks->pop_front();
+        } else {
+            *task = std::move(tasks->back());
+            tasks->pop_back();
+        }
+        _numPendingTasks.fetchAndSubtract(1);
+        return true;
+    };
+
+    {
+        Worker& self = *_workers[workerIndex];
+        stdx::lock_guard<stdx::mutex> lk(self.mutex);
+        if (takeFrom(&self.tasks, false)) {
+            return true;
+        }
+    }
+
+    if (!_numPendingTasks.load()) {
+        return false;
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (takeFrom(&_injectedTasks, true)) {
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < _workers.size(); ++i) {
+        Worker& victim = *_workers[(workerIndex + i) % _workers.size()];
+        stdx::lock_guard<stdx::mutex> lk(victim.mutex);
+        if (takeFrom(&victim.tasks, true)) {
+            _numStolenTasks.fetchAndAdd(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::_drainPendingTasks() {
+    // Tasks cannot be run inline because they can create OperationContexts and the join() caller
+    // may already have one associated with the thread.
+    stdx::thread cleanThread = stdx::thread([&] {
+        const std::string threadName = str::stream() << _options.threadNamePrefix << "drain";
+        setThreadName(threadName);
+        _options.onCreateThread(threadName);
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (!_injectedTasks.empty()) {
+            Task task = std::move(_injectedTasks.front());
+            _injectedTasks.pop_front();
+            _numPendingTasks.fetchAndSubtract(1);
+            lk.unlock();
+            runTask(std::move(task));
+            lk.lock();
+        }
+    });
+    cleanThread.join();
+}
+
+void WorkStealingThreadPool::_notifyWorkAvailable() {
+    if (_numIdleThreads.load()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workAvailable.notify_one();
+    }
+}
+
+void WorkStealingThreadPool::_setState_inlock(const LifecycleState newState) {
+    if (newState == _state) {
+        return;
+    }
+    _state = newState;
+    _stateChange.notify_all();
+}
+
+}  // namespace mongo
@@ -0,0 +1,196 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+
+namespace mongo {
+
+/**
+ * A thread pool with a fixed number of threads, for short tasks which often schedule more tasks.
+ *
+ * Each worker thread owns a queue of tasks. Tasks scheduled from a worker thread of the pool go on
+ * that worker's queue, and the worker runs the most recently scheduled of them first, while its
+ * data is still in cache. Tasks scheduled from any other thread go on a shared injection queue.
+ * A worker with nothing in its own queue takes the oldest task of the injection queue, or failing
+ * that steals the oldest task from the queue of another worker. Unlike ThreadPool, scheduling from
+ * inside the pool does not contend on a pool-wide mutex, which is only taken to put idle workers
+ * to sleep and wake them up.
+ *
+ * Tasks are not run in the order they were scheduled, so the pool is not suitable for users which
+ * need FIFO execution.
+ */
+class WorkStealingThreadPool final : public ThreadPoolInterface {
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+public:
+    /**
+     * Structure used to configure an instance of WorkStealingThreadPool.
+     */
+    struct Options {
+        // Name of the thread pool. If this string is empty, the pool will be assigned a
+        // name unique to the current process.
+        std::string poolName;
+
+        // Prefix used to name threads for logging purposes. An integer will be appended to this
+        // string to create the thread name for each thread in the pool. If you leave this empty,
+        // the prefix will be the pool name followed by a hyphen.
+        std::string threadNamePrefix;
+
+        // Number of worker threads, all of which are started by startup().
+        size_t numThreads = 4;
+
+        // This function is run before each worker thread begins consuming tasks.
+        using OnCreateThreadFn = std::function<void(const std::string& threadName)>;
+        OnCreateThreadFn onCreateThread = [](const std::string&) {};
+    };
+
+    /**
+     * Structure used to return information about the thread pool via getStats().
+     */
+    struct Stats {
+        // The number of threads currently in the pool.
+        size_t numThreads;
+
+        // The number of threads currently waiting for work.
+        size_t numIdleThreads;
+
+        // The number of tasks waiting to be executed by the pool.
+        size_t numPendingTasks;
+
+        // The number of tasks a worker took from the queue of another worker.
+        size_t numStolenTasks;
+    };
+
+    /**
+     * Constructs a thread pool, configured with the given "options".
+     */
+    explicit WorkStealingThreadPool(Options options);
+
+    ~WorkStealingThreadPool() override;
+
+    void startup() override;
+    void shutdown() override;
+    void join() override;
+    void schedule(Task task) override;
+
+    /**
+     * Returns statistics about the thread pool's utilization.
+     */
+    Stats getStats() const;
+
+private:
+    /**
+     * Representation of the stage of life of a thread pool, with the same transitions as in
+     * ThreadPool:
+     *
+     * preStart -> running -> joinRequired -> joining -> shutdownComplete
+     *        \               ^
+     *         \_____________/
+     */
+    enum LifecycleState { preStart, running, joinRequired, joining, shutdownComplete };
+
+    struct Worker {
+        // Guards "tasks". The owner of the queue pushes and pops at the back, thieves pop at the
+        // front.
+        stdx::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * This is the run loop of the worker thread with index "workerIndex".
+     */
+    void _consumeTasks(size_t workerIndex);
+
+    /**
+     * Takes the next task for the worker with index "workerIndex", trying in order its own queue,
+     * the injection queue and the queues of the other workers. Returns false if all of them are
+     * empty.
+     */
+    bool _takeTask(size_t workerIndex, Task* task);
+
+    /**
+     * Runs the tasks left over after the worker threads have exited on a new thread, blocking
+     * until complete. This only finds tasks if the pool was shut down before it started.
+     */
+    void _drainPendingTasks();
+
+    /**
+     * Wakes up a worker waiting for work, if there is one.
+     */
+    void _notifyWorkAvailable();
+
+    void _setState_inlock(LifecycleState newState);
+
+    // These are the options with which the pool was configured at construction time.
+    const Options _options;
+
+    // Mutex guarding _state, _threads and _injectedTasks.
+    mutable stdx::mutex _mutex;
+
+    LifecycleState _state = preStart;
+
+    // Condition signaled to indicate that a task was scheduled, or that the pool is shutting down.
+    stdx::condition_variable _workAvailable;
+
+    // Condition variable signaled whenever _state changes.
+    stdx::condition_variable _stateChange;
+
+    // Queue of tasks scheduled from outside the pool.
+    std::deque<Task> _injectedTasks;
+
+    // One per worker thread. Sized at construction, so that it can be read without _mutex.
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    std::vector<stdx::thread> _threads;
+
+    // Number of tasks in all queues together. A worker only goes to sleep after seeing it at
+    // zero while counted in _numIdleThreads, and a scheduler only skips waking a worker after
+    // seeing no idle worker once its task is counted here, so that no wakeup is missed.
+    AtomicWord<size_t> _numPendingTasks{0};
+    AtomicWord<size_t> _numIdleThreads{0};
+    AtomicWord<size_t> _numStolenTasks{0};
+
+    // Set by shutdown(), so that tasks can check for it without taking _mutex.
+    AtomicWord<bool> _inShutdown{false};
+};
+
+}  // namespace mongo
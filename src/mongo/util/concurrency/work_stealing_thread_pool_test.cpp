@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/barrier.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool_test_common.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace {
+using namespace mongo;
+
+MONGO_INITIALIZER(WorkStealingThreadPoolCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("WorkStealingThreadPoolCommon", []() {
+        return std::make_unique<WorkStealingThreadPool>(WorkStealingThreadPool::Options());
+    });
+    return Status::OK();
+}
+
+TEST(WorkStealingThreadPoolTest, TasksScheduledFromATaskAreStolen) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 4;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    // All the tasks go on the queue of the worker running the first one, and can only meet at the
+    // barrier if the other workers steal them.
+    unittest::Barrier barrier(options.numThreads);
+    AtomicWord<size_t> numDone{0};
+    pool.schedule([&](auto status) {
+        ASSERT_OK(status);
+        for (size_t i = 1; i < options.numThreads; ++i) {
+            pool.schedule([&](auto status) {
+                ASSERT_OK(status);
+                barrier.countDownAndWait();
+                numDone.fetchAndAdd(1);
+            });
+        }
+        barrier.countDownAndWait();
+        numDone.fetchAndAdd(1);
+    });
+
+    pool.shutdown();
+    pool.join();
+    ASSERT_EQ(numDone.load(), options.numThreads);
+    ASSERT_EQ(pool.getStats().numStolenTasks, options.numThreads - 1);
+}
+
+TEST(WorkStealingThreadPoolTest, AllTasksRunBeforeJoinReturns) {
+    WorkStealingThreadPool pool(WorkStealingThreadPool::Options{});
+    pool.startup();
+
+    const size_t kNumTasks = 10000;
+    AtomicWord<size_t> numScheduling{0};
+    AtomicWord<size_t> numDone{0};
+    for (size_t i = 0; i < kNumTasks / 10; ++i) {
+        pool.schedule([&](auto status) {
+            ASSERT_OK(status);
+            for (size_t j = 0; j < 9; ++j) {
+                pool.schedule([&](auto status) {
+                    ASSERT_OK(status);
+                    numDone.fetchAndAdd(1);
+                });
+            }
+            numScheduling.fetchAndAdd(1);
+            numDone.fetchAndAdd(1);
+        });
+    }
+
+    // Wait for the tasks to be scheduled, so that none of them is refused by the shutdown.
+    while (numScheduling.load() < kNumTasks / 10) {
+        stdx::this_thread::yield();
+    }
+    pool.shutdown();
+    pool.join();
+    ASSERT_EQ(numDone.load(), kNumTasks);
+    ASSERT_EQ(pool.getStats().numPendingTasks, 0U);
+}
+
+}  // namespace
@@ -60,11 +60,25 @@
 
 #pragma once
 
+#include <type_traits>
+
+#include "mongo/stdx/type_traits.h"
 #include "mongo/util/decoration_container.h"
 #include "mongo/util/decoration_registry.h"
 
 namespace mongo {
 
+/**
+ * Size of the hot region of the decorations of D, given by a static constexpr member
+ * "kHotDecorationBytes" of D if it has one, and 0 otherwise.
+ */
+template <typename D, typename = void>
+struct HotDecorationBytes : std::integral_constant<size_t, 0> {};
+
+template <typename D>
+struct HotDecorationBytes<D, stdx::void_t<decltype(D::kHotDecorationBytes)>>
+    : std::integral_constant<size_t, D::kHotDecorationBytes> {};
+
 template <typename D>
 class Decorable {
     Decorable(const Decorable&) = delete;
@@ -132,13 +146,24 @@ public:
         return Decoration<T>(getRegistry()->template declareDecoration<T>());
     }
 
+    /**
+     * Like declareDecoration(), for decorations which are accessed all the time. They are packed
+     * together at the front of the decorations, as long as they fit in the kHotDecorationBytes
+     * declared by D.
+     */
+    template <typename T>
+    static Decoration<T> declareHotDecoration() {
+        return Decoration<T>(getRegistry()->template declareHotDecoration<T>());
+    }
+
 protected:
     Decorable() : _decorations(this, getRegistry()) {}
     ~Decorable() = default;
 
 private:
     static DecorationRegistry<D>* getRegistry() {
-        static DecorationRegistry<D>* theRegistry = new DecorationRegistry<D>();
+        static DecorationRegistry<D>* theRegistry =
+            new DecorationRegistry<D>(HotDecorationBytes<D>::value);
         return theRegistry;
     }
 
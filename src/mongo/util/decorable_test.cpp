@@ -175,6 +175,43 @@ TEST(DecorableTest, Alignment) {
                   std::alignment_of<int>::value);
 }
 
+TEST(DecorableTest, HotDecorationsArePackedAtTheFront) {
+    struct Big {
+        char bytes[64];
+    };
+
+    DecorationRegistry<MyDecorable> registry(64);
+    const auto cold = registry.declareDecoration<int>();
+    const auto hot1 = registry.declareHotDecoration<int>();
+    const auto hot2 = registry.declareHotDecoration<char>();
+    const auto tooBig = registry.declareHotDecoration<Big>();
+    DecorationContainer<MyDecorable> d(nullptr, &registry);
+
+    const auto base = reinterpret_cast<uintptr_t>(&d.getDecoration(hot1)) - sizeof(void*);
+    ASSERT_EQ(0U, base % stdx::hardware_destructive_interference_size);
+    ASSERT_EQ(sizeof(void*), reinterpret_cast<uintptr_t>(&d.getDecoration(hot1)) - base);
+    ASSERT_EQ(sizeof(void*) + sizeof(int),
+              reinterpret_cast<uintptr_t>(&d.getDecoration(hot2)) - base);
+
+    // The hot region is full, so the remaining decorations follow it.
+    ASSERT_EQ(64U, reinterpret_cast<uintptr_t>(&d.getDecoration(cold)) - base);
+    ASSERT_EQ(64U + sizeof(int), reinterpret_cast<uintptr_t>(&d.getDecoration(tooBig)) - base);
+}
+
+TEST(DecorableTest, BuffersAreReusedByTheSameThread) {
+    DecorationRegistry<MyDecorable> registry;
+    const auto dd = registry.declareDecoration<int>();
+
+    const int* first;
+    {
+        DecorationContainer<MyDecorable> d(nullptr, &registry);
+        first = &d.getDecoration(dd);
+    }
+    DecorationContainer<MyDecorable> d(nullptr, &registry);
+    ASSERT_EQ(first, &d.getDecoration(dd));
+    ASSERT_EQ(0, d.getDecoration(dd));
+}
+
 struct DecoratedOwnerChecker : public Decorable<DecoratedOwnerChecker> {
     const char answer[100] = "The answer to life the universe and everything is 42";
 };
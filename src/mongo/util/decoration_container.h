@@ -31,6 +31,10 @@
 
 #include <cstdint>
 #include <memory>
+#include <new>
+#include <utility>
+
+#include "mongo/stdx/new.h"
 
 namespace mongo {
 
@@ -42,6 +46,10 @@ class Decorable;
 
 /**
  * An container for decorations.
+ *
+ * The decorations live in one buffer aligned on a cache line. Each thread keeps the last buffer it
+ * released for reuse, so that a thread which creates and destroys decorables of the same type over
+ * and over, as happens with an OperationContext for every operation, does not allocate each time.
  */
 template <typename DecoratedType>
 class DecorationContainer {
@@ -97,7 +105,8 @@ public:
     explicit DecorationContainer(Decorable<DecoratedType>* const decorated,
                                  const DecorationRegistry<DecoratedType>* const registry)
         : _registry(registry),
-          _decorationData(new unsigned char[registry->getDecorationBufferSizeBytes()]) {
+          _decorationData(allocateBuffer(registry->getDecorationBufferSizeBytes()),
+                          BufferDeleter{registry->getDecorationBufferSizeBytes()}) {
         // Because the decorations live in the externally allocated storage buffer at
         // `_decorationData`, there needs to be a way to get back from a known location within this
         // buffer to the type which owns those decorations.  We place a pointer to ourselves, a
@@ -146,8 +155,67 @@ public:
     }
 
 private:
+    static constexpr size_t kBufferAlignment = stdx::hardware_destructive_interference_size;
+
+    static void freeBuffer(unsigned char* buffer) {
+        ::operator delete(buffer, std::align_val_t(kBufferAlignment));
+    }
+
+    // Set when the cache of the current thread is destroyed at thread exit, after which buffers
+    // bypass it. Being trivially destructible, the flag can still be read once thread-local
+    // objects with destructors, such as the cache, are gone.
+    static bool& bufferCacheDestroyed() {
+        static thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    struct BufferCache {
+        ~BufferCache() {
+            bufferCacheDestroyed() = true;
+            if (buffer) {
+                freeBuffer(buffer);
+            }
+        }
+
+        unsigned char* buffer = nullptr;
+        size_t size = 0;
+    };
+
+    static BufferCache& bufferCache() {
+        static thread_local BufferCache cache;
+        return cache;
+    }
+
+    static unsigned char* allocateBuffer(size_t size) {
+        if (!bufferCacheDestroyed()) {
+            auto& cache = bufferCache();
+            if (cache.buffer && cache.size == size) {
+                return std::exchange(cache.buffer, nullptr);
+            }
+        }
+        return static_cast<unsigned char*>(
+            ::operator new(size, std::align_val_t(kBufferAlignment)));
+    }
+
+    struct BufferDeleter {
+        void operator()(unsigned char* buffer) const noexcept {
+            if (bufferCacheDestroyed()) {
+                freeBuffer(buffer);
+                return;
+            }
+            auto& cache = bufferCache();
+            if (cache.buffer) {
+                freeBuffer(cache.buffer);
+            }
+            cache.buffer = buffer;
+            cache.size = size;
+        }
+
+        size_t size;
+    };
+
     const DecorationRegistry<DecoratedType>* const _registry;
-    const std::unique_ptr<unsigned char[]> _decorationData;
+    const std::unique_ptr<unsigned char[], BufferDeleter> _decorationData;
 };
 
 }  // namespace mongo
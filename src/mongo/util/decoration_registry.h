@@ -55,7 +55,13 @@ class DecorationRegistry {
     DecorationRegistry& operator=(const DecorationRegistry&) = delete;
 
 public:
-    DecorationRegistry() = default;
+    /**
+     * Reserves the first "hotRegionBytes" bytes of the decoration buffer for decorations declared
+     * with declareHotDecoration(), so that they share as few cache lines as possible.
+     */
+    explicit DecorationRegistry(size_t hotRegionBytes = 0)
+        : _hotRegionBytes(hotRegionBytes),
+          _totalSizeBytes(std::max(sizeof(void*), hotRegionBytes)) {}
 
     /**
      * Declares a decoration of type T, constructed with T's default constructor, and
@@ -69,8 +75,29 @@ public:
                                 "Decorations must be nothrow destructible");
         return
             typename DecorationContainer<DecoratedType>::template DecorationDescriptorWithType<T>(
-                std::move(declareDecoration(
-                    sizeof(T), std::alignment_of<T>::value, &constructAt<T>, &destroyAt<T>)));
+                std::move(declareDecoration(sizeof(T),
+                                            std::alignment_of<T>::value,
+                                            &constructAt<T>,
+                                            &destroyAt<T>,
+                                            false)));
+    }
+
+    /**
+     * Same as declareDecoration(), but places the decoration in the hot region at the front of the
+     * decoration buffer, if it still has room for it. Meant for the few decorations which are
+     * accessed all the time.
+     */
+    template <typename T>
+    auto declareHotDecoration() {
+        MONGO_STATIC_ASSERT_MSG(std::is_nothrow_destructible<T>::value,
+                                "Decorations must be nothrow destructible");
+        return
+            typename DecorationContainer<DecoratedType>::template DecorationDescriptorWithType<T>(
+                std::move(declareDecoration(sizeof(T),
+                                            std::alignment_of<T>::value,
+                                            &constructAt<T>,
+                                            &destroyAt<T>,
+                                            true)));
     }
 
     size_t getDecorationBufferSizeBytes() const {
@@ -162,7 +189,7 @@ private:
 
     /**
      * Declares a decoration with given "constructor" and "destructor" functions,
-     * of "sizeBytes" bytes.
+     * of "sizeBytes" bytes, in the hot region if "hot" is set and it fits there.
      *
      * NOTE: "destructor" must not throw exceptions.
      */
@@ -170,7 +197,18 @@ private:
         const size_t sizeBytes,
         const size_t alignBytes,
         const DecorationConstructorFn constructor,
-        const DecorationDestructorFn destructor) {
+        const DecorationDestructorFn destructor,
+        const bool hot) {
+        if (hot) {
+            const size_t offset = (_hotSizeBytes + alignBytes - 1) / alignBytes * alignBytes;
+            if (offset + sizeBytes <= _hotRegionBytes) {
+                typename DecorationContainer<DecoratedType>::DecorationDescriptor result(offset);
+                _decorationInfo.push_back(DecorationInfo(result, constructor, destructor));
+                _hotSizeBytes = offset + sizeBytes;
+                return result;
+            }
+        }
+
         const size_t misalignment = _totalSizeBytes % alignBytes;
         if (misalignment) {
             _totalSizeBytes += alignBytes - misalignment;
@@ -182,7 +220,11 @@ private:
     }
 
     DecorationInfoVector _decorationInfo;
-    size_t _totalSizeBytes{sizeof(void*)};
+
+    // The hot region starts right after the back link to the decorable, which is at offset 0.
+    const size_t _hotRegionBytes;
+    size_t _hotSizeBytes{sizeof(void*)};
+    size_t _totalSizeBytes;
 };
 
 }  // namespace mongo
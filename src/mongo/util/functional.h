@@ -30,6 +30,8 @@
 #pragma once
 
 #include <functional>
+#include <memory>
+#include <new>
 #include <type_traits>
 
 #include "mongo/stdx/type_traits.h"
@@ -45,6 +47,10 @@ class unique_function;
  * it is incapable of being copied.  Often this happens with C++14 or later lambdas which capture a
  * `std::unique_ptr` by move.  The interface of `unique_function` is nearly identical to
  * `std::function`, except that it is not copyable.
+ *
+ * Functors small enough to fit in a few pointers, whose move constructors do not throw, are stored
+ * inline rather than on the heap. This covers most lambdas used as continuations, which capture
+ * little more than a pointer or two.
  */
 template <typename RetType, typename... Args>
 class unique_function<RetType(Args...)> {
@@ -65,18 +71,30 @@ private:
 public:
     using result_type = RetType;
 
-    ~unique_function() noexcept = default;
+    ~unique_function() noexcept {
+        reset();
+    }
     unique_function() = default;
 
     unique_function(const unique_function&) = delete;
     unique_function& operator=(const unique_function&) = delete;
 
-    unique_function(unique_function&&) noexcept = default;
-    unique_function& operator=(unique_function&&) noexcept = default;
+    unique_function(unique_function&& that) noexcept {
+        takeFrom(that);
+    }
+
+    unique_function& operator=(unique_function&& that) noexcept {
+        if (this != &that) {
+            reset();
+            takeFrom(that);
+        }
+        return *this;
+    }
 
     void swap(unique_function& that) noexcept {
-        using std::swap;
-        swap(this->impl, that.impl);
+        unique_function tmp(std::move(that));
+        that = std::move(*this);
+        *this = std::move(tmp);
     }
 
     friend void swap(unique_function& a, unique_function& b) noexcept {
@@ -100,7 +118,7 @@ public:
         std::enable_if_t<std::is_move_constructible<Functor>::value, TagType> = makeTag(),
         std::enable_if_t<!std::is_same<std::decay_t<Functor>, unique_function>::value, TagType> =
             makeTag())
-        : impl(makeImpl(std::forward<Functor>(functor))) {}
+        : impl(makeImpl(std::forward<Functor>(functor), &buffer)) {}
 
     unique_function(std::nullptr_t) noexcept {}
 
@@ -135,8 +153,15 @@ private:
     struct Impl {
         virtual ~Impl() noexcept = default;
         virtual RetType call(Args&&... args) = 0;
+
+        // Only called on an Impl stored inline. Move constructs this Impl into 'buffer', destroys
+        // this one, and returns the new one.
+        virtual Impl* relocate(void* buffer) noexcept = 0;
     };
 
+    // Room for a vtable pointer and a functor of up to three pointers.
+    using Buffer = std::aligned_storage_t<4 * sizeof(void*), alignof(void*)>;
+
     // These overload helpers are needed to squelch problems in the `T ()` -> `void ()` case.
     template <typename Functor>
     static void callRegularVoid(const std::true_type isVoid, Functor& f, Args&&... args) {
@@ -151,21 +176,61 @@ private:
     }
 
     template <typename Functor>
-    static auto makeImpl(Functor&& functor) {
+    static Impl* makeImpl(Functor&& functor, Buffer* buffer) {
+        using StoredFunctor = std::decay_t<Functor>;
+
         struct SpecificImpl : Impl {
             explicit SpecificImpl(Functor&& func) : f(std::forward<Functor>(func)) {}
+            explicit SpecificImpl(StoredFunctor&& func, std::true_type isMoved)
+                : f(std::move(func)) {}
 
             RetType call(Args&&... args) override {
                 return callRegularVoid(std::is_void<RetType>(), f, std::forward<Args>(args)...);
             }
 
-            std::decay_t<Functor> f;
+            Impl* relocate(void* buffer) noexcept override {
+                auto moved = new (buffer) SpecificImpl(std::move(f), std::true_type());
+                this->~SpecificImpl();
+                return moved;
+            }
+
+            StoredFunctor f;
         };
 
-        return std::make_unique<SpecificImpl>(std::forward<Functor>(functor));
+        constexpr bool fitsInline = sizeof(SpecificImpl) <= sizeof(Buffer) &&
+            alignof(SpecificImpl) <= alignof(Buffer) &&
+            std::is_nothrow_move_constructible<StoredFunctor>::value;
+        if (fitsInline) {
+            return new (buffer) SpecificImpl(std::forward<Functor>(functor));
+        }
+        return new SpecificImpl(std::forward<Functor>(functor));
+    }
+
+    bool isInline() const noexcept {
+        return static_cast<const void*>(impl) == static_cast<const void*>(&buffer);
+    }
+
+    void reset() noexcept {
+        if (isInline()) {
+            impl->~Impl();
+        } else {
+            delete impl;
+        }
+        impl = nullptr;
+    }
+
+    // Requires this to be empty. Leaves 'that' empty.
+    void takeFrom(unique_function& that) noexcept {
+        if (that.isInline()) {
+            impl = that.impl->relocate(&buffer);
+        } else {
+            impl = that.impl;
+        }
+        that.impl = nullptr;
     }
 
-    std::unique_ptr<Impl> impl;
+    Impl* impl = nullptr;
+    Buffer buffer;
 };
 
 template <typename Signature>
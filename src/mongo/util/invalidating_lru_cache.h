@@ -36,6 +36,7 @@
 
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/trusted_hasher.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/with_lock.h"
@@ -362,4 +363,65 @@ private:
     Invalidator _invalidator;
 };
 
+/**
+ * Spreads the keys of an InvalidatingLRUCache over several independent shards by their hash, so
+ * that lookups of different keys take different mutexes. Each shard keeps its own LRU order and
+ * can hold 1/numShards of the total size, rounded up.
+ */
+template <typename Key, typename Value, typename Invalidator>
+class ShardedInvalidatingLRUCache {
+public:
+    using Shard = InvalidatingLRUCache<Key, Value, Invalidator>;
+    using CachedItemInfo = typename Shard::CachedItemInfo;
+
+    ShardedInvalidatingLRUCache(size_t maxCacheSize, size_t numShards, Invalidator invalidator) {
+        invariant(numShards > 0);
+        const size_t shardSize = (maxCacheSize + numShards - 1) / numShards;
+        _shards.reserve(numShards);
+        for (size_t i = 0; i < numShards; ++i) {
+            _shards.push_back(std::make_unique<Shard>(shardSize, invalidator));
+        }
+    }
+
+    void insertOrAssign(const Key& key, std::unique_ptr<Value> value) {
+        _shardFor(key).insertOrAssign(key, std::move(value));
+    }
+
+    std::shared_ptr<Value> insertOrAssignAndGet(const Key& key, std::unique_ptr<Value> value) {
+        return _shardFor(key).insertOrAssignAndGet(key, std::move(value));
+    }
+
+    void invalidate(const Key& key) {
+        _shardFor(key).invalidate(key);
+    }
+
+    template <typename Pred>
+    void invalidateIf(Pred predicate) {
+        for (auto& shard : _shards) {
+            shard->invalidateIf(predicate);
+        }
+    }
+
+    boost::optional<std::shared_ptr<Value>> get(const Key& key) {
+        return _shardFor(key).get(key);
+    }
+
+    std::vector<CachedItemInfo> getCacheInfo() const {
+        std::vector<CachedItemInfo> ret;
+        for (const auto& shard : _shards) {
+            auto shardInfo = shard->getCacheInfo();
+            ret.insert(ret.end(), shardInfo.begin(), shardInfo.end());
+        }
+        return ret;
+    }
+
+private:
+    Shard& _shardFor(const Key& key) {
+        return *_shards[DefaultHasher<Key>()(key) % _shards.size()];
+    }
+
+    // Never resized after construction, so the shards can be looked up without a lock.
+    std::vector<std::unique_ptr<Shard>> _shards;
+};
+
 }  // namespace mongo
@@ -187,5 +187,48 @@ TEST(InvalidatingLRUCache, InvalidateIf) {
     ASSERT_EQ(cacheInfo.size(), static_cast<size_t>(cacheSize) - 1);
 }
 
+TEST(ShardedInvalidatingLRUCache, KeysStayInTheirShard) {
+    constexpr int numKeys = 20;
+    ShardedInvalidatingLRUCache<int, TestValue, TestValueInvalidator> cache(
+        numKeys * 4, 4, TestValueInvalidator{});
+
+    for (int i = 0; i < numKeys; i++) {
+        cache.insertOrAssign(i, std::make_unique<TestValue>());
+    }
+    ASSERT_EQ(cache.getCacheInfo().size(), static_cast<size_t>(numKeys));
+
+    auto item = cache.get(7);
+    ASSERT_TRUE(item);
+    auto itemVal = std::move(*item);
+    ASSERT_TRUE(itemVal->isValid());
+
+    cache.invalidate(7);
+    ASSERT_FALSE(itemVal->isValid());
+    ASSERT_FALSE(cache.get(7));
+    ASSERT_EQ(cache.getCacheInfo().size(), static_cast<size_t>(numKeys - 1));
+
+    // A predicate reaches the items in every shard.
+    cache.invalidateIf([](const int& key, const TestValue*) { return key % 2 == 0; });
+    auto cacheInfo = cache.getCacheInfo();
+    ASSERT_EQ(cacheInfo.size(), static_cast<size_t>(numKeys / 2 - 1));
+    for (const auto& info : cacheInfo) {
+        ASSERT_EQ(info.key % 2, 1);
+        ASSERT_TRUE(cache.get(info.key));
+    }
+}
+
+TEST(ShardedInvalidatingLRUCache, ZeroSizeCachesNothing) {
+    ShardedInvalidatingLRUCache<int, TestValue, TestValueInvalidator> cache(
+        0, 4, TestValueInvalidator{});
+
+    auto item = cache.insertOrAssignAndGet(1, std::make_unique<TestValue>());
+    ASSERT_TRUE(item);
+    ASSERT_EQ(cache.getCacheInfo().size(), size_t(1));
+
+    item.reset();
+    ASSERT_TRUE(cache.getCacheInfo().empty());
+    ASSERT_FALSE(cache.get(1));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -30,6 +30,9 @@
 
 #include "mongo/util/regex_util.h"
 
+#include <algorithm>
+#include <cctype>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/util/str.h"
 
@@ -64,5 +67,195 @@ pcrecpp::RE_Options flagsToPcreOptions(StringData optionFlags,
     }
     return opt;
 }
+
+namespace {
+
+// Removes the last character, which may be made of several UTF-8 bytes, from 'literal'.
+void popCharacter(std::string* literal) {
+    while (!literal->empty() && (literal->back() & 0xC0) == 0x80) {
+        literal->pop_back();
+    }
+    if (!literal->empty()) {
+        literal->pop_back();
+    }
+}
+
+// Returns true if the escape sequence '\c' matches a single character or position, and is not
+// followed by further characters which belong to it.
+bool isSimpleEscape(char c) {
+    switch (c) {
+        case 'd':
+        case 'D':
+        case 'w':
+        case 'W':
+        case 's':
+        case 'S':
+        case 'h':
+        case 'H':
+        case 'v':
+        case 'V':
+        case 'b':
+        case 'B':
+        case 'A':
+        case 'z':
+        case 'Z':
+        case 'G':
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Returns true if 'bounds' is the inside of a quantifier such as '{2}' or '{1,3}'.
+bool isQuantifierBounds(StringData bounds) {
+    if (bounds.empty() || !std::isdigit(static_cast<unsigned char>(bounds[0]))) {
+        return false;
+    }
+    return std::all_of(bounds.begin(), bounds.end(), [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c)) || c == ',';
+    });
+}
+
+}  // namespace
+
+std::vector<std::string> requiredLiterals(StringData regex, StringData optionFlags) {
+    // Case-insensitive and extended patterns do not match their literals byte for byte.
+    if (optionFlags.find('i') != std::string::npos || optionFlags.find('x') != std::string::npos) {
+        return {};
+    }
+
+    std::vector<std::string> literals;
+    std::string current;
+    auto endLiteral = [&] {
+        if (!current.empty()) {
+            literals.push_back(std::move(current));
+            current.clear();
+        }
+    };
+
+    // Only the characters outside of any group are collected, since a group may be optional or
+    // hold an alternation.
+    size_t depth = 0;
+    const size_t size = regex.size();
+    for (size_t i = 0; i < size; ++i) {
+        const char c = regex[i];
+        switch (c) {
+            case '\\': {
+                if (i + 1 == size) {
+                    return {};
+                }
+                const char escaped = regex[++i];
+                if (std::isalnum(static_cast<unsigned char>(escaped))) {
+                    // Escapes such as '\Q', '\x41' or '\1' are followed by characters of their
+                    // own, which must not be taken for literals.
+                    if (!isSimpleEscape(escaped)) {
+                        return {};
+                    }
+                    endLiteral();
+                } else if (depth == 0) {
+                    current.push_back(escaped);
+                }
+                break;
+            }
+            case '[': {
+                // Skip the character class, in which a leading ']' is a literal.
+                size_t j = i + 1;
+                if (j < size && regex[j] == '^') {
+                    ++j;
+                }
+                if (j < size && regex[j] == ']') {
+                    ++j;
+                }
+                for (; j < size && regex[j] != ']'; ++j) {
+                    if (regex[j] == '\\') {
+                        ++j;
+                    } else if (regex[j] == '[' && j + 1 < size && regex[j + 1] == ':') {
+                        // A POSIX class such as '[:alpha:]'.
+                        const size_t end = regex.find(":]", j + 2);
+                        if (end == std::string::npos) {
+                            return {};
+                        }
+                        j = end + 1;
+                    }
+                }
+                if (j >= size) {
+                    return {};
+                }
+                i = j;
+                endLiteral();
+                break;
+            }
+            case '(':
+                if (i + 1 < size && regex[i + 1] == '*') {
+                    return {};
+                }
+                if (i + 1 < size && regex[i + 1] == '?') {
+                    // Anything but a non-capturing group or an assertion may change the options
+                    // of the rest of the pattern.
+                    const StringData rest = regex.substr(i + 2);
+                    if (!rest.startsWith(":") && !rest.startsWith("=") && !rest.startsWith("!") &&
+                        !rest.startsWith(">") && !rest.startsWith("<=") &&
+                        !rest.startsWith("<!")) {
+                        return {};
+                    }
+                }
+                ++depth;
+                endLiteral();
+                break;
+            case ')':
+                if (depth == 0) {
+                    return {};
+                }
+                --depth;
+                break;
+            case '|':
+                if (depth == 0) {
+                    return {};
+                }
+                break;
+            case '{': {
+                // A '{' which does not start a quantifier such as '{2}' or '{1,3}' is a literal.
+                const size_t end = regex.find('}', i);
+                const StringData bounds =
+                    end == std::string::npos ? StringData() : regex.substr(i + 1, end - i - 1);
+                if (!isQuantifierBounds(bounds)) {
+                    endLiteral();
+                    break;
+                }
+                i = end;
+                popCharacter(&current);
+                endLiteral();
+                break;
+            }
+            case '?':
+            case '*':
+                // The preceding character may not occur at all.
+                popCharacter(&current);
+                endLiteral();
+                break;
+            case '+':
+            case '.':
+            case '^':
+            case '$':
+                endLiteral();
+                break;
+            default:
+                if (depth == 0) {
+                    current.push_back(c);
+                }
+                break;
+        }
+    }
+    if (depth != 0) {
+        return {};
+    }
+    endLiteral();
+
+    // The longest literals are the least likely to occur, so try them first.
+    std::stable_sort(literals.begin(), literals.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.size() > rhs.size();
+    });
+    return literals;
+}
 }
 }
@@ -30,6 +30,8 @@
 #pragma once
 
 #include <pcrecpp.h>
+#include <string>
+#include <vector>
 
 #include "mongo/base/string_data.h"
 
@@ -42,5 +44,13 @@ namespace regex_util {
 pcrecpp::RE_Options flagsToPcreOptions(StringData optionFlags,
                                        bool ignoreInvalidOptions,
                                        StringData opName = "");
+
+/**
+ * Returns strings which every string matched by the regular expression 'regex' with the options
+ * 'optionFlags' must contain. The result is empty if no literal is required, or if the pattern
+ * uses a construct, such as a top-level alternation or a case-insensitive match, which makes its
+ * literals too hard to determine. Not every literal which is required need be returned.
+ */
+std::vector<std::string> requiredLiterals(StringData regex, StringData optionFlags);
 }
 }
@@ -0,0 +1,78 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/regex_util.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Literals = std::vector<std::string>;
+
+TEST(RegexUtilTest, RequiredLiteralsOfPlainPatterns) {
+    ASSERT(Literals({"error"}) == regex_util::requiredLiterals("error", ""));
+    ASSERT(Literals({"timeout", "error"}) == regex_util::requiredLiterals("error.*timeout", ""));
+    ASSERT(Literals({"abc"}) == regex_util::requiredLiterals("^abc$", "m"));
+    ASSERT(Literals({"a.b"}) == regex_util::requiredLiterals("a\\.b", "s"));
+    ASSERT(Literals({"abc", "de"}) == regex_util::requiredLiterals("\\babc\\d+de", ""));
+}
+
+TEST(RegexUtilTest, QuantifiedCharactersAreNotRequired) {
+    ASSERT(Literals({"ab"}) == regex_util::requiredLiterals("abc?", ""));
+    ASSERT(Literals({"ab", "d"}) == regex_util::requiredLiterals("abc*d", ""));
+    ASSERT(Literals({"abc"}) == regex_util::requiredLiterals("abc+", ""));
+    ASSERT(Literals({"ab", "d"}) == regex_util::requiredLiterals("abc{0,2}d", ""));
+    ASSERT(Literals({"ab", "x}"}) == regex_util::requiredLiterals("ab{x}", ""));
+    ASSERT(Literals({"caf"}) == regex_util::requiredLiterals("caf\xc3\xa9?", ""));
+}
+
+TEST(RegexUtilTest, GroupsAndClassesAreSkipped) {
+    ASSERT(Literals({"ab", "e"}) == regex_util::requiredLiterals("ab(c|d)?e", ""));
+    ASSERT(Literals({"ab", "e"}) == regex_util::requiredLiterals("ab(?:cd)*e", ""));
+    ASSERT(Literals({"ab", "e"}) == regex_util::requiredLiterals("ab[]c(]?e", ""));
+    ASSERT(Literals({"ab", "e"}) == regex_util::requiredLiterals("ab[[:alpha:]]e", ""));
+}
+
+TEST(RegexUtilTest, NoLiteralsForComplexPatterns) {
+    ASSERT(regex_util::requiredLiterals("abc|def", "").empty());
+    ASSERT(regex_util::requiredLiterals("abc", "i").empty());
+    ASSERT(regex_util::requiredLiterals("a b c", "x").empty());
+    ASSERT(regex_util::requiredLiterals("(?i)abc", "").empty());
+    ASSERT(regex_util::requiredLiterals("\\Qa.b\\E?", "").empty());
+    ASSERT(regex_util::requiredLiterals("\\x41?b", "").empty());
+    ASSERT(regex_util::requiredLiterals("(a)\\1", "").empty());
+    ASSERT(regex_util::requiredLiterals(".*", "").empty());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,380 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/config.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/sampling_profiler_gen.h"
+#include "mongo/util/stacktrace.h"
+#include "mongo/util/str.h"
+#include "mongo/util/string_map.h"
+
+#if defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+#include <csignal>
+#include <sys/time.h>
+
+#define MONGO_HAVE_SAMPLING_PROFILER
+#endif
+
+namespace mongo {
+namespace {
+
+constexpr size_t kMaxFramesPerSample = 64;
+constexpr size_t kNumSampleSlots = 8192;
+constexpr size_t kMaxDistinctStacks = 100 * 1000;
+
+// How far down the stack the signal handler looks for the frame that called it.
+constexpr size_t kMaxSignalHandlerFrames = 8;
+
+// Leave room in the reply for the fields around the folded stacks.
+constexpr int kMaxFoldedStacksBytes = BSONObjMaxUserSize - 64 * 1024;
+
+struct SampleSlot {
+    enum State : int { kEmpty, kWriting, kFull };
+
+    AtomicWord<int> state{kEmpty};
+    size_t firstFrame = 0;
+    size_t numFrames = 0;
+    std::array<void*, kMaxFramesPerSample> frames;
+};
+
+/**
+ * Stack samples written by the signal handler, waiting to be aggregated. This is all the handler
+ * touches, so it must stay async-signal-safe: no locks and no allocation.
+ */
+class SampleRing {
+public:
+    /**
+     * Records the current thread's stack. 'signalReturnAddress' is the signal handler's return
+     * address, into the kernel's signal trampoline; the frames up to and including it belong to
+     * the handler and are left out of the sample.
+     */
+    void record(void* signalReturnAddress) {
+        auto& slot = _slots[_nextSlot.fetchAndAddRelaxed(1) % kNumSampleSlots];
+        int expected = SampleSlot::kEmpty;
+        if (!slot.state.compareAndSwap(&expected, SampleSlot::kWriting)) {
+            _droppedSamples.fetchAndAddRelaxed(1);
+            return;
+        }
+
+        slot.numFrames = rawBacktrace(slot.frames.data(), slot.frames.size());
+        slot.firstFrame = 0;
+        for (size_t i = 0; i < std::min(slot.numFrames, kMaxSignalHandlerFrames); ++i) {
+            if (slot.frames[i] == signalReturnAddress) {
+                slot.firstFrame = i + 1;
+                break;
+            }
+        }
+        slot.state.store(SampleSlot::kFull);
+    }
+
+    /**
+     * Calls 'callback(frames, numFrames)' for each recorded sample, innermost frame first, and
+     * frees its slot. Must not be called concurrently with itself.
+     */
+    template <typename Callback>
+    void drain(Callback&& callback) {
+        for (auto& slot : _slots) {
+            if (slot.state.load() != SampleSlot::kFull) {
+                continue;
+            }
+            callback(slot.frames.data() + slot.firstFrame, slot.numFrames - slot.firstFrame);
+            slot.state.store(SampleSlot::kEmpty);
+        }
+    }
+
+    long long droppedSamples() const {
+        return _droppedSamples.loadRelaxed();
+    }
+
+private:
+    std::array<SampleSlot, kNumSampleSlots> _slots;
+    AtomicWord<unsigned> _nextSlot{0};
+    AtomicWord<long long> _droppedSamples{0};
+};
+
+// Allocated the first time the profiler starts, and never freed: a SIGPROF may still be in
+// flight after the profiler stops.
+SampleRing* sampleRing = nullptr;
+
+#if defined(MONGO_HAVE_SAMPLING_PROFILER)
+void handleProfilingSignal(int) {
+    const auto savedErrno = errno;
+    sampleRing->record(__builtin_return_address(0));
+    errno = savedErrno;
+}
+#endif
+
+class Profiler {
+public:
+    void startup() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _startedUp = true;
+        if (gSamplingProfilerEnabled.load()) {
+            auto status = _start(lk);
+            if (!status.isOK()) {
+                warning() << "Failed to start the sampling profiler: " << status;
+            }
+        }
+    }
+
+    Status setEnabled(bool enabled) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_startedUp || enabled == _running) {
+            return Status::OK();
+        }
+        return enabled ? _start(lk) : _stop(lk);
+    }
+
+    void appendTopFrames(BSONObjBuilder* builder, size_t numFrames) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _drain(lk);
+        _appendCounts(lk, builder);
+
+        StringMap<long long> samplesByName;
+        for (auto&& leaf : _leafSamples) {
+            samplesByName[_frameName(lk, leaf.first)] += leaf.second;
+        }
+
+        std::vector<std::pair<StringData, long long>> topFrames(samplesByName.begin(),
+                                                                samplesByName.end());
+        numFrames = std::min(numFrames, topFrames.size());
+        std::partial_sort(topFrames.begin(),
+                          topFrames.begin() + numFrames,
+                          topFrames.end(),
+                          [](const auto& a, const auto& b) { return a.second > b.second; });
+        topFrames.resize(numFrames);
+        std::sort(topFrames.begin(), topFrames.end());
+
+        BSONObjBuilder topFramesBuilder(builder->subobjStart("topFrames"));
+        for (auto&& frame : topFrames) {
+            topFramesBuilder.appendNumber(frame.first, frame.second);
+        }
+    }
+
+    void appendFoldedStacks(BSONObjBuilder* builder) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _drain(lk);
+        _appendCounts(lk, builder);
+
+        bool truncated = false;
+        BSONArrayBuilder stacksBuilder(builder->subarrayStart("stacks"));
+        for (auto&& stack : _stacks) {
+            StringBuilder folded;
+            for (auto frame = stack.first.rbegin(); frame != stack.first.rend(); ++frame) {
+                if (frame != stack.first.rbegin()) {
+                    folded << ';';
+                }
+                folded << _frameName(lk, *frame);
+            }
+            folded << ' ' << stack.second;
+
+            if (builder->len() + folded.len() > kMaxFoldedStacksBytes) {
+                truncated = true;
+                break;
+            }
+            stacksBuilder.append(folded.stringData());
+        }
+        stacksBuilder.doneFast();
+        builder->append("truncated", truncated);
+    }
+
+    void reset() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _drain(lk);
+        _stacks.clear();
+        _leafSamples.clear();
+        _numSamples = 0;
+        _numDroppedSamples = 0;
+        _numRingDroppedSamplesAtReset = sampleRing ? sampleRing->droppedSamples() : 0;
+    }
+
+private:
+    Status _start(WithLock) {
+#if defined(MONGO_HAVE_SAMPLING_PROFILER)
+        if (!sampleRing) {
+            // Load the unwinder now, since the first backtrace may allocate.
+            void* frames[1];
+            rawBacktrace(frames, 1);
+
+            sampleRing = new SampleRing();
+
+            struct sigaction action;
+            memset(&action, 0, sizeof(action));
+            action.sa_handler = &handleProfilingSignal;
+            sigemptyset(&action.sa_mask);
+            action.sa_flags = SA_RESTART;
+            if (sigaction(SIGPROF, &action, nullptr) != 0) {
+                return {ErrorCodes::OperationFailed,
+                        str::stream() << "Failed to install the SIGPROF handler: "
+                                      << errnoWithDescription()};
+            }
+        }
+
+        const long long periodMicros = 1000 * 1000 / gSamplingProfilerFrequencyHz;
+        struct itimerval timer;
+        timer.it_interval.tv_sec = periodMicros / (1000 * 1000);
+        timer.it_interval.tv_usec = periodMicros % (1000 * 1000);
+        timer.it_value = timer.it_interval;
+        if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+            return {ErrorCodes::OperationFailed,
+                    str::stream() << "Failed to start the profiling timer: "
+                                  << errnoWithDescription()};
+        }
+
+        _running = true;
+        log() << "Started the sampling profiler, taking " << gSamplingProfilerFrequencyHz
+              << " samples per second of CPU time";
+        return Status::OK();
+#else
+        return {ErrorCodes::IllegalOperation,
+                "The sampling profiler is not supported on this platform"};
+#endif
+    }
+
+    Status _stop(WithLock) {
+#if defined(MONGO_HAVE_SAMPLING_PROFILER)
+        // Leave the handler installed: the default action for SIGPROF terminates the process.
+        struct itimerval timer;
+        memset(&timer, 0, sizeof(timer));
+        if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+            return {ErrorCodes::OperationFailed,
+                    str::stream() << "Failed to stop the profiling timer: "
+                                  << errnoWithDescription()};
+        }
+
+        _running = false;
+        log() << "Stopped the sampling profiler";
+#endif
+        return Status::OK();
+    }
+
+    void _drain(WithLock) {
+        if (!sampleRing) {
+            return;
+        }
+
+        sampleRing->drain([&](void* const* frames, size_t numFrames) {
+            if (numFrames == 0) {
+                return;
+            }
+
+            std::vector<void*> stack(frames, frames + numFrames);
+            auto it = _stacks.find(stack);
+            if (it == _stacks.end()) {
+                if (_stacks.size() >= kMaxDistinctStacks) {
+                    ++_numDroppedSamples;
+                    return;
+                }
+                it = _stacks.emplace(std::move(stack), 0).first;
+            }
+            ++it->second;
+            ++_leafSamples[frames[0]];
+            ++_numSamples;
+        });
+    }
+
+    void _appendCounts(WithLock, BSONObjBuilder* builder) {
+        const long long ringDroppedSamples =
+            sampleRing ? sampleRing->droppedSamples() - _numRingDroppedSamplesAtReset : 0;
+
+        builder->append("running", _running);
+        builder->append("samples", _numSamples);
+        builder->append("droppedSamples", _numDroppedSamples + ringDroppedSamples);
+        builder->append("distinctStacks", static_cast<long long>(_stacks.size()));
+    }
+
+    const std::string& _frameName(WithLock, void* address) {
+        auto it = _frameNames.find(address);
+        if (it == _frameNames.end()) {
+            it = _frameNames.emplace(address, getFrameName(address)).first;
+        }
+        return it->second;
+    }
+
+    stdx::mutex _mutex;
+    bool _startedUp = false;
+    bool _running = false;
+
+    // Sample counts of each distinct stack, innermost frame first.
+    std::map<std::vector<void*>, long long> _stacks;
+
+    // Sample counts of each address seen at the top of a stack.
+    stdx::unordered_map<void*, long long> _leafSamples;
+
+    stdx::unordered_map<void*, std::string> _frameNames;
+
+    long long _numSamples = 0;
+    long long _numDroppedSamples = 0;
+    long long _numRingDroppedSamplesAtReset = 0;
+};
+
+Profiler profiler;
+
+}  // namespace
+
+void SamplingProfiler::startup() {
+    profiler.startup();
+}
+
+Status SamplingProfiler::onUpdateEnabled(bool enabled) {
+    return profiler.setEnabled(enabled);
+}
+
+void SamplingProfiler::appendTopFrames(BSONObjBuilder* builder, size_t numFrames) {
+    profiler.appendTopFrames(builder, numFrames);
+}
+
+void SamplingProfiler::appendFoldedStacks(BSONObjBuilder* builder) {
+    profiler.appendFoldedStacks(builder);
+}
+
+void SamplingProfiler::reset() {
+    profiler.reset();
+}
+
+}  // namespace mongo
@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Process-wide sampling CPU profiler, cheap enough to leave running in production.
+ *
+ * While enabled, a SIGPROF interval timer interrupts the thread that is using CPU roughly
+ * 'samplingProfilerFrequencyHz' times per second of process CPU time, and the signal handler
+ * records that thread's stack into a fixed-size ring of samples without locking or allocating.
+ * The ring is drained into a table of distinct stacks each time a report is generated, which
+ * FTDC does once per collection period. Samples that find the ring or the table full are
+ * counted as dropped.
+ *
+ * Stacks are kept as raw return addresses and only symbolized when they are reported.
+ *
+ * The profiler owns ITIMER_PROF, so it cannot be used together with gperftools' CPU profiler.
+ */
+class SamplingProfiler {
+public:
+    /**
+     * Starts the profiler if 'samplingProfilerEnabled' is set, and lets later changes to the
+     * parameter start and stop it. Must be called once the process has finished forking, since
+     * interval timers are not inherited by a forked child.
+     */
+    static void startup();
+
+    /**
+     * on_update hook for 'samplingProfilerEnabled'.
+     */
+    static Status onUpdateEnabled(bool enabled);
+
+    /**
+     * Appends the number of samples taken and the 'numFrames' functions which were most often
+     * on top of the stack, as {<function>: <samples>} in name order. Cumulative counts keep the
+     * set of functions, and so the FTDC schema, stable from one sample to the next.
+     */
+    static void appendTopFrames(BSONObjBuilder* builder, size_t numFrames);
+
+    /**
+     * Appends every distinct stack as a "root;...;leaf <samples>" string, the folded format used
+     * by flame graph tools. Stops early, and sets "truncated", if the reply would grow too large.
+     */
+    static void appendFoldedStacks(BSONObjBuilder* builder);
+
+    /**
+     * Discards all samples taken so far.
+     */
+    static void reset();
+};
+
+}  // namespace mongo
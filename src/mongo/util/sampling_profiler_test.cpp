@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/config.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/sampling_profiler_gen.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+#if defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+
+BSONObj foldedStacks() {
+    BSONObjBuilder builder;
+    SamplingProfiler::appendFoldedStacks(&builder);
+    return builder.obj();
+}
+
+// Burns CPU until the profiler has taken some samples, or gives up after a while.
+void spinUntilSampled() {
+    const auto deadline = Date_t::now() + Seconds(30);
+    volatile unsigned long long counter = 0;
+    while (Date_t::now() < deadline) {
+        for (int i = 0; i < 1000 * 1000; ++i) {
+            counter = counter + 1;
+        }
+        if (foldedStacks()["samples"].numberLong() > 0) {
+            return;
+        }
+    }
+}
+
+TEST(SamplingProfilerTest, RecordsAndResetsSamples) {
+    SamplingProfiler::startup();
+    gSamplingProfilerEnabled.store(true);
+    ASSERT_OK(SamplingProfiler::onUpdateEnabled(true));
+    ON_BLOCK_EXIT([] {
+        gSamplingProfilerEnabled.store(false);
+        ASSERT_OK(SamplingProfiler::onUpdateEnabled(false));
+        SamplingProfiler::reset();
+    });
+
+    spinUntilSampled();
+
+    auto profile = foldedStacks();
+    ASSERT_TRUE(profile["running"].trueValue()) << profile;
+    ASSERT_GT(profile["samples"].numberLong(), 0) << profile;
+    ASSERT_FALSE(profile["truncated"].trueValue()) << profile;
+
+    long long samplesInStacks = 0;
+    for (auto&& stack : profile["stacks"].Obj()) {
+        const auto folded = stack.str();
+        const auto space = folded.rfind(' ');
+        ASSERT_NE(space, std::string::npos) << folded;
+        samplesInStacks += std::stoll(folded.substr(space + 1));
+    }
+    ASSERT_EQ(samplesInStacks, profile["samples"].numberLong()) << profile;
+
+    BSONObjBuilder topFramesBuilder;
+    SamplingProfiler::appendTopFrames(&topFramesBuilder, 3);
+    auto topFrames = topFramesBuilder.obj();
+    ASSERT_GT(topFrames["topFrames"].Obj().nFields(), 0) << topFrames;
+    ASSERT_LTE(topFrames["topFrames"].Obj().nFields(), 3) << topFrames;
+
+    SamplingProfiler::reset();
+    profile = foldedStacks();
+    ASSERT_EQ(profile["distinctStacks"].numberLong(), 0) << profile;
+    ASSERT_TRUE(profile["stacks"].Obj().isEmpty()) << profile;
+}
+
+TEST(SamplingProfilerTest, StopsWhenDisabled) {
+    SamplingProfiler::startup();
+    gSamplingProfilerEnabled.store(true);
+    ASSERT_OK(SamplingProfiler::onUpdateEnabled(true));
+    gSamplingProfilerEnabled.store(false);
+    ASSERT_OK(SamplingProfiler::onUpdateEnabled(false));
+
+    ASSERT_FALSE(foldedStacks()["running"].trueValue());
+}
+
+#endif  // defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+
+}  // namespace
+}  // namespace mongo
@@ -33,7 +33,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <iosfwd>
+#include <string>
 
 #if defined(_WIN32)
 // We need to pick up a decl for CONTEXT. Forward declaring would be preferable, but it is
@@ -47,6 +49,22 @@ namespace mongo {
 void printStackTrace(std::ostream& os);
 void printStackTrace();
 
+/**
+ * Fills 'addresses' with up to 'maxFrames' return addresses from the current thread's stack,
+ * innermost first, and returns how many were filled. Returns 0 where stack traces are not
+ * supported.
+ *
+ * Does not lock. The first call on a process may allocate while the unwinder is loaded, so make
+ * one before calling this from a signal handler.
+ */
+size_t rawBacktrace(void** addresses, size_t maxFrames);
+
+/**
+ * Returns a human-readable name for the function containing 'address', without its parameter
+ * list, or the address itself if it can't be symbolized. Allocates and may lock.
+ */
+std::string getFrameName(void* address);
+
 #if defined(_WIN32)
 // Print stack trace (using a specified stack context) to "os", default to the log stream.
 void printWindowsStackTrace(CONTEXT& context, std::ostream& os);
@@ -34,8 +34,11 @@
 #include "mongo/util/stacktrace.h"
 
 #include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
 #include <dlfcn.h>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <sys/utsname.h>
 
@@ -138,6 +141,10 @@ void printStackTrace(std::ostream& os) {
     os << "This platform does not support printing stacktraces" << std::endl;
 }
 
+size_t rawBacktrace(void** addresses, size_t maxFrames) {
+    return 0;
+}
+
 #else
 /**
  * Prints a stack backtrace for the current thread to the specified ostream.
@@ -245,8 +252,39 @@ void printStackTrace(std::ostream& os) {
     os << "-----  END BACKTRACE  -----" << std::endl;
 }
 
+size_t rawBacktrace(void** addresses, size_t maxFrames) {
+    const int addressCount = backtrace(addresses, static_cast<int>(maxFrames));
+    return addressCount > 0 ? addressCount : 0;
+}
+
 #endif
 
+std::string getFrameName(void* address) {
+    Dl_info dlinfo;
+    if (!dladdr(address, &dlinfo)) {
+        std::ostringstream os;
+        os << address;
+        return os.str();
+    }
+
+    if (dlinfo.dli_sname) {
+        int status;
+        char* demangled = abi::__cxa_demangle(dlinfo.dli_sname, nullptr, nullptr, &status);
+        if (!demangled) {
+            return dlinfo.dli_sname;
+        }
+        // Strip off the parameters, as they are very verbose.
+        std::string name(demangled, strcspn(demangled, "("));
+        free(demangled);
+        return name;
+    }
+
+    std::ostringstream os;
+    os << getBaseName(dlinfo.dli_fname) << "+0x" << std::hex
+       << uintptr_t(address) - uintptr_t(dlinfo.dli_fbase);
+    return os.str();
+}
+
 namespace {
 
 void addOSComponentsToSoMap(BSONObjBuilder* soMap);
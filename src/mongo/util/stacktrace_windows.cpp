@@ -345,6 +345,37 @@ void printWindowsStackTrace(CONTEXT& context, std::ostream& os) {
     }
 }
 
+size_t rawBacktrace(void** addresses, size_t maxFrames) {
+    return CaptureStackBackTrace(0, static_cast<DWORD>(maxFrames), addresses, nullptr);
+}
+
+std::string getFrameName(void* address) {
+    auto& symbolHandler = SymbolHandler::instance();
+    stdx::lock_guard<SymbolHandler> lk(symbolHandler);
+
+    if (symbolHandler) {
+        const size_t nameSize = 1024;
+        const size_t symbolBufferSize = sizeof(SYMBOL_INFO) + nameSize;
+        std::unique_ptr<char[]> symbolCharBuffer(new char[symbolBufferSize]);
+        memset(symbolCharBuffer.get(), 0, symbolBufferSize);
+        SYMBOL_INFO* symbolBuffer = reinterpret_cast<SYMBOL_INFO*>(symbolCharBuffer.get());
+        symbolBuffer->SizeOfStruct = sizeof(SYMBOL_INFO);
+        symbolBuffer->MaxNameLen = nameSize;
+
+        DWORD64 displacement64;
+        if (SymFromAddr(symbolHandler.getHandle(),
+                        reinterpret_cast<DWORD64>(address),
+                        &displacement64,
+                        symbolBuffer)) {
+            return symbolBuffer->Name;
+        }
+    }
+
+    std::ostringstream os;
+    os << address;
+    return os.str();
+}
+
 // Print error message from C runtime, then fassert
 int crtDebugCallback(int, char* originalMessage, int*) {
     StringData message(originalMessage);
@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/tsc_tick_source.h"
+
+#include <boost/optional.hpp>
+#include <cstdlib>
+#include <memory>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define MONGO_HAVE_TSC_TICK_SOURCE
+#endif
+
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/system_tick_source.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+#if defined(MONGO_HAVE_TSC_TICK_SOURCE)
+
+const Milliseconds kCalibrationPeriod{5};
+
+// Number of threads the counter is read from to check that it is synchronized between cores.
+const int kSynchronizationCheckThreads = 8;
+
+TickSource::Tick readTsc() {
+    return static_cast<TickSource::Tick>(__rdtsc());
+}
+
+bool hasInvariantTsc() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return edx & (1U << 8);
+}
+
+/**
+ * Returns the number of TSC ticks per second, measured against SystemTickSource over
+ * kCalibrationPeriod.
+ */
+TickSource::Tick measureTicksPerSecond() {
+    auto systemTickSource = SystemTickSource::get();
+    const auto systemStart = systemTickSource->getTicks();
+    const auto tscStart = readTsc();
+    stdx::this_thread::sleep_for(kCalibrationPeriod.toSystemDuration());
+    const auto systemElapsed = systemTickSource->getTicks() - systemStart;
+    const auto tscElapsed = readTsc() - tscStart;
+    if (systemElapsed <= 0 || tscElapsed <= 0) {
+        return 0;
+    }
+    return static_cast<TickSource::Tick>(static_cast<double>(tscElapsed) *
+                                         systemTickSource->getTicksPerSecond() / systemElapsed);
+}
+
+/**
+ * Reads the counter in a sequence of threads, each started after the previous one is joined, and
+ * returns false if a read ever returns less than the read before it. Threads are likely to land
+ * on different cores, whose counters would then disagree.
+ */
+bool tscIsSynchronizedAcrossThreads() {
+    auto last = readTsc();
+    for (int i = 0; i < kSynchronizationCheckThreads; ++i) {
+        TickSource::Tick seen;
+        stdx::thread reader([&seen] { seen = readTsc(); });
+        reader.join();
+        if (seen < last) {
+            return false;
+        }
+        last = readTsc();
+        if (last < seen) {
+            return false;
+        }
+    }
+    return true;
+}
+
+boost::optional<TickSource::Tick> calibrateTsc() {
+    if (!hasInvariantTsc()) {
+        LOG(1) << "Not using the time stamp counter as tick source, it is not invariant";
+        return boost::none;
+    }
+
+    // Two measurements which disagree by more than half a percent hint at a counter whose rate
+    // varies, as it can under some hypervisors.
+    const auto first = measureTicksPerSecond();
+    const auto second = measureTicksPerSecond();
+    if (first <= 0 || second <= 0 || std::abs(first - second) > first / 200) {
+        LOG(1) << "Not using the time stamp counter as tick source, its rate is unsteady: "
+               << first << " then " << second << " ticks per second";
+        return boost::none;
+    }
+
+    if (!tscIsSynchronizedAcrossThreads()) {
+        LOG(1) << "Not using the time stamp counter as tick source, it differs between cores";
+        return boost::none;
+    }
+
+    return (first + second) / 2;
+}
+
+#else
+
+boost::optional<TickSource::Tick> calibrateTsc() {
+    return boost::none;
+}
+
+#endif
+
+}  // namespace
+
+TickSource::Tick TscTickSource::getTicks() {
+#if defined(MONGO_HAVE_TSC_TICK_SOURCE)
+    return readTsc();
+#else
+    MONGO_UNREACHABLE;
+#endif
+}
+
+TickSource::Tick TscTickSource::getTicksPerSecond() {
+    return _ticksPerSecond;
+}
+
+TickSource* TscTickSource::get() {
+    static const std::unique_ptr<TscTickSource> tscTickSource([]() -> TscTickSource* {
+        auto ticksPerSecond = calibrateTsc();
+        if (!ticksPerSecond) {
+            return nullptr;
+        }
+        LOG(1) << "Using the time stamp counter as tick source, at " << *ticksPerSecond
+               << " ticks per second";
+        return new TscTickSource(*ticksPerSecond);
+    }());
+
+    if (!tscTickSource) {
+        return SystemTickSource::get();
+    }
+    return tscTickSource.get();
+}
+
+}  // namespace mongo
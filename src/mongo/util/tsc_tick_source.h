@@ -0,0 +1,64 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+
+/**
+ * Tick source which reads the time stamp counter of x86-64 processors. Reading the counter takes
+ * a few nanoseconds and no system call, which makes it cheap enough to time individual plan
+ * stages.
+ *
+ * The counter is only used if the processor reports it as invariant, meaning that it ticks at a
+ * constant rate whatever the power state of the core, if its rate measured against
+ * SystemTickSource is steady, and if it never appears to go backwards when read from different
+ * threads. Otherwise get() falls back to SystemTickSource.
+ */
+class TscTickSource final : public TickSource {
+public:
+    TickSource::Tick getTicks() override;
+
+    TickSource::Tick getTicksPerSecond() override;
+
+    /**
+     * Returns the TSC tick source if the time stamp counter is usable, and SystemTickSource
+     * otherwise. The first call calibrates the counter, which takes about ten milliseconds.
+     */
+    static TickSource* get();
+
+private:
+    explicit TscTickSource(TickSource::Tick ticksPerSecond) : _ticksPerSecond(ticksPerSecond) {}
+
+    const TickSource::Tick _ticksPerSecond;
+};
+
+}  // namespace mongo
@@ -0,0 +1,67 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/system_tick_source.h"
+#include "mongo/util/tsc_tick_source.h"
+
+namespace mongo {
+namespace {
+
+TEST(TscTickSourceTest, TicksDoNotGoBackwards) {
+    auto tickSource = TscTickSource::get();
+    auto last = tickSource->getTicks();
+    for (int i = 0; i < 1000; ++i) {
+        const auto ticks = tickSource->getTicks();
+        ASSERT_GTE(ticks, last);
+        last = ticks;
+    }
+}
+
+TEST(TscTickSourceTest, ElapsedTimeAgreesWithTheSystemTickSource) {
+    auto tickSource = TscTickSource::get();
+    auto systemTickSource = SystemTickSource::get();
+
+    const auto start = tickSource->getTicks();
+    const auto systemStart = systemTickSource->getTicks();
+    stdx::this_thread::sleep_for(Milliseconds(50).toSystemDuration());
+    const auto elapsed = tickSource->ticksTo<Microseconds>(tickSource->getTicks() - start);
+    const auto systemElapsed =
+        systemTickSource->ticksTo<Microseconds>(systemTickSource->getTicks() - systemStart);
+
+    ASSERT_GTE(elapsed, Milliseconds(50));
+    ASSERT_LTE(elapsed - systemElapsed, Milliseconds(1));
+    ASSERT_LTE(systemElapsed - elapsed, Milliseconds(1));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -162,6 +162,69 @@ TEST(UniqueFunctionTest, simple_instantiations) {
     x = []() -> int { return 42; };
 }
 
+// Counts the live copies of a functor, to check that moving a unique_function neither leaks nor
+// destroys its functor twice, whether it is stored inline or on the heap.
+template <size_t padding, bool nothrowMove = true>
+struct CountedFunctor {
+    explicit CountedFunctor(int* live, int value) : live(live), value(value) {
+        ++*live;
+    }
+    CountedFunctor(CountedFunctor&& other) noexcept(nothrowMove)
+        : live(other.live), value(other.value) {
+        ++*live;
+    }
+    ~CountedFunctor() {
+        --*live;
+    }
+
+    int operator()() const {
+        return value;
+    }
+
+    int* live;
+    int value;
+    char pad[padding];
+};
+
+template <typename Functor>
+void checkMovesKeepTheFunctor() {
+    int live = 0;
+    {
+        mongo::unique_function<int()> a = Functor(&live, 1);
+        ASSERT_EQ(live, 1);
+        ASSERT_EQ(a(), 1);
+
+        mongo::unique_function<int()> b = std::move(a);
+        ASSERT_FALSE(a);
+        ASSERT_EQ(live, 1);
+        ASSERT_EQ(b(), 1);
+
+        mongo::unique_function<int()> c = Functor(&live, 2);
+        b.swap(c);
+        ASSERT_EQ(live, 2);
+        ASSERT_EQ(b(), 2);
+        ASSERT_EQ(c(), 1);
+
+        b = std::move(c);
+        ASSERT_FALSE(c);
+        ASSERT_EQ(live, 1);
+        ASSERT_EQ(b(), 1);
+    }
+    ASSERT_EQ(live, 0);
+}
+
+TEST(UniqueFunctionTest, small_functors_survive_moves) {
+    checkMovesKeepTheFunctor<CountedFunctor<1>>();
+}
+
+TEST(UniqueFunctionTest, large_functors_survive_moves) {
+    checkMovesKeepTheFunctor<CountedFunctor<64>>();
+}
+
+TEST(UniqueFunctionTest, functors_with_throwing_moves_survive_moves) {
+    checkMovesKeepTheFunctor<CountedFunctor<1, false>>();
+}
+
 namespace conversion_checking {
 template <typename FT>
 using uf = mongo::unique_function<FT>;